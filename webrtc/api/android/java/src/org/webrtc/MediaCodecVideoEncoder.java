@@ -177,6 +177,11 @@ public class MediaCodecVideoEncoder {
 
   // SPS and PPS NALs (Config frame) for H.264.
   private ByteBuffer configData = null;
+  // H.264 key frames with the config frame prepended. Reused while it is big
+  // enough, since C++ is done with it before the next dequeueOutputBuffer().
+  private ByteBuffer keyFrameBuffer = null;
+  // Reused by dequeueOutputBuffer() to avoid an allocation per call.
+  private final MediaCodec.BufferInfo outputBufferInfo = new MediaCodec.BufferInfo();
 
   // MediaCodec error handler - invoked when critical error happens which may prevent
   // further use of media codec API. Now it means that one of media codec instances
@@ -637,7 +642,7 @@ public class MediaCodecVideoEncoder {
   OutputBufferInfo dequeueOutputBuffer() {
     checkOnMediaCodecThread();
     try {
-      MediaCodec.BufferInfo info = new MediaCodec.BufferInfo();
+      MediaCodec.BufferInfo info = outputBufferInfo;
       int result = mediaCodec.dequeueOutputBuffer(info, DEQUEUE_TIMEOUT);
       // Check if this is config frame and save configuration data.
       if (result >= 0) {
@@ -676,13 +681,18 @@ public class MediaCodecVideoEncoder {
               " to output buffer with offset " + info.offset + ", size " +
               info.size);
           // For H.264 key frame append SPS and PPS NALs at the start
-          ByteBuffer keyFrameBuffer = ByteBuffer.allocateDirect(
-              configData.capacity() + info.size);
+          final int keyFrameSize = configData.capacity() + info.size;
+          if (keyFrameBuffer == null || keyFrameBuffer.capacity() < keyFrameSize) {
+            keyFrameBuffer = ByteBuffer.allocateDirect(keyFrameSize);
+          }
+          keyFrameBuffer.clear();
           configData.rewind();
           keyFrameBuffer.put(configData);
           keyFrameBuffer.put(outputBuffer);
-          keyFrameBuffer.position(0);
-          return new OutputBufferInfo(result, keyFrameBuffer,
+          // C++ takes the size from the capacity, so hand out a slice that ends
+          // at the frame.
+          keyFrameBuffer.flip();
+          return new OutputBufferInfo(result, keyFrameBuffer.slice(),
               isKeyFrame, info.presentationTimeUs);
         } else {
           return new OutputBufferInfo(result, outputBuffer.slice(),
@@ -101,8 +101,12 @@ class MediaCodecVideoDecoder : public webrtc::VideoDecoder,
   int32_t ReleaseOnCodecThread();
   int32_t DecodeOnCodecThread(const EncodedImage& inputImage);
   // Deliver any outputs pending in the MediaCodec to our |callback_| and return
-  // true on success.
-  bool DeliverPendingOutputs(JNIEnv* jni, int dequeue_timeout_us);
+  // true on success. Only the first dequeue waits up to |dequeue_timeout_ms|.
+  bool DeliverPendingOutputs(JNIEnv* jni, int dequeue_timeout_ms);
+  // Deliver at most one output and set |frame_dequeued| if there was one.
+  bool DeliverPendingOutput(JNIEnv* jni,
+                            int dequeue_timeout_ms,
+                            bool* frame_dequeued);
   int32_t ProcessHWErrorOnCodecThread();
   void EnableFrameLogOnWarning();
   void ResetVariables();
@@ -131,6 +135,10 @@ class MediaCodecVideoDecoder : public webrtc::VideoDecoder,
   int current_bytes_;  // Encoded bytes in the current statistics interval.
   int current_decoding_time_ms_;  // Overall decoding time in the current second
   int current_delay_time_ms_;  // Overall delay time in the current second.
+  // Output dequeue calls through JNI in the current statistics interval, and
+  // how many of them returned no frame.
+  int current_dequeue_calls_;
+  int current_empty_dequeue_calls_;
   uint32_t max_pending_frames_;  // Maximum number of pending input frames.
 
   // State that is constant for the lifetime of this object once the ctor
@@ -323,6 +331,8 @@ void MediaCodecVideoDecoder::ResetVariables() {
   current_bytes_ = 0;
   current_decoding_time_ms_ = 0;
   current_delay_time_ms_ = 0;
+  current_dequeue_calls_ = 0;
+  current_empty_dequeue_calls_ = 0;
 }
 
 int32_t MediaCodecVideoDecoder::InitDecodeOnCodecThread() {
@@ -668,6 +678,11 @@ int32_t MediaCodecVideoDecoder::DecodeOnCodecThread(
     return ProcessHWErrorOnCodecThread();
   }
 
+  // Poll soon for the output of this frame, even if the codec was drained and
+  // polling at the lower rate.
+  codec_thread_->Clear(this);
+  codec_thread_->PostDelayed(RTC_FROM_HERE, kMediaCodecPollMs, this);
+
   // Try to drain the decoder
   if (!DeliverPendingOutputs(jni, 0)) {
     ALOGE << "DeliverPendingOutputs error";
@@ -679,6 +694,20 @@ int32_t MediaCodecVideoDecoder::DecodeOnCodecThread(
 
 bool MediaCodecVideoDecoder::DeliverPendingOutputs(
     JNIEnv* jni, int dequeue_timeout_ms) {
+  // Keep going while frames are ready, so that a burst of outputs doesn't
+  // wait one poll interval per frame.
+  bool frame_dequeued = true;
+  while (frame_dequeued && frames_received_ > frames_decoded_) {
+    if (!DeliverPendingOutput(jni, dequeue_timeout_ms, &frame_dequeued))
+      return false;
+    dequeue_timeout_ms = 0;
+  }
+  return true;
+}
+
+bool MediaCodecVideoDecoder::DeliverPendingOutput(
+    JNIEnv* jni, int dequeue_timeout_ms, bool* frame_dequeued) {
+  *frame_dequeued = false;
   if (frames_received_ <= frames_decoded_) {
     // No need to query for output buffers - decoder is drained.
     return true;
@@ -689,6 +718,7 @@ bool MediaCodecVideoDecoder::DeliverPendingOutputs(
           use_surface_ ? j_dequeue_texture_buffer_method_
                        : j_dequeue_byte_buffer_method_,
           dequeue_timeout_ms);
+  current_dequeue_calls_++;
 
   if (CheckException(jni)) {
     ALOGE << "dequeueOutputBuffer() error";
@@ -696,8 +726,10 @@ bool MediaCodecVideoDecoder::DeliverPendingOutputs(
   }
   if (IsNull(jni, j_decoder_output_buffer)) {
     // No decoded frame ready.
+    current_empty_dequeue_calls_++;
     return true;
   }
+  *frame_dequeued = true;
 
   // Get decoded video frame properties.
   int color_format = GetIntField(jni, *j_media_codec_video_decoder_,
@@ -847,12 +879,16 @@ bool MediaCodecVideoDecoder::DeliverPendingOutputs(
         ". Fps: " << current_fps <<
         ". DecTime: " << (current_decoding_time_ms_ / current_frames_) <<
         ". DelayTime: " << (current_delay_time_ms_ / current_frames_) <<
+        ". Dequeues: " << current_dequeue_calls_ <<
+        " (" << current_empty_dequeue_calls_ << " empty)" <<
         " for last " << statistic_time_ms << " ms.";
     start_time_ms_ = rtc::TimeMillis();
     current_frames_ = 0;
     current_bytes_ = 0;
     current_decoding_time_ms_ = 0;
     current_delay_time_ms_ = 0;
+    current_dequeue_calls_ = 0;
+    current_empty_dequeue_calls_ = 0;
   }
 
   // If the frame was dropped, frame_buffer is left as nullptr.
@@ -893,7 +929,12 @@ void MediaCodecVideoDecoder::OnMessage(rtc::Message* msg) {
     ProcessHWErrorOnCodecThread();
     return;
   }
-  codec_thread_->PostDelayed(RTC_FROM_HERE, kMediaCodecPollMs, this);
+  // If there aren't more frames to deliver, we can poll at lower rate.
+  codec_thread_->PostDelayed(RTC_FROM_HERE,
+                             frames_received_ > frames_decoded_
+                                 ? kMediaCodecPollMs
+                                 : kMediaCodecPollNoFramesMs,
+                             this);
 }
 
 MediaCodecVideoDecoderFactory::MediaCodecVideoDecoderFactory()
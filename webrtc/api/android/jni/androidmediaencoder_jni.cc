@@ -225,6 +225,10 @@ class MediaCodecVideoEncoder : public webrtc::VideoEncoder,
   int current_bytes_;  // Encoded bytes in the current statistics interval.
   int current_acc_qp_; // Accumulated QP in the current statistics interval.
   int current_encoding_time_ms_;  // Overall encoding time in the current second
+  // Output dequeue calls through JNI in the current statistics interval, and
+  // how many of them returned no frame.
+  int current_dequeue_calls_;
+  int current_empty_dequeue_calls_;
   int64_t last_input_timestamp_ms_;  // Timestamp of last received yuv frame.
   int64_t last_output_timestamp_ms_;  // Timestamp of last encoded frame.
 
@@ -537,6 +541,8 @@ int32_t MediaCodecVideoEncoder::InitEncodeOnCodecThread(
   current_bytes_ = 0;
   current_acc_qp_ = 0;
   current_encoding_time_ms_ = 0;
+  current_dequeue_calls_ = 0;
+  current_empty_dequeue_calls_ = 0;
   last_input_timestamp_ms_ = -1;
   last_output_timestamp_ms_ = -1;
   output_timestamp_ = 0;
@@ -944,7 +950,9 @@ bool MediaCodecVideoEncoder::DeliverPendingOutputs(JNIEnv* jni) {
     jobject j_output_buffer_info = jni->CallObjectMethod(
         *j_media_codec_video_encoder_, j_dequeue_output_buffer_method_);
     CHECK_EXCEPTION(jni);
+    current_dequeue_calls_++;
     if (IsNull(jni, j_output_buffer_info)) {
+      current_empty_dequeue_calls_++;
       break;
     }
 
@@ -984,17 +992,18 @@ bool MediaCodecVideoEncoder::DeliverPendingOutputs(JNIEnv* jni) {
     // Callback - return encoded frame.
     int32_t callback_status = 0;
     if (callback_) {
-      std::unique_ptr<webrtc::EncodedImage> image(
-          new webrtc::EncodedImage(payload, payload_size, payload_size));
-      image->_encodedWidth = width_;
-      image->_encodedHeight = height_;
-      image->_timeStamp = output_timestamp_;
-      image->capture_time_ms_ = output_render_time_ms_;
-      image->rotation_ = output_rotation_;
-      image->_frameType =
+      // The image only wraps the output buffer, which stays with the codec
+      // until it is released below, so there is nothing to allocate or copy.
+      webrtc::EncodedImage image(payload, payload_size, payload_size);
+      image._encodedWidth = width_;
+      image._encodedHeight = height_;
+      image._timeStamp = output_timestamp_;
+      image.capture_time_ms_ = output_render_time_ms_;
+      image.rotation_ = output_rotation_;
+      image._frameType =
           (key_frame ? webrtc::kVideoFrameKey : webrtc::kVideoFrameDelta);
-      image->_completeFrame = true;
-      image->adapt_reason_.quality_resolution_downscales =
+      image._completeFrame = true;
+      image.adapt_reason_.quality_resolution_downscales =
           scale_ ? quality_scaler_.downscale_shift() : -1;
 
       webrtc::CodecSpecificInfo info;
@@ -1040,7 +1049,7 @@ bool MediaCodecVideoEncoder::DeliverPendingOutputs(JNIEnv* jni) {
       if (codecType_ == kVideoCodecVP8 || codecType_ == kVideoCodecVP9) {
         header.VerifyAndAllocateFragmentationHeader(1);
         header.fragmentationOffset[0] = 0;
-        header.fragmentationLength[0] = image->_length;
+        header.fragmentationLength[0] = image._length;
         header.fragmentationPlType[0] = 0;
         header.fragmentationTimeDiff[0] = 0;
         if (codecType_ == kVideoCodecVP8 && scale_) {
@@ -1048,7 +1057,7 @@ bool MediaCodecVideoEncoder::DeliverPendingOutputs(JNIEnv* jni) {
           if (webrtc::vp8::GetQp(payload, payload_size, &qp)) {
             current_acc_qp_ += qp;
             quality_scaler_.ReportQP(qp);
-            image->qp_ = qp;
+            image.qp_ = qp;
           }
         }
       } else if (codecType_ == kVideoCodecH264) {
@@ -1076,9 +1085,9 @@ bool MediaCodecVideoEncoder::DeliverPendingOutputs(JNIEnv* jni) {
         }
         if (scPositionsLength == 0) {
           ALOGE << "Start code is not found!";
-          ALOGE << "Data:" <<  image->_buffer[0] << " " << image->_buffer[1]
-              << " " << image->_buffer[2] << " " << image->_buffer[3]
-              << " " << image->_buffer[4] << " " << image->_buffer[5];
+          ALOGE << "Data:" <<  image._buffer[0] << " " << image._buffer[1]
+              << " " << image._buffer[2] << " " << image._buffer[3]
+              << " " << image._buffer[4] << " " << image._buffer[5];
           ResetCodecOnCodecThread();
           return false;
         }
@@ -1093,7 +1102,7 @@ bool MediaCodecVideoEncoder::DeliverPendingOutputs(JNIEnv* jni) {
         }
       }
 
-      callback_status = callback_->Encoded(*image, &info, &header);
+      callback_status = callback_->Encoded(image, &info, &header);
     }
 
     // Return output buffer back to the encoder.
@@ -1153,12 +1162,16 @@ void MediaCodecVideoEncoder::LogStatistics(bool force_log) {
         ", fps: " << current_fps <<
         ", encTime: " << (current_encoding_time_ms_ / current_frames_divider) <<
         ". QP: " << (current_acc_qp_ / current_frames_divider) <<
+        ". Dequeues: " << current_dequeue_calls_ <<
+        " (" << current_empty_dequeue_calls_ << " empty)" <<
         " for last " << statistic_time_ms << " ms.";
     stat_start_time_ms_ = rtc::TimeMillis();
     current_frames_ = 0;
     current_bytes_ = 0;
     current_acc_qp_ = 0;
     current_encoding_time_ms_ = 0;
+    current_dequeue_calls_ = 0;
+    current_empty_dequeue_calls_ = 0;
   }
 }
 
@@ -168,6 +168,7 @@
         'rtpsender.cc',
         'rtpsender.h',
         'rtpsenderinterface.h',
+        'rtpsnapshot.h',
         'sctputils.cc',
         'sctputils.h',
         'statscollector.cc',
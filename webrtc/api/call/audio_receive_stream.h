@@ -132,6 +132,12 @@ class AudioReceiveStream {
   // is potentially forwarded to any attached AudioSinkInterface implementation.
   virtual void SetGain(float gain) = 0;
 
+  // Returns true while the remote sender is in a DTX period and the stream
+  // would play out nothing but comfort noise. A mixer with many streams can
+  // leave silent streams out without pulling and decoding their audio. Unlike
+  // the other methods, this may be called on the thread that pulls the audio.
+  virtual bool IsSilent() const = 0;
+
  protected:
   virtual ~AudioReceiveStream() {}
 };
@@ -94,6 +94,12 @@ class AudioSendStream {
     // Note: This is still an experimental feature and not ready for real usage.
     int min_bitrate_kbps = -1;
     int max_bitrate_kbps = -1;
+
+    // Lets the encoder adapt its bitrate, frame length and FEC to the uplink
+    // bandwidth, packet loss and RTT. Requires the bitrate limits above to be
+    // set, since the uplink bandwidth is taken from the bitrate allocator.
+    // Note: This is still an experimental feature and not ready for real usage.
+    bool enable_audio_network_adaptor = false;
   };
 
   // Starts stream activity.
@@ -69,9 +69,10 @@ bool JsepCandidateCollection::HasCandidate(
   bool ret = false;
   for (std::vector<JsepIceCandidate*>::const_iterator it = candidates_.begin();
       it != candidates_.end(); ++it) {
-    if ((*it)->sdp_mid() == candidate->sdp_mid() &&
-        (*it)->sdp_mline_index() == candidate->sdp_mline_index() &&
-        (*it)->candidate().IsEquivalent(candidate->candidate())) {
+    // sdp_mid() returns a copy, so it's compared last.
+    if ((*it)->sdp_mline_index() == candidate->sdp_mline_index() &&
+        (*it)->candidate().IsEquivalent(candidate->candidate()) &&
+        (*it)->sdp_mid() == candidate->sdp_mid()) {
       ret = true;
       break;
     }
@@ -15,9 +15,11 @@
 #include "webrtc/base/bind.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/task_queue.h"
 #include "webrtc/call.h"
 #include "webrtc/pc/channelmanager.h"
 #include "webrtc/media/base/mediachannel.h"
+#include "webrtc/modules/utility/include/process_thread.h"
 
 namespace {
 
@@ -30,11 +32,18 @@ class MediaController : public webrtc::MediaControllerInterface,
  public:
   MediaController(const cricket::MediaConfig& media_config,
                   rtc::Thread* worker_thread,
-                  cricket::ChannelManager* channel_manager)
+                  cricket::ChannelManager* channel_manager,
+                  webrtc::SharedCallThreads* shared_threads)
       : worker_thread_(worker_thread),
         media_config_(media_config),
         channel_manager_(channel_manager) {
     RTC_DCHECK(worker_thread);
+    if (shared_threads) {
+      call_config_.module_process_thread =
+          shared_threads->module_process_thread();
+      call_config_.pacer_thread = shared_threads->pacer_thread();
+      call_config_.worker_queue = shared_threads->worker_queue();
+    }
     worker_thread_->Invoke<void>(RTC_FROM_HERE,
                                  rtc::Bind(&MediaController::Construct_w, this,
                                            channel_manager_->media_engine()));
@@ -86,10 +95,32 @@ class MediaController : public webrtc::MediaControllerInterface,
 
 namespace webrtc {
 
+SharedCallThreads::SharedCallThreads()
+    : module_process_thread_(ProcessThread::Create("ModuleProcessThread")),
+      pacer_thread_(ProcessThread::Create("PacerThread")),
+      worker_queue_(new rtc::TaskQueue("call_worker_queue")) {
+  module_process_thread_->Start();
+  pacer_thread_->Start();
+}
+
+SharedCallThreads::~SharedCallThreads() {
+  pacer_thread_->Stop();
+  module_process_thread_->Stop();
+}
+
 MediaControllerInterface* MediaControllerInterface::Create(
     const cricket::MediaConfig& config,
     rtc::Thread* worker_thread,
     cricket::ChannelManager* channel_manager) {
-  return new MediaController(config, worker_thread, channel_manager);
+  return Create(config, worker_thread, channel_manager, nullptr);
+}
+
+MediaControllerInterface* MediaControllerInterface::Create(
+    const cricket::MediaConfig& config,
+    rtc::Thread* worker_thread,
+    cricket::ChannelManager* channel_manager,
+    SharedCallThreads* shared_threads) {
+  return new MediaController(config, worker_thread, channel_manager,
+                             shared_threads);
 }
 }  // namespace webrtc
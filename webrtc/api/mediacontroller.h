@@ -11,8 +11,15 @@
 #ifndef WEBRTC_API_MEDIACONTROLLER_H_
 #define WEBRTC_API_MEDIACONTROLLER_H_
 
+#include <memory>
+
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/base/thread.h"
 
+namespace rtc {
+class TaskQueue;
+}  // namespace rtc
+
 namespace cricket {
 class ChannelManager;
 struct MediaConfig;
@@ -20,8 +27,32 @@ struct MediaConfig;
 
 namespace webrtc {
 class Call;
+class ProcessThread;
 class VoiceEngine;
 
+// The threads a webrtc::Call runs its modules and tasks on, for the calls of
+// many media controllers to share instead of starting three of their own
+// each. Congestion control stays per call. Must be created and destroyed on
+// the worker thread, after all the calls using it are gone.
+class SharedCallThreads {
+ public:
+  SharedCallThreads();
+  ~SharedCallThreads();
+
+  ProcessThread* module_process_thread() const {
+    return module_process_thread_.get();
+  }
+  ProcessThread* pacer_thread() const { return pacer_thread_.get(); }
+  rtc::TaskQueue* worker_queue() const { return worker_queue_.get(); }
+
+ private:
+  const std::unique_ptr<ProcessThread> module_process_thread_;
+  const std::unique_ptr<ProcessThread> pacer_thread_;
+  const std::unique_ptr<rtc::TaskQueue> worker_queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedCallThreads);
+};
+
 // The MediaController currently owns shared state between media channels, but
 // in the future will create and own RtpSenders and RtpReceivers.
 class MediaControllerInterface {
@@ -30,6 +61,12 @@ class MediaControllerInterface {
       const cricket::MediaConfig& config,
       rtc::Thread* worker_thread,
       cricket::ChannelManager* channel_manager);
+  // Creates a controller whose call uses |shared_threads|, if not null.
+  static MediaControllerInterface* Create(
+      const cricket::MediaConfig& config,
+      rtc::Thread* worker_thread,
+      cricket::ChannelManager* channel_manager,
+      SharedCallThreads* shared_threads);
 
   virtual ~MediaControllerInterface() {}
   virtual void Close() = 0;
@@ -426,6 +426,14 @@ void SetChannelOnSendersAndReceivers(CHANNEL* channel,
   }
 }
 
+void SnapshotTrack(const webrtc::MediaStreamTrackInterface& track,
+                   webrtc::MediaStreamTrackSnapshot* snapshot) {
+  snapshot->id = track.id();
+  snapshot->kind = track.kind();
+  snapshot->enabled = track.enabled();
+  snapshot->state = track.state();
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -873,6 +881,37 @@ PeerConnection::GetReceivers() const {
   return ret;
 }
 
+RtpSnapshot PeerConnection::GetRtpSnapshot() const {
+  RTC_DCHECK(signaling_thread()->IsCurrent());
+  // The proxies call straight through on the signaling thread.
+  RtpSnapshot snapshot;
+  snapshot.senders.resize(senders_.size());
+  for (size_t i = 0; i < senders_.size(); ++i) {
+    RtpSenderInterface* sender = senders_[i].get();
+    RtpSenderSnapshot& sender_snapshot = snapshot.senders[i];
+    sender_snapshot.sender = sender;
+    sender_snapshot.id = sender->id();
+    sender_snapshot.media_type = sender->media_type();
+    sender_snapshot.ssrc = sender->ssrc();
+    sender_snapshot.stream_ids = sender->stream_ids();
+    rtc::scoped_refptr<MediaStreamTrackInterface> track = sender->track();
+    sender_snapshot.has_track = track != nullptr;
+    if (track) {
+      SnapshotTrack(*track, &sender_snapshot.track);
+    }
+  }
+  snapshot.receivers.resize(receivers_.size());
+  for (size_t i = 0; i < receivers_.size(); ++i) {
+    RtpReceiverInterface* receiver = receivers_[i].get();
+    RtpReceiverSnapshot& receiver_snapshot = snapshot.receivers[i];
+    receiver_snapshot.receiver = receiver;
+    receiver_snapshot.id = receiver->id();
+    receiver_snapshot.media_type = receiver->media_type();
+    SnapshotTrack(*receiver->track(), &receiver_snapshot.track);
+  }
+  return snapshot;
+}
+
 bool PeerConnection::GetStats(StatsObserver* observer,
                               MediaStreamTrackInterface* track,
                               StatsOutputLevel level) {
@@ -96,6 +96,7 @@ class PeerConnection : public PeerConnectionInterface,
       const override;
   std::vector<rtc::scoped_refptr<RtpReceiverInterface>> GetReceivers()
       const override;
+  RtpSnapshot GetRtpSnapshot() const override;
 
   rtc::scoped_refptr<DataChannelInterface> CreateDataChannel(
       const std::string& label,
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <memory>
 
 #include "webrtc/api/test/peerconnectiontestwrapper.h"
@@ -23,6 +24,7 @@
 #include "webrtc/base/sslstreamadapter.h"
 #include "webrtc/base/stringencode.h"
 #include "webrtc/base/stringutils.h"
+#include "webrtc/base/timeutils.h"
 
 #define MAYBE_SKIP_TEST(feature)                    \
   if (!(feature())) {                               \
@@ -149,6 +151,35 @@ class PeerConnectionEndToEndTest
     EXPECT_EQ(local_dc->id(), remote_dc_list[remote_dc_index]->id());
   }
 
+  // Sends |count| messages of |size| bytes from the caller to the callee at
+  // once, and logs how long it takes them to arrive, and then one more.
+  void MeasureDataChannelThroughput(size_t count, size_t size) {
+    CreatePcs();
+    webrtc::DataChannelInit init;
+    rtc::scoped_refptr<DataChannelInterface> caller_dc(
+        caller_->CreateDataChannel("data", init));
+    Negotiate();
+    WaitForConnection();
+    WaitForDataChannelsToOpen(caller_dc, callee_signaled_data_channels_, 0);
+    webrtc::MockDataChannelObserver observer(callee_signaled_data_channels_[0]);
+
+    webrtc::DataBuffer buffer(std::string(size, 'a'));
+    int64_t start_ms = rtc::TimeMillis();
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_TRUE(caller_dc->Send(buffer));
+    }
+    EXPECT_EQ_WAIT(count, observer.received_message_count(), kMaxWait * 6);
+    int64_t elapsed_ms = std::max<int64_t>(rtc::TimeMillis() - start_ms, 1);
+
+    start_ms = rtc::TimeMillis();
+    EXPECT_TRUE(caller_dc->Send(webrtc::DataBuffer("b")));
+    EXPECT_EQ_WAIT(count + 1, observer.received_message_count(), kMaxWait);
+    LOG(LS_INFO) << count * size / 1024 << " kB in " << elapsed_ms << " ms: "
+                 << count * size * 8 / 1000 / elapsed_ms << " Mbps; "
+                 << "one message after: " << rtc::TimeMillis() - start_ms
+                 << " ms";
+  }
+
   void CloseDataChannels(DataChannelInterface* local_dc,
                          const DataChannelList& remote_dc_list,
                          size_t remote_dc_index) {
@@ -218,6 +249,22 @@ TEST_F(PeerConnectionEndToEndTest, CreateDataChannelBeforeNegotiate) {
   CloseDataChannels(callee_dc, caller_signaled_data_channels_, 0);
 }
 
+// Measures data channel throughput and latency with the default SCTP buffers
+// and with larger ones.
+// The tests are disabled by default to avoid unnecessarily loading the bots.
+TEST_F(PeerConnectionEndToEndTest, DISABLED_DataChannelThroughput) {
+  MAYBE_SKIP_TEST(rtc::SSLStreamAdapter::HaveDtlsSrtp);
+  MeasureDataChannelThroughput(256, 64 * 1024);
+}
+
+TEST_F(PeerConnectionEndToEndTest,
+       DISABLED_DataChannelThroughputWithLargeSctpBuffers) {
+  MAYBE_SKIP_TEST(rtc::SSLStreamAdapter::HaveDtlsSrtp);
+  config_.media_config.sctp.send_buffer_size = 4 * 1024 * 1024;
+  config_.media_config.sctp.receive_buffer_size = 4 * 1024 * 1024;
+  MeasureDataChannelThroughput(256, 64 * 1024);
+}
+
 // Verifies that a DataChannel created after the negotiation can transition to
 // "OPEN" and transfer data.
 TEST_F(PeerConnectionEndToEndTest, CreateDataChannelAfterNegotiate) {
@@ -124,6 +124,11 @@ PeerConnectionFactory::PeerConnectionFactory(
 PeerConnectionFactory::~PeerConnectionFactory() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   channel_manager_.reset(nullptr);
+  // The peer connections, and with them their calls, are gone by now.
+  if (shared_call_threads_) {
+    worker_thread_->Invoke<void>(RTC_FROM_HERE,
+                                 [this] { shared_call_threads_.reset(); });
+  }
 
   // Make sure |worker_thread_| and |signaling_thread_| outlive
   // |default_socket_factory_| and |default_network_manager_|.
@@ -177,6 +182,10 @@ void PeerConnectionFactory::SetOptions(const Options& options) {
   if (channel_manager_) {
     channel_manager_->SetCryptoOptions(options.crypto_options);
   }
+  if (options.share_call_threads && !shared_call_threads_) {
+    shared_call_threads_.reset(worker_thread_->Invoke<SharedCallThreads*>(
+        RTC_FROM_HERE, [] { return new SharedCallThreads(); }));
+  }
 }
 
 rtc::scoped_refptr<AudioSourceInterface>
@@ -304,8 +313,9 @@ PeerConnectionFactory::CreateAudioTrack(const std::string& id,
 webrtc::MediaControllerInterface* PeerConnectionFactory::CreateMediaController(
     const cricket::MediaConfig& config) const {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  return MediaControllerInterface::Create(config, worker_thread_,
-                                          channel_manager_.get());
+  return MediaControllerInterface::Create(
+      config, worker_thread_, channel_manager_.get(),
+      options_.share_call_threads ? shared_call_threads_.get() : nullptr);
 }
 
 cricket::TransportController* PeerConnectionFactory::CreateTransportController(
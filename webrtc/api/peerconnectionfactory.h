@@ -132,6 +132,8 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   std::unique_ptr<cricket::WebRtcVideoDecoderFactory> video_decoder_factory_;
   std::unique_ptr<rtc::BasicNetworkManager> default_network_manager_;
   std::unique_ptr<rtc::BasicPacketSocketFactory> default_socket_factory_;
+  // Created on the worker thread when sharing is first enabled.
+  std::unique_ptr<SharedCallThreads> shared_call_threads_;
 };
 
 }  // namespace webrtc
@@ -63,6 +63,7 @@
 #include "webrtc/api/rtcstatscollector.h"
 #include "webrtc/api/rtpreceiverinterface.h"
 #include "webrtc/api/rtpsenderinterface.h"
+#include "webrtc/api/rtpsnapshot.h"
 #include "webrtc/api/statstypes.h"
 #include "webrtc/api/umametrics.h"
 #include "webrtc/base/fileutils.h"
@@ -270,6 +271,13 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
     bool dscp() { return media_config.enable_dscp; }
     void set_dscp(bool enable) { media_config.enable_dscp = enable; }
 
+    bool network_thread_packet_delivery() {
+      return media_config.deliver_packets_on_network_thread;
+    }
+    void set_network_thread_packet_delivery(bool enable) {
+      media_config.deliver_packets_on_network_thread = enable;
+    }
+
     // TODO(nisse): The corresponding flag in MediaConfig and
     // elsewhere should be renamed enable_cpu_adaptation.
     bool cpu_adaptation() {
@@ -438,6 +446,11 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
     return std::vector<rtc::scoped_refptr<RtpReceiverInterface>>();
   }
 
+  // Returns the senders and receivers along with the state of each and of
+  // its track. Through the proxy, this is a single trip to the signaling
+  // thread, where calling each getter is one per call.
+  virtual RtpSnapshot GetRtpSnapshot() const { return RtpSnapshot(); }
+
   virtual bool GetStats(StatsObserver* observer,
                         MediaStreamTrackInterface* track,
                         StatsOutputLevel level) = 0;
@@ -638,7 +651,8 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
           disable_network_monitor(false),
           network_ignore_mask(rtc::kDefaultNetworkIgnoreMask),
           ssl_max_version(rtc::SSL_PROTOCOL_DTLS_12),
-          crypto_options(rtc::CryptoOptions::NoGcm()) {}
+          crypto_options(rtc::CryptoOptions::NoGcm()),
+          share_call_threads(false) {}
     bool disable_encryption;
     bool disable_sctp_data_channels;
     bool disable_network_monitor;
@@ -655,6 +669,13 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
 
     // Sets crypto related options, e.g. enabled cipher suites.
     rtc::CryptoOptions crypto_options;
+
+    // If true, the webrtc::Calls of peer connections created afterwards share
+    // one module process thread, pacer thread and task queue, instead of
+    // starting three threads per peer connection with media. Each peer
+    // connection keeps its own congestion control. For servers hosting many
+    // peer connections.
+    bool share_call_threads;
   };
 
   virtual void SetOptions(const Options& options) = 0;
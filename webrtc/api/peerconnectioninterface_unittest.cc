@@ -263,7 +263,10 @@ using webrtc::ObserverInterface;
 using webrtc::PeerConnectionInterface;
 using webrtc::PeerConnectionObserver;
 using webrtc::RtpReceiverInterface;
+using webrtc::RtpReceiverSnapshot;
 using webrtc::RtpSenderInterface;
+using webrtc::RtpSenderSnapshot;
+using webrtc::RtpSnapshot;
 using webrtc::SdpParseError;
 using webrtc::SessionDescriptionInterface;
 using webrtc::StreamCollection;
@@ -1542,6 +1545,48 @@ TEST_F(PeerConnectionInterfaceTest, CreateSenderWithStream) {
   EXPECT_EQ(kStreamLabel1, video_desc->streams()[0].sync_label);
 }
 
+// Test that the RTP snapshot matches what the getters of the senders,
+// receivers and their tracks return.
+TEST_F(PeerConnectionInterfaceTest, GetRtpSnapshot) {
+  InitiateCall();
+  pc_->CreateSender("video", kStreamLabel1);
+  auto senders = pc_->GetSenders();
+  auto receivers = pc_->GetReceivers();
+  ASSERT_EQ(3u, senders.size());
+  ASSERT_LT(0u, receivers.size());
+
+  RtpSnapshot snapshot = pc_->GetRtpSnapshot();
+  ASSERT_EQ(senders.size(), snapshot.senders.size());
+  for (size_t i = 0; i < senders.size(); ++i) {
+    const RtpSenderSnapshot& sender = snapshot.senders[i];
+    EXPECT_EQ(senders[i], sender.sender);
+    EXPECT_EQ(senders[i]->id(), sender.id);
+    EXPECT_EQ(senders[i]->media_type(), sender.media_type);
+    EXPECT_EQ(senders[i]->ssrc(), sender.ssrc);
+    EXPECT_EQ(senders[i]->stream_ids(), sender.stream_ids);
+    rtc::scoped_refptr<MediaStreamTrackInterface> track = senders[i]->track();
+    ASSERT_EQ(track != nullptr, sender.has_track);
+    if (track) {
+      EXPECT_EQ(track->id(), sender.track.id);
+      EXPECT_EQ(track->kind(), sender.track.kind);
+      EXPECT_EQ(track->enabled(), sender.track.enabled);
+      EXPECT_EQ(track->state(), sender.track.state);
+    }
+  }
+  // The sender created without a track.
+  EXPECT_FALSE(snapshot.senders.back().has_track);
+
+  ASSERT_EQ(receivers.size(), snapshot.receivers.size());
+  for (size_t i = 0; i < receivers.size(); ++i) {
+    const RtpReceiverSnapshot& receiver = snapshot.receivers[i];
+    EXPECT_EQ(receivers[i], receiver.receiver);
+    EXPECT_EQ(receivers[i]->id(), receiver.id);
+    EXPECT_EQ(receivers[i]->media_type(), receiver.media_type);
+    EXPECT_EQ(receivers[i]->track()->id(), receiver.track.id);
+    EXPECT_EQ(receivers[i]->track()->state(), receiver.track.state);
+  }
+}
+
 // Test that we can specify a certain track that we want statistics about.
 TEST_F(PeerConnectionInterfaceTest, GetStatsForSpecificTrack) {
   InitiateCall();
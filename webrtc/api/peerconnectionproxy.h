@@ -39,6 +39,7 @@ BEGIN_SIGNALING_PROXY_MAP(PeerConnection)
                      GetSenders)
   PROXY_CONSTMETHOD0(std::vector<rtc::scoped_refptr<RtpReceiverInterface>>,
                      GetReceivers)
+  PROXY_CONSTMETHOD0(RtpSnapshot, GetRtpSnapshot)
   PROXY_METHOD3(bool, GetStats, StatsObserver*,
                 MediaStreamTrackInterface*,
                 StatsOutputLevel)
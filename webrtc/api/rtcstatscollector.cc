@@ -47,7 +47,24 @@ void RTCStatsCollector::GetStatsReport(
   RTC_DCHECK(signaling_thread_->IsCurrent());
   RTC_DCHECK(callback);
   callbacks_.push_back(callback);
+  GatherStatsReportIfNeeded();
+}
+
+void RTCStatsCollector::GetDeltaStatsReport(
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK(callback);
+  delta_callbacks_.push_back(callback);
+  GatherStatsReportIfNeeded();
+}
+
+void RTCStatsCollector::ClearCachedStatsReport() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  cached_report_ = nullptr;
+}
 
+void RTCStatsCollector::GatherStatsReportIfNeeded() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
   // "Now" using a monotonically increasing timer.
   int64_t cache_now_us = rtc::TimeMicros();
   if (cached_report_ &&
@@ -69,6 +86,14 @@ void RTCStatsCollector::GetStatsReport(
     invoker_.AsyncInvoke<void>(RTC_FROM_HERE, signaling_thread_,
         rtc::Bind(&RTCStatsCollector::ProducePartialResultsOnSignalingThread,
             rtc::scoped_refptr<RTCStatsCollector>(this), timestamp_us));
+    if (worker_thread_ == network_thread_) {
+      // One hop does for both.
+      invoker_.AsyncInvoke<void>(RTC_FROM_HERE, worker_thread_,
+          rtc::Bind(
+              &RTCStatsCollector::ProducePartialResultsOnWorkerAndNetworkThread,
+              rtc::scoped_refptr<RTCStatsCollector>(this), timestamp_us));
+      return;
+    }
     invoker_.AsyncInvoke<void>(RTC_FROM_HERE, worker_thread_,
         rtc::Bind(&RTCStatsCollector::ProducePartialResultsOnWorkerThread,
             rtc::scoped_refptr<RTCStatsCollector>(this), timestamp_us));
@@ -78,11 +103,6 @@ void RTCStatsCollector::GetStatsReport(
   }
 }
 
-void RTCStatsCollector::ClearCachedStatsReport() {
-  RTC_DCHECK(signaling_thread_->IsCurrent());
-  cached_report_ = nullptr;
-}
-
 void RTCStatsCollector::ProducePartialResultsOnSignalingThread(
     int64_t timestamp_us) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
@@ -113,6 +133,12 @@ void RTCStatsCollector::ProducePartialResultsOnNetworkThread(
   AddPartialResults(report);
 }
 
+void RTCStatsCollector::ProducePartialResultsOnWorkerAndNetworkThread(
+    int64_t timestamp_us) {
+  ProducePartialResultsOnWorkerThread(timestamp_us);
+  ProducePartialResultsOnNetworkThread(timestamp_us);
+}
+
 void RTCStatsCollector::AddPartialResults(
     const rtc::scoped_refptr<RTCStatsReport>& partial_report) {
   if (!signaling_thread_->IsCurrent()) {
@@ -144,13 +170,35 @@ void RTCStatsCollector::AddPartialResults_s(
 
 void RTCStatsCollector::DeliverCachedReport() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  RTC_DCHECK(!callbacks_.empty());
+  RTC_DCHECK(!callbacks_.empty() || !delta_callbacks_.empty());
   RTC_DCHECK(cached_report_);
   for (const rtc::scoped_refptr<RTCStatsCollectorCallback>& callback :
        callbacks_) {
     callback->OnStatsDelivered(cached_report_);
   }
   callbacks_.clear();
+  if (delta_callbacks_.empty())
+    return;
+  rtc::scoped_refptr<const RTCStatsReport> delta_report = CreateDeltaReport();
+  delta_base_report_ = cached_report_;
+  for (const rtc::scoped_refptr<RTCStatsCollectorCallback>& callback :
+       delta_callbacks_) {
+    callback->OnStatsDelivered(delta_report);
+  }
+  delta_callbacks_.clear();
+}
+
+rtc::scoped_refptr<const RTCStatsReport>
+RTCStatsCollector::CreateDeltaReport() const {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  rtc::scoped_refptr<RTCStatsReport> delta_report = RTCStatsReport::Create();
+  for (const RTCStats& stats : *cached_report_) {
+    const RTCStats* base_stats =
+        delta_base_report_ ? delta_base_report_->Get(stats.id()) : nullptr;
+    if (!base_stats || *base_stats != stats)
+      delta_report->AddStats(stats.copy());
+  }
+  return delta_report;
 }
 
 std::unique_ptr<RTCPeerConnectionStats>
@@ -48,6 +48,12 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface {
   // considered fresh for |cache_lifetime_| ms. const RTCStatsReports are safe
   // to use across multiple threads and may be destructed on any thread.
   void GetStatsReport(rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
+  // Like |GetStatsReport|, except that the report only contains the stats that
+  // are new or have changed since the previous delta report was delivered, for
+  // pollers that only care about what changed. The first delta report contains
+  // all stats. Stats that no longer exist are not reported.
+  void GetDeltaStatsReport(
+      rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
   // Clears the cache's reference to the most recent stats report. Subsequently
   // calling |GetStatsReport| guarantees fresh stats.
   void ClearCachedStatsReport();
@@ -66,8 +72,11 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface {
       const rtc::scoped_refptr<RTCStatsReport>& partial_report);
 
  private:
+  void GatherStatsReportIfNeeded();
+  void ProducePartialResultsOnWorkerAndNetworkThread(int64_t timestamp_us);
   void AddPartialResults_s(rtc::scoped_refptr<RTCStatsReport> partial_report);
   void DeliverCachedReport();
+  rtc::scoped_refptr<const RTCStatsReport> CreateDeltaReport() const;
 
   std::unique_ptr<RTCPeerConnectionStats> ProducePeerConnectionStats_s(
       int64_t timestamp_us) const;
@@ -82,6 +91,7 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface {
   int64_t partial_report_timestamp_us_;
   rtc::scoped_refptr<RTCStatsReport> partial_report_;
   std::vector<rtc::scoped_refptr<RTCStatsCollectorCallback>> callbacks_;
+  std::vector<rtc::scoped_refptr<RTCStatsCollectorCallback>> delta_callbacks_;
 
   // A timestamp, in microseconds, that is based on a timer that is
   // monotonically increasing. That is, even if the system clock is modified the
@@ -90,6 +100,8 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface {
   int64_t cache_timestamp_us_;
   int64_t cache_lifetime_us_;
   rtc::scoped_refptr<const RTCStatsReport> cached_report_;
+  // The report that the previous delta report was made from.
+  rtc::scoped_refptr<const RTCStatsReport> delta_base_report_;
 };
 
 }  // namespace webrtc
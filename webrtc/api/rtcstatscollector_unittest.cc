@@ -253,6 +253,13 @@ class RTCStatsCollectorTest : public testing::Test {
     return callback->report();
   }
 
+  rtc::scoped_refptr<const RTCStatsReport> GetDeltaStatsReport() {
+    rtc::scoped_refptr<StatsCallback> callback = StatsCallback::Create();
+    collector_->GetDeltaStatsReport(callback);
+    EXPECT_TRUE_WAIT(callback->report(), kGetStatsReportTimeoutMs);
+    return callback->report();
+  }
+
  protected:
   rtc::scoped_refptr<RTCStatsCollectorTestHelper> test_;
   rtc::scoped_refptr<RTCStatsCollector> collector_;
@@ -358,6 +365,29 @@ TEST_F(RTCStatsCollectorTest, CollectRTCPeerConnectionStats) {
   }
 }
 
+TEST_F(RTCStatsCollectorTest, DeltaStatsReports) {
+  // The first delta report has everything.
+  rtc::scoped_refptr<const RTCStatsReport> delta = GetDeltaStatsReport();
+  EXPECT_TRUE(delta->Get("RTCPeerConnection"));
+
+  // Nothing has changed since.
+  collector_->ClearCachedStatsReport();
+  delta = GetDeltaStatsReport();
+  EXPECT_EQ(static_cast<size_t>(0), delta->size());
+  // Full reports are not affected.
+  EXPECT_TRUE(GetStatsReport()->Get("RTCPeerConnection"));
+
+  test_->data_channels().push_back(
+      new MockDataChannel(DataChannelInterface::kOpen));
+  collector_->ClearCachedStatsReport();
+  delta = GetDeltaStatsReport();
+  EXPECT_EQ(static_cast<size_t>(1), delta->size());
+  const RTCStats* stats = delta->Get("RTCPeerConnection");
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(*stats->cast_to<RTCPeerConnectionStats>().data_channels_opened,
+            static_cast<uint32_t>(1));
+}
+
 class RTCStatsCollectorTestWithFakeCollector : public testing::Test {
  public:
   RTCStatsCollectorTestWithFakeCollector()
@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file contains copies of the state of RtpSenders and RtpReceivers, for
+// reading all of it with a single call to the signaling thread.
+
+#ifndef WEBRTC_API_RTPSNAPSHOT_H_
+#define WEBRTC_API_RTPSNAPSHOT_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "webrtc/api/mediastreaminterface.h"
+#include "webrtc/api/rtpreceiverinterface.h"
+#include "webrtc/api/rtpsenderinterface.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+
+namespace webrtc {
+
+// The state of a track at the time of a snapshot.
+struct MediaStreamTrackSnapshot {
+  std::string id;
+  std::string kind;
+  bool enabled = false;
+  MediaStreamTrackInterface::TrackState state =
+      MediaStreamTrackInterface::kEnded;
+};
+
+struct RtpSenderSnapshot {
+  // For calls beyond the snapshot.
+  rtc::scoped_refptr<RtpSenderInterface> sender;
+  std::string id;
+  cricket::MediaType media_type = cricket::MEDIA_TYPE_AUDIO;
+  uint32_t ssrc = 0;
+  std::vector<std::string> stream_ids;
+  // False if the sender has no track, in which case |track| is unset.
+  bool has_track = false;
+  MediaStreamTrackSnapshot track;
+};
+
+struct RtpReceiverSnapshot {
+  // For calls beyond the snapshot.
+  rtc::scoped_refptr<RtpReceiverInterface> receiver;
+  std::string id;
+  cricket::MediaType media_type = cricket::MEDIA_TYPE_AUDIO;
+  MediaStreamTrackSnapshot track;
+};
+
+// What PeerConnectionInterface::GetSenders() and GetReceivers() return, with
+// the state each of their getters would, taken all at once. The parameters
+// are left out, since reading them takes a trip to the worker thread each.
+struct RtpSnapshot {
+  std::vector<RtpSenderSnapshot> senders;
+  std::vector<RtpReceiverSnapshot> receivers;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_API_RTPSNAPSHOT_H_
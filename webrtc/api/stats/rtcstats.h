@@ -66,9 +66,21 @@ class RTCStats {
   // this class. This allows for iteration of members.
   std::vector<const RTCStatsMemberInterface*> Members() const;
 
+  // Checks if the two stats objects are of the same type and have the same
+  // member values. The timestamps are not compared.
+  bool operator==(const RTCStats& other) const;
+  bool operator!=(const RTCStats& other) const;
+
   // Creates a human readable string representation of the report, listing all
   // of its members (names and values).
   std::string ToString() const;
+  // Creates a JSON object of the stats, e.g.
+  // {"type":"...","id":"...","timestamp":123,"fooBar":1.5}, where undefined
+  // members are left out. AppendJson() writes into an existing string instead,
+  // so that many stats can be serialized into one buffer
+  // (see RTCStatsReport::ToJson()).
+  std::string ToJson() const;
+  void AppendJson(std::string* json) const;
 
   // Downcasts the stats object to an |RTCStats| subclass |T|. DCHECKs that the
   // object is of type |T|.
@@ -188,7 +200,18 @@ class RTCStatsMemberInterface {
   virtual bool is_sequence() const = 0;
   virtual bool is_string() const = 0;
   bool is_defined() const { return is_defined_; }
+  // Members are equal if they are of the same type and either both undefined
+  // or both defined with the same value.
+  bool operator==(const RTCStatsMemberInterface& other) const {
+    return IsEqual(other);
+  }
+  bool operator!=(const RTCStatsMemberInterface& other) const {
+    return !(*this == other);
+  }
   virtual std::string ValueToString() const = 0;
+  // Appends the value to |json| as a JSON value. Strings are quoted and
+  // escaped, and non-finite doubles become null. Must be defined.
+  virtual void AppendValueJson(std::string* json) const = 0;
 
   template<typename T>
   const T& cast_to() const {
@@ -200,6 +223,8 @@ class RTCStatsMemberInterface {
   RTCStatsMemberInterface(const char* name, bool is_defined)
       : name_(name), is_defined_(is_defined) {}
 
+  virtual bool IsEqual(const RTCStatsMemberInterface& other) const = 0;
+
   const char* const name_;
   bool is_defined_;
 };
@@ -233,6 +258,7 @@ class RTCStatsMember : public RTCStatsMemberInterface {
   bool is_sequence() const override;
   bool is_string() const override;
   std::string ValueToString() const override;
+  void AppendValueJson(std::string* json) const override;
 
   // Assignment operators.
   T& operator=(const T& value) {
@@ -272,6 +298,14 @@ class RTCStatsMember : public RTCStatsMemberInterface {
     return &value_;
   }
 
+ protected:
+  bool IsEqual(const RTCStatsMemberInterface& other) const override {
+    if (type() != other.type() || is_defined_ != other.is_defined())
+      return false;
+    return !is_defined_ ||
+           value_ == static_cast<const RTCStatsMember<T>&>(other).value_;
+  }
+
  private:
   T value_;
 };
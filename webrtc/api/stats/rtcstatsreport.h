@@ -65,6 +65,10 @@ class RTCStatsReport : public rtc::RefCountInterface {
   ConstIterator begin() const;
   ConstIterator end() const;
 
+  // Creates a JSON array of all the stats, in iteration order, with each
+  // element as given by RTCStats::ToJson().
+  std::string ToJson() const;
+
   // Gets the subset of stats that are of type |T|, where |T| is any class
   // descending from |RTCStats|.
   template<typename T>
@@ -10,6 +10,7 @@
 
 #include "webrtc/api/statscollector.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -17,6 +18,7 @@
 #include "webrtc/api/peerconnection.h"
 #include "webrtc/base/base64.h"
 #include "webrtc/base/checks.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/pc/channel.h"
 
 namespace webrtc {
@@ -374,6 +376,17 @@ StatsCollector::StatsCollector(PeerConnection* pc)
 
 StatsCollector::~StatsCollector() {
   RTC_DCHECK(pc_->session()->signaling_thread()->IsCurrent());
+  StopMediaMonitors();
+}
+
+void StatsCollector::SetMediaStatsSnapshotInterval(int interval_ms) {
+  RTC_DCHECK(pc_->session()->signaling_thread()->IsCurrent());
+  RTC_DCHECK_GE(interval_ms, 0);
+  if (interval_ms != media_stats_interval_ms_) {
+    // Monitors are restarted at the new interval as the stats are needed.
+    StopMediaMonitors();
+  }
+  media_stats_interval_ms_ = interval_ms;
 }
 
 // Wallclock time in ms.
@@ -745,6 +758,68 @@ void StatsCollector::ExtractSessionInfo() {
   }
 }
 
+template <class Channel, class Info>
+bool StatsCollector::GetMediaStats(Channel* channel,
+                                   MediaStatsSnapshot<Channel, Info>* snapshot,
+                                   Info* info) {
+  if (!media_stats_interval_ms_) {
+    return channel->GetStats(info);
+  }
+  int64_t now = rtc::TimeMillis();
+  if (snapshot->channel == channel && snapshot->received_ms >= 0 &&
+      now - snapshot->received_ms <= 2 * media_stats_interval_ms_) {
+    *info = snapshot->info;
+    return true;
+  }
+  // Snapshots come in every interval while the monitor runs. Much longer
+  // without one means it doesn't, for example because the channel was
+  // replaced by another at the same address.
+  int64_t last_heard_ms = std::max(snapshot->started_ms, snapshot->received_ms);
+  if (snapshot->channel != channel ||
+      now - last_heard_ms > 4 * media_stats_interval_ms_) {
+    channel->SignalMediaMonitor.disconnect(this);
+    channel->SignalMediaMonitor.connect(this, &StatsCollector::OnMediaMonitor);
+    channel->StartMediaMonitor(media_stats_interval_ms_);
+    snapshot->channel = channel;
+    snapshot->started_ms = now;
+    snapshot->received_ms = -1;
+  }
+  // Until the first snapshot arrives.
+  return channel->GetStats(info);
+}
+
+void StatsCollector::OnMediaMonitor(cricket::VoiceChannel* channel,
+                                    const cricket::VoiceMediaInfo& info) {
+  if (channel == voice_snapshot_.channel) {
+    voice_snapshot_.info = info;
+    voice_snapshot_.received_ms = rtc::TimeMillis();
+  }
+}
+
+void StatsCollector::OnMediaMonitor(cricket::VideoChannel* channel,
+                                    const cricket::VideoMediaInfo& info) {
+  if (channel == video_snapshot_.channel) {
+    video_snapshot_.info = info;
+    video_snapshot_.received_ms = rtc::TimeMillis();
+  }
+}
+
+void StatsCollector::StopMediaMonitors() {
+  // Only the monitors of channels that are still around can be stopped.
+  if (voice_snapshot_.channel &&
+      voice_snapshot_.channel == pc_->session()->voice_channel()) {
+    voice_snapshot_.channel->StopMediaMonitor();
+    voice_snapshot_.channel->SignalMediaMonitor.disconnect(this);
+  }
+  if (video_snapshot_.channel &&
+      video_snapshot_.channel == pc_->session()->video_channel()) {
+    video_snapshot_.channel->StopMediaMonitor();
+    video_snapshot_.channel->SignalMediaMonitor.disconnect(this);
+  }
+  voice_snapshot_ = VoiceSnapshot();
+  video_snapshot_ = VideoSnapshot();
+}
+
 void StatsCollector::ExtractVoiceInfo() {
   RTC_DCHECK(pc_->session()->signaling_thread()->IsCurrent());
 
@@ -752,7 +827,8 @@ void StatsCollector::ExtractVoiceInfo() {
     return;
   }
   cricket::VoiceMediaInfo voice_info;
-  if (!pc_->session()->voice_channel()->GetStats(&voice_info)) {
+  if (!GetMediaStats(pc_->session()->voice_channel(), &voice_snapshot_,
+                     &voice_info)) {
     LOG(LS_ERROR) << "Failed to get voice channel stats.";
     return;
   }
@@ -785,7 +861,8 @@ void StatsCollector::ExtractVideoInfo(
     return;
 
   cricket::VideoMediaInfo video_info;
-  if (!pc_->session()->video_channel()->GetStats(&video_info)) {
+  if (!GetMediaStats(pc_->session()->video_channel(), &video_snapshot_,
+                     &video_info)) {
     LOG(LS_ERROR) << "Failed to get video channel stats.";
     return;
   }
@@ -22,6 +22,8 @@
 #include "webrtc/api/peerconnectioninterface.h"
 #include "webrtc/api/statstypes.h"
 #include "webrtc/api/webrtcsession.h"
+#include "webrtc/base/sigslot.h"
+#include "webrtc/media/base/mediachannel.h"
 
 namespace webrtc {
 
@@ -39,7 +41,7 @@ const char* AdapterTypeToStatsType(rtc::AdapterType type);
 // A mapping between track ids and their StatsReport.
 typedef std::map<std::string, StatsReport*> TrackIdMap;
 
-class StatsCollector {
+class StatsCollector : public sigslot::has_slots<> {
  public:
   // The caller is responsible for ensuring that the pc outlives the
   // StatsCollector instance.
@@ -57,6 +59,13 @@ class StatsCollector {
   // statistics.
   void RemoveLocalAudioTrack(AudioTrackInterface* audio_track, uint32_t ssrc);
 
+  // Makes UpdateStats() use the voice and video stats that the channels'
+  // media monitors deliver every |interval_ms|, instead of invoking onto the
+  // worker thread for them, which then isn't blocked on by the signaling
+  // thread. The stats can then be up to |interval_ms| old. 0, the default,
+  // turns this off.
+  void SetMediaStatsSnapshotInterval(int interval_ms);
+
   // Gather statistics from the session and store them for future use.
   void UpdateStats(PeerConnectionInterface::StatsOutputLevel level);
 
@@ -129,6 +138,31 @@ class StatsCollector {
   // Helper method to update the timestamp of track records.
   void UpdateTrackReports();
 
+  // The latest stats delivered by a channel's media monitor.
+  template <class Channel, class Info>
+  struct MediaStatsSnapshot {
+    Channel* channel = nullptr;
+    Info info;
+    // When the monitor was started, and when it last delivered |info|.
+    int64_t started_ms = -1;
+    int64_t received_ms = -1;
+  };
+  typedef MediaStatsSnapshot<cricket::VoiceChannel, cricket::VoiceMediaInfo>
+      VoiceSnapshot;
+  typedef MediaStatsSnapshot<cricket::VideoChannel, cricket::VideoMediaInfo>
+      VideoSnapshot;
+  // Gets the stats of |channel| from |snapshot| if it's fresh, otherwise from
+  // the channel itself, (re)starting its media monitor if need be.
+  template <class Channel, class Info>
+  bool GetMediaStats(Channel* channel,
+                     MediaStatsSnapshot<Channel, Info>* snapshot,
+                     Info* info);
+  void OnMediaMonitor(cricket::VoiceChannel* channel,
+                      const cricket::VoiceMediaInfo& info);
+  void OnMediaMonitor(cricket::VideoChannel* channel,
+                      const cricket::VideoMediaInfo& info);
+  void StopMediaMonitors();
+
   // A collection for all of our stats reports.
   StatsCollection reports_;
   TrackIdMap track_ids_;
@@ -142,6 +176,10 @@ class StatsCollector {
   typedef std::vector<std::pair<AudioTrackInterface*, uint32_t> >
       LocalAudioTrackVector;
   LocalAudioTrackVector local_audio_tracks_;
+
+  int media_stats_interval_ms_ = 0;
+  VoiceSnapshot voice_snapshot_;
+  VideoSnapshot video_snapshot_;
 };
 
 }  // namespace webrtc
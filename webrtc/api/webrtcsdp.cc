@@ -15,13 +15,16 @@
 #include <stdio.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include "webrtc/api/jsepicecandidate.h"
 #include "webrtc/api/jsepsessiondescription.h"
+#include "webrtc/base/array_view.h"
 #include "webrtc/base/arraysize.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/logging.h"
@@ -434,12 +437,12 @@ static bool GetLine(const std::string& message,
   if (line_end == std::string::npos) {
     return false;
   }
-  // Update the new start position
-  *pos = line_end + 1;
-  if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
+  size_t next_pos = line_end + 1;
+  if (line_end > line_begin && (message[line_end - 1] == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Callers reuse |line| for every line, so this rarely allocates.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -452,9 +455,64 @@ static bool GetLine(const std::string& message,
       !islower(cline[0]) ||
       cline[1] != kSdpDelimiterEqual ||
       cline[2] == kSdpDelimiterSpace) {
-    *pos = line_begin;
     return false;
   }
+  *pos = next_pos;
+  return true;
+}
+
+// A field of an SDP line. It points into the line rather than holding a copy,
+// so that splitting a line doesn't allocate a string per field.
+typedef rtc::ArrayView<const char> SdpField;
+
+static SdpField ToField(const std::string& s, size_t pos = 0) {
+  return pos < s.size() ? SdpField(s.data() + pos, s.size() - pos)
+                        : SdpField();
+}
+
+static std::string FieldToString(SdpField field) {
+  return std::string(field.data(), field.size());
+}
+
+static bool FieldEquals(SdpField field, const char* s) {
+  size_t length = strlen(s);
+  return field.size() == length &&
+         std::equal(field.begin(), field.end(), s);
+}
+
+// Splits |line| at every |delimiter| into |fields|, producing the same fields
+// as rtc::split() but without copying them. Reusing |fields| across lines
+// avoids allocations altogether.
+static void SplitFields(SdpField line,
+                        char delimiter,
+                        std::vector<SdpField>* fields) {
+  fields->clear();
+  const char* field_begin = line.begin();
+  for (const char* it = line.begin(); it != line.end(); ++it) {
+    if (*it == delimiter) {
+      fields->push_back(SdpField(field_begin, it - field_begin));
+      field_begin = it + 1;
+    }
+  }
+  fields->push_back(SdpField(field_begin, line.end() - field_begin));
+}
+
+// Like rtc::tokenize_first(): splits |source| at the first run of
+// |delimiter|s into |token| and |rest|.
+static bool TokenizeFirstField(SdpField source,
+                               char delimiter,
+                               SdpField* token,
+                               SdpField* rest) {
+  const char* left = std::find(source.begin(), source.end(), delimiter);
+  if (left == source.end()) {
+    return false;
+  }
+  const char* right = left + 1;
+  while (right != source.end() && *right == delimiter) {
+    ++right;
+  }
+  *token = SdpField(source.begin(), left - source.begin());
+  *rest = SdpField(right, source.end() - right);
   return true;
 }
 
@@ -550,12 +608,50 @@ static bool CaseInsensitiveFind(std::string str1, std::string str2) {
   return str1.find(str2) != std::string::npos;
 }
 
+// Parses |s| as a plain decimal number fitting in |T|, which is how nearly
+// every number in SDP is written, without the cost of a stream. Anything else
+// is left to rtc::FromString().
+template <class T>
+static bool GetDecimalFromString(const char* s, size_t length, T* t) {
+  if (length == 0 || length > 19) {
+    return false;
+  }
+  uint64_t value = 0;
+  for (size_t i = 0; i < length; ++i) {
+    if (s[i] < '0' || s[i] > '9') {
+      return false;
+    }
+    value = value * 10 + (s[i] - '0');
+  }
+  if (value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+    return false;
+  }
+  *t = static_cast<T>(value);
+  return true;
+}
+
+template <class T>
+static typename std::enable_if<std::is_integral<T>::value &&
+                                   !std::is_same<T, bool>::value,
+                               bool>::type
+FromStringFast(const std::string& s, T* t) {
+  return GetDecimalFromString(s.data(), s.size(), t) || rtc::FromString(s, t);
+}
+
+template <class T>
+static typename std::enable_if<!std::is_integral<T>::value ||
+                                   std::is_same<T, bool>::value,
+                               bool>::type
+FromStringFast(const std::string& s, T* t) {
+  return rtc::FromString(s, t);
+}
+
 template <class T>
 static bool GetValueFromString(const std::string& line,
                                const std::string& s,
                                T* t,
                                SdpParseError* error) {
-  if (!rtc::FromString(s, t)) {
+  if (!FromStringFast(s, t)) {
     std::ostringstream description;
     description << "Invalid value: " << s << ".";
     return ParseFailed(line, description.str(), error);
@@ -563,6 +659,17 @@ static bool GetValueFromString(const std::string& line,
   return true;
 }
 
+template <class T>
+static bool GetValueFromString(const std::string& line,
+                               SdpField field,
+                               T* t,
+                               SdpParseError* error) {
+  if (GetDecimalFromString(field.data(), field.size(), t)) {
+    return true;
+  }
+  return GetValueFromString(line, FieldToString(field), t, error);
+}
+
 static bool GetPayloadTypeFromString(const std::string& line,
                                      const std::string& s,
                                      int* payload_type,
@@ -793,6 +900,19 @@ static void GetCandidatesByMindex(const SessionDescriptionInterface& desci,
   }
 }
 
+// Returns a generous estimate of the size of the serialized |jdesc|, so that
+// the message can be reserved once rather than reallocated as it grows.
+static size_t EstimateSerializedSize(const JsepSessionDescription& jdesc) {
+  const size_t kSessionSize = 256;
+  const size_t kMediaSectionSize = 2048;
+  const size_t kCandidateSize = 160;
+  size_t size = kSessionSize;
+  for (size_t i = 0; i < jdesc.number_of_mediasections(); ++i) {
+    size += kMediaSectionSize + jdesc.candidates(i)->count() * kCandidateSize;
+  }
+  return size;
+}
+
 std::string SdpSerialize(const JsepSessionDescription& jdesc,
                          bool unified_plan_sdp) {
   const cricket::SessionDescription* desc = jdesc.description();
@@ -801,6 +921,7 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc,
   }
 
   std::string message;
+  message.reserve(EstimateSerializedSize(jdesc));
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -979,16 +1100,16 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
   // a=candidate:<blah>CRLF for backward compatibility and for parsing a line
   // from the SDP.
   if (IsLineType(first_line, kLineTypeAttributes)) {
-    first_line = first_line.substr(kLinePrefixLength);
+    first_line.erase(0, kLinePrefixLength);
   }
 
-  std::string attribute_candidate;
-  std::string candidate_value;
+  SdpField attribute_candidate;
+  SdpField candidate_value;
 
   // |first_line| must be in the form of "candidate:<value>".
-  if (!rtc::tokenize_first(first_line, kSdpDelimiterColon, &attribute_candidate,
-                           &candidate_value) ||
-      attribute_candidate != kAttributeCandidate) {
+  if (!TokenizeFirstField(ToField(first_line), kSdpDelimiterColon,
+                          &attribute_candidate, &candidate_value) ||
+      !FieldEquals(attribute_candidate, kAttributeCandidate)) {
     if (is_raw) {
       std::ostringstream description;
       description << "Expect line: " << kAttributeCandidate
@@ -1000,8 +1121,11 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
     }
   }
 
-  std::vector<std::string> fields;
-  rtc::split(candidate_value, kSdpDelimiterSpace, &fields);
+  // Enough for a candidate with all the extensions we know of.
+  const size_t kMaxExpectedFields = 24;
+  std::vector<SdpField> fields;
+  fields.reserve(kMaxExpectedFields);
+  SplitFields(candidate_value, kSdpDelimiterSpace, &fields);
 
   // RFC 5245
   // a=candidate:<foundation> <component-id> <transport> <priority>
@@ -1010,21 +1134,21 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
   // *(SP extension-att-name SP extension-att-value)
   const size_t expected_min_fields = 8;
   if (fields.size() < expected_min_fields ||
-      (fields[6] != kAttributeCandidateTyp)) {
+      !FieldEquals(fields[6], kAttributeCandidateTyp)) {
     return ParseFailedExpectMinFieldNum(first_line, expected_min_fields, error);
   }
-  const std::string& foundation = fields[0];
+  std::string foundation = FieldToString(fields[0]);
 
   int component_id = 0;
   if (!GetValueFromString(first_line, fields[1], &component_id, error)) {
     return false;
   }
-  const std::string& transport = fields[2];
+  std::string transport = FieldToString(fields[2]);
   uint32_t priority = 0;
   if (!GetValueFromString(first_line, fields[3], &priority, error)) {
     return false;
   }
-  const std::string& connection_address = fields[4];
+  std::string connection_address = FieldToString(fields[4]);
   int port = 0;
   if (!GetValueFromString(first_line, fields[5], &port, error)) {
     return false;
@@ -1037,14 +1161,14 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
   }
 
   std::string candidate_type;
-  const std::string& type = fields[7];
-  if (type == kCandidateHost) {
+  SdpField type = fields[7];
+  if (FieldEquals(type, kCandidateHost)) {
     candidate_type = cricket::LOCAL_PORT_TYPE;
-  } else if (type == kCandidateSrflx) {
+  } else if (FieldEquals(type, kCandidateSrflx)) {
     candidate_type = cricket::STUN_PORT_TYPE;
-  } else if (type == kCandidateRelay) {
+  } else if (FieldEquals(type, kCandidateRelay)) {
     candidate_type = cricket::RELAY_PORT_TYPE;
-  } else if (type == kCandidatePrflx) {
+  } else if (FieldEquals(type, kCandidatePrflx)) {
     candidate_type = cricket::PRFLX_PORT_TYPE;
   } else {
     return ParseFailed(first_line, "Unsupported candidate type.", error);
@@ -1055,12 +1179,12 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
   // The 2 optional fields for related address
   // [raddr <connection-address>] [rport <port>]
   if (fields.size() >= (current_position + 2) &&
-      fields[current_position] == kAttributeCandidateRaddr) {
-    related_address.SetIP(fields[++current_position]);
+      FieldEquals(fields[current_position], kAttributeCandidateRaddr)) {
+    related_address.SetIP(FieldToString(fields[++current_position]));
     ++current_position;
   }
   if (fields.size() >= (current_position + 2) &&
-      fields[current_position] == kAttributeCandidateRport) {
+      FieldEquals(fields[current_position], kAttributeCandidateRport)) {
     int port = 0;
     if (!GetValueFromString(
         first_line, fields[++current_position], &port, error)) {
@@ -1074,8 +1198,8 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
   // RFC 6544.
   std::string tcptype;
   if (fields.size() >= (current_position + 2) &&
-      fields[current_position] == kTcpCandidateType) {
-    tcptype = fields[++current_position];
+      FieldEquals(fields[current_position], kTcpCandidateType)) {
+    tcptype = FieldToString(fields[++current_position]);
     ++current_position;
 
     if (tcptype != cricket::TCPTYPE_ACTIVE_STR &&
@@ -1101,19 +1225,19 @@ bool ParseCandidate(const std::string& message, Candidate* candidate,
   for (size_t i = current_position; i + 1 < fields.size(); ++i) {
     // RFC 5245
     // *(SP extension-att-name SP extension-att-value)
-    if (fields[i] == kAttributeCandidateGeneration) {
+    if (FieldEquals(fields[i], kAttributeCandidateGeneration)) {
       if (!GetValueFromString(first_line, fields[++i], &generation, error)) {
         return false;
       }
-    } else if (fields[i] == kAttributeCandidateUfrag) {
-      username = fields[++i];
-    } else if (fields[i] == kAttributeCandidatePwd) {
-      password = fields[++i];
-    } else if (fields[i] == kAttributeCandidateNetworkId) {
+    } else if (FieldEquals(fields[i], kAttributeCandidateUfrag)) {
+      username = FieldToString(fields[++i]);
+    } else if (FieldEquals(fields[i], kAttributeCandidatePwd)) {
+      password = FieldToString(fields[++i]);
+    } else if (FieldEquals(fields[i], kAttributeCandidateNetworkId)) {
       if (!GetValueFromString(first_line, fields[++i], &network_id, error)) {
         return false;
       }
-    } else if (fields[i] == kAttributeCandidateNetworkCost) {
+    } else if (FieldEquals(fields[i], kAttributeCandidateNetworkCost)) {
       if (!GetValueFromString(first_line, fields[++i], &network_cost, error)) {
         return false;
       }
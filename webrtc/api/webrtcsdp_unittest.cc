@@ -24,6 +24,7 @@
 #include "webrtc/base/sslfingerprint.h"
 #include "webrtc/base/stringencode.h"
 #include "webrtc/base/stringutils.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/media/base/mediaconstants.h"
 #include "webrtc/media/engine/webrtcvideoengine2.h"
 #include "webrtc/modules/video_coding/codecs/h264/include/h264.h"
@@ -3183,3 +3184,49 @@ TEST_F(WebRtcSdpTest, SerializeUnifiedPlanSessionDescription) {
   MakeUnifiedPlanDescription();
   TestSerialize(jdesc_, true);
 }
+
+// Measures the cost of parsing and serializing a large offer: the reference
+// SDP with 100 more candidates and a simulcast group of 20 more SSRCs.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(WebRtcSdpTest, DISABLED_ParseAndSerializeLargeSdp) {
+  const int kCandidates = 100;
+  const int kSsrcs = 20;
+  const int kIterations = 1000;
+  std::string sdp = kSdpFullString;
+  std::string candidates;
+  for (int i = 0; i < kCandidates; ++i) {
+    candidates += "a=candidate:a0+B/" + rtc::ToString(10 + i) + " " +
+                  rtc::ToString(1 + i % 2) + " udp 2130706432 192.168.1." +
+                  rtc::ToString(i % 250 + 1) + " " +
+                  rtc::ToString(10000 + i) + " typ host generation 2\r\n";
+  }
+  sdp.insert(sdp.find("a=ice-ufrag:ufrag_video"), candidates);
+  std::string group = "a=ssrc-group:SIM";
+  std::string ssrcs;
+  for (int i = 0; i < kSsrcs; ++i) {
+    std::string ssrc = rtc::ToString(1000 + i);
+    group += " " + ssrc;
+    ssrcs += "a=ssrc:" + ssrc + " cname:stream_1_cname\r\n";
+    ssrcs += "a=ssrc:" + ssrc + " msid:local_stream_1 video_track_id_1\r\n";
+  }
+  sdp += group + "\r\n" + ssrcs;
+
+  JsepSessionDescription jdesc(kDummyString);
+  ASSERT_TRUE(SdpDeserialize(sdp, &jdesc));
+  int64_t start = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i) {
+    JsepSessionDescription parsed(kDummyString);
+    SdpDeserialize(sdp, &parsed);
+  }
+  int64_t parse_us = rtc::TimeMicros() - start;
+  start = rtc::TimeMicros();
+  size_t size = 0;
+  for (int i = 0; i < kIterations; ++i) {
+    size += webrtc::SdpSerialize(jdesc, false).size();
+  }
+  int64_t serialize_us = rtc::TimeMicros() - start;
+  EXPECT_LT(0u, size);
+  LOG(LS_INFO) << sdp.size() << " byte SDP: " << parse_us / kIterations
+               << " us to parse, " << serialize_us / kIterations
+               << " us to serialize";
+}
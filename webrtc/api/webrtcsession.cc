@@ -30,6 +30,8 @@
 #include "webrtc/base/logging.h"
 #include "webrtc/base/stringencode.h"
 #include "webrtc/base/stringutils.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/base/trace_event.h"
 #include "webrtc/call.h"
 #include "webrtc/media/base/mediaconstants.h"
 #include "webrtc/media/base/videocapturer.h"
@@ -426,6 +428,25 @@ static std::string MakeTdErrorString(const std::string& desc) {
   return MakeErrorString(kPushDownTDFailed, desc);
 }
 
+// Logs how long a phase of applying a description took, so that the time a
+// renegotiation costs can be attributed to transports or media.
+class ScopedPhaseTimer {
+ public:
+  ScopedPhaseTimer(const char* phase, cricket::ContentSource source)
+      : phase_(phase), source_(source), start_us_(rtc::TimeMicros()) {}
+  ~ScopedPhaseTimer() {
+    LOG(LS_INFO) << phase_ << " for "
+                 << (source_ == cricket::CS_LOCAL ? "local" : "remote")
+                 << " description took " << rtc::TimeMicros() - start_us_
+                 << " us.";
+  }
+
+ private:
+  const char* phase_;
+  cricket::ContentSource source_;
+  int64_t start_us_;
+};
+
 // Returns true if |new_desc| requests an ICE restart (i.e., new ufrag/pwd).
 bool CheckForRemoteIceRestart(const SessionDescriptionInterface* old_desc,
                               const SessionDescriptionInterface* new_desc,
@@ -681,6 +702,8 @@ void WebRtcSession::CreateAnswer(
 bool WebRtcSession::SetLocalDescription(SessionDescriptionInterface* desc,
                                         std::string* err_desc) {
   ASSERT(signaling_thread()->IsCurrent());
+  TRACE_EVENT0("webrtc", "WebRtcSession::SetLocalDescription");
+  ScopedPhaseTimer timer("Setting", cricket::CS_LOCAL);
 
   // Takes the ownership of |desc| regardless of the result.
   std::unique_ptr<SessionDescriptionInterface> desc_temp(desc);
@@ -737,6 +760,8 @@ bool WebRtcSession::SetLocalDescription(SessionDescriptionInterface* desc,
 bool WebRtcSession::SetRemoteDescription(SessionDescriptionInterface* desc,
                                          std::string* err_desc) {
   ASSERT(signaling_thread()->IsCurrent());
+  TRACE_EVENT0("webrtc", "WebRtcSession::SetRemoteDescription");
+  ScopedPhaseTimer timer("Setting", cricket::CS_REMOTE);
 
   // Takes the ownership of |desc| regardless of the result.
   std::unique_ptr<SessionDescriptionInterface> desc_temp(desc);
@@ -920,6 +945,8 @@ bool WebRtcSession::PushdownMediaDescription(
     cricket::ContentAction action,
     cricket::ContentSource source,
     std::string* err) {
+  TRACE_EVENT0("webrtc", "WebRtcSession::PushdownMediaDescription");
+  ScopedPhaseTimer timer("Pushing down media", source);
   auto set_content = [this, action, source, err](cricket::BaseChannel* ch) {
     if (!ch) {
       return true;
@@ -941,6 +968,8 @@ bool WebRtcSession::PushdownTransportDescription(cricket::ContentSource source,
                                                  cricket::ContentAction action,
                                                  std::string* error_desc) {
   RTC_DCHECK(signaling_thread()->IsCurrent());
+  TRACE_EVENT0("webrtc", "WebRtcSession::PushdownTransportDescription");
+  ScopedPhaseTimer timer("Pushing down transports", source);
 
   if (source == cricket::CS_LOCAL) {
     return PushdownLocalTransportDescription(local_desc_->description(), action,
@@ -1717,8 +1746,8 @@ bool WebRtcSession::CreateDataChannel(const cricket::ContentInfo* content,
       rtcp_mux_policy_ == PeerConnectionInterface::kRtcpMuxPolicyRequire;
   bool create_rtcp_transport_channel = !sctp && !require_rtcp_mux;
   data_channel_.reset(channel_manager_->CreateDataChannel(
-      transport_controller_.get(), content->name, bundle_transport,
-      create_rtcp_transport_channel, data_channel_type_));
+      media_controller_->config(), transport_controller_.get(), content->name,
+      bundle_transport, create_rtcp_transport_channel, data_channel_type_));
   if (!data_channel_) {
     return false;
   }
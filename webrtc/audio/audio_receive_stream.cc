@@ -226,6 +226,10 @@ void AudioReceiveStream::SetGain(float gain) {
   channel_proxy_->SetChannelOutputVolumeScaling(gain);
 }
 
+bool AudioReceiveStream::IsSilent() const {
+  return channel_proxy_->PlayoutInDtx();
+}
+
 const webrtc::AudioReceiveStream::Config& AudioReceiveStream::config() const {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   return config_;
@@ -268,7 +272,8 @@ bool AudioReceiveStream::DeliverRtp(const uint8_t* packet,
                                               header);
   }
 
-  return channel_proxy_->ReceivedRTPPacket(packet, length, packet_time);
+  // Handed on parsed, so that the channel doesn't parse it again.
+  return channel_proxy_->OnRtpPacket(packet, length, header);
 }
 
 VoiceEngine* AudioReceiveStream::voice_engine() const {
@@ -294,10 +294,10 @@ TEST(AudioReceiveStreamTest, ReceiveRtpPacket) {
                              rtp_packet.size() - kExpectedHeaderLength,
                              VerifyHeaderExtension(expected_extension)))
       .Times(1);
+  // The channel gets the header parsed.
   EXPECT_CALL(*helper.channel_proxy(),
-              ReceivedRTPPacket(&rtp_packet[0],
-                                rtp_packet.size(),
-                                _))
+              OnRtpPacket(&rtp_packet[0], rtp_packet.size(),
+                          VerifyHeaderExtension(expected_extension)))
       .WillOnce(Return(true));
   EXPECT_TRUE(
       recv_stream.DeliverRtp(&rtp_packet[0], rtp_packet.size(), packet_time));
@@ -372,5 +372,17 @@ TEST(AudioReceiveStreamTest, SetGain) {
       SetChannelOutputVolumeScaling(FloatEq(0.765f)));
   recv_stream.SetGain(0.765f);
 }
+
+TEST(AudioReceiveStreamTest, IsSilent) {
+  ConfigHelper helper;
+  internal::AudioReceiveStream recv_stream(
+      helper.congestion_controller(), helper.config(), helper.audio_state(),
+      helper.event_log());
+  EXPECT_CALL(*helper.channel_proxy(), PlayoutInDtx())
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+  EXPECT_TRUE(recv_stream.IsSilent());
+  EXPECT_FALSE(recv_stream.IsSilent());
+}
 }  // namespace test
 }  // namespace webrtc
@@ -53,6 +53,8 @@ std::string AudioSendStream::Config::ToString() const {
   ss << ", voe_channel_id: " << voe_channel_id;
   // TODO(solenberg): Encoder config.
   ss << ", cng_payload_type: " << cng_payload_type;
+  ss << ", enable_audio_network_adaptor: "
+     << (enable_audio_network_adaptor ? "true" : "false");
   ss << '}';
   return ss.str();
 }
@@ -100,6 +102,12 @@ AudioSendStream::AudioSendStream(
       RTC_NOTREACHED() << "Registering unsupported RTP extension.";
     }
   }
+
+  if (config_.enable_audio_network_adaptor &&
+      !channel_proxy_->EnableAudioNetworkAdaptor(true)) {
+    LOG(LS_WARNING) << "The send codec does not support the audio network "
+                       "adaptor.";
+  }
 }
 
 AudioSendStream::~AudioSendStream() {
@@ -257,6 +265,10 @@ uint32_t AudioSendStream::OnBitrateUpdated(uint32_t bitrate_bps,
                                            int64_t rtt) {
   RTC_DCHECK_GE(bitrate_bps,
                 static_cast<uint32_t>(config_.min_bitrate_kbps * 1000));
+  // The uncapped allocation is the best estimate of the uplink bandwidth
+  // available to this stream.
+  if (config_.enable_audio_network_adaptor)
+    channel_proxy_->OnUplinkNetworkMetrics(bitrate_bps, rtt);
   // The bitrate allocator might allocate an higher than max configured bitrate
   // if there is room, to allow for, as example, extra FEC. Ignore that for now.
   const uint32_t max_bitrate_bps = config_.max_bitrate_kbps * 1000;
@@ -106,6 +106,10 @@ struct ConfigHelper {
               .Times(1);
           EXPECT_CALL(*channel_proxy_, DeRegisterExternalTransport())
               .Times(1);
+          if (stream_config_.enable_audio_network_adaptor) {
+            EXPECT_CALL(*channel_proxy_, EnableAudioNetworkAdaptor(true))
+                .WillOnce(Return(true));
+          }
           return channel_proxy_;
         }));
     stream_config_.voe_channel_id = kChannelId;
@@ -202,7 +206,7 @@ TEST(AudioSendStreamTest, ConfigToString) {
       "{rtp: {ssrc: 1234, extensions: [{uri: "
       "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time, id: 3}], "
       "nack: {rtp_history_ms: 0}, c_name: foo_name}, voe_channel_id: 1, "
-      "cng_payload_type: 42}",
+      "cng_payload_type: 42, enable_audio_network_adaptor: false}",
       config.ToString());
 }
 
@@ -213,6 +217,20 @@ TEST(AudioSendStreamTest, ConstructDestruct) {
       helper.congestion_controller(), helper.bitrate_allocator());
 }
 
+TEST(AudioSendStreamTest, FeedsAudioNetworkAdaptor) {
+  ConfigHelper helper;
+  helper.config().min_bitrate_kbps = 6;
+  helper.config().max_bitrate_kbps = 32;
+  helper.config().enable_audio_network_adaptor = true;
+  internal::AudioSendStream send_stream(
+      helper.config(), helper.audio_state(), helper.worker_queue(),
+      helper.congestion_controller(), helper.bitrate_allocator());
+  // The adaptor sees the uncapped allocation, the encoder the capped bitrate.
+  EXPECT_CALL(*helper.channel_proxy(), OnUplinkNetworkMetrics(50000, 123));
+  EXPECT_CALL(*helper.channel_proxy(), SetBitrate(32000));
+  send_stream.OnBitrateUpdated(50000, 0, 123);
+}
+
 TEST(AudioSendStreamTest, SendTelephoneEvent) {
   ConfigHelper helper;
   internal::AudioSendStream send_stream(
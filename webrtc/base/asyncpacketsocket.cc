@@ -26,4 +26,15 @@ AsyncPacketSocket::AsyncPacketSocket() {
 AsyncPacketSocket::~AsyncPacketSocket() {
 }
 
+int AsyncPacketSocket::SendToBatch(const BatchedPacket* packets,
+                                   size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const BatchedPacket& packet = packets[i];
+    int ret = SendTo(packet.data, packet.size, packet.addr, *packet.options);
+    if (ret < 0)
+      return i == 0 ? ret : static_cast<int>(i);
+  }
+  return static_cast<int>(count);
+}
+
 };  // namespace rtc
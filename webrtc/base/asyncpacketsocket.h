@@ -63,6 +63,21 @@ inline PacketTime CreatePacketTime(int64_t not_before) {
   return PacketTime(TimeMicros(), not_before);
 }
 
+// A packet to be sent with AsyncPacketSocket::SendToBatch. The data and
+// options are not copied and must outlive the call.
+struct BatchedPacket {
+  BatchedPacket(const void* data,
+                size_t size,
+                const SocketAddress& addr,
+                const PacketOptions* options)
+      : data(data), size(size), addr(addr), options(options) {}
+
+  const void* data;
+  size_t size;
+  SocketAddress addr;
+  const PacketOptions* options;
+};
+
 // Provides the ability to receive packets asynchronously. Sends are not
 // buffered since it is acceptable to drop packets under high load.
 class AsyncPacketSocket : public sigslot::has_slots<> {
@@ -89,6 +104,15 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int Send(const void *pv, size_t cb, const PacketOptions& options) = 0;
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr,
                      const PacketOptions& options) = 0;
+  // Sends |count| packets, which lets sockets that support it make a single
+  // system call for all of them. Returns the number of packets sent, or -1
+  // if the first packet could not be sent. The default implementation calls
+  // SendTo for each packet.
+  virtual int SendToBatch(const BatchedPacket* packets, size_t count);
+
+  // Returns true if the socket may read several packets from the network at
+  // once, in which case it emits SignalReadBatchDone after signaling them.
+  virtual bool BatchesReads() const { return false; }
 
   // Close the socket.
   virtual int Close() = 0;
@@ -111,6 +135,11 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
                    const SocketAddress&,
                    const PacketTime&> SignalReadPacket;
 
+  // Emitted by sockets that batch reads after the SignalReadPacket calls for
+  // each batch. The data passed to these calls stays valid until then, so
+  // receivers may hold on to it, e.g. to send it on with SendToBatch.
+  sigslot::signal1<AsyncPacketSocket*> SignalReadBatchDone;
+
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
 
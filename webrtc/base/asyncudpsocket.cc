@@ -9,12 +9,23 @@
  */
 
 #include "webrtc/base/asyncudpsocket.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 
 namespace rtc {
 
 static const int BUF_SIZE = 64 * 1024;
 
+// Limits for a single segmented datagram. The kernel accepts up to 64
+// segments and the datagram must fit into an IP packet before segmentation.
+static const size_t kMaxGsoSegments = 64;
+static const size_t kMaxGsoSize = 65000;
+
 AsyncUDPSocket* AsyncUDPSocket::Create(
     AsyncSocket* socket,
     const SocketAddress& bind_address) {
@@ -36,7 +47,12 @@ AsyncUDPSocket* AsyncUDPSocket::Create(SocketFactory* factory,
 }
 
 AsyncUDPSocket::AsyncUDPSocket(AsyncSocket* socket)
-    : socket_(socket) {
+    : socket_(socket),
+      max_read_batch_size_(1),
+      gso_enabled_(false),
+      gro_enabled_(false),
+      gso_packets_sent_(0),
+      gro_packets_received_(0) {
   size_ = BUF_SIZE;
   buf_ = new char[size_];
 
@@ -74,6 +90,96 @@ int AsyncUDPSocket::SendTo(const void *pv, size_t cb,
   return ret;
 }
 
+int AsyncUDPSocket::SendToBatch(const BatchedPacket* packets, size_t count) {
+  BuildSendBatch(packets, count);
+  int64_t send_time_ms = rtc::TimeMillis();
+  int ret = socket_->SendToBatch(send_batch_.data(), send_batch_.size());
+  if (ret < 0)
+    return ret;
+
+  size_t packets_sent = 0;
+  size_t segmented_packets_sent = 0;
+  for (int i = 0; i < ret; ++i) {
+    packets_sent += send_batch_packets_[i];
+    if (send_batch_packets_[i] > 1)
+      segmented_packets_sent += send_batch_packets_[i];
+  }
+  if (segmented_packets_sent > 0) {
+    // The socket falls back to sending one by one if the device rejects
+    // segmented datagrams, in which case nothing went out coalesced.
+    int enabled = 0;
+    if (socket_->GetOption(Socket::OPT_UDP_GSO, &enabled) == 0 && enabled) {
+      gso_packets_sent_ += segmented_packets_sent;
+    } else {
+      gso_enabled_ = false;
+    }
+  }
+  for (size_t i = 0; i < packets_sent; ++i) {
+    SignalSentPacket(this,
+                     rtc::SentPacket(packets[i].options->packet_id,
+                                     send_time_ms));
+  }
+  return static_cast<int>(packets_sent);
+}
+
+void AsyncUDPSocket::BuildSendBatch(const BatchedPacket* packets,
+                                    size_t count) {
+  send_batch_.clear();
+  send_batch_packets_.clear();
+  if (gso_enabled_) {
+    // Reserve up front so that pointers into |gso_buf_| stay valid.
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; ++i)
+      total_size += packets[i].size;
+    gso_buf_.resize(total_size);
+  }
+
+  size_t gso_offset = 0;
+  size_t i = 0;
+  while (i < count) {
+    // Find the run of packets that can share a segmented datagram: all the
+    // same size and destination, only the last of them may be shorter.
+    size_t run = 1;
+    if (gso_enabled_) {
+      size_t total = packets[i].size;
+      while (i + run < count && run < kMaxGsoSegments &&
+             packets[i + run].size <= packets[i].size &&
+             packets[i + run].addr == packets[i].addr &&
+             total + packets[i + run].size <= kMaxGsoSize) {
+        total += packets[i + run].size;
+        ++run;
+        if (packets[i + run - 1].size < packets[i].size)
+          break;
+      }
+    }
+
+    SendDatagram datagram;
+    datagram.addr = packets[i].addr;
+    if (run == 1) {
+      datagram.data = packets[i].data;
+      datagram.size = packets[i].size;
+    } else {
+      char* data = &gso_buf_[gso_offset];
+      size_t size = 0;
+      for (size_t j = i; j < i + run; ++j) {
+        memcpy(data + size, packets[j].data, packets[j].size);
+        size += packets[j].size;
+      }
+      gso_offset += size;
+      datagram.data = data;
+      datagram.size = size;
+      datagram.segment_size = packets[i].size;
+    }
+    send_batch_.push_back(datagram);
+    send_batch_packets_.push_back(run);
+    i += run;
+  }
+}
+
+bool AsyncUDPSocket::BatchesReads() const {
+  return !read_batch_.empty();
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -87,7 +193,14 @@ int AsyncUDPSocket::GetOption(Socket::Option opt, int* value) {
 }
 
 int AsyncUDPSocket::SetOption(Socket::Option opt, int value) {
-  return socket_->SetOption(opt, value);
+  int ret = socket_->SetOption(opt, value);
+  if (ret == 0 && opt == Socket::OPT_UDP_GSO) {
+    gso_enabled_ = (value != 0);
+  } else if (ret == 0 && opt == Socket::OPT_UDP_GRO) {
+    gro_enabled_ = (value != 0);
+    UpdateReadBatch();
+  }
+  return ret;
 }
 
 int AsyncUDPSocket::GetError() const {
@@ -98,20 +211,78 @@ void AsyncUDPSocket::SetError(int error) {
   return socket_->SetError(error);
 }
 
+void AsyncUDPSocket::SetMaxReadBatchSize(size_t max_packets) {
+  RTC_DCHECK_GE(max_packets, 1u);
+  max_read_batch_size_ = max_packets;
+  UpdateReadBatch();
+}
+
+void AsyncUDPSocket::UpdateReadBatch() {
+  read_batch_.clear();
+  batch_buf_.reset();
+  // Coalesced datagrams are only reported through RecvFromBatch, so it is
+  // used with a single slot if GRO is enabled.
+  if (max_read_batch_size_ <= 1 && !gro_enabled_)
+    return;
+
+  size_t slots = std::max<size_t>(max_read_batch_size_, 1);
+  if (slots > 1)
+    batch_buf_.reset(new char[(slots - 1) * size_]);
+  read_batch_.resize(slots);
+  for (size_t i = 0; i < slots; ++i) {
+    read_batch_[i].buffer = (i == 0) ? buf_ : &batch_buf_[(i - 1) * size_];
+    read_batch_[i].capacity = size_;
+  }
+}
+
+void AsyncUDPSocket::OnReadError() {
+  // An error here typically means we got an ICMP error in response to our
+  // send datagram, indicating the remote address was unreachable.
+  // When doing ICE, this kind of thing will often happen.
+  // TODO: Do something better like forwarding the error to the user.
+  SocketAddress local_addr = socket_->GetLocalAddress();
+  LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString() << "] "
+               << "receive failed with error " << socket_->GetError();
+}
+
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   ASSERT(socket_.get() == socket);
 
+  if (!read_batch_.empty()) {
+    int count = socket_->RecvFromBatch(read_batch_.data(), read_batch_.size());
+    if (count < 0) {
+      OnReadError();
+      return;
+    }
+    for (int i = 0; i < count; ++i) {
+      const RecvDatagram& datagram = read_batch_[i];
+      PacketTime packet_time = (datagram.timestamp > -1
+                                    ? PacketTime(datagram.timestamp, 0)
+                                    : CreatePacketTime(0));
+      const char* data = static_cast<const char*>(datagram.buffer);
+      if (datagram.segment_size == 0) {
+        SignalReadPacket(this, data, datagram.size, datagram.addr,
+                         packet_time);
+        continue;
+      }
+      // Split a coalesced datagram back into the packets that were sent.
+      for (size_t offset = 0; offset < datagram.size;
+           offset += datagram.segment_size) {
+        size_t size = std::min(datagram.segment_size, datagram.size - offset);
+        ++gro_packets_received_;
+        SignalReadPacket(this, data + offset, size, datagram.addr,
+                         packet_time);
+      }
+    }
+    SignalReadBatchDone(this);
+    return;
+  }
+
   SocketAddress remote_addr;
   int64_t timestamp;
   int len = socket_->RecvFrom(buf_, size_, &remote_addr, &timestamp);
   if (len < 0) {
-    // An error here typically means we got an ICMP error in response to our
-    // send datagram, indicating the remote address was unreachable.
-    // When doing ICE, this kind of thing will often happen.
-    // TODO: Do something better like forwarding the error to the user.
-    SocketAddress local_addr = socket_->GetLocalAddress();
-    LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString() << "] "
-                 << "receive failed with error " << socket_->GetError();
+    OnReadError();
     return;
   }
 
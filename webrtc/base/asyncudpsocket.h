@@ -12,6 +12,7 @@
 #define WEBRTC_BASE_ASYNCUDPSOCKET_H_
 
 #include <memory>
+#include <vector>
 
 #include "webrtc/base/asyncpacketsocket.h"
 #include "webrtc/base/socketfactory.h"
@@ -43,6 +44,8 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  int SendToBatch(const BatchedPacket* packets, size_t count) override;
+  bool BatchesReads() const override;
   int Close() override;
 
   State GetState() const override;
@@ -51,15 +54,52 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int GetError() const override;
   void SetError(int error) override;
 
+  // Lets each read event drain up to |max_packets| datagrams from the socket
+  // with a single system call where supported (recvmmsg on Linux), instead of
+  // a single one. Each datagram is still signaled through SignalReadPacket.
+  // Every additional packet costs a receive buffer of 64 kB, so this is off
+  // (1) by default. When enabled, SignalReadPacket handlers must not delete
+  // this socket.
+  void SetMaxReadBatchSize(size_t max_packets);
+
+  // Number of packets that were sent as part of a segmented datagram, and
+  // received as part of a coalesced one, when OPT_UDP_GSO and OPT_UDP_GRO are
+  // enabled through SetOption.
+  uint64_t gso_packets_sent() const { return gso_packets_sent_; }
+  uint64_t gro_packets_received() const { return gro_packets_received_; }
+
  private:
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(AsyncSocket* socket);
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
 
+  // Logs a failed receive.
+  void OnReadError();
+  // (Re)creates |read_batch_| for the current batch size and GRO setting.
+  void UpdateReadBatch();
+  // Fills |send_batch_| from |packets|, merging runs of equally sized packets
+  // to the same address into segmented datagrams if GSO is enabled.
+  void BuildSendBatch(const BatchedPacket* packets, size_t count);
+
   std::unique_ptr<AsyncSocket> socket_;
   char* buf_;
   size_t size_;
+  // Receive slots used when batching reads; the first one uses |buf_| and
+  // the others |batch_buf_|. Empty if reads are not batched.
+  std::vector<RecvDatagram> read_batch_;
+  std::unique_ptr<char[]> batch_buf_;
+  size_t max_read_batch_size_;
+  // Reused for each call to SendToBatch. |send_batch_packets_| holds the
+  // number of packets carried by the corresponding entry of |send_batch_|,
+  // and |gso_buf_| the payloads of segmented datagrams.
+  std::vector<SendDatagram> send_batch_;
+  std::vector<size_t> send_batch_packets_;
+  std::vector<char> gso_buf_;
+  bool gso_enabled_;
+  bool gro_enabled_;
+  uint64_t gso_packets_sent_;
+  uint64_t gro_packets_received_;
 };
 
 }  // namespace rtc
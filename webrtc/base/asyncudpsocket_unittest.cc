@@ -10,9 +10,11 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "webrtc/base/asyncudpsocket.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/virtualsocketserver.h"
 
@@ -50,4 +52,111 @@ TEST_F(AsyncUdpSocketTest, OnWriteEvent) {
   EXPECT_TRUE(ready_to_send_);
 }
 
+class PacketCounter : public sigslot::has_slots<> {
+ public:
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const PacketTime& packet_time) {
+    packets_.push_back(std::string(data, size));
+  }
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& sent_packet) {
+    sent_packet_ids_.push_back(sent_packet.packet_id);
+  }
+  void OnReadBatchDone(AsyncPacketSocket* socket) {
+    batch_ends_.push_back(packets_.size());
+  }
+
+  std::vector<std::string> packets_;
+  std::vector<int> sent_packet_ids_;
+  // Number of packets read when each batch was done.
+  std::vector<size_t> batch_ends_;
+};
+
+TEST(AsyncUdpSocketBatchTest, SendToBatchAndReadBatch) {
+  PhysicalSocketServer pss;
+  const SocketAddress kLoopback(IPAddress(INADDR_LOOPBACK), 0);
+  AsyncSocket* receive_socket = pss.CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(receive_socket, kLoopback));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&pss, kLoopback));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  EXPECT_FALSE(receiver->BatchesReads());
+  receiver->SetMaxReadBatchSize(4);
+  EXPECT_TRUE(receiver->BatchesReads());
+
+  PacketCounter counter;
+  receiver->SignalReadPacket.connect(&counter, &PacketCounter::OnReadPacket);
+  receiver->SignalReadBatchDone.connect(&counter,
+                                        &PacketCounter::OnReadBatchDone);
+  sender->SignalSentPacket.connect(&counter, &PacketCounter::OnSentPacket);
+
+  const std::string kPayloads[] = {"a", "bb", "ccc"};
+  PacketOptions options[3];
+  std::vector<BatchedPacket> packets;
+  for (int i = 0; i < 3; ++i) {
+    options[i].packet_id = i;
+    packets.push_back(BatchedPacket(kPayloads[i].data(), kPayloads[i].size(),
+                                    receiver->GetLocalAddress(), &options[i]));
+  }
+  EXPECT_EQ(3, sender->SendToBatch(packets.data(), packets.size()));
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), counter.sent_packet_ids_);
+
+  // A single read event drains all queued datagrams.
+  receive_socket->SignalReadEvent(receive_socket);
+  ASSERT_EQ(3u, counter.packets_.size());
+  for (int i = 0; i < 3; ++i)
+    EXPECT_EQ(kPayloads[i], counter.packets_[i]);
+  EXPECT_EQ(std::vector<size_t>({3}), counter.batch_ends_);
+}
+
+TEST(AsyncUdpSocketBatchTest, SendsEqualSizedPacketsWithGso) {
+  PhysicalSocketServer pss;
+  const SocketAddress kLoopback(IPAddress(INADDR_LOOPBACK), 0);
+  AsyncSocket* receive_socket = pss.CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(receive_socket, kLoopback));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&pss, kLoopback));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  if (sender->SetOption(Socket::OPT_UDP_GSO, 1) != 0) {
+    LOG(LS_INFO) << "UDP GSO not supported, skipping test.";
+    return;
+  }
+  receiver->SetMaxReadBatchSize(8);
+
+  PacketCounter counter;
+  receiver->SignalReadPacket.connect(&counter, &PacketCounter::OnReadPacket);
+
+  // Three full sized packets and a shorter one at the end of the burst.
+  const std::string kPayloads[] = {std::string(1000, 'a'),
+                                   std::string(1000, 'b'),
+                                   std::string(1000, 'c'),
+                                   std::string(10, 'd')};
+  PacketOptions options;
+  std::vector<BatchedPacket> packets;
+  for (const std::string& payload : kPayloads) {
+    packets.push_back(BatchedPacket(payload.data(), payload.size(),
+                                    receiver->GetLocalAddress(), &options));
+  }
+  EXPECT_EQ(4, sender->SendToBatch(packets.data(), packets.size()));
+
+  EXPECT_TRUE_WAIT(pss.Wait(10, true) && counter.packets_.size() == 4u, 1000);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(kPayloads[i], counter.packets_[i]);
+  // The device may not support offload, in which case the socket falls back
+  // to sending the packets one by one.
+  EXPECT_TRUE(sender->gso_packets_sent() == 4u ||
+              sender->gso_packets_sent() == 0u);
+}
+
+TEST_F(AsyncUdpSocketTest, OffloadOptionsNotSupportedByVirtualSockets) {
+  EXPECT_EQ(-1, udp_socket_->SetOption(Socket::OPT_UDP_GSO, 1));
+  EXPECT_EQ(-1, udp_socket_->SetOption(Socket::OPT_UDP_GRO, 1));
+}
+
 }  // namespace rtc
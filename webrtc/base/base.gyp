@@ -65,9 +65,14 @@
         'md5digest.cc',
         'md5digest.h',
         'mod_ops.h',
+        'memory_usage.cc',
+        'memory_usage.h',
+        'mpscqueue.h',
         'onetimeevent.h',
         'optional.cc',
         'optional.h',
+        'packetbufferpool.cc',
+        'packetbufferpool.h',
         'platform_file.cc',
         'platform_file.h',
         'platform_thread.cc',
@@ -100,6 +105,7 @@
         'thread_checker.h',
         'thread_checker_impl.cc',
         'thread_checker_impl.h',
+        'timerwheel.h',
         'timestampaligner.cc',
         'timestampaligner.h',
         'timeutils.cc',
@@ -319,6 +325,8 @@
         'rtccertificate.h',
         'rtccertificategenerator.cc',
         'rtccertificategenerator.h',
+        'rtccertificatepool.cc',
+        'rtccertificatepool.h',
         'sha1.cc',
         'sha1.h',
         'sha1digest.cc',
@@ -577,6 +585,10 @@
           },
         }],
         ['OS=="linux"', {
+          'sources': [
+            'netlinknetworkmonitor.cc',
+            'netlinknetworkmonitor.h',
+          ],
           'link_settings': {
             'libraries': [
               '-ldl',
@@ -21,6 +21,8 @@
 
 namespace rtc {
 
+class PacketBufferPool;
+
 class CopyOnWriteBuffer {
  public:
   // An empty buffer.
@@ -223,6 +225,11 @@ class CopyOnWriteBuffer {
   }
 
  private:
+  friend class PacketBufferPool;
+
+  // Take ownership of an already allocated buffer, used by PacketBufferPool.
+  explicit CopyOnWriteBuffer(scoped_refptr<RefCountedObject<Buffer>> buffer);
+
   // Create a copy of the underlying data if it is referenced from other Buffer
   // objects.
   void CloneDataIfReferenced(size_t new_capacity);
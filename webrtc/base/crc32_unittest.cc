@@ -10,11 +10,30 @@
 
 #include "webrtc/base/crc32.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
 
 #include <string>
+#include <vector>
 
 namespace rtc {
 
+namespace {
+
+// The byte-at-a-time algorithm from RFC 1952.
+uint32_t ReferenceCrc32(const uint8_t* buf, size_t len) {
+  uint32_t c = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; ++i) {
+    c ^= buf[i];
+    for (int j = 0; j < 8; ++j)
+      c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+  }
+  return c ^ 0xFFFFFFFF;
+}
+
+}  // namespace
+
 TEST(Crc32Test, TestBasic) {
   EXPECT_EQ(0U, ComputeCrc32(""));
   EXPECT_EQ(0x352441C2U, ComputeCrc32("abc"));
@@ -32,4 +51,69 @@ TEST(Crc32Test, TestMultipleUpdates) {
   EXPECT_EQ(0x171A3F5FU, c);
 }
 
+TEST(Crc32Test, TestMatchesReferenceForAllLengthsAndAlignments) {
+  webrtc::Random random(1234);
+  std::vector<uint8_t> data(300);
+  for (uint8_t& byte : data)
+    byte = random.Rand<uint8_t>();
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t len = 0; len + offset <= data.size(); ++len) {
+      ASSERT_EQ(ReferenceCrc32(&data[offset], len),
+                ComputeCrc32(&data[offset], len))
+          << "offset " << offset << " len " << len;
+    }
+  }
+}
+
+TEST(Crc32Test, TestSplitUpdates) {
+  webrtc::Random random(5678);
+  std::vector<uint8_t> data(1000);
+  for (uint8_t& byte : data)
+    byte = random.Rand<uint8_t>();
+  const uint32_t expected = ComputeCrc32(data.data(), data.size());
+  for (size_t split = 0; split <= data.size(); split += 37) {
+    uint32_t c = UpdateCrc32(0, data.data(), split);
+    EXPECT_EQ(expected, UpdateCrc32(c, &data[split], data.size() - split));
+  }
+}
+
+// Measures the CRC32 throughput for a typical STUN binding request size,
+// compared with the table driven byte-at-a-time loop UpdateCrc32 used before.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(Crc32Test, DISABLED_Performance) {
+  static const size_t kPacketSize = 108;
+  static const int kIterations = 2000000;
+  std::vector<uint8_t> packet(kPacketSize, 0x5A);
+  uint32_t table[256];
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint8_t byte = static_cast<uint8_t>(i);
+    // Undo the pre and post conditioning to get the raw table entry.
+    table[i ^ 0xFF] = ReferenceCrc32(&byte, 1) ^ 0xFFFFFFFF ^ (0xFFFFFFFF >> 8);
+  }
+  uint32_t sink = 0;
+  uint32_t reference_sink = 0;
+
+  int64_t start = TimeNanos();
+  for (int i = 0; i < kIterations; ++i) {
+    packet[0] = static_cast<uint8_t>(i);
+    sink ^= ComputeCrc32(packet.data(), packet.size());
+  }
+  int64_t elapsed = TimeNanos() - start;
+  LOG(LS_INFO) << "ComputeCrc32: " << elapsed / kIterations << " ns per "
+               << kPacketSize << " byte packet";
+
+  start = TimeNanos();
+  for (int i = 0; i < kIterations; ++i) {
+    packet[0] = static_cast<uint8_t>(i);
+    uint32_t c = 0xFFFFFFFF;
+    for (uint8_t byte : packet)
+      c = table[(c ^ byte) & 0xFF] ^ (c >> 8);
+    reference_sink ^= c ^ 0xFFFFFFFF;
+  }
+  elapsed = TimeNanos() - start;
+  LOG(LS_INFO) << "Byte at a time: " << elapsed / kIterations << " ns per "
+               << kPacketSize << " byte packet";
+  EXPECT_EQ(reference_sink, sink);
+}
+
 }  // namespace rtc
@@ -11,9 +11,16 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <vector>
 
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+#include "webrtc/base/bytebuffer.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/event.h"
@@ -23,6 +30,10 @@
 #include "webrtc/base/timeutils.h"
 #include "webrtc/base/trace_event.h"
 
+#if defined(WEBRTC_WIN)
+#include "webrtc/base/win32.h"
+#endif
+
 // This is a guesstimate that should be enough in most cases.
 static const size_t kEventLoggerArgsStrBufferInitialSize = 256;
 static const size_t kTraceArgBufferLength = 32;
@@ -85,6 +96,85 @@ static bool EventTracingThreadFunc(void* params);
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
 
+struct TraceArg {
+  const char* name;
+  unsigned char type;
+  // Copied from webrtc/base/trace_event.h TraceValueUnion.
+  union TraceArgValue {
+    bool as_bool;
+    unsigned long long as_uint;
+    long long as_int;
+    double as_double;
+    const void* as_pointer;
+    const char* as_string;
+  } value;
+
+  // Assert that the size of the union is equal to the size of the as_uint
+  // field since we are assigning to arbitrary types using it.
+  static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
+                "Size of TraceArg value union is not equal to the size of "
+                "the uint field of that union.");
+};
+
+std::string TraceArgValueAsString(TraceArg arg) {
+  std::string output;
+
+  if (arg.type == TRACE_VALUE_TYPE_STRING ||
+      arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+    // Space for every character to be an espaced character + two for
+    // quatation marks.
+    output.reserve(strlen(arg.value.as_string) * 2 + 2);
+    output += '\"';
+    for (const char* c = arg.value.as_string; *c; ++c) {
+      if (*c == '"' || *c == '\\') {
+        output += '\\';
+        output += *c;
+      } else {
+        output += *c;
+      }
+    }
+    output += '\"';
+  } else {
+    output.resize(kTraceArgBufferLength);
+    size_t print_length = 0;
+    switch (arg.type) {
+      case TRACE_VALUE_TYPE_BOOL:
+        if (arg.value.as_bool) {
+          strcpy(&output[0], "true");
+          print_length = 4;
+        } else {
+          strcpy(&output[0], "false");
+          print_length = 5;
+        }
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
+                                arg.value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
+                                arg.value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
+                                arg.value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
+                                arg.value.as_pointer);
+        break;
+    }
+    size_t output_length = print_length < kTraceArgBufferLength
+                               ? print_length
+                               : kTraceArgBufferLength - 1;
+    // This will hopefully be very close to nop. On most implementations, it
+    // just writes null byte and sets the length field of the string.
+    output.resize(output_length);
+  }
+
+  return output;
+}
+
 // TODO(pbos): Log metadata for all threads, etc.
 class EventLogger final {
  public:
@@ -227,26 +317,6 @@ class EventLogger final {
   }
 
  private:
-  struct TraceArg {
-    const char* name;
-    unsigned char type;
-    // Copied from webrtc/base/trace_event.h TraceValueUnion.
-    union TraceArgValue {
-      bool as_bool;
-      unsigned long long as_uint;
-      long long as_int;
-      double as_double;
-      const void* as_pointer;
-      const char* as_string;
-    } value;
-
-    // Assert that the size of the union is equal to the size of the as_uint
-    // field since we are assigning to arbitrary types using it.
-    static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
-                  "Size of TraceArg value union is not equal to the size of "
-                  "the uint field of that union.");
-  };
-
   struct TraceEvent {
     const char* name;
     const unsigned char* category_enabled;
@@ -257,66 +327,6 @@ class EventLogger final {
     rtc::PlatformThreadId tid;
   };
 
-  static std::string TraceArgValueAsString(TraceArg arg) {
-    std::string output;
-
-    if (arg.type == TRACE_VALUE_TYPE_STRING ||
-        arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-      // Space for every character to be an espaced character + two for
-      // quatation marks.
-      output.reserve(strlen(arg.value.as_string) * 2 + 2);
-      output += '\"';
-      const char* c = arg.value.as_string;
-      do {
-        if (*c == '"' || *c == '\\') {
-          output += '\\';
-          output += *c;
-        } else {
-          output += *c;
-        }
-      } while (*++c);
-      output += '\"';
-    } else {
-      output.resize(kTraceArgBufferLength);
-      size_t print_length = 0;
-      switch (arg.type) {
-        case TRACE_VALUE_TYPE_BOOL:
-          if (arg.value.as_bool) {
-            strcpy(&output[0], "true");
-            print_length = 4;
-          } else {
-            strcpy(&output[0], "false");
-            print_length = 5;
-          }
-          break;
-        case TRACE_VALUE_TYPE_UINT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
-                                  arg.value.as_uint);
-          break;
-        case TRACE_VALUE_TYPE_INT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
-                                  arg.value.as_int);
-          break;
-        case TRACE_VALUE_TYPE_DOUBLE:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
-                                  arg.value.as_double);
-          break;
-        case TRACE_VALUE_TYPE_POINTER:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
-                                  arg.value.as_pointer);
-          break;
-      }
-      size_t output_length = print_length < kTraceArgBufferLength
-                                 ? print_length
-                                 : kTraceArgBufferLength - 1;
-      // This will hopefully be very close to nop. On most implementations, it
-      // just writes null byte and sets the length field of the string.
-      output.resize(output_length);
-    }
-
-    return output;
-  }
-
   rtc::CriticalSection crit_;
   std::vector<TraceEvent> trace_events_ GUARDED_BY(crit_);
   rtc::PlatformThread logging_thread_;
@@ -333,6 +343,229 @@ static bool EventTracingThreadFunc(void* params) {
   return false;
 }
 
+// Per-thread event rings for StartInternalRingCapture().
+static volatile int g_ring_capture_active = 0;
+// Bumped by every StartInternalRingCapture() so that snapshots skip events
+// left over from earlier captures.
+static volatile int g_ring_generation = 0;
+
+static const size_t kRingEventsPerThread = 2048;
+// TRACE_EVENT macros take at most two arguments.
+static const int kRingMaxArgs = 2;
+static const uint32_t kRingSnapshotMagic = 0x57525452;  // "WRTR"
+static const uint32_t kRingSnapshotVersion = 1;
+
+struct RingEvent {
+  // Seqlock: odd while the owning thread is writing the slot.
+  volatile int seq;
+  int generation;
+  uint64_t timestamp;
+  const char* name;
+  const unsigned char* category_enabled;
+  const char* arg_names[kRingMaxArgs];
+  unsigned long long arg_values[kRingMaxArgs];
+  rtc::PlatformThreadId tid;
+  char phase;
+  unsigned char num_args;
+  unsigned char arg_types[kRingMaxArgs];
+};
+
+// Only written by the thread it is assigned to. When that thread exits the
+// ring goes back to a free list and is reused, so memory is bounded by the
+// largest number of threads that trace at once.
+struct TraceRing {
+  TraceRing() : tid(0), next(0) { memset(events, 0, sizeof(events)); }
+  // Looking up the thread id can be a system call, so it is cached here.
+  rtc::PlatformThreadId tid;
+  size_t next;
+  RingEvent events[kRingEventsPerThread];
+};
+
+// Records trace events into per-thread TraceRings. The hot path is a
+// thread-local lookup and two atomic increments; locks are only taken the
+// first time a thread traces and for snapshots. Never destroyed, as exiting
+// threads may still hand back their rings.
+class TraceRingRecorder {
+ public:
+  TraceRingRecorder() {
+#if defined(WEBRTC_WIN)
+    key_ = TlsAlloc();
+#else
+    pthread_key_create(&key_, &TraceRingRecorder::OnThreadExit);
+#endif
+  }
+
+  void AddTraceEvent(const char* name,
+                     const unsigned char* category_enabled,
+                     char phase,
+                     int num_args,
+                     const char** arg_names,
+                     const unsigned char* arg_types,
+                     const unsigned long long* arg_values,
+                     uint64_t timestamp) {
+    TraceRing* ring = GetThreadRing();
+    RingEvent& e = ring->events[ring->next];
+    ring->next = (ring->next + 1) % kRingEventsPerThread;
+
+    rtc::AtomicOps::Increment(&e.seq);
+    e.generation = rtc::AtomicOps::AcquireLoad(&g_ring_generation);
+    e.timestamp = timestamp;
+    e.name = name;
+    e.category_enabled = category_enabled;
+    e.tid = ring->tid;
+    e.phase = phase;
+    e.num_args = 0;
+    for (int i = 0; i < num_args && i < kRingMaxArgs; ++i) {
+      // Copied strings are temporaries and can't be kept without copying
+      // them, which the ring avoids. They are dropped.
+      if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING)
+        continue;
+      e.arg_names[e.num_args] = arg_names[i];
+      e.arg_types[e.num_args] = arg_types[i];
+      e.arg_values[e.num_args] = arg_values[i];
+      ++e.num_args;
+    }
+    rtc::AtomicOps::Increment(&e.seq);
+  }
+
+  void Snapshot(rtc::Buffer* snapshot) {
+    const int generation = rtc::AtomicOps::AcquireLoad(&g_ring_generation);
+    std::vector<RingEvent> events;
+    {
+      rtc::CritScope lock(&crit_);
+      events.reserve(rings_.size() * kRingEventsPerThread);
+      for (TraceRing* ring : rings_) {
+        for (RingEvent& slot : ring->events) {
+          int seq = rtc::AtomicOps::AcquireLoad(&slot.seq);
+          if (seq == 0 || (seq & 1))
+            continue;
+          RingEvent copy = slot;
+          // Full barrier; discard the copy if the slot was rewritten while
+          // copying it.
+          if (rtc::AtomicOps::CompareAndSwap(&slot.seq, seq, seq) != seq)
+            continue;
+          if (copy.generation == generation)
+            events.push_back(copy);
+        }
+      }
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const RingEvent& a, const RingEvent& b) {
+                       return a.timestamp < b.timestamp;
+                     });
+    Serialize(events, snapshot);
+  }
+
+ private:
+  TraceRing* GetThreadRing() {
+#if defined(WEBRTC_WIN)
+    TraceRing* ring = static_cast<TraceRing*>(TlsGetValue(key_));
+#else
+    TraceRing* ring = static_cast<TraceRing*>(pthread_getspecific(key_));
+#endif
+    if (ring)
+      return ring;
+    {
+      rtc::CritScope lock(&crit_);
+      if (!free_rings_.empty()) {
+        ring = free_rings_.back();
+        free_rings_.pop_back();
+      } else {
+        ring = new TraceRing();
+        rings_.push_back(ring);
+      }
+    }
+    ring->tid = rtc::CurrentThreadId();
+#if defined(WEBRTC_WIN)
+    // There is no thread exit hook for TlsAlloc slots, so rings of exited
+    // threads are not reused on Windows.
+    TlsSetValue(key_, ring);
+#else
+    pthread_setspecific(key_, ring);
+#endif
+    return ring;
+  }
+
+#if defined(WEBRTC_POSIX)
+  static void OnThreadExit(void* ring);
+#endif
+
+  static void Serialize(const std::vector<RingEvent>& events,
+                        rtc::Buffer* snapshot) {
+    // Names, categories and string arguments are static strings; write each
+    // one once and refer to it by index.
+    std::map<const char*, uint32_t> string_ids;
+    std::vector<const char*> strings;
+    auto string_id = [&string_ids, &strings](const char* str) {
+      auto it = string_ids.find(str);
+      if (it != string_ids.end())
+        return it->second;
+      uint32_t id = static_cast<uint32_t>(strings.size());
+      string_ids[str] = id;
+      strings.push_back(str);
+      return id;
+    };
+    rtc::ByteBufferWriter body;
+    uint64_t last_timestamp = 0;
+    for (const RingEvent& e : events) {
+      // Events are sorted, so timestamps are stored as deltas.
+      body.WriteUVarint(e.timestamp - last_timestamp);
+      last_timestamp = e.timestamp;
+      body.WriteUVarint(static_cast<uint64_t>(e.tid));
+      body.WriteUVarint(string_id(e.name));
+      body.WriteUVarint(string_id(
+          reinterpret_cast<const char*>(e.category_enabled)));
+      body.WriteUInt8(static_cast<uint8_t>(e.phase));
+      body.WriteUInt8(e.num_args);
+      for (int i = 0; i < e.num_args; ++i) {
+        body.WriteUVarint(string_id(e.arg_names[i]));
+        body.WriteUInt8(e.arg_types[i]);
+        if (e.arg_types[i] == TRACE_VALUE_TYPE_STRING) {
+          TraceArg arg;
+          arg.value.as_uint = e.arg_values[i];
+          body.WriteUVarint(string_id(arg.value.as_string));
+        } else {
+          body.WriteUInt64(e.arg_values[i]);
+        }
+      }
+    }
+
+    rtc::ByteBufferWriter header;
+    header.WriteUInt32(kRingSnapshotMagic);
+    header.WriteUInt32(kRingSnapshotVersion);
+    header.WriteUVarint(strings.size());
+    for (const char* str : strings) {
+      size_t length = strlen(str);
+      header.WriteUVarint(length);
+      header.WriteBytes(str, length);
+    }
+    header.WriteUVarint(events.size());
+    snapshot->SetData(header.Data(), header.Length());
+    snapshot->AppendData(body.Data(), body.Length());
+  }
+
+  rtc::CriticalSection crit_;
+  // Every ring ever handed out. Rings are never freed.
+  std::vector<TraceRing*> rings_ GUARDED_BY(crit_);
+  std::vector<TraceRing*> free_rings_ GUARDED_BY(crit_);
+#if defined(WEBRTC_WIN)
+  DWORD key_;
+#else
+  pthread_key_t key_;
+#endif
+};
+
+static TraceRingRecorder* volatile g_ring_recorder = nullptr;
+
+#if defined(WEBRTC_POSIX)
+// static
+void TraceRingRecorder::OnThreadExit(void* ring) {
+  TraceRingRecorder* recorder = rtc::AtomicOps::AcquireLoadPtr(&g_ring_recorder);
+  rtc::CritScope lock(&recorder->crit_);
+  recorder->free_rings_.push_back(static_cast<TraceRing*>(ring));
+}
+#endif
+
 static EventLogger* volatile g_event_logger = nullptr;
 static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
 const unsigned char* InternalGetCategoryEnabled(const char* name) {
@@ -356,6 +589,12 @@ void InternalAddTraceEvent(char phase,
                            const unsigned char* arg_types,
                            const unsigned long long* arg_values,
                            unsigned char flags) {
+  if (rtc::AtomicOps::AcquireLoad(&g_ring_capture_active)) {
+    g_ring_recorder->AddTraceEvent(name, category_enabled, phase, num_args,
+                                   arg_names, arg_types, arg_values,
+                                   rtc::TimeMicros());
+  }
+
   // Fast path for when event tracing is inactive.
   if (rtc::AtomicOps::AcquireLoad(&g_event_logging_active) == 0)
     return;
@@ -395,6 +634,7 @@ void StopInternalCapture() {
 
 void ShutdownInternalTracer() {
   StopInternalCapture();
+  StopInternalRingCapture();
   EventLogger* old_logger = rtc::AtomicOps::AcquireLoadPtr(&g_event_logger);
   RTC_DCHECK(old_logger);
   RTC_CHECK(rtc::AtomicOps::CompareAndSwapPtr(
@@ -404,5 +644,109 @@ void ShutdownInternalTracer() {
   webrtc::SetupEventTracer(nullptr, nullptr);
 }
 
+void StartInternalRingCapture() {
+  if (!rtc::AtomicOps::AcquireLoadPtr(&g_ring_recorder)) {
+    TraceRingRecorder* recorder = new TraceRingRecorder();
+    if (rtc::AtomicOps::CompareAndSwapPtr(
+            &g_ring_recorder, static_cast<TraceRingRecorder*>(nullptr),
+            recorder) != nullptr) {
+      delete recorder;
+    }
+  }
+  rtc::AtomicOps::Increment(&g_ring_generation);
+  rtc::AtomicOps::ReleaseStore(&g_ring_capture_active, 1);
+}
+
+void StopInternalRingCapture() {
+  rtc::AtomicOps::ReleaseStore(&g_ring_capture_active, 0);
+}
+
+bool SnapshotInternalRingCapture(rtc::Buffer* snapshot) {
+  if (!rtc::AtomicOps::AcquireLoad(&g_ring_capture_active))
+    return false;
+  g_ring_recorder->Snapshot(snapshot);
+  return true;
+}
+
+bool ConvertRingSnapshotToJson(const rtc::Buffer& snapshot, std::string* json) {
+  rtc::ByteBufferReader reader(snapshot);
+  uint32_t magic;
+  uint32_t version;
+  if (!reader.ReadUInt32(&magic) || magic != kRingSnapshotMagic ||
+      !reader.ReadUInt32(&version) || version != kRingSnapshotVersion) {
+    return false;
+  }
+  uint64_t num_strings;
+  if (!reader.ReadUVarint(&num_strings) || num_strings > reader.Length())
+    return false;
+  std::vector<std::string> strings(num_strings);
+  for (std::string& str : strings) {
+    uint64_t length;
+    if (!reader.ReadUVarint(&length) || !reader.ReadString(&str, length))
+      return false;
+  }
+  auto read_string = [&reader, &strings](const std::string** str) {
+    uint64_t id;
+    if (!reader.ReadUVarint(&id) || id >= strings.size())
+      return false;
+    *str = &strings[id];
+    return true;
+  };
+
+  uint64_t num_events;
+  if (!reader.ReadUVarint(&num_events))
+    return false;
+  json->assign("{ \"traceEvents\": [\n");
+  uint64_t timestamp = 0;
+  char buf[64];
+  for (uint64_t i = 0; i < num_events; ++i) {
+    uint64_t delta;
+    uint64_t tid;
+    const std::string* name;
+    const std::string* category;
+    uint8_t phase;
+    uint8_t num_args;
+    if (!reader.ReadUVarint(&delta) || !reader.ReadUVarint(&tid) ||
+        !read_string(&name) || !read_string(&category) ||
+        !reader.ReadUInt8(&phase) || !reader.ReadUInt8(&num_args) ||
+        num_args > kRingMaxArgs) {
+      return false;
+    }
+    timestamp += delta;
+    *json += i ? "," : " ";
+    *json += "{ \"name\": \"" + *name + "\", \"cat\": \"" + *category +
+             "\", \"ph\": \"";
+    *json += static_cast<char>(phase);
+    sprintfn(buf, sizeof(buf),
+             "\", \"ts\": %" PRIu64 ", \"pid\": 1, \"tid\": %" PRIu64,
+             timestamp, tid);
+    *json += buf;
+    for (int j = 0; j < num_args; ++j) {
+      const std::string* arg_name;
+      TraceArg arg;
+      if (!read_string(&arg_name) || !reader.ReadUInt8(&arg.type))
+        return false;
+      if (arg.type == TRACE_VALUE_TYPE_STRING) {
+        const std::string* value;
+        if (!read_string(&value))
+          return false;
+        arg.value.as_string = value->c_str();
+      } else {
+        uint64_t value;
+        if (!reader.ReadUInt64(&value))
+          return false;
+        arg.value.as_uint = value;
+      }
+      *json += j ? ", \"" : ", \"args\": { \"";
+      *json += *arg_name + "\": " + TraceArgValueAsString(arg);
+      if (j == num_args - 1)
+        *json += " }";
+    }
+    *json += "}\n";
+  }
+  *json += "]}\n";
+  return true;
+}
+
 }  // namespace tracing
 }  // namespace rtc
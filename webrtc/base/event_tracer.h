@@ -28,6 +28,10 @@
 
 #include <stdio.h>
 
+#include <string>
+
+#include "webrtc/base/buffer.h"
+
 namespace webrtc {
 
 typedef const unsigned char* (*GetCategoryEnabledPtr)(const char* name);
@@ -79,6 +83,23 @@ void StartInternalCaptureToFile(FILE* file);
 void StopInternalCapture();
 // Make sure we run this, this will tear down the internal tracing.
 void ShutdownInternalTracer();
+
+// Always-on "flight recorder" capture. Events are written to a fixed-size
+// ring buffer per thread, without taking locks or allocating, so that the
+// most recent events on every thread can be grabbed with
+// SnapshotInternalRingCapture(), e.g. when a call quality alarm fires.
+// SetupInternalTracer() must have been called. May run alongside
+// StartInternalCapture().
+void StartInternalRingCapture();
+void StopInternalRingCapture();
+// Writes the events currently held by the ring buffers, oldest first, to
+// |snapshot| in a compact binary format. Returns false if ring capture is not
+// running.
+bool SnapshotInternalRingCapture(rtc::Buffer* snapshot);
+// Converts a snapshot to the Chrome trace JSON format used by
+// StartInternalCapture(). Does not need tracing to be set up, so it can be
+// used offline on stored snapshots. Returns false if |snapshot| is malformed.
+bool ConvertRingSnapshotToJson(const rtc::Buffer& snapshot, std::string* json);
 }  // namespace tracing
 }  // namespace rtc
 
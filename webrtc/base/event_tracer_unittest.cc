@@ -10,7 +10,11 @@
 
 #include "webrtc/base/event_tracer.h"
 
+#include <string>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/base/trace_event.h"
 #include "webrtc/system_wrappers/include/static_instance.h"
 
@@ -80,3 +84,117 @@ TEST(EventTracerTest, ScopedTraceEvent) {
 }
 
 }  // namespace webrtc
+
+namespace rtc {
+namespace tracing {
+
+namespace {
+
+int CountEvents(const std::string& json, const char* name) {
+  const std::string needle = std::string("\"name\": \"") + name + "\"";
+  int count = 0;
+  for (size_t pos = json.find(needle); pos != std::string::npos;
+       pos = json.find(needle, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+std::string SnapshotAsJson() {
+  Buffer snapshot;
+  EXPECT_TRUE(SnapshotInternalRingCapture(&snapshot));
+  std::string json;
+  EXPECT_TRUE(ConvertRingSnapshotToJson(snapshot, &json));
+  return json;
+}
+
+}  // namespace
+
+TEST(EventTracerRingTest, SnapshotContainsEvents) {
+  SetupInternalTracer();
+  StartInternalRingCapture();
+  {
+    TRACE_EVENT2("webrtc", "RingEvent", "count", 7, "label", "static");
+  }
+  TRACE_EVENT_INSTANT1("webrtc", "RingInstant", "copied",
+                       TRACE_STR_COPY(std::string("dropped").c_str()));
+  std::string json = SnapshotAsJson();
+  ShutdownInternalTracer();
+
+  // Begin and end.
+  EXPECT_EQ(2, CountEvents(json, "RingEvent"));
+  EXPECT_EQ(1, CountEvents(json, "RingInstant"));
+  EXPECT_NE(std::string::npos,
+            json.find("\"args\": { \"count\": 7, \"label\": \"static\" }"));
+  EXPECT_EQ(std::string::npos, json.find("dropped"));
+  EXPECT_EQ(0u, json.find("{ \"traceEvents\": ["));
+}
+
+TEST(EventTracerRingTest, RingKeepsMostRecentEvents) {
+  SetupInternalTracer();
+  StartInternalRingCapture();
+  TRACE_EVENT_INSTANT0("webrtc", "Oldest");
+  for (int i = 0; i < 5000; ++i)
+    TRACE_EVENT_INSTANT0("webrtc", "Filler");
+  TRACE_EVENT_INSTANT0("webrtc", "Newest");
+  std::string json = SnapshotAsJson();
+  ShutdownInternalTracer();
+
+  EXPECT_EQ(0, CountEvents(json, "Oldest"));
+  EXPECT_EQ(1, CountEvents(json, "Newest"));
+  EXPECT_LT(0, CountEvents(json, "Filler"));
+  EXPECT_GT(5000, CountEvents(json, "Filler"));
+}
+
+TEST(EventTracerRingTest, RestartDropsPreviousCapture) {
+  SetupInternalTracer();
+  StartInternalRingCapture();
+  TRACE_EVENT_INSTANT0("webrtc", "FirstCapture");
+  StopInternalRingCapture();
+  Buffer snapshot;
+  EXPECT_FALSE(SnapshotInternalRingCapture(&snapshot));
+
+  StartInternalRingCapture();
+  TRACE_EVENT_INSTANT0("webrtc", "SecondCapture");
+  std::string json = SnapshotAsJson();
+  ShutdownInternalTracer();
+
+  EXPECT_EQ(0, CountEvents(json, "FirstCapture"));
+  EXPECT_EQ(1, CountEvents(json, "SecondCapture"));
+}
+
+TEST(EventTracerRingTest, RejectsMalformedSnapshot) {
+  std::string json;
+  EXPECT_FALSE(ConvertRingSnapshotToJson(Buffer(), &json));
+  const uint8_t garbage[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_FALSE(ConvertRingSnapshotToJson(Buffer(garbage), &json));
+
+  SetupInternalTracer();
+  StartInternalRingCapture();
+  TRACE_EVENT_INSTANT0("webrtc", "Truncated");
+  Buffer snapshot;
+  EXPECT_TRUE(SnapshotInternalRingCapture(&snapshot));
+  ShutdownInternalTracer();
+  snapshot.SetSize(snapshot.size() - 1);
+  EXPECT_FALSE(ConvertRingSnapshotToJson(snapshot, &json));
+}
+
+// Measures the cost of a scoped trace event with ring capture running.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(EventTracerRingTest, DISABLED_Performance) {
+  static const int kIterations = 10000000;
+  SetupInternalTracer();
+  StartInternalRingCapture();
+  uint64_t start = TimeNanos();
+  for (int i = 0; i < kIterations; ++i) {
+    TRACE_EVENT0("webrtc", "RingPerformance");
+  }
+  uint64_t elapsed = TimeNanos() - start;
+  ShutdownInternalTracer();
+  LOG(LS_INFO) << kIterations << " TRACE_EVENT0, "
+               << static_cast<double>(elapsed) / kIterations
+               << " ns per scoped event";
+}
+
+}  // namespace tracing
+}  // namespace rtc
@@ -10,10 +10,14 @@
 
 #include "webrtc/base/logsinks.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <iostream>
 #include <string>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/stringencode.h"
 
 namespace rtc {
 
@@ -61,4 +65,139 @@ CallSessionFileRotatingLogSink::CallSessionFileRotatingLogSink(
 CallSessionFileRotatingLogSink::~CallSessionFileRotatingLogSink() {
 }
 
+const size_t AsyncLogSink::kDefaultBufferSize;
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogSink> sink)
+    : AsyncLogSink(std::move(sink), kDefaultBufferSize) {}
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogSink> sink, size_t buffer_size)
+    : sink_(std::move(sink)),
+      capacity_(buffer_size),
+      buffer_(new char[buffer_size]),
+      read_pos_(0),
+      used_(0),
+      accepted_(0),
+      delivered_(0),
+      dropped_(0),
+      unreported_drops_(0),
+      stopping_(false),
+      wake_(false, false),
+      drained_(false, false),
+      thread_(&AsyncLogSink::ThreadFunc, this, "AsyncLogSink") {
+  RTC_DCHECK(sink_);
+  RTC_DCHECK_GT(capacity_, sizeof(uint32_t));
+  thread_.Start();
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    CritScope cs(&crit_);
+    stopping_ = true;
+  }
+  wake_.Set();
+  thread_.Stop();
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message) {
+  const uint32_t length = static_cast<uint32_t>(message.size());
+  bool was_empty;
+  {
+    CritScope cs(&crit_);
+    if (sizeof(length) + length > capacity_ - used_) {
+      ++dropped_;
+      ++unreported_drops_;
+      return;
+    }
+    was_empty = (used_ == 0);
+    WriteLocked(&length, sizeof(length));
+    WriteLocked(message.data(), length);
+    ++accepted_;
+  }
+  // The background thread only goes back to sleep once it has seen the
+  // buffer empty, so it only needs waking for the first message.
+  if (was_empty)
+    wake_.Set();
+}
+
+void AsyncLogSink::Flush() {
+  uint64_t target;
+  {
+    CritScope cs(&crit_);
+    target = accepted_;
+  }
+  while (true) {
+    {
+      CritScope cs(&crit_);
+      if (delivered_ >= target)
+        return;
+    }
+    wake_.Set();
+    // Poll as several threads may be flushing at once.
+    drained_.Wait(10);
+  }
+}
+
+uint64_t AsyncLogSink::dropped_messages() const {
+  CritScope cs(&crit_);
+  return dropped_;
+}
+
+// static
+bool AsyncLogSink::ThreadFunc(void* param) {
+  AsyncLogSink* me = static_cast<AsyncLogSink*>(param);
+  me->wake_.Wait(Event::kForever);
+  return me->DeliverPending();
+}
+
+bool AsyncLogSink::DeliverPending() {
+  bool delivered_one = false;
+  while (true) {
+    uint64_t drops = 0;
+    {
+      CritScope cs(&crit_);
+      if (delivered_one)
+        ++delivered_;
+      delivered_one = false;
+      std::swap(drops, unreported_drops_);
+      if (!drops) {
+        if (used_ == 0) {
+          drained_.Set();
+          return !stopping_;
+        }
+        uint32_t length;
+        ReadLocked(&length, sizeof(length));
+        message_.resize(length);
+        ReadLocked(&message_[0], length);
+        delivered_one = true;
+      }
+    }
+    if (drops) {
+      sink_->OnLogMessage("AsyncLogSink: dropped " + ToString(drops) +
+                          " log messages\n");
+    } else {
+      sink_->OnLogMessage(message_);
+    }
+  }
+}
+
+void AsyncLogSink::WriteLocked(const void* data, size_t size) {
+  RTC_DCHECK_LE(size, capacity_ - used_);
+  const char* src = static_cast<const char*>(data);
+  size_t write_pos = (read_pos_ + used_) % capacity_;
+  size_t first = std::min(size, capacity_ - write_pos);
+  memcpy(&buffer_[write_pos], src, first);
+  memcpy(&buffer_[0], src + first, size - first);
+  used_ += size;
+}
+
+void AsyncLogSink::ReadLocked(void* data, size_t size) {
+  RTC_DCHECK_LE(size, used_);
+  char* dst = static_cast<char*>(data);
+  size_t first = std::min(size, capacity_ - read_pos_);
+  memcpy(dst, &buffer_[read_pos_], first);
+  memcpy(dst + first, &buffer_[0], size - first);
+  read_pos_ = (read_pos_ + size) % capacity_;
+  used_ -= size;
+}
+
 }  // namespace rtc
@@ -11,12 +11,17 @@
 #ifndef WEBRTC_BASE_FILE_ROTATING_LOG_SINK_H_
 #define WEBRTC_BASE_FILE_ROTATING_LOG_SINK_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/filerotatingstream.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/platform_thread.h"
 
 namespace rtc {
 
@@ -63,6 +68,70 @@ class CallSessionFileRotatingLogSink : public FileRotatingLogSink {
   RTC_DISALLOW_COPY_AND_ASSIGN(CallSessionFileRotatingLogSink);
 };
 
+// Log sink that hands messages to another sink on a background thread, so
+// that logging never waits for disk or stream I/O. OnLogMessage() only copies
+// the message into a fixed-size ring buffer; if the buffer is full the
+// message is dropped and counted instead of blocking the caller. The wrapped
+// sink is only called on the background thread, and a line reporting the
+// number of dropped messages is written to it after any drop.
+//
+// Example:
+//   std::unique_ptr<FileRotatingLogSink> file_sink(...);
+//   file_sink->Init();
+//   AsyncLogSink async_sink(std::move(file_sink));
+//   LogMessage::AddLogToStream(&async_sink, LS_VERBOSE);
+class AsyncLogSink : public LogSink {
+ public:
+  static const size_t kDefaultBufferSize = 256 * 1024;
+
+  explicit AsyncLogSink(std::unique_ptr<LogSink> sink);
+  AsyncLogSink(std::unique_ptr<LogSink> sink, size_t buffer_size);
+  // Delivers any buffered messages before returning. The sink must have been
+  // removed from LogMessage by then.
+  ~AsyncLogSink() override;
+
+  void OnLogMessage(const std::string& message) override;
+
+  // Blocks until every message accepted so far has been delivered to the
+  // wrapped sink.
+  void Flush();
+
+  // Total number of messages dropped because the buffer was full.
+  uint64_t dropped_messages() const;
+
+ private:
+  static bool ThreadFunc(void* param);
+  // Delivers messages until the buffer is empty. Returns false if the sink is
+  // being destroyed.
+  bool DeliverPending();
+
+  void WriteLocked(const void* data, size_t size)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void ReadLocked(void* data, size_t size) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const std::unique_ptr<LogSink> sink_;
+  const size_t capacity_;
+  const std::unique_ptr<char[]> buffer_;
+
+  mutable CriticalSection crit_;
+  size_t read_pos_ GUARDED_BY(crit_);
+  size_t used_ GUARDED_BY(crit_);
+  uint64_t accepted_ GUARDED_BY(crit_);
+  uint64_t delivered_ GUARDED_BY(crit_);
+  uint64_t dropped_ GUARDED_BY(crit_);
+  uint64_t unreported_drops_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+
+  // Only used on the background thread.
+  std::string message_;
+
+  Event wake_;
+  Event drained_;
+  PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AsyncLogSink);
+};
+
 }  // namespace rtc
 
 #endif  // WEBRTC_BASE_FILE_ROTATING_LOG_SINK_H_
@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logsinks.h"
+#include "webrtc/base/platform_thread.h"
+
+namespace rtc {
+
+namespace {
+
+// Records messages, optionally blocking in OnLogMessage() until released.
+class RecordingSink : public LogSink {
+ public:
+  RecordingSink() : blocked_(true, true), entered_(false, false) {}
+
+  void OnLogMessage(const std::string& message) override {
+    entered_.Set();
+    blocked_.Wait(Event::kForever);
+    CritScope cs(&crit_);
+    messages_.push_back(message);
+    delivering_thread_ = CurrentThreadRef();
+  }
+
+  void Block() { blocked_.Reset(); }
+  void Unblock() { blocked_.Set(); }
+  bool WaitForEntered() { return entered_.Wait(1000); }
+
+  std::vector<std::string> messages() const {
+    CritScope cs(&crit_);
+    return messages_;
+  }
+  PlatformThreadRef delivering_thread() const {
+    CritScope cs(&crit_);
+    return delivering_thread_;
+  }
+
+ private:
+  mutable CriticalSection crit_;
+  std::vector<std::string> messages_ GUARDED_BY(crit_);
+  PlatformThreadRef delivering_thread_ GUARDED_BY(crit_);
+  Event blocked_;
+  Event entered_;
+};
+
+// AsyncLogSink owns the sink it wraps; this lets the tests keep the
+// RecordingSink alive after the AsyncLogSink is gone.
+class ForwardingSink : public LogSink {
+ public:
+  explicit ForwardingSink(LogSink* target) : target_(target) {}
+  void OnLogMessage(const std::string& message) override {
+    target_->OnLogMessage(message);
+  }
+
+ private:
+  LogSink* const target_;
+};
+
+std::unique_ptr<LogSink> ForwardTo(LogSink* target) {
+  return std::unique_ptr<LogSink>(new ForwardingSink(target));
+}
+
+}  // namespace
+
+TEST(AsyncLogSinkTest, DeliversMessagesInOrder) {
+  RecordingSink recorder;
+  AsyncLogSink sink(ForwardTo(&recorder));
+  sink.OnLogMessage("one\n");
+  sink.OnLogMessage("");
+  sink.OnLogMessage("three\n");
+  sink.Flush();
+
+  std::vector<std::string> messages = recorder.messages();
+  ASSERT_EQ(3u, messages.size());
+  EXPECT_EQ("one\n", messages[0]);
+  EXPECT_EQ("", messages[1]);
+  EXPECT_EQ("three\n", messages[2]);
+  EXPECT_EQ(0u, sink.dropped_messages());
+  EXPECT_FALSE(IsThreadRefEqual(CurrentThreadRef(),
+                                recorder.delivering_thread()));
+}
+
+TEST(AsyncLogSinkTest, MessagesWrapAroundBuffer) {
+  RecordingSink recorder;
+  // Small enough that the records have to wrap many times.
+  AsyncLogSink sink(ForwardTo(&recorder), 37);
+  std::vector<std::string> expected;
+  for (int i = 0; i < 100; ++i) {
+    expected.push_back(std::string(i % 13, 'a' + i % 26));
+    sink.OnLogMessage(expected.back());
+    sink.Flush();
+  }
+  EXPECT_EQ(expected, recorder.messages());
+  EXPECT_EQ(0u, sink.dropped_messages());
+}
+
+TEST(AsyncLogSinkTest, DropsWhenFullWithoutBlocking) {
+  RecordingSink recorder;
+  recorder.Block();
+  // Room for a single record with a 4 byte payload.
+  AsyncLogSink sink(ForwardTo(&recorder), 8);
+  sink.OnLogMessage("aaaa");
+  // Wait until the first record has been taken out and the background thread
+  // is stuck in the sink.
+  ASSERT_TRUE(recorder.WaitForEntered());
+  sink.OnLogMessage("bbbb");
+  sink.OnLogMessage("cccc");
+  sink.OnLogMessage("longer than the buffer");
+  EXPECT_EQ(2u, sink.dropped_messages());
+  recorder.Unblock();
+  sink.Flush();
+
+  std::vector<std::string> messages = recorder.messages();
+  ASSERT_EQ(3u, messages.size());
+  EXPECT_EQ("aaaa", messages[0]);
+  EXPECT_EQ("AsyncLogSink: dropped 2 log messages\n", messages[1]);
+  EXPECT_EQ("bbbb", messages[2]);
+}
+
+TEST(AsyncLogSinkTest, DestructorDeliversPendingMessages) {
+  RecordingSink recorder;
+  {
+    recorder.Block();
+    AsyncLogSink sink(ForwardTo(&recorder));
+    sink.OnLogMessage("first");
+    ASSERT_TRUE(recorder.WaitForEntered());
+    sink.OnLogMessage("second");
+    recorder.Unblock();
+  }
+  std::vector<std::string> messages = recorder.messages();
+  ASSERT_EQ(2u, messages.size());
+  EXPECT_EQ("first", messages[0]);
+  EXPECT_EQ("second", messages[1]);
+}
+
+TEST(AsyncLogSinkTest, WorksWithLogMessage) {
+  RecordingSink recorder;
+  AsyncLogSink sink(ForwardTo(&recorder));
+  LogMessage::AddLogToStream(&sink, LS_INFO);
+  LOG(LS_INFO) << "AsyncLogSinkTest";
+  LogMessage::RemoveLogToStream(&sink);
+  sink.Flush();
+
+  std::vector<std::string> messages = recorder.messages();
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_NE(std::string::npos, messages[0].find("AsyncLogSinkTest"));
+}
+
+}  // namespace rtc
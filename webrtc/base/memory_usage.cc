@@ -0,0 +1,150 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/memory_usage.h"
+
+#include <algorithm>
+#include <map>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/thread_annotations.h"
+
+namespace rtc {
+
+class MemoryCounter {
+ public:
+  explicit MemoryCounter(const char* name) : name_(name) {}
+
+  void AddOwner() {
+    CritScope cs(&lock_);
+    ++num_owners_;
+  }
+
+  void RemoveOwner() {
+    CritScope cs(&lock_);
+    RTC_DCHECK_GT(num_owners_, 0);
+    --num_owners_;
+  }
+
+  void Update(int64_t delta) {
+    CritScope cs(&lock_);
+    bytes_ += delta;
+    RTC_DCHECK_GE(bytes_, 0);
+    peak_bytes_ = std::max(peak_bytes_, bytes_);
+  }
+
+  MemoryUsage Get() const {
+    CritScope cs(&lock_);
+    MemoryUsage usage;
+    usage.name = name_;
+    usage.bytes = bytes_;
+    usage.peak_bytes = peak_bytes_;
+    usage.num_owners = num_owners_;
+    return usage;
+  }
+
+ private:
+  const char* const name_;
+  CriticalSection lock_;
+  int64_t bytes_ GUARDED_BY(lock_) = 0;
+  int64_t peak_bytes_ GUARDED_BY(lock_) = 0;
+  int num_owners_ GUARDED_BY(lock_) = 0;
+};
+
+namespace {
+
+volatile int g_accounting_enabled = 0;
+
+// Counters are never destroyed, since owners may outlive any shutdown code.
+struct MemoryCounterRegistry {
+  CriticalSection lock;
+  std::map<std::string, MemoryCounter*> counters GUARDED_BY(lock);
+};
+
+MemoryCounterRegistry* GetRegistry() {
+  static MemoryCounterRegistry* const registry = new MemoryCounterRegistry();
+  return registry;
+}
+
+MemoryCounter* GetCounter(const char* name) {
+  if (!MemoryAccountingEnabled())
+    return nullptr;
+  MemoryCounterRegistry* registry = GetRegistry();
+  CritScope cs(&registry->lock);
+  MemoryCounter*& counter = registry->counters[name];
+  if (!counter)
+    counter = new MemoryCounter(name);
+  return counter;
+}
+
+}  // namespace
+
+void EnableMemoryAccounting() {
+  AtomicOps::ReleaseStore(&g_accounting_enabled, 1);
+}
+
+bool MemoryAccountingEnabled() {
+  return AtomicOps::AcquireLoad(&g_accounting_enabled) != 0;
+}
+
+std::vector<MemoryUsage> GetMemoryUsage() {
+  std::vector<MemoryUsage> usages;
+  MemoryCounterRegistry* registry = GetRegistry();
+  CritScope cs(&registry->lock);
+  for (const auto& it : registry->counters)
+    usages.push_back(it.second->Get());
+  return usages;
+}
+
+void LogMemoryUsage() {
+  for (const MemoryUsage& usage : GetMemoryUsage()) {
+    LOG(LS_INFO) << usage.name << ": " << usage.bytes << " bytes (peak "
+                 << usage.peak_bytes << ") in " << usage.num_owners
+                 << " owners";
+  }
+}
+
+ScopedMemoryUsage::ScopedMemoryUsage(const char* name)
+    : counter_(GetCounter(name)), bytes_(0) {
+  if (counter_)
+    counter_->AddOwner();
+}
+
+ScopedMemoryUsage::~ScopedMemoryUsage() {
+  if (counter_) {
+    counter_->Update(-static_cast<int64_t>(bytes_));
+    counter_->RemoveOwner();
+  }
+}
+
+void ScopedMemoryUsage::Add(size_t bytes) {
+  bytes_ += bytes;
+  if (counter_)
+    counter_->Update(static_cast<int64_t>(bytes));
+}
+
+void ScopedMemoryUsage::Subtract(size_t bytes) {
+  RTC_DCHECK_LE(bytes, bytes_);
+  bytes_ -= bytes;
+  if (counter_)
+    counter_->Update(-static_cast<int64_t>(bytes));
+}
+
+void ScopedMemoryUsage::Set(size_t bytes) {
+  if (bytes >= bytes_)
+    Add(bytes - bytes_);
+  else
+    Subtract(bytes_ - bytes);
+}
+
+}  // namespace rtc
@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_MEMORY_USAGE_H_
+#define WEBRTC_BASE_MEMORY_USAGE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+
+namespace rtc {
+
+// Opt-in accounting of the memory held by the larger pools and buffers, such
+// as packet histories and frame buffer pools. Each owner of such memory keeps
+// a ScopedMemoryUsage and reports how many bytes it currently holds; the
+// bytes of all owners with the same name are summed up in a process-wide
+// counter that can be read with GetMemoryUsage().
+//
+// Accounting is off by default and costs a single flag check per update
+// while it is off. Owners created before EnableMemoryAccounting() was called
+// keep not reporting, so the totals only cover owners created afterwards.
+
+struct MemoryUsage {
+  std::string name;
+  // Bytes currently held by all owners with this name.
+  int64_t bytes = 0;
+  // Largest value |bytes| has had.
+  int64_t peak_bytes = 0;
+  // Number of owners currently alive.
+  int num_owners = 0;
+};
+
+// Starts accounting for ScopedMemoryUsages created from now on.
+void EnableMemoryAccounting();
+bool MemoryAccountingEnabled();
+
+// Returns the usage of every name seen since accounting was enabled, sorted by
+// name.
+std::vector<MemoryUsage> GetMemoryUsage();
+
+// Logs the result of GetMemoryUsage().
+void LogMemoryUsage();
+
+class MemoryCounter;
+
+// The bytes held by one owner. |name| must be a string literal (or otherwise
+// outlive the process); names are usually the class that owns the memory,
+// e.g. "I420BufferPool". Not thread safe; the owner must serialize updates
+// the same way it serializes access to the memory it accounts for.
+class ScopedMemoryUsage {
+ public:
+  explicit ScopedMemoryUsage(const char* name);
+  ~ScopedMemoryUsage();
+
+  void Add(size_t bytes);
+  void Subtract(size_t bytes);
+  void Set(size_t bytes);
+
+  size_t bytes() const { return bytes_; }
+
+ private:
+  // Null if accounting was disabled when this object was created.
+  MemoryCounter* const counter_;
+  size_t bytes_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ScopedMemoryUsage);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_MEMORY_USAGE_H_
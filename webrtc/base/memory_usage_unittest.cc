@@ -0,0 +1,55 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/memory_usage.h"
+
+#include <memory>
+
+#include "webrtc/base/gunit.h"
+
+namespace rtc {
+
+namespace {
+
+MemoryUsage FindUsage(const std::string& name) {
+  for (const MemoryUsage& usage : GetMemoryUsage()) {
+    if (usage.name == name)
+      return usage;
+  }
+  return MemoryUsage();
+}
+
+}  // namespace
+
+TEST(MemoryUsageTest, SumsUpOwnersWithTheSameName) {
+  EnableMemoryAccounting();
+  std::unique_ptr<ScopedMemoryUsage> first(
+      new ScopedMemoryUsage("MemoryUsageTest.Sum"));
+  ScopedMemoryUsage second("MemoryUsageTest.Sum");
+  first->Add(100);
+  second.Add(50);
+  second.Subtract(20);
+  EXPECT_EQ(130u, first->bytes() + second.bytes());
+
+  MemoryUsage usage = FindUsage("MemoryUsageTest.Sum");
+  EXPECT_EQ(130, usage.bytes);
+  EXPECT_EQ(150, usage.peak_bytes);
+  EXPECT_EQ(2, usage.num_owners);
+
+  // Destroying an owner gives back what it held.
+  first.reset();
+  second.Set(10);
+  usage = FindUsage("MemoryUsageTest.Sum");
+  EXPECT_EQ(10, usage.bytes);
+  EXPECT_EQ(150, usage.peak_bytes);
+  EXPECT_EQ(1, usage.num_owners);
+}
+
+}  // namespace rtc
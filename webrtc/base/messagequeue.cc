@@ -168,7 +168,11 @@ void MessageQueueManager::ProcessAllMessageQueuesInternal() {
 // MessageQueue
 MessageQueue::MessageQueue(SocketServer* ss, bool init_queue)
     : fPeekKeep_(false),
-      dmsgq_next_num_(0),
+      posted_size_(0),
+      msgq_head_(nullptr),
+      msgq_tail_(nullptr),
+      msgq_size_(0),
+      dmsgq_(TimeMillis()),
       fInitialized_(false),
       fDestroyed_(false),
       stop_(0),
@@ -192,6 +196,15 @@ MessageQueue::MessageQueue(std::unique_ptr<SocketServer> ss, bool init_queue)
 
 MessageQueue::~MessageQueue() {
   DoDestroy();
+  // Free the nodes of anything posted after DoDestroy() cleared the queue.
+  // As before, their message data is not deleted.
+  CritScope cs(&crit_);
+  DrainPostedMessages();
+  while (msgq_head_) {
+    QueuedMessage* node = msgq_head_;
+    msgq_head_ = node->mpsc_next;
+    delete node;
+  }
 }
 
 void MessageQueue::DoInit() {
@@ -292,32 +305,41 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
     int64_t cmsDelayNext = kForever;
     bool first_pass = true;
     while (true) {
+      QueuedMessage* node;
       // All queue operations need to be locked, but nothing else in this loop
       // (specifically handling disposed message) can happen inside the crit.
       // Otherwise, disposed MessageHandlers will cause deadlocks.
       {
         CritScope cs(&crit_);
+        // Immediate posts made so far go ahead of any delayed messages that
+        // trigger now.
+        DrainPostedMessages();
         // On the first pass, check for delayed messages that have been
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
-          while (!dmsgq_.empty()) {
-            if (msCurrent < dmsgq_.top().msTrigger_) {
-              cmsDelayNext = TimeDiff(dmsgq_.top().msTrigger_, msCurrent);
-              break;
-            }
-            msgq_.push_back(dmsgq_.top().msg_);
-            dmsgq_.pop();
+          Message triggered;
+          while (dmsgq_.PopExpired(msCurrent, &triggered)) {
+            PushReadyMessage(new QueuedMessage(triggered));
+          }
+          int64_t msNext;
+          if (dmsgq_.NextExpiry(&msNext)) {
+            cmsDelayNext = std::max<int64_t>(0, TimeDiff(msNext, msCurrent));
           }
         }
         // Pull a message off the message queue, if available.
-        if (msgq_.empty()) {
+        if (!msgq_head_) {
           break;
-        } else {
-          *pmsg = msgq_.front();
-          msgq_.pop_front();
         }
+        node = msgq_head_;
+        msgq_head_ = node->mpsc_next;
+        if (!msgq_head_) {
+          msgq_tail_ = nullptr;
+        }
+        --msgq_size_;
       }  // crit_ is released here.
+      *pmsg = node->msg;
+      delete node;
 
       // Log a warning for time-sensitive messages that we're late to deliver.
       if (pmsg->ts_sensitive) {
@@ -381,22 +403,20 @@ void MessageQueue::Post(const Location& posted_from,
   if (IsQuitting())
     return;
 
-  // Keep thread safe
-  // Add the message to the end of the queue
+  // Add the message to the end of the queue without taking crit_; the
+  // consumer picks it up on its next pass.
   // Signal for the multiplexer to return
 
-  {
-    CritScope cs(&crit_);
-    Message msg;
-    msg.posted_from = posted_from;
-    msg.phandler = phandler;
-    msg.message_id = id;
-    msg.pdata = pdata;
-    if (time_sensitive) {
-      msg.ts_sensitive = TimeMillis() + kMaxMsgLatency;
-    }
-    msgq_.push_back(msg);
+  Message msg;
+  msg.posted_from = posted_from;
+  msg.phandler = phandler;
+  msg.message_id = id;
+  msg.pdata = pdata;
+  if (time_sensitive) {
+    msg.ts_sensitive = TimeMillis() + kMaxMsgLatency;
   }
+  AtomicOps::Increment(&posted_size_);
+  posted_.Push(new QueuedMessage(msg));
   WakeUpSocketServer();
 }
 
@@ -405,6 +425,15 @@ void MessageQueue::PostDelayed(const Location& posted_from,
                                MessageHandler* phandler,
                                uint32_t id,
                                MessageData* pdata) {
+  DoDelayPost(posted_from, cmsDelay, TimeAfter(cmsDelay), phandler, id, pdata);
+}
+
+DelayedMessageHandle MessageQueue::PostDelayedWithHandle(
+    const Location& posted_from,
+    int cmsDelay,
+    MessageHandler* phandler,
+    uint32_t id,
+    MessageData* pdata) {
   return DoDelayPost(posted_from, cmsDelay, TimeAfter(cmsDelay), phandler, id,
                      pdata);
 }
@@ -416,7 +445,7 @@ void MessageQueue::PostAt(const Location& posted_from,
                           MessageData* pdata) {
   // This should work even if it is used (unexpectedly).
   int64_t delay = static_cast<uint32_t>(TimeMillis()) - tstamp;
-  return DoDelayPost(posted_from, delay, tstamp, phandler, id, pdata);
+  DoDelayPost(posted_from, delay, tstamp, phandler, id, pdata);
 }
 
 void MessageQueue::PostAt(const Location& posted_from,
@@ -424,24 +453,24 @@ void MessageQueue::PostAt(const Location& posted_from,
                           MessageHandler* phandler,
                           uint32_t id,
                           MessageData* pdata) {
-  return DoDelayPost(posted_from, TimeUntil(tstamp), tstamp, phandler, id,
-                     pdata);
+  DoDelayPost(posted_from, TimeUntil(tstamp), tstamp, phandler, id, pdata);
 }
 
-void MessageQueue::DoDelayPost(const Location& posted_from,
-                               int64_t cmsDelay,
-                               int64_t tstamp,
-                               MessageHandler* phandler,
-                               uint32_t id,
-                               MessageData* pdata) {
+DelayedMessageHandle MessageQueue::DoDelayPost(const Location& posted_from,
+                                               int64_t cmsDelay,
+                                               int64_t tstamp,
+                                               MessageHandler* phandler,
+                                               uint32_t id,
+                                               MessageData* pdata) {
   if (IsQuitting()) {
-    return;
+    return TimerWheel<Message>::kInvalidHandle;
   }
 
   // Keep thread safe
-  // Add to the priority queue. Gets sorted soonest first.
+  // Add to the timer wheel, which keeps them sorted soonest first.
   // Signal for the multiplexer to return.
 
+  DelayedMessageHandle handle;
   {
     CritScope cs(&crit_);
     Message msg;
@@ -449,24 +478,21 @@ void MessageQueue::DoDelayPost(const Location& posted_from,
     msg.phandler = phandler;
     msg.message_id = id;
     msg.pdata = pdata;
-    DelayedMessage dmsg(cmsDelay, tstamp, dmsgq_next_num_, msg);
-    dmsgq_.push(dmsg);
-    // If this message queue processes 1 message every millisecond for 50 days,
-    // we will wrap this number.  Even then, only messages with identical times
-    // will be misordered, and then only briefly.  This is probably ok.
-    VERIFY(0 != ++dmsgq_next_num_);
+    handle = dmsgq_.Insert(tstamp, msg);
   }
   WakeUpSocketServer();
+  return handle;
 }
 
 int MessageQueue::GetDelay() {
   CritScope cs(&crit_);
 
-  if (!msgq_.empty())
+  if (msgq_head_ || !posted_.empty())
     return 0;
 
-  if (!dmsgq_.empty()) {
-    int delay = TimeUntil(dmsgq_.top().msTrigger_);
+  int64_t msNext;
+  if (dmsgq_.NextExpiry(&msNext)) {
+    int delay = TimeUntil(msNext);
     if (delay < 0)
       delay = 0;
     return delay;
@@ -479,6 +505,7 @@ void MessageQueue::Clear(MessageHandler* phandler,
                          uint32_t id,
                          MessageList* removed) {
   CritScope cs(&crit_);
+  DrainPostedMessages();
 
   // Remove messages with phandler
 
@@ -493,36 +520,76 @@ void MessageQueue::Clear(MessageHandler* phandler,
 
   // Remove from ordered message queue
 
-  for (MessageList::iterator it = msgq_.begin(); it != msgq_.end();) {
-    if (it->Match(phandler, id)) {
+  QueuedMessage* prev = nullptr;
+  QueuedMessage** link = &msgq_head_;
+  while (QueuedMessage* node = *link) {
+    if (node->msg.Match(phandler, id)) {
       if (removed) {
-        removed->push_back(*it);
+        removed->push_back(node->msg);
       } else {
-        delete it->pdata;
+        delete node->msg.pdata;
+      }
+      *link = node->mpsc_next;
+      if (msgq_tail_ == node) {
+        msgq_tail_ = prev;
       }
-      it = msgq_.erase(it);
+      --msgq_size_;
+      delete node;
     } else {
-      ++it;
+      prev = node;
+      link = &node->mpsc_next;
     }
   }
 
-  // Remove from priority queue. Not directly iterable, so use this approach
+  // Remove from the timer wheel
 
-  PriorityQueue::container_type::iterator new_end = dmsgq_.container().begin();
-  for (PriorityQueue::container_type::iterator it = new_end;
-       it != dmsgq_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(it->msg_);
-      } else {
-        delete it->msg_.pdata;
-      }
+  dmsgq_.RemoveIf([phandler, id, removed](Message* msg) {
+    if (!msg->Match(phandler, id))
+      return false;
+    if (removed) {
+      removed->push_back(*msg);
     } else {
-      *new_end++ = *it;
+      delete msg->pdata;
     }
+    return true;
+  });
+}
+
+bool MessageQueue::CancelDelayed(DelayedMessageHandle handle,
+                                 Message* removed) {
+  Message msg;
+  {
+    CritScope cs(&crit_);
+    if (!dmsgq_.Cancel(handle, &msg))
+      return false;
+  }
+  if (removed) {
+    *removed = msg;
+  } else {
+    delete msg.pdata;
+  }
+  return true;
+}
+
+void MessageQueue::DrainPostedMessages() {
+  QueuedMessage* node = posted_.PopAll();
+  while (node) {
+    QueuedMessage* next = node->mpsc_next;
+    AtomicOps::Decrement(&posted_size_);
+    PushReadyMessage(node);
+    node = next;
+  }
+}
+
+void MessageQueue::PushReadyMessage(QueuedMessage* node) {
+  node->mpsc_next = nullptr;
+  if (msgq_tail_) {
+    msgq_tail_->mpsc_next = node;
+  } else {
+    msgq_head_ = node;
   }
-  dmsgq_.container().erase(new_end, dmsgq_.container().end());
-  dmsgq_.reheap();
+  msgq_tail_ = node;
+  ++msgq_size_;
 }
 
 void MessageQueue::Dispatch(Message *pmsg) {
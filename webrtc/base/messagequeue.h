@@ -24,10 +24,12 @@
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/location.h"
 #include "webrtc/base/messagehandler.h"
+#include "webrtc/base/mpscqueue.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/sharedexclusivelock.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/socketserver.h"
+#include "webrtc/base/timerwheel.h"
 #include "webrtc/base/timeutils.h"
 #include "webrtc/base/thread_annotations.h"
 
@@ -157,27 +159,8 @@ struct Message {
 
 typedef std::list<Message> MessageList;
 
-// DelayedMessage goes into a priority queue, sorted by trigger time.  Messages
-// with the same trigger time are processed in num_ (FIFO) order.
-
-class DelayedMessage {
- public:
-  DelayedMessage(int64_t delay,
-                 int64_t trigger,
-                 uint32_t num,
-                 const Message& msg)
-      : cmsDelay_(delay), msTrigger_(trigger), num_(num), msg_(msg) {}
-
-  bool operator< (const DelayedMessage& dmsg) const {
-    return (dmsg.msTrigger_ < msTrigger_)
-           || ((dmsg.msTrigger_ == msTrigger_) && (dmsg.num_ < num_));
-  }
-
-  int64_t cmsDelay_;  // for debugging
-  int64_t msTrigger_;
-  uint32_t num_;
-  Message msg_;
-};
+// Identifies a delayed message for MessageQueue::CancelDelayed().
+typedef TimerWheel<Message>::Handle DelayedMessageHandle;
 
 class MessageQueue {
  public:
@@ -238,9 +221,20 @@ class MessageQueue {
                       MessageHandler* phandler,
                       uint32_t id = 0,
                       MessageData* pdata = NULL);
+  // Like PostDelayed(), but returns a handle CancelDelayed() accepts, for
+  // timers that are cancelled individually.
+  DelayedMessageHandle PostDelayedWithHandle(const Location& posted_from,
+                                             int cmsDelay,
+                                             MessageHandler* phandler,
+                                             uint32_t id = 0,
+                                             MessageData* pdata = NULL);
   virtual void Clear(MessageHandler* phandler,
                      uint32_t id = MQID_ANY,
                      MessageList* removed = NULL);
+  // Removes the delayed message |handle| identifies, in constant time. Its
+  // data is moved to |removed| if given, and deleted otherwise. Returns false
+  // if the message has already triggered or been removed.
+  bool CancelDelayed(DelayedMessageHandle handle, Message* removed = NULL);
   virtual void Dispatch(Message *pmsg);
   virtual void ReceiveSends();
 
@@ -249,8 +243,9 @@ class MessageQueue {
 
   bool empty() const { return size() == 0u; }
   size_t size() const {
-    CritScope cs(&crit_);  // msgq_.size() is not thread safe.
-    return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u);
+    CritScope cs(&crit_);  // dmsgq_.size() is not thread safe.
+    return msgq_size_ + AtomicOps::AcquireLoad(&posted_size_) +
+           dmsgq_.size() + (fPeekKeep_ ? 1u : 0u);
   }
 
   // Internally posts a message which causes the doomed object to be deleted
@@ -265,18 +260,22 @@ class MessageQueue {
   sigslot::signal0<> SignalQueueDestroyed;
 
  protected:
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
+  // A message posted for immediate delivery. Post() pushes these onto
+  // |posted_| without taking |crit_|; the consumer moves them to |msgq_head_|
+  // in order before looking at them.
+  struct QueuedMessage {
+    explicit QueuedMessage(const Message& msg)
+        : msg(msg), mpsc_next(nullptr) {}
+    Message msg;
+    QueuedMessage* mpsc_next;
   };
 
-  void DoDelayPost(const Location& posted_from,
-                   int64_t cmsDelay,
-                   int64_t tstamp,
-                   MessageHandler* phandler,
-                   uint32_t id,
-                   MessageData* pdata);
+  DelayedMessageHandle DoDelayPost(const Location& posted_from,
+                                   int64_t cmsDelay,
+                                   int64_t tstamp,
+                                   MessageHandler* phandler,
+                                   uint32_t id,
+                                   MessageData* pdata);
 
   // Perform initialization, subclasses must call this from their constructor
   // if false was passed as init_queue to the MessageQueue constructor.
@@ -288,11 +287,23 @@ class MessageQueue {
 
   void WakeUpSocketServer();
 
+  // Moves everything in |posted_| to the end of |msgq_head_|.
+  void DrainPostedMessages() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void PushReadyMessage(QueuedMessage* node) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   bool fPeekKeep_;
   Message msgPeek_;
-  MessageList msgq_ GUARDED_BY(crit_);
-  PriorityQueue dmsgq_ GUARDED_BY(crit_);
-  uint32_t dmsgq_next_num_ GUARDED_BY(crit_);
+  MpscQueue<QueuedMessage> posted_;
+  // Number of messages in |posted_|. Incremented before a push, so it may
+  // briefly count a message that is not yet visible.
+  volatile int posted_size_;
+  // Messages ready for delivery, singly linked through mpsc_next.
+  QueuedMessage* msgq_head_ GUARDED_BY(crit_);
+  QueuedMessage* msgq_tail_ GUARDED_BY(crit_);
+  size_t msgq_size_ GUARDED_BY(crit_);
+  // Delayed messages, by trigger time. Messages with the same trigger time
+  // are processed in FIFO order.
+  TimerWheel<Message> dmsgq_ GUARDED_BY(crit_);
   CriticalSection crit_;
   bool fInitialized_;
   bool fDestroyed_;
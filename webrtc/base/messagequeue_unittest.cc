@@ -10,13 +10,17 @@
 
 #include "webrtc/base/messagequeue.h"
 
+#include <algorithm>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include "webrtc/base/atomicops.h"
 #include "webrtc/base/bind.h"
 #include "webrtc/base/event.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/base/timeutils.h"
 #include "webrtc/base/nullsocketserver.h"
@@ -85,6 +89,38 @@ TEST_F(MessageQueueTest,
   DelayedPostsWithIdenticalTimesAreProcessedInFifoOrder(&q_nullss);
 }
 
+TEST_F(MessageQueueTest, CancelDelayed) {
+  MessageQueue q(SocketServer::CreateDefault(), true);
+  DelayedMessageHandle first =
+      q.PostDelayedWithHandle(RTC_FROM_HERE, 0, NULL, 1);
+  q.PostDelayedWithHandle(RTC_FROM_HERE, 0, NULL, 2);
+  DelayedMessageHandle third = q.PostDelayedWithHandle(
+      RTC_FROM_HERE, 0, NULL, 3, new TypedMessageData<int>(3));
+  EXPECT_EQ(3u, q.size());
+
+  EXPECT_TRUE(q.CancelDelayed(first));
+  EXPECT_FALSE(q.CancelDelayed(first));
+  Message removed;
+  EXPECT_TRUE(q.CancelDelayed(third, &removed));
+  EXPECT_EQ(3u, removed.message_id);
+  delete removed.pdata;
+  EXPECT_EQ(1u, q.size());
+
+  Message msg;
+  EXPECT_TRUE(q.Get(&msg, 0));
+  EXPECT_EQ(2u, msg.message_id);
+  EXPECT_FALSE(q.Get(&msg, 0));
+}
+
+TEST_F(MessageQueueTest, CancelDelayedAfterTrigger) {
+  MessageQueue q(SocketServer::CreateDefault(), true);
+  DelayedMessageHandle handle =
+      q.PostDelayedWithHandle(RTC_FROM_HERE, 0, NULL, 1);
+  Message msg;
+  EXPECT_TRUE(q.Get(&msg, 0));
+  EXPECT_FALSE(q.CancelDelayed(handle));
+}
+
 TEST_F(MessageQueueTest, DisposeNotLocked) {
   bool was_locked = true;
   bool deleted = false;
@@ -215,3 +251,79 @@ TEST(MessageQueueManager, ProcessAllMessageQueuesWithClearedQueue) {
   rtc::Thread::Current()->Post(RTC_FROM_HERE, &event_signaler);
   MessageQueueManager::ProcessAllMessageQueues();
 }
+
+namespace {
+
+// Counts the messages dispatched to it and signals |done| once |expected|
+// messages have arrived.
+class CountingMessageHandler : public MessageHandler {
+ public:
+  CountingMessageHandler(int expected, Event* done)
+      : expected_(expected), done_(done) {}
+  void OnMessage(Message* msg) override {
+    if (++count_ == expected_)
+      done_->Set();
+  }
+
+ private:
+  const int expected_;
+  Event* const done_;
+  int count_ = 0;
+};
+
+class PostingThread {
+ public:
+  PostingThread(MessageQueue* queue, MessageHandler* handler, int count)
+      : queue_(queue), handler_(handler), count_(count),
+        thread_(&ThreadFunc, this, "MqPerfPoster") {}
+
+  void Start() { thread_.Start(); }
+  void Stop() { thread_.Stop(); }
+
+ private:
+  static bool ThreadFunc(void* param) {
+    PostingThread* me = static_cast<PostingThread*>(param);
+    for (int i = 0; i < me->count_; ++i)
+      me->queue_->Post(RTC_FROM_HERE, me->handler_);
+    return false;
+  }
+
+  MessageQueue* const queue_;
+  MessageHandler* const handler_;
+  const int count_;
+  PlatformThread thread_;
+};
+
+}  // namespace
+
+// Measures end-to-end Post() to Dispatch() throughput with several threads
+// posting to one rtc::Thread, as with many PeerConnections sharing a worker
+// thread. The test is disabled by default to avoid unnecessarily loading the
+// bots.
+TEST(MessageQueuePerfTest, DISABLED_PostDispatchThroughput) {
+  static const int kMessagesPerThread = 200000;
+  for (size_t num_threads : {1, 4, 8}) {
+    Thread consumer;
+    consumer.Start();
+    Event done(false, false);
+    const int total = static_cast<int>(num_threads) * kMessagesPerThread;
+    CountingMessageHandler handler(total, &done);
+    std::vector<std::unique_ptr<PostingThread>> posters;
+    for (size_t i = 0; i < num_threads; ++i) {
+      posters.emplace_back(
+          new PostingThread(&consumer, &handler, kMessagesPerThread));
+    }
+
+    int64_t start = TimeMillis();
+    for (auto& poster : posters)
+      poster->Start();
+    EXPECT_TRUE(done.Wait(Event::kForever));
+    int64_t elapsed = std::max<int64_t>(1, TimeSince(start));
+    LOG(LS_INFO) << num_threads << " posting threads: " << total
+                 << " messages in " << elapsed << " ms ("
+                 << total * 1000 / elapsed << " msg/s)";
+    for (auto& poster : posters)
+      poster->Stop();
+    consumer.Stop();
+  }
+}
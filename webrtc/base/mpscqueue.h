@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_MPSCQUEUE_H_
+#define WEBRTC_BASE_MPSCQUEUE_H_
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/constructormagic.h"
+
+namespace rtc {
+
+// Intrusive, lock-free multi-producer single-consumer queue. T must have a
+// member "T* mpsc_next" that the queue is free to overwrite while the node is
+// queued.
+//
+// Push() may be called concurrently from any number of threads; it never
+// blocks and never allocates. PopAll() detaches every node pushed so far and
+// returns them linked through mpsc_next in the order they were pushed. Only
+// one thread may call PopAll() at a time; callers that consume from several
+// threads must serialize PopAll() themselves.
+//
+// Nodes are pushed onto a stack with a CAS loop and the consumer takes the
+// whole stack at once, so there is no ABA hazard: a node is never popped
+// individually while producers are pushing.
+template <class T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(nullptr) {}
+  // The queue does not own its nodes; it must be empty when destroyed.
+  ~MpscQueue() {}
+
+  void Push(T* node) {
+    T* head = AtomicOps::AcquireLoadPtr(&head_);
+    while (true) {
+      node->mpsc_next = head;
+      T* prev = AtomicOps::CompareAndSwapPtr(&head_, head, node);
+      if (prev == head)
+        return;
+      head = prev;
+    }
+  }
+
+  // Returns the oldest node, with the rest following it through mpsc_next,
+  // or null if the queue is empty.
+  T* PopAll() {
+    T* head = AtomicOps::AcquireLoadPtr(&head_);
+    while (head) {
+      T* prev = AtomicOps::CompareAndSwapPtr(&head_, head,
+                                             static_cast<T*>(nullptr));
+      if (prev == head)
+        break;
+      head = prev;
+    }
+    // The stack is newest first; reverse it.
+    T* fifo = nullptr;
+    while (head) {
+      T* next = head->mpsc_next;
+      head->mpsc_next = fifo;
+      fifo = head;
+      head = next;
+    }
+    return fifo;
+  }
+
+  // Only a hint when producers are active.
+  bool empty() const {
+    return AtomicOps::AcquireLoadPtr(const_cast<T* volatile*>(&head_)) ==
+           nullptr;
+  }
+
+ private:
+  T* volatile head_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MpscQueue);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_MPSCQUEUE_H_
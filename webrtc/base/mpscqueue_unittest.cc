@@ -0,0 +1,227 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/mpscqueue.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+struct TestNode {
+  TestNode(int producer, int seq)
+      : producer(producer), seq(seq), mpsc_next(nullptr) {}
+  int producer;
+  int seq;
+  TestNode* mpsc_next;
+};
+
+// Pushes |count| nodes tagged with |id| onto a queue from its own thread.
+class Producer {
+ public:
+  Producer(MpscQueue<TestNode>* queue, int id, int count)
+      : queue_(queue), id_(id), count_(count),
+        thread_(&ThreadFunc, this, "MpscProducer") {}
+
+  void Start() { thread_.Start(); }
+  void Stop() { thread_.Stop(); }
+
+ private:
+  static bool ThreadFunc(void* param) {
+    Producer* me = static_cast<Producer*>(param);
+    for (int i = 0; i < me->count_; ++i)
+      me->queue_->Push(new TestNode(me->id_, i));
+    return false;
+  }
+
+  MpscQueue<TestNode>* const queue_;
+  const int id_;
+  const int count_;
+  PlatformThread thread_;
+};
+
+// Takes everything off |queue| and returns the number of nodes consumed. If
+// |next_seq| is given, checks that nodes from each producer arrive in the
+// order they were pushed.
+int ConsumeAll(MpscQueue<TestNode>* queue, std::vector<int>* next_seq) {
+  int consumed = 0;
+  TestNode* node = queue->PopAll();
+  while (node) {
+    if (next_seq) {
+      EXPECT_EQ((*next_seq)[node->producer], node->seq);
+      (*next_seq)[node->producer] = node->seq + 1;
+    }
+    TestNode* next = node->mpsc_next;
+    delete node;
+    node = next;
+    ++consumed;
+  }
+  return consumed;
+}
+
+}  // namespace
+
+TEST(MpscQueueTest, PopAllOnEmptyQueue) {
+  MpscQueue<TestNode> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(nullptr, queue.PopAll());
+}
+
+TEST(MpscQueueTest, PopAllReturnsNodesInPushOrder) {
+  MpscQueue<TestNode> queue;
+  TestNode nodes[] = {TestNode(0, 0), TestNode(0, 1), TestNode(0, 2)};
+  for (TestNode& node : nodes)
+    queue.Push(&node);
+  EXPECT_FALSE(queue.empty());
+
+  TestNode* node = queue.PopAll();
+  EXPECT_TRUE(queue.empty());
+  for (TestNode& expected : nodes) {
+    ASSERT_EQ(&expected, node);
+    node = node->mpsc_next;
+  }
+  EXPECT_EQ(nullptr, node);
+}
+
+TEST(MpscQueueTest, PushAfterPopAll) {
+  MpscQueue<TestNode> queue;
+  TestNode first(0, 0);
+  TestNode second(0, 1);
+  queue.Push(&first);
+  EXPECT_EQ(&first, queue.PopAll());
+  queue.Push(&second);
+  TestNode* node = queue.PopAll();
+  EXPECT_EQ(&second, node);
+  EXPECT_EQ(nullptr, node->mpsc_next);
+}
+
+TEST(MpscQueueTest, ConcurrentProducers) {
+  static const int kProducers = 4;
+  static const int kNodesPerProducer = 10000;
+  MpscQueue<TestNode> queue;
+  std::vector<std::unique_ptr<Producer>> producers;
+  for (int i = 0; i < kProducers; ++i)
+    producers.emplace_back(new Producer(&queue, i, kNodesPerProducer));
+  for (auto& producer : producers)
+    producer->Start();
+
+  std::vector<int> next_seq(kProducers, 0);
+  int consumed = 0;
+  while (consumed < kProducers * kNodesPerProducer)
+    consumed += ConsumeAll(&queue, &next_seq);
+
+  for (auto& producer : producers)
+    producer->Stop();
+  EXPECT_TRUE(queue.empty());
+  for (int seq : next_seq)
+    EXPECT_EQ(kNodesPerProducer, seq);
+}
+
+namespace {
+
+// The queue MpscQueue replaces in MessageQueue, for comparison.
+class LockedListQueue {
+ public:
+  void Push(const TestNode& node) {
+    CritScope cs(&crit_);
+    list_.push_back(node);
+  }
+  size_t PopAll() {
+    std::list<TestNode> taken;
+    {
+      CritScope cs(&crit_);
+      taken.swap(list_);
+    }
+    return taken.size();
+  }
+
+ private:
+  CriticalSection crit_;
+  std::list<TestNode> list_;
+};
+
+class LockedProducer {
+ public:
+  LockedProducer(LockedListQueue* queue, int count)
+      : queue_(queue), count_(count),
+        thread_(&ThreadFunc, this, "LockedProducer") {}
+
+  void Start() { thread_.Start(); }
+  void Stop() { thread_.Stop(); }
+
+ private:
+  static bool ThreadFunc(void* param) {
+    LockedProducer* me = static_cast<LockedProducer*>(param);
+    for (int i = 0; i < me->count_; ++i)
+      me->queue_->Push(TestNode(0, i));
+    return false;
+  }
+
+  LockedListQueue* const queue_;
+  const int count_;
+  PlatformThread thread_;
+};
+
+}  // namespace
+
+// Compares the push/pop throughput of MpscQueue with a CriticalSection
+// guarded std::list, as MessageQueue used before, with 8 producers and one
+// consumer. The difference only shows up with several cores; the producers
+// never wait for each other or for the consumer with MpscQueue.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(MpscQueueTest, DISABLED_Performance) {
+  static const int kProducers = 8;
+  static const int kNodesPerProducer = 1000000;
+  static const int kTotal = kProducers * kNodesPerProducer;
+
+  {
+    MpscQueue<TestNode> queue;
+    std::vector<std::unique_ptr<Producer>> producers;
+    for (int i = 0; i < kProducers; ++i)
+      producers.emplace_back(new Producer(&queue, i, kNodesPerProducer));
+    int64_t start = TimeMillis();
+    for (auto& producer : producers)
+      producer->Start();
+    int consumed = 0;
+    while (consumed < kTotal)
+      consumed += ConsumeAll(&queue, nullptr);
+    LOG(LS_INFO) << "MpscQueue: " << kTotal << " nodes in "
+                 << TimeSince(start) << " ms";
+    for (auto& producer : producers)
+      producer->Stop();
+  }
+
+  {
+    LockedListQueue queue;
+    std::vector<std::unique_ptr<LockedProducer>> producers;
+    for (int i = 0; i < kProducers; ++i)
+      producers.emplace_back(new LockedProducer(&queue, kNodesPerProducer));
+    int64_t start = TimeMillis();
+    for (auto& producer : producers)
+      producer->Start();
+    size_t consumed = 0;
+    while (consumed < static_cast<size_t>(kTotal))
+      consumed += queue.PopAll();
+    LOG(LS_INFO) << "Locked std::list: " << kTotal << " nodes in "
+                 << TimeSince(start) << " ms";
+    for (auto& producer : producers)
+      producer->Stop();
+  }
+}
+
+}  // namespace rtc
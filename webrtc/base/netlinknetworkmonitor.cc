@@ -0,0 +1,138 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/netlinknetworkmonitor.h"
+
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+
+namespace rtc {
+
+namespace {
+// How long a read may block before the thread checks whether it has been
+// asked to stop.
+const int kPollTimeoutMs = 100;
+const size_t kReadBufferSize = 8192;
+}  // namespace
+
+NetlinkNetworkMonitor::NetlinkNetworkMonitor()
+    : fd_(-1), read_thread_(&ReadThread, this, "NetlinkMonitor") {}
+
+NetlinkNetworkMonitor::~NetlinkNetworkMonitor() {
+  Stop();
+}
+
+void NetlinkNetworkMonitor::Start() {
+  RTC_DCHECK(worker_thread() == Thread::Current());
+  if (fd_ >= 0)
+    return;
+
+  fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd_ < 0) {
+    LOG_ERR(LS_ERROR) << "Failed to create netlink socket";
+    return;
+  }
+  sockaddr_nl addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+  if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    LOG_ERR(LS_ERROR) << "Failed to bind netlink socket";
+    close(fd_);
+    fd_ = -1;
+    return;
+  }
+  read_thread_.Start();
+  LOG(LS_INFO) << "Started netlink network monitor";
+}
+
+void NetlinkNetworkMonitor::Stop() {
+  RTC_DCHECK(worker_thread() == Thread::Current());
+  if (fd_ < 0)
+    return;
+
+  read_thread_.Stop();
+  close(fd_);
+  fd_ = -1;
+}
+
+AdapterType NetlinkNetworkMonitor::GetAdapterType(
+    const std::string& interface_name) {
+  // Netlink doesn't tell what kind of link an interface is; leave it to the
+  // name based rules in BasicNetworkManager.
+  return ADAPTER_TYPE_UNKNOWN;
+}
+
+bool NetlinkNetworkMonitor::IsNetworkChangeMessage(const void* data,
+                                                   size_t length) {
+  int remaining = static_cast<int>(length);
+  for (const nlmsghdr* header = static_cast<const nlmsghdr*>(data);
+       NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+    switch (header->nlmsg_type) {
+      case RTM_NEWLINK:
+      case RTM_DELLINK:
+      case RTM_NEWADDR:
+      case RTM_DELADDR:
+        return true;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+bool NetlinkNetworkMonitor::ReadThread(void* obj) {
+  return static_cast<NetlinkNetworkMonitor*>(obj)->ReadMessages();
+}
+
+bool NetlinkNetworkMonitor::ReadMessages() {
+  pollfd fds;
+  fds.fd = fd_;
+  fds.events = POLLIN;
+  fds.revents = 0;
+  int result = poll(&fds, 1, kPollTimeoutMs);
+  if (result < 0 && errno != EINTR) {
+    LOG_ERR(LS_ERROR) << "Failed to poll netlink socket";
+    return false;
+  }
+  if (result <= 0)
+    return true;
+
+  // Several messages usually arrive for one change, e.g. a link coming up
+  // followed by its addresses, so only notify once per batch that was read.
+  alignas(nlmsghdr) char buffer[kReadBufferSize];
+  bool changed = false;
+  ssize_t length;
+  while ((length = recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+    changed |= IsNetworkChangeMessage(buffer, length);
+  }
+  if (length < 0 && errno == ENOBUFS) {
+    // The kernel dropped messages because we didn't keep up; something may
+    // have changed.
+    changed = true;
+  }
+  if (changed)
+    OnNetworksChanged();
+  return true;
+}
+
+NetworkMonitorInterface* NetlinkNetworkMonitorFactory::CreateNetworkMonitor() {
+  return new NetlinkNetworkMonitor();
+}
+
+}  // namespace rtc
@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_NETLINKNETWORKMONITOR_H_
+#define WEBRTC_BASE_NETLINKNETWORKMONITOR_H_
+
+#include <string>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/networkmonitor.h"
+#include "webrtc/base/platform_thread.h"
+
+namespace rtc {
+
+// Network monitor for Linux that listens on a NETLINK_ROUTE socket for link
+// and address changes, so that BasicNetworkManager learns about them as they
+// happen instead of on its next periodic getifaddrs() scan.
+//
+// The socket is read on a dedicated thread; OnNetworksChanged() forwards the
+// notification to the worker thread the monitor was created on. Start() and
+// Stop() must be called on that thread.
+class NetlinkNetworkMonitor : public NetworkMonitorBase {
+ public:
+  NetlinkNetworkMonitor();
+  ~NetlinkNetworkMonitor() override;
+
+  void Start() override;
+  void Stop() override;
+
+  AdapterType GetAdapterType(const std::string& interface_name) override;
+
+  // Returns true if the netlink messages in |data| include a link or address
+  // being added or removed.
+  static bool IsNetworkChangeMessage(const void* data, size_t length);
+
+ private:
+  static bool ReadThread(void* obj);
+  bool ReadMessages();
+
+  int fd_;
+  PlatformThread read_thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetlinkNetworkMonitor);
+};
+
+class NetlinkNetworkMonitorFactory : public NetworkMonitorFactory {
+ public:
+  NetlinkNetworkMonitorFactory() {}
+  ~NetlinkNetworkMonitorFactory() override {}
+
+  NetworkMonitorInterface* CreateNetworkMonitor() override;
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_NETLINKNETWORKMONITOR_H_
@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <string.h>
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/netlinknetworkmonitor.h"
+
+namespace rtc {
+
+namespace {
+
+// Appends a netlink message of |type| with an empty payload to |buffer|.
+size_t AppendMessage(uint16_t type, size_t offset, char* buffer) {
+  nlmsghdr* header = reinterpret_cast<nlmsghdr*>(buffer + offset);
+  memset(header, 0, NLMSG_SPACE(0));
+  header->nlmsg_len = NLMSG_LENGTH(0);
+  header->nlmsg_type = type;
+  return offset + NLMSG_SPACE(0);
+}
+
+}  // namespace
+
+TEST(NetlinkNetworkMonitorTest, DetectsLinkAndAddressChanges) {
+  const uint16_t kChanges[] = {RTM_NEWLINK, RTM_DELLINK, RTM_NEWADDR,
+                               RTM_DELADDR};
+  for (uint16_t type : kChanges) {
+    alignas(nlmsghdr) char buffer[64];
+    size_t length = AppendMessage(type, 0, buffer);
+    EXPECT_TRUE(NetlinkNetworkMonitor::IsNetworkChangeMessage(buffer, length));
+  }
+}
+
+TEST(NetlinkNetworkMonitorTest, IgnoresOtherMessages) {
+  alignas(nlmsghdr) char buffer[64];
+  size_t length = AppendMessage(RTM_NEWROUTE, 0, buffer);
+  length = AppendMessage(NLMSG_NOOP, length, buffer);
+  EXPECT_FALSE(NetlinkNetworkMonitor::IsNetworkChangeMessage(buffer, length));
+
+  // A change further into the batch is still found.
+  length = AppendMessage(RTM_NEWADDR, length, buffer);
+  EXPECT_TRUE(NetlinkNetworkMonitor::IsNetworkChangeMessage(buffer, length));
+
+  // A truncated message is not parsed.
+  EXPECT_FALSE(NetlinkNetworkMonitor::IsNetworkChangeMessage(
+      buffer, NLMSG_LENGTH(0) - 1));
+}
+
+TEST(NetlinkNetworkMonitorTest, StartAndStop) {
+  NetlinkNetworkMonitor monitor;
+  monitor.Start();
+  monitor.Start();
+  monitor.Stop();
+  monitor.Stop();
+}
+
+}  // namespace rtc
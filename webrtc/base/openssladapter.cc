@@ -934,8 +934,29 @@ bool OpenSSLAdapter::ConfigureTrustedRootCertificates(SSL_CTX* ctx) {
 
 SSL_CTX*
 OpenSSLAdapter::SetupSSLContext() {
+  // Negotiate up to (D)TLS 1.2, which is needed for the AES-GCM cipher
+  // suites that are cheapest per record. See OpenSSLStreamAdapter for the
+  // same choice of methods.
+#ifdef OPENSSL_IS_BORINGSSL
   SSL_CTX* ctx = SSL_CTX_new(ssl_mode_ == SSL_MODE_DTLS ?
-      DTLSv1_client_method() : TLSv1_client_method());
+      DTLS_method() : TLS_method());
+#else
+  const SSL_METHOD* method;
+  if (ssl_mode_ == SSL_MODE_DTLS) {
+#if (OPENSSL_VERSION_NUMBER >= 0x10002000L)
+    method = DTLS_client_method();
+#else
+    method = DTLSv1_client_method();
+#endif
+  } else {
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+    method = TLS_client_method();
+#else
+    method = SSLv23_client_method();
+#endif
+  }
+  SSL_CTX* ctx = SSL_CTX_new(method);
+#endif  // OPENSSL_IS_BORINGSSL
   if (ctx == NULL) {
     unsigned long error = ERR_get_error();  // NOLINT: type used by OpenSSL.
     LOG(LS_WARNING) << "SSL_CTX creation failed: "
@@ -954,7 +975,17 @@ OpenSSLAdapter::SetupSSLContext() {
 
   SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, SSLVerifyCallback);
   SSL_CTX_set_verify_depth(ctx, 4);
-  SSL_CTX_set_cipher_list(ctx, "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+#ifdef OPENSSL_IS_BORINGSSL
+  SSL_CTX_set_min_version(ctx, ssl_mode_ == SSL_MODE_DTLS ?
+      DTLS1_VERSION : TLS1_VERSION);
+#else
+  // SSLv2 and SSLv3 are only excluded by default in newer OpenSSL versions.
+  SSL_CTX_set_options(ctx, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+#endif
+  // Use the same cipher suites as OpenSSLStreamAdapter, which put the
+  // ECDHE AES-GCM suites first.
+  SSL_CTX_set_cipher_list(ctx,
+      "DEFAULT:!NULL:!aNULL:!SHA256:!SHA384:!aECDH:!AESGCM+AES256:!aPSK");
 
   if (ssl_mode_ == SSL_MODE_DTLS) {
     SSL_CTX_set_read_ahead(ctx, 1);
@@ -22,10 +22,13 @@
 #include <openssl/dtls1.h>
 #endif
 
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "webrtc/base/common.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/safe_conversions.h"
 #include "webrtc/base/stream.h"
@@ -61,6 +64,81 @@ static SrtpCipherMapEntry SrtpCipherMap[] = {
     {nullptr, 0}};
 #endif
 
+// Process-wide state for DTLS session resumption. Clients keep the session
+// of their last connection to each peer here. Servers resume sessions from
+// the tickets presented by clients, which are encrypted with keys shared by
+// every SSL_CTX in the process, so no server-side state is needed.
+class DtlsSessionCache {
+ public:
+  // Bound on the number of cached client sessions.
+  static const size_t kMaxSessions = 1024;
+
+  static DtlsSessionCache* Instance() {
+    RTC_DEFINE_STATIC_LOCAL(DtlsSessionCache, cache, ());
+    return &cache;
+  }
+
+  DtlsSessionCache() {
+    RTC_CHECK(RAND_bytes(ticket_keys_, sizeof(ticket_keys_)));
+  }
+
+  // Returns a new reference to the session cached under |key|, or NULL.
+  SSL_SESSION* Get(const std::string& key) {
+    CritScope cs(&crit_);
+    auto it = sessions_.find(key);
+    if (it == sessions_.end())
+      return NULL;
+    SSL_SESSION_up_ref(it->second);
+    return it->second;
+  }
+
+  // Takes ownership of |session|.
+  void Put(const std::string& key, SSL_SESSION* session) {
+    CritScope cs(&crit_);
+    auto it = sessions_.find(key);
+    if (it != sessions_.end()) {
+      SSL_SESSION_free(it->second);
+      it->second = session;
+      return;
+    }
+    if (sessions_.size() >= kMaxSessions) {
+      // Evicting an arbitrary entry is good enough; a miss only costs a full
+      // handshake.
+      SSL_SESSION_free(sessions_.begin()->second);
+      sessions_.erase(sessions_.begin());
+    }
+    sessions_[key] = session;
+  }
+
+  void Remove(const std::string& key) {
+    CritScope cs(&crit_);
+    auto it = sessions_.find(key);
+    if (it != sessions_.end()) {
+      SSL_SESSION_free(it->second);
+      sessions_.erase(it);
+    }
+  }
+
+  // Enables resumption on a new context.
+  void ConfigureContext(SSL_CTX* ctx) {
+    static const unsigned char kSessionIdContext[] = "webrtc-dtls";
+    SSL_CTX_set_session_id_context(ctx, kSessionIdContext,
+                                   sizeof(kSessionIdContext) - 1);
+    SSL_CTX_set_tlsext_ticket_keys(ctx, ticket_keys_, sizeof(ticket_keys_));
+    // Clients use the cache above and servers use tickets, so OpenSSL's
+    // per-context cache would only hold sessions that are never looked up.
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+  }
+
+ private:
+  CriticalSection crit_;
+  std::map<std::string, SSL_SESSION*> sessions_ GUARDED_BY(crit_);
+  // Key name, HMAC secret and AES key for session tickets.
+  unsigned char ticket_keys_[48];
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DtlsSessionCache);
+};
+
 #ifdef OPENSSL_IS_BORINGSSL
 static void TimeCallback(const SSL* ssl, struct timeval* out_clock) {
   uint64_t time = TimeNanos();
@@ -287,7 +365,9 @@ OpenSSLStreamAdapter::OpenSSLStreamAdapter(StreamInterface* stream)
       ssl_(NULL),
       ssl_ctx_(NULL),
       ssl_mode_(SSL_MODE_TLS),
-      ssl_max_version_(SSL_PROTOCOL_TLS_12) {}
+      ssl_max_version_(SSL_PROTOCOL_TLS_12),
+      session_resumption_enabled_(false),
+      offered_cached_session_(false) {}
 
 OpenSSLStreamAdapter::~OpenSSLStreamAdapter() {
   Cleanup();
@@ -387,6 +467,10 @@ int OpenSSLStreamAdapter::GetSslVersion() const {
   return -1;
 }
 
+bool OpenSSLStreamAdapter::IsSessionResumed() const {
+  return state_ == SSL_CONNECTED && SSL_session_reused(ssl_);
+}
+
 // Key Extractor interface
 bool OpenSSLStreamAdapter::ExportKeyingMaterial(const std::string& label,
                                                 const uint8_t* context,
@@ -495,6 +579,11 @@ void OpenSSLStreamAdapter::SetMaxProtocolVersion(SSLProtocolVersion version) {
   ssl_max_version_ = version;
 }
 
+void OpenSSLStreamAdapter::SetSessionResumptionEnabled(bool enabled) {
+  ASSERT(ssl_ctx_ == NULL);
+  session_resumption_enabled_ = enabled;
+}
+
 //
 // StreamInterface Implementation
 //
@@ -762,6 +851,20 @@ int OpenSSLStreamAdapter::BeginSSL() {
 
   SSL_set_app_data(ssl_, this);
 
+  offered_cached_session_ = false;
+  session_cache_key_.clear();
+  if (session_resumption_enabled_ && ssl_mode_ == SSL_MODE_DTLS) {
+    session_cache_key_ = SessionCacheKey();
+  }
+  if (role_ == SSL_CLIENT && !session_cache_key_.empty()) {
+    SSL_SESSION* session =
+        DtlsSessionCache::Instance()->Get(session_cache_key_);
+    if (session) {
+      offered_cached_session_ = SSL_set_session(ssl_, session) == 1;
+      SSL_SESSION_free(session);
+    }
+  }
+
   SSL_set_bio(ssl_, bio, bio);  // the SSL object owns the bio now.
   if (ssl_mode_ == SSL_MODE_DTLS) {
 #ifdef OPENSSL_IS_BORINGSSL
@@ -816,6 +919,26 @@ int OpenSSLStreamAdapter::ContinueSSL() {
         return -1;
       }
 
+      if (SSL_session_reused(ssl_)) {
+        // The peer certificate isn't sent, and SSLVerifyCallback isn't run,
+        // when resuming; check the one recorded in the session instead.
+        X509* cert = SSL_get_peer_certificate(ssl_);
+        bool verified = cert && VerifyPeerCertificate(cert);
+        X509_free(cert);
+        if (!verified) {
+          LOG(LS_ERROR) << "Resumed session has an unexpected peer certificate";
+          if (role_ == SSL_CLIENT)
+            DtlsSessionCache::Instance()->Remove(session_cache_key_);
+          return -1;
+        }
+        LOG(LS_INFO) << "Resumed DTLS session";
+      }
+      if (role_ == SSL_CLIENT && !session_cache_key_.empty()) {
+        SSL_SESSION* session = SSL_get1_session(ssl_);
+        if (session)
+          DtlsSessionCache::Instance()->Put(session_cache_key_, session);
+      }
+
       state_ = SSL_CONNECTED;
       StreamAdapterInterface::OnEvent(stream(), SE_OPEN|SE_READ|SE_WRITE, 0);
       break;
@@ -839,6 +962,10 @@ int OpenSSLStreamAdapter::ContinueSSL() {
     case SSL_ERROR_ZERO_RETURN:
     default:
       LOG(LS_VERBOSE) << " -- error " << code;
+      if (offered_cached_session_) {
+        // Don't offer the same session again if it led to a failure.
+        DtlsSessionCache::Instance()->Remove(session_cache_key_);
+      }
       SSLHandshakeError ssl_handshake_err = SSLHandshakeError::UNKNOWN;
       int err_code = ERR_peek_last_error();
       if (err_code != 0 && ERR_GET_REASON(err_code) == SSL_R_NO_SHARED_CIPHER) {
@@ -1030,6 +1157,9 @@ SSL_CTX* OpenSSLStreamAdapter::SetupSSLContext() {
   }
 #endif
 
+  if (session_resumption_enabled_ && ssl_mode_ == SSL_MODE_DTLS)
+    DtlsSessionCache::Instance()->ConfigureContext(ctx);
+
   return ctx;
 }
 
@@ -1057,30 +1187,53 @@ int OpenSSLStreamAdapter::SSLVerifyCallback(int ok, X509_STORE_CTX* store) {
     return 1;
   }
 
+  // Ignore any verification error if the digest matches, since there is no
+  // value in checking the validity of a self-signed cert issued by untrusted
+  // sources.
+  return stream->VerifyPeerCertificate(cert) ? 1 : 0;
+}
+
+bool OpenSSLStreamAdapter::VerifyPeerCertificate(X509* cert) {
   unsigned char digest[EVP_MAX_MD_SIZE];
   size_t digest_length;
   if (!OpenSSLCertificate::ComputeDigest(
            cert,
-           stream->peer_certificate_digest_algorithm_,
+           peer_certificate_digest_algorithm_,
            digest, sizeof(digest),
            &digest_length)) {
     LOG(LS_WARNING) << "Failed to compute peer cert digest.";
-    return 0;
+    return false;
   }
 
   Buffer computed_digest(digest, digest_length);
-  if (computed_digest != stream->peer_certificate_digest_value_) {
+  if (computed_digest != peer_certificate_digest_value_) {
     LOG(LS_WARNING) << "Rejected peer certificate due to mismatched digest.";
-    return 0;
+    return false;
   }
-  // Ignore any verification error if the digest matches, since there is no
-  // value in checking the validity of a self-signed cert issued by untrusted
-  // sources.
   LOG(LS_INFO) << "Accepted peer certificate.";
 
   // Record the peer's certificate.
-  stream->peer_certificate_.reset(new OpenSSLCertificate(cert));
-  return 1;
+  peer_certificate_.reset(new OpenSSLCertificate(cert));
+  return true;
+}
+
+std::string OpenSSLStreamAdapter::SessionCacheKey() const {
+  // A session is only reused between the same pair of certificates, and
+  // only with the maximum protocol version it was negotiated under.
+  if (!identity_ || peer_certificate_digest_algorithm_.empty())
+    return std::string();
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  size_t digest_length;
+  if (!identity_->certificate().ComputeDigest(DIGEST_SHA_256, digest,
+                                              sizeof(digest), &digest_length)) {
+    return std::string();
+  }
+  std::string key(reinterpret_cast<const char*>(digest), digest_length);
+  key += peer_certificate_digest_algorithm_;
+  key.append(peer_certificate_digest_value_.data<char>(),
+             peer_certificate_digest_value_.size());
+  key += static_cast<char>(ssl_max_version_);
+  return key;
 }
 
 bool OpenSSLStreamAdapter::SSLPostConnectionCheck(SSL* ssl,
@@ -74,6 +74,7 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   int StartSSL() override;
   void SetMode(SSLMode mode) override;
   void SetMaxProtocolVersion(SSLProtocolVersion version) override;
+  void SetSessionResumptionEnabled(bool enabled) override;
 
   StreamResult Read(void* data,
                     size_t data_len,
@@ -92,6 +93,7 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   bool GetSslCipherSuite(int* cipher) override;
 
   int GetSslVersion() const override;
+  bool IsSessionResumed() const override;
 
   // Key Extractor interface
   bool ExportKeyingMaterial(const std::string& label,
@@ -168,6 +170,14 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   // passed.
   static int SSLVerifyCallback(int ok, X509_STORE_CTX* store);
 
+  // Checks |cert| against the expected peer certificate digest and, if it
+  // matches, records it as the peer certificate.
+  bool VerifyPeerCertificate(X509* cert);
+
+  // Key under which sessions with this peer are cached; empty if they can't
+  // be.
+  std::string SessionCacheKey() const;
+
   SSLState state_;
   SSLRole role_;
   int ssl_error_code_;  // valid when state_ == SSL_ERROR or SSL_CLOSED
@@ -196,6 +206,12 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
 
   // Max. allowed protocol version
   SSLProtocolVersion ssl_max_version_;
+
+  // Session resumption, see SetSessionResumptionEnabled().
+  bool session_resumption_enabled_;
+  std::string session_cache_key_;
+  // True if a cached session was offered in this handshake.
+  bool offered_cached_session_;
 };
 
 /////////////////////////////////////////////////////////////////////////////
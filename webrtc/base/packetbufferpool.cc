@@ -0,0 +1,115 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/packetbufferpool.h"
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/basictypes.h"
+#include "webrtc/base/checks.h"
+
+namespace rtc {
+
+// Backing storage for a pooled buffer. Instead of deleting itself when the
+// last reference is dropped, it hands itself back to the pool.
+class PacketBufferPool::Slab : public RefCountedObject<Buffer> {
+ public:
+  explicit Slab(PacketBufferPool* pool)
+      : RefCountedObject<Buffer>(0, kSlabSize), pool_(pool) {}
+  ~Slab() override {}
+
+  int Release() const override {
+    int count = AtomicOps::Decrement(&ref_count_);
+    if (!count) {
+      pool_->Recycle(const_cast<Slab*>(this));
+    }
+    return count;
+  }
+
+ private:
+  PacketBufferPool* const pool_;
+};
+
+const size_t PacketBufferPool::kSlabSize;
+const size_t PacketBufferPool::kMaxIdleSlabs;
+
+// static
+PacketBufferPool* PacketBufferPool::Instance() {
+  RTC_DEFINE_STATIC_LOCAL(PacketBufferPool, pool, ());
+  return &pool;
+}
+
+PacketBufferPool::PacketBufferPool() {
+  idle_slabs_.reserve(kMaxIdleSlabs);
+}
+
+PacketBufferPool::~PacketBufferPool() {
+  Trim();
+}
+
+CopyOnWriteBuffer PacketBufferPool::Allocate(size_t size) {
+  scoped_refptr<RefCountedObject<Buffer>> buffer;
+  if (size > kSlabSize) {
+    buffer = new RefCountedObject<Buffer>(size);
+    CritScope cs(&crit_);
+    ++stats_.allocations;
+    ++stats_.heap_allocations;
+    return CopyOnWriteBuffer(std::move(buffer));
+  }
+
+  Slab* slab = nullptr;
+  {
+    CritScope cs(&crit_);
+    ++stats_.allocations;
+    if (!idle_slabs_.empty()) {
+      slab = idle_slabs_.back();
+      idle_slabs_.pop_back();
+    } else {
+      ++stats_.heap_allocations;
+    }
+  }
+  if (!slab) {
+    slab = new Slab(this);
+  }
+  RTC_DCHECK_EQ(kSlabSize, slab->capacity());
+  slab->SetSize(size);
+  buffer = slab;
+  return CopyOnWriteBuffer(std::move(buffer));
+}
+
+PacketBufferPool::Stats PacketBufferPool::GetStats() const {
+  CritScope cs(&crit_);
+  Stats stats = stats_;
+  stats.idle = idle_slabs_.size();
+  return stats;
+}
+
+void PacketBufferPool::Trim() {
+  CritScope cs(&crit_);
+  for (Slab* slab : idle_slabs_) {
+    delete slab;
+  }
+  idle_slabs_.clear();
+}
+
+void PacketBufferPool::Recycle(Slab* slab) {
+  // The slab may have been reallocated to a larger size while in use.
+  if (slab->capacity() == kSlabSize) {
+    slab->Clear();
+    CritScope cs(&crit_);
+    if (idle_slabs_.size() < kMaxIdleSlabs) {
+      idle_slabs_.push_back(slab);
+      ++stats_.recycled;
+      return;
+    }
+  }
+  delete slab;
+}
+
+}  // namespace rtc
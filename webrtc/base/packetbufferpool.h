@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_PACKETBUFFERPOOL_H_
+#define WEBRTC_BASE_PACKETBUFFERPOOL_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/copyonwritebuffer.h"
+#include "webrtc/base/criticalsection.h"
+
+namespace rtc {
+
+// A free list of fixed-size slabs used as backing storage for
+// CopyOnWriteBuffers on the packet path. Buffers handed out by Allocate() look
+// like any other CopyOnWriteBuffer, except that when the last reference goes
+// away the slab is returned to the pool instead of being freed, so a steady
+// flow of packets does not hit the heap. Buffers may be released on any
+// thread.
+//
+// A slab that has been grown past kSlabSize (e.g. by AppendData) is freed
+// normally on release, as are slabs released while the pool is full. A pool
+// must outlive every buffer it has handed out; the one returned by Instance()
+// is never destroyed.
+class PacketBufferPool {
+ public:
+  // Large enough for any RTP or RTCP packet, see cricket::kMaxRtpPacketLen.
+  static const size_t kSlabSize = 2048;
+  // Upper bound on the number of idle slabs kept around.
+  static const size_t kMaxIdleSlabs = 1024;
+
+  struct Stats {
+    // Number of buffers handed out by Allocate().
+    uint64_t allocations = 0;
+    // Number of those that had to be allocated on the heap, either because
+    // no idle slab was available or because the size exceeded kSlabSize.
+    uint64_t heap_allocations = 0;
+    // Number of slabs returned to the free list on release.
+    uint64_t recycled = 0;
+    // Number of slabs currently idle in the free list.
+    size_t idle = 0;
+  };
+
+  // The process-wide pool.
+  static PacketBufferPool* Instance();
+
+  PacketBufferPool();
+  ~PacketBufferPool();
+
+  // Returns a buffer of |size| uninitialized bytes. If |size| fits in a
+  // slab, capacity() of the returned buffer is kSlabSize.
+  CopyOnWriteBuffer Allocate(size_t size);
+
+  // Returns a buffer holding a copy of |size| bytes at |data|.
+  template <typename T,
+            typename std::enable_if<
+                internal::BufferCompat<uint8_t, T>::value>::type* = nullptr>
+  CopyOnWriteBuffer Allocate(const T* data, size_t size) {
+    CopyOnWriteBuffer buffer = Allocate(size);
+    if (size > 0) {
+      std::memcpy(buffer.data(), data, size);
+    }
+    return buffer;
+  }
+
+  Stats GetStats() const;
+
+  // Frees all idle slabs.
+  void Trim();
+
+ private:
+  class Slab;
+
+  void Recycle(Slab* slab);
+
+  mutable rtc::CriticalSection crit_;
+  std::vector<Slab*> idle_slabs_ GUARDED_BY(crit_);
+  Stats stats_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PacketBufferPool);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_PACKETBUFFERPOOL_H_
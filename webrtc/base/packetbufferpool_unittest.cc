@@ -0,0 +1,133 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/packetbufferpool.h"
+
+namespace rtc {
+
+namespace {
+
+// clang-format off
+const uint8_t kTestData[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7,
+                             0x8, 0x9, 0xa, 0xb, 0xc, 0xd, 0xe, 0xf};
+// clang-format on
+
+}  // namespace
+
+TEST(PacketBufferPoolTest, TestAllocateCopiesData) {
+  PacketBufferPool pool;
+  CopyOnWriteBuffer buf = pool.Allocate(kTestData, sizeof(kTestData));
+  EXPECT_EQ(sizeof(kTestData), buf.size());
+  EXPECT_EQ(PacketBufferPool::kSlabSize, buf.capacity());
+  EXPECT_EQ(0, memcmp(buf.cdata(), kTestData, sizeof(kTestData)));
+}
+
+TEST(PacketBufferPoolTest, TestReleasedSlabIsReused) {
+  PacketBufferPool pool;
+  const uint8_t* data;
+  {
+    CopyOnWriteBuffer buf = pool.Allocate(kTestData, sizeof(kTestData));
+    data = buf.cdata();
+    EXPECT_EQ(0u, pool.GetStats().idle);
+  }
+  EXPECT_EQ(1u, pool.GetStats().idle);
+
+  CopyOnWriteBuffer buf = pool.Allocate(4);
+  EXPECT_EQ(data, buf.cdata());
+  EXPECT_EQ(4u, buf.size());
+
+  PacketBufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(1u, stats.heap_allocations);
+  EXPECT_EQ(1u, stats.recycled);
+  EXPECT_EQ(0u, stats.idle);
+}
+
+TEST(PacketBufferPoolTest, TestSlabReturnedWhenLastReferenceReleased) {
+  PacketBufferPool pool;
+  CopyOnWriteBuffer buf1 = pool.Allocate(kTestData, sizeof(kTestData));
+  {
+    CopyOnWriteBuffer buf2(buf1);
+    CopyOnWriteBuffer buf3 = buf1;
+  }
+  EXPECT_EQ(0u, pool.GetStats().idle);
+  buf1 = CopyOnWriteBuffer();
+  EXPECT_EQ(1u, pool.GetStats().idle);
+}
+
+TEST(PacketBufferPoolTest, TestCopyOnWriteDoesNotAffectPooledSlab) {
+  PacketBufferPool pool;
+  CopyOnWriteBuffer buf1 = pool.Allocate(kTestData, sizeof(kTestData));
+  CopyOnWriteBuffer buf2(buf1);
+  // Writing to a shared pooled buffer clones it onto the heap.
+  buf2.data()[0] = 0xff;
+  EXPECT_NE(buf1.cdata(), buf2.cdata());
+  EXPECT_EQ(kTestData[0], buf1[0]);
+  buf2 = CopyOnWriteBuffer();
+  EXPECT_EQ(0u, pool.GetStats().idle);
+  buf1 = CopyOnWriteBuffer();
+  EXPECT_EQ(1u, pool.GetStats().idle);
+}
+
+TEST(PacketBufferPoolTest, TestOversizedAllocationUsesHeap) {
+  PacketBufferPool pool;
+  {
+    CopyOnWriteBuffer buf = pool.Allocate(PacketBufferPool::kSlabSize + 1);
+    EXPECT_EQ(PacketBufferPool::kSlabSize + 1, buf.size());
+  }
+  PacketBufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(1u, stats.heap_allocations);
+  EXPECT_EQ(0u, stats.recycled);
+  EXPECT_EQ(0u, stats.idle);
+}
+
+TEST(PacketBufferPoolTest, TestGrownSlabIsNotRecycled) {
+  PacketBufferPool pool;
+  {
+    CopyOnWriteBuffer buf = pool.Allocate(PacketBufferPool::kSlabSize);
+    buf.AppendData(kTestData);
+    EXPECT_LT(PacketBufferPool::kSlabSize, buf.capacity());
+  }
+  EXPECT_EQ(0u, pool.GetStats().idle);
+  EXPECT_EQ(0u, pool.GetStats().recycled);
+}
+
+TEST(PacketBufferPoolTest, TestSteadyStateDoesNotAllocate) {
+  PacketBufferPool pool;
+  std::vector<CopyOnWriteBuffer> in_flight;
+  for (int i = 0; i < 10; ++i) {
+    in_flight.push_back(pool.Allocate(kTestData, sizeof(kTestData)));
+  }
+  in_flight.clear();
+  const uint64_t heap_allocations = pool.GetStats().heap_allocations;
+  EXPECT_EQ(10u, heap_allocations);
+
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 10; ++i) {
+      in_flight.push_back(pool.Allocate(kTestData, sizeof(kTestData)));
+    }
+    in_flight.clear();
+  }
+  EXPECT_EQ(heap_allocations, pool.GetStats().heap_allocations);
+  EXPECT_EQ(10u, pool.GetStats().idle);
+}
+
+TEST(PacketBufferPoolTest, TestTrimFreesIdleSlabs) {
+  PacketBufferPool pool;
+  pool.Allocate(kTestData, sizeof(kTestData));
+  EXPECT_EQ(1u, pool.GetStats().idle);
+  pool.Trim();
+  EXPECT_EQ(0u, pool.GetStats().idle);
+}
+
+}  // namespace rtc
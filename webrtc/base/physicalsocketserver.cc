@@ -28,6 +28,28 @@
 #include <signal.h>
 #endif
 
+#if defined(WEBRTC_USE_EPOLL)
+#include <poll.h>
+#endif
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// recvmmsg() and sendmmsg() are available since Linux 2.6.33 and 3.0.
+#define WEBRTC_USE_MMSG 1
+
+// UDP segmentation offload (Linux 4.18) and receive offload (Linux 5.0) are
+// probed for at runtime, see PhysicalSocket::SetUdpOffloadOption.
+#include <netinet/udp.h>
+#if !defined(SOL_UDP)
+#define SOL_UDP 17
+#endif
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+#endif
+
 #if defined(WEBRTC_WIN)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -121,8 +143,23 @@ static const int ICMP_HEADER_SIZE = 8u;
 static const int ICMP_PING_TIMEOUT_MILLIS = 10000u;
 #endif
 
+#if defined(WEBRTC_USE_MMSG)
+// Maximum number of datagrams passed to a single sendmmsg() or recvmmsg()
+// call. Larger batches are split.
+static const size_t kMaxMmsgBatchSize = 64;
+#endif
+
+#if defined(WEBRTC_USE_EPOLL)
+// Initial number of events to process with one call to "epoll_wait".
+static const size_t kInitialEpollEvents = 128;
+
+// Maximum number of events to process with one call to "epoll_wait".
+static const size_t kMaxEpollEvents = 8192;
+#endif
+
 PhysicalSocket::PhysicalSocket(PhysicalSocketServer* ss, SOCKET s)
-  : ss_(ss), s_(s), enabled_events_(0), error_(0),
+  : ss_(ss), s_(s), enabled_events_(0), udp_(false), gso_enabled_(false),
+    gro_enabled_(false), error_(0),
     state_((s == INVALID_SOCKET) ? CS_CLOSED : CS_CONNECTED),
     resolver_(nullptr) {
 #if defined(WEBRTC_WIN)
@@ -153,7 +190,7 @@ bool PhysicalSocket::Create(int family, int type) {
   udp_ = (SOCK_DGRAM == type);
   UpdateLastError();
   if (udp_)
-    enabled_events_ = DE_READ | DE_WRITE;
+    SetEnabledEvents(DE_READ | DE_WRITE);
   return s_ != INVALID_SOCKET;
 }
 
@@ -243,12 +280,12 @@ int PhysicalSocket::DoConnect(const SocketAddress& connect_addr) {
     state_ = CS_CONNECTED;
   } else if (IsBlockingError(GetError())) {
     state_ = CS_CONNECTING;
-    enabled_events_ |= DE_CONNECT;
+    EnableEvents(DE_CONNECT);
   } else {
     return SOCKET_ERROR;
   }
 
-  enabled_events_ |= DE_READ | DE_WRITE;
+  EnableEvents(DE_READ | DE_WRITE);
   return 0;
 }
 
@@ -267,6 +304,8 @@ AsyncSocket::ConnState PhysicalSocket::GetState() const {
 }
 
 int PhysicalSocket::GetOption(Option opt, int* value) {
+  if (opt == OPT_UDP_GSO || opt == OPT_UDP_GRO)
+    return GetUdpOffloadOption(opt, value);
   int slevel;
   int sopt;
   if (TranslateOption(opt, &slevel, &sopt) == -1)
@@ -282,6 +321,8 @@ int PhysicalSocket::GetOption(Option opt, int* value) {
 }
 
 int PhysicalSocket::SetOption(Option opt, int value) {
+  if (opt == OPT_UDP_GSO || opt == OPT_UDP_GRO)
+    return SetUdpOffloadOption(opt, value);
   int slevel;
   int sopt;
   if (TranslateOption(opt, &slevel, &sopt) == -1)
@@ -294,6 +335,46 @@ int PhysicalSocket::SetOption(Option opt, int value) {
   return ::setsockopt(s_, slevel, sopt, (SockOptArg)&value, sizeof(value));
 }
 
+int PhysicalSocket::GetUdpOffloadOption(Option opt, int* value) {
+  *value = (opt == OPT_UDP_GSO) ? gso_enabled_ : gro_enabled_;
+  return 0;
+}
+
+int PhysicalSocket::SetUdpOffloadOption(Option opt, int value) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!udp_) {
+    SetError(ENOPROTOOPT);
+    return -1;
+  }
+  if (opt == OPT_UDP_GSO) {
+    if (value) {
+      // The segment size is passed with each sendmsg(); reading the socket
+      // option only checks that the kernel knows about it.
+      int segment_size = 0;
+      socklen_t len = sizeof(segment_size);
+      if (::getsockopt(s_, SOL_UDP, UDP_SEGMENT, &segment_size, &len) != 0) {
+        UpdateLastError();
+        LOG(LS_INFO) << "UDP segmentation offload not supported.";
+        return -1;
+      }
+    }
+    gso_enabled_ = (value != 0);
+    return 0;
+  }
+  int enable = value ? 1 : 0;
+  if (::setsockopt(s_, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) != 0) {
+    UpdateLastError();
+    LOG(LS_INFO) << "UDP receive offload not supported.";
+    return -1;
+  }
+  gro_enabled_ = (enable != 0);
+  return 0;
+#else
+  SetError(ENOPROTOOPT);
+  return -1;
+#endif
+}
+
 int PhysicalSocket::Send(const void* pv, size_t cb) {
   int sent = DoSend(s_, reinterpret_cast<const char *>(pv),
       static_cast<int>(cb),
@@ -314,7 +395,7 @@ int PhysicalSocket::Send(const void* pv, size_t cb) {
   ASSERT(sent <= static_cast<int>(cb));
   if ((sent > 0 && sent < static_cast<int>(cb)) ||
       (sent < 0 && IsBlockingError(GetError()))) {
-    enabled_events_ |= DE_WRITE;
+    EnableEvents(DE_WRITE);
   }
   return sent;
 }
@@ -339,7 +420,7 @@ int PhysicalSocket::SendTo(const void* buffer,
   ASSERT(sent <= static_cast<int>(length));
   if ((sent > 0 && sent < static_cast<int>(length)) ||
       (sent < 0 && IsBlockingError(GetError()))) {
-    enabled_events_ |= DE_WRITE;
+    EnableEvents(DE_WRITE);
   }
   return sent;
 }
@@ -354,7 +435,7 @@ int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
     LOG(LS_WARNING) << "EOF from socket; deferring close event";
     // Must turn this back on so that the select() loop will notice the close
     // event.
-    enabled_events_ |= DE_READ;
+    EnableEvents(DE_READ);
     SetError(EWOULDBLOCK);
     return SOCKET_ERROR;
   }
@@ -365,7 +446,7 @@ int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
   if (udp_ || success) {
-    enabled_events_ |= DE_READ;
+    EnableEvents(DE_READ);
   }
   if (!success) {
     LOG_F(LS_VERBOSE) << "Error = " << error;
@@ -391,12 +472,153 @@ int PhysicalSocket::RecvFrom(void* buffer,
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
   if (udp_ || success) {
-    enabled_events_ |= DE_READ;
+    EnableEvents(DE_READ);
+  }
+  if (!success) {
+    LOG_F(LS_VERBOSE) << "Error = " << error;
+  }
+  return received;
+}
+
+int PhysicalSocket::SendToBatch(const SendDatagram* datagrams,
+                                size_t count) {
+#if defined(WEBRTC_USE_MMSG)
+  if (!gso_enabled_) {
+    for (size_t i = 0; i < count; ++i) {
+      if (datagrams[i].segment_size != 0) {
+        // Segmented datagrams have to be split in user space.
+        return AsyncSocket::SendToBatch(datagrams, count);
+      }
+    }
+  }
+
+  size_t sent = 0;
+  while (sent < count) {
+    size_t batch_size = std::min(count - sent, kMaxMmsgBatchSize);
+    sockaddr_storage addrs[kMaxMmsgBatchSize];
+    struct iovec iovs[kMaxMmsgBatchSize];
+    struct mmsghdr msgs[kMaxMmsgBatchSize];
+    char control[kMaxMmsgBatchSize][CMSG_SPACE(sizeof(uint16_t))];
+    bool segmented = false;
+    memset(msgs, 0, sizeof(msgs[0]) * batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+      const SendDatagram& datagram = datagrams[sent + i];
+      iovs[i].iov_base = const_cast<void*>(datagram.data);
+      iovs[i].iov_len = datagram.size;
+      msgs[i].msg_hdr.msg_name = &addrs[i];
+      msgs[i].msg_hdr.msg_namelen =
+          static_cast<socklen_t>(datagram.addr.ToSockAddrStorage(&addrs[i]));
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      if (datagram.segment_size != 0 && datagram.segment_size < datagram.size) {
+        msgs[i].msg_hdr.msg_control = control[i];
+        msgs[i].msg_hdr.msg_controllen = sizeof(control[i]);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t segment_size = static_cast<uint16_t>(datagram.segment_size);
+        memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+        segmented = true;
+      }
+    }
+    // Suppress SIGPIPE. See Send() for explanation.
+    int ret = ::sendmmsg(s_, msgs, static_cast<unsigned int>(batch_size),
+                         MSG_NOSIGNAL);
+    UpdateLastError();
+    if (ret < 0) {
+      if (segmented && GetError() == EIO) {
+        // The egress device can't checksum segmented datagrams; stop asking
+        // for offload and send the remaining datagrams one by one.
+        LOG(LS_WARNING) << "UDP segmentation offload failed, disabling it.";
+        gso_enabled_ = false;
+        int rest = AsyncSocket::SendToBatch(datagrams + sent, count - sent);
+        if (rest < 0)
+          return sent == 0 ? rest : static_cast<int>(sent);
+        return static_cast<int>(sent + rest);
+      }
+      if (IsBlockingError(GetError()))
+        EnableEvents(DE_WRITE);
+      return sent == 0 ? ret : static_cast<int>(sent);
+    }
+    sent += ret;
+    if (static_cast<size_t>(ret) < batch_size) {
+      // sendmmsg stops at the first datagram that could not be sent, which
+      // typically means the send buffer is full.
+      EnableEvents(DE_WRITE);
+      break;
+    }
+  }
+  return static_cast<int>(sent);
+#else
+  return AsyncSocket::SendToBatch(datagrams, count);
+#endif
+}
+
+int PhysicalSocket::RecvFromBatch(RecvDatagram* datagrams, size_t count) {
+#if defined(WEBRTC_USE_MMSG)
+  size_t batch_size = std::min(count, kMaxMmsgBatchSize);
+  // Coalesced datagrams are only reported through the control messages.
+  if (batch_size == 0 || (batch_size == 1 && !gro_enabled_))
+    return AsyncSocket::RecvFromBatch(datagrams, batch_size);
+
+  sockaddr_storage addrs[kMaxMmsgBatchSize];
+  struct iovec iovs[kMaxMmsgBatchSize];
+  struct mmsghdr msgs[kMaxMmsgBatchSize];
+  char control[kMaxMmsgBatchSize][CMSG_SPACE(sizeof(int))];
+  memset(msgs, 0, sizeof(msgs[0]) * batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    iovs[i].iov_base = datagrams[i].buffer;
+    iovs[i].iov_len = datagrams[i].capacity;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    if (gro_enabled_) {
+      msgs[i].msg_hdr.msg_control = control[i];
+      msgs[i].msg_hdr.msg_controllen = sizeof(control[i]);
+    }
+  }
+  int received = ::recvmmsg(s_, msgs, static_cast<unsigned int>(batch_size),
+                            MSG_DONTWAIT, nullptr);
+  UpdateLastError();
+  if (received > 0) {
+    // The kernel only keeps the timestamp of the last datagram read; all
+    // datagrams of a batch were queued by the time of this wakeup, so that
+    // timestamp is reported for each of them.
+    int64_t timestamp = GetSocketRecvTimestamp(s_);
+    for (int i = 0; i < received; ++i) {
+      datagrams[i].size = msgs[i].msg_len;
+      datagrams[i].timestamp = timestamp;
+      datagrams[i].segment_size = 0;
+      SocketAddressFromSockAddrStorage(addrs[i], &datagrams[i].addr);
+      if (!gro_enabled_)
+        continue;
+      for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg;
+           cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+          int segment_size;
+          memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+          if (segment_size > 0 &&
+              static_cast<size_t>(segment_size) < datagrams[i].size) {
+            datagrams[i].segment_size = segment_size;
+          }
+        }
+      }
+    }
+  }
+  int error = GetError();
+  bool success = (received >= 0) || IsBlockingError(error);
+  if (udp_ || success) {
+    EnableEvents(DE_READ);
   }
   if (!success) {
     LOG_F(LS_VERBOSE) << "Error = " << error;
   }
   return received;
+#else
+  return AsyncSocket::RecvFromBatch(datagrams, count);
+#endif
 }
 
 int PhysicalSocket::Listen(int backlog) {
@@ -404,7 +626,7 @@ int PhysicalSocket::Listen(int backlog) {
   UpdateLastError();
   if (err == 0) {
     state_ = CS_CONNECTING;
-    enabled_events_ |= DE_ACCEPT;
+    EnableEvents(DE_ACCEPT);
 #if !defined(NDEBUG)
     dbg_addr_ = "Listening @ ";
     dbg_addr_.append(GetLocalAddress().ToString());
@@ -416,7 +638,7 @@ int PhysicalSocket::Listen(int backlog) {
 AsyncSocket* PhysicalSocket::Accept(SocketAddress* out_addr) {
   // Always re-subscribe DE_ACCEPT to make sure new incoming connections will
   // trigger an event even if DoAccept returns an error here.
-  enabled_events_ |= DE_ACCEPT;
+  EnableEvents(DE_ACCEPT);
   sockaddr_storage addr_storage;
   socklen_t addr_len = sizeof(addr_storage);
   sockaddr* addr = reinterpret_cast<sockaddr*>(&addr_storage);
@@ -436,7 +658,7 @@ int PhysicalSocket::Close() {
   UpdateLastError();
   s_ = INVALID_SOCKET;
   state_ = CS_CLOSED;
-  enabled_events_ = 0;
+  SetEnabledEvents(0);
   if (resolver_) {
     resolver_->Destroy(false);
     resolver_ = nullptr;
@@ -594,6 +816,18 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
       return -1;
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
+    case OPT_UDP_GSO:
+    case OPT_UDP_GRO:
+      return -1;  // Handled by Get/SetUdpOffloadOption.
+    case OPT_REUSEPORT:
+#if defined(SO_REUSEPORT)
+      *slevel = SOL_SOCKET;
+      *sopt = SO_REUSEPORT;
+      break;
+#else
+      LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+      return -1;
+#endif
     default:
       ASSERT(false);
       return -1;
@@ -601,6 +835,18 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
   return 0;
 }
 
+void PhysicalSocket::SetEnabledEvents(uint8_t events) {
+  enabled_events_ = events;
+}
+
+void PhysicalSocket::EnableEvents(uint8_t events) {
+  SetEnabledEvents(enabled_events_ | events);
+}
+
+void PhysicalSocket::DisableEvents(uint8_t events) {
+  SetEnabledEvents(enabled_events_ & ~events);
+}
+
 SocketDispatcher::SocketDispatcher(PhysicalSocketServer *ss)
 #if defined(WEBRTC_WIN)
   : PhysicalSocket(ss), id_(0), signal_close_(false)
@@ -727,6 +973,13 @@ uint32_t SocketDispatcher::GetRequestedEvents() {
   return enabled_events_;
 }
 
+void SocketDispatcher::SetEnabledEvents(uint8_t events) {
+  if (enabled_events_ == events)
+    return;
+  PhysicalSocket::SetEnabledEvents(events);
+  ss_->Update(this);
+}
+
 void SocketDispatcher::OnPreEvent(uint32_t ff) {
   if ((ff & DE_CONNECT) != 0)
     state_ = CS_CONNECTED;
@@ -748,7 +1001,7 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
   if (((ff & DE_CONNECT) != 0) && (id_ == cache_id)) {
     if (ff != DE_CONNECT)
       LOG(LS_VERBOSE) << "Signalled with DE_CONNECT: " << ff;
-    enabled_events_ &= ~DE_CONNECT;
+    DisableEvents(DE_CONNECT);
 #if !defined(NDEBUG)
     dbg_addr_ = "Connected @ ";
     dbg_addr_.append(GetRemoteAddress().ToString());
@@ -756,15 +1009,15 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
     SignalConnectEvent(this);
   }
   if (((ff & DE_ACCEPT) != 0) && (id_ == cache_id)) {
-    enabled_events_ &= ~DE_ACCEPT;
+    DisableEvents(DE_ACCEPT);
     SignalReadEvent(this);
   }
   if ((ff & DE_READ) != 0) {
-    enabled_events_ &= ~DE_READ;
+    DisableEvents(DE_READ);
     SignalReadEvent(this);
   }
   if (((ff & DE_WRITE) != 0) && (id_ == cache_id)) {
-    enabled_events_ &= ~DE_WRITE;
+    DisableEvents(DE_WRITE);
     SignalWriteEvent(this);
   }
   if (((ff & DE_CLOSE) != 0) && (id_ == cache_id)) {
@@ -779,24 +1032,24 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
   // Make sure we deliver connect/accept first. Otherwise, consumers may see
   // something like a READ followed by a CONNECT, which would be odd.
   if ((ff & DE_CONNECT) != 0) {
-    enabled_events_ &= ~DE_CONNECT;
+    DisableEvents(DE_CONNECT);
     SignalConnectEvent(this);
   }
   if ((ff & DE_ACCEPT) != 0) {
-    enabled_events_ &= ~DE_ACCEPT;
+    DisableEvents(DE_ACCEPT);
     SignalReadEvent(this);
   }
   if ((ff & DE_READ) != 0) {
-    enabled_events_ &= ~DE_READ;
+    DisableEvents(DE_READ);
     SignalReadEvent(this);
   }
   if ((ff & DE_WRITE) != 0) {
-    enabled_events_ &= ~DE_WRITE;
+    DisableEvents(DE_WRITE);
     SignalWriteEvent(this);
   }
   if ((ff & DE_CLOSE) != 0) {
     // The socket is now dead to us, so stop checking it.
-    enabled_events_ = 0;
+    SetEnabledEvents(0);
     SignalCloseEvent(this, err);
   }
 }
@@ -1053,7 +1306,8 @@ class PosixSignalDispatcher : public Dispatcher {
 
 class FileDispatcher: public Dispatcher, public AsyncFile {
  public:
-  FileDispatcher(int fd, PhysicalSocketServer *ss) : ss_(ss), fd_(fd) {
+  FileDispatcher(int fd, PhysicalSocketServer *ss)
+      : ss_(ss), fd_(fd), flags_(0) {
     set_readable(true);
 
     ss_->Add(this);
@@ -1087,16 +1341,23 @@ class FileDispatcher: public Dispatcher, public AsyncFile {
   bool readable() override { return (flags_ & DE_READ) != 0; }
 
   void set_readable(bool value) override {
-    flags_ = value ? (flags_ | DE_READ) : (flags_ & ~DE_READ);
+    SetFlags(value ? (flags_ | DE_READ) : (flags_ & ~DE_READ));
   }
 
   bool writable() override { return (flags_ & DE_WRITE) != 0; }
 
   void set_writable(bool value) override {
-    flags_ = value ? (flags_ | DE_WRITE) : (flags_ & ~DE_WRITE);
+    SetFlags(value ? (flags_ | DE_WRITE) : (flags_ & ~DE_WRITE));
   }
 
  private:
+  void SetFlags(int flags) {
+    if (flags_ == flags)
+      return;
+    flags_ = flags;
+    ss_->Update(this);
+  }
+
   PhysicalSocketServer* ss_;
   int fd_;
   int flags_;
@@ -1184,7 +1445,28 @@ class Signaler : public EventDispatcher {
 };
 
 PhysicalSocketServer::PhysicalSocketServer()
-    : fWait_(false) {
+    : PhysicalSocketServer(true) {
+}
+
+PhysicalSocketServer::PhysicalSocketServer(bool use_epoll)
+    :
+#if defined(WEBRTC_USE_EPOLL)
+      epoll_fd_(INVALID_SOCKET),
+      next_epoll_key_(0),
+#endif
+      fWait_(false) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (use_epoll) {
+    // Since Linux 2.6.8 the size argument is ignored, but must be positive.
+    epoll_fd_ = epoll_create(FD_SETSIZE);
+    if (epoll_fd_ == INVALID_SOCKET) {
+      // Not an error, will fall back to "select" below.
+      LOG_E(LS_WARNING, EN, errno) << "epoll_create";
+    } else {
+      fcntl(epoll_fd_, F_SETFD, FD_CLOEXEC);
+    }
+  }
+#endif
   signal_wakeup_ = new Signaler(this, &fWait_);
 #if defined(WEBRTC_WIN)
   socket_ev_ = WSACreateEvent();
@@ -1199,9 +1481,23 @@ PhysicalSocketServer::~PhysicalSocketServer() {
   signal_dispatcher_.reset();
 #endif
   delete signal_wakeup_;
+#if defined(WEBRTC_USE_EPOLL)
+  ASSERT(epoll_registrations_.empty());
+  if (epoll_fd_ != INVALID_SOCKET) {
+    close(epoll_fd_);
+  }
+#endif
   ASSERT(dispatchers_.empty());
 }
 
+bool PhysicalSocketServer::UsesEpoll() const {
+#if defined(WEBRTC_USE_EPOLL)
+  return epoll_fd_ != INVALID_SOCKET;
+#else
+  return false;
+#endif
+}
+
 void PhysicalSocketServer::WakeUp() {
   signal_wakeup_->Signal();
 }
@@ -1246,6 +1542,12 @@ AsyncSocket* PhysicalSocketServer::WrapSocket(SOCKET s) {
 
 void PhysicalSocketServer::Add(Dispatcher *pdispatcher) {
   CritScope cs(&crit_);
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    AddEpoll(pdispatcher);
+    return;
+  }
+#endif
   // Prevent duplicates. This can cause dead dispatchers to stick around.
   DispatcherList::iterator pos = std::find(dispatchers_.begin(),
                                            dispatchers_.end(),
@@ -1257,6 +1559,12 @@ void PhysicalSocketServer::Add(Dispatcher *pdispatcher) {
 
 void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
   CritScope cs(&crit_);
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    RemoveEpoll(pdispatcher);
+    return;
+  }
+#endif
   DispatcherList::iterator pos = std::find(dispatchers_.begin(),
                                            dispatchers_.end(),
                                            pdispatcher);
@@ -1278,8 +1586,86 @@ void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
   }
 }
 
+void PhysicalSocketServer::Update(Dispatcher* pdispatcher) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ == INVALID_SOCKET)
+    return;
+
+  CritScope cs(&crit_);
+  EpollRegistrations::iterator it = epoll_registrations_.find(pdispatcher);
+  if (it == epoll_registrations_.end()) {
+    // Dispatchers update their requested events before they have been added
+    // and while they are being closed; AddEpoll registers whatever they
+    // request at that point.
+    return;
+  }
+  UpdateEpoll(pdispatcher, &it->second);
+#endif
+}
+
 #if defined(WEBRTC_POSIX)
 bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET) {
+    // The epoll set contains all dispatchers, so when only the wakeup signal
+    // should be processed, "poll" is used on its descriptor instead. Unlike
+    // "select" this is not limited by FD_SETSIZE.
+    return process_io ? WaitEpoll(cmsWait) : WaitPoll(cmsWait, signal_wakeup_);
+  }
+#endif
+  return WaitSelect(cmsWait, process_io);
+}
+
+static void ProcessEvents(Dispatcher* dispatcher,
+                          bool readable,
+                          bool writable,
+                          bool check_error) {
+  int errcode = 0;
+  // TODO(pthatcher): Should we set errcode if getsockopt fails?
+  if (check_error) {
+    socklen_t len = sizeof(errcode);
+    ::getsockopt(dispatcher->GetDescriptor(), SOL_SOCKET, SO_ERROR, &errcode,
+                 &len);
+  }
+
+  uint32_t ff = 0;
+
+  // Check readable descriptors. If we're waiting on an accept, signal
+  // that. Otherwise we're waiting for data, check to see if we're
+  // readable or really closed.
+  // TODO(pthatcher): Only peek at TCP descriptors.
+  if (readable) {
+    if (dispatcher->GetRequestedEvents() & DE_ACCEPT) {
+      ff |= DE_ACCEPT;
+    } else if (errcode || dispatcher->IsDescriptorClosed()) {
+      ff |= DE_CLOSE;
+    } else {
+      ff |= DE_READ;
+    }
+  }
+
+  // Check writable descriptors. If we're waiting on a connect, detect
+  // success versus failure by the reaped error code.
+  if (writable) {
+    if (dispatcher->GetRequestedEvents() & DE_CONNECT) {
+      if (!errcode) {
+        ff |= DE_CONNECT;
+      } else {
+        ff |= DE_CLOSE;
+      }
+    } else {
+      ff |= DE_WRITE;
+    }
+  }
+
+  // Tell the descriptor about the event.
+  if (ff != 0) {
+    dispatcher->OnPreEvent(ff);
+    dispatcher->OnEvent(ff, errcode);
+  }
+}
+
+bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
   // Calculate timing information
 
   struct timeval *ptvWait = NULL;
@@ -1365,51 +1751,19 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
       for (size_t i = 0; i < dispatchers_.size(); ++i) {
         Dispatcher *pdispatcher = dispatchers_[i];
         int fd = pdispatcher->GetDescriptor();
-        uint32_t ff = 0;
-        int errcode = 0;
-
-        // Reap any error code, which can be signaled through reads or writes.
-        // TODO(pthatcher): Should we set errcode if getsockopt fails?
-        if (FD_ISSET(fd, &fdsRead) || FD_ISSET(fd, &fdsWrite)) {
-          socklen_t len = sizeof(errcode);
-          ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &errcode, &len);
-        }
 
-        // Check readable descriptors. If we're waiting on an accept, signal
-        // that. Otherwise we're waiting for data, check to see if we're
-        // readable or really closed.
-        // TODO(pthatcher): Only peek at TCP descriptors.
-        if (FD_ISSET(fd, &fdsRead)) {
+        bool readable = FD_ISSET(fd, &fdsRead);
+        if (readable) {
           FD_CLR(fd, &fdsRead);
-          if (pdispatcher->GetRequestedEvents() & DE_ACCEPT) {
-            ff |= DE_ACCEPT;
-          } else if (errcode || pdispatcher->IsDescriptorClosed()) {
-            ff |= DE_CLOSE;
-          } else {
-            ff |= DE_READ;
-          }
         }
 
-        // Check writable descriptors. If we're waiting on a connect, detect
-        // success versus failure by the reaped error code.
-        if (FD_ISSET(fd, &fdsWrite)) {
+        bool writable = FD_ISSET(fd, &fdsWrite);
+        if (writable) {
           FD_CLR(fd, &fdsWrite);
-          if (pdispatcher->GetRequestedEvents() & DE_CONNECT) {
-            if (!errcode) {
-              ff |= DE_CONNECT;
-            } else {
-              ff |= DE_CLOSE;
-            }
-          } else {
-            ff |= DE_WRITE;
-          }
         }
 
-        // Tell the descriptor about the event.
-        if (ff != 0) {
-          pdispatcher->OnPreEvent(ff);
-          pdispatcher->OnEvent(ff, errcode);
-        }
+        // Reap any error code, which can be signaled through reads or writes.
+        ProcessEvents(pdispatcher, readable, writable, readable || writable);
       }
     }
 
@@ -1437,6 +1791,246 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
   return true;
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+
+static uint32_t GetEpollEvents(uint32_t ff) {
+  uint32_t events = 0;
+  if (ff & (DE_READ | DE_ACCEPT)) {
+    events |= EPOLLIN;
+  }
+  if (ff & (DE_WRITE | DE_CONNECT)) {
+    events |= EPOLLOUT;
+  }
+  return events;
+}
+
+void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  // Prevent duplicates. This can cause dead dispatchers to stick around.
+  if (epoll_registrations_.find(pdispatcher) != epoll_registrations_.end())
+    return;
+
+  EpollRegistration registration = {++next_epoll_key_, 0};
+  epoll_dispatchers_[registration.key] = pdispatcher;
+  EpollRegistration* added =
+      &epoll_registrations_.insert(std::make_pair(pdispatcher, registration))
+           .first->second;
+  UpdateEpoll(pdispatcher, added);
+}
+
+void PhysicalSocketServer::RemoveEpoll(Dispatcher* pdispatcher) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  EpollRegistrations::iterator it = epoll_registrations_.find(pdispatcher);
+  // We silently ignore duplicate calls to Add, so we should silently ignore
+  // the (expected) symmetric calls to Remove. Note that this may still hide
+  // a real issue, so we at least log a warning about it.
+  if (it == epoll_registrations_.end()) {
+    LOG(LS_WARNING) << "PhysicalSocketServer asked to remove a unknown "
+                    << "dispatcher, potentially from a duplicate call to Add.";
+    return;
+  }
+
+  if (it->second.events != 0) {
+    int fd = pdispatcher->GetDescriptor();
+    // The event argument is ignored, but kernels before 2.6.9 require it to
+    // be non-null.
+    struct epoll_event event = {0};
+    int err = epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &event);
+    if (err == -1 && errno != ENOENT && errno != EBADF) {
+      // ENOENT and EBADF are expected if the descriptor has already been
+      // closed, which implicitly removes it from the epoll set.
+      LOG_E(LS_ERROR, EN, errno) << "epoll_ctl EPOLL_CTL_DEL";
+    }
+  }
+  // Any events still pending for |key| in the current WaitEpoll iteration are
+  // dropped, since the key is no longer known.
+  epoll_dispatchers_.erase(it->second.key);
+  epoll_registrations_.erase(it);
+}
+
+void PhysicalSocketServer::UpdateEpoll(Dispatcher* pdispatcher,
+                                       EpollRegistration* registration) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  int fd = pdispatcher->GetDescriptor();
+  if (fd == INVALID_SOCKET)
+    return;
+
+  uint32_t events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+  if (events == registration->events)
+    return;
+
+  // Descriptors without any requested events are taken out of the interest
+  // set entirely. Otherwise EPOLLHUP and EPOLLERR, which are always reported,
+  // would make a dead socket spin the loop until it is closed.
+  struct epoll_event event = {0};
+  event.events = events;
+  event.data.u64 = registration->key;
+  int op;
+  if (events == 0) {
+    op = EPOLL_CTL_DEL;
+  } else if (registration->events == 0) {
+    op = EPOLL_CTL_ADD;
+  } else {
+    op = EPOLL_CTL_MOD;
+  }
+  int err = epoll_ctl(epoll_fd_, op, fd, &event);
+  if (err == -1 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+    // The descriptor was closed and reopened behind our back.
+    err = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+  }
+  if (err == -1) {
+    LOG_E(LS_ERROR, EN, errno) << "epoll_ctl " << op << " fd " << fd;
+    return;
+  }
+  registration->events = events;
+}
+
+bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
+  ASSERT(epoll_fd_ != INVALID_SOCKET);
+  int64_t tvWait = -1;
+  int64_t tvStop = -1;
+  if (cmsWait != kForever) {
+    tvWait = cmsWait;
+    tvStop = TimeAfter(cmsWait);
+  }
+
+  if (epoll_events_.empty()) {
+    // The initial space to receive events is created only if epoll is used.
+    epoll_events_.resize(kInitialEpollEvents);
+  }
+
+  fWait_ = true;
+
+  while (fWait_) {
+    // Wait then call handlers as appropriate
+    // < 0 means error
+    // 0 means timeout
+    // > 0 means count of descriptors ready
+    int n = epoll_wait(epoll_fd_, &epoll_events_[0],
+                       static_cast<int>(epoll_events_.size()),
+                       static_cast<int>(tvWait));
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_E(LS_ERROR, EN, errno) << "epoll";
+        return false;
+      }
+      // Else ignore the error and keep going. If this EINTR was for one of the
+      // signals managed by this PhysicalSocketServer, the
+      // PosixSignalDeliveryDispatcher will be in the signaled state in the next
+      // iteration.
+    } else if (n == 0) {
+      // If timeout, return success
+      return true;
+    } else {
+      // We have signaled descriptors
+      CritScope cr(&crit_);
+      for (int i = 0; i < n; ++i) {
+        const struct epoll_event& event = epoll_events_[i];
+        EpollDispatcherMap::iterator it =
+            epoll_dispatchers_.find(event.data.u64);
+        if (it == epoll_dispatchers_.end()) {
+          // The dispatcher for this socket was removed by the handler of an
+          // event earlier in this batch.
+          continue;
+        }
+
+        bool readable = (event.events & (EPOLLIN | EPOLLPRI)) != 0;
+        bool writable = (event.events & EPOLLOUT) != 0;
+        bool check_error = (event.events & (EPOLLRDHUP | EPOLLERR | EPOLLHUP));
+
+        ProcessEvents(it->second, readable, writable, check_error);
+      }
+    }
+
+    if (static_cast<size_t>(n) == epoll_events_.size() &&
+        epoll_events_.size() < kMaxEpollEvents) {
+      // We used the complete space to receive events, increase size for future
+      // iterations.
+      epoll_events_.resize(std::min(epoll_events_.size() * 2, kMaxEpollEvents));
+    }
+
+    if (cmsWait != kForever) {
+      tvWait = TimeDiff(tvStop, TimeMillis());
+      if (tvWait <= 0) {
+        // Return success on timeout.
+        return true;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool PhysicalSocketServer::WaitPoll(int cmsWait, Dispatcher* dispatcher) {
+  ASSERT(dispatcher);
+  int64_t tvWait = -1;
+  int64_t tvStop = -1;
+  if (cmsWait != kForever) {
+    tvWait = cmsWait;
+    tvStop = TimeAfter(cmsWait);
+  }
+
+  fWait_ = true;
+
+  struct pollfd fds = {0};
+  int fd = dispatcher->GetDescriptor();
+  fds.fd = fd;
+
+  while (fWait_) {
+    uint32_t ff = dispatcher->GetRequestedEvents();
+    fds.events = 0;
+    if (ff & (DE_READ | DE_ACCEPT)) {
+      fds.events |= POLLIN;
+    }
+    if (ff & (DE_WRITE | DE_CONNECT)) {
+      fds.events |= POLLOUT;
+    }
+    fds.revents = 0;
+
+    // Wait then call handlers as appropriate
+    // < 0 means error
+    // 0 means timeout
+    // > 0 means count of descriptors ready
+    int n = poll(&fds, 1, static_cast<int>(tvWait));
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_E(LS_ERROR, EN, errno) << "poll";
+        return false;
+      }
+      // Else ignore the error and keep going. If this EINTR was for one of the
+      // signals managed by this PhysicalSocketServer, the
+      // PosixSignalDeliveryDispatcher will be in the signaled state in the next
+      // iteration.
+    } else if (n == 0) {
+      // If timeout, return success
+      return true;
+    } else {
+      // We have signaled descriptors (should only be the passed dispatcher).
+      ASSERT(n == 1);
+      ASSERT(fds.fd == fd);
+
+      bool readable = (fds.revents & (POLLIN | POLLPRI)) != 0;
+      bool writable = (fds.revents & POLLOUT) != 0;
+      bool check_error = (fds.revents & (POLLRDHUP | POLLERR | POLLHUP)) != 0;
+
+      CritScope cr(&crit_);
+      ProcessEvents(dispatcher, readable, writable, check_error);
+    }
+
+    if (cmsWait != kForever) {
+      tvWait = TimeDiff(tvStop, TimeMillis());
+      if (tvWait < 0) {
+        // Return success on timeout.
+        return true;
+      }
+    }
+  }
+
+  return true;
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 static void GlobalSignalHandler(int signum) {
   PosixSignalHandler::Instance()->OnPosixSignalReceived(signum);
 }
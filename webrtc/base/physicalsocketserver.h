@@ -11,7 +11,13 @@
 #ifndef WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 #define WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 
+#if defined(WEBRTC_LINUX)
+#include <sys/epoll.h>
+#define WEBRTC_USE_EPOLL 1
+#endif
+
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/base/asyncfile.h"
@@ -59,6 +65,10 @@ class Dispatcher {
 class PhysicalSocketServer : public SocketServer {
  public:
   PhysicalSocketServer();
+  // |use_epoll| selects the epoll based implementation of Wait() on platforms
+  // that support it (see WEBRTC_USE_EPOLL). It is ignored elsewhere, and a
+  // server that fails to create its epoll instance falls back to select().
+  explicit PhysicalSocketServer(bool use_epoll);
   ~PhysicalSocketServer() override;
 
   // SocketFactory:
@@ -77,6 +87,14 @@ class PhysicalSocketServer : public SocketServer {
 
   void Add(Dispatcher* dispatcher);
   void Remove(Dispatcher* dispatcher);
+  // Must be called when the value returned by |dispatcher|'s
+  // GetRequestedEvents() changes, so that the epoll interest set can be kept
+  // in sync. This is a no-op for the select() based implementation, which
+  // queries every dispatcher on each iteration.
+  void Update(Dispatcher* dispatcher);
+
+  // Returns true if this server dispatches events through epoll.
+  bool UsesEpoll() const;
 
 #if defined(WEBRTC_POSIX)
   AsyncFile* CreateFile(int fd);
@@ -102,9 +120,36 @@ class PhysicalSocketServer : public SocketServer {
   typedef std::vector<size_t*> IteratorList;
 
 #if defined(WEBRTC_POSIX)
+  bool WaitSelect(int cms, bool process_io);
   static bool InstallSignal(int signum, void (*handler)(int));
 
   std::unique_ptr<PosixSignalDispatcher> signal_dispatcher_;
+#endif
+#if defined(WEBRTC_USE_EPOLL)
+  // Epoll registration state of a single dispatcher. |key| is stored in the
+  // kernel instead of the dispatcher pointer, so that events that are still
+  // pending for a dispatcher that has been removed (and whose memory may have
+  // been reused) are recognized as stale and dropped.
+  struct EpollRegistration {
+    uint64_t key;
+    // The epoll event mask currently registered in the kernel, or 0 if the
+    // descriptor is currently not part of the interest set.
+    uint32_t events;
+  };
+  typedef std::unordered_map<Dispatcher*, EpollRegistration> EpollRegistrations;
+  typedef std::unordered_map<uint64_t, Dispatcher*> EpollDispatcherMap;
+
+  void AddEpoll(Dispatcher* dispatcher);
+  void RemoveEpoll(Dispatcher* dispatcher);
+  void UpdateEpoll(Dispatcher* dispatcher, EpollRegistration* registration);
+  bool WaitEpoll(int cms);
+  bool WaitPoll(int cms, Dispatcher* dispatcher);
+
+  int epoll_fd_;
+  uint64_t next_epoll_key_;
+  EpollRegistrations epoll_registrations_;
+  EpollDispatcherMap epoll_dispatchers_;
+  std::vector<struct epoll_event> epoll_events_;
 #endif
   DispatcherList dispatchers_;
   IteratorList iterators_;
@@ -149,6 +194,10 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
                SocketAddress* out_addr,
                int64_t* timestamp) override;
 
+  // Use sendmmsg and recvmmsg where available.
+  int SendToBatch(const SendDatagram* datagrams, size_t count) override;
+  int RecvFromBatch(RecvDatagram* datagrams, size_t count) override;
+
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
 
@@ -178,10 +227,23 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 
   static int TranslateOption(Option opt, int* slevel, int* sopt);
 
+  // Handles OPT_UDP_GSO and OPT_UDP_GRO, which are negotiated with the kernel
+  // rather than mapped to a single socket option.
+  int GetUdpOffloadOption(Option opt, int* value);
+  int SetUdpOffloadOption(Option opt, int value);
+
+  // All modifications of |enabled_events_| go through these, so that
+  // subclasses registered with the socket server can propagate the change.
+  virtual void SetEnabledEvents(uint8_t events);
+  void EnableEvents(uint8_t events);
+  void DisableEvents(uint8_t events);
+
   PhysicalSocketServer* ss_;
   SOCKET s_;
   uint8_t enabled_events_;
   bool udp_;
+  bool gso_enabled_;
+  bool gro_enabled_;
   CriticalSection crit_;
   int error_ GUARDED_BY(crit_);
   ConnState state_;
@@ -218,6 +280,9 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
 
   int Close() override;
 
+ protected:
+  void SetEnabledEvents(uint8_t events) override;
+
 #if defined(WEBRTC_WIN)
  private:
   static int next_id_;
@@ -18,6 +18,7 @@
 #include "webrtc/base/socket_unittest.h"
 #include "webrtc/base/testutils.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 namespace rtc {
 
@@ -415,6 +416,199 @@ TEST_F(PhysicalSocketTest, TestSocketRecvTimestampIPv6) {
 }
 #endif
 
+#if defined(WEBRTC_USE_EPOLL)
+
+TEST_F(PhysicalSocketTest, UsesEpollByDefault) {
+  EXPECT_TRUE(server_->UsesEpoll());
+}
+
+// Runs a subset of the generic socket tests against the select() based
+// implementation, which is used on Linux when epoll is unavailable.
+class PhysicalSocketSelectTest : public SocketTest {
+ protected:
+  PhysicalSocketSelectTest()
+      : server_(new PhysicalSocketServer(false)), scope_(server_.get()) {}
+
+  std::unique_ptr<PhysicalSocketServer> server_;
+  SocketServerScope scope_;
+};
+
+TEST_F(PhysicalSocketSelectTest, DoesNotUseEpoll) {
+  EXPECT_FALSE(server_->UsesEpoll());
+}
+
+TEST_F(PhysicalSocketSelectTest, TestConnectIPv4) {
+  SocketTest::TestConnectIPv4();
+}
+
+TEST_F(PhysicalSocketSelectTest, TestServerCloseIPv4) {
+  SocketTest::TestServerCloseIPv4();
+}
+
+TEST_F(PhysicalSocketSelectTest, TestCloseInClosedCallbackIPv4) {
+  SocketTest::TestCloseInClosedCallbackIPv4();
+}
+
+TEST_F(PhysicalSocketSelectTest, TestSocketServerWaitIPv4) {
+  SocketTest::TestSocketServerWaitIPv4();
+}
+
+TEST_F(PhysicalSocketSelectTest, TestTcpIPv4) {
+  SocketTest::TestTcpIPv4();
+}
+
+TEST_F(PhysicalSocketSelectTest, TestUdpIPv4) {
+  SocketTest::TestUdpIPv4();
+}
+
+// Deletes the other socket of a pair when the first one becomes readable.
+class DeleteOtherOnRead : public sigslot::has_slots<> {
+ public:
+  DeleteOtherOnRead(AsyncSocket* first, AsyncSocket* second)
+      : first_(first), second_(second) {
+    first_->SignalReadEvent.connect(this, &DeleteOtherOnRead::OnReadEvent);
+    second_->SignalReadEvent.connect(this, &DeleteOtherOnRead::OnReadEvent);
+  }
+  ~DeleteOtherOnRead() override {
+    delete first_;
+    delete second_;
+  }
+
+  int reads() const { return reads_; }
+
+ private:
+  void OnReadEvent(AsyncSocket* socket) {
+    ++reads_;
+    char buffer[16];
+    socket->RecvFrom(buffer, sizeof(buffer), nullptr, nullptr);
+    if (socket == first_) {
+      delete second_;
+      second_ = nullptr;
+    } else {
+      delete first_;
+      first_ = nullptr;
+    }
+  }
+
+  AsyncSocket* first_;
+  AsyncSocket* second_;
+  int reads_ = 0;
+};
+
+// Events that are reported by a single epoll_wait for a socket that has been
+// deleted while handling an earlier event must be dropped.
+TEST_F(PhysicalSocketTest, DeleteSocketWithPendingEvent) {
+  AsyncSocket* first = server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+  AsyncSocket* second = server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+  ASSERT_EQ(0, first->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, second->Bind(SocketAddress(kIPv4Loopback, 0)));
+  DeleteOtherOnRead handler(first, second);
+
+  std::unique_ptr<Socket> sender(
+      server_->CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_TRUE(sender);
+  const char kData[] = "x";
+  EXPECT_EQ(1, sender->SendTo(kData, 1, first->GetLocalAddress()));
+  EXPECT_EQ(1, sender->SendTo(kData, 1, second->GetLocalAddress()));
+
+  EXPECT_TRUE_WAIT(handler.reads() > 0, kTimeout);
+  // Process any further events; only one of the sockets is left.
+  EXPECT_TRUE(server_->Wait(10, true));
+  EXPECT_EQ(1, handler.reads());
+}
+
+#if defined(SO_REUSEPORT)
+// Sockets can share a port only if all of them set OPT_REUSEPORT.
+TEST_F(PhysicalSocketTest, BindWithReusePort) {
+  std::unique_ptr<AsyncSocket> first(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> second(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> third(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, first->SetOption(Socket::OPT_REUSEPORT, 1));
+  ASSERT_EQ(0, second->SetOption(Socket::OPT_REUSEPORT, 1));
+  int value = 0;
+  ASSERT_EQ(0, second->GetOption(Socket::OPT_REUSEPORT, &value));
+  EXPECT_NE(0, value);
+
+  ASSERT_EQ(0, first->Bind(SocketAddress(kIPv4Loopback, 0)));
+  EXPECT_EQ(0, second->Bind(first->GetLocalAddress()));
+  EXPECT_NE(0, third->Bind(first->GetLocalAddress()));
+}
+#endif
+
+// Counts and drains datagrams on all sockets it is connected to.
+class DatagramCounter : public sigslot::has_slots<> {
+ public:
+  void OnReadEvent(AsyncSocket* socket) {
+    char buffer[64];
+    while (socket->RecvFrom(buffer, sizeof(buffer), nullptr, nullptr) > 0)
+      ++received_;
+  }
+
+  int received() const { return received_; }
+
+ private:
+  int received_ = 0;
+};
+
+// Measures the time spent in Wait() with |num_sockets| bound UDP sockets, of
+// which only |num_active| receive a datagram in each round.
+static void RunWaitBenchmark(bool use_epoll, int num_sockets, int num_active) {
+  static const int kRounds = 1000;
+  PhysicalSocketServer ss(use_epoll);
+  ASSERT_EQ(use_epoll, ss.UsesEpoll());
+
+  DatagramCounter counter;
+  std::vector<std::unique_ptr<AsyncSocket>> sockets;
+  for (int i = 0; i < num_sockets; ++i) {
+    AsyncSocket* socket = ss.CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+    if (!socket) {
+      LOG(LS_WARNING) << "Only created " << i << " sockets, check ulimit -n.";
+      return;
+    }
+    sockets.emplace_back(socket);
+    ASSERT_EQ(0, socket->Bind(SocketAddress(IPAddress(INADDR_LOOPBACK), 0)));
+    socket->SignalReadEvent.connect(&counter, &DatagramCounter::OnReadEvent);
+  }
+  SocketDispatcher* last = static_cast<SocketDispatcher*>(sockets.back().get());
+  if (!use_epoll && last->GetDescriptor() >= FD_SETSIZE) {
+    LOG(LS_INFO) << "Skipping select() with " << num_sockets << " sockets.";
+    return;
+  }
+
+  std::unique_ptr<Socket> sender(ss.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_TRUE(sender);
+  const char kData[] = "ping";
+  int64_t start_us = TimeMicros();
+  for (int round = 0; round < kRounds; ++round) {
+    for (int i = 0; i < num_active; ++i) {
+      AsyncSocket* target = sockets[(round + i * 7919) % num_sockets].get();
+      sender->SendTo(kData, sizeof(kData), target->GetLocalAddress());
+    }
+    // Wait() only returns on timeout or WakeUp(), so poll without blocking.
+    while (counter.received() < (round + 1) * num_active)
+      ss.Wait(0, true);
+  }
+  int64_t elapsed_us = TimeMicros() - start_us;
+  LOG(LS_INFO) << (use_epoll ? "epoll" : "select") << ": " << num_sockets
+               << " sockets, " << num_active << " active, "
+               << elapsed_us / kRounds << " us per round.";
+}
+
+// Compares the scaling of the epoll and select() implementations. Raise the
+// descriptor limit (ulimit -n) above 10000 to run all configurations.
+// The test is disabled by default to avoid unecessarily loading the bots.
+TEST(PhysicalSocketServerPerfTest, DISABLED_WaitScaling) {
+  for (int num_sockets : {1000, 10000}) {
+    RunWaitBenchmark(false, num_sockets, 10);
+    RunWaitBenchmark(true, num_sockets, 10);
+  }
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 class PosixSignalDeliveryTest : public testing::Test {
  public:
   static void RecordSignal(int signum) {
@@ -10,8 +10,16 @@
 
 #include "webrtc/base/platform_thread.h"
 
+#include <map>
+#include <set>
+
 #include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/logging.h"
 
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+#include <sched.h>
+#endif
 #if defined(WEBRTC_LINUX)
 #include <sys/prctl.h>
 #include <sys/syscall.h>
@@ -76,6 +84,88 @@ void SetCurrentThreadName(const char* name) {
 #endif
 }
 
+namespace {
+// The CPU affinities set by SetThreadAffinityByName() and the threads that are
+// running. Leaked, so that threads may still be running at exit.
+struct ThreadRegistry {
+  CriticalSection lock;
+  std::map<std::string, std::vector<int>> affinities GUARDED_BY(lock);
+  std::set<const ScopedThreadRegistration*> threads GUARDED_BY(lock);
+};
+
+ThreadRegistry* GetThreadRegistry() {
+  static ThreadRegistry* const registry = new ThreadRegistry();
+  return registry;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+      return false;
+    CPU_SET(cpu, &cpu_set);
+  }
+  return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#elif defined(WEBRTC_WIN)
+  DWORD_PTR mask = 0;
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= static_cast<int>(sizeof(mask) * 8))
+      return false;
+    mask |= static_cast<DWORD_PTR>(1) << cpu;
+  }
+  return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+  return false;
+#endif
+}
+}  // namespace
+
+void SetThreadAffinityByName(const std::string& thread_name,
+                             const std::vector<int>& cpus) {
+  ThreadRegistry* registry = GetThreadRegistry();
+  CritScope cs(&registry->lock);
+  if (cpus.empty()) {
+    registry->affinities.erase(thread_name);
+  } else {
+    registry->affinities[thread_name] = cpus;
+  }
+}
+
+std::vector<RunningThreadInfo> GetRunningThreads() {
+  ThreadRegistry* registry = GetThreadRegistry();
+  CritScope cs(&registry->lock);
+  std::vector<RunningThreadInfo> threads;
+  for (const ScopedThreadRegistration* thread : registry->threads)
+    threads.push_back(thread->info());
+  return threads;
+}
+
+ScopedThreadRegistration::ScopedThreadRegistration(const std::string& name) {
+  if (!name.empty())
+    SetCurrentThreadName(name.c_str());
+  info_.name = name;
+  info_.id = CurrentThreadId();
+  ThreadRegistry* registry = GetThreadRegistry();
+  CritScope cs(&registry->lock);
+  auto it = registry->affinities.find(name);
+  if (it != registry->affinities.end()) {
+    if (SetCurrentThreadAffinity(it->second)) {
+      info_.cpus = it->second;
+    } else {
+      LOG(LS_WARNING) << "Failed to set the CPU affinity of thread " << name;
+    }
+  }
+  registry->threads.insert(this);
+}
+
+ScopedThreadRegistration::~ScopedThreadRegistration() {
+  ThreadRegistry* registry = GetThreadRegistry();
+  CritScope cs(&registry->lock);
+  registry->threads.erase(this);
+}
+
 namespace {
 #if defined(WEBRTC_WIN)
 void CALLBACK RaiseFlag(ULONG_PTR param) {
@@ -189,8 +279,7 @@ void PlatformThread::Stop() {
 }
 
 void PlatformThread::Run() {
-  if (!name_.empty())
-    rtc::SetCurrentThreadName(name_.c_str());
+  ScopedThreadRegistration registration(name_);
   do {
     // The interface contract of Start/Stop is that for a successful call to
     // Start, there should be at least one call to the run function.  So we
@@ -12,6 +12,7 @@
 #define WEBRTC_BASE_PLATFORM_THREAD_H_
 
 #include <string>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/event.h"
@@ -29,6 +30,40 @@ bool IsThreadRefEqual(const PlatformThreadRef& a, const PlatformThreadRef& b);
 // Sets the current thread name.
 void SetCurrentThreadName(const char* name);
 
+// Restricts the threads named |thread_name| to the CPUs in |cpus|, e.g. to pin
+// media threads to dedicated cores or to keep other threads off them. Applies
+// to the threads that PlatformThread and rtc::Thread start after the call; an
+// empty |cpus| removes the restriction. Only supported on Linux, Android and
+// Windows, and ignored elsewhere. Can be called on any thread.
+void SetThreadAffinityByName(const std::string& thread_name,
+                             const std::vector<int>& cpus);
+
+struct RunningThreadInfo {
+  std::string name;
+  PlatformThreadId id;
+  // The CPUs the thread was restricted to, or empty.
+  std::vector<int> cpus;
+};
+
+// Returns the threads started by PlatformThread and rtc::Thread that are
+// still running, for diagnostics.
+std::vector<RunningThreadInfo> GetRunningThreads();
+
+// Names the current thread, applies the CPU affinity set for |name| and lists
+// the thread in GetRunningThreads() for the lifetime of the object.
+class ScopedThreadRegistration {
+ public:
+  explicit ScopedThreadRegistration(const std::string& name);
+  ~ScopedThreadRegistration();
+
+  const RunningThreadInfo& info() const { return info_; }
+
+ private:
+  RunningThreadInfo info_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ScopedThreadRegistration);
+};
+
 // Callback function that the spawned thread will enter once spawned.
 // A return value of false is interpreted as that the function has no
 // more work to do and that the thread can be released.
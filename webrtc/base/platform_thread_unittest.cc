@@ -10,6 +10,10 @@
 
 #include "webrtc/base/platform_thread.h"
 
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 
@@ -28,6 +32,23 @@ bool SetFlagRunFunction(void* obj) {
   webrtc::SleepMs(0);  // Hand over timeslice, prevents busy looping.
   return true;
 }
+
+bool IsRunning(const std::string& name) {
+  for (const RunningThreadInfo& thread : GetRunningThreads()) {
+    if (thread.name == name)
+      return true;
+  }
+  return false;
+}
+
+#if defined(WEBRTC_LINUX)
+// Records the CPU the thread runs on.
+bool GetCpuRunFunction(void* obj) {
+  *static_cast<int*>(obj) = sched_getcpu();
+  webrtc::SleepMs(0);  // Hand over timeslice, prevents busy looping.
+  return true;
+}
+#endif
 }  // namespace
 
 TEST(PlatformThreadTest, StartStop) {
@@ -62,4 +83,36 @@ TEST(PlatformThreadTest, RunFunctionIsCalled) {
   // We expect the thread to have run at least once.
   EXPECT_TRUE(flag);
 }
+
+TEST(PlatformThreadTest, ListsRunningThreads) {
+  PlatformThread thread(&NullRunFunction, nullptr, "ListsRunningThreads");
+  EXPECT_FALSE(IsRunning("ListsRunningThreads"));
+  thread.Start();
+  // The thread registers itself once it runs.
+  for (int i = 0; i < 1000 && !IsRunning("ListsRunningThreads"); ++i)
+    webrtc::SleepMs(1);
+  EXPECT_TRUE(IsRunning("ListsRunningThreads"));
+  thread.Stop();
+  EXPECT_FALSE(IsRunning("ListsRunningThreads"));
+}
+
+#if defined(WEBRTC_LINUX)
+TEST(PlatformThreadTest, SetsThreadAffinityByName) {
+  // Pin the thread to the last CPU this process may run on.
+  cpu_set_t allowed;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+  int cpu = CPU_SETSIZE - 1;
+  while (!CPU_ISSET(cpu, &allowed))
+    --cpu;
+  SetThreadAffinityByName("SetsThreadAffinity", std::vector<int>(1, cpu));
+
+  int thread_cpu = -1;
+  PlatformThread thread(&GetCpuRunFunction, &thread_cpu, "SetsThreadAffinity");
+  thread.Start();
+  thread.Stop();
+  EXPECT_EQ(cpu, thread_cpu);
+
+  SetThreadAffinityByName("SetsThreadAffinity", std::vector<int>());
+}
+#endif
 }  // rtc
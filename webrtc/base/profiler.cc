@@ -12,7 +12,12 @@
 
 #include <math.h>
 #include <algorithm>
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#include <time.h>
+#endif
 
+#include "webrtc/base/checks.h"
 #include "webrtc/base/timeutils.h"
 
 namespace {
@@ -178,6 +183,209 @@ bool Profiler::Clear() {
   return result;
 }
 
+namespace {
+
+// Owns the profiles of all threads. Never destroyed, as threads may still be
+// profiling at exit.
+class ThreadProfileRegistry {
+ public:
+  ThreadProfileRegistry() {
+#if defined(WEBRTC_WIN)
+    key_ = TlsAlloc();
+#else
+    pthread_key_create(&key_, nullptr);
+#endif
+  }
+
+  ThreadProfile* GetCurrent() {
+#if defined(WEBRTC_WIN)
+    return static_cast<ThreadProfile*>(TlsGetValue(key_));
+#else
+    return static_cast<ThreadProfile*>(pthread_getspecific(key_));
+#endif
+  }
+
+  void SetCurrent(ThreadProfile* profile) {
+    {
+      CritScope lock(&crit_);
+      profiles_.push_back(profile);
+    }
+#if defined(WEBRTC_WIN)
+    TlsSetValue(key_, profile);
+#else
+    pthread_setspecific(key_, profile);
+#endif
+  }
+
+  std::vector<ThreadProfile*> GetAll() {
+    CritScope lock(&crit_);
+    return profiles_;
+  }
+
+ private:
+#if defined(WEBRTC_WIN)
+  DWORD key_;
+#else
+  pthread_key_t key_;
+#endif
+  CriticalSection crit_;
+  std::vector<ThreadProfile*> profiles_ GUARDED_BY(crit_);
+};
+
+ThreadProfileRegistry* GetThreadProfileRegistry() {
+  static ThreadProfileRegistry* const registry = new ThreadProfileRegistry();
+  return registry;
+}
+
+void ReportNodes(const ThreadProfile::Snapshot& snapshot,
+                 int node,
+                 const std::string& prefix,
+                 const char* file,
+                 int line,
+                 LoggingSeverity severity_to_use) {
+  for (; node != -1; node = snapshot.nodes[node].next_sibling) {
+    const ThreadProfile::Node& n = snapshot.nodes[node];
+    const std::string name = prefix + n.name;
+    LogMessage(file, line, severity_to_use).stream()
+        << name << " count=" << n.count
+        << " wall=" << FormattedTime(n.wall_time_ns /
+                                     static_cast<double>(kNumNanosecsPerSec))
+        << " cpu=" << FormattedTime(n.cpu_time_ns /
+                                    static_cast<double>(kNumNanosecsPerSec));
+    ReportNodes(snapshot, n.first_child, name + "/", file, line,
+                severity_to_use);
+  }
+}
+
+}  // namespace
+
+ThreadProfile::ThreadProfile(PlatformThreadId thread_id)
+    : thread_id_(thread_id), current_node_(-1) {}
+
+// static
+ThreadProfile* ThreadProfile::Current() {
+  ThreadProfileRegistry* registry = GetThreadProfileRegistry();
+  ThreadProfile* profile = registry->GetCurrent();
+  if (!profile) {
+    profile = new ThreadProfile(CurrentThreadId());
+    registry->SetCurrent(profile);
+  }
+  return profile;
+}
+
+// static
+std::vector<ThreadProfile::Snapshot> ThreadProfile::GetSnapshots() {
+  std::vector<Snapshot> snapshots;
+  for (ThreadProfile* profile : GetThreadProfileRegistry()->GetAll()) {
+    CritScope lock(&profile->crit_);
+    snapshots.push_back(Snapshot{profile->thread_id_, profile->nodes_});
+  }
+  return snapshots;
+}
+
+// static
+void ThreadProfile::ReportAllToLog(const char* file,
+                                   int line,
+                                   LoggingSeverity severity_to_use) {
+  std::map<PlatformThreadId, std::string> thread_names;
+  for (const RunningThreadInfo& thread : GetRunningThreads())
+    thread_names[thread.id] = thread.name;
+
+  LogMessage(file, line, severity_to_use).stream()
+      << "=== Thread profile report ===";
+  for (const Snapshot& snapshot : GetSnapshots()) {
+    LogMessage(file, line, severity_to_use).stream()
+        << "Thread " << snapshot.thread_id << " '"
+        << thread_names[snapshot.thread_id] << "'";
+    // Top-level scopes are chained as siblings of the first node.
+    if (!snapshot.nodes.empty())
+      ReportNodes(snapshot, 0, "", file, line, severity_to_use);
+  }
+  LogMessage(file, line, severity_to_use).stream()
+      << "=== End thread profile report ===";
+}
+
+int ThreadProfile::EnterScope(const char* name) {
+  CritScope lock(&crit_);
+  // Scopes are told apart by the address of their name, which is a literal.
+  int* link = nullptr;
+  if (current_node_ != -1) {
+    link = &nodes_[current_node_].first_child;
+  } else if (!nodes_.empty()) {
+    // All top-level scopes are siblings of the first one.
+    if (nodes_[0].name == name) {
+      current_node_ = 0;
+      return current_node_;
+    }
+    link = &nodes_[0].next_sibling;
+  }
+  if (link) {
+    while (*link != -1 && nodes_[*link].name != name)
+      link = &nodes_[*link].next_sibling;
+    if (*link != -1) {
+      current_node_ = *link;
+      return current_node_;
+    }
+  }
+  const int node = static_cast<int>(nodes_.size());
+  if (link)
+    *link = node;
+  nodes_.push_back(Node{name, current_node_, -1, -1, 0, 0, 0});
+  current_node_ = node;
+  return node;
+}
+
+void ThreadProfile::LeaveScope(int node,
+                               int64_t wall_time_ns,
+                               int64_t cpu_time_ns) {
+  CritScope lock(&crit_);
+  RTC_DCHECK_EQ(current_node_, node);
+  Node& n = nodes_[node];
+  ++n.count;
+  n.wall_time_ns += wall_time_ns;
+  n.cpu_time_ns += cpu_time_ns;
+  current_node_ = n.parent;
+}
+
+CpuProfilerScope::CpuProfilerScope(const char* name)
+    : profile_(ThreadProfile::Current()),
+      node_(profile_->EnterScope(name)),
+      start_wall_time_ns_(TimeNanos()),
+      start_cpu_time_ns_(CurrentThreadCpuTimeNanos()) {}
+
+CpuProfilerScope::~CpuProfilerScope() {
+  const int64_t cpu_time_ns = CurrentThreadCpuTimeNanos();
+  const int64_t wall_time_ns = TimeNanos();
+  profile_->LeaveScope(node_, wall_time_ns - start_wall_time_ns_,
+                       cpu_time_ns - start_cpu_time_ns_);
+}
+
+int64_t CurrentThreadCpuTimeNanos() {
+#if defined(WEBRTC_WIN)
+  FILETIME creation_time;
+  FILETIME exit_time;
+  FILETIME kernel_time;
+  FILETIME user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+                      &kernel_time, &user_time)) {
+    return 0;
+  }
+  // In units of 100 ns.
+  const uint64_t kernel = (static_cast<uint64_t>(kernel_time.dwHighDateTime)
+                           << 32) | kernel_time.dwLowDateTime;
+  const uint64_t user = (static_cast<uint64_t>(user_time.dwHighDateTime)
+                         << 32) | user_time.dwLowDateTime;
+  return static_cast<int64_t>(kernel + user) * 100;
+#elif defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return 0;
+  return static_cast<int64_t>(ts.tv_sec) * kNumNanosecsPerSec + ts.tv_nsec;
+#else
+  return 0;
+#endif
+}
+
 std::ostream& operator<<(std::ostream& stream,
                          const ProfilerEvent& profiler_event) {
   stream << "count=" << profiler_event.event_count()
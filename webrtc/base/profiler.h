@@ -27,17 +27,29 @@
 //     PROFILE_STOP("My async event");
 //     // Handle callback.
 //   }
+// PROFILE_CPU is a cheaper alternative for hot paths, which also measures the
+// CPU time of the thread and keeps nested scopes apart:
+//   void OnPacket() {
+//     PROFILE_CPU("OnPacket");
+//     {
+//       PROFILE_CPU("Parse");  // Reported as OnPacket/Parse.
+//       // Do something
+//     }
+//   }
 
 #ifndef WEBRTC_BASE_PROFILER_H_
 #define WEBRTC_BASE_PROFILER_H_
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/sharedexclusivelock.h"
 
 // Profiling could be switched via a build flag, but for now, it's always on.
@@ -67,6 +79,13 @@
 // captured within a scope (eg, an async call with a callback when done).
 #define PROFILE_START(msg) rtc::Profiler::Instance()->StartEvent(msg)
 #define PROFILE_STOP(msg) rtc::Profiler::Instance()->StopEvent(msg)
+// Profiles the wall-clock and CPU time of the current scope, per thread and
+// nested within the enclosing PROFILE_CPU scopes. |name| must be a string
+// literal.
+#define PROFILE_CPU(name) rtc::CpuProfilerScope UNIQUE_VAR(name)
+// Reports the PROFILE_CPU timings of all threads to the log at severity |sev|.
+#define PROFILE_CPU_DUMP_ALL(sev) \
+  rtc::ThreadProfile::ReportAllToLog(__FILE__, __LINE__, sev)
 // TODO(ryanpetrie): Consider adding PROFILE_DUMP_EVERY(sev, iterations)
 
 #undef UV_HELPER2
@@ -81,6 +100,8 @@
 #define PROFILE_DUMP(sev, prefix) (void)0
 #define PROFILE_START(msg) (void)0
 #define PROFILE_STOP(msg) (void)0
+#define PROFILE_CPU(name) (void)0
+#define PROFILE_CPU_DUMP_ALL(sev) (void)0
 
 #endif  // ENABLE_PROFILING
 
@@ -155,6 +176,80 @@ class ProfilerScope {
   RTC_DISALLOW_COPY_AND_ASSIGN(ProfilerScope);
 };
 
+// The scopes profiled with PROFILE_CPU on one thread, as a tree where every
+// scope entered within another one has its own node below it. Only the owning
+// thread updates its profile, and other threads only take its lock to make
+// snapshots, so profiling a scope doesn't contend with other threads.
+class ThreadProfile {
+ public:
+  struct Node {
+    // The name passed to PROFILE_CPU.
+    const char* name;
+    // Indices of the enclosing scope, the first nested scope and the next
+    // scope with the same parent, or -1.
+    int parent;
+    int first_child;
+    int next_sibling;
+    int64_t count;
+    int64_t wall_time_ns;
+    int64_t cpu_time_ns;
+  };
+
+  struct Snapshot {
+    PlatformThreadId thread_id;
+    // Parents come before their children.
+    std::vector<Node> nodes;
+  };
+
+  // Returns the profile of the current thread, creating it on first use.
+  static ThreadProfile* Current();
+
+  // Returns the profiles of all threads that have profiled a scope, including
+  // threads that have exited since.
+  static std::vector<Snapshot> GetSnapshots();
+
+  // Writes the profiles of all threads to the log.
+  static void ReportAllToLog(const char* file,
+                             int line,
+                             LoggingSeverity severity_to_use);
+
+  // Enters the scope |name| below the current scope, and returns its node.
+  int EnterScope(const char* name);
+  // Leaves the scope |node| entered last, and adds the time spent in it.
+  void LeaveScope(int node, int64_t wall_time_ns, int64_t cpu_time_ns);
+
+ private:
+  explicit ThreadProfile(PlatformThreadId thread_id);
+
+  const PlatformThreadId thread_id_;
+  CriticalSection crit_;
+  std::vector<Node> nodes_ GUARDED_BY(crit_);
+  // Only accessed on the owning thread.
+  int current_node_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ThreadProfile);
+};
+
+// Measures a scope in the current thread's ThreadProfile. Used by the
+// PROFILE_CPU macro.
+class CpuProfilerScope {
+ public:
+  explicit CpuProfilerScope(const char* name);
+  ~CpuProfilerScope();
+
+ private:
+  ThreadProfile* const profile_;
+  const int node_;
+  const int64_t start_wall_time_ns_;
+  const int64_t start_cpu_time_ns_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CpuProfilerScope);
+};
+
+// Returns the CPU time used by the current thread in nanoseconds, or 0 on
+// platforms where it isn't available.
+int64_t CurrentThreadCpuTimeNanos();
+
 std::ostream& operator<<(std::ostream& stream,
                          const ProfilerEvent& profiler_event);
 
@@ -9,6 +9,7 @@
  */
 
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/profiler.h"
 #include "webrtc/base/thread.h"
 
@@ -24,6 +25,35 @@ const char* TestFunc() {
   return __FUNCTION__;
 }
 
+const char kOuterScope[] = "Outer";
+const char kInnerScope[] = "Inner";
+
+bool ProfileInnerScope(void* thread_id) {
+  PROFILE_CPU(kInnerScope);
+  *static_cast<rtc::PlatformThreadId*>(thread_id) = rtc::CurrentThreadId();
+  return false;
+}
+
+const rtc::ThreadProfile::Snapshot* FindSnapshot(
+    const std::vector<rtc::ThreadProfile::Snapshot>& snapshots,
+    rtc::PlatformThreadId thread_id) {
+  for (const rtc::ThreadProfile::Snapshot& snapshot : snapshots) {
+    if (snapshot.thread_id == thread_id)
+      return &snapshot;
+  }
+  return nullptr;
+}
+
+int FindNode(const rtc::ThreadProfile::Snapshot& snapshot,
+             const char* name,
+             int parent) {
+  for (size_t i = 0; i < snapshot.nodes.size(); ++i) {
+    if (snapshot.nodes[i].name == name && snapshot.nodes[i].parent == parent)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
 }  // namespace
 
 namespace rtc {
@@ -116,4 +146,40 @@ TEST(ProfilerTest, Clear) {
   EXPECT_EQ(NULL, Profiler::Instance()->GetEvent("event"));
 }
 
+TEST(ProfilerTest, ProfilesNestedScopesPerThread) {
+  {
+    PROFILE_CPU(kOuterScope);
+    for (int i = 0; i < 3; ++i) {
+      PROFILE_CPU(kInnerScope);
+    }
+  }
+  PlatformThreadId thread_id = 0;
+  PlatformThread thread(&ProfileInnerScope, &thread_id, "ProfilerTest");
+  thread.Start();
+  thread.Stop();
+
+  const std::vector<ThreadProfile::Snapshot> snapshots =
+      ThreadProfile::GetSnapshots();
+  const ThreadProfile::Snapshot* snapshot =
+      FindSnapshot(snapshots, CurrentThreadId());
+  ASSERT_TRUE(snapshot != nullptr);
+  const int outer = FindNode(*snapshot, kOuterScope, -1);
+  ASSERT_NE(-1, outer);
+  const int inner = FindNode(*snapshot, kInnerScope, outer);
+  ASSERT_NE(-1, inner);
+  EXPECT_EQ(inner, snapshot->nodes[outer].first_child);
+  EXPECT_EQ(-1, FindNode(*snapshot, kInnerScope, -1));
+  EXPECT_GE(snapshot->nodes[outer].count, 1);
+  EXPECT_EQ(3 * snapshot->nodes[outer].count, snapshot->nodes[inner].count);
+  EXPECT_GE(snapshot->nodes[outer].wall_time_ns,
+            snapshot->nodes[inner].wall_time_ns);
+
+  // The other thread's scope is top-level in its own profile.
+  snapshot = FindSnapshot(snapshots, thread_id);
+  ASSERT_TRUE(snapshot != nullptr);
+  ASSERT_EQ(1u, snapshot->nodes.size());
+  EXPECT_EQ(kInnerScope, snapshot->nodes[0].name);
+  EXPECT_EQ(1, snapshot->nodes[0].count);
+}
+
 }  // namespace rtc
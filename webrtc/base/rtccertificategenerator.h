@@ -14,6 +14,7 @@
 #include "webrtc/base/optional.h"
 #include "webrtc/base/refcount.h"
 #include "webrtc/base/rtccertificate.h"
+#include "webrtc/base/rtccertificatepool.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/sslidentity.h"
 #include "webrtc/base/thread.h"
@@ -51,7 +52,8 @@ class RTCCertificateGeneratorInterface {
 // Standard implementation of |RTCCertificateGeneratorInterface|.
 // The static function |GenerateCertificate| generates a certificate on the
 // current thread. The |RTCCertificateGenerator| instance generates certificates
-// asynchronously on the worker thread with |GenerateCertificateAsync|.
+// asynchronously on the worker thread with |GenerateCertificateAsync|, or
+// takes them from an |RTCCertificatePool| if one is given.
 class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
  public:
   // Generates a certificate on the current thread. Returns null on failure.
@@ -64,6 +66,11 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
       const Optional<uint64_t>& expires_ms);
 
   RTCCertificateGenerator(Thread* signaling_thread, Thread* worker_thread);
+  // Requests without |expires_ms| are served from |pool| when it has a
+  // certificate ready. |pool| may be null and must outlive the generator.
+  RTCCertificateGenerator(Thread* signaling_thread,
+                          Thread* worker_thread,
+                          RTCCertificatePool* pool);
   ~RTCCertificateGenerator() override {}
 
   // |RTCCertificateGeneratorInterface| overrides.
@@ -79,6 +86,7 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
  private:
   Thread* const signaling_thread_;
   Thread* const worker_thread_;
+  RTCCertificatePool* const pool_;
 };
 
 }  // namespace rtc
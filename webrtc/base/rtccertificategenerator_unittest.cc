@@ -70,13 +70,17 @@ class RTCCertificateGeneratorTest
     : public testing::Test {
  public:
   RTCCertificateGeneratorTest()
-      : fixture_(new RefCountedObject<RTCCertificateGeneratorFixture>()) {}
+      : fixture_(new RefCountedObject<RTCCertificateGeneratorFixture>()),
+        worker_thread_(new Thread()) {
+    RTC_CHECK(worker_thread_->Start());
+  }
   ~RTCCertificateGeneratorTest() {}
 
  protected:
   static const int kGenerationTimeoutMs = 10000;
 
   scoped_refptr<RTCCertificateGeneratorFixture> fixture_;
+  std::unique_ptr<Thread> worker_thread_;
 };
 
 TEST_F(RTCCertificateGeneratorTest, GenerateECDSA) {
@@ -106,6 +110,30 @@ TEST_F(RTCCertificateGeneratorTest, GenerateAsyncECDSA) {
   EXPECT_TRUE(fixture_->certificate());
 }
 
+TEST_F(RTCCertificateGeneratorTest, GenerateAsyncFromPool) {
+  RTCCertificatePool pool(1);
+  pool.AddKeyParams(KeyParams::ECDSA());
+  EXPECT_EQ_WAIT(1u, pool.GetStats().ready, kGenerationTimeoutMs);
+  RTCCertificateGenerator generator(Thread::Current(), worker_thread_.get(),
+                                    &pool);
+
+  generator.GenerateCertificateAsync(KeyParams::ECDSA(), Optional<uint64_t>(),
+                                     fixture_);
+  // Even when served from the pool, the callback is invoked asynchronously.
+  EXPECT_FALSE(fixture_->GenerateAsyncCompleted());
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+  EXPECT_EQ(1u, pool.GetStats().hits);
+
+  // Requests with an expiration time are not served from the pool.
+  generator.GenerateCertificateAsync(KeyParams::ECDSA(),
+                                     Optional<uint64_t>(60000), fixture_);
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+  EXPECT_EQ(1u, pool.GetStats().hits);
+  EXPECT_EQ(0u, pool.GetStats().misses);
+}
+
 TEST_F(RTCCertificateGeneratorTest, GenerateWithExpires) {
   // By generating two certificates with different expiration we can compare the
   // two expiration times relative to each other without knowing the current
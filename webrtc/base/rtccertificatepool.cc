@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/rtccertificatepool.h"
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/rtccertificategenerator.h"
+#include "webrtc/base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+bool SameKeyParams(const KeyParams& a, const KeyParams& b) {
+  if (a.type() != b.type())
+    return false;
+  switch (a.type()) {
+    case KT_RSA:
+      return a.rsa_params().mod_size == b.rsa_params().mod_size &&
+             a.rsa_params().pub_exp == b.rsa_params().pub_exp;
+    case KT_ECDSA:
+      return a.ec_curve() == b.ec_curve();
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+const size_t RTCCertificatePool::kDefaultSize;
+const int64_t RTCCertificatePool::kMaxCertificateAgeMs;
+
+RTCCertificatePool::RTCCertificatePool()
+    : RTCCertificatePool(kDefaultSize) {}
+
+RTCCertificatePool::RTCCertificatePool(size_t size)
+    : size_(size),
+      stopping_(false),
+      wake_(false, false),
+      thread_(&RTCCertificatePool::ThreadFunc, this, "RTCCertificatePool") {
+  RTC_DCHECK_GT(size_, 0u);
+  // Not lowering the thread priority; on POSIX PlatformThread::SetPriority
+  // switches to a real-time policy, which would preempt normal threads.
+  thread_.Start();
+}
+
+RTCCertificatePool::~RTCCertificatePool() {
+  {
+    CritScope cs(&crit_);
+    stopping_ = true;
+  }
+  wake_.Set();
+  // Waits for a generation in progress, if any.
+  thread_.Stop();
+}
+
+void RTCCertificatePool::AddKeyParams(const KeyParams& key_params) {
+  {
+    CritScope cs(&crit_);
+    AddKeyParamsLocked(key_params);
+  }
+  wake_.Set();
+}
+
+scoped_refptr<RTCCertificate> RTCCertificatePool::Take(
+    const KeyParams& key_params) {
+  scoped_refptr<RTCCertificate> certificate;
+  {
+    CritScope cs(&crit_);
+    Entry* entry = FindEntryLocked(key_params);
+    if (entry) {
+      DiscardExpiredLocked(entry);
+      if (!entry->ready.empty()) {
+        certificate = entry->ready.front().certificate;
+        entry->ready.pop_front();
+      }
+    } else {
+      AddKeyParamsLocked(key_params);
+    }
+    if (certificate) {
+      ++stats_.hits;
+    } else {
+      ++stats_.misses;
+    }
+  }
+  wake_.Set();
+  return certificate;
+}
+
+RTCCertificatePool::Stats RTCCertificatePool::GetStats() const {
+  CritScope cs(&crit_);
+  Stats stats = stats_;
+  stats.ready = 0;
+  for (const Entry& entry : entries_)
+    stats.ready += entry.ready.size();
+  return stats;
+}
+
+// static
+bool RTCCertificatePool::ThreadFunc(void* param) {
+  RTCCertificatePool* me = static_cast<RTCCertificatePool*>(param);
+  me->wake_.Wait(Event::kForever);
+  return me->Refill();
+}
+
+bool RTCCertificatePool::Refill() {
+  while (true) {
+    KeyParams key_params;
+    {
+      CritScope cs(&crit_);
+      if (stopping_)
+        return false;
+      Entry* to_fill = nullptr;
+      for (Entry& entry : entries_) {
+        DiscardExpiredLocked(&entry);
+        if (entry.ready.size() < size_) {
+          to_fill = &entry;
+          break;
+        }
+      }
+      if (!to_fill)
+        return true;
+      key_params = to_fill->key_params;
+    }
+
+    scoped_refptr<RTCCertificate> certificate =
+        RTCCertificateGenerator::GenerateCertificate(key_params,
+                                                     Optional<uint64_t>());
+    if (!certificate) {
+      // Wait for the next Take() rather than retrying in a loop.
+      LOG(LS_WARNING) << "RTCCertificatePool failed to generate a "
+                      << "certificate.";
+      return true;
+    }
+
+    CritScope cs(&crit_);
+    ++stats_.generated;
+    Entry* entry = FindEntryLocked(key_params);
+    RTC_DCHECK(entry);
+    entry->ready.push_back({certificate, TimeMillis()});
+  }
+}
+
+RTCCertificatePool::Entry* RTCCertificatePool::FindEntryLocked(
+    const KeyParams& key_params) {
+  for (Entry& entry : entries_) {
+    if (SameKeyParams(entry.key_params, key_params))
+      return &entry;
+  }
+  return nullptr;
+}
+
+void RTCCertificatePool::AddKeyParamsLocked(const KeyParams& key_params) {
+  if (!key_params.IsValid() || FindEntryLocked(key_params))
+    return;
+  entries_.push_back(Entry(key_params));
+}
+
+void RTCCertificatePool::DiscardExpiredLocked(Entry* entry) {
+  const int64_t now = TimeMillis();
+  while (!entry->ready.empty() &&
+         now - entry->ready.front().generated_ms > kMaxCertificateAgeMs) {
+    entry->ready.pop_front();
+    ++stats_.expired;
+  }
+}
+
+}  // namespace rtc
@@ -0,0 +1,108 @@
+/*
+ *  Copyright 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_RTCCERTIFICATEPOOL_H_
+#define WEBRTC_BASE_RTCCERTIFICATEPOOL_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/rtccertificate.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/base/sslidentity.h"
+
+namespace rtc {
+
+// Keeps a few certificates with the default expiration time pre-generated for
+// each KeyParams in use, so that an |RTCCertificateGenerator| given a pool
+// does not have to generate a key when a certificate is requested. RSA key
+// generation in particular can take hundreds of milliseconds.
+//
+// The pool is refilled on its own thread whenever a certificate is taken.
+// Certificates that have been waiting in the pool for longer than
+// kMaxCertificateAgeMs are discarded rather than handed out, so handed out
+// certificates are always valid for close to the default lifetime.
+//
+// All methods may be called from any thread.
+class RTCCertificatePool {
+ public:
+  // Number of certificates kept ready for each KeyParams by default.
+  static const size_t kDefaultSize = 2;
+  static const int64_t kMaxCertificateAgeMs = 24 * 60 * 60 * 1000;
+
+  struct Stats {
+    // Number of Take() calls that returned a certificate.
+    uint64_t hits = 0;
+    // Number of Take() calls that returned null.
+    uint64_t misses = 0;
+    // Number of certificates generated by the pool.
+    uint64_t generated = 0;
+    // Number of certificates discarded for being too old.
+    uint64_t expired = 0;
+    // Number of certificates currently ready, over all KeyParams.
+    size_t ready = 0;
+  };
+
+  RTCCertificatePool();
+  // Keeps |size| certificates ready for each KeyParams.
+  explicit RTCCertificatePool(size_t size);
+  ~RTCCertificatePool();
+
+  // Starts keeping certificates of |key_params| ready. Does nothing if
+  // |key_params| are invalid or already in use.
+  void AddKeyParams(const KeyParams& key_params);
+
+  // Returns a ready certificate of |key_params|, or null if there is none.
+  // KeyParams that haven't been added are added, so later calls hit.
+  scoped_refptr<RTCCertificate> Take(const KeyParams& key_params);
+
+  Stats GetStats() const;
+
+ private:
+  struct ReadyCertificate {
+    scoped_refptr<RTCCertificate> certificate;
+    int64_t generated_ms;
+  };
+  struct Entry {
+    explicit Entry(const KeyParams& key_params) : key_params(key_params) {}
+    KeyParams key_params;
+    std::deque<ReadyCertificate> ready;
+  };
+
+  static bool ThreadFunc(void* param);
+  // Generates certificates until every entry is full. Returns false if the
+  // pool is being destroyed.
+  bool Refill();
+  Entry* FindEntryLocked(const KeyParams& key_params)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void AddKeyParamsLocked(const KeyParams& key_params)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void DiscardExpiredLocked(Entry* entry) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const size_t size_;
+  mutable CriticalSection crit_;
+  std::vector<Entry> entries_ GUARDED_BY(crit_);
+  Stats stats_ GUARDED_BY(crit_);
+  bool stopping_ GUARDED_BY(crit_);
+  Event wake_;
+  PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RTCCertificatePool);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_RTCCERTIFICATEPOOL_H_
@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/rtccertificatepool.h"
+
+#include "webrtc/base/fakeclock.h"
+#include "webrtc/base/gunit.h"
+
+namespace rtc {
+
+namespace {
+
+const int kGenerationTimeoutMs = 10000;
+
+}  // namespace
+
+TEST(RTCCertificatePoolTest, FillsAddedKeyParams) {
+  RTCCertificatePool pool(2);
+  EXPECT_EQ(0u, pool.GetStats().ready);
+  pool.AddKeyParams(KeyParams::ECDSA());
+  EXPECT_EQ_WAIT(2u, pool.GetStats().ready, kGenerationTimeoutMs);
+  EXPECT_EQ(2u, pool.GetStats().generated);
+}
+
+TEST(RTCCertificatePoolTest, TakeHitsAndRefills) {
+  RTCCertificatePool pool(1);
+  pool.AddKeyParams(KeyParams::ECDSA());
+  EXPECT_EQ_WAIT(1u, pool.GetStats().ready, kGenerationTimeoutMs);
+
+  scoped_refptr<RTCCertificate> certificate = pool.Take(KeyParams::ECDSA());
+  ASSERT_TRUE(certificate);
+  RTCCertificatePool::Stats stats = pool.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(0u, stats.misses);
+
+  EXPECT_EQ_WAIT(1u, pool.GetStats().ready, kGenerationTimeoutMs);
+  EXPECT_EQ(2u, pool.GetStats().generated);
+  EXPECT_NE(certificate.get(), pool.Take(KeyParams::ECDSA()).get());
+}
+
+TEST(RTCCertificatePoolTest, TakeOfNewKeyParamsMissesThenHits) {
+  RTCCertificatePool pool(1);
+  EXPECT_FALSE(pool.Take(KeyParams::ECDSA()));
+  EXPECT_EQ(1u, pool.GetStats().misses);
+  EXPECT_EQ_WAIT(1u, pool.GetStats().ready, kGenerationTimeoutMs);
+  EXPECT_TRUE(pool.Take(KeyParams::ECDSA()));
+  EXPECT_EQ(1u, pool.GetStats().hits);
+}
+
+TEST(RTCCertificatePoolTest, KeyParamsAreKeptApart) {
+  RTCCertificatePool pool(1);
+  pool.AddKeyParams(KeyParams::ECDSA());
+  EXPECT_EQ_WAIT(1u, pool.GetStats().ready, kGenerationTimeoutMs);
+  EXPECT_FALSE(pool.Take(KeyParams::RSA()));
+  EXPECT_EQ(1u, pool.GetStats().misses);
+  EXPECT_EQ_WAIT(2u, pool.GetStats().ready, kGenerationTimeoutMs);
+  EXPECT_TRUE(pool.Take(KeyParams::RSA()));
+  EXPECT_TRUE(pool.Take(KeyParams::ECDSA()));
+}
+
+TEST(RTCCertificatePoolTest, InvalidKeyParamsAreIgnored) {
+  RTCCertificatePool pool(1);
+  pool.AddKeyParams(KeyParams::RSA(0));
+  EXPECT_FALSE(pool.Take(KeyParams::RSA(0)));
+  EXPECT_EQ(0u, pool.GetStats().ready);
+  EXPECT_EQ(0u, pool.GetStats().generated);
+}
+
+TEST(RTCCertificatePoolTest, OldCertificatesAreDiscarded) {
+  ScopedFakeClock clock;
+  RTCCertificatePool pool(1);
+  pool.AddKeyParams(KeyParams::ECDSA());
+  EXPECT_EQ_WAIT(1u, pool.GetStats().ready, kGenerationTimeoutMs);
+
+  clock.AdvanceTime(TimeDelta::FromMilliseconds(
+      RTCCertificatePool::kMaxCertificateAgeMs + 1));
+  EXPECT_FALSE(pool.Take(KeyParams::ECDSA()));
+  RTCCertificatePool::Stats stats = pool.GetStats();
+  EXPECT_EQ(1u, stats.expired);
+  EXPECT_EQ(1u, stats.misses);
+  // Replaced with a fresh one.
+  EXPECT_EQ_WAIT(1u, pool.GetStats().ready, kGenerationTimeoutMs);
+  EXPECT_TRUE(pool.Take(KeyParams::ECDSA()));
+}
+
+}  // namespace rtc
@@ -25,6 +25,8 @@
 #include "webrtc/base/win32.h"
 #endif
 
+#include <algorithm>
+
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/socketaddress.h"
@@ -133,6 +135,33 @@ struct SentPacket {
   int64_t send_time_ms;
 };
 
+// A datagram to be sent with Socket::SendToBatch.
+struct SendDatagram {
+  const void* data;
+  size_t size;
+  SocketAddress addr;
+  // If non-zero, |data| holds consecutive datagrams of |segment_size| bytes
+  // each (the last one may be shorter) to the same address. With
+  // OPT_UDP_GSO enabled the kernel splits them (UDP segmentation offload),
+  // otherwise they are sent one by one.
+  size_t segment_size = 0;
+};
+
+// A datagram slot for Socket::RecvFromBatch. |buffer| and |capacity| are set
+// by the caller, the remaining fields are filled in for each datagram
+// received.
+struct RecvDatagram {
+  void* buffer;
+  size_t capacity;
+  size_t size;
+  SocketAddress addr;
+  // The receive time in microseconds, or -1 if not available.
+  int64_t timestamp;
+  // Non-zero if the kernel coalesced several datagrams of the same flow into
+  // |buffer| (see OPT_UDP_GRO). All but the last one are of this size.
+  size_t segment_size;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -157,6 +186,40 @@ class Socket {
                        size_t cb,
                        SocketAddress* paddr,
                        int64_t* timestamp) = 0;
+  // Sends |count| datagrams, with a single system call where supported.
+  // Returns the number of datagrams sent, which is less than |count| if the
+  // socket would block, or -1 if the first datagram could not be sent (see
+  // GetError()). The default implementation calls SendTo for each datagram.
+  virtual int SendToBatch(const SendDatagram* datagrams, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      const SendDatagram& datagram = datagrams[i];
+      size_t segment_size =
+          datagram.segment_size ? datagram.segment_size : datagram.size;
+      const char* data = static_cast<const char*>(datagram.data);
+      for (size_t offset = 0; offset < datagram.size; offset += segment_size) {
+        size_t size = std::min(segment_size, datagram.size - offset);
+        int ret = SendTo(data + offset, size, datagram.addr);
+        if (ret < 0)
+          return i == 0 ? ret : static_cast<int>(i);
+      }
+    }
+    return static_cast<int>(count);
+  }
+  // Receives up to |count| datagrams that are already queued, with a single
+  // system call where supported. Returns the number of datagrams received,
+  // or -1 if none could be received (see GetError()). The default
+  // implementation receives a single datagram with RecvFrom.
+  virtual int RecvFromBatch(RecvDatagram* datagrams, size_t count) {
+    if (count == 0)
+      return 0;
+    int ret = RecvFrom(datagrams[0].buffer, datagrams[0].capacity,
+                       &datagrams[0].addr, &datagrams[0].timestamp);
+    if (ret < 0)
+      return ret;
+    datagrams[0].size = static_cast<size_t>(ret);
+    datagrams[0].segment_size = 0;
+    return 1;
+  }
   virtual int Listen(int backlog) = 0;
   virtual Socket *Accept(SocketAddress *paddr) = 0;
   virtual int Close() = 0;
@@ -186,6 +249,13 @@ class Socket {
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
+    OPT_UDP_GSO,     // Whether SendToBatch may use UDP segmentation offload.
+                     // Setting fails if the kernel doesn't support it.
+    OPT_UDP_GRO,     // Whether the kernel may coalesce received datagrams,
+                     // which are then reported by RecvFromBatch.
+    OPT_REUSEPORT,   // Whether sockets may bind to the same address and port,
+                     // with the kernel spreading incoming packets or
+                     // connections over them. Must be set before Bind.
   };
   virtual int GetOption(Option opt, int* value) = 0;
   virtual int SetOption(Option opt, int value) = 0;
@@ -115,10 +115,16 @@ SSLStreamAdapter::SSLStreamAdapter(StreamInterface* stream)
 
 SSLStreamAdapter::~SSLStreamAdapter() {}
 
+void SSLStreamAdapter::SetSessionResumptionEnabled(bool enabled) {}
+
 bool SSLStreamAdapter::GetSslCipherSuite(int* cipher_suite) {
   return false;
 }
 
+bool SSLStreamAdapter::IsSessionResumed() const {
+  return false;
+}
+
 bool SSLStreamAdapter::ExportKeyingMaterial(const std::string& label,
                                             const uint8_t* context,
                                             size_t context_len,
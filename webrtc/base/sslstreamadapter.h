@@ -150,6 +150,13 @@ class SSLStreamAdapter : public StreamAdapterInterface {
   // next lower will be used.
   virtual void SetMaxProtocolVersion(SSLProtocolVersion version) = 0;
 
+  // Allows a DTLS handshake to resume a session from an earlier connection
+  // between the same local identity and a peer with the same certificate
+  // digest, skipping the key exchange and certificate signature. Resumed
+  // sessions are still checked against the peer certificate digest. Must be
+  // called before StartSSL(). Disabled by default.
+  virtual void SetSessionResumptionEnabled(bool enabled);
+
   // StartSSL starts negotiation with a peer, whose certificate is verified
   // using the certificate digest. Generally, SetIdentity() and possibly
   // SetServerRole() should have been called before this.
@@ -188,6 +195,9 @@ class SSLStreamAdapter : public StreamAdapterInterface {
 
   virtual int GetSslVersion() const = 0;
 
+  // Returns true if the established connection resumed an earlier session.
+  virtual bool IsSessionResumed() const;
+
   // Key Exporter interface from RFC 5705
   // Arguments are:
   // label               -- the exporter label.
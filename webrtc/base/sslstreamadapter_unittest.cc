@@ -313,6 +313,38 @@ class SSLStreamAdapterTestBase : public testing::Test,
     server_ssl_->SetIdentity(server_identity_);
   }
 
+  // Recreate the streams and adapters for a new connection between the same
+  // client and server identities.
+  void ResetStreamsWithSameIdentities() {
+    std::unique_ptr<rtc::SSLIdentity> client_identity(
+        client_identity_->GetReference());
+    std::unique_ptr<rtc::SSLIdentity> server_identity(
+        server_identity_->GetReference());
+    CreateStreams();
+
+    client_ssl_.reset(rtc::SSLStreamAdapter::Create(client_stream_));
+    server_ssl_.reset(rtc::SSLStreamAdapter::Create(server_stream_));
+
+    client_ssl_->SignalEvent.connect(this, &SSLStreamAdapterTestBase::OnEvent);
+    server_ssl_->SignalEvent.connect(this, &SSLStreamAdapterTestBase::OnEvent);
+
+    client_identity_ = client_identity.release();
+    server_identity_ = server_identity.release();
+    client_ssl_->SetIdentity(client_identity_);
+    server_ssl_->SetIdentity(server_identity_);
+    identities_set_ = false;
+  }
+
+  void SetSessionResumptionEnabled(bool enabled) {
+    client_ssl_->SetSessionResumptionEnabled(enabled);
+    server_ssl_->SetSessionResumptionEnabled(enabled);
+  }
+
+  bool IsSessionResumed(bool client) {
+    return client ? client_ssl_->IsSessionResumed()
+                  : server_ssl_->IsSessionResumed();
+  }
+
   virtual void OnEvent(rtc::StreamInterface *stream, int sig, int err) {
     LOG(LS_INFO) << "SSLStreamAdapterTestBase::OnEvent sig=" << sig;
 
@@ -1125,6 +1157,39 @@ TEST_P(SSLStreamAdapterTestDTLS, TestCertExpired) {
   TestHandshake();
 }
 
+// Test that a second connection between the same identities resumes the
+// session of the first one, and still transfers data.
+TEST_P(SSLStreamAdapterTestDTLS, TestDTLSSessionResumption) {
+  MAYBE_SKIP_TEST(HaveDtls);
+  SetSessionResumptionEnabled(true);
+  TestHandshake();
+  EXPECT_FALSE(IsSessionResumed(true));
+  EXPECT_FALSE(IsSessionResumed(false));
+
+  ResetStreamsWithSameIdentities();
+  SetSessionResumptionEnabled(true);
+  TestHandshake();
+  EXPECT_TRUE(IsSessionResumed(true));
+  EXPECT_TRUE(IsSessionResumed(false));
+  // The peer certificates are known even though they weren't sent.
+  EXPECT_TRUE(GetPeerCertificate(true));
+  EXPECT_TRUE(GetPeerCertificate(false));
+  TestTransfer(100);
+}
+
+// Test that sessions aren't resumed unless both sides enable it.
+TEST_P(SSLStreamAdapterTestDTLS, TestDTLSSessionResumptionDisabled) {
+  MAYBE_SKIP_TEST(HaveDtls);
+  SetSessionResumptionEnabled(true);
+  TestHandshake();
+
+  ResetStreamsWithSameIdentities();
+  client_ssl_->SetSessionResumptionEnabled(true);
+  TestHandshake();
+  EXPECT_FALSE(IsSessionResumed(true));
+  EXPECT_FALSE(IsSessionResumed(false));
+}
+
 // Test data transfer using certs created from strings.
 TEST_F(SSLStreamAdapterTestDTLSFromPEMStrings, TestTransfer) {
   MAYBE_SKIP_TEST(HaveDtls);
@@ -12,9 +12,11 @@
 #define WEBRTC_BASE_SWAP_QUEUE_H_
 
 #include <algorithm>
+#include <limits>
 #include <utility>
 #include <vector>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
@@ -206,6 +208,305 @@ class SwapQueue {
   RTC_DISALLOW_COPY_AND_ASSIGN(SwapQueue);
 };
 
+// Variant of SwapQueue for exactly one producer thread and one consumer
+// thread, e.g. a real-time audio thread handing data to another one. Insert()
+// and Remove() never block and never take a lock: the slots between the read
+// and write indices are owned by one side at a time, and ownership moves with
+// the atomic element count. Clear() must not run concurrently with Insert() or
+// Remove().
+template <typename T, typename QueueItemVerifier = SwapQueueItemVerifier<T>>
+class SpscSwapQueue {
+ public:
+  // Creates a queue of size size and fills it with default constructed Ts.
+  explicit SpscSwapQueue(size_t size) : queue_(size) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Same as above and accepts an item verification functor.
+  SpscSwapQueue(size_t size, const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier), queue_(size) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Creates a queue of size size and fills it with copies of prototype.
+  SpscSwapQueue(size_t size, const T& prototype) : queue_(size, prototype) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Same as above and accepts an item verification functor.
+  SpscSwapQueue(size_t size,
+                const T& prototype,
+                const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier), queue_(size, prototype) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Resets the queue to have zero content while maintaining the queue size.
+  void Clear() {
+    next_write_index_ = 0;
+    next_read_index_ = 0;
+    rtc::AtomicOps::ReleaseStore(&num_elements_, 0);
+  }
+
+  // Same contract as SwapQueue::Insert(). Must only be called by the
+  // producer.
+  bool Insert(T* input) WARN_UNUSED_RESULT {
+    RTC_DCHECK(input);
+    RTC_DCHECK(queue_item_verifier_(*input));
+
+    if (static_cast<size_t>(rtc::AtomicOps::AcquireLoad(&num_elements_)) ==
+        queue_.size()) {
+      return false;
+    }
+
+    using std::swap;
+    swap(*input, queue_[next_write_index_]);
+
+    ++next_write_index_;
+    if (next_write_index_ == queue_.size()) {
+      next_write_index_ = 0;
+    }
+
+    // Hands the slot over to the consumer.
+    rtc::AtomicOps::Increment(&num_elements_);
+
+    RTC_DCHECK_LT(next_write_index_, queue_.size());
+    return true;
+  }
+
+  // Same contract as SwapQueue::Remove(). Must only be called by the
+  // consumer.
+  bool Remove(T* output) WARN_UNUSED_RESULT {
+    RTC_DCHECK(output);
+    RTC_DCHECK(queue_item_verifier_(*output));
+
+    if (rtc::AtomicOps::AcquireLoad(&num_elements_) == 0) {
+      return false;
+    }
+
+    using std::swap;
+    swap(*output, queue_[next_read_index_]);
+
+    ++next_read_index_;
+    if (next_read_index_ == queue_.size()) {
+      next_read_index_ = 0;
+    }
+
+    // Hands the slot back to the producer.
+    rtc::AtomicOps::Decrement(&num_elements_);
+
+    RTC_DCHECK_LT(next_read_index_, queue_.size());
+    return true;
+  }
+
+ private:
+  // Verify that the queue slots complies with the ItemVerifier test.
+  bool VerifyQueueSlots() {
+    for (const auto& v : queue_) {
+      RTC_DCHECK(queue_item_verifier_(v));
+    }
+    return true;
+  }
+
+  QueueItemVerifier queue_item_verifier_;
+
+  // Only accessed by the producer.
+  size_t next_write_index_ = 0;
+  // Only accessed by the consumer.
+  size_t next_read_index_ = 0;
+  // Number of slots owned by the consumer.
+  volatile int num_elements_ = 0;
+
+  // queue_.size() is constant.
+  std::vector<T> queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SpscSwapQueue);
+};
+
+// Variant of SwapQueue for any number of producer threads and exactly one
+// consumer thread, e.g. several threads logging events that one thread writes
+// out. Neither side takes a lock: producers claim a slot with a
+// compare-and-swap on the write position, retried only when another producer
+// claimed it first, and the consumer never retries. Each slot has a sequence
+// number telling whose turn it is, so an element is only visible to the
+// consumer once the producer that claimed its slot has filled it; until then
+// Remove() returns false even if later slots are filled. Clear() must not run
+// concurrently with Insert() or Remove().
+template <typename T, typename QueueItemVerifier = SwapQueueItemVerifier<T>>
+class MpscSwapQueue {
+ public:
+  // Creates a queue of size size and fills it with default constructed Ts.
+  explicit MpscSwapQueue(size_t size) : queue_(size), slots_(size) {
+    Init();
+  }
+
+  // Same as above and accepts an item verification functor.
+  MpscSwapQueue(size_t size, const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier),
+        queue_(size),
+        slots_(size) {
+    Init();
+  }
+
+  // Creates a queue of size size and fills it with copies of prototype.
+  MpscSwapQueue(size_t size, const T& prototype)
+      : queue_(size, prototype), slots_(size) {
+    Init();
+  }
+
+  // Same as above and accepts an item verification functor.
+  MpscSwapQueue(size_t size,
+                const T& prototype,
+                const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier),
+        queue_(size, prototype),
+        slots_(size) {
+    Init();
+  }
+
+  // Resets the queue to have zero content while maintaining the queue size.
+  void Clear() {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      rtc::AtomicOps::ReleaseStore(&slots_[i].sequence,
+                                   static_cast<int>(2 * i));
+    }
+    next_read_position_ = 0;
+    rtc::AtomicOps::ReleaseStore(&next_write_position_, 0);
+  }
+
+  // Same contract as SwapQueue::Insert(). May be called concurrently by
+  // several producers.
+  bool Insert(T* input) WARN_UNUSED_RESULT {
+    RTC_DCHECK(input);
+    RTC_DCHECK(queue_item_verifier_(*input));
+
+    if (queue_.empty()) {
+      return false;
+    }
+
+    int position = rtc::AtomicOps::AcquireLoad(&next_write_position_);
+    while (true) {
+      int distance = SequenceDistance(
+          rtc::AtomicOps::AcquireLoad(&slots_[Index(position)].sequence),
+          2 * position);
+      if (distance < 0) {
+        // The slot still holds the element from the previous lap.
+        return false;
+      }
+      if (distance == 0) {
+        int previous = rtc::AtomicOps::CompareAndSwap(
+            &next_write_position_, position, NextPosition(position, 1));
+        if (previous == position) {
+          break;
+        }
+        position = previous;
+      } else {
+        // Another producer has filled the slot since |position| was read.
+        position = rtc::AtomicOps::AcquireLoad(&next_write_position_);
+      }
+    }
+
+    using std::swap;
+    swap(*input, queue_[Index(position)]);
+
+    // Hands the slot over to the consumer.
+    rtc::AtomicOps::ReleaseStore(&slots_[Index(position)].sequence,
+                                 2 * position + 1);
+    return true;
+  }
+
+  // Same contract as SwapQueue::Remove(). Must only be called by the
+  // consumer.
+  bool Remove(T* output) WARN_UNUSED_RESULT {
+    RTC_DCHECK(output);
+    RTC_DCHECK(queue_item_verifier_(*output));
+
+    if (queue_.empty()) {
+      return false;
+    }
+
+    const size_t index = Index(next_read_position_);
+    int distance =
+        SequenceDistance(rtc::AtomicOps::AcquireLoad(&slots_[index].sequence),
+                         2 * next_read_position_ + 1);
+    if (distance != 0) {
+      RTC_DCHECK_LT(distance, 0);
+      return false;
+    }
+
+    using std::swap;
+    swap(*output, queue_[index]);
+
+    // Hands the slot back to the producers, for the next lap.
+    rtc::AtomicOps::ReleaseStore(
+        &slots_[index].sequence,
+        2 * NextPosition(next_read_position_, queue_.size()));
+    next_read_position_ = NextPosition(next_read_position_, 1);
+    return true;
+  }
+
+ private:
+  struct Slot {
+    // 2 * position when the slot is free for the producer claiming
+    // |position|, 2 * position + 1 once that producer has filled it.
+    volatile int sequence;
+  };
+
+  void Init() {
+    // Positions count modulo |wrap_|, a multiple of the size so that the slot
+    // index of consecutive positions stays consecutive across the wrap, and
+    // small enough for twice the position to fit in an int.
+    wrap_ = queue_.empty()
+                ? 1
+                : static_cast<int>(
+                      (std::numeric_limits<int>::max() / 4 / queue_.size()) *
+                      queue_.size());
+    RTC_CHECK_GT(wrap_, 0);
+    Clear();
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  size_t Index(int position) const { return position % queue_.size(); }
+
+  int NextPosition(int position, size_t steps) const {
+    return static_cast<int>((position + steps) % wrap_);
+  }
+
+  // Signed distance of |sequence| from |expected|, modulo the sequence range.
+  int SequenceDistance(int sequence, int expected) const {
+    const int range = 2 * wrap_;
+    int distance = sequence - expected;
+    if (distance > range / 2) {
+      distance -= range;
+    } else if (distance < -range / 2) {
+      distance += range;
+    }
+    return distance;
+  }
+
+  // Verify that the queue slots complies with the ItemVerifier test.
+  bool VerifyQueueSlots() {
+    for (const auto& v : queue_) {
+      RTC_DCHECK(queue_item_verifier_(v));
+    }
+    return true;
+  }
+
+  QueueItemVerifier queue_item_verifier_;
+
+  int wrap_ = 1;
+  // Claimed by the producers with compare-and-swap.
+  volatile int next_write_position_ = 0;
+  // Only accessed by the consumer.
+  int next_read_position_ = 0;
+
+  // queue_.size() and slots_.size() are constant.
+  std::vector<T> queue_;
+  std::vector<Slot> slots_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MpscSwapQueue);
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_BASE_SWAP_QUEUE_H_
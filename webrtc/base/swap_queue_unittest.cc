@@ -10,9 +10,14 @@
 
 #include "webrtc/base/swap_queue.h"
 
+#include <stdio.h>
+
+#include <memory>
 #include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/timeutils.h"
 
 namespace webrtc {
 
@@ -39,6 +44,85 @@ class LengthVerifierFunctor {
   size_t length_;
 };
 
+// Producer for the concurrent SpscSwapQueue test. Inserts the chunks
+// {k, k, k} for k = 0, 1, ... until kNumChunks have been inserted.
+const int kNumChunks = 10000;
+
+struct SpscProducerState {
+  SpscSwapQueue<std::vector<int>>* queue;
+  int next_chunk;
+};
+
+bool SpscProducer(void* obj) {
+  SpscProducerState* state = static_cast<SpscProducerState*>(obj);
+  std::vector<int> chunk(kChunkSize, state->next_chunk);
+  while (state->next_chunk < kNumChunks) {
+    if (state->queue->Insert(&chunk))
+      chunk.assign(kChunkSize, ++state->next_chunk);
+  }
+  return false;
+}
+
+// Producer for the concurrent MpscSwapQueue tests. Inserts |num_chunks|
+// chunks {id, k, k} for k = 0, 1, ..., with the id of the producer first.
+template <typename Queue>
+struct MultiProducerState {
+  Queue* queue;
+  int id;
+  int num_chunks;
+};
+
+template <typename Queue>
+bool MultiProducer(void* obj) {
+  MultiProducerState<Queue>* state =
+      static_cast<MultiProducerState<Queue>*>(obj);
+  std::vector<int> chunk(kChunkSize);
+  for (int k = 0; k < state->num_chunks;) {
+    chunk[0] = state->id;
+    chunk[1] = chunk[2] = k;
+    if (state->queue->Insert(&chunk))
+      ++k;
+  }
+  return false;
+}
+
+// Runs |num_producers| producers of |num_chunks| each into |queue| and checks
+// that the chunks of each arrive complete and in order. Returns the time it
+// took in ms.
+template <typename Queue>
+int64_t RunProducers(Queue* queue, int num_producers, int num_chunks) {
+  std::vector<MultiProducerState<Queue>> states(num_producers);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> producers;
+  const int64_t start_ms = rtc::TimeMillis();
+  for (int i = 0; i < num_producers; ++i) {
+    states[i] = {queue, i, num_chunks};
+    producers.emplace_back(new rtc::PlatformThread(&MultiProducer<Queue>,
+                                                   &states[i], "Producer"));
+    producers.back()->Start();
+  }
+
+  std::vector<int> next_chunk(num_producers, 0);
+  std::vector<int> chunk(kChunkSize);
+  for (int received = 0; received < num_producers * num_chunks;) {
+    if (!queue->Remove(&chunk))
+      continue;
+    ++received;
+    EXPECT_EQ(kChunkSize, chunk.size());
+    const int id = chunk[0];
+    EXPECT_GE(id, 0);
+    EXPECT_LT(id, num_producers);
+    if (id < 0 || id >= num_producers)
+      continue;
+    EXPECT_EQ(next_chunk[id], chunk[1]);
+    EXPECT_EQ(next_chunk[id], chunk[2]);
+    ++next_chunk[id];
+  }
+  for (auto& producer : producers)
+    producer->Stop();
+  EXPECT_FALSE(queue->Remove(&chunk));
+  return rtc::TimeMillis() - start_ms;
+}
+
 }  // anonymous namespace
 
 TEST(SwapQueueTest, BasicOperation) {
@@ -222,4 +306,141 @@ TEST(SwapQueueTest, OneSlotQueue) {
   EXPECT_FALSE(queue.Remove(&i));
 }
 
+TEST(SpscSwapQueueTest, FullAndEmptyQueue) {
+  SpscSwapQueue<int> queue(2);
+  int i = 0;
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  i = 1;
+  EXPECT_TRUE(queue.Insert(&i));
+  i = 2;
+  EXPECT_FALSE(queue.Insert(&i));
+  EXPECT_EQ(i, 2);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i, 0);
+  // The freed slot can be reused while the other one is still queued.
+  i = 3;
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i, 1);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i, 3);
+  EXPECT_FALSE(queue.Remove(&i));
+}
+
+TEST(SpscSwapQueueTest, Clear) {
+  SpscSwapQueue<int> queue(2);
+  int i = 0;
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Insert(&i));
+  queue.Clear();
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+}
+
+TEST(SpscSwapQueueTest, ZeroSlotQueue) {
+  SpscSwapQueue<int> queue(0);
+  int i = 42;
+  EXPECT_FALSE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_EQ(i, 42);
+}
+
+TEST(SpscSwapQueueTest, ConcurrentProducerAndConsumer) {
+  SpscSwapQueue<std::vector<int>> queue(128, std::vector<int>(kChunkSize));
+  SpscProducerState state = {&queue, 0};
+  rtc::PlatformThread producer(&SpscProducer, &state, "SpscProducer");
+  producer.Start();
+
+  // Every chunk must arrive once, complete and in order.
+  std::vector<int> chunk(kChunkSize);
+  int expected_chunk = 0;
+  while (expected_chunk < kNumChunks) {
+    if (!queue.Remove(&chunk))
+      continue;
+    EXPECT_EQ(kChunkSize, chunk.size());
+    for (int value : chunk)
+      EXPECT_EQ(expected_chunk, value);
+    ++expected_chunk;
+  }
+  producer.Stop();
+  EXPECT_FALSE(queue.Remove(&chunk));
+}
+
+TEST(MpscSwapQueueTest, FullAndEmptyQueue) {
+  MpscSwapQueue<int> queue(2);
+  int i = 0;
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  i = 1;
+  EXPECT_TRUE(queue.Insert(&i));
+  i = 2;
+  EXPECT_FALSE(queue.Insert(&i));
+  EXPECT_EQ(i, 2);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i, 0);
+  // The freed slot can be reused while the other one is still queued.
+  i = 3;
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i, 1);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i, 3);
+  EXPECT_FALSE(queue.Remove(&i));
+}
+
+TEST(MpscSwapQueueTest, OneSlotQueue) {
+  MpscSwapQueue<int> queue(1);
+  for (int k = 0; k < 3; ++k) {
+    int i = k;
+    EXPECT_TRUE(queue.Insert(&i));
+    EXPECT_FALSE(queue.Insert(&i));
+    EXPECT_TRUE(queue.Remove(&i));
+    EXPECT_EQ(i, k);
+    EXPECT_FALSE(queue.Remove(&i));
+  }
+}
+
+TEST(MpscSwapQueueTest, Clear) {
+  MpscSwapQueue<int> queue(2);
+  int i = 0;
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Insert(&i));
+  queue.Clear();
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+}
+
+TEST(MpscSwapQueueTest, ZeroSlotQueue) {
+  MpscSwapQueue<int> queue(0);
+  int i = 42;
+  EXPECT_FALSE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_EQ(i, 42);
+}
+
+TEST(MpscSwapQueueTest, ConcurrentProducers) {
+  MpscSwapQueue<std::vector<int>> queue(128, std::vector<int>(kChunkSize));
+  RunProducers(&queue, 4, kNumChunks / 10);
+}
+
+// Compares the time it takes several producers to hand chunks to one
+// consumer through the lock-based and the lock-free queue.
+TEST(MpscSwapQueueTest, DISABLED_ContentionAgainstSwapQueue) {
+  for (int num_producers = 1; num_producers <= 8; num_producers *= 2) {
+    SwapQueue<std::vector<int>> locked_queue(128, std::vector<int>(kChunkSize));
+    MpscSwapQueue<std::vector<int>> lock_free_queue(
+        128, std::vector<int>(kChunkSize));
+    int64_t locked_ms =
+        RunProducers(&locked_queue, num_producers, kNumChunks * 10);
+    int64_t lock_free_ms =
+        RunProducers(&lock_free_queue, num_producers, kNumChunks * 10);
+    printf("%d producers: SwapQueue %d ms, MpscSwapQueue %d ms\n",
+           num_producers, static_cast<int>(locked_ms),
+           static_cast<int>(lock_free_ms));
+  }
+}
+
 }  // namespace webrtc
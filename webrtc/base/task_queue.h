@@ -11,9 +11,12 @@
 #ifndef WEBRTC_BASE_TASK_QUEUE_H_
 #define WEBRTC_BASE_TASK_QUEUE_H_
 
+#include <deque>
 #include <list>
 #include <memory>
+#include <set>
 #include <unordered_map>
+#include <vector>
 
 #if defined(WEBRTC_MAC) && !defined(WEBRTC_BUILD_LIBEVENT)
 #include <dispatch/dispatch.h>
@@ -27,6 +30,8 @@
 #endif
 
 #if defined(WEBRTC_BUILD_LIBEVENT)
+#include "webrtc/base/event.h"
+
 struct event_base;
 struct event;
 #endif
@@ -96,6 +101,82 @@ static std::unique_ptr<QueuedTask> NewClosure(const Closure& closure,
       new ClosureTaskWithCleanup<Closure, Cleanup>(closure, cleanup));
 }
 
+#if defined(WEBRTC_BUILD_LIBEVENT)
+class TaskQueue;
+
+// A fixed set of worker threads that can be shared by many TaskQueues, so
+// that the number of OS threads does not grow with the number of queues.
+// A TaskQueue constructed with a pool keeps its guarantees: its tasks run in
+// FIFO order and never overlap, and TaskQueue::Current() and IsCurrent() work
+// as usual, but consecutive tasks may run on different worker threads.
+// A worker runs a limited number of tasks from one queue before moving on to
+// the next, so a busy queue can't starve the others.
+class TaskQueuePool {
+ public:
+  struct Stats {
+    size_t num_threads = 0;
+    size_t num_queues = 0;
+    // Tasks that are ready to run but haven't started, summed over queues.
+    size_t pending_tasks = 0;
+    // The largest number of ready tasks waiting on a single queue.
+    size_t max_queue_depth = 0;
+    // Delayed tasks whose time hasn't come yet.
+    size_t delayed_tasks = 0;
+    uint64_t tasks_run = 0;
+    // Time from when a task became ready to run until it started running.
+    int64_t total_latency_us = 0;
+    int64_t max_latency_us = 0;
+  };
+
+  // Starts |num_threads| worker threads, or one per core if |num_threads| is
+  // 0.
+  explicit TaskQueuePool(size_t num_threads);
+  // All TaskQueues using the pool must have been destroyed.
+  ~TaskQueuePool();
+
+  size_t num_threads() const { return threads_.size(); }
+  Stats GetStats() const;
+
+ private:
+  friend class TaskQueue;
+  struct PooledQueue;
+  struct DelayedTask;
+
+  static bool ThreadMain(void* context);
+  void RunWorker();
+  void RunQueue(PooledQueue* queue);
+
+  PooledQueue* AddQueue(TaskQueue* queue);
+  // Drops the queue's pending tasks and waits for a running task to finish.
+  void RemoveQueue(PooledQueue* queue);
+  void PostTask(PooledQueue* queue, std::unique_ptr<QueuedTask> task);
+  void PostDelayedTask(PooledQueue* queue,
+                       std::unique_ptr<QueuedTask> task,
+                       uint32_t milliseconds);
+
+  void EnqueueLocked(PooledQueue* queue, std::unique_ptr<QueuedTask> task)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Moves delayed tasks that are due to their queues and returns the time
+  // until the next one is, or Event::kForever.
+  int PromoteDelayedTasksLocked() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  std::vector<std::unique_ptr<PlatformThread>> threads_;
+  // Wakes up one worker. A worker that takes a queue while others are still
+  // runnable passes the wakeup on.
+  Event wakeup_;
+  CriticalSection crit_;
+  bool quit_ GUARDED_BY(crit_);
+  std::set<PooledQueue*> queues_ GUARDED_BY(crit_);
+  std::deque<PooledQueue*> runnable_ GUARDED_BY(crit_);
+  // A heap ordered by due time, see DelayedTask::operator<.
+  std::vector<DelayedTask> delayed_ GUARDED_BY(crit_);
+  uint64_t next_delayed_seq_ GUARDED_BY(crit_);
+  Stats stats_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(TaskQueuePool);
+};
+#endif  // defined(WEBRTC_BUILD_LIBEVENT)
+
 // Implements a task queue that asynchronously executes tasks in a way that
 // guarantees that they're executed in FIFO order and that tasks never overlap.
 // Tasks may always execute on the same worker thread and they may not.
@@ -159,6 +240,11 @@ static std::unique_ptr<QueuedTask> NewClosure(const Closure& closure,
 class LOCKABLE TaskQueue {
  public:
   explicit TaskQueue(const char* queue_name);
+#if defined(WEBRTC_BUILD_LIBEVENT)
+  // Runs the queue's tasks on the threads of |pool| instead of on a thread of
+  // its own. |pool| must outlive the queue.
+  TaskQueue(const char* queue_name, TaskQueuePool* pool);
+#endif
   // TODO(tommi): Implement move semantics?
   ~TaskQueue();
 
@@ -226,6 +312,8 @@ class LOCKABLE TaskQueue {
 
  private:
 #if defined(WEBRTC_BUILD_LIBEVENT)
+  friend class TaskQueuePool;
+
   static bool ThreadMain(void* context);
   static void OnWakeup(int socket, short flags, void* context);  // NOLINT
   static void RunTask(int fd, short flags, void* context);       // NOLINT
@@ -247,6 +335,10 @@ class LOCKABLE TaskQueue {
   rtc::CriticalSection pending_lock_;
   std::list<std::unique_ptr<QueuedTask>> pending_ GUARDED_BY(pending_lock_);
   std::list<PostAndReplyTask*> pending_replies_ GUARDED_BY(pending_lock_);
+  // Set if the queue runs on a TaskQueuePool, in which case none of the
+  // libevent state above is used.
+  TaskQueuePool* const pool_ = nullptr;
+  TaskQueuePool::PooledQueue* pooled_queue_ = nullptr;
 #elif defined(WEBRTC_MAC)
   struct QueueContext;
   struct TaskContext;
@@ -14,9 +14,13 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include "base/third_party/libevent/event.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/systeminfo.h"
 #include "webrtc/base/task_queue_posix.h"
 #include "webrtc/base/timeutils.h"
 
@@ -28,6 +32,10 @@ namespace {
 static const char kQuit = 1;
 static const char kRunTask = 2;
 
+// Number of tasks a pool worker runs from one queue before it lets other
+// queues have a turn.
+static const int kMaxTasksPerSlice = 16;
+
 struct TimerEvent {
   explicit TimerEvent(std::unique_ptr<QueuedTask> task)
       : task(std::move(task)) {}
@@ -150,8 +158,27 @@ TaskQueue::TaskQueue(const char* queue_name)
   thread_.Start();
 }
 
+TaskQueue::TaskQueue(const char* queue_name, TaskQueuePool* pool)
+    : event_base_(nullptr),
+      thread_(&TaskQueue::ThreadMain, this, queue_name),
+      pool_(pool) {
+  RTC_DCHECK(queue_name);
+  RTC_DCHECK(pool);
+  pooled_queue_ = pool_->AddQueue(this);
+}
+
 TaskQueue::~TaskQueue() {
   RTC_DCHECK(!IsCurrent());
+  if (pool_) {
+    pool_->RemoveQueue(pooled_queue_);
+    pooled_queue_ = nullptr;
+    CritScope lock(&pending_lock_);
+    for (auto* reply : pending_replies_)
+      reply->OnReplyQueueGone();
+    pending_replies_.clear();
+    return;
+  }
+
   struct timespec ts;
   char message = kQuit;
   while (write(wakeup_pipe_in_, &message, sizeof(message)) != sizeof(message)) {
@@ -196,11 +223,17 @@ bool TaskQueue::IsCurrent(const char* queue_name) {
 }
 
 bool TaskQueue::IsCurrent() const {
+  if (pool_)
+    return Current() == this;
   return IsThreadRefEqual(thread_.GetThreadRef(), CurrentThreadRef());
 }
 
 void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
   RTC_DCHECK(task.get());
+  if (pool_) {
+    pool_->PostTask(pooled_queue_, std::move(task));
+    return;
+  }
   // libevent isn't thread safe.  This means that we can't use methods such
   // as event_base_once to post tasks to the worker thread from a different
   // thread.  However, we can use it when posting from the worker thread itself.
@@ -228,7 +261,9 @@ void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
 
 void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                 uint32_t milliseconds) {
-  if (IsCurrent()) {
+  if (pool_) {
+    pool_->PostDelayedTask(pooled_queue_, std::move(task), milliseconds);
+  } else if (IsCurrent()) {
     TimerEvent* timer = new TimerEvent(std::move(task));
     EventAssign(&timer->ev, event_base_, -1, 0, &TaskQueue::RunTimer, timer);
     QueueContext* ctx =
@@ -333,4 +368,233 @@ void TaskQueue::ReplyTaskDone(PostAndReplyTask* reply_task) {
   pending_replies_.remove(reply_task);
 }
 
+struct TaskQueuePool::PooledQueue {
+  explicit PooledQueue(TaskQueue* queue) : context(queue), idle(true, true) {}
+
+  struct PendingTask {
+    std::unique_ptr<QueuedTask> task;
+    // When the task became ready to run, for the latency stats.
+    int64_t ready_us;
+  };
+
+  // Installed as the current queue while one of its tasks runs.
+  TaskQueue::QueueContext context;
+  std::deque<PendingTask> tasks;
+  // True while the queue is in |runnable_| or a worker is running it.
+  bool scheduled = false;
+  bool running = false;
+  bool removed = false;
+  // Signaled when no worker is running the queue.
+  Event idle;
+};
+
+struct TaskQueuePool::DelayedTask {
+  // Orders the heap so that the earliest task is on top, with ties broken in
+  // posting order.
+  bool operator<(const DelayedTask& o) const {
+    return run_at_ms > o.run_at_ms ||
+           (run_at_ms == o.run_at_ms && seq > o.seq);
+  }
+
+  int64_t run_at_ms;
+  uint64_t seq;
+  PooledQueue* queue;
+  std::unique_ptr<QueuedTask> task;
+};
+
+TaskQueuePool::TaskQueuePool(size_t num_threads)
+    : wakeup_(false, false), quit_(false), next_delayed_seq_(0) {
+  if (num_threads == 0)
+    num_threads = std::max(1, SystemInfo::GetMaxCpus());
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(
+        new PlatformThread(&TaskQueuePool::ThreadMain, this, "TaskQueuePool"));
+    threads_.back()->Start();
+  }
+}
+
+TaskQueuePool::~TaskQueuePool() {
+  {
+    CritScope lock(&crit_);
+    RTC_DCHECK(queues_.empty());
+    quit_ = true;
+  }
+  wakeup_.Set();
+  for (auto& thread : threads_)
+    thread->Stop();
+}
+
+TaskQueuePool::Stats TaskQueuePool::GetStats() const {
+  CritScope lock(&crit_);
+  Stats stats = stats_;
+  stats.num_threads = threads_.size();
+  stats.num_queues = queues_.size();
+  stats.delayed_tasks = delayed_.size();
+  for (const PooledQueue* queue : queues_) {
+    stats.pending_tasks += queue->tasks.size();
+    stats.max_queue_depth =
+        std::max(stats.max_queue_depth, queue->tasks.size());
+  }
+  return stats;
+}
+
+// static
+bool TaskQueuePool::ThreadMain(void* context) {
+  static_cast<TaskQueuePool*>(context)->RunWorker();
+  return false;
+}
+
+void TaskQueuePool::RunWorker() {
+  while (true) {
+    PooledQueue* queue = nullptr;
+    int wait_ms;
+    {
+      CritScope lock(&crit_);
+      if (quit_) {
+        // Pass the wakeup on to the next worker.
+        wakeup_.Set();
+        return;
+      }
+      wait_ms = PromoteDelayedTasksLocked();
+      if (!runnable_.empty()) {
+        queue = runnable_.front();
+        runnable_.pop_front();
+        queue->running = true;
+        queue->idle.Reset();
+        if (!runnable_.empty())
+          wakeup_.Set();
+      }
+    }
+    if (queue) {
+      RunQueue(queue);
+    } else {
+      wakeup_.Wait(wait_ms);
+    }
+  }
+}
+
+void TaskQueuePool::RunQueue(PooledQueue* queue) {
+  pthread_setspecific(GetQueuePtrTls(), &queue->context);
+  for (int i = 0; i < kMaxTasksPerSlice; ++i) {
+    std::unique_ptr<QueuedTask> task;
+    {
+      CritScope lock(&crit_);
+      if (queue->removed || queue->tasks.empty())
+        break;
+      PooledQueue::PendingTask& pending = queue->tasks.front();
+      int64_t latency_us = TimeMicros() - pending.ready_us;
+      ++stats_.tasks_run;
+      stats_.total_latency_us += latency_us;
+      stats_.max_latency_us = std::max(stats_.max_latency_us, latency_us);
+      task = std::move(pending.task);
+      queue->tasks.pop_front();
+    }
+    if (!task->Run())
+      task.release();
+  }
+  pthread_setspecific(GetQueuePtrTls(), nullptr);
+
+  bool wake = false;
+  {
+    CritScope lock(&crit_);
+    queue->running = false;
+    if (!queue->removed) {
+      if (queue->tasks.empty()) {
+        queue->scheduled = false;
+      } else {
+        runnable_.push_back(queue);
+        wake = true;
+      }
+    }
+    // |queue| may be deleted as soon as this is signaled.
+    queue->idle.Set();
+  }
+  if (wake)
+    wakeup_.Set();
+}
+
+TaskQueuePool::PooledQueue* TaskQueuePool::AddQueue(TaskQueue* queue) {
+  PooledQueue* pooled_queue = new PooledQueue(queue);
+  CritScope lock(&crit_);
+  queues_.insert(pooled_queue);
+  return pooled_queue;
+}
+
+void TaskQueuePool::RemoveQueue(PooledQueue* queue) {
+  std::deque<PooledQueue::PendingTask> dropped_tasks;
+  std::vector<DelayedTask> dropped_timers;
+  {
+    CritScope lock(&crit_);
+    queue->removed = true;
+    queues_.erase(queue);
+    runnable_.erase(std::remove(runnable_.begin(), runnable_.end(), queue),
+                    runnable_.end());
+    dropped_tasks.swap(queue->tasks);
+    auto it = std::partition(delayed_.begin(), delayed_.end(),
+                             [queue](const DelayedTask& delayed) {
+                               return delayed.queue != queue;
+                             });
+    std::move(it, delayed_.end(), std::back_inserter(dropped_timers));
+    delayed_.erase(it, delayed_.end());
+    std::make_heap(delayed_.begin(), delayed_.end());
+  }
+  // Wait for a task that is already running to finish.
+  queue->idle.Wait(Event::kForever);
+  delete queue;
+  // |dropped_tasks| and |dropped_timers| are deleted outside of the lock, in
+  // case their destructors post tasks.
+}
+
+void TaskQueuePool::PostTask(PooledQueue* queue,
+                             std::unique_ptr<QueuedTask> task) {
+  {
+    CritScope lock(&crit_);
+    EnqueueLocked(queue, std::move(task));
+  }
+  wakeup_.Set();
+}
+
+void TaskQueuePool::PostDelayedTask(PooledQueue* queue,
+                                    std::unique_ptr<QueuedTask> task,
+                                    uint32_t milliseconds) {
+  {
+    CritScope lock(&crit_);
+    DelayedTask delayed;
+    delayed.run_at_ms = TimeMillis() + milliseconds;
+    delayed.seq = next_delayed_seq_++;
+    delayed.queue = queue;
+    delayed.task = std::move(task);
+    delayed_.push_back(std::move(delayed));
+    std::push_heap(delayed_.begin(), delayed_.end());
+  }
+  // Let a waiting worker recompute its timeout.
+  wakeup_.Set();
+}
+
+void TaskQueuePool::EnqueueLocked(PooledQueue* queue,
+                                  std::unique_ptr<QueuedTask> task) {
+  RTC_DCHECK(!queue->removed);
+  PooledQueue::PendingTask pending;
+  pending.task = std::move(task);
+  pending.ready_us = TimeMicros();
+  queue->tasks.push_back(std::move(pending));
+  if (!queue->scheduled) {
+    queue->scheduled = true;
+    runnable_.push_back(queue);
+  }
+}
+
+int TaskQueuePool::PromoteDelayedTasksLocked() {
+  int64_t now = TimeMillis();
+  while (!delayed_.empty()) {
+    if (delayed_.front().run_at_ms > now)
+      return static_cast<int>(delayed_.front().run_at_ms - now);
+    std::pop_heap(delayed_.begin(), delayed_.end());
+    DelayedTask& delayed = delayed_.back();
+    EnqueueLocked(delayed.queue, std::move(delayed.task));
+    delayed_.pop_back();
+  }
+  return Event::kForever;
+}
+
 }  // namespace rtc
@@ -11,6 +11,7 @@
 #include <memory>
 #include <vector>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/bind.h"
 #include "webrtc/base/event.h"
 #include "webrtc/base/gunit.h"
@@ -255,4 +256,149 @@ TEST(TaskQueueTest, PostALot) {
   EXPECT_EQ(kTaskCount, tasks_cleaned_up);
 }
 
+#if defined(WEBRTC_BUILD_LIBEVENT)
+TEST(TaskQueuePoolTest, PostAndCheckCurrent) {
+  static const char kQueueName[] = "PooledPostAndCheckCurrent";
+  TaskQueuePool pool(2);
+  TaskQueue queue(kQueueName, &pool);
+  EXPECT_FALSE(queue.IsCurrent());
+  EXPECT_FALSE(TaskQueue::Current());
+
+  Event event(false, false);
+  queue.PostTask(Bind(&CheckCurrent, kQueueName, &event, &queue));
+  EXPECT_TRUE(event.Wait(1000));
+}
+
+TEST(TaskQueuePoolTest, DefaultsToOneThreadPerCore) {
+  TaskQueuePool pool(0);
+  EXPECT_GE(pool.num_threads(), 1u);
+}
+
+// Many queues share a few threads; each queue must still run its tasks in
+// order and one at a time.
+TEST(TaskQueuePoolTest, KeepsPerQueueOrdering) {
+  static const int kNumQueues = 20;
+  static const int kTasksPerQueue = 200;
+  TaskQueuePool pool(4);
+
+  struct QueueState {
+    std::unique_ptr<TaskQueue> queue;
+    int next = 0;
+    volatile int running = 0;
+    bool ok = true;
+  };
+  std::vector<QueueState> states(kNumQueues);
+  for (auto& state : states)
+    state.queue.reset(new TaskQueue("PooledOrdering", &pool));
+
+  Event done(false, false);
+  volatile int remaining = kNumQueues * kTasksPerQueue;
+  for (int i = 0; i < kTasksPerQueue; ++i) {
+    for (auto& state : states) {
+      QueueState* s = &state;
+      s->queue->PostTask([s, i, &remaining, &done]() {
+        if (AtomicOps::Increment(&s->running) != 1 || s->next != i ||
+            !s->queue->IsCurrent()) {
+          s->ok = false;
+        }
+        ++s->next;
+        AtomicOps::Decrement(&s->running);
+        if (AtomicOps::Decrement(&remaining) == 0)
+          done.Set();
+      });
+    }
+  }
+  EXPECT_TRUE(done.Wait(5000));
+  for (const auto& state : states) {
+    EXPECT_TRUE(state.ok);
+    EXPECT_EQ(kTasksPerQueue, state.next);
+  }
+
+  TaskQueuePool::Stats stats = pool.GetStats();
+  EXPECT_EQ(4u, stats.num_threads);
+  EXPECT_EQ(static_cast<size_t>(kNumQueues), stats.num_queues);
+  EXPECT_EQ(static_cast<uint64_t>(kNumQueues * kTasksPerQueue),
+            stats.tasks_run);
+  EXPECT_EQ(0u, stats.pending_tasks);
+  EXPECT_GE(stats.max_latency_us, 0);
+}
+
+TEST(TaskQueuePoolTest, PostDelayed) {
+  static const char kQueueName[] = "PooledPostDelayed";
+  TaskQueuePool pool(1);
+  TaskQueue queue(kQueueName, &pool);
+
+  Event event(false, false);
+  uint32_t start = Time();
+  queue.PostDelayedTask(Bind(&CheckCurrent, kQueueName, &event, &queue), 100);
+  EXPECT_EQ(1u, pool.GetStats().delayed_tasks);
+  EXPECT_TRUE(event.Wait(1000));
+  uint32_t end = Time();
+  EXPECT_GE(end - start, 100u);
+  EXPECT_NEAR(end - start, 200u, 100u);  // Accept 100-300.
+}
+
+TEST(TaskQueuePoolTest, PostDelayedAfterDestruct) {
+  static const char kQueueName[] = "PooledPostDelayedAfterDestruct";
+  TaskQueuePool pool(1);
+  Event event(false, false);
+  {
+    TaskQueue queue(kQueueName, &pool);
+    queue.PostDelayedTask(Bind(&CheckCurrent, kQueueName, &event, &queue), 100);
+  }
+  EXPECT_EQ(0u, pool.GetStats().delayed_tasks);
+  EXPECT_FALSE(event.Wait(200));  // Task should not run.
+}
+
+TEST(TaskQueuePoolTest, PostAndReplyBetweenPooledAndDedicatedQueues) {
+  static const char kPostQueue[] = "PooledPostQueue";
+  static const char kReplyQueue[] = "ReplyQueue";
+  TaskQueuePool pool(2);
+  TaskQueue post_queue(kPostQueue, &pool);
+  TaskQueue reply_queue(kReplyQueue);
+
+  Event event(false, false);
+  post_queue.PostTaskAndReply(
+      Bind(&CheckCurrent, kPostQueue, nullptr, &post_queue),
+      Bind(&CheckCurrent, kReplyQueue, &event, &reply_queue), &reply_queue);
+  EXPECT_TRUE(event.Wait(1000));
+
+  post_queue.PostTask(
+      Bind(&TestPostTaskAndReply, &reply_queue, kReplyQueue, &event));
+  EXPECT_TRUE(event.Wait(1000));
+}
+
+// Destroying a queue drops its pending tasks, after waiting for the one that
+// is running.
+TEST(TaskQueuePoolTest, DestructWithPendingTasks) {
+  Event started(false, false);
+  Event unblock(false, false);
+  int tasks_executed = 0;
+  int tasks_cleaned_up = 0;
+  static const int kTaskCount = 100;
+
+  TaskQueuePool pool(2);
+  TaskQueue helper("PooledDestructHelper");
+  {
+    TaskQueue queue("PooledDestruct", &pool);
+    queue.PostTask([&started, &unblock]() {
+      started.Set();
+      unblock.Wait(Event::kForever);
+    });
+    for (int i = 0; i < kTaskCount; ++i)
+      queue.PostTask(NewClosure([&tasks_executed]() { ++tasks_executed; },
+                                [&tasks_cleaned_up]() { ++tasks_cleaned_up; }));
+    EXPECT_TRUE(started.Wait(1000));
+    EXPECT_EQ(static_cast<size_t>(kTaskCount), pool.GetStats().pending_tasks);
+    EXPECT_EQ(static_cast<size_t>(kTaskCount),
+              pool.GetStats().max_queue_depth);
+    // Run the destructor of |queue| while its first task is blocked.
+    helper.PostDelayedTask([&unblock]() { unblock.Set(); }, 50);
+  }
+  EXPECT_EQ(0, tasks_executed);
+  EXPECT_EQ(kTaskCount, tasks_cleaned_up);
+  EXPECT_EQ(0u, pool.GetStats().num_queues);
+}
+#endif  // defined(WEBRTC_BUILD_LIBEVENT)
+
 }  // namespace rtc
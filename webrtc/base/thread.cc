@@ -142,6 +142,8 @@ Thread::Thread() : Thread(SocketServer::CreateDefault()) {}
 
 Thread::Thread(SocketServer* ss)
     : MessageQueue(ss, false),
+      sendlist_head_(NULL),
+      sendlist_tail_(NULL),
       running_(true, false),
 #if defined(WEBRTC_WIN)
       thread_(NULL),
@@ -155,6 +157,8 @@ Thread::Thread(SocketServer* ss)
 
 Thread::Thread(std::unique_ptr<SocketServer> ss)
     : MessageQueue(std::move(ss), false),
+      sendlist_head_(NULL),
+      sendlist_tail_(NULL),
       running_(true, false),
 #if defined(WEBRTC_WIN)
       thread_(NULL),
@@ -311,7 +315,7 @@ void Thread::AssertBlockingIsAllowedOnCurrentThread() {
 void* Thread::PreRun(void* pv) {
   ThreadInit* init = static_cast<ThreadInit*>(pv);
   ThreadManager::Instance()->SetCurrentThread(init->thread);
-  rtc::SetCurrentThreadName(init->thread->name_.c_str());
+  ScopedThreadRegistration registration(init->thread->name_);
 #if __has_feature(objc_arc)
   @autoreleasepool
 #elif defined(WEBRTC_MAC)
@@ -364,18 +368,30 @@ void Thread::Send(const Location& posted_from,
 
   AssertBlockingIsAllowedOnCurrentThread();
 
-  AutoThread thread;
-  Thread *current_thread = Thread::Current();
+  // Only wrap the calling thread if it isn't wrapped already; doing so
+  // creates a socket server and registers with MessageQueueManager, which
+  // would otherwise be paid on every call.
+  Thread* current_thread = Thread::Current();
+  std::unique_ptr<AutoThread> auto_thread;
+  if (!current_thread) {
+    auto_thread.reset(new AutoThread());
+    current_thread = Thread::Current();
+  }
   ASSERT(current_thread != NULL);  // AutoThread ensures this
 
   bool ready = false;
+  _SendMessage smsg;
+  smsg.thread = current_thread;
+  smsg.msg = msg;
+  smsg.ready = &ready;
   {
     CritScope cs(&crit_);
-    _SendMessage smsg;
-    smsg.thread = current_thread;
-    smsg.msg = msg;
-    smsg.ready = &ready;
-    sendlist_.push_back(smsg);
+    if (sendlist_tail_) {
+      sendlist_tail_->next = &smsg;
+    } else {
+      sendlist_head_ = &smsg;
+    }
+    sendlist_tail_ = &smsg;
   }
 
   // Wait for a reply
@@ -436,17 +452,29 @@ void Thread::ReceiveSendsFromThread(const Thread* source) {
 }
 
 bool Thread::PopSendMessageFromThread(const Thread* source, _SendMessage* msg) {
-  for (std::list<_SendMessage>::iterator it = sendlist_.begin();
-       it != sendlist_.end(); ++it) {
+  _SendMessage* prev = NULL;
+  for (_SendMessage* it = sendlist_head_; it; prev = it, it = it->next) {
     if (it->thread == source || source == NULL) {
+      UnlinkSendMessage(prev, it);
       *msg = *it;
-      sendlist_.erase(it);
       return true;
     }
   }
   return false;
 }
 
+void Thread::UnlinkSendMessage(_SendMessage* prev, _SendMessage* smsg) {
+  if (prev) {
+    prev->next = smsg->next;
+  } else {
+    sendlist_head_ = smsg->next;
+  }
+  if (sendlist_tail_ == smsg) {
+    sendlist_tail_ = prev;
+  }
+  smsg->next = NULL;
+}
+
 void Thread::InvokeInternal(const Location& posted_from,
                             MessageHandler* handler) {
   TRACE_EVENT2("webrtc", "Thread::Invoke", "src_file_and_line",
@@ -464,8 +492,10 @@ void Thread::Clear(MessageHandler* phandler,
   // Object target cleared: remove from send list, wakeup/set ready
   // if sender not NULL.
 
-  std::list<_SendMessage>::iterator iter = sendlist_.begin();
-  while (iter != sendlist_.end()) {
+  _SendMessage* prev = NULL;
+  _SendMessage* iter = sendlist_head_;
+  while (iter) {
+    // |iter| belongs to the sender and may go away once |ready| is set.
     _SendMessage smsg = *iter;
     if (smsg.msg.Match(phandler, id)) {
       if (removed) {
@@ -473,12 +503,14 @@ void Thread::Clear(MessageHandler* phandler,
       } else {
         delete smsg.msg.pdata;
       }
-      iter = sendlist_.erase(iter);
+      UnlinkSendMessage(prev, iter);
       *smsg.ready = true;
       smsg.thread->socketserver()->WakeUp();
+      iter = smsg.next;
       continue;
     }
-    ++iter;
+    prev = iter;
+    iter = iter->next;
   }
 
   MessageQueue::Clear(phandler, id, removed);
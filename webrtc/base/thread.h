@@ -72,11 +72,15 @@ class ThreadManager {
   RTC_DISALLOW_COPY_AND_ASSIGN(ThreadManager);
 };
 
+// A pending Send(). It lives on the sending thread's stack until the send
+// completes and is linked into the target thread's |sendlist_| through
+// |next|, so Send() does not allocate.
 struct _SendMessage {
-  _SendMessage() {}
+  _SendMessage() : thread(NULL), ready(NULL), next(NULL) {}
   Thread *thread;
   Message msg;
   bool *ready;
+  _SendMessage* next;
 };
 
 class Runnable {
@@ -261,9 +265,15 @@ class LOCKABLE Thread : public MessageQueue {
   // Returns true if there is such a message.
   bool PopSendMessageFromThread(const Thread* source, _SendMessage* msg);
 
+  // Removes |smsg|, which follows |prev| (NULL if it is the head), from
+  // |sendlist_|. The caller must lock |crit_| before calling.
+  void UnlinkSendMessage(_SendMessage* prev, _SendMessage* smsg);
+
   void InvokeInternal(const Location& posted_from, MessageHandler* handler);
 
-  std::list<_SendMessage> sendlist_;
+  // Intrusive FIFO of pending sends, guarded by |crit_|.
+  _SendMessage* sendlist_head_;
+  _SendMessage* sendlist_tail_;
   std::string name_;
   Event running_;  // Signalled means running.
 
@@ -14,10 +14,12 @@
 #include "webrtc/base/asyncudpsocket.h"
 #include "webrtc/base/event.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/sigslot.h"
 #include "webrtc/base/socketaddress.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 
 #if defined(WEBRTC_WIN)
 #include <comdef.h>  // NOLINT
@@ -383,6 +385,25 @@ TEST(ThreadTest, ThreeThreadsInvoke) {
   EXPECT_TRUE_WAIT(thread_a_called.Get(), 2000);
 }
 
+// Measures the round-trip latency of a trivial Invoke() on another thread.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(ThreadTest, DISABLED_InvokeLatency) {
+  static const int kInvokes = 100000;
+  AutoThread current_thread;
+  Thread thread;
+  thread.Start();
+
+  int count = 0;
+  int64_t start_us = TimeMicros();
+  for (int i = 0; i < kInvokes; ++i)
+    thread.Invoke<void>(RTC_FROM_HERE, [&count] { ++count; });
+  int64_t elapsed_us = TimeMicros() - start_us;
+  EXPECT_EQ(kInvokes, count);
+  LOG(LS_INFO) << kInvokes << " invokes, "
+               << static_cast<double>(elapsed_us) / kInvokes
+               << " us per round trip";
+}
+
 // Set the name on a thread when the underlying QueueDestroyed signal is
 // triggered. This causes an error if the object is already partially
 // destroyed.
@@ -0,0 +1,349 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_BASE_TIMERWHEEL_H_
+#define WEBRTC_BASE_TIMERWHEEL_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/constructormagic.h"
+
+namespace rtc {
+
+// Hierarchical timer wheel holding values of type T keyed by an expiration
+// time in milliseconds. Insert() and Cancel() are O(1); PopExpired() is
+// amortized O(1) per value, since a value moves down at most one level at a
+// time until it reaches the millisecond resolution bottom level.
+//
+// Values are popped in expiration order, and values with the same expiration
+// time in the order they were inserted.
+//
+// Each level has 64 slots; a slot at level n spans 64^n ms. A value goes in
+// the level of the highest bit in which its expiration time differs from the
+// wheel's current time, so the bottom level holds the values expiring in the
+// current 64 ms. Expiration times before the current time, which happen when
+// the clock passed to PopExpired() lags the caller's clock or goes backwards
+// in tests, go in a separate sorted list that is popped first.
+//
+// Not thread safe.
+template <class T>
+class TimerWheel {
+ public:
+  // Identifies an inserted value for Cancel(). Handles of popped or cancelled
+  // values are not reused.
+  typedef uint64_t Handle;
+  static const Handle kInvalidHandle = 0;
+
+  // |now| is the wheel's initial current time.
+  explicit TimerWheel(int64_t now)
+      : now_(now),
+        size_(0),
+        next_seq_(0),
+        next_generation_(1),
+        free_(kNone),
+        lists_(kPastList + 1) {
+    for (uint64_t& bits : occupied_)
+      bits = 0;
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  Handle Insert(int64_t expiry, const T& value) {
+    if (size_ == 0 && expiry < now_) {
+      // Nothing depends on the current time; avoid the past list.
+      now_ = expiry;
+    }
+    uint32_t index = Allocate();
+    Node& node = nodes_[index];
+    node.value = value;
+    node.expiry = expiry;
+    node.seq = next_seq_++;
+    Place(index);
+    ++size_;
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+  }
+
+  // Removes the value identified by |handle| and stores it in |value|, if
+  // non-null. Returns false if the value has already been popped or
+  // cancelled.
+  bool Cancel(Handle handle, T* value) {
+    uint32_t index = static_cast<uint32_t>(handle);
+    uint32_t generation = static_cast<uint32_t>(handle >> 32);
+    if (index >= nodes_.size() || nodes_[index].list == kNone ||
+        nodes_[index].generation != generation) {
+      return false;
+    }
+    Unlink(index);
+    if (value)
+      *value = nodes_[index].value;
+    Free(index);
+    return true;
+  }
+
+  // Removes the next value that expires at or before |now| and stores it in
+  // |value|. Returns false if there is none.
+  bool PopExpired(int64_t now, T* value) {
+    while (true) {
+      if (lists_[kPastList].head != kNone) {
+        // Everything in the past list expires before anything in the wheel.
+        uint32_t index = lists_[kPastList].head;
+        if (nodes_[index].expiry > now)
+          return false;
+        return PopFront(index, value);
+      }
+      int level;
+      int64_t next;
+      if (!NextEvent(&level, &next) || next > now) {
+        // No slot starts before |now|, so the placement of every value stays
+        // the same if the wheel jumps ahead to |now|.
+        if (now > now_)
+          now_ = now;
+        return false;
+      }
+      now_ = next;
+      uint32_t list = ListIndex(level, SlotOf(next, level));
+      if (level == 0)
+        return PopFront(lists_[list].head, value);
+      // Spread the slot over the lower levels.
+      uint32_t index = lists_[list].head;
+      lists_[list].head = lists_[list].tail = kNone;
+      occupied_[level] &= ~(1ull << SlotOf(next, level));
+      while (index != kNone) {
+        uint32_t next_index = nodes_[index].next;
+        Place(index);
+        index = next_index;
+      }
+    }
+  }
+
+  // Returns false if the wheel is empty. Otherwise stores in |expiry| the
+  // time of the next expiration, or a time before it at which PopExpired()
+  // has to be called again to find it.
+  bool NextExpiry(int64_t* expiry) const {
+    if (lists_[kPastList].head != kNone) {
+      *expiry = nodes_[lists_[kPastList].head].expiry;
+      return true;
+    }
+    int level;
+    return NextEvent(&level, expiry);
+  }
+
+  // Calls |visitor| with a pointer to each value, in no particular order, and
+  // removes the values for which it returns true.
+  template <class Visitor>
+  void RemoveIf(Visitor visitor) {
+    for (uint32_t list = 0; list < lists_.size(); ++list) {
+      uint32_t index = lists_[list].head;
+      while (index != kNone) {
+        uint32_t next_index = nodes_[index].next;
+        if (visitor(&nodes_[index].value)) {
+          Unlink(index);
+          Free(index);
+        }
+        index = next_index;
+      }
+    }
+  }
+
+ private:
+  static const int kSlotBits = 6;
+  static const uint32_t kSlots = 1 << kSlotBits;
+  // Enough levels to cover all 64 bits of a time.
+  static const int kLevels = (64 + kSlotBits - 1) / kSlotBits;
+  static const uint32_t kPastList = kLevels * kSlots;
+  static const uint32_t kNone = 0xffffffff;
+
+  struct Node {
+    T value;
+    int64_t expiry = 0;
+    uint64_t seq = 0;
+    uint32_t generation = 0;
+    uint32_t prev = kNone;
+    uint32_t next = kNone;
+    // Index in |lists_|, or kNone when free.
+    uint32_t list = kNone;
+  };
+  struct List {
+    uint32_t head = kNone;
+    uint32_t tail = kNone;
+  };
+
+  static int HighestBit(uint64_t x) {
+    int bit = 0;
+    for (int shift = 32; shift > 0; shift >>= 1) {
+      if (x >> shift) {
+        x >>= shift;
+        bit += shift;
+      }
+    }
+    return bit;
+  }
+  static uint32_t SlotOf(int64_t time, int level) {
+    return (static_cast<uint64_t>(time) >> (level * kSlotBits)) & (kSlots - 1);
+  }
+  static uint32_t ListIndex(int level, uint32_t slot) {
+    return level * kSlots + slot;
+  }
+  bool Before(const Node& a, const Node& b) const {
+    return a.expiry < b.expiry || (a.expiry == b.expiry && a.seq < b.seq);
+  }
+
+  // Finds the first occupied slot and the time it starts at.
+  bool NextEvent(int* level, int64_t* start) const {
+    for (int l = 0; l < kLevels; ++l) {
+      if (!occupied_[l])
+        continue;
+      uint64_t bits = occupied_[l];
+      uint32_t slot = HighestBit(bits & (~bits + 1));
+      // Slots at or above level 1 always come after the current one, and
+      // bottom level slots never come before it.
+      RTC_DCHECK(l == 0 ? slot >= SlotOf(now_, l) : slot > SlotOf(now_, l));
+      int shift = (l + 1) * kSlotBits;
+      uint64_t block = shift >= 64 ? 0 : static_cast<uint64_t>(now_) &
+                                             (~0ull << shift);
+      *level = l;
+      *start = static_cast<int64_t>(
+          block | (static_cast<uint64_t>(slot) << (l * kSlotBits)));
+      return true;
+    }
+    return false;
+  }
+
+  // Links a node into the list its expiration time belongs in.
+  void Place(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.expiry < now_) {
+      InsertSorted(kPastList, index);
+      return;
+    }
+    uint64_t diff = static_cast<uint64_t>(node.expiry) ^
+                    static_cast<uint64_t>(now_);
+    int level = diff ? HighestBit(diff) / kSlotBits : 0;
+    uint32_t slot = SlotOf(node.expiry, level);
+    occupied_[level] |= 1ull << slot;
+    if (level == 0) {
+      // Values cascading from above may be older than ones inserted directly.
+      InsertSorted(ListIndex(level, slot), index);
+    } else {
+      // Upper slots are spread out in order; they don't need to be sorted.
+      Append(ListIndex(level, slot), index);
+    }
+  }
+
+  void Append(uint32_t list, uint32_t index) {
+    Node& node = nodes_[index];
+    node.list = list;
+    node.next = kNone;
+    node.prev = lists_[list].tail;
+    if (node.prev != kNone) {
+      nodes_[node.prev].next = index;
+    } else {
+      lists_[list].head = index;
+    }
+    lists_[list].tail = index;
+  }
+
+  void InsertSorted(uint32_t list, uint32_t index) {
+    uint32_t after = lists_[list].tail;
+    while (after != kNone && Before(nodes_[index], nodes_[after]))
+      after = nodes_[after].prev;
+    if (after == lists_[list].tail) {
+      Append(list, index);
+      return;
+    }
+    Node& node = nodes_[index];
+    node.list = list;
+    node.prev = after;
+    if (after != kNone) {
+      node.next = nodes_[after].next;
+      nodes_[after].next = index;
+    } else {
+      node.next = lists_[list].head;
+      lists_[list].head = index;
+    }
+    nodes_[node.next].prev = index;
+  }
+
+  void Unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    List& list = lists_[node.list];
+    if (node.prev != kNone) {
+      nodes_[node.prev].next = node.next;
+    } else {
+      list.head = node.next;
+    }
+    if (node.next != kNone) {
+      nodes_[node.next].prev = node.prev;
+    } else {
+      list.tail = node.prev;
+    }
+    if (list.head == kNone && node.list != kPastList) {
+      occupied_[node.list / kSlots] &= ~(1ull << (node.list % kSlots));
+    }
+    node.list = kNone;
+  }
+
+  bool PopFront(uint32_t index, T* value) {
+    Unlink(index);
+    *value = nodes_[index].value;
+    Free(index);
+    return true;
+  }
+
+  uint32_t Allocate() {
+    uint32_t index;
+    if (free_ != kNone) {
+      index = free_;
+      free_ = nodes_[index].next;
+    } else {
+      RTC_CHECK(nodes_.size() < kNone);
+      index = static_cast<uint32_t>(nodes_.size());
+      nodes_.push_back(Node());
+    }
+    nodes_[index].generation = next_generation_++;
+    if (next_generation_ == 0)
+      next_generation_ = 1;
+    return index;
+  }
+
+  void Free(uint32_t index) {
+    Node& node = nodes_[index];
+    node.value = T();
+    node.list = kNone;
+    node.next = free_;
+    free_ = index;
+    --size_;
+  }
+
+  int64_t now_;
+  size_t size_;
+  uint64_t next_seq_;
+  uint32_t next_generation_;
+  // Head of the free list, linked through Node::next.
+  uint32_t free_;
+  std::vector<Node> nodes_;
+  // The slots of every level, followed by the past list.
+  std::vector<List> lists_;
+  // One bit per non-empty slot, for each level.
+  uint64_t occupied_[kLevels];
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+template <class T>
+const typename TimerWheel<T>::Handle TimerWheel<T>::kInvalidHandle;
+
+}  // namespace rtc
+
+#endif  // WEBRTC_BASE_TIMERWHEEL_H_
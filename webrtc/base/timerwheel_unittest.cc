@@ -0,0 +1,318 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/timerwheel.h"
+#include "webrtc/base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+typedef TimerWheel<int> Wheel;
+
+// Pops everything due at |now|.
+std::vector<int> PopAll(Wheel* wheel, int64_t now) {
+  std::vector<int> popped;
+  int value;
+  while (wheel->PopExpired(now, &value))
+    popped.push_back(value);
+  return popped;
+}
+
+}  // namespace
+
+TEST(TimerWheelTest, Empty) {
+  Wheel wheel(1000);
+  EXPECT_TRUE(wheel.empty());
+  int64_t expiry;
+  EXPECT_FALSE(wheel.NextExpiry(&expiry));
+  int value;
+  EXPECT_FALSE(wheel.PopExpired(1000000, &value));
+}
+
+TEST(TimerWheelTest, PopsOnlyExpiredValues) {
+  Wheel wheel(1000);
+  wheel.Insert(1010, 1);
+  wheel.Insert(1100, 2);
+  EXPECT_EQ(2u, wheel.size());
+  EXPECT_TRUE(PopAll(&wheel, 1009).empty());
+  EXPECT_EQ(std::vector<int>({1}), PopAll(&wheel, 1010));
+  EXPECT_TRUE(PopAll(&wheel, 1099).empty());
+  EXPECT_EQ(std::vector<int>({2}), PopAll(&wheel, 5000));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, PopsInExpiryOrderThenFifo) {
+  Wheel wheel(0);
+  wheel.Insert(70000, 5);
+  wheel.Insert(300, 2);
+  wheel.Insert(5, 0);
+  wheel.Insert(300, 3);
+  wheel.Insert(64, 1);
+  wheel.Insert(70000, 6);
+  wheel.Insert(4100, 4);
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4, 5, 6}), PopAll(&wheel, 100000));
+}
+
+TEST(TimerWheelTest, CascadedValuesStayBehindEarlierInsertions) {
+  // The first value is placed far up and cascades into the bottom slot that
+  // the second one was inserted into directly.
+  Wheel wheel(0);
+  wheel.Insert(5000, 1);
+  EXPECT_TRUE(PopAll(&wheel, 4990).empty());
+  wheel.Insert(5000, 2);
+  EXPECT_EQ(std::vector<int>({1, 2}), PopAll(&wheel, 5000));
+}
+
+TEST(TimerWheelTest, PastExpiriesArePoppedFirstInOrder) {
+  Wheel wheel(1000);
+  wheel.Insert(1000, 3);
+  wheel.Insert(998, 0);
+  wheel.Insert(999, 1);
+  wheel.Insert(1000, 4);
+  wheel.Insert(999, 2);
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 4}), PopAll(&wheel, 1000));
+}
+
+TEST(TimerWheelTest, ClockGoingBackwards) {
+  // As when a fake clock is installed after the wheel was created.
+  Wheel wheel(1000000);
+  wheel.Insert(10, 0);
+  wheel.Insert(20, 1);
+  EXPECT_TRUE(PopAll(&wheel, 5).empty());
+  EXPECT_EQ(std::vector<int>({0}), PopAll(&wheel, 10));
+  EXPECT_EQ(std::vector<int>({1}), PopAll(&wheel, 20));
+}
+
+TEST(TimerWheelTest, NextExpiryIsReachedFromBelow) {
+  Wheel wheel(1000);
+  wheel.Insert(1000 + 123456, 7);
+  int64_t now = 1000;
+  int64_t expiry;
+  int value;
+  int wakeups = 0;
+  while (!wheel.PopExpired(now, &value)) {
+    ASSERT_TRUE(wheel.NextExpiry(&expiry));
+    ASSERT_GT(expiry, now);
+    ASSERT_LE(expiry, 1000 + 123456);
+    now = expiry;
+    ++wakeups;
+  }
+  EXPECT_EQ(1000 + 123456, now);
+  EXPECT_EQ(7, value);
+  // One per level it has to cascade down.
+  EXPECT_LE(wakeups, 3);
+}
+
+TEST(TimerWheelTest, Cancel) {
+  Wheel wheel(0);
+  Wheel::Handle first = wheel.Insert(100, 1);
+  Wheel::Handle second = wheel.Insert(100, 2);
+  EXPECT_NE(Wheel::kInvalidHandle, first);
+  EXPECT_NE(first, second);
+  int value = 0;
+  EXPECT_TRUE(wheel.Cancel(first, &value));
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(wheel.Cancel(first, &value));
+  EXPECT_EQ(1u, wheel.size());
+
+  // The slot |first| was in is reused, but not its handle.
+  Wheel::Handle third = wheel.Insert(200, 3);
+  EXPECT_NE(first, third);
+  EXPECT_FALSE(wheel.Cancel(first, nullptr));
+
+  EXPECT_EQ(std::vector<int>({2, 3}), PopAll(&wheel, 200));
+  EXPECT_FALSE(wheel.Cancel(second, nullptr));
+  EXPECT_FALSE(wheel.Cancel(Wheel::kInvalidHandle, nullptr));
+}
+
+TEST(TimerWheelTest, CancelLastValueInSlot) {
+  Wheel wheel(0);
+  Wheel::Handle handle = wheel.Insert(100000, 1);
+  wheel.Insert(200000, 2);
+  EXPECT_TRUE(wheel.Cancel(handle, nullptr));
+  int64_t expiry;
+  ASSERT_TRUE(wheel.NextExpiry(&expiry));
+  EXPECT_GT(expiry, 100000);
+  EXPECT_EQ(std::vector<int>({2}), PopAll(&wheel, 200000));
+}
+
+TEST(TimerWheelTest, RemoveIf) {
+  Wheel wheel(0);
+  for (int i = 0; i < 10; ++i)
+    wheel.Insert(i * 1000, i);
+  wheel.RemoveIf([](int* value) { return *value % 2 == 0; });
+  EXPECT_EQ(5u, wheel.size());
+  EXPECT_EQ(std::vector<int>({1, 3, 5, 7, 9}), PopAll(&wheel, 10000));
+}
+
+// Checks the wheel against a sorted map through random inserts, cancels and
+// clock advances.
+TEST(TimerWheelTest, MatchesSortedModel) {
+  webrtc::Random random(12345);
+  int64_t now = 1000000;
+  Wheel wheel(now);
+  // (expiry, insertion order) -> value.
+  std::map<std::pair<int64_t, int>, int> model;
+  std::vector<std::pair<Wheel::Handle, std::pair<int64_t, int>>> handles;
+  int order = 0;
+  for (int step = 0; step < 20000; ++step) {
+    int action = random.Rand(0, 9);
+    if (action < 5) {
+      int64_t delay = random.Rand(0, 3) == 0 ? random.Rand(0, 10)
+                                             : random.Rand(0, 300000);
+      int64_t expiry = now + delay - 5;
+      handles.push_back(
+          std::make_pair(wheel.Insert(expiry, order), std::make_pair(expiry,
+                                                                     order)));
+      model[std::make_pair(expiry, order)] = order;
+      ++order;
+    } else if (action < 7 && !handles.empty()) {
+      size_t i = random.Rand(0, static_cast<int>(handles.size()) - 1);
+      int value;
+      bool cancelled = wheel.Cancel(handles[i].first, &value);
+      ASSERT_EQ(model.count(handles[i].second) == 1, cancelled);
+      if (cancelled) {
+        EXPECT_EQ(handles[i].second.second, value);
+        model.erase(handles[i].second);
+      }
+      handles.erase(handles.begin() + i);
+    } else {
+      now += random.Rand(0, 5000);
+      int value;
+      while (wheel.PopExpired(now, &value)) {
+        ASSERT_FALSE(model.empty());
+        ASSERT_LE(model.begin()->first.first, now);
+        ASSERT_EQ(model.begin()->second, value);
+        model.erase(model.begin());
+      }
+      ASSERT_TRUE(model.empty() || model.begin()->first.first > now);
+    }
+    ASSERT_EQ(model.size(), wheel.size());
+  }
+}
+
+namespace {
+
+// How MessageQueue kept delayed messages before, for comparison.
+struct HeapTimer {
+  int64_t expiry;
+  uint64_t seq;
+  int value;
+  bool operator<(const HeapTimer& other) const {
+    return other.expiry < expiry ||
+           (other.expiry == expiry && other.seq < seq);
+  }
+};
+
+class HeapTimerQueue : public std::priority_queue<HeapTimer> {
+ public:
+  // Cancelling meant filtering the container and rebuilding the heap.
+  void Remove(int value) {
+    c.erase(std::remove_if(c.begin(), c.end(),
+                           [value](const HeapTimer& timer) {
+                             return timer.value == value;
+                           }),
+            c.end());
+    std::make_heap(c.begin(), c.end(), comp);
+  }
+};
+
+// A STUN-like retransmission delay, 100 to 1600 ms.
+int64_t StunDelay(webrtc::Random* random) {
+  return 100 << random->Rand(0, 4);
+}
+
+}  // namespace
+
+// Keeps 100k STUN-like timers outstanding while time advances, cancelling
+// some as if responses arrived and re-arming the ones that fire, and compares
+// the cost per operation with the priority queue MessageQueue used before.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(TimerWheelTest, DISABLED_Performance) {
+  static const int kTimers = 100000;
+  static const int kCancels = 1000;
+  static const int kSimulatedMs = 10000;
+
+  webrtc::Random random(42);
+  int64_t now = 0;
+  Wheel wheel(now);
+  std::vector<Wheel::Handle> handles(kTimers);
+  int64_t start = TimeNanos();
+  for (int i = 0; i < kTimers; ++i)
+    handles[i] = wheel.Insert(now + StunDelay(&random), i);
+  int64_t insert_ns = TimeNanos() - start;
+
+  start = TimeNanos();
+  uint64_t fired = 0;
+  for (int ms = 0; ms < kSimulatedMs; ++ms) {
+    ++now;
+    int value;
+    while (wheel.PopExpired(now, &value)) {
+      handles[value] = wheel.Insert(now + StunDelay(&random), value);
+      ++fired;
+    }
+  }
+  int64_t advance_ns = TimeNanos() - start;
+
+  start = TimeNanos();
+  for (int i = 0; i < kCancels; ++i) {
+    int value = random.Rand(0, kTimers - 1);
+    wheel.Cancel(handles[value], nullptr);
+    handles[value] = wheel.Insert(now + StunDelay(&random), value);
+  }
+  int64_t cancel_ns = TimeNanos() - start;
+  LOG(LS_INFO) << "TimerWheel: insert " << insert_ns / kTimers
+               << " ns, fire and re-arm " << advance_ns / fired
+               << " ns, cancel and re-arm " << cancel_ns / kCancels << " ns";
+
+  HeapTimerQueue heap;
+  uint64_t seq = 0;
+  now = 0;
+  start = TimeNanos();
+  for (int i = 0; i < kTimers; ++i)
+    heap.push({now + StunDelay(&random), seq++, i});
+  insert_ns = TimeNanos() - start;
+
+  start = TimeNanos();
+  fired = 0;
+  for (int ms = 0; ms < kSimulatedMs; ++ms) {
+    ++now;
+    while (heap.top().expiry <= now) {
+      int value = heap.top().value;
+      heap.pop();
+      heap.push({now + StunDelay(&random), seq++, value});
+      ++fired;
+    }
+  }
+  advance_ns = TimeNanos() - start;
+
+  start = TimeNanos();
+  for (int i = 0; i < kCancels; ++i) {
+    int value = random.Rand(0, kTimers - 1);
+    heap.Remove(value);
+    heap.push({now + StunDelay(&random), seq++, value});
+  }
+  cancel_ns = TimeNanos() - start;
+  LOG(LS_INFO) << "priority_queue: insert " << insert_ns / kTimers
+               << " ns, fire and re-arm " << advance_ns / fired
+               << " ns, cancel and re-arm " << cancel_ns / kCancels << " ns";
+}
+
+}  // namespace rtc
@@ -13,6 +13,7 @@
 #if defined(WEBRTC_POSIX)
 #include <sys/time.h>
 #if defined(WEBRTC_MAC)
+#include <mach/mach.h>
 #include <mach/mach_time.h>
 #endif
 #endif
@@ -88,6 +89,46 @@ int64_t SystemTimeMillis() {
   return static_cast<int64_t>(SystemTimeNanos() / kNumNanosecsPerMillisec);
 }
 
+int64_t ThreadCpuTimeNanos() {
+#if defined(WEBRTC_MAC)
+  mach_port_t thread = mach_thread_self();
+  thread_basic_info_data_t info;
+  mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+  kern_return_t kr =
+      thread_info(thread, THREAD_BASIC_INFO,
+                  reinterpret_cast<thread_info_t>(&info), &count);
+  mach_port_deallocate(mach_task_self(), thread);
+  if (kr != KERN_SUCCESS)
+    return -1;
+  return kNumNanosecsPerSec * (static_cast<int64_t>(info.user_time.seconds) +
+                               info.system_time.seconds) +
+         kNumNanosecsPerMicrosec *
+             (static_cast<int64_t>(info.user_time.microseconds) +
+              info.system_time.microseconds);
+#elif defined(WEBRTC_POSIX)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return -1;
+  return kNumNanosecsPerSec * static_cast<int64_t>(ts.tv_sec) +
+         static_cast<int64_t>(ts.tv_nsec);
+#elif defined(WEBRTC_WIN)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time,
+                      &kernel_time, &user_time)) {
+    return -1;
+  }
+  // FILETIME is in units of 100 ns.
+  ULARGE_INTEGER kernel, user;
+  kernel.LowPart = kernel_time.dwLowDateTime;
+  kernel.HighPart = kernel_time.dwHighDateTime;
+  user.LowPart = user_time.dwLowDateTime;
+  user.HighPart = user_time.dwHighDateTime;
+  return static_cast<int64_t>(kernel.QuadPart + user.QuadPart) * 100;
+#else
+  return -1;
+#endif
+}
+
 uint64_t TimeNanos() {
   if (g_clock) {
     return g_clock->TimeNanos();
@@ -58,6 +58,10 @@ ClockInterface* SetClockForTesting(ClockInterface* clock);
 uint64_t SystemTimeNanos();
 int64_t SystemTimeMillis();
 
+// Returns the CPU time consumed by the calling thread, or -1 if the platform
+// doesn't provide it. Not affected by a clock set for testing.
+int64_t ThreadCpuTimeNanos();
+
 // Returns the current time in milliseconds in 32 bits.
 uint32_t Time32();
 
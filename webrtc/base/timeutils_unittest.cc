@@ -59,6 +59,20 @@ TEST(TimeTest, TestTimeDiff64) {
   EXPECT_EQ(-ts_diff, rtc::TimeDiff(ts_earlier, ts_later));
 }
 
+TEST(TimeTest, ThreadCpuTimeAdvancesWhenBusy) {
+  const int64_t cpu_start_ns = rtc::ThreadCpuTimeNanos();
+  if (cpu_start_ns == -1)
+    return;  // Not supported on this platform.
+  // Spin until the thread has consumed some CPU time.
+  const int64_t wall_start_ms = rtc::TimeMillis();
+  volatile int sum = 0;
+  while (rtc::ThreadCpuTimeNanos() == cpu_start_ns) {
+    ++sum;
+    ASSERT_LT(rtc::TimeMillis() - wall_start_ms, 5000);
+  }
+  EXPECT_GT(rtc::ThreadCpuTimeNanos(), cpu_start_ns);
+}
+
 class TimestampWrapAroundHandlerTest : public testing::Test {
  public:
   TimestampWrapAroundHandlerTest() {}
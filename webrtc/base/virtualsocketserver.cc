@@ -381,6 +381,10 @@ int VirtualSocket::GetOption(Option opt, int* value) {
 }
 
 int VirtualSocket::SetOption(Option opt, int value) {
+  if (opt == OPT_UDP_GSO || opt == OPT_UDP_GRO) {
+    // Offloads are a property of the kernel, which isn't emulated.
+    return -1;
+  }
   options_map_[opt] = value;
   return 0;  // 0 is success to emulate setsockopt()
 }
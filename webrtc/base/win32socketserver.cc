@@ -617,6 +617,10 @@ int Win32Socket::TranslateOption(Option opt, int* slevel, int* sopt) {
     case OPT_DSCP:
       LOG(LS_WARNING) << "Socket::OPT_DSCP not supported.";
       return -1;
+    case OPT_UDP_GSO:
+    case OPT_UDP_GRO:
+    case OPT_REUSEPORT:
+      return -1;  // Linux only.
     default:
       ASSERT(false);
       return -1;
@@ -23,9 +23,16 @@
 #include "webrtc/video_receive_stream.h"
 #include "webrtc/video_send_stream.h"
 
+namespace rtc {
+class TaskQueue;
+class TaskQueuePool;
+}  // namespace rtc
+
 namespace webrtc {
 
 class AudioProcessing;
+class CongestionControlGroup;
+class ProcessThread;
 
 const char* Version();
 
@@ -89,6 +96,27 @@ class Call {
     // Audio Processing Module to be used in this call.
     // TODO(solenberg): Change this to a shared_ptr once we can use C++11.
     AudioProcessing* audio_processing = nullptr;
+
+    // Threads to run the call's modules and tasks on, possibly shared with
+    // other calls. Each call starts threads of its own for those that are
+    // null. Shared process threads must be started, and must outlive the
+    // call; they are only ever used from the thread the call is created on.
+    ProcessThread* module_process_thread = nullptr;
+    ProcessThread* pacer_thread = nullptr;
+    rtc::TaskQueue* worker_queue = nullptr;
+    // Threads that the video receive streams render frames on. If null, the
+    // call starts a pool of its own when the first video receive stream is
+    // created, where task queue pools are supported (WEBRTC_BUILD_LIBEVENT).
+    // Must outlive the call.
+    rtc::TaskQueuePool* render_pool = nullptr;
+
+    // Bandwidth estimation and pacing shared with the other calls in the
+    // group, for calls whose transports use the same network path. The call
+    // runs its own if null. Must outlive the call.
+    CongestionControlGroup* congestion_control_group = nullptr;
+    // Share of the bitrate above the min bitrates that the call gets relative
+    // to the other calls in |congestion_control_group|.
+    double bitrate_priority = 1.0;
   };
 
   struct Stats {
@@ -186,6 +186,15 @@ void BitrateAllocator::RemoveObserver(BitrateAllocatorObserver* observer) {
   UpdateAllocationLimits();
 }
 
+void BitrateAllocator::SetBitratePriority(BitrateAllocatorObserver* observer,
+                                          double bitrate_priority) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  RTC_DCHECK_GT(bitrate_priority, 0.0);
+  auto it = FindObserverConfig(observer);
+  if (it != bitrate_observer_configs_.end())
+    it->bitrate_priority = bitrate_priority;
+}
+
 int BitrateAllocator::GetStartBitrate(BitrateAllocatorObserver* observer) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   const auto& it = FindObserverConfig(observer);
@@ -372,30 +381,41 @@ void BitrateAllocator::DistributeBitrateEvenly(uint32_t bitrate,
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   RTC_DCHECK_EQ(allocation->size(), bitrate_observer_configs_.size());
 
+  // Observers are visited in the order in which they reach their max bitrate,
+  // so that what they can't fit is carried over to the remaining observers.
   ObserverSortingMap list_max_bitrates;
+  double sum_priorities = 0.0;
   for (const auto& observer_config : bitrate_observer_configs_) {
     if (include_zero_allocations ||
         allocation->at(observer_config.observer) != 0) {
-      list_max_bitrates.insert(std::pair<uint32_t, const ObserverConfig*>(
-          observer_config.max_bitrate_bps, &observer_config));
+      list_max_bitrates.insert(std::pair<double, const ObserverConfig*>(
+          observer_config.max_bitrate_bps / observer_config.bitrate_priority,
+          &observer_config));
+      sum_priorities += observer_config.bitrate_priority;
     }
   }
   auto it = list_max_bitrates.begin();
   while (it != list_max_bitrates.end()) {
     RTC_DCHECK_GT(bitrate, 0u);
-    uint32_t extra_allocation =
-        bitrate / static_cast<uint32_t>(list_max_bitrates.size());
+    const ObserverConfig& observer_config = *it->second;
+    uint32_t extra_allocation = bitrate;
+    if (list_max_bitrates.size() > 1) {
+      extra_allocation = static_cast<uint32_t>(
+          bitrate * observer_config.bitrate_priority / sum_priorities);
+    }
+    sum_priorities -= observer_config.bitrate_priority;
     uint32_t total_allocation =
-        extra_allocation + allocation->at(it->second->observer);
+        extra_allocation + allocation->at(observer_config.observer);
     bitrate -= extra_allocation;
-    if (total_allocation > max_multiplier * it->first) {
+    uint32_t max_allocation = max_multiplier * observer_config.max_bitrate_bps;
+    if (total_allocation > max_allocation) {
       // There is more than we can fit for this observer, carry over to the
       // remaining observers.
-      bitrate += total_allocation - max_multiplier * it->first;
-      total_allocation = max_multiplier * it->first;
+      bitrate += total_allocation - max_allocation;
+      total_allocation = max_allocation;
     }
     // Finally, update the allocation for this observer.
-    allocation->at(it->second->observer) = total_allocation;
+    allocation->at(observer_config.observer) = total_allocation;
     it = list_max_bitrates.erase(it);
   }
 }
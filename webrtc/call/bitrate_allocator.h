@@ -85,6 +85,12 @@ class BitrateAllocator {
   // allocation.
   void RemoveObserver(BitrateAllocatorObserver* observer);
 
+  // Sets the share of the bitrate above the min bitrates that |observer| gets
+  // relative to the other observers. The priority of an added observer is
+  // 1.0. Will not trigger a new bitrate allocation.
+  void SetBitratePriority(BitrateAllocatorObserver* observer,
+                          double bitrate_priority);
+
   // Returns initial bitrate allocated for |observer|. If |observer| is not in
   // the list of added observers, a best guess is returned.
   int GetStartBitrate(BitrateAllocatorObserver* observer);
@@ -102,6 +108,7 @@ class BitrateAllocator {
           max_bitrate_bps(max_bitrate_bps),
           pad_up_bitrate_bps(pad_up_bitrate_bps),
           enforce_min_bitrate(enforce_min_bitrate),
+          bitrate_priority(1.0),
           allocated_bitrate_bps(-1),
           media_ratio(1.0) {}
 
@@ -110,6 +117,7 @@ class BitrateAllocator {
     uint32_t max_bitrate_bps;
     uint32_t pad_up_bitrate_bps;
     bool enforce_min_bitrate;
+    double bitrate_priority;
     int64_t allocated_bitrate_bps;
     double media_ratio;  // Part of the total bitrate used for media [0.0, 1.0].
   };
@@ -122,7 +130,7 @@ class BitrateAllocator {
   ObserverConfigs::iterator FindObserverConfig(
       const BitrateAllocatorObserver* observer);
 
-  typedef std::multimap<uint32_t, const ObserverConfig*> ObserverSortingMap;
+  typedef std::multimap<double, const ObserverConfig*> ObserverSortingMap;
   typedef std::map<BitrateAllocatorObserver*, int> ObserverAllocation;
 
   ObserverAllocation AllocateBitrates(uint32_t bitrate);
@@ -138,7 +146,8 @@ class BitrateAllocator {
   // The minimum bitrate required by this observer, including enable-hysteresis
   // if the observer is in a paused state.
   uint32_t MinBitrateWithHysteresis(const ObserverConfig& observer_config);
-  // Splits |bitrate| evenly to observers already in |allocation|.
+  // Splits |bitrate| to observers already in |allocation|, in proportion to
+  // their bitrate priority.
   // |include_zero_allocations| decides if zero allocations should be part of
   // the distribution or not. The allowed max bitrate is |max_multiplier| x
   // observer max bitrate.
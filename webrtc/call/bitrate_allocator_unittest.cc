@@ -498,4 +498,37 @@ TEST_F(BitrateAllocatorTest, AvoidTogglePercent) {
   allocator_->RemoveObserver(&observer);
 }
 
+TEST_F(BitrateAllocatorTest, DistributesByBitratePriority) {
+  TestBitrateObserver observer_1;
+  TestBitrateObserver observer_2;
+  allocator_->AddObserver(&observer_1, 100000, 1000000, 0, true);
+  allocator_->AddObserver(&observer_2, 100000, 1000000, 0, true);
+  allocator_->SetBitratePriority(&observer_2, 3.0);
+
+  // The 400 kbps above the min bitrates are split 1:3.
+  allocator_->OnNetworkChanged(600000, 0, 50);
+  EXPECT_EQ(200000u, observer_1.last_bitrate_bps_);
+  EXPECT_EQ(400000u, observer_2.last_bitrate_bps_);
+
+  allocator_->RemoveObserver(&observer_1);
+  allocator_->RemoveObserver(&observer_2);
+}
+
+TEST_F(BitrateAllocatorTest, BitratePriorityRespectsMaxBitrate) {
+  TestBitrateObserver observer_1;
+  TestBitrateObserver observer_2;
+  allocator_->AddObserver(&observer_1, 100000, 1000000, 0, true);
+  allocator_->AddObserver(&observer_2, 100000, 250000, 0, true);
+  allocator_->SetBitratePriority(&observer_2, 3.0);
+
+  // Observer 2 would get 100 + 375 kbps, but what exceeds its max bitrate
+  // goes to observer 1.
+  allocator_->OnNetworkChanged(700000, 0, 50);
+  EXPECT_EQ(450000u, observer_1.last_bitrate_bps_);
+  EXPECT_EQ(250000u, observer_2.last_bitrate_bps_);
+
+  allocator_->RemoveObserver(&observer_1);
+  allocator_->RemoveObserver(&observer_2);
+}
+
 }  // namespace webrtc
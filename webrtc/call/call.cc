@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/audio/audio_receive_stream.h"
@@ -20,6 +21,8 @@
 #include "webrtc/audio/scoped_voe_interface.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/task_queue.h"
 #include "webrtc/base/thread_annotations.h"
@@ -27,6 +30,7 @@
 #include "webrtc/base/trace_event.h"
 #include "webrtc/call.h"
 #include "webrtc/call/bitrate_allocator.h"
+#include "webrtc/call/congestion_control_group.h"
 #include "webrtc/call/rtc_event_log.h"
 #include "webrtc/config.h"
 #include "webrtc/modules/bitrate_controller/include/bitrate_controller.h"
@@ -55,10 +59,17 @@ const int Call::Config::kDefaultStartBitrateBps = 300000;
 
 namespace internal {
 
+#if defined(WEBRTC_BUILD_LIBEVENT)
+// The video receive streams of a call render on these threads. With more than
+// one, a slow renderer doesn't hold up the other streams.
+const size_t kNumRenderThreads = 2;
+#endif
+
 class Call : public webrtc::Call,
              public PacketReceiver,
              public CongestionController::Observer,
-             public BitrateAllocator::LimitObserver {
+             public BitrateAllocator::LimitObserver,
+             public BitrateAllocatorObserver {
  public:
   explicit Call(const Call::Config& config);
   virtual ~Call();
@@ -109,6 +120,12 @@ class Call : public webrtc::Call,
   void OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
                                  uint32_t max_padding_bitrate_bps) override;
 
+  // Implements BitrateAllocatorObserver, through which the congestion control
+  // group hands the call its share of the shared estimate.
+  uint32_t OnBitrateUpdated(uint32_t bitrate_bps,
+                            uint8_t fraction_loss,
+                            int64_t rtt) override;
+
   bool StartEventLog(rtc::PlatformFile log_file,
                      int64_t max_size_bytes) override {
     return event_log_->StartLogging(log_file, max_size_bytes);
@@ -143,9 +160,16 @@ class Call : public webrtc::Call,
   Clock* const clock_;
 
   const int num_cpu_cores_;
-  const std::unique_ptr<ProcessThread> module_process_thread_;
-  const std::unique_ptr<ProcessThread> pacer_thread_;
+  // Null if the call uses shared threads.
+  const std::unique_ptr<ProcessThread> owned_module_process_thread_;
+  const std::unique_ptr<ProcessThread> owned_pacer_thread_;
+  ProcessThread* const module_process_thread_;
+  ProcessThread* const pacer_thread_;
   const std::unique_ptr<CallStats> call_stats_;
+  // Created with the first video receive stream, unless the config provides
+  // a pool. Null where task queue pools aren't supported.
+  std::unique_ptr<rtc::TaskQueuePool> owned_render_pool_;
+  rtc::TaskQueuePool* render_pool_;
   const std::unique_ptr<BitrateAllocator> bitrate_allocator_;
   Call::Config config_;
   rtc::ThreadChecker configuration_thread_checker_;
@@ -163,6 +187,16 @@ class Call : public webrtc::Call,
       GUARDED_BY(receive_crit_);
   std::map<std::string, AudioReceiveStream*> sync_stream_mapping_
       GUARDED_BY(receive_crit_);
+  // The receive streams of each SSRC, looked up once for every incoming RTP
+  // packet. Holds the same streams as |audio_receive_ssrcs_| and
+  // |video_receive_ssrcs_|, which are kept ordered for the less frequent
+  // operations that iterate over the streams.
+  struct ReceiveStreams {
+    AudioReceiveStream* audio = nullptr;
+    VideoReceiveStream* video = nullptr;
+  };
+  std::unordered_map<uint32_t, ReceiveStreams> receive_streams_by_ssrc_
+      GUARDED_BY(receive_crit_);
 
   std::unique_ptr<RWLockWrapper> send_crit_;
   // Audio and Video send streams are owned by the client that creates them.
@@ -178,10 +212,19 @@ class Call : public webrtc::Call,
   // from the destructor, and therefore doesn't need any explicit
   // synchronization.
   int64_t first_packet_sent_ms_;
-  RateCounter received_bytes_per_second_counter_;
-  RateCounter received_audio_bytes_per_second_counter_;
-  RateCounter received_video_bytes_per_second_counter_;
-  RateCounter received_rtcp_bytes_per_second_counter_;
+
+  // Packets are delivered on the network thread or on the worker thread, and
+  // on both when media channels deliver packets of known streams on the
+  // network thread and those of unsignalled SSRCs on the worker thread.
+  rtc::CriticalSection received_counters_crit_;
+  RateCounter received_bytes_per_second_counter_
+      GUARDED_BY(&received_counters_crit_);
+  RateCounter received_audio_bytes_per_second_counter_
+      GUARDED_BY(&received_counters_crit_);
+  RateCounter received_video_bytes_per_second_counter_
+      GUARDED_BY(&received_counters_crit_);
+  RateCounter received_rtcp_bytes_per_second_counter_
+      GUARDED_BY(&received_counters_crit_);
 
   // TODO(holmer): Remove this lock once BitrateController no longer calls
   // OnNetworkChanged from multiple threads.
@@ -193,15 +236,21 @@ class Call : public webrtc::Call,
 
   std::map<std::string, rtc::NetworkRoute> network_routes_;
 
-  VieRemb remb_;
-  const std::unique_ptr<CongestionController> congestion_controller_;
+  // Null if the call is in a congestion control group.
+  CongestionControlGroup* const congestion_control_group_;
+  const std::unique_ptr<VieRemb> owned_remb_;
+  VieRemb* const remb_;
+  const std::unique_ptr<CongestionController> owned_congestion_controller_;
+  CongestionController* const congestion_controller_;
   const std::unique_ptr<SendDelayStats> video_send_delay_stats_;
   const int64_t start_ms_;
   // TODO(perkj): |worker_queue_| is supposed to replace
   // |module_process_thread_|.
-  // |worker_queue| is defined last to ensure all pending tasks are cancelled
-  // and deleted before any other members.
-  rtc::TaskQueue worker_queue_;
+  // |owned_worker_queue_| is defined last to ensure all pending tasks are
+  // cancelled and deleted before any other members. Tasks on a shared queue
+  // are run before the call goes away instead.
+  const std::unique_ptr<rtc::TaskQueue> owned_worker_queue_;
+  rtc::TaskQueue* const worker_queue_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(Call);
 };
@@ -228,9 +277,20 @@ namespace internal {
 Call::Call(const Call::Config& config)
     : clock_(Clock::GetRealTimeClock()),
       num_cpu_cores_(CpuInfo::DetectNumberOfCores()),
-      module_process_thread_(ProcessThread::Create("ModuleProcessThread")),
-      pacer_thread_(ProcessThread::Create("PacerThread")),
+      owned_module_process_thread_(
+          config.module_process_thread
+              ? nullptr
+              : ProcessThread::Create("ModuleProcessThread")),
+      owned_pacer_thread_(config.pacer_thread
+                              ? nullptr
+                              : ProcessThread::Create("PacerThread")),
+      module_process_thread_(config.module_process_thread
+                                 ? config.module_process_thread
+                                 : owned_module_process_thread_.get()),
+      pacer_thread_(config.pacer_thread ? config.pacer_thread
+                                        : owned_pacer_thread_.get()),
       call_stats_(new CallStats(clock_)),
+      render_pool_(config.render_pool),
       bitrate_allocator_(new BitrateAllocator(this)),
       config_(config),
       audio_network_state_(kNetworkUp),
@@ -247,12 +307,26 @@ Call::Call(const Call::Config& config)
       configured_max_padding_bitrate_bps_(0),
       estimated_send_bitrate_kbps_counter_(clock_, nullptr, true),
       pacer_bitrate_kbps_counter_(clock_, nullptr, true),
-      remb_(clock_),
+      congestion_control_group_(config.congestion_control_group),
+      owned_remb_(congestion_control_group_ ? nullptr : new VieRemb(clock_)),
+      remb_(congestion_control_group_ ? congestion_control_group_->remb()
+                                      : owned_remb_.get()),
+      owned_congestion_controller_(
+          congestion_control_group_
+              ? nullptr
+              : new CongestionController(clock_, this, remb_,
+                                         event_log_.get())),
       congestion_controller_(
-          new CongestionController(clock_, this, &remb_, event_log_.get())),
+          congestion_control_group_
+              ? congestion_control_group_->congestion_controller()
+              : owned_congestion_controller_.get()),
       video_send_delay_stats_(new SendDelayStats(clock_)),
       start_ms_(clock_->TimeInMilliseconds()),
-      worker_queue_("call_worker_queue") {
+      owned_worker_queue_(config.worker_queue
+                              ? nullptr
+                              : new rtc::TaskQueue("call_worker_queue")),
+      worker_queue_(config.worker_queue ? config.worker_queue
+                                        : owned_worker_queue_.get()) {
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   RTC_DCHECK_GE(config.bitrate_config.min_bitrate_bps, 0);
   RTC_DCHECK_GE(config.bitrate_config.start_bitrate_bps,
@@ -263,24 +337,31 @@ Call::Call(const Call::Config& config)
   }
 
   Trace::CreateTrace();
-  call_stats_->RegisterStatsObserver(congestion_controller_.get());
+  call_stats_->RegisterStatsObserver(congestion_controller_);
 
-  congestion_controller_->SetBweBitrates(
-      config_.bitrate_config.min_bitrate_bps,
-      config_.bitrate_config.start_bitrate_bps,
-      config_.bitrate_config.max_bitrate_bps);
-
-  module_process_thread_->Start();
+  if (owned_module_process_thread_)
+    module_process_thread_->Start();
   module_process_thread_->RegisterModule(call_stats_.get());
-  module_process_thread_->RegisterModule(congestion_controller_.get());
-  pacer_thread_->RegisterModule(congestion_controller_->pacer());
-  pacer_thread_->RegisterModule(
-      congestion_controller_->GetRemoteBitrateEstimator(true));
-  pacer_thread_->Start();
+  if (congestion_control_group_) {
+    // The group configures and runs the shared congestion controller.
+    congestion_control_group_->AddCall(this, config_.bitrate_config,
+                                       config_.bitrate_priority);
+  } else {
+    congestion_controller_->SetBweBitrates(
+        config_.bitrate_config.min_bitrate_bps,
+        config_.bitrate_config.start_bitrate_bps,
+        config_.bitrate_config.max_bitrate_bps);
+    module_process_thread_->RegisterModule(congestion_controller_);
+    pacer_thread_->RegisterModule(congestion_controller_->pacer());
+    pacer_thread_->RegisterModule(
+        congestion_controller_->GetRemoteBitrateEstimator(true));
+  }
+  if (owned_pacer_thread_)
+    pacer_thread_->Start();
 }
 
 Call::~Call() {
-  RTC_DCHECK(!remb_.InUse());
+  RTC_DCHECK(!owned_remb_ || !owned_remb_->InUse());
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
 
   RTC_CHECK(audio_send_ssrcs_.empty());
@@ -288,16 +369,29 @@ Call::~Call() {
   RTC_CHECK(video_send_streams_.empty());
   RTC_CHECK(audio_receive_ssrcs_.empty());
   RTC_CHECK(video_receive_ssrcs_.empty());
+  RTC_CHECK(receive_streams_by_ssrc_.empty());
   RTC_CHECK(video_receive_streams_.empty());
 
-  pacer_thread_->Stop();
-  pacer_thread_->DeRegisterModule(congestion_controller_->pacer());
-  pacer_thread_->DeRegisterModule(
-      congestion_controller_->GetRemoteBitrateEstimator(true));
-  module_process_thread_->DeRegisterModule(congestion_controller_.get());
+  if (owned_pacer_thread_)
+    pacer_thread_->Stop();
+  if (congestion_control_group_) {
+    congestion_control_group_->RemoveCall(this);
+  } else {
+    pacer_thread_->DeRegisterModule(congestion_controller_->pacer());
+    pacer_thread_->DeRegisterModule(
+        congestion_controller_->GetRemoteBitrateEstimator(true));
+    module_process_thread_->DeRegisterModule(congestion_controller_);
+  }
   module_process_thread_->DeRegisterModule(call_stats_.get());
-  module_process_thread_->Stop();
-  call_stats_->DeregisterStatsObserver(congestion_controller_.get());
+  if (owned_module_process_thread_)
+    module_process_thread_->Stop();
+  call_stats_->DeregisterStatsObserver(congestion_controller_);
+  if (!owned_worker_queue_) {
+    // Run the tasks still pending for this call on the shared queue.
+    rtc::Event done(false, false);
+    worker_queue_->PostTask([&done] { done.Set(); });
+    done.Wait(rtc::Event::kForever);
+  }
 
   // Only update histograms after process threads have been shut down, so that
   // they won't try to concurrently update stats.
@@ -340,6 +434,7 @@ void Call::UpdateSendHistograms() {
 }
 
 void Call::UpdateReceiveHistograms() {
+  rtc::CritScope lock(&received_counters_crit_);
   const int kMinRequiredPeriodicSamples = 5;
   AggregatedStats video_bytes_per_sec =
       received_video_bytes_per_second_counter_.GetStats();
@@ -379,7 +474,7 @@ webrtc::AudioSendStream* Call::CreateAudioSendStream(
   TRACE_EVENT0("webrtc", "Call::CreateAudioSendStream");
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   AudioSendStream* send_stream = new AudioSendStream(
-      config, config_.audio_state, &worker_queue_, congestion_controller_.get(),
+      config, config_.audio_state, worker_queue_, congestion_controller_,
       bitrate_allocator_.get());
   {
     WriteLockScoped write_lock(*send_crit_);
@@ -416,13 +511,14 @@ webrtc::AudioReceiveStream* Call::CreateAudioReceiveStream(
   TRACE_EVENT0("webrtc", "Call::CreateAudioReceiveStream");
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
   AudioReceiveStream* receive_stream =
-      new AudioReceiveStream(congestion_controller_.get(), config,
+      new AudioReceiveStream(congestion_controller_, config,
                              config_.audio_state, event_log_.get());
   {
     WriteLockScoped write_lock(*receive_crit_);
     RTC_DCHECK(audio_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
                audio_receive_ssrcs_.end());
     audio_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
+    receive_streams_by_ssrc_[config.rtp.remote_ssrc].audio = receive_stream;
     ConfigureSync(config.sync_group);
   }
   receive_stream->SignalNetworkState(audio_network_state_);
@@ -439,9 +535,13 @@ void Call::DestroyAudioReceiveStream(
       static_cast<webrtc::internal::AudioReceiveStream*>(receive_stream);
   {
     WriteLockScoped write_lock(*receive_crit_);
-    size_t num_deleted = audio_receive_ssrcs_.erase(
-        audio_receive_stream->config().rtp.remote_ssrc);
+    const uint32_t ssrc = audio_receive_stream->config().rtp.remote_ssrc;
+    size_t num_deleted = audio_receive_ssrcs_.erase(ssrc);
     RTC_DCHECK(num_deleted == 1);
+    auto streams = receive_streams_by_ssrc_.find(ssrc);
+    streams->second.audio = nullptr;
+    if (!streams->second.video)
+      receive_streams_by_ssrc_.erase(streams);
     const std::string& sync_group = audio_receive_stream->config().sync_group;
     const auto it = sync_stream_mapping_.find(sync_group);
     if (it != sync_stream_mapping_.end() &&
@@ -468,9 +568,9 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
   // Copy ssrcs from |config| since |config| is moved.
   std::vector<uint32_t> ssrcs = config.rtp.ssrcs;
   VideoSendStream* send_stream = new VideoSendStream(
-      num_cpu_cores_, module_process_thread_.get(), &worker_queue_,
-      call_stats_.get(), congestion_controller_.get(), bitrate_allocator_.get(),
-      video_send_delay_stats_.get(), &remb_, event_log_.get(),
+      num_cpu_cores_, module_process_thread_, worker_queue_,
+      call_stats_.get(), congestion_controller_, bitrate_allocator_.get(),
+      video_send_delay_stats_.get(), remb_, event_log_.get(),
       std::move(config), std::move(encoder_config),
       suspended_video_send_ssrcs_);
 
@@ -527,9 +627,16 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
     webrtc::VideoReceiveStream::Config configuration) {
   TRACE_EVENT0("webrtc", "Call::CreateVideoReceiveStream");
   RTC_DCHECK(configuration_thread_checker_.CalledOnValidThread());
+#if defined(WEBRTC_BUILD_LIBEVENT)
+  if (!render_pool_) {
+    owned_render_pool_.reset(new rtc::TaskQueuePool(kNumRenderThreads));
+    render_pool_ = owned_render_pool_.get();
+  }
+#endif
   VideoReceiveStream* receive_stream = new VideoReceiveStream(
-      num_cpu_cores_, congestion_controller_.get(), std::move(configuration),
-      voice_engine(), module_process_thread_.get(), call_stats_.get(), &remb_);
+      num_cpu_cores_, congestion_controller_, std::move(configuration),
+      voice_engine(), module_process_thread_, call_stats_.get(), remb_,
+      render_pool_);
 
   const webrtc::VideoReceiveStream::Config& config = receive_stream->config();
   {
@@ -537,11 +644,14 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
     RTC_DCHECK(video_receive_ssrcs_.find(config.rtp.remote_ssrc) ==
                video_receive_ssrcs_.end());
     video_receive_ssrcs_[config.rtp.remote_ssrc] = receive_stream;
+    receive_streams_by_ssrc_[config.rtp.remote_ssrc].video = receive_stream;
     // TODO(pbos): Configure different RTX payloads per receive payload.
     VideoReceiveStream::Config::Rtp::RtxMap::const_iterator it =
         config.rtp.rtx.begin();
-    if (it != config.rtp.rtx.end())
+    if (it != config.rtp.rtx.end()) {
       video_receive_ssrcs_[it->second.ssrc] = receive_stream;
+      receive_streams_by_ssrc_[it->second.ssrc].video = receive_stream;
+    }
     video_receive_streams_.insert(receive_stream);
     ConfigureSync(config.sync_group);
   }
@@ -567,6 +677,10 @@ void Call::DestroyVideoReceiveStream(
         if (receive_stream_impl != nullptr)
           RTC_DCHECK(receive_stream_impl == it->second);
         receive_stream_impl = it->second;
+        auto streams = receive_streams_by_ssrc_.find(it->first);
+        streams->second.video = nullptr;
+        if (!streams->second.audio)
+          receive_streams_by_ssrc_.erase(streams);
         video_receive_ssrcs_.erase(it++);
       } else {
         ++it;
@@ -627,6 +741,10 @@ void Call::SetBitrateConfig(
   if (bitrate_config.start_bitrate_bps > 0)
     config_.bitrate_config.start_bitrate_bps = bitrate_config.start_bitrate_bps;
   config_.bitrate_config.max_bitrate_bps = bitrate_config.max_bitrate_bps;
+  if (congestion_control_group_) {
+    congestion_control_group_->SetBitrateConfig(this, config_.bitrate_config);
+    return;
+  }
   congestion_controller_->SetBweBitrates(bitrate_config.min_bitrate_bps,
                                          bitrate_config.start_bitrate_bps,
                                          bitrate_config.max_bitrate_bps);
@@ -699,6 +817,10 @@ void Call::OnNetworkRouteChanged(const std::string& transport_name,
                  << " bps, start: " << config_.bitrate_config.start_bitrate_bps
                  << " bps,  max: " << config_.bitrate_config.start_bitrate_bps
                  << " bps.";
+    if (congestion_control_group_) {
+      congestion_control_group_->ResetBweAndBitrates();
+      return;
+    }
     congestion_controller_->ResetBweAndBitrates(
         config_.bitrate_config.start_bitrate_bps,
         config_.bitrate_config.min_bitrate_bps,
@@ -735,6 +857,10 @@ void Call::UpdateAggregateNetworkState() {
   LOG(LS_INFO) << "UpdateAggregateNetworkState: aggregate_state="
                << (aggregate_state == kNetworkUp ? "up" : "down");
 
+  if (congestion_control_group_) {
+    congestion_control_group_->SignalNetworkState(this, aggregate_state);
+    return;
+  }
   congestion_controller_->SignalNetworkState(aggregate_state);
 }
 
@@ -750,13 +876,13 @@ void Call::OnNetworkChanged(uint32_t target_bitrate_bps, uint8_t fraction_loss,
                             int64_t rtt_ms) {
   // TODO(perkj): Consider making sure CongestionController operates on
   // |worker_queue_|.
-  if (!worker_queue_.IsCurrent()) {
-    worker_queue_.PostTask([this, target_bitrate_bps, fraction_loss, rtt_ms] {
+  if (!worker_queue_->IsCurrent()) {
+    worker_queue_->PostTask([this, target_bitrate_bps, fraction_loss, rtt_ms] {
       OnNetworkChanged(target_bitrate_bps, fraction_loss, rtt_ms);
     });
     return;
   }
-  RTC_DCHECK_RUN_ON(&worker_queue_);
+  RTC_DCHECK_RUN_ON(worker_queue_);
   bitrate_allocator_->OnNetworkChanged(target_bitrate_bps, fraction_loss,
                                        rtt_ms);
 
@@ -790,13 +916,26 @@ void Call::OnNetworkChanged(uint32_t target_bitrate_bps, uint8_t fraction_loss,
 
 void Call::OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
                                      uint32_t max_padding_bitrate_bps) {
-  congestion_controller_->SetAllocatedSendBitrateLimits(
-      min_send_bitrate_bps, max_padding_bitrate_bps);
+  if (congestion_control_group_) {
+    congestion_control_group_->SetAllocationLimits(this, min_send_bitrate_bps,
+                                                   max_padding_bitrate_bps);
+  } else {
+    congestion_controller_->SetAllocatedSendBitrateLimits(
+        min_send_bitrate_bps, max_padding_bitrate_bps);
+  }
   rtc::CritScope lock(&bitrate_crit_);
   min_allocated_send_bitrate_bps_ = min_send_bitrate_bps;
   configured_max_padding_bitrate_bps_ = max_padding_bitrate_bps;
 }
 
+uint32_t Call::OnBitrateUpdated(uint32_t bitrate_bps,
+                                uint8_t fraction_loss,
+                                int64_t rtt) {
+  OnNetworkChanged(bitrate_bps, fraction_loss, rtt);
+  // Protection is accounted for by the allocator of the call.
+  return 0;
+}
+
 void Call::ConfigureSync(const std::string& sync_group) {
   // Set sync only if there was no previous one.
   if (voice_engine() == nullptr || sync_group.empty())
@@ -852,10 +991,13 @@ PacketReceiver::DeliveryStatus Call::DeliverRtcp(MediaType media_type,
   // TODO(pbos): Make sure it's a valid packet.
   //             Return DELIVERY_UNKNOWN_SSRC if it can be determined that
   //             there's no receiver of the packet.
-  if (received_bytes_per_second_counter_.HasSample()) {
-    // First RTP packet has been received.
-    received_bytes_per_second_counter_.Add(static_cast<int>(length));
-    received_rtcp_bytes_per_second_counter_.Add(static_cast<int>(length));
+  {
+    rtc::CritScope lock(&received_counters_crit_);
+    if (received_bytes_per_second_counter_.HasSample()) {
+      // First RTP packet has been received.
+      received_bytes_per_second_counter_.Add(static_cast<int>(length));
+      received_rtcp_bytes_per_second_counter_.Add(static_cast<int>(length));
+    }
   }
   bool rtcp_delivered = false;
   if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
@@ -904,12 +1046,18 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
 
   uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&packet[8]);
   ReadLockScoped read_lock(*receive_crit_);
+  auto it = receive_streams_by_ssrc_.find(ssrc);
+  if (it == receive_streams_by_ssrc_.end())
+    return DELIVERY_UNKNOWN_SSRC;
+  const ReceiveStreams& streams = it->second;
   if (media_type == MediaType::ANY || media_type == MediaType::AUDIO) {
-    auto it = audio_receive_ssrcs_.find(ssrc);
-    if (it != audio_receive_ssrcs_.end()) {
-      received_bytes_per_second_counter_.Add(static_cast<int>(length));
-      received_audio_bytes_per_second_counter_.Add(static_cast<int>(length));
-      auto status = it->second->DeliverRtp(packet, length, packet_time)
+    if (streams.audio) {
+      {
+        rtc::CritScope lock(&received_counters_crit_);
+        received_bytes_per_second_counter_.Add(static_cast<int>(length));
+        received_audio_bytes_per_second_counter_.Add(static_cast<int>(length));
+      }
+      auto status = streams.audio->DeliverRtp(packet, length, packet_time)
                         ? DELIVERY_OK
                         : DELIVERY_PACKET_ERROR;
       if (status == DELIVERY_OK)
@@ -918,11 +1066,13 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
     }
   }
   if (media_type == MediaType::ANY || media_type == MediaType::VIDEO) {
-    auto it = video_receive_ssrcs_.find(ssrc);
-    if (it != video_receive_ssrcs_.end()) {
-      received_bytes_per_second_counter_.Add(static_cast<int>(length));
-      received_video_bytes_per_second_counter_.Add(static_cast<int>(length));
-      auto status = it->second->DeliverRtp(packet, length, packet_time)
+    if (streams.video) {
+      {
+        rtc::CritScope lock(&received_counters_crit_);
+        received_bytes_per_second_counter_.Add(static_cast<int>(length));
+        received_video_bytes_per_second_counter_.Add(static_cast<int>(length));
+      }
+      auto status = streams.video->DeliverRtp(packet, length, packet_time)
                         ? DELIVERY_OK
                         : DELIVERY_PACKET_ERROR;
       if (status == DELIVERY_OK)
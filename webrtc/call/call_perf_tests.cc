@@ -8,25 +8,39 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(WEBRTC_LINUX)
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <set>
 #include <string>
 
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/format_macros.h"
+#include "webrtc/base/memory_usage.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/thread_annotations.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/call.h"
 #include "webrtc/call/transport_adapter.h"
 #include "webrtc/config.h"
 #include "webrtc/modules/audio_coding/include/audio_coding_module.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/metrics_default.h"
 #include "webrtc/system_wrappers/include/rtp_to_ntp.h"
+#include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/call_test.h"
 #include "webrtc/test/direct_transport.h"
 #include "webrtc/test/drifting_clock.h"
@@ -36,6 +50,7 @@
 #include "webrtc/test/fake_encoder.h"
 #include "webrtc/test/frame_generator.h"
 #include "webrtc/test/frame_generator_capturer.h"
+#include "webrtc/test/null_transport.h"
 #include "webrtc/test/rtp_rtcp_observer.h"
 #include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/test/testsupport/perf_test.h"
@@ -71,6 +86,8 @@ class CallPerfTest : public test::CallTest {
                           int threshold_ms,
                           int start_time_ms,
                           int run_time_ms);
+
+  void TestManyVideoStreams(size_t num_streams);
 };
 
 class VideoRtcpAndSyncObserver : public test::RtpRtcpObserver,
@@ -703,4 +720,305 @@ TEST_F(CallPerfTest, KeepsHighBitrateWhenReconfiguringSender) {
   RunBaseTest(&test);
 }
 
+TEST_F(CallPerfTest, DemuxesRtpToManyReceiveStreams) {
+  static const size_t kNumStreams = 128;
+  static const int kNumPackets = 200000;
+  static const uint32_t kFirstSsrc = 0x10000;
+  static const uint32_t kFirstUnknownSsrc = 0x20000;
+
+  CreateReceiverCall(Call::Config());
+  test::NullTransport rtcp_send_transport;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    VideoReceiveStream::Config config(&rtcp_send_transport);
+    config.rtp.remote_ssrc = kFirstSsrc + static_cast<uint32_t>(i);
+    config.rtp.local_ssrc = kReceiverLocalVideoSsrc;
+    VideoReceiveStream::Decoder decoder;
+    decoder.payload_type = kFakeVideoSendPayloadType;
+    decoder.payload_name = "FAKE";
+    decoder.decoder = new test::FakeDecoder();
+    allocated_decoders_.push_back(
+        std::unique_ptr<VideoDecoder>(decoder.decoder));
+    config.decoders.push_back(decoder);
+    video_receive_streams_.push_back(
+        receiver_call_->CreateVideoReceiveStream(std::move(config)));
+  }
+
+  // The streams are not started, so they drop the packets once the call has
+  // demuxed them, and the time measured is mostly that of the demuxing.
+  uint8_t packet[12] = {0x80, kFakeVideoSendPayloadType};
+  PacketReceiver* receiver = receiver_call_->Receiver();
+  for (uint32_t first_ssrc : {kFirstSsrc, kFirstUnknownSsrc}) {
+    int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumPackets; ++i) {
+      ByteWriter<uint32_t>::WriteBigEndian(
+          &packet[8], first_ssrc + static_cast<uint32_t>(i % kNumStreams));
+      PacketReceiver::DeliveryStatus status = receiver->DeliverPacket(
+          MediaType::ANY, packet, sizeof(packet), PacketTime());
+      EXPECT_EQ(first_ssrc == kFirstSsrc
+                    ? PacketReceiver::DELIVERY_PACKET_ERROR
+                    : PacketReceiver::DELIVERY_UNKNOWN_SSRC,
+                status);
+    }
+    double ns_per_packet =
+        static_cast<double>(rtc::TimeNanos() - start_ns) / kNumPackets;
+    test::PrintResult("demux_time", "",
+                      first_ssrc == kFirstSsrc ? "known_ssrc" : "unknown_ssrc",
+                      ns_per_packet, "ns", false);
+  }
+
+  DestroyStreams();
+  DestroyCalls();
+}
+
+namespace {
+
+// Passes the frames of one capturer on to any number of send streams.
+class FrameFanOut : public rtc::VideoSinkInterface<VideoFrame>,
+                    public rtc::VideoSourceInterface<VideoFrame> {
+ public:
+  void OnFrame(const VideoFrame& frame) override {
+    rtc::CritScope lock(&crit_);
+    for (rtc::VideoSinkInterface<VideoFrame>* sink : sinks_)
+      sink->OnFrame(frame);
+  }
+
+  void AddOrUpdateSink(rtc::VideoSinkInterface<VideoFrame>* sink,
+                       const rtc::VideoSinkWants& wants) override {
+    rtc::CritScope lock(&crit_);
+    sinks_.insert(sink);
+  }
+
+  void RemoveSink(rtc::VideoSinkInterface<VideoFrame>* sink) override {
+    rtc::CritScope lock(&crit_);
+    sinks_.erase(sink);
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  std::set<rtc::VideoSinkInterface<VideoFrame>*> sinks_ GUARDED_BY(crit_);
+};
+
+// Measures how long the receiving call takes to process each packet.
+class TimingPacketReceiver : public PacketReceiver {
+ public:
+  explicit TimingPacketReceiver(PacketReceiver* receiver)
+      : receiver_(receiver) {}
+
+  DeliveryStatus DeliverPacket(MediaType media_type,
+                               const uint8_t* packet,
+                               size_t length,
+                               const PacketTime& packet_time) override {
+    int64_t start_ns = rtc::TimeNanos();
+    DeliveryStatus status =
+        receiver_->DeliverPacket(media_type, packet, length, packet_time);
+    int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    rtc::CritScope lock(&crit_);
+    ++num_packets_;
+    total_ns_ += elapsed_ns;
+    max_ns_ = std::max(max_ns_, elapsed_ns);
+    return status;
+  }
+
+  int64_t num_packets() const {
+    rtc::CritScope lock(&crit_);
+    return num_packets_;
+  }
+  double average_ns() const {
+    rtc::CritScope lock(&crit_);
+    return num_packets_ > 0 ? static_cast<double>(total_ns_) / num_packets_
+                            : 0;
+  }
+  int64_t max_ns() const {
+    rtc::CritScope lock(&crit_);
+    return max_ns_;
+  }
+
+ private:
+  PacketReceiver* const receiver_;
+  rtc::CriticalSection crit_;
+  int64_t num_packets_ GUARDED_BY(crit_) = 0;
+  int64_t total_ns_ GUARDED_BY(crit_) = 0;
+  int64_t max_ns_ GUARDED_BY(crit_) = 0;
+};
+
+// Resident set size of the process, or -1 if unknown.
+int64_t ResidentMemoryBytes() {
+#if defined(WEBRTC_LINUX)
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (!statm)
+    return -1;
+  long size_pages = 0;
+  long resident_pages = 0;
+  int num_read = fscanf(statm, "%ld %ld", &size_pages, &resident_pages);
+  fclose(statm);
+  if (num_read != 2)
+    return -1;
+  return static_cast<int64_t>(resident_pages) * getpagesize();
+#else
+  return -1;
+#endif
+}
+
+int64_t AccountedMemoryBytes() {
+  int64_t bytes = 0;
+  for (const rtc::MemoryUsage& usage : rtc::GetMemoryUsage())
+    bytes += usage.bytes;
+  return bytes;
+}
+
+}  // namespace
+
+// Sends |num_streams| video streams with fake encoders from one call to
+// another over loopback transports, and reports the CPU, memory and threads
+// used, and how long the receiving call takes per packet. The results are
+// printed and written as JSON to the output directory, so that the cost of
+// the paths shared by all streams, like demuxing, pacing, the process thread
+// and statistics, can be tracked as the number of streams grows.
+void CallPerfTest::TestManyVideoStreams(size_t num_streams) {
+  static const int kRunTimeMs = 10000;
+  static const int kFps = 30;
+  static const uint32_t kFirstSsrc = 0x10000;
+
+  rtc::EnableMemoryAccounting();
+  const int64_t start_resident_bytes = ResidentMemoryBytes();
+  const size_t start_num_threads = rtc::GetRunningThreads().size();
+
+  CreateCalls(Call::Config(), Call::Config());
+  test::DirectTransport send_transport(sender_call_.get());
+  test::DirectTransport receive_transport(receiver_call_.get());
+  TimingPacketReceiver timing_receiver(receiver_call_->Receiver());
+  send_transport.SetReceiver(&timing_receiver);
+  receive_transport.SetReceiver(sender_call_->Receiver());
+
+  std::vector<std::unique_ptr<test::FakeEncoder>> encoders;
+  std::vector<VideoSendStream*> send_streams;
+  FrameFanOut fan_out;
+  VideoEncoderConfig encoder_config;
+  encoder_config.streams = test::CreateVideoStreams(1);
+  for (size_t i = 0; i < num_streams; ++i) {
+    const uint32_t ssrc = kFirstSsrc + static_cast<uint32_t>(i);
+    encoders.emplace_back(new test::FakeEncoder(clock_));
+    VideoSendStream::Config send_config(&send_transport);
+    send_config.encoder_settings.encoder = encoders.back().get();
+    send_config.encoder_settings.payload_name = "FAKE";
+    send_config.encoder_settings.payload_type = kFakeVideoSendPayloadType;
+    send_config.rtp.ssrcs.push_back(ssrc);
+
+    VideoReceiveStream::Config receive_config(&receive_transport);
+    receive_config.rtp.remote_ssrc = ssrc;
+    receive_config.rtp.local_ssrc = kReceiverLocalVideoSsrc;
+    VideoReceiveStream::Decoder decoder =
+        test::CreateMatchingDecoder(send_config.encoder_settings);
+    allocated_decoders_.push_back(
+        std::unique_ptr<VideoDecoder>(decoder.decoder));
+    receive_config.decoders.push_back(decoder);
+
+    send_streams.push_back(sender_call_->CreateVideoSendStream(
+        std::move(send_config), encoder_config.Copy()));
+    send_streams.back()->SetSource(&fan_out);
+    video_receive_streams_.push_back(
+        receiver_call_->CreateVideoReceiveStream(std::move(receive_config)));
+  }
+
+  const VideoStream& stream = encoder_config.streams.back();
+  frame_generator_capturer_.reset(test::FrameGeneratorCapturer::Create(
+      stream.width, stream.height, kFps, clock_));
+  frame_generator_capturer_->AddOrUpdateSink(&fan_out, rtc::VideoSinkWants());
+  for (VideoReceiveStream* receive_stream : video_receive_streams_)
+    receive_stream->Start();
+  for (VideoSendStream* send_stream : send_streams)
+    send_stream->Start();
+  frame_generator_capturer_->Start();
+
+  const int64_t start_ms = rtc::TimeMillis();
+  const clock_t start_cpu = clock();
+  SleepMs(kRunTimeMs);
+  // CPU time of all threads of the process, except on Windows where clock()
+  // measures wall time.
+  const double cpu_ms = 1000.0 * (clock() - start_cpu) / CLOCKS_PER_SEC;
+  const int64_t run_time_ms = rtc::TimeMillis() - start_ms;
+  const size_t num_threads =
+      rtc::GetRunningThreads().size() - start_num_threads;
+  const int64_t accounted_bytes = AccountedMemoryBytes();
+  const int64_t end_resident_bytes = ResidentMemoryBytes();
+  int total_decode_fps = 0;
+  for (VideoReceiveStream* receive_stream : video_receive_streams_)
+    total_decode_fps += receive_stream->GetStats().decode_frame_rate;
+
+  frame_generator_capturer_->Stop();
+  frame_generator_capturer_->RemoveSink(&fan_out);
+  for (VideoSendStream* send_stream : send_streams)
+    send_stream->Stop();
+  for (VideoReceiveStream* receive_stream : video_receive_streams_)
+    receive_stream->Stop();
+  send_transport.StopSending();
+  receive_transport.StopSending();
+  for (VideoSendStream* send_stream : send_streams)
+    sender_call_->DestroyVideoSendStream(send_stream);
+  DestroyStreams();
+  DestroyCalls();
+
+  EXPECT_GT(timing_receiver.num_packets(), 0);
+
+  // Microseconds of CPU time per second, i.e. in millionths of a core.
+  const int64_t cpu_us_per_s_per_stream =
+      static_cast<int64_t>(1000 * cpu_ms / run_time_ms) /
+      static_cast<int64_t>(num_streams);
+  const int decode_fps_per_stream =
+      total_decode_fps / static_cast<int>(num_streams);
+  const int64_t resident_bytes_per_stream =
+      start_resident_bytes >= 0 && end_resident_bytes >= 0
+          ? (end_resident_bytes - start_resident_bytes) /
+                static_cast<int64_t>(num_streams)
+          : -1;
+  const std::string trace = std::to_string(num_streams) + "_streams";
+  test::PrintResult("cpu_time_per_stream", "", trace,
+                    cpu_us_per_s_per_stream, "us/s", false);
+  test::PrintResult("decode_fps_per_stream", "", trace,
+                    decode_fps_per_stream, "fps", false);
+  test::PrintResult("threads", "", trace, num_threads, "threads", false);
+  test::PrintResult("accounted_memory", "", trace, accounted_bytes, "bytes",
+                    false);
+  if (resident_bytes_per_stream >= 0) {
+    test::PrintResult("resident_memory_per_stream", "", trace,
+                      resident_bytes_per_stream, "bytes", false);
+  }
+  test::PrintResult("packet_processing_time", "", trace,
+                    timing_receiver.average_ns(), "ns", false);
+  test::PrintResult("max_packet_processing_time", "", trace,
+                    timing_receiver.max_ns(), "ns", false);
+
+  const std::string report_path =
+      test::OutputPath() + "call_perf_many_video_streams_" + trace + ".json";
+  FILE* report = fopen(report_path.c_str(), "w");
+  ASSERT_TRUE(report != nullptr) << "Can't write " << report_path;
+  fprintf(report,
+          "{\"num_streams\": %" PRIuS ", \"run_time_ms\": %" PRId64
+          ", \"cpu_time_per_stream_us_per_s\": %" PRId64
+          ", \"decode_fps_per_stream\": %d, \"threads\": %" PRIuS
+          ", \"accounted_memory_bytes\": %" PRId64
+          ", \"resident_memory_bytes_per_stream\": %" PRId64
+          ", \"received_packets\": %" PRId64
+          ", \"packet_processing_time_ns\": %.0f"
+          ", \"max_packet_processing_time_ns\": %" PRId64 "}\n",
+          num_streams, run_time_ms, cpu_us_per_s_per_stream,
+          decode_fps_per_stream, num_threads, accounted_bytes,
+          resident_bytes_per_stream, timing_receiver.num_packets(),
+          timing_receiver.average_ns(), timing_receiver.max_ns());
+  fclose(report);
+}
+
+TEST_F(CallPerfTest, SendsOneVideoStream) {
+  TestManyVideoStreams(1);
+}
+
+TEST_F(CallPerfTest, SendsManyVideoStreams) {
+  TestManyVideoStreams(32);
+}
+
+// Takes a few cores; run manually to see how far a call scales.
+TEST_F(CallPerfTest, DISABLED_SendsVeryManyVideoStreams) {
+  TestManyVideoStreams(500);
+}
+
 }  // namespace webrtc
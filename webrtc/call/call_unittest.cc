@@ -8,14 +8,22 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/api/call/audio_state.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/task_queue.h"
 #include "webrtc/call.h"
 #include "webrtc/modules/audio_coding/codecs/mock/mock_audio_decoder_factory.h"
+#include "webrtc/modules/utility/include/process_thread.h"
 #include "webrtc/test/mock_voice_engine.h"
 
 namespace {
@@ -31,12 +39,70 @@ struct CallHelper {
     call_.reset(webrtc::Call::Create(config));
   }
 
+  // Creates a call on the threads of |shared|.
+  explicit CallHelper(const webrtc::Call::Config& shared)
+      : voice_engine_(nullptr) {
+    webrtc::AudioState::Config audio_state_config;
+    audio_state_config.voice_engine = &voice_engine_;
+    webrtc::Call::Config config = shared;
+    config.audio_state = webrtc::AudioState::Create(audio_state_config);
+    call_.reset(webrtc::Call::Create(config));
+  }
+
   webrtc::Call* operator->() { return call_.get(); }
 
  private:
   testing::NiceMock<webrtc::test::MockVoiceEngine> voice_engine_;
   std::unique_ptr<webrtc::Call> call_;
 };
+// Threads for calls to share.
+struct SharedThreads {
+  SharedThreads()
+      : module_process_thread(
+            webrtc::ProcessThread::Create("ModuleProcessThread")),
+        pacer_thread(webrtc::ProcessThread::Create("PacerThread")),
+        worker_queue("call_worker_queue") {
+    module_process_thread->Start();
+    pacer_thread->Start();
+  }
+  ~SharedThreads() {
+    pacer_thread->Stop();
+    module_process_thread->Stop();
+  }
+
+  webrtc::Call::Config config() {
+    webrtc::Call::Config config;
+    config.module_process_thread = module_process_thread.get();
+    config.pacer_thread = pacer_thread.get();
+    config.worker_queue = &worker_queue;
+    return config;
+  }
+
+  std::unique_ptr<webrtc::ProcessThread> module_process_thread;
+  std::unique_ptr<webrtc::ProcessThread> pacer_thread;
+  rtc::TaskQueue worker_queue;
+};
+
+#if defined(WEBRTC_LINUX)
+// Reads a "<key>: <value>" line of /proc/self/status, e.g. the number of
+// threads or the resident set size in kB. Returns -1 on failure.
+int ReadProcStatus(const char* key) {
+  FILE* file = fopen("/proc/self/status", "r");
+  if (!file)
+    return -1;
+  char line[256];
+  int value = -1;
+  size_t key_length = strlen(key);
+  while (fgets(line, sizeof(line), file)) {
+    if (strncmp(line, key, key_length) == 0 && line[key_length] == ':') {
+      value = atoi(line + key_length + 1);
+      break;
+    }
+  }
+  fclose(file);
+  return value;
+}
+#endif
 }  // namespace
 
 namespace webrtc {
@@ -116,4 +182,51 @@ TEST(CallTest, CreateDestroy_AudioReceiveStreams) {
     streams.clear();
   }
 }
+TEST(CallTest, CreateDestroy_CallsWithSharedThreads) {
+  SharedThreads threads;
+  std::list<std::unique_ptr<CallHelper>> calls;
+  for (int i = 0; i < 3; ++i) {
+    calls.emplace_back(new CallHelper(threads.config()));
+    AudioSendStream::Config config(nullptr);
+    config.rtp.ssrc = 42;
+    config.voe_channel_id = 123;
+    AudioSendStream* stream = (*calls.back())->CreateAudioSendStream(config);
+    EXPECT_NE(stream, nullptr);
+    (*calls.back())->DestroyAudioSendStream(stream);
+  }
+  // Calls on shared threads go away in any order.
+  calls.pop_back();
+  calls.pop_front();
+  calls.clear();
+}
+
+#if defined(WEBRTC_LINUX)
+// Measures the threads and memory each call costs, with threads of its own
+// and with shared ones.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(CallTest, DISABLED_ThreadsAndMemoryPerCall) {
+  const int kCalls = 100;
+  SharedThreads threads;
+  for (bool shared : {false, true}) {
+    int threads_before = ReadProcStatus("Threads");
+    int rss_before_kb = ReadProcStatus("VmRSS");
+    std::vector<std::unique_ptr<CallHelper>> calls;
+    for (int i = 0; i < kCalls; ++i) {
+      calls.emplace_back(shared ? new CallHelper(threads.config())
+                                : new CallHelper());
+    }
+    int threads_per_call = (ReadProcStatus("Threads") - threads_before) /
+                           kCalls;
+    int rss_per_call_kb = (ReadProcStatus("VmRSS") - rss_before_kb) / kCalls;
+    LOG(LS_INFO) << kCalls << " calls on " << (shared ? "shared" : "own")
+                 << " threads: " << threads_per_call << " thread(s) and "
+                 << rss_per_call_kb << " kB resident per call";
+    if (shared)
+      EXPECT_EQ(0, threads_per_call);
+    else
+      EXPECT_LE(3, threads_per_call);
+  }
+}
+#endif
+
 }  // namespace webrtc
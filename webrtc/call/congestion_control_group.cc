@@ -0,0 +1,236 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/congestion_control_group.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/call/rtc_event_log.h"
+#include "webrtc/modules/pacing/paced_sender.h"
+#include "webrtc/modules/utility/include/process_thread.h"
+
+namespace webrtc {
+
+namespace {
+// Max bitrate of a call without a configured one. Well above what a call will
+// send, while leaving room to sum the max bitrates of many calls.
+const uint32_t kDefaultMaxCallBitrateBps = 100000000;
+}  // namespace
+
+CongestionControlGroup::CongestionControlGroup(
+    Clock* clock,
+    ProcessThread* module_process_thread,
+    ProcessThread* pacer_thread)
+    : module_process_thread_(module_process_thread),
+      pacer_thread_(pacer_thread),
+      event_log_(RtcEventLog::CreateNull()),
+      remb_(clock),
+      congestion_controller_(
+          new CongestionController(clock, this, &remb_, event_log_.get())),
+      bitrate_allocator_(new BitrateAllocator(this)),
+      network_state_(kNetworkUp),
+      task_queue_("congestion_control_group") {
+  RTC_DCHECK(module_process_thread_);
+  RTC_DCHECK(pacer_thread_);
+  module_process_thread_->RegisterModule(congestion_controller_.get());
+  pacer_thread_->RegisterModule(congestion_controller_->pacer());
+  pacer_thread_->RegisterModule(
+      congestion_controller_->GetRemoteBitrateEstimator(true));
+}
+
+CongestionControlGroup::~CongestionControlGroup() {
+  RTC_DCHECK(!remb_.InUse());
+  pacer_thread_->DeRegisterModule(congestion_controller_->pacer());
+  pacer_thread_->DeRegisterModule(
+      congestion_controller_->GetRemoteBitrateEstimator(true));
+  module_process_thread_->DeRegisterModule(congestion_controller_.get());
+}
+
+void CongestionControlGroup::AddCall(
+    BitrateAllocatorObserver* call,
+    const Call::Config::BitrateConfig& bitrate_config,
+    double bitrate_priority) {
+  RTC_DCHECK_GT(bitrate_priority, 0.0);
+  task_queue_.PostTask([this, call, bitrate_config, bitrate_priority] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    RTC_DCHECK(calls_.find(call) == calls_.end());
+    CallConfig& config = calls_[call];
+    config.bitrate_config = bitrate_config;
+    config.bitrate_priority = bitrate_priority;
+    UpdateBweBitrates(calls_.size() == 1);
+    UpdateAllocation(call);
+    UpdateNetworkState();
+  });
+}
+
+void CongestionControlGroup::RemoveCall(BitrateAllocatorObserver* call) {
+  rtc::Event done(false, false);
+  task_queue_.PostTask([this, call, &done] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    bitrate_allocator_->RemoveObserver(call);
+    calls_.erase(call);
+    UpdateBweBitrates(false);
+    UpdateNetworkState();
+    done.Set();
+  });
+  done.Wait(rtc::Event::kForever);
+}
+
+void CongestionControlGroup::SetBitrateConfig(
+    BitrateAllocatorObserver* call,
+    const Call::Config::BitrateConfig& bitrate_config) {
+  task_queue_.PostTask([this, call, bitrate_config] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    auto it = calls_.find(call);
+    // A call may report changes while it is leaving the group.
+    if (it == calls_.end())
+      return;
+    it->second.bitrate_config = bitrate_config;
+    UpdateBweBitrates(false);
+    UpdateAllocation(call);
+  });
+}
+
+void CongestionControlGroup::SetAllocationLimits(
+    BitrateAllocatorObserver* call,
+    uint32_t min_send_bitrate_bps,
+    uint32_t max_padding_bitrate_bps) {
+  task_queue_.PostTask(
+      [this, call, min_send_bitrate_bps, max_padding_bitrate_bps] {
+        RTC_DCHECK_RUN_ON(&task_queue_);
+        auto it = calls_.find(call);
+        if (it == calls_.end())
+          return;
+        it->second.min_send_bitrate_bps = min_send_bitrate_bps;
+        it->second.max_padding_bitrate_bps = max_padding_bitrate_bps;
+        UpdateAllocation(call);
+      });
+}
+
+void CongestionControlGroup::SignalNetworkState(BitrateAllocatorObserver* call,
+                                                NetworkState state) {
+  task_queue_.PostTask([this, call, state] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    auto it = calls_.find(call);
+    if (it == calls_.end())
+      return;
+    it->second.network_state = state;
+    UpdateAllocation(call);
+    UpdateNetworkState();
+  });
+}
+
+void CongestionControlGroup::ResetBweAndBitrates() {
+  task_queue_.PostTask([this] {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    Call::Config::BitrateConfig bitrate_config = AggregateBitrateConfig();
+    LOG(LS_INFO) << "Reset shared bitrates to min: "
+                 << bitrate_config.min_bitrate_bps
+                 << " bps, start: " << bitrate_config.start_bitrate_bps
+                 << " bps, max: " << bitrate_config.max_bitrate_bps << " bps.";
+    congestion_controller_->ResetBweAndBitrates(
+        bitrate_config.start_bitrate_bps, bitrate_config.min_bitrate_bps,
+        bitrate_config.max_bitrate_bps);
+  });
+}
+
+void CongestionControlGroup::OnNetworkChanged(uint32_t target_bitrate_bps,
+                                              uint8_t fraction_loss,
+                                              int64_t rtt_ms) {
+  if (!task_queue_.IsCurrent()) {
+    task_queue_.PostTask([this, target_bitrate_bps, fraction_loss, rtt_ms] {
+      OnNetworkChanged(target_bitrate_bps, fraction_loss, rtt_ms);
+    });
+    return;
+  }
+  RTC_DCHECK_RUN_ON(&task_queue_);
+  bitrate_allocator_->OnNetworkChanged(target_bitrate_bps, fraction_loss,
+                                       rtt_ms);
+}
+
+void CongestionControlGroup::OnAllocationLimitsChanged(
+    uint32_t min_send_bitrate_bps,
+    uint32_t max_padding_bitrate_bps) {
+  congestion_controller_->SetAllocatedSendBitrateLimits(
+      min_send_bitrate_bps, max_padding_bitrate_bps);
+}
+
+void CongestionControlGroup::UpdateAllocation(BitrateAllocatorObserver* call) {
+  RTC_DCHECK_RUN_ON(&task_queue_);
+  RTC_DCHECK(calls_.find(call) != calls_.end());
+  const CallConfig& config = calls_[call];
+  if (config.network_state == kNetworkDown) {
+    // A call that is down shouldn't hold on to any of the bitrate.
+    bitrate_allocator_->RemoveObserver(call);
+    call->OnBitrateUpdated(0, 0, 0);
+    return;
+  }
+  uint32_t max_bitrate_bps = kDefaultMaxCallBitrateBps;
+  if (config.bitrate_config.max_bitrate_bps > 0)
+    max_bitrate_bps = config.bitrate_config.max_bitrate_bps;
+  // The min send bitrate of a call is what its streams enforce, which this
+  // allocation then enforces too.
+  bitrate_allocator_->AddObserver(
+      call, config.min_send_bitrate_bps,
+      std::max(max_bitrate_bps, config.min_send_bitrate_bps),
+      config.max_padding_bitrate_bps, true);
+  bitrate_allocator_->SetBitratePriority(call, config.bitrate_priority);
+}
+
+Call::Config::BitrateConfig CongestionControlGroup::AggregateBitrateConfig()
+    const {
+  RTC_DCHECK_RUN_ON(&task_queue_);
+  Call::Config::BitrateConfig aggregate;
+  aggregate.start_bitrate_bps = 0;
+  aggregate.max_bitrate_bps = 0;
+  for (const auto& kv : calls_) {
+    const Call::Config::BitrateConfig& bitrate_config =
+        kv.second.bitrate_config;
+    aggregate.min_bitrate_bps += bitrate_config.min_bitrate_bps;
+    aggregate.start_bitrate_bps += bitrate_config.start_bitrate_bps;
+    if (aggregate.max_bitrate_bps != -1) {
+      aggregate.max_bitrate_bps =
+          bitrate_config.max_bitrate_bps == -1
+              ? -1
+              : aggregate.max_bitrate_bps + bitrate_config.max_bitrate_bps;
+    }
+  }
+  return aggregate;
+}
+
+void CongestionControlGroup::UpdateBweBitrates(bool set_start_bitrate) {
+  RTC_DCHECK_RUN_ON(&task_queue_);
+  if (calls_.empty())
+    return;
+  Call::Config::BitrateConfig bitrate_config = AggregateBitrateConfig();
+  // Start bitrate of -1 means the current estimate is kept.
+  congestion_controller_->SetBweBitrates(
+      bitrate_config.min_bitrate_bps,
+      set_start_bitrate ? bitrate_config.start_bitrate_bps : -1,
+      bitrate_config.max_bitrate_bps);
+}
+
+void CongestionControlGroup::UpdateNetworkState() {
+  RTC_DCHECK_RUN_ON(&task_queue_);
+  NetworkState network_state = kNetworkDown;
+  for (const auto& kv : calls_) {
+    if (kv.second.network_state == kNetworkUp)
+      network_state = kNetworkUp;
+  }
+  if (network_state == network_state_)
+    return;
+  network_state_ = network_state;
+  congestion_controller_->SignalNetworkState(network_state_);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_CALL_CONGESTION_CONTROL_GROUP_H_
+#define WEBRTC_CALL_CONGESTION_CONTROL_GROUP_H_
+
+#include <map>
+#include <memory>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/task_queue.h"
+#include "webrtc/base/thread_checker.h"
+#include "webrtc/call.h"
+#include "webrtc/call/bitrate_allocator.h"
+#include "webrtc/modules/congestion_controller/include/congestion_controller.h"
+#include "webrtc/video/vie_remb.h"
+
+namespace webrtc {
+
+class Clock;
+class ProcessThread;
+class RtcEventLog;
+
+// Bandwidth estimation and pacing shared by calls whose transports go over the
+// same network path, e.g. several PeerConnections to the same server. Running
+// one estimator and one pacer for the path keeps the calls from competing with
+// each other for the bottleneck. The estimate is split between the calls by a
+// BitrateAllocator, in proportion to their Call::Config::bitrate_priority once
+// the min send bitrate of every call has been met.
+//
+// The process threads must be started and must outlive the group, and the
+// group must outlive the calls using it.
+class CongestionControlGroup : public CongestionController::Observer,
+                               public BitrateAllocator::LimitObserver {
+ public:
+  CongestionControlGroup(Clock* clock,
+                         ProcessThread* module_process_thread,
+                         ProcessThread* pacer_thread);
+  ~CongestionControlGroup() override;
+
+  CongestionController* congestion_controller() {
+    return congestion_controller_.get();
+  }
+  // Sends the REMB messages for the receive streams of all calls.
+  VieRemb* remb() { return &remb_; }
+
+  // The methods below are called by the calls in the group. A call gets its
+  // share of the estimate through OnBitrateUpdated(), on a task queue owned by
+  // the group.
+  void AddCall(BitrateAllocatorObserver* call,
+               const Call::Config::BitrateConfig& bitrate_config,
+               double bitrate_priority);
+  // No bitrate updates are delivered to |call| once this returns.
+  void RemoveCall(BitrateAllocatorObserver* call);
+  void SetBitrateConfig(BitrateAllocatorObserver* call,
+                        const Call::Config::BitrateConfig& bitrate_config);
+  void SetAllocationLimits(BitrateAllocatorObserver* call,
+                           uint32_t min_send_bitrate_bps,
+                           uint32_t max_padding_bitrate_bps);
+  void SignalNetworkState(BitrateAllocatorObserver* call, NetworkState state);
+  // Restarts the estimate, e.g. after the network route of a call changed.
+  void ResetBweAndBitrates();
+
+  // Implements CongestionController::Observer.
+  void OnNetworkChanged(uint32_t target_bitrate_bps,
+                        uint8_t fraction_loss,
+                        int64_t rtt_ms) override;
+
+  // Implements BitrateAllocator::LimitObserver.
+  void OnAllocationLimitsChanged(uint32_t min_send_bitrate_bps,
+                                 uint32_t max_padding_bitrate_bps) override;
+
+ private:
+  struct CallConfig {
+    Call::Config::BitrateConfig bitrate_config;
+    double bitrate_priority = 1.0;
+    uint32_t min_send_bitrate_bps = 0;
+    uint32_t max_padding_bitrate_bps = 0;
+    NetworkState network_state = kNetworkUp;
+  };
+
+  // Hands the current config of |call| to |bitrate_allocator_|.
+  void UpdateAllocation(BitrateAllocatorObserver* call);
+  // Returns the sum of the bitrate configs of the calls.
+  Call::Config::BitrateConfig AggregateBitrateConfig() const;
+  // Configures the shared BWE with the aggregate bitrate config. The start
+  // bitrate is only used for the first call, so that calls joining later don't
+  // reset the estimate of the path.
+  void UpdateBweBitrates(bool set_start_bitrate);
+  void UpdateNetworkState();
+
+  ProcessThread* const module_process_thread_;
+  ProcessThread* const pacer_thread_;
+  const std::unique_ptr<RtcEventLog> event_log_;
+  VieRemb remb_;
+  const std::unique_ptr<CongestionController> congestion_controller_;
+  const std::unique_ptr<BitrateAllocator> bitrate_allocator_;
+  std::map<BitrateAllocatorObserver*, CallConfig> calls_
+      ACCESS_ON(&task_queue_);
+  NetworkState network_state_ ACCESS_ON(&task_queue_);
+
+  // Defined last to ensure all pending tasks are cancelled and deleted before
+  // any other members.
+  rtc::TaskQueue task_queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CongestionControlGroup);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_CALL_CONGESTION_CONTROL_GROUP_H_
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/call/congestion_control_group.h"
+#include "webrtc/modules/utility/include/process_thread.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+namespace {
+const int kWaitTimeoutMs = 1000;
+
+// Stands in for a call, receiving its share of the estimate.
+class TestCall : public BitrateAllocatorObserver {
+ public:
+  TestCall() : updated_(false, false), bitrate_bps_(0) {}
+
+  uint32_t OnBitrateUpdated(uint32_t bitrate_bps,
+                            uint8_t fraction_loss,
+                            int64_t rtt) override {
+    {
+      rtc::CritScope lock(&crit_);
+      bitrate_bps_ = bitrate_bps;
+    }
+    updated_.Set();
+    return 0;
+  }
+
+  // Returns true if the share of the call becomes |bitrate_bps|.
+  bool WaitForBitrate(uint32_t bitrate_bps) {
+    while (true) {
+      {
+        rtc::CritScope lock(&crit_);
+        if (bitrate_bps_ == bitrate_bps)
+          return true;
+      }
+      if (!updated_.Wait(kWaitTimeoutMs))
+        return false;
+    }
+  }
+
+ private:
+  rtc::Event updated_;
+  rtc::CriticalSection crit_;
+  uint32_t bitrate_bps_ GUARDED_BY(crit_);
+};
+}  // namespace
+
+class CongestionControlGroupTest : public ::testing::Test {
+ protected:
+  // The process threads aren't started, so that the shared estimate only
+  // changes through OnNetworkChanged() in the tests.
+  CongestionControlGroupTest()
+      : clock_(0),
+        module_process_thread_(ProcessThread::Create("ModuleProcessThread")),
+        pacer_thread_(ProcessThread::Create("PacerThread")),
+        group_(new CongestionControlGroup(&clock_,
+                                          module_process_thread_.get(),
+                                          pacer_thread_.get())) {}
+
+  SimulatedClock clock_;
+  std::unique_ptr<ProcessThread> module_process_thread_;
+  std::unique_ptr<ProcessThread> pacer_thread_;
+  std::unique_ptr<CongestionControlGroup> group_;
+};
+
+TEST_F(CongestionControlGroupTest, SplitsEstimateByBitratePriority) {
+  TestCall call_1;
+  TestCall call_2;
+  group_->AddCall(&call_1, Call::Config::BitrateConfig(), 1.0);
+  group_->AddCall(&call_2, Call::Config::BitrateConfig(), 3.0);
+
+  group_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_TRUE(call_1.WaitForBitrate(100000));
+  EXPECT_TRUE(call_2.WaitForBitrate(300000));
+
+  group_->RemoveCall(&call_1);
+  group_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_TRUE(call_2.WaitForBitrate(400000));
+  group_->RemoveCall(&call_2);
+}
+
+TEST_F(CongestionControlGroupTest, MinSendBitrateIsMetFirst) {
+  TestCall call_1;
+  TestCall call_2;
+  group_->AddCall(&call_1, Call::Config::BitrateConfig(), 1.0);
+  group_->AddCall(&call_2, Call::Config::BitrateConfig(), 1.0);
+  group_->SetAllocationLimits(&call_1, 200000, 0);
+
+  group_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_TRUE(call_1.WaitForBitrate(300000));
+  EXPECT_TRUE(call_2.WaitForBitrate(100000));
+
+  group_->RemoveCall(&call_1);
+  group_->RemoveCall(&call_2);
+}
+
+TEST_F(CongestionControlGroupTest, CallThatIsDownGetsNoBitrate) {
+  TestCall call_1;
+  TestCall call_2;
+  group_->AddCall(&call_1, Call::Config::BitrateConfig(), 1.0);
+  group_->AddCall(&call_2, Call::Config::BitrateConfig(), 1.0);
+  group_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_TRUE(call_1.WaitForBitrate(200000));
+
+  group_->SignalNetworkState(&call_1, kNetworkDown);
+  EXPECT_TRUE(call_1.WaitForBitrate(0));
+  group_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_TRUE(call_2.WaitForBitrate(400000));
+
+  group_->SignalNetworkState(&call_1, kNetworkUp);
+  group_->OnNetworkChanged(400000, 0, 0);
+  EXPECT_TRUE(call_1.WaitForBitrate(200000));
+  EXPECT_TRUE(call_2.WaitForBitrate(200000));
+
+  group_->RemoveCall(&call_1);
+  group_->RemoveCall(&call_2);
+}
+
+}  // namespace webrtc
@@ -20,9 +20,19 @@
 #include "webrtc/base/thread_checker.h"
 #include "webrtc/call.h"
 #include "webrtc/call/rtc_event_log_helper_thread.h"
+#include "webrtc/call/rtc_event_log_rtp_batch.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
-#include "webrtc/modules/rtp_rtcp/source/rtcp_utility.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/app.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/bye.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/extended_jitter_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/psfb.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
 #include "webrtc/system_wrappers/include/logging.h"
@@ -72,8 +82,13 @@ class RtcEventLogImpl final : public RtcEventLog {
   // Message queue for passing control messages to the logging thread.
   SwapQueue<RtcEventLogHelperThread::ControlMessage> message_queue_;
 
-  // Message queue for passing events to the logging thread.
-  SwapQueue<std::unique_ptr<rtclog::Event> > event_queue_;
+  // Message queue for passing events to the logging thread. Events are logged
+  // from many threads, so the queue doesn't take a lock.
+  MpscSwapQueue<std::unique_ptr<rtclog::Event>> event_queue_;
+
+  // Message queue for passing RTP headers to the logging thread. Unlike the
+  // events above, the headers don't need any allocations.
+  MpscSwapQueue<LoggedRtpHeader> rtp_header_queue_;
 
   const Clock* const clock_;
 
@@ -128,9 +143,11 @@ RtcEventLogImpl::RtcEventLogImpl(const Clock* clock)
     // Allocate buffers for roughly one second of history.
     : message_queue_(kControlMessagesPerSecond),
       event_queue_(kEventsPerSecond),
+      rtp_header_queue_(kEventsPerSecond),
       clock_(clock),
       helper_thread_(&message_queue_,
                      &event_queue_,
+                     &rtp_header_queue_,
                      clock),
       thread_checker_() {
   thread_checker_.DetachFromThread();
@@ -305,6 +322,23 @@ void RtcEventLogImpl::LogRtpHeader(PacketDirection direction,
     header_length += (x_len + 1) * 4;
   }
 
+  if (header_length <= LoggedRtpHeader::kMaxHeaderLength &&
+      header_length <= packet_length && packet_length <= 0xFFFF) {
+    LoggedRtpHeader rtp_header;
+    rtp_header.timestamp_us = clock_->TimeInMicroseconds();
+    rtp_header.media_type = media_type;
+    rtp_header.incoming = direction == kIncomingPacket;
+    rtp_header.header_length = static_cast<uint8_t>(header_length);
+    rtp_header.packet_length = static_cast<uint16_t>(packet_length);
+    memcpy(rtp_header.header, header, header_length);
+    if (!rtp_header_queue_.Insert(&rtp_header)) {
+      LOG(LS_ERROR) << "WebRTC event log queue full. Dropping RTP header.";
+    }
+    helper_thread_.SignalNewEvent();
+    return;
+  }
+
+  // Unusually long headers are logged as individual events.
   std::unique_ptr<rtclog::Event> rtp_event(new rtclog::Event());
   rtp_event->set_timestamp_us(clock_->TimeInMicroseconds());
   rtp_event->set_type(rtclog::Event::RTP_EVENT);
@@ -325,41 +359,41 @@ void RtcEventLogImpl::LogRtcpPacket(PacketDirection direction,
   rtcp_event->mutable_rtcp_packet()->set_incoming(direction == kIncomingPacket);
   rtcp_event->mutable_rtcp_packet()->set_type(ConvertMediaType(media_type));
 
-  RTCPUtility::RtcpCommonHeader header;
+  rtcp::CommonHeader header;
   const uint8_t* block_begin = packet;
   const uint8_t* packet_end = packet + length;
   RTC_DCHECK(length <= IP_PACKET_SIZE);
   uint8_t buffer[IP_PACKET_SIZE];
   uint32_t buffer_length = 0;
   while (block_begin < packet_end) {
-    if (!RtcpParseCommonHeader(block_begin, packet_end - block_begin,
-                               &header)) {
+    if (!header.Parse(block_begin, packet_end - block_begin)) {
       break;  // Incorrect message header.
     }
-    uint32_t block_size = header.BlockSize();
-    switch (header.packet_type) {
-      case RTCPUtility::PT_SR:
+    const uint8_t* next_block = header.NextPacket();
+    uint32_t block_size = next_block - block_begin;
+    switch (header.type()) {
+      case rtcp::SenderReport::kPacketType:
         FALLTHROUGH();
-      case RTCPUtility::PT_RR:
+      case rtcp::ReceiverReport::kPacketType:
         FALLTHROUGH();
-      case RTCPUtility::PT_BYE:
+      case rtcp::Bye::kPacketType:
         FALLTHROUGH();
-      case RTCPUtility::PT_IJ:
+      case rtcp::ExtendedJitterReport::kPacketType:
         FALLTHROUGH();
-      case RTCPUtility::PT_RTPFB:
+      case rtcp::Rtpfb::kPacketType:
         FALLTHROUGH();
-      case RTCPUtility::PT_PSFB:
+      case rtcp::Psfb::kPacketType:
         FALLTHROUGH();
-      case RTCPUtility::PT_XR:
+      case rtcp::ExtendedReports::kPacketType:
         // We log sender reports, receiver reports, bye messages
         // inter-arrival jitter, third-party loss reports, payload-specific
         // feedback and extended reports.
         memcpy(buffer + buffer_length, block_begin, block_size);
         buffer_length += block_size;
         break;
-      case RTCPUtility::PT_SDES:
+      case rtcp::Sdes::kPacketType:
         FALLTHROUGH();
-      case RTCPUtility::PT_APP:
+      case rtcp::App::kPacketType:
         FALLTHROUGH();
       default:
         // We don't log sender descriptions, application defined messages
@@ -367,7 +401,7 @@ void RtcEventLogImpl::LogRtcpPacket(PacketDirection direction,
         break;
     }
 
-    block_begin += block_size;
+    block_begin = next_block;
   }
   rtcp_event->mutable_rtcp_packet()->set_packet_data(buffer, buffer_length);
   StoreEvent(&rtcp_event);
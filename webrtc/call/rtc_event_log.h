@@ -104,6 +104,8 @@ class RtcEventLog {
   // The current implementation writes a LOG_START event, then the old
   // configurations, then the remaining events in timestamp order and finally
   // a LOG_END event. However, this might change without further notice.
+  // Most RTP headers are stored in RTP_HEADER_BATCH_EVENTs, which
+  // ParsedRtcEventLog converts to one RTP_EVENT per header.
   // TODO(terelius): Change result type to a vector?
   static bool ParseRtcEventLog(const std::string& file_name,
                                rtclog::EventStream* result);
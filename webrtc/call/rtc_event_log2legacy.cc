@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "gflags/gflags.h"
+#include "webrtc/call/rtc_event_log_parser.h"
+
+// This utility will convert a stored event log to the format without RTP
+// header batches, with one RTP_EVENT per logged header.
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Tool for converting an RtcEventLog file to the format used before RTP "
+      "headers were logged in batches.\n"
+      "Run " +
+      program_name +
+      " --helpshort for usage.\n"
+      "Example usage:\n" +
+      program_name + " input.rel output.rel\n";
+  google::SetUsageMessage(usage);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (argc != 3) {
+    std::cout << google::ProgramUsage();
+    return 0;
+  }
+  std::string input_file = argv[1];
+  std::string output_file = argv[2];
+
+  webrtc::ParsedRtcEventLog parsed_stream;
+  if (!parsed_stream.ParseFile(input_file)) {
+    std::cerr << "Error while parsing input file: " << input_file << std::endl;
+    return -1;
+  }
+
+  std::ofstream output(output_file, std::ios_base::out | std::ios_base::binary);
+  if (!output.is_open()) {
+    std::cerr << "Error while opening output file: " << output_file
+              << std::endl;
+    return -1;
+  }
+  if (!parsed_stream.WriteLegacyFormat(&output)) {
+    std::cerr << "Error while writing output file: " << output_file
+              << std::endl;
+    return -1;
+  }
+
+  std::cout << "Wrote " << parsed_stream.GetNumberOfEvents()
+            << " events to the output file." << std::endl;
+  return 0;
+}
@@ -22,6 +22,19 @@ namespace webrtc {
 namespace {
 const int kEventsInHistory = 10000;
 
+// Limits the RTP headers buffered for a batch. When the writer thread wakes
+// up every 100 ms, a batch typically holds all headers since the last wake-up.
+// ParsedRtcEventLog doesn't accept events larger than 64 kB.
+const size_t kMaxHeadersPerBatch = 1000;
+const size_t kMaxRtpHeaderBatchBytes = 32768;
+
+// Upper bounds for the encoded size of an RTP header in a batch and for the
+// fields of the RTP_HEADER_BATCH_EVENT around the headers, used to stay within
+// the file size limit.
+const size_t kMaxEncodedRtpHeaderLength =
+    40 + LoggedRtpHeader::kMaxHeaderLength;
+const size_t kMaxRtpHeaderBatchOverhead = 40;
+
 bool IsConfigEvent(const rtclog::Event& event) {
   rtclog::Event_EventType event_type = event.type();
   return event_type == rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT ||
@@ -34,11 +47,14 @@ bool IsConfigEvent(const rtclog::Event& event) {
 // RtcEventLogImpl member functions.
 RtcEventLogHelperThread::RtcEventLogHelperThread(
     SwapQueue<ControlMessage>* message_queue,
-    SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue,
+    MpscSwapQueue<std::unique_ptr<rtclog::Event>>* event_queue,
+    MpscSwapQueue<LoggedRtpHeader>* rtp_header_queue,
     const Clock* const clock)
     : message_queue_(message_queue),
       event_queue_(event_queue),
+      rtp_header_queue_(rtp_header_queue),
       history_(kEventsInHistory),
+      rtp_header_history_(kEventsInHistory),
       config_history_(),
       file_(FileWrapper::Create()),
       thread_(&ThreadOutputFunction, this, "RtcEventLog thread"),
@@ -48,6 +64,7 @@ RtcEventLogHelperThread::RtcEventLogHelperThread(
       stop_time_(std::numeric_limits<int64_t>::max()),
       has_recent_event_(false),
       most_recent_event_(),
+      has_recent_rtp_header_(false),
       output_string_(),
       wake_periodically_(false, false),
       wake_from_hibernation_(false, false),
@@ -55,6 +72,7 @@ RtcEventLogHelperThread::RtcEventLogHelperThread(
       clock_(clock) {
   RTC_DCHECK(message_queue_);
   RTC_DCHECK(event_queue_);
+  RTC_DCHECK(rtp_header_queue_);
   RTC_DCHECK(clock_);
   thread_.Start();
 }
@@ -106,6 +124,41 @@ bool RtcEventLogHelperThread::AppendEventToString(rtclog::Event* event) {
   return stop;
 }
 
+bool RtcEventLogHelperThread::AppendRtpHeaderToBatch(
+    const LoggedRtpHeader& header) {
+  auto header_fits = [this] {
+    return written_bytes_ +
+               static_cast<int64_t>(output_string_.size() +
+                                    rtp_header_batch_.size_bytes() +
+                                    kMaxRtpHeaderBatchOverhead +
+                                    kMaxEncodedRtpHeaderLength) <=
+           max_size_bytes_;
+  };
+  if (rtp_header_batch_.num_headers() == kMaxHeadersPerBatch ||
+      rtp_header_batch_.size_bytes() + kMaxEncodedRtpHeaderLength >
+          kMaxRtpHeaderBatchBytes ||
+      !header_fits()) {
+    if (AppendRtpHeaderBatchToString() || !header_fits())
+      return true;
+  }
+  rtp_header_batch_.Add(header);
+  return false;
+}
+
+bool RtcEventLogHelperThread::AppendRtpHeaderBatchToString() {
+  if (rtp_header_batch_.empty())
+    return false;
+  rtp_header_batch_event_.set_timestamp_us(
+      rtp_header_batch_.first_timestamp_us());
+  rtp_header_batch_event_.set_type(rtclog::Event::RTP_HEADER_BATCH_EVENT);
+  rtclog::RtpHeaderBatch* batch =
+      rtp_header_batch_event_.mutable_rtp_header_batch();
+  batch->set_num_headers(rtp_header_batch_.num_headers());
+  // Swapping the buffers lets the batches reuse each other's memory.
+  rtp_header_batch_.Finish(batch->mutable_headers());
+  return AppendEventToString(&rtp_header_batch_event_);
+}
+
 bool RtcEventLogHelperThread::LogToMemory() {
   RTC_DCHECK(!file_->is_open());
   bool message_received = false;
@@ -126,6 +179,18 @@ bool RtcEventLogHelperThread::LogToMemory() {
     has_recent_event_ = event_queue_->Remove(&most_recent_event_);
     message_received = true;
   }
+
+  if (!has_recent_rtp_header_) {
+    has_recent_rtp_header_ =
+        rtp_header_queue_->Remove(&most_recent_rtp_header_);
+  }
+  while (has_recent_rtp_header_ &&
+         most_recent_rtp_header_.timestamp_us <= current_time) {
+    rtp_header_history_.push_back(most_recent_rtp_header_);
+    has_recent_rtp_header_ =
+        rtp_header_queue_->Remove(&most_recent_rtp_header_);
+    message_received = true;
+  }
   return message_received;
 }
 
@@ -152,6 +217,15 @@ void RtcEventLogHelperThread::StartLogFile() {
       history_.pop_front();
     }
   }
+  while (!rtp_header_history_.empty() && !stop) {
+    stop = AppendRtpHeaderToBatch(rtp_header_history_.front());
+    if (!stop) {
+      rtp_header_history_.pop_front();
+    }
+  }
+  if (!stop) {
+    stop = AppendRtpHeaderBatchToString();
+  }
 
   // Write to file.
   if (!file_->Write(output_string_.data(), output_string_.size())) {
@@ -185,18 +259,47 @@ bool RtcEventLogHelperThread::LogToFile() {
   if (!has_recent_event_) {
     has_recent_event_ = event_queue_->Remove(&most_recent_event_);
   }
+  if (!has_recent_rtp_header_) {
+    has_recent_rtp_header_ =
+        rtp_header_queue_->Remove(&most_recent_rtp_header_);
+  }
   bool stop = false;
-  while (!stop && has_recent_event_ &&
-         most_recent_event_->timestamp_us() <= time_limit) {
-    stop = AppendEventToString(most_recent_event_.get());
-    if (!stop) {
+  while (!stop) {
+    const bool event_ready =
+        has_recent_event_ && most_recent_event_->timestamp_us() <= time_limit;
+    const bool rtp_header_ready =
+        has_recent_rtp_header_ &&
+        most_recent_rtp_header_.timestamp_us <= time_limit;
+    if (rtp_header_ready &&
+        (!event_ready || most_recent_rtp_header_.timestamp_us <=
+                             most_recent_event_->timestamp_us())) {
+      stop = AppendRtpHeaderToBatch(most_recent_rtp_header_);
+      if (!stop) {
+        has_recent_rtp_header_ =
+            rtp_header_queue_->Remove(&most_recent_rtp_header_);
+      }
+    } else if (event_ready) {
+      // The batched RTP headers are never moved past a configuration event.
       if (IsConfigEvent(*most_recent_event_)) {
-        config_history_.push_back(std::move(most_recent_event_));
+        stop = AppendRtpHeaderBatchToString();
+      }
+      if (!stop) {
+        stop = AppendEventToString(most_recent_event_.get());
+      }
+      if (!stop) {
+        if (IsConfigEvent(*most_recent_event_)) {
+          config_history_.push_back(std::move(most_recent_event_));
+        }
+        has_recent_event_ = event_queue_->Remove(&most_recent_event_);
       }
-      has_recent_event_ = event_queue_->Remove(&most_recent_event_);
+    } else {
+      break;
     }
     message_received = true;
   }
+  if (!stop) {
+    stop = AppendRtpHeaderBatchToString();
+  }
 
   // Write string to file.
   if (!file_->Write(output_string_.data(), output_string_.size())) {
@@ -212,6 +315,8 @@ bool RtcEventLogHelperThread::LogToFile() {
   // time limit, or in other words if we have terminated the loop despite
   // having more events in the queue.
   if ((has_recent_event_ && most_recent_event_->timestamp_us() > stop_time_) ||
+      (has_recent_rtp_header_ &&
+       most_recent_rtp_header_.timestamp_us > stop_time_) ||
       stop) {
     RTC_DCHECK(file_->is_open());
     StopLogFile();
@@ -222,6 +327,8 @@ bool RtcEventLogHelperThread::LogToFile() {
 void RtcEventLogHelperThread::StopLogFile() {
   RTC_DCHECK(file_->is_open());
   output_string_.clear();
+  // RTP headers that didn't fit within the size limit are dropped.
+  rtp_header_batch_.Clear();
 
   rtclog::Event end_event;
   // This function can be called either because we have reached the stop time,
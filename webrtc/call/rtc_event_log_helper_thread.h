@@ -22,6 +22,7 @@
 #include "webrtc/base/platform_thread.h"
 #include "webrtc/base/swap_queue.h"
 #include "webrtc/call/ringbuffer.h"
+#include "webrtc/call/rtc_event_log_rtp_batch.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
 
@@ -66,7 +67,8 @@ class RtcEventLogHelperThread final {
 
   RtcEventLogHelperThread(
       SwapQueue<ControlMessage>* message_queue,
-      SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue,
+      MpscSwapQueue<std::unique_ptr<rtclog::Event>>* event_queue,
+      MpscSwapQueue<LoggedRtpHeader>* rtp_header_queue,
       const Clock* const clock);
   ~RtcEventLogHelperThread();
 
@@ -83,6 +85,8 @@ class RtcEventLogHelperThread final {
   static bool ThreadOutputFunction(void* obj);
 
   bool AppendEventToString(rtclog::Event* event);
+  bool AppendRtpHeaderToBatch(const LoggedRtpHeader& header);
+  bool AppendRtpHeaderBatchToString();
   bool LogToMemory();
   void StartLogFile();
   bool LogToFile();
@@ -91,10 +95,12 @@ class RtcEventLogHelperThread final {
 
   // Message queues for passing events to the logging thread.
   SwapQueue<ControlMessage>* message_queue_;
-  SwapQueue<std::unique_ptr<rtclog::Event>>* event_queue_;
+  MpscSwapQueue<std::unique_ptr<rtclog::Event>>* event_queue_;
+  MpscSwapQueue<LoggedRtpHeader>* rtp_header_queue_;
 
   // History containing the most recent events (~ 10 s).
   RingBuffer<std::unique_ptr<rtclog::Event>> history_;
+  RingBuffer<LoggedRtpHeader> rtp_header_history_;
 
   // History containing all past configuration events.
   std::vector<std::unique_ptr<rtclog::Event>> config_history_;
@@ -110,6 +116,14 @@ class RtcEventLogHelperThread final {
   bool has_recent_event_;
   std::unique_ptr<rtclog::Event> most_recent_event_;
 
+  bool has_recent_rtp_header_;
+  LoggedRtpHeader most_recent_rtp_header_;
+
+  // RTP headers waiting to be written as an RTP_HEADER_BATCH_EVENT. The event
+  // is reused for all batches.
+  RtpHeaderBatchWriter rtp_header_batch_;
+  rtclog::Event rtp_header_batch_event_;
+
   // Temporary space for serializing profobuf data.
   std::string output_string_;
 
@@ -12,14 +12,18 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <fstream>
 #include <istream>
+#include <limits>
+#include <sstream>
 #include <utility>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/call.h"
 #include "webrtc/call/rtc_event_log.h"
+#include "webrtc/call/rtc_event_log_rtp_batch.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
 
@@ -41,6 +45,21 @@ MediaType GetRuntimeMediaType(rtclog::MediaType media_type) {
   return MediaType::ANY;
 }
 
+rtclog::MediaType GetSerializedMediaType(MediaType media_type) {
+  switch (media_type) {
+    case MediaType::ANY:
+      return rtclog::MediaType::ANY;
+    case MediaType::AUDIO:
+      return rtclog::MediaType::AUDIO;
+    case MediaType::VIDEO:
+      return rtclog::MediaType::VIDEO;
+    case MediaType::DATA:
+      return rtclog::MediaType::DATA;
+  }
+  RTC_NOTREACHED();
+  return rtclog::MediaType::ANY;
+}
+
 RtcpMode GetRuntimeRtcpMode(rtclog::VideoReceiveConfig::RtcpMode rtcp_mode) {
   switch (rtcp_mode) {
     case rtclog::VideoReceiveConfig::RTCP_COMPOUND:
@@ -79,6 +98,9 @@ ParsedRtcEventLog::EventType GetRuntimeEventType(
       return ParsedRtcEventLog::EventType::AUDIO_RECEIVER_CONFIG_EVENT;
     case rtclog::Event::AUDIO_SENDER_CONFIG_EVENT:
       return ParsedRtcEventLog::EventType::AUDIO_SENDER_CONFIG_EVENT;
+    case rtclog::Event::RTP_HEADER_BATCH_EVENT:
+      // The batches are replaced by RTP_EVENTs when parsing.
+      break;
   }
   RTC_NOTREACHED();
   return ParsedRtcEventLog::EventType::UNKNOWN_EVENT;
@@ -104,16 +126,59 @@ std::pair<uint64_t, bool> ParseVarInt(std::istream& stream) {
   return std::make_pair(varint, false);
 }
 
-}  // namespace
+// The RTP headers of a batch are not reordered with the events that start or
+// end a log and with configuration events.
+bool IsSegmentBoundary(const rtclog::Event& event) {
+  switch (event.type()) {
+    case rtclog::Event::LOG_START:
+    case rtclog::Event::LOG_END:
+    case rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT:
+    case rtclog::Event::VIDEO_SENDER_CONFIG_EVENT:
+    case rtclog::Event::AUDIO_RECEIVER_CONFIG_EVENT:
+    case rtclog::Event::AUDIO_SENDER_CONFIG_EVENT:
+      return true;
+    default:
+      return false;
+  }
+}
 
-bool ParsedRtcEventLog::ParseFile(const std::string& filename) {
-  std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
-  if (!file.good() || !file.is_open()) {
-    LOG(LS_WARNING) << "Could not open file for reading.";
+// Converts the headers of an RTP_HEADER_BATCH_EVENT into RTP_EVENTs.
+bool ExpandRtpHeaderBatch(const rtclog::Event& batch_event,
+                          std::vector<rtclog::Event>* rtp_events) {
+  if (!batch_event.has_timestamp_us() || !batch_event.has_rtp_header_batch())
+    return false;
+  const rtclog::RtpHeaderBatch& batch = batch_event.rtp_header_batch();
+  std::vector<LoggedRtpHeader> headers;
+  if (!DecodeRtpHeaderBatch(batch_event.timestamp_us(), batch.num_headers(),
+                            batch.headers(), &headers)) {
     return false;
   }
+  for (const LoggedRtpHeader& header : headers) {
+    rtclog::Event event;
+    event.set_timestamp_us(header.timestamp_us);
+    event.set_type(rtclog::Event::RTP_EVENT);
+    rtclog::RtpPacket* rtp_packet = event.mutable_rtp_packet();
+    rtp_packet->set_incoming(header.incoming);
+    rtp_packet->set_type(GetSerializedMediaType(header.media_type));
+    rtp_packet->set_packet_length(header.packet_length);
+    rtp_packet->set_header(header.header, header.header_length);
+    rtp_events->push_back(std::move(event));
+  }
+  return true;
+}
+
+}  // namespace
+
+ParsedRtcEventLog::ParsedRtcEventLog()
+    : stream_(nullptr), parse_error_(false) {}
 
-  return ParseStream(file);
+ParsedRtcEventLog::~ParsedRtcEventLog() = default;
+
+bool ParsedRtcEventLog::ParseFile(const std::string& filename) {
+  if (!StartParsingFile(filename))
+    return false;
+  ParseNextEvents(std::numeric_limits<size_t>::max());
+  return !parse_error_;
 }
 
 bool ParsedRtcEventLog::ParseString(const std::string& s) {
@@ -122,60 +187,193 @@ bool ParsedRtcEventLog::ParseString(const std::string& s) {
 }
 
 bool ParsedRtcEventLog::ParseStream(std::istream& stream) {
+  StartParsingStream(&stream);
+  ParseNextEvents(std::numeric_limits<size_t>::max());
+  return !parse_error_;
+}
+
+bool ParsedRtcEventLog::StartParsingFile(const std::string& filename) {
+  std::unique_ptr<std::ifstream> file(new std::ifstream(
+      filename, std::ios_base::in | std::ios_base::binary));
+  if (!file->good() || !file->is_open()) {
+    LOG(LS_WARNING) << "Could not open file for reading.";
+    events_.clear();
+    return false;
+  }
+  StartParsingStream(file.get());
+  file_ = std::move(file);
+  return true;
+}
+
+void ParsedRtcEventLog::StartParsingStream(std::istream* stream) {
+  RTC_DCHECK(stream->good());
   events_.clear();
+  file_.reset();
+  stream_ = stream;
+  pending_events_.clear();
+  ready_events_.clear();
+  parse_error_ = false;
+}
+
+bool ParsedRtcEventLog::ParseNextEvents(size_t max_events) {
+  events_.clear();
+  while (events_.size() < max_events && ReadUntilEventsAreReady()) {
+    events_.push_back(std::move(ready_events_.front()));
+    ready_events_.pop_front();
+  }
+  return !events_.empty();
+}
+
+bool ParsedRtcEventLog::ReadEvent(rtclog::Event* event) {
   const size_t kMaxEventSize = (1u << 16) - 1;
-  std::vector<char> tmp_buffer(kMaxEventSize);
   uint64_t tag;
   uint64_t message_length;
   bool success;
 
-  RTC_DCHECK(stream.good());
+  // Check whether we have reached end of file.
+  stream_->peek();
+  if (stream_->eof())
+    return false;
 
-  while (1) {
-    // Check whether we have reached end of file.
-    stream.peek();
-    if (stream.eof()) {
-      return true;
-    }
+  // Read the next message tag. The tag number is defined as
+  // (fieldnumber << 3) | wire_type. In our case, the field number is
+  // supposed to be 1 and the wire type for an length-delimited field is 2.
+  const uint64_t kExpectedTag = (1 << 3) | 2;
+  std::tie(tag, success) = ParseVarInt(*stream_);
+  if (!success) {
+    LOG(LS_WARNING) << "Missing field tag from beginning of protobuf event.";
+    parse_error_ = true;
+    return false;
+  } else if (tag != kExpectedTag) {
+    LOG(LS_WARNING) << "Unexpected field tag at beginning of protobuf event.";
+    parse_error_ = true;
+    return false;
+  }
 
-    // Read the next message tag. The tag number is defined as
-    // (fieldnumber << 3) | wire_type. In our case, the field number is
-    // supposed to be 1 and the wire type for an length-delimited field is 2.
-    const uint64_t kExpectedTag = (1 << 3) | 2;
-    std::tie(tag, success) = ParseVarInt(stream);
-    if (!success) {
-      LOG(LS_WARNING) << "Missing field tag from beginning of protobuf event.";
-      return false;
-    } else if (tag != kExpectedTag) {
-      LOG(LS_WARNING) << "Unexpected field tag at beginning of protobuf event.";
-      return false;
-    }
+  // Read the length field.
+  std::tie(message_length, success) = ParseVarInt(*stream_);
+  if (!success) {
+    LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
+    parse_error_ = true;
+    return false;
+  } else if (message_length > kMaxEventSize) {
+    LOG(LS_WARNING) << "Protobuf message length is too large.";
+    parse_error_ = true;
+    return false;
+  }
 
-    // Read the length field.
-    std::tie(message_length, success) = ParseVarInt(stream);
-    if (!success) {
-      LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
-      return false;
-    } else if (message_length > kMaxEventSize) {
-      LOG(LS_WARNING) << "Protobuf message length is too large.";
-      return false;
+  // Read the next protobuf event to a temporary char buffer.
+  read_buffer_.resize(kMaxEventSize);
+  stream_->read(read_buffer_.data(), message_length);
+  if (stream_->gcount() != static_cast<int>(message_length)) {
+    LOG(LS_WARNING) << "Failed to read protobuf message from file.";
+    parse_error_ = true;
+    return false;
+  }
+
+  // Parse the protobuf event from the buffer.
+  if (!event->ParseFromArray(read_buffer_.data(), message_length)) {
+    LOG(LS_WARNING) << "Failed to parse protobuf message.";
+    parse_error_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool ParsedRtcEventLog::ReadUntilEventsAreReady() {
+  // The writer flushes RTP header batches often, so other events only need to
+  // wait for a few batches before they can't be reordered any more. Logs
+  // without batches are released in chunks of this size.
+  const size_t kMaxPendingEvents = 10000;
+  std::vector<rtclog::Event> batched_rtp_events;
+  while (ready_events_.empty()) {
+    rtclog::Event event;
+    if (!stream_ || !ReadEvent(&event)) {
+      stream_ = nullptr;
+      file_.reset();
+      if (pending_events_.empty())
+        return false;
+      ReleasePendingEvents(pending_events_.size());
+      break;
+    }
+    if (event.type() == rtclog::Event::RTP_HEADER_BATCH_EVENT) {
+      if (!ExpandRtpHeaderBatch(event, &batched_rtp_events)) {
+        LOG(LS_WARNING) << "Failed to decode RTP header batch.";
+        parse_error_ = true;
+        stream_ = nullptr;
+        continue;
+      }
+      MergeBatchedRtpEvents(&batched_rtp_events);
+    } else if (IsSegmentBoundary(event)) {
+      ReleasePendingEvents(pending_events_.size());
+      ready_events_.push_back(std::move(event));
+    } else {
+      pending_events_.push_back(std::move(event));
+      if (pending_events_.size() > kMaxPendingEvents)
+        ReleasePendingEvents(pending_events_.size() - kMaxPendingEvents);
     }
+  }
+  return true;
+}
 
-    // Read the next protobuf event to a temporary char buffer.
-    stream.read(tmp_buffer.data(), message_length);
-    if (stream.gcount() != static_cast<int>(message_length)) {
-      LOG(LS_WARNING) << "Failed to read protobuf message from file.";
-      return false;
+void ParsedRtcEventLog::MergeBatchedRtpEvents(
+    std::vector<rtclog::Event>* batched_rtp_events) {
+  if (batched_rtp_events->empty())
+    return;
+  auto earlier = [](const rtclog::Event& a, const rtclog::Event& b) {
+    return a.timestamp_us() < b.timestamp_us();
+  };
+  std::stable_sort(batched_rtp_events->begin(), batched_rtp_events->end(),
+                   earlier);
+  const int64_t last_batched_timestamp_us =
+      batched_rtp_events->back().timestamp_us();
+  std::deque<rtclog::Event> pending;
+  pending.swap(pending_events_);
+  // RTP headers go before other events logged at the same time, like when the
+  // log is written.
+  auto event = pending.begin();
+  auto rtp_event = batched_rtp_events->begin();
+  while (event != pending.end() || rtp_event != batched_rtp_events->end()) {
+    if (rtp_event == batched_rtp_events->end() ||
+        (event != pending.end() && earlier(*event, *rtp_event))) {
+      pending_events_.push_back(std::move(*event++));
+    } else {
+      pending_events_.push_back(std::move(*rtp_event++));
     }
+  }
+  batched_rtp_events->clear();
 
-    // Parse the protobuf event from the buffer.
-    rtclog::Event event;
-    if (!event.ParseFromArray(tmp_buffer.data(), message_length)) {
-      LOG(LS_WARNING) << "Failed to parse protobuf message.";
+  // Later batches only contain headers logged after the ones in this batch,
+  // so events before the last of them are in their final order.
+  size_t num_final_events = 0;
+  while (num_final_events < pending_events_.size() &&
+         pending_events_[num_final_events].timestamp_us() <
+             last_batched_timestamp_us) {
+    ++num_final_events;
+  }
+  ReleasePendingEvents(num_final_events);
+}
+
+void ParsedRtcEventLog::ReleasePendingEvents(size_t num_events) {
+  RTC_DCHECK_LE(num_events, pending_events_.size());
+  for (size_t i = 0; i < num_events; ++i) {
+    ready_events_.push_back(std::move(pending_events_.front()));
+    pending_events_.pop_front();
+  }
+}
+
+bool ParsedRtcEventLog::WriteLegacyFormat(std::ostream* stream) const {
+  rtclog::EventStream event_stream;
+  std::string output;
+  for (const rtclog::Event& event : events_) {
+    // Events can be merged by concatenating EventStreams with one event each.
+    *event_stream.add_stream() = event;
+    if (!event_stream.AppendToString(&output))
       return false;
-    }
-    events_.push_back(event);
+    event_stream.Clear();
   }
+  stream->write(output.data(), output.size());
+  return stream->good();
 }
 
 size_t ParsedRtcEventLog::GetNumberOfEvents() const {
@@ -10,6 +10,11 @@
 #ifndef WEBRTC_CALL_RTC_EVENT_LOG_PARSER_H_
 #define WEBRTC_CALL_RTC_EVENT_LOG_PARSER_H_
 
+#include <deque>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -47,6 +52,9 @@ class ParsedRtcEventLog {
     AUDIO_SENDER_CONFIG_EVENT = 11
   };
 
+  ParsedRtcEventLog();
+  ~ParsedRtcEventLog();
+
   // Reads an RtcEventLog file and returns true if parsing was successful.
   bool ParseFile(const std::string& file_name);
 
@@ -56,6 +64,24 @@ class ParsedRtcEventLog {
   // Reads an RtcEventLog from an istream and returns true if successful.
   bool ParseStream(std::istream& stream);
 
+  // Incremental parsing, for logs that are too large to be held in memory.
+  // After StartParsingFile() or StartParsingStream(), each call to
+  // ParseNextEvents() replaces the parsed events with the next (at most)
+  // |max_events| events of the log, in the same order as ParseFile() would
+  // have returned them. The accessors below then refer to those events.
+  // ParseNextEvents() returns false once all events have been returned;
+  // parse_error() tells whether the log was malformed.
+  // The |stream| passed to StartParsingStream() must outlive the parsing.
+  bool StartParsingFile(const std::string& file_name);
+  void StartParsingStream(std::istream* stream);
+  bool ParseNextEvents(size_t max_events);
+  bool parse_error() const { return parse_error_; }
+
+  // Writes the parsed events to |stream| in the format that was used before
+  // RTP headers were written in batches, i.e. with one RTP_EVENT per header,
+  // for tools that can't read the batches. Returns true if successful.
+  bool WriteLegacyFormat(std::ostream* stream) const;
+
   // Returns the number of events in an EventStream.
   size_t GetNumberOfEvents() const;
 
@@ -112,7 +138,31 @@ class ParsedRtcEventLog {
                              int32_t* total_packets) const;
 
  private:
+  // Reads the next event from |stream_|. Returns false at the end of the
+  // stream or if the event is malformed, in which case |parse_error_| is set.
+  bool ReadEvent(rtclog::Event* event);
+
+  // Reads events until there are events in |ready_events_|. Returns false if
+  // there are no more events.
+  bool ReadUntilEventsAreReady();
+
+  // Merges the RTP_EVENTs of an RTP_HEADER_BATCH_EVENT into
+  // |pending_events_| in timestamp order.
+  void MergeBatchedRtpEvents(std::vector<rtclog::Event>* batched_rtp_events);
+
+  // Moves the first |num_events| pending events to |ready_events_|.
+  void ReleasePendingEvents(size_t num_events);
+
   std::vector<rtclog::Event> events_;
+
+  std::unique_ptr<std::ifstream> file_;
+  std::istream* stream_;
+  std::vector<char> read_buffer_;
+  // Events that may still be reordered with the RTP headers of a later batch.
+  std::deque<rtclog::Event> pending_events_;
+  // Events in their final order, not yet returned by ParseNextEvents().
+  std::deque<rtclog::Event> ready_events_;
+  bool parse_error_;
 };
 
 }  // namespace webrtc
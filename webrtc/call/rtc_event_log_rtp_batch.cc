@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/rtc_event_log_rtp_batch.h"
+
+#include <string.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+// Each header in a batch is encoded as:
+//   varint   zigzag encoded arrival time delta (us) from the previous header.
+//   byte     bit 0: incoming, bits 1-2: media type.
+//   varint   index of the SSRC among the SSRCs of the batch. An index equal
+//            to the number of SSRCs seen so far introduces a new SSRC, which
+//            follows as 4 bytes in network byte order.
+//   2 bytes  the first two bytes of the header (V, P, X, CC, M and PT).
+//   varint   zigzag encoded sequence number delta from the previous header
+//            with the same SSRC, or from 0 for the first one.
+//   varint   zigzag encoded RTP timestamp delta, like the sequence number.
+//   varint   length of the header after the fixed 12 bytes, followed by
+//            those bytes (CSRCs and header extensions).
+//   varint   payload and padding length.
+
+namespace webrtc {
+
+namespace {
+
+const size_t kFixedHeaderLength = 12;
+
+void WriteVarInt(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void WriteSignedVarInt(int64_t value, std::string* out) {
+  WriteVarInt((static_cast<uint64_t>(value) << 1) ^
+                  static_cast<uint64_t>(value >> 63),
+              out);
+}
+
+class BatchReader {
+ public:
+  explicit BatchReader(const std::string& data)
+      : data_(reinterpret_cast<const uint8_t*>(data.data())),
+        size_(data.size()),
+        position_(0) {}
+
+  bool ReadVarInt(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (position_ == size_)
+        return false;
+      const uint8_t byte = data_[position_++];
+      *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0)
+        return true;
+    }
+    return false;
+  }
+
+  bool ReadSignedVarInt(int64_t* value) {
+    uint64_t zigzag;
+    if (!ReadVarInt(&zigzag))
+      return false;
+    *value =
+        static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+    return true;
+  }
+
+  const uint8_t* ReadBytes(size_t num_bytes) {
+    if (size_ - position_ < num_bytes)
+      return nullptr;
+    const uint8_t* bytes = data_ + position_;
+    position_ += num_bytes;
+    return bytes;
+  }
+
+  bool done() const { return position_ == size_; }
+
+ private:
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t position_;
+};
+
+}  // namespace
+
+const size_t LoggedRtpHeader::kMaxHeaderLength;
+
+RtpHeaderBatchWriter::RtpHeaderBatchWriter()
+    : num_headers_(0), first_timestamp_us_(0), last_timestamp_us_(0) {}
+
+RtpHeaderBatchWriter::~RtpHeaderBatchWriter() = default;
+
+void RtpHeaderBatchWriter::Add(const LoggedRtpHeader& header) {
+  RTC_DCHECK_GE(header.header_length, kFixedHeaderLength);
+  RTC_DCHECK_LE(header.header_length, LoggedRtpHeader::kMaxHeaderLength);
+  RTC_DCHECK_GE(header.packet_length, header.header_length);
+  if (num_headers_ == 0) {
+    first_timestamp_us_ = header.timestamp_us;
+    last_timestamp_us_ = header.timestamp_us;
+  }
+  ++num_headers_;
+
+  WriteSignedVarInt(header.timestamp_us - last_timestamp_us_, &buffer_);
+  last_timestamp_us_ = header.timestamp_us;
+  buffer_.push_back(static_cast<char>(
+      (header.incoming ? 1 : 0) | (static_cast<int>(header.media_type) << 1)));
+
+  const uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&header.header[8]);
+  size_t index = 0;
+  while (index < ssrcs_.size() && ssrcs_[index].ssrc != ssrc)
+    ++index;
+  WriteVarInt(index, &buffer_);
+  if (index == ssrcs_.size()) {
+    ssrcs_.push_back(SsrcState{ssrc, 0, 0});
+    buffer_.append(reinterpret_cast<const char*>(&header.header[8]), 4);
+  }
+  SsrcState* state = &ssrcs_[index];
+
+  buffer_.append(reinterpret_cast<const char*>(header.header), 2);
+  const uint16_t sequence_number =
+      ByteReader<uint16_t>::ReadBigEndian(&header.header[2]);
+  const uint32_t timestamp =
+      ByteReader<uint32_t>::ReadBigEndian(&header.header[4]);
+  WriteSignedVarInt(
+      static_cast<int16_t>(sequence_number - state->sequence_number),
+      &buffer_);
+  WriteSignedVarInt(static_cast<int32_t>(timestamp - state->timestamp),
+                    &buffer_);
+  state->sequence_number = sequence_number;
+  state->timestamp = timestamp;
+
+  WriteVarInt(header.header_length - kFixedHeaderLength, &buffer_);
+  buffer_.append(
+      reinterpret_cast<const char*>(&header.header[kFixedHeaderLength]),
+      header.header_length - kFixedHeaderLength);
+  WriteVarInt(header.packet_length - header.header_length, &buffer_);
+}
+
+void RtpHeaderBatchWriter::Finish(std::string* encoded) {
+  encoded->swap(buffer_);
+  Clear();
+}
+
+void RtpHeaderBatchWriter::Clear() {
+  buffer_.clear();
+  ssrcs_.clear();
+  num_headers_ = 0;
+}
+
+bool DecodeRtpHeaderBatch(int64_t first_timestamp_us,
+                          size_t num_headers,
+                          const std::string& encoded,
+                          std::vector<LoggedRtpHeader>* headers) {
+  struct SsrcState {
+    const uint8_t* ssrc;
+    uint16_t sequence_number;
+    uint32_t timestamp;
+  };
+  std::vector<SsrcState> ssrcs;
+  BatchReader reader(encoded);
+  int64_t timestamp_us = first_timestamp_us;
+  for (size_t i = 0; i < num_headers; ++i) {
+    LoggedRtpHeader header;
+    int64_t delta;
+    if (!reader.ReadSignedVarInt(&delta))
+      return false;
+    timestamp_us += delta;
+    header.timestamp_us = timestamp_us;
+
+    const uint8_t* flags = reader.ReadBytes(1);
+    if (!flags || (*flags >> 1) > static_cast<int>(MediaType::DATA))
+      return false;
+    header.incoming = (*flags & 1) != 0;
+    header.media_type = static_cast<MediaType>(*flags >> 1);
+
+    uint64_t index;
+    if (!reader.ReadVarInt(&index) || index > ssrcs.size())
+      return false;
+    if (index == ssrcs.size()) {
+      const uint8_t* ssrc = reader.ReadBytes(4);
+      if (!ssrc)
+        return false;
+      ssrcs.push_back(SsrcState{ssrc, 0, 0});
+    }
+    SsrcState* state = &ssrcs[index];
+
+    const uint8_t* first_bytes = reader.ReadBytes(2);
+    int64_t sequence_number_delta;
+    int64_t timestamp_delta;
+    if (!first_bytes || !reader.ReadSignedVarInt(&sequence_number_delta) ||
+        !reader.ReadSignedVarInt(&timestamp_delta)) {
+      return false;
+    }
+    state->sequence_number += static_cast<uint16_t>(sequence_number_delta);
+    state->timestamp += static_cast<uint32_t>(timestamp_delta);
+    memcpy(header.header, first_bytes, 2);
+    ByteWriter<uint16_t>::WriteBigEndian(&header.header[2],
+                                         state->sequence_number);
+    ByteWriter<uint32_t>::WriteBigEndian(&header.header[4], state->timestamp);
+    memcpy(&header.header[8], state->ssrc, 4);
+
+    uint64_t extra_length;
+    if (!reader.ReadVarInt(&extra_length) ||
+        extra_length > LoggedRtpHeader::kMaxHeaderLength - kFixedHeaderLength) {
+      return false;
+    }
+    const uint8_t* extra = reader.ReadBytes(extra_length);
+    if (!extra)
+      return false;
+    memcpy(&header.header[kFixedHeaderLength], extra, extra_length);
+    header.header_length =
+        static_cast<uint8_t>(kFixedHeaderLength + extra_length);
+
+    uint64_t payload_length;
+    if (!reader.ReadVarInt(&payload_length) ||
+        header.header_length + payload_length > 0xFFFF) {
+      return false;
+    }
+    header.packet_length =
+        static_cast<uint16_t>(header.header_length + payload_length);
+    headers->push_back(header);
+  }
+  return reader.done();
+}
+
+}  // namespace webrtc
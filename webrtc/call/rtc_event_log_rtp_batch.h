@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_CALL_RTC_EVENT_LOG_RTP_BATCH_H_
+#define WEBRTC_CALL_RTC_EVENT_LOG_RTP_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/call.h"
+
+namespace webrtc {
+
+// An RTP header passed from RtcEventLog::LogRtpHeader() to the thread writing
+// the log. The header is stored inline so that logging a packet doesn't
+// allocate; longer headers are logged as individual RTP_EVENTs instead.
+struct LoggedRtpHeader {
+  static const size_t kMaxHeaderLength = 64;
+
+  int64_t timestamp_us = 0;
+  MediaType media_type = MediaType::ANY;
+  bool incoming = false;
+  uint8_t header_length = 0;
+  uint16_t packet_length = 0;
+  uint8_t header[kMaxHeaderLength];
+};
+
+// Encodes a sequence of RTP headers into the compact format stored in the
+// RTP_HEADER_BATCH_EVENTs of the event log. Each header is written relative
+// to the previous header in the batch: the arrival time as a delta, the SSRC
+// as an index into the SSRCs seen so far, and the sequence number and RTP
+// timestamp as deltas from the previous header with the same SSRC. CSRCs and
+// header extensions are copied as they are. A batch doesn't depend on earlier
+// batches, so it can be decoded on its own.
+class RtpHeaderBatchWriter {
+ public:
+  RtpHeaderBatchWriter();
+  ~RtpHeaderBatchWriter();
+
+  // Appends |header| to the batch.
+  void Add(const LoggedRtpHeader& header);
+
+  bool empty() const { return num_headers_ == 0; }
+  size_t num_headers() const { return num_headers_; }
+  // Size of the encoded headers in bytes.
+  size_t size_bytes() const { return buffer_.size(); }
+  // Arrival time of the first header in the batch.
+  int64_t first_timestamp_us() const { return first_timestamp_us_; }
+
+  // Swaps the encoded batch into |encoded| and starts a new batch. The
+  // previous content of |encoded| is reused as buffer for the next batch.
+  void Finish(std::string* encoded);
+
+  // Discards the headers of the batch.
+  void Clear();
+
+ private:
+  struct SsrcState {
+    uint32_t ssrc;
+    uint16_t sequence_number;
+    uint32_t timestamp;
+  };
+
+  std::vector<SsrcState> ssrcs_;
+  std::string buffer_;
+  size_t num_headers_;
+  int64_t first_timestamp_us_;
+  int64_t last_timestamp_us_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpHeaderBatchWriter);
+};
+
+// Decodes |num_headers| headers written by RtpHeaderBatchWriter, whose first
+// header arrived at |first_timestamp_us|, and appends them to |headers|.
+// Returns false if the batch is malformed.
+bool DecodeRtpHeaderBatch(int64_t first_timestamp_us,
+                          size_t num_headers,
+                          const std::string& encoded,
+                          std::vector<LoggedRtpHeader>* headers);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_CALL_RTC_EVENT_LOG_RTP_BATCH_H_
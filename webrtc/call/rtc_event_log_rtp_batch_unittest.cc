@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/call/rtc_event_log_rtp_batch.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/random.h"
+#include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+
+namespace webrtc {
+
+namespace {
+
+LoggedRtpHeader MakeHeader(int64_t timestamp_us,
+                           uint32_t ssrc,
+                           uint16_t sequence_number,
+                           uint32_t rtp_timestamp,
+                           size_t extension_length,
+                           Random* prng) {
+  LoggedRtpHeader header;
+  header.timestamp_us = timestamp_us;
+  header.media_type = prng->Rand<bool>() ? MediaType::AUDIO : MediaType::VIDEO;
+  header.incoming = prng->Rand<bool>();
+  header.header_length = static_cast<uint8_t>(12 + extension_length);
+  header.packet_length =
+      static_cast<uint16_t>(header.header_length + prng->Rand(0, 1200));
+  header.header[0] = extension_length > 0 ? 0x90 : 0x80;
+  header.header[1] = prng->Rand<uint8_t>();
+  ByteWriter<uint16_t>::WriteBigEndian(&header.header[2], sequence_number);
+  ByteWriter<uint32_t>::WriteBigEndian(&header.header[4], rtp_timestamp);
+  ByteWriter<uint32_t>::WriteBigEndian(&header.header[8], ssrc);
+  for (size_t i = 12; i < header.header_length; ++i)
+    header.header[i] = prng->Rand<uint8_t>();
+  return header;
+}
+
+void ExpectEqual(const LoggedRtpHeader& expected,
+                 const LoggedRtpHeader& actual) {
+  EXPECT_EQ(expected.timestamp_us, actual.timestamp_us);
+  EXPECT_EQ(expected.media_type, actual.media_type);
+  EXPECT_EQ(expected.incoming, actual.incoming);
+  EXPECT_EQ(expected.packet_length, actual.packet_length);
+  ASSERT_EQ(expected.header_length, actual.header_length);
+  EXPECT_EQ(0,
+            memcmp(expected.header, actual.header, expected.header_length));
+}
+
+std::vector<LoggedRtpHeader> MakeStreams(Random* prng) {
+  // Two interleaved streams with sequence number and timestamp wrap-around,
+  // and arrival times that are not always increasing.
+  std::vector<LoggedRtpHeader> headers;
+  int64_t timestamp_us = 123456789;
+  for (int i = 0; i < 100; ++i) {
+    timestamp_us += prng->Rand(-100, 10000);
+    headers.push_back(MakeHeader(timestamp_us, 0x11111111,
+                                 static_cast<uint16_t>(65500 + i),
+                                 0xFFFFF000 + 960 * i, 8, prng));
+    headers.push_back(
+        MakeHeader(timestamp_us + 1, 0x22222222,
+                   static_cast<uint16_t>(i * 3), 1000 * i,
+                   i % 2 == 0 ? 0 : LoggedRtpHeader::kMaxHeaderLength - 12,
+                   prng));
+  }
+  return headers;
+}
+
+}  // namespace
+
+TEST(RtpHeaderBatchTest, EncodeAndDecode) {
+  Random prng(0x12345678);
+  const std::vector<LoggedRtpHeader> headers = MakeStreams(&prng);
+  RtpHeaderBatchWriter writer;
+  for (const LoggedRtpHeader& header : headers)
+    writer.Add(header);
+  EXPECT_EQ(headers.size(), writer.num_headers());
+  EXPECT_EQ(headers[0].timestamp_us, writer.first_timestamp_us());
+
+  std::string encoded;
+  writer.Finish(&encoded);
+  EXPECT_TRUE(writer.empty());
+  EXPECT_EQ(0u, writer.size_bytes());
+
+  std::vector<LoggedRtpHeader> decoded;
+  ASSERT_TRUE(DecodeRtpHeaderBatch(headers[0].timestamp_us, headers.size(),
+                                   encoded, &decoded));
+  ASSERT_EQ(headers.size(), decoded.size());
+  for (size_t i = 0; i < headers.size(); ++i)
+    ExpectEqual(headers[i], decoded[i]);
+}
+
+TEST(RtpHeaderBatchTest, BatchesAreIndependent) {
+  Random prng(0x87654321);
+  const std::vector<LoggedRtpHeader> headers = MakeStreams(&prng);
+  RtpHeaderBatchWriter writer;
+  std::string first_batch;
+  std::string second_batch;
+  writer.Add(headers[0]);
+  writer.Add(headers[1]);
+  writer.Finish(&first_batch);
+  writer.Add(headers[2]);
+  writer.Add(headers[3]);
+  writer.Finish(&second_batch);
+
+  std::vector<LoggedRtpHeader> decoded;
+  ASSERT_TRUE(DecodeRtpHeaderBatch(headers[2].timestamp_us, 2, second_batch,
+                                   &decoded));
+  ASSERT_EQ(2u, decoded.size());
+  ExpectEqual(headers[2], decoded[0]);
+  ExpectEqual(headers[3], decoded[1]);
+}
+
+TEST(RtpHeaderBatchTest, IsCompact) {
+  Random prng(0x24681357);
+  RtpHeaderBatchWriter writer;
+  const size_t kNumHeaders = 500;
+  for (size_t i = 0; i < kNumHeaders; ++i) {
+    writer.Add(MakeHeader(20000 * i, 0x33333333, static_cast<uint16_t>(i),
+                          960 * i, 0, &prng));
+  }
+  // A header without extensions needs about 13 bytes, compared with more than
+  // 30 bytes when logged as an RTP_EVENT.
+  EXPECT_GT(kNumHeaders * 16, writer.size_bytes());
+}
+
+TEST(RtpHeaderBatchTest, RejectsMalformedBatches) {
+  Random prng(0x13572468);
+  const std::vector<LoggedRtpHeader> headers = MakeStreams(&prng);
+  RtpHeaderBatchWriter writer;
+  writer.Add(headers[0]);
+  writer.Add(headers[1]);
+  std::string encoded;
+  writer.Finish(&encoded);
+
+  std::vector<LoggedRtpHeader> decoded;
+  // Truncated.
+  EXPECT_FALSE(DecodeRtpHeaderBatch(0, 2, encoded.substr(0, encoded.size() - 1),
+                                    &decoded));
+  // Trailing data.
+  EXPECT_FALSE(DecodeRtpHeaderBatch(0, 1, encoded, &decoded));
+  // Too many headers.
+  EXPECT_FALSE(DecodeRtpHeaderBatch(0, 3, encoded, &decoded));
+  // Reference to an unknown SSRC.
+  std::string unknown_ssrc = encoded;
+  unknown_ssrc[2] = 1;
+  EXPECT_FALSE(DecodeRtpHeaderBatch(0, 2, unknown_ssrc, &decoded));
+}
+
+}  // namespace webrtc
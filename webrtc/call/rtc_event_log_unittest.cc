@@ -10,6 +10,7 @@
 
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -21,6 +22,7 @@
 #include "webrtc/call.h"
 #include "webrtc/call/rtc_event_log.h"
 #include "webrtc/call/rtc_event_log_parser.h"
+#include "webrtc/call/rtc_event_log_rtp_batch.h"
 #include "webrtc/call/rtc_event_log_unittest_helper.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
@@ -458,4 +460,98 @@ TEST(RtcEventLogTest, LogEventAndReadBack) {
   remove(temp_filename.c_str());
 }
 
+TEST(RtcEventLogTest, RtpHeadersAreBatched) {
+  Random prng(1122334455);
+  const size_t kNumPackets = 300;
+  std::vector<RtpPacketToSend> rtp_packets;
+  for (size_t i = 0; i < kNumPackets; i++) {
+    rtp_packets.push_back(
+        GenerateRtpPacket(nullptr, i % 3, prng.Rand(1000, 1100), &prng));
+  }
+  // Too long to be batched.
+  rtp_packets.push_back(GenerateRtpPacket(nullptr, 15, 1100, &prng));
+  ASSERT_LT(LoggedRtpHeader::kMaxHeaderLength,
+            rtp_packets.back().headers_size());
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  {
+    SimulatedClock fake_clock(prng.Rand<uint32_t>());
+    std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create(&fake_clock));
+    log_dumper->StartLogging(temp_filename, 10000000);
+    for (size_t i = 0; i < rtp_packets.size(); i++) {
+      fake_clock.AdvanceTimeMicroseconds(prng.Rand(1, 1000));
+      log_dumper->LogRtpHeader(
+          (i % 2 == 0) ? kIncomingPacket : kOutgoingPacket,
+          (i % 3 == 0) ? MediaType::AUDIO : MediaType::VIDEO,
+          rtp_packets[i].data(), rtp_packets[i].size());
+      if (i == kNumPackets / 2) {
+        log_dumper->LogAudioPlayout(1234);
+      }
+    }
+    fake_clock.AdvanceTimeMicroseconds(prng.Rand(1, 1000));
+    log_dumper->StopLogging();
+  }
+
+  // The file holds the batches rather than one event per header.
+  rtclog::EventStream raw_stream;
+  ASSERT_TRUE(RtcEventLog::ParseRtcEventLog(temp_filename, &raw_stream));
+  EXPECT_GT(kNumPackets / 2, static_cast<size_t>(raw_stream.stream_size()));
+
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+  const size_t kNumEvents = rtp_packets.size() + 3;
+  ASSERT_EQ(kNumEvents, parsed_log.GetNumberOfEvents());
+
+  // The batches are written as individual RTP_EVENTs in the legacy format.
+  std::ostringstream legacy_stream;
+  ASSERT_TRUE(parsed_log.WriteLegacyFormat(&legacy_stream));
+  rtclog::EventStream legacy_events;
+  ASSERT_TRUE(legacy_events.ParseFromString(legacy_stream.str()));
+  EXPECT_EQ(kNumEvents, static_cast<size_t>(legacy_events.stream_size()));
+  ParsedRtcEventLog parsed_legacy_log;
+  ASSERT_TRUE(parsed_legacy_log.ParseString(legacy_stream.str()));
+
+  for (const ParsedRtcEventLog* log : {&parsed_log, &parsed_legacy_log}) {
+    ASSERT_EQ(kNumEvents, log->GetNumberOfEvents());
+    RtcEventLogTestHelper::VerifyLogStartEvent(*log, 0);
+    size_t event_index = 1;
+    for (size_t i = 0; i < rtp_packets.size(); i++) {
+      RtcEventLogTestHelper::VerifyRtpEvent(
+          *log, event_index++, (i % 2 == 0) ? kIncomingPacket : kOutgoingPacket,
+          (i % 3 == 0) ? MediaType::AUDIO : MediaType::VIDEO,
+          rtp_packets[i].data(), rtp_packets[i].headers_size(),
+          rtp_packets[i].size());
+      if (i == kNumPackets / 2) {
+        RtcEventLogTestHelper::VerifyPlayoutEvent(*log, event_index++, 1234);
+      }
+    }
+    RtcEventLogTestHelper::VerifyLogEndEvent(*log, event_index);
+  }
+
+  // Incremental parsing returns the same events, a few at a time.
+  ParsedRtcEventLog incremental_log;
+  ASSERT_TRUE(incremental_log.StartParsingFile(temp_filename));
+  const size_t kMaxEventsPerChunk = 7;
+  size_t num_parsed_events = 0;
+  while (incremental_log.ParseNextEvents(kMaxEventsPerChunk)) {
+    ASSERT_GE(kMaxEventsPerChunk, incremental_log.GetNumberOfEvents());
+    for (size_t i = 0; i < incremental_log.GetNumberOfEvents(); i++) {
+      ASSERT_LT(num_parsed_events, kNumEvents);
+      EXPECT_EQ(parsed_legacy_log.GetEventType(num_parsed_events),
+                incremental_log.GetEventType(i));
+      EXPECT_EQ(parsed_legacy_log.GetTimestamp(num_parsed_events),
+                incremental_log.GetTimestamp(i));
+      ++num_parsed_events;
+    }
+  }
+  EXPECT_FALSE(incremental_log.parse_error());
+  EXPECT_EQ(kNumEvents, num_parsed_events);
+
+  // Clean up temporary file - can be pretty slow.
+  remove(temp_filename.c_str());
+}
+
 }  // namespace webrtc
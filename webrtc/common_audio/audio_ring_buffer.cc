@@ -10,66 +10,91 @@
 
 #include "webrtc/common_audio/audio_ring_buffer.h"
 
-#include "webrtc/base/checks.h"
-#include "webrtc/common_audio/ring_buffer.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
-// This is a simple multi-channel wrapper over the ring_buffer.h C interface.
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
 
 namespace webrtc {
 
-AudioRingBuffer::AudioRingBuffer(size_t channels, size_t max_frames) {
-  buffers_.reserve(channels);
-  for (size_t i = 0; i < channels; ++i)
-    buffers_.push_back(WebRtc_CreateBuffer(max_frames, sizeof(float)));
+AudioRingBuffer::AudioRingBuffer(size_t channels, size_t max_frames)
+    : num_channels_(channels),
+      buffer_frames_(max_frames + 1),
+      data_(channels * buffer_frames_),
+      read_pos_(0),
+      write_pos_(0) {
+  RTC_CHECK_GT(num_channels_, 0u);
+  RTC_CHECK_LE(buffer_frames_,
+               static_cast<size_t>(std::numeric_limits<int>::max()));
 }
 
-AudioRingBuffer::~AudioRingBuffer() {
-  for (auto buf : buffers_)
-    WebRtc_FreeBuffer(buf);
-}
+AudioRingBuffer::~AudioRingBuffer() = default;
 
 void AudioRingBuffer::Write(const float* const* data, size_t channels,
                             size_t frames) {
-  RTC_DCHECK_EQ(buffers_.size(), channels);
+  RTC_DCHECK_EQ(num_channels_, channels);
+  const int read_pos = rtc::AtomicOps::AcquireLoad(&read_pos_);
+  const size_t write_pos = write_pos_;
+  RTC_CHECK_LE(frames,
+               buffer_frames_ - 1 - ReadFramesAvailable(read_pos, write_pos));
+  // Copy up to the end of the buffer, then wrap around to its start.
+  const size_t first_frames = std::min(frames, buffer_frames_ - write_pos);
   for (size_t i = 0; i < channels; ++i) {
-    const size_t written = WebRtc_WriteBuffer(buffers_[i], data[i], frames);
-    RTC_CHECK_EQ(written, frames);
+    float* const channel = &data_[i * buffer_frames_];
+    memcpy(channel + write_pos, data[i], first_frames * sizeof(float));
+    memcpy(channel, data[i] + first_frames,
+           (frames - first_frames) * sizeof(float));
   }
+  rtc::AtomicOps::ReleaseStore(
+      &write_pos_, static_cast<int>((write_pos + frames) % buffer_frames_));
 }
 
 void AudioRingBuffer::Read(float* const* data, size_t channels, size_t frames) {
-  RTC_DCHECK_EQ(buffers_.size(), channels);
+  RTC_DCHECK_EQ(num_channels_, channels);
+  const size_t read_pos = read_pos_;
+  const int write_pos = rtc::AtomicOps::AcquireLoad(&write_pos_);
+  RTC_CHECK_LE(frames, ReadFramesAvailable(read_pos, write_pos));
+  const size_t first_frames = std::min(frames, buffer_frames_ - read_pos);
   for (size_t i = 0; i < channels; ++i) {
-    const size_t read =
-        WebRtc_ReadBuffer(buffers_[i], nullptr, data[i], frames);
-    RTC_CHECK_EQ(read, frames);
+    const float* const channel = &data_[i * buffer_frames_];
+    memcpy(data[i], channel + read_pos, first_frames * sizeof(float));
+    memcpy(data[i] + first_frames, channel,
+           (frames - first_frames) * sizeof(float));
   }
+  rtc::AtomicOps::ReleaseStore(
+      &read_pos_, static_cast<int>((read_pos + frames) % buffer_frames_));
 }
 
 size_t AudioRingBuffer::ReadFramesAvailable() const {
-  // All buffers have the same amount available.
-  return WebRtc_available_read(buffers_[0]);
+  return ReadFramesAvailable(rtc::AtomicOps::AcquireLoad(&read_pos_),
+                             rtc::AtomicOps::AcquireLoad(&write_pos_));
 }
 
 size_t AudioRingBuffer::WriteFramesAvailable() const {
-  // All buffers have the same amount available.
-  return WebRtc_available_write(buffers_[0]);
+  return buffer_frames_ - 1 - ReadFramesAvailable();
 }
 
 void AudioRingBuffer::MoveReadPositionForward(size_t frames) {
-  for (auto buf : buffers_) {
-    const size_t moved =
-        static_cast<size_t>(WebRtc_MoveReadPtr(buf, static_cast<int>(frames)));
-    RTC_CHECK_EQ(moved, frames);
-  }
+  const size_t read_pos = read_pos_;
+  RTC_CHECK_LE(frames, ReadFramesAvailable(
+                           read_pos, rtc::AtomicOps::AcquireLoad(&write_pos_)));
+  rtc::AtomicOps::ReleaseStore(
+      &read_pos_, static_cast<int>((read_pos + frames) % buffer_frames_));
 }
 
 void AudioRingBuffer::MoveReadPositionBackward(size_t frames) {
-  for (auto buf : buffers_) {
-    const size_t moved = static_cast<size_t>(
-        -WebRtc_MoveReadPtr(buf, -static_cast<int>(frames)));
-    RTC_CHECK_EQ(moved, frames);
-  }
+  RTC_CHECK_LE(frames, WriteFramesAvailable());
+  const size_t read_pos = read_pos_;
+  rtc::AtomicOps::ReleaseStore(
+      &read_pos_, static_cast<int>((read_pos + buffer_frames_ - frames) %
+                                   buffer_frames_));
+}
+
+size_t AudioRingBuffer::ReadFramesAvailable(size_t read_pos,
+                                            size_t write_pos) const {
+  return (write_pos + buffer_frames_ - read_pos) % buffer_frames_;
 }
 
 }  // namespace webrtc
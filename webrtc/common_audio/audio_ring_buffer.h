@@ -12,16 +12,22 @@
 
 #include <stddef.h>
 
-#include <memory>
 #include <vector>
 
-struct RingBuffer;
+#include "webrtc/base/constructormagic.h"
 
 namespace webrtc {
 
 // A ring buffer tailored for float deinterleaved audio. Any operation that
 // cannot be performed as requested will cause a crash (e.g. insufficient data
 // in the buffer to fulfill a read request.)
+//
+// The buffer is wait-free when used by one producer thread, calling Write()
+// and WriteFramesAvailable(), and one consumer thread, calling the other
+// methods. The read and write positions are published with release semantics
+// and read with acquire semantics, so no lock is needed. The exception is
+// MoveReadPositionBackward(), which hands frames back from the producer to the
+// consumer and must not be called concurrently with Write().
 class AudioRingBuffer final {
  public:
   // Specify the number of channels and maximum number of frames the buffer will
@@ -48,8 +54,20 @@ class AudioRingBuffer final {
   void MoveReadPositionBackward(size_t frames);
 
  private:
-  // TODO(kwiberg): Use std::vector<std::unique_ptr<RingBuffer>> instead.
-  std::vector<RingBuffer*> buffers_;
+  size_t ReadFramesAvailable(size_t read_pos, size_t write_pos) const;
+
+  const size_t num_channels_;
+  // One more than the maximum number of frames, so that a full buffer can be
+  // told apart from an empty one.
+  const size_t buffer_frames_;
+  // The channels are stored after one another in a single allocation.
+  std::vector<float> data_;
+  // Only written by the consumer.
+  volatile int read_pos_;
+  // Only written by the producer.
+  volatile int write_pos_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AudioRingBuffer);
 };
 
 }  // namespace webrtc
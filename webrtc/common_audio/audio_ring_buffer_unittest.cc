@@ -8,12 +8,15 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <memory>
 
 #include "webrtc/common_audio/audio_ring_buffer.h"
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/common_audio/channel_buffer.h"
+#include "webrtc/system_wrappers/include/sleep.h"
 
 namespace webrtc {
 
@@ -109,4 +112,70 @@ TEST_F(AudioRingBufferTest, MoveReadPosition) {
   EXPECT_EQ(2, output.channels()[0][0]);
 }
 
+namespace {
+
+const size_t kConcurrentNumChannels = 2;
+const size_t kConcurrentNumFrames = 10000;
+const size_t kConcurrentWriteChunkFrames = 10;
+const size_t kConcurrentReadChunkFrames = 7;
+
+struct ConcurrentWriter {
+  ConcurrentWriter(AudioRingBuffer* buffer, const ChannelBuffer<float>* input)
+      : buffer(buffer), input(input), input_pos(0) {}
+
+  // Writes one chunk per call, waiting for the reader when the buffer is full.
+  static bool WriteChunk(void* obj) {
+    ConcurrentWriter* writer = static_cast<ConcurrentWriter*>(obj);
+    if (writer->buffer->WriteFramesAvailable() < kConcurrentWriteChunkFrames) {
+      SleepMs(1);
+      return true;
+    }
+    float* slice[kConcurrentNumChannels];
+    writer->buffer->Write(writer->input->Slice(slice, writer->input_pos),
+                          kConcurrentNumChannels, kConcurrentWriteChunkFrames);
+    writer->input_pos += kConcurrentWriteChunkFrames;
+    return writer->input_pos < kConcurrentNumFrames;
+  }
+
+  AudioRingBuffer* const buffer;
+  const ChannelBuffer<float>* const input;
+  size_t input_pos;
+};
+
+}  // namespace
+
+TEST_F(AudioRingBufferTest, ConcurrentReadAndWrite) {
+  static_assert(kConcurrentNumFrames % kConcurrentWriteChunkFrames == 0,
+                "whole number of written chunks");
+  ChannelBuffer<float> input(kConcurrentNumFrames, kConcurrentNumChannels);
+  for (size_t i = 0; i < kConcurrentNumChannels; ++i)
+    for (size_t j = 0; j < kConcurrentNumFrames; ++j)
+      input.channels()[i][j] = (i + 1) * (j + 1);
+  ChannelBuffer<float> output(kConcurrentNumFrames, kConcurrentNumChannels);
+
+  AudioRingBuffer buf(kConcurrentNumChannels, 256);
+  ConcurrentWriter writer(&buf, &input);
+  rtc::PlatformThread thread(&ConcurrentWriter::WriteChunk, &writer,
+                             "AudioRingBufferWriter");
+  thread.Start();
+  float* slice[kConcurrentNumChannels];
+  size_t output_pos = 0;
+  while (output_pos < kConcurrentNumFrames) {
+    const size_t frames = std::min(kConcurrentReadChunkFrames,
+                                   kConcurrentNumFrames - output_pos);
+    if (buf.ReadFramesAvailable() < frames) {
+      SleepMs(1);
+      continue;
+    }
+    buf.Read(output.Slice(slice, output_pos), kConcurrentNumChannels, frames);
+    output_pos += frames;
+  }
+  thread.Stop();
+
+  EXPECT_EQ(0u, buf.ReadFramesAvailable());
+  for (size_t i = 0; i < kConcurrentNumChannels; ++i)
+    for (size_t j = 0; j < kConcurrentNumFrames; ++j)
+      EXPECT_EQ(input.channels()[i][j], output.channels()[i][j]);
+}
+
 }  // namespace webrtc
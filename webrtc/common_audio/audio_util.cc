@@ -10,22 +10,90 @@
 
 #include "webrtc/common_audio/include/audio_util.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
+#if defined(__SSE2__)
+namespace {
+
+// Converts the largest multiple of 8 samples and returns the number of
+// converted samples; the results are bit-exact with the scalar versions.
+size_t S16ToFloatSSE2(const int16_t* src, size_t size, float* dest) {
+  const __m128 kMaxInt16Inverse = _mm_set1_ps(1.f / limits_int16::max());
+  const __m128 kMinInt16Inverse = _mm_set1_ps(-1.f / limits_int16::min());
+  const __m128i kZero = _mm_setzero_si128();
+  const size_t num_vector_samples = size & ~static_cast<size_t>(7);
+  for (size_t i = 0; i < num_vector_samples; i += 8) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Sign extend to 32 bits by placing the samples in the upper halves.
+    const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(kZero, v), 16);
+    const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(kZero, v), 16);
+    const __m128 lo_positive = _mm_castsi128_ps(_mm_cmpgt_epi32(lo, kZero));
+    const __m128 hi_positive = _mm_castsi128_ps(_mm_cmpgt_epi32(hi, kZero));
+    const __m128 lo_scale =
+        _mm_or_ps(_mm_and_ps(lo_positive, kMaxInt16Inverse),
+                  _mm_andnot_ps(lo_positive, kMinInt16Inverse));
+    const __m128 hi_scale =
+        _mm_or_ps(_mm_and_ps(hi_positive, kMaxInt16Inverse),
+                  _mm_andnot_ps(hi_positive, kMinInt16Inverse));
+    _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), lo_scale));
+    _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), hi_scale));
+  }
+  return num_vector_samples;
+}
+
+size_t FloatS16ToS16SSE2(const float* src, size_t size, int16_t* dest) {
+  const __m128 kMax = _mm_set1_ps(limits_int16::max());
+  const __m128 kMin = _mm_set1_ps(limits_int16::min());
+  const __m128 kHalf = _mm_set1_ps(0.5f);
+  const __m128 kSignMask = _mm_set1_ps(-0.f);
+  const size_t num_vector_samples = size & ~static_cast<size_t>(7);
+  for (size_t i = 0; i < num_vector_samples; i += 8) {
+    // Clamping first makes rounding away from zero, followed by truncation,
+    // give the saturated values of the scalar version.
+    const __m128 lo =
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), kMin), kMax);
+    const __m128 hi =
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), kMin), kMax);
+    const __m128 lo_round = _mm_or_ps(_mm_and_ps(lo, kSignMask), kHalf);
+    const __m128 hi_round = _mm_or_ps(_mm_and_ps(hi, kSignMask), kHalf);
+    const __m128i packed =
+        _mm_packs_epi32(_mm_cvttps_epi32(_mm_add_ps(lo, lo_round)),
+                        _mm_cvttps_epi32(_mm_add_ps(hi, hi_round)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+  }
+  return num_vector_samples;
+}
+
+}  // namespace
+#endif
+
 void FloatToS16(const float* src, size_t size, int16_t* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToS16(src[i]);
 }
 
 void S16ToFloat(const int16_t* src, size_t size, float* dest) {
-  for (size_t i = 0; i < size; ++i)
+  size_t i = 0;
+#if defined(__SSE2__)
+  i = S16ToFloatSSE2(src, size, dest);
+#endif
+  for (; i < size; ++i)
     dest[i] = S16ToFloat(src[i]);
 }
 
 void FloatS16ToS16(const float* src, size_t size, int16_t* dest) {
-  for (size_t i = 0; i < size; ++i)
+  size_t i = 0;
+#if defined(__SSE2__)
+  i = FloatS16ToS16SSE2(src, size, dest);
+#endif
+  for (; i < size; ++i)
     dest[i] = FloatS16ToS16(src[i]);
 }
 
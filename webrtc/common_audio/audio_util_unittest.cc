@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <vector>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/include/audio_util.h"
@@ -68,6 +70,30 @@ TEST(AudioUtilTest, FloatS16ToS16) {
   ExpectArraysEq(kReference, output, kSize);
 }
 
+// The array versions may be vectorized; they must match the scalar ones.
+TEST(AudioUtilTest, S16ToFloatMatchesScalarVersion) {
+  std::vector<int16_t> input;
+  for (int v = limits_int16::min(); v <= limits_int16::max(); ++v)
+    input.push_back(static_cast<int16_t>(v));
+  std::vector<float> output(input.size());
+  S16ToFloat(input.data(), input.size(), output.data());
+  for (size_t i = 0; i < input.size(); ++i)
+    EXPECT_EQ(S16ToFloat(input[i]), output[i]);
+}
+
+TEST(AudioUtilTest, FloatS16ToS16MatchesScalarVersion) {
+  std::vector<float> input = {0.f, -0.f, 0.5f, -0.5f, 1.5f, -1.5f,
+                              32766.5f, 32766.49f, 32767.f, 32767.5f,
+                              -32767.5f, -32767.51f, -32768.f, -32768.5f,
+                              1e9f, -1e9f};
+  for (float v = -33000.f; v < 33000.f; v += 0.25f)
+    input.push_back(v);
+  std::vector<int16_t> output(input.size());
+  FloatS16ToS16(input.data(), input.size(), output.data());
+  for (size_t i = 0; i < input.size(); ++i)
+    EXPECT_EQ(FloatS16ToS16(input[i]), output[i]) << input[i];
+}
+
 TEST(AudioUtilTest, FloatToFloatS16) {
   const size_t kSize = 9;
   const float kInput[kSize] = {0.f,
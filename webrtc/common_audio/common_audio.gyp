@@ -51,6 +51,9 @@
         'real_fourier.h',
         'real_fourier_ooura.cc',
         'real_fourier_ooura.h',
+        'real_fourier_stockham.cc',
+        'real_fourier_stockham.h',
+        'real_fourier_stockham_internal.h',
         'resampler/include/push_resampler.h',
         'resampler/include/resampler.h',
         'resampler/push_resampler.cc',
@@ -135,7 +138,10 @@
           ],
         }],
         ['target_arch=="ia32" or target_arch=="x64"', {
-          'dependencies': ['common_audio_sse2',],
+          'dependencies': [
+            'common_audio_avx2',
+            'common_audio_sse2',
+          ],
         }],
         ['build_with_neon==1', {
           'dependencies': ['common_audio_neon',],
@@ -199,7 +205,12 @@
           'type': 'static_library',
           'sources': [
             'fir_filter_sse.cc',
+            'real_fourier_stockham_sse2.cc',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/downsample_fast_sse2.c',
+            'signal_processing/min_max_operations_sse2.c',
+            'signal_processing/vector_scaling_operations_sse2.c',
           ],
           'conditions': [
             ['os_posix==1', {
@@ -210,6 +221,21 @@
             }],
           ],
         },
+        {
+          'target_name': 'common_audio_avx2',
+          'type': 'static_library',
+          'sources': [
+            'resampler/sinc_resampler_avx2.cc',
+          ],
+          'conditions': [
+            ['os_posix==1', {
+              'cflags': [ '-mavx2', '-mfma', ],
+              'xcode_settings': {
+                'OTHER_CFLAGS': [ '-mavx2', '-mfma', ],
+              },
+            }],
+          ],
+        },
       ],  # targets
     }],
     ['build_with_neon==1', {
@@ -220,6 +246,7 @@
           'includes': ['../build/arm_neon.gypi',],
           'sources': [
             'fir_filter_neon.cc',
+            'real_fourier_stockham_neon.cc',
             'resampler/sinc_resampler_neon.cc',
             'signal_processing/cross_correlation_neon.c',
             'signal_processing/downsample_fast_neon.c',
@@ -13,6 +13,7 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/common_audio/real_fourier_ooura.h"
 #include "webrtc/common_audio/real_fourier_openmax.h"
+#include "webrtc/common_audio/real_fourier_stockham.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
 
 namespace webrtc {
@@ -25,6 +26,8 @@ std::unique_ptr<RealFourier> RealFourier::Create(int fft_order) {
 #if defined(RTC_USE_OPENMAX_DL)
   return std::unique_ptr<RealFourier>(new RealFourierOpenmax(fft_order));
 #else
+  if (RealFourierStockham::IsOptimized(fft_order))
+    return std::unique_ptr<RealFourier>(new RealFourierStockham(fft_order));
   return std::unique_ptr<RealFourier>(new RealFourierOoura(fft_order));
 #endif
 }
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "webrtc/common_audio/real_fourier_stockham.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+using std::complex;
+
+namespace {
+
+// The alignment of the internal buffers, enough for the vectorized kernels.
+const size_t kBufferAlignment = 16;
+
+void DeinterleaveC(const float* in, size_t length, float* re, float* im) {
+  for (size_t i = 0; i < length; ++i) {
+    re[i] = in[2 * i];
+    im[i] = in[2 * i + 1];
+  }
+}
+
+void InterleaveC(const float* re, const float* im, size_t length, float* out) {
+  for (size_t i = 0; i < length; ++i) {
+    out[2 * i] = re[i];
+    out[2 * i + 1] = im[i];
+  }
+}
+
+void ButterflyC(const float* in_re,
+                const float* in_im,
+                size_t length,
+                size_t stride,
+                const float* twiddle_re,
+                const float* twiddle_im,
+                float* out_re,
+                float* out_im) {
+  const size_t half = length / 2;
+  for (size_t p = 0; p < half / stride; ++p) {
+    for (size_t q = 0; q < stride; ++q) {
+      const size_t k = q + stride * p;
+      const size_t j = q + 2 * stride * p;
+      const float diff_re = in_re[k] - in_re[k + half];
+      const float diff_im = in_im[k] - in_im[k + half];
+      out_re[j] = in_re[k] + in_re[k + half];
+      out_im[j] = in_im[k] + in_im[k + half];
+      out_re[j + stride] = diff_re * twiddle_re[p] - diff_im * twiddle_im[p];
+      out_im[j + stride] = diff_re * twiddle_im[p] + diff_im * twiddle_re[p];
+    }
+  }
+}
+
+void ForwardPostprocessC(const float* re,
+                         const float* im,
+                         size_t length,
+                         const float* twiddle_re,
+                         const float* twiddle_im,
+                         complex<float>* out) {
+  out[0] = complex<float>(re[0] + im[0], 0.f);
+  out[length] = complex<float>(re[0] - im[0], 0.f);
+  for (size_t k = 1; k < length; ++k) {
+    const float sum_re = re[k] + re[length - k];
+    const float sum_im = im[k] + im[length - k];
+    const float diff_re = re[k] - re[length - k];
+    const float diff_im = im[k] - im[length - k];
+    out[k] = complex<float>(
+        0.5f * (sum_re + twiddle_re[k] * sum_im + twiddle_im[k] * diff_re),
+        0.5f * (diff_im - twiddle_re[k] * diff_re + twiddle_im[k] * sum_im));
+  }
+}
+
+void InversePreprocessC(const complex<float>* in,
+                        size_t length,
+                        const float* twiddle_re,
+                        const float* twiddle_im,
+                        float* re,
+                        float* im) {
+  const float scale = 0.5f / length;
+  im[0] = scale * (in[0].real() + in[length].real());
+  re[0] = scale * (in[0].real() - in[length].real());
+  for (size_t k = 1; k < length; ++k) {
+    const float sum_re = in[k].real() + in[length - k].real();
+    const float sum_im = in[k].imag() + in[length - k].imag();
+    const float diff_re = in[k].real() - in[length - k].real();
+    const float diff_im = in[k].imag() - in[length - k].imag();
+    im[k] = scale *
+            (sum_re - twiddle_re[k] * sum_im + twiddle_im[k] * diff_re);
+    re[k] = scale *
+            (diff_im + twiddle_re[k] * diff_re + twiddle_im[k] * sum_im);
+  }
+}
+
+}  // namespace
+
+RealFourierStockham::RealFourierStockham(int fft_order)
+    : order_(fft_order),
+      length_(FftLength(order_)),
+      half_length_(length_ / 2),
+      twiddles_(static_cast<float*>(
+          AlignedMalloc(4 * half_length_ * sizeof(float), kBufferAlignment))),
+      work_(static_cast<float*>(
+          AlignedMalloc(4 * half_length_ * sizeof(float), kBufferAlignment))),
+      deinterleave_(DeinterleaveC),
+      interleave_(InterleaveC),
+      butterfly_(ButterflyC),
+      forward_postprocess_(ForwardPostprocessC),
+      inverse_preprocess_(InversePreprocessC) {
+  RTC_CHECK_GE(fft_order, 1);
+
+  // Pass |stride| of the complex transform works on sub-transforms of length
+  // |half_length_| / |stride|, each needing half as many twiddle factors.
+  float* twiddle_re = twiddles_.get();
+  float* twiddle_im = twiddle_re + half_length_;
+  for (size_t stride = 1; stride < half_length_; stride *= 2) {
+    const size_t sub_length = half_length_ / stride;
+    for (size_t p = 0; p < sub_length / 2; ++p) {
+      const double angle = -2.0 * M_PI * p / sub_length;
+      *twiddle_re++ = static_cast<float>(cos(angle));
+      *twiddle_im++ = static_cast<float>(sin(angle));
+    }
+  }
+  twiddle_re = twiddles_.get() + 2 * half_length_;
+  twiddle_im = twiddle_re + half_length_;
+  for (size_t k = 0; k < half_length_; ++k) {
+    const double angle = -M_PI * k / half_length_;
+    twiddle_re[k] = static_cast<float>(cos(angle));
+    twiddle_im[k] = static_cast<float>(sin(angle));
+  }
+
+  if (IsOptimized(fft_order)) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    deinterleave_ = real_fourier_stockham::DeinterleaveSSE2;
+    interleave_ = real_fourier_stockham::InterleaveSSE2;
+    butterfly_ = real_fourier_stockham::ButterflySSE2;
+    forward_postprocess_ = real_fourier_stockham::ForwardPostprocessSSE2;
+    inverse_preprocess_ = real_fourier_stockham::InversePreprocessSSE2;
+#elif defined(WEBRTC_HAS_NEON)
+    deinterleave_ = real_fourier_stockham::DeinterleaveNEON;
+    interleave_ = real_fourier_stockham::InterleaveNEON;
+    butterfly_ = real_fourier_stockham::ButterflyNEON;
+    forward_postprocess_ = real_fourier_stockham::ForwardPostprocessNEON;
+    inverse_preprocess_ = real_fourier_stockham::InversePreprocessNEON;
+#endif
+  }
+}
+
+RealFourierStockham::~RealFourierStockham() = default;
+
+bool RealFourierStockham::IsOptimized(int fft_order) {
+  if (fft_order < real_fourier_stockham::kMinSimdOrder)
+    return false;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return WebRtc_GetCPUInfo(kSSE2) != 0;
+#elif defined(WEBRTC_HAS_NEON)
+  return true;
+#else
+  return false;
+#endif
+}
+
+size_t RealFourierStockham::ComplexForward() const {
+  const float* twiddle_re = twiddles_.get();
+  const float* twiddle_im = twiddle_re + half_length_;
+  size_t in = 0;
+  size_t out = 2 * half_length_;
+  for (size_t stride = 1; stride < half_length_; stride *= 2) {
+    float* const work = work_.get();
+    butterfly_(&work[in], &work[in + half_length_], half_length_, stride,
+               twiddle_re, twiddle_im, &work[out], &work[out + half_length_]);
+    const size_t num_twiddles = half_length_ / (2 * stride);
+    twiddle_re += num_twiddles;
+    twiddle_im += num_twiddles;
+    std::swap(in, out);
+  }
+  return in;
+}
+
+void RealFourierStockham::Forward(const float* src,
+                                  complex<float>* dest) const {
+  float* const work = work_.get();
+  deinterleave_(src, half_length_, work, work + half_length_);
+  const size_t result = ComplexForward();
+  const float* twiddle_re = twiddles_.get() + 2 * half_length_;
+  forward_postprocess_(&work[result], &work[result + half_length_],
+                       half_length_, twiddle_re, twiddle_re + half_length_,
+                       dest);
+}
+
+void RealFourierStockham::Inverse(const complex<float>* src,
+                                  float* dest) const {
+  float* const work = work_.get();
+  const float* twiddle_re = twiddles_.get() + 2 * half_length_;
+  inverse_preprocess_(src, half_length_, twiddle_re, twiddle_re + half_length_,
+                      work, work + half_length_);
+  const size_t result = ComplexForward();
+  // Swapping the real and imaginary parts back completes the inverse.
+  interleave_(&work[result + half_length_], &work[result], half_length_,
+              dest);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_REAL_FOURIER_STOCKHAM_H_
+#define WEBRTC_COMMON_AUDIO_REAL_FOURIER_STOCKHAM_H_
+
+#include <complex>
+#include <memory>
+
+#include "webrtc/common_audio/real_fourier.h"
+#include "webrtc/common_audio/real_fourier_stockham_internal.h"
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+
+namespace webrtc {
+
+// Real FFT computed through a half-length complex Stockham autosort FFT on
+// split real and imaginary arrays, which vectorizes without the shuffling an
+// interleaved layout needs. Uses SSE2 or NEON when available and the order is
+// at least |real_fourier_stockham::kMinSimdOrder|, plain C otherwise.
+class RealFourierStockham : public RealFourier {
+ public:
+  explicit RealFourierStockham(int fft_order);
+  ~RealFourierStockham() override;
+
+  // Whether the vectorized kernels are used for |fft_order| on this CPU.
+  static bool IsOptimized(int fft_order);
+
+  void Forward(const float* src, std::complex<float>* dest) const override;
+  void Inverse(const std::complex<float>* src, float* dest) const override;
+
+  int order() const override {
+    return order_;
+  }
+
+ private:
+  // Runs the complex transform on the split data in |work_|, ping-ponging
+  // between its two halves. Returns the offset of the half with the result.
+  size_t ComplexForward() const;
+
+  const int order_;
+  const size_t length_;
+  const size_t half_length_;
+  // The |half_length_| - 1 twiddle factors of all the passes of the complex
+  // transform followed by the |half_length_| ones of the real transform, real
+  // parts first.
+  const std::unique_ptr<float[], AlignedFreeDeleter> twiddles_;
+  // Two pairs of real and imaginary arrays of |half_length_| samples.
+  const std::unique_ptr<float[], AlignedFreeDeleter> work_;
+
+  real_fourier_stockham::Deinterleave deinterleave_;
+  real_fourier_stockham::Interleave interleave_;
+  real_fourier_stockham::Butterfly butterfly_;
+  real_fourier_stockham::ForwardPostprocess forward_postprocess_;
+  real_fourier_stockham::InversePreprocess inverse_preprocess_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_REAL_FOURIER_STOCKHAM_H_
@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_AUDIO_REAL_FOURIER_STOCKHAM_INTERNAL_H_
+#define WEBRTC_COMMON_AUDIO_REAL_FOURIER_STOCKHAM_INTERNAL_H_
+
+#include <stddef.h>
+
+#include <complex>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace real_fourier_stockham {
+
+// The complex transform and the arrays it works on are split into their real
+// (|re|) and imaginary (|im|) parts. A real transform of length 2 * |length|
+// packs its even samples into |re| and its odd samples into |im|, does a
+// |length|-point complex transform and unpacks the result.
+
+// Smallest FFT order the vectorized kernels handle: they need at least four
+// butterflies in each pass of the complex transform.
+const int kMinSimdOrder = 4;
+
+// Splits the 2 * |length| samples of |in| into the even |re| and odd |im|
+// halves.
+typedef void (*Deinterleave)(const float* in,
+                             size_t length,
+                             float* re,
+                             float* im);
+
+// Inverse of Deinterleave.
+typedef void (*Interleave)(const float* re,
+                           const float* im,
+                           size_t length,
+                           float* out);
+
+// Radix-2 pass of a |length|-point Stockham autosort FFT in which |stride|
+// sub-transforms are done in parallel. The |length| / (2 * |stride|)
+// |twiddle_re| and |twiddle_im| factors are those of the current sub-transform
+// length. The output must not alias the input.
+typedef void (*Butterfly)(const float* in_re,
+                          const float* in_im,
+                          size_t length,
+                          size_t stride,
+                          const float* twiddle_re,
+                          const float* twiddle_im,
+                          float* out_re,
+                          float* out_im);
+
+// Turns the |length|-point complex transform |re|, |im| of the packed real
+// input into the |length| + 1 bins of its real transform. |twiddle_re| and
+// |twiddle_im| hold the |length| factors exp(-i * pi * k / |length|).
+typedef void (*ForwardPostprocess)(const float* re,
+                                   const float* im,
+                                   size_t length,
+                                   const float* twiddle_re,
+                                   const float* twiddle_im,
+                                   std::complex<float>* out);
+
+// Inverse of ForwardPostprocess, scaled such that the complex transform which
+// follows it gives the unscaled result. The real and imaginary parts are
+// swapped in |re| and |im| so that the inverse complex transform can be done
+// with the forward one.
+typedef void (*InversePreprocess)(const std::complex<float>* in,
+                                  size_t length,
+                                  const float* twiddle_re,
+                                  const float* twiddle_im,
+                                  float* re,
+                                  float* im);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void DeinterleaveSSE2(const float* in, size_t length, float* re, float* im);
+void InterleaveSSE2(const float* re, const float* im, size_t length,
+                    float* out);
+void ButterflySSE2(const float* in_re,
+                   const float* in_im,
+                   size_t length,
+                   size_t stride,
+                   const float* twiddle_re,
+                   const float* twiddle_im,
+                   float* out_re,
+                   float* out_im);
+void ForwardPostprocessSSE2(const float* re,
+                            const float* im,
+                            size_t length,
+                            const float* twiddle_re,
+                            const float* twiddle_im,
+                            std::complex<float>* out);
+void InversePreprocessSSE2(const std::complex<float>* in,
+                           size_t length,
+                           const float* twiddle_re,
+                           const float* twiddle_im,
+                           float* re,
+                           float* im);
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void DeinterleaveNEON(const float* in, size_t length, float* re, float* im);
+void InterleaveNEON(const float* re, const float* im, size_t length,
+                    float* out);
+void ButterflyNEON(const float* in_re,
+                   const float* in_im,
+                   size_t length,
+                   size_t stride,
+                   const float* twiddle_re,
+                   const float* twiddle_im,
+                   float* out_re,
+                   float* out_im);
+void ForwardPostprocessNEON(const float* re,
+                            const float* im,
+                            size_t length,
+                            const float* twiddle_re,
+                            const float* twiddle_im,
+                            std::complex<float>* out);
+void InversePreprocessNEON(const std::complex<float>* in,
+                           size_t length,
+                           const float* twiddle_re,
+                           const float* twiddle_im,
+                           float* re,
+                           float* im);
+#endif
+
+}  // namespace real_fourier_stockham
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_AUDIO_REAL_FOURIER_STOCKHAM_INTERNAL_H_
@@ -0,0 +1,231 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// NEON versions of the Stockham real FFT kernels.
+
+#include <arm_neon.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/common_audio/real_fourier_stockham_internal.h"
+
+namespace webrtc {
+namespace real_fourier_stockham {
+
+namespace {
+
+float32x4_t Reverse(float32x4_t x) {
+  x = vrev64q_f32(x);
+  return vcombine_f32(vget_high_f32(x), vget_low_f32(x));
+}
+
+}  // namespace
+
+void DeinterleaveNEON(const float* in, size_t length, float* re, float* im) {
+  RTC_DCHECK_EQ(0u, length % 4);
+  for (size_t i = 0; i < length; i += 4) {
+    const float32x4x2_t x = vld2q_f32(&in[2 * i]);
+    vst1q_f32(&re[i], x.val[0]);
+    vst1q_f32(&im[i], x.val[1]);
+  }
+}
+
+void InterleaveNEON(const float* re, const float* im, size_t length,
+                    float* out) {
+  RTC_DCHECK_EQ(0u, length % 4);
+  for (size_t i = 0; i < length; i += 4) {
+    float32x4x2_t x;
+    x.val[0] = vld1q_f32(&re[i]);
+    x.val[1] = vld1q_f32(&im[i]);
+    vst2q_f32(&out[2 * i], x);
+  }
+}
+
+void ButterflyNEON(const float* in_re,
+                   const float* in_im,
+                   size_t length,
+                   size_t stride,
+                   const float* twiddle_re,
+                   const float* twiddle_im,
+                   float* out_re,
+                   float* out_im) {
+  const size_t half = length / 2;
+  RTC_DCHECK_EQ(0u, half % 4);
+  if (stride == 1) {
+    // Each butterfly has its own twiddle factor and its two outputs are
+    // adjacent.
+    for (size_t k = 0; k < half; k += 4) {
+      const float32x4_t a_re = vld1q_f32(&in_re[k]);
+      const float32x4_t a_im = vld1q_f32(&in_im[k]);
+      const float32x4_t b_re = vld1q_f32(&in_re[k + half]);
+      const float32x4_t b_im = vld1q_f32(&in_im[k + half]);
+      const float32x4_t w_re = vld1q_f32(&twiddle_re[k]);
+      const float32x4_t w_im = vld1q_f32(&twiddle_im[k]);
+      const float32x4_t diff_re = vsubq_f32(a_re, b_re);
+      const float32x4_t diff_im = vsubq_f32(a_im, b_im);
+      float32x4x2_t re;
+      float32x4x2_t im;
+      re.val[0] = vaddq_f32(a_re, b_re);
+      im.val[0] = vaddq_f32(a_im, b_im);
+      re.val[1] = vsubq_f32(vmulq_f32(diff_re, w_re), vmulq_f32(diff_im, w_im));
+      im.val[1] = vaddq_f32(vmulq_f32(diff_re, w_im), vmulq_f32(diff_im, w_re));
+      vst2q_f32(&out_re[2 * k], re);
+      vst2q_f32(&out_im[2 * k], im);
+    }
+  } else if (stride == 2) {
+    // Pairs of butterflies share a twiddle factor and their outputs are
+    // adjacent pairs.
+    for (size_t k = 0; k < half; k += 4) {
+      const float32x4_t a_re = vld1q_f32(&in_re[k]);
+      const float32x4_t a_im = vld1q_f32(&in_im[k]);
+      const float32x4_t b_re = vld1q_f32(&in_re[k + half]);
+      const float32x4_t b_im = vld1q_f32(&in_im[k + half]);
+      const float32x2_t w_re_pair = vld1_f32(&twiddle_re[k / 2]);
+      const float32x2_t w_im_pair = vld1_f32(&twiddle_im[k / 2]);
+      const float32x2x2_t w_re_zip = vzip_f32(w_re_pair, w_re_pair);
+      const float32x2x2_t w_im_zip = vzip_f32(w_im_pair, w_im_pair);
+      const float32x4_t w_re = vcombine_f32(w_re_zip.val[0], w_re_zip.val[1]);
+      const float32x4_t w_im = vcombine_f32(w_im_zip.val[0], w_im_zip.val[1]);
+      const float32x4_t sum_re = vaddq_f32(a_re, b_re);
+      const float32x4_t sum_im = vaddq_f32(a_im, b_im);
+      const float32x4_t diff_re = vsubq_f32(a_re, b_re);
+      const float32x4_t diff_im = vsubq_f32(a_im, b_im);
+      const float32x4_t prod_re =
+          vsubq_f32(vmulq_f32(diff_re, w_re), vmulq_f32(diff_im, w_im));
+      const float32x4_t prod_im =
+          vaddq_f32(vmulq_f32(diff_re, w_im), vmulq_f32(diff_im, w_re));
+      vst1q_f32(&out_re[2 * k],
+                vcombine_f32(vget_low_f32(sum_re), vget_low_f32(prod_re)));
+      vst1q_f32(&out_re[2 * k + 4],
+                vcombine_f32(vget_high_f32(sum_re), vget_high_f32(prod_re)));
+      vst1q_f32(&out_im[2 * k],
+                vcombine_f32(vget_low_f32(sum_im), vget_low_f32(prod_im)));
+      vst1q_f32(&out_im[2 * k + 4],
+                vcombine_f32(vget_high_f32(sum_im), vget_high_f32(prod_im)));
+    }
+  } else {
+    // Whole vectors of butterflies share a twiddle factor.
+    RTC_DCHECK_EQ(0u, stride % 4);
+    for (size_t p = 0; p < half / stride; ++p) {
+      const float32x4_t w_re = vdupq_n_f32(twiddle_re[p]);
+      const float32x4_t w_im = vdupq_n_f32(twiddle_im[p]);
+      for (size_t q = 0; q < stride; q += 4) {
+        const size_t k = q + stride * p;
+        const size_t j = q + 2 * stride * p;
+        const float32x4_t a_re = vld1q_f32(&in_re[k]);
+        const float32x4_t a_im = vld1q_f32(&in_im[k]);
+        const float32x4_t b_re = vld1q_f32(&in_re[k + half]);
+        const float32x4_t b_im = vld1q_f32(&in_im[k + half]);
+        const float32x4_t diff_re = vsubq_f32(a_re, b_re);
+        const float32x4_t diff_im = vsubq_f32(a_im, b_im);
+        vst1q_f32(&out_re[j], vaddq_f32(a_re, b_re));
+        vst1q_f32(&out_im[j], vaddq_f32(a_im, b_im));
+        vst1q_f32(&out_re[j + stride], vsubq_f32(vmulq_f32(diff_re, w_re),
+                                                 vmulq_f32(diff_im, w_im)));
+        vst1q_f32(&out_im[j + stride], vaddq_f32(vmulq_f32(diff_re, w_im),
+                                                 vmulq_f32(diff_im, w_re)));
+      }
+    }
+  }
+}
+
+void ForwardPostprocessNEON(const float* re,
+                            const float* im,
+                            size_t length,
+                            const float* twiddle_re,
+                            const float* twiddle_im,
+                            std::complex<float>* out) {
+  float* out_float = reinterpret_cast<float*>(out);
+  out[0] = std::complex<float>(re[0] + im[0], 0.f);
+  out[length] = std::complex<float>(re[0] - im[0], 0.f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+
+  // vectorized code (four at once)
+  size_t k = 1;
+  for (; k + 3 < length; k += 4) {
+    const float32x4_t a_re = vld1q_f32(&re[k]);
+    const float32x4_t a_im = vld1q_f32(&im[k]);
+    const float32x4_t c_re = Reverse(vld1q_f32(&re[length - k - 3]));
+    const float32x4_t c_im = Reverse(vld1q_f32(&im[length - k - 3]));
+    const float32x4_t w_re = vld1q_f32(&twiddle_re[k]);
+    const float32x4_t w_im = vld1q_f32(&twiddle_im[k]);
+    const float32x4_t sum_re = vaddq_f32(a_re, c_re);
+    const float32x4_t sum_im = vaddq_f32(a_im, c_im);
+    const float32x4_t diff_re = vsubq_f32(a_re, c_re);
+    const float32x4_t diff_im = vsubq_f32(a_im, c_im);
+    float32x4x2_t x;
+    x.val[0] = vmulq_f32(
+        half, vaddq_f32(vaddq_f32(sum_re, vmulq_f32(w_re, sum_im)),
+                        vmulq_f32(w_im, diff_re)));
+    x.val[1] = vmulq_f32(
+        half, vaddq_f32(vsubq_f32(diff_im, vmulq_f32(w_re, diff_re)),
+                        vmulq_f32(w_im, sum_im)));
+    vst2q_f32(&out_float[2 * k], x);
+  }
+  // scalar code for the remaining items.
+  for (; k < length; ++k) {
+    const float sum_re = re[k] + re[length - k];
+    const float sum_im = im[k] + im[length - k];
+    const float diff_re = re[k] - re[length - k];
+    const float diff_im = im[k] - im[length - k];
+    out[k] = std::complex<float>(
+        0.5f * (sum_re + twiddle_re[k] * sum_im + twiddle_im[k] * diff_re),
+        0.5f * (diff_im - twiddle_re[k] * diff_re + twiddle_im[k] * sum_im));
+  }
+}
+
+void InversePreprocessNEON(const std::complex<float>* in,
+                           size_t length,
+                           const float* twiddle_re,
+                           const float* twiddle_im,
+                           float* re,
+                           float* im) {
+  const float* in_float = reinterpret_cast<const float*>(in);
+  const float scale = 0.5f / length;
+  im[0] = scale * (in[0].real() + in[length].real());
+  re[0] = scale * (in[0].real() - in[length].real());
+  const float32x4_t scale_ps = vdupq_n_f32(scale);
+
+  // vectorized code (four at once)
+  size_t k = 1;
+  for (; k + 3 < length; k += 4) {
+    const float32x4x2_t a = vld2q_f32(&in_float[2 * k]);
+    const float32x4x2_t c = vld2q_f32(&in_float[2 * (length - k - 3)]);
+    const float32x4_t c_re = Reverse(c.val[0]);
+    const float32x4_t c_im = Reverse(c.val[1]);
+    const float32x4_t w_re = vld1q_f32(&twiddle_re[k]);
+    const float32x4_t w_im = vld1q_f32(&twiddle_im[k]);
+    const float32x4_t sum_re = vaddq_f32(a.val[0], c_re);
+    const float32x4_t sum_im = vaddq_f32(a.val[1], c_im);
+    const float32x4_t diff_re = vsubq_f32(a.val[0], c_re);
+    const float32x4_t diff_im = vsubq_f32(a.val[1], c_im);
+    vst1q_f32(&im[k],
+              vmulq_f32(scale_ps,
+                        vaddq_f32(vsubq_f32(sum_re, vmulq_f32(w_re, sum_im)),
+                                  vmulq_f32(w_im, diff_re))));
+    vst1q_f32(&re[k],
+              vmulq_f32(scale_ps,
+                        vaddq_f32(vaddq_f32(diff_im, vmulq_f32(w_re, diff_re)),
+                                  vmulq_f32(w_im, sum_im))));
+  }
+  // scalar code for the remaining items.
+  for (; k < length; ++k) {
+    const float sum_re = in[k].real() + in[length - k].real();
+    const float sum_im = in[k].imag() + in[length - k].imag();
+    const float diff_re = in[k].real() - in[length - k].real();
+    const float diff_im = in[k].imag() - in[length - k].imag();
+    im[k] = scale *
+            (sum_re - twiddle_re[k] * sum_im + twiddle_im[k] * diff_re);
+    re[k] = scale *
+            (diff_im + twiddle_re[k] * diff_re + twiddle_im[k] * sum_im);
+  }
+}
+
+}  // namespace real_fourier_stockham
+}  // namespace webrtc
@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// SSE2 versions of the Stockham real FFT kernels. The operations are done in
+// the same order as in the C versions, so the output is bit-exact.
+
+#include <emmintrin.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/common_audio/real_fourier_stockham_internal.h"
+
+namespace webrtc {
+namespace real_fourier_stockham {
+
+namespace {
+
+__m128 Reverse(__m128 x) {
+  return _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+}  // namespace
+
+void DeinterleaveSSE2(const float* in, size_t length, float* re, float* im) {
+  RTC_DCHECK_EQ(0u, length % 4);
+  for (size_t i = 0; i < length; i += 4) {
+    const __m128 a = _mm_loadu_ps(&in[2 * i]);
+    const __m128 b = _mm_loadu_ps(&in[2 * i + 4]);
+    _mm_store_ps(&re[i], _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_store_ps(&im[i], _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+}
+
+void InterleaveSSE2(const float* re, const float* im, size_t length,
+                    float* out) {
+  RTC_DCHECK_EQ(0u, length % 4);
+  for (size_t i = 0; i < length; i += 4) {
+    const __m128 a = _mm_load_ps(&re[i]);
+    const __m128 b = _mm_load_ps(&im[i]);
+    _mm_storeu_ps(&out[2 * i], _mm_unpacklo_ps(a, b));
+    _mm_storeu_ps(&out[2 * i + 4], _mm_unpackhi_ps(a, b));
+  }
+}
+
+void ButterflySSE2(const float* in_re,
+                   const float* in_im,
+                   size_t length,
+                   size_t stride,
+                   const float* twiddle_re,
+                   const float* twiddle_im,
+                   float* out_re,
+                   float* out_im) {
+  const size_t half = length / 2;
+  RTC_DCHECK_EQ(0u, half % 4);
+  if (stride == 1) {
+    // Each butterfly has its own twiddle factor and its two outputs are
+    // adjacent.
+    for (size_t k = 0; k < half; k += 4) {
+      const __m128 a_re = _mm_load_ps(&in_re[k]);
+      const __m128 a_im = _mm_load_ps(&in_im[k]);
+      const __m128 b_re = _mm_load_ps(&in_re[k + half]);
+      const __m128 b_im = _mm_load_ps(&in_im[k + half]);
+      const __m128 w_re = _mm_loadu_ps(&twiddle_re[k]);
+      const __m128 w_im = _mm_loadu_ps(&twiddle_im[k]);
+      const __m128 sum_re = _mm_add_ps(a_re, b_re);
+      const __m128 sum_im = _mm_add_ps(a_im, b_im);
+      const __m128 diff_re = _mm_sub_ps(a_re, b_re);
+      const __m128 diff_im = _mm_sub_ps(a_im, b_im);
+      const __m128 prod_re =
+          _mm_sub_ps(_mm_mul_ps(diff_re, w_re), _mm_mul_ps(diff_im, w_im));
+      const __m128 prod_im =
+          _mm_add_ps(_mm_mul_ps(diff_re, w_im), _mm_mul_ps(diff_im, w_re));
+      _mm_store_ps(&out_re[2 * k], _mm_unpacklo_ps(sum_re, prod_re));
+      _mm_store_ps(&out_re[2 * k + 4], _mm_unpackhi_ps(sum_re, prod_re));
+      _mm_store_ps(&out_im[2 * k], _mm_unpacklo_ps(sum_im, prod_im));
+      _mm_store_ps(&out_im[2 * k + 4], _mm_unpackhi_ps(sum_im, prod_im));
+    }
+  } else if (stride == 2) {
+    // Pairs of butterflies share a twiddle factor and their outputs are
+    // adjacent pairs.
+    for (size_t k = 0; k < half; k += 4) {
+      const __m128 a_re = _mm_load_ps(&in_re[k]);
+      const __m128 a_im = _mm_load_ps(&in_im[k]);
+      const __m128 b_re = _mm_load_ps(&in_re[k + half]);
+      const __m128 b_im = _mm_load_ps(&in_im[k + half]);
+      __m128 w_re = _mm_loadl_pi(_mm_setzero_ps(),
+                                 reinterpret_cast<const __m64*>(
+                                     &twiddle_re[k / 2]));
+      __m128 w_im = _mm_loadl_pi(_mm_setzero_ps(),
+                                 reinterpret_cast<const __m64*>(
+                                     &twiddle_im[k / 2]));
+      w_re = _mm_unpacklo_ps(w_re, w_re);
+      w_im = _mm_unpacklo_ps(w_im, w_im);
+      const __m128 sum_re = _mm_add_ps(a_re, b_re);
+      const __m128 sum_im = _mm_add_ps(a_im, b_im);
+      const __m128 diff_re = _mm_sub_ps(a_re, b_re);
+      const __m128 diff_im = _mm_sub_ps(a_im, b_im);
+      const __m128 prod_re =
+          _mm_sub_ps(_mm_mul_ps(diff_re, w_re), _mm_mul_ps(diff_im, w_im));
+      const __m128 prod_im =
+          _mm_add_ps(_mm_mul_ps(diff_re, w_im), _mm_mul_ps(diff_im, w_re));
+      _mm_store_ps(&out_re[2 * k], _mm_movelh_ps(sum_re, prod_re));
+      _mm_store_ps(&out_re[2 * k + 4], _mm_movehl_ps(prod_re, sum_re));
+      _mm_store_ps(&out_im[2 * k], _mm_movelh_ps(sum_im, prod_im));
+      _mm_store_ps(&out_im[2 * k + 4], _mm_movehl_ps(prod_im, sum_im));
+    }
+  } else {
+    // Whole vectors of butterflies share a twiddle factor.
+    RTC_DCHECK_EQ(0u, stride % 4);
+    for (size_t p = 0; p < half / stride; ++p) {
+      const __m128 w_re = _mm_set1_ps(twiddle_re[p]);
+      const __m128 w_im = _mm_set1_ps(twiddle_im[p]);
+      for (size_t q = 0; q < stride; q += 4) {
+        const size_t k = q + stride * p;
+        const size_t j = q + 2 * stride * p;
+        const __m128 a_re = _mm_load_ps(&in_re[k]);
+        const __m128 a_im = _mm_load_ps(&in_im[k]);
+        const __m128 b_re = _mm_load_ps(&in_re[k + half]);
+        const __m128 b_im = _mm_load_ps(&in_im[k + half]);
+        const __m128 diff_re = _mm_sub_ps(a_re, b_re);
+        const __m128 diff_im = _mm_sub_ps(a_im, b_im);
+        _mm_store_ps(&out_re[j], _mm_add_ps(a_re, b_re));
+        _mm_store_ps(&out_im[j], _mm_add_ps(a_im, b_im));
+        _mm_store_ps(&out_re[j + stride],
+                     _mm_sub_ps(_mm_mul_ps(diff_re, w_re),
+                                _mm_mul_ps(diff_im, w_im)));
+        _mm_store_ps(&out_im[j + stride],
+                     _mm_add_ps(_mm_mul_ps(diff_re, w_im),
+                                _mm_mul_ps(diff_im, w_re)));
+      }
+    }
+  }
+}
+
+void ForwardPostprocessSSE2(const float* re,
+                            const float* im,
+                            size_t length,
+                            const float* twiddle_re,
+                            const float* twiddle_im,
+                            std::complex<float>* out) {
+  float* out_float = reinterpret_cast<float*>(out);
+  out[0] = std::complex<float>(re[0] + im[0], 0.f);
+  out[length] = std::complex<float>(re[0] - im[0], 0.f);
+  const __m128 half = _mm_set1_ps(0.5f);
+
+  // vectorized code (four at once)
+  size_t k = 1;
+  for (; k + 3 < length; k += 4) {
+    const __m128 a_re = _mm_loadu_ps(&re[k]);
+    const __m128 a_im = _mm_loadu_ps(&im[k]);
+    const __m128 c_re = Reverse(_mm_loadu_ps(&re[length - k - 3]));
+    const __m128 c_im = Reverse(_mm_loadu_ps(&im[length - k - 3]));
+    const __m128 w_re = _mm_loadu_ps(&twiddle_re[k]);
+    const __m128 w_im = _mm_loadu_ps(&twiddle_im[k]);
+    const __m128 sum_re = _mm_add_ps(a_re, c_re);
+    const __m128 sum_im = _mm_add_ps(a_im, c_im);
+    const __m128 diff_re = _mm_sub_ps(a_re, c_re);
+    const __m128 diff_im = _mm_sub_ps(a_im, c_im);
+    const __m128 x_re = _mm_mul_ps(
+        half, _mm_add_ps(_mm_add_ps(sum_re, _mm_mul_ps(w_re, sum_im)),
+                         _mm_mul_ps(w_im, diff_re)));
+    const __m128 x_im = _mm_mul_ps(
+        half, _mm_add_ps(_mm_sub_ps(diff_im, _mm_mul_ps(w_re, diff_re)),
+                         _mm_mul_ps(w_im, sum_im)));
+    _mm_storeu_ps(&out_float[2 * k], _mm_unpacklo_ps(x_re, x_im));
+    _mm_storeu_ps(&out_float[2 * k + 4], _mm_unpackhi_ps(x_re, x_im));
+  }
+  // scalar code for the remaining items.
+  for (; k < length; ++k) {
+    const float sum_re = re[k] + re[length - k];
+    const float sum_im = im[k] + im[length - k];
+    const float diff_re = re[k] - re[length - k];
+    const float diff_im = im[k] - im[length - k];
+    out[k] = std::complex<float>(
+        0.5f * (sum_re + twiddle_re[k] * sum_im + twiddle_im[k] * diff_re),
+        0.5f * (diff_im - twiddle_re[k] * diff_re + twiddle_im[k] * sum_im));
+  }
+}
+
+void InversePreprocessSSE2(const std::complex<float>* in,
+                           size_t length,
+                           const float* twiddle_re,
+                           const float* twiddle_im,
+                           float* re,
+                           float* im) {
+  const float* in_float = reinterpret_cast<const float*>(in);
+  const float scale = 0.5f / length;
+  im[0] = scale * (in[0].real() + in[length].real());
+  re[0] = scale * (in[0].real() - in[length].real());
+  const __m128 scale_ps = _mm_set1_ps(scale);
+
+  // vectorized code (four at once)
+  size_t k = 1;
+  for (; k + 3 < length; k += 4) {
+    const __m128 a_lo = _mm_loadu_ps(&in_float[2 * k]);
+    const __m128 a_hi = _mm_loadu_ps(&in_float[2 * k + 4]);
+    const __m128 c_lo = _mm_loadu_ps(&in_float[2 * (length - k - 3)]);
+    const __m128 c_hi = _mm_loadu_ps(&in_float[2 * (length - k - 3) + 4]);
+    const __m128 a_re = _mm_shuffle_ps(a_lo, a_hi, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 a_im = _mm_shuffle_ps(a_lo, a_hi, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 c_re =
+        Reverse(_mm_shuffle_ps(c_lo, c_hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128 c_im =
+        Reverse(_mm_shuffle_ps(c_lo, c_hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    const __m128 w_re = _mm_loadu_ps(&twiddle_re[k]);
+    const __m128 w_im = _mm_loadu_ps(&twiddle_im[k]);
+    const __m128 sum_re = _mm_add_ps(a_re, c_re);
+    const __m128 sum_im = _mm_add_ps(a_im, c_im);
+    const __m128 diff_re = _mm_sub_ps(a_re, c_re);
+    const __m128 diff_im = _mm_sub_ps(a_im, c_im);
+    _mm_storeu_ps(
+        &im[k],
+        _mm_mul_ps(scale_ps,
+                   _mm_add_ps(_mm_sub_ps(sum_re, _mm_mul_ps(w_re, sum_im)),
+                              _mm_mul_ps(w_im, diff_re))));
+    _mm_storeu_ps(
+        &re[k],
+        _mm_mul_ps(scale_ps,
+                   _mm_add_ps(_mm_add_ps(diff_im, _mm_mul_ps(w_re, diff_re)),
+                              _mm_mul_ps(w_im, sum_im))));
+  }
+  // scalar code for the remaining items.
+  for (; k < length; ++k) {
+    const float sum_re = in[k].real() + in[length - k].real();
+    const float sum_im = in[k].imag() + in[length - k].imag();
+    const float diff_re = in[k].real() - in[length - k].real();
+    const float diff_im = in[k].imag() - in[length - k].imag();
+    im[k] = scale *
+            (sum_re - twiddle_re[k] * sum_im + twiddle_im[k] * diff_re);
+    re[k] = scale *
+            (diff_im + twiddle_re[k] * diff_re + twiddle_im[k] * sum_im);
+  }
+}
+
+}  // namespace real_fourier_stockham
+}  // namespace webrtc
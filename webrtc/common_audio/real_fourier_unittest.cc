@@ -10,11 +10,16 @@
 
 #include "webrtc/common_audio/real_fourier.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_audio/real_fourier_openmax.h"
 #include "webrtc/common_audio/real_fourier_ooura.h"
+#include "webrtc/common_audio/real_fourier_stockham.h"
 
 namespace webrtc {
 
@@ -73,7 +78,8 @@ using FftTypes = ::testing::Types<
 #if defined(RTC_USE_OPENMAX_DL)
     RealFourierOpenmax,
 #endif
-    RealFourierOoura>;
+    RealFourierOoura,
+    RealFourierStockham>;
 TYPED_TEST_CASE(RealFourierTest, FftTypes);
 
 TYPED_TEST(RealFourierTest, SimpleForwardTransform) {
@@ -105,5 +111,72 @@ TYPED_TEST(RealFourierTest, SimpleBackwardTransform) {
   EXPECT_NEAR(this->real_buffer_[3], 4.0f, 1e-8f);
 }
 
-}  // namespace webrtc
+// Compares the Stockham transform, vectorized from order
+// |real_fourier_stockham::kMinSimdOrder| where the CPU allows it, with Ooura
+// for random input over the whole range of sizes used in APM.
+TEST(RealFourierStockhamTest, MatchesOoura) {
+  srand(42);
+  for (int order = 1; order <= 12; ++order) {
+    SCOPED_TRACE(order);
+    const size_t length = RealFourier::FftLength(order);
+    const size_t complex_length = RealFourier::ComplexLength(order);
+    RealFourierOoura ooura(order);
+    RealFourierStockham stockham(order);
+    RealFourier::fft_real_scoper real = RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_real_scoper real_out =
+        RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_cplx_scoper expected =
+        RealFourier::AllocCplxBuffer(complex_length);
+    RealFourier::fft_cplx_scoper actual =
+        RealFourier::AllocCplxBuffer(complex_length);
+    for (size_t i = 0; i < length; ++i) {
+      real[i] = 2.f * rand() / RAND_MAX - 1.f;
+    }
+
+    ooura.Forward(real.get(), expected.get());
+    stockham.Forward(real.get(), actual.get());
+    // The rounding errors of both grow with the size of the transform.
+    const float tolerance = 1e-6f * length;
+    for (size_t i = 0; i < complex_length; ++i) {
+      EXPECT_NEAR(expected[i].real(), actual[i].real(), tolerance);
+      EXPECT_NEAR(expected[i].imag(), actual[i].imag(), tolerance);
+    }
+
+    stockham.Inverse(actual.get(), real_out.get());
+    for (size_t i = 0; i < length; ++i) {
+      EXPECT_NEAR(real[i], real_out[i], 1e-5f);
+    }
+  }
+}
 
+// Benchmarks a forward and inverse transform for each FFT size, comparing
+// Ooura with the implementation RealFourier::Create() picks.
+TEST(RealFourierTest, DISABLED_FftSizeSweepBenchmark) {
+  const int kIterations = 100000;
+  for (int order = 4; order <= 12; ++order) {
+    const size_t length = RealFourier::FftLength(order);
+    RealFourier::fft_real_scoper real = RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_cplx_scoper cplx =
+        RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(order));
+    std::fill(real.get(), real.get() + length, 0.5f);
+    std::unique_ptr<RealFourier> ooura(new RealFourierOoura(order));
+    std::unique_ptr<RealFourier> created = RealFourier::Create(order);
+    double ns_per_transform[2];
+    for (int j = 0; j < 2; ++j) {
+      const RealFourier* fft = j == 0 ? ooura.get() : created.get();
+      const int64_t start = rtc::TimeNanos();
+      for (int i = 0; i < kIterations; ++i) {
+        fft->Forward(real.get(), cplx.get());
+        fft->Inverse(cplx.get(), real.get());
+      }
+      ns_per_transform[j] =
+          static_cast<double>(rtc::TimeNanos() - start) / kIterations;
+    }
+    printf("FFT length %4zu: Ooura took %.0fns; RealFourier::Create() took "
+           "%.0fns, which is %.2fx faster.\n",
+           length, ns_per_transform[0], ns_per_transform[1],
+           ns_per_transform[0] / ns_per_transform[1]);
+  }
+}
+
+}  // namespace webrtc
@@ -118,27 +118,32 @@ double SincScaleFactor(double io_ratio) {
 
 }  // namespace
 
-// If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-#if defined(__SSE2__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
-// x86 CPU detection required.  Function will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// x86 CPU detection required, since AVX2 is not part of the baseline.
+// Functions will be set by InitializeCPUSpecificFeatures().
 #define CONVOLVE_FUNC convolve_proc_
+#define CONVOLVE_SINGLE_KERNEL_FUNC convolve_single_kernel_proc_
 
 void SincResampler::InitializeCPUSpecificFeatures() {
-  convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    convolve_proc_ = Convolve_AVX2;
+    convolve_single_kernel_proc_ = ConvolveSingleKernel_AVX2;
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    convolve_proc_ = Convolve_SSE;
+    convolve_single_kernel_proc_ = ConvolveSingleKernel_SSE;
+  } else {
+    convolve_proc_ = Convolve_C;
+    convolve_single_kernel_proc_ = ConvolveSingleKernel_C;
+  }
 }
-#endif
 #elif defined(WEBRTC_HAS_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
+#define CONVOLVE_SINGLE_KERNEL_FUNC ConvolveSingleKernel_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #else
 // Unknown architecture.
 #define CONVOLVE_FUNC Convolve_C
+#define CONVOLVE_SINGLE_KERNEL_FUNC ConvolveSingleKernel_C
 void SincResampler::InitializeCPUSpecificFeatures() {}
 #endif
 
@@ -149,23 +154,25 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
       read_cb_(read_cb),
       request_frames_(request_frames),
       input_buffer_size_(request_frames_ + kKernelSize),
-      // Create input buffers with a 16-byte alignment for SSE optimizations.
+      // Create input buffers with a 32-byte alignment for AVX optimizations.
       kernel_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
+          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       kernel_pre_sinc_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
+          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       kernel_window_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
+          AlignedMalloc(sizeof(float) * kKernelStorageSize, 32))),
       input_buffer_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * input_buffer_size_, 16))),
-#if defined(WEBRTC_CPU_DETECTION)
+          AlignedMalloc(sizeof(float) * input_buffer_size_, 32))),
+#if defined(WEBRTC_ARCH_X86_FAMILY)
       convolve_proc_(NULL),
+      convolve_single_kernel_proc_(NULL),
 #endif
       r1_(input_buffer_.get()),
       r2_(input_buffer_.get() + kKernelSize / 2) {
-#if defined(WEBRTC_CPU_DETECTION)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
   InitializeCPUSpecificFeatures();
   assert(convolve_proc_);
+  assert(convolve_single_kernel_proc_);
 #endif
   assert(request_frames_ > 0);
   Flush();
@@ -274,6 +281,12 @@ void SincResampler::Resample(size_t frames, float* destination) {
   // actually has an impact on ARM performance.  See inner loop comment below.
   const double current_io_ratio = io_sample_rate_ratio_;
   const float* const kernel_ptr = kernel_storage_.get();
+  // With an integer ratio, e.g. 48 kHz -> 16 kHz, and an integer start index,
+  // the kernel stays centered on input samples and the first kernel offset is
+  // the only one used.  The index stays an integer since |block_size_| is one.
+  const bool integer_steps =
+      current_io_ratio == floor(current_io_ratio) &&
+      virtual_source_idx_ == floor(virtual_source_idx_);
   while (remaining_frames) {
     // |i| may be negative if the last Resample() call ended on an iteration
     // that put |virtual_source_idx_| over the limit.
@@ -285,6 +298,15 @@ void SincResampler::Resample(size_t frames, float* destination) {
          i > 0; --i) {
       assert(virtual_source_idx_ < block_size_);
 
+      if (integer_steps) {
+        *destination++ = CONVOLVE_SINGLE_KERNEL_FUNC(
+            r1_ + static_cast<int>(virtual_source_idx_), kernel_ptr);
+        virtual_source_idx_ += current_io_ratio;
+        if (!--remaining_frames)
+          return;
+        continue;
+      }
+
       // |virtual_source_idx_| lies in between two kernel offsets so figure out
       // what they are.
       const int source_idx = static_cast<int>(virtual_source_idx_);
@@ -299,10 +321,10 @@ void SincResampler::Resample(size_t frames, float* destination) {
       const float* const k1 = kernel_ptr + offset_idx * kKernelSize;
       const float* const k2 = k1 + kKernelSize;
 
-      // Ensure |k1|, |k2| are 16-byte aligned for SIMD usage.  Should always be
-      // true so long as kKernelSize is a multiple of 16.
-      assert(0u == (reinterpret_cast<uintptr_t>(k1) & 0x0F));
-      assert(0u == (reinterpret_cast<uintptr_t>(k2) & 0x0F));
+      // Ensure |k1|, |k2| are 32-byte aligned for SIMD usage.  Should always be
+      // true so long as kKernelSize is a multiple of 32.
+      assert(0u == (reinterpret_cast<uintptr_t>(k1) & 0x1F));
+      assert(0u == (reinterpret_cast<uintptr_t>(k2) & 0x1F));
 
       // Initialize input pointer based on quantized |virtual_source_idx_|.
       const float* const input_ptr = r1_ + source_idx;
@@ -337,6 +359,7 @@ void SincResampler::Resample(size_t frames, float* destination) {
 }
 
 #undef CONVOLVE_FUNC
+#undef CONVOLVE_SINGLE_KERNEL_FUNC
 
 size_t SincResampler::ChunkSize() const {
   return static_cast<size_t>(block_size_ / io_sample_rate_ratio_);
@@ -369,4 +392,15 @@ float SincResampler::Convolve_C(const float* input_ptr, const float* k1,
       kernel_interpolation_factor * sum2);
 }
 
+float SincResampler::ConvolveSingleKernel_C(const float* input_ptr,
+                                            const float* k) {
+  float sum = 0;
+
+  size_t n = kKernelSize;
+  while (n--)
+    sum += *input_ptr++ * *k++;
+
+  return sum;
+}
+
 }  // namespace webrtc
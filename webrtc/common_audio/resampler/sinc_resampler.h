@@ -87,6 +87,8 @@ class SincResampler {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveAVX2);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveSingleKernel);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveBenchmark);
 
   void InitializeKernel();
@@ -107,12 +109,29 @@ class SincResampler {
   static float Convolve_SSE(const float* input_ptr, const float* k1,
                             const float* k2,
                             double kernel_interpolation_factor);
+  static float Convolve_AVX2(const float* input_ptr, const float* k1,
+                             const float* k2,
+                             double kernel_interpolation_factor);
 #elif defined(WEBRTC_HAS_NEON)
   static float Convolve_NEON(const float* input_ptr, const float* k1,
                              const float* k2,
                              double kernel_interpolation_factor);
 #endif
 
+  // Compute convolution of the single kernel |k| over |input_ptr|.  Used when
+  // the input / output ratio is an integer, since the kernel is then always
+  // centered on an input sample and no interpolation is needed.
+  static float ConvolveSingleKernel_C(const float* input_ptr, const float* k);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static float ConvolveSingleKernel_SSE(const float* input_ptr,
+                                        const float* k);
+  static float ConvolveSingleKernel_AVX2(const float* input_ptr,
+                                         const float* k);
+#elif defined(WEBRTC_HAS_NEON)
+  static float ConvolveSingleKernel_NEON(const float* input_ptr,
+                                         const float* k);
+#endif
+
   // The ratio of input / output sample rates.
   double io_sample_rate_ratio_;
 
@@ -145,14 +164,16 @@ class SincResampler {
   // Data from the source is copied into this buffer for each processing pass.
   std::unique_ptr<float[], AlignedFreeDeleter> input_buffer_;
 
-  // Stores the runtime selection of which Convolve function to use.
+  // Stores the runtime selection of which Convolve functions to use.
   // TODO(ajm): Move to using a global static which must only be initialized
   // once by the user. We're not doing this initially, because we don't have
   // e.g. a LazyInstance helper in webrtc.
-#if defined(WEBRTC_CPU_DETECTION)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
   typedef float (*ConvolveProc)(const float*, const float*, const float*,
                                 double);
   ConvolveProc convolve_proc_;
+  typedef float (*ConvolveSingleKernelProc)(const float*, const float*);
+  ConvolveSingleKernelProc convolve_single_kernel_proc_;
 #endif
 
   // Pointers to the various regions inside |input_buffer_|.  See the diagram at
@@ -44,4 +44,20 @@ float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
   return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
 }
 
+float SincResampler::ConvolveSingleKernel_NEON(const float* input_ptr,
+                                               const float* k) {
+  float32x4_t m_sums = vmovq_n_f32(0);
+
+  const float* upper = input_ptr + kKernelSize;
+  for (; input_ptr < upper; ) {
+    m_sums = vmlaq_f32(m_sums, vld1q_f32(input_ptr), vld1q_f32(k));
+    input_ptr += 4;
+    k += 4;
+  }
+
+  // Sum components together.
+  float32x2_t m_half = vadd_f32(vget_high_f32(m_sums), vget_low_f32(m_sums));
+  return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
+}
+
 }  // namespace webrtc
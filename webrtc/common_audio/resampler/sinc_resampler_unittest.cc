@@ -119,8 +119,10 @@ TEST(SincResamplerTest, DISABLED_SetRatioBench) {
 // Define platform independent function name for Convolve* tests.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
 #define CONVOLVE_FUNC Convolve_SSE
+#define CONVOLVE_SINGLE_KERNEL_FUNC ConvolveSingleKernel_SSE
 #elif defined(WEBRTC_ARCH_ARM_V7)
 #define CONVOLVE_FUNC Convolve_NEON
+#define CONVOLVE_SINGLE_KERNEL_FUNC ConvolveSingleKernel_NEON
 #endif
 
 // Ensure various optimized Convolve() methods return the same value.  Only run
@@ -164,6 +166,61 @@ TEST(SincResamplerTest, Convolve) {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Ensure Convolve_AVX2() returns the same value as Convolve_C() on CPUs which
+// support it.
+TEST(SincResamplerTest, ConvolveAVX2) {
+  if (!WebRtc_GetCPUInfo(kAVX2) || !WebRtc_GetCPUInfo(kFMA3))
+    return;
+
+  // Initialize a dummy resampler.
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+
+  // The fused multiply-adds make Convolve_AVX2() slightly more precise than
+  // Convolve_C(), so comparison must be done using an epsilon.
+  static const double kEpsilon = 0.00000005;
+
+  for (size_t input_offset = 0; input_offset < 8; ++input_offset) {
+    const float* input = resampler.kernel_storage_.get() + input_offset;
+    double result = resampler.Convolve_C(
+        input, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    double result2 = resampler.Convolve_AVX2(
+        input, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon);
+    result = resampler.ConvolveSingleKernel_C(
+        input, resampler.kernel_storage_.get());
+    result2 = resampler.ConvolveSingleKernel_AVX2(
+        input, resampler.kernel_storage_.get());
+    EXPECT_NEAR(result2, result, kEpsilon);
+  }
+}
+#endif
+
+// Ensure the single kernel Convolve() methods give the same result as the
+// interpolating ones with an interpolation factor of zero.
+TEST(SincResamplerTest, ConvolveSingleKernel) {
+  // Initialize a dummy resampler.
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+  const float* const kernel = resampler.kernel_storage_.get();
+  const float* const second_kernel = kernel + SincResampler::kKernelSize;
+
+  for (size_t input_offset = 0; input_offset < 8; ++input_offset) {
+    const float* input = kernel + input_offset;
+    EXPECT_EQ(resampler.Convolve_C(input, kernel, second_kernel, 0.0),
+              resampler.ConvolveSingleKernel_C(input, kernel));
+#if defined(CONVOLVE_FUNC)
+    EXPECT_EQ(resampler.CONVOLVE_FUNC(input, kernel, second_kernel, 0.0),
+              resampler.CONVOLVE_SINGLE_KERNEL_FUNC(input, kernel));
+#endif
+  }
+}
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that RTC_DCHECKs are compiled out when benchmarking.
 // Original benchmarks were run with --convolve-iterations=50000000.
@@ -225,10 +282,41 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
          total_time_optimized_aligned_us / 1000,
          total_time_c_us / total_time_optimized_aligned_us,
          total_time_optimized_unaligned_us / total_time_optimized_aligned_us);
+
+  // Benchmark the single kernel version used for integer ratios.
+  start = rtc::TimeNanos();
+  for (int j = 0; j < kConvolveIterations; ++j) {
+    resampler.CONVOLVE_SINGLE_KERNEL_FUNC(
+        resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get());
+  }
+  double total_time_single_kernel_us =
+      (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
+  printf(STRINGIZE(CONVOLVE_SINGLE_KERNEL_FUNC) " (unaligned) took %.2fms; "
+         "which is %.2fx faster than " STRINGIZE(CONVOLVE_FUNC)
+         " (unaligned).\n", total_time_single_kernel_us / 1000,
+         total_time_optimized_unaligned_us / total_time_single_kernel_us);
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    // Benchmark Convolve_AVX2() with unaligned input pointer.
+    start = rtc::TimeNanos();
+    for (int j = 0; j < kConvolveIterations; ++j) {
+      resampler.Convolve_AVX2(
+          resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    }
+    double total_time_avx2_us =
+        (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
+    printf("Convolve_AVX2 (unaligned) took %.2fms; which is %.2fx faster than "
+           "Convolve_SSE (unaligned).\n", total_time_avx2_us / 1000,
+           total_time_optimized_unaligned_us / total_time_avx2_us);
+  }
 #endif
 }
 
 #undef CONVOLVE_FUNC
+#undef CONVOLVE_SINGLE_KERNEL_FUNC
 
 typedef std::tr1::tuple<int, int, double, double> SincResamplerTestData;
 class SincResamplerTest
@@ -351,7 +439,7 @@ INSTANTIATE_TEST_CASE_P(
         std::tr1::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::tr1::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::tr1::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::tr1::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::tr1::make_tuple(48000, 44100, -15.01, -64.04),
         std::tr1::make_tuple(96000, 44100, -18.49, -25.51),
         std::tr1::make_tuple(192000, 44100, -20.50, -13.31),
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+#include "webrtc/base/checks.h"
+
+// Longest filter handled by the vectorized loop; longer ones, which no caller
+// uses, fall back to the C version.
+enum { kMaxPaddedCoefficients = 32 };
+
+static inline int32_t HorizontalSum(__m128i sum) {
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// Returns the partial sums of the filter output at |data_in|, with the
+// coefficients reversed and zero padded in front to |padded_length| samples.
+static inline __m128i FilterSSE2(const int16_t* data_in,
+                                 const int16_t* padded_coefficients,
+                                 size_t padded_length) {
+  const int16_t* data = data_in - padded_length + 1;
+  __m128i sum = _mm_setzero_si128();
+  size_t j = 0;
+  for (j = 0; j < padded_length; j += 8) {
+    const __m128i coefficients =
+        _mm_loadu_si128((const __m128i*)(padded_coefficients + j));
+    const __m128i samples = _mm_loadu_si128((const __m128i*)(data + j));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(coefficients, samples));
+  }
+  return sum;
+}
+
+// SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms. Four outputs
+// are computed at a time, each with one pmaddwd per eight coefficients. The
+// 32-bit sums wrap in the same way as in the C version, so the result is
+// bit-exact.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  int16_t padded_coefficients[kMaxPaddedCoefficients];
+  const size_t padded_length = (coefficients_length + 7) & ~(size_t)7;
+  const __m128i round = _mm_set1_epi32(2048);  // 0.5 in Q12.
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+  size_t i = 0;
+  size_t j = 0;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+  if (padded_length > kMaxPaddedCoefficients) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  for (j = 0; j < padded_length; j++) {
+    const size_t k = padded_length - 1 - j;
+    padded_coefficients[j] = k < coefficients_length ? coefficients[k] : 0;
+  }
+
+  // The padded filter reads samples before the first one used by the C
+  // version; the outputs for which those are not in |data_in| are calculated
+  // as in the C version.
+  i = delay;
+  for (; i < endpos && i + 1 < padded_length; i += factor) {
+    int32_t out_s32 = 2048;  // Round value, 0.5 in Q12.
+    for (j = 0; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * data_in[i - j];  // Q12.
+    }
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32 >> 12);
+  }
+
+  for (; i + 3 * factor < endpos; i += 4 * factor) {
+    const __m128i sum0 = FilterSSE2(&data_in[i], padded_coefficients,
+                                    padded_length);
+    const __m128i sum1 = FilterSSE2(&data_in[i + factor], padded_coefficients,
+                                    padded_length);
+    const __m128i sum2 = FilterSSE2(&data_in[i + 2 * factor],
+                                    padded_coefficients, padded_length);
+    const __m128i sum3 = FilterSSE2(&data_in[i + 3 * factor],
+                                    padded_coefficients, padded_length);
+    // Add up the partial sums of each output into one lane.
+    const __m128i sum01_lo = _mm_unpacklo_epi32(sum0, sum1);
+    const __m128i sum01_hi = _mm_unpackhi_epi32(sum0, sum1);
+    const __m128i sum23_lo = _mm_unpacklo_epi32(sum2, sum3);
+    const __m128i sum23_hi = _mm_unpackhi_epi32(sum2, sum3);
+    const __m128i sum01 = _mm_add_epi32(sum01_lo, sum01_hi);
+    const __m128i sum23 = _mm_add_epi32(sum23_lo, sum23_hi);
+    __m128i out = _mm_add_epi32(_mm_unpacklo_epi64(sum01, sum23),
+                                _mm_unpackhi_epi64(sum01, sum23));
+    out = _mm_srai_epi32(_mm_add_epi32(out, round), 12);  // Q0.
+    // Saturate and store the output.
+    _mm_storel_epi64((__m128i*)data_out, _mm_packs_epi32(out, out));
+    data_out += 4;
+  }
+
+  for (; i < endpos; i += factor) {
+    const int32_t out_s32 = HorizontalSum(
+        FilterSSE2(&data_in[i], padded_coefficients, padded_length));
+    *data_out++ = WebRtcSpl_SatW32ToW16((out_s32 + 2048) >> 12);
+  }
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// SSE2 versions of the min and max functions for x86 platforms. They return
+// the same values as the C versions.
+
+#include <emmintrin.h>
+#include <stdlib.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+static inline int16_t HorizontalMaxW16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_max_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static inline int16_t HorizontalMinW16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_min_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+// SSE2 has no 32-bit min and max instructions, so they are made from a
+// comparison and a select.
+static inline __m128i MaxW32(__m128i a, __m128i b) {
+  const __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, a),
+                      _mm_andnot_si128(a_greater, b));
+}
+
+static inline __m128i MinW32(__m128i a, __m128i b) {
+  const __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, b),
+                      _mm_andnot_si128(a_greater, a));
+}
+
+static inline int32_t HorizontalMaxW32(__m128i v) {
+  v = MaxW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = MaxW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+static inline int32_t HorizontalMinW32(__m128i v) {
+  v = MinW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = MinW32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+// Maximum absolute value of word16 vector. SSE2 version for x86 platforms.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i max_abs = zero;
+  size_t i = 0;
+  int maximum = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(vector + i));
+    // The saturating negation turns -32768 into 32767, which is also what
+    // the C version returns for it.
+    max_abs = _mm_max_epi16(max_abs, _mm_max_epi16(v, _mm_subs_epi16(zero, v)));
+  }
+  maximum = HorizontalMaxW16(max_abs);
+
+  for (; i < length; i++) {
+    const int absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// Maximum absolute value of word32 vector. SSE2 version for x86 platforms.
+int32_t WebRtcSpl_MaxAbsValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i max_abs = _mm_setzero_si128();
+  size_t i = 0;
+  uint32_t maximum = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)(vector + i));
+    const __m128i sign = _mm_srai_epi32(v, 31);
+    __m128i absolute = _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+    // abs(0x80000000) is 0x80000000, which is saturated to 0x7fffffff as in
+    // the C version. This keeps all values positive for the signed max.
+    absolute = _mm_sub_epi32(absolute, _mm_srli_epi32(absolute, 31));
+    max_abs = MaxW32(max_abs, absolute);
+  }
+  maximum = (uint32_t)HorizontalMaxW32(max_abs);
+
+  for (; i < length; i++) {
+    const uint32_t absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  maximum = WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)maximum;
+}
+
+// Maximum value of word16 vector. SSE2 version for x86 platforms.
+int16_t WebRtcSpl_MaxValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i max_value = _mm_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+  size_t i = 0;
+  int16_t maximum = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    max_value = _mm_max_epi16(max_value,
+                              _mm_loadu_si128((const __m128i*)(vector + i)));
+  }
+  maximum = HorizontalMaxW16(max_value);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector. SSE2 version for x86 platforms.
+int32_t WebRtcSpl_MaxValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i max_value = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  size_t i = 0;
+  int32_t maximum = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4) {
+    max_value =
+        MaxW32(max_value, _mm_loadu_si128((const __m128i*)(vector + i)));
+  }
+  maximum = HorizontalMaxW32(max_value);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector. SSE2 version for x86 platforms.
+int16_t WebRtcSpl_MinValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i min_value = _mm_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+  size_t i = 0;
+  int16_t minimum = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    min_value = _mm_min_epi16(min_value,
+                              _mm_loadu_si128((const __m128i*)(vector + i)));
+  }
+  minimum = HorizontalMinW16(min_value);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector. SSE2 version for x86 platforms.
+int32_t WebRtcSpl_MinValueW32SSE2(const int32_t* vector, size_t length) {
+  __m128i min_value = _mm_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+  size_t i = 0;
+  int32_t minimum = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 4 <= length; i += 4) {
+    min_value =
+        MinW32(min_value, _mm_loadu_si128((const __m128i*)(vector + i)));
+  }
+  minimum = HorizontalMinW32(min_value);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
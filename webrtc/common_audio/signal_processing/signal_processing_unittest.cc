@@ -13,6 +13,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 static const size_t kVector16Size = 9;
 static const int16_t vector16[kVector16Size] = {1, -15511, 4323, 1963,
@@ -471,11 +472,11 @@ TEST_F(SplTest, CrossCorrelationTest) {
                              kCrossCorrelationDimension, kShift, kStep);
 
   // WebRtcSpl_CrossCorrelationC() and WebRtcSpl_CrossCorrelationNeon()
-  // are not bit-exact.
+  // are not bit-exact. WebRtcSpl_CrossCorrelationSSE2() is.
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
   if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
@@ -487,6 +488,167 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST_F(SplTest, CrossCorrelationSSE2BitExactTest) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const size_t kMaxSeqDimension = 40;
+  const size_t kCrossCorrelationDimension = 5;
+  const size_t kSeq2Size = 2 * kCrossCorrelationDimension + kMaxSeqDimension;
+  int16_t seq1[kMaxSeqDimension];
+  int16_t seq2[kSeq2Size];
+  // Samples are limited to 13 bits, so that the C version doesn't overflow.
+  uint32_t seed = 1;
+  for (size_t i = 0; i < kMaxSeqDimension; ++i) {
+    seed = seed * 1103515245 + 12345;
+    seq1[i] = static_cast<int16_t>(seed >> 16) >> 3;
+  }
+  for (size_t i = 0; i < kSeq2Size; ++i) {
+    seed = seed * 1103515245 + 12345;
+    seq2[i] = static_cast<int16_t>(seed >> 16) >> 3;
+  }
+
+  // Covers both the vectorized loop and the remaining samples, for positive
+  // and negative steps and with and without scaling.
+  for (size_t dim_seq = 0; dim_seq <= kMaxSeqDimension; ++dim_seq) {
+    for (int shift = 0; shift <= 6; ++shift) {
+      for (int step = -1; step <= 1; step += 2) {
+        const int16_t* seq2_start =
+            step > 0 ? seq2 : seq2 + kCrossCorrelationDimension - 1;
+        int32_t expected[kCrossCorrelationDimension];
+        int32_t actual[kCrossCorrelationDimension];
+        WebRtcSpl_CrossCorrelationC(expected, seq1, seq2_start, dim_seq,
+                                    kCrossCorrelationDimension, shift, step);
+        WebRtcSpl_CrossCorrelationSSE2(actual, seq1, seq2_start, dim_seq,
+                                       kCrossCorrelationDimension, shift,
+                                       step);
+        for (size_t i = 0; i < kCrossCorrelationDimension; ++i) {
+          EXPECT_EQ(expected[i], actual[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, MinMaxOperationsSSE2BitExactTest) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const size_t kMaxLength = 40;
+  int16_t vector16[kMaxLength];
+  int32_t vector32[kMaxLength];
+  uint32_t seed = 1;
+  for (int extreme = 0; extreme < 3; ++extreme) {
+    for (size_t i = 0; i < kMaxLength; ++i) {
+      seed = seed * 1103515245 + 12345;
+      vector16[i] = static_cast<int16_t>(seed >> 16);
+      vector32[i] = static_cast<int32_t>(seed);
+    }
+    // Place the extreme values in the vectorized part and in the rest.
+    if (extreme == 1) {
+      vector16[3] = WEBRTC_SPL_WORD16_MIN;
+      vector32[3] = WEBRTC_SPL_WORD32_MIN;
+    } else if (extreme == 2) {
+      vector16[kMaxLength - 1] = WEBRTC_SPL_WORD16_MIN;
+      vector16[kMaxLength - 2] = WEBRTC_SPL_WORD16_MAX;
+      vector32[kMaxLength - 1] = WEBRTC_SPL_WORD32_MIN;
+      vector32[kMaxLength - 2] = WEBRTC_SPL_WORD32_MAX;
+    }
+    for (size_t length = 1; length <= kMaxLength; ++length) {
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(vector16, length),
+                WebRtcSpl_MaxAbsValueW16SSE2(vector16, length));
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW32C(vector32, length),
+                WebRtcSpl_MaxAbsValueW32SSE2(vector32, length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW16C(vector16, length),
+                WebRtcSpl_MaxValueW16SSE2(vector16, length));
+      EXPECT_EQ(WebRtcSpl_MaxValueW32C(vector32, length),
+                WebRtcSpl_MaxValueW32SSE2(vector32, length));
+      EXPECT_EQ(WebRtcSpl_MinValueW16C(vector16, length),
+                WebRtcSpl_MinValueW16SSE2(vector16, length));
+      EXPECT_EQ(WebRtcSpl_MinValueW32C(vector32, length),
+                WebRtcSpl_MinValueW32SSE2(vector32, length));
+    }
+  }
+}
+
+TEST_F(SplTest, ScaleAndAddVectorsWithRoundSSE2BitExactTest) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const size_t kMaxLength = 40;
+  int16_t in_vector1[kMaxLength];
+  int16_t in_vector2[kMaxLength];
+  uint32_t seed = 1;
+  for (size_t i = 0; i < kMaxLength; ++i) {
+    seed = seed * 1103515245 + 12345;
+    in_vector1[i] = static_cast<int16_t>(seed >> 16);
+    seed = seed * 1103515245 + 12345;
+    in_vector2[i] = static_cast<int16_t>(seed >> 16);
+  }
+  // The scales are limited to 15 bits, so that the C version doesn't
+  // overflow. Small shifts truncate the results to 16 bits.
+  const int16_t kScales[][2] = {{1, 1}, {-16384, 16383}, {3, -3277}};
+  for (const auto& scales : kScales) {
+    for (int shift = 0; shift <= 15; ++shift) {
+      for (size_t length = 1; length <= kMaxLength; ++length) {
+        int16_t expected[kMaxLength];
+        int16_t actual[kMaxLength];
+        EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+                         in_vector1, scales[0], in_vector2, scales[1], shift,
+                         expected, length));
+        EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+                         in_vector1, scales[0], in_vector2, scales[1], shift,
+                         actual, length));
+        for (size_t i = 0; i < length; ++i) {
+          EXPECT_EQ(expected[i], actual[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, DownsampleFastSSE2BitExactTest) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  const size_t kDataLength = 200;
+  const size_t kMaxCoefficients = 40;
+  int16_t data_in[kDataLength];
+  int16_t coefficients[kMaxCoefficients];
+  // Samples and coefficients are limited to 13 bits, so that the C version
+  // doesn't overflow; the outputs still saturate.
+  uint32_t seed = 1;
+  for (size_t i = 0; i < kDataLength; ++i) {
+    seed = seed * 1103515245 + 12345;
+    data_in[i] = static_cast<int16_t>(seed >> 16) >> 3;
+  }
+  for (size_t i = 0; i < kMaxCoefficients; ++i) {
+    seed = seed * 1103515245 + 12345;
+    coefficients[i] = static_cast<int16_t>(seed >> 16) >> 3;
+  }
+
+  // Covers the outputs calculated before, in and after the vectorized loop,
+  // and the fallback to the C version for long filters.
+  const size_t kCoefficientsLengths[] = {1, 3, 5, 7, 8, 9, 16, 17, 40};
+  for (size_t coefficients_length : kCoefficientsLengths) {
+    for (int factor = 1; factor <= 12; ++factor) {
+      for (size_t delay = coefficients_length - 1;
+           delay <= coefficients_length + 2; ++delay) {
+        const size_t data_out_length = (kDataLength - 1 - delay) / factor + 1;
+        int16_t expected[kDataLength];
+        int16_t actual[kDataLength];
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(
+                         data_in, kDataLength, expected, data_out_length,
+                         coefficients, coefficients_length, factor, delay));
+        EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(
+                         data_in, kDataLength, actual, data_out_length,
+                         coefficients, coefficients_length, factor, delay));
+        for (size_t i = 0; i < data_out_length; ++i) {
+          EXPECT_EQ(expected[i], actual[i]);
+        }
+      }
+    }
+  }
+}
+#endif
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, currently only for ARM, MIPS and x86 SSE2 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -41,6 +41,20 @@ static void InitPointersToC() {
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
       WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+    WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32SSE2;
+    WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16SSE2;
+    WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32SSE2;
+    WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16SSE2;
+    WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32SSE2;
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+    WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+    WebRtcSpl_ScaleAndAddVectorsWithRound =
+        WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2;
+  }
+#endif
 }
 #endif
 
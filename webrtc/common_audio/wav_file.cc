@@ -26,6 +26,14 @@ namespace webrtc {
 static const WavFormat kWavFormat = kWavFormatPcm;
 static const size_t kBytesPerSample = 2;
 
+// Size of the stdio buffers, large enough to turn the many small reads and
+// writes of the callers into few large I/O operations.
+static const size_t kFileBufferSize = 1 << 20;
+
+// Number of samples converted at a time by the float versions of
+// ReadSamples() and WriteSamples().
+static const size_t kChunkSize = 4096;
+
 // Doesn't take ownership of the file handle and won't close it.
 class ReadableWavFile : public ReadableWav {
  public:
@@ -49,6 +57,7 @@ std::string WavFile::FormatAsString() const {
 WavReader::WavReader(const std::string& filename)
     : file_handle_(fopen(filename.c_str(), "rb")) {
   RTC_CHECK(file_handle_) << "Could not open wav file for reading.";
+  RTC_CHECK_EQ(0, setvbuf(file_handle_, nullptr, _IOFBF, kFileBufferSize));
 
   ReadableWavFile readable(file_handle_);
   WavFormat format;
@@ -58,6 +67,7 @@ WavReader::WavReader(const std::string& filename)
   num_samples_remaining_ = num_samples_;
   RTC_CHECK_EQ(kWavFormat, format);
   RTC_CHECK_EQ(kBytesPerSample, bytes_per_sample);
+  data_start_position_ = rtc::checked_cast<size_t>(ftell(file_handle_));
 }
 
 WavReader::~WavReader() {
@@ -92,19 +102,27 @@ size_t WavReader::ReadSamples(size_t num_samples, int16_t* samples) {
 }
 
 size_t WavReader::ReadSamples(size_t num_samples, float* samples) {
-  static const size_t kChunksize = 4096 / sizeof(uint16_t);
   size_t read = 0;
-  for (size_t i = 0; i < num_samples; i += kChunksize) {
-    int16_t isamples[kChunksize];
-    size_t chunk = std::min(kChunksize, num_samples - i);
+  for (size_t i = 0; i < num_samples; i += kChunkSize) {
+    int16_t isamples[kChunkSize];
+    size_t chunk = std::min(kChunkSize, num_samples - i);
     chunk = ReadSamples(chunk, isamples);
-    for (size_t j = 0; j < chunk; ++j)
-      samples[i + j] = isamples[j];
+    std::copy(isamples, isamples + chunk, samples + i);
     read += chunk;
+    if (chunk < kChunkSize)
+      break;
   }
   return read;
 }
 
+void WavReader::SeekToSample(size_t sample_index) {
+  RTC_CHECK_LE(sample_index, num_samples_);
+  const size_t position = data_start_position_ + sample_index * kBytesPerSample;
+  RTC_CHECK_EQ(0, fseek(file_handle_, rtc::checked_cast<long>(position),
+                        SEEK_SET));
+  num_samples_remaining_ = num_samples_ - sample_index;
+}
+
 void WavReader::Close() {
   RTC_CHECK_EQ(0, fclose(file_handle_));
   file_handle_ = NULL;
@@ -117,6 +135,7 @@ WavWriter::WavWriter(const std::string& filename, int sample_rate,
       num_samples_(0),
       file_handle_(fopen(filename.c_str(), "wb")) {
   RTC_CHECK(file_handle_) << "Could not open wav file for writing.";
+  RTC_CHECK_EQ(0, setvbuf(file_handle_, nullptr, _IOFBF, kFileBufferSize));
   RTC_CHECK(CheckWavParameters(num_channels_, sample_rate_, kWavFormat,
                                kBytesPerSample, num_samples_));
 
@@ -154,10 +173,9 @@ void WavWriter::WriteSamples(const int16_t* samples, size_t num_samples) {
 }
 
 void WavWriter::WriteSamples(const float* samples, size_t num_samples) {
-  static const size_t kChunksize = 4096 / sizeof(uint16_t);
-  for (size_t i = 0; i < num_samples; i += kChunksize) {
-    int16_t isamples[kChunksize];
-    const size_t chunk = std::min(kChunksize, num_samples - i);
+  for (size_t i = 0; i < num_samples; i += kChunkSize) {
+    int16_t isamples[kChunkSize];
+    const size_t chunk = std::min(kChunkSize, num_samples - i);
     FloatS16ToS16(samples + i, chunk, isamples);
     WriteSamples(isamples, chunk);
   }
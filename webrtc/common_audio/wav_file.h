@@ -78,6 +78,11 @@ class WavReader final : public WavFile {
   size_t ReadSamples(size_t num_samples, float* samples);
   size_t ReadSamples(size_t num_samples, int16_t* samples);
 
+  // Moves the read position to the interleaved sample |sample_index|, counted
+  // from the start of the audio data, which must not exceed num_samples().
+  // Allows several readers of the same file to process separate parts of it.
+  void SeekToSample(size_t sample_index);
+
   int sample_rate() const override;
   size_t num_channels() const override;
   size_t num_samples() const override;
@@ -88,6 +93,7 @@ class WavReader final : public WavFile {
   size_t num_channels_;
   size_t num_samples_;  // Total number of samples in the file.
   size_t num_samples_remaining_;
+  size_t data_start_position_;  // File position of the first sample.
   FILE* file_handle_;  // Input file, owned by this class.
 
   RTC_DISALLOW_COPY_AND_ASSIGN(WavReader);
@@ -11,6 +11,7 @@
 // MSVC++ requires this to be set before any other includes to get M_PI.
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -174,4 +175,41 @@ TEST(WavWriterTest, LargeFile) {
   }
 }
 
+// Read separate parts of a WAV file with several readers, as done when
+// processing a file in parallel.
+TEST(WavReaderTest, SeekToSample) {
+  const std::string outfile = test::OutputPath() + "wavtest4.wav";
+  static const size_t kNumChannels = 2;
+  static const size_t kNumSamples = 3 * 4096 * kNumChannels + 2;
+  int16_t samples[kNumSamples];
+  for (size_t i = 0; i < kNumSamples; ++i)
+    samples[i] = static_cast<int16_t>(i);
+  {
+    WavWriter w(outfile, 16000, kNumChannels);
+    w.WriteSamples(samples, kNumSamples);
+  }
+
+  static const size_t kNumParts = 3;
+  static const size_t kPartSize = kNumSamples / kNumParts + 1;
+  for (size_t part = 0; part < kNumParts; ++part) {
+    WavReader r(outfile);
+    r.SeekToSample(part * kPartSize);
+    const size_t expected_read =
+        std::min(kPartSize, kNumSamples - part * kPartSize);
+    int16_t read_samples[kPartSize];
+    EXPECT_EQ(expected_read, r.ReadSamples(kPartSize, read_samples));
+    EXPECT_EQ(0, memcmp(samples + part * kPartSize, read_samples,
+                        expected_read * sizeof(*read_samples)));
+  }
+
+  WavReader r(outfile);
+  r.SeekToSample(kNumSamples);
+  float read_samples[kNumSamples];
+  EXPECT_EQ(0u, r.ReadSamples(kNumSamples, read_samples));
+  r.SeekToSample(1);
+  EXPECT_EQ(kNumSamples - 1, r.ReadSamples(kNumSamples, read_samples));
+  for (size_t i = 0; i < kNumSamples - 1; ++i)
+    EXPECT_EQ(samples[i + 1], read_samples[i]);
+}
+
 }  // namespace webrtc
@@ -62,16 +62,20 @@
         'h264/pps_parser.h',
         'h264/sps_parser.cc',
         'h264/sps_parser.h',
+        'encoded_image_buffer.cc',
         'i420_buffer_pool.cc',
         'video_frame.cc',
         'incoming_video_stream.cc',
         'include/bitrate_adjuster.h',
+        'include/encoded_image_buffer.h',
         'include/frame_callback.h',
         'include/i420_buffer_pool.h',
         'include/incoming_video_stream.h',
+        'include/scale_pyramid_buffer.h',
         'include/video_frame_buffer.h',
         'libyuv/include/webrtc_libyuv.h',
         'libyuv/webrtc_libyuv.cc',
+        'scale_pyramid_buffer.cc',
         'video_frame_buffer.cc',
         'video_render_frames.cc',
         'video_render_frames.h',
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/include/encoded_image_buffer.h"
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+EncodedImageBuffer::EncodedImageBuffer(size_t size)
+    : data_(new uint8_t[size]), size_(size) {}
+
+EncodedImageBuffer::~EncodedImageBuffer() {}
+
+EncodedImageBufferPool::EncodedImageBufferPool() {}
+
+EncodedImageBufferPool::~EncodedImageBufferPool() {}
+
+void EncodedImageBufferPool::Release() {
+  buffers_.clear();
+}
+
+rtc::scoped_refptr<EncodedImageBuffer> EncodedImageBufferPool::CreateBuffer(
+    size_t size) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  for (auto it = buffers_.begin(); it != buffers_.end();) {
+    // If the buffer is in use, the ref count will be >= 2, one from the list we
+    // are looping over and one from the application.
+    if (!(*it)->HasOneRef()) {
+      ++it;
+      continue;
+    }
+    if ((*it)->size() >= size)
+      return *it;
+    it = buffers_.erase(it);
+  }
+  rtc::scoped_refptr<PooledBuffer> buffer = new PooledBuffer(size);
+  buffers_.push_back(buffer);
+  return buffer;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_video/include/encoded_image_buffer.h"
+
+namespace webrtc {
+
+TEST(TestEncodedImageBufferPool, ReusesFreeBuffer) {
+  EncodedImageBufferPool pool;
+  rtc::scoped_refptr<EncodedImageBuffer> buffer = pool.CreateBuffer(1000);
+  EXPECT_EQ(1000u, buffer->size());
+  const uint8_t* data = buffer->data();
+  buffer = nullptr;
+  // A smaller buffer can be served by the free one.
+  buffer = pool.CreateBuffer(500);
+  EXPECT_EQ(data, buffer->data());
+  EXPECT_EQ(1000u, buffer->size());
+}
+
+TEST(TestEncodedImageBufferPool, DoesNotReuseBufferInUse) {
+  EncodedImageBufferPool pool;
+  rtc::scoped_refptr<EncodedImageBuffer> buffer = pool.CreateBuffer(1000);
+  rtc::scoped_refptr<EncodedImageBuffer> held = buffer;
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(1000);
+  EXPECT_NE(held->data(), buffer->data());
+  // The data of the held buffer stays valid after the pool is released.
+  held->data()[999] = 42;
+  pool.Release();
+  EXPECT_EQ(42, held->data()[999]);
+}
+
+TEST(TestEncodedImageBufferPool, ReplacesTooSmallBuffer) {
+  EncodedImageBufferPool pool;
+  rtc::scoped_refptr<EncodedImageBuffer> buffer = pool.CreateBuffer(500);
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(1000);
+  EXPECT_EQ(1000u, buffer->size());
+  const uint8_t* data = buffer->data();
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(1000);
+  EXPECT_EQ(data, buffer->data());
+}
+
+}  // namespace webrtc
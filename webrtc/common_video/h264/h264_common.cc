@@ -10,6 +10,8 @@
 
 #include "webrtc/common_video/h264/h264_common.h"
 
+#include <string.h>
+
 namespace webrtc {
 namespace H264 {
 
@@ -17,33 +19,37 @@ const uint8_t kNaluTypeMask = 0x1F;
 
 std::vector<NaluIndex> FindNaluIndices(const uint8_t* buffer,
                                        size_t buffer_size) {
-  // This is sorta like Boyer-Moore, but with only the first optimization step:
-  // given a 3-byte sequence we're looking at, if the 3rd byte isn't 1 or 0,
-  // skip ahead to the next 3-byte sequence. 0s and 1s are relatively rare, so
-  // this will skip the majority of reads/checks.
+  // Every start sequence ends with a 1, and 1s are rare in coded data, so
+  // instead of looking at every position we let memchr (which is vectorized
+  // on all platforms we care about) find the next 1 and only then check the
+  // two bytes before it.
   RTC_CHECK_GE(buffer_size, kNaluShortStartSequenceSize);
   std::vector<NaluIndex> sequences;
+  // A start sequence has to begin before |end| to be reported.
   const size_t end = buffer_size - kNaluShortStartSequenceSize;
-  for (size_t i = 0; i < end;) {
-    if (buffer[i + 2] > 1) {
-      i += 3;
-    } else if (buffer[i + 2] == 1 && buffer[i + 1] == 0 && buffer[i] == 0) {
-      // We found a start sequence, now check if it was a 3 of 4 byte one.
-      NaluIndex index = {i, i + 3, 0};
-      if (index.start_offset > 0 && buffer[index.start_offset - 1] == 0)
-        --index.start_offset;
+  const uint8_t* const search_end = buffer + end + 2;
+  const uint8_t* next = buffer + 2;
+  while (next < search_end) {
+    const uint8_t* one =
+        static_cast<const uint8_t*>(memchr(next, 1, search_end - next));
+    if (!one)
+      break;
+    next = one + 1;
+    if (one[-1] != 0 || one[-2] != 0)
+      continue;
 
-      // Update length of previous entry.
-      auto it = sequences.rbegin();
-      if (it != sequences.rend())
-        it->payload_size = index.start_offset - it->payload_start_offset;
+    // We found a start sequence, now check if it was a 3 of 4 byte one.
+    const size_t i = one - 2 - buffer;
+    NaluIndex index = {i, i + 3, 0};
+    if (index.start_offset > 0 && buffer[index.start_offset - 1] == 0)
+      --index.start_offset;
 
-      sequences.push_back(index);
+    // Update length of previous entry.
+    auto it = sequences.rbegin();
+    if (it != sequences.rend())
+      it->payload_size = index.start_offset - it->payload_start_offset;
 
-      i += 3;
-    } else {
-      ++i;
-    }
+    sequences.push_back(index);
   }
 
   // Update length of last entry, if any.
@@ -60,23 +66,25 @@ NaluType ParseNaluType(uint8_t data) {
 
 std::unique_ptr<rtc::Buffer> ParseRbsp(const uint8_t* data, size_t length) {
   std::unique_ptr<rtc::Buffer> rbsp_buffer(new rtc::Buffer(0, length));
-  const char* sps_bytes = reinterpret_cast<const char*>(data);
-  for (size_t i = 0; i < length;) {
-    // Be careful about over/underflow here. byte_length_ - 3 can underflow, and
-    // i + 3 can overflow, but byte_length_ - i can't, because i < byte_length_
-    // above, and that expression will produce the number of bytes left in
-    // the stream including the byte at i.
-    if (length - i >= 3 && data[i] == 0 && data[i + 1] == 0 &&
-        data[i + 2] == 3) {
-      // Two rbsp bytes + the emulation byte.
-      rbsp_buffer->AppendData(sps_bytes + i, 2);
-      i += 3;
-    } else {
-      // Single rbsp byte.
-      rbsp_buffer->AppendData(sps_bytes[i]);
-      ++i;
-    }
+  // Emulation bytes are rare, so find them with memchr and copy the data
+  // between them in bulk. A {0 0 3} sequence can't begin before
+  // |copy_start|, as the bytes up to there were consumed by the previous one.
+  const uint8_t* const data_end = data + length;
+  const uint8_t* copy_start = data;
+  const uint8_t* next = data;
+  while (next < data_end) {
+    const uint8_t* three =
+        static_cast<const uint8_t*>(memchr(next, 3, data_end - next));
+    if (!three)
+      break;
+    next = three + 1;
+    if (three - copy_start < 2 || three[-1] != 0 || three[-2] != 0)
+      continue;
+    // Two rbsp bytes + the emulation byte.
+    rbsp_buffer->AppendData(copy_start, three - copy_start);
+    copy_start = next;
   }
+  rbsp_buffer->AppendData(copy_start, data_end - copy_start);
   return rbsp_buffer;
 }
 
@@ -86,21 +94,26 @@ void WriteRbsp(const uint8_t* bytes, size_t length, rtc::Buffer* destination) {
   size_t num_consecutive_zeros = 0;
   destination->EnsureCapacity(destination->size() + length);
 
+  // Bytes that don't need escaping are copied in bulk, up to the next byte
+  // that does.
+  size_t copy_start = 0;
   for (size_t i = 0; i < length; ++i) {
     uint8_t byte = bytes[i];
     if (byte <= kEmulationByte &&
         num_consecutive_zeros >= kZerosInStartSequence) {
       // Need to escape.
+      destination->AppendData(bytes + copy_start, i - copy_start);
       destination->AppendData(kEmulationByte);
+      copy_start = i;
       num_consecutive_zeros = 0;
     }
-    destination->AppendData(byte);
     if (byte == 0) {
       ++num_consecutive_zeros;
     } else {
       num_consecutive_zeros = 0;
     }
   }
+  destination->AppendData(bytes + copy_start, length - copy_start);
 }
 
 }  // namespace H264
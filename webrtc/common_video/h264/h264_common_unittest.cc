@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/buffer.h"
+#include "webrtc/base/random.h"
+#include "webrtc/common_video/h264/h264_common.h"
+
+namespace webrtc {
+
+TEST(H264CommonTest, FindsShortAndLongStartSequences) {
+  const uint8_t kBuffer[] = {0, 0, 0, 1, 0x67, 0xFF, 1, 0, 1, 0,
+                             0, 1, 0x68, 0,    0,    0, 0, 1, 0x65, 1};
+  std::vector<H264::NaluIndex> indices =
+      H264::FindNaluIndices(kBuffer, sizeof(kBuffer));
+  ASSERT_EQ(3u, indices.size());
+  EXPECT_EQ(0u, indices[0].start_offset);
+  EXPECT_EQ(4u, indices[0].payload_start_offset);
+  EXPECT_EQ(5u, indices[0].payload_size);
+  EXPECT_EQ(9u, indices[1].start_offset);
+  EXPECT_EQ(12u, indices[1].payload_start_offset);
+  EXPECT_EQ(2u, indices[1].payload_size);
+  EXPECT_EQ(14u, indices[2].start_offset);
+  EXPECT_EQ(18u, indices[2].payload_start_offset);
+  EXPECT_EQ(2u, indices[2].payload_size);
+}
+
+TEST(H264CommonTest, FindsNoStartSequence) {
+  const uint8_t kBuffer[] = {1, 0, 1, 1, 0, 2, 0, 0, 3, 0, 1, 0, 0};
+  EXPECT_TRUE(H264::FindNaluIndices(kBuffer, sizeof(kBuffer)).empty());
+}
+
+TEST(H264CommonTest, ParseRbspRemovesEmulationBytes) {
+  const uint8_t kEscaped[] = {3, 0, 0, 3, 0, 0, 3, 3, 0, 3, 0, 0, 3};
+  const uint8_t kRbsp[] = {3, 0, 0, 0, 0, 3, 0, 3, 0, 0};
+  std::unique_ptr<rtc::Buffer> rbsp =
+      H264::ParseRbsp(kEscaped, sizeof(kEscaped));
+  EXPECT_EQ(rtc::Buffer(kRbsp), *rbsp);
+}
+
+TEST(H264CommonTest, WriteRbspRoundTrips) {
+  Random random(0x12345678);
+  for (int i = 0; i < 100; ++i) {
+    // Mostly zeros and other small values, so there is plenty to escape.
+    rtc::Buffer data(random.Rand(3, 200));
+    for (size_t j = 0; j < data.size(); ++j)
+      data[j] = random.Rand(0, 3) == 0 ? random.Rand<uint8_t>() : 0;
+
+    rtc::Buffer escaped;
+    H264::WriteRbsp(data.data(), data.size(), &escaped);
+    EXPECT_TRUE(
+        H264::FindNaluIndices(escaped.data(), escaped.size()).empty());
+    EXPECT_EQ(data, *H264::ParseRbsp(escaped.data(), escaped.size()));
+  }
+}
+
+}  // namespace webrtc
@@ -14,22 +14,46 @@
 
 namespace webrtc {
 
+namespace {
+
+size_t BufferSizeInBytes(const I420Buffer& buffer) {
+  const int chroma_height = (buffer.height() + 1) / 2;
+  return buffer.StrideY() * buffer.height() +
+         (buffer.StrideU() + buffer.StrideV()) * chroma_height;
+}
+
+}  // namespace
+
 I420BufferPool::I420BufferPool(bool zero_initialize)
-    : zero_initialize_(zero_initialize) {}
+    : memory_usage_("I420BufferPool"), zero_initialize_(zero_initialize) {}
 
 void I420BufferPool::Release() {
   buffers_.clear();
+  memory_usage_.Set(0);
+  width_ = height_ = previous_width_ = previous_height_ = 0;
 }
 
 rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
                                                             int height) {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
-  // Release buffers with wrong resolution.
-  for (auto it = buffers_.begin(); it != buffers_.end();) {
-    if ((*it)->width() != width || (*it)->height() != height)
-      it = buffers_.erase(it);
-    else
-      ++it;
+  if (width != width_ || height != height_) {
+    previous_width_ = width_;
+    previous_height_ = height_;
+    width_ = width;
+    height_ = height;
+    // Release buffers that are neither of the new nor the previous resolution.
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+      const int buffer_width = (*it)->width();
+      const int buffer_height = (*it)->height();
+      if ((buffer_width != width_ || buffer_height != height_) &&
+          (buffer_width != previous_width_ ||
+           buffer_height != previous_height_)) {
+        memory_usage_.Subtract(BufferSizeInBytes(**it));
+        it = buffers_.erase(it);
+      } else {
+        ++it;
+      }
+    }
   }
   // Look for a free buffer.
   for (const rtc::scoped_refptr<PooledI420Buffer>& buffer : buffers_) {
@@ -37,8 +61,11 @@ rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
     // are looping over and one from the application. If the ref count is 1,
     // then the list we are looping over holds the only reference and it's safe
     // to reuse.
-    if (buffer->HasOneRef())
+    if (buffer->HasOneRef() && buffer->width() == width &&
+        buffer->height() == height) {
+      ++num_reused_buffers_;
       return buffer;
+    }
   }
   // Allocate new buffer.
   rtc::scoped_refptr<PooledI420Buffer> buffer =
@@ -46,6 +73,8 @@ rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
   if (zero_initialize_)
     buffer->InitializeData();
   buffers_.push_back(buffer);
+  memory_usage_.Add(BufferSizeInBytes(*buffer));
+  ++num_allocated_buffers_;
   return buffer;
 }
 
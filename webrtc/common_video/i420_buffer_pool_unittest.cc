@@ -51,6 +51,29 @@ TEST(TestI420BufferPool, FailToReuse) {
   EXPECT_NE(v_ptr, buffer->DataV());
 }
 
+TEST(TestI420BufferPool, ReusesBuffersOfPreviousResolution) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pool.CreateBuffer(32, 32);
+  const uint8_t* y_ptr = buffer->DataY();
+  buffer = nullptr;
+  // Switch to a lower resolution and back, as adaptation does.
+  buffer = pool.CreateBuffer(16, 16);
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(32, 32);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(2, pool.num_allocated_buffers());
+  EXPECT_EQ(2, pool.num_reused_buffers());
+  buffer = nullptr;
+  // Buffers of older resolutions are released.
+  buffer = pool.CreateBuffer(8, 8);
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(32, 32);
+  EXPECT_NE(y_ptr, buffer->DataY());
+  EXPECT_EQ(4, pool.num_allocated_buffers());
+}
+
 TEST(TestI420BufferPool, FrameValidAfterPoolDestruction) {
   rtc::scoped_refptr<VideoFrameBuffer> buffer;
   {
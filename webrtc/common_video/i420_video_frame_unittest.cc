@@ -200,6 +200,8 @@ TEST(TestVideoFrame, ShallowCopy) {
   frame1.set_timestamp(timestamp);
   frame1.set_ntp_time_ms(ntp_time_ms);
   frame1.set_render_time_ms(render_time_ms);
+  frame1.set_update_rect(rtc::Optional<VideoFrame::UpdateRect>(
+      VideoFrame::UpdateRect{1, 2, 3, 4}));
   VideoFrame frame2;
   frame2.ShallowCopy(frame1);
 
@@ -218,6 +220,11 @@ TEST(TestVideoFrame, ShallowCopy) {
   EXPECT_EQ(frame2.ntp_time_ms(), frame1.ntp_time_ms());
   EXPECT_EQ(frame2.render_time_ms(), frame1.render_time_ms());
   EXPECT_EQ(frame2.rotation(), frame1.rotation());
+  ASSERT_TRUE(frame2.update_rect());
+  EXPECT_EQ(1, frame2.update_rect()->offset_x);
+  EXPECT_EQ(2, frame2.update_rect()->offset_y);
+  EXPECT_EQ(3, frame2.update_rect()->width);
+  EXPECT_EQ(4, frame2.update_rect()->height);
 
   frame2.set_timestamp(timestamp + 1);
   frame2.set_ntp_time_ms(ntp_time_ms + 1);
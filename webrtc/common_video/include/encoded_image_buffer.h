@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_INCLUDE_ENCODED_IMAGE_BUFFER_H_
+#define WEBRTC_COMMON_VIDEO_INCLUDE_ENCODED_IMAGE_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <memory>
+
+#include "webrtc/base/race_checker.h"
+#include "webrtc/base/refcount.h"
+#include "webrtc/base/scoped_ref_ptr.h"
+
+namespace webrtc {
+
+// Ref counted memory holding the data of an EncodedImage. Consumers that keep
+// an encoded image beyond the EncodedImageCallback hold a reference to its
+// buffer rather than copying the data.
+class EncodedImageBuffer : public rtc::RefCountInterface {
+ public:
+  explicit EncodedImageBuffer(size_t size);
+
+  uint8_t* data() { return data_.get(); }
+  size_t size() const { return size_; }
+
+ protected:
+  ~EncodedImageBuffer() override;
+
+ private:
+  const std::unique_ptr<uint8_t[]> data_;
+  const size_t size_;
+};
+
+// Pool of encoded image buffers, so that encoders don't allocate the memory of
+// every frame. A buffer is reused once the pool holds the only reference to it.
+class EncodedImageBufferPool {
+ public:
+  EncodedImageBufferPool();
+  ~EncodedImageBufferPool();
+
+  // Returns a buffer of at least |size| bytes from the pool, or a new buffer
+  // if no free buffer is large enough. Free buffers that are too small are
+  // released.
+  rtc::scoped_refptr<EncodedImageBuffer> CreateBuffer(size_t size);
+  // Clears |buffers_|. Buffers still in use are released with their last
+  // reference.
+  void Release();
+
+ private:
+  // Explicitly use a RefCountedObject to get access to HasOneRef, needed by
+  // the pool to check exclusive access.
+  using PooledBuffer = rtc::RefCountedObject<EncodedImageBuffer>;
+
+  rtc::RaceChecker race_checker_;
+  std::list<rtc::scoped_refptr<PooledBuffer>> buffers_;
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_INCLUDE_ENCODED_IMAGE_BUFFER_H_
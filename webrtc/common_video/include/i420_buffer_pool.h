@@ -13,6 +13,7 @@
 
 #include <list>
 
+#include "webrtc/base/memory_usage.h"
 #include "webrtc/base/race_checker.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
 
@@ -22,7 +23,9 @@ namespace webrtc {
 // The pool manages the memory of the I420Buffer returned from CreateBuffer.
 // When the I420Buffer is destructed, the memory is returned to the pool for use
 // by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
+// changes, buffers of the previous resolution are kept, so that switching back
+// and forth between two resolutions, e.g. during video adaptation, doesn't
+// cause new allocations. Buffers of any other resolution are purged.
 class I420BufferPool {
  public:
   I420BufferPool() : I420BufferPool(false) {}
@@ -35,6 +38,11 @@ class I420BufferPool {
   // later from another thread.
   void Release();
 
+  // Number of buffers returned by CreateBuffer that were recycled from the
+  // pool, and that had to be allocated, respectively.
+  int num_reused_buffers() const { return num_reused_buffers_; }
+  int num_allocated_buffers() const { return num_allocated_buffers_; }
+
  private:
   // Explicitly use a RefCountedObject to get access to HasOneRef,
   // needed by the pool to check exclusive access.
@@ -42,12 +50,20 @@ class I420BufferPool {
 
   rtc::RaceChecker race_checker_;
   std::list<rtc::scoped_refptr<PooledI420Buffer>> buffers_;
+  // Pixel data of |buffers_|, when memory accounting is enabled.
+  rtc::ScopedMemoryUsage memory_usage_;
   // If true, newly allocated buffers are zero-initialized. Note that recycled
   // buffers are not zero'd before reuse. This is required of buffers used by
   // FFmpeg according to http://crbug.com/390941, which only requires it for the
   // initial allocation (as shown by FFmpeg's own buffer allocation code). It
   // has to do with "Use-of-uninitialized-value" on "Linux_msan_chrome".
   bool zero_initialize_;
+  int width_ = 0;
+  int height_ = 0;
+  int previous_width_ = 0;
+  int previous_height_ = 0;
+  int num_reused_buffers_ = 0;
+  int num_allocated_buffers_ = 0;
 };
 
 }  // namespace webrtc
@@ -13,45 +13,45 @@
 
 #include <memory>
 
-#include "webrtc/base/criticalsection.h"
-#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/race_checker.h"
-#include "webrtc/base/thread_annotations.h"
-#include "webrtc/base/thread_checker.h"
+#include "webrtc/base/task_queue.h"
 #include "webrtc/common_video/video_render_frames.h"
 #include "webrtc/media/base/videosinkinterface.h"
 
+namespace rtc {
+class TaskQueuePool;
+}  // namespace rtc
+
 namespace webrtc {
-class EventTimerWrapper;
 
+// Delivers frames to |callback| at their render time, minus |delay_ms|. The
+// frames are rendered from a task queue that wakes up when the next frame is
+// due.
 class IncomingVideoStream : public rtc::VideoSinkInterface<VideoFrame> {
  public:
   IncomingVideoStream(int32_t delay_ms,
                       rtc::VideoSinkInterface<VideoFrame>* callback);
+  // If |render_pool| is not null, the render queue runs on its threads, shared
+  // with other streams, instead of on a thread of its own. Pools are only
+  // supported where WEBRTC_BUILD_LIBEVENT is defined. |render_pool| must
+  // outlive the stream.
+  IncomingVideoStream(int32_t delay_ms,
+                      rtc::VideoSinkInterface<VideoFrame>* callback,
+                      rtc::TaskQueuePool* render_pool);
   ~IncomingVideoStream() override;
 
- protected:
-  static bool IncomingVideoStreamThreadFun(void* obj);
-  bool IncomingVideoStreamProcess();
-
  private:
-  enum { kEventStartupTimeMs = 10 };
-  enum { kEventMaxWaitTimeMs = 100 };
-  enum { kFrameRatePeriodMs = 1000 };
-
   void OnFrame(const VideoFrame& video_frame) override;
+  // Renders the frames that are due and schedules the next call.
+  void Dequeue();
 
-  rtc::ThreadChecker main_thread_checker_;
-  rtc::ThreadChecker render_thread_checker_;
   rtc::RaceChecker decoder_race_checker_;
-
-  rtc::CriticalSection buffer_critsect_;
-  rtc::PlatformThread incoming_render_thread_;
-  std::unique_ptr<EventTimerWrapper> deliver_buffer_event_;
-
-  rtc::VideoSinkInterface<VideoFrame>* const external_callback_;
-  std::unique_ptr<VideoRenderFrames> render_buffers_
-      GUARDED_BY(buffer_critsect_);
+  rtc::VideoSinkInterface<VideoFrame>* const callback_;
+  // Only accessed on |incoming_render_queue_|.
+  VideoRenderFrames render_buffers_;
+  // Declared last, so that it is destroyed, and pending tasks are dropped,
+  // before the members they use.
+  std::unique_ptr<rtc::TaskQueue> incoming_render_queue_;
 };
 
 }  // namespace webrtc
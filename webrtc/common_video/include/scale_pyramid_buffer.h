@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_COMMON_VIDEO_INCLUDE_SCALE_PYRAMID_BUFFER_H_
+#define WEBRTC_COMMON_VIDEO_INCLUDE_SCALE_PYRAMID_BUFFER_H_
+
+#include <vector>
+
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/common_video/include/video_frame_buffer.h"
+
+namespace webrtc {
+
+// Frame buffer that wraps another buffer and lazily computes and caches scaled
+// down versions of it. Each scaled version is derived from the smallest one
+// already cached that is at least as large, rather than from the full
+// resolution buffer, so that all consumers of a frame, e.g. the streams of a
+// simulcast encoder, share the scaling work. The pixel data of the wrapped
+// buffer must not change while the pyramid is in use.
+class ScalePyramidBuffer : public VideoFrameBuffer {
+ public:
+  // Returns |buffer| itself if it already is a ScalePyramidBuffer, and
+  // otherwise a new pyramid wrapping it. |buffer| must not have a native
+  // handle.
+  static rtc::scoped_refptr<ScalePyramidBuffer> Wrap(
+      const rtc::scoped_refptr<VideoFrameBuffer>& buffer);
+
+  // Returns the frame scaled to |width| x |height|, or the wrapped buffer if
+  // the resolution matches. Safe to call from any thread.
+  rtc::scoped_refptr<VideoFrameBuffer> ScaledBuffer(int width, int height);
+
+  int width() const override;
+  int height() const override;
+  const uint8_t* DataY() const override;
+  const uint8_t* DataU() const override;
+  const uint8_t* DataV() const override;
+  int StrideY() const override;
+  int StrideU() const override;
+  int StrideV() const override;
+
+  void* native_handle() const override;
+  rtc::scoped_refptr<VideoFrameBuffer> NativeToI420Buffer() override;
+
+  ScalePyramidBuffer* scale_pyramid() override;
+
+ protected:
+  explicit ScalePyramidBuffer(
+      const rtc::scoped_refptr<VideoFrameBuffer>& buffer);
+  ~ScalePyramidBuffer() override;
+
+ private:
+  const rtc::scoped_refptr<VideoFrameBuffer> buffer_;
+
+  rtc::CriticalSection crit_;
+  // Scaled versions of |buffer_|, ordered by decreasing width.
+  std::vector<rtc::scoped_refptr<I420Buffer>> levels_ GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_COMMON_VIDEO_INCLUDE_SCALE_PYRAMID_BUFFER_H_
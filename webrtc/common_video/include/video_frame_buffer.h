@@ -19,7 +19,7 @@
 #include "webrtc/base/refcount.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/common_video/rotation.h"
-#include "webrtc/system_wrappers/include/aligned_malloc.h"
+#include "webrtc/system_wrappers/include/huge_page_malloc.h"
 
 namespace webrtc {
 
@@ -30,6 +30,8 @@ enum PlaneType {
   kNumOfPlanes = 3,
 };
 
+class ScalePyramidBuffer;
+
 // Interface of a simple frame buffer containing pixel data. This interface does
 // not contain any frame metadata such as rotation, timestamp, pixel_width, etc.
 class VideoFrameBuffer : public rtc::RefCountInterface {
@@ -64,11 +66,16 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   // native handle.
   virtual rtc::scoped_refptr<VideoFrameBuffer> NativeToI420Buffer() = 0;
 
+  // Returns this buffer as a ScalePyramidBuffer if it is one, and otherwise
+  // nullptr.
+  virtual ScalePyramidBuffer* scale_pyramid();
+
  protected:
   virtual ~VideoFrameBuffer();
 };
 
-// Plain I420 buffer in standard memory.
+// Plain I420 buffer in standard memory. Large buffers are backed by huge pages
+// when enabled, see SetHugePageMode().
 class I420Buffer : public VideoFrameBuffer {
  public:
   I420Buffer(int width, int height);
@@ -147,7 +154,7 @@ class I420Buffer : public VideoFrameBuffer {
   const int stride_y_;
   const int stride_u_;
   const int stride_v_;
-  const std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
+  const HugePageBuffer data_;
 };
 
 // Base class for native-handle buffer is a wrapper around a |native_handle|.
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_video/include/incoming_video_stream.h"
+
+namespace webrtc {
+namespace {
+
+const int kRenderDelayMs = 10;
+const int kTimeoutMs = 5000;
+
+class RenderedFramesSink : public rtc::VideoSinkInterface<VideoFrame> {
+ public:
+  explicit RenderedFramesSink(size_t num_frames)
+      : num_frames_(num_frames), done_(false, false) {}
+
+  void OnFrame(const VideoFrame& frame) override {
+    rtc::CritScope cs(&crit_);
+    timestamps_.push_back(frame.timestamp());
+    render_delays_ms_.push_back(frame.render_time_ms() - rtc::TimeMillis());
+    if (timestamps_.size() == num_frames_)
+      done_.Set();
+  }
+
+  bool WaitForFrames() { return done_.Wait(kTimeoutMs); }
+
+  std::vector<uint32_t> timestamps() {
+    rtc::CritScope cs(&crit_);
+    return timestamps_;
+  }
+  std::vector<int64_t> render_delays_ms() {
+    rtc::CritScope cs(&crit_);
+    return render_delays_ms_;
+  }
+
+ private:
+  const size_t num_frames_;
+  rtc::Event done_;
+  rtc::CriticalSection crit_;
+  std::vector<uint32_t> timestamps_;
+  std::vector<int64_t> render_delays_ms_;
+};
+
+VideoFrame CreateFrame(uint32_t timestamp, int64_t render_time_ms) {
+  return VideoFrame(I420Buffer::Create(16, 16), timestamp, render_time_ms,
+                    kVideoRotation_0);
+}
+
+void RendersFramesInOrderAtRenderTime(rtc::TaskQueuePool* pool) {
+  RenderedFramesSink sink(3);
+  IncomingVideoStream stream(kRenderDelayMs, &sink, pool);
+  rtc::VideoSinkInterface<VideoFrame>* stream_sink = &stream;
+  const int64_t now_ms = rtc::TimeMillis();
+  stream_sink->OnFrame(CreateFrame(1, now_ms + 50));
+  stream_sink->OnFrame(CreateFrame(2, now_ms + 100));
+  stream_sink->OnFrame(CreateFrame(3, now_ms + 150));
+  ASSERT_TRUE(sink.WaitForFrames());
+
+  EXPECT_EQ(std::vector<uint32_t>({1, 2, 3}), sink.timestamps());
+  // Frames are released |kRenderDelayMs| before their render time, but not
+  // earlier.
+  for (int64_t delay_ms : sink.render_delays_ms())
+    EXPECT_LE(delay_ms, kRenderDelayMs);
+}
+
+}  // namespace
+
+TEST(IncomingVideoStreamTest, RendersFramesInOrderAtRenderTime) {
+  RendersFramesInOrderAtRenderTime(nullptr);
+}
+
+#if defined(WEBRTC_BUILD_LIBEVENT)
+TEST(IncomingVideoStreamTest, RendersFramesOnPool) {
+  rtc::TaskQueuePool pool(1);
+  RendersFramesInOrderAtRenderTime(&pool);
+}
+#endif
+
+}  // namespace webrtc
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_video/include/scale_pyramid_buffer.h"
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+// static
+rtc::scoped_refptr<ScalePyramidBuffer> ScalePyramidBuffer::Wrap(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer) {
+  RTC_DCHECK(!buffer->native_handle());
+  if (buffer->scale_pyramid())
+    return buffer->scale_pyramid();
+  return new rtc::RefCountedObject<ScalePyramidBuffer>(buffer);
+}
+
+ScalePyramidBuffer::ScalePyramidBuffer(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer)
+    : buffer_(buffer) {}
+
+ScalePyramidBuffer::~ScalePyramidBuffer() {}
+
+rtc::scoped_refptr<VideoFrameBuffer> ScalePyramidBuffer::ScaledBuffer(
+    int width,
+    int height) {
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+  if (width == buffer_->width() && height == buffer_->height())
+    return buffer_;
+
+  rtc::CritScope lock(&crit_);
+  // Find the smallest level to scale from, and where the new level goes.
+  rtc::scoped_refptr<VideoFrameBuffer> source = buffer_;
+  auto it = levels_.begin();
+  for (; it != levels_.end() && (*it)->width() >= width; ++it) {
+    if ((*it)->width() == width && (*it)->height() == height)
+      return *it;
+    if ((*it)->height() >= height)
+      source = *it;
+  }
+  rtc::scoped_refptr<I420Buffer> scaled = I420Buffer::Create(width, height);
+  scaled->ScaleFrom(source);
+  levels_.insert(it, scaled);
+  return scaled;
+}
+
+int ScalePyramidBuffer::width() const {
+  return buffer_->width();
+}
+
+int ScalePyramidBuffer::height() const {
+  return buffer_->height();
+}
+
+const uint8_t* ScalePyramidBuffer::DataY() const {
+  return buffer_->DataY();
+}
+const uint8_t* ScalePyramidBuffer::DataU() const {
+  return buffer_->DataU();
+}
+const uint8_t* ScalePyramidBuffer::DataV() const {
+  return buffer_->DataV();
+}
+
+int ScalePyramidBuffer::StrideY() const {
+  return buffer_->StrideY();
+}
+int ScalePyramidBuffer::StrideU() const {
+  return buffer_->StrideU();
+}
+int ScalePyramidBuffer::StrideV() const {
+  return buffer_->StrideV();
+}
+
+void* ScalePyramidBuffer::native_handle() const {
+  return nullptr;
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> ScalePyramidBuffer::NativeToI420Buffer() {
+  RTC_NOTREACHED();
+  return nullptr;
+}
+
+ScalePyramidBuffer* ScalePyramidBuffer::scale_pyramid() {
+  return this;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/common_video/include/scale_pyramid_buffer.h"
+
+namespace webrtc {
+
+TEST(TestScalePyramidBuffer, ForwardsToWrappedBuffer) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(64, 48);
+  rtc::scoped_refptr<ScalePyramidBuffer> pyramid =
+      ScalePyramidBuffer::Wrap(buffer);
+  EXPECT_EQ(64, pyramid->width());
+  EXPECT_EQ(48, pyramid->height());
+  EXPECT_EQ(buffer->DataY(), pyramid->DataY());
+  EXPECT_EQ(buffer->DataU(), pyramid->DataU());
+  EXPECT_EQ(buffer->DataV(), pyramid->DataV());
+  EXPECT_EQ(buffer->StrideY(), pyramid->StrideY());
+  EXPECT_EQ(buffer->StrideU(), pyramid->StrideU());
+  EXPECT_EQ(buffer->StrideV(), pyramid->StrideV());
+  EXPECT_EQ(nullptr, pyramid->native_handle());
+  EXPECT_EQ(buffer, pyramid->ScaledBuffer(64, 48));
+}
+
+TEST(TestScalePyramidBuffer, WrapsPyramidOnlyOnce) {
+  rtc::scoped_refptr<ScalePyramidBuffer> pyramid =
+      ScalePyramidBuffer::Wrap(I420Buffer::Create(64, 48));
+  rtc::scoped_refptr<VideoFrameBuffer> buffer = pyramid;
+  EXPECT_EQ(pyramid, ScalePyramidBuffer::Wrap(buffer));
+  EXPECT_EQ(pyramid.get(), buffer->scale_pyramid());
+  EXPECT_EQ(nullptr, I420Buffer::Create(64, 48)->scale_pyramid());
+}
+
+TEST(TestScalePyramidBuffer, CachesScaledBuffers) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(64, 48);
+  buffer->SetToBlack();
+  rtc::scoped_refptr<ScalePyramidBuffer> pyramid =
+      ScalePyramidBuffer::Wrap(buffer);
+
+  rtc::scoped_refptr<VideoFrameBuffer> quarter = pyramid->ScaledBuffer(16, 12);
+  EXPECT_EQ(16, quarter->width());
+  EXPECT_EQ(12, quarter->height());
+  rtc::scoped_refptr<VideoFrameBuffer> half = pyramid->ScaledBuffer(32, 24);
+  EXPECT_EQ(32, half->width());
+  EXPECT_EQ(24, half->height());
+
+  EXPECT_EQ(quarter, pyramid->ScaledBuffer(16, 12));
+  EXPECT_EQ(half, pyramid->ScaledBuffer(32, 24));
+  EXPECT_NE(quarter, pyramid->ScaledBuffer(16, 8));
+}
+
+}  // namespace webrtc
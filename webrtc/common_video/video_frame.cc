@@ -68,6 +68,7 @@ void VideoFrame::CreateEmptyFrame(int width,
   ntp_time_ms_ = 0;
   timestamp_us_ = 0;
   rotation_ = kVideoRotation_0;
+  update_rect_ = rtc::Optional<UpdateRect>();
 
   // Allocate a new buffer.
   video_frame_buffer_ = I420Buffer::Create(
@@ -123,6 +124,7 @@ void VideoFrame::ShallowCopy(const VideoFrame& videoFrame) {
   ntp_time_ms_ = videoFrame.ntp_time_ms_;
   timestamp_us_ = videoFrame.timestamp_us_;
   rotation_ = videoFrame.rotation_;
+  update_rect_ = videoFrame.update_rect_;
 }
 
 // TODO(nisse): Delete. Besides test code, only one use, in
@@ -44,6 +44,10 @@ uint8_t* VideoFrameBuffer::MutableDataV() {
   return nullptr;
 }
 
+ScalePyramidBuffer* VideoFrameBuffer::scale_pyramid() {
+  return nullptr;
+}
+
 VideoFrameBuffer::~VideoFrameBuffer() {}
 
 I420Buffer::I420Buffer(int width, int height)
@@ -60,9 +64,8 @@ I420Buffer::I420Buffer(int width,
       stride_y_(stride_y),
       stride_u_(stride_u),
       stride_v_(stride_v),
-      data_(static_cast<uint8_t*>(AlignedMalloc(
-          I420DataSize(height, stride_y, stride_u, stride_v),
-          kBufferAlignment))) {
+      data_(HugePageMalloc(I420DataSize(height, stride_y, stride_u, stride_v),
+                           kBufferAlignment)) {
   RTC_DCHECK_GT(width, 0);
   RTC_DCHECK_GT(height, 0);
   RTC_DCHECK_GE(stride_y, width);
@@ -80,4 +80,8 @@ uint32_t VideoRenderFrames::TimeToNextFrameRelease() {
   return time_to_release < 0 ? 0u : static_cast<uint32_t>(time_to_release);
 }
 
+bool VideoRenderFrames::HasPendingFrames() const {
+  return !incoming_frames_.empty();
+}
+
 }  // namespace webrtc
@@ -35,6 +35,8 @@ class VideoRenderFrames {
   // Returns the number of ms to next frame to render
   uint32_t TimeToNextFrameRelease();
 
+  bool HasPendingFrames() const;
+
  private:
   // 10 seconds for 30 fps.
   enum { KMaxNumberOfFrames = 300 };
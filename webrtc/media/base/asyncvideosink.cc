@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/media/base/asyncvideosink.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/optional.h"
+#include "webrtc/base/timeutils.h"
+
+namespace rtc {
+
+AsyncVideoSink::PendingFrame::PendingFrame(const cricket::VideoFrame& frame,
+                                           int64_t time_us)
+    : buffer(frame.video_frame_buffer()),
+      rotation(frame.rotation()),
+      timestamp_us(frame.timestamp_us()),
+      transport_frame_id(frame.transport_frame_id()),
+      time_us(time_us) {}
+
+AsyncVideoSink::AsyncVideoSink(const char* queue_name,
+                               VideoSinkInterface<cricket::VideoFrame>* sink,
+                               size_t max_pending_frames)
+    : sink_(sink), max_pending_frames_(max_pending_frames), queue_(queue_name) {
+  RTC_DCHECK(sink_);
+  RTC_DCHECK_GT(max_pending_frames_, 0u);
+}
+
+AsyncVideoSink::~AsyncVideoSink() {}
+
+void AsyncVideoSink::OnFrame(const cricket::VideoFrame& frame) {
+  {
+    rtc::CritScope cs(&crit_);
+    if (pending_frames_.size() >= max_pending_frames_) {
+      pending_frames_.pop_front();
+      ++stats_.frames_dropped;
+    }
+    pending_frames_.emplace_back(frame, rtc::TimeMicros());
+  }
+  // One task is posted per frame. Tasks of dropped frames find a frame posted
+  // later, or nothing, to deliver.
+  queue_.PostTask([this] { DeliverPendingFrame(); });
+}
+
+AsyncVideoSink::Stats AsyncVideoSink::GetStats() const {
+  rtc::CritScope cs(&crit_);
+  return stats_;
+}
+
+void AsyncVideoSink::DeliverPendingFrame() {
+  RTC_DCHECK(queue_.IsCurrent());
+  rtc::Optional<PendingFrame> pending_frame;
+  {
+    rtc::CritScope cs(&crit_);
+    if (pending_frames_.empty())
+      return;
+    pending_frame = rtc::Optional<PendingFrame>(pending_frames_.front());
+    pending_frames_.pop_front();
+  }
+  sink_->OnFrame(cricket::WebRtcVideoFrame(
+      pending_frame->buffer, pending_frame->rotation,
+      pending_frame->timestamp_us, pending_frame->transport_frame_id));
+
+  const int64_t latency_us = rtc::TimeMicros() - pending_frame->time_us;
+  rtc::CritScope cs(&crit_);
+  ++stats_.frames_delivered;
+  total_delivery_latency_us_ += latency_us;
+  stats_.avg_delivery_latency_ms = static_cast<int>(
+      total_delivery_latency_us_ / stats_.frames_delivered /
+      rtc::kNumMicrosecsPerMillisec);
+  stats_.max_delivery_latency_ms =
+      std::max(stats_.max_delivery_latency_ms,
+               static_cast<int>(latency_us / rtc::kNumMicrosecsPerMillisec));
+}
+
+}  // namespace rtc
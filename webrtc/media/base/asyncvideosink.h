@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MEDIA_BASE_ASYNCVIDEOSINK_H_
+#define WEBRTC_MEDIA_BASE_ASYNCVIDEOSINK_H_
+
+#include <deque>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/task_queue.h"
+#include "webrtc/media/base/videoframe.h"
+#include "webrtc/media/base/videosinkinterface.h"
+#include "webrtc/media/engine/webrtcvideoframe.h"
+
+namespace rtc {
+
+// AsyncVideoSink delivers frames to another sink on a task queue of its own,
+// so that a slow sink doesn't delay the thread calling OnFrame, e.g. the
+// capture thread of a VideoBroadcaster with several sinks. At most
+// |max_pending_frames| frames wait for delivery. When a frame arrives while
+// that many are pending, the oldest pending frame is dropped.
+class AsyncVideoSink : public VideoSinkInterface<cricket::VideoFrame> {
+ public:
+  struct Stats {
+    uint32_t frames_delivered = 0;
+    uint32_t frames_dropped = 0;
+    // Time from OnFrame until the wrapped sink has returned from OnFrame.
+    int avg_delivery_latency_ms = 0;
+    int max_delivery_latency_ms = 0;
+  };
+
+  AsyncVideoSink(const char* queue_name,
+                 VideoSinkInterface<cricket::VideoFrame>* sink,
+                 size_t max_pending_frames);
+  // Pending frames are dropped. When the destructor returns, |sink| is not
+  // called anymore.
+  ~AsyncVideoSink() override;
+
+  void OnFrame(const cricket::VideoFrame& frame) override;
+
+  Stats GetStats() const;
+
+ private:
+  struct PendingFrame {
+    PendingFrame(const cricket::VideoFrame& frame, int64_t time_us);
+
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer;
+    webrtc::VideoRotation rotation;
+    int64_t timestamp_us;
+    uint32_t transport_frame_id;
+    // Time when the frame was passed to OnFrame.
+    int64_t time_us;
+  };
+
+  void DeliverPendingFrame();
+
+  VideoSinkInterface<cricket::VideoFrame>* const sink_;
+  const size_t max_pending_frames_;
+  rtc::CriticalSection crit_;
+  std::deque<PendingFrame> pending_frames_ GUARDED_BY(crit_);
+  Stats stats_ GUARDED_BY(crit_);
+  int64_t total_delivery_latency_us_ GUARDED_BY(crit_) = 0;
+  // Declared last, so that it is destroyed, and stops calling |sink_|, first.
+  rtc::TaskQueue queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AsyncVideoSink);
+};
+
+}  // namespace rtc
+
+#endif  // WEBRTC_MEDIA_BASE_ASYNCVIDEOSINK_H_
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/base/event.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/media/base/asyncvideosink.h"
+#include "webrtc/media/base/fakevideorenderer.h"
+#include "webrtc/media/engine/webrtcvideoframe.h"
+
+using cricket::FakeVideoRenderer;
+using cricket::WebRtcVideoFrame;
+
+namespace {
+
+const int kTimeoutMs = 5000;
+
+// Blocks in OnFrame until |unblock_event| is set.
+class BlockingSink : public rtc::VideoSinkInterface<cricket::VideoFrame> {
+ public:
+  BlockingSink()
+      : blocked_event(false, false), unblock_event(true, false) {}
+
+  void OnFrame(const cricket::VideoFrame& frame) override {
+    timestamps_us.push_back(frame.timestamp_us());
+    blocked_event.Set();
+    unblock_event.Wait(rtc::Event::kForever);
+  }
+
+  rtc::Event blocked_event;
+  rtc::Event unblock_event;
+  // Only accessed on the delivery queue, or after it has been destroyed.
+  std::vector<int64_t> timestamps_us;
+};
+
+void SendFrame(rtc::AsyncVideoSink* async_sink, int64_t timestamp_us) {
+  async_sink->OnFrame(WebRtcVideoFrame(webrtc::I420Buffer::Create(16, 16),
+                                       webrtc::kVideoRotation_0, timestamp_us));
+}
+
+}  // namespace
+
+TEST(AsyncVideoSinkTest, DeliversFrames) {
+  FakeVideoRenderer sink;
+  rtc::AsyncVideoSink async_sink("DeliveryQueue", &sink, 1);
+  SendFrame(&async_sink, 1);
+  EXPECT_EQ_WAIT(1, sink.num_rendered_frames(), kTimeoutMs);
+  SendFrame(&async_sink, 2);
+  EXPECT_EQ_WAIT(2, sink.num_rendered_frames(), kTimeoutMs);
+  EXPECT_EQ_WAIT(2u, async_sink.GetStats().frames_delivered, kTimeoutMs);
+  EXPECT_EQ(0u, async_sink.GetStats().frames_dropped);
+}
+
+TEST(AsyncVideoSinkTest, DropsOldestFrameWhenSinkIsSlow) {
+  BlockingSink sink;
+  {
+    rtc::AsyncVideoSink async_sink("DeliveryQueue", &sink, 2);
+    SendFrame(&async_sink, 1);
+    ASSERT_TRUE(sink.blocked_event.Wait(kTimeoutMs));
+    // Frame 1 is being delivered. Frame 2 is dropped to make room for frame 4.
+    SendFrame(&async_sink, 2);
+    SendFrame(&async_sink, 3);
+    SendFrame(&async_sink, 4);
+    EXPECT_EQ(1u, async_sink.GetStats().frames_dropped);
+
+    sink.unblock_event.Set();
+    EXPECT_EQ_WAIT(3u, async_sink.GetStats().frames_delivered, kTimeoutMs);
+  }
+  EXPECT_EQ(std::vector<int64_t>({1, 3, 4}), sink.timestamps_us);
+}
+
+TEST(AsyncVideoSinkTest, ReportsDeliveryLatency) {
+  BlockingSink sink;
+  rtc::AsyncVideoSink async_sink("DeliveryQueue", &sink, 1);
+  SendFrame(&async_sink, 1);
+  ASSERT_TRUE(sink.blocked_event.Wait(kTimeoutMs));
+  rtc::Thread::SleepMs(20);
+  sink.unblock_event.Set();
+  EXPECT_EQ_WAIT(1u, async_sink.GetStats().frames_delivered, kTimeoutMs);
+  EXPECT_GE(async_sink.GetStats().avg_delivery_latency_ms, 20);
+  EXPECT_GE(async_sink.GetStats().max_delivery_latency_ms, 20);
+}
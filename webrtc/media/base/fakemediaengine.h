@@ -22,6 +22,7 @@
 #include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/networkroute.h"
 #include "webrtc/base/stringutils.h"
+#include "webrtc/base/thread.h"
 #include "webrtc/media/base/audiosource.h"
 #include "webrtc/media/base/mediaengine.h"
 #include "webrtc/media/base/rtputils.h"
@@ -93,6 +94,13 @@ template <class Base> class RtpHelper : public Base {
   }
   bool CheckNoRtp() { return rtp_packets_.empty(); }
   bool CheckNoRtcp() { return rtcp_packets_.empty(); }
+  // Makes DeliverPacketOnNetworkThread() take the packets, like the media
+  // channels of MediaConfig::deliver_packets_on_network_thread do.
+  void set_deliver_packets_on_network_thread(bool deliver) {
+    deliver_packets_on_network_thread_ = deliver;
+  }
+  // The thread the last RTP or RTCP packet was received on.
+  rtc::Thread* receive_thread() const { return receive_thread_; }
   void set_fail_set_send_codecs(bool fail) { fail_set_send_codecs_ = fail; }
   void set_fail_set_recv_codecs(bool fail) { fail_set_recv_codecs_ = fail; }
   virtual bool AddSendStream(const StreamParams& sp) {
@@ -244,10 +252,25 @@ template <class Base> class RtpHelper : public Base {
   virtual void OnPacketReceived(rtc::CopyOnWriteBuffer* packet,
                                 const rtc::PacketTime& packet_time) {
     rtp_packets_.push_back(std::string(packet->data<char>(), packet->size()));
+    receive_thread_ = rtc::Thread::Current();
   }
   virtual void OnRtcpReceived(rtc::CopyOnWriteBuffer* packet,
                               const rtc::PacketTime& packet_time) {
     rtcp_packets_.push_back(std::string(packet->data<char>(), packet->size()));
+    receive_thread_ = rtc::Thread::Current();
+  }
+  virtual bool DeliverPacketOnNetworkThread(
+      bool rtcp,
+      rtc::CopyOnWriteBuffer* packet,
+      const rtc::PacketTime& packet_time) {
+    if (!deliver_packets_on_network_thread_)
+      return false;
+    if (rtcp) {
+      OnRtcpReceived(packet, packet_time);
+    } else {
+      OnPacketReceived(packet, packet_time);
+    }
+    return true;
   }
   virtual void OnReadyToSend(bool ready) {
     ready_to_send_ = ready;
@@ -279,6 +302,8 @@ template <class Base> class RtpHelper : public Base {
   bool ready_to_send_;
   rtc::NetworkRoute last_network_route_;
   int num_network_route_changes_ = 0;
+  bool deliver_packets_on_network_thread_ = false;
+  rtc::Thread* receive_thread_ = nullptr;
 };
 
 class FakeVoiceMediaChannel : public RtpHelper<VoiceMediaChannel> {
@@ -934,7 +959,8 @@ class FakeDataEngine : public DataEngineInterface {
  public:
   FakeDataEngine() : last_channel_type_(DCT_NONE) {}
 
-  virtual DataMediaChannel* CreateChannel(DataChannelType data_channel_type) {
+  virtual DataMediaChannel* CreateChannel(DataChannelType data_channel_type,
+                                          const MediaConfig& config) {
     last_channel_type_ = data_channel_type;
     FakeDataMediaChannel* ch = new FakeDataMediaChannel(this, DataOptions());
     channels_.push_back(ch);
@@ -101,6 +101,13 @@ struct MediaConfig {
   // PeerConnection constraint 'googDscp'.
   bool enable_dscp = false;
 
+  // Hand received packets of known streams to the call on the network
+  // thread, instead of posting them to the worker thread first. RTCP, and the
+  // NACK and RTX responses it triggers, is then handled without a thread hop.
+  // Packets of unsignalled SSRCs still go to the worker thread, where their
+  // streams are created. See MediaChannel::DeliverPacketOnNetworkThread.
+  bool deliver_packets_on_network_thread = false;
+
   // Video-specific config.
   struct Video {
     // Enable WebRTC CPU Overuse Detection. This flag comes from the
@@ -133,6 +140,16 @@ struct MediaConfig {
     // IncomingVideoStream constructor.
     bool disable_prerenderer_smoothing = false;
   } video;
+
+  // SCTP data channel config.
+  struct Sctp {
+    // Sizes of the SCTP association's send and receive buffers, in bytes.
+    // The receive buffer bounds the window the peer may send ahead, and so
+    // the throughput over a given round trip time. 0 means the usrsctp
+    // default of 256 kB.
+    int send_buffer_size = 0;
+    int receive_buffer_size = 0;
+  } sctp;
 };
 
 // Options that can be applied to a VoiceMediaChannel or a VoiceMediaEngine.
@@ -379,6 +396,16 @@ class MediaChannel : public sigslot::has_slots<> {
   // Called when a RTCP packet is received.
   virtual void OnRtcpReceived(rtc::CopyOnWriteBuffer* packet,
                               const rtc::PacketTime& packet_time) = 0;
+  // Called on the network thread when a RTP or RTCP packet is received, before
+  // it is posted to the worker thread. Returns true if the packet has been
+  // delivered, or false if it should be passed to OnPacketReceived() or
+  // OnRtcpReceived() on the worker thread as usual.
+  virtual bool DeliverPacketOnNetworkThread(
+      bool rtcp,
+      rtc::CopyOnWriteBuffer* packet,
+      const rtc::PacketTime& packet_time) {
+    return false;
+  }
   // Called when the socket's ability to send has changed.
   virtual void OnReadyToSend(bool ready) = 0;
   // Called when the network route used for sending packets changed.
@@ -815,6 +842,10 @@ struct DataMediaInfo {
 };
 
 struct RtcpParameters {
+  bool operator==(const RtcpParameters& o) const {
+    return reduced_size == o.reduced_size;
+  }
+
   bool reduced_size = false;
 };
 
@@ -828,6 +859,9 @@ struct RtpParameters {
     ost << "}";
     return ost.str();
   }
+  bool operator==(const RtpParameters& o) const {
+    return codecs == o.codecs && extensions == o.extensions && rtcp == o.rtcp;
+  }
 
   std::vector<Codec> codecs;
   std::vector<webrtc::RtpExtension> extensions;
@@ -849,6 +883,10 @@ struct RtpSendParameters : RtpParameters<Codec> {
     ost << "}";
     return ost.str();
   }
+  bool operator==(const RtpSendParameters& o) const {
+    return RtpParameters<Codec>::operator==(o) &&
+           max_bandwidth_bps == o.max_bandwidth_bps;
+  }
 
   int max_bandwidth_bps = -1;
 };
@@ -864,6 +902,10 @@ struct AudioSendParameters : RtpSendParameters<AudioCodec> {
     ost << "}";
     return ost.str();
   }
+  bool operator==(const AudioSendParameters& o) const {
+    return RtpSendParameters<AudioCodec>::operator==(o) &&
+           options == o.options;
+  }
 
   AudioOptions options;
 };
@@ -948,6 +990,11 @@ class VoiceMediaChannel : public MediaChannel {
 // TODO(deadbeef): Rename to VideoSenderParameters, since they're intended to
 // encapsulate all the parameters needed for a video RtpSender.
 struct VideoSendParameters : RtpSendParameters<VideoCodec> {
+  bool operator==(const VideoSendParameters& o) const {
+    return RtpSendParameters<VideoCodec>::operator==(o) &&
+           conference_mode == o.conference_mode;
+  }
+
   // Use conference mode? This flag comes from the remote
   // description's SDP line 'a=x-google-flag:conference', copied over
   // by VideoChannel::SetRemoteContent_w, and ultimately used by
@@ -39,7 +39,8 @@ RtpDataEngine::RtpDataEngine() {
 }
 
 DataMediaChannel* RtpDataEngine::CreateChannel(
-    DataChannelType data_channel_type) {
+    DataChannelType data_channel_type,
+    const MediaConfig& config) {
   if (data_channel_type != DCT_RTP) {
     return NULL;
   }
@@ -72,7 +72,7 @@ class RtpDataMediaChannelTest : public testing::Test {
   cricket::RtpDataMediaChannel* CreateChannel(cricket::RtpDataEngine* dme) {
     cricket::RtpDataMediaChannel* channel =
         static_cast<cricket::RtpDataMediaChannel*>(dme->CreateChannel(
-            cricket::DCT_RTP));
+            cricket::DCT_RTP, cricket::MediaConfig()));
     channel->SetInterface(iface_.get());
     channel->SignalDataReceived.connect(
         receiver_.get(), &FakeDataReceiver::OnDataReceived);
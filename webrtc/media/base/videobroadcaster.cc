@@ -13,6 +13,7 @@
 #include <limits>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/common_video/include/scale_pyramid_buffer.h"
 
 namespace rtc {
 
@@ -52,6 +53,23 @@ VideoSinkWants VideoBroadcaster::wants() const {
 
 void VideoBroadcaster::OnFrame(const cricket::VideoFrame& frame) {
   rtc::CritScope cs(&sinks_and_wants_lock_);
+  // Sinks scaling the frame, e.g. send streams of different resolutions,
+  // share the work through the scale pyramid of the frame.
+  const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer =
+      frame.video_frame_buffer();
+  if (sink_pairs().size() > 1 && buffer && !buffer->native_handle() &&
+      !buffer->scale_pyramid()) {
+    cricket::WebRtcVideoFrame pyramid_frame(
+        webrtc::ScalePyramidBuffer::Wrap(buffer), frame.rotation(),
+        frame.timestamp_us(), frame.transport_frame_id());
+    pyramid_frame.set_update_rect(frame.update_rect());
+    DeliverFrame(pyramid_frame);
+  } else {
+    DeliverFrame(frame);
+  }
+}
+
+void VideoBroadcaster::DeliverFrame(const cricket::VideoFrame& frame) {
   for (auto& sink_pair : sink_pairs()) {
     if (sink_pair.wants.black_frames) {
       sink_pair.sink->OnFrame(cricket::WebRtcVideoFrame(
@@ -30,6 +30,8 @@ namespace rtc {
 // Sinks must be added and removed on one and only one thread.
 // Video frames can be broadcasted on any thread. I.e VideoBroadcaster::OnFrame
 // can be called on any thread.
+// Frames are delivered synchronously to all sinks. Sinks that may be slow can
+// be wrapped in an AsyncVideoSink, so that they don't delay the other sinks.
 class VideoBroadcaster : public VideoSourceBase,
                          public VideoSinkInterface<cricket::VideoFrame> {
  public:
@@ -48,6 +50,8 @@ class VideoBroadcaster : public VideoSourceBase,
   void OnFrame(const cricket::VideoFrame& frame) override;
 
  protected:
+  void DeliverFrame(const cricket::VideoFrame& frame)
+      EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
   void UpdateWants() EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
   const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& GetBlackFrameBuffer(
       int width, int height)
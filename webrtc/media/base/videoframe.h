@@ -15,6 +15,7 @@
 #include "webrtc/base/stream.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
 #include "webrtc/common_video/rotation.h"
+#include "webrtc/video_frame.h"
 
 namespace cricket {
 
@@ -48,6 +49,13 @@ class VideoFrame {
   // Indicates the rotation angle in degrees.
   virtual webrtc::VideoRotation rotation() const = 0;
 
+  // Part of the frame that changed since the previous frame of the source, see
+  // webrtc::VideoFrame::update_rect().
+  virtual const rtc::Optional<webrtc::VideoFrame::UpdateRect>& update_rect()
+      const = 0;
+  virtual void set_update_rect(
+      const rtc::Optional<webrtc::VideoFrame::UpdateRect>& update_rect) = 0;
+
   // Tests if sample is valid. Returns true if valid.
 
   // TODO(nisse): Deprecated. Should be deleted in the cricket::VideoFrame and
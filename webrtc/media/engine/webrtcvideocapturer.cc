@@ -353,9 +353,35 @@ void WebRtcVideoCapturer::OnIncomingCapturedFrame(
                  << ". Expected format " << GetCaptureFormat()->ToString();
   }
 
-  OnFrame(cricket::WebRtcVideoFrame(
-              sample.video_frame_buffer(), sample.rotation(),
-              sample.render_time_ms() * rtc::kNumMicrosecsPerMillisec, 0),
+  const int64_t capture_time_us =
+      sample.render_time_ms() * rtc::kNumMicrosecsPerMillisec;
+  int adapted_width;
+  int adapted_height;
+  int crop_width;
+  int crop_height;
+  int crop_x;
+  int crop_y;
+  // Frames the video adapter drops, or that no sink wants, are dropped before
+  // anything is done with them.
+  if (!AdaptFrame(sample.width(), sample.height(), capture_time_us,
+                  rtc::TimeMicros(), &adapted_width, &adapted_height,
+                  &crop_width, &crop_height, &crop_x, &crop_y, nullptr)) {
+    return;
+  }
+
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer =
+      sample.video_frame_buffer();
+  if (adapted_width != sample.width() || adapted_height != sample.height()) {
+    // Crop and scale in a single pass, into a recycled buffer.
+    rtc::scoped_refptr<webrtc::I420Buffer> scaled_buffer =
+        scaled_buffer_pool_.CreateBuffer(adapted_width, adapted_height);
+    scaled_buffer->CropAndScaleFrom(buffer, crop_x, crop_y, crop_width,
+                                    crop_height);
+    buffer = scaled_buffer;
+  }
+
+  OnFrame(cricket::WebRtcVideoFrame(buffer, sample.rotation(),
+                                    capture_time_us, 0),
           sample.width(), sample.height());
 }
 
@@ -18,6 +18,7 @@
 #include "webrtc/base/asyncinvoker.h"
 #include "webrtc/base/messagehandler.h"
 #include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/media/base/device.h"
 #include "webrtc/media/base/videocapturer.h"
@@ -82,6 +83,9 @@ class WebRtcVideoCapturer : public VideoCapturer,
   rtc::scoped_refptr<webrtc::VideoCaptureModule> module_;
   int captured_frames_;
   std::vector<uint8_t> capture_buffer_;
+  // Buffers for the frames scaled by the video adapter, which are reused once
+  // the sinks have released them.
+  webrtc::I420BufferPool scaled_buffer_pool_;
   rtc::Thread* start_thread_;  // Set in Start(), unset in Stop();
 
   std::unique_ptr<rtc::AsyncInvoker> async_invoker_;
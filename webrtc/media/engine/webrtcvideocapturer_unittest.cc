@@ -100,6 +100,23 @@ TEST_F(WebRtcVideoCapturerTest, TestCapture) {
   EXPECT_EQ_WAIT(cricket::CS_STOPPED, listener.last_capture_state(), 1000);
 }
 
+TEST_F(WebRtcVideoCapturerTest, TestCaptureAdaptsToResolutionRequest) {
+  EXPECT_TRUE(capturer_->Init(cricket::Device(kTestDeviceName, kTestDeviceId)));
+  cricket::VideoCapturerListener listener(capturer_.get());
+  cricket::VideoFormat format(
+      capturer_->GetSupportedFormats()->at(0));
+  EXPECT_EQ(cricket::CS_STARTING, capturer_->Start(format));
+  EXPECT_EQ_WAIT(cricket::CS_RUNNING, listener.last_capture_state(), 1000);
+  rtc::VideoSinkWants wants;
+  wants.max_pixel_count = rtc::Optional<int>(640 * 480 / 2);
+  capturer_->AddOrUpdateSink(&listener, wants);
+  factory_->modules[0]->SendFrame(640, 480);
+  EXPECT_TRUE_WAIT(listener.frame_count() > 0, 5000);
+  EXPECT_EQ(320, listener.frame_width());
+  EXPECT_EQ(240, listener.frame_height());
+  capturer_->Stop();
+}
+
 TEST_F(WebRtcVideoCapturerTest, TestCaptureVcm) {
   EXPECT_TRUE(capturer_->Init(factory_->Create(0,
       reinterpret_cast<const char*>(kTestDeviceId.c_str()))));
@@ -17,6 +17,7 @@
 
 #include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/packetbufferpool.h"
 #include "webrtc/base/stringutils.h"
 #include "webrtc/base/timeutils.h"
 #include "webrtc/base/trace_event.h"
@@ -673,6 +674,8 @@ WebRtcVideoChannel2::WebRtcVideoChannel2(
     WebRtcVideoDecoderFactory* external_decoder_factory)
     : VideoMediaChannel(config),
       call_(call),
+      deliver_packets_on_network_thread_(
+          config.deliver_packets_on_network_thread),
       unsignalled_ssrc_handler_(&default_unsignalled_ssrc_handler_),
       video_config_(config.video),
       external_encoder_factory_(external_encoder_factory),
@@ -1487,6 +1490,23 @@ void WebRtcVideoChannel2::OnRtcpReceived(
       webrtc_packet_time);
 }
 
+bool WebRtcVideoChannel2::DeliverPacketOnNetworkThread(
+    bool rtcp,
+    rtc::CopyOnWriteBuffer* packet,
+    const rtc::PacketTime& packet_time) {
+  // Only |call_| is touched here, which takes packets on any thread.
+  if (!deliver_packets_on_network_thread_)
+    return false;
+  const webrtc::PacketTime webrtc_packet_time(packet_time.timestamp,
+                                              packet_time.not_before);
+  // Packets of unsignalled SSRCs are left to OnPacketReceived(), which decides
+  // whether to create a stream for them.
+  return call_->Receiver()->DeliverPacket(webrtc::MediaType::VIDEO,
+                                          packet->cdata(), packet->size(),
+                                          webrtc_packet_time) !=
+         webrtc::PacketReceiver::DELIVERY_UNKNOWN_SSRC;
+}
+
 void WebRtcVideoChannel2::OnReadyToSend(bool ready) {
   LOG(LS_VERBOSE) << "OnReadyToSend: " << (ready ? "Ready." : "Not ready.");
   call_->SignalChannelNetworkState(
@@ -1519,14 +1539,16 @@ void WebRtcVideoChannel2::SetInterface(NetworkInterface* iface) {
 bool WebRtcVideoChannel2::SendRtp(const uint8_t* data,
                                   size_t len,
                                   const webrtc::PacketOptions& options) {
-  rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
+  rtc::CopyOnWriteBuffer packet =
+        rtc::PacketBufferPool::Instance()->Allocate(data, len);
   rtc::PacketOptions rtc_options;
   rtc_options.packet_id = options.packet_id;
   return MediaChannel::SendPacket(&packet, rtc_options);
 }
 
 bool WebRtcVideoChannel2::SendRtcp(const uint8_t* data, size_t len) {
-  rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
+  rtc::CopyOnWriteBuffer packet =
+        rtc::PacketBufferPool::Instance()->Allocate(data, len);
   return MediaChannel::SendRtcp(&packet, rtc::PacketOptions());
 }
 
@@ -1640,6 +1662,7 @@ void WebRtcVideoChannel2::WebRtcVideoSendStream::OnFrame(
   webrtc::VideoFrame video_frame(frame.video_frame_buffer(),
                                  frame.rotation(),
                                  frame.timestamp_us());
+  video_frame.set_update_rect(frame.update_rect());
 
   rtc::CritScope cs(&lock_);
 
@@ -173,6 +173,10 @@ class WebRtcVideoChannel2 : public VideoMediaChannel, public webrtc::Transport {
                         const rtc::PacketTime& packet_time) override;
   void OnRtcpReceived(rtc::CopyOnWriteBuffer* packet,
                       const rtc::PacketTime& packet_time) override;
+  bool DeliverPacketOnNetworkThread(
+      bool rtcp,
+      rtc::CopyOnWriteBuffer* packet,
+      const rtc::PacketTime& packet_time) override;
   void OnReadyToSend(bool ready) override;
   void OnNetworkRouteChanged(const std::string& transport_name,
                              const rtc::NetworkRoute& network_route) override;
@@ -536,6 +540,7 @@ class WebRtcVideoChannel2 : public VideoMediaChannel, public webrtc::Transport {
   uint32_t rtcp_receiver_report_ssrc_;
   bool sending_;
   webrtc::Call* const call_;
+  const bool deliver_packets_on_network_thread_;
 
   DefaultUnsignalledSsrcHandler default_unsignalled_ssrc_handler_;
   UnsignalledSsrcHandler* const unsignalled_ssrc_handler_;
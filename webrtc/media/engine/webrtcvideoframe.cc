@@ -95,6 +95,16 @@ webrtc::VideoRotation WebRtcVideoFrame::rotation() const {
   return rotation_;
 }
 
+const rtc::Optional<webrtc::VideoFrame::UpdateRect>&
+WebRtcVideoFrame::update_rect() const {
+  return update_rect_;
+}
+
+void WebRtcVideoFrame::set_update_rect(
+    const rtc::Optional<webrtc::VideoFrame::UpdateRect>& update_rect) {
+  update_rect_ = update_rect;
+}
+
 bool WebRtcVideoFrame::Reset(uint32_t format,
                              int w,
                              int h,
@@ -156,6 +166,7 @@ bool WebRtcVideoFrame::Reset(uint32_t format,
 void WebRtcVideoFrame::InitToEmptyBuffer(int w, int h) {
   video_frame_buffer_ = new rtc::RefCountedObject<webrtc::I420Buffer>(w, h);
   rotation_ = webrtc::kVideoRotation_0;
+  update_rect_ = rtc::Optional<webrtc::VideoFrame::UpdateRect>();
 }
 
 }  // namespace cricket
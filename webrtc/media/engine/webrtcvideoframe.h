@@ -86,6 +86,12 @@ class WebRtcVideoFrame : public VideoFrame {
 
   webrtc::VideoRotation rotation() const override;
 
+  const rtc::Optional<webrtc::VideoFrame::UpdateRect>& update_rect()
+      const override;
+  void set_update_rect(
+      const rtc::Optional<webrtc::VideoFrame::UpdateRect>& update_rect)
+      override;
+
  protected:
   // Creates a frame from a raw sample with FourCC |format| and size |w| x |h|.
   // |h| can be negative indicating a vertically flipped image.
@@ -112,6 +118,7 @@ class WebRtcVideoFrame : public VideoFrame {
   int64_t timestamp_us_;
   uint32_t transport_frame_id_;
   webrtc::VideoRotation rotation_;
+  rtc::Optional<webrtc::VideoFrame::UpdateRect> update_rect_;
 
   // This is mutable as the calculation is expensive but once calculated, it
   // remains const.
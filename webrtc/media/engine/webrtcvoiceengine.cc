@@ -1460,7 +1460,11 @@ WebRtcVoiceMediaChannel::WebRtcVoiceMediaChannel(WebRtcVoiceEngine* engine,
                                                  const MediaConfig& config,
                                                  const AudioOptions& options,
                                                  webrtc::Call* call)
-    : VoiceMediaChannel(config), engine_(engine), call_(call) {
+    : VoiceMediaChannel(config),
+      engine_(engine),
+      call_(call),
+      deliver_packets_on_network_thread_(
+          config.deliver_packets_on_network_thread) {
   LOG(LS_VERBOSE) << "WebRtcVoiceMediaChannel::WebRtcVoiceMediaChannel";
   RTC_DCHECK(call);
   engine->RegisterChannel(this);
@@ -2446,6 +2450,23 @@ void WebRtcVoiceMediaChannel::OnRtcpReceived(
       packet->cdata(), packet->size(), webrtc_packet_time);
 }
 
+bool WebRtcVoiceMediaChannel::DeliverPacketOnNetworkThread(
+    bool rtcp,
+    rtc::CopyOnWriteBuffer* packet,
+    const rtc::PacketTime& packet_time) {
+  // Only |call_| is touched here, which takes packets on any thread.
+  if (!deliver_packets_on_network_thread_)
+    return false;
+  const webrtc::PacketTime webrtc_packet_time(packet_time.timestamp,
+                                              packet_time.not_before);
+  // Packets of unsignalled SSRCs are left to OnPacketReceived(), which creates
+  // a default receive stream for them.
+  return call_->Receiver()->DeliverPacket(webrtc::MediaType::AUDIO,
+                                          packet->cdata(), packet->size(),
+                                          webrtc_packet_time) !=
+         webrtc::PacketReceiver::DELIVERY_UNKNOWN_SSRC;
+}
+
 void WebRtcVoiceMediaChannel::OnNetworkRouteChanged(
     const std::string& transport_name,
     const rtc::NetworkRoute& network_route) {
@@ -2582,6 +2582,30 @@ TEST_F(WebRtcVoiceEngineTestFake, RecvUnsignalled) {
                                                 sizeof(kPcmuFrame)));
 }
 
+// Test that packets of known streams can be delivered on the network thread,
+// and that those of unsignalled streams are left to OnPacketReceived().
+TEST_F(WebRtcVoiceEngineTestFake, DeliverPacketOnNetworkThread) {
+  EXPECT_TRUE(SetupChannel());
+  EXPECT_TRUE(AddRecvStream(1));
+  rtc::CopyOnWriteBuffer packet(kPcmuFrame, sizeof(kPcmuFrame));
+  EXPECT_FALSE(channel_->DeliverPacketOnNetworkThread(false, &packet,
+                                                      rtc::PacketTime()));
+  EXPECT_EQ(0, GetRecvStream(1).received_packets());
+  delete channel_;
+
+  cricket::MediaConfig config;
+  config.deliver_packets_on_network_thread = true;
+  channel_ = engine_->CreateChannel(&call_, config, cricket::AudioOptions());
+  EXPECT_FALSE(channel_->DeliverPacketOnNetworkThread(false, &packet,
+                                                      rtc::PacketTime()));
+  EXPECT_EQ(0, call_.GetAudioReceiveStreams().size());
+  EXPECT_TRUE(AddRecvStream(1));
+  EXPECT_TRUE(channel_->DeliverPacketOnNetworkThread(false, &packet,
+                                                     rtc::PacketTime()));
+  EXPECT_TRUE(GetRecvStream(1).VerifyLastPacket(kPcmuFrame,
+                                                sizeof(kPcmuFrame)));
+}
+
 // Test that receiving on an unsignalled stream works (default channel will be
 // created), and that packets will be forwarded to the default channel
 // regardless of their SSRCs.
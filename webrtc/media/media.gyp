@@ -14,6 +14,7 @@
       'type': 'static_library',
       'dependencies': [
         '<(webrtc_root)/base/base.gyp:rtc_base_approved',
+        '<(webrtc_root)/base/base.gyp:rtc_task_queue',
         '<(webrtc_root)/common.gyp:webrtc_common',
         '<(webrtc_root)/webrtc.gyp:webrtc',
         '<(webrtc_root)/voice_engine/voice_engine.gyp:voice_engine',
@@ -26,6 +27,8 @@
         ],
       },
       'sources': [
+        'base/asyncvideosink.cc',
+        'base/asyncvideosink.h',
         'base/audiosource.h',
         'base/codec.cc',
         'base/codec.h',
@@ -333,11 +333,12 @@ SctpDataEngine::~SctpDataEngine() {}
 
 // Called on the worker thread.
 DataMediaChannel* SctpDataEngine::CreateChannel(
-    DataChannelType data_channel_type) {
+    DataChannelType data_channel_type,
+    const MediaConfig& config) {
   if (data_channel_type != DCT_SCTP) {
     return NULL;
   }
-  return new SctpDataMediaChannel(rtc::Thread::Current());
+  return new SctpDataMediaChannel(rtc::Thread::Current(), config.sctp);
 }
 
 // static
@@ -378,8 +379,10 @@ int SctpDataMediaChannel::SendThresholdCallback(struct socket* sock,
   return 0;
 }
 
-SctpDataMediaChannel::SctpDataMediaChannel(rtc::Thread* thread)
+SctpDataMediaChannel::SctpDataMediaChannel(rtc::Thread* thread,
+                                           const MediaConfig::Sctp& config)
     : worker_thread_(thread),
+      config_(config),
       local_port_(kSctpDefaultPort),
       remote_port_(kSctpDefaultPort),
       sock_(NULL),
@@ -421,11 +424,15 @@ bool SctpDataMediaChannel::OpenSctpSocket() {
   // If kSendBufferSize isn't reflective of reality, we log an error, but we
   // still have to do something reasonable here.  Look up what the buffer's
   // real size is and set our threshold to something reasonable.
-  const static int kSendThreshold = usrsctp_sysctl_get_sctp_sendspace() / 2;
+  const static int kDefaultSendThreshold =
+      usrsctp_sysctl_get_sctp_sendspace() / 2;
+  int send_threshold = config_.send_buffer_size > 0
+                           ? config_.send_buffer_size / 2
+                           : kDefaultSendThreshold;
 
   sock_ = usrsctp_socket(
       AF_CONN, SOCK_STREAM, IPPROTO_SCTP, OnSctpInboundPacket,
-      &SctpDataMediaChannel::SendThresholdCallback, kSendThreshold, this);
+      &SctpDataMediaChannel::SendThresholdCallback, send_threshold, this);
   if (!sock_) {
     LOG_ERRNO(LS_ERROR) << debug_name_ << "Failed to create SCTP socket.";
     DecrementUsrSctpUsageCount();
@@ -451,6 +458,23 @@ bool SctpDataMediaChannel::OpenSctpSocket() {
     return false;
   }
 
+  // The receive buffer size is advertised to the peer as the initial window,
+  // so it has to be set before connecting.
+  if (config_.send_buffer_size > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF,
+                         &config_.send_buffer_size,
+                         sizeof(config_.send_buffer_size))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "Failed to set SO_SNDBUF.";
+    return false;
+  }
+  if (config_.receive_buffer_size > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_RCVBUF,
+                         &config_.receive_buffer_size,
+                         sizeof(config_.receive_buffer_size))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "Failed to set SO_RCVBUF.";
+    return false;
+  }
+
   // Enable stream ID resets.
   struct sctp_assoc_value stream_rst;
   stream_rst.assoc_id = SCTP_ALL_ASSOC;
@@ -666,7 +690,9 @@ bool SctpDataMediaChannel::SendData(
       rtc::checked_cast<socklen_t>(sizeof(spa)), SCTP_SENDV_SPA, 0);
   if (send_res < 0) {
     if (errno == SCTP_EWOULDBLOCK) {
-      *result = SDR_BLOCK;
+      if (result) {
+        *result = SDR_BLOCK;
+      }
       LOG(LS_INFO) << debug_name_ << "->SendData(...): EWOULDBLOCK returned";
     } else {
       LOG_ERRNO(LS_ERROR) << "ERROR:" << debug_name_
@@ -88,7 +88,8 @@ class SctpDataEngine : public DataEngineInterface, public sigslot::has_slots<> {
   SctpDataEngine();
   ~SctpDataEngine() override;
 
-  DataMediaChannel* CreateChannel(DataChannelType data_channel_type) override;
+  DataMediaChannel* CreateChannel(DataChannelType data_channel_type,
+                                  const MediaConfig& config) override;
   const std::vector<DataCodec>& data_codecs() override { return codecs_; }
 
  private:
@@ -125,7 +126,7 @@ class SctpDataMediaChannel : public DataMediaChannel,
 
   // Given a thread which will be used to post messages (received data) to this
   // SctpDataMediaChannel instance.
-  explicit SctpDataMediaChannel(rtc::Thread* thread);
+  SctpDataMediaChannel(rtc::Thread* thread, const MediaConfig::Sctp& config);
   virtual ~SctpDataMediaChannel();
 
   // When SetSend is set to true, connects. When set to false, disconnects.
@@ -215,6 +216,7 @@ class SctpDataMediaChannel : public DataMediaChannel,
   // Responsible for marshalling incoming data to the channels listeners, and
   // outgoing data to the network interface.
   rtc::Thread* worker_thread_;
+  const MediaConfig::Sctp config_;
   // The local and remote SCTP port to use. These are passed along the wire
   // and the listener and connector must be using the same port. It is not
   // related to the ports at the IP level.  If set to -1, we default to
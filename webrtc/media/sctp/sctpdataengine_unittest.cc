@@ -266,7 +266,8 @@ class SctpDataMediaChannelTest : public testing::Test,
   SctpDataMediaChannel* CreateChannel(SctpFakeNetworkInterface* net,
                                       SctpFakeDataReceiver* recv) {
     SctpDataMediaChannel* channel =
-        static_cast<SctpDataMediaChannel*>(engine_->CreateChannel(DCT_SCTP));
+        static_cast<SctpDataMediaChannel*>(
+            engine_->CreateChannel(DCT_SCTP, media_config_));
     channel->SetInterface(net);
     // When data is received, pass it to the SctpFakeDataReceiver.
     channel->SignalDataReceived.connect(
@@ -311,6 +312,10 @@ class SctpDataMediaChannelTest : public testing::Test,
 
   int channel1_ready_to_send_count() { return chan1_ready_to_send_count_; }
   int channel2_ready_to_send_count() { return chan2_ready_to_send_count_; }
+
+  // Applies to the channels created after.
+  MediaConfig media_config_;
+
  private:
   std::unique_ptr<SctpDataEngine> engine_;
   std::unique_ptr<SctpFakeNetworkInterface> net1_;
@@ -408,6 +413,32 @@ TEST_F(SctpDataMediaChannelTest, SendDataBlocked) {
   EXPECT_EQ(SDR_BLOCK, result);
 }
 
+// Verifies that a larger send buffer takes more messages before blocking.
+TEST_F(SctpDataMediaChannelTest, SendBufferSizeIsConfigurable) {
+  // Four times the default.
+  media_config_.sctp.send_buffer_size = 1024 * 1024;
+  media_config_.sctp.receive_buffer_size = 1024 * 1024;
+  SetupConnectedChannels();
+
+  SendDataResult result = SDR_SUCCESS;
+  SendDataParams params;
+  params.ssrc = 1;
+
+  std::vector<char> buffer(1024 * 64, 0);
+
+  size_t sent = 0;
+  for (; sent < 100; ++sent) {
+    channel1()->SendData(
+        params, rtc::CopyOnWriteBuffer(&buffer[0], buffer.size()), &result);
+    if (result == SDR_BLOCK)
+      break;
+  }
+
+  EXPECT_EQ(SDR_BLOCK, result);
+  // The default 256 kB buffer takes four.
+  EXPECT_LT(8u, sent);
+}
+
 TEST_F(SctpDataMediaChannelTest, ClosesRemoteStream) {
   SetupConnectedChannels();
   SignalChannelClosedObserver chan_1_sig_receiver, chan_2_sig_receiver;
@@ -177,6 +177,38 @@ int AcmReceiver::GetAudio(int desired_freq_hz,
   return 0;
 }
 
+int AcmReceiver::GetAudioWithoutDecoding(int desired_freq_hz,
+                                         AudioFrame* audio_frame) {
+  // Accessing members, take the lock.
+  rtc::CritScope lock(&crit_sect_);
+
+  if (neteq_->GetAudioWithoutDecoding(audio_frame) != NetEq::kOK) {
+    LOG(LERROR) << "AcmReceiver::GetAudioWithoutDecoding - NetEq Failed.";
+    return -1;
+  }
+
+  // Silence needs no resampling, only the frame size changes.
+  if (desired_freq_hz != -1 &&
+      audio_frame->sample_rate_hz_ != desired_freq_hz) {
+    audio_frame->sample_rate_hz_ = desired_freq_hz;
+    audio_frame->samples_per_channel_ =
+        static_cast<size_t>(desired_freq_hz / 100);
+  }
+
+  // The next decoded frame follows silence, so the resampler is primed with
+  // silence if it is needed.
+  memset(last_audio_buffer_.get(), 0,
+         sizeof(int16_t) * AudioFrame::kMaxDataSizeSamples);
+  resampled_last_output_frame_ = false;
+
+  call_stats_.DecodedByNetEq(audio_frame->speech_type_, true);
+  return 0;
+}
+
+bool AcmReceiver::InDtx() const {
+  return neteq_->InDtx();
+}
+
 int32_t AcmReceiver::AddCodec(int acm_codec_id,
                               uint8_t payload_type,
                               size_t channels,
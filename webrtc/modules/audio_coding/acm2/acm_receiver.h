@@ -81,6 +81,23 @@ class AcmReceiver {
   //
   int GetAudio(int desired_freq_hz, AudioFrame* audio_frame, bool* muted);
 
+  //
+  // Same as GetAudio(), but for audio that will not be played out. NetEq does
+  // not decode the packets, see NetEq::GetAudioWithoutDecoding(), and the
+  // sample data in |audio_frame| is not populated and must be interpreted as
+  // all zero.
+  //
+  // Return value             : 0 if OK.
+  //                           -1 if NetEq returned an error.
+  //
+  int GetAudioWithoutDecoding(int desired_freq_hz, AudioFrame* audio_frame);
+
+  //
+  // Returns true while the sender is in a DTX period and GetAudio() would only
+  // produce comfort noise, see NetEq::InDtx().
+  //
+  bool InDtx() const;
+
   //
   // Adds a new codec to the NetEq codec database.
   //
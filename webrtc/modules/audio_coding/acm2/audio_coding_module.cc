@@ -68,6 +68,12 @@ class AudioCodingModuleImpl final : public AudioCodingModule {
   // Add 10 ms of raw (PCM) audio data to the encoder.
   int Add10MsData(const AudioFrame& audio_frame) override;
 
+  // Add a multiple of 10 ms of raw (PCM) audio data to the encoder.
+  int AddData(rtc::ArrayView<const int16_t> audio,
+              int sample_rate_hz,
+              size_t num_channels,
+              uint32_t timestamp) override;
+
   /////////////////////////////////////////
   // (RED) Redundant Coding
   //
@@ -167,6 +173,9 @@ class AudioCodingModuleImpl final : public AudioCodingModule {
                       AudioFrame* audio_frame,
                       bool* muted) override;
   int PlayoutData10Ms(int desired_freq_hz, AudioFrame* audio_frame) override;
+  int PlayoutData10MsWithoutDecoding(int desired_freq_hz,
+                                     AudioFrame* audio_frame) override;
+  bool PlayoutInDtx() const override;
 
   /////////////////////////////////////////
   //   Statistics
@@ -407,6 +416,18 @@ class RawAudioEncoderWrapper final : public AudioEncoder {
   void SetTargetBitrate(int target_bps) override {
     return enc_->SetTargetBitrate(target_bps);
   }
+  bool EnableAudioNetworkAdaptor() override {
+    return enc_->EnableAudioNetworkAdaptor();
+  }
+  void DisableAudioNetworkAdaptor() override {
+    return enc_->DisableAudioNetworkAdaptor();
+  }
+  void OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) override {
+    return enc_->OnReceivedUplinkBandwidth(uplink_bandwidth_bps);
+  }
+  void OnReceivedRtt(int rtt_ms) override {
+    return enc_->OnReceivedRtt(rtt_ms);
+  }
 
  private:
   AudioEncoder* enc_;
@@ -669,6 +690,47 @@ int AudioCodingModuleImpl::Add10MsData(const AudioFrame& audio_frame) {
   return r < 0 ? r : Encode(input_data);
 }
 
+int AudioCodingModuleImpl::AddData(rtc::ArrayView<const int16_t> audio,
+                                   int sample_rate_hz,
+                                   size_t num_channels,
+                                   uint32_t timestamp) {
+  const size_t samples_per_channel =
+      sample_rate_hz > 0 ? static_cast<size_t>(sample_rate_hz / 100) : 0;
+  const size_t samples_per_block = samples_per_channel * num_channels;
+  if (samples_per_block == 0 ||
+      samples_per_block > AudioFrame::kMaxDataSizeSamples ||
+      audio.size() % samples_per_block != 0) {
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                 "Cannot add audio, length is not a multiple of 10 ms");
+    return -1;
+  }
+
+  // The frame is only used to pass each block on; the remaining checks are
+  // done per block by Add10MsDataInternal().
+  AudioFrame frame;
+  frame.sample_rate_hz_ = sample_rate_hz;
+  frame.num_channels_ = num_channels;
+  frame.samples_per_channel_ = samples_per_channel;
+  frame.timestamp_ = timestamp;
+
+  // The lock is only taken once for all the blocks.
+  rtc::CritScope lock(&acm_crit_sect_);
+  int encoded_bytes = 0;
+  for (size_t offset = 0; offset < audio.size(); offset += samples_per_block) {
+    memcpy(frame.data_, &audio[offset],
+           samples_per_block * sizeof(frame.data_[0]));
+    InputData input_data;
+    int r = Add10MsDataInternal(frame, &input_data);
+    if (r >= 0)
+      r = Encode(input_data);
+    if (r < 0)
+      return r;
+    encoded_bytes += r;
+    frame.timestamp_ += static_cast<uint32_t>(samples_per_channel);
+  }
+  return encoded_bytes;
+}
+
 int AudioCodingModuleImpl::Add10MsDataInternal(const AudioFrame& audio_frame,
                                                InputData* input_data) {
   if (audio_frame.samples_per_channel_ == 0) {
@@ -1119,6 +1181,22 @@ int AudioCodingModuleImpl::PlayoutData10Ms(int desired_freq_hz,
   return ret;
 }
 
+int AudioCodingModuleImpl::PlayoutData10MsWithoutDecoding(
+    int desired_freq_hz,
+    AudioFrame* audio_frame) {
+  if (receiver_.GetAudioWithoutDecoding(desired_freq_hz, audio_frame) != 0) {
+    WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceAudioCoding, id_,
+                 "PlayoutData10MsWithoutDecoding failed");
+    return -1;
+  }
+  audio_frame->id_ = id_;
+  return 0;
+}
+
+bool AudioCodingModuleImpl::PlayoutInDtx() const {
+  return receiver_.InDtx();
+}
+
 /////////////////////////////////////////
 //   Statistics
 //
@@ -345,6 +345,80 @@ TEST_F(AudioCodingModuleTestOldApi, TransportCallbackIsInvokedForEachPacket) {
   EXPECT_EQ(kAudioFrameSpeech, packet_cb_.last_frame_type());
 }
 
+namespace {
+// Records the timestamp and payload of all the packets.
+class PacketRecorder : public AudioPacketizationCallback {
+ public:
+  int32_t SendData(FrameType frame_type,
+                   uint8_t payload_type,
+                   uint32_t timestamp,
+                   const uint8_t* payload_data,
+                   size_t payload_len_bytes,
+                   const RTPFragmentationHeader* fragmentation) override {
+    timestamps.push_back(timestamp);
+    payloads.push_back(
+        std::vector<uint8_t>(payload_data, payload_data + payload_len_bytes));
+    return 0;
+  }
+
+  std::vector<uint32_t> timestamps;
+  std::vector<std::vector<uint8_t>> payloads;
+};
+}  // namespace
+
+// Checks that adding several 10 ms blocks at once gives the same packets as
+// adding them one by one, including resampling and down-mixing.
+TEST_F(AudioCodingModuleTestOldApi, AddDataMatchesAdd10MsData) {
+  const int k10MsBlocksPerPacket = 3;
+  const int kNumBlocks = 4 * k10MsBlocksPerPacket;
+  const int kInputSampleRateHz = 32000;
+  const size_t kInputChannels = 2;
+  const size_t kSamplesPerBlock = kInputChannels * kInputSampleRateHz / 100;
+  codec_.pacsize = k10MsBlocksPerPacket * kSampleRateHz / 100;
+  RegisterCodec();
+  PacketRecorder batch_packets;
+  ASSERT_EQ(0, acm_->RegisterTransportCallback(&batch_packets));
+
+  std::unique_ptr<AudioCodingModule> reference_acm(
+      AudioCodingModule::Create(id_, clock_));
+  ASSERT_EQ(0, reference_acm->RegisterSendCodec(codec_));
+  PacketRecorder reference_packets;
+  ASSERT_EQ(0, reference_acm->RegisterTransportCallback(&reference_packets));
+
+  std::vector<int16_t> audio(kNumBlocks * kSamplesPerBlock);
+  for (size_t i = 0; i < audio.size(); ++i)
+    audio[i] = static_cast<int16_t>((i * 131) % 2001 - 1000);
+
+  const uint32_t kTimestamp = 4711;
+  EXPECT_GT(acm_->AddData(audio, kInputSampleRateHz, kInputChannels,
+                          kTimestamp),
+            0);
+
+  AudioFrame frame;
+  frame.sample_rate_hz_ = kInputSampleRateHz;
+  frame.num_channels_ = kInputChannels;
+  frame.samples_per_channel_ = kInputSampleRateHz / 100;
+  frame.timestamp_ = kTimestamp;
+  for (int block = 0; block < kNumBlocks; ++block) {
+    memcpy(frame.data_, &audio[block * kSamplesPerBlock],
+           kSamplesPerBlock * sizeof(frame.data_[0]));
+    ASSERT_GE(reference_acm->Add10MsData(frame), 0);
+    frame.timestamp_ += kInputSampleRateHz / 100;
+  }
+
+  EXPECT_EQ(static_cast<size_t>(kNumBlocks / k10MsBlocksPerPacket),
+            reference_packets.payloads.size());
+  EXPECT_EQ(reference_packets.timestamps, batch_packets.timestamps);
+  EXPECT_EQ(reference_packets.payloads, batch_packets.payloads);
+}
+
+TEST_F(AudioCodingModuleTestOldApi, AddDataFailsOnPartialBlocks) {
+  RegisterCodec();
+  std::vector<int16_t> audio(3 * kNumSamples10ms / 2);
+  EXPECT_EQ(-1, acm_->AddData(audio, kSampleRateHz, 1, 0));
+  EXPECT_EQ(0, packet_cb_.num_calls());
+}
+
 #if defined(WEBRTC_CODEC_ISAC) || defined(WEBRTC_CODEC_ISACFX)
 // Verifies that the RTP timestamp series is not reset when the codec is
 // changed.
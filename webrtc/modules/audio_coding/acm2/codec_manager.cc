@@ -190,6 +190,10 @@ bool CodecManager::SetCodecFEC(bool enable_codec_fec) {
   return true;
 }
 
+void CodecManager::SetAudioNetworkAdaptor(bool enable) {
+  codec_stack_params_.use_audio_network_adaptor = enable;
+}
+
 bool CodecManager::MakeEncoder(RentACodec* rac, AudioCodingModule* acm) {
   RTC_DCHECK(rac);
   RTC_DCHECK(acm);
@@ -56,6 +56,10 @@ class CodecManager final {
 
   bool SetCodecFEC(bool enable_codec_fec);
 
+  // Enables or disables the audio network adaptor of the speech encoder, if
+  // it has one. Takes effect when the encoder is next made.
+  void SetAudioNetworkAdaptor(bool enable);
+
   // Uses the provided Rent-A-Codec to create a new encoder stack, if we have a
   // complete specification; if so, it is then passed to set_encoder. On error,
   // returns false.
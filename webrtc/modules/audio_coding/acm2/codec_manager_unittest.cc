@@ -67,5 +67,41 @@ TEST(CodecManagerTest, ExternalEncoderFec) {
   EXPECT_FALSE(cm.GetStackParams()->use_codec_fec);
 }
 
+TEST(CodecManagerTest, ExternalEncoderAudioNetworkAdaptor) {
+  auto enc0 = CreateMockEncoder();
+  auto enc1 = CreateMockEncoder();
+  auto enc2 = CreateMockEncoder();
+  EXPECT_CALL(*enc0, SetFec(false)).WillOnce(Return(true));
+  EXPECT_CALL(*enc1, SetFec(false)).WillOnce(Return(true));
+  EXPECT_CALL(*enc2, SetFec(false)).WillOnce(Return(true));
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(*enc0, DisableAudioNetworkAdaptor());
+    EXPECT_CALL(*enc1, EnableAudioNetworkAdaptor()).WillOnce(Return(true));
+    EXPECT_CALL(*enc2, EnableAudioNetworkAdaptor()).WillOnce(Return(false));
+  }
+
+  CodecManager cm;
+  RentACodec rac;
+
+  // use_audio_network_adaptor starts out false.
+  EXPECT_FALSE(cm.GetStackParams()->use_audio_network_adaptor);
+  cm.GetStackParams()->speech_encoder = std::move(enc0);
+  EXPECT_TRUE(rac.RentEncoderStack(cm.GetStackParams()));
+  EXPECT_FALSE(cm.GetStackParams()->use_audio_network_adaptor);
+
+  // Set it to true.
+  cm.SetAudioNetworkAdaptor(true);
+  EXPECT_TRUE(cm.GetStackParams()->use_audio_network_adaptor);
+  cm.GetStackParams()->speech_encoder = std::move(enc1);
+  EXPECT_TRUE(rac.RentEncoderStack(cm.GetStackParams()));
+  EXPECT_TRUE(cm.GetStackParams()->use_audio_network_adaptor);
+
+  // Switch to a codec that doesn't support it.
+  cm.GetStackParams()->speech_encoder = std::move(enc2);
+  EXPECT_TRUE(rac.RentEncoderStack(cm.GetStackParams()));
+  EXPECT_FALSE(cm.GetStackParams()->use_audio_network_adaptor);
+}
+
 }  // namespace acm2
 }  // namespace webrtc
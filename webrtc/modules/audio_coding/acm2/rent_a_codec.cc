@@ -332,6 +332,15 @@ std::unique_ptr<AudioEncoder> RentACodec::RentEncoderStack(
     RTC_DCHECK(success);
   }
 
+  if (param->use_audio_network_adaptor) {
+    // Switch the audio network adaptor on. On failure, remember that it is
+    // off.
+    if (!param->speech_encoder->EnableAudioNetworkAdaptor())
+      param->use_audio_network_adaptor = false;
+  } else {
+    param->speech_encoder->DisableAudioNetworkAdaptor();
+  }
+
   auto pt = [&param](const std::map<int, int>& m) {
     auto it = m.find(param->speech_encoder->SampleRateHz());
     return it == m.end() ? rtc::Optional<int>()
@@ -204,6 +204,7 @@ class RentACodec {
     std::unique_ptr<AudioEncoder> speech_encoder;
 
     bool use_codec_fec = false;
+    bool use_audio_network_adaptor = false;
     bool use_red = false;
     bool use_cng = false;
     ACMVADMode vad_mode = VADNormal;
@@ -41,6 +41,27 @@ void AudioNetworkAdaptorImpl::SetUplinkPacketLossFraction(
   // TODO(minyue): Add debug dumping.
 }
 
+void AudioNetworkAdaptorImpl::SetTargetAudioBitrate(
+    int target_audio_bitrate_bps) {
+  last_metrics_.target_audio_bitrate_bps =
+      rtc::Optional<int>(target_audio_bitrate_bps);
+
+  // TODO(minyue): Add debug dumping.
+}
+
+void AudioNetworkAdaptorImpl::SetRtt(int rtt_ms) {
+  last_metrics_.rtt_ms = rtc::Optional<int>(rtt_ms);
+
+  // TODO(minyue): Add debug dumping.
+}
+
+void AudioNetworkAdaptorImpl::SetEncodeTime(int encode_time_us,
+                                            int encoded_audio_duration_ms) {
+  last_metrics_.encode_time_us = rtc::Optional<int>(encode_time_us);
+  last_metrics_.encoded_audio_duration_ms =
+      rtc::Optional<int>(encoded_audio_duration_ms);
+}
+
 AudioNetworkAdaptor::EncoderRuntimeConfig
 AudioNetworkAdaptorImpl::GetEncoderRuntimeConfig() {
   EncoderRuntimeConfig config;
@@ -48,6 +69,11 @@ AudioNetworkAdaptorImpl::GetEncoderRuntimeConfig() {
        controller_manager_->GetSortedControllers(last_metrics_))
     controller->MakeDecision(last_metrics_, &config);
 
+  // The encode time is reported per frame, so that each frame is only
+  // accounted for once.
+  last_metrics_.encode_time_us = rtc::Optional<int>();
+  last_metrics_.encoded_audio_duration_ms = rtc::Optional<int>();
+
   // TODO(minyue): Add debug dumping.
 
   return config;
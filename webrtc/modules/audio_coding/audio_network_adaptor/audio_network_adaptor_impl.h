@@ -37,9 +37,16 @@ class AudioNetworkAdaptorImpl final : public AudioNetworkAdaptor {
 
   void SetUplinkPacketLossFraction(float uplink_packet_loss_fraction) override;
 
+  void SetTargetAudioBitrate(int target_audio_bitrate_bps) override;
+
+  void SetRtt(int rtt_ms) override;
+
   void SetReceiverFrameLengthRange(int min_frame_length_ms,
                                    int max_frame_length_ms) override;
 
+  void SetEncodeTime(int encode_time_us,
+                     int encoded_audio_duration_ms) override;
+
   EncoderRuntimeConfig GetEncoderRuntimeConfig() override;
 
   void StartDebugDump(FILE* file_handle) override;
@@ -29,7 +29,11 @@ constexpr size_t kNumControllers = 2;
 MATCHER_P(NetworkMetricsIs, metric, "") {
   return arg.uplink_bandwidth_bps == metric.uplink_bandwidth_bps &&
          arg.target_audio_bitrate_bps == metric.target_audio_bitrate_bps &&
-         arg.uplink_packet_loss_fraction == metric.uplink_packet_loss_fraction;
+         arg.uplink_packet_loss_fraction ==
+             metric.uplink_packet_loss_fraction &&
+         arg.rtt_ms == metric.rtt_ms &&
+         arg.encode_time_us == metric.encode_time_us &&
+         arg.encoded_audio_duration_ms == metric.encoded_audio_duration_ms;
 }
 
 MATCHER_P(ConstraintsReceiverFrameLengthRangeIs, frame_length_range, "") {
@@ -95,6 +99,45 @@ TEST(AudioNetworkAdaptorImplTest,
   }
   states.audio_network_adaptor->SetUplinkPacketLossFraction(kPacketLoss);
   states.audio_network_adaptor->GetEncoderRuntimeConfig();
+
+  constexpr int kTargetAudioBitrate = 15000;
+  check.target_audio_bitrate_bps = rtc::Optional<int>(kTargetAudioBitrate);
+  for (auto& mock_controller : states.mock_controllers) {
+    EXPECT_CALL(*mock_controller, MakeDecision(NetworkMetricsIs(check), _));
+  }
+  states.audio_network_adaptor->SetTargetAudioBitrate(kTargetAudioBitrate);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+
+  constexpr int kRtt = 100;
+  check.rtt_ms = rtc::Optional<int>(kRtt);
+  for (auto& mock_controller : states.mock_controllers) {
+    EXPECT_CALL(*mock_controller, MakeDecision(NetworkMetricsIs(check), _));
+  }
+  states.audio_network_adaptor->SetRtt(kRtt);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+}
+
+TEST(AudioNetworkAdaptorImplTest, EncodeTimeIsOnlyUsedForOneDecision) {
+  auto states = CreateAudioNetworkAdaptor();
+
+  constexpr int kEncodeTimeUs = 400;
+  constexpr int kFrameLengthMs = 20;
+
+  Controller::NetworkMetrics check;
+  check.encode_time_us = rtc::Optional<int>(kEncodeTimeUs);
+  check.encoded_audio_duration_ms = rtc::Optional<int>(kFrameLengthMs);
+  for (auto& mock_controller : states.mock_controllers) {
+    EXPECT_CALL(*mock_controller, MakeDecision(NetworkMetricsIs(check), _));
+  }
+  states.audio_network_adaptor->SetEncodeTime(kEncodeTimeUs, kFrameLengthMs);
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
+
+  const Controller::NetworkMetrics no_metrics;
+  for (auto& mock_controller : states.mock_controllers) {
+    EXPECT_CALL(*mock_controller,
+                MakeDecision(NetworkMetricsIs(no_metrics), _));
+  }
+  states.audio_network_adaptor->GetEncoderRuntimeConfig();
 }
 
 TEST(AudioNetworkAdaptorImplTest, SetConstraintsIsCalledOnSetFrameLengthRange) {
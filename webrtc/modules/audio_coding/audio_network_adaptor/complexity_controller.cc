@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/audio_network_adaptor/complexity_controller.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+constexpr size_t ComplexityController::kEncodeTimeWindowFrames;
+
+ComplexityController::Config::Config(int initial_complexity,
+                                     int min_complexity,
+                                     int max_complexity,
+                                     float complexity_decreasing_cpu_usage,
+                                     float complexity_increasing_cpu_usage,
+                                     float cpu_usage_smoothing_factor,
+                                     int min_frames_between_changes)
+    : initial_complexity(initial_complexity),
+      min_complexity(min_complexity),
+      max_complexity(max_complexity),
+      complexity_decreasing_cpu_usage(complexity_decreasing_cpu_usage),
+      complexity_increasing_cpu_usage(complexity_increasing_cpu_usage),
+      cpu_usage_smoothing_factor(cpu_usage_smoothing_factor),
+      min_frames_between_changes(min_frames_between_changes) {}
+
+ComplexityController::Stats::Stats() = default;
+
+ComplexityController::Stats::~Stats() = default;
+
+ComplexityController::ComplexityController(const Config& config)
+    : config_(config),
+      complexity_(config_.initial_complexity),
+      num_complexity_changes_(0),
+      frames_since_last_change_(0),
+      cpu_usage_filter_(config_.cpu_usage_smoothing_factor),
+      next_encode_time_index_(0) {
+  RTC_DCHECK_LE(config_.min_complexity, config_.initial_complexity);
+  RTC_DCHECK_GE(config_.max_complexity, config_.initial_complexity);
+  // Without a gap between the thresholds, the complexity would oscillate.
+  RTC_DCHECK_LT(config_.complexity_increasing_cpu_usage,
+                config_.complexity_decreasing_cpu_usage);
+  encode_times_us_.reserve(kEncodeTimeWindowFrames);
+}
+
+ComplexityController::~ComplexityController() = default;
+
+void ComplexityController::MakeDecision(
+    const NetworkMetrics& metrics,
+    AudioNetworkAdaptor::EncoderRuntimeConfig* config) {
+  // Decision on |complexity| should not have been made.
+  RTC_DCHECK(!config->complexity);
+
+  if (metrics.encode_time_us && metrics.encoded_audio_duration_ms) {
+    UpdateComplexity(*metrics.encode_time_us,
+                     *metrics.encoded_audio_duration_ms);
+  }
+  config->complexity = rtc::Optional<int>(complexity_);
+}
+
+ComplexityController::Stats ComplexityController::GetStats() const {
+  Stats stats;
+  stats.complexity = complexity_;
+  stats.num_complexity_changes = num_complexity_changes_;
+  if (cpu_usage_filter_.filtered() != rtc::ExpFilter::kValueUndefined) {
+    stats.smoothed_cpu_usage =
+        rtc::Optional<float>(cpu_usage_filter_.filtered());
+  }
+  stats.encode_time_50th_percentile_us = EncodeTimePercentile(0.5f);
+  stats.encode_time_95th_percentile_us = EncodeTimePercentile(0.95f);
+  stats.encode_time_99th_percentile_us = EncodeTimePercentile(0.99f);
+  return stats;
+}
+
+void ComplexityController::UpdateComplexity(int encode_time_us,
+                                            int encoded_audio_duration_ms) {
+  RTC_DCHECK_GE(encode_time_us, 0);
+  RTC_DCHECK_GT(encoded_audio_duration_ms, 0);
+
+  if (encode_times_us_.size() < kEncodeTimeWindowFrames) {
+    encode_times_us_.push_back(encode_time_us);
+  } else {
+    encode_times_us_[next_encode_time_index_] = encode_time_us;
+  }
+  next_encode_time_index_ =
+      (next_encode_time_index_ + 1) % kEncodeTimeWindowFrames;
+
+  const float cpu_usage =
+      encode_time_us / (1000.f * encoded_audio_duration_ms);
+  const float smoothed_cpu_usage = cpu_usage_filter_.Apply(1.f, cpu_usage);
+
+  if (++frames_since_last_change_ < config_.min_frames_between_changes)
+    return;
+
+  int new_complexity = complexity_;
+  if (smoothed_cpu_usage > config_.complexity_decreasing_cpu_usage) {
+    new_complexity = std::max(complexity_ - 1, config_.min_complexity);
+  } else if (smoothed_cpu_usage < config_.complexity_increasing_cpu_usage) {
+    new_complexity = std::min(complexity_ + 1, config_.max_complexity);
+  }
+  if (new_complexity == complexity_)
+    return;
+
+  complexity_ = new_complexity;
+  ++num_complexity_changes_;
+  frames_since_last_change_ = 0;
+  // The usage measured at the previous complexity is no longer relevant.
+  cpu_usage_filter_.Reset(config_.cpu_usage_smoothing_factor);
+}
+
+rtc::Optional<int> ComplexityController::EncodeTimePercentile(
+    float percentile) const {
+  if (encode_times_us_.empty())
+    return rtc::Optional<int>();
+  std::vector<int> sorted_encode_times_us(encode_times_us_);
+  const size_t index = std::min(
+      static_cast<size_t>(percentile * sorted_encode_times_us.size()),
+      sorted_encode_times_us.size() - 1);
+  std::nth_element(sorted_encode_times_us.begin(),
+                   sorted_encode_times_us.begin() + index,
+                   sorted_encode_times_us.end());
+  return rtc::Optional<int>(sorted_encode_times_us[index]);
+}
+
+}  // namespace webrtc
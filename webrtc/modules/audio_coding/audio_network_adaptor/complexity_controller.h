@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
+#define WEBRTC_MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/exp_filter.h"
+#include "webrtc/base/optional.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/controller.h"
+
+namespace webrtc {
+
+// Adapts the encoder complexity to the measured encode time, so that the
+// encoder stays within a CPU budget. The CPU usage is the encode time divided
+// by the duration of the encoded audio; e.g. 0.01 means that 1 ms is spent on
+// encoding 100 ms of audio.
+class ComplexityController final : public Controller {
+ public:
+  struct Config {
+    Config(int initial_complexity,
+           int min_complexity,
+           int max_complexity,
+           float complexity_decreasing_cpu_usage,
+           float complexity_increasing_cpu_usage,
+           float cpu_usage_smoothing_factor,
+           int min_frames_between_changes);
+    int initial_complexity;
+    int min_complexity;
+    int max_complexity;
+    // Smoothed CPU usage above which the complexity should be decreased.
+    float complexity_decreasing_cpu_usage;
+    // Smoothed CPU usage below which the complexity should be increased.
+    float complexity_increasing_cpu_usage;
+    // Filter factor of the exponential CPU usage smoothing, applied per frame.
+    float cpu_usage_smoothing_factor;
+    // Number of frames to encode after a change before the next one, so that
+    // the smoothed CPU usage reflects the new complexity.
+    int min_frames_between_changes;
+  };
+
+  struct Stats {
+    Stats();
+    ~Stats();
+    int complexity;
+    int num_complexity_changes;
+    rtc::Optional<float> smoothed_cpu_usage;
+    // Percentiles of the encode time per frame, over the last
+    // kEncodeTimeWindowFrames frames.
+    rtc::Optional<int> encode_time_50th_percentile_us;
+    rtc::Optional<int> encode_time_95th_percentile_us;
+    rtc::Optional<int> encode_time_99th_percentile_us;
+  };
+
+  static constexpr size_t kEncodeTimeWindowFrames = 500;
+
+  explicit ComplexityController(const Config& config);
+  ~ComplexityController() override;
+
+  void MakeDecision(const NetworkMetrics& metrics,
+                    AudioNetworkAdaptor::EncoderRuntimeConfig* config) override;
+
+  Stats GetStats() const;
+
+ private:
+  void UpdateComplexity(int encode_time_us, int encoded_audio_duration_ms);
+  rtc::Optional<int> EncodeTimePercentile(float percentile) const;
+
+  const Config config_;
+  int complexity_;
+  int num_complexity_changes_;
+  int frames_since_last_change_;
+  rtc::ExpFilter cpu_usage_filter_;
+  // Circular buffer of the last encode times.
+  std::vector<int> encode_times_us_;
+  size_t next_encode_time_index_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(ComplexityController);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
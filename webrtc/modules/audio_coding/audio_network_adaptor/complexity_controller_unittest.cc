@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/complexity_controller.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kInitialComplexity = 9;
+constexpr int kMinComplexity = 5;
+constexpr int kMaxComplexity = 10;
+constexpr float kComplexityDecreasingCpuUsage = 0.02f;
+constexpr float kComplexityIncreasingCpuUsage = 0.01f;
+constexpr float kCpuUsageSmoothingFactor = 0.9f;
+constexpr int kMinFramesBetweenChanges = 10;
+constexpr int kFrameLengthMs = 20;
+// Encode times giving a CPU usage above, below and between the thresholds.
+constexpr int kHighEncodeTimeUs = 500;
+constexpr int kLowEncodeTimeUs = 100;
+constexpr int kMediumEncodeTimeUs = 300;
+
+std::unique_ptr<ComplexityController> CreateController() {
+  std::unique_ptr<ComplexityController> controller(new ComplexityController(
+      ComplexityController::Config(
+          kInitialComplexity, kMinComplexity, kMaxComplexity,
+          kComplexityDecreasingCpuUsage, kComplexityIncreasingCpuUsage,
+          kCpuUsageSmoothingFactor, kMinFramesBetweenChanges)));
+  return controller;
+}
+
+int MakeDecision(ComplexityController* controller,
+                 const rtc::Optional<int>& encode_time_us) {
+  AudioNetworkAdaptor::EncoderRuntimeConfig config;
+  Controller::NetworkMetrics metrics;
+  metrics.encode_time_us = encode_time_us;
+  if (encode_time_us)
+    metrics.encoded_audio_duration_ms = rtc::Optional<int>(kFrameLengthMs);
+  controller->MakeDecision(metrics, &config);
+  EXPECT_TRUE(config.complexity);
+  return *config.complexity;
+}
+
+void EncodeFrames(ComplexityController* controller,
+                  int num_frames,
+                  int encode_time_us) {
+  for (int i = 0; i < num_frames; ++i)
+    MakeDecision(controller, rtc::Optional<int>(encode_time_us));
+}
+
+}  // namespace
+
+TEST(ComplexityControllerTest, OutputInitValueWhenEncodeTimeUnknown) {
+  auto controller = CreateController();
+  EXPECT_EQ(kInitialComplexity,
+            MakeDecision(controller.get(), rtc::Optional<int>()));
+  EXPECT_FALSE(controller->GetStats().encode_time_50th_percentile_us);
+}
+
+TEST(ComplexityControllerTest, WaitForMinFramesBeforeChanging) {
+  auto controller = CreateController();
+  EncodeFrames(controller.get(), kMinFramesBetweenChanges - 1,
+               kHighEncodeTimeUs);
+  EXPECT_EQ(kInitialComplexity, controller->GetStats().complexity);
+  EXPECT_EQ(kInitialComplexity - 1,
+            MakeDecision(controller.get(),
+                         rtc::Optional<int>(kHighEncodeTimeUs)));
+}
+
+TEST(ComplexityControllerTest, DecreaseComplexityDownToMinForHighCpuUsage) {
+  auto controller = CreateController();
+  EncodeFrames(controller.get(),
+               kMinFramesBetweenChanges * (kInitialComplexity - kMinComplexity),
+               kHighEncodeTimeUs);
+  EXPECT_EQ(kMinComplexity, controller->GetStats().complexity);
+  EncodeFrames(controller.get(), 5 * kMinFramesBetweenChanges,
+               kHighEncodeTimeUs);
+  EXPECT_EQ(kMinComplexity, controller->GetStats().complexity);
+  EXPECT_EQ(kInitialComplexity - kMinComplexity,
+            controller->GetStats().num_complexity_changes);
+}
+
+TEST(ComplexityControllerTest, IncreaseComplexityUpToMaxForLowCpuUsage) {
+  auto controller = CreateController();
+  EncodeFrames(controller.get(), 5 * kMinFramesBetweenChanges,
+               kLowEncodeTimeUs);
+  EXPECT_EQ(kMaxComplexity, controller->GetStats().complexity);
+  EXPECT_EQ(kMaxComplexity - kInitialComplexity,
+            controller->GetStats().num_complexity_changes);
+}
+
+TEST(ComplexityControllerTest, MaintainComplexityForMediumCpuUsage) {
+  auto controller = CreateController();
+  EncodeFrames(controller.get(), 5 * kMinFramesBetweenChanges,
+               kMediumEncodeTimeUs);
+  EXPECT_EQ(kInitialComplexity, controller->GetStats().complexity);
+  EXPECT_EQ(0, controller->GetStats().num_complexity_changes);
+  ASSERT_TRUE(controller->GetStats().smoothed_cpu_usage);
+  EXPECT_FLOAT_EQ(kMediumEncodeTimeUs / (1000.f * kFrameLengthMs),
+                  *controller->GetStats().smoothed_cpu_usage);
+}
+
+TEST(ComplexityControllerTest, CheckBehaviorOnChangingCpuUsage) {
+  auto controller = CreateController();
+  EncodeFrames(controller.get(), kMinFramesBetweenChanges, kHighEncodeTimeUs);
+  EXPECT_EQ(kInitialComplexity - 1, controller->GetStats().complexity);
+  // Between the thresholds, the complexity is kept.
+  EncodeFrames(controller.get(), kMinFramesBetweenChanges, kMediumEncodeTimeUs);
+  EXPECT_EQ(kInitialComplexity - 1, controller->GetStats().complexity);
+  EncodeFrames(controller.get(), kMinFramesBetweenChanges, kLowEncodeTimeUs);
+  EXPECT_EQ(kInitialComplexity, controller->GetStats().complexity);
+}
+
+TEST(ComplexityControllerTest, ReportEncodeTimePercentiles) {
+  auto controller = CreateController();
+  // Encode times of 1, 2, ..., 100 us, repeated; only the last
+  // kEncodeTimeWindowFrames frames are taken into account.
+  for (size_t i = 0; i < 2 * ComplexityController::kEncodeTimeWindowFrames;
+       ++i) {
+    MakeDecision(controller.get(), rtc::Optional<int>(i % 100 + 1));
+  }
+  ComplexityController::Stats stats = controller->GetStats();
+  EXPECT_EQ(rtc::Optional<int>(51), stats.encode_time_50th_percentile_us);
+  EXPECT_EQ(rtc::Optional<int>(96), stats.encode_time_95th_percentile_us);
+  EXPECT_EQ(rtc::Optional<int>(100), stats.encode_time_99th_percentile_us);
+}
+
+}  // namespace webrtc
@@ -24,6 +24,11 @@ class Controller {
     rtc::Optional<int> uplink_bandwidth_bps;
     rtc::Optional<float> uplink_packet_loss_fraction;
     rtc::Optional<int> target_audio_bitrate_bps;
+    rtc::Optional<int> rtt_ms;
+    // Time spent encoding the last frame and the duration of its audio. Only
+    // set for the first decision after the frame has been reported.
+    rtc::Optional<int> encode_time_us;
+    rtc::Optional<int> encoded_audio_duration_ms;
   };
 
   struct Constraints {
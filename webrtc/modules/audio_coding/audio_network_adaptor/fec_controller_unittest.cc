@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/fec_controller.h"
+
+namespace webrtc {
+
+namespace {
+
+// The enabling threshold lies above the disabling threshold, and both go from
+// a higher packet loss at low bandwidth to a lower packet loss at high
+// bandwidth. See FecController::Config.
+constexpr int kDisablingBandwidthLow = 15000;
+constexpr float kDisablingPacketLossAtLowBw = 0.08f;
+constexpr int kDisablingBandwidthHigh = 64000;
+constexpr float kDisablingPacketLossAtHighBw = 0.01f;
+constexpr int kEnablingBandwidthLow = 17000;
+constexpr float kEnablingPacketLossAtLowBw = 0.1f;
+constexpr int kEnablingBandwidthHigh = 64000;
+constexpr float kEnablingPacketLossAtHighBw = 0.05f;
+
+// A smoothing filter that returns the last sample, so that the tests control
+// the smoothed packet loss directly.
+class FakeSmoothingFilter final : public SmoothingFilter {
+ public:
+  void AddSample(float sample) override {
+    average_ = rtc::Optional<float>(sample);
+  }
+  rtc::Optional<float> GetAverage() const override { return average_; }
+
+ private:
+  rtc::Optional<float> average_;
+};
+
+std::unique_ptr<FecController> CreateFecController(bool initial_fec_enabled) {
+  return std::unique_ptr<FecController>(new FecController(
+      FecController::Config(
+          initial_fec_enabled,
+          FecController::Config::Threshold(
+              kEnablingBandwidthLow, kEnablingPacketLossAtLowBw,
+              kEnablingBandwidthHigh, kEnablingPacketLossAtHighBw),
+          FecController::Config::Threshold(
+              kDisablingBandwidthLow, kDisablingPacketLossAtLowBw,
+              kDisablingBandwidthHigh, kDisablingPacketLossAtHighBw),
+          0, nullptr),
+      std::unique_ptr<SmoothingFilter>(new FakeSmoothingFilter())));
+}
+
+void CheckDecision(FecController* controller,
+                   const rtc::Optional<int>& uplink_bandwidth_bps,
+                   const rtc::Optional<float>& uplink_packet_loss_fraction,
+                   bool expected_enable_fec,
+                   float expected_uplink_packet_loss_fraction) {
+  Controller::NetworkMetrics metrics;
+  metrics.uplink_bandwidth_bps = uplink_bandwidth_bps;
+  metrics.uplink_packet_loss_fraction = uplink_packet_loss_fraction;
+  AudioNetworkAdaptor::EncoderRuntimeConfig config;
+  controller->MakeDecision(metrics, &config);
+  EXPECT_EQ(rtc::Optional<bool>(expected_enable_fec), config.enable_fec);
+  EXPECT_EQ(rtc::Optional<float>(expected_uplink_packet_loss_fraction),
+            config.uplink_packet_loss_fraction);
+}
+
+}  // namespace
+
+TEST(FecControllerTest, OutputInitValueWhenMetricsUnknown) {
+  for (bool initial_fec_enabled : {false, true}) {
+    auto controller = CreateFecController(initial_fec_enabled);
+    CheckDecision(controller.get(), rtc::Optional<int>(),
+                  rtc::Optional<float>(), initial_fec_enabled, 0.0f);
+  }
+}
+
+TEST(FecControllerTest, EnableFecForHighBandwidthAndPacketLoss) {
+  auto controller = CreateFecController(false);
+  CheckDecision(controller.get(), rtc::Optional<int>(kEnablingBandwidthHigh),
+                rtc::Optional<float>(kEnablingPacketLossAtHighBw), true,
+                kEnablingPacketLossAtHighBw);
+}
+
+TEST(FecControllerTest, EnableFecOnEnablingThresholdCurve) {
+  auto controller = CreateFecController(false);
+  constexpr int kBandwidth =
+      (kEnablingBandwidthLow + kEnablingBandwidthHigh) / 2;
+  constexpr float kPacketLoss =
+      (kEnablingPacketLossAtLowBw + kEnablingPacketLossAtHighBw) / 2 + 1e-4f;
+  CheckDecision(controller.get(), rtc::Optional<int>(kBandwidth),
+                rtc::Optional<float>(kPacketLoss), true, kPacketLoss);
+}
+
+TEST(FecControllerTest, MaintainFecOffBelowEnablingThresholdCurve) {
+  auto controller = CreateFecController(false);
+  constexpr int kBandwidth =
+      (kEnablingBandwidthLow + kEnablingBandwidthHigh) / 2;
+  constexpr float kPacketLoss =
+      (kEnablingPacketLossAtLowBw + kEnablingPacketLossAtHighBw) / 2 - 1e-4f;
+  CheckDecision(controller.get(), rtc::Optional<int>(kBandwidth),
+                rtc::Optional<float>(kPacketLoss), false, kPacketLoss);
+}
+
+TEST(FecControllerTest, MaintainFecOffForVeryLowBandwidth) {
+  auto controller = CreateFecController(false);
+  // Below |kEnablingBandwidthLow|, no packet loss can cause FEC to turn on.
+  CheckDecision(controller.get(), rtc::Optional<int>(kEnablingBandwidthLow - 1),
+                rtc::Optional<float>(1.0f), false, 1.0f);
+}
+
+TEST(FecControllerTest, DisableFecForLowPacketLoss) {
+  auto controller = CreateFecController(true);
+  CheckDecision(controller.get(), rtc::Optional<int>(kDisablingBandwidthHigh),
+                rtc::Optional<float>(kDisablingPacketLossAtHighBw), false,
+                kDisablingPacketLossAtHighBw);
+}
+
+TEST(FecControllerTest, MaintainFecOnAboveDisablingThresholdCurve) {
+  auto controller = CreateFecController(true);
+  CheckDecision(controller.get(), rtc::Optional<int>(kDisablingBandwidthHigh),
+                rtc::Optional<float>(kDisablingPacketLossAtHighBw + 1e-4f),
+                true, kDisablingPacketLossAtHighBw + 1e-4f);
+}
+
+TEST(FecControllerTest, DisableFecForVeryLowBandwidth) {
+  auto controller = CreateFecController(true);
+  CheckDecision(controller.get(),
+                rtc::Optional<int>(kDisablingBandwidthLow - 1),
+                rtc::Optional<float>(1.0f), false, 1.0f);
+}
+
+TEST(FecControllerTest, UsesLastKnownUplinkBandwidth) {
+  auto controller = CreateFecController(false);
+  CheckDecision(controller.get(), rtc::Optional<int>(kEnablingBandwidthHigh),
+                rtc::Optional<float>(0.0f), false, 0.0f);
+  CheckDecision(controller.get(), rtc::Optional<int>(),
+                rtc::Optional<float>(kEnablingPacketLossAtHighBw), true,
+                kEnablingPacketLossAtHighBw);
+}
+
+}  // namespace webrtc
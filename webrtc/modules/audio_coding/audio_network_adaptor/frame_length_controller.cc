@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_coding/audio_network_adaptor/frame_length_controller.h"
+
+#include <iterator>
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+FrameLengthController::Config::Config(
+    const std::set<int>& encoder_frame_lengths_ms,
+    int initial_frame_length_ms,
+    float fl_increasing_packet_loss_fraction,
+    float fl_decreasing_packet_loss_fraction,
+    int fl_increasing_bandwidth_bps,
+    int fl_decreasing_bandwidth_bps)
+    : encoder_frame_lengths_ms(encoder_frame_lengths_ms),
+      initial_frame_length_ms(initial_frame_length_ms),
+      fl_increasing_packet_loss_fraction(fl_increasing_packet_loss_fraction),
+      fl_decreasing_packet_loss_fraction(fl_decreasing_packet_loss_fraction),
+      fl_increasing_bandwidth_bps(fl_increasing_bandwidth_bps),
+      fl_decreasing_bandwidth_bps(fl_decreasing_bandwidth_bps) {}
+
+FrameLengthController::Config::Config(const Config& other) = default;
+
+FrameLengthController::Config::~Config() = default;
+
+FrameLengthController::FrameLengthController(const Config& config)
+    : config_(config), frame_lengths_ms_(config_.encoder_frame_lengths_ms) {
+  RTC_DCHECK_LT(config_.fl_increasing_bandwidth_bps,
+                config_.fl_decreasing_bandwidth_bps);
+  frame_length_ms_ = frame_lengths_ms_.find(config_.initial_frame_length_ms);
+  // |encoder_frame_lengths_ms| must contain |initial_frame_length_ms|.
+  RTC_DCHECK(frame_length_ms_ != frame_lengths_ms_.end());
+}
+
+FrameLengthController::~FrameLengthController() = default;
+
+void FrameLengthController::MakeDecision(
+    const NetworkMetrics& metrics,
+    AudioNetworkAdaptor::EncoderRuntimeConfig* config) {
+  // Decision on |frame_length_ms| should not have been made.
+  RTC_DCHECK(!config->frame_length_ms);
+
+  if (FrameLengthIncreasingDecision(metrics, *config)) {
+    ++frame_length_ms_;
+  } else if (FrameLengthDecreasingDecision(metrics, *config)) {
+    --frame_length_ms_;
+  }
+  config->frame_length_ms = rtc::Optional<int>(*frame_length_ms_);
+}
+
+void FrameLengthController::SetConstraints(const Constraints& constraints) {
+  if (!constraints.receiver_frame_length_range)
+    return;
+  const int current_frame_length_ms = *frame_length_ms_;
+  std::set<int> frame_lengths_ms;
+  for (int frame_length_ms : config_.encoder_frame_lengths_ms) {
+    if (frame_length_ms >=
+            constraints.receiver_frame_length_range->min_frame_length_ms &&
+        frame_length_ms <=
+            constraints.receiver_frame_length_range->max_frame_length_ms) {
+      frame_lengths_ms.insert(frame_length_ms);
+    }
+  }
+  if (frame_lengths_ms.empty()) {
+    // None of the frame lengths is acceptable to the receiver; keep the
+    // current one rather than leaving the encoder without a choice.
+    frame_lengths_ms.insert(current_frame_length_ms);
+  }
+  frame_lengths_ms_.swap(frame_lengths_ms);
+  // Keep the current frame length if possible, otherwise use the longest one
+  // that is not longer, or the shortest one available.
+  frame_length_ms_ = frame_lengths_ms_.upper_bound(current_frame_length_ms);
+  if (frame_length_ms_ != frame_lengths_ms_.begin())
+    --frame_length_ms_;
+}
+
+bool FrameLengthController::FrameLengthIncreasingDecision(
+    const NetworkMetrics& metrics,
+    const AudioNetworkAdaptor::EncoderRuntimeConfig& config) const {
+  // Increase frame length if
+  // 1. longer frame length is available AND
+  // 2. |uplink_bandwidth_bps| is known to be smaller than a threshold AND
+  // 3. |uplink_packet_loss_fraction| is known to be smaller than a threshold
+  //    AND
+  // 4. FEC is not decided or is OFF.
+  if (std::next(frame_length_ms_) == frame_lengths_ms_.end())
+    return false;
+
+  return metrics.uplink_bandwidth_bps &&
+         *metrics.uplink_bandwidth_bps <=
+             config_.fl_increasing_bandwidth_bps &&
+         metrics.uplink_packet_loss_fraction &&
+         *metrics.uplink_packet_loss_fraction <=
+             config_.fl_increasing_packet_loss_fraction &&
+         !config.enable_fec.value_or(false);
+}
+
+bool FrameLengthController::FrameLengthDecreasingDecision(
+    const NetworkMetrics& metrics,
+    const AudioNetworkAdaptor::EncoderRuntimeConfig& config) const {
+  // Decrease frame length if
+  // 1. shorter frame length is available AND one or more of the followings:
+  // 2. |uplink_bandwidth_bps| is known to be larger than a threshold,
+  // 3. |uplink_packet_loss_fraction| is known to be larger than a threshold,
+  // 4. FEC is decided ON.
+  if (frame_length_ms_ == frame_lengths_ms_.begin())
+    return false;
+
+  return (metrics.uplink_bandwidth_bps &&
+          *metrics.uplink_bandwidth_bps >=
+              config_.fl_decreasing_bandwidth_bps) ||
+         (metrics.uplink_packet_loss_fraction &&
+          *metrics.uplink_packet_loss_fraction >=
+              config_.fl_decreasing_packet_loss_fraction) ||
+         config.enable_fec.value_or(false);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_FRAME_LENGTH_CONTROLLER_H_
+#define WEBRTC_MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_FRAME_LENGTH_CONTROLLER_H_
+
+#include <set>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/controller.h"
+
+namespace webrtc {
+
+// Chooses between the frame lengths supported by the encoder. Longer frames
+// reduce the packet rate, and thereby the packet overhead, on links with a low
+// bandwidth. Shorter frames are preferred when the bandwidth allows, when the
+// packet loss is high, or when FEC is on.
+class FrameLengthController final : public Controller {
+ public:
+  struct Config {
+    Config(const std::set<int>& encoder_frame_lengths_ms,
+           int initial_frame_length_ms,
+           float fl_increasing_packet_loss_fraction,
+           float fl_decreasing_packet_loss_fraction,
+           int fl_increasing_bandwidth_bps,
+           int fl_decreasing_bandwidth_bps);
+    Config(const Config& other);
+    ~Config();
+    std::set<int> encoder_frame_lengths_ms;
+    int initial_frame_length_ms;
+    // Uplink packet loss fraction below which the frame length may increase.
+    float fl_increasing_packet_loss_fraction;
+    // Uplink packet loss fraction above which the frame length should
+    // decrease.
+    float fl_decreasing_packet_loss_fraction;
+    // Uplink bandwidth below which the frame length may increase.
+    int fl_increasing_bandwidth_bps;
+    // Uplink bandwidth above which the frame length should decrease.
+    int fl_decreasing_bandwidth_bps;
+  };
+
+  explicit FrameLengthController(const Config& config);
+
+  ~FrameLengthController() override;
+
+  void MakeDecision(const NetworkMetrics& metrics,
+                    AudioNetworkAdaptor::EncoderRuntimeConfig* config) override;
+
+  void SetConstraints(const Constraints& constraints) override;
+
+ private:
+  bool FrameLengthIncreasingDecision(
+      const NetworkMetrics& metrics,
+      const AudioNetworkAdaptor::EncoderRuntimeConfig& config) const;
+
+  bool FrameLengthDecreasingDecision(
+      const NetworkMetrics& metrics,
+      const AudioNetworkAdaptor::EncoderRuntimeConfig& config) const;
+
+  const Config config_;
+
+  // The frame lengths that are allowed by both the encoder and the receiver.
+  std::set<int> frame_lengths_ms_;
+
+  std::set<int>::const_iterator frame_length_ms_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(FrameLengthController);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_FRAME_LENGTH_CONTROLLER_H_
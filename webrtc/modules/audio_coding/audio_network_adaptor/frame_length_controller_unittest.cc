@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/frame_length_controller.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr float kFlIncreasingPacketLossFraction = 0.04f;
+constexpr float kFlDecreasingPacketLossFraction = 0.05f;
+constexpr int kFlIncreasingBandwidthBps = 40000;
+constexpr int kFlDecreasingBandwidthBps = 50000;
+constexpr int kMediumBandwidthBps =
+    (kFlIncreasingBandwidthBps + kFlDecreasingBandwidthBps) / 2;
+constexpr float kMediumPacketLossFraction =
+    (kFlIncreasingPacketLossFraction + kFlDecreasingPacketLossFraction) / 2;
+
+std::unique_ptr<FrameLengthController> CreateController(
+    const std::set<int>& encoder_frame_lengths_ms,
+    int initial_frame_length_ms) {
+  std::unique_ptr<FrameLengthController> controller(
+      new FrameLengthController(FrameLengthController::Config(
+          encoder_frame_lengths_ms, initial_frame_length_ms,
+          kFlIncreasingPacketLossFraction, kFlDecreasingPacketLossFraction,
+          kFlIncreasingBandwidthBps, kFlDecreasingBandwidthBps)));
+  return controller;
+}
+
+void CheckDecision(FrameLengthController* controller,
+                   const rtc::Optional<int>& uplink_bandwidth_bps,
+                   const rtc::Optional<float>& uplink_packet_loss_fraction,
+                   const rtc::Optional<bool>& enable_fec,
+                   int expected_frame_length_ms) {
+  Controller::NetworkMetrics metrics;
+  metrics.uplink_bandwidth_bps = uplink_bandwidth_bps;
+  metrics.uplink_packet_loss_fraction = uplink_packet_loss_fraction;
+  AudioNetworkAdaptor::EncoderRuntimeConfig config;
+  config.enable_fec = enable_fec;
+  controller->MakeDecision(metrics, &config);
+  EXPECT_EQ(rtc::Optional<int>(expected_frame_length_ms),
+            config.frame_length_ms);
+}
+
+}  // namespace
+
+TEST(FrameLengthControllerTest, OutputInitValueWhenMetricsUnknown) {
+  auto controller = CreateController({20, 60}, 60);
+  CheckDecision(controller.get(), rtc::Optional<int>(), rtc::Optional<float>(),
+                rtc::Optional<bool>(), 60);
+}
+
+TEST(FrameLengthControllerTest, IncreaseTo60MsOnLowBandwidthAndLowLoss) {
+  auto controller = CreateController({20, 60}, 20);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlIncreasingBandwidthBps),
+                rtc::Optional<float>(kFlIncreasingPacketLossFraction),
+                rtc::Optional<bool>(), 60);
+}
+
+TEST(FrameLengthControllerTest, Maintain20MsWhenPacketLossUnknown) {
+  auto controller = CreateController({20, 60}, 20);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlIncreasingBandwidthBps),
+                rtc::Optional<float>(), rtc::Optional<bool>(), 20);
+}
+
+TEST(FrameLengthControllerTest, Maintain20MsWhenFecIsOn) {
+  auto controller = CreateController({20, 60}, 20);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlIncreasingBandwidthBps),
+                rtc::Optional<float>(kFlIncreasingPacketLossFraction),
+                rtc::Optional<bool>(true), 20);
+}
+
+TEST(FrameLengthControllerTest, Maintain20MsOnMediumBandwidth) {
+  auto controller = CreateController({20, 60}, 20);
+  CheckDecision(controller.get(), rtc::Optional<int>(kMediumBandwidthBps),
+                rtc::Optional<float>(kFlIncreasingPacketLossFraction),
+                rtc::Optional<bool>(), 20);
+}
+
+TEST(FrameLengthControllerTest, Maintain60MsOnMediumBandwidthAndLoss) {
+  auto controller = CreateController({20, 60}, 60);
+  CheckDecision(controller.get(), rtc::Optional<int>(kMediumBandwidthBps),
+                rtc::Optional<float>(kMediumPacketLossFraction),
+                rtc::Optional<bool>(false), 60);
+}
+
+TEST(FrameLengthControllerTest, DecreaseTo20MsOnHighBandwidth) {
+  auto controller = CreateController({20, 60}, 60);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlDecreasingBandwidthBps),
+                rtc::Optional<float>(), rtc::Optional<bool>(), 20);
+}
+
+TEST(FrameLengthControllerTest, DecreaseTo20MsOnHighPacketLoss) {
+  auto controller = CreateController({20, 60}, 60);
+  CheckDecision(controller.get(), rtc::Optional<int>(kMediumBandwidthBps),
+                rtc::Optional<float>(kFlDecreasingPacketLossFraction),
+                rtc::Optional<bool>(), 20);
+}
+
+TEST(FrameLengthControllerTest, DecreaseTo20MsWhenFecIsOn) {
+  auto controller = CreateController({20, 60}, 60);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlIncreasingBandwidthBps),
+                rtc::Optional<float>(kFlIncreasingPacketLossFraction),
+                rtc::Optional<bool>(true), 20);
+}
+
+TEST(FrameLengthControllerTest, StepsThroughFrameLengthsOneAtATime) {
+  auto controller = CreateController({20, 40, 60}, 20);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlIncreasingBandwidthBps),
+                rtc::Optional<float>(0.0f), rtc::Optional<bool>(), 40);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlIncreasingBandwidthBps),
+                rtc::Optional<float>(0.0f), rtc::Optional<bool>(), 60);
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlDecreasingBandwidthBps),
+                rtc::Optional<float>(0.0f), rtc::Optional<bool>(), 40);
+}
+
+TEST(FrameLengthControllerTest, RespectsReceiverFrameLengthRange) {
+  auto controller = CreateController({20, 60}, 60);
+  Controller::Constraints constraints;
+  constraints.receiver_frame_length_range =
+      rtc::Optional<Controller::Constraints::FrameLengthRange>(
+          Controller::Constraints::FrameLengthRange(10, 40));
+  controller->SetConstraints(constraints);
+  // 60 ms is no longer allowed, so the controller falls back to 20 ms and
+  // stays there.
+  CheckDecision(controller.get(), rtc::Optional<int>(kFlIncreasingBandwidthBps),
+                rtc::Optional<float>(0.0f), rtc::Optional<bool>(), 20);
+}
+
+}  // namespace webrtc
@@ -34,6 +34,9 @@ class AudioNetworkAdaptor {
     // better use of the bandwidth. |num_channels| sets the number of channels
     // to encode.
     rtc::Optional<size_t> num_channels;
+
+    // Encoder complexity, in the range of the encoder, e.g. 0-10 for Opus.
+    rtc::Optional<int> complexity;
   };
 
   virtual ~AudioNetworkAdaptor() = default;
@@ -43,9 +46,21 @@ class AudioNetworkAdaptor {
   virtual void SetUplinkPacketLossFraction(
       float uplink_packet_loss_fraction) = 0;
 
+  // Sets the bitrate the audio encoder should target, e.g. as allocated from
+  // the send-side bandwidth estimate.
+  virtual void SetTargetAudioBitrate(int target_audio_bitrate_bps) = 0;
+
+  virtual void SetRtt(int rtt_ms) = 0;
+
   virtual void SetReceiverFrameLengthRange(int min_frame_length_ms,
                                            int max_frame_length_ms) = 0;
 
+  // Reports the time spent encoding the last frame, which carried
+  // |encoded_audio_duration_ms| of audio. It is only taken into account by the
+  // next call to GetEncoderRuntimeConfig().
+  virtual void SetEncodeTime(int encode_time_us,
+                             int encoded_audio_duration_ms) = 0;
+
   virtual EncoderRuntimeConfig GetEncoderRuntimeConfig() = 0;
 
   virtual void StartDebugDump(FILE* file_handle) = 0;
@@ -64,6 +64,16 @@ void AudioEncoder::SetProjectedPacketLossRate(double fraction) {}
 
 void AudioEncoder::SetTargetBitrate(int target_bps) {}
 
+bool AudioEncoder::EnableAudioNetworkAdaptor() {
+  return false;
+}
+
+void AudioEncoder::DisableAudioNetworkAdaptor() {}
+
+void AudioEncoder::OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) {}
+
+void AudioEncoder::OnReceivedRtt(int rtt_ms) {}
+
 rtc::ArrayView<std::unique_ptr<AudioEncoder>>
 AudioEncoder::ReclaimContainedEncoders() { return nullptr; }
 
@@ -153,6 +153,24 @@ class AudioEncoder {
   // implementation does the latter).
   virtual void SetTargetBitrate(int target_bps);
 
+  // Enables the audio network adaptor, which from then on chooses the encoder
+  // settings (bitrate, frame length, FEC, etc.) from the network metrics
+  // reported to the encoder. Returns true if the codec supports it. The
+  // default implementation just returns false.
+  virtual bool EnableAudioNetworkAdaptor();
+
+  // Disables the audio network adaptor. The default implementation does
+  // nothing.
+  virtual void DisableAudioNetworkAdaptor();
+
+  // Provides the send-side estimate of the uplink bandwidth. The default
+  // implementation does nothing.
+  virtual void OnReceivedUplinkBandwidth(int uplink_bandwidth_bps);
+
+  // Provides the round-trip time of the send path. The default implementation
+  // does nothing.
+  virtual void OnReceivedRtt(int rtt_ms);
+
   // Causes this encoder to let go of any other encoders it contains, and
   // returns a pointer to an array where they are stored (which is required to
   // live as long as this encoder). Unless the returned array is empty, you may
@@ -187,6 +187,22 @@ void AudioEncoderCng::SetTargetBitrate(int bits_per_second) {
   speech_encoder_->SetTargetBitrate(bits_per_second);
 }
 
+bool AudioEncoderCng::EnableAudioNetworkAdaptor() {
+  return speech_encoder_->EnableAudioNetworkAdaptor();
+}
+
+void AudioEncoderCng::DisableAudioNetworkAdaptor() {
+  speech_encoder_->DisableAudioNetworkAdaptor();
+}
+
+void AudioEncoderCng::OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) {
+  speech_encoder_->OnReceivedUplinkBandwidth(uplink_bandwidth_bps);
+}
+
+void AudioEncoderCng::OnReceivedRtt(int rtt_ms) {
+  speech_encoder_->OnReceivedRtt(rtt_ms);
+}
+
 rtc::ArrayView<std::unique_ptr<AudioEncoder>>
 AudioEncoderCng::ReclaimContainedEncoders() {
   return rtc::ArrayView<std::unique_ptr<AudioEncoder>>(&speech_encoder_, 1);
@@ -63,6 +63,10 @@ class AudioEncoderCng final : public AudioEncoder {
   void SetMaxPlaybackRate(int frequency_hz) override;
   void SetProjectedPacketLossRate(double fraction) override;
   void SetTargetBitrate(int target_bps) override;
+  bool EnableAudioNetworkAdaptor() override;
+  void DisableAudioNetworkAdaptor() override;
+  void OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) override;
+  void OnReceivedRtt(int rtt_ms) override;
   rtc::ArrayView<std::unique_ptr<AudioEncoder>> ReclaimContainedEncoders()
       override;
 
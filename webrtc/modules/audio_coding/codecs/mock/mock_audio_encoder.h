@@ -42,6 +42,10 @@ class MockAudioEncoder : public AudioEncoder {
   MOCK_METHOD1(SetMaxPlaybackRate, void(int frequency_hz));
   MOCK_METHOD1(SetProjectedPacketLossRate, void(double fraction));
   MOCK_METHOD1(SetTargetBitrate, void(int target_bps));
+  MOCK_METHOD0(EnableAudioNetworkAdaptor, bool());
+  MOCK_METHOD0(DisableAudioNetworkAdaptor, void());
+  MOCK_METHOD1(OnReceivedUplinkBandwidth, void(int uplink_bandwidth_bps));
+  MOCK_METHOD1(OnReceivedRtt, void(int rtt_ms));
   MOCK_METHOD1(SetMaxBitrate, void(int max_bps));
   MOCK_METHOD1(SetMaxPayloadSize, void(int max_payload_size_bytes));
 
@@ -11,11 +11,21 @@
 #include "webrtc/modules/audio_coding/codecs/opus/audio_encoder_opus.h"
 
 #include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/safe_conversions.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/audio_network_adaptor_impl.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/bitrate_controller.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/controller_manager.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/fec_controller.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/frame_length_controller.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
+#include "webrtc/system_wrappers/include/clock.h"
 
 namespace webrtc {
 
@@ -76,6 +86,38 @@ double OptimizePacketLossRate(double new_loss_rate, double old_loss_rate) {
   }
 }
 
+// Creates the audio network adaptor used by Opus. FEC is switched on when the
+// packet loss is high compared to the bandwidth. On links with a low bandwidth
+// and a low packet loss, 60 ms frames are used, which cut the packet rate and
+// with it the packet overhead to a third of that with 20 ms frames.
+std::unique_ptr<AudioNetworkAdaptor> CreateAudioNetworkAdaptor(
+    const AudioEncoderOpus::Config& config) {
+  // The controllers are consulted in this order. The frame length depends on
+  // the FEC decision, and the bitrate on the frame length.
+  std::vector<std::unique_ptr<Controller>> controllers;
+  controllers.push_back(std::unique_ptr<Controller>(new FecController(
+      FecController::Config(
+          config.fec_enabled,
+          FecController::Config::Threshold(17000, 0.1f, 64000, 0.05f),
+          FecController::Config::Threshold(15000, 0.08f, 64000, 0.01f),
+          10000, Clock::GetRealTimeClock()))));
+  controllers.push_back(
+      std::unique_ptr<Controller>(new FrameLengthController(
+          FrameLengthController::Config(
+              std::set<int>({20, 60, config.frame_size_ms}),
+              config.frame_size_ms, 0.04f, 0.05f, 40000, 50000))));
+  controllers.push_back(std::unique_ptr<Controller>(new BitrateController(
+      BitrateController::Config(config.GetBitrateBps(),
+                                config.frame_size_ms))));
+  return std::unique_ptr<AudioNetworkAdaptor>(new AudioNetworkAdaptorImpl(
+      AudioNetworkAdaptorImpl::Config(),
+      std::unique_ptr<ControllerManager>(new ControllerManagerImpl(
+          ControllerManagerImpl::Config(), std::move(controllers)))));
+}
+
+// Longest frame length that the audio network adaptor may choose.
+constexpr int kAudioNetworkAdaptorMaxFrameLengthMs = 60;
+
 }  // namespace
 
 AudioEncoderOpus::Config::Config() = default;
@@ -105,7 +147,10 @@ int AudioEncoderOpus::Config::GetBitrateBps() const {
 }
 
 AudioEncoderOpus::AudioEncoderOpus(const Config& config)
-    : packet_loss_rate_(0.0), inst_(nullptr) {
+    : packet_loss_rate_(0.0),
+      inst_(nullptr),
+      last_encode_time_us_(0),
+      next_frame_length_ms_(config.frame_size_ms) {
   RTC_CHECK(RecreateEncoderInstance(config));
 }
 
@@ -129,6 +174,11 @@ size_t AudioEncoderOpus::Num10MsFramesInNextPacket() const {
 }
 
 size_t AudioEncoderOpus::Max10MsFramesInAPacket() const {
+  if (audio_network_adaptor_) {
+    return static_cast<size_t>(
+        std::max(config_.frame_size_ms, kAudioNetworkAdaptorMaxFrameLengthMs) /
+        10);
+  }
   return Num10msFramesPerPacket();
 }
 
@@ -176,6 +226,50 @@ void AudioEncoderOpus::SetMaxPlaybackRate(int frequency_hz) {
 }
 
 void AudioEncoderOpus::SetProjectedPacketLossRate(double fraction) {
+  if (audio_network_adaptor_) {
+    audio_network_adaptor_->SetUplinkPacketLossFraction(fraction);
+    ApplyAudioNetworkAdaptor();
+    return;
+  }
+  SetPacketLossRate(fraction);
+}
+
+void AudioEncoderOpus::SetTargetBitrate(int bits_per_second) {
+  if (audio_network_adaptor_) {
+    audio_network_adaptor_->SetTargetAudioBitrate(bits_per_second);
+    ApplyAudioNetworkAdaptor();
+    return;
+  }
+  SetBitrate(bits_per_second);
+}
+
+bool AudioEncoderOpus::EnableAudioNetworkAdaptor() {
+  if (!audio_network_adaptor_) {
+    audio_network_adaptor_ = CreateAudioNetworkAdaptor(config_);
+    ApplyAudioNetworkAdaptor();
+  }
+  return true;
+}
+
+void AudioEncoderOpus::DisableAudioNetworkAdaptor() {
+  audio_network_adaptor_.reset();
+}
+
+void AudioEncoderOpus::OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) {
+  if (audio_network_adaptor_) {
+    audio_network_adaptor_->SetUplinkBandwidth(uplink_bandwidth_bps);
+    ApplyAudioNetworkAdaptor();
+  }
+}
+
+void AudioEncoderOpus::OnReceivedRtt(int rtt_ms) {
+  if (audio_network_adaptor_) {
+    audio_network_adaptor_->SetRtt(rtt_ms);
+    ApplyAudioNetworkAdaptor();
+  }
+}
+
+void AudioEncoderOpus::SetPacketLossRate(double fraction) {
   double opt_loss_rate = OptimizePacketLossRate(fraction, packet_loss_rate_);
   if (packet_loss_rate_ != opt_loss_rate) {
     packet_loss_rate_ = opt_loss_rate;
@@ -185,13 +279,23 @@ void AudioEncoderOpus::SetProjectedPacketLossRate(double fraction) {
   }
 }
 
-void AudioEncoderOpus::SetTargetBitrate(int bits_per_second) {
+void AudioEncoderOpus::SetBitrate(int bits_per_second) {
   config_.bitrate_bps = rtc::Optional<int>(
       std::max(std::min(bits_per_second, kMaxBitrateBps), kMinBitrateBps));
   RTC_DCHECK(config_.IsOk());
   RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst_, config_.GetBitrateBps()));
 }
 
+bool AudioEncoderOpus::SetComplexity(int complexity) {
+  auto conf = config_;
+  conf.complexity = complexity;
+  if (!conf.IsOk())
+    return false;
+  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, complexity));
+  config_ = conf;
+  return true;
+}
+
 AudioEncoder::EncodedInfo AudioEncoderOpus::EncodeImpl(
     uint32_t rtp_timestamp,
     rtc::ArrayView<const int16_t> audio,
@@ -213,12 +317,15 @@ AudioEncoder::EncodedInfo AudioEncoderOpus::EncodeImpl(
   info.encoded_bytes =
       encoded->AppendData(
           max_encoded_bytes, [&] (rtc::ArrayView<uint8_t> encoded) {
+            const uint64_t start_time_us = rtc::TimeMicros();
             int status = WebRtcOpus_Encode(
                 inst_, &input_buffer_[0],
                 rtc::CheckedDivExact(input_buffer_.size(),
                                      config_.num_channels),
                 rtc::saturated_cast<int16_t>(max_encoded_bytes),
                 encoded.data());
+            last_encode_time_us_ = rtc::saturated_cast<int>(
+                rtc::TimeMicros() - start_time_us);
 
             RTC_CHECK_GE(status, 0);  // Fails only if fed invalid data.
 
@@ -226,6 +333,14 @@ AudioEncoder::EncodedInfo AudioEncoderOpus::EncodeImpl(
           });
   input_buffer_.clear();
 
+  if (audio_network_adaptor_) {
+    audio_network_adaptor_->SetEncodeTime(last_encode_time_us_,
+                                          config_.frame_size_ms);
+    ApplyAudioNetworkAdaptor();
+  }
+  // A new frame length only takes effect at the start of a packet.
+  config_.frame_size_ms = next_frame_length_ms_;
+
   info.encoded_timestamp = first_timestamp_in_buffer_;
   info.payload_type = config_.payload_type;
   info.send_even_if_empty = true;  // Allows Opus to send empty packets.
@@ -252,6 +367,29 @@ size_t AudioEncoderOpus::SufficientOutputBufferSize() const {
   return 2 * approx_encoded_bytes;
 }
 
+void AudioEncoderOpus::ApplyAudioNetworkAdaptor() {
+  const auto config = audio_network_adaptor_->GetEncoderRuntimeConfig();
+  if (config.bitrate_bps)
+    SetBitrate(*config.bitrate_bps);
+  if (config.uplink_packet_loss_fraction)
+    SetPacketLossRate(*config.uplink_packet_loss_fraction);
+  if (config.enable_fec && *config.enable_fec != config_.fec_enabled) {
+    // Toggle FEC without recreating the encoder, which would drop the audio
+    // that is buffered for the current packet.
+    if (*config.enable_fec) {
+      RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
+    } else {
+      RTC_CHECK_EQ(0, WebRtcOpus_DisableFec(inst_));
+    }
+    config_.fec_enabled = *config.enable_fec;
+  }
+  if (config.frame_length_ms) {
+    next_frame_length_ms_ = *config.frame_length_ms;
+    if (input_buffer_.empty())
+      config_.frame_size_ms = next_frame_length_ms_;
+  }
+}
+
 // If the given config is OK, recreate the Opus encoder instance with those
 // settings, save the config, and return true. Otherwise, do nothing and return
 // false.
@@ -282,6 +420,7 @@ bool AudioEncoderOpus::RecreateEncoderInstance(const Config& config) {
                WebRtcOpus_SetPacketLossRate(
                    inst_, static_cast<int32_t>(packet_loss_rate_ * 100 + .5)));
   config_ = config;
+  next_frame_length_ms_ = config_.frame_size_ms;
   return true;
 }
 
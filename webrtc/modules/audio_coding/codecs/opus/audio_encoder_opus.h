@@ -11,10 +11,12 @@
 #ifndef WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_AUDIO_ENCODER_OPUS_H_
 #define WEBRTC_MODULES_AUDIO_CODING_CODECS_OPUS_AUDIO_ENCODER_OPUS_H_
 
+#include <memory>
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/optional.h"
+#include "webrtc/modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "webrtc/modules/audio_coding/codecs/opus/opus_interface.h"
 #include "webrtc/modules/audio_coding/codecs/audio_encoder.h"
 
@@ -82,9 +84,27 @@ class AudioEncoderOpus final : public AudioEncoder {
   void SetProjectedPacketLossRate(double fraction) override;
   void SetTargetBitrate(int target_bps) override;
 
+  // With the audio network adaptor enabled, the packet loss rate, the target
+  // bitrate, the uplink bandwidth and the RTT are passed to the adaptor, which
+  // decides the bitrate, the frame length and FEC.
+  bool EnableAudioNetworkAdaptor() override;
+  void DisableAudioNetworkAdaptor() override;
+  void OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) override;
+  void OnReceivedRtt(int rtt_ms) override;
+
+  // Changes the complexity of the running encoder. Returns false, and keeps
+  // the current complexity, if |complexity| is out of range.
+  bool SetComplexity(int complexity);
+
+  // Returns the time spent in the Opus encoder for the last packet, e.g. to be
+  // reported to an AudioNetworkAdaptor which adapts the complexity.
+  int last_encode_time_us() const { return last_encode_time_us_; }
+
   // Getters for testing.
   double packet_loss_rate() const { return packet_loss_rate_; }
   ApplicationMode application() const { return config_.application; }
+  int complexity() const { return config_.complexity; }
+  bool fec_enabled() const { return config_.fec_enabled; }
 
  protected:
   EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
@@ -96,12 +116,20 @@ class AudioEncoderOpus final : public AudioEncoder {
   size_t SamplesPer10msFrame() const;
   size_t SufficientOutputBufferSize() const;
   bool RecreateEncoderInstance(const Config& config);
+  void SetBitrate(int bits_per_second);
+  void SetPacketLossRate(double fraction);
+  void ApplyAudioNetworkAdaptor();
 
   Config config_;
   double packet_loss_rate_;
   std::vector<int16_t> input_buffer_;
   OpusEncInst* inst_;
   uint32_t first_timestamp_in_buffer_;
+  int last_encode_time_us_;
+  std::unique_ptr<AudioNetworkAdaptor> audio_network_adaptor_;
+  // Frame length decided by the audio network adaptor. Takes effect when the
+  // next packet is started.
+  int next_frame_length_ms_;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioEncoderOpus);
 };
 
@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/audio_coding/codecs/opus/audio_encoder_opus.h"
@@ -77,6 +78,17 @@ TEST_F(AudioEncoderOpusTest, ToggleDtx) {
   EXPECT_TRUE(encoder_->SetDtx(false));
 }
 
+TEST_F(AudioEncoderOpusTest, SetComplexity) {
+  CreateCodec(1);
+  EXPECT_TRUE(encoder_->SetComplexity(3));
+  EXPECT_EQ(3, encoder_->complexity());
+  EXPECT_FALSE(encoder_->SetComplexity(11));
+  EXPECT_EQ(3, encoder_->complexity());
+  // The complexity is kept on reset.
+  encoder_->Reset();
+  EXPECT_EQ(3, encoder_->complexity());
+}
+
 TEST_F(AudioEncoderOpusTest, SetBitrate) {
   CreateCodec(1);
   // Constants are replicated from audio_encoder_opus.cc.
@@ -150,4 +162,52 @@ TEST_F(AudioEncoderOpusTest, PacketLossRateOptimized) {
   // clang-format on
 }
 
+TEST_F(AudioEncoderOpusTest, AudioNetworkAdaptorChangesFrameLength) {
+  CreateCodec(1);
+  EXPECT_TRUE(encoder_->EnableAudioNetworkAdaptor());
+  EXPECT_EQ(2u, encoder_->Num10MsFramesInNextPacket());
+  EXPECT_EQ(6u, encoder_->Max10MsFramesInAPacket());
+
+  // Low bandwidth and no packet loss switch to 60 ms frames.
+  encoder_->OnReceivedUplinkBandwidth(30000);
+  encoder_->SetProjectedPacketLossRate(0.0);
+  EXPECT_EQ(6u, encoder_->Num10MsFramesInNextPacket());
+
+  // Start a packet. A higher bandwidth does not change the frame length
+  // until the packet is complete.
+  const int16_t kAudio[480] = {0};
+  rtc::Buffer encoded;
+  uint32_t rtp_timestamp = 0;
+  encoder_->Encode(rtp_timestamp, kAudio, &encoded);
+  rtp_timestamp += 480;
+  encoder_->OnReceivedUplinkBandwidth(60000);
+  EXPECT_EQ(6u, encoder_->Num10MsFramesInNextPacket());
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(0u, encoded.size());
+    encoder_->Encode(rtp_timestamp, kAudio, &encoded);
+    rtp_timestamp += 480;
+  }
+  EXPECT_GT(encoded.size(), 0u);
+  EXPECT_EQ(2u, encoder_->Num10MsFramesInNextPacket());
+
+  encoder_->DisableAudioNetworkAdaptor();
+  EXPECT_EQ(2u, encoder_->Max10MsFramesInAPacket());
+}
+
+TEST_F(AudioEncoderOpusTest, AudioNetworkAdaptorEnablesFec) {
+  CreateCodec(1);
+  EXPECT_TRUE(encoder_->EnableAudioNetworkAdaptor());
+  encoder_->OnReceivedUplinkBandwidth(64000);
+  EXPECT_FALSE(encoder_->fec_enabled());
+  encoder_->SetProjectedPacketLossRate(0.2);
+  EXPECT_TRUE(encoder_->fec_enabled());
+}
+
+TEST_F(AudioEncoderOpusTest, AudioNetworkAdaptorSetsBitrate) {
+  CreateCodec(1);
+  EXPECT_TRUE(encoder_->EnableAudioNetworkAdaptor());
+  encoder_->SetTargetBitrate(20000);
+  EXPECT_EQ(20000, encoder_->GetTargetBitrate());
+}
+
 }  // namespace webrtc
@@ -12,20 +12,39 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <utility>
 
 #include "webrtc/base/checks.h"
 
 namespace webrtc {
 
+namespace {
+
+// RFC 2198 limits the timestamp offset of a redundant block to 14 bits and
+// its length to 10 bits.
+const uint32_t kMaxRedTimestampOffset = (1 << 14) - 1;
+const size_t kMaxRedBlockLength = (1 << 10) - 1;
+
+// One more earlier encoding is carried for each step of this much projected
+// packet loss.
+const double kPacketLossRatePerRedundantEncoding = 0.1;
+
+}  // namespace
+
 AudioEncoderCopyRed::Config::Config() = default;
 AudioEncoderCopyRed::Config::Config(Config&&) = default;
 AudioEncoderCopyRed::Config::~Config() = default;
 
 AudioEncoderCopyRed::AudioEncoderCopyRed(Config&& config)
     : speech_encoder_(std::move(config.speech_encoder)),
-      red_payload_type_(config.payload_type) {
+      red_payload_type_(config.payload_type),
+      max_redundant_encodings_(config.max_redundant_encodings),
+      redundancy_distance_(config.redundancy_distance),
+      num_redundant_encodings_(std::min<size_t>(1, max_redundant_encodings_)),
+      past_encodings_(max_redundant_encodings_ * redundancy_distance_) {
   RTC_CHECK(speech_encoder_) << "Speech encoder not provided.";
+  RTC_CHECK_GT(redundancy_distance_, 0u);
 }
 
 AudioEncoderCopyRed::~AudioEncoderCopyRed() = default;
@@ -72,15 +91,31 @@ AudioEncoder::EncodedInfo AudioEncoderCopyRed::EncodeImpl(
     // intentional.
     info.redundant.push_back(info);
     RTC_DCHECK_EQ(info.redundant.size(), 1u);
-    if (secondary_info_.encoded_bytes > 0) {
-      encoded->AppendData(secondary_encoded_);
-      info.redundant.push_back(secondary_info_);
-      RTC_DCHECK_EQ(info.redundant.size(), 2u);
+    const size_t num_past_encodings = past_encodings_.size();
+    for (size_t i = 1; i <= num_redundant_encodings_; ++i) {
+      const PastEncoding& past =
+          past_encodings_[(next_past_encoding_ + num_past_encodings -
+                           i * redundancy_distance_) %
+                          num_past_encodings];
+      // Older encodings are missing or too old as well.
+      if (past.info.encoded_bytes == 0 ||
+          info.encoded_timestamp - past.info.encoded_timestamp >
+              kMaxRedTimestampOffset) {
+        break;
+      }
+      if (past.info.encoded_bytes > kMaxRedBlockLength)
+        continue;
+      encoded->AppendData(past.encoded);
+      info.redundant.push_back(past.info);
     }
-    // Save primary to secondary.
-    secondary_encoded_.SetData(encoded->data() + primary_offset,
+    if (num_past_encodings > 0) {
+      // Save primary for the packets to come.
+      PastEncoding* primary = &past_encodings_[next_past_encoding_];
+      primary->encoded.SetData(encoded->data() + primary_offset,
                                info.encoded_bytes);
-    secondary_info_ = info;
+      primary->info = info;
+      next_past_encoding_ = (next_past_encoding_ + 1) % num_past_encodings;
+    }
     RTC_DCHECK_EQ(info.speech, info.redundant[0].speech);
   }
   // Update main EncodedInfo.
@@ -95,8 +130,11 @@ AudioEncoder::EncodedInfo AudioEncoderCopyRed::EncodeImpl(
 
 void AudioEncoderCopyRed::Reset() {
   speech_encoder_->Reset();
-  secondary_encoded_.Clear();
-  secondary_info_.encoded_bytes = 0;
+  for (PastEncoding& past : past_encodings_) {
+    past.encoded.Clear();
+    past.info.encoded_bytes = 0;
+  }
+  next_past_encoding_ = 0;
 }
 
 bool AudioEncoderCopyRed::SetFec(bool enable) {
@@ -117,12 +155,32 @@ void AudioEncoderCopyRed::SetMaxPlaybackRate(int frequency_hz) {
 
 void AudioEncoderCopyRed::SetProjectedPacketLossRate(double fraction) {
   speech_encoder_->SetProjectedPacketLossRate(fraction);
+  // Always carry at least one earlier encoding, as before.
+  const size_t wanted = 1 + static_cast<size_t>(
+      std::max(fraction, 0.0) / kPacketLossRatePerRedundantEncoding);
+  num_redundant_encodings_ = std::min(wanted, max_redundant_encodings_);
 }
 
 void AudioEncoderCopyRed::SetTargetBitrate(int bits_per_second) {
   speech_encoder_->SetTargetBitrate(bits_per_second);
 }
 
+bool AudioEncoderCopyRed::EnableAudioNetworkAdaptor() {
+  return speech_encoder_->EnableAudioNetworkAdaptor();
+}
+
+void AudioEncoderCopyRed::DisableAudioNetworkAdaptor() {
+  speech_encoder_->DisableAudioNetworkAdaptor();
+}
+
+void AudioEncoderCopyRed::OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) {
+  speech_encoder_->OnReceivedUplinkBandwidth(uplink_bandwidth_bps);
+}
+
+void AudioEncoderCopyRed::OnReceivedRtt(int rtt_ms) {
+  speech_encoder_->OnReceivedRtt(rtt_ms);
+}
+
 rtc::ArrayView<std::unique_ptr<AudioEncoder>>
 AudioEncoderCopyRed::ReclaimContainedEncoders() {
   return rtc::ArrayView<std::unique_ptr<AudioEncoder>>(&speech_encoder_, 1);
@@ -22,8 +22,10 @@ namespace webrtc {
 
 // This class implements redundant audio coding. The class object will have an
 // underlying AudioEncoder object that performs the actual encodings. The
-// current class will gather the two latest encodings from the underlying codec
-// into one packet.
+// current class will gather the latest encoding from the underlying codec and
+// up to |max_redundant_encodings| earlier ones into one packet, the most
+// recent first. The number of earlier encodings grows with the projected
+// packet loss rate.
 class AudioEncoderCopyRed final : public AudioEncoder {
  public:
   struct Config {
@@ -32,6 +34,12 @@ class AudioEncoderCopyRed final : public AudioEncoder {
     ~Config();
     int payload_type;
     std::unique_ptr<AudioEncoder> speech_encoder;
+    // The maximum number of earlier encodings in each packet.
+    size_t max_redundant_encodings = 1;
+    // How many encodings apart the earlier encodings are. With a distance of
+    // 2, packet n carries encodings n - 2, n - 4, ..., which survives losing
+    // two packets in a row.
+    size_t redundancy_distance = 1;
   };
 
   explicit AudioEncoderCopyRed(Config&& config);
@@ -51,6 +59,10 @@ class AudioEncoderCopyRed final : public AudioEncoder {
   void SetMaxPlaybackRate(int frequency_hz) override;
   void SetProjectedPacketLossRate(double fraction) override;
   void SetTargetBitrate(int target_bps) override;
+  bool EnableAudioNetworkAdaptor() override;
+  void DisableAudioNetworkAdaptor() override;
+  void OnReceivedUplinkBandwidth(int uplink_bandwidth_bps) override;
+  void OnReceivedRtt(int rtt_ms) override;
   rtc::ArrayView<std::unique_ptr<AudioEncoder>> ReclaimContainedEncoders()
       override;
 
@@ -60,10 +72,21 @@ class AudioEncoderCopyRed final : public AudioEncoder {
                          rtc::Buffer* encoded) override;
 
  private:
+  struct PastEncoding {
+    rtc::Buffer encoded;
+    EncodedInfoLeaf info;
+  };
+
   std::unique_ptr<AudioEncoder> speech_encoder_;
   int red_payload_type_;
-  rtc::Buffer secondary_encoded_;
-  EncodedInfoLeaf secondary_info_;
+  const size_t max_redundant_encodings_;
+  const size_t redundancy_distance_;
+  size_t num_redundant_encodings_;
+  // The last max_redundant_encodings_ * redundancy_distance_ encodings, used
+  // as a ring buffer. The buffers are reused, so that saving an encoding only
+  // copies it.
+  std::vector<PastEncoding> past_encodings_;
+  size_t next_past_encoding_ = 0;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioEncoderCopyRed);
 };
 
@@ -32,21 +32,61 @@ static const size_t kMaxNumSamples = 48 * 10 * 2;  // 10 ms @ 48 kHz stereo.
 class AudioEncoderCopyRedTest : public ::testing::Test {
  protected:
   AudioEncoderCopyRedTest()
-      : mock_encoder_(new MockAudioEncoder),
+      : mock_encoder_(nullptr),
         timestamp_(4711),
         sample_rate_hz_(16000),
         num_audio_samples_10ms(sample_rate_hz_ / 100),
         red_payload_type_(200) {
+    CreateRed(1, 1);
+    memset(audio_, 0, sizeof(audio_));
+  }
+
+  // Replaces |red_| with one using a new mock encoder.
+  void CreateRed(size_t max_redundant_encodings, size_t redundancy_distance) {
+    if (red_) {
+      EXPECT_CALL(*mock_encoder_, Die()).Times(1);
+      red_.reset();
+    }
+    mock_encoder_ = new MockAudioEncoder;
     AudioEncoderCopyRed::Config config;
     config.payload_type = red_payload_type_;
     config.speech_encoder = std::unique_ptr<AudioEncoder>(mock_encoder_);
+    config.max_redundant_encodings = max_redundant_encodings;
+    config.redundancy_distance = redundancy_distance;
     red_.reset(new AudioEncoderCopyRed(std::move(config)));
-    memset(audio_, 0, sizeof(audio_));
     EXPECT_CALL(*mock_encoder_, NumChannels()).WillRepeatedly(Return(1U));
     EXPECT_CALL(*mock_encoder_, SampleRateHz())
         .WillRepeatedly(Return(sample_rate_hz_));
   }
 
+  // Lets the mock encoder encode the n-th frame, starting from 1, into n bytes
+  // with the frame's timestamp.
+  void EncodeWithIncreasingSizes() {
+    num_encodings_ = 0;
+    EXPECT_CALL(*mock_encoder_, EncodeImpl(_, _, _))
+        .WillRepeatedly(Invoke([this](uint32_t timestamp,
+                                      rtc::ArrayView<const int16_t> audio,
+                                      rtc::Buffer* encoded) {
+          AudioEncoder::EncodedInfo info;
+          info.encoded_bytes = ++num_encodings_;
+          info.encoded_timestamp = timestamp;
+          encoded->SetSize(encoded->size() + info.encoded_bytes);
+          return info;
+        }));
+  }
+
+  // Checks that |encoded_info_| carries the encodings of |sizes|, in order.
+  void ExpectEncodings(const std::vector<size_t>& sizes) {
+    ASSERT_EQ(sizes.size(), encoded_info_.redundant.size());
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      EXPECT_EQ(sizes[i], encoded_info_.redundant[i].encoded_bytes);
+      total_bytes += sizes[i];
+    }
+    EXPECT_EQ(total_bytes, encoded_info_.encoded_bytes);
+    EXPECT_EQ(total_bytes, encoded_.size());
+  }
+
   void TearDown() override {
     EXPECT_CALL(*mock_encoder_, Die()).Times(1);
     red_.reset();
@@ -71,6 +111,7 @@ class AudioEncoderCopyRedTest : public ::testing::Test {
   rtc::Buffer encoded_;
   AudioEncoder::EncodedInfo encoded_info_;
   const int red_payload_type_;
+  size_t num_encodings_ = 0;
 };
 
 TEST_F(AudioEncoderCopyRedTest, CreateAndDestroy) {
@@ -275,6 +316,78 @@ TEST_F(AudioEncoderCopyRedTest, CheckPayloadType) {
   EXPECT_EQ(red_payload_type_, encoded_info_.payload_type);
 }
 
+// Checks that additional earlier encodings are carried as the projected packet
+// loss rate grows, up to the configured maximum.
+TEST_F(AudioEncoderCopyRedTest, RedundancyFollowsPacketLossRate) {
+  CreateRed(3, 1);
+  EncodeWithIncreasingSizes();
+  EXPECT_CALL(*mock_encoder_, SetProjectedPacketLossRate(_)).Times(4);
+
+  Encode();
+  ExpectEncodings({1});
+  Encode();
+  ExpectEncodings({2, 1});
+  Encode();
+  ExpectEncodings({3, 2});
+
+  red_->SetProjectedPacketLossRate(0.15);
+  Encode();
+  ExpectEncodings({4, 3, 2});
+
+  red_->SetProjectedPacketLossRate(0.5);
+  Encode();
+  ExpectEncodings({5, 4, 3, 2});
+  Encode();
+  ExpectEncodings({6, 5, 4, 3});
+
+  red_->SetProjectedPacketLossRate(0.0);
+  Encode();
+  ExpectEncodings({7, 6});
+
+  // Reset() drops the earlier encodings.
+  EXPECT_CALL(*mock_encoder_, Reset());
+  red_->SetProjectedPacketLossRate(0.5);
+  red_->Reset();
+  Encode();
+  ExpectEncodings({8});
+  Encode();
+  ExpectEncodings({9, 8});
+}
+
+// Checks that the earlier encodings are |redundancy_distance| encodings apart.
+TEST_F(AudioEncoderCopyRedTest, CheckRedundancyDistance) {
+  CreateRed(2, 2);
+  EncodeWithIncreasingSizes();
+  EXPECT_CALL(*mock_encoder_, SetProjectedPacketLossRate(0.25));
+  red_->SetProjectedPacketLossRate(0.25);
+
+  Encode();
+  ExpectEncodings({1});
+  Encode();
+  ExpectEncodings({2});
+  Encode();
+  ExpectEncodings({3, 1});
+  Encode();
+  ExpectEncodings({4, 2});
+  Encode();
+  ExpectEncodings({5, 3, 1});
+  Encode();
+  ExpectEncodings({6, 4, 2});
+}
+
+// Checks that earlier encodings whose timestamp offset doesn't fit in the RED
+// header are left out.
+TEST_F(AudioEncoderCopyRedTest, OmitsEncodingsTooOldForRedHeader) {
+  EncodeWithIncreasingSizes();
+  Encode();
+  ExpectEncodings({1});
+  timestamp_ += 1 << 14;
+  Encode();
+  ExpectEncodings({2});
+  Encode();
+  ExpectEncodings({3, 2});
+}
+
 #if GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 
 // This test fixture tests various error conditions that makes the
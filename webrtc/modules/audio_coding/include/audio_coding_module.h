@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include "webrtc/base/array_view.h"
 #include "webrtc/base/deprecation.h"
 #include "webrtc/base/optional.h"
 #include "webrtc/common_types.h"
@@ -322,6 +323,32 @@ class AudioCodingModule {
   //
   virtual int32_t Add10MsData(const AudioFrame& audio_frame) = 0;
 
+  ///////////////////////////////////////////////////////////////////////////
+  // int32_t AddData()
+  // Add a multiple of 10 ms of raw (PCM) audio data and encode it, as
+  // Add10MsData() would for each 10 ms block, but in a single call. This is
+  // meant for offline processing, e.g. from files. The encoded packets are
+  // delivered via the callback object registered using
+  // RegisterTransportCallback.
+  //
+  // Input:
+  //   -audio              : interleaved audio; its length must be a multiple
+  //                         of |num_channels| * |sample_rate_hz| / 100.
+  //   -sample_rate_hz     : sampling frequency of |audio|.
+  //   -num_channels       : number of channels of |audio|, 1 or 2.
+  //   -timestamp          : timestamp of the first sample of |audio|, in
+  //                         samples at |sample_rate_hz|.
+  //
+  // Return value:
+  //   >= 0   total number of bytes encoded.
+  //     -1   some error occurred. Blocks before the failing one have been
+  //          encoded.
+  //
+  virtual int32_t AddData(rtc::ArrayView<const int16_t> audio,
+                          int sample_rate_hz,
+                          size_t num_channels,
+                          uint32_t timestamp) = 0;
+
   ///////////////////////////////////////////////////////////////////////////
   // (RED) Redundant Coding
   //
@@ -719,6 +746,31 @@ class AudioCodingModule {
   virtual int32_t PlayoutData10Ms(int32_t desired_freq_hz,
                                   AudioFrame* audio_frame) = 0;
 
+  ///////////////////////////////////////////////////////////////////////////
+  // int32_t PlayoutData10MsWithoutDecoding()
+  // Same as PlayoutData10Ms(), but for audio that will not be played out, e.g.
+  // the audio of a participant that is not mixed. The received packets are
+  // not decoded, but the jitter buffer advances as if they were, see
+  // NetEq::GetAudioWithoutDecoding(). The sample data in audio_frame is not
+  // populated, and must be interpreted as all zero.
+  //
+  // Return value:
+  //   -1 if the function fails,
+  //    0 if the function succeeds.
+  //
+  virtual int32_t PlayoutData10MsWithoutDecoding(int32_t desired_freq_hz,
+                                                 AudioFrame* audio_frame) = 0;
+
+  ///////////////////////////////////////////////////////////////////////////
+  // bool PlayoutInDtx()
+  // Returns true while the remote sender is in a DTX period, i.e. the next
+  // PlayoutData10Ms() call would produce nothing but comfort noise, see
+  // NetEq::InDtx(). Callers that don't need the comfort noise, e.g. a server
+  // mixing many participants, can call PlayoutData10MsWithoutDecoding()
+  // instead.
+  //
+  virtual bool PlayoutInDtx() const = 0;
+
   ///////////////////////////////////////////////////////////////////////////
   //   Codec specific
   //
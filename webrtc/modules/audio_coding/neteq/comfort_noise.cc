@@ -24,18 +24,15 @@ void ComfortNoise::Reset() {
   first_call_ = true;
 }
 
-int ComfortNoise::UpdateParameters(Packet* packet) {
-  assert(packet);  // Existence is verified by caller.
+int ComfortNoise::UpdateParameters(const Packet& packet) {
   // Get comfort noise decoder.
-  if (decoder_database_->SetActiveCngDecoder(packet->header.payloadType)
+  if (decoder_database_->SetActiveCngDecoder(packet.header.payloadType)
       != kOK) {
-    delete packet;
     return kUnknownPayloadType;
   }
   ComfortNoiseDecoder* cng_decoder = decoder_database_->GetActiveCngDecoder();
   RTC_DCHECK(cng_decoder);
-  cng_decoder->UpdateSid(packet->payload);
-  delete packet;
+  cng_decoder->UpdateSid(packet.payload);
   return kOK;
 }
 
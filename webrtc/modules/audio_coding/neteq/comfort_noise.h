@@ -45,8 +45,7 @@ class ComfortNoise {
   void Reset();
 
   // Update the comfort noise generator with the parameters in |packet|.
-  // Will delete the packet.
-  int UpdateParameters(Packet* packet);
+  int UpdateParameters(const Packet& packet);
 
   // Generates |requested_length| samples of comfort noise and writes to
   // |output|. If this is the first in call after Reset (or first after creating
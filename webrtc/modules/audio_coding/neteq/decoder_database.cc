@@ -22,7 +22,9 @@ DecoderDatabase::DecoderDatabase(
     const rtc::scoped_refptr<AudioDecoderFactory>& decoder_factory)
     : active_decoder_type_(-1),
       active_cng_decoder_type_(-1),
-      decoder_factory_(decoder_factory) {}
+      decoder_factory_(decoder_factory) {
+  decoder_lookup_.fill(nullptr);
+}
 
 DecoderDatabase::~DecoderDatabase() = default;
 
@@ -108,6 +110,7 @@ bool DecoderDatabase::Empty() const { return decoders_.empty(); }
 int DecoderDatabase::Size() const { return static_cast<int>(decoders_.size()); }
 
 void DecoderDatabase::Reset() {
+  decoder_lookup_.fill(nullptr);
   decoders_.clear();
   active_decoder_type_ = -1;
   active_cng_decoder_type_ = -1;
@@ -129,6 +132,7 @@ int DecoderDatabase::RegisterPayload(uint8_t rtp_payload_type,
     // Database already contains a decoder with type |rtp_payload_type|.
     return kDecoderExists;
   }
+  decoder_lookup_[rtp_payload_type] = &ret.first->second;
   return kOK;
 }
 
@@ -152,10 +156,13 @@ int DecoderDatabase::InsertExternal(uint8_t rtp_payload_type,
     // Database already contains a decoder with type |rtp_payload_type|.
     return kDecoderExists;
   }
+  decoder_lookup_[rtp_payload_type] = &ret.first->second;
   return kOK;
 }
 
 int DecoderDatabase::Remove(uint8_t rtp_payload_type) {
+  if (rtp_payload_type < decoder_lookup_.size())
+    decoder_lookup_[rtp_payload_type] = nullptr;
   if (decoders_.erase(rtp_payload_type) == 0) {
     // No decoder with that |rtp_payload_type|.
     return kDecoderNotFound;
@@ -170,6 +177,7 @@ int DecoderDatabase::Remove(uint8_t rtp_payload_type) {
 }
 
 void DecoderDatabase::RemoveAll() {
+  decoder_lookup_.fill(nullptr);
   decoders_.clear();
   active_decoder_type_ = -1;      // No active decoder.
   active_cng_decoder_type_ = -1;  // No active CNG decoder.
@@ -177,12 +185,11 @@ void DecoderDatabase::RemoveAll() {
 
 const DecoderDatabase::DecoderInfo* DecoderDatabase::GetDecoderInfo(
     uint8_t rtp_payload_type) const {
-  DecoderMap::const_iterator it = decoders_.find(rtp_payload_type);
-  if (it == decoders_.end()) {
-    // Decoder not found.
+  if (rtp_payload_type >= decoder_lookup_.size()) {
+    // Invalid payload type; can't be in the database.
     return NULL;
   }
-  return &(*it).second;
+  return decoder_lookup_[rtp_payload_type];
 }
 
 uint8_t DecoderDatabase::GetRtpPayloadType(
@@ -288,10 +295,10 @@ bool DecoderDatabase::IsRed(uint8_t rtp_payload_type) const {
 int DecoderDatabase::CheckPayloadTypes(const PacketList& packet_list) const {
   PacketList::const_iterator it;
   for (it = packet_list.begin(); it != packet_list.end(); ++it) {
-    if (!GetDecoderInfo((*it)->header.payloadType)) {
+    if (!GetDecoderInfo(it->header.payloadType)) {
       // Payload type is not found.
       LOG(LS_WARNING) << "CheckPayloadTypes: unknown RTP payload type "
-                      << static_cast<int>((*it)->header.payloadType);
+                      << static_cast<int>(it->header.payloadType);
       return kDecoderNotFound;
     }
   }
@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_DECODER_DATABASE_H_
 #define WEBRTC_MODULES_AUDIO_CODING_NETEQ_DECODER_DATABASE_H_
 
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -195,6 +196,10 @@ class DecoderDatabase {
   typedef std::map<uint8_t, DecoderInfo> DecoderMap;
 
   DecoderMap decoders_;
+  // Entries of |decoders_| indexed by RTP payload type, so that the per-packet
+  // lookups don't have to search the map. Map entries never move, and are
+  // removed from this table before they are erased.
+  std::array<const DecoderInfo*, 128> decoder_lookup_;
   int active_decoder_type_;
   int active_cng_decoder_type_;
   mutable std::unique_ptr<ComfortNoiseDecoder> active_cng_decoder_;
@@ -88,6 +88,26 @@ TEST(DecoderDatabase, GetDecoderInfo) {
   EXPECT_TRUE(info == NULL);  // Should not be found.
 }
 
+TEST(DecoderDatabase, GetDecoderInfoAfterRemove) {
+  DecoderDatabase db(new rtc::RefCountedObject<MockAudioDecoderFactory>);
+  const uint8_t kPayloadType = 17;
+  EXPECT_EQ(DecoderDatabase::kOK,
+            db.RegisterPayload(kPayloadType, NetEqDecoder::kDecoderPCMu,
+                               "pcmu"));
+  EXPECT_TRUE(db.GetDecoderInfo(kPayloadType) != NULL);
+  EXPECT_TRUE(db.GetDecoderInfo(128) == NULL);  // Invalid payload type.
+  EXPECT_EQ(DecoderDatabase::kOK, db.Remove(kPayloadType));
+  EXPECT_TRUE(db.GetDecoderInfo(kPayloadType) == NULL);
+  EXPECT_EQ(DecoderDatabase::kOK,
+            db.RegisterPayload(kPayloadType, NetEqDecoder::kDecoderPCMa,
+                               "pcma"));
+  ASSERT_TRUE(db.GetDecoderInfo(kPayloadType) != NULL);
+  EXPECT_EQ(NetEqDecoder::kDecoderPCMa,
+            db.GetDecoderInfo(kPayloadType)->codec_type);
+  db.RemoveAll();
+  EXPECT_TRUE(db.GetDecoderInfo(kPayloadType) == NULL);
+}
+
 TEST(DecoderDatabase, GetRtpPayloadType) {
   DecoderDatabase db(new rtc::RefCountedObject<MockAudioDecoderFactory>);
   const uint8_t kPayloadType = 0;
@@ -190,26 +210,17 @@ TEST(DecoderDatabase, CheckPayloadTypes) {
   for (int i = 0; i < kNumPayloads + 1; ++i) {
     // Create packet with payload type |i|. The last packet will have a payload
     // type that is not registered in the decoder database.
-    Packet* packet = new Packet;
-    packet->header.payloadType = i;
-    packet_list.push_back(packet);
+    packet_list.push_back(Packet());
+    packet_list.back().header.payloadType = i;
   }
 
   // Expect to return false, since the last packet is of an unknown type.
   EXPECT_EQ(DecoderDatabase::kDecoderNotFound,
             db.CheckPayloadTypes(packet_list));
 
-  delete packet_list.back();
   packet_list.pop_back();  // Remove the unknown one.
 
   EXPECT_EQ(DecoderDatabase::kOK, db.CheckPayloadTypes(packet_list));
-
-  // Delete all packets.
-  PacketList::iterator it = packet_list.begin();
-  while (it != packet_list.end()) {
-    delete packet_list.front();
-    it = packet_list.erase(it);
-  }
 }
 
 #if defined(WEBRTC_CODEC_ISAC) || defined(WEBRTC_CODEC_ISACFX)
@@ -35,6 +35,10 @@ DelayManager::DelayManager(size_t max_packets_in_buffer,
       target_level_(base_target_level_ << 8),  // In Q8 domain.
       packet_len_ms_(0),
       streaming_mode_(false),
+      low_latency_mode_(false),
+      limit_probability_(kLimitProbability),
+      maximum_peak_delay_ms_(0),
+      delay_peak_capped_(false),
       last_seq_no_(0),
       last_timestamp_(0),
       minimum_delay_ms_(0),
@@ -215,8 +219,11 @@ void DelayManager::UpdateHistogram(size_t iat_packets) {
   assert(vector_sum == 0);  // Verify that the above is correct.
 
   // Update |iat_factor_| (changes only during the first seconds after a reset).
-  // The factor converges to |kIatFactor_|.
-  iat_factor_ += (kIatFactor_ - iat_factor_ + 3) >> 2;
+  // The factor converges to |kIatFactor_|, or |kIatFactorLowLatency| in
+  // low-latency mode.
+  const int steady_state_factor =
+      low_latency_mode_ ? kIatFactorLowLatency : kIatFactor_;
+  iat_factor_ += (steady_state_factor - iat_factor_ + 3) >> 2;
 }
 
 // Enforces upper and lower limits for |target_level_|. The upper limit is
@@ -251,7 +258,7 @@ void DelayManager::LimitTargetLevel() {
 }
 
 int DelayManager::CalculateTargetLevel(int iat_packets) {
-  int limit_probability = kLimitProbability;
+  int limit_probability = limit_probability_;
   if (streaming_mode_) {
     limit_probability = kLimitProbabilityStreaming;
   }
@@ -282,8 +289,18 @@ int DelayManager::CalculateTargetLevel(int iat_packets) {
 
   // Update detector for delay peaks.
   bool delay_peak_found = peak_detector_.Update(iat_packets, target_level);
+  delay_peak_capped_ = false;
   if (delay_peak_found) {
-    target_level = std::max(target_level, peak_detector_.MaxPeakHeight());
+    int peak_height = peak_detector_.MaxPeakHeight();
+    if (maximum_peak_delay_ms_ > 0 && packet_len_ms_ > 0) {
+      const int max_peak_height =
+          std::max(maximum_peak_delay_ms_ / packet_len_ms_, 1);
+      if (peak_height > std::max(target_level, max_peak_height)) {
+        peak_height = max_peak_height;
+        delay_peak_capped_ = true;
+      }
+    }
+    target_level = std::max(target_level, peak_height);
   }
 
   // Sanity check. |target_level| must be strictly positive.
@@ -309,6 +326,7 @@ int DelayManager::SetPacketAudioLength(int length_ms) {
 void DelayManager::Reset() {
   packet_len_ms_ = 0;  // Packet size unknown.
   streaming_mode_ = false;
+  delay_peak_capped_ = false;
   peak_detector_.Reset();
   ResetHistogram();  // Resets target levels too.
   iat_factor_ = 0;  // Adapt the histogram faster for the first few packets.
@@ -410,12 +428,30 @@ bool DelayManager::SetMaximumDelay(int delay_ms) {
   return true;
 }
 
+bool DelayManager::SetTargetPercentile(int percentile) {
+  if (percentile < 50 || percentile > 99) {
+    return false;
+  }
+  // Probability of observing a larger inter-arrival time, in Q30.
+  limit_probability_ = static_cast<int>(
+      (static_cast<int64_t>(100 - percentile) << 30) / 100);
+  return true;
+}
+
+void DelayManager::SetMaximumPeakDelay(int delay_ms) {
+  maximum_peak_delay_ms_ = std::max(delay_ms, 0);
+}
+
 int DelayManager::least_required_delay_ms() const {
   return least_required_delay_ms_;
 }
 
 int DelayManager::base_target_level() const { return base_target_level_; }
 void DelayManager::set_streaming_mode(bool value) { streaming_mode_ = value; }
+void DelayManager::set_low_latency_mode(bool value) {
+  low_latency_mode_ = value;
+}
+bool DelayManager::delay_peak_capped() const { return delay_peak_capped_; }
 int DelayManager::last_pack_cng_or_dtmf() const {
   return last_pack_cng_or_dtmf_;
 }
@@ -97,9 +97,23 @@ class DelayManager {
   // Assuming |delay| is in valid range.
   virtual bool SetMinimumDelay(int delay_ms);
   virtual bool SetMaximumDelay(int delay_ms);
+  // Sets the percentile of the inter-arrival time histogram that is used as
+  // base target level outside streaming mode. Returns false if |percentile| is
+  // not in the range [50, 99]. The default is 95.
+  virtual bool SetTargetPercentile(int percentile);
+  // Limits the target level set while delay peaks are found to |delay_ms|, or
+  // to the base target level if that is higher. Zero input removes the limit.
+  virtual void SetMaximumPeakDelay(int delay_ms);
   virtual int least_required_delay_ms() const;
   virtual int base_target_level() const;
   virtual void set_streaming_mode(bool value);
+  // In low-latency mode, the inter-arrival time histogram forgets old
+  // observations faster, making the target level follow improved network
+  // conditions within seconds.
+  virtual void set_low_latency_mode(bool value);
+  // Returns true if the maximum peak delay lowered the target level in the
+  // last update.
+  virtual bool delay_peak_capped() const;
   virtual int last_pack_cng_or_dtmf() const;
   virtual void set_last_pack_cng_or_dtmf(int value);
 
@@ -111,6 +125,8 @@ class DelayManager {
                                              // |iat_cumulative_sum_|.
   // Steady-state forgetting factor for |iat_vector_|, 0.9993 in Q15.
   static const int kIatFactor_ = 32745;
+  // Steady-state forgetting factor in low-latency mode, 0.996 in Q15.
+  static const int kIatFactorLowLatency = 32637;
   static const int kMaxIat = 64;  // Max inter-arrival time to register.
 
   // Sets |iat_vector_| to the default start distribution and sets the
@@ -146,6 +162,10 @@ class DelayManager {
                       // of packets (Q8), before adding any extra delay.
   int packet_len_ms_;  // Length of audio in each incoming packet [ms].
   bool streaming_mode_;
+  bool low_latency_mode_;
+  int limit_probability_;  // Target level probability outside streaming (Q30).
+  int maximum_peak_delay_ms_;  // Externally set maximum delay for peaks.
+  bool delay_peak_capped_;
   uint16_t last_seq_no_;  // Sequence number for last received packet.
   uint32_t last_timestamp_;  // Timestamp for the last received packet.
   int minimum_delay_ms_;  // Externally set minimum delay.
@@ -183,6 +183,81 @@ TEST_F(DelayManagerTest, UpdatePeakFound) {
   EXPECT_EQ(5 << 8, higher);
 }
 
+TEST_F(DelayManagerTest, UpdatePeakFoundWithMaximumPeakDelay) {
+  dm_->SetMaximumPeakDelay(3 * kFrameSizeMs);
+  SetPacketAudioLength(kFrameSizeMs);
+  // First packet arrival.
+  InsertNextPacket();
+  // Advance time by one frame size.
+  IncreaseTime(kFrameSizeMs);
+  // Second packet arrival. Let the peak height be 5, which is above the limit.
+  EXPECT_CALL(detector_, Update(1, 1))
+      .WillOnce(Return(true));
+  EXPECT_CALL(detector_, MaxPeakHeight())
+      .WillOnce(Return(5));
+  InsertNextPacket();
+  EXPECT_EQ(3 << 8, dm_->TargetLevel());
+  EXPECT_EQ(1, dm_->base_target_level());
+  EXPECT_TRUE(dm_->delay_peak_capped());
+
+  // Third packet arrival, with a peak height of 2, which is below the limit.
+  IncreaseTime(kFrameSizeMs);
+  EXPECT_CALL(detector_, Update(1, 1))
+      .WillOnce(Return(true));
+  EXPECT_CALL(detector_, MaxPeakHeight())
+      .WillOnce(Return(2));
+  InsertNextPacket();
+  EXPECT_EQ(2 << 8, dm_->TargetLevel());
+  EXPECT_FALSE(dm_->delay_peak_capped());
+}
+
+TEST_F(DelayManagerTest, TargetPercentile) {
+  EXPECT_FALSE(dm_->SetTargetPercentile(49));
+  EXPECT_FALSE(dm_->SetTargetPercentile(100));
+  EXPECT_TRUE(dm_->SetTargetPercentile(50));
+  dm_->set_low_latency_mode(true);
+  SetPacketAudioLength(kFrameSizeMs);
+  EXPECT_CALL(detector_, Update(_, _))
+      .WillRepeatedly(Return(false));
+  InsertNextPacket();
+  // Let every tenth packet arrive with an inter-arrival time of 3 packets.
+  for (int i = 1; i <= 2000; ++i) {
+    IncreaseTime((i % 10 == 0 ? 3 : 1) * kFrameSizeMs);
+    InsertNextPacket();
+  }
+  EXPECT_EQ(1, dm_->base_target_level());
+
+  // The 95th percentile covers the late packets.
+  EXPECT_TRUE(dm_->SetTargetPercentile(95));
+  IncreaseTime(kFrameSizeMs);
+  InsertNextPacket();
+  EXPECT_EQ(3, dm_->base_target_level());
+}
+
+TEST_F(DelayManagerTest, LowLatencyModeAdaptsFaster) {
+  EXPECT_CALL(detector_, Update(_, _))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(detector_, Reset()).Times(2);
+  for (bool low_latency_mode : {false, true}) {
+    dm_->Reset();
+    dm_->set_low_latency_mode(low_latency_mode);
+    SetPacketAudioLength(kFrameSizeMs);
+    InsertNextPacket();
+    for (int i = 0; i < 100; ++i) {
+      IncreaseTime(kFrameSizeMs);
+      InsertNextPacket();
+    }
+    // A single packet arriving two packet times late gets the weight of the
+    // steady-state forgetting factor, 0.9993 normally and 0.996 in low-latency
+    // mode, in the histogram.
+    IncreaseTime(2 * kFrameSizeMs);
+    InsertNextPacket();
+    const int expected_weight = low_latency_mode ? (32768 - 32637) << 15
+                                                 : (32768 - 32745) << 15;
+    EXPECT_NEAR(expected_weight, dm_->iat_vector()[2], 1000);
+  }
+}
+
 TEST_F(DelayManagerTest, TargetDelay) {
   SetPacketAudioLength(kFrameSizeMs);
   // First packet arrival.
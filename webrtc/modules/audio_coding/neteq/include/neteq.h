@@ -55,6 +55,12 @@ struct NetEqNetworkStatistics {
   int median_waiting_time_ms;
   int min_waiting_time_ms;
   int max_waiting_time_ms;
+  // Average target delay computed for the packets received since the last
+  // call, and the fraction of these packets for which the target delay was
+  // limited by NetEq::Config::max_delay_peak_ms (in Q14). The mean is -1 if no
+  // packets were received.
+  int mean_target_delay_ms;
+  uint16_t delay_peak_capped_rate;
 };
 
 enum NetEqPlayoutMode {
@@ -96,6 +102,15 @@ class NetEq {
     NetEqPlayoutMode playout_mode;
     bool enable_fast_accelerate;
     bool enable_muted_state = false;
+    // Tuning of the target delay, e.g. for low-latency calls on stable
+    // networks or for server relays. In low-latency mode, the inter-arrival
+    // time histogram adapts about six times faster. The target delay is the
+    // |delay_target_percentile| of the histogram, outside streaming mode.
+    // |max_delay_peak_ms| limits the delay added while delay peaks are found;
+    // 0 means no limit.
+    bool enable_low_latency_mode = false;
+    int delay_target_percentile = 95;
+    int max_delay_peak_ms = 0;
   };
 
   enum ReturnCodes {
@@ -160,6 +175,22 @@ class NetEq {
   // Returns kOK on success, or kFail in case of an error.
   virtual int GetAudio(AudioFrame* audio_frame, bool* muted) = 0;
 
+  // Same as GetAudio(), but for audio that will not be played out, e.g. the
+  // audio of a participant that is not mixed. The packets due for playout are
+  // taken from the packet buffer, and the playout timestamp, the jitter and
+  // network statistics and the expand state advance as in GetAudio(), but the
+  // packets are not decoded. The |data_| in |audio_frame| should be
+  // interpreted as all zeros.
+  // Returns kOK on success, or kFail in case of an error.
+  virtual int GetAudioWithoutDecoding(AudioFrame* audio_frame) = 0;
+
+  // Returns true while the sender is in a DTX period, i.e. the last output was
+  // comfort noise, RFC 3389 or codec internal, and the next packet due for
+  // playout, if any, is comfort noise too. The next GetAudio() call will then
+  // produce nothing but comfort noise, so callers that don't need it can call
+  // GetAudioWithoutDecoding() instead.
+  virtual bool InDtx() const = 0;
+
   // Associates |rtp_payload_type| with |codec| and |codec_name|, and stores the
   // information in the codec database. Returns 0 on success, -1 on failure.
   // The name is only used to provide information back to the caller about the
@@ -27,7 +27,12 @@ class MockPacketBuffer : public PacketBuffer {
       void());
   MOCK_CONST_METHOD0(Empty,
       bool());
-  MOCK_METHOD1(InsertPacket,
+  // gmock cannot mock methods taking rvalue references; forward the inserted
+  // packet to InsertPacketWrapped instead.
+  int InsertPacket(Packet&& packet) override {
+    return InsertPacketWrapped(&packet);
+  }
+  MOCK_METHOD1(InsertPacketWrapped,
       int(Packet* packet));
   MOCK_METHOD4(InsertPacketList,
       int(PacketList* packet_list,
@@ -40,8 +45,6 @@ class MockPacketBuffer : public PacketBuffer {
       int(uint32_t timestamp, uint32_t* next_timestamp));
   MOCK_CONST_METHOD0(NextRtpHeader,
       const RTPHeader*());
-  MOCK_METHOD1(GetNextPacket,
-      Packet*(size_t* discard_count));
   MOCK_METHOD0(DiscardNextPacket,
       int());
   MOCK_METHOD2(DiscardOldPackets,
@@ -28,7 +28,11 @@ std::string NetEq::Config::ToString() const {
      << ", playout_mode=" << playout_mode
      << ", enable_fast_accelerate="
      << (enable_fast_accelerate ? " true": "false")
-     << ", enable_muted_state=" << (enable_muted_state ? " true": "false");
+     << ", enable_muted_state=" << (enable_muted_state ? " true": "false")
+     << ", enable_low_latency_mode="
+     << (enable_low_latency_mode ? "true" : "false")
+     << ", delay_target_percentile=" << delay_target_percentile
+     << ", max_delay_peak_ms=" << max_delay_peak_ms;
   return ss.str();
 }
 
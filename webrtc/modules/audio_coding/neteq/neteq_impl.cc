@@ -114,6 +114,13 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
     fs = 8000;
   }
   delay_manager_->SetMaximumDelay(config.max_delay_ms);
+  delay_manager_->set_low_latency_mode(config.enable_low_latency_mode);
+  if (!delay_manager_->SetTargetPercentile(config.delay_target_percentile)) {
+    LOG(LS_ERROR) << "Delay target percentile "
+                  << config.delay_target_percentile
+                  << " not supported. Using the default.";
+  }
+  delay_manager_->SetMaximumPeakDelay(config.max_delay_peak_ms);
   fs_hz_ = fs;
   fs_mult_ = fs / 8000;
   last_output_sample_rate_hz_ = fs;
@@ -192,11 +199,39 @@ void SetAudioFrameActivityAndType(bool vad_enabled,
 int NetEqImpl::GetAudio(AudioFrame* audio_frame, bool* muted) {
   TRACE_EVENT0("webrtc", "NetEqImpl::GetAudio");
   rtc::CritScope lock(&crit_sect_);
-  int error = GetAudioInternal(audio_frame, muted);
+  int error = GetAudioInternal(audio_frame, muted, true);
+  if (error != 0) {
+    error_code_ = error;
+    return kFail;
+  }
+  FinishAudioFrame(audio_frame);
+  return kOK;
+}
+
+int NetEqImpl::GetAudioWithoutDecoding(AudioFrame* audio_frame) {
+  TRACE_EVENT0("webrtc", "NetEqImpl::GetAudioWithoutDecoding");
+  rtc::CritScope lock(&crit_sect_);
+  bool muted;
+  int error = GetAudioInternal(audio_frame, &muted, false);
   if (error != 0) {
     error_code_ = error;
     return kFail;
   }
+  FinishAudioFrame(audio_frame);
+  return kOK;
+}
+
+bool NetEqImpl::InDtx() const {
+  rtc::CritScope lock(&crit_sect_);
+  if (last_mode_ != kModeRfc3389Cng && last_mode_ != kModeCodecInternalCng)
+    return false;
+  // Speech resumes with the next packet, unless it is a comfort noise update.
+  const RTPHeader* next_header = packet_buffer_->NextRtpHeader();
+  return !next_header ||
+         decoder_database_->IsComfortNoise(next_header->payloadType);
+}
+
+void NetEqImpl::FinishAudioFrame(AudioFrame* audio_frame) {
   RTC_DCHECK_EQ(
       audio_frame->sample_rate_hz_,
       rtc::checked_cast<int>(audio_frame->samples_per_channel_ * 100));
@@ -209,7 +244,6 @@ int NetEqImpl::GetAudio(AudioFrame* audio_frame, bool* muted) {
              last_output_sample_rate_hz_ == 32000 ||
              last_output_sample_rate_hz_ == 48000)
       << "Unexpected sample rate " << last_output_sample_rate_hz_;
-  return kOK;
 }
 
 int NetEqImpl::RegisterPayloadType(NetEqDecoder codec,
@@ -545,23 +579,23 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
   {
     // Convert to Packet.
     // Create |packet| within this separate scope, since it should not be used
-    // directly once it's been inserted in the packet list. This way, |packet|
+    // directly once it's been moved into the packet list. This way, |packet|
     // is not defined outside of this block.
-    Packet* packet = new Packet;
-    packet->header.markerBit = false;
-    packet->header.payloadType = rtp_header.header.payloadType;
-    packet->header.sequenceNumber = rtp_header.header.sequenceNumber;
-    packet->header.timestamp = rtp_header.header.timestamp;
-    packet->header.ssrc = rtp_header.header.ssrc;
-    packet->header.numCSRCs = 0;
-    packet->payload.SetData(payload.data(), payload.size());
-    packet->primary = true;
+    Packet packet;
+    packet.header.markerBit = false;
+    packet.header.payloadType = rtp_header.header.payloadType;
+    packet.header.sequenceNumber = rtp_header.header.sequenceNumber;
+    packet.header.timestamp = rtp_header.header.timestamp;
+    packet.header.ssrc = rtp_header.header.ssrc;
+    packet.header.numCSRCs = 0;
+    packet.payload.SetData(payload.data(), payload.size());
+    packet.primary = true;
     // Waiting time will be set upon inserting the packet in the buffer.
-    RTC_DCHECK(!packet->waiting_time);
-    // Insert packet in a packet list.
-    packet_list.push_back(packet);
+    RTC_DCHECK(!packet.waiting_time);
     // Save main payloads header for later.
-    memcpy(&main_header, &packet->header, sizeof(main_header));
+    memcpy(&main_header, &packet.header, sizeof(main_header));
+    // Insert packet in a packet list.
+    packet_list.push_back(std::move(packet));
   }
 
   bool update_sample_rate_and_channels = false;
@@ -598,7 +632,6 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
   // Check for RED payload type, and separate payloads into several packets.
   if (decoder_database_->IsRed(main_header.payloadType)) {
     if (payload_splitter_->SplitRed(&packet_list) != PayloadSplitter::kOK) {
-      PacketBuffer::DeleteAllPackets(&packet_list);
       return kRedundancySplitError;
     }
     // Only accept a few RED payloads of the same type as the main data,
@@ -606,13 +639,12 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
     payload_splitter_->CheckRedPayloads(&packet_list, *decoder_database_);
     // Update the stored main payload header since the main payload has now
     // changed.
-    memcpy(&main_header, &packet_list.front()->header, sizeof(main_header));
+    memcpy(&main_header, &packet_list.front().header, sizeof(main_header));
   }
 
   // Check payload types.
   if (decoder_database_->CheckPayloadTypes(packet_list) ==
       DecoderDatabase::kDecoderNotFound) {
-    PacketBuffer::DeleteAllPackets(&packet_list);
     return kUnknownRtpPayloadType;
   }
 
@@ -623,23 +655,19 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
   // DTMF payloads found.
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    Packet* current_packet = (*it);
-    assert(current_packet);
-    assert(!current_packet->payload.empty());
-    if (decoder_database_->IsDtmf(current_packet->header.payloadType)) {
+    const Packet& current_packet = (*it);
+    assert(!current_packet.payload.empty());
+    if (decoder_database_->IsDtmf(current_packet.header.payloadType)) {
       DtmfEvent event;
-      int ret = DtmfBuffer::ParseEvent(current_packet->header.timestamp,
-                                       current_packet->payload.data(),
-                                       current_packet->payload.size(), &event);
+      int ret = DtmfBuffer::ParseEvent(current_packet.header.timestamp,
+                                       current_packet.payload.data(),
+                                       current_packet.payload.size(), &event);
       if (ret != DtmfBuffer::kOK) {
-        PacketBuffer::DeleteAllPackets(&packet_list);
         return kDtmfParsingError;
       }
       if (dtmf_buffer_->InsertEvent(event) != DtmfBuffer::kOK) {
-        PacketBuffer::DeleteAllPackets(&packet_list);
         return kDtmfInsertError;
       }
-      delete current_packet;
       it = packet_list.erase(it);
     } else {
       ++it;
@@ -649,7 +677,6 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
   // Check for FEC in packets, and separate payloads into several packets.
   int ret = payload_splitter_->SplitFec(&packet_list, decoder_database_.get());
   if (ret != PayloadSplitter::kOK) {
-    PacketBuffer::DeleteAllPackets(&packet_list);
     switch (ret) {
       case PayloadSplitter::kUnknownPayloadType:
         return kUnknownRtpPayloadType;
@@ -662,7 +689,6 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
   // are of a known payload type.
   ret = payload_splitter_->SplitAudio(&packet_list, *decoder_database_);
   if (ret != PayloadSplitter::kOK) {
-    PacketBuffer::DeleteAllPackets(&packet_list);
     switch (ret) {
       case PayloadSplitter::kUnknownPayloadType:
         return kUnknownRtpPayloadType;
@@ -681,19 +707,18 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
         decoder_database_->GetDecoder(main_header.payloadType);
     assert(decoder);  // Should always get a valid object, since we have
     // already checked that the payload types are known.
-    decoder->IncomingPacket(packet_list.front()->payload.data(),
-                            packet_list.front()->payload.size(),
-                            packet_list.front()->header.sequenceNumber,
-                            packet_list.front()->header.timestamp,
+    decoder->IncomingPacket(packet_list.front().payload.data(),
+                            packet_list.front().payload.size(),
+                            packet_list.front().header.sequenceNumber,
+                            packet_list.front().header.timestamp,
                             receive_timestamp);
   }
 
   PacketList parsed_packet_list;
   while (!packet_list.empty()) {
-    std::unique_ptr<Packet> packet(packet_list.front());
-    packet_list.pop_front();
+    Packet& packet = packet_list.front();
     const DecoderDatabase::DecoderInfo* info =
-        decoder_database_->GetDecoderInfo(packet->header.payloadType);
+        decoder_database_->GetDecoderInfo(packet.header.payloadType);
     if (!info) {
       LOG(LS_WARNING) << "SplitAudio unknown payload type";
       return kUnknownRtpPayloadType;
@@ -701,25 +726,24 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
 
     if (info->IsComfortNoise()) {
       // Carry comfort noise packets along.
-      parsed_packet_list.push_back(packet.release());
+      parsed_packet_list.splice(parsed_packet_list.end(), packet_list,
+                                packet_list.begin());
     } else {
+      const RTPHeader original_header = packet.header;
       std::vector<AudioDecoder::ParseResult> results =
-          info->GetDecoder()->ParsePayload(std::move(packet->payload),
-                                           packet->header.timestamp,
-                                           packet->primary);
-      const RTPHeader& original_header = packet->header;
+          info->GetDecoder()->ParsePayload(std::move(packet.payload),
+                                           packet.header.timestamp,
+                                           packet.primary);
+      packet_list.pop_front();
       for (auto& result : results) {
         RTC_DCHECK(result.frame);
-        // Reuse the packet if possible
-        if (!packet) {
-          packet.reset(new Packet);
-          packet->header = original_header;
-        }
-        packet->header.timestamp = result.timestamp;
+        Packet new_packet;
+        new_packet.header = original_header;
+        new_packet.header.timestamp = result.timestamp;
         // TODO(ossu): Move from primary to some sort of priority level.
-        packet->primary = result.primary;
-        packet->frame = std::move(result.frame);
-        parsed_packet_list.push_back(packet.release());
+        new_packet.primary = result.primary;
+        new_packet.frame = std::move(result.frame);
+        parsed_packet_list.push_back(std::move(new_packet));
       }
     }
   }
@@ -730,8 +754,8 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
       nack_->Reset();
     }
     nack_->UpdateLastReceivedPacket(
-        parsed_packet_list.front()->header.sequenceNumber,
-        parsed_packet_list.front()->header.timestamp);
+        parsed_packet_list.front().header.sequenceNumber,
+        parsed_packet_list.front().header.timestamp);
   }
 
   // Insert packets in buffer.
@@ -745,7 +769,6 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
     new_codec_ = true;
     update_sample_rate_and_channels = true;
   } else if (ret != PacketBuffer::kOK) {
-    PacketBuffer::DeleteAllPackets(&parsed_packet_list);
     return kOtherError;
   }
 
@@ -818,8 +841,14 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
         !new_codec_) {
       // Only update statistics if incoming packet is not older than last played
       // out packet, and if new codec flag is not set.
-      delay_manager_->Update(main_header.sequenceNumber, main_header.timestamp,
-                             fs_hz_);
+      if (delay_manager_->Update(main_header.sequenceNumber,
+                                 main_header.timestamp, fs_hz_) == 0) {
+        const int ms_per_packet = rtc::checked_cast<int>(
+            decision_logic_->packet_length_samples() / (fs_hz_ / 1000));
+        stats_.StoreTargetDelay(
+            (delay_manager_->TargetLevel() >> 8) * ms_per_packet,
+            delay_manager_->delay_peak_capped());
+      }
     }
   } else if (delay_manager_->last_pack_cng_or_dtmf() == -1) {
     // This is first "normal" packet after CNG or DTMF.
@@ -831,7 +860,9 @@ int NetEqImpl::InsertPacketInternal(const WebRtcRTPHeader& rtp_header,
   return 0;
 }
 
-int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame, bool* muted) {
+int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame,
+                                bool* muted,
+                                bool decode) {
   PacketList packet_list;
   DtmfEvent dtmf_event;
   Operations operation;
@@ -866,7 +897,7 @@ int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame, bool* muted) {
 
   AudioDecoder::SpeechType speech_type;
   int length = 0;
-  int decode_return_value = Decode(&packet_list, &operation,
+  int decode_return_value = Decode(&packet_list, &operation, decode,
                                    &length, &speech_type);
 
   assert(vad_.get());
@@ -1325,7 +1356,7 @@ int NetEqImpl::GetDecision(Operations* operation,
 }
 
 int NetEqImpl::Decode(PacketList* packet_list, Operations* operation,
-                      int* decoded_length,
+                      bool decode, int* decoded_length,
                       AudioDecoder::SpeechType* speech_type) {
   *speech_type = AudioDecoder::kSpeech;
 
@@ -1334,15 +1365,15 @@ int NetEqImpl::Decode(PacketList* packet_list, Operations* operation,
   AudioDecoder* decoder = decoder_database_->GetActiveDecoder();
 
   if (!packet_list->empty()) {
-    const Packet* packet = packet_list->front();
-    uint8_t payload_type = packet->header.payloadType;
+    const Packet& packet = packet_list->front();
+    uint8_t payload_type = packet.header.payloadType;
     if (!decoder_database_->IsComfortNoise(payload_type)) {
       decoder = decoder_database_->GetDecoder(payload_type);
       assert(decoder);
       if (!decoder) {
         LOG(LS_WARNING) << "Unknown payload type "
                         << static_cast<int>(payload_type);
-        PacketBuffer::DeleteAllPackets(packet_list);
+        packet_list->clear();
         return kDecoderNotFound;
       }
       bool decoder_changed;
@@ -1355,7 +1386,7 @@ int NetEqImpl::Decode(PacketList* packet_list, Operations* operation,
         if (!decoder_info) {
           LOG(LS_WARNING) << "Unknown payload type "
                           << static_cast<int>(payload_type);
-          PacketBuffer::DeleteAllPackets(packet_list);
+          packet_list->clear();
           return kDecoderNotFound;
         }
         // If sampling rate or number of channels has changed, we need to make
@@ -1387,16 +1418,16 @@ int NetEqImpl::Decode(PacketList* packet_list, Operations* operation,
 
   *decoded_length = 0;
   // Update codec-internal PLC state.
-  if ((*operation == kMerge) && decoder && decoder->HasDecodePlc()) {
+  if (decode && (*operation == kMerge) && decoder && decoder->HasDecodePlc()) {
     decoder->DecodePlc(1, &decoded_buffer_[*decoded_length]);
   }
 
   int return_value;
   if (*operation == kCodecInternalCng) {
     RTC_DCHECK(packet_list->empty());
-    return_value = DecodeCng(decoder, decoded_length, speech_type);
+    return_value = DecodeCng(decoder, decode, decoded_length, speech_type);
   } else {
-    return_value = DecodeLoop(packet_list, *operation, decoder,
+    return_value = DecodeLoop(packet_list, *operation, decoder, decode,
                               decoded_length, speech_type);
   }
 
@@ -1432,7 +1463,8 @@ int NetEqImpl::Decode(PacketList* packet_list, Operations* operation,
   return return_value;
 }
 
-int NetEqImpl::DecodeCng(AudioDecoder* decoder, int* decoded_length,
+int NetEqImpl::DecodeCng(AudioDecoder* decoder, bool decode,
+                         int* decoded_length,
                          AudioDecoder::SpeechType* speech_type) {
   if (!decoder) {
     // This happens when active decoder is not defined.
@@ -1440,6 +1472,13 @@ int NetEqImpl::DecodeCng(AudioDecoder* decoder, int* decoded_length,
     return 0;
   }
 
+  if (!decode) {
+    *decoded_length = rtc::checked_cast<int>(output_size_samples_);
+    std::fill(&decoded_buffer_[0], &decoded_buffer_[*decoded_length], 0);
+    *speech_type = AudioDecoder::kComfortNoise;
+    return 0;
+  }
+
   while (*decoded_length < rtc::checked_cast<int>(output_size_samples_)) {
     const int length = decoder->Decode(
             nullptr, 0, fs_hz_,
@@ -1463,16 +1502,14 @@ int NetEqImpl::DecodeCng(AudioDecoder* decoder, int* decoded_length,
 }
 
 int NetEqImpl::DecodeLoop(PacketList* packet_list, const Operations& operation,
-                          AudioDecoder* decoder, int* decoded_length,
+                          AudioDecoder* decoder, bool decode,
+                          int* decoded_length,
                           AudioDecoder::SpeechType* speech_type) {
-  Packet* packet = NULL;
-  if (!packet_list->empty()) {
-    packet = packet_list->front();
-  }
-
   // Do decoding.
-  while (packet &&
-      !decoder_database_->IsComfortNoise(packet->header.payloadType)) {
+  while (
+      !packet_list->empty() &&
+      !decoder_database_->IsComfortNoise(
+          packet_list->front().header.payloadType)) {
     assert(decoder);  // At this point, we must have a decoder object.
     // The number of channels in the |sync_buffer_| should be the same as the
     // number decoder channels.
@@ -1481,12 +1518,26 @@ int NetEqImpl::DecodeLoop(PacketList* packet_list, const Operations& operation,
     assert(operation == kNormal || operation == kAccelerate ||
            operation == kFastAccelerate || operation == kMerge ||
            operation == kPreemptiveExpand);
+    const Packet& packet = packet_list->front();
+    const rtc::ArrayView<int16_t> decoded(
+        &decoded_buffer_[*decoded_length],
+        decoded_buffer_length_ - *decoded_length);
+    rtc::Optional<AudioDecoder::EncodedAudioFrame::DecodeResult> opt_result;
+    if (decode) {
+      opt_result = packet.frame->Decode(decoded);
+    } else {
+      // Only the duration of the packet is needed to advance the timeline,
+      // which is much cheaper to get than the decoded audio.
+      size_t duration = packet.frame->Duration();
+      if (duration == 0)
+        duration = decoder_frame_length_;
+      const size_t num_samples =
+          std::min(duration * decoder->Channels(), decoded.size());
+      std::fill(decoded.begin(), decoded.begin() + num_samples, 0);
+      opt_result = rtc::Optional<AudioDecoder::EncodedAudioFrame::DecodeResult>(
+          {num_samples, AudioDecoder::kSpeech});
+    }
     packet_list->pop_front();
-    auto opt_result = packet->frame->Decode(
-        rtc::ArrayView<int16_t>(&decoded_buffer_[*decoded_length],
-                                decoded_buffer_length_ - *decoded_length));
-    delete packet;
-    packet = NULL;
     if (opt_result) {
       const auto& result = *opt_result;
       *speech_type = result.speech_type;
@@ -1501,27 +1552,23 @@ int NetEqImpl::DecodeLoop(PacketList* packet_list, const Operations& operation,
       // TODO(ossu): What to put here?
       LOG(LS_WARNING) << "Decode error";
       *decoded_length = -1;
-      PacketBuffer::DeleteAllPackets(packet_list);
+      packet_list->clear();
       break;
     }
     if (*decoded_length > rtc::checked_cast<int>(decoded_buffer_length_)) {
       // Guard against overflow.
       LOG(LS_WARNING) << "Decoded too much.";
-      PacketBuffer::DeleteAllPackets(packet_list);
+      packet_list->clear();
       return kDecodedTooMuch;
     }
-    if (!packet_list->empty()) {
-      packet = packet_list->front();
-    } else {
-      packet = NULL;
-    }
   }  // End of decode loop.
 
   // If the list is not empty at this point, either a decoding error terminated
   // the while-loop, or list must hold exactly one CNG packet.
   assert(packet_list->empty() || *decoded_length < 0 ||
-         (packet_list->size() == 1 && packet &&
-             decoder_database_->IsComfortNoise(packet->header.payloadType)));
+         (packet_list->size() == 1 &&
+          decoder_database_->IsComfortNoise(
+              packet_list->front().header.payloadType)));
   return 0;
 }
 
@@ -1761,13 +1808,11 @@ int NetEqImpl::DoRfc3389Cng(PacketList* packet_list, bool play_dtmf) {
   if (!packet_list->empty()) {
     // Must have exactly one SID frame at this point.
     assert(packet_list->size() == 1);
-    Packet* packet = packet_list->front();
-    packet_list->pop_front();
-    if (!decoder_database_->IsComfortNoise(packet->header.payloadType)) {
+    const Packet& packet = packet_list->front();
+    if (!decoder_database_->IsComfortNoise(packet.header.payloadType)) {
       LOG(LS_ERROR) << "Trying to decode non-CNG payload as CNG.";
       return kOtherError;
     }
-    // UpdateParameters() deletes |packet|.
     if (comfort_noise_->UpdateParameters(packet) ==
         ComfortNoise::kInternalError) {
       algorithm_buffer_->Zeros(output_size_samples_);
@@ -1952,7 +1997,8 @@ int NetEqImpl::ExtractPackets(size_t required_samples,
   do {
     timestamp_ = header->timestamp;
     size_t discard_count = 0;
-    Packet* packet = packet_buffer_->GetNextPacket(&discard_count);
+    rtc::Optional<Packet> packet =
+        packet_buffer_->GetNextPacket(&discard_count);
     // |header| may be invalid after the |packet_buffer_| operation.
     header = NULL;
     if (!packet) {
@@ -1963,7 +2009,6 @@ int NetEqImpl::ExtractPackets(size_t required_samples,
     stats_.PacketsDiscarded(discard_count);
     stats_.StoreWaitingTime(packet->waiting_time->ElapsedMs());
     RTC_DCHECK(!packet->empty());
-    packet_list->push_back(packet);  // Store packet in list.
 
     if (first_packet) {
       first_packet = false;
@@ -2001,6 +2046,9 @@ int NetEqImpl::ExtractPackets(size_t required_samples,
     extracted_samples = packet->header.timestamp - first_timestamp +
         packet_duration;
 
+    packet_list->push_back(std::move(*packet));  // Store packet in list.
+    packet = rtc::Optional<Packet>();  // Ensure it's never used after the move.
+
     // Check what packet is available next.
     header = packet_buffer_->NextRtpHeader();
     next_packet_available = false;
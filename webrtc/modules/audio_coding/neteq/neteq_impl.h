@@ -110,6 +110,10 @@ class NetEqImpl : public webrtc::NetEq {
 
   int GetAudio(AudioFrame* audio_frame, bool* muted) override;
 
+  int GetAudioWithoutDecoding(AudioFrame* audio_frame) override;
+
+  bool InDtx() const override;
+
   int RegisterPayloadType(NetEqDecoder codec,
                           const std::string& codec_name,
                           uint8_t rtp_payload_type) override;
@@ -219,8 +223,15 @@ class NetEqImpl : public webrtc::NetEq {
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
   // Delivers 10 ms of audio data. The data is written to |audio_frame|.
+  // Unless |decode| is true, the packets are not decoded and silence is
+  // processed in place of their audio.
   // Returns 0 on success, otherwise an error code.
-  int GetAudioInternal(AudioFrame* audio_frame, bool* muted)
+  int GetAudioInternal(AudioFrame* audio_frame, bool* muted, bool decode)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
+  // Sets the VAD activity, speech type and sample rate of |audio_frame| after
+  // a successful GetAudioInternal() call.
+  void FinishAudioFrame(AudioFrame* audio_frame)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
   // Provides a decision to the GetAudioInternal method. The decision what to
@@ -238,15 +249,17 @@ class NetEqImpl : public webrtc::NetEq {
   // elements. The length of the decoded data is written to |decoded_length|.
   // The speech type -- speech or (codec-internal) comfort noise -- is written
   // to |speech_type|. If |packet_list| contains any SID frames for RFC 3389
-  // comfort noise, those are not decoded.
+  // comfort noise, those are not decoded. Unless |decode| is true, silence of
+  // the duration of the packets is written instead of their decoded audio.
   int Decode(PacketList* packet_list,
              Operations* operation,
+             bool decode,
              int* decoded_length,
              AudioDecoder::SpeechType* speech_type)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
   // Sub-method to Decode(). Performs codec internal CNG.
-  int DecodeCng(AudioDecoder* decoder, int* decoded_length,
+  int DecodeCng(AudioDecoder* decoder, bool decode, int* decoded_length,
                 AudioDecoder::SpeechType* speech_type)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
@@ -254,6 +267,7 @@ class NetEqImpl : public webrtc::NetEq {
   int DecodeLoop(PacketList* packet_list,
                  const Operations& operation,
                  AudioDecoder* decoder,
+                 bool decode,
                  int* decoded_length,
                  AudioDecoder::SpeechType* speech_type)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
@@ -49,10 +49,10 @@ using ::testing::IsNull;
 namespace webrtc {
 
 // This function is called when inserting a packet list into the mock packet
-// buffer. The purpose is to delete all inserted packets properly, to avoid
-// memory leaks in the test.
+// buffer. The purpose is to empty the list, as the real buffer does when the
+// packets are moved into it.
 int DeletePacketsAndReturnOk(PacketList* packet_list) {
-  PacketBuffer::DeleteAllPackets(packet_list);
+  packet_list->clear();
   return PacketBuffer::kOK;
 }
 
@@ -298,8 +298,8 @@ TEST_F(NetEqImplTest, InsertPacket) {
                 WithArg<0>(Invoke(DeletePacketsAndReturnOk))));
   // SetArgPointee<2>(kPayloadType) means that the third argument (zero-based
   // index) is a pointer, and the variable pointed to is set to kPayloadType.
-  // Also invoke the function DeletePacketsAndReturnOk to properly delete all
-  // packets in the list (to avoid memory leaks in the test).
+  // Also invoke the function DeletePacketsAndReturnOk to empty the packet
+  // list.
   EXPECT_CALL(*mock_packet_buffer_, NextRtpHeader())
       .Times(1)
       .WillOnce(Return(&rtp_header.header));
@@ -482,6 +482,93 @@ TEST_F(NetEqImplTest, VerifyTimestampPropagation) {
       sync_buffer->FutureLength());
 }
 
+TEST_F(NetEqImplTest, GetAudioWithoutDecoding) {
+  UseNoMocks();
+  CreateInstance();
+
+  const uint8_t kPayloadType = 17;   // Just an arbitrary number.
+  const uint32_t kReceiveTime = 17;  // Value doesn't matter for this test.
+  const int kSampleRateHz = 8000;
+  const size_t kPayloadLengthSamples =
+      static_cast<size_t>(10 * kSampleRateHz / 1000);  // 10 ms.
+  const size_t kPayloadLengthBytes = kPayloadLengthSamples;
+  uint8_t payload[kPayloadLengthBytes] = {0};
+  WebRtcRTPHeader rtp_header;
+  rtp_header.header.payloadType = kPayloadType;
+  rtp_header.header.sequenceNumber = 0x1234;
+  rtp_header.header.timestamp = 0x12345678;
+  rtp_header.header.ssrc = 0x87654321;
+
+  // This is a dummy decoder that produces as many output samples of value 1
+  // as the input has bytes, and counts the calls to decode.
+  class CountingDecoder : public AudioDecoder {
+   public:
+    CountingDecoder() : num_decode_calls_(0) {}
+
+    int DecodeInternal(const uint8_t* encoded,
+                       size_t encoded_len,
+                       int /* sample_rate_hz */,
+                       int16_t* decoded,
+                       SpeechType* speech_type) override {
+      ++num_decode_calls_;
+      std::fill(decoded, decoded + encoded_len, 1);
+      *speech_type = kSpeech;
+      return encoded_len;
+    }
+
+    int PacketDuration(const uint8_t* encoded,
+                       size_t encoded_len) const override {
+      return static_cast<int>(encoded_len);
+    }
+
+    void Reset() override {}
+
+    int SampleRateHz() const override { return kSampleRateHz; }
+
+    size_t Channels() const override { return 1; }
+
+    int num_decode_calls() const { return num_decode_calls_; }
+
+   private:
+    int num_decode_calls_;
+  } decoder_;
+
+  EXPECT_EQ(NetEq::kOK, neteq_->RegisterExternalDecoder(
+                            &decoder_, NetEqDecoder::kDecoderPCM16B,
+                            "dummy name", kPayloadType));
+
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->InsertPacket(rtp_header, payload, kReceiveTime));
+
+  // The packet is taken from the packet buffer, but not decoded.
+  AudioFrame output;
+  EXPECT_EQ(NetEq::kOK, neteq_->GetAudioWithoutDecoding(&output));
+  EXPECT_EQ(0, decoder_.num_decode_calls());
+  EXPECT_TRUE(packet_buffer_->Empty());
+  EXPECT_EQ(kPayloadLengthSamples, output.samples_per_channel_);
+  EXPECT_EQ(kSampleRateHz, output.sample_rate_hz_);
+
+  // The timeline advances as if the packet was decoded.
+  const SyncBuffer* sync_buffer = neteq_->sync_buffer_for_test();
+  ASSERT_TRUE(sync_buffer != NULL);
+  EXPECT_EQ(rtp_header.header.timestamp + kPayloadLengthSamples,
+            sync_buffer->end_timestamp());
+  EXPECT_EQ(rtc::Optional<uint32_t>(sync_buffer->end_timestamp() -
+                                    sync_buffer->FutureLength()),
+            neteq_->GetPlayoutTimestamp());
+
+  // The next packet is decoded when audio is asked for again.
+  rtp_header.header.sequenceNumber++;
+  rtp_header.header.timestamp += kPayloadLengthSamples;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->InsertPacket(rtp_header, payload, kReceiveTime));
+  bool muted;
+  EXPECT_EQ(NetEq::kOK, neteq_->GetAudio(&output, &muted));
+  EXPECT_EQ(1, decoder_.num_decode_calls());
+  EXPECT_EQ(rtp_header.header.timestamp + kPayloadLengthSamples,
+            sync_buffer->end_timestamp());
+}
+
 TEST_F(NetEqImplTest, ReorderedPacket) {
   UseNoMocks();
   CreateInstance();
@@ -749,6 +836,9 @@ TEST_F(NetEqImplTest, CodecInternalCng) {
     ASSERT_EQ(kMaxOutputSize, output.samples_per_channel_);
     EXPECT_EQ(1u, output.num_channels_);
     EXPECT_EQ(expected_type[i - 1], output.speech_type_);
+    // No packets are waiting while playing CNG.
+    EXPECT_EQ(expected_type[i - 1] == AudioFrame::kCNG, neteq_->InDtx())
+        << "i = " << i;
     EXPECT_EQ(NetEq::kOK, neteq_->GetAudio(&output, &muted));
     SCOPED_TRACE("");
     verify_timestamp(neteq_->GetPlayoutTimestamp(), i);
@@ -765,6 +855,8 @@ TEST_F(NetEqImplTest, CodecInternalCng) {
     ASSERT_EQ(kMaxOutputSize, output.samples_per_channel_);
     EXPECT_EQ(1u, output.num_channels_);
     EXPECT_EQ(expected_type[i - 1], output.speech_type_);
+    // The speech packet ends the DTX period, even before it is played out.
+    EXPECT_FALSE(neteq_->InDtx()) << "i = " << i;
     EXPECT_EQ(NetEq::kOK, neteq_->GetAudio(&output, &muted));
     SCOPED_TRACE("");
     verify_timestamp(neteq_->GetPlayoutTimestamp(), i);
@@ -14,6 +14,10 @@ namespace webrtc {
 
 Packet::Packet() = default;
 
+Packet::Packet(Packet&& b) = default;
+
 Packet::~Packet() = default;
 
+Packet& Packet::operator=(Packet&& b) = default;
+
 }  // namespace webrtc
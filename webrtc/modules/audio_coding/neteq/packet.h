@@ -15,6 +15,7 @@
 #include <memory>
 
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/audio_coding/codecs/audio_decoder.h"
 #include "webrtc/modules/audio_coding/neteq/tick_timer.h"
 #include "webrtc/modules/include/module_common_types.h"
@@ -32,8 +33,11 @@ struct Packet {
   std::unique_ptr<AudioDecoder::EncodedAudioFrame> frame;
 
   Packet();
+  Packet(Packet&& b);
   ~Packet();
 
+  Packet& operator=(Packet&& b);
+
   // Comparison operators. Establish a packet ordering based on (1) timestamp,
   // (2) sequence number and (3) redundancy.
   // Timestamp and sequence numbers are compared taking wrap-around into
@@ -64,10 +68,14 @@ struct Packet {
   bool operator>=(const Packet& rhs) const { return !operator<(rhs); }
 
   bool empty() const { return !frame && payload.empty(); }
+
+ private:
+  RTC_DISALLOW_COPY_AND_ASSIGN(Packet);
 };
 
-// A list of packets.
-typedef std::list<Packet*> PacketList;
+// A list of packets. Packets are moved in and out of lists rather than
+// allocated one by one.
+typedef std::list<Packet> PacketList;
 
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_H_
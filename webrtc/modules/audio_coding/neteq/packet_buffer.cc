@@ -8,14 +8,16 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-// This is the implementation of the PacketBuffer class. It is mostly based on
-// an STL list. The list is kept sorted at all times so that the next packet to
-// decode is at the beginning of the list.
+// This is the implementation of the PacketBuffer class. The packets are kept
+// sorted in a ring buffer at all times, so that the next packet to decode is at
+// the front of the ring.
 
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
-#include <algorithm>  // find_if()
+#include <algorithm>  // max()
+#include <utility>
 
+#include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/audio_coding/codecs/audio_decoder.h"
 #include "webrtc/modules/audio_coding/neteq/decoder_database.h"
@@ -23,21 +25,6 @@
 
 namespace webrtc {
 namespace {
-// Predicate used when inserting packets in the buffer list.
-// Operator() returns true when |packet| goes before |new_packet|.
-class NewTimestampIsLarger {
- public:
-  explicit NewTimestampIsLarger(const Packet* new_packet)
-      : new_packet_(new_packet) {
-  }
-  bool operator()(Packet* packet) {
-    return (*new_packet_ >= *packet);
-  }
-
- private:
-  const Packet* new_packet_;
-};
-
 // Returns true if both payload types are known to the decoder database, and
 // have the same sample rate.
 bool EqualSampleRates(uint8_t pt1,
@@ -51,7 +38,9 @@ bool EqualSampleRates(uint8_t pt1,
 
 PacketBuffer::PacketBuffer(size_t max_number_of_packets,
                            const TickTimer* tick_timer)
-    : max_number_of_packets_(max_number_of_packets), tick_timer_(tick_timer) {}
+    : max_number_of_packets_(max_number_of_packets),
+      slots_(std::max(max_number_of_packets, static_cast<size_t>(1))),
+      tick_timer_(tick_timer) {}
 
 // Destructor. All packets in the buffer will be destroyed.
 PacketBuffer::~PacketBuffer() {
@@ -60,59 +49,57 @@ PacketBuffer::~PacketBuffer() {
 
 // Flush the buffer. All packets in the buffer will be destroyed.
 void PacketBuffer::Flush() {
-  DeleteAllPackets(&buffer_);
+  while (!Empty()) {
+    DiscardPacketAt(0);
+  }
 }
 
 bool PacketBuffer::Empty() const {
-  return buffer_.empty();
+  return size_ == 0;
 }
 
-int PacketBuffer::InsertPacket(Packet* packet) {
-  if (!packet || packet->empty()) {
-    if (packet) {
-      delete packet;
-    }
+int PacketBuffer::InsertPacket(Packet&& packet) {
+  if (packet.empty()) {
     LOG(LS_WARNING) << "InsertPacket invalid packet";
     return kInvalidPacket;
   }
 
   int return_val = kOK;
 
-  packet->waiting_time = tick_timer_->GetNewStopwatch();
+  packet.waiting_time = tick_timer_->GetNewStopwatch();
 
-  if (buffer_.size() >= max_number_of_packets_) {
+  if (size_ >= max_number_of_packets_) {
     // Buffer is full. Flush it.
     Flush();
     LOG(LS_WARNING) << "Packet buffer flushed";
     return_val = kFlushed;
   }
 
-  // Get an iterator pointing to the place in the buffer where the new packet
-  // should be inserted. The list is searched from the back, since the most
-  // likely case is that the new packet should be near the end of the list.
-  PacketList::reverse_iterator rit = std::find_if(
-      buffer_.rbegin(), buffer_.rend(),
-      NewTimestampIsLarger(packet));
-
-  // The new packet is to be inserted to the right of |rit|. If it has the same
-  // timestamp as |rit|, which has a higher priority, do not insert the new
-  // packet to list.
-  if (rit != buffer_.rend() &&
-      packet->header.timestamp == (*rit)->header.timestamp) {
-    delete packet;
+  // Find the position in the buffer where the new packet should be inserted.
+  // The buffer is searched from the back, since the most likely case is that
+  // the new packet should be near the end of the buffer.
+  size_t index = size_;
+  while (index > 0 && packet < PacketAt(index - 1)) {
+    --index;
+  }
+
+  // The new packet is to be inserted after |index| - 1. If it has the same
+  // timestamp as that packet, which has a higher priority, do not insert the
+  // new packet.
+  if (index > 0 &&
+      packet.header.timestamp == PacketAt(index - 1).header.timestamp) {
     return return_val;
   }
 
-  // The new packet is to be inserted to the left of |it|. If it has the same
-  // timestamp as |it|, which has a lower priority, replace |it| with the new
-  // packet.
-  PacketList::iterator it = rit.base();
-  if (it != buffer_.end() &&
-      packet->header.timestamp == (*it)->header.timestamp) {
-    delete *it;
-    it = buffer_.erase(it);
+  // The new packet is to be inserted before |index|. If it has the same
+  // timestamp as that packet, which has a lower priority, replace it with the
+  // new packet.
+  if (index < size_ &&
+      packet.header.timestamp == PacketAt(index).header.timestamp) {
+    PacketAt(index) = std::move(packet);
+    return return_val;
   }
-  buffer_.insert(it, packet);  // Insert the packet at that position.
+  InsertPacketAt(index, std::move(packet));
 
   return return_val;
 }
@@ -123,24 +110,23 @@ int PacketBuffer::InsertPacketList(
     rtc::Optional<uint8_t>* current_rtp_payload_type,
     rtc::Optional<uint8_t>* current_cng_rtp_payload_type) {
   bool flushed = false;
-  while (!packet_list->empty()) {
-    Packet* packet = packet_list->front();
-    if (decoder_database.IsComfortNoise(packet->header.payloadType)) {
+  for (auto& packet : *packet_list) {
+    if (decoder_database.IsComfortNoise(packet.header.payloadType)) {
       if (*current_cng_rtp_payload_type &&
-          **current_cng_rtp_payload_type != packet->header.payloadType) {
+          **current_cng_rtp_payload_type != packet.header.payloadType) {
         // New CNG payload type implies new codec type.
         *current_rtp_payload_type = rtc::Optional<uint8_t>();
         Flush();
         flushed = true;
       }
       *current_cng_rtp_payload_type =
-          rtc::Optional<uint8_t>(packet->header.payloadType);
-    } else if (!decoder_database.IsDtmf(packet->header.payloadType)) {
+          rtc::Optional<uint8_t>(packet.header.payloadType);
+    } else if (!decoder_database.IsDtmf(packet.header.payloadType)) {
       // This must be speech.
       if ((*current_rtp_payload_type &&
-           **current_rtp_payload_type != packet->header.payloadType) ||
+           **current_rtp_payload_type != packet.header.payloadType) ||
           (*current_cng_rtp_payload_type &&
-           !EqualSampleRates(packet->header.payloadType,
+           !EqualSampleRates(packet.header.payloadType,
                              **current_cng_rtp_payload_type,
                              decoder_database))) {
         *current_cng_rtp_payload_type = rtc::Optional<uint8_t>();
@@ -148,19 +134,19 @@ int PacketBuffer::InsertPacketList(
         flushed = true;
       }
       *current_rtp_payload_type =
-          rtc::Optional<uint8_t>(packet->header.payloadType);
+          rtc::Optional<uint8_t>(packet.header.payloadType);
     }
-    int return_val = InsertPacket(packet);
-    packet_list->pop_front();
+    int return_val = InsertPacket(std::move(packet));
     if (return_val == kFlushed) {
       // The buffer flushed, but this is not an error. We can still continue.
       flushed = true;
     } else if (return_val != kOK) {
       // An error occurred. Delete remaining packets in list and return.
-      DeleteAllPackets(packet_list);
+      packet_list->clear();
       return return_val;
     }
   }
+  packet_list->clear();
   return flushed ? kFlushed : kOK;
 }
 
@@ -171,7 +157,7 @@ int PacketBuffer::NextTimestamp(uint32_t* next_timestamp) const {
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  *next_timestamp = buffer_.front()->header.timestamp;
+  *next_timestamp = PacketAt(0).header.timestamp;
   return kOK;
 }
 
@@ -183,11 +169,10 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  PacketList::const_iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    if ((*it)->header.timestamp >= timestamp) {
+  for (size_t i = 0; i < size_; ++i) {
+    if (PacketAt(i).header.timestamp >= timestamp) {
       // Found a packet matching the search.
-      *next_timestamp = (*it)->header.timestamp;
+      *next_timestamp = PacketAt(i).header.timestamp;
       return kOK;
     }
   }
@@ -198,26 +183,26 @@ const RTPHeader* PacketBuffer::NextRtpHeader() const {
   if (Empty()) {
     return NULL;
   }
-  return const_cast<const RTPHeader*>(&(buffer_.front()->header));
+  return &PacketAt(0).header;
 }
 
-Packet* PacketBuffer::GetNextPacket(size_t* discard_count) {
+rtc::Optional<Packet> PacketBuffer::GetNextPacket(size_t* discard_count) {
   if (Empty()) {
     // Buffer is empty.
-    return NULL;
+    return rtc::Optional<Packet>();
   }
 
-  Packet* packet = buffer_.front();
   // Assert that the packet sanity checks in InsertPacket method works.
-  RTC_DCHECK(packet && !packet->empty());
-  buffer_.pop_front();
+  RTC_DCHECK(!PacketAt(0).empty());
+  rtc::Optional<Packet> packet(std::move(PacketAt(0)));
+  DiscardPacketAt(0);
 
   // Discard other packets with the same timestamp. These are duplicates or
   // redundant payloads that should not be used.
   size_t discards = 0;
 
   while (!Empty() &&
-      buffer_.front()->header.timestamp == packet->header.timestamp) {
+      PacketAt(0).header.timestamp == packet->header.timestamp) {
     if (DiscardNextPacket() != kOK) {
       assert(false);  // Must be ok by design.
     }
@@ -237,16 +222,15 @@ int PacketBuffer::DiscardNextPacket() {
     return kBufferEmpty;
   }
   // Assert that the packet sanity checks in InsertPacket method works.
-  RTC_DCHECK(buffer_.front());
-  RTC_DCHECK(!buffer_.front()->empty());
-  DeleteFirstPacket(&buffer_);
+  RTC_DCHECK(!PacketAt(0).empty());
+  DiscardPacketAt(0);
   return kOK;
 }
 
 int PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit,
                                     uint32_t horizon_samples) {
-  while (!Empty() && timestamp_limit != buffer_.front()->header.timestamp &&
-         IsObsoleteTimestamp(buffer_.front()->header.timestamp,
+  while (!Empty() && timestamp_limit != PacketAt(0).header.timestamp &&
+         IsObsoleteTimestamp(PacketAt(0).header.timestamp,
                              timestamp_limit,
                              horizon_samples)) {
     if (DiscardNextPacket() != kOK) {
@@ -261,30 +245,29 @@ int PacketBuffer::DiscardAllOldPackets(uint32_t timestamp_limit) {
 }
 
 void PacketBuffer::DiscardPacketsWithPayloadType(uint8_t payload_type) {
-  for (auto it = buffer_.begin(); it != buffer_.end(); /* */) {
-    Packet *packet = *it;
-    if (packet->header.payloadType == payload_type) {
-      delete packet;
-      it = buffer_.erase(it);
+  for (size_t i = 0; i < size_; /* */) {
+    if (PacketAt(i).header.payloadType == payload_type) {
+      DiscardPacketAt(i);
     } else {
-      ++it;
+      ++i;
     }
   }
 }
 
 size_t PacketBuffer::NumPacketsInBuffer() const {
-  return buffer_.size();
+  return size_;
 }
 
 size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
   size_t num_samples = 0;
   size_t last_duration = last_decoded_length;
-  for (Packet* packet : buffer_) {
-    if (packet->frame) {
-      if (!packet->primary) {
+  for (size_t i = 0; i < size_; ++i) {
+    const Packet& packet = PacketAt(i);
+    if (packet.frame) {
+      if (!packet.primary) {
         continue;
       }
-      size_t duration = packet->frame->Duration();
+      size_t duration = packet.frame->Duration();
       if (duration > 0) {
         last_duration = duration;  // Save the most up-to-date (valid) duration.
       }
@@ -294,25 +277,67 @@ size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
   return num_samples;
 }
 
-bool PacketBuffer::DeleteFirstPacket(PacketList* packet_list) {
-  if (packet_list->empty()) {
-    return false;
-  }
-  Packet* first_packet = packet_list->front();
-  delete first_packet;
-  packet_list->pop_front();
-  return true;
+void PacketBuffer::BufferStat(int* num_packets, int* max_num_packets) const {
+  *num_packets = static_cast<int>(size_);
+  *max_num_packets = static_cast<int>(max_number_of_packets_);
 }
 
-void PacketBuffer::DeleteAllPackets(PacketList* packet_list) {
-  while (DeleteFirstPacket(packet_list)) {
-    // Continue while the list is not empty.
+Packet& PacketBuffer::PacketAt(size_t index) {
+  RTC_DCHECK_LT(index, size_);
+  return *slots_[(first_ + index) % slots_.size()];
+}
+
+const Packet& PacketBuffer::PacketAt(size_t index) const {
+  RTC_DCHECK_LT(index, size_);
+  return *slots_[(first_ + index) % slots_.size()];
+}
+
+void PacketBuffer::MovePacket(size_t from, size_t to) {
+  rtc::Optional<Packet>& from_slot = slots_[(first_ + from) % slots_.size()];
+  rtc::Optional<Packet>& to_slot = slots_[(first_ + to) % slots_.size()];
+  RTC_DCHECK(from_slot);
+  RTC_DCHECK(!to_slot);
+  to_slot = std::move(from_slot);
+  // A moved-from packet may only be destroyed.
+  from_slot = rtc::Optional<Packet>();
+}
+
+void PacketBuffer::InsertPacketAt(size_t index, Packet&& packet) {
+  RTC_DCHECK_LE(index, size_);
+  RTC_DCHECK_LT(size_, slots_.size());
+  if (index < size_ / 2) {
+    // Closer to the front; shift the packets before |index| one step towards
+    // the front instead.
+    first_ = (first_ + slots_.size() - 1) % slots_.size();
+    for (size_t i = 0; i < index; ++i) {
+      MovePacket(i + 1, i);
+    }
+  } else {
+    for (size_t i = size_; i > index; --i) {
+      MovePacket(i - 1, i);
+    }
   }
+  slots_[(first_ + index) % slots_.size()] =
+      rtc::Optional<Packet>(std::move(packet));
+  ++size_;
 }
 
-void PacketBuffer::BufferStat(int* num_packets, int* max_num_packets) const {
-  *num_packets = static_cast<int>(buffer_.size());
-  *max_num_packets = static_cast<int>(max_number_of_packets_);
+void PacketBuffer::DiscardPacketAt(size_t index) {
+  RTC_DCHECK_LT(index, size_);
+  slots_[(first_ + index) % slots_.size()] = rtc::Optional<Packet>();
+  if (index < size_ / 2) {
+    // Closer to the front; shift the packets before |index| one step towards
+    // the back.
+    for (size_t i = index; i > 0; --i) {
+      MovePacket(i - 1, i);
+    }
+    first_ = (first_ + 1) % slots_.size();
+  } else {
+    for (size_t i = index; i + 1 < size_; ++i) {
+      MovePacket(i + 1, i);
+    }
+  }
+  --size_;
 }
 
 }  // namespace webrtc
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 #define WEBRTC_MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 
+#include <vector>
+
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/optional.h"
 #include "webrtc/modules/audio_coding/neteq/packet.h"
@@ -46,14 +48,13 @@ class PacketBuffer {
   // Returns true for an empty buffer.
   virtual bool Empty() const;
 
-  // Inserts |packet| into the buffer. The buffer will take over ownership of
-  // the packet object.
+  // Inserts |packet| into the buffer. The packet is moved into the buffer.
   // Returns PacketBuffer::kOK on success, PacketBuffer::kFlushed if the buffer
   // was flushed due to overfilling.
-  virtual int InsertPacket(Packet* packet);
+  virtual int InsertPacket(Packet&& packet);
 
-  // Inserts a list of packets into the buffer. The buffer will take over
-  // ownership of the packet objects.
+  // Inserts a list of packets into the buffer. The packets are moved out of
+  // |packet_list| into the buffer.
   // Returns PacketBuffer::kOK if all packets were inserted successfully.
   // If the buffer was flushed due to overfilling, only a subset of the list is
   // inserted, and PacketBuffer::kFlushed is returned.
@@ -84,15 +85,14 @@ class PacketBuffer {
   // buffer. Returns NULL if the buffer is empty.
   virtual const RTPHeader* NextRtpHeader() const;
 
-  // Extracts the first packet in the buffer and returns a pointer to it.
-  // Returns NULL if the buffer is empty. The caller is responsible for deleting
-  // the packet.
+  // Extracts the first packet in the buffer and returns it. Returns an empty
+  // optional if the buffer is empty.
   // Subsequent packets with the same timestamp as the one extracted will be
-  // discarded and properly deleted. The number of discarded packets will be
-  // written to the output variable |discard_count|.
-  virtual Packet* GetNextPacket(size_t* discard_count);
+  // discarded. The number of discarded packets will be written to the output
+  // variable |discard_count|.
+  virtual rtc::Optional<Packet> GetNextPacket(size_t* discard_count);
 
-  // Discards the first packet in the buffer. The packet is deleted.
+  // Discards the first packet in the buffer.
   // Returns PacketBuffer::kBufferEmpty if the buffer is empty,
   // PacketBuffer::kOK otherwise.
   virtual int DiscardNextPacket();
@@ -122,15 +122,6 @@ class PacketBuffer {
 
   virtual void BufferStat(int* num_packets, int* max_num_packets) const;
 
-  // Static method that properly deletes the first packet, and its payload
-  // array, in |packet_list|. Returns false if |packet_list| already was empty,
-  // otherwise true.
-  static bool DeleteFirstPacket(PacketList* packet_list);
-
-  // Static method that properly deletes all packets, and their payload arrays,
-  // in |packet_list|.
-  static void DeleteAllPackets(PacketList* packet_list);
-
   // Static method returning true if |timestamp| is older than |timestamp_limit|
   // but less than |horizon_samples| behind |timestamp_limit|. For instance,
   // with timestamp_limit = 100 and horizon_samples = 10, a timestamp in the
@@ -146,8 +137,29 @@ class PacketBuffer {
   }
 
  private:
+  // Returns the packet at position |index|, counted from the next packet to
+  // decode.
+  Packet& PacketAt(size_t index);
+  const Packet& PacketAt(size_t index) const;
+  // Moves the packet at position |from| to the empty position |to|, leaving
+  // |from| empty.
+  void MovePacket(size_t from, size_t to);
+  // Moves |packet| into position |index|, shifting the packets from |index|
+  // onwards one step towards the back of the buffer.
+  void InsertPacketAt(size_t index, Packet&& packet);
+  // Discards the packet at position |index|, shifting the packets after it one
+  // step towards the front of the buffer.
+  void DiscardPacketAt(size_t index);
+
   size_t max_number_of_packets_;
-  PacketList buffer_;
+  // The packets are kept sorted in a ring of |max_number_of_packets_| slots,
+  // allocated once, so that inserting and extracting packets moves them
+  // between slots instead of allocating list nodes. |first_| is the slot of
+  // the next packet to decode, and |size_| the number of packets. Slots that
+  // do not hold a packet are empty.
+  std::vector<rtc::Optional<Packet>> slots_;
+  size_t first_ = 0;
+  size_t size_ = 0;
   const TickTimer* tick_timer_;
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
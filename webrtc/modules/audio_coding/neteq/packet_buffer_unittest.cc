@@ -12,6 +12,8 @@
 
 #include "webrtc/modules/audio_coding/neteq/packet_buffer.h"
 
+#include <utility>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_coding/codecs/builtin_audio_decoder_factory.h"
@@ -24,13 +26,13 @@ using ::testing::_;
 
 namespace webrtc {
 
-// Helper class to generate packets. Packets must be deleted by the user.
+// Helper class to generate packets.
 class PacketGenerator {
  public:
   PacketGenerator(uint16_t seq_no, uint32_t ts, uint8_t pt, int frame_size);
   virtual ~PacketGenerator() {}
   void Reset(uint16_t seq_no, uint32_t ts, uint8_t pt, int frame_size);
-  Packet* NextPacket(int payload_size_bytes);
+  Packet NextPacket(int payload_size_bytes);
 
   uint16_t seq_no_;
   uint32_t ts_;
@@ -51,17 +53,17 @@ void PacketGenerator::Reset(uint16_t seq_no, uint32_t ts, uint8_t pt,
   frame_size_ = frame_size;
 }
 
-Packet* PacketGenerator::NextPacket(int payload_size_bytes) {
-  Packet* packet = new Packet;
-  packet->header.sequenceNumber = seq_no_;
-  packet->header.timestamp = ts_;
-  packet->header.payloadType = pt_;
-  packet->header.markerBit = false;
-  packet->header.ssrc = 0x12345678;
-  packet->header.numCSRCs = 0;
-  packet->header.paddingLength = 0;
-  packet->primary = true;
-  packet->payload.SetSize(payload_size_bytes);
+Packet PacketGenerator::NextPacket(int payload_size_bytes) {
+  Packet packet;
+  packet.header.sequenceNumber = seq_no_;
+  packet.header.timestamp = ts_;
+  packet.header.payloadType = pt_;
+  packet.header.markerBit = false;
+  packet.header.ssrc = 0x12345678;
+  packet.header.numCSRCs = 0;
+  packet.header.paddingLength = 0;
+  packet.primary = true;
+  packet.payload.SetSize(payload_size_bytes);
   ++seq_no_;
   ts_ += frame_size_;
   return packet;
@@ -93,16 +95,19 @@ TEST(PacketBuffer, InsertPacket) {
   PacketGenerator gen(17u, 4711u, 0, 10);
 
   const int payload_len = 100;
-  Packet* packet = gen.NextPacket(payload_len);
+  Packet packet = gen.NextPacket(payload_len);
+  const RTPHeader header = packet.header;
 
-  EXPECT_EQ(0, buffer.InsertPacket(packet));
+  EXPECT_EQ(0, buffer.InsertPacket(std::move(packet)));
   uint32_t next_ts;
   EXPECT_EQ(PacketBuffer::kOK, buffer.NextTimestamp(&next_ts));
   EXPECT_EQ(4711u, next_ts);
   EXPECT_FALSE(buffer.Empty());
   EXPECT_EQ(1u, buffer.NumPacketsInBuffer());
   const RTPHeader* hdr = buffer.NextRtpHeader();
-  EXPECT_EQ(&(packet->header), hdr);  // Compare pointer addresses.
+  ASSERT_TRUE(hdr);
+  EXPECT_EQ(header.sequenceNumber, hdr->sequenceNumber);
+  EXPECT_EQ(header.payloadType, hdr->payloadType);
 
   // Do not explicitly flush buffer or delete packet to test that it is deleted
   // with the buffer. (Tested with Valgrind or similar tool.)
@@ -117,8 +122,8 @@ TEST(PacketBuffer, FlushBuffer) {
 
   // Insert 10 small packets; should be ok.
   for (int i = 0; i < 10; ++i) {
-    Packet* packet = gen.NextPacket(payload_len);
-    EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(packet));
+    EXPECT_EQ(PacketBuffer::kOK,
+              buffer.InsertPacket(gen.NextPacket(payload_len)));
   }
   EXPECT_EQ(10u, buffer.NumPacketsInBuffer());
   EXPECT_FALSE(buffer.Empty());
@@ -139,8 +144,8 @@ TEST(PacketBuffer, OverfillBuffer) {
   const int payload_len = 10;
   int i;
   for (i = 0; i < 10; ++i) {
-    Packet* packet = gen.NextPacket(payload_len);
-    EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(packet));
+    EXPECT_EQ(PacketBuffer::kOK,
+              buffer.InsertPacket(gen.NextPacket(payload_len)));
   }
   EXPECT_EQ(10u, buffer.NumPacketsInBuffer());
   uint32_t next_ts;
@@ -148,12 +153,13 @@ TEST(PacketBuffer, OverfillBuffer) {
   EXPECT_EQ(0u, next_ts);  // Expect first inserted packet to be first in line.
 
   // Insert 11th packet; should flush the buffer and insert it after flushing.
-  Packet* packet = gen.NextPacket(payload_len);
-  EXPECT_EQ(PacketBuffer::kFlushed, buffer.InsertPacket(packet));
+  Packet packet = gen.NextPacket(payload_len);
+  const uint32_t timestamp = packet.header.timestamp;
+  EXPECT_EQ(PacketBuffer::kFlushed, buffer.InsertPacket(std::move(packet)));
   EXPECT_EQ(1u, buffer.NumPacketsInBuffer());
   EXPECT_EQ(PacketBuffer::kOK, buffer.NextTimestamp(&next_ts));
   // Expect last inserted packet to be first in line.
-  EXPECT_EQ(packet->header.timestamp, next_ts);
+  EXPECT_EQ(timestamp, next_ts);
 
   // Flush buffer to delete all packets.
   buffer.Flush();
@@ -169,8 +175,7 @@ TEST(PacketBuffer, InsertPacketList) {
 
   // Insert 10 small packets.
   for (int i = 0; i < 10; ++i) {
-    Packet* packet = gen.NextPacket(payload_len);
-    list.push_back(packet);
+    list.push_back(gen.NextPacket(payload_len));
   }
 
   MockDecoderDatabase decoder_database;
@@ -208,13 +213,12 @@ TEST(PacketBuffer, InsertPacketListChangePayloadType) {
 
   // Insert 10 small packets.
   for (int i = 0; i < 10; ++i) {
-    Packet* packet = gen.NextPacket(payload_len);
-    list.push_back(packet);
+    list.push_back(gen.NextPacket(payload_len));
   }
   // Insert 11th packet of another payload type (not CNG).
-  Packet* packet = gen.NextPacket(payload_len);
-  packet->header.payloadType = 1;
-  list.push_back(packet);
+  Packet packet = gen.NextPacket(payload_len);
+  packet.header.payloadType = 1;
+  list.push_back(std::move(packet));
 
 
   MockDecoderDatabase decoder_database;
@@ -274,7 +278,7 @@ TEST(PacketBuffer, ExtractOrderRedundancy) {
 
   const size_t kExpectPacketsInBuffer = 9;
 
-  std::vector<Packet*> expect_order(kExpectPacketsInBuffer);
+  std::vector<Packet> expect_order(kExpectPacketsInBuffer);
 
   PacketGenerator gen(0, 0, 0, kFrameSize);
 
@@ -283,22 +287,25 @@ TEST(PacketBuffer, ExtractOrderRedundancy) {
               packet_facts[i].timestamp,
               packet_facts[i].payload_type,
               kFrameSize);
-    Packet* packet = gen.NextPacket(kPayloadLength);
-    packet->primary = packet_facts[i].primary;
-    EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(packet));
+    Packet packet = gen.NextPacket(kPayloadLength);
+    packet.primary = packet_facts[i].primary;
     if (packet_facts[i].extract_order >= 0) {
-      expect_order[packet_facts[i].extract_order] = packet;
+      // Keep the header and redundancy of the packet to compare with.
+      Packet& expected = expect_order[packet_facts[i].extract_order];
+      expected.header = packet.header;
+      expected.primary = packet.primary;
     }
+    EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(std::move(packet)));
   }
 
   EXPECT_EQ(kExpectPacketsInBuffer, buffer.NumPacketsInBuffer());
 
   size_t drop_count;
   for (size_t i = 0; i < kExpectPacketsInBuffer; ++i) {
-    Packet* packet = buffer.GetNextPacket(&drop_count);
+    rtc::Optional<Packet> packet = buffer.GetNextPacket(&drop_count);
+    ASSERT_TRUE(packet);
     EXPECT_EQ(0u, drop_count);
-    EXPECT_EQ(packet, expect_order[i]);  // Compare pointer addresses.
-    delete packet;
+    EXPECT_TRUE(*packet == expect_order[i]);
   }
   EXPECT_TRUE(buffer.Empty());
 }
@@ -315,8 +322,7 @@ TEST(PacketBuffer, DiscardPackets) {
 
   // Insert 10 small packets.
   for (int i = 0; i < 10; ++i) {
-    Packet* packet = gen.NextPacket(payload_len);
-    buffer.InsertPacket(packet);
+    buffer.InsertPacket(gen.NextPacket(payload_len));
   }
   EXPECT_EQ(10u, buffer.NumPacketsInBuffer());
 
@@ -347,11 +353,11 @@ TEST(PacketBuffer, Reordering) {
   // a (rather strange) reordering.
   PacketList list;
   for (int i = 0; i < 10; ++i) {
-    Packet* packet = gen.NextPacket(payload_len);
+    Packet packet = gen.NextPacket(payload_len);
     if (i % 2) {
-      list.push_front(packet);
+      list.push_front(std::move(packet));
     } else {
-      list.push_back(packet);
+      list.push_back(std::move(packet));
     }
   }
 
@@ -373,11 +379,10 @@ TEST(PacketBuffer, Reordering) {
   // Extract them and make sure that come out in the right order.
   uint32_t current_ts = start_ts;
   for (int i = 0; i < 10; ++i) {
-    Packet* packet = buffer.GetNextPacket(NULL);
-    ASSERT_FALSE(packet == NULL);
+    rtc::Optional<Packet> packet = buffer.GetNextPacket(NULL);
+    ASSERT_TRUE(packet);
     EXPECT_EQ(current_ts, packet->header.timestamp);
     current_ts += ts_increment;
-    delete packet;
   }
   EXPECT_TRUE(buffer.Empty());
 
@@ -424,9 +429,9 @@ TEST(PacketBuffer, CngFirstThenSpeechWithNewSampleRate) {
             current_cng_pt);  // CNG payload type set.
 
   // Insert second packet, which is wide-band speech.
-  Packet* packet = gen.NextPacket(kPayloadLen);
-  packet->header.payloadType = kSpeechPt;
-  list.push_back(packet);
+  Packet packet = gen.NextPacket(kPayloadLen);
+  packet.header.payloadType = kSpeechPt;
+  list.push_back(std::move(packet));
   // Expect the buffer to flush out the CNG packet, since it does not match the
   // new speech sample rate.
   EXPECT_EQ(PacketBuffer::kFlushed,
@@ -454,12 +459,10 @@ TEST(PacketBuffer, Failures) {
   TickTimer tick_timer;
 
   PacketBuffer* buffer = new PacketBuffer(100, &tick_timer);  // 100 packets.
-  Packet* packet = NULL;
-  EXPECT_EQ(PacketBuffer::kInvalidPacket, buffer->InsertPacket(packet));
-  packet = gen.NextPacket(payload_len);
-  packet->payload.Clear();
-  EXPECT_EQ(PacketBuffer::kInvalidPacket, buffer->InsertPacket(packet));
-  // Packet is deleted by the PacketBuffer.
+  Packet invalid_packet = gen.NextPacket(payload_len);
+  invalid_packet.payload.Clear();
+  EXPECT_EQ(PacketBuffer::kInvalidPacket,
+            buffer->InsertPacket(std::move(invalid_packet)));
 
   // Buffer should still be empty. Test all empty-checks.
   uint32_t temp_ts;
@@ -467,13 +470,13 @@ TEST(PacketBuffer, Failures) {
   EXPECT_EQ(PacketBuffer::kBufferEmpty,
             buffer->NextHigherTimestamp(0, &temp_ts));
   EXPECT_EQ(NULL, buffer->NextRtpHeader());
-  EXPECT_EQ(NULL, buffer->GetNextPacket(NULL));
+  EXPECT_FALSE(buffer->GetNextPacket(NULL));
   EXPECT_EQ(PacketBuffer::kBufferEmpty, buffer->DiscardNextPacket());
   EXPECT_EQ(0, buffer->DiscardAllOldPackets(0));  // 0 packets discarded.
 
   // Insert one packet to make the buffer non-empty.
-  packet = gen.NextPacket(payload_len);
-  EXPECT_EQ(PacketBuffer::kOK, buffer->InsertPacket(packet));
+  EXPECT_EQ(PacketBuffer::kOK,
+            buffer->InsertPacket(gen.NextPacket(payload_len)));
   EXPECT_EQ(PacketBuffer::kInvalidPointer, buffer->NextTimestamp(NULL));
   EXPECT_EQ(PacketBuffer::kInvalidPointer,
             buffer->NextHigherTimestamp(0, NULL));
@@ -485,9 +488,9 @@ TEST(PacketBuffer, Failures) {
   buffer = new PacketBuffer(100, &tick_timer);  // 100 packets.
   PacketList list;
   list.push_back(gen.NextPacket(payload_len));  // Valid packet.
-  packet = gen.NextPacket(payload_len);
-  packet->payload.Clear();  // Invalid.
-  list.push_back(packet);
+  Packet packet = gen.NextPacket(payload_len);
+  packet.payload.Clear();  // Invalid.
+  list.push_back(std::move(packet));
   list.push_back(gen.NextPacket(payload_len));  // Valid packet.
   MockDecoderDatabase decoder_database;
   auto factory = CreateBuiltinAudioDecoderFactory();
@@ -512,81 +515,97 @@ TEST(PacketBuffer, Failures) {
 // The function should return true if the first packet "goes before" the second.
 TEST(PacketBuffer, ComparePackets) {
   PacketGenerator gen(0, 0, 0, 10);
-  Packet* a = gen.NextPacket(10);  // SN = 0, TS = 0.
-  Packet* b = gen.NextPacket(10);  // SN = 1, TS = 10.
-  EXPECT_FALSE(*a == *b);
-  EXPECT_TRUE(*a != *b);
-  EXPECT_TRUE(*a < *b);
-  EXPECT_FALSE(*a > *b);
-  EXPECT_TRUE(*a <= *b);
-  EXPECT_FALSE(*a >= *b);
+  Packet a = gen.NextPacket(10);  // SN = 0, TS = 0.
+  Packet b = gen.NextPacket(10);  // SN = 1, TS = 10.
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a < b);
+  EXPECT_FALSE(a > b);
+  EXPECT_TRUE(a <= b);
+  EXPECT_FALSE(a >= b);
 
   // Testing wrap-around case; 'a' is earlier but has a larger timestamp value.
-  a->header.timestamp = 0xFFFFFFFF - 10;
-  EXPECT_FALSE(*a == *b);
-  EXPECT_TRUE(*a != *b);
-  EXPECT_TRUE(*a < *b);
-  EXPECT_FALSE(*a > *b);
-  EXPECT_TRUE(*a <= *b);
-  EXPECT_FALSE(*a >= *b);
+  a.header.timestamp = 0xFFFFFFFF - 10;
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a < b);
+  EXPECT_FALSE(a > b);
+  EXPECT_TRUE(a <= b);
+  EXPECT_FALSE(a >= b);
 
   // Test equal packets.
-  EXPECT_TRUE(*a == *a);
-  EXPECT_FALSE(*a != *a);
-  EXPECT_FALSE(*a < *a);
-  EXPECT_FALSE(*a > *a);
-  EXPECT_TRUE(*a <= *a);
-  EXPECT_TRUE(*a >= *a);
+  EXPECT_TRUE(a == a);
+  EXPECT_FALSE(a != a);
+  EXPECT_FALSE(a < a);
+  EXPECT_FALSE(a > a);
+  EXPECT_TRUE(a <= a);
+  EXPECT_TRUE(a >= a);
 
   // Test equal timestamps but different sequence numbers (0 and 1).
-  a->header.timestamp = b->header.timestamp;
-  EXPECT_FALSE(*a == *b);
-  EXPECT_TRUE(*a != *b);
-  EXPECT_TRUE(*a < *b);
-  EXPECT_FALSE(*a > *b);
-  EXPECT_TRUE(*a <= *b);
-  EXPECT_FALSE(*a >= *b);
+  a.header.timestamp = b.header.timestamp;
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a < b);
+  EXPECT_FALSE(a > b);
+  EXPECT_TRUE(a <= b);
+  EXPECT_FALSE(a >= b);
 
   // Test equal timestamps but different sequence numbers (32767 and 1).
-  a->header.sequenceNumber = 0xFFFF;
-  EXPECT_FALSE(*a == *b);
-  EXPECT_TRUE(*a != *b);
-  EXPECT_TRUE(*a < *b);
-  EXPECT_FALSE(*a > *b);
-  EXPECT_TRUE(*a <= *b);
-  EXPECT_FALSE(*a >= *b);
+  a.header.sequenceNumber = 0xFFFF;
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a < b);
+  EXPECT_FALSE(a > b);
+  EXPECT_TRUE(a <= b);
+  EXPECT_FALSE(a >= b);
 
   // Test equal timestamps and sequence numbers, but only 'b' is primary.
-  a->header.sequenceNumber = b->header.sequenceNumber;
-  a->primary = false;
-  b->primary = true;
-  EXPECT_FALSE(*a == *b);
-  EXPECT_TRUE(*a != *b);
-  EXPECT_FALSE(*a < *b);
-  EXPECT_TRUE(*a > *b);
-  EXPECT_FALSE(*a <= *b);
-  EXPECT_TRUE(*a >= *b);
-
-  delete a;
-  delete b;
+  a.header.sequenceNumber = b.header.sequenceNumber;
+  a.primary = false;
+  b.primary = true;
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+  EXPECT_FALSE(a < b);
+  EXPECT_TRUE(a > b);
+  EXPECT_FALSE(a <= b);
+  EXPECT_TRUE(a >= b);
 }
 
-// Test the DeleteFirstPacket DeleteAllPackets methods.
-TEST(PacketBuffer, DeleteAllPackets) {
-  PacketGenerator gen(0, 0, 0, 10);
-  PacketList list;
+// Test that packets keep their order while the buffer is filled and drained
+// many times over, so that the packets wrap around the ends of the buffer.
+TEST(PacketBuffer, WrapAround) {
+  TickTimer tick_timer;
+  PacketBuffer buffer(5, &tick_timer);  // 5 packets.
+  const uint32_t ts_increment = 10;
+  const int kPacketsPerRound = 4;
+  PacketGenerator gen(0, 0, 0, ts_increment);
   const int payload_len = 10;
 
-  // Insert 10 small packets.
-  for (int i = 0; i < 10; ++i) {
-    Packet* packet = gen.NextPacket(payload_len);
-    list.push_back(packet);
+  uint32_t next_ts = 0;
+  for (int i = 0; i < 20; ++i) {
+    // Insert four packets in reverse order, and extract three of them.
+    std::vector<Packet> packets(kPacketsPerRound);
+    for (auto& packet : packets) {
+      packet = gen.NextPacket(payload_len);
+    }
+    for (auto it = packets.rbegin(); it != packets.rend(); ++it) {
+      EXPECT_EQ(PacketBuffer::kOK, buffer.InsertPacket(std::move(*it)));
+    }
+    for (int j = 0; j < kPacketsPerRound - 1; ++j) {
+      rtc::Optional<Packet> packet = buffer.GetNextPacket(NULL);
+      ASSERT_TRUE(packet);
+      EXPECT_EQ(next_ts, packet->header.timestamp);
+      next_ts += ts_increment;
+    }
+    // Drop the packets left over every other round, to keep the buffer from
+    // overfilling.
+    if (i % 2) {
+      EXPECT_EQ(2u, buffer.NumPacketsInBuffer());
+      buffer.DiscardPacketsWithPayloadType(0);
+      EXPECT_TRUE(buffer.Empty());
+      next_ts += 2 * ts_increment;
+    }
   }
-  EXPECT_TRUE(PacketBuffer::DeleteFirstPacket(&list));
-  EXPECT_EQ(9u, list.size());
-  PacketBuffer::DeleteAllPackets(&list);
-  EXPECT_TRUE(list.empty());
-  EXPECT_FALSE(PacketBuffer::DeleteFirstPacket(&list));
 }
 
 namespace {
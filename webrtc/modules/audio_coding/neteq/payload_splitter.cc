@@ -11,6 +11,10 @@
 #include "webrtc/modules/audio_coding/neteq/payload_splitter.h"
 
 #include <assert.h>
+#include <string.h>  // memmove
+
+#include <iterator>
+#include <utility>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
@@ -19,19 +23,21 @@
 namespace webrtc {
 
 // The method loops through a list of packets {A, B, C, ...}. Each packet is
-// split into its corresponding RED payloads, {A1, A2, ...}, which is
-// temporarily held in the list |new_packets|.
-// When the first packet in |packet_list| has been processed, the orignal packet
-// is replaced by the new ones in |new_packets|, so that |packet_list| becomes:
+// split into its corresponding RED payloads, {A1, A2, ...}. The primary
+// payload, which is the last block of the RED packet, is moved to the front of
+// the payload buffer of the original packet, which is then reused for it. The
+// redundant payloads are inserted after it, so that |packet_list| becomes:
 // {A1, A2, ..., B, C, ...}. The method then continues with B, and C, until all
 // the original packets have been replaced by their split payloads.
 int PayloadSplitter::SplitRed(PacketList* packet_list) {
   int ret = kOK;
   PacketList::iterator it = packet_list->begin();
   while (it != packet_list->end()) {
-    const Packet* red_packet = (*it);
+    Packet* red_packet = &(*it);
     assert(!red_packet->payload.empty());
-    const uint8_t* payload_ptr = red_packet->payload.data();
+    const uint8_t* header_ptr = red_packet->payload.data();
+    const uint8_t* const payload_end = header_ptr + red_packet->payload.size();
+    const PacketList::iterator next_packet = std::next(it);
 
     // Read RED headers (according to RFC 2198):
     //
@@ -46,79 +52,57 @@ int PayloadSplitter::SplitRed(PacketList* packet_list) {
     //   |0|   Block PT  |
     //   +-+-+-+-+-+-+-+-+
 
-    struct RedHeader {
-      uint8_t payload_type;
-      uint32_t timestamp;
-      size_t payload_length;
-      bool primary;
-    };
-
-    std::vector<RedHeader> new_headers;
-    bool last_block = false;
-    size_t sum_length = 0;
-    while (!last_block) {
-      RedHeader new_header;
-      // Check the F bit. If F == 0, this was the last block.
-      last_block = ((*payload_ptr & 0x80) == 0);
-      // Bits 1 through 7 are payload type.
-      new_header.payload_type = payload_ptr[0] & 0x7F;
-      if (last_block) {
-        // No more header data to read.
-        ++sum_length;  // Account for RED header size of 1 byte.
-        new_header.timestamp = red_packet->header.timestamp;
-        new_header.payload_length = red_packet->payload.size() - sum_length;
-        new_header.primary = true;  // Last block is always primary.
-        payload_ptr += 1;  // Advance to first payload byte.
-      } else {
-        // Bits 8 through 21 are timestamp offset.
-        int timestamp_offset = (payload_ptr[1] << 6) +
-            ((payload_ptr[2] & 0xFC) >> 2);
-        new_header.timestamp = red_packet->header.timestamp - timestamp_offset;
-        // Bits 22 through 31 are payload length.
-        new_header.payload_length =
-            ((payload_ptr[2] & 0x03) << 8) + payload_ptr[3];
-        new_header.primary = false;
-        payload_ptr += 4;  // Advance to next RED header.
-      }
-      sum_length += new_header.payload_length;
-      sum_length += 4;  // Account for RED header size of 4 bytes.
-      // Store in new list of packets.
-      new_headers.push_back(new_header);
+    // Find the first payload byte, which follows the last RED header. The F
+    // bit is 0 in the last header.
+    const uint8_t* payload_ptr = header_ptr;
+    while (payload_ptr < payload_end && (*payload_ptr & 0x80) != 0) {
+      payload_ptr += 4;
     }
+    ++payload_ptr;
 
-    // Populate the new packets with payload data.
-    // |payload_ptr| now points at the first payload byte.
-    PacketList new_packets;  // An empty list to store the split packets in.
-    for (const auto& new_header : new_headers) {
-      size_t payload_length = new_header.payload_length;
-      if (payload_ptr + payload_length >
-          red_packet->payload.data() + red_packet->payload.size()) {
-        // The block lengths in the RED headers do not match the overall packet
-        // length. Something is corrupt. Discard this and the remaining
-        // payloads from this packet.
-        LOG(LS_WARNING) << "SplitRed length mismatch";
-        ret = kRedLengthMismatch;
+    // Create packets for the redundant payloads. Each one is inserted before
+    // the previous one, so that the most recent redundant payload comes first.
+    PacketList::iterator insert_position = next_packet;
+    bool length_mismatch = payload_ptr > payload_end;
+    while (!length_mismatch && (*header_ptr & 0x80) != 0) {
+      Packet new_packet;
+      new_packet.header = red_packet->header;
+      // Bits 1 through 7 are payload type.
+      new_packet.header.payloadType = header_ptr[0] & 0x7F;
+      // Bits 8 through 21 are timestamp offset.
+      int timestamp_offset = (header_ptr[1] << 6) +
+          ((header_ptr[2] & 0xFC) >> 2);
+      new_packet.header.timestamp -= timestamp_offset;
+      // Bits 22 through 31 are payload length.
+      size_t payload_length = ((header_ptr[2] & 0x03) << 8) + header_ptr[3];
+      new_packet.primary = false;
+      header_ptr += 4;  // Advance to next RED header.
+      if (payload_length > static_cast<size_t>(payload_end - payload_ptr)) {
+        length_mismatch = true;
         break;
       }
-      Packet* new_packet = new Packet;
-      new_packet->header = red_packet->header;
-      new_packet->header.timestamp = new_header.timestamp;
-      new_packet->header.payloadType = new_header.payload_type;
-      new_packet->primary = new_header.primary;
-      new_packet->payload.SetData(payload_ptr, payload_length);
-      new_packets.push_front(new_packet);
+      new_packet.payload.SetData(payload_ptr, payload_length);
       payload_ptr += payload_length;
+      insert_position = packet_list->insert(insert_position,
+                                            std::move(new_packet));
     }
-    // Insert new packets into original list, before the element pointed to by
-    // iterator |it|.
-    packet_list->splice(it, new_packets, new_packets.begin(),
-                        new_packets.end());
-    // Delete old packet payload.
-    delete (*it);
-    // Remove |it| from the packet list. This operation effectively moves the
-    // iterator |it| to the next packet in the list. Thus, we do not have to
-    // increment it manually.
-    it = packet_list->erase(it);
+
+    if (length_mismatch) {
+      // The block lengths in the RED headers do not match the overall packet
+      // length. Something is corrupt. Discard this and the remaining
+      // payloads from this packet.
+      LOG(LS_WARNING) << "SplitRed length mismatch";
+      ret = kRedLengthMismatch;
+      packet_list->erase(it);
+    } else {
+      // Turn the RED packet into the primary payload, in place.
+      red_packet->header.payloadType = header_ptr[0] & 0x7F;
+      red_packet->primary = true;  // Last block is always primary.
+      const size_t payload_length = payload_end - payload_ptr;
+      memmove(red_packet->payload.data(), payload_ptr, payload_length);
+      red_packet->payload.SetSize(payload_length);
+    }
+    it = next_packet;
   }
   return ret;
 }
@@ -128,7 +112,7 @@ int PayloadSplitter::SplitFec(PacketList* packet_list,
   PacketList::iterator it = packet_list->begin();
   // Iterate through all packets in |packet_list|.
   while (it != packet_list->end()) {
-    Packet* packet = (*it);  // Just to make the notation more intuitive.
+    Packet* packet = &(*it);  // Just to make the notation more intuitive.
     // Get codec type for this payload.
     uint8_t payload_type = packet->header.payloadType;
     const DecoderDatabase::DecoderInfo* info =
@@ -157,17 +141,17 @@ int PayloadSplitter::SplitFec(PacketList* packet_list,
         // payload, even if it comes as a secondary payload in a RED packet.
         packet->primary = true;
 
-        Packet* new_packet = new Packet;
-        new_packet->header = packet->header;
+        Packet new_packet;
+        new_packet.header = packet->header;
         int duration = decoder->PacketDurationRedundant(packet->payload.data(),
                                                         packet->payload.size());
-        new_packet->header.timestamp -= duration;
-        new_packet->payload.SetData(packet->payload);
-        new_packet->primary = false;
+        new_packet.header.timestamp -= duration;
+        new_packet.payload.SetData(packet->payload);
+        new_packet.primary = false;
         // Waiting time should not be set here.
         RTC_DCHECK(!packet->waiting_time);
 
-        packet_list->insert(it, new_packet);
+        packet_list->insert(it, std::move(new_packet));
         break;
       }
       default: {
@@ -187,7 +171,7 @@ int PayloadSplitter::CheckRedPayloads(PacketList* packet_list,
   int main_payload_type = -1;
   int num_deleted_packets = 0;
   while (it != packet_list->end()) {
-    uint8_t this_payload_type = (*it)->header.payloadType;
+    uint8_t this_payload_type = it->header.payloadType;
     if (!decoder_database.IsDtmf(this_payload_type) &&
         !decoder_database.IsComfortNoise(this_payload_type)) {
       if (main_payload_type == -1) {
@@ -197,7 +181,6 @@ int PayloadSplitter::CheckRedPayloads(PacketList* packet_list,
         if (this_payload_type != main_payload_type) {
           // We do not allow redundant payloads of a different type.
           // Discard this payload.
-          delete (*it);
           // Remove |it| from the packet list. This operation effectively
           // moves the iterator |it| to the next packet in the list. Thus, we
           // do not have to increment it manually.
@@ -217,7 +200,7 @@ int PayloadSplitter::SplitAudio(PacketList* packet_list,
   PacketList::iterator it = packet_list->begin();
   // Iterate through all packets in |packet_list|.
   while (it != packet_list->end()) {
-    Packet* packet = (*it);  // Just to make the notation more intuitive.
+    Packet* packet = &(*it);  // Just to make the notation more intuitive.
     // Get codec type for this payload.
     const DecoderDatabase::DecoderInfo* info =
         decoder_database.GetDecoderInfo(packet->header.payloadType);
@@ -331,15 +314,18 @@ int PayloadSplitter::SplitAudio(PacketList* packet_list,
         continue;
       }
     }
+    if (new_packets.empty()) {
+      // The payload was not split. Keep the original packet.
+      ++it;
+      continue;
+    }
     // Insert new packets into original list, before the element pointed to by
     // iterator |it|.
     packet_list->splice(it, new_packets, new_packets.begin(),
                         new_packets.end());
-    // Delete old packet payload.
-    delete (*it);
-    // Remove |it| from the packet list. This operation effectively moves the
-    // iterator |it| to the next packet in the list. Thus, we do not have to
-    // increment it manually.
+    // Remove the old packet from the packet list. This operation effectively
+    // moves the iterator |it| to the next packet in the list. Thus, we do not
+    // have to increment it manually.
     it = packet_list->erase(it);
   }
   return kOK;
@@ -362,6 +348,10 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
   while (split_size_bytes >= 2 * min_chunk_size) {
     split_size_bytes >>= 1;
   }
+  if (split_size_bytes == packet->payload.size()) {
+    // Special case. Do not split, and thereby copy, the payload.
+    return;
+  }
   uint32_t timestamps_per_chunk = static_cast<uint32_t>(
       split_size_bytes * timestamps_per_ms / bytes_per_ms);
   uint32_t timestamp = packet->header.timestamp;
@@ -369,24 +359,24 @@ void PayloadSplitter::SplitBySamples(const Packet* packet,
   const uint8_t* payload_ptr = packet->payload.data();
   size_t len = packet->payload.size();
   while (len >= (2 * split_size_bytes)) {
-    Packet* new_packet = new Packet;
-    new_packet->header = packet->header;
-    new_packet->header.timestamp = timestamp;
+    Packet new_packet;
+    new_packet.header = packet->header;
+    new_packet.header.timestamp = timestamp;
     timestamp += timestamps_per_chunk;
-    new_packet->primary = packet->primary;
-    new_packet->payload.SetData(payload_ptr, split_size_bytes);
+    new_packet.primary = packet->primary;
+    new_packet.payload.SetData(payload_ptr, split_size_bytes);
     payload_ptr += split_size_bytes;
-    new_packets->push_back(new_packet);
+    new_packets->push_back(std::move(new_packet));
     len -= split_size_bytes;
   }
 
   if (len > 0) {
-    Packet* new_packet = new Packet;
-    new_packet->header = packet->header;
-    new_packet->header.timestamp = timestamp;
-    new_packet->primary = packet->primary;
-    new_packet->payload.SetData(payload_ptr, len);
-    new_packets->push_back(new_packet);
+    Packet new_packet;
+    new_packet.header = packet->header;
+    new_packet.header.timestamp = timestamp;
+    new_packet.primary = packet->primary;
+    new_packet.payload.SetData(payload_ptr, len);
+    new_packets->push_back(std::move(new_packet));
   }
 }
 
@@ -409,14 +399,14 @@ int PayloadSplitter::SplitByFrames(const Packet* packet,
   size_t len = packet->payload.size();
   while (len > 0) {
     assert(len >= bytes_per_frame);
-    Packet* new_packet = new Packet;
-    new_packet->header = packet->header;
-    new_packet->header.timestamp = timestamp;
+    Packet new_packet;
+    new_packet.header = packet->header;
+    new_packet.header.timestamp = timestamp;
     timestamp += timestamps_per_frame;
-    new_packet->primary = packet->primary;
-    new_packet->payload.SetData(payload_ptr, bytes_per_frame);
+    new_packet.primary = packet->primary;
+    new_packet.payload.SetData(payload_ptr, bytes_per_frame);
     payload_ptr += bytes_per_frame;
-    new_packets->push_back(new_packet);
+    new_packets->push_back(std::move(new_packet));
     len -= bytes_per_frame;
   }
   return kOK;
@@ -42,7 +42,8 @@ class PayloadSplitter {
 
   // Splits each packet in |packet_list| into its separate RED payloads. Each
   // RED payload is packetized into a Packet. The original elements in
-  // |packet_list| are properly deleted, and replaced by the new packets.
+  // |packet_list| are replaced by the new packets; the primary payload reuses
+  // the element and payload buffer of the original packet.
   // Note that all packets in |packet_list| must be RED payloads, i.e., have
   // RED headers according to RFC 2198 at the very beginning of the payload.
   // Returns kOK or an error.
@@ -69,7 +70,8 @@ class PayloadSplitter {
 
  private:
   // Splits the payload in |packet|. The payload is assumed to be from a
-  // sample-based codec.
+  // sample-based codec. Leaves |new_packets| empty if the payload is small
+  // enough to be kept as it is.
   virtual void SplitBySamples(const Packet* packet,
                               size_t bytes_per_ms,
                               uint32_t timestamps_per_ms,
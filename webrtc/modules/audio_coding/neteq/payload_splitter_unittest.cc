@@ -74,18 +74,18 @@ void CreateOpusFecPayload(uint8_t* payload, size_t payload_length,
 // by the values in array |payload_types| (which must be of length
 // |num_payloads|). Each redundant payload is |timestamp_offset| samples
 // "behind" the the previous payload.
-Packet* CreateRedPayload(size_t num_payloads,
-                         uint8_t* payload_types,
-                         int timestamp_offset,
-                         bool embed_opus_fec = false) {
-  Packet* packet = new Packet;
-  packet->header.payloadType = kRedPayloadType;
-  packet->header.timestamp = kBaseTimestamp;
-  packet->header.sequenceNumber = kSequenceNumber;
-  packet->payload.SetSize((kPayloadLength + 1) +
-                          (num_payloads - 1) *
-                              (kPayloadLength + kRedHeaderLength));
-  uint8_t* payload_ptr = packet->payload.data();
+Packet CreateRedPayload(size_t num_payloads,
+                        uint8_t* payload_types,
+                        int timestamp_offset,
+                        bool embed_opus_fec = false) {
+  Packet packet;
+  packet.header.payloadType = kRedPayloadType;
+  packet.header.timestamp = kBaseTimestamp;
+  packet.header.sequenceNumber = kSequenceNumber;
+  packet.payload.SetSize((kPayloadLength + 1) +
+                         (num_payloads - 1) *
+                             (kPayloadLength + kRedHeaderLength));
+  uint8_t* payload_ptr = packet.payload.data();
   for (size_t i = 0; i < num_payloads; ++i) {
     // Write the RED headers.
     if (i == num_payloads - 1) {
@@ -121,38 +121,38 @@ Packet* CreateRedPayload(size_t num_payloads,
 }
 
 // Create a packet with all payload bytes set to |payload_value|.
-Packet* CreatePacket(uint8_t payload_type, size_t payload_length,
-                     uint8_t payload_value, bool opus_fec = false) {
-  Packet* packet = new Packet;
-  packet->header.payloadType = payload_type;
-  packet->header.timestamp = kBaseTimestamp;
-  packet->header.sequenceNumber = kSequenceNumber;
-  packet->payload.SetSize(payload_length);
+Packet CreatePacket(uint8_t payload_type, size_t payload_length,
+                    uint8_t payload_value, bool opus_fec = false) {
+  Packet packet;
+  packet.header.payloadType = payload_type;
+  packet.header.timestamp = kBaseTimestamp;
+  packet.header.sequenceNumber = kSequenceNumber;
+  packet.payload.SetSize(payload_length);
   if (opus_fec) {
-    CreateOpusFecPayload(packet->payload.data(), packet->payload.size(),
+    CreateOpusFecPayload(packet.payload.data(), packet.payload.size(),
                          payload_value);
   } else {
-    memset(packet->payload.data(), payload_value, packet->payload.size());
+    memset(packet.payload.data(), payload_value, packet.payload.size());
   }
   return packet;
 }
 
 // Checks that |packet| has the attributes given in the remaining parameters.
-void VerifyPacket(const Packet* packet,
+void VerifyPacket(const Packet& packet,
                   size_t payload_length,
                   uint8_t payload_type,
                   uint16_t sequence_number,
                   uint32_t timestamp,
                   uint8_t payload_value,
                   bool primary = true) {
-  EXPECT_EQ(payload_length, packet->payload.size());
-  EXPECT_EQ(payload_type, packet->header.payloadType);
-  EXPECT_EQ(sequence_number, packet->header.sequenceNumber);
-  EXPECT_EQ(timestamp, packet->header.timestamp);
-  EXPECT_EQ(primary, packet->primary);
-  ASSERT_FALSE(packet->payload.empty());
-  for (size_t i = 0; i < packet->payload.size(); ++i) {
-    EXPECT_EQ(payload_value, packet->payload[i]);
+  EXPECT_EQ(payload_length, packet.payload.size());
+  EXPECT_EQ(payload_type, packet.header.payloadType);
+  EXPECT_EQ(sequence_number, packet.header.sequenceNumber);
+  EXPECT_EQ(timestamp, packet.header.timestamp);
+  EXPECT_EQ(primary, packet.primary);
+  ASSERT_FALSE(packet.payload.empty());
+  for (size_t i = 0; i < packet.payload.size(); ++i) {
+    EXPECT_EQ(payload_value, packet.payload[i]);
   }
 }
 
@@ -167,23 +167,51 @@ TEST(PayloadSplitter, CreateAndDestroy) {
 TEST(RedPayloadSplitter, OnePacketTwoPayloads) {
   uint8_t payload_types[] = {0, 0};
   const int kTimestampOffset = 160;
-  Packet* packet = CreateRedPayload(2, payload_types, kTimestampOffset);
   PacketList packet_list;
-  packet_list.push_back(packet);
+  packet_list.push_back(CreateRedPayload(2, payload_types, kTimestampOffset));
   PayloadSplitter splitter;
   EXPECT_EQ(PayloadSplitter::kOK, splitter.SplitRed(&packet_list));
   ASSERT_EQ(2u, packet_list.size());
   // Check first packet. The first in list should always be the primary payload.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber,
-               kBaseTimestamp, 1, true);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[1],
+               kSequenceNumber, kBaseTimestamp, 1, true);
   packet_list.pop_front();
   // Check second packet.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
-               kBaseTimestamp - kTimestampOffset, 0, false);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[0],
+               kSequenceNumber, kBaseTimestamp - kTimestampOffset, 0, false);
+}
+
+// The primary payload is parsed in place, reusing the packet and its payload
+// buffer.
+TEST(RedPayloadSplitter, PrimaryPayloadIsNotCopied) {
+  uint8_t payload_types[] = {0, 0, 0};
+  const int kTimestampOffset = 160;
+  PacketList packet_list;
+  packet_list.push_back(CreateRedPayload(3, payload_types, kTimestampOffset));
+  const Packet* const red_packet = &packet_list.front();
+  const uint8_t* const red_payload = red_packet->payload.data();
+  PayloadSplitter splitter;
+  EXPECT_EQ(PayloadSplitter::kOK, splitter.SplitRed(&packet_list));
+  ASSERT_EQ(3u, packet_list.size());
+  EXPECT_EQ(red_packet, &packet_list.front());
+  EXPECT_EQ(red_payload, packet_list.front().payload.data());
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[2],
+               kSequenceNumber, kBaseTimestamp, 2, true);
+}
+
+// A RED header claiming more headers than fit in the payload is discarded.
+TEST(RedPayloadSplitter, TruncatedHeader) {
+  Packet packet;
+  packet.header.payloadType = kRedPayloadType;
+  // A single, incomplete, RED header with the F bit set.
+  const uint8_t kPayload[] = {0x80, 0x00};
+  packet.payload.SetData(kPayload);
+  PacketList packet_list;
+  packet_list.push_back(std::move(packet));
+  PayloadSplitter splitter;
+  EXPECT_EQ(PayloadSplitter::kRedLengthMismatch,
+            splitter.SplitRed(&packet_list));
+  EXPECT_TRUE(packet_list.empty());
 }
 
 // Packets A and B are not split at all. Only the RED header in each packet is
@@ -192,29 +220,23 @@ TEST(RedPayloadSplitter, TwoPacketsOnePayload) {
   uint8_t payload_types[] = {0};
   const int kTimestampOffset = 160;
   // Create first packet, with a single RED payload.
-  Packet* packet = CreateRedPayload(1, payload_types, kTimestampOffset);
   PacketList packet_list;
-  packet_list.push_back(packet);
+  packet_list.push_back(CreateRedPayload(1, payload_types, kTimestampOffset));
   // Create second packet, with a single RED payload.
-  packet = CreateRedPayload(1, payload_types, kTimestampOffset);
+  packet_list.push_back(CreateRedPayload(1, payload_types, kTimestampOffset));
   // Manually change timestamp and sequence number of second packet.
-  packet->header.timestamp += kTimestampOffset;
-  packet->header.sequenceNumber++;
-  packet_list.push_back(packet);
+  packet_list.back().header.timestamp += kTimestampOffset;
+  packet_list.back().header.sequenceNumber++;
   PayloadSplitter splitter;
   EXPECT_EQ(PayloadSplitter::kOK, splitter.SplitRed(&packet_list));
   ASSERT_EQ(2u, packet_list.size());
   // Check first packet.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
-               kBaseTimestamp, 0, true);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[0],
+               kSequenceNumber, kBaseTimestamp, 0, true);
   packet_list.pop_front();
   // Check second packet.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber + 1,
-               kBaseTimestamp + kTimestampOffset, 0, true);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[0],
+               kSequenceNumber + 1, kBaseTimestamp + kTimestampOffset, 0, true);
 }
 
 // Packets A and B are split into packets A1, A2, A3, B1, B2, B3, with
@@ -230,53 +252,41 @@ TEST(RedPayloadSplitter, TwoPacketsThreePayloads) {
   uint8_t payload_types[] = {2, 1, 0};  // Primary is the last one.
   const int kTimestampOffset = 160;
   // Create first packet, with 3 RED payloads.
-  Packet* packet = CreateRedPayload(3, payload_types, kTimestampOffset);
   PacketList packet_list;
-  packet_list.push_back(packet);
+  packet_list.push_back(CreateRedPayload(3, payload_types, kTimestampOffset));
   // Create first packet, with 3 RED payloads.
-  packet = CreateRedPayload(3, payload_types, kTimestampOffset);
+  packet_list.push_back(CreateRedPayload(3, payload_types, kTimestampOffset));
   // Manually change timestamp and sequence number of second packet.
-  packet->header.timestamp += kTimestampOffset;
-  packet->header.sequenceNumber++;
-  packet_list.push_back(packet);
+  packet_list.back().header.timestamp += kTimestampOffset;
+  packet_list.back().header.sequenceNumber++;
   PayloadSplitter splitter;
   EXPECT_EQ(PayloadSplitter::kOK, splitter.SplitRed(&packet_list));
   ASSERT_EQ(6u, packet_list.size());
   // Check first packet, A1.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[2], kSequenceNumber,
-               kBaseTimestamp, 2, true);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[2],
+               kSequenceNumber, kBaseTimestamp, 2, true);
   packet_list.pop_front();
   // Check second packet, A2.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber,
-               kBaseTimestamp - kTimestampOffset, 1, false);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[1],
+               kSequenceNumber, kBaseTimestamp - kTimestampOffset, 1, false);
   packet_list.pop_front();
   // Check third packet, A3.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
-               kBaseTimestamp - 2 * kTimestampOffset, 0, false);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[0],
+               kSequenceNumber, kBaseTimestamp - 2 * kTimestampOffset, 0,
+               false);
   packet_list.pop_front();
   // Check fourth packet, B1.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[2], kSequenceNumber + 1,
-               kBaseTimestamp + kTimestampOffset, 2, true);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[2],
+               kSequenceNumber + 1, kBaseTimestamp + kTimestampOffset, 2, true);
   packet_list.pop_front();
   // Check fifth packet, B2.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[1], kSequenceNumber + 1,
-               kBaseTimestamp, 1, false);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[1],
+               kSequenceNumber + 1, kBaseTimestamp, 1, false);
   packet_list.pop_front();
   // Check sixth packet, B3.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber + 1,
-               kBaseTimestamp - kTimestampOffset, 0, false);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[0],
+               kSequenceNumber + 1, kBaseTimestamp - kTimestampOffset, 0,
+               false);
 }
 
 // Creates a list with 4 packets with these payload types:
@@ -291,8 +301,7 @@ TEST(RedPayloadSplitter, CheckRedPayloads) {
   PacketList packet_list;
   for (uint8_t i = 0; i <= 3; ++i) {
     // Create packet with payload type |i|, payload length 10 bytes, all 0.
-    Packet* packet = CreatePacket(i, 10, 0);
-    packet_list.push_back(packet);
+    packet_list.push_back(CreatePacket(i, 10, 0));
   }
 
   // Use a real DecoderDatabase object here instead of a mock, since it is
@@ -312,9 +321,8 @@ TEST(RedPayloadSplitter, CheckRedPayloads) {
   // Verify packets. The loop verifies that payload types 0, 1, and 2 are in the
   // list.
   for (int i = 0; i <= 2; ++i) {
-    Packet* packet = packet_list.front();
-    VerifyPacket(packet, 10, i, kSequenceNumber, kBaseTimestamp, 0, true);
-    delete packet;
+    VerifyPacket(packet_list.front(), 10, i, kSequenceNumber, kBaseTimestamp, 0,
+                 true);
     packet_list.pop_front();
   }
   EXPECT_TRUE(packet_list.empty());
@@ -325,25 +333,49 @@ TEST(RedPayloadSplitter, CheckRedPayloads) {
 TEST(RedPayloadSplitter, WrongPayloadLength) {
   uint8_t payload_types[] = {0, 0, 0};
   const int kTimestampOffset = 160;
-  Packet* packet = CreateRedPayload(3, payload_types, kTimestampOffset);
+  Packet packet = CreateRedPayload(3, payload_types, kTimestampOffset);
   // Manually tamper with the payload length of the packet.
   // This is one byte too short for the second payload (out of three).
   // We expect only the first payload to be returned.
-  packet->payload.SetSize(packet->payload.size() - (kPayloadLength + 1));
+  packet.payload.SetSize(packet.payload.size() - (kPayloadLength + 1));
   PacketList packet_list;
-  packet_list.push_back(packet);
+  packet_list.push_back(std::move(packet));
   PayloadSplitter splitter;
   EXPECT_EQ(PayloadSplitter::kRedLengthMismatch,
             splitter.SplitRed(&packet_list));
   ASSERT_EQ(1u, packet_list.size());
   // Check first packet.
-  packet = packet_list.front();
-  VerifyPacket(packet, kPayloadLength, payload_types[0], kSequenceNumber,
-               kBaseTimestamp - 2 * kTimestampOffset, 0, false);
-  delete packet;
+  VerifyPacket(packet_list.front(), kPayloadLength, payload_types[0],
+               kSequenceNumber, kBaseTimestamp - 2 * kTimestampOffset, 0,
+               false);
   packet_list.pop_front();
 }
 
+// A payload that does not need splitting is kept as is, without being copied.
+TEST(AudioPayloadSplitter, UnsplitPayloadIsNotCopied) {
+  static const uint8_t kPayloadType = 17;
+  // 20 ms of PCMu is the smallest chunk size, and is not split.
+  PacketList packet_list;
+  packet_list.push_back(CreatePacket(kPayloadType, 160, 0));
+  const uint8_t* const payload = packet_list.front().payload.data();
+
+  MockDecoderDatabase decoder_database;
+  std::unique_ptr<DecoderDatabase::DecoderInfo> info(
+      new DecoderDatabase::DecoderInfo(NetEqDecoder::kDecoderPCMu, ""));
+  EXPECT_CALL(decoder_database, GetDecoderInfo(kPayloadType))
+      .WillRepeatedly(Return(info.get()));
+
+  PayloadSplitter splitter;
+  EXPECT_EQ(0, splitter.SplitAudio(&packet_list, decoder_database));
+  ASSERT_EQ(1u, packet_list.size());
+  EXPECT_EQ(payload, packet_list.front().payload.data());
+  VerifyPacket(packet_list.front(), 160, kPayloadType, kSequenceNumber,
+               kBaseTimestamp, 0);
+
+  // The destructor is called when decoder_database goes out of scope.
+  EXPECT_CALL(decoder_database, Die());
+}
+
 // Test that iSAC, iSAC-swb, RED, DTMF, CNG, and "Arbitrary" payloads do not
 // get split.
 TEST(AudioPayloadSplitter, NonSplittable) {
@@ -392,10 +424,9 @@ TEST(AudioPayloadSplitter, NonSplittable) {
   uint8_t payload_type = 0;
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    VerifyPacket((*it), kPayloadLength, payload_type, kSequenceNumber,
+    VerifyPacket(*it, kPayloadLength, payload_type, kSequenceNumber,
                  kBaseTimestamp, 10 * payload_type);
     ++payload_type;
-    delete (*it);
     it = packet_list.erase(it);
   }
 
@@ -425,7 +456,6 @@ TEST(AudioPayloadSplitter, UnknownPayloadType) {
   // Delete the packets and payloads to avoid having the test leak memory.
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    delete (*it);
     it = packet_list.erase(it);
   }
 
@@ -542,9 +572,8 @@ TEST_P(SplitBySamplesTest, PayloadSizes) {
     size_t length_bytes = expected_size_ms[i] * bytes_per_ms_;
     uint32_t expected_timestamp = kBaseTimestamp +
         expected_timestamp_offset_ms[i] * samples_per_ms_;
-    VerifyPacket((*it), length_bytes, kPayloadType, kSequenceNumber,
+    VerifyPacket(*it, length_bytes, kPayloadType, kSequenceNumber,
                  expected_timestamp, expected_payload_value[i]);
-    delete (*it);
     it = packet_list.erase(it);
     ++i;
   }
@@ -590,12 +619,12 @@ TEST_P(SplitIlbcTest, NumFrames) {
   static const uint8_t kPayloadType = 17;  // Just a random number.
   const int frame_length_samples = frame_length_ms_ * 8;
   size_t payload_length_bytes = frame_length_bytes_ * num_frames_;
-  Packet* packet = CreatePacket(kPayloadType, payload_length_bytes, 0);
+  Packet packet = CreatePacket(kPayloadType, payload_length_bytes, 0);
   // Fill payload with increasing integers {0, 1, 2, ...}.
-  for (size_t i = 0; i < packet->payload.size(); ++i) {
-    packet->payload[i] = static_cast<uint8_t>(i);
+  for (size_t i = 0; i < packet.payload.size(); ++i) {
+    packet.payload[i] = static_cast<uint8_t>(i);
   }
-  packet_list.push_back(packet);
+  packet_list.push_back(std::move(packet));
 
   MockDecoderDatabase decoder_database;
   // Tell the mock decoder database to return DecoderInfo structs with different
@@ -614,7 +643,7 @@ TEST_P(SplitIlbcTest, NumFrames) {
   int frame_num = 0;
   uint8_t payload_value = 0;
   while (it != packet_list.end()) {
-    Packet* packet = (*it);
+    const Packet* packet = &(*it);
     EXPECT_EQ(kBaseTimestamp + frame_length_samples * frame_num,
               packet->header.timestamp);
     EXPECT_EQ(frame_length_bytes_, packet->payload.size());
@@ -626,7 +655,6 @@ TEST_P(SplitIlbcTest, NumFrames) {
       EXPECT_EQ(payload_value, packet->payload[i]);
       ++payload_value;
     }
-    delete (*it);
     it = packet_list.erase(it);
     ++frame_num;
   }
@@ -659,8 +687,7 @@ TEST(IlbcPayloadSplitter, TooLargePayload) {
   PacketList packet_list;
   static const uint8_t kPayloadType = 17;  // Just a random number.
   size_t kPayloadLengthBytes = 950;
-  Packet* packet = CreatePacket(kPayloadType, kPayloadLengthBytes, 0);
-  packet_list.push_back(packet);
+  packet_list.push_back(CreatePacket(kPayloadType, kPayloadLengthBytes, 0));
 
   MockDecoderDatabase decoder_database;
   std::unique_ptr<DecoderDatabase::DecoderInfo> info(
@@ -676,7 +703,6 @@ TEST(IlbcPayloadSplitter, TooLargePayload) {
   // Delete the packets and payloads to avoid having the test leak memory.
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    delete (*it);
     it = packet_list.erase(it);
   }
 
@@ -689,8 +715,7 @@ TEST(IlbcPayloadSplitter, UnevenPayload) {
   PacketList packet_list;
   static const uint8_t kPayloadType = 17;  // Just a random number.
   size_t kPayloadLengthBytes = 39;  // Not an even number of frames.
-  Packet* packet = CreatePacket(kPayloadType, kPayloadLengthBytes, 0);
-  packet_list.push_back(packet);
+  packet_list.push_back(CreatePacket(kPayloadType, kPayloadLengthBytes, 0));
 
   MockDecoderDatabase decoder_database;
   std::unique_ptr<DecoderDatabase::DecoderInfo> info(
@@ -706,7 +731,6 @@ TEST(IlbcPayloadSplitter, UnevenPayload) {
   // Delete the packets and payloads to avoid having the test leak memory.
   PacketList::iterator it = packet_list.begin();
   while (it != packet_list.end()) {
-    delete (*it);
     it = packet_list.erase(it);
   }
 
@@ -721,14 +745,11 @@ TEST(FecPayloadSplitter, MixedPayload) {
   decoder_database.RegisterPayload(0, NetEqDecoder::kDecoderOpus, "opus");
   decoder_database.RegisterPayload(1, NetEqDecoder::kDecoderPCMu, "pcmu");
 
-  Packet* packet = CreatePacket(0, 10, 0xFF, true);
-  packet_list.push_back(packet);
+  packet_list.push_back(CreatePacket(0, 10, 0xFF, true));
 
-  packet = CreatePacket(0, 10, 0); // Non-FEC Opus payload.
-  packet_list.push_back(packet);
+  packet_list.push_back(CreatePacket(0, 10, 0)); // Non-FEC Opus payload.
 
-  packet = CreatePacket(1, 10, 0); // Non-Opus payload.
-  packet_list.push_back(packet);
+  packet_list.push_back(CreatePacket(1, 10, 0)); // Non-Opus payload.
 
   PayloadSplitter splitter;
   EXPECT_EQ(PayloadSplitter::kOK,
@@ -736,33 +757,29 @@ TEST(FecPayloadSplitter, MixedPayload) {
   EXPECT_EQ(4u, packet_list.size());
 
   // Check first packet.
-  packet = packet_list.front();
+  const Packet* packet = &packet_list.front();
   EXPECT_EQ(0, packet->header.payloadType);
   EXPECT_EQ(kBaseTimestamp - 20 * 48, packet->header.timestamp);
   EXPECT_EQ(10U, packet->payload.size());
   EXPECT_FALSE(packet->primary);
-  delete packet;
   packet_list.pop_front();
 
   // Check second packet.
-  packet = packet_list.front();
+  packet = &packet_list.front();
   EXPECT_EQ(0, packet->header.payloadType);
   EXPECT_EQ(kBaseTimestamp, packet->header.timestamp);
   EXPECT_EQ(10U, packet->payload.size());
   EXPECT_TRUE(packet->primary);
-  delete packet;
   packet_list.pop_front();
 
   // Check third packet.
-  packet = packet_list.front();
-  VerifyPacket(packet, 10, 0, kSequenceNumber, kBaseTimestamp, 0, true);
-  delete packet;
+  VerifyPacket(packet_list.front(), 10, 0, kSequenceNumber, kBaseTimestamp, 0,
+               true);
   packet_list.pop_front();
 
   // Check fourth packet.
-  packet = packet_list.front();
-  VerifyPacket(packet, 10, 1, kSequenceNumber, kBaseTimestamp, 0, true);
-  delete packet;
+  VerifyPacket(packet_list.front(), 10, 1, kSequenceNumber, kBaseTimestamp, 0,
+               true);
 }
 
 TEST(FecPayloadSplitter, EmbedFecInRed) {
@@ -772,8 +789,8 @@ TEST(FecPayloadSplitter, EmbedFecInRed) {
   const int kTimestampOffset = 20 * 48;  // 20 ms * 48 kHz.
   uint8_t payload_types[] = {0, 0};
   decoder_database.RegisterPayload(0, NetEqDecoder::kDecoderOpus, "opus");
-  Packet* packet = CreateRedPayload(2, payload_types, kTimestampOffset, true);
-  packet_list.push_back(packet);
+  packet_list.push_back(
+      CreateRedPayload(2, payload_types, kTimestampOffset, true));
 
   PayloadSplitter splitter;
   EXPECT_EQ(PayloadSplitter::kOK,
@@ -784,43 +801,39 @@ TEST(FecPayloadSplitter, EmbedFecInRed) {
   EXPECT_EQ(4u, packet_list.size());
 
   // Check first packet. FEC packet copied from primary payload in RED.
-  packet = packet_list.front();
+  const Packet* packet = &packet_list.front();
   EXPECT_EQ(0, packet->header.payloadType);
   EXPECT_EQ(kBaseTimestamp - kTimestampOffset, packet->header.timestamp);
   EXPECT_EQ(kPayloadLength, packet->payload.size());
   EXPECT_FALSE(packet->primary);
   EXPECT_EQ(packet->payload[3], 1);
-  delete packet;
   packet_list.pop_front();
 
   // Check second packet. Normal packet copied from primary payload in RED.
-  packet = packet_list.front();
+  packet = &packet_list.front();
   EXPECT_EQ(0, packet->header.payloadType);
   EXPECT_EQ(kBaseTimestamp, packet->header.timestamp);
   EXPECT_EQ(kPayloadLength, packet->payload.size());
   EXPECT_TRUE(packet->primary);
   EXPECT_EQ(packet->payload[3], 1);
-  delete packet;
   packet_list.pop_front();
 
   // Check third packet. FEC packet copied from secondary payload in RED.
-  packet = packet_list.front();
+  packet = &packet_list.front();
   EXPECT_EQ(0, packet->header.payloadType);
   EXPECT_EQ(kBaseTimestamp - 2 * kTimestampOffset, packet->header.timestamp);
   EXPECT_EQ(kPayloadLength, packet->payload.size());
   EXPECT_FALSE(packet->primary);
   EXPECT_EQ(packet->payload[3], 0);
-  delete packet;
   packet_list.pop_front();
 
   // Check fourth packet. Normal packet copied from primary payload in RED.
-  packet = packet_list.front();
+  packet = &packet_list.front();
   EXPECT_EQ(0, packet->header.payloadType);
   EXPECT_EQ(kBaseTimestamp - kTimestampOffset, packet->header.timestamp);
   EXPECT_EQ(kPayloadLength, packet->payload.size());
   EXPECT_TRUE(packet->primary);
   EXPECT_EQ(packet->payload[3], 0);
-  delete packet;
   packet_list.pop_front();
 }
 
@@ -113,6 +113,9 @@ StatisticsCalculator::StatisticsCalculator()
       lost_timestamps_(0),
       timestamps_since_last_report_(0),
       secondary_decoded_samples_(0),
+      target_delay_sum_ms_(0),
+      num_target_delays_(0),
+      num_capped_target_delays_(0),
       delayed_packet_outage_counter_(
           "WebRTC.Audio.DelayedPacketOutageEventsPerMinute",
           60000,  // 60 seconds report interval.
@@ -132,6 +135,9 @@ void StatisticsCalculator::Reset() {
   expanded_noise_samples_ = 0;
   secondary_decoded_samples_ = 0;
   waiting_times_.clear();
+  target_delay_sum_ms_ = 0;
+  num_target_delays_ = 0;
+  num_capped_target_delays_ = 0;
 }
 
 void StatisticsCalculator::ResetMcu() {
@@ -203,6 +209,14 @@ void StatisticsCalculator::StoreWaitingTime(int waiting_time_ms) {
   waiting_times_.push_back(waiting_time_ms);
 }
 
+void StatisticsCalculator::StoreTargetDelay(int target_delay_ms,
+                                            bool delay_peak_capped) {
+  target_delay_sum_ms_ += target_delay_ms;
+  ++num_target_delays_;
+  if (delay_peak_capped)
+    ++num_capped_target_delays_;
+}
+
 void StatisticsCalculator::GetNetworkStatistics(
     int fs_hz,
     size_t num_samples_in_buffers,
@@ -274,6 +288,17 @@ void StatisticsCalculator::GetNetworkStatistics(
     stats->mean_waiting_time_ms = static_cast<int>(sum / waiting_times_.size());
   }
 
+  if (num_target_delays_ == 0) {
+    stats->mean_target_delay_ms = -1;
+    stats->delay_peak_capped_rate = 0;
+  } else {
+    stats->mean_target_delay_ms =
+        static_cast<int>(target_delay_sum_ms_ / num_target_delays_);
+    stats->delay_peak_capped_rate = CalculateQ14Ratio(
+        num_capped_target_delays_,
+        rtc::checked_cast<uint32_t>(num_target_delays_));
+  }
+
   // Reset counters.
   ResetMcu();
   Reset();
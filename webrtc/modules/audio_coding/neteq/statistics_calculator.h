@@ -69,6 +69,10 @@ class StatisticsCalculator {
   // Stores new packet waiting time in waiting time statistics.
   void StoreWaitingTime(int waiting_time_ms);
 
+  // Stores the target delay computed when a packet was received, and whether
+  // it was limited by the maximum peak delay.
+  void StoreTargetDelay(int target_delay_ms, bool delay_peak_capped);
+
   // Reports that |num_samples| samples were decoded from secondary packets.
   void SecondaryDecodedSamples(int num_samples);
 
@@ -157,6 +161,9 @@ class StatisticsCalculator {
   uint32_t timestamps_since_last_report_;
   std::deque<int> waiting_times_;
   uint32_t secondary_decoded_samples_;
+  int64_t target_delay_sum_ms_;
+  size_t num_target_delays_;
+  size_t num_capped_target_delays_;
   PeriodicUmaCount delayed_packet_outage_counter_;
   PeriodicUmaAverage excess_buffer_delay_;
 
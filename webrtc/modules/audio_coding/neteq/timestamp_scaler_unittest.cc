@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/audio_coding/neteq/timestamp_scaler.h"
 
+#include <utility>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_coding/codecs/builtin_audio_decoder_factory.h"
@@ -215,19 +217,23 @@ TEST(TimestampScaler, TestG722PacketList) {
   // Test both sides of the timestamp wrap-around.
   uint32_t external_timestamp = 0xFFFFFFFF - 5;
   uint32_t internal_timestamp = external_timestamp;
-  Packet packet1;
-  packet1.header.payloadType = kRtpPayloadType;
-  packet1.header.timestamp = external_timestamp;
-  Packet packet2;
-  packet2.header.payloadType = kRtpPayloadType;
-  packet2.header.timestamp = external_timestamp + 10;
   PacketList packet_list;
-  packet_list.push_back(&packet1);
-  packet_list.push_back(&packet2);
+  {
+    Packet packet1;
+    packet1.header.payloadType = kRtpPayloadType;
+    packet1.header.timestamp = external_timestamp;
+    Packet packet2;
+    packet2.header.payloadType = kRtpPayloadType;
+    packet2.header.timestamp = external_timestamp + 10;
+    packet_list.push_back(std::move(packet1));
+    packet_list.push_back(std::move(packet2));
+  }
 
   scaler.ToInternal(&packet_list);
-  EXPECT_EQ(internal_timestamp, packet1.header.timestamp);
-  EXPECT_EQ(internal_timestamp + 20, packet2.header.timestamp);
+  EXPECT_EQ(internal_timestamp, packet_list.front().header.timestamp);
+  packet_list.pop_front();
+  EXPECT_EQ(internal_timestamp + 20, packet_list.front().header.timestamp);
+  packet_list.pop_front();
 
   EXPECT_CALL(db, Die());  // Called when database object is deleted.
 }
@@ -82,6 +82,20 @@ static bool ValidateExtensionId(const char* flagname, int32_t value) {
   return false;
 }
 
+bool ValidateTargetPercentile(const char* flagname, int32_t value) {
+  if (value >= 50 && value <= 99)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
+
+bool ValidateNonNegative(const char* flagname, int32_t value) {
+  if (value >= 0)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
+
 // Define command line flags.
 DEFINE_int32(pcmu, 0, "RTP payload type for PCM-u");
 const bool pcmu_dummy =
@@ -150,6 +164,18 @@ const bool audio_level_dummy =
 DEFINE_int32(abs_send_time, 3, "Extension ID for absolute sender time");
 const bool abs_send_time_dummy =
     google::RegisterFlagValidator(&FLAGS_abs_send_time, &ValidateExtensionId);
+DEFINE_bool(low_latency, false,
+            "Let the jitter buffer target delay adapt faster");
+DEFINE_int32(target_percentile, 95,
+             "Percentile of the inter-arrival times used as target delay");
+const bool target_percentile_dummy =
+    google::RegisterFlagValidator(&FLAGS_target_percentile,
+                                  &ValidateTargetPercentile);
+DEFINE_int32(max_delay_peak_ms, 0,
+             "Maximum target delay while delay peaks are found (0 = no limit)");
+const bool max_delay_peak_ms_dummy =
+    google::RegisterFlagValidator(&FLAGS_max_delay_peak_ms,
+                                  &ValidateNonNegative);
 
 // Maps a codec type to a printable name string.
 std::string CodecName(NetEqDecoder codec) {
@@ -424,6 +450,9 @@ int RunTest(int argc, char* argv[]) {
   DefaultNetEqTestErrorCallback error_cb;
   NetEq::Config config;
   config.sample_rate_hz = sample_rate_hz;
+  config.enable_low_latency_mode = FLAGS_low_latency;
+  config.delay_target_percentile = FLAGS_target_percentile;
+  config.max_delay_peak_ms = FLAGS_max_delay_peak_ms;
   NetEqTest test(config, codecs, ext_codecs, std::move(input),
                  std::move(output), &error_cb);
 
@@ -448,6 +477,9 @@ int RunTest(int argc, char* argv[]) {
   printf("  median_waiting_time_ms: %d ms\n", stats.median_waiting_time_ms);
   printf("  min_waiting_time_ms: %d ms\n", stats.min_waiting_time_ms);
   printf("  max_waiting_time_ms: %d ms\n", stats.max_waiting_time_ms);
+  printf("  mean_target_delay_ms: %d ms\n", stats.mean_target_delay_ms);
+  printf("  delay_peak_capped_rate: %f %%\n",
+         100.0 * stats.delay_peak_capped_rate / 16384.0);
 
   return 0;
 }
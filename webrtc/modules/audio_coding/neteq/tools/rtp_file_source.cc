@@ -23,6 +23,7 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/modules/audio_coding/neteq/tools/packet.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+#include "webrtc/test/mapped_rtp_file_reader.h"
 #include "webrtc/test/rtp_file_reader.h"
 
 namespace webrtc {
@@ -57,8 +58,8 @@ bool RtpFileSource::RegisterRtpHeaderExtension(RTPExtensionType type,
 
 std::unique_ptr<Packet> RtpFileSource::NextPacket() {
   while (true) {
-    RtpPacket temp_packet;
-    if (!rtp_reader_->NextPacket(&temp_packet)) {
+    MappedRtpFileReader::Packet temp_packet;
+    if (!rtp_reader_->NextPacketView(&temp_packet)) {
       return NULL;
     }
     if (temp_packet.original_length == 0) {
@@ -89,10 +90,11 @@ RtpFileSource::RtpFileSource()
       parser_(RtpHeaderParser::Create()) {}
 
 bool RtpFileSource::OpenFile(const std::string& file_name) {
-  rtp_reader_.reset(RtpFileReader::Create(RtpFileReader::kRtpDump, file_name));
+  rtp_reader_ =
+      MappedRtpFileReader::Create(RtpFileReader::kRtpDump, file_name);
   if (rtp_reader_)
     return true;
-  rtp_reader_.reset(RtpFileReader::Create(RtpFileReader::kPcap, file_name));
+  rtp_reader_ = MappedRtpFileReader::Create(RtpFileReader::kPcap, file_name);
   if (!rtp_reader_) {
     FATAL() << "Couldn't open input file as either a rtpdump or .pcap. Note "
                "that .pcapng is not supported.";
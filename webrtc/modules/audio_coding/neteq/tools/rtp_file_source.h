@@ -27,7 +27,7 @@ class RtpHeaderParser;
 
 namespace test {
 
-class RtpFileReader;
+class MappedRtpFileReader;
 
 class RtpFileSource : public PacketSource {
  public:
@@ -55,7 +55,7 @@ class RtpFileSource : public PacketSource {
 
   bool OpenFile(const std::string& file_name);
 
-  std::unique_ptr<RtpFileReader> rtp_reader_;
+  std::unique_ptr<MappedRtpFileReader> rtp_reader_;
   std::unique_ptr<RtpHeaderParser> parser_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtpFileSource);
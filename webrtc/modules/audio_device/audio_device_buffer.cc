@@ -64,7 +64,13 @@ AudioDeviceBuffer::AudioDeviceBuffer()
       last_log_stat_time_(0),
       max_rec_level_(0),
       max_play_level_(0),
-      num_rec_level_is_zero_(0) {
+      num_rec_level_is_zero_(0),
+      max_play_delay_ms_(0),
+      max_rec_delay_ms_(0),
+      play_underruns_(0),
+      last_play_underruns_(0),
+      rec_overruns_(0),
+      last_rec_overruns_(0) {
   LOG(INFO) << "AudioDeviceBuffer::ctor";
   // TODO(henrika): improve buffer handling and ensure that we don't allocate
   // more than what is required.
@@ -281,9 +287,14 @@ int32_t AudioDeviceBuffer::SetRecordedBuffer(const void* audio_buffer,
   }
 
   // Update some stats but do it on the task queue to ensure that the members
-  // are modified and read on the same thread.
+  // are modified and read on the same thread. The stats are based on the local
+  // copy since |audio_buffer| may be owned by the caller, e.g. be a view into
+  // a buffer of the native audio layer, and is only valid during this call.
+  // The delays are the ones given by the previous SetVQEData() call, which is
+  // made on the same thread.
   task_queue_.PostTask(rtc::Bind(&AudioDeviceBuffer::UpdateRecStats, this,
-                                 audio_buffer, num_samples));
+                                 &rec_buffer_[0], num_samples, play_delay_ms_,
+                                 rec_delay_ms_));
   return 0;
 }
 
@@ -380,6 +391,16 @@ void AudioDeviceBuffer::UpdateRecordingParameters() {
   RTC_DCHECK_LE(rec_bytes_per_10ms_, kMaxBufferSizeBytes);
 }
 
+void AudioDeviceBuffer::ReportPlayoutUnderrun() {
+  task_queue_.PostTask(
+      rtc::Bind(&AudioDeviceBuffer::UpdatePlayoutUnderruns, this));
+}
+
+void AudioDeviceBuffer::ReportRecordingOverrun() {
+  task_queue_.PostTask(
+      rtc::Bind(&AudioDeviceBuffer::UpdateRecordingOverruns, this));
+}
+
 void AudioDeviceBuffer::StartTimer() {
   num_stat_reports_ = 0;
   last_log_stat_time_ = rtc::TimeMillis();
@@ -407,7 +428,9 @@ void AudioDeviceBuffer::LogStats() {
               << ", "
               << "samples: " << diff_samples << ", "
               << "rate: " << static_cast<int>(rate + 0.5) << ", "
-              << "level: " << max_rec_level_;
+              << "level: " << max_rec_level_ << ", "
+              << "delay: " << max_rec_delay_ms_ << ", "
+              << "overruns: " << rec_overruns_ - last_rec_overruns_;
 
     diff_samples = play_samples_ - last_play_samples_;
     rate = diff_samples / (static_cast<float>(time_since_last) / 1000.0);
@@ -417,7 +440,9 @@ void AudioDeviceBuffer::LogStats() {
               << ", "
               << "samples: " << diff_samples << ", "
               << "rate: " << static_cast<int>(rate + 0.5) << ", "
-              << "level: " << max_play_level_;
+              << "level: " << max_play_level_ << ", "
+              << "delay: " << max_play_delay_ms_ << ", "
+              << "underruns: " << play_underruns_ - last_play_underruns_;
   }
 
   // Count number of times we detect "no audio" corresponding to a case where
@@ -430,8 +455,12 @@ void AudioDeviceBuffer::LogStats() {
   last_play_callbacks_ = play_callbacks_;
   last_rec_samples_ = rec_samples_;
   last_play_samples_ = play_samples_;
+  last_play_underruns_ = play_underruns_;
+  last_rec_overruns_ = rec_overruns_;
   max_rec_level_ = 0;
   max_play_level_ = 0;
+  max_rec_delay_ms_ = 0;
+  max_play_delay_ms_ = 0;
 
   int64_t time_to_wait_ms = next_callback_time - rtc::TimeMillis();
   RTC_DCHECK_GT(time_to_wait_ms, 0) << "Invalid timer interval";
@@ -449,6 +478,10 @@ void AudioDeviceBuffer::ResetRecStats() {
   last_rec_samples_ = 0;
   max_rec_level_ = 0;
   num_rec_level_is_zero_ = 0;
+  max_rec_delay_ms_ = 0;
+  max_play_delay_ms_ = 0;
+  rec_overruns_ = 0;
+  last_rec_overruns_ = 0;
 }
 
 void AudioDeviceBuffer::ResetPlayStats() {
@@ -458,13 +491,19 @@ void AudioDeviceBuffer::ResetPlayStats() {
   play_samples_ = 0;
   last_play_samples_ = 0;
   max_play_level_ = 0;
+  play_underruns_ = 0;
+  last_play_underruns_ = 0;
 }
 
 void AudioDeviceBuffer::UpdateRecStats(const void* audio_buffer,
-                                       size_t num_samples) {
+                                       size_t num_samples,
+                                       int play_delay_ms,
+                                       int rec_delay_ms) {
   RTC_DCHECK(task_queue_.IsCurrent());
   ++rec_callbacks_;
   rec_samples_ += num_samples;
+  max_play_delay_ms_ = std::max(max_play_delay_ms_, play_delay_ms);
+  max_rec_delay_ms_ = std::max(max_rec_delay_ms_, rec_delay_ms);
 
   // Find the max absolute value in an audio packet twice per second and update
   // |max_rec_level_| to track the largest value.
@@ -496,4 +535,14 @@ void AudioDeviceBuffer::UpdatePlayStats(const void* audio_buffer,
   }
 }
 
+void AudioDeviceBuffer::UpdatePlayoutUnderruns() {
+  RTC_DCHECK(task_queue_.IsCurrent());
+  ++play_underruns_;
+}
+
+void AudioDeviceBuffer::UpdateRecordingOverruns() {
+  RTC_DCHECK(task_queue_.IsCurrent());
+  ++rec_overruns_;
+}
+
 }  // namespace webrtc
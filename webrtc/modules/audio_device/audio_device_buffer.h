@@ -62,6 +62,12 @@ class AudioDeviceBuffer {
   virtual int32_t RequestPlayoutData(size_t num_samples);
   virtual int32_t GetPlayoutData(void* audio_buffer);
 
+  // Called by the audio layer when the device has run out of audio to play
+  // out (underrun) or when recorded audio has been lost since it was not read
+  // in time (overrun). Can be called on any thread.
+  void ReportPlayoutUnderrun();
+  void ReportRecordingOverrun();
+
   // TODO(henrika): these methods should not be used and does not contain any
   // valid implementation. Investigate the possibility to either remove them
   // or add a proper implementation if needed.
@@ -93,8 +99,13 @@ class AudioDeviceBuffer {
   // Updates counters in each play/record callback but does it on the task
   // queue to ensure that they can be read by LogStats() without any locks since
   // each task is serialized by the task queue.
-  void UpdateRecStats(const void* audio_buffer, size_t num_samples);
+  void UpdateRecStats(const void* audio_buffer,
+                      size_t num_samples,
+                      int play_delay_ms,
+                      int rec_delay_ms);
   void UpdatePlayStats(const void* audio_buffer, size_t num_samples);
+  void UpdatePlayoutUnderruns();
+  void UpdateRecordingOverruns();
 
   // Ensures that methods are called on the same thread as the thread that
   // creates this object.
@@ -220,6 +231,19 @@ class AudioDeviceBuffer {
   // (two per second) in a row equals zero. The member is only incremented on
   // the task queue and max once every 10th second.
   size_t num_rec_level_is_zero_;
+
+  // Max delay values given by SetVQEData() over the last 10 seconds. Reset to
+  // zero at each call to LogStats(). Only modified on the task queue thread.
+  int max_play_delay_ms_;
+  int max_rec_delay_ms_;
+
+  // Total number of underruns (playout) and overruns (recording) reported by
+  // the audio layer, and the totals stored at the previous timer task. Only
+  // modified on the task queue thread.
+  uint32_t play_underruns_;
+  uint32_t last_play_underruns_;
+  uint32_t rec_overruns_;
+  uint32_t last_rec_overruns_;
 };
 
 }  // namespace webrtc
@@ -30,16 +30,10 @@ FineAudioBuffer::FineAudioBuffer(AudioDeviceBuffer* device_buffer,
       bytes_per_10_ms_(samples_per_10_ms_ * sizeof(int16_t)),
       playout_cached_buffer_start_(0),
       playout_cached_bytes_(0),
-      // Allocate extra space on the recording side to reduce the number of
-      // memmove() calls.
-      required_record_buffer_size_bytes_(
-          5 * (desired_frame_size_bytes + bytes_per_10_ms_)),
-      record_cached_bytes_(0),
-      record_read_pos_(0),
-      record_write_pos_(0) {
+      record_cached_bytes_(0) {
   playout_cache_buffer_.reset(new int8_t[bytes_per_10_ms_]);
-  record_cache_buffer_.reset(new int8_t[required_record_buffer_size_bytes_]);
-  memset(record_cache_buffer_.get(), 0, required_record_buffer_size_bytes_);
+  record_cache_buffer_.reset(new int8_t[bytes_per_10_ms_]);
+  memset(record_cache_buffer_.get(), 0, bytes_per_10_ms_);
 }
 
 FineAudioBuffer::~FineAudioBuffer() {}
@@ -59,9 +53,7 @@ void FineAudioBuffer::ResetPlayout() {
 
 void FineAudioBuffer::ResetRecord() {
   record_cached_bytes_ = 0;
-  record_read_pos_ = 0;
-  record_write_pos_ = 0;
-  memset(record_cache_buffer_.get(), 0, required_record_buffer_size_bytes_);
+  memset(record_cache_buffer_.get(), 0, bytes_per_10_ms_);
 }
 
 void FineAudioBuffer::GetPlayoutData(int8_t* buffer) {
@@ -115,35 +107,40 @@ void FineAudioBuffer::DeliverRecordedData(const int8_t* buffer,
                                           size_t size_in_bytes,
                                           int playout_delay_ms,
                                           int record_delay_ms) {
-  // Check if the temporary buffer can store the incoming buffer. If not,
-  // move the remaining (old) bytes to the beginning of the temporary buffer
-  // and start adding new samples after the old samples.
-  if (record_write_pos_ + size_in_bytes > required_record_buffer_size_bytes_) {
-    if (record_cached_bytes_ > 0) {
-      memmove(record_cache_buffer_.get(),
-              record_cache_buffer_.get() + record_read_pos_,
-              record_cached_bytes_);
-    }
-    record_write_pos_ = record_cached_bytes_;
-    record_read_pos_ = 0;
+  // Complete the 10ms chunk which remains from the last call, if any, and
+  // deliver it from the cache.
+  if (record_cached_bytes_ > 0) {
+    const size_t bytes_to_cache =
+        std::min(bytes_per_10_ms_ - record_cached_bytes_, size_in_bytes);
+    memcpy(record_cache_buffer_.get() + record_cached_bytes_, buffer,
+           bytes_to_cache);
+    record_cached_bytes_ += bytes_to_cache;
+    buffer += bytes_to_cache;
+    size_in_bytes -= bytes_to_cache;
+    if (record_cached_bytes_ < bytes_per_10_ms_)
+      return;
+    DeliverRecordedChunk(record_cache_buffer_.get(), playout_delay_ms,
+                         record_delay_ms);
+    record_cached_bytes_ = 0;
   }
-  // Add recorded samples to a temporary buffer.
-  memcpy(record_cache_buffer_.get() + record_write_pos_, buffer, size_in_bytes);
-  record_write_pos_ += size_in_bytes;
-  record_cached_bytes_ += size_in_bytes;
-  // Consume samples in temporary buffer in chunks of 10ms until there is not
-  // enough data left. The number of remaining bytes in the cache is given by
-  // |record_cached_bytes_| after this while loop is done.
-  while (record_cached_bytes_ >= bytes_per_10_ms_) {
-    device_buffer_->SetRecordedBuffer(
-        record_cache_buffer_.get() + record_read_pos_, samples_per_10_ms_);
-    device_buffer_->SetVQEData(playout_delay_ms, record_delay_ms, 0);
-    device_buffer_->DeliverRecordedData();
-    // Read next chunk of 10ms data.
-    record_read_pos_ += bytes_per_10_ms_;
-    // Reduce number of cached bytes with the consumed amount.
-    record_cached_bytes_ -= bytes_per_10_ms_;
+  // Deliver all complete 10ms chunks directly from |buffer|, i.e. without
+  // copying them into the cache first.
+  while (size_in_bytes >= bytes_per_10_ms_) {
+    DeliverRecordedChunk(buffer, playout_delay_ms, record_delay_ms);
+    buffer += bytes_per_10_ms_;
+    size_in_bytes -= bytes_per_10_ms_;
   }
+  // Store the remaining bytes (less than 10ms) until the next call.
+  memcpy(record_cache_buffer_.get(), buffer, size_in_bytes);
+  record_cached_bytes_ = size_in_bytes;
+}
+
+void FineAudioBuffer::DeliverRecordedChunk(const int8_t* chunk,
+                                           int playout_delay_ms,
+                                           int record_delay_ms) {
+  device_buffer_->SetRecordedBuffer(chunk, samples_per_10_ms_);
+  device_buffer_->SetVQEData(playout_delay_ms, record_delay_ms, 0);
+  device_buffer_->DeliverRecordedData();
 }
 
 }  // namespace webrtc
@@ -64,12 +64,19 @@ class FineAudioBuffer {
   // Example: buffer size is 5ms => call #1 stores 5ms of data, call #2 stores
   // 5ms of data and sends a total of 10ms to WebRTC and clears the intenal
   // cache. Call #3 restarts the scheme above.
+  // Complete 10ms chunks are sent directly from |buffer|; only the parts of
+  // chunks which straddle two calls are copied into the internal cache.
   void DeliverRecordedData(const int8_t* buffer,
                            size_t size_in_bytes,
                            int playout_delay_ms,
                            int record_delay_ms);
 
  private:
+  // Sends one 10ms |chunk| of recorded audio to |device_buffer_|.
+  void DeliverRecordedChunk(const int8_t* chunk,
+                            int playout_delay_ms,
+                            int record_delay_ms);
+
   // Device buffer that works with 10ms chunks of data both for playout and
   // for recording. I.e., the WebRTC side will always be asked for audio to be
   // played out in 10ms chunks and recorded audio will be sent to WebRTC in
@@ -92,16 +99,11 @@ class FineAudioBuffer {
   size_t playout_cached_buffer_start_;
   // Number of bytes stored in output (contain samples to be played out) cache.
   size_t playout_cached_bytes_;
-  // Storage for input samples that are about to be delivered to the WebRTC
-  // ADB or remains from the last successful delivery of a 10ms audio buffer.
+  // Storage for input samples which do not form a complete 10ms chunk yet.
+  // Holds at most 10ms of audio.
   std::unique_ptr<int8_t[]> record_cache_buffer_;
-  // Required (max) size in bytes of the |record_cache_buffer_|.
-  const size_t required_record_buffer_size_bytes_;
   // Number of bytes in input (contains recorded samples) cache.
   size_t record_cached_bytes_;
-  // Read and write pointers used in the buffering scheme on the recording side.
-  size_t record_read_pos_;
-  size_t record_write_pos_;
 };
 
 }  // namespace webrtc
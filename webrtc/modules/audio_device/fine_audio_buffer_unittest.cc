@@ -143,4 +143,31 @@ TEST(FineBufferTest, GreaterThan10ms) {
   RunFineBufferTest(kSampleRate, kFrameSizeSamples);
 }
 
+// Verifies that complete 10ms chunks of recorded audio are delivered directly
+// from the provided buffer, i.e. without being copied first.
+TEST(FineBufferTest, DeliverRecordedChunksWithoutCopy) {
+  const int kSampleRate = 48000;
+  const int kSamplesPer10Ms = kSampleRate * 10 / 1000;
+  const int kBytesPer10Ms = kSamplesPer10Ms * static_cast<int>(sizeof(int16_t));
+  const int kFrameSizeBytes = 3 * kBytesPer10Ms;
+  std::unique_ptr<int8_t[]> in_buffer(new int8_t[kFrameSizeBytes]);
+
+  MockAudioDeviceBuffer audio_device_buffer;
+  {
+    InSequence s;
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_CALL(audio_device_buffer,
+                  SetRecordedBuffer(in_buffer.get() + i * kBytesPer10Ms,
+                                    kSamplesPer10Ms))
+          .WillOnce(Return(0));
+    }
+  }
+  EXPECT_CALL(audio_device_buffer, SetVQEData(_, _, _)).Times(3);
+  EXPECT_CALL(audio_device_buffer, DeliverRecordedData()).Times(3);
+
+  FineAudioBuffer fine_buffer(&audio_device_buffer, kFrameSizeBytes,
+                              kSampleRate);
+  fine_buffer.DeliverRecordedData(in_buffer.get(), kFrameSizeBytes, 0, 0);
+}
+
 }  // namespace webrtc
@@ -38,7 +38,10 @@ class FineAudioBuffer;
 //
 // Recorded audio will be delivered on a real-time internal I/O thread in the
 // audio unit. The audio unit will also ask for audio data to play out on this
-// same thread.
+// same thread. The callbacks on that thread neither log nor touch the audio
+// session; they only count glitches, which are reported on the creating
+// thread. If playout glitches persist with an I/O buffer duration below 10ms,
+// the buffer duration falls back to 10ms.
 class AudioDeviceIOS : public AudioDeviceGeneric,
                        public AudioSessionObserver,
                        public VoiceProcessingAudioUnitObserver,
@@ -70,15 +73,12 @@ class AudioDeviceIOS : public AudioDeviceGeneric,
   int32_t SetLoudspeakerStatus(bool enable) override;
   int32_t GetLoudspeakerStatus(bool& enabled) const override;
 
-  // These methods returns hard-coded delay values and not dynamic delay
-  // estimates. The reason is that iOS supports a built-in AEC and the WebRTC
-  // AEC will always be disabled in the Libjingle layer to avoid running two
-  // AEC implementations at the same time. And, it saves resources to avoid
-  // updating these delay values continuously.
-  // TODO(henrika): it would be possible to mark these two methods as not
-  // implemented since they are only called for A/V-sync purposes today and
-  // A/V-sync is not supported on iOS. However, we avoid adding error messages
-  // the log by using these dummy implementations instead.
+  // These methods return the output and input latencies reported by the
+  // audio session plus the I/O buffer duration, updated each time the audio
+  // buffers are set up, and hard-coded values before that. They are not
+  // dynamic delay estimates. iOS supports a built-in AEC and the WebRTC AEC
+  // will always be disabled in the Libjingle layer to avoid running two AEC
+  // implementations at the same time.
   int32_t PlayoutDelay(uint16_t& delayMS) const override;
   int32_t RecordingDelay(uint16_t& delayMS) const override;
 
@@ -188,6 +188,19 @@ class AudioDeviceIOS : public AudioDeviceGeneric,
   void HandleCanPlayOrRecordChange(bool can_play_or_record);
   void HandleSampleRateChange(float sample_rate);
 
+  // Called periodically on |thread_| while there is an audio unit. Logs the
+  // glitches counted by the audio callbacks since the last call, and raises
+  // the I/O buffer duration if there were too many playout glitches.
+  void CheckForGlitches();
+
+  // Counts a glitch in |num_glitches| if |time_stamp| isn't the expected
+  // |next_sample_time|, and expects the next callback |num_frames| later.
+  // Called on the real-time I/O thread.
+  static void DetectGlitch(const AudioTimeStamp* time_stamp,
+                           UInt32 num_frames,
+                           Float64* next_sample_time,
+                           volatile int* num_glitches);
+
   // Uses current |playout_parameters_| and |record_parameters_| to inform the
   // audio device buffer (ADB) about our internal audio parameters.
   void UpdateAudioDeviceBuffer();
@@ -294,6 +307,26 @@ class AudioDeviceIOS : public AudioDeviceGeneric,
 
   // Set to true if we've activated the audio session.
   bool has_configured_session_;
+
+  // Delay estimates in milliseconds. Written on |thread_| and read on the
+  // real-time I/O thread.
+  volatile int playout_delay_ms_;
+  volatile int record_delay_ms_;
+
+  // The sample time that the next callback is expected at. Only accessed on
+  // the real-time I/O thread.
+  Float64 next_playout_sample_time_;
+  Float64 next_record_sample_time_;
+
+  // Total number of callbacks with missing or unexpected audio. Incremented
+  // on the real-time I/O thread.
+  volatile int num_playout_glitches_;
+  volatile int num_record_glitches_;
+
+  // The totals at the last CheckForGlitches() call. Only accessed on
+  // |thread_|.
+  int last_num_playout_glitches_;
+  int last_num_record_glitches_;
 };
 
 }  // namespace webrtc
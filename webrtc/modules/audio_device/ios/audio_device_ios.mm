@@ -61,11 +61,21 @@ namespace webrtc {
 const UInt16 kFixedPlayoutDelayEstimate = 30;
 const UInt16 kFixedRecordDelayEstimate = 30;
 
+// Interval between the checks for glitches, and the number of playout glitches
+// per interval that makes a buffer duration below 10ms fall back to 10ms.
+const int kGlitchCheckIntervalMs = 2000;
+const int kMaxPlayoutGlitchesPerCheck = 4;
+
+// Gaps longer than this many buffers between two callbacks are restarts of the
+// audio unit rather than glitches.
+const int kMaxGlitchBuffers = 100;
+
 enum AudioDeviceMessageType : uint32_t {
   kMessageTypeInterruptionBegin,
   kMessageTypeInterruptionEnd,
   kMessageTypeValidRouteChange,
   kMessageTypeCanPlayOrRecordChange,
+  kMessageTypeCheckForGlitches,
 };
 
 using ios::CheckAndLogError;
@@ -100,7 +110,15 @@ AudioDeviceIOS::AudioDeviceIOS()
       rec_is_initialized_(false),
       play_is_initialized_(false),
       is_interrupted_(false),
-      has_configured_session_(false) {
+      has_configured_session_(false),
+      playout_delay_ms_(kFixedPlayoutDelayEstimate),
+      record_delay_ms_(kFixedRecordDelayEstimate),
+      next_playout_sample_time_(-1),
+      next_record_sample_time_(-1),
+      num_playout_glitches_(0),
+      num_record_glitches_(0),
+      last_num_playout_glitches_(0),
+      last_num_record_glitches_(0) {
   LOGI() << "ctor" << ios::GetCurrentThreadDescription();
   thread_ = rtc::Thread::Current();
   audio_session_observer_ =
@@ -309,12 +327,14 @@ int32_t AudioDeviceIOS::GetLoudspeakerStatus(bool& enabled) const {
 }
 
 int32_t AudioDeviceIOS::PlayoutDelay(uint16_t& delayMS) const {
-  delayMS = kFixedPlayoutDelayEstimate;
+  delayMS = static_cast<uint16_t>(
+      rtc::AtomicOps::AcquireLoad(&playout_delay_ms_));
   return 0;
 }
 
 int32_t AudioDeviceIOS::RecordingDelay(uint16_t& delayMS) const {
-  delayMS = kFixedRecordDelayEstimate;
+  delayMS = static_cast<uint16_t>(
+      rtc::AtomicOps::AcquireLoad(&record_delay_ms_));
   return 0;
 }
 
@@ -366,18 +386,16 @@ OSStatus AudioDeviceIOS::OnDeliverRecordedData(
   if (!rtc::AtomicOps::AcquireLoad(&recording_))
     return result;
 
+  DetectGlitch(time_stamp, num_frames, &next_record_sample_time_,
+               &num_record_glitches_);
   size_t frames_per_buffer = record_parameters_.frames_per_buffer();
   if (num_frames != frames_per_buffer) {
     // We have seen short bursts (1-2 frames) where |in_number_frames| changes.
-    // Add a log to keep track of longer sequences if that should ever happen.
+    // Count a glitch to keep track of longer sequences if that should ever
+    // happen; logging on this thread could block it.
     // Also return since calling AudioUnitRender in this state will only result
     // in kAudio_ParamError (-50) anyhow.
-    RTCLogWarning(@"Expected %u frames but got %u",
-                  static_cast<unsigned int>(frames_per_buffer),
-                  static_cast<unsigned int>(num_frames));
-
-    RTCAudioSession *session = [RTCAudioSession sharedInstance];
-    RTCLogWarning(@"Session:\n %@", session);
+    rtc::AtomicOps::Increment(&num_record_glitches_);
     return result;
   }
 
@@ -391,7 +409,7 @@ OSStatus AudioDeviceIOS::OnDeliverRecordedData(
   result =
       audio_unit_->Render(flags, time_stamp, bus_number, num_frames, io_data);
   if (result != noErr) {
-    RTCLogError(@"Failed to render audio.");
+    rtc::AtomicOps::Increment(&num_record_glitches_);
     return result;
   }
 
@@ -403,9 +421,9 @@ OSStatus AudioDeviceIOS::OnDeliverRecordedData(
   RTC_CHECK_EQ(size_in_bytes / VoiceProcessingAudioUnit::kBytesPerSample,
                num_frames);
   int8_t* data = static_cast<int8_t*>(audio_buffer->mData);
-  fine_audio_buffer_->DeliverRecordedData(data, size_in_bytes,
-                                          kFixedPlayoutDelayEstimate,
-                                          kFixedRecordDelayEstimate);
+  fine_audio_buffer_->DeliverRecordedData(
+      data, size_in_bytes, rtc::AtomicOps::AcquireLoad(&playout_delay_ms_),
+      rtc::AtomicOps::AcquireLoad(&record_delay_ms_));
   return noErr;
 }
 
@@ -424,6 +442,8 @@ OSStatus AudioDeviceIOS::OnGetPlayoutData(AudioUnitRenderActionFlags* flags,
   RTC_CHECK_EQ(size_in_bytes / VoiceProcessingAudioUnit::kBytesPerSample,
                num_frames);
   int8_t* destination = reinterpret_cast<int8_t*>(audio_buffer->mData);
+  DetectGlitch(time_stamp, num_frames, &next_playout_sample_time_,
+               &num_playout_glitches_);
   // Produce silence and give audio unit a hint about it if playout is not
   // activated.
   if (!rtc::AtomicOps::AcquireLoad(&playing_)) {
@@ -431,15 +451,13 @@ OSStatus AudioDeviceIOS::OnGetPlayoutData(AudioUnitRenderActionFlags* flags,
     memset(destination, 0, size_in_bytes);
     return noErr;
   }
-  // Produce silence and log a warning message for the case when Core Audio is
+  // Produce silence and count a glitch for the case when Core Audio is
   // asking for an invalid number of audio frames. I don't expect this to happen
   // but it is done as a safety measure to avoid bad audio if such as case would
   // ever be triggered e.g. in combination with BT devices.
   const size_t frames_per_buffer = playout_parameters_.frames_per_buffer();
   if (num_frames != frames_per_buffer) {
-    RTCLogWarning(@"Expected %u frames but got %u",
-                  static_cast<unsigned int>(frames_per_buffer),
-                  static_cast<unsigned int>(num_frames));
+    rtc::AtomicOps::Increment(&num_playout_glitches_);
     *flags |= kAudioUnitRenderAction_OutputIsSilence;
     memset(destination, 0, size_in_bytes);
     return noErr;
@@ -454,6 +472,21 @@ OSStatus AudioDeviceIOS::OnGetPlayoutData(AudioUnitRenderActionFlags* flags,
   return noErr;
 }
 
+// static
+void AudioDeviceIOS::DetectGlitch(const AudioTimeStamp* time_stamp,
+                                  UInt32 num_frames,
+                                  Float64* next_sample_time,
+                                  volatile int* num_glitches) {
+  if (!(time_stamp->mFlags & kAudioTimeStampSampleTimeValid))
+    return;
+  const Float64 gap = time_stamp->mSampleTime - *next_sample_time;
+  if (*next_sample_time >= 0 && gap >= 1 &&
+      gap <= static_cast<Float64>(num_frames) * kMaxGlitchBuffers) {
+    rtc::AtomicOps::Increment(num_glitches);
+  }
+  *next_sample_time = time_stamp->mSampleTime + num_frames;
+}
+
 void AudioDeviceIOS::OnMessage(rtc::Message *msg) {
   switch (msg->message_id) {
     case kMessageTypeInterruptionBegin:
@@ -472,6 +505,9 @@ void AudioDeviceIOS::OnMessage(rtc::Message *msg) {
       delete data;
       break;
     }
+    case kMessageTypeCheckForGlitches:
+      CheckForGlitches();
+      break;
   }
 }
 
@@ -582,6 +618,52 @@ void AudioDeviceIOS::HandleSampleRateChange(float sample_rate) {
   RTCLog(@"Successfully handled sample rate change.");
 }
 
+void AudioDeviceIOS::CheckForGlitches() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!audio_unit_)
+    return;
+  thread_->PostDelayed(RTC_FROM_HERE, kGlitchCheckIntervalMs, this,
+                       kMessageTypeCheckForGlitches);
+
+  const int num_playout_glitches =
+      rtc::AtomicOps::AcquireLoad(&num_playout_glitches_);
+  const int num_record_glitches =
+      rtc::AtomicOps::AcquireLoad(&num_record_glitches_);
+  const int new_playout_glitches =
+      num_playout_glitches - last_num_playout_glitches_;
+  const int new_record_glitches =
+      num_record_glitches - last_num_record_glitches_;
+  last_num_playout_glitches_ = num_playout_glitches;
+  last_num_record_glitches_ = num_record_glitches;
+  if (new_playout_glitches == 0 && new_record_glitches == 0)
+    return;
+  RTCLogWarning(@"%d playout and %d record glitches in the last %d ms.",
+                new_playout_glitches, new_record_glitches,
+                kGlitchCheckIntervalMs);
+
+  // Fall back to the default I/O buffer duration, until the audio session is
+  // configured again, if a shorter one can't be kept up with.
+  RTCAudioSession* session = [RTCAudioSession sharedInstance];
+  if (is_interrupted_ || new_playout_glitches <= kMaxPlayoutGlitchesPerCheck ||
+      session.preferredIOBufferDuration >=
+          kRTCAudioSessionHighPerformanceIOBufferDuration) {
+    return;
+  }
+  RTCLogWarning(@"Falling back to an I/O buffer duration of %f s.",
+                kRTCAudioSessionHighPerformanceIOBufferDuration);
+  [session lockForConfiguration];
+  NSError* error = nil;
+  if (![session setPreferredIOBufferDuration:
+                    kRTCAudioSessionHighPerformanceIOBufferDuration
+                                       error:&error]) {
+    RTCLogError(@"Failed to set the I/O buffer duration: %@",
+                error.localizedDescription);
+  }
+  [session unlockForConfiguration];
+  // Sets up the audio buffers for the new buffer duration.
+  HandleSampleRateChange(session.sampleRate);
+}
+
 void AudioDeviceIOS::UpdateAudioDeviceBuffer() {
   LOGI() << "UpdateAudioDevicebuffer";
   // AttachAudioBuffer() is called at construction by the main class but check
@@ -631,6 +713,17 @@ void AudioDeviceIOS::SetupAudioBuffersForActiveAudioSession() {
   RTC_DCHECK_EQ(playout_parameters_.GetBytesPerBuffer(),
                 record_parameters_.GetBytesPerBuffer());
 
+  // The delay in each direction is the latency reported by the session plus
+  // one I/O buffer.
+  const int playout_delay_ms = static_cast<int>(
+      (session.outputLatency + io_buffer_duration) * 1000 + 0.5);
+  const int record_delay_ms = static_cast<int>(
+      (session.inputLatency + io_buffer_duration) * 1000 + 0.5);
+  rtc::AtomicOps::ReleaseStore(&playout_delay_ms_, playout_delay_ms);
+  rtc::AtomicOps::ReleaseStore(&record_delay_ms_, record_delay_ms);
+  LOG(LS_INFO) << " round-trip latency: "
+               << playout_delay_ms + record_delay_ms << " ms";
+
   // Update the ADB parameters since the sample rate might have changed.
   UpdateAudioDeviceBuffer();
 
@@ -798,6 +891,9 @@ bool AudioDeviceIOS::InitPlayOrRecord() {
   if (!CreateAudioUnit()) {
     return false;
   }
+  // Look for glitches for as long as there is an audio unit.
+  thread_->PostDelayed(RTC_FROM_HERE, kGlitchCheckIntervalMs, this,
+                       kMessageTypeCheckForGlitches);
 
   RTCAudioSession* session = [RTCAudioSession sharedInstance];
   // Subscribe to audio session events.
@@ -834,6 +930,7 @@ void AudioDeviceIOS::ShutdownPlayOrRecord() {
 
   // Close and delete the voice-processing I/O unit.
   audio_unit_.reset();
+  thread_->Clear(this, kMessageTypeCheckForGlitches);
 
   // Remove audio session notification observers.
   RTCAudioSession* session = [RTCAudioSession sharedInstance];
@@ -18,6 +18,7 @@ extern const double kRTCAudioSessionHighPerformanceSampleRate;
 extern const double kRTCAudioSessionLowComplexitySampleRate;
 extern const double kRTCAudioSessionHighPerformanceIOBufferDuration;
 extern const double kRTCAudioSessionLowComplexityIOBufferDuration;
+extern const double kRTCAudioSessionLowLatencyIOBufferDuration;
 
 // Struct to hold configuration values.
 @interface RTCAudioSessionConfiguration : NSObject
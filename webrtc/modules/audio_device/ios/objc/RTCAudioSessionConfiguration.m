@@ -52,6 +52,12 @@ const double kRTCAudioSessionHighPerformanceIOBufferDuration = 0.01;
 // TODO(henrika): monitor this size and determine if it should be modified.
 const double kRTCAudioSessionLowComplexityIOBufferDuration = 0.06;
 
+// Smaller buffer size that can be set as ioBufferDuration of the WebRTC
+// configuration to cut the latency by 5ms in each direction, at the cost of
+// twice as many callbacks. If the device can't keep up, AudioDeviceIOS falls
+// back to kRTCAudioSessionHighPerformanceIOBufferDuration.
+const double kRTCAudioSessionLowLatencyIOBufferDuration = 0.005;
+
 static RTCAudioSessionConfiguration *gWebRTCConfiguration = nil;
 
 @implementation RTCAudioSessionConfiguration
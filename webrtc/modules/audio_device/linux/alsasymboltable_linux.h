@@ -43,6 +43,8 @@ namespace webrtc_adm_linux_alsa {
   X(snd_pcm_close) \
   X(snd_pcm_delay) \
   X(snd_pcm_drop) \
+  X(snd_pcm_mmap_readi) \
+  X(snd_pcm_mmap_writei) \
   X(snd_pcm_open) \
   X(snd_pcm_prepare) \
   X(snd_pcm_readi) \
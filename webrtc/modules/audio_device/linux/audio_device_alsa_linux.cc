@@ -51,9 +51,11 @@ namespace webrtc
 static const unsigned int ALSA_PLAYOUT_FREQ = 48000;
 static const unsigned int ALSA_PLAYOUT_CH = 2;
 static const unsigned int ALSA_PLAYOUT_LATENCY = 40*1000; // in us
+static const unsigned int ALSA_PLAYOUT_MMAP_LATENCY = 20*1000; // in us
 static const unsigned int ALSA_CAPTURE_FREQ = 48000;
 static const unsigned int ALSA_CAPTURE_CH = 2;
 static const unsigned int ALSA_CAPTURE_LATENCY = 40*1000; // in us
+static const unsigned int ALSA_CAPTURE_MMAP_LATENCY = 20*1000; // in us
 static const unsigned int ALSA_CAPTURE_WAIT_TIMEOUT = 5; // in ms
 
 #define FUNC_GET_NUM_OF_DEVICE 0
@@ -71,6 +73,8 @@ AudioDeviceLinuxALSA::AudioDeviceLinuxALSA(const int32_t id) :
     _outputDeviceIsSpecified(false),
     _handleRecord(NULL),
     _handlePlayout(NULL),
+    _recordingMmapAccess(false),
+    _playoutMmapAccess(false),
     _recordingBuffersizeInFrame(0),
     _recordingPeriodSizeInFrame(0),
     _playoutBufferSizeInFrame(0),
@@ -1087,18 +1091,12 @@ int32_t AudioDeviceLinuxALSA::InitPlayout()
     }
 
     _playoutFramesIn10MS = _playoutFreq/100;
-    if ((errVal = LATE(snd_pcm_set_params)( _handlePlayout,
-#if defined(WEBRTC_ARCH_BIG_ENDIAN)
-        SND_PCM_FORMAT_S16_BE,
-#else
-        SND_PCM_FORMAT_S16_LE, //format
-#endif
-        SND_PCM_ACCESS_RW_INTERLEAVED, //access
-        _playChannels, //channels
-        _playoutFreq, //rate
-        1, //soft_resample
-        ALSA_PLAYOUT_LATENCY //40*1000 //latency required overall latency in us
-    )) < 0)
+    if ((errVal = SetPcmParams(_handlePlayout,
+                               _playChannels,
+                               _playoutFreq,
+                               ALSA_PLAYOUT_LATENCY,
+                               ALSA_PLAYOUT_MMAP_LATENCY,
+                               &_playoutMmapAccess)) < 0)
     {   /* 0.5sec */
         _playoutFramesIn10MS = 0;
         WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
@@ -1243,18 +1241,12 @@ int32_t AudioDeviceLinuxALSA::InitRecording()
     }
 
     _recordingFramesIn10MS = _recordingFreq/100;
-    if ((errVal = LATE(snd_pcm_set_params)(_handleRecord,
-#if defined(WEBRTC_ARCH_BIG_ENDIAN)
-        SND_PCM_FORMAT_S16_BE, //format
-#else
-        SND_PCM_FORMAT_S16_LE, //format
-#endif
-        SND_PCM_ACCESS_RW_INTERLEAVED, //access
-        _recChannels, //channels
-        _recordingFreq, //rate
-        1, //soft_resample
-        ALSA_CAPTURE_LATENCY //latency in us
-    )) < 0)
+    if ((errVal = SetPcmParams(_handleRecord,
+                               _recChannels,
+                               _recordingFreq,
+                               ALSA_CAPTURE_LATENCY,
+                               ALSA_CAPTURE_MMAP_LATENCY,
+                               &_recordingMmapAccess)) < 0)
     {
          // Fall back to another mode then.
          if (_recChannels == 1)
@@ -1262,18 +1254,12 @@ int32_t AudioDeviceLinuxALSA::InitRecording()
          else
            _recChannels = 1;
 
-         if ((errVal = LATE(snd_pcm_set_params)(_handleRecord,
-#if defined(WEBRTC_ARCH_BIG_ENDIAN)
-             SND_PCM_FORMAT_S16_BE, //format
-#else
-             SND_PCM_FORMAT_S16_LE, //format
-#endif
-             SND_PCM_ACCESS_RW_INTERLEAVED, //access
-             _recChannels, //channels
-             _recordingFreq, //rate
-             1, //soft_resample
-             ALSA_CAPTURE_LATENCY //latency in us
-         )) < 0)
+         if ((errVal = SetPcmParams(_handleRecord,
+                                    _recChannels,
+                                    _recordingFreq,
+                                    ALSA_CAPTURE_LATENCY,
+                                    ALSA_CAPTURE_MMAP_LATENCY,
+                                    &_recordingMmapAccess)) < 0)
          {
              _recordingFramesIn10MS = 0;
              WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
@@ -1870,6 +1856,51 @@ int32_t AudioDeviceLinuxALSA::OutputSanityCheckAfterUnlockedPeriod() const
     return 0;
 }
 
+int32_t AudioDeviceLinuxALSA::SetPcmParams(snd_pcm_t* deviceHandle,
+                                           uint8_t channels,
+                                           uint32_t freq,
+                                           unsigned int latencyUs,
+                                           unsigned int mmapLatencyUs,
+                                           bool* mmapAccess)
+{
+    // Memory mapped access lets ALSA copy the audio directly into the ring
+    // buffer of the device, which allows for a smaller buffer (and latency).
+    int errVal = LATE(snd_pcm_set_params)(deviceHandle,
+#if defined(WEBRTC_ARCH_BIG_ENDIAN)
+        SND_PCM_FORMAT_S16_BE, //format
+#else
+        SND_PCM_FORMAT_S16_LE, //format
+#endif
+        SND_PCM_ACCESS_MMAP_INTERLEAVED, //access
+        channels, //channels
+        freq, //rate
+        1, //soft_resample
+        mmapLatencyUs //latency in us
+    );
+    if (errVal >= 0)
+    {
+        *mmapAccess = true;
+        return errVal;
+    }
+
+    WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                 "    mmap access not supported: %s (%d), using rw access",
+                 LATE(snd_strerror)(errVal), errVal);
+    *mmapAccess = false;
+    return LATE(snd_pcm_set_params)(deviceHandle,
+#if defined(WEBRTC_ARCH_BIG_ENDIAN)
+        SND_PCM_FORMAT_S16_BE, //format
+#else
+        SND_PCM_FORMAT_S16_LE, //format
+#endif
+        SND_PCM_ACCESS_RW_INTERLEAVED, //access
+        channels, //channels
+        freq, //rate
+        1, //soft_resample
+        latencyUs //latency in us
+    );
+}
+
 int32_t AudioDeviceLinuxALSA::ErrorRecovery(int32_t error,
                                             snd_pcm_t* deviceHandle)
 {
@@ -1879,6 +1910,15 @@ int32_t AudioDeviceLinuxALSA::ErrorRecovery(int32_t error,
                (LATE(snd_pcm_stream)(deviceHandle) == SND_PCM_STREAM_CAPTURE) ?
                    "capture" : "playout", LATE(snd_strerror)(error), error, st);
 
+    if (-EPIPE == error && _ptrAudioBuffer)
+    {
+        // Buffer underrun (playout) or overrun (capture).
+        if (LATE(snd_pcm_stream)(deviceHandle) == SND_PCM_STREAM_CAPTURE)
+            _ptrAudioBuffer->ReportRecordingOverrun();
+        else
+            _ptrAudioBuffer->ReportPlayoutUnderrun();
+    }
+
     // It is recommended to use snd_pcm_recover for all errors. If that function
     // cannot handle the error, the input error code will be returned, otherwise
     // 0 is returned. From snd_pcm_recover API doc: "This functions handles
@@ -2021,15 +2061,25 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess()
 
     int size = LATE(snd_pcm_frames_to_bytes)(_handlePlayout,
         _playoutFramesLeft);
-    frames = LATE(snd_pcm_writei)(
-        _handlePlayout,
-        &_playoutBuffer[_playoutBufferSizeIn10MS - size],
-        avail_frames);
+    if (_playoutMmapAccess)
+    {
+        frames = LATE(snd_pcm_mmap_writei)(
+            _handlePlayout,
+            &_playoutBuffer[_playoutBufferSizeIn10MS - size],
+            avail_frames);
+    }
+    else
+    {
+        frames = LATE(snd_pcm_writei)(
+            _handlePlayout,
+            &_playoutBuffer[_playoutBufferSizeIn10MS - size],
+            avail_frames);
+    }
 
     if (frames < 0)
     {
         WEBRTC_TRACE(kTraceStream, kTraceAudioDevice, _id,
-                     "playout snd_pcm_writei error: %s",
+                     "playout write error: %s",
                      LATE(snd_strerror)(frames));
         _playoutFramesLeft = 0;
         ErrorRecovery(frames, _handlePlayout);
@@ -2085,12 +2135,20 @@ bool AudioDeviceLinuxALSA::RecThreadProcess()
     if (static_cast<uint32_t>(avail_frames) > _recordingFramesLeft)
         avail_frames = _recordingFramesLeft;
 
-    frames = LATE(snd_pcm_readi)(_handleRecord,
-        buffer, avail_frames); // frames to be written
+    if (_recordingMmapAccess)
+    {
+        frames = LATE(snd_pcm_mmap_readi)(_handleRecord,
+            buffer, avail_frames); // frames to be written
+    }
+    else
+    {
+        frames = LATE(snd_pcm_readi)(_handleRecord,
+            buffer, avail_frames); // frames to be written
+    }
     if (frames < 0)
     {
         WEBRTC_TRACE(kTraceError, kTraceAudioDevice, _id,
-                     "capture snd_pcm_readi error: %s",
+                     "capture read error: %s",
                      LATE(snd_strerror)(frames));
         ErrorRecovery(frames, _handleRecord);
         UnLock();
@@ -165,6 +165,15 @@ private:
                            char* enumDeviceName = NULL,
                            const int32_t ednLen = 0) const;
     int32_t ErrorRecovery(int32_t error, snd_pcm_t* deviceHandle);
+    // Configures |deviceHandle| for memory mapped access with |mmapLatencyUs|,
+    // and falls back to read/write access with |latencyUs| if the device does
+    // not support it. |mmapAccess| tells which one is used.
+    int32_t SetPcmParams(snd_pcm_t* deviceHandle,
+                         uint8_t channels,
+                         uint32_t freq,
+                         unsigned int latencyUs,
+                         unsigned int mmapLatencyUs,
+                         bool* mmapAccess);
 
 private:
     bool KeyPressed() const;
@@ -203,6 +212,8 @@ private:
 
     snd_pcm_t* _handleRecord;
     snd_pcm_t* _handlePlayout;
+    bool _recordingMmapAccess;
+    bool _playoutMmapAccess;
 
     snd_pcm_uframes_t _recordingBuffersizeInFrame;
     snd_pcm_uframes_t _recordingPeriodSizeInFrame;
@@ -2285,6 +2285,7 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler()
 {
     WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
                  "  Playout underflow");
+    _ptrAudioBuffer->ReportPlayoutUnderrun();
 
     if (_configuredLatencyPlay == WEBRTC_PA_NO_LATENCY_REQUIREMENTS)
     {
@@ -2382,6 +2383,7 @@ void AudioDeviceLinuxPulse::PaStreamOverflowCallbackHandler()
 {
     WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
                  "  Recording overflow");
+    _ptrAudioBuffer->ReportRecordingOverrun();
 }
 
 int32_t AudioDeviceLinuxPulse::LatencyUsecs(pa_stream *stream)
@@ -17,6 +17,7 @@
 #include "webrtc/modules/audio_device/test/audio_device_test_defines.h"
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/test/testsupport/fileutils.h"
 
 #include "webrtc/modules/audio_device/audio_device_config.h"
@@ -150,6 +151,61 @@ class AudioTransportAPI: public AudioTransport {
   uint32_t play_count_;
 };
 
+// Keeps track of the total (playout plus recording) delay that the device
+// reports with the recorded data, i.e. its estimate of the round-trip latency.
+class DelayMeasuringTransportAPI : public AudioTransportAPI {
+ public:
+  DelayMeasuringTransportAPI(
+      const rtc::scoped_refptr<AudioDeviceModule>& audioDevice)
+      : AudioTransportAPI(audioDevice),
+        num_delays_(0),
+        sum_delay_ms_(0),
+        min_delay_ms_(0),
+        max_delay_ms_(0) {}
+
+  int32_t RecordedDataIsAvailable(const void* audioSamples,
+                                  const size_t nSamples,
+                                  const size_t nBytesPerSample,
+                                  const size_t nChannels,
+                                  const uint32_t sampleRate,
+                                  const uint32_t totalDelay,
+                                  const int32_t clockSkew,
+                                  const uint32_t currentMicLevel,
+                                  const bool keyPressed,
+                                  uint32_t& newMicLevel) override {
+    {
+      rtc::CritScope lock(&crit_);
+      if (num_delays_ == 0 || totalDelay < min_delay_ms_)
+        min_delay_ms_ = totalDelay;
+      if (totalDelay > max_delay_ms_)
+        max_delay_ms_ = totalDelay;
+      sum_delay_ms_ += totalDelay;
+      ++num_delays_;
+    }
+    return AudioTransportAPI::RecordedDataIsAvailable(
+        audioSamples, nSamples, nBytesPerSample, nChannels, sampleRate,
+        totalDelay, clockSkew, currentMicLevel, keyPressed, newMicLevel);
+  }
+
+  // Returns false if no recorded data has been delivered.
+  bool GetDelays(uint32_t* min_ms, uint32_t* average_ms, uint32_t* max_ms) {
+    rtc::CritScope lock(&crit_);
+    if (num_delays_ == 0)
+      return false;
+    *min_ms = min_delay_ms_;
+    *average_ms = static_cast<uint32_t>(sum_delay_ms_ / num_delays_);
+    *max_ms = max_delay_ms_;
+    return true;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  uint64_t num_delays_;
+  uint64_t sum_delay_ms_;
+  uint32_t min_delay_ms_;
+  uint32_t max_delay_ms_;
+};
+
 class AudioDeviceAPITest: public testing::Test {
  protected:
   AudioDeviceAPITest() {}
@@ -727,6 +783,39 @@ TEST_F(AudioDeviceAPITest, StartAndStopRecording) {
   }
 }
 
+// Runs playout and recording on the default devices for a while and logs the
+// round-trip delay they report. On Windows, run with
+// --force_fieldtrials=WebRTC-Audio-WasapiLowLatency/Enabled/ to compare with
+// the low-latency WASAPI streams.
+TEST_F(AudioDeviceAPITest, MeasureRoundTripDelay) {
+  bool playout_available;
+  bool recording_available;
+  EXPECT_EQ(0, audio_device_->SetPlayoutDevice(MACRO_DEFAULT_DEVICE));
+  EXPECT_EQ(0, audio_device_->SetRecordingDevice(MACRO_DEFAULT_DEVICE));
+  EXPECT_EQ(0, audio_device_->PlayoutIsAvailable(&playout_available));
+  EXPECT_EQ(0, audio_device_->RecordingIsAvailable(&recording_available));
+  if (!playout_available || !recording_available)
+    return;
+
+  DelayMeasuringTransportAPI transport(audio_device_);
+  EXPECT_EQ(0, audio_device_->RegisterAudioCallback(&transport));
+  EXPECT_EQ(0, audio_device_->InitPlayout());
+  EXPECT_EQ(0, audio_device_->InitRecording());
+  EXPECT_EQ(0, audio_device_->StartPlayout());
+  EXPECT_EQ(0, audio_device_->StartRecording());
+  SleepMs(2000);
+  EXPECT_EQ(0, audio_device_->StopRecording());
+  EXPECT_EQ(0, audio_device_->StopPlayout());
+  EXPECT_EQ(0, audio_device_->RegisterAudioCallback(NULL));
+
+  uint32_t min_ms = 0;
+  uint32_t average_ms = 0;
+  uint32_t max_ms = 0;
+  ASSERT_TRUE(transport.GetDelays(&min_ms, &average_ms, &max_ms));
+  TEST_LOG("\nRound-trip delay: min=%u ms, average=%u ms, max=%u ms\n",
+           min_ms, average_ms, max_ms);
+}
+
 #if defined(_WIN32) && !defined(WEBRTC_WINDOWS_CORE_AUDIO_BUILD)
 TEST_F(AudioDeviceAPITest, SetAndGetWaveOutVolume) {
   uint32_t vol(0);
@@ -27,6 +27,8 @@
 #include <assert.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include <windows.h>
 #include <comdef.h>
 #include <dmo.h>
@@ -37,6 +39,7 @@
 
 #include "webrtc/base/logging.h"
 #include "webrtc/base/platform_thread.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/system_wrappers/include/trace.h"
 
@@ -424,6 +427,8 @@ AudioDeviceWindowsCore::AudioDeviceWindowsCore(const int32_t id) :
     _dmo(NULL),
     _mediaBuffer(NULL),
     _builtInAecEnabled(false),
+    _lowLatencyEnabled(field_trial::FindFullName(
+        "WebRTC-Audio-WasapiLowLatency") == "Enabled"),
     _playAudioFrameSize(0),
     _playSampleRate(0),
     _playBlockSize(0),
@@ -2318,13 +2323,32 @@ int32_t AudioDeviceWindowsCore::InitPlayout()
         // read by GetBufferSize() and it is 20ms on most machines.
         hnsBufferDuration = 30*10000;
     }
-    hr = _ptrClientOut->Initialize(
+    //
+    // In low-latency mode the render buffer must still fit one 10 ms block,
+    // since that is what the render thread writes on each pass.
+    if (_lowLatencyEnabled &&
+        _InitializeLowLatencyStream(_ptrDeviceOut,
+                                    &_ptrClientOut,
+                                    AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+                                    &Wfx,
+                                    _playBlockSize))
+    {
+        hr = S_OK;
+    }
+    else if (_ptrClientOut == NULL)
+    {
+        hr = E_POINTER;
+    }
+    else
+    {
+        hr = _ptrClientOut->Initialize(
                           AUDCLNT_SHAREMODE_SHARED,             // share Audio Engine with other applications
                           AUDCLNT_STREAMFLAGS_EVENTCALLBACK,    // processing of the audio buffer by the client will be event driven
                           hnsBufferDuration,                    // requested buffer capacity as a time value (in 100-nanosecond units)
                           0,                                    // periodicity
                           &Wfx,                                 // selected wave format
                           NULL);                                // session GUID
+    }
 
     if (FAILED(hr))
     {
@@ -2397,6 +2421,87 @@ Exit:
     return -1;
 }
 
+// ----------------------------------------------------------------------------
+//  _InitializeLowLatencyStream
+// ----------------------------------------------------------------------------
+
+bool AudioDeviceWindowsCore::_InitializeLowLatencyStream(
+    IMMDevice* device,
+    IAudioClient** client,
+    DWORD streamFlags,
+    const WAVEFORMATEX* format,
+    UINT32 minBufferFrames)
+{
+    IAudioClient3* client3 = NULL;
+    HRESULT hr = (*client)->QueryInterface(__uuidof(IAudioClient3),
+                                           (void**)&client3);
+    if (FAILED(hr))
+    {
+        WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                     "IAudioClient3 is not supported, using default period");
+        return false;
+    }
+
+    // All periods are given in audio frames. The engine only accepts
+    // multiples of the fundamental period between the min and max periods.
+    UINT32 defaultPeriod = 0;
+    UINT32 fundamentalPeriod = 0;
+    UINT32 minPeriod = 0;
+    UINT32 maxPeriod = 0;
+    hr = client3->GetSharedModeEnginePeriod(format,
+                                            &defaultPeriod,
+                                            &fundamentalPeriod,
+                                            &minPeriod,
+                                            &maxPeriod);
+    if (SUCCEEDED(hr))
+    {
+        WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                     "engine periods: default=%u fundamental=%u min=%u max=%u",
+                     defaultPeriod, fundamentalPeriod, minPeriod, maxPeriod);
+        // Fails if the format isn't one the engine can run at a reduced
+        // period, typically when it differs from the mix format.
+        hr = client3->InitializeSharedAudioStream(streamFlags,
+                                                  minPeriod,
+                                                  format,
+                                                  NULL);
+    }
+    SAFE_RELEASE(client3);
+    if (FAILED(hr))
+    {
+        WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
+                     "failed to initialize low-latency stream");
+        _TraceCOMError(hr);
+        return false;
+    }
+
+    UINT32 bufferFrames = 0;
+    hr = (*client)->GetBufferSize(&bufferFrames);
+    if (SUCCEEDED(hr) && bufferFrames >= minBufferFrames + minPeriod)
+    {
+        WEBRTC_TRACE(kTraceInfo, kTraceAudioDevice, _id,
+                     "low-latency stream: period=%u, buffer=%u frames",
+                     minPeriod, bufferFrames);
+        return true;
+    }
+
+    // An IAudioClient can only be initialized once, so start over with a new
+    // one that the caller can initialize with the default period.
+    WEBRTC_TRACE(kTraceWarning, kTraceAudioDevice, _id,
+                 "low-latency buffer of %u frames is too small, need %u",
+                 bufferFrames, minBufferFrames + minPeriod);
+    SAFE_RELEASE(*client);
+    hr = device->Activate(__uuidof(IAudioClient),
+                          CLSCTX_ALL,
+                          NULL,
+                          (void**)client);
+    if (FAILED(hr))
+    {
+        _TraceCOMError(hr);
+        *client = NULL;
+    }
+    return false;
+}
+
 // Capture initialization when the built-in AEC DirectX Media Object (DMO) is
 // used. Called from InitRecording(), most of which is skipped over. The DMO
 // handles device initialization itself.
@@ -2624,7 +2729,26 @@ int32_t AudioDeviceWindowsCore::InitRecording()
     }
 
     // Create a capturing stream.
-    hr = _ptrClientIn->Initialize(
+    //
+    // The capture thread collects packets of any size into 10 ms blocks, so
+    // a low-latency stream has no lower limit on its buffer size.
+    if (_lowLatencyEnabled &&
+        _InitializeLowLatencyStream(_ptrDeviceIn,
+                                    &_ptrClientIn,
+                                    AUDCLNT_STREAMFLAGS_EVENTCALLBACK |
+                                    AUDCLNT_STREAMFLAGS_NOPERSIST,
+                                    &Wfx,
+                                    0))
+    {
+        hr = S_OK;
+    }
+    else if (_ptrClientIn == NULL)
+    {
+        hr = E_POINTER;
+    }
+    else
+    {
+        hr = _ptrClientIn->Initialize(
                           AUDCLNT_SHAREMODE_SHARED,             // share Audio Engine with other applications
                           AUDCLNT_STREAMFLAGS_EVENTCALLBACK |   // processing of the audio buffer by the client will be event driven
                           AUDCLNT_STREAMFLAGS_NOPERSIST,        // volume and mute settings for an audio session will not persist across system restarts
@@ -2632,6 +2756,7 @@ int32_t AudioDeviceWindowsCore::InitRecording()
                           0,                                    // periodicity
                           &Wfx,                                 // selected wave format
                           NULL);                                // session GUID
+    }
 
 
     if (hr != S_OK)
@@ -3904,9 +4029,12 @@ DWORD AudioDeviceWindowsCore::DoCaptureThread()
 
     // Allocate memory for sync buffer.
     // It is used for compensation between native 44.1 and internal 44.0 and
-    // for cases when the capture buffer is larger than 10ms.
+    // for cases when the capture buffer is larger than 10ms. In low-latency
+    // mode the capture buffer can be smaller than 10ms, but the sync buffer
+    // must still hold a full 10ms block and one more packet.
     //
-    const UINT32 syncBufferSize = 2*(bufferLength * _recAudioFrameSize);
+    const UINT32 syncBufferSize =
+        2*(std::max<UINT32>(bufferLength, _recBlockSize) * _recAudioFrameSize);
     syncBuffer = new BYTE[syncBufferSize];
     if (syncBuffer == NULL)
     {
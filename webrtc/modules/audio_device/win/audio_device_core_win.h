@@ -272,6 +272,17 @@ private:
 
     int32_t InitRecordingDMO();
 
+    // Initializes |*client| as an event-driven shared-mode stream running at
+    // the smallest engine period that IAudioClient3 (Windows 10) allows.
+    // Returns false if that fails or if the endpoint buffer can't hold
+    // |minBufferFrames| plus one period; |*client| is then a fresh,
+    // uninitialized client (or NULL if it couldn't be activated again).
+    bool _InitializeLowLatencyStream(IMMDevice* device,
+                                     IAudioClient** client,
+                                     DWORD streamFlags,
+                                     const WAVEFORMATEX* format,
+                                     UINT32 minBufferFrames);
+
 private:
     ScopedCOMInitializer                    _comInit;
     AudioDeviceBuffer*                      _ptrAudioBuffer;
@@ -298,6 +309,9 @@ private:  // WASAPI
     rtc::scoped_refptr<IMediaObject> _dmo;
     rtc::scoped_refptr<IMediaBuffer> _mediaBuffer;
     bool                                    _builtInAecEnabled;
+    // Use the minimum shared-mode engine period when the OS supports it. Set
+    // by the "WebRTC-Audio-WasapiLowLatency" field trial.
+    const bool                              _lowLatencyEnabled;
 
     HANDLE                                  _hRenderSamplesReadyEvent;
     HANDLE                                  _hPlayThread;
@@ -17,6 +17,10 @@
 #include "webrtc/modules/include/module.h"
 #include "webrtc/modules/include/module_common_types.h"
 
+namespace rtc {
+class TaskQueuePool;
+}  // namespace rtc
+
 namespace webrtc {
 class MixerAudioSource;
 
@@ -31,8 +35,28 @@ class AudioMixer {
     kDefaultFrequency = kWbInHz
   };
 
+  struct FetchStats {
+    // Frames asked for on the threads of the fetch pool.
+    uint64_t fetched_frames = 0;
+    // Frames that their source took longer than a frame duration to deliver.
+    // A growing count means that the fetch pool needs more threads.
+    uint64_t late_frames = 0;
+    // The longest time a Mix() call waited for the frames of its sources.
+    int64_t max_fetch_time_us = 0;
+  };
+
   // Factory method. Constructor disabled.
   static std::unique_ptr<AudioMixer> Create(int id);
+  // Creates a mixer that asks its audio sources for audio in parallel, on
+  // task queues of |fetch_pool|, so that the decoding of many streams is
+  // spread over the threads of the pool instead of running serially in
+  // Mix(). Mix() still returns only when all the frames are delivered. A
+  // source's calls never overlap, but its GetAudioFrameWithMuted() runs on a
+  // pool thread and must not call back into the mixer. |fetch_pool| must
+  // outlive the mixer, and is only supported where task queue pools are
+  // (WEBRTC_BUILD_LIBEVENT).
+  static std::unique_ptr<AudioMixer> Create(int id,
+                                            rtc::TaskQueuePool* fetch_pool);
   virtual ~AudioMixer() {}
 
   // Add/remove audio sources as candidates for mixing.
@@ -56,6 +80,14 @@ class AudioMixer {
                    size_t number_of_channels,
                    AudioFrame* audio_frame_for_mixing) = 0;
 
+  // Places the result of the last Mix() call without the audio of
+  // |audio_source| in |audio_frame|, e.g. to send a participant the audio of
+  // everyone else. The audio of the other sources is not fetched again, so
+  // this is cheap for sources that were not mixed. Must be called on the
+  // thread calling Mix().
+  virtual void GetMixWithoutSource(const MixerAudioSource& audio_source,
+                                   AudioFrame* audio_frame) = 0;
+
   // Returns true if the audio source is mixed anonymously.
   virtual bool AnonymousMixabilityStatus(
       const MixerAudioSource& audio_source) const = 0;
@@ -67,6 +99,10 @@ class AudioMixer {
   // Return value between 0 and 0x7fff is returned by voe::AudioLevel.
   virtual int GetOutputAudioLevelFullRange() = 0;
 
+  // Returns the statistics of the parallel fetching of audio. All zero for a
+  // mixer without a fetch pool.
+  virtual FetchStats GetFetchStats() const = 0;
+
  protected:
   AudioMixer() {}
 
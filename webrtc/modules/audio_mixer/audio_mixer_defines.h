@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_AUDIO_MIXER_AUDIO_MIXER_DEFINES_H_
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/typedefs.h"
 
@@ -43,6 +44,26 @@ class MixerAudioSource {
   virtual AudioFrameWithMuted GetAudioFrameWithMuted(int32_t id,
                                                      int sample_rate_hz) = 0;
 
+  // Returns the level of the audio the source will deliver next, in -dBov as
+  // signaled by the RFC 6464 audio level header extension, i.e. 0 for the
+  // loudest audio and 127 for silence. When there are many sources, the mixer
+  // only asks the loudest of them for audio, and calls SkipAudioFrame() on
+  // the others. Sources that return no level are always asked.
+  virtual rtc::Optional<int> AudioLevelDbov() const;
+
+  // Called instead of GetAudioFrameWithMuted() in the mix iterations where the
+  // source is not asked for audio because of its audio level. Sources backed
+  // by a jitter buffer should advance it without decoding, e.g. through
+  // AudioCodingModule::PlayoutData10MsWithoutDecoding().
+  virtual void SkipAudioFrame(int32_t id, int sample_rate_hz);
+
+  // Returns true if the source would deliver nothing but comfort noise, e.g.
+  // while the sender is in DTX, see AudioCodingModule::PlayoutInDtx(). Silent
+  // sources are not asked for audio, regardless of how many sources there
+  // are, and SkipAudioFrame() is called instead. A silent source that was
+  // mixed in the last iteration is asked once more, to be ramped out.
+  virtual bool IsSilent() const;
+
   // Returns true if the participant was mixed this mix iteration.
   bool IsMixed() const;
 
@@ -14,7 +14,11 @@
 #include <functional>
 #include <utility>
 
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/thread_annotations.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/common_audio/include/audio_util.h"
 #include "webrtc/modules/audio_mixer/audio_frame_manipulator.h"
 #include "webrtc/modules/audio_mixer/audio_mixer_defines.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
@@ -25,6 +29,8 @@
 namespace webrtc {
 namespace {
 
+const char kFetchQueueName[] = "AudioMixerFetch";
+
 class SourceFrame {
  public:
   SourceFrame(MixerAudioSource* p, AudioFrame* a, bool m, bool was_mixed_before)
@@ -81,6 +87,63 @@ void RemixFrame(AudioFrame* frame, size_t number_of_channels) {
   }
 }
 
+// Merges the VAD activity and speech type of |frame| into |mixed_audio| the
+// way AudioFrame::operator+= does.
+void MergeFrameInfo(const AudioFrame& frame, AudioFrame* mixed_audio) {
+  if (mixed_audio->vad_activity_ == AudioFrame::kVadActive ||
+      frame.vad_activity_ == AudioFrame::kVadActive) {
+    mixed_audio->vad_activity_ = AudioFrame::kVadActive;
+  } else if (mixed_audio->vad_activity_ == AudioFrame::kVadUnknown ||
+             frame.vad_activity_ == AudioFrame::kVadUnknown) {
+    mixed_audio->vad_activity_ = AudioFrame::kVadUnknown;
+  }
+  if (mixed_audio->speech_type_ != frame.speech_type_)
+    mixed_audio->speech_type_ = AudioFrame::kUndefined;
+}
+
+// Returns the audio sources of |audio_source_list| to ask for audio. When
+// there are more than |max_sources| sources, the sources signaling an audio
+// level are only asked if they are among the |max_sources| loudest of them,
+// or if they were mixed in the last iteration so that they are ramped out.
+// This saves fetching and decoding the audio of the sources that would not be
+// mixed anyway. The other sources are written to |skipped|.
+MixerAudioSourceList SelectAudioSourcesByLevel(
+    const MixerAudioSourceList& audio_source_list,
+    size_t max_sources,
+    MixerAudioSourceList* skipped) {
+  if (audio_source_list.size() <= max_sources)
+    return audio_source_list;
+
+  MixerAudioSourceList selected;
+  std::vector<std::pair<int, MixerAudioSource*>> candidates;
+  for (auto* const audio_source : audio_source_list) {
+    const rtc::Optional<int> level = audio_source->AudioLevelDbov();
+    if (!level || audio_source->mix_history_->WasMixed()) {
+      selected.push_back(audio_source);
+    } else {
+      candidates.emplace_back(*level, audio_source);
+    }
+  }
+  if (candidates.size() > max_sources) {
+    // Lower levels in -dBov are louder.
+    std::nth_element(candidates.begin(), candidates.begin() + max_sources,
+                     candidates.end(),
+                     [](const std::pair<int, MixerAudioSource*>& a,
+                        const std::pair<int, MixerAudioSource*>& b) {
+                       return a.first < b.first;
+                     });
+    for (auto it = candidates.begin() + max_sources; it != candidates.end();
+         ++it) {
+      skipped->push_back(it->second);
+    }
+    candidates.resize(max_sources);
+  }
+  for (const auto& candidate : candidates) {
+    selected.push_back(candidate.second);
+  }
+  return selected;
+}
+
 void Ramp(const std::vector<SourceFrame>& mixed_sources_and_frames) {
   for (const auto& source_frame : mixed_sources_and_frames) {
     // Ramp in previously unmixed.
@@ -108,6 +171,16 @@ bool MixerAudioSource::IsMixed() const {
   return mix_history_->IsMixed();
 }
 
+rtc::Optional<int> MixerAudioSource::AudioLevelDbov() const {
+  return rtc::Optional<int>();
+}
+
+void MixerAudioSource::SkipAudioFrame(int32_t id, int sample_rate_hz) {}
+
+bool MixerAudioSource::IsSilent() const {
+  return false;
+}
+
 NewMixHistory::NewMixHistory() : is_mixed_(0) {}
 
 NewMixHistory::~NewMixHistory() {}
@@ -135,14 +208,26 @@ std::unique_ptr<AudioMixer> AudioMixer::Create(int id) {
   return AudioMixerImpl::Create(id);
 }
 
-AudioMixerImpl::AudioMixerImpl(int id, std::unique_ptr<AudioProcessing> limiter)
+std::unique_ptr<AudioMixer> AudioMixer::Create(int id,
+                                               rtc::TaskQueuePool* fetch_pool) {
+  return AudioMixerImpl::Create(id, fetch_pool);
+}
+
+AudioMixerImpl::AudioMixerImpl(int id,
+                               std::unique_ptr<AudioProcessing> limiter,
+                               rtc::TaskQueuePool* fetch_pool)
     : id_(id),
       audio_source_list_(),
       additional_audio_source_list_(),
       num_mixed_audio_sources_(0),
       use_limiter_(true),
       time_stamp_(0),
-      limiter_(std::move(limiter)) {
+      limiter_(std::move(limiter)),
+      mix_buffer_(AudioFrame::kMaxDataSizeSamples),
+      fetch_pool_(fetch_pool) {
+#if !defined(WEBRTC_BUILD_LIBEVENT)
+  RTC_DCHECK(!fetch_pool_);
+#endif
   SetOutputFrequency(kDefaultFrequency);
   thread_checker_.DetachFromThread();
 }
@@ -150,6 +235,21 @@ AudioMixerImpl::AudioMixerImpl(int id, std::unique_ptr<AudioProcessing> limiter)
 AudioMixerImpl::~AudioMixerImpl() {}
 
 std::unique_ptr<AudioMixer> AudioMixerImpl::Create(int id) {
+  return Create(id, nullptr);
+}
+
+std::unique_ptr<AudioMixer> AudioMixerImpl::Create(
+    int id,
+    rtc::TaskQueuePool* fetch_pool) {
+  std::unique_ptr<AudioProcessing> limiter = CreateLimiter();
+  if (!limiter)
+    return nullptr;
+
+  return std::unique_ptr<AudioMixer>(
+      new AudioMixerImpl(id, std::move(limiter), fetch_pool));
+}
+
+std::unique_ptr<AudioProcessing> AudioMixerImpl::CreateLimiter() {
   Config config;
   config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
   std::unique_ptr<AudioProcessing> limiter(AudioProcessing::Create(config));
@@ -175,8 +275,7 @@ std::unique_ptr<AudioMixer> AudioMixerImpl::Create(int id) {
   if (limiter->gain_control()->Enable(true) != limiter->kNoError)
     return nullptr;
 
-  return std::unique_ptr<AudioMixer>(
-      new AudioMixerImpl(id, std::move(limiter)));
+  return limiter;
 }
 
 void AudioMixerImpl::Mix(int sample_rate,
@@ -197,21 +296,34 @@ void AudioMixerImpl::Mix(int sample_rate,
     SetOutputFrequency(static_cast<Frequency>(sample_rate));
   }
 
-  AudioFrameList mix_list;
-  AudioFrameList anonymous_mix_list;
+  AudioSourceFrameList anonymous_mix_list;
   int num_mixed_audio_sources;
   {
     rtc::CritScope lock(&crit_);
-    mix_list = GetNonAnonymousAudio();
+    mixed_frames_ = GetNonAnonymousAudio();
     anonymous_mix_list = GetAnonymousAudio();
     num_mixed_audio_sources = static_cast<int>(num_mixed_audio_sources_);
   }
 
-  mix_list.insert(mix_list.begin(), anonymous_mix_list.begin(),
-                  anonymous_mix_list.end());
+  mixed_frames_.insert(mixed_frames_.begin(), anonymous_mix_list.begin(),
+                       anonymous_mix_list.end());
 
-  for (const auto& frame : mix_list) {
-    RemixFrame(frame, number_of_channels);
+  for (const auto& source_frame : mixed_frames_) {
+    RemixFrame(source_frame.second, number_of_channels);
+  }
+
+  // Drop the limiters of the mixes without sources that are no longer mixed.
+  for (auto it = source_limiters_.begin(); it != source_limiters_.end();) {
+    const MixerAudioSource* const audio_source = it->first;
+    if (std::none_of(mixed_frames_.begin(), mixed_frames_.end(),
+                     [audio_source](const std::pair<MixerAudioSource*,
+                                                    AudioFrame*>& mixed) {
+                       return mixed.first == audio_source;
+                     })) {
+      it = source_limiters_.erase(it);
+    } else {
+      ++it;
+    }
   }
 
   audio_frame_for_mixing->UpdateFrame(
@@ -222,24 +334,61 @@ void AudioMixerImpl::Mix(int sample_rate,
 
   use_limiter_ = num_mixed_audio_sources > 1;
 
+  SumMixedFrames(sample_size_ * number_of_channels);
+
   // We only use the limiter if we're actually mixing multiple streams.
-  MixFromList(audio_frame_for_mixing, mix_list, id_, use_limiter_);
+  MixFromList(audio_frame_for_mixing, nullptr, use_limiter_);
 
   if (audio_frame_for_mixing->samples_per_channel_ == 0) {
     // Nothing was mixed, set the audio samples to silence.
     audio_frame_for_mixing->samples_per_channel_ = sample_size_;
     audio_frame_for_mixing->Mute();
-  } else {
+  } else if (use_limiter_) {
     // Only call the limiter if we have something to mix.
-    LimitMixedAudio(audio_frame_for_mixing);
+    LimitMixedAudio(limiter_.get(), audio_frame_for_mixing);
   }
 
   // Pass the final result to the level indicator.
   audio_level_.ComputeLevel(*audio_frame_for_mixing);
 
+  last_mix_.CopyFrom(*audio_frame_for_mixing);
   return;
 }
 
+void AudioMixerImpl::GetMixWithoutSource(const MixerAudioSource& audio_source,
+                                         AudioFrame* audio_frame) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  audio_frame->CopyFrom(last_mix_);
+  const auto mixed = std::find_if(
+      mixed_frames_.begin(), mixed_frames_.end(),
+      [&audio_source](const std::pair<MixerAudioSource*, AudioFrame*>& mixed) {
+        return mixed.first == &audio_source;
+      });
+  if (mixed == mixed_frames_.end())
+    return;
+
+  // Remove the audio of the source from the sum of the last mix, rather than
+  // mixing the other frames again.
+  audio_frame->samples_per_channel_ = 0;
+  audio_frame->speech_type_ = AudioFrame::kNormalSpeech;
+  audio_frame->vad_activity_ = AudioFrame::kVadPassive;
+  const bool use_limiter = mixed_frames_.size() > 2;
+  MixFromList(audio_frame, mixed->second, use_limiter);
+
+  if (audio_frame->samples_per_channel_ == 0) {
+    audio_frame->samples_per_channel_ = sample_size_;
+    audio_frame->Mute();
+  } else if (use_limiter) {
+    // The limiter adapts its gain to the audio it processes, so each mix
+    // needs its own.
+    std::unique_ptr<AudioProcessing>& limiter = source_limiters_[&audio_source];
+    if (!limiter)
+      limiter = CreateLimiter();
+    if (limiter)
+      LimitMixedAudio(limiter.get(), audio_frame);
+  }
+}
+
 int32_t AudioMixerImpl::SetOutputFrequency(const Frequency& frequency) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
   output_frequency_ = frequency;
@@ -290,6 +439,10 @@ int32_t AudioMixerImpl::SetMixabilityStatus(MixerAudioSource* audio_source,
     }
     num_mixed_audio_sources_ =
         num_mixed_non_anonymous + additional_audio_source_list_.size();
+#if defined(WEBRTC_BUILD_LIBEVENT)
+    if (!mixable)
+      fetch_queues_.erase(audio_source);
+#endif
   }
   return 0;
 }
@@ -341,18 +494,97 @@ bool AudioMixerImpl::AnonymousMixabilityStatus(
   return IsAudioSourceInList(audio_source, additional_audio_source_list_);
 }
 
-AudioFrameList AudioMixerImpl::GetNonAnonymousAudio() const {
+AudioMixer::FetchStats AudioMixerImpl::GetFetchStats() const {
+  rtc::CritScope lock(&crit_);
+  return fetch_stats_;
+}
+
+std::vector<MixerAudioSource::AudioFrameWithMuted>
+AudioMixerImpl::GetAudioFrames(const MixerAudioSourceList& audio_sources) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  const int sample_rate_hz = static_cast<int>(OutputFrequency());
+  std::vector<MixerAudioSource::AudioFrameWithMuted> frames(
+      audio_sources.size());
+#if defined(WEBRTC_BUILD_LIBEVENT)
+  if (fetch_pool_ && audio_sources.size() > 1) {
+    std::vector<int64_t> fetch_times_us(audio_sources.size());
+    volatile int remaining = static_cast<int>(audio_sources.size());
+    rtc::Event done(false, false);
+    const int64_t start_us = rtc::TimeMicros();
+    for (size_t i = 0; i < audio_sources.size(); ++i) {
+      MixerAudioSource* const audio_source = audio_sources[i];
+      std::unique_ptr<rtc::TaskQueue>& queue = fetch_queues_[audio_source];
+      if (!queue)
+        queue.reset(new rtc::TaskQueue(kFetchQueueName, fetch_pool_));
+      // The locals outlive the tasks, since all of them are waited for.
+      queue->PostTask([this, audio_source, sample_rate_hz, start_us, i,
+                       &frames, &fetch_times_us, &remaining, &done]() {
+        frames[i] = audio_source->GetAudioFrameWithMuted(id_, sample_rate_hz);
+        fetch_times_us[i] = rtc::TimeMicros() - start_us;
+        if (rtc::AtomicOps::Decrement(&remaining) == 0)
+          done.Set();
+      });
+    }
+    done.Wait(rtc::Event::kForever);
+
+    const int64_t fetch_time_us = rtc::TimeMicros() - start_us;
+    fetch_stats_.fetched_frames += audio_sources.size();
+    fetch_stats_.late_frames += std::count_if(
+        fetch_times_us.begin(), fetch_times_us.end(), [](int64_t time_us) {
+          return time_us > kFrameDurationInMs * rtc::kNumMicrosecsPerMillisec;
+        });
+    fetch_stats_.max_fetch_time_us =
+        std::max(fetch_stats_.max_fetch_time_us, fetch_time_us);
+    return frames;
+  }
+#endif
+  for (size_t i = 0; i < audio_sources.size(); ++i) {
+    frames[i] = audio_sources[i]->GetAudioFrameWithMuted(id_, sample_rate_hz);
+  }
+  return frames;
+}
+
+AudioSourceFrameList AudioMixerImpl::GetNonAnonymousAudio() {
   RTC_DCHECK_RUN_ON(&thread_checker_);
   WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, id_,
                "GetNonAnonymousAudio()");
-  AudioFrameList result;
+  AudioSourceFrameList result;
   std::vector<SourceFrame> audio_source_mixing_data_list;
   std::vector<SourceFrame> ramp_list;
 
-  // Get audio source audio and put it in the struct vector.
+  // Silent sources are left out, except for the ones mixed in the last
+  // iteration, which are fetched after the others to be ramped out.
+  MixerAudioSourceList audible_audio_sources;
+  MixerAudioSourceList silent_mixed_audio_sources;
+  MixerAudioSourceList skipped_audio_sources;
   for (auto* const audio_source : audio_source_list_) {
-    auto audio_frame_with_info = audio_source->GetAudioFrameWithMuted(
-        id_, static_cast<int>(OutputFrequency()));
+    if (!audio_source->IsSilent()) {
+      audible_audio_sources.push_back(audio_source);
+    } else if (audio_source->mix_history_->WasMixed()) {
+      silent_mixed_audio_sources.push_back(audio_source);
+    } else {
+      skipped_audio_sources.push_back(audio_source);
+    }
+  }
+  MixerAudioSourceList audio_sources_to_fetch =
+      SelectAudioSourcesByLevel(audible_audio_sources,
+                                kMaximumAmountOfMixedAudioSources,
+                                &skipped_audio_sources);
+  const size_t num_audible_to_fetch = audio_sources_to_fetch.size();
+  audio_sources_to_fetch.insert(audio_sources_to_fetch.end(),
+                                silent_mixed_audio_sources.begin(),
+                                silent_mixed_audio_sources.end());
+  for (auto* const audio_source : skipped_audio_sources) {
+    audio_source->SkipAudioFrame(id_, static_cast<int>(OutputFrequency()));
+  }
+
+  const std::vector<MixerAudioSource::AudioFrameWithMuted> audio_frames =
+      GetAudioFrames(audio_sources_to_fetch);
+
+  // Get audio source audio and put it in the struct vector.
+  for (size_t i = 0; i < audio_sources_to_fetch.size(); ++i) {
+    MixerAudioSource* const audio_source = audio_sources_to_fetch[i];
+    const auto& audio_frame_with_info = audio_frames[i];
 
     const auto audio_frame_info = audio_frame_with_info.audio_frame_info;
     AudioFrame* audio_source_audio_frame = audio_frame_with_info.audio_frame;
@@ -362,6 +594,16 @@ AudioFrameList AudioMixerImpl::GetNonAnonymousAudio() const {
                    "failed to GetAudioFrameWithMuted() from participant");
       continue;
     }
+    if (i >= num_audible_to_fetch) {
+      // A silent source is mixed one last time, ramped out.
+      audio_source->mix_history_->SetIsMixed(false);
+      if (audio_frame_info != MixerAudioSource::AudioFrameInfo::kMuted) {
+        result.emplace_back(audio_source, audio_source_audio_frame);
+        ramp_list.emplace_back(audio_source, audio_source_audio_frame, false,
+                               true, -1);
+      }
+      continue;
+    }
     audio_source_mixing_data_list.emplace_back(
         audio_source, audio_source_audio_frame,
         audio_frame_info == MixerAudioSource::AudioFrameInfo::kMuted,
@@ -387,7 +629,7 @@ AudioFrameList AudioMixerImpl::GetNonAnonymousAudio() const {
     bool is_mixed = false;
     if (max_audio_frame_counter > 0) {
       --max_audio_frame_counter;
-      result.push_back(p.audio_frame_);
+      result.emplace_back(p.audio_source_, p.audio_frame_);
       ramp_list.emplace_back(p.audio_source_, p.audio_frame_, false,
                              p.was_mixed_before_, -1);
       is_mixed = true;
@@ -398,7 +640,7 @@ AudioFrameList AudioMixerImpl::GetNonAnonymousAudio() const {
   return result;
 }
 
-AudioFrameList AudioMixerImpl::GetAnonymousAudio() const {
+AudioSourceFrameList AudioMixerImpl::GetAnonymousAudio() const {
   RTC_DCHECK_RUN_ON(&thread_checker_);
   WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, id_,
                "GetAnonymousAudio()");
@@ -408,7 +650,7 @@ AudioFrameList AudioMixerImpl::GetAnonymousAudio() const {
   // that the list of participants can be traversed safely.
   std::vector<SourceFrame> ramp_list;
   MixerAudioSourceList additional_audio_sources_list;
-  AudioFrameList result;
+  AudioSourceFrameList result;
   additional_audio_sources_list.insert(additional_audio_sources_list.begin(),
                                        additional_audio_source_list_.begin(),
                                        additional_audio_source_list_.end());
@@ -424,7 +666,7 @@ AudioFrameList AudioMixerImpl::GetAnonymousAudio() const {
       continue;
     }
     if (ret != MixerAudioSource::AudioFrameInfo::kMuted) {
-      result.push_back(audio_frame);
+      result.emplace_back(audio_source, audio_frame);
       ramp_list.emplace_back(audio_source, audio_frame, false,
                              audio_source->mix_history_->IsMixed(), 0);
       audio_source->mix_history_->SetIsMixed(true);
@@ -471,53 +713,78 @@ bool AudioMixerImpl::RemoveAudioSourceFromList(
   }
 }
 
+void AudioMixerImpl::SumMixedFrames(size_t num_samples) {
+  RTC_DCHECK_LE(num_samples, mix_buffer_.size());
+  std::fill(mix_buffer_.begin(), mix_buffer_.begin() + num_samples, 0.f);
+  for (const auto& source_frame : mixed_frames_) {
+    const int16_t* const data = source_frame.second->data_;
+    // Summing in float needs no saturation of the partial sums, which lets
+    // the compiler vectorize the loop.
+    for (size_t i = 0; i < num_samples; ++i)
+      mix_buffer_[i] += data[i];
+  }
+}
+
 int32_t AudioMixerImpl::MixFromList(AudioFrame* mixed_audio,
-                                    const AudioFrameList& audio_frame_list,
-                                    int32_t id,
-                                    bool use_limiter) {
-  WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, id,
-               "MixFromList(mixed_audio, audio_frame_list)");
-  if (audio_frame_list.empty())
+                                    const AudioFrame* excluded_frame,
+                                    bool use_limiter) const {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  WEBRTC_TRACE(kTraceStream, kTraceAudioMixerServer, id_,
+               "MixFromList(mixed_audio, excluded_frame)");
+  const AudioFrame* last_frame = nullptr;
+  size_t num_frames = 0;
+  for (const auto& source_frame : mixed_frames_) {
+    const AudioFrame* const frame = source_frame.second;
+    if (frame == excluded_frame)
+      continue;
+    RTC_DCHECK_EQ(mixed_audio->sample_rate_hz_, frame->sample_rate_hz_);
+    RTC_DCHECK_EQ(
+        frame->samples_per_channel_,
+        static_cast<size_t>(
+            (mixed_audio->sample_rate_hz_ * kFrameDurationInMs) / 1000));
+    RTC_DCHECK_EQ(frame->num_channels_, mixed_audio->num_channels_);
+    MergeFrameInfo(*frame, mixed_audio);
+    last_frame = frame;
+    ++num_frames;
+  }
+  if (num_frames == 0)
     return 0;
 
-  if (audio_frame_list.size() == 1) {
-    mixed_audio->timestamp_ = audio_frame_list.front()->timestamp_;
-    mixed_audio->elapsed_time_ms_ = audio_frame_list.front()->elapsed_time_ms_;
+  if (num_frames == 1) {
+    mixed_audio->timestamp_ = last_frame->timestamp_;
+    mixed_audio->elapsed_time_ms_ = last_frame->elapsed_time_ms_;
   } else {
     // TODO(wu): Issue 3390.
     // Audio frame timestamp is only supported in one channel case.
     mixed_audio->timestamp_ = 0;
     mixed_audio->elapsed_time_ms_ = -1;
   }
-
-  for (const auto& frame : audio_frame_list) {
-    RTC_DCHECK_EQ(mixed_audio->sample_rate_hz_, frame->sample_rate_hz_);
-    RTC_DCHECK_EQ(
-        frame->samples_per_channel_,
-        static_cast<size_t>(
-            (mixed_audio->sample_rate_hz_ * kFrameDurationInMs) / 1000));
-
-    // Mix |f.frame| into |mixed_audio|, with saturation protection.
-    // These effect is applied to |f.frame| itself prior to mixing.
-    if (use_limiter) {
-      // Divide by two to avoid saturation in the mixing.
-      // This is only meaningful if the limiter will be used.
-      *frame >>= 1;
+  mixed_audio->samples_per_channel_ = last_frame->samples_per_channel_;
+
+  // Halve the mix to avoid saturation before the limiter, which restores the
+  // level. All the frames are scaled once, in a single pass over the sum.
+  const float gain = use_limiter ? 0.5f : 1.f;
+  const size_t num_samples =
+      mixed_audio->samples_per_channel_ * mixed_audio->num_channels_;
+  RTC_DCHECK_LE(num_samples, mix_buffer_.size());
+  if (excluded_frame) {
+    const int16_t* const excluded = excluded_frame->data_;
+    for (size_t i = 0; i < num_samples; ++i) {
+      mixed_audio->data_[i] =
+          FloatS16ToS16(gain * (mix_buffer_[i] - excluded[i]));
     }
-    RTC_DCHECK_EQ(frame->num_channels_, mixed_audio->num_channels_);
-    *mixed_audio += *frame;
+  } else {
+    for (size_t i = 0; i < num_samples; ++i)
+      mixed_audio->data_[i] = FloatS16ToS16(gain * mix_buffer_[i]);
   }
   return 0;
 }
 
-bool AudioMixerImpl::LimitMixedAudio(AudioFrame* mixed_audio) const {
+bool AudioMixerImpl::LimitMixedAudio(AudioProcessing* limiter,
+                                     AudioFrame* mixed_audio) const {
   RTC_DCHECK_RUN_ON(&thread_checker_);
-  if (!use_limiter_) {
-    return true;
-  }
-
   // Smoothly limit the mixed frame.
-  const int error = limiter_->ProcessStream(mixed_audio);
+  const int error = limiter->ProcessStream(mixed_audio);
 
   // And now we can safely restore the level. This procedure results in
   // some loss of resolution, deemed acceptable.
@@ -531,7 +798,7 @@ bool AudioMixerImpl::LimitMixedAudio(AudioFrame* mixed_audio) const {
   // negative value is undefined).
   *mixed_audio += *mixed_audio;
 
-  if (error != limiter_->kNoError) {
+  if (error != limiter->kNoError) {
     WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, id_,
                  "Error from AudioProcessing: %d", error);
     RTC_NOTREACHED();
@@ -13,8 +13,10 @@
 
 #include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "webrtc/base/task_queue.h"
 #include "webrtc/base/thread_checker.h"
 #include "webrtc/engine_configurations.h"
 #include "webrtc/modules/audio_mixer/audio_mixer.h"
@@ -25,7 +27,8 @@ namespace webrtc {
 class AudioProcessing;
 class CriticalSectionWrapper;
 
-typedef std::vector<AudioFrame*> AudioFrameList;
+typedef std::vector<std::pair<MixerAudioSource*, AudioFrame*>>
+    AudioSourceFrameList;
 typedef std::vector<MixerAudioSource*> MixerAudioSourceList;
 
 // Cheshire cat implementation of MixerAudioSource's non virtual functions.
@@ -56,6 +59,8 @@ class AudioMixerImpl : public AudioMixer {
   static const int kFrameDurationInMs = 10;
 
   static std::unique_ptr<AudioMixer> Create(int id);
+  static std::unique_ptr<AudioMixer> Create(int id,
+                                            rtc::TaskQueuePool* fetch_pool);
 
   ~AudioMixerImpl() override;
 
@@ -68,11 +73,19 @@ class AudioMixerImpl : public AudioMixer {
   void Mix(int sample_rate,
            size_t number_of_channels,
            AudioFrame* audio_frame_for_mixing) override;
+  void GetMixWithoutSource(const MixerAudioSource& audio_source,
+                           AudioFrame* audio_frame) override;
   bool AnonymousMixabilityStatus(
       const MixerAudioSource& audio_source) const override;
+  FetchStats GetFetchStats() const override;
 
  private:
-  AudioMixerImpl(int id, std::unique_ptr<AudioProcessing> limiter);
+  AudioMixerImpl(int id,
+                 std::unique_ptr<AudioProcessing> limiter,
+                 rtc::TaskQueuePool* fetch_pool);
+
+  // Returns an AudioProcessing limiting mixed audio, or null on failure.
+  static std::unique_ptr<AudioProcessing> CreateLimiter();
 
   // Set/get mix frequency
   int32_t SetOutputFrequency(const Frequency& frequency);
@@ -81,11 +94,18 @@ class AudioMixerImpl : public AudioMixer {
   // Compute what audio sources to mix from audio_source_list_. Ramp
   // in and out. Update mixed status. Mixes up to
   // kMaximumAmountOfMixedAudioSources audio sources.
-  AudioFrameList GetNonAnonymousAudio() const EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  AudioSourceFrameList GetNonAnonymousAudio() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Asks each of |audio_sources| for audio, in parallel on the fetch pool if
+  // there is one, and returns the frames in the order of |audio_sources|.
+  std::vector<MixerAudioSource::AudioFrameWithMuted> GetAudioFrames(
+      const MixerAudioSourceList& audio_sources)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Return the AudioFrames that should be mixed anonymously. Ramp in
   // and out. Update mixed status.
-  AudioFrameList GetAnonymousAudio() const EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  AudioSourceFrameList GetAnonymousAudio() const
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // This function returns true if it finds the MixerAudioSource in the
   // specified list of MixerAudioSources.
@@ -99,13 +119,18 @@ class AudioMixerImpl : public AudioMixer {
   bool RemoveAudioSourceFromList(MixerAudioSource* remove_audio_source,
                                  MixerAudioSourceList* audio_source_list) const;
 
-  // Mix the AudioFrames stored in audioFrameList into mixed_audio.
-  static int32_t MixFromList(AudioFrame* mixed_audio,
-                             const AudioFrameList& audio_frame_list,
-                             int32_t id,
-                             bool use_limiter);
+  // Sums the first |num_samples| samples of the frames in |mixed_frames_|
+  // into |mix_buffer_|.
+  void SumMixedFrames(size_t num_samples);
 
-  bool LimitMixedAudio(AudioFrame* mixed_audio) const;
+  // Mix the AudioFrames stored in |mixed_frames_|, except for
+  // |excluded_frame| if not null, into mixed_audio. Takes the samples from
+  // |mix_buffer_|, which must hold the sum of all the frames.
+  int32_t MixFromList(AudioFrame* mixed_audio,
+                      const AudioFrame* excluded_frame,
+                      bool use_limiter) const;
+
+  bool LimitMixedAudio(AudioProcessing* limiter, AudioFrame* mixed_audio) const;
 
   // Output level functions for VoEVolumeControl.
   int GetOutputAudioLevel() override;
@@ -142,6 +167,26 @@ class AudioMixerImpl : public AudioMixer {
   // Measures audio level for the combined signal.
   voe::AudioLevel audio_level_ ACCESS_ON(&thread_checker_);
 
+  // The sources and frames mixed in the last Mix() call, the sum of their
+  // samples and the mixed result, kept for GetMixWithoutSource().
+  AudioSourceFrameList mixed_frames_ ACCESS_ON(&thread_checker_);
+  std::vector<float> mix_buffer_ ACCESS_ON(&thread_checker_);
+  AudioFrame last_mix_ ACCESS_ON(&thread_checker_);
+
+  // Limiters of the mixes without the sources that are currently mixed. A
+  // mix without a source that is not mixed is the mix itself.
+  std::map<const MixerAudioSource*, std::unique_ptr<AudioProcessing>>
+      source_limiters_ ACCESS_ON(&thread_checker_);
+
+  rtc::TaskQueuePool* const fetch_pool_;
+#if defined(WEBRTC_BUILD_LIBEVENT)
+  // The queues of |fetch_pool_| that the sources are asked for audio on, one
+  // per source so that its calls never overlap.
+  std::map<const MixerAudioSource*, std::unique_ptr<rtc::TaskQueue>>
+      fetch_queues_ GUARDED_BY(crit_);
+#endif
+  FetchStats fetch_stats_ GUARDED_BY(crit_);
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixerImpl);
 };
 }  // namespace webrtc
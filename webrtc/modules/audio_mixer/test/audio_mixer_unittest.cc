@@ -15,9 +15,12 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "webrtc/base/bind.h"
+#include "webrtc/base/task_queue.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/audio_mixer/audio_mixer_defines.h"
 #include "webrtc/modules/audio_mixer/audio_mixer.h"
+#include "webrtc/system_wrappers/include/sleep.h"
 
 using testing::_;
 using testing::Exactly;
@@ -59,18 +62,32 @@ class MockMixerAudioSource : public MixerAudioSource {
 
   MOCK_METHOD2(GetAudioFrameWithMuted,
                AudioFrameWithMuted(const int32_t id, int sample_rate_hz));
+  MOCK_METHOD2(SkipAudioFrame, void(int32_t id, int sample_rate_hz));
+
+  rtc::Optional<int> AudioLevelDbov() const override { return audio_level_; }
+  bool IsSilent() const override { return silent_; }
 
   AudioFrame* fake_frame() { return &fake_frame_; }
   AudioFrameInfo fake_info() { return fake_audio_frame_info_; }
   void set_fake_info(const AudioFrameInfo audio_frame_info) {
     fake_audio_frame_info_ = audio_frame_info;
   }
+  void set_audio_level(int level_dbov) {
+    audio_level_ = rtc::Optional<int>(level_dbov);
+  }
+  void set_fetch_delay_ms(int delay_ms) { fetch_delay_ms_ = delay_ms; }
+  void set_silent(bool silent) { silent_ = silent; }
 
  private:
   AudioFrame fake_frame_, fake_output_frame_;
   AudioFrameInfo fake_audio_frame_info_;
+  rtc::Optional<int> audio_level_;
+  int fetch_delay_ms_ = 0;
+  bool silent_ = false;
   AudioFrameWithMuted FakeAudioFrameWithMuted(const int32_t id,
                                               int sample_rate_hz) {
+    if (fetch_delay_ms_ > 0)
+      SleepMs(fetch_delay_ms_);
     fake_output_frame_.CopyFrom(fake_frame_);
     return {
         &fake_output_frame_,  // audio_frame_pointer
@@ -408,7 +425,7 @@ TEST(AudioMixer, ConstructFromOtherThread) {
   init_thread->Start();
   std::unique_ptr<AudioMixer> mixer(
       init_thread->Invoke<std::unique_ptr<AudioMixer>>(
-          RTC_FROM_HERE, std::bind(&AudioMixer::Create, kId)));
+          RTC_FROM_HERE, []() { return AudioMixer::Create(kId); }));
   MockMixerAudioSource participant;
 
   ResetFrame(participant.fake_frame());
@@ -505,4 +522,227 @@ TEST(AudioMixer, UnmutedShouldMixBeforeLoud) {
 
   MixAndCompare(frames, frame_info, expected_status);
 }
+
+TEST(AudioMixer, OnlyLoudestSourcesByAudioLevelAreFetched) {
+  constexpr int kAudioSources =
+      AudioMixer::kMaximumAmountOfMixedAudioSources + 3;
+
+  const std::unique_ptr<AudioMixer> mixer(AudioMixer::Create(kId));
+  MockMixerAudioSource participants[kAudioSources];
+  // A source without an audio level is always fetched.
+  MockMixerAudioSource participant_without_level;
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->data_[80] = 100;
+    // The audio level decreases with |i|.
+    participants[i].set_audio_level(kAudioSources - i);
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[i], true));
+  }
+  ResetFrame(participant_without_level.fake_frame());
+  EXPECT_EQ(0, mixer->SetMixabilityStatus(&participant_without_level, true));
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    const bool loudest =
+        i >= kAudioSources - AudioMixer::kMaximumAmountOfMixedAudioSources;
+    EXPECT_CALL(participants[i], GetAudioFrameWithMuted(_, _))
+        .Times(Exactly(loudest ? 1 : 0));
+    EXPECT_CALL(participants[i], SkipAudioFrame(_, kDefaultSampleRateHz))
+        .Times(Exactly(loudest ? 0 : 1));
+  }
+  EXPECT_CALL(participant_without_level, GetAudioFrameWithMuted(_, _))
+      .Times(Exactly(1));
+  EXPECT_CALL(participant_without_level, SkipAudioFrame(_, _)).Times(0);
+
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    const bool loudest =
+        i >= kAudioSources - AudioMixer::kMaximumAmountOfMixedAudioSources;
+    EXPECT_EQ(loudest, participants[i].IsMixed())
+        << "Mixed status of AudioSource #" << i << " wrong.";
+  }
+}
+
+TEST(AudioMixer, MixedSourcesAreFetchedToRampOut) {
+  constexpr int kAudioSources =
+      AudioMixer::kMaximumAmountOfMixedAudioSources + 1;
+
+  const std::unique_ptr<AudioMixer> mixer(AudioMixer::Create(kId));
+  MockMixerAudioSource participants[kAudioSources];
+
+  MockMixerAudioSource& quiet = participants[kAudioSources - 1];
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].set_audio_level(0);
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[i], true));
+    // The quiet source is only fetched in the second iteration.
+    EXPECT_CALL(participants[i], GetAudioFrameWithMuted(_, _))
+        .Times(Exactly(&participants[i] == &quiet ? 1 : 2));
+  }
+  quiet.set_audio_level(20);
+  EXPECT_CALL(quiet, SkipAudioFrame(_, _)).Times(Exactly(1));
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+  EXPECT_FALSE(quiet.IsMixed());
+
+  // The quiet source gets louder than the mixed ones, which are still fetched
+  // to be ramped out.
+  quiet.set_audio_level(0);
+  for (auto& participant : participants) {
+    if (&participant != &quiet)
+      participant.set_audio_level(20);
+  }
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+}
+
+TEST(AudioMixer, SilentSourcesAreRampedOutAndSkipped) {
+  const std::unique_ptr<AudioMixer> mixer(AudioMixer::Create(kId));
+  MockMixerAudioSource participants[2];
+  MockMixerAudioSource& silent = participants[1];
+
+  for (auto& participant : participants) {
+    ResetFrame(participant.fake_frame());
+    participant.fake_frame()->data_[80] = 100;
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participant, true));
+  }
+  EXPECT_CALL(participants[0], GetAudioFrameWithMuted(_, _)).Times(Exactly(3));
+  EXPECT_CALL(participants[0], SkipAudioFrame(_, _)).Times(0);
+  // The silent source is fetched while it's audible, and once more to be
+  // ramped out.
+  EXPECT_CALL(silent, GetAudioFrameWithMuted(_, _)).Times(Exactly(2));
+  EXPECT_CALL(silent, SkipAudioFrame(_, kDefaultSampleRateHz))
+      .Times(Exactly(1));
+
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+  EXPECT_TRUE(silent.IsMixed());
+
+  silent.set_silent(true);
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+  EXPECT_FALSE(silent.IsMixed());
+  EXPECT_TRUE(participants[0].IsMixed());
+
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+  EXPECT_FALSE(silent.IsMixed());
+}
+
+TEST(AudioMixer, MixWithoutSourceExcludesItsAudio) {
+  const std::unique_ptr<AudioMixer> mixer(AudioMixer::Create(kId));
+  MockMixerAudioSource participants[2];
+
+  for (int i = 0; i < 2; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    std::fill(participants[i].fake_frame()->data_,
+              participants[i].fake_frame()->data_ + kDefaultSampleRateHz / 100,
+              100 * (i + 1));
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participants[i], true));
+    EXPECT_CALL(participants[i], GetAudioFrameWithMuted(_, _))
+        .Times(Exactly(2));
+  }
+
+  // Two mix iterations to compare after the ramp-up step.
+  for (int i = 0; i < 2; ++i) {
+    mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+  }
+
+  AudioFrame mix_without_source;
+  for (int i = 0; i < 2; ++i) {
+    mixer->GetMixWithoutSource(participants[i], &mix_without_source);
+    const AudioFrame& other = *participants[1 - i].fake_frame();
+    EXPECT_EQ(other.samples_per_channel_,
+              mix_without_source.samples_per_channel_);
+    EXPECT_EQ(0, memcmp(other.data_, mix_without_source.data_,
+                        other.samples_per_channel_ * sizeof(other.data_[0])));
+  }
+}
+
+TEST(AudioMixer, MixWithoutUnmixedSourceIsTheMix) {
+  const std::unique_ptr<AudioMixer> mixer(AudioMixer::Create(kId));
+  MockMixerAudioSource participant;
+  MockMixerAudioSource muted_participant;
+
+  ResetFrame(participant.fake_frame());
+  for (size_t i = 0; i < participant.fake_frame()->samples_per_channel_; ++i)
+    participant.fake_frame()->data_[i] = i;
+  ResetFrame(muted_participant.fake_frame());
+  muted_participant.set_fake_info(MixerAudioSource::AudioFrameInfo::kMuted);
+  EXPECT_EQ(0, mixer->SetMixabilityStatus(&participant, true));
+  EXPECT_EQ(0, mixer->SetMixabilityStatus(&muted_participant, true));
+  EXPECT_CALL(participant, GetAudioFrameWithMuted(_, _)).Times(Exactly(1));
+  EXPECT_CALL(muted_participant, GetAudioFrameWithMuted(_, _))
+      .Times(Exactly(1));
+
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+  EXPECT_FALSE(muted_participant.IsMixed());
+
+  AudioFrame mix_without_source;
+  mixer->GetMixWithoutSource(muted_participant, &mix_without_source);
+  EXPECT_EQ(frame_for_mixing.samples_per_channel_,
+            mix_without_source.samples_per_channel_);
+  EXPECT_EQ(0, memcmp(frame_for_mixing.data_, mix_without_source.data_,
+                      frame_for_mixing.samples_per_channel_ *
+                          sizeof(frame_for_mixing.data_[0])));
+}
+
+#if defined(WEBRTC_BUILD_LIBEVENT)
+TEST(AudioMixer, ParallelFetchGivesTheSerialMix) {
+  constexpr int kAudioSources = 5;
+  rtc::TaskQueuePool fetch_pool(2);
+  const std::unique_ptr<AudioMixer> serial_mixer(AudioMixer::Create(kId));
+  const std::unique_ptr<AudioMixer> parallel_mixer(
+      AudioMixer::Create(kId, &fetch_pool));
+  MockMixerAudioSource participants[kAudioSources];
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->data_[80] = 100 * (i + 1);
+    EXPECT_CALL(participants[i], GetAudioFrameWithMuted(_, _))
+        .Times(Exactly(2));
+  }
+
+  // The mixed status of the sources is shared, so the mixers take turns.
+  AudioFrame serial_mix;
+  for (auto& participant : participants)
+    EXPECT_EQ(0, serial_mixer->SetMixabilityStatus(&participant, true));
+  serial_mixer->Mix(kDefaultSampleRateHz, 1, &serial_mix);
+  for (auto& participant : participants)
+    EXPECT_EQ(0, serial_mixer->SetMixabilityStatus(&participant, false));
+
+  AudioFrame parallel_mix;
+  for (auto& participant : participants)
+    EXPECT_EQ(0, parallel_mixer->SetMixabilityStatus(&participant, true));
+  parallel_mixer->Mix(kDefaultSampleRateHz, 1, &parallel_mix);
+
+  EXPECT_EQ(serial_mix.samples_per_channel_,
+            parallel_mix.samples_per_channel_);
+  EXPECT_EQ(0, memcmp(serial_mix.data_, parallel_mix.data_,
+                      serial_mix.samples_per_channel_ *
+                          sizeof(serial_mix.data_[0])));
+  EXPECT_EQ(0u, serial_mixer->GetFetchStats().fetched_frames);
+  EXPECT_EQ(static_cast<uint64_t>(kAudioSources),
+            parallel_mixer->GetFetchStats().fetched_frames);
+}
+
+TEST(AudioMixer, ParallelFetchCountsLateFrames) {
+  rtc::TaskQueuePool fetch_pool(2);
+  const std::unique_ptr<AudioMixer> mixer(AudioMixer::Create(kId, &fetch_pool));
+  MockMixerAudioSource participants[2];
+
+  for (auto& participant : participants) {
+    ResetFrame(participant.fake_frame());
+    EXPECT_EQ(0, mixer->SetMixabilityStatus(&participant, true));
+    EXPECT_CALL(participant, GetAudioFrameWithMuted(_, _)).Times(Exactly(2));
+  }
+
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+  participants[1].set_fetch_delay_ms(20);
+  mixer->Mix(kDefaultSampleRateHz, 1, &frame_for_mixing);
+
+  const AudioMixer::FetchStats stats = mixer->GetFetchStats();
+  EXPECT_EQ(4u, stats.fetched_frames);
+  // The first frames may be late too on a loaded machine.
+  EXPECT_GE(stats.late_frames, 1u);
+  EXPECT_GE(stats.max_fetch_time_us, 20 * rtc::kNumMicrosecsPerMillisec);
+}
+#endif  // defined(WEBRTC_BUILD_LIBEVENT)
 }  // namespace webrtc
@@ -18,6 +18,9 @@
 #ifdef WEBRTC_AGC_DEBUG_DUMP
 #include <stdio.h>
 #endif
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "webrtc/base/checks.h"
 #include "webrtc/modules/audio_processing/agc/legacy/gain_control.h"
@@ -275,6 +278,34 @@ int32_t WebRtcAgc_AddFarendToDigital(DigitalAgc* stt,
   return 0;
 }
 
+// Scales |length| samples by a gain that starts at |gain32| (Q20) and grows by
+// |delta| per sample, storing the 16 most significant bits of each product.
+static void ApplyGainRamp(int16_t* samples,
+                          size_t length,
+                          int32_t gain32,
+                          int32_t delta) {
+  size_t n = 0;
+#if defined(WEBRTC_HAS_NEON)
+  // Four samples at a time, with the gain of each lane |delta| apart. The
+  // products fit in 32 bits, so this is bit-exact with the loop below.
+  const int32_t start[4] = {gain32, gain32 + delta, gain32 + 2 * delta,
+                            gain32 + 3 * delta};
+  int32x4_t gain = vld1q_s32(start);
+  const int32x4_t step = vdupq_n_s32(4 * delta);
+  for (; n + 4 <= length; n += 4) {
+    int32x4_t tmp = vmulq_s32(vmovl_s16(vld1_s16(&samples[n])),
+                              vshrq_n_s32(gain, 4));
+    vst1_s16(&samples[n], vshrn_n_s32(tmp, 16));
+    gain = vaddq_s32(gain, step);
+  }
+  gain32 += (int32_t)n * delta;
+#endif
+  for (; n < length; n++) {
+    samples[n] = (int16_t)((samples[n] * (gain32 >> 4)) >> 16);
+    gain32 += delta;
+  }
+}
+
 int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
                                  const int16_t* const* in_near,
                                  size_t num_bands,
@@ -521,13 +552,10 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
   for (k = 1; k < 10; k++) {
     delta = (gains[k + 1] - gains[k]) * (1 << (4 - L2));
     gain32 = gains[k] * (1 << 4);
-    // iterate over samples
-    for (n = 0; n < L; n++) {
-      for (i = 0; i < num_bands; ++i) {
-        tmp32 = out[i][k * L + n] * (gain32 >> 4);
-        out[i][k * L + n] = (int16_t)(tmp32 >> 16);
-      }
-      gain32 += delta;
+    // The bands share the gain, so each one can be scaled as a contiguous
+    // run of samples.
+    for (i = 0; i < num_bands; ++i) {
+      ApplyGainRamp(&out[i][k * L], L, gain32, delta);
     }
   }
 
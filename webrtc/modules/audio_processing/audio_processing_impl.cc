@@ -285,7 +285,7 @@ AudioProcessingImpl::AudioProcessingImpl(const webrtc::Config& config,
     public_submodules_->echo_control_mobile.reset(
         new EchoControlMobileImpl(&crit_render_, &crit_capture_));
     public_submodules_->gain_control.reset(
-        new GainControlImpl(&crit_capture_, &crit_capture_));
+        new GainControlImpl(&crit_render_, &crit_capture_));
     public_submodules_->high_pass_filter.reset(
         new HighPassFilterImpl(&crit_capture_));
     public_submodules_->level_estimator.reset(
@@ -297,8 +297,6 @@ AudioProcessingImpl::AudioProcessingImpl(const webrtc::Config& config,
     public_submodules_->gain_control_for_experimental_agc.reset(
         new GainControlForExperimentalAgc(
             public_submodules_->gain_control.get(), &crit_capture_));
-
-    private_submodules_->level_controller.reset(new LevelController());
   }
 
   SetExtraOptions(config);
@@ -312,7 +310,7 @@ AudioProcessingImpl::~AudioProcessingImpl() {
   public_submodules_->gain_control_for_experimental_agc.reset();
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  debug_dump_.debug_file->CloseFile();
+  debug_dump_.writer.reset();
 #endif
 }
 
@@ -368,8 +366,7 @@ AudioProcessingImpl::ApmDebugDumpThreadState::ApmDebugDumpThreadState()
 
 AudioProcessingImpl::ApmDebugDumpThreadState::~ApmDebugDumpThreadState() {}
 
-AudioProcessingImpl::ApmDebugDumpState::ApmDebugDumpState()
-    : debug_file(FileWrapper::Create()) {}
+AudioProcessingImpl::ApmDebugDumpState::ApmDebugDumpState() {}
 
 AudioProcessingImpl::ApmDebugDumpState::~ApmDebugDumpState() {}
 
@@ -459,7 +456,7 @@ int AudioProcessingImpl::InitializeLocked() {
   InitializeLevelController();
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     int err = WriteInitMessage();
     if (err != kNoError) {
       return err;
@@ -561,11 +558,11 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
 
   if (config.level_controller.enabled !=
       capture_nonlocked_.level_controller_enabled) {
+    capture_nonlocked_.level_controller_enabled =
+        config.level_controller.enabled;
     InitializeLevelController();
     LOG(LS_INFO) << "Level controller activated: "
                  << capture_nonlocked_.level_controller_enabled;
-    capture_nonlocked_.level_controller_enabled =
-        config.level_controller.enabled;
   }
 }
 
@@ -684,6 +681,7 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessStream_StreamConfig");
   ProcessingConfig processing_config;
   bool reinitialization_required = false;
+  bool format_changed = false;
   {
     // Acquire the capture lock in order to safely call the function
     // that retrieves the render side data. This function accesses apm
@@ -698,14 +696,16 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
     }
 
     processing_config = formats_.api_format;
+    processing_config.input_stream() = input_config;
+    processing_config.output_stream() = output_config;
     reinitialization_required = UpdateActiveSubmoduleStates();
+    format_changed = processing_config != formats_.api_format;
   }
 
-  processing_config.input_stream() = input_config;
-  processing_config.output_stream() = output_config;
-
-  {
-    // Do conditional reinitialization.
+  if (reinitialization_required || format_changed) {
+    // Do conditional reinitialization. The render lock is only needed for
+    // this, so the capture thread does not contend with the render thread
+    // in steady state.
     rtc::CritScope cs_render(&crit_render_);
     RETURN_ON_ERR(
         MaybeInitializeCapture(processing_config, reinitialization_required));
@@ -715,7 +715,7 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
                 formats_.api_format.input_stream().num_frames());
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     RETURN_ON_ERR(WriteConfigMessage(false));
 
     debug_dump_.capture.event_msg->set_type(audioproc::Event::STREAM);
@@ -733,16 +733,15 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
   capture_.capture_audio->CopyTo(formats_.api_format.output_stream(), dest);
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     audioproc::Stream* msg = debug_dump_.capture.event_msg->mutable_stream();
     const size_t channel_size =
         sizeof(float) * formats_.api_format.output_stream().num_frames();
     for (size_t i = 0; i < formats_.api_format.output_stream().num_channels();
          ++i)
       msg->add_output_channel(dest[i], channel_size);
-    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.debug_file.get(),
-                                          &debug_dump_.num_bytes_left_for_log_,
-                                          &crit_debug_, &debug_dump_.capture));
+    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.writer.get(),
+                                          &debug_dump_.capture));
   }
 #endif
 
@@ -777,6 +776,7 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
 
   ProcessingConfig processing_config;
   bool reinitialization_required = false;
+  bool format_changed = false;
   {
     // Aquire lock for the access of api_format.
     // The lock is released immediately due to the conditional
@@ -785,16 +785,19 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
     // TODO(ajm): The input and output rates and channels are currently
     // constrained to be identical in the int16 interface.
     processing_config = formats_.api_format;
+    processing_config.input_stream().set_sample_rate_hz(
+        frame->sample_rate_hz_);
+    processing_config.input_stream().set_num_channels(frame->num_channels_);
+    processing_config.output_stream().set_sample_rate_hz(
+        frame->sample_rate_hz_);
+    processing_config.output_stream().set_num_channels(frame->num_channels_);
 
     reinitialization_required = UpdateActiveSubmoduleStates();
+    format_changed = processing_config != formats_.api_format;
   }
-  processing_config.input_stream().set_sample_rate_hz(frame->sample_rate_hz_);
-  processing_config.input_stream().set_num_channels(frame->num_channels_);
-  processing_config.output_stream().set_sample_rate_hz(frame->sample_rate_hz_);
-  processing_config.output_stream().set_num_channels(frame->num_channels_);
 
-  {
-    // Do conditional reinitialization.
+  if (reinitialization_required || format_changed) {
+    // Do conditional reinitialization. See the float ProcessStream().
     rtc::CritScope cs_render(&crit_render_);
     RETURN_ON_ERR(
         MaybeInitializeCapture(processing_config, reinitialization_required));
@@ -806,7 +809,7 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
   }
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     RETURN_ON_ERR(WriteConfigMessage(false));
 
     debug_dump_.capture.event_msg->set_type(audioproc::Event::STREAM);
@@ -823,14 +826,13 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
       frame, submodule_states_.CaptureMultiBandProcessingActive());
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     audioproc::Stream* msg = debug_dump_.capture.event_msg->mutable_stream();
     const size_t data_size =
         sizeof(int16_t) * frame->samples_per_channel_ * frame->num_channels_;
     msg->set_output_data(frame->data_, data_size);
-    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.debug_file.get(),
-                                          &debug_dump_.num_bytes_left_for_log_,
-                                          &crit_debug_, &debug_dump_.capture));
+    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.writer.get(),
+                                          &debug_dump_.capture));
   }
 #endif
 
@@ -845,7 +847,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
                public_submodules_->echo_control_mobile->is_enabled()));
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     audioproc::Stream* msg = debug_dump_.capture.event_msg->mutable_stream();
     msg->set_delay(capture_nonlocked_.stream_delay_ms);
     msg->set_drift(
@@ -1033,7 +1035,7 @@ int AudioProcessingImpl::AnalyzeReverseStreamLocked(
          formats_.api_format.reverse_input_stream().num_frames());
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     debug_dump_.render.event_msg->set_type(audioproc::Event::REVERSE_STREAM);
     audioproc::ReverseStream* msg =
         debug_dump_.render.event_msg->mutable_reverse_stream();
@@ -1042,9 +1044,8 @@ int AudioProcessingImpl::AnalyzeReverseStreamLocked(
     for (size_t i = 0;
          i < formats_.api_format.reverse_input_stream().num_channels(); ++i)
       msg->add_channel(src[i], channel_size);
-    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.debug_file.get(),
-                                          &debug_dump_.num_bytes_left_for_log_,
-                                          &crit_debug_, &debug_dump_.render));
+    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.writer.get(),
+                                          &debug_dump_.render));
   }
 #endif
 
@@ -1088,16 +1089,15 @@ int AudioProcessingImpl::ProcessReverseStream(AudioFrame* frame) {
   }
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  if (debug_dump_.debug_file->is_open()) {
+  if (debug_dump_.is_open()) {
     debug_dump_.render.event_msg->set_type(audioproc::Event::REVERSE_STREAM);
     audioproc::ReverseStream* msg =
         debug_dump_.render.event_msg->mutable_reverse_stream();
     const size_t data_size =
         sizeof(int16_t) * frame->samples_per_channel_ * frame->num_channels_;
     msg->set_data(frame->data_, data_size);
-    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.debug_file.get(),
-                                          &debug_dump_.num_bytes_left_for_log_,
-                                          &crit_debug_, &debug_dump_.render));
+    RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.writer.get(),
+                                          &debug_dump_.render));
   }
 #endif
   render_.render_audio->DeinterleaveFrom(frame);
@@ -1199,13 +1199,15 @@ int AudioProcessingImpl::StartDebugRecording(
   }
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  debug_dump_.num_bytes_left_for_log_ = max_log_size_bytes;
   // Stop any ongoing recording.
-  debug_dump_.debug_file->CloseFile();
+  debug_dump_.writer.reset();
 
-  if (!debug_dump_.debug_file->OpenFile(filename, false)) {
+  std::unique_ptr<FileWrapper> debug_file(FileWrapper::Create());
+  if (!debug_file->OpenFile(filename, false)) {
     return kFileError;
   }
+  debug_dump_.writer.reset(
+      new DebugDumpWriter(std::move(debug_file), max_log_size_bytes));
 
   RETURN_ON_ERR(WriteConfigMessage(true));
   RETURN_ON_ERR(WriteInitMessage());
@@ -1226,14 +1228,15 @@ int AudioProcessingImpl::StartDebugRecording(FILE* handle,
   }
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  debug_dump_.num_bytes_left_for_log_ = max_log_size_bytes;
-
   // Stop any ongoing recording.
-  debug_dump_.debug_file->CloseFile();
+  debug_dump_.writer.reset();
 
-  if (!debug_dump_.debug_file->OpenFromFileHandle(handle)) {
+  std::unique_ptr<FileWrapper> debug_file(FileWrapper::Create());
+  if (!debug_file->OpenFromFileHandle(handle)) {
     return kFileError;
   }
+  debug_dump_.writer.reset(
+      new DebugDumpWriter(std::move(debug_file), max_log_size_bytes));
 
   RETURN_ON_ERR(WriteConfigMessage(true));
   RETURN_ON_ERR(WriteInitMessage());
@@ -1258,8 +1261,9 @@ int AudioProcessingImpl::StopDebugRecording() {
   rtc::CritScope cs_capture(&crit_capture_);
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
-  // We just return if recording hasn't started.
-  debug_dump_.debug_file->CloseFile();
+  // We just return if recording hasn't started. Destroying the writer writes
+  // the queued messages and closes the file.
+  debug_dump_.writer.reset();
   return kNoError;
 #else
   return kUnsupportedFunctionError;
@@ -1348,6 +1352,14 @@ void AudioProcessingImpl::InitializeIntelligibility() {
 }
 
 void AudioProcessingImpl::InitializeLevelController() {
+  // The level controller is only allocated while it is enabled, like the
+  // state of the public submodules.
+  if (!capture_nonlocked_.level_controller_enabled) {
+    private_submodules_->level_controller.reset();
+    return;
+  }
+  if (!private_submodules_->level_controller)
+    private_submodules_->level_controller.reset(new LevelController());
   private_submodules_->level_controller->Initialize(proc_sample_rate_hz());
 }
 
@@ -1426,9 +1438,7 @@ void AudioProcessingImpl::UpdateHistogramsOnCallEnd() {
 
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
 int AudioProcessingImpl::WriteMessageToDebugFile(
-    FileWrapper* debug_file,
-    int64_t* filesize_limit_bytes,
-    rtc::CriticalSection* crit_debug,
+    DebugDumpWriter* writer,
     ApmDebugDumpThreadState* debug_state) {
   int32_t size = debug_state->event_msg->ByteSize();
   if (size <= 0) {
@@ -1443,30 +1453,10 @@ int AudioProcessingImpl::WriteMessageToDebugFile(
     return kUnspecifiedError;
   }
 
-  {
-    // Ensure atomic writes of the message.
-    rtc::CritScope cs_debug(crit_debug);
-
-    RTC_DCHECK(debug_file->is_open());
-    // Update the byte counter.
-    if (*filesize_limit_bytes >= 0) {
-      *filesize_limit_bytes -=
-          (sizeof(int32_t) + debug_state->event_str.length());
-      if (*filesize_limit_bytes < 0) {
-        // Not enough bytes are left to write this message, so stop logging.
-        debug_file->CloseFile();
-        return kNoError;
-      }
-    }
-    // Write message preceded by its size.
-    if (!debug_file->Write(&size, sizeof(int32_t))) {
-      return kFileError;
-    }
-    if (!debug_file->Write(debug_state->event_str.data(),
-                           debug_state->event_str.length())) {
-      return kFileError;
-    }
-  }
+  // The message is written on the writer thread. It is dropped (and counted)
+  // if the writer cannot keep up, rather than blocking the audio thread.
+  RTC_DCHECK(writer);
+  writer->QueueMessage(&debug_state->event_str);
 
   debug_state->event_msg->Clear();
 
@@ -1493,9 +1483,8 @@ int AudioProcessingImpl::WriteInitMessage() {
   msg->set_num_reverse_output_channels(
       formats_.api_format.reverse_output_stream().num_channels());
 
-  RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.debug_file.get(),
-                                        &debug_dump_.num_bytes_left_for_log_,
-                                        &crit_debug_, &debug_dump_.capture));
+  RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.writer.get(),
+                                        &debug_dump_.capture));
   return kNoError;
 }
 
@@ -1557,9 +1546,8 @@ int AudioProcessingImpl::WriteConfigMessage(bool forced) {
   debug_dump_.capture.event_msg->set_type(audioproc::Event::CONFIG);
   debug_dump_.capture.event_msg->mutable_config()->CopyFrom(config);
 
-  RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.debug_file.get(),
-                                        &debug_dump_.num_bytes_left_for_log_,
-                                        &crit_debug_, &debug_dump_.capture));
+  RETURN_ON_ERR(WriteMessageToDebugFile(debug_dump_.writer.get(),
+                                        &debug_dump_.capture));
   return kNoError;
 }
 #endif  // WEBRTC_AUDIOPROC_DEBUG_DUMP
@@ -17,8 +17,10 @@
 #include <vector>
 
 #include "webrtc/base/criticalsection.h"
+#include "webrtc/base/gtest_prod_util.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/audio_processing/audio_buffer.h"
+#include "webrtc/modules/audio_processing/debug_dump_writer.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/system_wrappers/include/file_wrapper.h"
 
@@ -182,10 +184,10 @@ class AudioProcessingImpl : public AudioProcessing {
   struct ApmDebugDumpState {
     ApmDebugDumpState();
     ~ApmDebugDumpState();
-    // Number of bytes that can still be written to the log before the maximum
-    // size is reached. A value of <= 0 indicates that no limit is used.
-    int64_t num_bytes_left_for_log_ = -1;
-    std::unique_ptr<FileWrapper> debug_file;
+    bool is_open() const { return writer && writer->is_open(); }
+    // Writes the messages to the file on a background thread; null when no
+    // recording is ongoing.
+    std::unique_ptr<DebugDumpWriter> writer;
     ApmDebugDumpThreadState render;
     ApmDebugDumpThreadState capture;
   };
@@ -243,9 +245,7 @@ class AudioProcessingImpl : public AudioProcessing {
 #ifdef WEBRTC_AUDIOPROC_DEBUG_DUMP
   // TODO(andrew): make this more graceful. Ideally we would split this stuff
   // out into a separate class with an "enabled" and "disabled" implementation.
-  static int WriteMessageToDebugFile(FileWrapper* debug_file,
-                                     int64_t* filesize_limit_bytes,
-                                     rtc::CriticalSection* crit_debug,
+  static int WriteMessageToDebugFile(DebugDumpWriter* writer,
                                      ApmDebugDumpThreadState* debug_state);
   int WriteInitMessage() EXCLUSIVE_LOCKS_REQUIRED(crit_render_, crit_capture_);
 
@@ -255,16 +255,18 @@ class AudioProcessingImpl : public AudioProcessing {
   int WriteConfigMessage(bool forced) EXCLUSIVE_LOCKS_REQUIRED(crit_capture_)
       EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
 
-  // Critical section.
-  rtc::CriticalSection crit_debug_;
-
   // Debug dump state.
   ApmDebugDumpState debug_dump_;
 #endif
 
-  // Critical sections.
+  // Critical sections. In steady state the render and capture threads only
+  // take their own lock; both are taken when the configuration changes.
   rtc::CriticalSection crit_render_ ACQUIRED_BEFORE(crit_capture_);
   rtc::CriticalSection crit_capture_;
+  FRIEND_TEST_ALL_PREFIXES(AudioProcessingImplTest,
+                           CaptureDoesNotTakeRenderLock);
+  FRIEND_TEST_ALL_PREFIXES(AudioProcessingImplTest,
+                           RenderDoesNotTakeCaptureLock);
 
   // Class containing information about what submodules are active.
   ApmSubmoduleStates submodule_states_;
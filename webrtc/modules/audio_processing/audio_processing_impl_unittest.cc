@@ -10,8 +10,12 @@
 
 #include "webrtc/modules/audio_processing/audio_processing_impl.h"
 
+#include <memory>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/config.h"
 #include "webrtc/modules/audio_processing/test/test_utils.h"
 #include "webrtc/modules/include/module_common_types.h"
@@ -20,6 +24,85 @@ using ::testing::Invoke;
 using ::testing::Return;
 
 namespace webrtc {
+namespace {
+
+const int kLockTestTimeoutMs = 10000;
+
+// Runs a number of render or capture calls on a separate thread, so that the
+// test thread can hold the lock of the other side meanwhile. The lock must be
+// released before the runner is destroyed.
+class ApiCallRunner {
+ public:
+  ApiCallRunner(AudioProcessing* apm, bool render, int num_calls)
+      : apm_(apm),
+        render_(render),
+        num_calls_(num_calls),
+        done_(false, false),
+        thread_(&ApiCallRunner::Run, this, "ApiCallRunner") {
+    frame_.num_channels_ = 1;
+    SetFrameSampleRate(&frame_, 16000);
+  }
+  ~ApiCallRunner() { thread_.Stop(); }
+
+  // Returns true if all calls completed without error within the timeout.
+  bool StartAndWaitForCalls() {
+    thread_.Start();
+    return done_.Wait(kLockTestTimeoutMs) && !failed_;
+  }
+
+ private:
+  static bool Run(void* obj) {
+    ApiCallRunner* runner = static_cast<ApiCallRunner*>(obj);
+    AudioProcessing* apm = runner->apm_;
+    for (int i = 0; i < runner->num_calls_; ++i) {
+      int error = AudioProcessing::kNoError;
+      if (runner->render_) {
+        error = apm->ProcessReverseStream(&runner->frame_);
+      } else {
+        error = apm->set_stream_delay_ms(0);
+        if (error == AudioProcessing::kNoError)
+          error = apm->ProcessStream(&runner->frame_);
+      }
+      runner->failed_ |= error != AudioProcessing::kNoError;
+    }
+    runner->done_.Set();
+    return false;
+  }
+
+  AudioProcessing* const apm_;
+  const bool render_;
+  const int num_calls_;
+  AudioFrame frame_;
+  bool failed_ = false;
+  rtc::Event done_;
+  rtc::PlatformThread thread_;
+};
+
+// Creates an APM with all render side submodules either using the desktop or
+// the mobile echo canceller, and processes one frame on each side so that no
+// reinitialization is needed afterwards. The experimental AGC is turned off
+// since it does not process the render signal.
+std::unique_ptr<AudioProcessingImpl> CreateInitializedApm(bool mobile_aec) {
+  webrtc::Config config;
+  config.Set<ExperimentalAgc>(new ExperimentalAgc(false));
+  std::unique_ptr<AudioProcessingImpl> apm(new AudioProcessingImpl(config));
+  EXPECT_NOERR(apm->Initialize());
+  EXPECT_NOERR(apm->echo_cancellation()->Enable(!mobile_aec));
+  EXPECT_NOERR(apm->echo_control_mobile()->Enable(mobile_aec));
+  EXPECT_NOERR(apm->gain_control()->set_mode(GainControl::kAdaptiveDigital));
+  EXPECT_NOERR(apm->gain_control()->Enable(true));
+  EXPECT_NOERR(apm->noise_suppression()->Enable(true));
+
+  AudioFrame frame;
+  frame.num_channels_ = 1;
+  SetFrameSampleRate(&frame, 16000);
+  EXPECT_NOERR(apm->ProcessReverseStream(&frame));
+  EXPECT_NOERR(apm->set_stream_delay_ms(0));
+  EXPECT_NOERR(apm->ProcessStream(&frame));
+  return apm;
+}
+
+}  // namespace
 
 class MockInitialize : public AudioProcessingImpl {
  public:
@@ -72,4 +155,41 @@ TEST(AudioProcessingImplTest, AudioParameterChangeTriggersInit) {
   EXPECT_NOERR(mock.ProcessReverseStream(&frame));
 }
 
+TEST(AudioProcessingImplTest, LevelControllerCanBeToggled) {
+  std::unique_ptr<AudioProcessing> apm(AudioProcessing::Create());
+  AudioFrame frame;
+  frame.num_channels_ = 1;
+  SetFrameSampleRate(&frame, 48000);
+
+  // The level controller is allocated when it is enabled, and released when
+  // it is disabled.
+  AudioProcessing::Config config;
+  for (bool enabled : {true, false, true}) {
+    config.level_controller.enabled = enabled;
+    apm->ApplyConfig(config);
+    EXPECT_NOERR(apm->ProcessStream(&frame));
+  }
+}
+
+TEST(AudioProcessingImplTest, CaptureDoesNotTakeRenderLock) {
+  for (bool mobile_aec : {false, true}) {
+    std::unique_ptr<AudioProcessingImpl> apm = CreateInitializedApm(mobile_aec);
+    ApiCallRunner capture(apm.get(), false, 10);
+    // Capture calls must complete while the render lock is held elsewhere.
+    rtc::CritScope cs_render(&apm->crit_render_);
+    EXPECT_TRUE(capture.StartAndWaitForCalls());
+  }
+}
+
+TEST(AudioProcessingImplTest, RenderDoesNotTakeCaptureLock) {
+  for (bool mobile_aec : {false, true}) {
+    std::unique_ptr<AudioProcessingImpl> apm = CreateInitializedApm(mobile_aec);
+    // Render calls must complete while the capture lock is held elsewhere,
+    // also when the render queues fill up as no capture calls are made.
+    ApiCallRunner render(apm.get(), true, 200);
+    rtc::CritScope cs_capture(&apm->crit_capture_);
+    EXPECT_TRUE(render.StartAndWaitForCalls());
+  }
+}
+
 }  // namespace webrtc
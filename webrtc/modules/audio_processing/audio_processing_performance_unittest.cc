@@ -25,6 +25,7 @@
 #include "webrtc/modules/audio_processing/test/test_utils.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 #include "webrtc/system_wrappers/include/event_wrapper.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/testsupport/perf_test.h"
@@ -56,9 +57,19 @@ enum class SettingsType {
   kDefaultApmDesktopAndIntelligibilityEnhancer,
   kAllSubmodulesTurnedOff,
   kDefaultApmDesktopWithoutDelayAgnostic,
-  kDefaultApmDesktopWithoutExtendedFilter
+  kDefaultApmDesktopWithoutExtendedFilter,
+  kDefaultApmDesktopWithoutAvx2
 };
 
+// CPU feature detection that hides AVX2 and FMA3, used to benchmark the SSE2
+// code paths on machines that support AVX2.
+WebRtc_CPUInfo cpu_info_with_avx2 = nullptr;
+int GetCPUInfoWithoutAvx2(CPUFeature feature) {
+  if (feature == kAVX2 || feature == kFMA3)
+    return 0;
+  return cpu_info_with_avx2(feature);
+}
+
 // Variables related to the audio data and formats.
 struct AudioFrameData {
   explicit AudioFrameData(size_t max_frame_size) {
@@ -104,6 +115,16 @@ struct SimulationConfig {
       }
     }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    // Tracks the gain of the AVX2 AEC kernels at the higher rates.
+    const int avx2_comparison_sample_rates[] = {32000, 48000};
+
+    for (auto sample_rate : avx2_comparison_sample_rates) {
+      simulation_configs.push_back(SimulationConfig(
+          sample_rate, SettingsType::kDefaultApmDesktopWithoutAvx2));
+    }
+#endif
+
 #if WEBRTC_INTELLIGIBILITY_ENHANCER == 1
     const SettingsType intelligibility_enhancer_settings[] = {
         SettingsType::kDefaultApmDesktopAndIntelligibilityEnhancer};
@@ -167,6 +188,9 @@ struct SimulationConfig {
       case SettingsType::kDefaultApmDesktopWithoutExtendedFilter:
         description = "DefaultApmDesktopWithoutExtendedFilter";
         break;
+      case SettingsType::kDefaultApmDesktopWithoutAvx2:
+        description = "DefaultApmDesktopWithoutAvx2";
+        break;
     }
     return description;
   }
@@ -497,7 +521,13 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
   static const int32_t kTestTimeout = 3 * 10 * kMinNumFramesToProcess;
 
   // ::testing::TestWithParam<> implementation.
-  void TearDown() override { StopThreads(); }
+  void TearDown() override {
+    StopThreads();
+    if (cpu_info_with_avx2) {
+      WebRtc_GetCPUInfo = cpu_info_with_avx2;
+      cpu_info_with_avx2 = nullptr;
+    }
+  }
 
   // Stop all running threads.
   void StopThreads() {
@@ -588,6 +618,19 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
         apm_->SetExtraOptions(config);
         break;
       }
+      case SettingsType::kDefaultApmDesktopWithoutAvx2: {
+        // The AEC picks its kernels when it is created, so the detection is
+        // masked until the test is torn down.
+        cpu_info_with_avx2 = WebRtc_GetCPUInfo;
+        WebRtc_GetCPUInfo = GetCPUInfoWithoutAvx2;
+        Config config;
+        add_default_desktop_config(&config);
+        apm_.reset(AudioProcessingImpl::Create(config));
+        ASSERT_TRUE(!!apm_);
+        set_default_desktop_apm_runtime_settings(apm_.get());
+        apm_->SetExtraOptions(config);
+        break;
+      }
       case SettingsType::kDefaultApmDesktopAndBeamformer: {
         Config config;
         add_beamformer_config(&config);
@@ -20,6 +20,7 @@
 #include "webrtc/base/arraysize.h"
 #include "webrtc/common_audio/window_generator.h"
 #include "webrtc/modules/audio_processing/beamformer/covariance_matrix_generator.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 namespace {
@@ -74,29 +75,54 @@ const float kHoldTargetSeconds = 0.25f;
 // recording from broadside.
 const float kCompensationGain = 2.f;
 
-// Does conjugate(|norm_mat|) * |mat| * transpose(|norm_mat|). No extra space is
-// used; to accomplish this, we compute both multiplications in the same loop.
-// The returned norm is clamped to be non-negative.
-float Norm(const ComplexMatrix<float>& mat,
+// Does conjugate(|vec|) * |mat| * transpose(|vec|). No extra space is used; to
+// accomplish this, we compute both multiplications in the same loop. The
+// complex products are written out, which gives the same results as the
+// complex<float> operators for finite values without their NaN handling.
+// |kSize| is the size of |mat| if non-zero, otherwise |size| is.
+template <size_t kSize>
+float QuadraticFormC(const complex<float>* mat,
+                     const complex<float>* vec,
+                     size_t size) {
+  const size_t n = kSize ? kSize : size;
+  float result = 0.f;
+  for (size_t i = 0; i < n; ++i) {
+    float product_re = 0.f;
+    float product_im = 0.f;
+    for (size_t j = 0; j < n; ++j) {
+      const complex<float>& element = mat[j * n + i];
+      product_re += vec[j].real() * element.real() +
+                    vec[j].imag() * element.imag();
+      product_im += vec[j].real() * element.imag() -
+                    vec[j].imag() * element.real();
+    }
+    result += product_re * vec[i].real() - product_im * vec[i].imag();
+  }
+  return result;
+}
+
+nonlinear_beamformer::QuadraticForm SelectQuadraticForm(size_t size) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    return nonlinear_beamformer::SelectQuadraticFormSSE2(size);
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  return nonlinear_beamformer::SelectQuadraticFormNeon(size);
+#endif
+  return nonlinear_beamformer::SelectQuadraticFormC(size);
+}
+
+// Does conjugate(|norm_mat|) * |mat| * transpose(|norm_mat|) with
+// |quadratic_form|. The returned norm is clamped to be non-negative.
+float Norm(nonlinear_beamformer::QuadraticForm quadratic_form,
+           const ComplexMatrix<float>& mat,
            const ComplexMatrix<float>& norm_mat) {
   RTC_CHECK_EQ(1u, norm_mat.num_rows());
   RTC_CHECK_EQ(norm_mat.num_columns(), mat.num_rows());
   RTC_CHECK_EQ(norm_mat.num_columns(), mat.num_columns());
-
-  complex<float> first_product = complex<float>(0.f, 0.f);
-  complex<float> second_product = complex<float>(0.f, 0.f);
-
-  const complex<float>* const* mat_els = mat.elements();
-  const complex<float>* const* norm_mat_els = norm_mat.elements();
-
-  for (size_t i = 0; i < norm_mat.num_columns(); ++i) {
-    for (size_t j = 0; j < norm_mat.num_columns(); ++j) {
-      first_product += conj(norm_mat_els[0][j]) * mat_els[j][i];
-    }
-    second_product += first_product * norm_mat_els[0][i];
-    first_product = 0.f;
-  }
-  return std::max(second_product.real(), 0.f);
+  return std::max(quadratic_form(mat.elements()[0], norm_mat.elements()[0],
+                                 norm_mat.num_columns()),
+                  0.f);
 }
 
 // Does conjugate(|lhs|) * |rhs| for row vectors |lhs| and |rhs|.
@@ -109,12 +135,17 @@ complex<float> ConjugateDotProduct(const ComplexMatrix<float>& lhs,
   const complex<float>* const* lhs_elements = lhs.elements();
   const complex<float>* const* rhs_elements = rhs.elements();
 
-  complex<float> result = complex<float>(0.f, 0.f);
+  // The complex products are written out, like in QuadraticFormC().
+  float result_re = 0.f;
+  float result_im = 0.f;
   for (size_t i = 0; i < lhs.num_columns(); ++i) {
-    result += conj(lhs_elements[0][i]) * rhs_elements[0][i];
+    const complex<float>& l = lhs_elements[0][i];
+    const complex<float>& r = rhs_elements[0][i];
+    result_re += l.real() * r.real() + l.imag() * r.imag();
+    result_im += l.real() * r.imag() - l.imag() * r.real();
   }
 
-  return result;
+  return complex<float>(result_re, result_im);
 }
 
 // Works for positive numbers only.
@@ -166,6 +197,33 @@ std::vector<Point> GetCenteredArray(std::vector<Point> array_geometry) {
 
 }  // namespace
 
+namespace nonlinear_beamformer {
+
+QuadraticForm SelectQuadraticFormC(size_t size) {
+  static_assert(kMaxSpecializedChannels == 8,
+                "The specializations need to be updated.");
+  switch (size) {
+    case 2:
+      return QuadraticFormC<2>;
+    case 3:
+      return QuadraticFormC<3>;
+    case 4:
+      return QuadraticFormC<4>;
+    case 5:
+      return QuadraticFormC<5>;
+    case 6:
+      return QuadraticFormC<6>;
+    case 7:
+      return QuadraticFormC<7>;
+    case 8:
+      return QuadraticFormC<8>;
+    default:
+      return QuadraticFormC<0>;
+  }
+}
+
+}  // namespace nonlinear_beamformer
+
 const float NonlinearBeamformer::kHalfBeamWidthRadians = DegreesToRadians(20.f);
 
 // static
@@ -211,6 +269,7 @@ NonlinearBeamformer::NonlinearBeamformer(
     SphericalPointf target_direction)
     : num_input_channels_(array_geometry.size()),
       num_postfilter_channels_(num_postfilter_channels),
+      quadratic_form_(SelectQuadraticForm(num_input_channels_)),
       array_geometry_(GetCenteredArray(array_geometry)),
       array_normal_(GetArrayNormalIfExists(array_geometry)),
       min_mic_spacing_(GetMinimumSpacing(array_geometry)),
@@ -384,10 +443,12 @@ void NonlinearBeamformer::InitInterfCovMats() {
 
 void NonlinearBeamformer::NormalizeCovMats() {
   for (size_t i = 0; i < kNumFreqBins; ++i) {
-    rxiws_[i] = Norm(target_cov_mats_[i], delay_sum_masks_[i]);
+    rxiws_[i] =
+        Norm(quadratic_form_, target_cov_mats_[i], delay_sum_masks_[i]);
     rpsiws_[i].clear();
     for (size_t j = 0; j < interf_angles_radians_.size(); ++j) {
-      rpsiws_[i].push_back(Norm(*interf_cov_mats_[i][j], delay_sum_masks_[i]));
+      rpsiws_[i].push_back(Norm(quadratic_form_, *interf_cov_mats_[i][j],
+                                delay_sum_masks_[i]));
     }
   }
 }
@@ -461,7 +522,7 @@ void NonlinearBeamformer::ProcessAudioBlock(const complex_f* const* input,
       eig_m_.Scale(1.f / eig_m_norm_factor);
     }
 
-    float rxim = Norm(target_cov_mats_[i], eig_m_);
+    float rxim = Norm(quadratic_form_, target_cov_mats_[i], eig_m_);
     float ratio_rxiw_rxim = 0.f;
     if (rxim > 0.f) {
       ratio_rxiw_rxim = rxiws_[i] / rxim;
@@ -498,7 +559,7 @@ float NonlinearBeamformer::CalculatePostfilterMask(
     float rpsiw,
     float ratio_rxiw_rxim,
     float rmw_r) {
-  float rpsim = Norm(interf_cov_mat, eig_m_);
+  float rpsim = Norm(quadratic_form_, interf_cov_mat, eig_m_);
 
   float ratio = 0.f;
   if (rpsim > 0.f) {
@@ -23,6 +23,7 @@
 #include "webrtc/common_audio/channel_buffer.h"
 #include "webrtc/modules/audio_processing/beamformer/array_util.h"
 #include "webrtc/modules/audio_processing/beamformer/complex_matrix.h"
+#include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer_internal.h"
 
 namespace webrtc {
 
@@ -158,6 +159,8 @@ class NonlinearBeamformer : public LappedTransform::Callback {
   // Parameters exposed to the user.
   const size_t num_input_channels_;
   const size_t num_postfilter_channels_;
+  // Specialized for |num_input_channels_|.
+  const nonlinear_beamformer::QuadraticForm quadratic_form_;
   int sample_rate_hz_;
 
   const std::vector<Point> array_geometry_;
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_BEAMFORMER_NONLINEAR_BEAMFORMER_INTERNAL_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_BEAMFORMER_NONLINEAR_BEAMFORMER_INTERNAL_H_
+
+#include <complex>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace nonlinear_beamformer {
+
+// The kernels are specialized at compile time for up to this many input
+// channels. Larger arrays use a generic version.
+const size_t kMaxSpecializedChannels = 8;
+
+// Returns the real part of conj(|vec|) * |mat| * transpose(|vec|), for a row
+// vector |vec| of length |size| and a row-major |size| x |size| matrix |mat|.
+// All versions do the same operations in the same order as the generic
+// ComplexMatrix code, so they give bit-exact results.
+typedef float (*QuadraticForm)(const std::complex<float>* mat,
+                               const std::complex<float>* vec,
+                               size_t size);
+
+// Return the version of the kernel to use for |size| input channels.
+QuadraticForm SelectQuadraticFormC(size_t size);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+QuadraticForm SelectQuadraticFormSSE2(size_t size);
+#endif
+#if defined(WEBRTC_HAS_NEON)
+QuadraticForm SelectQuadraticFormNeon(size_t size);
+#endif
+
+}  // namespace nonlinear_beamformer
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_BEAMFORMER_NONLINEAR_BEAMFORMER_INTERNAL_H_
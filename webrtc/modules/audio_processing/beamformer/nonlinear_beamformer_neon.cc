@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// NEON versions of the NonlinearBeamformer kernels.
+
+#include <arm_neon.h>
+
+#include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer_internal.h"
+
+namespace webrtc {
+namespace nonlinear_beamformer {
+
+namespace {
+
+// Two columns of conjugate(|vec|) * |mat| are computed at once, as interleaved
+// complex numbers. The multiplications and additions are kept separate, since
+// fused versions would not be bit-exact with the C code. |kSize| is the size
+// of |mat| if non-zero, otherwise |size| is.
+template <size_t kSize>
+float QuadraticFormNeon(const std::complex<float>* mat,
+                        const std::complex<float>* vec,
+                        size_t size) {
+  const size_t n = kSize ? kSize : size;
+  const float* mat_float = reinterpret_cast<const float*>(mat);
+  // Negates the imaginary parts.
+  const uint32x4_t imag_sign = vreinterpretq_u32_f32(
+      vcombine_f32(vcreate_f32(0x8000000000000000ULL),
+                   vcreate_f32(0x8000000000000000ULL)));
+  float result = 0.f;
+  size_t i = 0;
+
+  // vectorized code (two columns at once)
+  for (; i + 1 < n; i += 2) {
+    float32x4_t product = vdupq_n_f32(0.f);
+    for (size_t j = 0; j < n; ++j) {
+      const float32x4_t element = vld1q_f32(&mat_float[2 * (j * n + i)]);
+      const float32x4_t swapped = vrev64q_f32(element);
+      const float32x4_t vec_re = vdupq_n_f32(vec[j].real());
+      const float32x4_t vec_im = vdupq_n_f32(vec[j].imag());
+      const float32x4_t conj_product = vreinterpretq_f32_u32(
+          veorq_u32(vreinterpretq_u32_f32(vmulq_f32(vec_im, swapped)),
+                    imag_sign));
+      product = vaddq_f32(
+          product, vaddq_f32(vmulq_f32(vec_re, element), conj_product));
+    }
+    float columns[4];
+    vst1q_f32(columns, product);
+    result += columns[0] * vec[i].real() - columns[1] * vec[i].imag();
+    result += columns[2] * vec[i + 1].real() - columns[3] * vec[i + 1].imag();
+  }
+
+  // scalar code for the remaining column.
+  for (; i < n; ++i) {
+    float product_re = 0.f;
+    float product_im = 0.f;
+    for (size_t j = 0; j < n; ++j) {
+      const std::complex<float>& element = mat[j * n + i];
+      product_re += vec[j].real() * element.real() +
+                    vec[j].imag() * element.imag();
+      product_im += vec[j].real() * element.imag() -
+                    vec[j].imag() * element.real();
+    }
+    result += product_re * vec[i].real() - product_im * vec[i].imag();
+  }
+  return result;
+}
+
+}  // namespace
+
+QuadraticForm SelectQuadraticFormNeon(size_t size) {
+  static_assert(kMaxSpecializedChannels == 8,
+                "The specializations need to be updated.");
+  switch (size) {
+    case 2:
+      return QuadraticFormNeon<2>;
+    case 3:
+      return QuadraticFormNeon<3>;
+    case 4:
+      return QuadraticFormNeon<4>;
+    case 5:
+      return QuadraticFormNeon<5>;
+    case 6:
+      return QuadraticFormNeon<6>;
+    case 7:
+      return QuadraticFormNeon<7>;
+    case 8:
+      return QuadraticFormNeon<8>;
+    default:
+      return QuadraticFormNeon<0>;
+  }
+}
+
+}  // namespace nonlinear_beamformer
+}  // namespace webrtc
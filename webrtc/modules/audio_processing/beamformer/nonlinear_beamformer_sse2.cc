@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// SSE2 versions of the NonlinearBeamformer kernels.
+
+#include <emmintrin.h>
+
+#include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer_internal.h"
+
+namespace webrtc {
+namespace nonlinear_beamformer {
+
+namespace {
+
+// Two columns of conjugate(|vec|) * |mat| are computed at once, as interleaved
+// complex numbers. |kSize| is the size of |mat| if non-zero, otherwise |size|
+// is.
+template <size_t kSize>
+float QuadraticFormSSE2(const std::complex<float>* mat,
+                        const std::complex<float>* vec,
+                        size_t size) {
+  const size_t n = kSize ? kSize : size;
+  const float* mat_float = reinterpret_cast<const float*>(mat);
+  // Negates the imaginary parts.
+  const __m128 imag_sign = _mm_set_ps(-0.f, 0.f, -0.f, 0.f);
+  float result = 0.f;
+  size_t i = 0;
+
+  // vectorized code (two columns at once)
+  for (; i + 1 < n; i += 2) {
+    __m128 product = _mm_setzero_ps();
+    for (size_t j = 0; j < n; ++j) {
+      const __m128 element = _mm_loadu_ps(&mat_float[2 * (j * n + i)]);
+      const __m128 swapped =
+          _mm_shuffle_ps(element, element, _MM_SHUFFLE(2, 3, 0, 1));
+      const __m128 vec_re = _mm_set1_ps(vec[j].real());
+      const __m128 vec_im = _mm_set1_ps(vec[j].imag());
+      product = _mm_add_ps(
+          product,
+          _mm_add_ps(_mm_mul_ps(vec_re, element),
+                     _mm_xor_ps(_mm_mul_ps(vec_im, swapped), imag_sign)));
+    }
+    float columns[4];
+    _mm_storeu_ps(columns, product);
+    result += columns[0] * vec[i].real() - columns[1] * vec[i].imag();
+    result += columns[2] * vec[i + 1].real() - columns[3] * vec[i + 1].imag();
+  }
+
+  // scalar code for the remaining column.
+  for (; i < n; ++i) {
+    float product_re = 0.f;
+    float product_im = 0.f;
+    for (size_t j = 0; j < n; ++j) {
+      const std::complex<float>& element = mat[j * n + i];
+      product_re += vec[j].real() * element.real() +
+                    vec[j].imag() * element.imag();
+      product_im += vec[j].real() * element.imag() -
+                    vec[j].imag() * element.real();
+    }
+    result += product_re * vec[i].real() - product_im * vec[i].imag();
+  }
+  return result;
+}
+
+}  // namespace
+
+QuadraticForm SelectQuadraticFormSSE2(size_t size) {
+  static_assert(kMaxSpecializedChannels == 8,
+                "The specializations need to be updated.");
+  switch (size) {
+    case 2:
+      return QuadraticFormSSE2<2>;
+    case 3:
+      return QuadraticFormSSE2<3>;
+    case 4:
+      return QuadraticFormSSE2<4>;
+    case 5:
+      return QuadraticFormSSE2<5>;
+    case 6:
+      return QuadraticFormSSE2<6>;
+    case 7:
+      return QuadraticFormSSE2<7>;
+    case 8:
+      return QuadraticFormSSE2<8>;
+    default:
+      return QuadraticFormSSE2<0>;
+  }
+}
+
+}  // namespace nonlinear_beamformer
+}  // namespace webrtc
@@ -14,12 +14,19 @@
 #include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer.h"
 
 #include <math.h>
+#include <stdio.h>
+
+#include <complex>
+#include <cstdlib>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/array_view.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/audio_processing/audio_buffer.h"
+#include "webrtc/modules/audio_processing/beamformer/nonlinear_beamformer_internal.h"
 #include "webrtc/modules/audio_processing/test/audio_buffer_tools.h"
 #include "webrtc/modules/audio_processing/test/bitexactness_tools.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 namespace {
@@ -153,6 +160,54 @@ const SphericalPointf TargetDirection2(static_cast<float>(M_PI) / 2.f,
                                        1.f,
                                        2.f);
 
+// The quadratic form as computed with the complex arithmetic of the original
+// ComplexMatrix code.
+float ReferenceQuadraticForm(const std::vector<complex<float>>& mat,
+                             const std::vector<complex<float>>& vec) {
+  const size_t n = vec.size();
+  complex<float> first_product(0.f, 0.f);
+  complex<float> second_product(0.f, 0.f);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      first_product += conj(vec[j]) * mat[j * n + i];
+    }
+    second_product += first_product * vec[i];
+    first_product = 0.f;
+  }
+  return second_product.real();
+}
+
+void VerifyQuadraticForm(
+    nonlinear_beamformer::QuadraticForm (*select)(size_t size)) {
+  std::srand(42);
+  for (size_t n = 1; n <= nonlinear_beamformer::kMaxSpecializedChannels + 3;
+       ++n) {
+    std::vector<complex<float>> mat(n * n);
+    std::vector<complex<float>> vec(n);
+    for (int trial = 0; trial < 10; ++trial) {
+      for (auto& element : mat) {
+        element = complex<float>(std::rand() / (RAND_MAX / 2.f) - 1.f,
+                                 std::rand() / (RAND_MAX / 2.f) - 1.f);
+      }
+      for (auto& element : vec) {
+        element = complex<float>(std::rand() / (RAND_MAX / 2.f) - 1.f,
+                                 std::rand() / (RAND_MAX / 2.f) - 1.f);
+      }
+      EXPECT_EQ(ReferenceQuadraticForm(mat, vec),
+                select(n)(mat.data(), vec.data(), n))
+          << "size " << n;
+    }
+  }
+}
+
+std::vector<Point> CreateLinearArrayGeometry(size_t num_mics) {
+  std::vector<Point> array_geometry;
+  for (size_t i = 0; i < num_mics; ++i) {
+    array_geometry.push_back(Point(0.05f * i, 0.f, 0.f));
+  }
+  return array_geometry;
+}
+
 }  // namespace
 
 TEST(NonlinearBeamformerTest, AimingModifiesBeam) {
@@ -249,6 +304,46 @@ TEST(NonlinearBeamformerTest, InterfAnglesTakeAmbiguityIntoAccount) {
   }
 }
 
+TEST(NonlinearBeamformerTest, QuadraticFormIsBitExact) {
+  VerifyQuadraticForm(nonlinear_beamformer::SelectQuadraticFormC);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    VerifyQuadraticForm(nonlinear_beamformer::SelectQuadraticFormSSE2);
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  VerifyQuadraticForm(nonlinear_beamformer::SelectQuadraticFormNeon);
+#endif
+}
+
+// Measures the time per chunk of AnalyzeChunk() and PostFilter() for linear
+// arrays of different sizes.
+TEST(NonlinearBeamformerTest, DISABLED_ProcessChunkBenchmark) {
+  const size_t kNumChunks = 2000;
+  const size_t kNumMics[] = {2, 4, 8};
+  for (size_t num_mics : kNumMics) {
+    NonlinearBeamformer bf(CreateLinearArrayGeometry(num_mics), 1u);
+    bf.Initialize(kChunkSizeMs, kSampleRateHz);
+    const size_t chunk_length = kSampleRateHz * kChunkSizeMs / 1000;
+    ChannelBuffer<float> data(chunk_length, num_mics);
+    std::srand(42);
+    int64_t elapsed_ns = 0;
+    for (size_t chunk = 0; chunk < kNumChunks; ++chunk) {
+      for (size_t ch = 0; ch < num_mics; ++ch) {
+        for (size_t i = 0; i < chunk_length; ++i) {
+          data.channels()[ch][i] = std::rand() / (RAND_MAX / 0.06f) - 0.03f;
+        }
+      }
+      const int64_t start_ns = rtc::TimeNanos();
+      bf.AnalyzeChunk(data);
+      bf.PostFilter(&data);
+      elapsed_ns += rtc::TimeNanos() - start_ns;
+    }
+    printf("%zu mics: %.2f us per chunk\n", num_mics,
+           elapsed_ns / 1000.0 / kNumChunks);
+  }
+}
+
 // TODO(peah): Investigate why the nonlinear_beamformer.cc causes a DCHECK in
 // this setup.
 TEST(BeamformerBitExactnessTest,
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/debug_dump_writer.h"
+
+#include <utility>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+
+namespace webrtc {
+
+namespace {
+
+// Time between two successive checks of the queue by the writer thread.
+const int kWriterThreadIntervalMs = 20;
+
+}  // namespace
+
+DebugDumpWriter::DebugDumpWriter(std::unique_ptr<FileWrapper> file,
+                                 int64_t max_log_size_bytes)
+    : file_(std::move(file)),
+      num_bytes_left_for_log_(max_log_size_bytes),
+      open_(1),
+      num_dropped_messages_(0),
+      queue_(kMaxQueueSize),
+      wake_up_(false, false),
+      thread_(&DebugDumpWriter::WriterThreadFunc, this, "DebugDumpWriter") {
+  RTC_DCHECK(file_->is_open());
+  thread_.Start();
+}
+
+DebugDumpWriter::~DebugDumpWriter() {
+  wake_up_.Set();
+  thread_.Stop();
+  // Write what is left in the queue now that the writer thread is gone.
+  WriteQueuedMessages();
+  file_->CloseFile();
+  const int num_dropped_messages = this->num_dropped_messages();
+  if (num_dropped_messages > 0) {
+    LOG(LS_WARNING) << "Debug dump dropped " << num_dropped_messages
+                    << " messages";
+  }
+}
+
+bool DebugDumpWriter::QueueMessage(std::string* message) {
+  if (!queue_.Insert(message)) {
+    rtc::AtomicOps::Increment(&num_dropped_messages_);
+    message->clear();
+    return false;
+  }
+  return true;
+}
+
+bool DebugDumpWriter::is_open() const {
+  return rtc::AtomicOps::AcquireLoad(&open_) != 0;
+}
+
+int DebugDumpWriter::num_dropped_messages() const {
+  return rtc::AtomicOps::AcquireLoad(&num_dropped_messages_);
+}
+
+bool DebugDumpWriter::WriterThreadFunc(void* obj) {
+  return static_cast<DebugDumpWriter*>(obj)->ProcessQueue();
+}
+
+bool DebugDumpWriter::ProcessQueue() {
+  wake_up_.Wait(kWriterThreadIntervalMs);
+  WriteQueuedMessages();
+  return true;
+}
+
+void DebugDumpWriter::WriteQueuedMessages() {
+  while (queue_.Remove(&message_)) {
+    WriteMessage();
+    // Cleared before being swapped back into the queue, keeping its capacity.
+    message_.clear();
+  }
+}
+
+void DebugDumpWriter::WriteMessage() {
+  if (!file_->is_open())
+    return;
+  // Update the byte counter.
+  if (num_bytes_left_for_log_ >= 0) {
+    num_bytes_left_for_log_ -= sizeof(int32_t) + message_.length();
+    if (num_bytes_left_for_log_ < 0) {
+      // Not enough bytes are left to write this message, so stop logging.
+      file_->CloseFile();
+      rtc::AtomicOps::ReleaseStore(&open_, 0);
+      return;
+    }
+  }
+  // Write message preceded by its size.
+  const int32_t size = static_cast<int32_t>(message_.length());
+  if (!file_->Write(&size, sizeof(int32_t)) ||
+      !file_->Write(message_.data(), message_.length())) {
+    LOG(LS_ERROR) << "Failed to write to the debug dump";
+  }
+}
+
+}  // namespace webrtc
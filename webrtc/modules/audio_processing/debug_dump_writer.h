@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_DEBUG_DUMP_WRITER_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_DEBUG_DUMP_WRITER_H_
+
+#include <memory>
+#include <string>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/swap_queue.h"
+#include "webrtc/system_wrappers/include/file_wrapper.h"
+
+namespace webrtc {
+
+// Writes serialized debug dump messages to a file on a background thread, so
+// that the audio threads never block on disk I/O. The messages are passed
+// through a fixed-size queue; when the writer cannot keep up and the queue is
+// full, messages are dropped and counted. Each message is written preceded by
+// its size as an int32_t.
+class DebugDumpWriter {
+ public:
+  // Maximum number of messages waiting to be written, i.e. about 2.5 seconds
+  // of audio when both the render and capture sides are dumped.
+  static const size_t kMaxQueueSize = 500;
+
+  // Takes ownership of the already opened |file|. Writing stops before the
+  // file would exceed |max_log_size_bytes|; a negative value indicates that no
+  // limit is used.
+  DebugDumpWriter(std::unique_ptr<FileWrapper> file,
+                  int64_t max_log_size_bytes);
+  // Writes the queued messages and closes the file.
+  ~DebugDumpWriter();
+
+  // Queues |message| for writing. The content of |message| is swapped with an
+  // empty string from the queue, so that no allocation is needed once the
+  // queue has been filled. Returns false if the message was dropped because
+  // the queue is full. Can be called concurrently from several threads; the
+  // messages are written in the order they are queued.
+  bool QueueMessage(std::string* message);
+
+  // Returns false once the size limit has been reached and the file closed.
+  bool is_open() const;
+
+  // Number of messages dropped since the queue was full.
+  int num_dropped_messages() const;
+
+ private:
+  static bool WriterThreadFunc(void* obj);
+  bool ProcessQueue();
+  void WriteQueuedMessages();
+  void WriteMessage();
+
+  const std::unique_ptr<FileWrapper> file_;
+  // Only accessed on the writer thread, or after it has been stopped.
+  int64_t num_bytes_left_for_log_;
+  std::string message_;
+  // Set to 0 when the size limit has been reached.
+  volatile int open_;
+  volatile int num_dropped_messages_;
+  MpscSwapQueue<std::string> queue_;
+  rtc::Event wake_up_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DebugDumpWriter);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_DEBUG_DUMP_WRITER_H_
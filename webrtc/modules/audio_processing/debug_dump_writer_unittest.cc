@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/debug_dump_writer.h"
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+namespace {
+
+std::unique_ptr<FileWrapper> OpenFile(const std::string& file_name) {
+  std::unique_ptr<FileWrapper> file(FileWrapper::Create());
+  EXPECT_TRUE(file->OpenFile(file_name.c_str(), false));
+  return file;
+}
+
+// Reads back the messages written by a DebugDumpWriter.
+std::vector<std::string> ReadMessages(const std::string& file_name) {
+  std::vector<std::string> messages;
+  FILE* file = fopen(file_name.c_str(), "rb");
+  EXPECT_TRUE(file);
+  int32_t size = 0;
+  while (fread(&size, sizeof(size), 1, file) == 1) {
+    std::string message(size, '\0');
+    EXPECT_EQ(static_cast<size_t>(size),
+              fread(&message[0], 1, message.size(), file));
+    messages.push_back(message);
+  }
+  fclose(file);
+  return messages;
+}
+
+}  // namespace
+
+TEST(DebugDumpWriterTest, WritesMessagesInOrder) {
+  const std::string file_name =
+      test::TempFilename(test::OutputPath(), "debug_dump_writer_in_order");
+  const size_t kNumMessages = 3 * DebugDumpWriter::kMaxQueueSize;
+  {
+    DebugDumpWriter writer(OpenFile(file_name), -1);
+    for (size_t i = 0; i < kNumMessages; ++i) {
+      std::string message = "message " + std::to_string(i);
+      // Give the writer thread time to empty the queue.
+      while (!writer.QueueMessage(&message)) {
+        message = "message " + std::to_string(i);
+      }
+      EXPECT_TRUE(message.empty());
+    }
+  }
+  const std::vector<std::string> messages = ReadMessages(file_name);
+  ASSERT_EQ(kNumMessages, messages.size());
+  for (size_t i = 0; i < kNumMessages; ++i)
+    EXPECT_EQ("message " + std::to_string(i), messages[i]);
+  remove(file_name.c_str());
+}
+
+TEST(DebugDumpWriterTest, StopsWritingAtSizeLimit) {
+  const std::string file_name =
+      test::TempFilename(test::OutputPath(), "debug_dump_writer_size_limit");
+  const std::string kMessage = "0123456789";
+  // Room for two messages, each preceded by its size.
+  const int64_t kMaxLogSizeBytes = 2 * (sizeof(int32_t) + kMessage.size()) + 1;
+  {
+    DebugDumpWriter writer(OpenFile(file_name), kMaxLogSizeBytes);
+    for (int i = 0; i < 3; ++i) {
+      std::string message = kMessage;
+      EXPECT_TRUE(writer.QueueMessage(&message));
+    }
+  }
+  const std::vector<std::string> messages = ReadMessages(file_name);
+  ASSERT_EQ(2u, messages.size());
+  EXPECT_EQ(kMessage, messages[0]);
+  EXPECT_EQ(kMessage, messages[1]);
+  remove(file_name.c_str());
+}
+
+TEST(DebugDumpWriterTest, CountsDroppedMessages) {
+  const std::string file_name =
+      test::TempFilename(test::OutputPath(), "debug_dump_writer_dropped");
+  int num_dropped = 0;
+  {
+    DebugDumpWriter writer(OpenFile(file_name), -1);
+    // Queueing more messages than fit in the queue is expected to drop some,
+    // unless the writer thread happens to keep up.
+    for (size_t i = 0; i < 100 * DebugDumpWriter::kMaxQueueSize; ++i) {
+      std::string message(100, 'x');
+      if (!writer.QueueMessage(&message)) {
+        EXPECT_TRUE(message.empty());
+        ++num_dropped;
+      }
+    }
+    EXPECT_EQ(num_dropped, writer.num_dropped_messages());
+  }
+  EXPECT_EQ(100 * DebugDumpWriter::kMaxQueueSize - num_dropped,
+            ReadMessages(file_name).size());
+  remove(file_name.c_str());
+}
+
+}  // namespace webrtc
@@ -162,11 +162,9 @@ int EchoCancellationImpl::ProcessRenderAudio(const AudioBuffer* audio) {
 
   // Insert the samples into the queue.
   if (!render_signal_queue_->Insert(&render_queue_buffer_)) {
-    // The data queue is full and needs to be emptied.
-    ReadQueuedRenderData();
-
-    // Retry the insert (should always work).
-    RTC_DCHECK_EQ(render_signal_queue_->Insert(&render_queue_buffer_), true);
+    // The capture side has stalled and the queue is full. Emptying it from
+    // here would take the capture lock on the render thread, so the chunk is
+    // dropped instead.
   }
 
   return AudioProcessing::kNoError;
@@ -521,7 +519,7 @@ void EchoCancellationImpl::AllocateRenderQueue() {
     std::vector<float> template_queue_element(render_queue_element_max_size_);
 
     render_signal_queue_.reset(
-        new SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
+        new SpscSwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<float>(render_queue_element_max_size_)));
 
@@ -106,7 +106,8 @@ class EchoCancellationImpl : public EchoCancellation {
   std::vector<float> capture_queue_buffer_ GUARDED_BY(crit_capture_);
 
   // Lock protection not needed.
-  std::unique_ptr<SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>>
+  std::unique_ptr<
+      SpscSwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>>
       render_signal_queue_;
 
   std::vector<std::unique_ptr<Canceller>> cancellers_;
@@ -80,7 +80,7 @@ class EchoControlMobileImpl : public EchoControlMobile {
 
   // Lock protection not needed.
   std::unique_ptr<
-      SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
+      SpscSwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
       render_signal_queue_;
 
   std::vector<std::unique_ptr<Canceller>> cancellers_;
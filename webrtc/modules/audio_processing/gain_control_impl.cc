@@ -136,11 +136,9 @@ int GainControlImpl::ProcessRenderAudio(AudioBuffer* audio) {
 
   // Insert the samples into the queue.
   if (!render_signal_queue_->Insert(&render_queue_buffer_)) {
-    // The data queue is full and needs to be emptied.
-    ReadQueuedRenderData();
-
-    // Retry the insert (should always work).
-    RTC_DCHECK_EQ(render_signal_queue_->Insert(&render_queue_buffer_), true);
+    // The capture side has stalled and the queue is full. Emptying it from
+    // here would take the capture lock on the render thread, so the chunk is
+    // dropped instead.
   }
 
   return AudioProcessing::kNoError;
@@ -465,7 +463,8 @@ void GainControlImpl::AllocateRenderQueue() {
     std::vector<int16_t> template_queue_element(render_queue_element_max_size_);
 
     render_signal_queue_.reset(
-        new SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>(
+        new SpscSwapQueue<std::vector<int16_t>,
+                          RenderQueueItemVerifier<int16_t>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<int16_t>(render_queue_element_max_size_)));
 
@@ -477,7 +476,8 @@ void GainControlImpl::AllocateRenderQueue() {
 }
 
 int GainControlImpl::Configure() {
-  rtc::CritScope cs_render(crit_render_);
+  // Only the capture lock is taken, as the experimental AGC calls this on the
+  // capture thread with the capture lock already held.
   rtc::CritScope cs_capture(crit_capture_);
   WebRtcAgcConfig config;
   // TODO(ajm): Flip the sign here (since AGC expects a positive value) if we
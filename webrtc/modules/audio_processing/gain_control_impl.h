@@ -89,7 +89,7 @@ class GainControlImpl : public GainControl {
 
   // Lock protection not needed.
   std::unique_ptr<
-      SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
+      SpscSwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
       render_signal_queue_;
 
   std::vector<std::unique_ptr<GainController>> gain_controllers_;
@@ -52,15 +52,40 @@ float DotProduct(const float* a, const float* b, size_t length) {
   return ret;
 }
 
+// Returns the range of frequencies each filter in |filter_bank| is non-zero
+// for, or an empty range if it is zero everywhere.
+std::vector<std::pair<size_t, size_t>> GetFilterRanges(
+    const std::vector<std::vector<float>>& filter_bank) {
+  std::vector<std::pair<size_t, size_t>> ranges(filter_bank.size());
+  for (size_t i = 0; i < filter_bank.size(); ++i) {
+    const std::vector<float>& filter = filter_bank[i];
+    size_t first = 0;
+    while (first < filter.size() && filter[first] == 0.f) {
+      ++first;
+    }
+    size_t last = filter.size();
+    while (last > first && filter[last - 1] == 0.f) {
+      --last;
+    }
+    ranges[i] = std::make_pair(first, last);
+  }
+  return ranges;
+}
+
 // Computes the power across ERB bands from the power spectral density |pow|.
-// Stores it in |result|.
+// Stores it in |result|. Only the non-zero |ranges| of the filters are used,
+// which gives the same result as the full dot products.
 void MapToErbBands(const float* pow,
                    const std::vector<std::vector<float>>& filter_bank,
+                   const std::vector<std::pair<size_t, size_t>>& ranges,
                    float* result) {
+  RTC_DCHECK_EQ(filter_bank.size(), ranges.size());
   for (size_t i = 0; i < filter_bank.size(); ++i) {
     RTC_DCHECK_GT(filter_bank[i].size(), 0u);
+    const size_t first = ranges[i].first;
     result[i] = kPowerNormalizationFactor *
-                DotProduct(filter_bank[i].data(), pow, filter_bank[i].size());
+                DotProduct(&filter_bank[i][first], &pow[first],
+                           ranges[i].second - first);
   }
 }
 
@@ -84,6 +109,8 @@ IntelligibilityEnhancer::IntelligibilityEnhancer(int sample_rate_hz,
       center_freqs_(bank_size_),
       capture_filter_bank_(CreateErbBank(num_noise_bins)),
       render_filter_bank_(CreateErbBank(freqs_)),
+      capture_filter_ranges_(GetFilterRanges(capture_filter_bank_)),
+      render_filter_ranges_(GetFilterRanges(render_filter_bank_)),
       gains_eq_(bank_size_),
       gain_applier_(freqs_, kMaxRelativeGainChange),
       audio_s16_(chunk_length_),
@@ -170,9 +197,9 @@ void IntelligibilityEnhancer::ProcessAudioBlock(
     ++num_active_chunks_;
     if (num_chunks_ % kGainUpdatePeriod == 0) {
       MapToErbBands(clear_power_estimator_.power().data(), render_filter_bank_,
-                    filtered_clear_pow_.data());
+                    render_filter_ranges_, filtered_clear_pow_.data());
       MapToErbBands(noise_power_estimator_.power().data(), capture_filter_bank_,
-                    filtered_noise_pow_.data());
+                    capture_filter_ranges_, filtered_noise_pow_.data());
       SolveForGainsGivenLambda(kLambdaTop, start_freq_, gains_eq_.data());
       const float power_target = std::accumulate(
           filtered_clear_pow_.data(),
@@ -250,11 +277,15 @@ void IntelligibilityEnhancer::SolveForLambda(float power_target) {
 
 void IntelligibilityEnhancer::UpdateErbGains() {
   // (ERB gain) = filterbank' * (freq gain)
+  // Accumulated filter by filter over the non-zero range of each, which adds
+  // the same terms in the same order as the full product.
   float* gains = gain_applier_.target();
-  for (size_t i = 0; i < freqs_; ++i) {
-    gains[i] = 0.f;
-    for (size_t j = 0; j < bank_size_; ++j) {
-      gains[i] += render_filter_bank_[j][i] * gains_eq_[j];
+  std::fill(gains, gains + freqs_, 0.f);
+  for (size_t j = 0; j < bank_size_; ++j) {
+    const float* filter = render_filter_bank_[j].data();
+    for (size_t i = render_filter_ranges_[j].first;
+         i < render_filter_ranges_[j].second; ++i) {
+      gains[i] += filter[i] * gains_eq_[j];
     }
   }
 }
@@ -13,6 +13,7 @@
 
 #include <complex>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "webrtc/base/swap_queue.h"
@@ -107,6 +108,11 @@ class IntelligibilityEnhancer : public LappedTransform::Callback {
   std::vector<float> center_freqs_;
   std::vector<std::vector<float>> capture_filter_bank_;
   std::vector<std::vector<float>> render_filter_bank_;
+  // The frequencies [first, second) each filter is non-zero for. The filters
+  // only overlap a few bins, so only those are visited when mapping between
+  // frequencies and ERB bands.
+  const std::vector<std::pair<size_t, size_t>> capture_filter_ranges_;
+  const std::vector<std::pair<size_t, size_t>> render_filter_ranges_;
   size_t start_freq_;
 
   std::vector<float> gains_eq_;  // Pre-filter modified gains.
@@ -125,7 +131,7 @@ class IntelligibilityEnhancer : public LappedTransform::Callback {
   unsigned long int num_active_chunks_;
 
   std::vector<float> noise_estimation_buffer_;
-  SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>
+  SpscSwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>
       noise_estimation_queue_;
 
   std::vector<std::unique_ptr<intelligibility::DelayBuffer>>
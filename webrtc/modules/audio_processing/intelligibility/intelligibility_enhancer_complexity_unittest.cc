@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/random.h"
+#include "webrtc/modules/audio_processing/audio_buffer.h"
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/modules/audio_processing/intelligibility/intelligibility_enhancer.h"
+#include "webrtc/modules/audio_processing/noise_suppression_impl.h"
+#include "webrtc/modules/audio_processing/test/audio_buffer_tools.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// The enhancer only activates once its smoothed SNR estimate has dropped,
+// which takes around 300 frames, so it is active for most of the run.
+const size_t kNumFramesToProcess = 1000;
+
+class PerformanceTimer {
+ public:
+  PerformanceTimer() : clock_(webrtc::Clock::GetRealTimeClock()) {
+    durations_us_.reserve(kNumFramesToProcess);
+  }
+
+  void StartTimer() { start_timestamp_us_ = clock_->TimeInMicroseconds(); }
+  void StopTimer() {
+    durations_us_.push_back(clock_->TimeInMicroseconds() -
+                            start_timestamp_us_);
+  }
+
+  std::string FormPerformanceMeasureString() const {
+    RTC_DCHECK(!durations_us_.empty());
+    const double average =
+        static_cast<double>(std::accumulate(durations_us_.begin(),
+                                            durations_us_.end(), int64_t{0})) /
+        durations_us_.size();
+    double variance = 0.0;
+    for (int64_t duration : durations_us_) {
+      variance += (duration - average) * (duration - average);
+    }
+    variance /= durations_us_.size();
+    return std::to_string(average) + ", " + std::to_string(sqrt(variance));
+  }
+
+ private:
+  webrtc::Clock* clock_;
+  int64_t start_timestamp_us_ = 0;
+  std::vector<int64_t> durations_us_;
+};
+
+// Runs the render side of the enhancer on |sample_rate_hz| audio that is split
+// into bands the same way as in APM. The capture noise estimate is kept well
+// above the render level so that the enhancer activates and keeps updating
+// its gains.
+void RunStandaloneEnhancer(int sample_rate_hz, size_t num_channels) {
+  const StreamConfig config(sample_rate_hz, num_channels, false);
+  AudioBuffer buffer(config.num_frames(), config.num_channels(),
+                     config.num_frames(), config.num_channels(),
+                     config.num_frames());
+  Random rand_gen(42);
+  std::vector<float> input(config.num_frames() * config.num_channels());
+  std::vector<float> noise(NoiseSuppressionImpl::num_noise_bins());
+  PerformanceTimer timer;
+
+  IntelligibilityEnhancer enhancer(
+      std::min(sample_rate_hz,
+               static_cast<int>(AudioProcessing::kSampleRate16kHz)),
+      num_channels, buffer.num_bands(), noise.size());
+  for (size_t frame_no = 0; frame_no < kNumFramesToProcess; ++frame_no) {
+    for (float& sample : input) {
+      sample = rand_gen.Rand<float>() - 0.5f;
+    }
+    test::CopyVectorToAudioBuffer(config, input, &buffer);
+    for (float& bin : noise) {
+      bin = 100000.f * rand_gen.Rand<float>();
+    }
+    enhancer.SetCaptureNoiseEstimate(noise, 1.f);
+
+    timer.StartTimer();
+    if (sample_rate_hz > AudioProcessing::kSampleRate16kHz) {
+      buffer.SplitIntoFrequencyBands();
+    }
+    enhancer.ProcessRenderAudio(&buffer);
+    if (sample_rate_hz > AudioProcessing::kSampleRate16kHz) {
+      buffer.MergeFrequencyBands();
+    }
+    timer.StopTimer();
+  }
+  webrtc::test::PrintResultMeanAndError(
+      "intelligibility_enhancer_call_durations",
+      "_" + std::to_string(sample_rate_hz) + "Hz_" +
+          std::to_string(num_channels) + "_channels",
+      "StandaloneIntelligibilityEnhancer",
+      timer.FormPerformanceMeasureString(), "us", false);
+}
+
+}  // namespace
+
+TEST(IntelligibilityEnhancerPerformanceTest, StandaloneProcessing) {
+  const int kSampleRatesToTest[] = {
+      AudioProcessing::kSampleRate8kHz, AudioProcessing::kSampleRate16kHz,
+      AudioProcessing::kSampleRate32kHz, AudioProcessing::kSampleRate48kHz};
+  for (int sample_rate_hz : kSampleRatesToTest) {
+    for (size_t num_channels = 1; num_channels <= 2; ++num_channels) {
+      RunStandaloneEnhancer(sample_rate_hz, num_channels);
+    }
+  }
+}
+
+}  // namespace webrtc
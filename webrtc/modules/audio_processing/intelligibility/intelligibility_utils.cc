@@ -33,6 +33,16 @@ float UpdateFactor(float target, float current, float limit) {
   return std::min(std::max(current * gain, kMinFactor), kMaxFactor);;
 }
 
+float Power(float x) {
+  return x * x;
+}
+
+// std::norm() avoids the square root (and the scaling done to prevent
+// overflow) that squaring std::abs() would take.
+float Power(const std::complex<float>& x) {
+  return std::norm(x);
+}
+
 }  // namespace
 
 template<typename T>
@@ -42,8 +52,7 @@ PowerEstimator<T>::PowerEstimator(size_t num_freqs, float decay)
 template<typename T>
 void PowerEstimator<T>::Step(const T* data) {
   for (size_t i = 0; i < power_.size(); ++i) {
-    power_[i] = decay_ * power_[i] +
-                (1.f - decay_) * std::abs(data[i]) * std::abs(data[i]);
+    power_[i] = decay_ * power_[i] + (1.f - decay_) * Power(data[i]);
   }
 }
 
@@ -7,6 +7,12 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include <math.h>
+
 #include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
@@ -15,6 +21,11 @@
 #include "webrtc/modules/audio_processing/noise_suppression_impl.h"
 #include "webrtc/modules/audio_processing/test/audio_buffer_tools.h"
 #include "webrtc/modules/audio_processing/test/bitexactness_tools.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_AUDIOPROC_FLOAT_PROFILE)
+#include "webrtc/modules/audio_processing/ns/noise_suppression.h"
+#endif
 
 namespace webrtc {
 namespace {
@@ -45,9 +56,15 @@ void RunBitexactnessTest(int sample_rate_hz,
                          float speech_probability_reference,
                          rtc::ArrayView<const float> noise_estimate_reference,
                          rtc::ArrayView<const float> output_reference) {
+  // The references are produced by the generic C code. The vectorized log()
+  // and exp() approximations are checked against it by
+  // NoiseSuppressionSimdTest below.
+  WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+  WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
   rtc::CriticalSection crit_capture;
   NoiseSuppressionImpl noise_suppressor(&crit_capture);
   noise_suppressor.Initialize(num_channels, sample_rate_hz);
+  WebRtc_GetCPUInfo = get_cpu_info;
   noise_suppressor.Enable(true);
   noise_suppressor.set_level(level);
 
@@ -92,8 +109,76 @@ void RunBitexactnessTest(int sample_rate_hz,
       output_reference, capture_output, kVectorElementErrorBound));
 }
 
+#if defined(WEBRTC_AUDIOPROC_FLOAT_PROFILE)
+// Runs the float noise suppressor on white noise, with a tone switched on and
+// off every second, and returns the output of all frames
+// together with the final speech probability.
+void RunFloatNoiseSuppressor(int sample_rate_hz,
+                             std::vector<float>* output,
+                             float* speech_probability) {
+  const size_t kFrameLength = rtc::CheckedDivExact(sample_rate_hz, 100);
+  NsHandle* ns = WebRtcNs_Create();
+  ASSERT_EQ(0, WebRtcNs_Init(ns, sample_rate_hz));
+  ASSERT_EQ(0, WebRtcNs_set_policy(ns, 2));
+  std::vector<float> input(kFrameLength);
+  std::vector<float> frame_output(kFrameLength);
+  unsigned int seed = 17;
+  for (size_t frame_no = 0; frame_no < kNumFramesToProcess; ++frame_no) {
+    for (size_t i = 0; i < kFrameLength; ++i) {
+      seed = seed * 1103515245 + 12345;
+      input[i] = 1000.f * (static_cast<float>(seed >> 16 & 0x7FFF) / 16384.f -
+                           1.f);
+      if ((frame_no / 100) % 2 == 1) {
+        input[i] += 8000.f * sinf(2.f * static_cast<float>(M_PI) * 440.f *
+                                  (frame_no * kFrameLength + i) /
+                                  sample_rate_hz);
+      }
+    }
+    const float* input_ptr = input.data();
+    float* output_ptr = frame_output.data();
+    WebRtcNs_Analyze(ns, input_ptr);
+    WebRtcNs_Process(ns, &input_ptr, 1, &output_ptr);
+    output->insert(output->end(), frame_output.begin(), frame_output.end());
+  }
+  *speech_probability = WebRtcNs_prior_speech_probability(ns);
+  WebRtcNs_Free(ns);
+}
+
+// Verifies that the vectorized spectral math, if any, stays close to the
+// generic C code.
+void RunSimdTest(int sample_rate_hz) {
+  WebRtc_CPUInfo get_cpu_info = WebRtc_GetCPUInfo;
+  WebRtc_GetCPUInfo = WebRtc_GetCPUInfoNoASM;
+  std::vector<float> reference_output;
+  float reference_speech_probability;
+  RunFloatNoiseSuppressor(sample_rate_hz, &reference_output,
+                          &reference_speech_probability);
+  WebRtc_GetCPUInfo = get_cpu_info;
+
+  std::vector<float> output;
+  float speech_probability;
+  RunFloatNoiseSuppressor(sample_rate_hz, &output, &speech_probability);
+
+  ASSERT_EQ(reference_output.size(), output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    ASSERT_NEAR(reference_output[i], output[i], 0.1f) << "sample " << i;
+  }
+  EXPECT_NEAR(reference_speech_probability, speech_probability, 1e-4f);
+}
+#endif
+
 }  // namespace
 
+#if defined(WEBRTC_AUDIOPROC_FLOAT_PROFILE)
+TEST(NoiseSuppressionSimdTest, Mono8kHz) {
+  RunSimdTest(8000);
+}
+
+TEST(NoiseSuppressionSimdTest, Mono16kHz) {
+  RunSimdTest(16000);
+}
+#endif
+
 TEST(NoiseSuppresionBitExactnessTest, Mono8kHzLow) {
 #if defined(WEBRTC_ARCH_ARM64)
   const float kSpeechProbabilityReference = -4.0f;
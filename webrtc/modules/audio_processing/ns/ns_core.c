@@ -18,6 +18,36 @@
 #include "webrtc/modules/audio_processing/ns/noise_suppression.h"
 #include "webrtc/modules/audio_processing/ns/ns_core.h"
 #include "webrtc/modules/audio_processing/ns/windows_private.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
+
+static void LogC(const float* in, size_t length, float* out) {
+  size_t i;
+  for (i = 0; i < length; ++i) {
+    out[i] = (float)log(in[i]);
+  }
+}
+
+static void ExpC(const float* in, size_t length, float* out) {
+  size_t i;
+  for (i = 0; i < length; ++i) {
+    out[i] = (float)exp(in[i]);
+  }
+}
+
+static void MagnitudeC(const float* real,
+                       const float* imag,
+                       size_t length,
+                       float* magn) {
+  size_t i;
+  for (i = 0; i < length; ++i) {
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+// Declare function pointers.
+NsLog WebRtcNs_Log;
+NsExp WebRtcNs_Exp;
+NsMagnitude WebRtcNs_Magnitude;
 
 // Set Feature Extraction Parameters.
 static void set_feature_extraction_parameters(NoiseSuppressionC* self) {
@@ -209,25 +239,35 @@ int WebRtcNs_InitCore(NoiseSuppressionC* self, uint32_t fs) {
   // Default mode.
   WebRtcNs_set_policy_core(self, 0);
 
+  // Initialize function pointers.
+  WebRtcNs_Log = LogC;
+  WebRtcNs_Exp = ExpC;
+  WebRtcNs_Magnitude = MagnitudeC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcNs_InitSSE2();
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  WebRtcNs_InitNeon();
+#endif
+
   self->initFlag = 1;
   return 0;
 }
 
 // Estimate noise.
+// |lmagn| is the log of the magnitude spectrum.
 static void NoiseEstimation(NoiseSuppressionC* self,
-                            float* magn,
+                            const float* lmagn,
                             float* noise) {
   size_t i, s, offset;
-  float lmagn[HALF_ANAL_BLOCKL], delta;
+  float delta;
 
   if (self->updates < END_STARTUP_LONG) {
     self->updates++;
   }
 
-  for (i = 0; i < self->magnLen; i++) {
-    lmagn[i] = (float)log(magn[i]);
-  }
-
   // Loop over simultaneous estimates.
   for (s = 0; s < SIMULT; s++) {
     offset = s * self->magnLen;
@@ -262,9 +302,7 @@ static void NoiseEstimation(NoiseSuppressionC* self,
     if (self->counter[s] >= END_STARTUP_LONG) {
       self->counter[s] = 0;
       if (self->updates >= END_STARTUP_LONG) {
-        for (i = 0; i < self->magnLen; i++) {
-          self->quantile[i] = (float)exp(self->lquantile[offset + i]);
-        }
+        WebRtcNs_Exp(&self->lquantile[offset], self->magnLen, self->quantile);
       }
     }
 
@@ -274,9 +312,7 @@ static void NoiseEstimation(NoiseSuppressionC* self,
   // Sequentially update the noise during startup.
   if (self->updates < END_STARTUP_LONG) {
     // Use the last "s" to get noise during startup that differ from zero.
-    for (i = 0; i < self->magnLen; i++) {
-      self->quantile[i] = (float)exp(self->lquantile[offset + i]);
-    }
+    WebRtcNs_Exp(&self->lquantile[offset], self->magnLen, self->quantile);
   }
 
   for (i = 0; i < self->magnLen; i++) {
@@ -518,10 +554,11 @@ static void FeatureParameterExtraction(NoiseSuppressionC* self, int flag) {
 }
 
 // Compute spectral flatness on input spectrum.
-// |magnIn| is the magnitude spectrum.
+// |magnIn| is the magnitude spectrum and |lmagnIn| its log.
 // Spectral flatness is returned in self->featureData[0].
 static void ComputeSpectralFlatness(NoiseSuppressionC* self,
-                                    const float* magnIn) {
+                                    const float* magnIn,
+                                    const float* lmagnIn) {
   size_t i;
   size_t shiftLP = 1;  // Option to remove first bin(s) from spectral measures.
   float avgSpectralFlatnessNum, avgSpectralFlatnessDen, spectralTmp;
@@ -537,7 +574,7 @@ static void ComputeSpectralFlatness(NoiseSuppressionC* self,
   // case.
   for (i = shiftLP; i < self->magnLen; i++) {
     if (magnIn[i] > 0.0) {
-      avgSpectralFlatnessNum += (float)log(magnIn[i]);
+      avgSpectralFlatnessNum += lmagnIn[i];
     } else {
       self->featureData[0] -= SPECT_FL_TAVG * self->featureData[0];
       return;
@@ -652,6 +689,7 @@ static void SpeechNoiseProb(NoiseSuppressionC* self,
   float weightIndPrior0, weightIndPrior1, weightIndPrior2;
   float threshPrior0, threshPrior1, threshPrior2;
   float widthPrior, widthPrior0, widthPrior1, widthPrior2;
+  float lrtTmp[HALF_ANAL_BLOCKL], logLrtTmp[HALF_ANAL_BLOCKL];
 
   widthPrior0 = WIDTH_PR_MAP;
   // Width for pause region: lower range, so increase width in tanh map.
@@ -675,11 +713,15 @@ static void SpeechNoiseProb(NoiseSuppressionC* self,
   // This is the average over all frequencies of the smooth log LRT.
   logLrtTimeAvgKsum = 0.0;
   for (i = 0; i < self->magnLen; i++) {
-    tmpFloat1 = 1.f + 2.f * snrLocPrior[i];
+    lrtTmp[i] = 1.f + 2.f * snrLocPrior[i];
+  }
+  WebRtcNs_Log(lrtTmp, self->magnLen, logLrtTmp);
+  for (i = 0; i < self->magnLen; i++) {
+    tmpFloat1 = lrtTmp[i];
     tmpFloat2 = 2.f * snrLocPrior[i] / (tmpFloat1 + 0.0001f);
     besselTmp = (snrLocPost[i] + 1.f) * tmpFloat2;
     self->logLrtTimeAvg[i] +=
-        LRT_TAVG * (besselTmp - (float)log(tmpFloat1) - self->logLrtTimeAvg[i]);
+        LRT_TAVG * (besselTmp - logLrtTmp[i] - self->logLrtTimeAvg[i]);
     logLrtTimeAvgKsum += self->logLrtTimeAvg[i];
   }
   logLrtTimeAvgKsum = (float)logLrtTimeAvgKsum / (self->magnLen);
@@ -743,8 +785,11 @@ static void SpeechNoiseProb(NoiseSuppressionC* self,
   // Final speech probability: combine prior model with LR factor:.
   gainPrior = (1.f - self->priorSpeechProb) / (self->priorSpeechProb + 0.0001f);
   for (i = 0; i < self->magnLen; i++) {
-    invLrt = (float)exp(-self->logLrtTimeAvg[i]);
-    invLrt = (float)gainPrior * invLrt;
+    lrtTmp[i] = -self->logLrtTimeAvg[i];
+  }
+  WebRtcNs_Exp(lrtTmp, self->magnLen, lrtTmp);
+  for (i = 0; i < self->magnLen; i++) {
+    invLrt = (float)gainPrior * lrtTmp[i];
     probSpeechFinal[i] = 1.f / (1.f + invLrt);
   }
 }
@@ -752,12 +797,14 @@ static void SpeechNoiseProb(NoiseSuppressionC* self,
 // Update the noise features.
 // Inputs:
 //   * |magn| is the signal magnitude spectrum estimate.
+//   * |lmagn| is the log of |magn|.
 //   * |updateParsFlag| is an update flag for parameters.
 static void FeatureUpdate(NoiseSuppressionC* self,
                           const float* magn,
+                          const float* lmagn,
                           int updateParsFlag) {
   // Compute spectral flatness on input spectrum.
-  ComputeSpectralFlatness(self, magn);
+  ComputeSpectralFlatness(self, magn, lmagn);
   // Compute difference of input spectrum with learned/estimated noise spectrum.
   ComputeSpectralDifference(self, magn);
   // Compute histograms for parameter decisions (thresholds and weights for
@@ -906,9 +953,9 @@ static void FFT(NoiseSuppressionC* self,
   for (i = 1; i < magnitude_length - 1; ++i) {
     real[i] = time_data[2 * i];
     imag[i] = time_data[2 * i + 1];
-    // Magnitude spectrum.
-    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
   }
+  // Magnitude spectrum.
+  WebRtcNs_Magnitude(&real[1], &imag[1], magnitude_length - 2, &magn[1]);
 }
 
 // Transforms the signal from frequency to time domain.
@@ -1050,7 +1097,8 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC* self, const float* speechFrame) {
   float sumMagn = 0.f;
   float tmpFloat1, tmpFloat2, tmpFloat3;
   float winData[ANAL_BLOCKL_MAX];
-  float magn[HALF_ANAL_BLOCKL], noise[HALF_ANAL_BLOCKL];
+  float magn[HALF_ANAL_BLOCKL], lmagn[HALF_ANAL_BLOCKL];
+  float noise[HALF_ANAL_BLOCKL];
   float snrLocPost[HALF_ANAL_BLOCKL], snrLocPrior[HALF_ANAL_BLOCKL];
   float real[ANAL_BLOCKL_MAX], imag[HALF_ANAL_BLOCKL];
   // Variables during startup.
@@ -1085,6 +1133,8 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC* self, const float* speechFrame) {
   self->blockInd++;  // Update the block index only when we process a block.
 
   FFT(self, winData, self->anaLen, self->magnLen, real, imag, magn);
+  // The log spectrum is shared by the noise and feature estimation.
+  WebRtcNs_Log(magn, self->magnLen, lmagn);
 
   for (i = 0; i < self->magnLen; i++) {
     signalEnergy += real[i] * real[i] + imag[i] * imag[i];
@@ -1105,7 +1155,7 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC* self, const float* speechFrame) {
   self->sumMagn = sumMagn;
 
   // Quantile noise estimate.
-  NoiseEstimation(self, magn, noise);
+  NoiseEstimation(self, lmagn, noise);
   // Compute simplified noise model during startup.
   if (self->blockInd < END_STARTUP_SHORT) {
     // Estimate White noise.
@@ -1172,7 +1222,7 @@ void WebRtcNs_AnalyzeCore(NoiseSuppressionC* self, const float* speechFrame) {
   // Post and prior SNR needed for SpeechNoiseProb.
   ComputeSnr(self, magn, noise, snrLocPrior, snrLocPost);
 
-  FeatureUpdate(self, magn, updateParsFlag);
+  FeatureUpdate(self, magn, lmagn, updateParsFlag);
   SpeechNoiseProb(self, self->speechProb, snrLocPrior, snrLocPost);
   UpdateNoiseEstimate(self, magn, snrLocPrior, snrLocPost, noise);
 
@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_AUDIO_PROCESSING_NS_NS_CORE_H_
 
 #include "webrtc/modules/audio_processing/ns/defines.h"
+#include "webrtc/typedefs.h"
 
 typedef struct NSParaExtract_ {
   // Bin size of histogram.
@@ -184,6 +185,38 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
                           size_t num_bands,
                           float* const* outFrame);
 
+/****************************************************************************
+ * Some function pointers, for the per-bin spectral math shared by SSE2, ARM
+ * NEON and generic C code. The optimized logarithm and exponential are
+ * polynomial approximations accurate to about one ulp, which is well within
+ * what the noise estimation needs. |in| and |out| may be the same array.
+ */
+// Natural logarithm of |length| positive values.
+typedef void (*NsLog)(const float* in, size_t length, float* out);
+extern NsLog WebRtcNs_Log;
+
+// Exponential of |length| values.
+typedef void (*NsExp)(const float* in, size_t length, float* out);
+extern NsExp WebRtcNs_Exp;
+
+// Magnitude spectrum, offset by one to avoid taking the log of zero later.
+typedef void (*NsMagnitude)(const float* real,
+                            const float* imag,
+                            size_t length,
+                            float* magn);
+extern NsMagnitude WebRtcNs_Magnitude;
+
+// The generic C versions of the above are defined as static in ns_core.c.
+// These set the function pointers to the optimized versions, defined in
+// ns_core_sse2.c and ns_core_neon.c.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcNs_InitSSE2(void);
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void WebRtcNs_InitNeon(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
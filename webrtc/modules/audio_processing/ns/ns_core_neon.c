@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <arm_neon.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_processing/ns/ns_core.h"
+
+// Natural logarithm of four positive, normal floats, using the same
+// decomposition and polynomial as mm_log_ps() in ns_core_sse2.c.
+static float32x4_t vlogq_f32(float32x4_t x) {
+  const uint32x4_t exponent_mask = vdupq_n_u32(0x7F800000);
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const uint32x4_t bits = vreinterpretq_u32_f32(x);
+  float32x4_t e, m, z, y;
+  uint32x4_t mask;
+
+  // Exponent and mantissa in [0.5, 1).
+  e = vcvtq_f32_s32(vsubq_s32(
+      vreinterpretq_s32_u32(vshrq_n_u32(vandq_u32(bits, exponent_mask), 23)),
+      vdupq_n_s32(126)));
+  m = vreinterpretq_f32_u32(vorrq_u32(vbicq_u32(bits, exponent_mask),
+                                      vreinterpretq_u32_f32(half)));
+
+  // Move the mantissa to [sqrt(0.5), sqrt(2)) and subtract one.
+  mask = vcltq_f32(m, vdupq_n_f32(0.707106781186547524f));
+  e = vsubq_f32(e, vreinterpretq_f32_u32(
+                       vandq_u32(vreinterpretq_u32_f32(one), mask)));
+  m = vsubq_f32(vaddq_f32(m, vreinterpretq_f32_u32(vandq_u32(
+                                 vreinterpretq_u32_f32(m), mask))),
+                one);
+
+  z = vmulq_f32(m, m);
+  y = vdupq_n_f32(7.0376836292E-2f);
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(-1.1514610310E-1f));
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(1.1676998740E-1f));
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(-1.2420140846E-1f));
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(1.4249322787E-1f));
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(-1.6668057665E-1f));
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(2.0000714765E-1f));
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(-2.4999993993E-1f));
+  y = vaddq_f32(vmulq_f32(y, m), vdupq_n_f32(3.3333331174E-1f));
+  y = vmulq_f32(vmulq_f32(y, m), z);
+
+  // log(2) is split into 0.693359375 - 2.12194440e-4 for accuracy.
+  y = vaddq_f32(y, vmulq_f32(e, vdupq_n_f32(-2.12194440e-4f)));
+  y = vsubq_f32(y, vmulq_f32(z, half));
+  y = vaddq_f32(m, y);
+  return vaddq_f32(y, vmulq_f32(e, vdupq_n_f32(0.693359375f)));
+}
+
+// Exponential of four floats, using the same decomposition and polynomial as
+// mm_exp_ps() in ns_core_sse2.c.
+static float32x4_t vexpq_f32(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  float32x4_t n, truncated, z, y;
+  int32x4_t two_n;
+
+  x = vminq_f32(x, vdupq_n_f32(88.f));
+  x = vmaxq_f32(x, vdupq_n_f32(-87.3365447505531f));
+
+  // n = floor(x / log(2) + 0.5).
+  n = vaddq_f32(vmulq_f32(x, vdupq_n_f32(1.44269504088896341f)),
+                vdupq_n_f32(0.5f));
+  truncated = vcvtq_f32_s32(vcvtq_s32_f32(n));
+  n = vsubq_f32(truncated,
+                vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(truncated, n),
+                                                vreinterpretq_u32_f32(one))));
+
+  x = vsubq_f32(x, vmulq_f32(n, vdupq_n_f32(0.693359375f)));
+  x = vsubq_f32(x, vmulq_f32(n, vdupq_n_f32(-2.12194440e-4f)));
+
+  z = vmulq_f32(x, x);
+  y = vdupq_n_f32(1.9875691500E-4f);
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.3981999507E-3f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(8.3334519073E-3f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(4.1665795894E-2f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(1.6666665459E-1f));
+  y = vaddq_f32(vmulq_f32(y, x), vdupq_n_f32(5.0000001201E-1f));
+  y = vaddq_f32(vaddq_f32(vmulq_f32(y, z), x), one);
+
+  // Scale by 2^n.
+  two_n = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+  return vmulq_f32(y, vreinterpretq_f32_s32(two_n));
+}
+
+static void LogNeon(const float* in, size_t length, float* out) {
+  size_t i;
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    vst1q_f32(&out[i], vlogq_f32(vld1q_f32(&in[i])));
+  }
+  // scalar code for the remaining items.
+  for (; i < length; ++i) {
+    out[i] = (float)log(in[i]);
+  }
+}
+
+static void ExpNeon(const float* in, size_t length, float* out) {
+  size_t i;
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    vst1q_f32(&out[i], vexpq_f32(vld1q_f32(&in[i])));
+  }
+  // scalar code for the remaining items.
+  for (; i < length; ++i) {
+    out[i] = (float)exp(in[i]);
+  }
+}
+
+// ARMv7 NEON has no square root instruction, so the square root is computed
+// from the reciprocal square root estimate refined by two Newton-Raphson
+// steps. The power is floored to FLT_MIN to avoid 0 * inf.
+static void MagnitudeNeon(const float* real,
+                          const float* imag,
+                          size_t length,
+                          float* magn) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  size_t i;
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    const float32x4_t re = vld1q_f32(&real[i]);
+    const float32x4_t im = vld1q_f32(&imag[i]);
+    const float32x4_t power = vmaxq_f32(
+        vmlaq_f32(vmulq_f32(re, re), im, im),
+        vdupq_n_f32(1.17549435e-38f));
+    float32x4_t rsqrt = vrsqrteq_f32(power);
+    rsqrt = vmulq_f32(vrsqrtsq_f32(vmulq_f32(power, rsqrt), rsqrt), rsqrt);
+    rsqrt = vmulq_f32(vrsqrtsq_f32(vmulq_f32(power, rsqrt), rsqrt), rsqrt);
+    vst1q_f32(&magn[i], vaddq_f32(vmulq_f32(power, rsqrt), one));
+  }
+  // scalar code for the remaining items.
+  for (; i < length; ++i) {
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+void WebRtcNs_InitNeon(void) {
+  WebRtcNs_Log = LogNeon;
+  WebRtcNs_Exp = ExpNeon;
+  WebRtcNs_Magnitude = MagnitudeNeon;
+}
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <math.h>
+
+#include "webrtc/modules/audio_processing/ns/ns_core.h"
+
+// Natural logarithm of four positive, normal floats. The argument is split
+// into an exponent |e| and a mantissa |m| in [sqrt(0.5), sqrt(2)), and
+// log(m) is approximated with the same polynomial as the Cephes logf(). The
+// maximum error is about one ulp.
+static __m128 mm_log_ps(__m128 x) {
+  const __m128i exponent_mask = _mm_set1_epi32(0x7F800000);
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  __m128 e, m, mask, z, y;
+
+  // Exponent and mantissa in [0.5, 1).
+  const __m128i bits = _mm_castps_si128(x);
+  e = _mm_cvtepi32_ps(_mm_sub_epi32(
+      _mm_srli_epi32(_mm_and_si128(bits, exponent_mask), 23),
+      _mm_set1_epi32(126)));
+  m = _mm_or_ps(_mm_castsi128_ps(_mm_andnot_si128(exponent_mask, bits)),
+                half);
+
+  // Move the mantissa to [sqrt(0.5), sqrt(2)) and subtract one.
+  mask = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+  e = _mm_sub_ps(e, _mm_and_ps(one, mask));
+  m = _mm_sub_ps(_mm_add_ps(m, _mm_and_ps(m, mask)), one);
+
+  z = _mm_mul_ps(m, m);
+  y = _mm_set1_ps(7.0376836292E-2f);
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.1514610310E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(1.1676998740E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.2420140846E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(1.4249322787E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.6668057665E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(2.0000714765E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-2.4999993993E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(3.3333331174E-1f));
+  y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+
+  // log(2) is split into 0.693359375 - 2.12194440e-4 for accuracy.
+  y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+  y = _mm_sub_ps(y, _mm_mul_ps(z, half));
+  y = _mm_add_ps(m, y);
+  return _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+}
+
+// Exponential of four floats. The argument is split as n * log(2) + r, with
+// an integer |n| and |r| in [-log(2) / 2, log(2) / 2], and exp(r) is
+// approximated with the same polynomial as the Cephes expf(). Arguments
+// outside of the range of normal floats are clamped to it, and arguments
+// between 88 and log(FLT_MAX) to 88.
+static __m128 mm_exp_ps(__m128 x) {
+  const __m128 one = _mm_set1_ps(1.f);
+  __m128 n, truncated, z, y;
+  __m128i two_n;
+
+  x = _mm_min_ps(x, _mm_set1_ps(88.f));
+  x = _mm_max_ps(x, _mm_set1_ps(-87.3365447505531f));
+
+  // n = floor(x / log(2) + 0.5).
+  n = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)),
+                 _mm_set1_ps(0.5f));
+  truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(n));
+  n = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, n), one));
+
+  x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(0.693359375f)));
+  x = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(-2.12194440e-4f)));
+
+  z = _mm_mul_ps(x, x);
+  y = _mm_set1_ps(1.9875691500E-4f);
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507E-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073E-3f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894E-2f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459E-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201E-1f));
+  y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), one);
+
+  // Scale by 2^n.
+  two_n = _mm_slli_epi32(
+      _mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(y, _mm_castsi128_ps(two_n));
+}
+
+static void LogSSE2(const float* in, size_t length, float* out) {
+  size_t i;
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    _mm_storeu_ps(&out[i], mm_log_ps(_mm_loadu_ps(&in[i])));
+  }
+  // scalar code for the remaining items.
+  for (; i < length; ++i) {
+    out[i] = (float)log(in[i]);
+  }
+}
+
+static void ExpSSE2(const float* in, size_t length, float* out) {
+  size_t i;
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    _mm_storeu_ps(&out[i], mm_exp_ps(_mm_loadu_ps(&in[i])));
+  }
+  // scalar code for the remaining items.
+  for (; i < length; ++i) {
+    out[i] = (float)exp(in[i]);
+  }
+}
+
+// Bit-exact with the C version, since the square root is exactly rounded.
+static void MagnitudeSSE2(const float* real,
+                          const float* imag,
+                          size_t length,
+                          float* magn) {
+  const __m128 one = _mm_set1_ps(1.f);
+  size_t i;
+  // vectorized code (four at once)
+  for (i = 0; i + 3 < length; i += 4) {
+    const __m128 re = _mm_loadu_ps(&real[i]);
+    const __m128 im = _mm_loadu_ps(&imag[i]);
+    const __m128 power = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+    _mm_storeu_ps(&magn[i], _mm_add_ps(_mm_sqrt_ps(power), one));
+  }
+  // scalar code for the remaining items.
+  for (; i < length; ++i) {
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+void WebRtcNs_InitSSE2(void) {
+  WebRtcNs_Log = LogSSE2;
+  WebRtcNs_Exp = ExpSSE2;
+  WebRtcNs_Magnitude = MagnitudeSSE2;
+}
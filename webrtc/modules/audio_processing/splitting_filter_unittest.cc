@@ -14,6 +14,8 @@
 #include <cmath>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_audio/channel_buffer.h"
 #include "webrtc/modules/audio_processing/splitting_filter.h"
 
@@ -103,4 +105,30 @@ TEST(SplittingFilterTest, SplitsIntoThreeBandsAndReconstructs) {
   }
 }
 
+// Measures the time of a three band split and merge of a 48 kHz channel.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(SplittingFilterTest, DISABLED_ThreeBandsSplitAndMergeBenchmark) {
+  static const int kChannels = 1;
+  static const int kSampleRateHz = 48000;
+  static const size_t kNumBands = 3;
+  static const size_t kChunks = 100000;
+  SplittingFilter splitting_filter(kChannels, kNumBands,
+                                   kSamplesPer48kHzChannel);
+  IFChannelBuffer in_data(kSamplesPer48kHzChannel, kChannels, kNumBands);
+  IFChannelBuffer bands(kSamplesPer48kHzChannel, kChannels, kNumBands);
+  IFChannelBuffer out_data(kSamplesPer48kHzChannel, kChannels, kNumBands);
+  for (size_t k = 0; k < kSamplesPer48kHzChannel; ++k) {
+    in_data.fbuf()->channels()[0][k] =
+        8192.f * sin(2.f * M_PI * 1000 * k / kSampleRateHz);
+  }
+  int64_t start_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < kChunks; ++i) {
+    splitting_filter.Analysis(&in_data, &bands);
+    splitting_filter.Synthesis(&bands, &out_data);
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  LOG(LS_INFO) << "Split and merged " << kChunks << " chunks: "
+               << elapsed_ns / kChunks << " ns/chunk.";
+}
+
 }  // namespace webrtc
@@ -38,22 +38,16 @@
 #include <cmath>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
-namespace {
 
-const size_t kNumBands = 3;
-const size_t kSparsity = 4;
+using three_band_filter_bank::kMemorySize;
+using three_band_filter_bank::kNumBands;
+using three_band_filter_bank::kNumCoeffs;
+using three_band_filter_bank::kSparsity;
 
-// Factors to take into account when choosing |kNumCoeffs|:
-//   1. Higher |kNumCoeffs|, means faster transition, which ensures less
-//      aliasing. This is especially important when there is non-linear
-//      processing between the splitting and merging.
-//   2. The delay that this filter bank introduces is
-//      |kNumBands| * |kSparsity| * |kNumCoeffs| / 2, so it increases linearly
-//      with |kNumCoeffs|.
-//   3. The computation complexity also increases linearly with |kNumCoeffs|.
-const size_t kNumCoeffs = 4;
+namespace {
 
 // The Matlab code to generate these |kLowpassCoeffs| is:
 //
@@ -94,12 +88,48 @@ void Downsample(const float* in,
   }
 }
 
-// Upsamples |in| into |out|, scaling by |kNumBands| and accumulating it every
-// |kNumBands| starting from |offset|. |split_length| is the |in| length. |out|
-// has to be at least |kNumBands| * |split_length| long.
+// Upsamples |in| into |out|, writing it every |kNumBands| starting from
+// |offset|. |split_length| is the |in| length. |out| has to be at least
+// |kNumBands| * |split_length| long.
 void Upsample(const float* in, size_t split_length, size_t offset, float* out) {
   for (size_t i = 0; i < split_length; ++i) {
-    out[kNumBands * i + offset] += kNumBands * in[i];
+    out[kNumBands * i + offset] = in[i];
+  }
+}
+
+// Moves the last |kMemorySize| samples of |buffer|, which holds |kMemorySize|
+// past samples followed by |split_length| current ones, to its beginning.
+void UpdateMemory(size_t split_length, float* buffer) {
+  memmove(buffer, &buffer[split_length], kMemorySize * sizeof(*buffer));
+}
+
+void FilterAndAccumulateC(const float* in,
+                          size_t split_length,
+                          size_t offset,
+                          const float* coeffs,
+                          const float* gains,
+                          size_t num_gains,
+                          float* const* out) {
+  for (size_t i = 0; i < split_length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < kNumCoeffs; ++j) {
+      sum += in[kMemorySize + i - offset - j * kSparsity] * coeffs[j];
+    }
+    for (size_t j = 0; j < num_gains; ++j) {
+      out[j][i] += gains[j] * sum;
+    }
+  }
+}
+
+void UpModulateC(const float* const* in,
+                 size_t split_length,
+                 const float* modulation,
+                 float* out) {
+  memset(out, 0, split_length * sizeof(*out));
+  for (size_t i = 0; i < kNumBands; ++i) {
+    for (size_t j = 0; j < split_length; ++j) {
+      out[j] += modulation[i] * in[i][j];
+    }
   }
 }
 
@@ -109,18 +139,14 @@ void Upsample(const float* in, size_t split_length, size_t offset, float* out) {
 // use a DCT to shift it in both directions at the same time, to the center
 // frequencies [1 / 12, 3 / 12, 5 / 12].
 ThreeBandFilterBank::ThreeBandFilterBank(size_t length)
-    : in_buffer_(rtc::CheckedDivExact(length, kNumBands)),
-      out_buffer_(in_buffer_.size()) {
-  for (size_t i = 0; i < kSparsity; ++i) {
-    for (size_t j = 0; j < kNumBands; ++j) {
-      analysis_filters_.push_back(
-          std::unique_ptr<SparseFIRFilter>(new SparseFIRFilter(
-              kLowpassCoeffs[i * kNumBands + j], kNumCoeffs, kSparsity, i)));
-      synthesis_filters_.push_back(
-          std::unique_ptr<SparseFIRFilter>(new SparseFIRFilter(
-              kLowpassCoeffs[i * kNumBands + j], kNumCoeffs, kSparsity, i)));
-    }
-  }
+    : analysis_buffers_(
+          kNumBands,
+          std::vector<float>(
+              kMemorySize + rtc::CheckedDivExact(length, kNumBands), 0.f)),
+      synthesis_buffers_(kNumBands * kSparsity, analysis_buffers_[0]),
+      out_buffer_(rtc::CheckedDivExact(length, kNumBands)),
+      filter_and_accumulate_(FilterAndAccumulateC),
+      up_modulate_(UpModulateC) {
   dct_modulation_.resize(kNumBands * kSparsity);
   for (size_t i = 0; i < dct_modulation_.size(); ++i) {
     dct_modulation_[i].resize(kNumBands);
@@ -129,6 +155,18 @@ ThreeBandFilterBank::ThreeBandFilterBank(size_t length)
           2.f * cos(2.f * M_PI * i * (2.f * j + 1.f) / dct_modulation_.size());
     }
   }
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    filter_and_accumulate_ = three_band_filter_bank::FilterAndAccumulateAVX2;
+    up_modulate_ = three_band_filter_bank::UpModulateAVX2;
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    filter_and_accumulate_ = three_band_filter_bank::FilterAndAccumulateSSE2;
+    up_modulate_ = three_band_filter_bank::UpModulateSSE2;
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  filter_and_accumulate_ = three_band_filter_bank::FilterAndAccumulateNEON;
+  up_modulate_ = three_band_filter_bank::UpModulateNEON;
+#endif
 }
 
 ThreeBandFilterBank::~ThreeBandFilterBank() = default;
@@ -139,22 +177,24 @@ ThreeBandFilterBank::~ThreeBandFilterBank() = default;
 //      decomposition of the low-pass prototype filter and upsampled by a factor
 //      of |kSparsity|.
 //   3. Modulating with cosines and accumulating to get the desired band.
+// Steps 2 and 3 are done in a single pass for each delayed signal.
 void ThreeBandFilterBank::Analysis(const float* in,
                                    size_t length,
                                    float* const* out) {
-  RTC_CHECK_EQ(in_buffer_.size(), rtc::CheckedDivExact(length, kNumBands));
+  const size_t split_length = out_buffer_.size();
+  RTC_CHECK_EQ(split_length, rtc::CheckedDivExact(length, kNumBands));
   for (size_t i = 0; i < kNumBands; ++i) {
-    memset(out[i], 0, in_buffer_.size() * sizeof(*out[i]));
+    memset(out[i], 0, split_length * sizeof(*out[i]));
   }
   for (size_t i = 0; i < kNumBands; ++i) {
-    Downsample(in, in_buffer_.size(), kNumBands - i - 1, &in_buffer_[0]);
+    float* buffer = &analysis_buffers_[i][0];
+    Downsample(in, split_length, kNumBands - i - 1, &buffer[kMemorySize]);
     for (size_t j = 0; j < kSparsity; ++j) {
       const size_t offset = i + j * kNumBands;
-      analysis_filters_[offset]->Filter(&in_buffer_[0],
-                                        in_buffer_.size(),
-                                        &out_buffer_[0]);
-      DownModulate(&out_buffer_[0], out_buffer_.size(), offset, out);
+      filter_and_accumulate_(buffer, split_length, j, kLowpassCoeffs[offset],
+                             &dct_modulation_[offset][0], kNumBands, out);
     }
+    UpdateMemory(split_length, buffer);
   }
 }
 
@@ -167,49 +207,21 @@ void ThreeBandFilterBank::Analysis(const float* in,
 void ThreeBandFilterBank::Synthesis(const float* const* in,
                                     size_t split_length,
                                     float* out) {
-  RTC_CHECK_EQ(in_buffer_.size(), split_length);
-  memset(out, 0, kNumBands * in_buffer_.size() * sizeof(*out));
+  RTC_CHECK_EQ(out_buffer_.size(), split_length);
+  const float kUpsamplingScaling = kNumBands;
+  float* const out_buffer = &out_buffer_[0];
   for (size_t i = 0; i < kNumBands; ++i) {
+    memset(out_buffer, 0, split_length * sizeof(*out_buffer));
     for (size_t j = 0; j < kSparsity; ++j) {
       const size_t offset = i + j * kNumBands;
-      UpModulate(in, in_buffer_.size(), offset, &in_buffer_[0]);
-      synthesis_filters_[offset]->Filter(&in_buffer_[0],
-                                         in_buffer_.size(),
-                                         &out_buffer_[0]);
-      Upsample(&out_buffer_[0], out_buffer_.size(), i, out);
-    }
-  }
-}
-
-
-// Modulates |in| by |dct_modulation_| and accumulates it in each of the
-// |kNumBands| bands of |out|. |offset| is the index in the period of the
-// cosines used for modulation. |split_length| is the length of |in| and each
-// band of |out|.
-void ThreeBandFilterBank::DownModulate(const float* in,
-                                       size_t split_length,
-                                       size_t offset,
-                                       float* const* out) {
-  for (size_t i = 0; i < kNumBands; ++i) {
-    for (size_t j = 0; j < split_length; ++j) {
-      out[i][j] += dct_modulation_[offset][i] * in[j];
-    }
-  }
-}
-
-// Modulates each of the |kNumBands| bands of |in| by |dct_modulation_| and
-// accumulates them in |out|. |out| is cleared before starting to accumulate.
-// |offset| is the index in the period of the cosines used for modulation.
-// |split_length| is the length of each band of |in| and |out|.
-void ThreeBandFilterBank::UpModulate(const float* const* in,
-                                     size_t split_length,
-                                     size_t offset,
-                                     float* out) {
-  memset(out, 0, split_length * sizeof(*out));
-  for (size_t i = 0; i < kNumBands; ++i) {
-    for (size_t j = 0; j < split_length; ++j) {
-      out[j] += dct_modulation_[offset][i] * in[i][j];
+      float* buffer = &synthesis_buffers_[offset][0];
+      up_modulate_(in, split_length, &dct_modulation_[offset][0],
+                   &buffer[kMemorySize]);
+      filter_and_accumulate_(buffer, split_length, j, kLowpassCoeffs[offset],
+                             &kUpsamplingScaling, 1, &out_buffer);
+      UpdateMemory(split_length, buffer);
     }
+    Upsample(out_buffer, split_length, i, out);
   }
 }
 
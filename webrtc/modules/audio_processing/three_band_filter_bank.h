@@ -12,10 +12,9 @@
 #define WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
 
 #include <cstring>
-#include <memory>
 #include <vector>
 
-#include "webrtc/common_audio/sparse_fir_filter.h"
+#include "webrtc/modules/audio_processing/three_band_filter_bank_internal.h"
 
 namespace webrtc {
 
@@ -48,20 +47,16 @@ class ThreeBandFilterBank final {
   void Synthesis(const float* const* in, size_t split_length, float* out);
 
  private:
-  void DownModulate(const float* in,
-                    size_t split_length,
-                    size_t offset,
-                    float* const* out);
-  void UpModulate(const float* const* in,
-                  size_t split_length,
-                  size_t offset,
-                  float* out);
-
-  std::vector<float> in_buffer_;
+  // The past |kMemorySize| input samples of each sparse filter are kept in
+  // front of the current samples, so that the filters run over contiguous
+  // memory. Analysis keeps one buffer per downsampled phase, synthesis one per
+  // modulated signal.
+  std::vector<std::vector<float>> analysis_buffers_;
+  std::vector<std::vector<float>> synthesis_buffers_;
   std::vector<float> out_buffer_;
-  std::vector<std::unique_ptr<SparseFIRFilter>> analysis_filters_;
-  std::vector<std::unique_ptr<SparseFIRFilter>> synthesis_filters_;
   std::vector<std::vector<float>> dct_modulation_;
+  three_band_filter_bank::FilterAndAccumulate filter_and_accumulate_;
+  three_band_filter_bank::UpModulate up_modulate_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// AVX2 and FMA3 versions of the three-band filter bank kernels. The fused
+// multiply-adds round differently than the C versions, so the output is not
+// bit-exact with them.
+
+#include <immintrin.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/audio_processing/three_band_filter_bank_internal.h"
+
+namespace webrtc {
+namespace three_band_filter_bank {
+
+void FilterAndAccumulateAVX2(const float* in,
+                             size_t split_length,
+                             size_t offset,
+                             const float* coeffs,
+                             const float* gains,
+                             size_t num_gains,
+                             float* const* out) {
+  RTC_DCHECK_LE(num_gains, kNumBands);
+  __m256 coeffs_ps[kNumCoeffs];
+  for (size_t j = 0; j < kNumCoeffs; ++j) {
+    coeffs_ps[j] = _mm256_set1_ps(coeffs[j]);
+  }
+  __m256 gains_ps[kNumBands];
+  for (size_t j = 0; j < num_gains; ++j) {
+    gains_ps[j] = _mm256_set1_ps(gains[j]);
+  }
+
+  // vectorized code (eight at once)
+  size_t i = 0;
+  for (; i + 7 < split_length; i += 8) {
+    __m256 sum = _mm256_setzero_ps();
+    for (size_t j = 0; j < kNumCoeffs; ++j) {
+      const __m256 in_ps =
+          _mm256_loadu_ps(&in[kMemorySize + i - offset - j * kSparsity]);
+      sum = _mm256_fmadd_ps(in_ps, coeffs_ps[j], sum);
+    }
+    for (size_t j = 0; j < num_gains; ++j) {
+      const __m256 out_ps = _mm256_loadu_ps(&out[j][i]);
+      _mm256_storeu_ps(&out[j][i], _mm256_fmadd_ps(gains_ps[j], sum, out_ps));
+    }
+  }
+  // scalar code for the remaining items.
+  for (; i < split_length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < kNumCoeffs; ++j) {
+      sum += in[kMemorySize + i - offset - j * kSparsity] * coeffs[j];
+    }
+    for (size_t j = 0; j < num_gains; ++j) {
+      out[j][i] += gains[j] * sum;
+    }
+  }
+}
+
+void UpModulateAVX2(const float* const* in,
+                    size_t split_length,
+                    const float* modulation,
+                    float* out) {
+  __m256 modulation_ps[kNumBands];
+  for (size_t j = 0; j < kNumBands; ++j) {
+    modulation_ps[j] = _mm256_set1_ps(modulation[j]);
+  }
+
+  // vectorized code (eight at once)
+  size_t i = 0;
+  for (; i + 7 < split_length; i += 8) {
+    __m256 sum = _mm256_setzero_ps();
+    for (size_t j = 0; j < kNumBands; ++j) {
+      sum = _mm256_fmadd_ps(modulation_ps[j], _mm256_loadu_ps(&in[j][i]), sum);
+    }
+    _mm256_storeu_ps(&out[i], sum);
+  }
+  // scalar code for the remaining items.
+  for (; i < split_length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < kNumBands; ++j) {
+      sum += modulation[j] * in[j][i];
+    }
+    out[i] = sum;
+  }
+}
+
+}  // namespace three_band_filter_bank
+}  // namespace webrtc
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_INTERNAL_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_INTERNAL_H_
+
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+namespace three_band_filter_bank {
+
+const size_t kNumBands = 3;
+const size_t kSparsity = 4;
+
+// Factors to take into account when choosing |kNumCoeffs|:
+//   1. Higher |kNumCoeffs|, means faster transition, which ensures less
+//      aliasing. This is especially important when there is non-linear
+//      processing between the splitting and merging.
+//   2. The delay that this filter bank introduces is
+//      |kNumBands| * |kSparsity| * |kNumCoeffs| / 2, so it increases linearly
+//      with |kNumCoeffs|.
+//   3. The computation complexity also increases linearly with |kNumCoeffs|.
+const size_t kNumCoeffs = 4;
+
+// Number of past samples the sparse filters need: |kSparsity| times the
+// |kNumCoeffs| - 1 taps of history plus the largest offset.
+const size_t kMemorySize = kSparsity * kNumCoeffs - 1;
+
+// Filters |in| with the |kNumCoeffs| |coeffs| of a sparse filter with
+// sparsity |kSparsity| and delayed by |offset| samples, and accumulates the
+// result scaled by each of the |num_gains| |gains| into the corresponding
+// band of |out|. |in| holds |kMemorySize| past samples followed by the
+// |split_length| current ones. Each band of |out| has |split_length| samples.
+typedef void (*FilterAndAccumulate)(const float* in,
+                                    size_t split_length,
+                                    size_t offset,
+                                    const float* coeffs,
+                                    const float* gains,
+                                    size_t num_gains,
+                                    float* const* out);
+
+// Modulates each of the |kNumBands| bands of |in| by the corresponding
+// |modulation| factor and writes their sum to |out|. |split_length| is the
+// length of each band of |in| and of |out|.
+typedef void (*UpModulate)(const float* const* in,
+                           size_t split_length,
+                           const float* modulation,
+                           float* out);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void FilterAndAccumulateSSE2(const float* in,
+                             size_t split_length,
+                             size_t offset,
+                             const float* coeffs,
+                             const float* gains,
+                             size_t num_gains,
+                             float* const* out);
+void UpModulateSSE2(const float* const* in,
+                    size_t split_length,
+                    const float* modulation,
+                    float* out);
+void FilterAndAccumulateAVX2(const float* in,
+                             size_t split_length,
+                             size_t offset,
+                             const float* coeffs,
+                             const float* gains,
+                             size_t num_gains,
+                             float* const* out);
+void UpModulateAVX2(const float* const* in,
+                    size_t split_length,
+                    const float* modulation,
+                    float* out);
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void FilterAndAccumulateNEON(const float* in,
+                             size_t split_length,
+                             size_t offset,
+                             const float* coeffs,
+                             const float* gains,
+                             size_t num_gains,
+                             float* const* out);
+void UpModulateNEON(const float* const* in,
+                    size_t split_length,
+                    const float* modulation,
+                    float* out);
+#endif
+
+}  // namespace three_band_filter_bank
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_INTERNAL_H_
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// NEON versions of the three-band filter bank kernels.
+
+#include <arm_neon.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/audio_processing/three_band_filter_bank_internal.h"
+
+namespace webrtc {
+namespace three_band_filter_bank {
+
+void FilterAndAccumulateNEON(const float* in,
+                             size_t split_length,
+                             size_t offset,
+                             const float* coeffs,
+                             const float* gains,
+                             size_t num_gains,
+                             float* const* out) {
+  RTC_DCHECK_LE(num_gains, kNumBands);
+  float32x4_t coeffs_ps[kNumCoeffs];
+  for (size_t j = 0; j < kNumCoeffs; ++j) {
+    coeffs_ps[j] = vdupq_n_f32(coeffs[j]);
+  }
+  float32x4_t gains_ps[kNumBands];
+  for (size_t j = 0; j < num_gains; ++j) {
+    gains_ps[j] = vdupq_n_f32(gains[j]);
+  }
+
+  // vectorized code (four at once)
+  size_t i = 0;
+  for (; i + 3 < split_length; i += 4) {
+    float32x4_t sum = vdupq_n_f32(0.f);
+    for (size_t j = 0; j < kNumCoeffs; ++j) {
+      const float32x4_t in_ps =
+          vld1q_f32(&in[kMemorySize + i - offset - j * kSparsity]);
+      sum = vmlaq_f32(sum, in_ps, coeffs_ps[j]);
+    }
+    for (size_t j = 0; j < num_gains; ++j) {
+      const float32x4_t out_ps = vld1q_f32(&out[j][i]);
+      vst1q_f32(&out[j][i], vmlaq_f32(out_ps, gains_ps[j], sum));
+    }
+  }
+  // scalar code for the remaining items.
+  for (; i < split_length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < kNumCoeffs; ++j) {
+      sum += in[kMemorySize + i - offset - j * kSparsity] * coeffs[j];
+    }
+    for (size_t j = 0; j < num_gains; ++j) {
+      out[j][i] += gains[j] * sum;
+    }
+  }
+}
+
+void UpModulateNEON(const float* const* in,
+                    size_t split_length,
+                    const float* modulation,
+                    float* out) {
+  float32x4_t modulation_ps[kNumBands];
+  for (size_t j = 0; j < kNumBands; ++j) {
+    modulation_ps[j] = vdupq_n_f32(modulation[j]);
+  }
+
+  // vectorized code (four at once)
+  size_t i = 0;
+  for (; i + 3 < split_length; i += 4) {
+    float32x4_t sum = vdupq_n_f32(0.f);
+    for (size_t j = 0; j < kNumBands; ++j) {
+      sum = vmlaq_f32(sum, modulation_ps[j], vld1q_f32(&in[j][i]));
+    }
+    vst1q_f32(&out[i], sum);
+  }
+  // scalar code for the remaining items.
+  for (; i < split_length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < kNumBands; ++j) {
+      sum += modulation[j] * in[j][i];
+    }
+    out[i] = sum;
+  }
+}
+
+}  // namespace three_band_filter_bank
+}  // namespace webrtc
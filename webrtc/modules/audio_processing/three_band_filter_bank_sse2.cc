@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// SSE2 versions of the three-band filter bank kernels. The operations are
+// done in the same order as in the C versions, so the output is bit-exact.
+
+#include <emmintrin.h>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/audio_processing/three_band_filter_bank_internal.h"
+
+namespace webrtc {
+namespace three_band_filter_bank {
+
+void FilterAndAccumulateSSE2(const float* in,
+                             size_t split_length,
+                             size_t offset,
+                             const float* coeffs,
+                             const float* gains,
+                             size_t num_gains,
+                             float* const* out) {
+  RTC_DCHECK_LE(num_gains, kNumBands);
+  __m128 coeffs_ps[kNumCoeffs];
+  for (size_t j = 0; j < kNumCoeffs; ++j) {
+    coeffs_ps[j] = _mm_set1_ps(coeffs[j]);
+  }
+  __m128 gains_ps[kNumBands];
+  for (size_t j = 0; j < num_gains; ++j) {
+    gains_ps[j] = _mm_set1_ps(gains[j]);
+  }
+
+  // vectorized code (four at once)
+  size_t i = 0;
+  for (; i + 3 < split_length; i += 4) {
+    __m128 sum = _mm_setzero_ps();
+    for (size_t j = 0; j < kNumCoeffs; ++j) {
+      const __m128 in_ps =
+          _mm_loadu_ps(&in[kMemorySize + i - offset - j * kSparsity]);
+      sum = _mm_add_ps(sum, _mm_mul_ps(in_ps, coeffs_ps[j]));
+    }
+    for (size_t j = 0; j < num_gains; ++j) {
+      const __m128 out_ps = _mm_loadu_ps(&out[j][i]);
+      _mm_storeu_ps(&out[j][i],
+                    _mm_add_ps(out_ps, _mm_mul_ps(gains_ps[j], sum)));
+    }
+  }
+  // scalar code for the remaining items.
+  for (; i < split_length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < kNumCoeffs; ++j) {
+      sum += in[kMemorySize + i - offset - j * kSparsity] * coeffs[j];
+    }
+    for (size_t j = 0; j < num_gains; ++j) {
+      out[j][i] += gains[j] * sum;
+    }
+  }
+}
+
+void UpModulateSSE2(const float* const* in,
+                    size_t split_length,
+                    const float* modulation,
+                    float* out) {
+  __m128 modulation_ps[kNumBands];
+  for (size_t j = 0; j < kNumBands; ++j) {
+    modulation_ps[j] = _mm_set1_ps(modulation[j]);
+  }
+
+  // vectorized code (four at once)
+  size_t i = 0;
+  for (; i + 3 < split_length; i += 4) {
+    __m128 sum = _mm_setzero_ps();
+    for (size_t j = 0; j < kNumBands; ++j) {
+      sum = _mm_add_ps(sum,
+                       _mm_mul_ps(modulation_ps[j], _mm_loadu_ps(&in[j][i])));
+    }
+    _mm_storeu_ps(&out[i], sum);
+  }
+  // scalar code for the remaining items.
+  for (; i < split_length; ++i) {
+    float sum = 0.f;
+    for (size_t j = 0; j < kNumBands; ++j) {
+      sum += modulation[j] * in[j][i];
+    }
+    out[i] = sum;
+  }
+}
+
+}  // namespace three_band_filter_bank
+}  // namespace webrtc
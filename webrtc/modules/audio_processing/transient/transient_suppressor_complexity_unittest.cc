@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/random.h"
+#include "webrtc/modules/audio_processing/transient/common.h"
+#include "webrtc/modules/audio_processing/transient/transient_detector.h"
+#include "webrtc/modules/audio_processing/transient/transient_suppressor.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kNumFramesToProcess = 500;
+// A key is pressed every |kKeyPressPeriodFrames| chunks, which keeps both the
+// detection and the suppression enabled.
+const size_t kKeyPressPeriodFrames = 20;
+
+class PerformanceTimer {
+ public:
+  PerformanceTimer() : clock_(webrtc::Clock::GetRealTimeClock()) {
+    durations_us_.reserve(kNumFramesToProcess);
+  }
+
+  void StartTimer() { start_timestamp_us_ = clock_->TimeInMicroseconds(); }
+  void StopTimer() {
+    durations_us_.push_back(clock_->TimeInMicroseconds() -
+                            start_timestamp_us_);
+  }
+
+  std::string FormPerformanceMeasureString() const {
+    RTC_DCHECK(!durations_us_.empty());
+    const double average =
+        static_cast<double>(std::accumulate(durations_us_.begin(),
+                                            durations_us_.end(), int64_t{0})) /
+        durations_us_.size();
+    double variance = 0.0;
+    for (int64_t duration : durations_us_) {
+      variance += (duration - average) * (duration - average);
+    }
+    variance /= durations_us_.size();
+    return std::to_string(average) + ", " + std::to_string(sqrt(variance));
+  }
+
+ private:
+  webrtc::Clock* clock_;
+  int64_t start_timestamp_us_ = 0;
+  std::vector<int64_t> durations_us_;
+};
+
+// Fills |data| with int16 ranged noise, with a click at the start of the
+// chunks where a key is pressed.
+void GenerateChunk(bool key_pressed, Random* rand_gen, float* data,
+                   size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    data[i] = 300.f * (rand_gen->Rand<float>() - 0.5f);
+  }
+  if (key_pressed) {
+    for (size_t i = 0; i < length / 10; ++i) {
+      data[i] += 20000.f * (rand_gen->Rand<float>() - 0.5f);
+    }
+  }
+}
+
+std::string FormTestDescription(int sample_rate_hz, int num_channels) {
+  return "_" + std::to_string(sample_rate_hz) + "Hz_" +
+         std::to_string(num_channels) + "_channels";
+}
+
+void RunTransientDetector(int sample_rate_hz) {
+  const size_t chunk_length =
+      static_cast<size_t>(sample_rate_hz * ts::kChunkSizeMs / 1000);
+  Random rand_gen(42);
+  std::vector<float> data(chunk_length);
+  PerformanceTimer timer;
+
+  TransientDetector detector(sample_rate_hz);
+  for (size_t frame_no = 0; frame_no < kNumFramesToProcess; ++frame_no) {
+    GenerateChunk(frame_no % kKeyPressPeriodFrames == 0, &rand_gen, &data[0],
+                  chunk_length);
+
+    timer.StartTimer();
+    detector.Detect(&data[0], chunk_length, nullptr, 0);
+    timer.StopTimer();
+  }
+  webrtc::test::PrintResultMeanAndError(
+      "transient_suppressor_call_durations",
+      FormTestDescription(sample_rate_hz, 1), "TransientDetector",
+      timer.FormPerformanceMeasureString(), "us", false);
+}
+
+void RunTransientSuppressor(int sample_rate_hz, int num_channels) {
+  const int detection_rate_hz =
+      std::min<int>(sample_rate_hz, ts::kSampleRate16kHz);
+  const size_t chunk_length =
+      static_cast<size_t>(sample_rate_hz * ts::kChunkSizeMs / 1000);
+  const size_t detection_length =
+      static_cast<size_t>(detection_rate_hz * ts::kChunkSizeMs / 1000);
+  Random rand_gen(42);
+  std::vector<float> data(chunk_length * num_channels);
+  std::vector<float> detection_data(detection_length);
+  PerformanceTimer timer;
+
+  TransientSuppressor suppressor;
+  ASSERT_EQ(0, suppressor.Initialize(sample_rate_hz, detection_rate_hz,
+                                     num_channels));
+  for (size_t frame_no = 0; frame_no < kNumFramesToProcess; ++frame_no) {
+    const bool key_pressed = frame_no % kKeyPressPeriodFrames == 0;
+    GenerateChunk(key_pressed, &rand_gen, &data[0], data.size());
+    GenerateChunk(key_pressed, &rand_gen, &detection_data[0],
+                  detection_length);
+
+    timer.StartTimer();
+    ASSERT_EQ(0, suppressor.Suppress(&data[0], chunk_length, num_channels,
+                                     &detection_data[0], detection_length,
+                                     nullptr, 0, 1.f, key_pressed));
+    timer.StopTimer();
+  }
+  webrtc::test::PrintResultMeanAndError(
+      "transient_suppressor_call_durations",
+      FormTestDescription(sample_rate_hz, num_channels), "TransientSuppressor",
+      timer.FormPerformanceMeasureString(), "us", false);
+}
+
+}  // namespace
+
+TEST(TransientSuppressorPerformanceTest, StandaloneDetection) {
+  const int kSampleRatesToTest[] = {ts::kSampleRate8kHz, ts::kSampleRate16kHz,
+                                    ts::kSampleRate32kHz,
+                                    ts::kSampleRate48kHz};
+  for (int sample_rate_hz : kSampleRatesToTest) {
+    RunTransientDetector(sample_rate_hz);
+  }
+}
+
+TEST(TransientSuppressorPerformanceTest, StandaloneSuppression) {
+  const int kSampleRatesToTest[] = {ts::kSampleRate8kHz, ts::kSampleRate16kHz,
+                                    ts::kSampleRate32kHz,
+                                    ts::kSampleRate48kHz};
+  for (int sample_rate_hz : kSampleRatesToTest) {
+    for (int num_channels = 1; num_channels <= 2; ++num_channels) {
+      RunTransientSuppressor(sample_rate_hz, num_channels);
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -24,7 +24,9 @@ WPDNode::WPDNode(size_t length,
                  size_t coefficients_length)
     : // The data buffer has parent data length to be able to contain and filter
       // it.
-      data_(new float[2 * length + 1]),
+      owned_data_(new float[2 * length + 1]),
+      data_(owned_data_.get()),
+      filter_buffer_(owned_data_.get()),
       length_(length),
       filter_(FIRFilter::Create(coefficients,
                                 coefficients_length,
@@ -32,7 +34,26 @@ WPDNode::WPDNode(size_t length,
   RTC_DCHECK_GT(length, 0u);
   RTC_DCHECK(coefficients);
   RTC_DCHECK_GT(coefficients_length, 0u);
-  memset(data_.get(), 0.f, (2 * length + 1) * sizeof(data_[0]));
+  memset(data_, 0.f, (2 * length + 1) * sizeof(data_[0]));
+}
+
+WPDNode::WPDNode(size_t length,
+                 const float* coefficients,
+                 size_t coefficients_length,
+                 float* data,
+                 float* filter_buffer)
+    : data_(data),
+      filter_buffer_(filter_buffer),
+      length_(length),
+      filter_(FIRFilter::Create(coefficients,
+                                coefficients_length,
+                                2 * length + 1)) {
+  RTC_DCHECK_GT(length, 0u);
+  RTC_DCHECK(coefficients);
+  RTC_DCHECK_GT(coefficients_length, 0u);
+  RTC_DCHECK(data);
+  RTC_DCHECK(filter_buffer);
+  memset(data_, 0.f, length * sizeof(data_[0]));
 }
 
 WPDNode::~WPDNode() {}
@@ -43,12 +64,12 @@ int WPDNode::Update(const float* parent_data, size_t parent_data_length) {
   }
 
   // Filter data.
-  filter_->Filter(parent_data, parent_data_length, data_.get());
+  filter_->Filter(parent_data, parent_data_length, filter_buffer_);
 
   // Decimate data.
   const bool kOddSequence = true;
   size_t output_samples = DyadicDecimate(
-      data_.get(), parent_data_length, kOddSequence, data_.get(), length_);
+      filter_buffer_, parent_data_length, kOddSequence, data_, length_);
   if (output_samples != length_) {
     return -1;
   }
@@ -65,7 +86,7 @@ int WPDNode::set_data(const float* new_data, size_t length) {
   if (!new_data || length != length_) {
     return -1;
   }
-  memcpy(data_.get(), new_data, length * sizeof(data_[0]));
+  memcpy(data_, new_data, length * sizeof(data_[0]));
   return 0;
 }
 
@@ -25,19 +25,33 @@ class WPDNode {
   // Creates a WPDNode. The data vector will contain zeros. The filter will have
   // the coefficients provided.
   WPDNode(size_t length, const float* coefficients, size_t coefficients_length);
+  // Creates a WPDNode which uses external storage instead of allocating its
+  // own. |data| must have room for |length| values and |filter_buffer| for
+  // 2 * |length| values. Both must outlive the node, and |filter_buffer| can
+  // be shared between nodes which are not updated concurrently.
+  WPDNode(size_t length,
+          const float* coefficients,
+          size_t coefficients_length,
+          float* data,
+          float* filter_buffer);
   ~WPDNode();
 
   // Updates the node data. |parent_data| / 2 must be equals to |length_|.
   // Returns 0 if correct, and -1 otherwise.
   int Update(const float* parent_data, size_t parent_data_length);
 
-  const float* data() const { return data_.get(); }
+  const float* data() const { return data_; }
   // Returns 0 if correct, and -1 otherwise.
   int set_data(const float* new_data, size_t length);
   size_t length() const { return length_; }
 
  private:
-  std::unique_ptr<float[]> data_;
+  // Only allocated if no external storage is provided.
+  std::unique_ptr<float[]> owned_data_;
+  float* data_;
+  // Holds the filtered parent data before decimation. Points to |data_| when
+  // the node owns its storage.
+  float* filter_buffer_;
   size_t length_;
   std::unique_ptr<FIRFilter> filter_;
 };
@@ -29,13 +29,21 @@ WPDTree::WPDTree(size_t data_length, const float* high_pass_coefficients,
   RTC_DCHECK(high_pass_coefficients);
   RTC_DCHECK(low_pass_coefficients);
   RTC_DCHECK_GT(levels, 0);
+  // Each level holds at most |data_length| values, and so does the filtering
+  // buffer, since the filtered data has the length of the parent.
+  nodes_data_.reset(new float[(levels + 2) * data_length]);
+  float* const filter_buffer = &nodes_data_[(levels + 1) * data_length];
+  float* next_node_data = nodes_data_.get();
+
   // Size is 1 more, so we can use the array as 1-based. nodes_[0] is never
   // allocated.
   nodes_.reset(new std::unique_ptr<WPDNode>[num_nodes_ + 1]);
 
   // Create the first node
   const float kRootCoefficient = 1.f;  // Identity Coefficient.
-  nodes_[1].reset(new WPDNode(data_length, &kRootCoefficient, 1));
+  nodes_[1].reset(new WPDNode(data_length, &kRootCoefficient, 1,
+                              next_node_data, filter_buffer));
+  next_node_data += data_length;
   // Variables used to create the rest of the nodes.
   size_t index = 1;
   size_t index_left_child = 0;
@@ -52,12 +60,15 @@ WPDTree::WPDTree(size_t data_length, const float* high_pass_coefficients,
       // Obtain the index of the current node children.
       index_left_child = index * 2;
       index_right_child = index_left_child + 1;
-      nodes_[index_left_child].reset(new WPDNode(nodes_[index]->length() / 2,
-                                                 low_pass_coefficients,
-                                                 coefficients_length));
-      nodes_[index_right_child].reset(new WPDNode(nodes_[index]->length() / 2,
-                                                  high_pass_coefficients,
-                                                  coefficients_length));
+      const size_t child_length = nodes_[index]->length() / 2;
+      nodes_[index_left_child].reset(
+          new WPDNode(child_length, low_pass_coefficients, coefficients_length,
+                      next_node_data, filter_buffer));
+      next_node_data += child_length;
+      nodes_[index_right_child].reset(
+          new WPDNode(child_length, high_pass_coefficients, coefficients_length,
+                      next_node_data, filter_buffer));
+      next_node_data += child_length;
     }
   }
 }
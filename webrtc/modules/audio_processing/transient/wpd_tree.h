@@ -36,6 +36,9 @@ namespace webrtc {
 // Left Child: Current node index * 2.
 // Right Child: Current node index * 2 + 1.
 // Parent: Current Node Index / 2 (Integer division).
+// The data of all the nodes is kept in a single preallocated buffer, level
+// after level, so the nodes of each level (and in particular the leaves) are
+// contiguous in memory. The nodes share a single filtering buffer too.
 class WPDTree {
  public:
   // Creates a WPD tree using the data length and coefficients provided.
@@ -84,6 +87,8 @@ class WPDTree {
   size_t data_length_;
   int levels_;
   int num_nodes_;
+  // Storage for the data of all the nodes, followed by the filtering buffer.
+  std::unique_ptr<float[]> nodes_data_;
   std::unique_ptr<std::unique_ptr<WPDNode>[]> nodes_;
 };
 
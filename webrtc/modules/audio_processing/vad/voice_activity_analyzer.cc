@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/vad/voice_activity_analyzer.h"
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+namespace {
+
+const int kMaxVoiceProbabilitySampleRateHz = 32000;
+
+// The same mapping as in VoiceDetectionImpl.
+int VadMode(VoiceDetection::Likelihood likelihood) {
+  switch (likelihood) {
+    case VoiceDetection::kVeryLowLikelihood:
+      return 3;
+    case VoiceDetection::kLowLikelihood:
+      return 2;
+    case VoiceDetection::kModerateLikelihood:
+      return 1;
+    case VoiceDetection::kHighLikelihood:
+      return 0;
+  }
+  RTC_NOTREACHED();
+  return 2;
+}
+
+}  // namespace
+
+VoiceActivityAnalyzer::VoiceActivityAnalyzer(const Config& config)
+    : config_(config),
+      frame_length_(static_cast<size_t>(config.sample_rate_hz / 100)),
+      vad_(WebRtcVad_Create()) {
+  RTC_CHECK(vad_);
+  RTC_CHECK_EQ(0, WebRtcVad_ValidRateAndFrameLength(config_.sample_rate_hz,
+                                                    frame_length_));
+  RTC_CHECK(!config_.estimate_voice_probability ||
+            config_.sample_rate_hz <= kMaxVoiceProbabilitySampleRateHz);
+  Reset();
+}
+
+VoiceActivityAnalyzer::~VoiceActivityAnalyzer() {
+  WebRtcVad_Free(vad_);
+}
+
+void VoiceActivityAnalyzer::Reset() {
+  int error = WebRtcVad_Init(vad_);
+  RTC_DCHECK_EQ(0, error);
+  error = WebRtcVad_set_mode(vad_, VadMode(config_.likelihood));
+  RTC_DCHECK_EQ(0, error);
+  rms_.Reset();
+  if (config_.estimate_voice_probability) {
+    voice_activity_detector_.reset(new VoiceActivityDetector());
+  }
+}
+
+VoiceActivityAnalyzer::Analysis VoiceActivityAnalyzer::AnalyzeFrame(
+    rtc::ArrayView<const int16_t> frame) {
+  RTC_DCHECK_EQ(frame_length_, frame.size());
+  Analysis analysis;
+  analysis.has_voice = DetectVoice(frame.data());
+  analysis.level = EstimateLevel(frame.data());
+  if (voice_activity_detector_) {
+    analysis.voice_probability = EstimateVoiceProbability(frame.data());
+  }
+  return analysis;
+}
+
+void VoiceActivityAnalyzer::AnalyzeFrames(
+    rtc::ArrayView<VoiceActivityAnalyzer* const> analyzers,
+    rtc::ArrayView<const int16_t* const> frames,
+    rtc::ArrayView<Analysis> analyses) {
+  RTC_DCHECK_EQ(analyzers.size(), frames.size());
+  RTC_DCHECK_EQ(analyzers.size(), analyses.size());
+  for (size_t i = 0; i < analyzers.size(); ++i) {
+    analyses[i].has_voice = analyzers[i]->DetectVoice(frames[i]);
+  }
+  for (size_t i = 0; i < analyzers.size(); ++i) {
+    analyses[i].level = analyzers[i]->EstimateLevel(frames[i]);
+  }
+  for (size_t i = 0; i < analyzers.size(); ++i) {
+    analyses[i].voice_probability =
+        analyzers[i]->voice_activity_detector_
+            ? analyzers[i]->EstimateVoiceProbability(frames[i])
+            : 0.f;
+  }
+}
+
+bool VoiceActivityAnalyzer::DetectVoice(const int16_t* frame) {
+  const int vad_ret = WebRtcVad_Process(vad_, config_.sample_rate_hz, frame,
+                                        frame_length_);
+  RTC_DCHECK(vad_ret == 0 || vad_ret == 1);
+  return vad_ret == 1;
+}
+
+int VoiceActivityAnalyzer::EstimateLevel(const int16_t* frame) {
+  rms_.Process(frame, frame_length_);
+  return rms_.RMS();
+}
+
+float VoiceActivityAnalyzer::EstimateVoiceProbability(const int16_t* frame) {
+  voice_activity_detector_->ProcessChunk(frame, frame_length_,
+                                         config_.sample_rate_hz);
+  return voice_activity_detector_->last_voice_probability();
+}
+
+}  // namespace webrtc
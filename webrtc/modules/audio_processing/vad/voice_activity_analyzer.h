@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_VAD_VOICE_ACTIVITY_ANALYZER_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_VAD_VOICE_ACTIVITY_ANALYZER_H_
+
+#include <memory>
+
+#include "webrtc/base/array_view.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/common_audio/vad/include/webrtc_vad.h"
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/modules/audio_processing/rms_level.h"
+#include "webrtc/modules/audio_processing/vad/voice_activity_detector.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Analysis-only alternative to an AudioProcessing instance with only
+// VoiceDetection and LevelEstimator enabled, for servers that only need the
+// voice activity and speech level of each incoming stream, e.g. for active
+// speaker detection. Decoded mono int16 frames of 10 ms are analyzed at their
+// native sample rate directly, without band splitting or AudioBuffer copies.
+class VoiceActivityAnalyzer {
+ public:
+  struct Config {
+    // One of 8000, 16000, 32000 and 48000 Hz.
+    int sample_rate_hz = 16000;
+    VoiceDetection::Likelihood likelihood = VoiceDetection::kLowLikelihood;
+    // Also runs the considerably more expensive VoiceActivityDetector to get a
+    // voice probability. Only supported up to 32000 Hz.
+    bool estimate_voice_probability = false;
+  };
+
+  struct Analysis {
+    // The WebRtcVad decision for the frame.
+    bool has_voice = false;
+    // The RMS level of the frame as returned by RMSLevel::RMS(), i.e. the
+    // negated level in dBFS, in [0, 127].
+    int level = RMSLevel::kMinLevel;
+    // VoiceActivityDetector::last_voice_probability(), which lags a few
+    // frames. Only set if |estimate_voice_probability| is enabled.
+    float voice_probability = 0.f;
+  };
+
+  explicit VoiceActivityAnalyzer(const Config& config);
+  ~VoiceActivityAnalyzer();
+
+  // Restores the state of a newly created analyzer.
+  void Reset();
+
+  // Analyzes one frame of |frame_length()| samples.
+  Analysis AnalyzeFrame(rtc::ArrayView<const int16_t> frame);
+
+  // Analyzes |frames[i]| with |analyzers[i]| into |analyses[i]| for each
+  // stream. The analyzers may have different configurations. Each analysis
+  // step is run over all streams before the next one, so that its code and
+  // tables stay in cache.
+  static void AnalyzeFrames(
+      rtc::ArrayView<VoiceActivityAnalyzer* const> analyzers,
+      rtc::ArrayView<const int16_t* const> frames,
+      rtc::ArrayView<Analysis> analyses);
+
+  int sample_rate_hz() const { return config_.sample_rate_hz; }
+  size_t frame_length() const { return frame_length_; }
+
+ private:
+  bool DetectVoice(const int16_t* frame);
+  int EstimateLevel(const int16_t* frame);
+  float EstimateVoiceProbability(const int16_t* frame);
+
+  const Config config_;
+  const size_t frame_length_;
+  VadInst* vad_;
+  RMSLevel rms_;
+  std::unique_ptr<VoiceActivityDetector> voice_activity_detector_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VoiceActivityAnalyzer);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_VAD_VOICE_ACTIVITY_ANALYZER_H_
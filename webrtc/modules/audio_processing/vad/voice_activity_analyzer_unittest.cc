@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// MSVC++ requires this to be set before any other includes to get M_PI.
+#define _USE_MATH_DEFINES
+
+#include "webrtc/modules/audio_processing/vad/voice_activity_analyzer.h"
+
+#include <math.h>
+
+#include <memory>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/arraysize.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kNumFrames = 300;
+
+// Generates frames of noise with bursts of a harmonic signal, which is loud
+// enough to be detected as voice.
+void GenerateFrame(size_t frame_no,
+                   int sample_rate_hz,
+                   unsigned int* seed,
+                   rtc::ArrayView<int16_t> frame) {
+  const bool burst = (frame_no / 50) % 2 == 1;
+  for (size_t i = 0; i < frame.size(); ++i) {
+    *seed = *seed * 1103515245 + 12345;
+    float sample = static_cast<float>((*seed >> 16) & 0x3FF) - 512.f;
+    if (burst) {
+      const float t =
+          static_cast<float>(frame_no * frame.size() + i) / sample_rate_hz;
+      for (int harmonic = 1; harmonic <= 5; ++harmonic) {
+        sample += 4000.f / harmonic * sinf(2.f * M_PI * 150.f * harmonic * t);
+      }
+    }
+    frame[i] = static_cast<int16_t>(sample);
+  }
+}
+
+}  // namespace
+
+TEST(VoiceActivityAnalyzerTest, SilenceHasNoVoiceAndMinimumLevel) {
+  VoiceActivityAnalyzer::Config config;
+  VoiceActivityAnalyzer analyzer(config);
+  std::vector<int16_t> frame(analyzer.frame_length(), 0);
+  for (size_t frame_no = 0; frame_no < 10; ++frame_no) {
+    VoiceActivityAnalyzer::Analysis analysis = analyzer.AnalyzeFrame(frame);
+    EXPECT_FALSE(analysis.has_voice);
+    EXPECT_EQ(static_cast<int>(RMSLevel::kMinLevel), analysis.level);
+  }
+}
+
+// With a 16 kHz mono stream, AudioProcessing does not split the bands and
+// its VoiceDetection and LevelEstimator see the same data as the analyzer.
+TEST(VoiceActivityAnalyzerTest, MatchesAudioProcessing) {
+  const int kSampleRateHz = 16000;
+  VoiceActivityAnalyzer::Config config;
+  config.sample_rate_hz = kSampleRateHz;
+  config.likelihood = VoiceDetection::kModerateLikelihood;
+  VoiceActivityAnalyzer analyzer(config);
+
+  std::unique_ptr<AudioProcessing> apm(AudioProcessing::Create());
+  ASSERT_EQ(AudioProcessing::kNoError, apm->voice_detection()->Enable(true));
+  ASSERT_EQ(AudioProcessing::kNoError, apm->voice_detection()->set_likelihood(
+                                           config.likelihood));
+  ASSERT_EQ(AudioProcessing::kNoError, apm->level_estimator()->Enable(true));
+
+  AudioFrame frame;
+  frame.sample_rate_hz_ = kSampleRateHz;
+  frame.num_channels_ = 1;
+  frame.samples_per_channel_ = analyzer.frame_length();
+  unsigned int seed = 1;
+  size_t num_voice_frames = 0;
+  for (size_t frame_no = 0; frame_no < kNumFrames; ++frame_no) {
+    rtc::ArrayView<int16_t> data(frame.data_, frame.samples_per_channel_);
+    GenerateFrame(frame_no, kSampleRateHz, &seed, data);
+    VoiceActivityAnalyzer::Analysis analysis = analyzer.AnalyzeFrame(data);
+    ASSERT_EQ(AudioProcessing::kNoError, apm->ProcessStream(&frame));
+    EXPECT_EQ(apm->voice_detection()->stream_has_voice(), analysis.has_voice);
+    EXPECT_EQ(apm->level_estimator()->RMS(), analysis.level);
+    num_voice_frames += analysis.has_voice ? 1 : 0;
+  }
+  EXPECT_GT(num_voice_frames, kNumFrames / 4);
+  EXPECT_LT(num_voice_frames, 3 * kNumFrames / 4);
+}
+
+TEST(VoiceActivityAnalyzerTest, BatchMatchesSingleStreams) {
+  const int kSampleRatesHz[] = {8000, 16000, 32000, 48000};
+  const size_t kNumStreams = arraysize(kSampleRatesHz);
+  std::vector<std::unique_ptr<VoiceActivityAnalyzer>> single;
+  std::vector<std::unique_ptr<VoiceActivityAnalyzer>> batch;
+  std::vector<VoiceActivityAnalyzer*> batch_ptrs;
+  for (int sample_rate_hz : kSampleRatesHz) {
+    VoiceActivityAnalyzer::Config config;
+    config.sample_rate_hz = sample_rate_hz;
+    config.estimate_voice_probability = sample_rate_hz <= 32000;
+    single.emplace_back(new VoiceActivityAnalyzer(config));
+    batch.emplace_back(new VoiceActivityAnalyzer(config));
+    batch_ptrs.push_back(batch.back().get());
+  }
+
+  std::vector<std::vector<int16_t>> frames(kNumStreams);
+  std::vector<const int16_t*> frame_ptrs(kNumStreams);
+  std::vector<unsigned int> seeds(kNumStreams, 1);
+  std::vector<VoiceActivityAnalyzer::Analysis> analyses(kNumStreams);
+  for (size_t frame_no = 0; frame_no < kNumFrames; ++frame_no) {
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      frames[i].resize(single[i]->frame_length());
+      GenerateFrame(frame_no, kSampleRatesHz[i], &seeds[i], frames[i]);
+      frame_ptrs[i] = frames[i].data();
+    }
+    VoiceActivityAnalyzer::AnalyzeFrames(batch_ptrs, frame_ptrs, analyses);
+    for (size_t i = 0; i < kNumStreams; ++i) {
+      VoiceActivityAnalyzer::Analysis expected =
+          single[i]->AnalyzeFrame(frames[i]);
+      EXPECT_EQ(expected.has_voice, analyses[i].has_voice);
+      EXPECT_EQ(expected.level, analyses[i].level);
+      EXPECT_EQ(expected.voice_probability, analyses[i].voice_probability);
+    }
+  }
+}
+
+TEST(VoiceActivityAnalyzerTest, ResetRestoresInitialState) {
+  VoiceActivityAnalyzer::Config config;
+  config.estimate_voice_probability = true;
+  VoiceActivityAnalyzer analyzer(config);
+  std::vector<int16_t> frame(analyzer.frame_length());
+  std::vector<VoiceActivityAnalyzer::Analysis> first;
+  for (int pass = 0; pass < 2; ++pass) {
+    unsigned int seed = 1;
+    for (size_t frame_no = 0; frame_no < kNumFrames; ++frame_no) {
+      GenerateFrame(frame_no, config.sample_rate_hz, &seed, frame);
+      VoiceActivityAnalyzer::Analysis analysis = analyzer.AnalyzeFrame(frame);
+      if (pass == 0) {
+        first.push_back(analysis);
+      } else {
+        EXPECT_EQ(first[frame_no].has_voice, analysis.has_voice);
+        EXPECT_EQ(first[frame_no].level, analysis.level);
+        EXPECT_EQ(first[frame_no].voice_probability,
+                  analysis.voice_probability);
+      }
+    }
+    analyzer.Reset();
+  }
+}
+
+}  // namespace webrtc
@@ -329,6 +329,7 @@ int64_t CongestionController::TimeUntilNextProcess() {
 void CongestionController::Process() {
   bitrate_controller_->Process();
   remote_bitrate_estimator_->Process();
+  probe_controller_->Process();
   MaybeTriggerOnNetworkChanged();
 }
 
@@ -347,6 +348,7 @@ void CongestionController::MaybeTriggerOnNetworkChanged() {
     pacer_->SetEstimatedBitrate(bitrate_bps);
     probe_controller_->SetEstimatedBitrate(bitrate_bps);
     retransmission_rate_limiter_->SetMaxRate(bitrate_bps);
+    remote_estimator_proxy_.OnBitrateChanged(bitrate_bps);
   }
 
   bitrate_bps = IsNetworkDown() || IsSendQueueFull() ? 0 : bitrate_bps;
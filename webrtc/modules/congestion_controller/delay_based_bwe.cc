@@ -63,87 +63,96 @@ void DelayBasedBwe::IncomingPacketFeedbackVector(
                               BweNames::kBweNamesMax);
     uma_recorded_ = true;
   }
-  for (const auto& packet_info : packet_feedback_vector) {
-    IncomingPacketInfo(packet_info);
-  }
-}
-
-void DelayBasedBwe::IncomingPacketInfo(const PacketInfo& info) {
+  // The whole feedback vector is processed under one lock, and only the last
+  // estimate change is reported; the earlier ones would be superseded anyway.
   int64_t now_ms = clock_->TimeInMilliseconds();
-
-  incoming_bitrate_.Update(info.payload_size, info.arrival_time_ms);
   bool delay_based_bwe_changed = false;
   uint32_t target_bitrate_bps = 0;
   {
     rtc::CritScope lock(&crit_);
-
-    // Reset if the stream has timed out.
-    if (last_seen_packet_ms_ == -1 ||
-        now_ms - last_seen_packet_ms_ > kStreamTimeOutMs) {
-      inter_arrival_.reset(new InterArrival(
-          (kTimestampGroupLengthMs << kInterArrivalShift) / 1000,
-          kTimestampToMs, true));
-      estimator_.reset(new OveruseEstimator(OverUseDetectorOptions()));
-    }
-    last_seen_packet_ms_ = now_ms;
-
-    uint32_t send_time_24bits =
-        static_cast<uint32_t>(((static_cast<uint64_t>(info.send_time_ms)
-                                << kAbsSendTimeFraction) +
-                               500) /
-                              1000) &
-        0x00FFFFFF;
-    // Shift up send time to use the full 32 bits that inter_arrival works with,
-    // so wrapping works properly.
-    uint32_t timestamp = send_time_24bits << kAbsSendTimeInterArrivalUpshift;
-
-    uint32_t ts_delta = 0;
-    int64_t t_delta = 0;
-    int size_delta = 0;
-    if (inter_arrival_->ComputeDeltas(timestamp, info.arrival_time_ms, now_ms,
-                                      info.payload_size, &ts_delta, &t_delta,
-                                      &size_delta)) {
-      double ts_delta_ms = (1000.0 * ts_delta) / (1 << kInterArrivalShift);
-      estimator_->Update(t_delta, ts_delta_ms, size_delta, detector_.State(),
-                         info.arrival_time_ms);
-      detector_.Detect(estimator_->offset(), ts_delta_ms,
-                       estimator_->num_of_deltas(), info.arrival_time_ms);
+    for (const auto& packet_info : packet_feedback_vector) {
+      uint32_t packet_target_bitrate_bps = 0;
+      if (IncomingPacketInfo(packet_info, now_ms,
+                             &packet_target_bitrate_bps)) {
+        delay_based_bwe_changed = true;
+        target_bitrate_bps = packet_target_bitrate_bps;
+      }
     }
+  }
+  if (delay_based_bwe_changed)
+    observer_->OnReceiveBitrateChanged({kFixedSsrc}, target_bitrate_bps);
+}
 
-    int probing_bps = 0;
-    if (info.probe_cluster_id != PacketInfo::kNotAProbe) {
-      probing_bps =
-          probe_bitrate_estimator_.HandleProbeAndEstimateBitrate(info);
-    }
+bool DelayBasedBwe::IncomingPacketInfo(const PacketInfo& info,
+                                       int64_t now_ms,
+                                       uint32_t* target_bitrate_bps) {
+  incoming_bitrate_.Update(info.payload_size, info.arrival_time_ms);
+  bool delay_based_bwe_changed = false;
 
-    // Currently overusing the bandwidth.
-    if (detector_.State() == kBwOverusing) {
-      rtc::Optional<uint32_t> incoming_rate =
-          incoming_bitrate_.Rate(info.arrival_time_ms);
-      if (incoming_rate &&
-          remote_rate_.TimeToReduceFurther(now_ms, *incoming_rate)) {
-        delay_based_bwe_changed =
-            UpdateEstimate(info.arrival_time_ms, now_ms, &target_bitrate_bps);
-      }
-    } else if (probing_bps > 0) {
-      // No overuse, but probing measured a bitrate.
-      remote_rate_.SetEstimate(probing_bps, info.arrival_time_ms);
-      observer_->OnProbeBitrate(probing_bps);
-      delay_based_bwe_changed =
-          UpdateEstimate(info.arrival_time_ms, now_ms, &target_bitrate_bps);
-    }
-    if (!delay_based_bwe_changed &&
-        (last_update_ms_ == -1 ||
-         now_ms - last_update_ms_ > remote_rate_.GetFeedbackInterval())) {
+  // Reset if the stream has timed out.
+  if (last_seen_packet_ms_ == -1 ||
+      now_ms - last_seen_packet_ms_ > kStreamTimeOutMs) {
+    inter_arrival_.reset(new InterArrival(
+        (kTimestampGroupLengthMs << kInterArrivalShift) / 1000,
+        kTimestampToMs, true));
+    estimator_.reset(new OveruseEstimator(OverUseDetectorOptions()));
+  }
+  last_seen_packet_ms_ = now_ms;
+
+  uint32_t send_time_24bits =
+      static_cast<uint32_t>(((static_cast<uint64_t>(info.send_time_ms)
+                              << kAbsSendTimeFraction) +
+                             500) /
+                            1000) &
+      0x00FFFFFF;
+  // Shift up send time to use the full 32 bits that inter_arrival works with,
+  // so wrapping works properly.
+  uint32_t timestamp = send_time_24bits << kAbsSendTimeInterArrivalUpshift;
+
+  uint32_t ts_delta = 0;
+  int64_t t_delta = 0;
+  int size_delta = 0;
+  if (inter_arrival_->ComputeDeltas(timestamp, info.arrival_time_ms, now_ms,
+                                    info.payload_size, &ts_delta, &t_delta,
+                                    &size_delta)) {
+    double ts_delta_ms = (1000.0 * ts_delta) / (1 << kInterArrivalShift);
+    estimator_->Update(t_delta, ts_delta_ms, size_delta, detector_.State(),
+                       info.arrival_time_ms);
+    detector_.Detect(estimator_->offset(), ts_delta_ms,
+                     estimator_->num_of_deltas(), info.arrival_time_ms);
+  }
+
+  int probing_bps = 0;
+  if (info.probe_cluster_id != PacketInfo::kNotAProbe) {
+    probing_bps = probe_bitrate_estimator_.HandleProbeAndEstimateBitrate(info);
+  }
+
+  // Currently overusing the bandwidth.
+  if (detector_.State() == kBwOverusing) {
+    rtc::Optional<uint32_t> incoming_rate =
+        incoming_bitrate_.Rate(info.arrival_time_ms);
+    if (incoming_rate &&
+        remote_rate_.TimeToReduceFurther(now_ms, *incoming_rate)) {
       delay_based_bwe_changed =
-          UpdateEstimate(info.arrival_time_ms, now_ms, &target_bitrate_bps);
+          UpdateEstimate(info.arrival_time_ms, now_ms, target_bitrate_bps);
     }
+  } else if (probing_bps > 0) {
+    // No overuse, but probing measured a bitrate.
+    remote_rate_.SetEstimate(probing_bps, info.arrival_time_ms);
+    observer_->OnProbeBitrate(probing_bps);
+    delay_based_bwe_changed =
+        UpdateEstimate(info.arrival_time_ms, now_ms, target_bitrate_bps);
+  }
+  if (!delay_based_bwe_changed &&
+      (last_update_ms_ == -1 ||
+       now_ms - last_update_ms_ > remote_rate_.GetFeedbackInterval())) {
+    delay_based_bwe_changed =
+        UpdateEstimate(info.arrival_time_ms, now_ms, target_bitrate_bps);
   }
 
-  if (delay_based_bwe_changed) {
+  if (delay_based_bwe_changed)
     last_update_ms_ = now_ms;
-    observer_->OnReceiveBitrateChanged({kFixedSsrc}, target_bitrate_bps);
-  }
+  return delay_based_bwe_changed;
 }
 
 bool DelayBasedBwe::UpdateEstimate(int64_t arrival_time_ms,
@@ -56,7 +56,11 @@ class DelayBasedBwe : public RemoteBitrateEstimator {
   }
 
  private:
-  void IncomingPacketInfo(const PacketInfo& info);
+  // Returns true and sets |target_bitrate_bps| if the estimate was updated.
+  bool IncomingPacketInfo(const PacketInfo& info,
+                          int64_t now_ms,
+                          uint32_t* target_bitrate_bps)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
   // Updates the current remote rate estimate and returns true if a valid
   // estimate exists.
   bool UpdateEstimate(int64_t packet_arrival_time_ms,
@@ -10,6 +10,8 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/pacing/paced_sender.h"
 #include "webrtc/modules/congestion_controller/delay_based_bwe.h"
 #include "webrtc/modules/congestion_controller/delay_based_bwe_unittest_helper.h"
@@ -181,4 +183,31 @@ TEST_F(DelayBasedBweTest, TestLongTimeoutAndWrap) {
   // properly timed out.
   TestWrappingHelper(10 * 64);
 }
+
+// Feeds back 100 packets at a time, as for a 1 Mbps stream every 100 ms.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(DelayBasedBweTest, DISABLED_FeedbackVectorThroughput) {
+  const int kNumFeedbacks = 20000;
+  const int kPacketsPerFeedback = 100;
+  uint16_t seq_num = 0;
+  int64_t send_time_ms = 0;
+  int64_t elapsed_ns = 0;
+  std::vector<PacketInfo> packets;
+  for (int i = 0; i < kNumFeedbacks; ++i) {
+    packets.clear();
+    for (int j = 0; j < kPacketsPerFeedback; ++j) {
+      send_time_ms += 1;
+      // Some jitter on the way.
+      packets.push_back(PacketInfo(send_time_ms + 50 + j % 3, send_time_ms,
+                                   seq_num++, 1200, PacketInfo::kNotAProbe));
+    }
+    clock_.AdvanceTimeMilliseconds(kPacketsPerFeedback);
+    int64_t start_ns = rtc::TimeNanos();
+    bitrate_estimator_->IncomingPacketFeedbackVector(packets);
+    elapsed_ns += rtc::TimeNanos() - start_ns;
+  }
+  LOG(LS_INFO) << "Processed " << kNumFeedbacks << " feedback vectors: "
+               << elapsed_ns / (kNumFeedbacks * kPacketsPerFeedback)
+               << " ns/packet.";
+}
 }  // namespace webrtc
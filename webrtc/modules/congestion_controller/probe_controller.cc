@@ -10,9 +10,11 @@
 
 #include "webrtc/modules/congestion_controller/probe_controller.h"
 
+#include <algorithm>
 #include <initializer_list>
 
 #include "webrtc/base/logging.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
@@ -31,6 +33,9 @@ constexpr int64_t kMaxWaitingTimeForProbingResultMs = 1000;
 // further probing is disabled.
 constexpr int kExponentialProbingDisabled = 0;
 
+// Interval between probes sent while the sender is application-limited.
+constexpr int64_t kAlrPeriodicProbingIntervalMs = 5000;
+
 }  // namespace
 
 ProbeController::ProbeController(PacedSender* pacer, Clock* clock)
@@ -40,7 +45,10 @@ ProbeController::ProbeController(PacedSender* pacer, Clock* clock)
       min_bitrate_to_probe_further_bps_(kExponentialProbingDisabled),
       time_last_probing_initiated_ms_(0),
       estimated_bitrate_bps_(0),
-      max_bitrate_bps_(0) {}
+      max_bitrate_bps_(0),
+      enable_periodic_alr_probing_(
+          field_trial::FindFullName("WebRTC-PeriodicAlrProbing") ==
+          "Enabled") {}
 
 void ProbeController::SetBitrates(int min_bitrate_bps,
                                   int start_bitrate_bps,
@@ -92,6 +100,39 @@ void ProbeController::SetEstimatedBitrate(int bitrate_bps) {
   estimated_bitrate_bps_ = bitrate_bps;
 }
 
+void ProbeController::EnablePeriodicAlrProbing(bool enable) {
+  rtc::CritScope cs(&critsect_);
+  enable_periodic_alr_probing_ = enable;
+}
+
+void ProbeController::Process() {
+  rtc::CritScope cs(&critsect_);
+  if (!enable_periodic_alr_probing_ || state_ != State::kProbingComplete ||
+      estimated_bitrate_bps_ == 0 ||
+      estimated_bitrate_bps_ >= max_bitrate_bps_) {
+    return;
+  }
+
+  rtc::Optional<int64_t> alr_start_time_ms =
+      pacer_->GetApplicationLimitedRegionStartTime();
+  if (!alr_start_time_ms)
+    return;
+
+  // Probe once the sender has been application-limited for a while, and then
+  // at regular intervals for as long as it stays that way.
+  int64_t next_probe_time_ms =
+      std::max(*alr_start_time_ms, time_last_probing_initiated_ms_) +
+      kAlrPeriodicProbingIntervalMs;
+  if (clock_->TimeInMilliseconds() >= next_probe_time_ms) {
+    LOG(LS_INFO) << "Probing in application-limited region at "
+                 << estimated_bitrate_bps_ << " bps estimate.";
+    // As when probing further on startup, double the estimate and expect a
+    // minimum of 25% gain to continue probing.
+    InitiateProbing({std::min(2 * estimated_bitrate_bps_, max_bitrate_bps_)},
+                    1.25 * estimated_bitrate_bps_);
+  }
+}
+
 void ProbeController::InitiateProbing(
     std::initializer_list<int> bitrates_to_probe,
     int min_bitrate_to_probe_further_bps) {
@@ -23,7 +23,9 @@ class Clock;
 
 // This class controls initiation of probing to estimate initial channel
 // capacity. There is also support for probing during a session when max
-// bitrate is adjusted by an application.
+// bitrate is adjusted by an application, and periodically while the sender is
+// application-limited, so that the estimate can follow the channel even when
+// little media is sent.
 class ProbeController {
  public:
   ProbeController(PacedSender* pacer, Clock* clock);
@@ -33,6 +35,14 @@ class ProbeController {
                    int max_bitrate_bps);
   void SetEstimatedBitrate(int bitrate_bps);
 
+  // Enables probing every few seconds while the pacer reports that the sender
+  // is application-limited. Disabled by default, unless the
+  // "WebRTC-PeriodicAlrProbing" field trial is enabled.
+  void EnablePeriodicAlrProbing(bool enable);
+
+  // Initiates periodic probes when they are due. Should be called regularly.
+  void Process();
+
  private:
   void InitiateProbing(std::initializer_list<int> bitrates_to_probe,
                        int min_bitrate_to_probe_further_bps)
@@ -53,6 +63,7 @@ class ProbeController {
   int64_t time_last_probing_initiated_ms_ GUARDED_BY(critsect_);
   int estimated_bitrate_bps_ GUARDED_BY(critsect_);
   int max_bitrate_bps_ GUARDED_BY(critsect_);
+  bool enable_periodic_alr_probing_ GUARDED_BY(critsect_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(ProbeController);
 };
@@ -19,6 +19,7 @@
 using testing::_;
 using testing::AtLeast;
 using testing::NiceMock;
+using testing::Return;
 
 namespace webrtc {
 namespace test {
@@ -31,6 +32,8 @@ constexpr int kMaxBitrateBps = 1000;
 
 constexpr int kExponentialProbingTimeoutMs = 5000;
 
+constexpr int kAlrProbeInterval = 5000;
+
 }  // namespace
 
 class ProbeControllerTest : public ::testing::Test {
@@ -81,5 +84,53 @@ TEST_F(ProbeControllerTest, TestExponentialProbingTimeout) {
   probe_controller_->SetEstimatedBitrate(1800);
 }
 
+TEST_F(ProbeControllerTest, PeriodicProbingInAlr) {
+  probe_controller_->EnablePeriodicAlrProbing(true);
+  probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
+                                 kMaxBitrateBps);
+  // Long enough to time out exponential probing.
+  clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
+  probe_controller_->SetEstimatedBitrate(400);
+
+  int64_t alr_start_time = clock_.TimeInMilliseconds();
+  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
+      .WillRepeatedly(Return(rtc::Optional<int64_t>(alr_start_time)));
+
+  // No probe until the sender has been application-limited for a while.
+  EXPECT_CALL(pacer_, CreateProbeCluster(_, _)).Times(0);
+  clock_.AdvanceTimeMilliseconds(kAlrProbeInterval - 1);
+  probe_controller_->Process();
+  testing::Mock::VerifyAndClearExpectations(&pacer_);
+
+  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
+      .WillRepeatedly(Return(rtc::Optional<int64_t>(alr_start_time)));
+  EXPECT_CALL(pacer_, CreateProbeCluster(2 * 400, _));
+  clock_.AdvanceTimeMilliseconds(1);
+  probe_controller_->Process();
+  testing::Mock::VerifyAndClearExpectations(&pacer_);
+
+  // The next probe is sent one interval later, capped at the max bitrate.
+  clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
+  probe_controller_->SetEstimatedBitrate(600);
+  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
+      .WillRepeatedly(Return(rtc::Optional<int64_t>(alr_start_time)));
+  EXPECT_CALL(pacer_, CreateProbeCluster(kMaxBitrateBps, _));
+  probe_controller_->Process();
+}
+
+TEST_F(ProbeControllerTest, NoPeriodicProbingOutsideAlr) {
+  probe_controller_->EnablePeriodicAlrProbing(true);
+  probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
+                                 kMaxBitrateBps);
+  clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
+  probe_controller_->SetEstimatedBitrate(400);
+
+  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
+      .WillRepeatedly(Return(rtc::Optional<int64_t>()));
+  EXPECT_CALL(pacer_, CreateProbeCluster(_, _)).Times(0);
+  clock_.AdvanceTimeMilliseconds(2 * kAlrProbeInterval);
+  probe_controller_->Process();
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -18,6 +18,14 @@
 
 namespace webrtc {
 
+namespace {
+
+// Aligns the rows of frames whose width is a multiple of 16 to 64 bytes, for
+// SIMD.
+const size_t kBufferAlignment = 64;
+
+}  // namespace
+
 DesktopFrame::DesktopFrame(DesktopSize size,
                            int stride,
                            uint8_t* data,
@@ -58,14 +66,16 @@ uint8_t* DesktopFrame::GetFrameDataAtPos(const DesktopVector& pos) const {
 }
 
 BasicDesktopFrame::BasicDesktopFrame(DesktopSize size)
-    : DesktopFrame(size, kBytesPerPixel * size.width(),
-                   new uint8_t[kBytesPerPixel * size.width() * size.height()],
-                   NULL) {
-}
+    : BasicDesktopFrame(
+          size,
+          HugePageMalloc(kBytesPerPixel * size.width() * size.height(),
+                         kBufferAlignment)) {}
 
-BasicDesktopFrame::~BasicDesktopFrame() {
-  delete[] data_;
-}
+BasicDesktopFrame::BasicDesktopFrame(DesktopSize size, HugePageBuffer buffer)
+    : DesktopFrame(size, kBytesPerPixel * size.width(), buffer.get(), NULL),
+      buffer_(std::move(buffer)) {}
+
+BasicDesktopFrame::~BasicDesktopFrame() {}
 
 DesktopFrame* BasicDesktopFrame::CopyOf(const DesktopFrame& frame) {
   DesktopFrame* result = new BasicDesktopFrame(frame.size());
@@ -17,6 +17,7 @@
 #include "webrtc/modules/desktop_capture/desktop_geometry.h"
 #include "webrtc/modules/desktop_capture/desktop_region.h"
 #include "webrtc/modules/desktop_capture/shared_memory.h"
+#include "webrtc/system_wrappers/include/huge_page_malloc.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -94,6 +95,8 @@ class DesktopFrame {
 // A DesktopFrame that stores data in the heap.
 class BasicDesktopFrame : public DesktopFrame {
  public:
+  // Large frames are backed by huge pages when enabled, see
+  // SetHugePageMode().
   explicit BasicDesktopFrame(DesktopSize size);
   ~BasicDesktopFrame() override;
 
@@ -101,6 +104,10 @@ class BasicDesktopFrame : public DesktopFrame {
   static DesktopFrame* CopyOf(const DesktopFrame& frame);
 
  private:
+  BasicDesktopFrame(DesktopSize size, HugePageBuffer buffer);
+
+  const HugePageBuffer buffer_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(BasicDesktopFrame);
 };
 
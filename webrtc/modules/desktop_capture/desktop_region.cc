@@ -13,6 +13,7 @@
 #include <assert.h>
 
 #include <algorithm>
+#include <limits>
 
 namespace webrtc {
 
@@ -145,8 +146,81 @@ void DesktopRegion::AddRect(const DesktopRect& rect) {
 }
 
 void DesktopRegion::AddRects(const DesktopRect* rects, int count) {
+  if (count == 1) {
+    AddRect(rects[0]);
+    return;
+  }
+
+  if (rows_.empty()) {
+    AddRectsToEmptyRegion(rects, count);
+    return;
+  }
+
+  DesktopRegion region;
+  region.AddRectsToEmptyRegion(rects, count);
+  AddRegion(region);
+}
+
+void DesktopRegion::AddRectsToEmptyRegion(const DesktopRect* rects,
+                                          int count) {
+  assert(rows_.empty());
+
+  // Sweep the rectangles from top to bottom. Every pair of consecutive
+  // horizontal edges bounds a row, whose spans are the union of the rectangles
+  // crossing it. Rows are generated in order, so they are appended to |rows_|.
+  std::vector<const DesktopRect*> sorted_rects;
+  std::vector<int32_t> edges;
+  sorted_rects.reserve(count);
+  edges.reserve(2 * count);
   for (int i = 0; i < count; ++i) {
-    AddRect(rects[i]);
+    if (rects[i].is_empty())
+      continue;
+    sorted_rects.push_back(&rects[i]);
+    edges.push_back(rects[i].top());
+    edges.push_back(rects[i].bottom());
+  }
+  std::sort(sorted_rects.begin(), sorted_rects.end(),
+            [](const DesktopRect* a, const DesktopRect* b) {
+              return a->top() < b->top();
+            });
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  // Rectangles crossing the current row.
+  std::vector<const DesktopRect*> active_rects;
+  size_t next_rect = 0;
+  for (size_t i = 0; i + 1 < edges.size(); ++i) {
+    int32_t top = edges[i];
+    int32_t bottom = edges[i + 1];
+
+    active_rects.erase(
+        std::remove_if(active_rects.begin(), active_rects.end(),
+                       [top](const DesktopRect* rect) {
+                         return rect->bottom() <= top;
+                       }),
+        active_rects.end());
+    while (next_rect < sorted_rects.size() &&
+           sorted_rects[next_rect]->top() <= top) {
+      active_rects.push_back(sorted_rects[next_rect++]);
+    }
+    if (active_rects.empty())
+      continue;
+
+    std::sort(active_rects.begin(), active_rects.end(),
+              [](const DesktopRect* a, const DesktopRect* b) {
+                return a->left() < b->left();
+              });
+    Rows::iterator row = rows_.insert(
+        rows_.end(), Rows::value_type(bottom, new Row(top, bottom)));
+    RowSpanSet* spans = &row->second->spans;
+    for (const DesktopRect* rect : active_rects) {
+      if (!spans->empty() && rect->left() <= spans->back().right) {
+        spans->back().right = std::max(spans->back().right, rect->right());
+      } else {
+        spans->push_back(RowSpan(rect->left(), rect->right()));
+      }
+    }
+    MergeWithPrecedingRow(row);
   }
 }
 
@@ -169,10 +243,106 @@ void DesktopRegion::MergeWithPrecedingRow(Rows::iterator row) {
 }
 
 void DesktopRegion::AddRegion(const DesktopRegion& region) {
-  // TODO(sergeyu): This function is not optimized - potentially it can iterate
-  // over rows of the two regions similar to how it works in Intersect().
-  for (Iterator it(region); !it.IsAtEnd(); it.Advance()) {
-    AddRect(it.rect());
+  if (region.rows_.empty())
+    return;
+
+  if (rows_.empty()) {
+    *this = region;
+    return;
+  }
+
+  DesktopRegion old_region;
+  Swap(&old_region);
+  Union(old_region, region);
+}
+
+void DesktopRegion::Union(const DesktopRegion& region1,
+                          const DesktopRegion& region2) {
+  Clear();
+
+  Rows::const_iterator it1 = region1.rows_.begin();
+  Rows::const_iterator end1 = region1.rows_.end();
+  Rows::const_iterator it2 = region2.rows_.begin();
+  Rows::const_iterator end2 = region2.rows_.end();
+
+  // Bottom of the last row added to the union. Rows of each region don't
+  // overlap, so the part of a row above |top| has already been added.
+  int32_t top = std::numeric_limits<int32_t>::min();
+
+  while (it1 != end1 && it2 != end2) {
+    const Row* row1 = it1->second;
+    const Row* row2 = it2->second;
+    int32_t top1 = std::max(row1->top, top);
+    int32_t top2 = std::max(row2->top, top);
+
+    Rows::iterator new_row;
+    if (top1 < top2) {
+      // Only |row1| covers the range above |row2|.
+      int32_t bottom = std::min(row1->bottom, top2);
+      new_row = rows_.insert(
+          rows_.end(), Rows::value_type(bottom, new Row(top1, bottom)));
+      new_row->second->spans = row1->spans;
+    } else if (top2 < top1) {
+      // Only |row2| covers the range above |row1|.
+      int32_t bottom = std::min(row2->bottom, top1);
+      new_row = rows_.insert(
+          rows_.end(), Rows::value_type(bottom, new Row(top2, bottom)));
+      new_row->second->spans = row2->spans;
+    } else {
+      int32_t bottom = std::min(row1->bottom, row2->bottom);
+      new_row = rows_.insert(
+          rows_.end(), Rows::value_type(bottom, new Row(top1, bottom)));
+      UnionRows(row1->spans, row2->spans, &new_row->second->spans);
+    }
+    MergeWithPrecedingRow(new_row);
+    top = new_row->second->bottom;
+
+    // Move to the next row of regions that have been consumed up to |top|.
+    if (row1->bottom <= top)
+      ++it1;
+    if (row2->bottom <= top)
+      ++it2;
+  }
+
+  // Copy the remaining rows of the region that extends further down.
+  if (it1 == end1) {
+    it1 = it2;
+    end1 = end2;
+  }
+  for (; it1 != end1; ++it1) {
+    const Row* row = it1->second;
+    int32_t row_top = std::max(row->top, top);
+    Rows::iterator new_row = rows_.insert(
+        rows_.end(),
+        Rows::value_type(row->bottom, new Row(row_top, row->bottom)));
+    new_row->second->spans = row->spans;
+    MergeWithPrecedingRow(new_row);
+  }
+}
+
+// static
+void DesktopRegion::UnionRows(const RowSpanSet& set1,
+                              const RowSpanSet& set2,
+                              RowSpanSet* output) {
+  RowSpanSet::const_iterator it1 = set1.begin();
+  RowSpanSet::const_iterator it2 = set2.begin();
+  output->reserve(set1.size() + set2.size());
+
+  while (it1 != set1.end() || it2 != set2.end()) {
+    // Take the left-most of the remaining spans and coalesce it with the last
+    // output span if they touch or overlap.
+    const RowSpan* span;
+    if (it2 == set2.end() || (it1 != set1.end() && it1->left <= it2->left)) {
+      span = &*it1++;
+    } else {
+      span = &*it2++;
+    }
+
+    if (!output->empty() && span->left <= output->back().right) {
+      output->back().right = std::max(output->back().right, span->right);
+    } else {
+      output->push_back(*span);
+    }
   }
 }
 
@@ -145,6 +145,18 @@ class DesktopRegion {
   // Returns true if the |span| exists in the given |row|.
   static bool IsSpanInRow(const Row& row, const RowSpan& rect);
 
+  // Adds |rects| to the region, which must be empty. All the rows are built in
+  // a single sweep, instead of being split and merged for every rectangle.
+  void AddRectsToEmptyRegion(const DesktopRect* rects, int count);
+
+  // Finds union of two regions and stores it in the current region.
+  void Union(const DesktopRegion& region1, const DesktopRegion& region2);
+
+  // Calculates the union of two sets of spans.
+  static void UnionRows(const RowSpanSet& set1,
+                        const RowSpanSet& set2,
+                        RowSpanSet* output);
+
   // Calculates the intersection of two sets of spans.
   static void IntersectRows(const RowSpanSet& set1,
                             const RowSpanSet& set2,
@@ -11,8 +11,10 @@
 #include "webrtc/modules/desktop_capture/desktop_region.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/timeutils.h"
 
 namespace webrtc {
 
@@ -686,6 +688,58 @@ TEST(DesktopRegionTest, SubtractRectOnSameCol) {
   }
 }
 
+// Verify that regions built in bulk match the ones built from single rects.
+TEST(DesktopRegionTest, AddRectsMatchesAddRect) {
+  const int kRectCounts[] = {2, 10, 100, 1000};
+  for (int count : kRectCounts) {
+    SCOPED_TRACE(count);
+    std::vector<DesktopRect> rects;
+    for (int i = 0; i < count; ++i) {
+      rects.push_back(DesktopRect::MakeXYWH(
+          RadmonInt(1000), RadmonInt(1000), RadmonInt(100), RadmonInt(100)));
+    }
+
+    DesktopRegion expected;
+    for (const DesktopRect& rect : rects)
+      expected.AddRect(rect);
+
+    DesktopRegion r(rects.data(), count);
+    EXPECT_TRUE(r.Equals(expected));
+
+    // Adding to a non-empty region.
+    r.Clear();
+    r.AddRects(rects.data(), count / 2);
+    r.AddRects(rects.data() + count / 2, count - count / 2);
+    EXPECT_TRUE(r.Equals(expected));
+  }
+}
+
+// Verify that AddRegion() matches adding the rects of the region one by one.
+TEST(DesktopRegionTest, AddRegionMatchesAddRect) {
+  for (int c = 0; c < 100; ++c) {
+    SCOPED_TRACE(c);
+    DesktopRegion r1;
+    DesktopRegion r2;
+    for (int i = 0; i < 20; ++i) {
+      r1.AddRect(DesktopRect::MakeXYWH(
+          RadmonInt(200), RadmonInt(200), RadmonInt(50), RadmonInt(50)));
+      r2.AddRect(DesktopRect::MakeXYWH(
+          RadmonInt(200), RadmonInt(200), RadmonInt(50), RadmonInt(50)));
+    }
+
+    DesktopRegion expected(r1);
+    for (DesktopRegion::Iterator it(r2); !it.IsAtEnd(); it.Advance())
+      expected.AddRect(it.rect());
+
+    DesktopRegion r(r1);
+    r.AddRegion(r2);
+    EXPECT_TRUE(r.Equals(expected));
+
+    r = r2;
+    r.AddRegion(r1);
+    EXPECT_TRUE(r.Equals(expected));
+  }
+}
 
 TEST(DesktopRegionTest, DISABLED_Performance) {
   for (int c = 0; c < 1000; ++c) {
@@ -707,4 +761,43 @@ TEST(DesktopRegionTest, DISABLED_Performance) {
   }
 }
 
+// Compares building regions of many small dirty rects one rect at a time with
+// building them in bulk.
+TEST(DesktopRegionTest, DISABLED_AddRectsPerformance) {
+  const int kNumRegions = 100;
+  const int kNumRects = 2000;
+  std::vector<DesktopRect> rects;
+  for (int i = 0; i < kNumRects; ++i) {
+    rects.push_back(DesktopRect::MakeXYWH(
+        RadmonInt(3840), RadmonInt(2160), 16 + RadmonInt(4) * 16,
+        16 + RadmonInt(4) * 16));
+  }
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int c = 0; c < kNumRegions; ++c) {
+    DesktopRegion r;
+    for (const DesktopRect& rect : rects)
+      r.AddRect(rect);
+  }
+  printf("AddRect: average run time = %d us / region\n",
+         static_cast<int>((rtc::TimeMicros() - start_us) / kNumRegions));
+
+  start_us = rtc::TimeMicros();
+  for (int c = 0; c < kNumRegions; ++c) {
+    DesktopRegion r(rects.data(), kNumRects);
+  }
+  printf("AddRects: average run time = %d us / region\n",
+         static_cast<int>((rtc::TimeMicros() - start_us) / kNumRegions));
+
+  DesktopRegion r1(rects.data(), kNumRects / 2);
+  DesktopRegion r2(rects.data() + kNumRects / 2, kNumRects / 2);
+  start_us = rtc::TimeMicros();
+  for (int c = 0; c < kNumRegions; ++c) {
+    DesktopRegion r(r1);
+    r.AddRegion(r2);
+  }
+  printf("AddRegion: average run time = %d us / region\n",
+         static_cast<int>((rtc::TimeMicros() - start_us) / kNumRegions));
+}
+
 }  // namespace webrtc
@@ -12,12 +12,29 @@
 
 #include "string.h"
 
+#include <algorithm>
+
+#include "webrtc/base/event.h"
 #include "webrtc/modules/desktop_capture/differ_block.h"
 #include "webrtc/system_wrappers/include/logging.h"
 
 namespace webrtc {
 
-Differ::Differ(int width, int height, int bpp, int stride) {
+namespace {
+
+// Upper bound on the number of threads diffing a frame.
+const int kMaxDifferThreads = 4;
+
+// Frames are only split into bands of at least this many block rows, so that
+// small frames aren't slowed down by the thread hops.
+const int kMinBlockRowsPerBand = 8;
+
+}  // namespace
+
+Differ::Differ(int width, int height, int bpp, int stride)
+    : Differ(width, height, bpp, stride, 1) {}
+
+Differ::Differ(int width, int height, int bpp, int stride, int num_threads) {
   // Dimensions of screen.
   width_ = width;
   height_ = height;
@@ -30,6 +47,13 @@ Differ::Differ(int width, int height, int bpp, int stride) {
   diff_info_height_ = ((height_ + kBlockSize - 1) / kBlockSize) + 1;
   diff_info_size_ = diff_info_width_ * diff_info_height_ * sizeof(bool);
   diff_info_.reset(new bool[diff_info_size_]);
+
+  const int block_rows = (height_ + kBlockSize - 1) / kBlockSize;
+  const int num_bands =
+      std::max(1, std::min(std::min(num_threads, kMaxDifferThreads),
+                           block_rows / kMinBlockRowsPerBand));
+  for (int i = 1; i < num_bands; ++i)
+    band_queues_.emplace_back(new rtc::TaskQueue("DifferQueue"));
 }
 
 Differ::~Differ() {}
@@ -49,6 +73,36 @@ void Differ::MarkDirtyBlocks(const uint8_t* prev_buffer,
                              const uint8_t* curr_buffer) {
   memset(diff_info_.get(), 0, diff_info_size_);
 
+  // The last block row may be a partial row.
+  const int block_rows = (height_ + kBlockSize - 1) / kBlockSize;
+  if (band_queues_.empty()) {
+    MarkDirtyBlockRows(prev_buffer, curr_buffer, 0, block_rows);
+    return;
+  }
+
+  const int num_bands = static_cast<int>(band_queues_.size()) + 1;
+  std::vector<std::unique_ptr<rtc::Event>> done_events;
+  for (int i = 1; i < num_bands; ++i) {
+    const int block_row_start = block_rows * i / num_bands;
+    const int block_row_end = block_rows * (i + 1) / num_bands;
+    rtc::Event* done = new rtc::Event(false, false);
+    done_events.emplace_back(done);
+    band_queues_[i - 1]->PostTask(
+        [this, prev_buffer, curr_buffer, block_row_start, block_row_end, done] {
+          MarkDirtyBlockRows(prev_buffer, curr_buffer, block_row_start,
+                             block_row_end);
+          done->Set();
+        });
+  }
+  MarkDirtyBlockRows(prev_buffer, curr_buffer, 0, block_rows / num_bands);
+  for (const auto& done : done_events)
+    done->Wait(rtc::Event::kForever);
+}
+
+void Differ::MarkDirtyBlockRows(const uint8_t* prev_buffer,
+                                const uint8_t* curr_buffer,
+                                int block_row_start,
+                                int block_row_end) {
   // Calc number of full blocks.
   int x_full_blocks = width_ / kBlockSize;
   int y_full_blocks = height_ / kBlockSize;
@@ -60,23 +114,38 @@ void Differ::MarkDirtyBlocks(const uint8_t* prev_buffer,
   // Offset from the start of one block-column to the next.
   int block_x_offset = bytes_per_pixel_ * kBlockSize;
   // Offset from the start of one block-row to the next.
-  int block_y_stride = (width_ * bytes_per_pixel_) * kBlockSize;
+  int block_y_stride = bytes_per_row_ * kBlockSize;
   // Offset from the start of one diff_info row to the next.
   int diff_info_stride = diff_info_width_ * sizeof(bool);
 
-  const uint8_t* prev_block_row_start = prev_buffer;
-  const uint8_t* curr_block_row_start = curr_buffer;
-  bool* diff_info_row_start = diff_info_.get();
+  const uint8_t* prev_block_row_start =
+      prev_buffer + block_row_start * block_y_stride;
+  const uint8_t* curr_block_row_start =
+      curr_buffer + block_row_start * block_y_stride;
+  bool* diff_info_row_start =
+      diff_info_.get() + block_row_start * diff_info_stride;
 
-  for (int y = 0; y < y_full_blocks; y++) {
+  for (int y = block_row_start; y < block_row_end; y++) {
     const uint8_t* prev_block = prev_block_row_start;
     const uint8_t* curr_block = curr_block_row_start;
     bool* diff_info = diff_info_row_start;
 
+    // If the screen height is not a multiple of the block size, then the last
+    // row is a partial row. This situation is far more common than the
+    // 'partial column' case.
+    const int block_height = y < y_full_blocks ? kBlockSize
+                                               : partial_row_height;
+
     for (int x = 0; x < x_full_blocks; x++) {
       // Mark this block as being modified so that it gets incorporated into
       // a dirty rect.
-      *diff_info = BlockDifference(prev_block, curr_block, bytes_per_row_);
+      if (block_height == kBlockSize) {
+        *diff_info = BlockDifference(prev_block, curr_block, bytes_per_row_);
+      } else {
+        *diff_info = !PartialBlocksEqual(prev_block, curr_block,
+                                         bytes_per_row_,
+                                         kBlockSize, block_height);
+      }
       prev_block += block_x_offset;
       curr_block += block_x_offset;
       diff_info += sizeof(bool);
@@ -86,7 +155,7 @@ void Differ::MarkDirtyBlocks(const uint8_t* prev_buffer,
     // This condition should rarely, if ever, occur.
     if (partial_column_width != 0) {
       *diff_info = !PartialBlocksEqual(prev_block, curr_block, bytes_per_row_,
-                                       partial_column_width, kBlockSize);
+                                       partial_column_width, block_height);
       diff_info += sizeof(bool);
     }
 
@@ -95,29 +164,6 @@ void Differ::MarkDirtyBlocks(const uint8_t* prev_buffer,
     curr_block_row_start += block_y_stride;
     diff_info_row_start += diff_info_stride;
   }
-
-  // If the screen height is not a multiple of the block size, then this
-  // handles the last partial row. This situation is far more common than the
-  // 'partial column' case.
-  if (partial_row_height != 0) {
-    const uint8_t* prev_block = prev_block_row_start;
-    const uint8_t* curr_block = curr_block_row_start;
-    bool* diff_info = diff_info_row_start;
-    for (int x = 0; x < x_full_blocks; x++) {
-      *diff_info = !PartialBlocksEqual(prev_block, curr_block,
-                                       bytes_per_row_,
-                                       kBlockSize, partial_row_height);
-      prev_block += block_x_offset;
-      curr_block += block_x_offset;
-      diff_info += sizeof(bool);
-    }
-    if (partial_column_width != 0) {
-      *diff_info = !PartialBlocksEqual(prev_block, curr_block, bytes_per_row_,
-                                       partial_column_width,
-                                       partial_row_height);
-      diff_info += sizeof(bool);
-    }
-  }
 }
 
 bool Differ::PartialBlocksEqual(const uint8_t* prev_buffer,
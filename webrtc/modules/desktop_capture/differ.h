@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/task_queue.h"
 #include "webrtc/modules/desktop_capture/desktop_region.h"
 
 namespace webrtc {
@@ -30,6 +31,10 @@ class Differ {
   // Create a differ that operates on bitmaps with the specified width, height
   // and bytes_per_pixel.
   Differ(int width, int height, int bytes_per_pixel, int stride);
+  // Same as above, but large frames are split into horizontal bands of block
+  // rows which are diffed in parallel on up to |num_threads| threads.
+  Differ(int width, int height, int bytes_per_pixel, int stride,
+         int num_threads);
   ~Differ();
 
   int width() { return width_; }
@@ -49,6 +54,14 @@ class Differ {
   // Identify all of the blocks that contain changed pixels.
   void MarkDirtyBlocks(const uint8_t* prev_buffer, const uint8_t* curr_buffer);
 
+  // Identifies the changed blocks in the block rows [|block_row_start|,
+  // |block_row_end|). Bands of block rows write disjoint parts of
+  // |diff_info_|, so they can be marked concurrently.
+  void MarkDirtyBlockRows(const uint8_t* prev_buffer,
+                          const uint8_t* curr_buffer,
+                          int block_row_start,
+                          int block_row_end);
+
   // After the dirty blocks have been identified, this routine merges adjacent
   // blocks into a region.
   // The goal is to minimize the region that covers the dirty blocks.
@@ -82,6 +95,10 @@ class Differ {
   int diff_info_height_;
   int diff_info_size_;
 
+  // Queues diffing all but the first band of block rows, which is diffed on
+  // the calling thread. Empty when the frame is diffed on one thread.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> band_queues_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(Differ);
 };
 
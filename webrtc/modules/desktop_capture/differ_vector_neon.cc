@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/differ_vector_neon.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+namespace {
+
+// Returns whether any bit of |acc| is set.
+bool AnyBitSet(const uint8x16_t acc) {
+  const uint64x2_t acc_64x2 = vreinterpretq_u64_u8(acc);
+  return (vgetq_lane_u64(acc_64x2, 0) | vgetq_lane_u64(acc_64x2, 1)) != 0;
+}
+
+// ORs the XOR of |count| 16 byte vectors of |image1| and |image2| into |acc|.
+uint8x16_t AccumulateDifference(const uint8_t* image1,
+                                const uint8_t* image2,
+                                int count,
+                                uint8x16_t acc) {
+  for (int i = 0; i < count; ++i) {
+    const uint8x16_t v0 = vld1q_u8(image1 + i * 16);
+    const uint8x16_t v1 = vld1q_u8(image2 + i * 16);
+    acc = vorrq_u8(acc, veorq_u8(v0, v1));
+  }
+  return acc;
+}
+
+}  // namespace
+
+extern bool VectorDifference_NEON_W16(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  return AnyBitSet(AccumulateDifference(image1, image2, 4, vdupq_n_u8(0)));
+}
+
+extern bool VectorDifference_NEON_W32(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  return AnyBitSet(AccumulateDifference(image1, image2, 8, vdupq_n_u8(0)));
+}
+
+}  // namespace webrtc
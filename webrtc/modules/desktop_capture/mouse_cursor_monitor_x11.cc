@@ -85,6 +85,10 @@ class MouseCursorMonitorX11 : public MouseCursorMonitor,
   int xfixes_event_base_;
   int xfixes_error_base_;
 
+  // Serial of the last captured cursor shape. A display cursor notification
+  // for the same serial doesn't need the image to be fetched again.
+  unsigned long cursor_serial_;
+
   std::unique_ptr<MouseCursor> cursor_shape_;
 };
 
@@ -97,7 +101,8 @@ MouseCursorMonitorX11::MouseCursorMonitorX11(
       window_(window),
       have_xfixes_(false),
       xfixes_event_base_(-1),
-      xfixes_error_base_(-1) {}
+      xfixes_error_base_(-1),
+      cursor_serial_(0) {}
 
 MouseCursorMonitorX11::~MouseCursorMonitorX11() {
   if (have_xfixes_) {
@@ -171,7 +176,8 @@ bool MouseCursorMonitorX11::HandleXEvent(const XEvent& event) {
   if (have_xfixes_ && event.type == xfixes_event_base_ + XFixesCursorNotify) {
     const XFixesCursorNotifyEvent* cursor_event =
         reinterpret_cast<const XFixesCursorNotifyEvent*>(&event);
-    if (cursor_event->subtype == XFixesDisplayCursorNotify) {
+    if (cursor_event->subtype == XFixesDisplayCursorNotify &&
+        cursor_event->cursor_serial != cursor_serial_) {
       CaptureCursor();
     }
     // Return false, even if the event has been handled, because there might be
@@ -205,6 +211,7 @@ void MouseCursorMonitorX11::CaptureCursor() {
   DesktopVector hotspot(std::min(img->width, img->xhot),
                         std::min(img->height, img->yhot));
 
+  cursor_serial_ = img->cursor_serial;
   XFree(img);
 
   cursor_shape_.reset(new MouseCursor(image.release(), hotspot));
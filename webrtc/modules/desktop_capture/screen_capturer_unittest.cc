@@ -22,6 +22,7 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/desktop_capture/rgba_color.h"
 #include "webrtc/modules/desktop_capture/desktop_capture_options.h"
 #include "webrtc/modules/desktop_capture/desktop_frame.h"
@@ -292,6 +293,33 @@ TEST_F(ScreenCapturerTest, DISABLED_TwoCapturers) {
   TestCaptureUpdatedRegion({capturer_.get(), capturer2.get()});
 }
 
+// Disabled since it's a benchmark, which depends on the size and the content of
+// the screen. Run it with the screen at the resolution of interest, e.g. 1080p
+// or 4K, with and without changing content.
+TEST_F(ScreenCapturerTest, DISABLED_CaptureTime) {
+  const int kNumFrames = 100;
+  std::unique_ptr<DesktopFrame> frame;
+  EXPECT_CALL(callback_,
+              OnCaptureResultPtr(DesktopCapturer::Result::SUCCESS, _))
+      .Times(kNumFrames + 1)
+      .WillRepeatedly(SaveUniquePtrArg(&frame));
+
+  capturer_->Start(&callback_);
+  // The first capture is always of the whole screen.
+  capturer_->Capture(DesktopRegion());
+  ASSERT_TRUE(frame);
+
+  const int64_t start_time_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumFrames; ++i) {
+    capturer_->Capture(DesktopRegion());
+    ASSERT_TRUE(frame);
+  }
+  const int64_t capture_time_us = rtc::TimeMicros() - start_time_us;
+  printf("%dx%d: average capture time = %d us / frame\n",
+         frame->size().width(), frame->size().height(),
+         static_cast<int>(capture_time_us / kNumFrames));
+}
+
 #if defined(WEBRTC_WIN)
 
 TEST_F(ScreenCapturerTest, UseSharedBuffers) {
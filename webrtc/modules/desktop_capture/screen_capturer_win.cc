@@ -24,18 +24,24 @@ namespace webrtc {
 // static
 ScreenCapturer* ScreenCapturer::Create(const DesktopCaptureOptions& options) {
   std::unique_ptr<ScreenCapturer> capturer;
+  // Whether the frames carry the dirty and move rectangles reported by DXGI.
+  bool reports_updated_region = false;
   if (options.allow_directx_capturer() &&
       ScreenCapturerWinDirectx::IsSupported()) {
     capturer.reset(new ScreenCapturerWinDirectx(options));
+    reports_updated_region = true;
   } else {
     capturer.reset(new ScreenCapturerWinGdi(options));
   }
 
   if (options.allow_use_magnification_api()) {
     capturer.reset(new ScreenCapturerWinMagnifier(std::move(capturer)));
+    reports_updated_region = false;
   }
 
-  if (options.detect_updated_region()) {
+  // DXGI already tells which parts of the screen changed, so comparing the
+  // frames on the CPU would only repeat its work.
+  if (options.detect_updated_region() && !reports_updated_region) {
     capturer.reset(new ScreenCapturerDifferWrapper(std::move(capturer)));
   }
 
@@ -15,6 +15,7 @@
 #include <memory>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include <X11/extensions/Xdamage.h>
 #include <X11/extensions/Xfixes.h>
@@ -32,6 +33,7 @@
 #include "webrtc/modules/desktop_capture/screen_capturer_helper.h"
 #include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
 #include "webrtc/modules/desktop_capture/x11/x_server_pixel_buffer.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/system_wrappers/include/logging.h"
 
 namespace webrtc {
@@ -74,11 +76,12 @@ class ScreenCapturerLinux : public ScreenCapturer,
   void ScreenConfigurationChanged();
 
   // Synchronize the current buffer with |last_buffer_|, by copying pixels from
-  // the area of |last_invalid_rects|.
+  // the area of |last_invalid_rects|, except |captured_region| which is about
+  // to be captured.
   // Note this only works on the assumption that kNumBuffers == 2, as
   // |last_invalid_rects| holds the differences from the previous buffer and
   // the one prior to that (which will then be the current buffer).
-  void SynchronizeFrame();
+  void SynchronizeFrame(const DesktopRegion& captured_region);
 
   void DeinitXlib();
 
@@ -260,7 +263,8 @@ void ScreenCapturerLinux::Capture(const DesktopRegion& region) {
        (differ_->height() != frame->size().height()) ||
        (differ_->bytes_per_row() != frame->stride()))) {
     differ_.reset(new Differ(frame->size().width(), frame->size().height(),
-                             DesktopFrame::kBytesPerPixel, frame->stride()));
+                             DesktopFrame::kBytesPerPixel, frame->stride(),
+                             CpuInfo::DetectNumberOfCores()));
   }
 
   std::unique_ptr<DesktopFrame> result = CaptureScreen();
@@ -307,16 +311,8 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
   // expands that region to a grid.
   helper_.set_size_most_recent(frame->size());
 
-  // In the DAMAGE case, ensure the frame is up-to-date with the previous frame
-  // if any.  If there isn't a previous frame, that means a screen-resolution
-  // change occurred, and |invalid_rects| will be updated to include the whole
-  // screen.
-  if (use_damage_ && queue_.previous_frame())
-    SynchronizeFrame();
-
   DesktopRegion* updated_region = frame->mutable_updated_region();
 
-  x_server_pixel_buffer_.Synchronize();
   if (use_damage_ && queue_.previous_frame()) {
     // Atomically fetch and clear the damage region.
     XDamageSubtract(display(), damage_handle_, None, damage_region_);
@@ -324,11 +320,15 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
     XRectangle bounds;
     XRectangle* rects = XFixesFetchRegionAndBounds(display(), damage_region_,
                                                    &rects_num, &bounds);
+    std::vector<DesktopRect> damage_rects;
+    damage_rects.reserve(rects_num);
     for (int i = 0; i < rects_num; ++i) {
-      updated_region->AddRect(DesktopRect::MakeXYWH(
+      damage_rects.push_back(DesktopRect::MakeXYWH(
           rects[i].x, rects[i].y, rects[i].width, rects[i].height));
     }
     XFree(rects);
+    updated_region->AddRects(damage_rects.data(),
+                             static_cast<int>(damage_rects.size()));
     helper_.InvalidateRegion(*updated_region);
 
     // Capture the damaged portions of the desktop.
@@ -340,14 +340,17 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
     updated_region->IntersectWith(
         DesktopRect::MakeSize(x_server_pixel_buffer_.window_size()));
 
-    for (DesktopRegion::Iterator it(*updated_region);
-         !it.IsAtEnd(); it.Advance()) {
-      x_server_pixel_buffer_.CaptureRect(it.rect(), frame.get());
-    }
+    // Ensure the frame is up-to-date with the previous frame, outside of the
+    // damaged portions captured below. The damage is fetched before the
+    // pixels, so damage reported meanwhile is captured by the next frame.
+    SynchronizeFrame(*updated_region);
+
+    x_server_pixel_buffer_.CaptureRegion(*updated_region, frame.get());
   } else {
     // Doing full-screen polling, or this is the first capture after a
     // screen-resolution change.  In either case, need a full-screen capture.
     DesktopRect screen_rect = DesktopRect::MakeSize(frame->size());
+    x_server_pixel_buffer_.Synchronize();
     x_server_pixel_buffer_.CaptureRect(screen_rect, frame.get());
 
     if (queue_.previous_frame()) {
@@ -380,22 +383,21 @@ void ScreenCapturerLinux::ScreenConfigurationChanged() {
   }
 }
 
-void ScreenCapturerLinux::SynchronizeFrame() {
+void ScreenCapturerLinux::SynchronizeFrame(
+    const DesktopRegion& captured_region) {
   // Synchronize the current buffer with the previous one since we do not
   // capture the entire desktop. Note that encoder may be reading from the
   // previous buffer at this time so thread access complaints are false
   // positives.
-
-  // TODO(hclam): We can reduce the amount of copying here by subtracting
-  // |capturer_helper_|s region from |last_invalid_region_|.
-  // http://crbug.com/92354
   RTC_DCHECK(queue_.previous_frame());
 
   DesktopFrame* current = queue_.current_frame();
   DesktopFrame* last = queue_.previous_frame();
   RTC_DCHECK(current != last);
-  for (DesktopRegion::Iterator it(last_invalid_region_);
-       !it.IsAtEnd(); it.Advance()) {
+  // The pixels in |captured_region| are overwritten by the capture anyway.
+  DesktopRegion copy_region(last_invalid_region_);
+  copy_region.Subtract(captured_region);
+  for (DesktopRegion::Iterator it(copy_region); !it.IsAtEnd(); it.Advance()) {
     current->CopyPixelsFrom(*last, it.rect().top_left(), it.rect());
   }
 }
@@ -0,0 +1,382 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/shared_memory_frame_ring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/system_wrappers/include/logging.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kMagic = 0x52465257;  // "WRFR"
+
+// Updated regions with more rectangles are sent as the whole frame.
+const int kMaxUpdatedRects = 32;
+
+// Value of SlotHeader::lock while the producer writes to the slot.
+const int kSlotWriting = -1;
+
+// The slots are page-aligned, so that each of them can be read and written
+// without touching the pages of another.
+const size_t kPageSize = 4096;
+
+size_t AlignToPage(size_t size) {
+  return (size + kPageSize - 1) & ~(kPageSize - 1);
+}
+
+}  // namespace
+
+// Placed at the start of the segment, followed by the SlotHeaders. Only holds
+// fixed-size types, so that both processes agree on the layout.
+struct SharedMemoryFrameRing::RingHeader {
+  int magic;
+  int num_slots;
+  int max_width;
+  int max_height;
+  uint64_t headers_size;
+  uint64_t slot_size;
+  // Incremented for each published frame. The consumer waits on it.
+  volatile int sequence;
+  // Number of consumers waiting on |sequence|, so that the producer only
+  // makes the wake-up system call when needed.
+  volatile int waiters;
+  // The slot holding the frame published last, or -1.
+  volatile int latest_slot;
+};
+
+struct SharedMemoryFrameRing::SlotHeader {
+  // 0 when free, kSlotWriting or the number of frames the consumer holds.
+  volatile int lock;
+  int sequence;
+  int width;
+  int height;
+  int dpi_x;
+  int dpi_y;
+  int64_t capture_time_ms;
+  // -1 if the whole frame is updated.
+  int num_updated_rects;
+  int updated_rects[kMaxUpdatedRects][4];
+};
+
+// Backs the frames returned by ReceiveFrame(), and releases the slot when the
+// frame is destroyed.
+class SharedMemoryFrameRing::SlotMemory : public SharedMemory {
+ public:
+  SlotMemory(void* data,
+             size_t size,
+             Handle handle,
+             int slot,
+             volatile int* lock)
+      : SharedMemory(data, size, handle, slot), lock_(lock) {}
+  ~SlotMemory() override { rtc::AtomicOps::Decrement(lock_); }
+
+ private:
+  volatile int* const lock_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SlotMemory);
+};
+
+// static
+std::unique_ptr<SharedMemoryFrameRing> SharedMemoryFrameRing::Create(
+    int num_slots,
+    DesktopSize max_size) {
+  RTC_DCHECK_GE(num_slots, 2);
+  RTC_DCHECK(!max_size.is_empty());
+
+  size_t headers_size =
+      AlignToPage(sizeof(RingHeader) + num_slots * sizeof(SlotHeader));
+  size_t slot_size = AlignToPage(max_size.width() * max_size.height() *
+                                 DesktopFrame::kBytesPerPixel);
+  size_t size = headers_size + num_slots * slot_size;
+
+  // The name is only used to get a descriptor and is removed right away.
+  static volatile int ring_count = 0;
+  char name[64];
+  snprintf(name, sizeof(name), "/webrtc-frame-ring-%d-%d",
+           static_cast<int>(getpid()), rtc::AtomicOps::Increment(&ring_count));
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    LOG(LS_ERROR) << "Failed to create shared memory: " << errno;
+    return nullptr;
+  }
+  shm_unlink(name);
+
+  if (ftruncate(fd, size) != 0) {
+    LOG(LS_ERROR) << "Failed to allocate " << size
+                  << " bytes of shared memory: " << errno;
+    close(fd);
+    return nullptr;
+  }
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    LOG(LS_ERROR) << "Failed to map shared memory: " << errno;
+    close(fd);
+    return nullptr;
+  }
+
+  // The segment is zero-filled, so all the slots start free.
+  RingHeader* header = static_cast<RingHeader*>(data);
+  header->magic = kMagic;
+  header->num_slots = num_slots;
+  header->max_width = max_size.width();
+  header->max_height = max_size.height();
+  header->headers_size = headers_size;
+  header->slot_size = slot_size;
+  header->latest_slot = -1;
+
+  return std::unique_ptr<SharedMemoryFrameRing>(
+      new SharedMemoryFrameRing(fd, data, size));
+}
+
+// static
+std::unique_ptr<SharedMemoryFrameRing> SharedMemoryFrameRing::Attach(
+    SharedMemory::Handle handle) {
+  struct stat st;
+  if (fstat(handle, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(RingHeader)) {
+    close(handle);
+    return nullptr;
+  }
+  size_t size = st.st_size;
+  void* data =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+  if (data == MAP_FAILED) {
+    LOG(LS_ERROR) << "Failed to map shared memory: " << errno;
+    close(handle);
+    return nullptr;
+  }
+
+  const RingHeader* header = static_cast<const RingHeader*>(data);
+  if (header->magic != kMagic || header->num_slots < 2 ||
+      header->headers_size <
+          sizeof(RingHeader) + header->num_slots * sizeof(SlotHeader) ||
+      header->slot_size < static_cast<uint64_t>(header->max_width) *
+                              header->max_height *
+                              DesktopFrame::kBytesPerPixel ||
+      header->headers_size + header->num_slots * header->slot_size != size) {
+    LOG(LS_ERROR) << "Shared memory doesn't hold a frame ring.";
+    munmap(data, size);
+    close(handle);
+    return nullptr;
+  }
+
+  return std::unique_ptr<SharedMemoryFrameRing>(
+      new SharedMemoryFrameRing(handle, data, size));
+}
+
+SharedMemoryFrameRing::SharedMemoryFrameRing(SharedMemory::Handle handle,
+                                             void* data,
+                                             size_t size)
+    : handle_(handle),
+      data_(data),
+      size_(size),
+      header_(static_cast<RingHeader*>(data)) {
+  invalid_regions_.resize(header_->num_slots);
+  slot_sizes_.resize(header_->num_slots);
+}
+
+SharedMemoryFrameRing::~SharedMemoryFrameRing() {
+  munmap(data_, size_);
+  close(handle_);
+}
+
+int SharedMemoryFrameRing::num_slots() const {
+  return header_->num_slots;
+}
+
+DesktopSize SharedMemoryFrameRing::max_size() const {
+  return DesktopSize(header_->max_width, header_->max_height);
+}
+
+SharedMemoryFrameRing::SlotHeader* SharedMemoryFrameRing::slot_header(
+    int slot) const {
+  RTC_DCHECK_GE(slot, 0);
+  RTC_DCHECK_LT(slot, header_->num_slots);
+  return reinterpret_cast<SlotHeader*>(header_ + 1) + slot;
+}
+
+uint8_t* SharedMemoryFrameRing::slot_data(int slot) const {
+  return static_cast<uint8_t*>(data_) + header_->headers_size +
+         slot * header_->slot_size;
+}
+
+bool SharedMemoryFrameRing::PublishFrame(const DesktopFrame& frame) {
+  const DesktopSize& size = frame.size();
+  if (size.width() > header_->max_width ||
+      size.height() > header_->max_height) {
+    LOG(LS_WARNING) << "Frame of " << size.width() << "x" << size.height()
+                    << " doesn't fit in the ring.";
+    return false;
+  }
+
+  const DesktopRect frame_rect = DesktopRect::MakeSize(size);
+  pending_updated_region_.AddRegion(frame.updated_region());
+  for (int i = 0; i < header_->num_slots; ++i) {
+    if (slot_sizes_[i].equals(size)) {
+      invalid_regions_[i].AddRegion(frame.updated_region());
+    } else {
+      invalid_regions_[i].SetRect(frame_rect);
+    }
+  }
+
+  // Take the first free slot after the latest one, skipping the latest one
+  // itself as the consumer may be about to read it.
+  int latest = rtc::AtomicOps::AcquireLoad(&header_->latest_slot);
+  int slot = -1;
+  for (int i = 1; i <= header_->num_slots; ++i) {
+    int candidate = (latest + i) % header_->num_slots;
+    if (candidate != latest &&
+        rtc::AtomicOps::CompareAndSwap(&slot_header(candidate)->lock, 0,
+                                       kSlotWriting) == 0) {
+      slot = candidate;
+      break;
+    }
+  }
+  if (slot < 0) {
+    // The changes are sent with the next frame.
+    return false;
+  }
+
+  // Rows are packed, which is the stride SharedMemoryDesktopFrame uses.
+  const int slot_stride = size.width() * DesktopFrame::kBytesPerPixel;
+  uint8_t* const data = slot_data(slot);
+  invalid_regions_[slot].IntersectWith(frame_rect);
+  for (DesktopRegion::Iterator it(invalid_regions_[slot]); !it.IsAtEnd();
+       it.Advance()) {
+    const DesktopRect& rect = it.rect();
+    const uint8_t* src = frame.GetFrameDataAtPos(rect.top_left());
+    uint8_t* dst = data + rect.top() * slot_stride +
+                   rect.left() * DesktopFrame::kBytesPerPixel;
+    const size_t row_bytes = rect.width() * DesktopFrame::kBytesPerPixel;
+    for (int y = 0; y < rect.height(); ++y) {
+      memcpy(dst, src, row_bytes);
+      src += frame.stride();
+      dst += slot_stride;
+    }
+  }
+  invalid_regions_[slot].Clear();
+  slot_sizes_[slot] = size;
+
+  SlotHeader* slot_header = this->slot_header(slot);
+  slot_header->sequence = header_->sequence + 1;
+  slot_header->width = size.width();
+  slot_header->height = size.height();
+  slot_header->dpi_x = frame.dpi().x();
+  slot_header->dpi_y = frame.dpi().y();
+  slot_header->capture_time_ms = frame.capture_time_ms();
+  pending_updated_region_.IntersectWith(frame_rect);
+  int num_rects = 0;
+  for (DesktopRegion::Iterator it(pending_updated_region_); !it.IsAtEnd();
+       it.Advance()) {
+    if (num_rects == kMaxUpdatedRects) {
+      num_rects = -1;
+      break;
+    }
+    int* rect = slot_header->updated_rects[num_rects++];
+    rect[0] = it.rect().left();
+    rect[1] = it.rect().top();
+    rect[2] = it.rect().right();
+    rect[3] = it.rect().bottom();
+  }
+  slot_header->num_updated_rects = num_rects;
+  pending_updated_region_.Clear();
+
+  rtc::AtomicOps::ReleaseStore(&slot_header->lock, 0);
+  rtc::AtomicOps::ReleaseStore(&header_->latest_slot, slot);
+  rtc::AtomicOps::Increment(&header_->sequence);
+  if (rtc::AtomicOps::AcquireLoad(&header_->waiters) > 0) {
+    syscall(SYS_futex, &header_->sequence, FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+  }
+  return true;
+}
+
+std::unique_ptr<DesktopFrame> SharedMemoryFrameRing::ReceiveFrame(
+    int timeout_ms) {
+  const int64_t deadline_ms = rtc::TimeMillis() + timeout_ms;
+  int sequence;
+  while ((sequence = rtc::AtomicOps::AcquireLoad(&header_->sequence)) ==
+         last_received_sequence_) {
+    int64_t remaining_ms = deadline_ms - rtc::TimeMillis();
+    if (remaining_ms <= 0)
+      return nullptr;
+    timespec timeout;
+    timeout.tv_sec = remaining_ms / 1000;
+    timeout.tv_nsec = (remaining_ms % 1000) * 1000000;
+    // Returns right away if a frame has been published since |sequence| was
+    // read.
+    rtc::AtomicOps::Increment(&header_->waiters);
+    syscall(SYS_futex, &header_->sequence, FUTEX_WAIT, sequence, &timeout,
+            nullptr, 0);
+    rtc::AtomicOps::Decrement(&header_->waiters);
+  }
+
+  // Lock the latest slot. The producer never writes to the latest slot, so
+  // this only has to be retried if another frame is published meanwhile.
+  int slot;
+  SlotHeader* slot_header;
+  while (true) {
+    slot = rtc::AtomicOps::AcquireLoad(&header_->latest_slot);
+    slot_header = this->slot_header(slot);
+    int lock = rtc::AtomicOps::AcquireLoad(&slot_header->lock);
+    if (lock != kSlotWriting &&
+        rtc::AtomicOps::CompareAndSwap(&slot_header->lock, lock, lock + 1) ==
+            lock) {
+      if (rtc::AtomicOps::AcquireLoad(&header_->latest_slot) == slot)
+        break;
+      rtc::AtomicOps::Decrement(&slot_header->lock);
+    }
+  }
+
+  DesktopSize size(slot_header->width, slot_header->height);
+  std::unique_ptr<DesktopFrame> frame = SharedMemoryDesktopFrame::Create(
+      size, std::unique_ptr<SharedMemory>(new SlotMemory(
+                slot_data(slot), header_->slot_size, handle_, slot,
+                &slot_header->lock)));
+  frame->set_dpi(DesktopVector(slot_header->dpi_x, slot_header->dpi_y));
+  frame->set_capture_time_ms(slot_header->capture_time_ms);
+
+  DesktopRegion* updated_region = frame->mutable_updated_region();
+  if (last_received_sequence_ != 0 &&
+      slot_header->sequence == last_received_sequence_ + 1 &&
+      slot_header->num_updated_rects >= 0) {
+    for (int i = 0; i < slot_header->num_updated_rects; ++i) {
+      const int* rect = slot_header->updated_rects[i];
+      updated_region->AddRect(
+          DesktopRect::MakeLTRB(rect[0], rect[1], rect[2], rect[3]));
+    }
+    updated_region->IntersectWith(DesktopRect::MakeSize(size));
+  } else {
+    updated_region->SetRect(DesktopRect::MakeSize(size));
+  }
+  last_received_sequence_ = slot_header->sequence;
+
+  return frame;
+}
+
+}  // namespace webrtc
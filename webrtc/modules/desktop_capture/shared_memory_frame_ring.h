@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_DESKTOP_CAPTURE_SHARED_MEMORY_FRAME_RING_H_
+#define WEBRTC_MODULES_DESKTOP_CAPTURE_SHARED_MEMORY_FRAME_RING_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/desktop_geometry.h"
+#include "webrtc/modules/desktop_capture/desktop_region.h"
+#include "webrtc/modules/desktop_capture/shared_memory.h"
+
+namespace webrtc {
+
+// A ring of DesktopFrames in a single shared memory segment, used to deliver
+// captured frames from a capture process to the process that consumes them
+// without copying them through an IPC channel.
+//
+// The capture process creates the ring and passes handle() to the other
+// process over its own IPC channel (e.g. with SCM_RIGHTS), where it is
+// attached. The capture process then publishes each captured frame, and the
+// consumer receives the frames as views into the segment. Each slot carries
+// the frame's size, DPI, capture time and updated region; publishing wakes up
+// a waiting consumer through a futex on the segment.
+//
+// There must be a single producer and a single consumer, each calling the
+// ring from one thread at a time. The producer never overwrites a slot held
+// by the consumer or the most recently published frame; with all the other
+// slots held a frame is dropped, so the consumer should keep fewer than
+// num_slots - 1 frames at a time.
+//
+// Only available on Linux.
+class SharedMemoryFrameRing {
+ public:
+  // Creates a ring of |num_slots| frames, each up to |max_size|, in a new
+  // anonymous shared memory segment. |num_slots| must be at least 2. Returns
+  // null on failure.
+  static std::unique_ptr<SharedMemoryFrameRing> Create(int num_slots,
+                                                       DesktopSize max_size);
+
+  // Maps the ring created by Create() in another process. Takes ownership of
+  // |handle|. Returns null if |handle| doesn't refer to a ring.
+  static std::unique_ptr<SharedMemoryFrameRing> Attach(
+      SharedMemory::Handle handle);
+
+  // All the frames returned by ReceiveFrame() must be destroyed before the
+  // ring.
+  ~SharedMemoryFrameRing();
+
+  // The handle of the segment, to be passed to Attach().
+  SharedMemory::Handle handle() const { return handle_; }
+
+  int num_slots() const;
+  DesktopSize max_size() const;
+
+  // Producer side. Copies |frame| to a free slot and publishes it. Only the
+  // pixels that changed since the slot was last written are copied, using the
+  // updated regions of the frames published in between. Returns false if the
+  // frame is larger than max_size() or all the slots are in use, in which case
+  // the frame is dropped.
+  bool PublishFrame(const DesktopFrame& frame);
+
+  // Consumer side. Returns the most recently published frame if it is newer
+  // than the one last returned, waiting up to |timeout_ms| for one to be
+  // published. Returns null on timeout. The updated region of the frame is
+  // relative to the frame last returned; it is the whole frame if any frame
+  // was skipped. The frame points into the ring and its slot isn't reused
+  // until the frame is destroyed. The id() of its shared_memory() is the slot
+  // index.
+  std::unique_ptr<DesktopFrame> ReceiveFrame(int timeout_ms);
+
+ private:
+  struct RingHeader;
+  struct SlotHeader;
+  class SlotMemory;
+
+  SharedMemoryFrameRing(SharedMemory::Handle handle, void* data, size_t size);
+
+  SlotHeader* slot_header(int slot) const;
+  uint8_t* slot_data(int slot) const;
+
+  // Only accessed from the producer. The part of each slot that is older than
+  // the last published frame, and the size of the frame the slot holds.
+  std::vector<DesktopRegion> invalid_regions_;
+  std::vector<DesktopSize> slot_sizes_;
+  // The updated regions of the frames dropped since the last published one.
+  DesktopRegion pending_updated_region_;
+
+  // Only accessed from the consumer. The sequence number of the last frame
+  // returned by ReceiveFrame().
+  int last_received_sequence_ = 0;
+
+  const SharedMemory::Handle handle_;
+  void* const data_;
+  const size_t size_;
+  RingHeader* const header_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedMemoryFrameRing);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_DESKTOP_CAPTURE_SHARED_MEMORY_FRAME_RING_H_
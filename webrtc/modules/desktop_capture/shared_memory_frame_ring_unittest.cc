@@ -0,0 +1,218 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/desktop_capture/shared_memory_frame_ring.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/desktop_region.h"
+#include "webrtc/system_wrappers/include/sleep.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kWidth = 64;
+const int kHeight = 48;
+
+// Fills |rect| of |frame| with |value| and marks it as updated.
+void Paint(DesktopFrame* frame, const DesktopRect& rect, uint8_t value) {
+  for (int y = rect.top(); y < rect.bottom(); ++y) {
+    memset(frame->GetFrameDataAtPos(DesktopVector(rect.left(), y)), value,
+           rect.width() * DesktopFrame::kBytesPerPixel);
+  }
+  frame->mutable_updated_region()->AddRect(rect);
+}
+
+bool FramesEqual(const DesktopFrame& a, const DesktopFrame& b) {
+  if (!a.size().equals(b.size()))
+    return false;
+  for (int y = 0; y < a.size().height(); ++y) {
+    if (memcmp(a.GetFrameDataAtPos(DesktopVector(0, y)),
+               b.GetFrameDataAtPos(DesktopVector(0, y)),
+               a.size().width() * DesktopFrame::kBytesPerPixel) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+class SharedMemoryFrameRingTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    CreateRing(3);
+    source_.reset(new BasicDesktopFrame(DesktopSize(kWidth, kHeight)));
+    Paint(source_.get(), DesktopRect::MakeWH(kWidth, kHeight), 0);
+  }
+
+  void CreateRing(int num_slots) {
+    consumer_.reset();
+    producer_ =
+        SharedMemoryFrameRing::Create(num_slots, DesktopSize(kWidth, kHeight));
+    ASSERT_TRUE(producer_);
+    // Attaching a duplicate of the handle maps the segment a second time, as
+    // the consumer process would.
+    consumer_ = SharedMemoryFrameRing::Attach(dup(producer_->handle()));
+    ASSERT_TRUE(consumer_);
+  }
+
+  // Publishes |source_| and clears its updated region.
+  bool Publish() {
+    bool published = producer_->PublishFrame(*source_);
+    source_->mutable_updated_region()->Clear();
+    return published;
+  }
+
+ protected:
+  std::unique_ptr<SharedMemoryFrameRing> producer_;
+  std::unique_ptr<SharedMemoryFrameRing> consumer_;
+  std::unique_ptr<DesktopFrame> source_;
+};
+
+TEST_F(SharedMemoryFrameRingTest, AttachedRingHasSameLayout) {
+  EXPECT_EQ(3, consumer_->num_slots());
+  EXPECT_TRUE(consumer_->max_size().equals(DesktopSize(kWidth, kHeight)));
+}
+
+TEST_F(SharedMemoryFrameRingTest, DeliversFramesAndUpdatedRegions) {
+  source_->set_dpi(DesktopVector(96, 96));
+  source_->set_capture_time_ms(7);
+  ASSERT_TRUE(Publish());
+  std::unique_ptr<DesktopFrame> frame = consumer_->ReceiveFrame(0);
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(FramesEqual(*source_, *frame));
+  EXPECT_TRUE(frame->dpi().equals(DesktopVector(96, 96)));
+  EXPECT_EQ(7, frame->capture_time_ms());
+  // The first frame is always updated in full.
+  EXPECT_TRUE(frame->updated_region().Equals(
+      DesktopRegion(DesktopRect::MakeWH(kWidth, kHeight))));
+  frame.reset();
+
+  // Each slot is brought up to date with the changes it missed.
+  for (int i = 1; i < 10; ++i) {
+    const DesktopRect rect = DesktopRect::MakeXYWH(i * 5, i, 3, 4);
+    Paint(source_.get(), rect, i);
+    ASSERT_TRUE(Publish());
+    frame = consumer_->ReceiveFrame(0);
+    ASSERT_TRUE(frame);
+    EXPECT_TRUE(FramesEqual(*source_, *frame));
+    EXPECT_TRUE(frame->updated_region().Equals(DesktopRegion(rect)));
+    frame.reset();
+  }
+
+  EXPECT_FALSE(consumer_->ReceiveFrame(0));
+}
+
+TEST_F(SharedMemoryFrameRingTest, SkippedFramesUpdateWholeFrame) {
+  ASSERT_TRUE(Publish());
+  Paint(source_.get(), DesktopRect::MakeXYWH(1, 1, 2, 2), 1);
+  ASSERT_TRUE(Publish());
+  std::unique_ptr<DesktopFrame> frame = consumer_->ReceiveFrame(0);
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(FramesEqual(*source_, *frame));
+  frame.reset();
+
+  Paint(source_.get(), DesktopRect::MakeXYWH(1, 1, 2, 2), 2);
+  ASSERT_TRUE(Publish());
+  Paint(source_.get(), DesktopRect::MakeXYWH(10, 10, 2, 2), 3);
+  ASSERT_TRUE(Publish());
+  frame = consumer_->ReceiveFrame(0);
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(FramesEqual(*source_, *frame));
+  EXPECT_TRUE(frame->updated_region().Equals(
+      DesktopRegion(DesktopRect::MakeWH(kWidth, kHeight))));
+}
+
+TEST_F(SharedMemoryFrameRingTest, DropsFramesWhileSlotsAreHeld) {
+  CreateRing(2);
+  ASSERT_TRUE(Publish());
+  std::unique_ptr<DesktopFrame> first = consumer_->ReceiveFrame(0);
+  ASSERT_TRUE(first);
+  const DesktopRect rect1 = DesktopRect::MakeXYWH(0, 0, 4, 4);
+  Paint(source_.get(), rect1, 1);
+  ASSERT_TRUE(Publish());
+  std::unique_ptr<DesktopFrame> second = consumer_->ReceiveFrame(0);
+  ASSERT_TRUE(second);
+
+  // Both slots are held, and the second one also holds the latest frame.
+  const DesktopRect rect2 = DesktopRect::MakeXYWH(20, 20, 4, 4);
+  Paint(source_.get(), rect2, 2);
+  EXPECT_FALSE(Publish());
+  // The frames held by the consumer are left untouched.
+  EXPECT_EQ(0, *first->GetFrameDataAtPos(rect1.top_left()));
+  EXPECT_EQ(1, *second->GetFrameDataAtPos(rect1.top_left()));
+  EXPECT_EQ(0, *second->GetFrameDataAtPos(rect2.top_left()));
+
+  first.reset();
+  const DesktopRect rect3 = DesktopRect::MakeXYWH(40, 40, 4, 4);
+  Paint(source_.get(), rect3, 3);
+  ASSERT_TRUE(Publish());
+  std::unique_ptr<DesktopFrame> third = consumer_->ReceiveFrame(0);
+  ASSERT_TRUE(third);
+  EXPECT_TRUE(FramesEqual(*source_, *third));
+  // The dropped frame's changes are delivered with the next one.
+  DesktopRegion expected_region(rect2);
+  expected_region.AddRect(rect3);
+  EXPECT_TRUE(third->updated_region().Equals(expected_region));
+}
+
+TEST_F(SharedMemoryFrameRingTest, DeliversResizedFrames) {
+  ASSERT_TRUE(Publish());
+  ASSERT_TRUE(consumer_->ReceiveFrame(0));
+
+  source_.reset(new BasicDesktopFrame(DesktopSize(kWidth / 2, kHeight)));
+  Paint(source_.get(), DesktopRect::MakeWH(kWidth / 2, kHeight), 5);
+  ASSERT_TRUE(Publish());
+  std::unique_ptr<DesktopFrame> frame = consumer_->ReceiveFrame(0);
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(FramesEqual(*source_, *frame));
+
+  source_.reset(new BasicDesktopFrame(DesktopSize(kWidth + 1, kHeight)));
+  EXPECT_FALSE(Publish());
+}
+
+TEST_F(SharedMemoryFrameRingTest, ReceiveTimesOut) {
+  int64_t start_ms = rtc::TimeMillis();
+  EXPECT_FALSE(consumer_->ReceiveFrame(20));
+  EXPECT_GE(rtc::TimeMillis() - start_ms, 20);
+}
+
+TEST_F(SharedMemoryFrameRingTest, WakesUpWaitingConsumer) {
+  rtc::PlatformThread thread(
+      [](void* obj) {
+        SleepMs(20);
+        static_cast<SharedMemoryFrameRingTest*>(obj)->Publish();
+        return false;
+      },
+      this, "Producer");
+  thread.Start();
+  std::unique_ptr<DesktopFrame> frame = consumer_->ReceiveFrame(10000);
+  thread.Stop();
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(FramesEqual(*source_, *frame));
+}
+
+TEST(SharedMemoryFrameRingAttachTest, RejectsOtherFiles) {
+  int fd = open("/dev/null", O_RDWR);
+  ASSERT_GE(fd, 0);
+  EXPECT_FALSE(SharedMemoryFrameRing::Attach(fd));
+}
+
+}  // namespace webrtc
@@ -245,12 +245,15 @@ bool DxgiOutputDuplicator::DoDetectUpdatedRegion(
   }
   dirty_rects_count = buff_size / sizeof(RECT);
 
+  // Collect the rectangles first, so that the region is built in one pass.
+  std::vector<DesktopRect> rects;
+  rects.reserve(2 * move_rects_count + dirty_rects_count);
   while (move_rects_count > 0) {
-    updated_region->AddRect(DesktopRect::MakeXYWH(
+    rects.push_back(DesktopRect::MakeXYWH(
         move_rects->SourcePoint.x, move_rects->SourcePoint.y,
         move_rects->DestinationRect.right - move_rects->DestinationRect.left,
         move_rects->DestinationRect.bottom - move_rects->DestinationRect.top));
-    updated_region->AddRect(DesktopRect::MakeLTRB(
+    rects.push_back(DesktopRect::MakeLTRB(
         move_rects->DestinationRect.left, move_rects->DestinationRect.top,
         move_rects->DestinationRect.right, move_rects->DestinationRect.bottom));
     move_rects++;
@@ -258,13 +261,14 @@ bool DxgiOutputDuplicator::DoDetectUpdatedRegion(
   }
 
   while (dirty_rects_count > 0) {
-    updated_region->AddRect(
+    rects.push_back(
         DesktopRect::MakeLTRB(dirty_rects->left, dirty_rects->top,
                               dirty_rects->right, dirty_rects->bottom));
     dirty_rects++;
     dirty_rects_count--;
   }
 
+  updated_region->AddRects(rects.data(), static_cast<int>(rects.size()));
   return true;
 }
 
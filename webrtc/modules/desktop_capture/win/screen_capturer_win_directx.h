@@ -26,6 +26,9 @@ namespace webrtc {
 
 // ScreenCapturerWinDirectx captures 32bit RGBA using DirectX. This
 // implementation won't work when ScreenCaptureFrameQueue.kQueueLength is not 2.
+// The updated_region() of the captured frames is built from the dirty and move
+// rectangles of IDXGIOutputDuplication, so it does not need to be detected by
+// ScreenCapturerDifferWrapper.
 class ScreenCapturerWinDirectx : public ScreenCapturer {
  public:
   // Whether the system supports DirectX based capturing.
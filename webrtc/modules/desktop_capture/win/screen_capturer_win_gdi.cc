@@ -25,6 +25,7 @@
 #include "webrtc/modules/desktop_capture/win/cursor.h"
 #include "webrtc/modules/desktop_capture/win/desktop.h"
 #include "webrtc/modules/desktop_capture/win/screen_capture_utils.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/system_wrappers/include/logging.h"
 
 namespace webrtc {
@@ -98,7 +99,8 @@ void ScreenCapturerWinGdi::Capture(const DesktopRegion& region) {
       differ_.reset(new Differ(current_frame->size().width(),
                                current_frame->size().height(),
                                DesktopFrame::kBytesPerPixel,
-                               current_frame->stride()));
+                               current_frame->stride(),
+                               CpuInfo::DetectNumberOfCores()));
     }
 
     // Calculate difference between the two last captured frames.
@@ -24,6 +24,7 @@
 #include "webrtc/modules/desktop_capture/win/cursor.h"
 #include "webrtc/modules/desktop_capture/win/desktop.h"
 #include "webrtc/modules/desktop_capture/win/screen_capture_utils.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/system_wrappers/include/logging.h"
 
 namespace webrtc {
@@ -129,7 +130,8 @@ void ScreenCapturerWinMagnifier::Capture(const DesktopRegion& region) {
       differ_.reset(new Differ(current_frame->size().width(),
                                current_frame->size().height(),
                                DesktopFrame::kBytesPerPixel,
-                               current_frame->stride()));
+                               current_frame->stride(),
+                               CpuInfo::DetectNumberOfCores()));
     }
 
     // Calculate difference between the two last captured frames.
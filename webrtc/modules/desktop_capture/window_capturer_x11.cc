@@ -14,15 +14,21 @@
 #include <string.h>
 #include <X11/Xatom.h>
 #include <X11/extensions/Xcomposite.h>
+#include <X11/extensions/Xdamage.h>
+#include <X11/extensions/Xfixes.h>
 #include <X11/extensions/Xrender.h>
 #include <X11/Xutil.h>
 
 #include <algorithm>
+#include <vector>
 
+#include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/modules/desktop_capture/desktop_capture_options.h"
 #include "webrtc/modules/desktop_capture/desktop_frame.h"
+#include "webrtc/modules/desktop_capture/screen_capture_frame_queue.h"
+#include "webrtc/modules/desktop_capture/shared_desktop_frame.h"
 #include "webrtc/modules/desktop_capture/x11/shared_x_display.h"
 #include "webrtc/modules/desktop_capture/x11/x_error_trap.h"
 #include "webrtc/modules/desktop_capture/x11/x_server_pixel_buffer.h"
@@ -114,6 +120,19 @@ class WindowCapturerLinux : public WindowCapturer,
   // Returns window title for the specified X |window|.
   bool GetWindowTitle(::Window window, std::string* title);
 
+  // Starts and stops tracking the changes to |selected_window_| with XDamage,
+  // if the X server supports it.
+  void InitXDamage();
+  void DeinitXDamage();
+
+  // Fetches and clears the damage accumulated for |selected_window_| since the
+  // last call, clipped to the window.
+  void TakeDamagedRegion(DesktopRegion* region);
+
+  // Copies the pixels updated in the previous frame, except |captured_region|
+  // which is about to be captured, to the current frame.
+  void SynchronizeFrame(const DesktopRegion& captured_region);
+
   Callback* callback_ = nullptr;
 
   rtc::scoped_refptr<SharedXDisplay> x_display_;
@@ -123,9 +142,22 @@ class WindowCapturerLinux : public WindowCapturer,
   Atom normal_window_type_atom_;
   bool has_composite_extension_ = false;
 
+  // XDamage, used to capture only the parts of the window that changed. It
+  // requires XFixes for the damage region.
+  bool has_damage_extension_ = false;
+  int damage_event_base_ = -1;
+  Damage damage_handle_ = 0;
+  XserverRegion damage_region_ = 0;
+
   ::Window selected_window_ = 0;
   XServerPixelBuffer x_server_pixel_buffer_;
 
+  // Queue of the frame buffers. The current frame is brought up to date by
+  // copying the region updated in the previous frame from it, so that only
+  // the damaged parts of the window have to be fetched from the X server.
+  ScreenCaptureFrameQueue<SharedDesktopFrame> queue_;
+  DesktopRegion last_invalid_region_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(WindowCapturerLinux);
 };
 
@@ -147,10 +179,21 @@ WindowCapturerLinux::WindowCapturerLinux(const DesktopCaptureOptions& options)
     LOG(LS_INFO) << "Xcomposite extension not available or too old.";
   }
 
+  int xfixes_event_base, xfixes_error_base, damage_error_base;
+  if (XFixesQueryExtension(display(), &xfixes_event_base,
+                           &xfixes_error_base) &&
+      XDamageQueryExtension(display(), &damage_event_base_,
+                            &damage_error_base)) {
+    has_damage_extension_ = true;
+  } else {
+    LOG(LS_INFO) << "XDamage extension not available, capturing whole windows.";
+  }
+
   x_display_->AddEventHandler(ConfigureNotify, this);
 }
 
 WindowCapturerLinux::~WindowCapturerLinux() {
+  DeinitXDamage();
   x_display_->RemoveEventHandler(ConfigureNotify, this);
 }
 
@@ -212,6 +255,11 @@ bool WindowCapturerLinux::SelectWindow(WindowId id) {
   // remembers who has requested this and will turn it off for us when we exit.
   XCompositeRedirectWindow(display(), id, CompositeRedirectAutomatic);
 
+  // The next frame is captured in full, as the buffers hold another window.
+  queue_.Reset();
+  DeinitXDamage();
+  InitXDamage();
+
   return true;
 }
 
@@ -278,6 +326,10 @@ void WindowCapturerLinux::Capture(const DesktopRegion& region) {
     return;
   }
 
+  queue_.MoveToNextFrame();
+  RTC_DCHECK(!queue_.current_frame() || !queue_.current_frame()->IsShared());
+
+  // May reset |queue_| if the window has been resized.
   x_display_->ProcessPendingXEvents();
 
   if (!has_composite_extension_) {
@@ -289,15 +341,32 @@ void WindowCapturerLinux::Capture(const DesktopRegion& region) {
     return;
   }
 
-  std::unique_ptr<DesktopFrame> frame(
-      new BasicDesktopFrame(x_server_pixel_buffer_.window_size()));
-
-  x_server_pixel_buffer_.Synchronize();
-  x_server_pixel_buffer_.CaptureRect(DesktopRect::MakeSize(frame->size()),
-                                     frame.get());
-
-  frame->mutable_updated_region()->SetRect(
-      DesktopRect::MakeSize(frame->size()));
+  if (!queue_.current_frame()) {
+    queue_.ReplaceCurrentFrame(
+        SharedDesktopFrame::Wrap(std::unique_ptr<DesktopFrame>(
+            new BasicDesktopFrame(x_server_pixel_buffer_.window_size()))));
+  }
+  std::unique_ptr<SharedDesktopFrame> frame = queue_.current_frame()->Share();
+  DesktopRegion* updated_region = frame->mutable_updated_region();
+
+  if (damage_handle_ && queue_.previous_frame()) {
+    // The damage is fetched before the pixels, so damage reported meanwhile is
+    // captured by the next frame. A static window costs no X server round trip
+    // for pixels at all.
+    TakeDamagedRegion(updated_region);
+    SynchronizeFrame(*updated_region);
+    x_server_pixel_buffer_.CaptureRegion(*updated_region, frame.get());
+  } else {
+    // First capture of the window or after a resize, or no XDamage. The
+    // damage so far is covered by capturing the whole window.
+    if (damage_handle_)
+      XDamageSubtract(display(), damage_handle_, None, None);
+    x_server_pixel_buffer_.Synchronize();
+    x_server_pixel_buffer_.CaptureRect(DesktopRect::MakeSize(frame->size()),
+                                       frame.get());
+    updated_region->SetRect(DesktopRect::MakeSize(frame->size()));
+  }
+  last_invalid_region_ = *updated_region;
 
   callback_->OnCaptureResult(Result::SUCCESS, std::move(frame));
 }
@@ -310,12 +379,92 @@ bool WindowCapturerLinux::HandleXEvent(const XEvent& event) {
       if (!x_server_pixel_buffer_.Init(display(), selected_window_)) {
         LOG(LS_ERROR) << "Failed to initialize pixel buffer after resizing.";
       }
+      // Make sure the frame buffers will be reallocated.
+      queue_.Reset();
       return true;
     }
+  } else if (damage_handle_ &&
+             event.type == damage_event_base_ + XDamageNotify) {
+    // The damage itself is fetched on the next capture.
+    const XDamageNotifyEvent* damage_event =
+        reinterpret_cast<const XDamageNotifyEvent*>(&event);
+    return damage_event->damage == damage_handle_;
   }
   return false;
 }
 
+void WindowCapturerLinux::InitXDamage() {
+  if (!has_damage_extension_)
+    return;
+
+  damage_handle_ =
+      XDamageCreate(display(), selected_window_, XDamageReportNonEmpty);
+  if (!damage_handle_) {
+    LOG(LS_ERROR) << "Unable to initialize XDamage.";
+    return;
+  }
+
+  // Create an XFixes server-side region to collate damage into.
+  damage_region_ = XFixesCreateRegion(display(), 0, 0);
+  if (!damage_region_) {
+    XDamageDestroy(display(), damage_handle_);
+    damage_handle_ = 0;
+    LOG(LS_ERROR) << "Unable to create XFixes region.";
+    return;
+  }
+
+  x_display_->AddEventHandler(damage_event_base_ + XDamageNotify, this);
+}
+
+void WindowCapturerLinux::DeinitXDamage() {
+  // The damage object is already gone if the window has been destroyed.
+  XErrorTrap error_trap(display());
+  if (damage_handle_) {
+    x_display_->RemoveEventHandler(damage_event_base_ + XDamageNotify, this);
+    XDamageDestroy(display(), damage_handle_);
+    damage_handle_ = 0;
+  }
+  if (damage_region_) {
+    XFixesDestroyRegion(display(), damage_region_);
+    damage_region_ = 0;
+  }
+}
+
+void WindowCapturerLinux::TakeDamagedRegion(DesktopRegion* region) {
+  // Atomically fetch and clear the damage region.
+  XDamageSubtract(display(), damage_handle_, None, damage_region_);
+  int rects_num = 0;
+  XRectangle bounds;
+  XRectangle* rects = XFixesFetchRegionAndBounds(display(), damage_region_,
+                                                 &rects_num, &bounds);
+  std::vector<DesktopRect> damage_rects;
+  damage_rects.reserve(rects_num);
+  for (int i = 0; i < rects_num; ++i) {
+    damage_rects.push_back(DesktopRect::MakeXYWH(
+        rects[i].x, rects[i].y, rects[i].width, rects[i].height));
+  }
+  if (rects)
+    XFree(rects);
+  region->AddRects(damage_rects.data(), static_cast<int>(damage_rects.size()));
+
+  // Damage may still be reported for a previous, larger, window size.
+  region->IntersectWith(
+      DesktopRect::MakeSize(x_server_pixel_buffer_.window_size()));
+}
+
+void WindowCapturerLinux::SynchronizeFrame(
+    const DesktopRegion& captured_region) {
+  DesktopFrame* current = queue_.current_frame();
+  DesktopFrame* last = queue_.previous_frame();
+  RTC_DCHECK(current != last);
+  // The pixels in |captured_region| are overwritten by the capture anyway.
+  DesktopRegion copy_region(last_invalid_region_);
+  copy_region.Subtract(captured_region);
+  for (DesktopRegion::Iterator it(copy_region); !it.IsAtEnd(); it.Advance()) {
+    current->CopyPixelsFrom(*last, it.rect().top_left(), it.rect());
+  }
+}
+
 ::Window WindowCapturerLinux::GetApplicationWindow(::Window window) {
   // Get WM_STATE property of the window.
   XWindowProperty<uint32_t> window_state(display(), window, wm_state_atom_);
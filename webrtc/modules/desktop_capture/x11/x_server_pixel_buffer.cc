@@ -14,6 +14,8 @@
 #include <string.h>
 #include <sys/shm.h>
 
+#include <algorithm>
+
 #include "webrtc/modules/desktop_capture/desktop_frame.h"
 #include "webrtc/modules/desktop_capture/x11/x_error_trap.h"
 #include "webrtc/system_wrappers/include/logging.h"
@@ -47,6 +49,10 @@ uint32_t MaskToShift(uint32_t mask) {
   return shift;
 }
 
+// The bounding rectangle of the captured region is fetched on its own, instead
+// of the whole window, if it covers at most this fraction of the window.
+const int kMaxPartialCapturePercent = 50;
+
 // Returns true if |image| is in RGB format.
 bool IsXImageRGBFormat(XImage* image) {
   return image->bits_per_pixel == 32 &&
@@ -103,6 +109,8 @@ bool XServerPixelBuffer::Init(Display* display, Window window) {
   }
 
   window_size_ = DesktopSize(attributes.width, attributes.height);
+  visual_ = attributes.visual;
+  depth_ = attributes.depth;
   window_ = window;
   InitShm(attributes);
 
@@ -256,18 +264,92 @@ void XServerPixelBuffer::CaptureRect(const DesktopRect& rect,
     data = reinterpret_cast<uint8_t*>(x_image_->data);
   }
 
-  if (IsXImageRGBFormat(x_image_)) {
-    FastBlit(data, rect, frame);
+  Blit(x_image_, data, rect, frame);
+}
+
+void XServerPixelBuffer::CaptureRegion(const DesktopRegion& region,
+                                       DesktopFrame* frame) {
+  if (region.is_empty())
+    return;
+
+  if (shm_segment_info_ && !shm_pixmap_) {
+    int left = window_size_.width();
+    int top = window_size_.height();
+    int right = 0;
+    int bottom = 0;
+    for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance()) {
+      left = std::min(left, it.rect().left());
+      top = std::min(top, it.rect().top());
+      right = std::max(right, it.rect().right());
+      bottom = std::max(bottom, it.rect().bottom());
+    }
+    DesktopRect bounds = DesktopRect::MakeLTRB(left, top, right, bottom);
+    if (static_cast<int64_t>(bounds.width()) * bounds.height() * 100 <=
+            static_cast<int64_t>(window_size_.width()) *
+                window_size_.height() * kMaxPartialCapturePercent &&
+        CaptureBoundsWithShm(region, bounds, frame)) {
+      return;
+    }
+  }
+
+  Synchronize();
+  for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance())
+    CaptureRect(it.rect(), frame);
+}
+
+bool XServerPixelBuffer::CaptureBoundsWithShm(const DesktopRegion& region,
+                                              const DesktopRect& bounds,
+                                              DesktopFrame* frame) {
+  // The shared memory segment is large enough for the whole window, so an
+  // image of the size of |bounds| fits at its start.
+  XImage* image = XShmCreateImage(display_, visual_, depth_, ZPixmap,
+                                  shm_segment_info_->shmaddr,
+                                  shm_segment_info_, bounds.width(),
+                                  bounds.height());
+  if (!image)
+    return false;
+
+  bool succeeded;
+  {
+    XErrorTrap error_trap(display_);
+    succeeded = XShmGetImage(display_, window_, image, bounds.left(),
+                             bounds.top(), AllPlanes) &&
+                error_trap.GetLastErrorAndDisable() == 0;
+  }
+  // The segment no longer holds the whole window.
+  xshm_get_image_succeeded_ = false;
+
+  if (succeeded) {
+    for (DesktopRegion::Iterator it(region); !it.IsAtEnd(); it.Advance()) {
+      const DesktopRect& rect = it.rect();
+      uint8_t* data = reinterpret_cast<uint8_t*>(image->data) +
+                      (rect.top() - bounds.top()) * image->bytes_per_line +
+                      (rect.left() - bounds.left()) * image->bits_per_pixel / 8;
+      Blit(image, data, rect, frame);
+    }
+  }
+  // Doesn't free the shared memory, which is owned by |shm_segment_info_|.
+  XDestroyImage(image);
+  return succeeded;
+}
+
+void XServerPixelBuffer::Blit(XImage* image,
+                              uint8_t* data,
+                              const DesktopRect& rect,
+                              DesktopFrame* frame) {
+  if (IsXImageRGBFormat(image)) {
+    FastBlit(image, data, rect, frame);
   } else {
-    SlowBlit(data, rect, frame);
+    SlowBlit(image, data, rect, frame);
   }
 }
 
-void XServerPixelBuffer::FastBlit(uint8_t* image,
+void XServerPixelBuffer::FastBlit(XImage* x_image,
+                                  uint8_t* image,
                                   const DesktopRect& rect,
                                   DesktopFrame* frame) {
   uint8_t* src_pos = image;
-  int src_stride = x_image_->bytes_per_line;
+  int src_stride = x_image->bytes_per_line;
   int dst_x = rect.left(), dst_y = rect.top();
 
   uint8_t* dst_pos = frame->data() + frame->stride() * dst_y;
@@ -282,22 +364,23 @@ void XServerPixelBuffer::FastBlit(uint8_t* image,
   }
 }
 
-void XServerPixelBuffer::SlowBlit(uint8_t* image,
+void XServerPixelBuffer::SlowBlit(XImage* x_image,
+                                  uint8_t* image,
                                   const DesktopRect& rect,
                                   DesktopFrame* frame) {
-  int src_stride = x_image_->bytes_per_line;
+  int src_stride = x_image->bytes_per_line;
   int dst_x = rect.left(), dst_y = rect.top();
   int width = rect.width(), height = rect.height();
 
-  uint32_t red_mask = x_image_->red_mask;
-  uint32_t green_mask = x_image_->red_mask;
-  uint32_t blue_mask = x_image_->blue_mask;
+  uint32_t red_mask = x_image->red_mask;
+  uint32_t green_mask = x_image->red_mask;
+  uint32_t blue_mask = x_image->blue_mask;
 
   uint32_t red_shift = MaskToShift(red_mask);
   uint32_t green_shift = MaskToShift(green_mask);
   uint32_t blue_shift = MaskToShift(blue_mask);
 
-  int bits_per_pixel = x_image_->bits_per_pixel;
+  int bits_per_pixel = x_image->bits_per_pixel;
 
   uint8_t* dst_pos = frame->data() + frame->stride() * dst_y;
   uint8_t* src_pos = image;
@@ -15,6 +15,7 @@
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/desktop_capture/desktop_geometry.h"
+#include "webrtc/modules/desktop_capture/desktop_region.h"
 
 #include <X11/Xutil.h>
 #include <X11/extensions/XShm.h>
@@ -57,22 +58,47 @@ class XServerPixelBuffer {
   // that |rect| is not larger than window_size().
   void CaptureRect(const DesktopRect& rect, DesktopFrame* frame);
 
+  // Capture |region| and store it in the |frame|, synchronizing the pixel
+  // buffer as needed. When shared memory is used without pixmaps and the
+  // bounding rectangle of |region| is small compared to the window, only that
+  // rectangle is fetched from the X server instead of the whole window. The
+  // caller must ensure that |region| is within window_size().
+  void CaptureRegion(const DesktopRegion& region, DesktopFrame* frame);
+
  private:
   void InitShm(const XWindowAttributes& attributes);
   bool InitPixmaps(int depth);
 
+  // Fetch |bounds| into the shared memory segment and store |region|, which
+  // must be within |bounds|, in the |frame|. Returns false if the X server
+  // failed to provide the image.
+  bool CaptureBoundsWithShm(const DesktopRegion& region,
+                            const DesktopRect& bounds,
+                            DesktopFrame* frame);
+
+  // Copy |rect| from |data|, which points to the top left pixel of |rect| in
+  // |image|, to the |frame|.
+  void Blit(XImage* image,
+            uint8_t* data,
+            const DesktopRect& rect,
+            DesktopFrame* frame);
+
   // We expose two forms of blitting to handle variations in the pixel format.
   // In FastBlit(), the operation is effectively a memcpy.
-  void FastBlit(uint8_t* image,
+  void FastBlit(XImage* x_image,
+                uint8_t* image,
                 const DesktopRect& rect,
                 DesktopFrame* frame);
-  void SlowBlit(uint8_t* image,
+  void SlowBlit(XImage* x_image,
+                uint8_t* image,
                 const DesktopRect& rect,
                 DesktopFrame* frame);
 
   Display* display_ = nullptr;
   Window window_ = 0;
   DesktopSize window_size_;
+  Visual* visual_ = nullptr;
+  int depth_ = 0;
   XImage* x_image_ = nullptr;
   XShmSegmentInfo* shm_segment_info_ = nullptr;
   Pixmap shm_pixmap_ = 0;
@@ -656,14 +656,11 @@ inline AudioFrame& AudioFrame::operator>>=(const int rhs) {
 }
 
 namespace {
+// Clamps without branches, so that loops over samples can be vectorized.
 inline int16_t ClampToInt16(int32_t input) {
-  if (input < -0x00008000) {
-    return -0x8000;
-  } else if (input > 0x00007FFF) {
-    return 0x7FFF;
-  } else {
-    return static_cast<int16_t>(input);
-  }
+  return static_cast<int16_t>(
+      std::min(std::max(input, static_cast<int32_t>(-0x8000)),
+               static_cast<int32_t>(0x7FFF)));
 }
 }
 
@@ -696,7 +693,6 @@ inline AudioFrame& AudioFrame::operator+=(const AudioFrame& rhs) {
     memcpy(data_, rhs.data_,
            sizeof(int16_t) * rhs.samples_per_channel_ * num_channels_);
   } else {
-    // IMPROVEMENT this can be done very fast in assembly
     for (size_t i = 0; i < samples_per_channel_ * num_channels_; i++) {
       int32_t wrap_guard =
           static_cast<int32_t>(data_[i]) + static_cast<int32_t>(rhs.data_[i]);
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/pacing/alr_detector.h"
+
+#include "webrtc/base/checks.h"
+
+namespace {
+
+// Time period over which outgoing traffic is measured.
+constexpr int kMeasurementPeriodMs = 500;
+
+// Sent traffic as a percentage of the estimated network capacity, used to
+// determine the application-limited region. The region starts when usage drops
+// below kAlrStartUsagePercent and ends when it rises above kAlrEndUsagePercent.
+constexpr int kAlrStartUsagePercent = 30;
+constexpr int kAlrEndUsagePercent = 50;
+
+}  // namespace
+
+namespace webrtc {
+
+AlrDetector::AlrDetector()
+    : rate_(kMeasurementPeriodMs, RateStatistics::kBpsScale),
+      estimated_bitrate_bps_(0) {}
+
+AlrDetector::~AlrDetector() {}
+
+void AlrDetector::OnBytesSent(size_t bytes_sent, int64_t now_ms) {
+  rate_.Update(bytes_sent, now_ms);
+  rtc::Optional<uint32_t> rate = rate_.Rate(now_ms);
+  if (!rate || estimated_bitrate_bps_ == 0)
+    return;
+
+  int64_t percentage =
+      static_cast<int64_t>(*rate) * 100 / estimated_bitrate_bps_;
+  if (percentage < kAlrStartUsagePercent && !alr_started_time_ms_) {
+    alr_started_time_ms_ = rtc::Optional<int64_t>(now_ms);
+  } else if (percentage > kAlrEndUsagePercent && alr_started_time_ms_) {
+    alr_started_time_ms_ = rtc::Optional<int64_t>();
+  }
+}
+
+void AlrDetector::SetEstimatedBitrate(int bitrate_bps) {
+  RTC_DCHECK_GT(bitrate_bps, 0);
+  estimated_bitrate_bps_ = bitrate_bps;
+}
+
+rtc::Optional<int64_t> AlrDetector::GetApplicationLimitedRegionStartTime()
+    const {
+  return alr_started_time_ms_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_PACING_ALR_DETECTOR_H_
+#define WEBRTC_MODULES_PACING_ALR_DETECTOR_H_
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/optional.h"
+#include "webrtc/base/rate_statistics.h"
+#include "webrtc/typedefs.h"
+
+namespace webrtc {
+
+// Detects whether the outgoing traffic is currently limited by what the
+// application produces rather than by the network, i.e. whether the sender is
+// in an application-limited region (ALR). This is done by comparing the rate of
+// the media sent over the last 500 ms to the estimated bitrate, which is what
+// the pacer's media budget is derived from.
+//
+// Note that this class isn't thread-safe by itself and therefore relies
+// on being protected by the caller.
+class AlrDetector {
+ public:
+  AlrDetector();
+  ~AlrDetector();
+
+  // Reports |bytes_sent| media bytes at |now_ms|. Should be called regularly,
+  // also with zero bytes, so that idle periods are detected.
+  void OnBytesSent(size_t bytes_sent, int64_t now_ms);
+
+  // Sets the current estimated bitrate.
+  void SetEstimatedBitrate(int bitrate_bps);
+
+  // Returns the time in milliseconds when the current application-limited
+  // region started, or an empty result if the sender is currently not
+  // application-limited.
+  rtc::Optional<int64_t> GetApplicationLimitedRegionStartTime() const;
+
+ private:
+  RateStatistics rate_;
+  int estimated_bitrate_bps_;
+
+  // Set while in an application-limited region.
+  rtc::Optional<int64_t> alr_started_time_ms_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AlrDetector);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_PACING_ALR_DETECTOR_H_
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/pacing/alr_detector.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kEstimatedBitrateBps = 300000;
+constexpr int64_t kTimeStepMs = 10;
+
+}  // namespace
+
+class AlrDetectorTest : public testing::Test {
+ public:
+  AlrDetectorTest() : now_ms_(1) {
+    alr_detector_.SetEstimatedBitrate(kEstimatedBitrateBps);
+  }
+
+  // Sends at |usage_percent| of the estimated bitrate for |duration_ms|.
+  void SimulateOutgoingTraffic(int usage_percent, int64_t duration_ms) {
+    const size_t kBytesPerStep =
+        kEstimatedBitrateBps * usage_percent / 100 * kTimeStepMs / 8000;
+    for (int64_t end_ms = now_ms_ + duration_ms; now_ms_ < end_ms;
+         now_ms_ += kTimeStepMs) {
+      alr_detector_.OnBytesSent(kBytesPerStep, now_ms_);
+    }
+  }
+
+ protected:
+  AlrDetector alr_detector_;
+  int64_t now_ms_;
+};
+
+TEST_F(AlrDetectorTest, AlrDetection) {
+  // Start in non-ALR state.
+  EXPECT_FALSE(alr_detector_.GetApplicationLimitedRegionStartTime());
+
+  // Stay in non-ALR state when usage is close to 100%.
+  SimulateOutgoingTraffic(90, 1000);
+  EXPECT_FALSE(alr_detector_.GetApplicationLimitedRegionStartTime());
+
+  // ALR starts when usage drops to 20%.
+  SimulateOutgoingTraffic(20, 1000);
+  rtc::Optional<int64_t> alr_start_time =
+      alr_detector_.GetApplicationLimitedRegionStartTime();
+  ASSERT_TRUE(alr_start_time);
+  EXPECT_LT(*alr_start_time, now_ms_);
+
+  // The region continues while usage stays low.
+  SimulateOutgoingTraffic(0, 1000);
+  EXPECT_EQ(alr_start_time,
+            alr_detector_.GetApplicationLimitedRegionStartTime());
+
+  // ALR ends when usage is back at 90%.
+  SimulateOutgoingTraffic(90, 1000);
+  EXPECT_FALSE(alr_detector_.GetApplicationLimitedRegionStartTime());
+}
+
+TEST_F(AlrDetectorTest, ShortSpikeDoesNotEndAlr) {
+  SimulateOutgoingTraffic(20, 1000);
+  ASSERT_TRUE(alr_detector_.GetApplicationLimitedRegionStartTime());
+
+  // A single burst, such as a key frame, is averaged over the measurement
+  // window.
+  alr_detector_.OnBytesSent(kEstimatedBitrateBps / 8 / 10, now_ms_);
+  SimulateOutgoingTraffic(20, 1000);
+  EXPECT_TRUE(alr_detector_.GetApplicationLimitedRegionStartTime());
+}
+
+TEST_F(AlrDetectorTest, FollowsEstimatedBitrate) {
+  SimulateOutgoingTraffic(50, 1000);
+  EXPECT_FALSE(alr_detector_.GetApplicationLimitedRegionStartTime());
+
+  // The same traffic is application-limited once the estimate grows.
+  alr_detector_.SetEstimatedBitrate(4 * kEstimatedBitrateBps);
+  SimulateOutgoingTraffic(50, 1000);
+  EXPECT_TRUE(alr_detector_.GetApplicationLimitedRegionStartTime());
+}
+
+}  // namespace webrtc
@@ -23,6 +23,11 @@ namespace {
 // Inactivity threshold above which probing is restarted.
 constexpr int kInactivityThresholdMs = 5000;
 
+// The minimum time a probe cluster lasts, given the data it has to send at its
+// bitrate. Without it, a cluster of a few packets at a high bitrate would be
+// sent within a millisecond or two, too short to measure reliably.
+constexpr int kMinProbeDurationMs = 15;
+
 int ComputeDeltaFromBitrate(size_t packet_size, uint32_t bitrate_bps) {
   RTC_CHECK_GT(bitrate_bps, 0u);
   // Compute the time delta needed to send packet_size bytes at bitrate_bps
@@ -35,6 +40,7 @@ BitrateProber::BitrateProber()
     : probing_state_(ProbingState::kDisabled),
       packet_size_last_sent_(0),
       time_last_probe_sent_ms_(-1),
+      probe_bytes_last_sent_(0),
       next_cluster_id_(0) {
   SetEnabled(true);
 }
@@ -68,13 +74,15 @@ void BitrateProber::OnIncomingPacket(size_t packet_size) {
 void BitrateProber::CreateProbeCluster(int bitrate_bps, int num_packets) {
   RTC_DCHECK(probing_state_ != ProbingState::kDisabled);
   ProbeCluster cluster;
-  cluster.max_probe_packets = num_packets;
+  cluster.min_probe_packets = num_packets;
+  cluster.min_probe_bytes =
+      static_cast<int64_t>(bitrate_bps) * kMinProbeDurationMs / 8000;
   cluster.probe_bitrate_bps = bitrate_bps;
   cluster.id = next_cluster_id_++;
   clusters_.push(cluster);
-  LOG(LS_INFO) << "Probe cluster (bitrate:packets): ("
-               << cluster.probe_bitrate_bps << ":" << cluster.max_probe_packets
-               << ") ";
+  LOG(LS_INFO) << "Probe cluster (bitrate:packets:bytes): ("
+               << cluster.probe_bitrate_bps << ":" << cluster.min_probe_packets
+               << ":" << cluster.min_probe_bytes << ") ";
   if (probing_state_ != ProbingState::kActive)
     probing_state_ = ProbingState::kInactive;
 }
@@ -82,13 +90,14 @@ void BitrateProber::CreateProbeCluster(int bitrate_bps, int num_packets) {
 void BitrateProber::ResetState() {
   time_last_probe_sent_ms_ = -1;
   packet_size_last_sent_ = 0;
+  probe_bytes_last_sent_ = 0;
 
   // Recreate all probing clusters.
   std::queue<ProbeCluster> clusters;
   clusters.swap(clusters_);
   while (!clusters.empty()) {
     CreateProbeCluster(clusters.front().probe_bitrate_bps,
-                       clusters.front().max_probe_packets);
+                       clusters.front().min_probe_packets);
     clusters.pop();
   }
   // If its enabled, reset to inactive.
@@ -117,19 +126,21 @@ int BitrateProber::TimeUntilNextProbe(int64_t now_ms) {
   // sent before.
   int time_until_probe_ms = 0;
   if (packet_size_last_sent_ != 0 && probing_state_ == ProbingState::kActive) {
+    size_t bytes_last_sent = time_last_probe_sent_ms_ == -1
+                                 ? packet_size_last_sent_
+                                 : probe_bytes_last_sent_;
+    // If sending the last probes takes less than a millisecond at this
+    // bitrate, |next_delta_ms| is zero and more probes are sent right away,
+    // until they add up to at least a millisecond.
     int next_delta_ms = ComputeDeltaFromBitrate(
-        packet_size_last_sent_, clusters_.front().probe_bitrate_bps);
+        bytes_last_sent, clusters_.front().probe_bitrate_bps);
     time_until_probe_ms = next_delta_ms - elapsed_time_ms;
-    // There is no point in trying to probe with less than 1 ms between packets
-    // as it essentially means trying to probe at infinite bandwidth.
-    const int kMinProbeDeltaMs = 1;
     // If we have waited more than 3 ms for a new packet to probe with we will
     // consider this probing session over.
     const int kMaxProbeDelayMs = 3;
-    if (next_delta_ms < kMinProbeDeltaMs ||
-        time_until_probe_ms < -kMaxProbeDelayMs) {
+    if (time_until_probe_ms < -kMaxProbeDelayMs) {
       probing_state_ = ProbingState::kSuspended;
-      LOG(LS_INFO) << "Delta too small or missed probing accurately, suspend";
+      LOG(LS_INFO) << "Missed probing accurately, suspend";
       time_until_probe_ms = 0;
     }
   }
@@ -153,12 +164,20 @@ void BitrateProber::PacketSent(int64_t now_ms, size_t packet_size) {
   packet_size_last_sent_ = packet_size;
   if (probing_state_ != ProbingState::kActive)
     return;
+  if (now_ms == time_last_probe_sent_ms_) {
+    probe_bytes_last_sent_ += packet_size;
+  } else {
+    probe_bytes_last_sent_ = packet_size;
+  }
   time_last_probe_sent_ms_ = now_ms;
   if (!clusters_.empty()) {
     ProbeCluster* cluster = &clusters_.front();
     ++cluster->sent_probe_packets;
-    if (cluster->sent_probe_packets == cluster->max_probe_packets)
+    cluster->sent_probe_bytes += packet_size;
+    if (cluster->sent_probe_packets >= cluster->min_probe_packets &&
+        cluster->sent_probe_bytes >= cluster->min_probe_bytes) {
       clusters_.pop();
+    }
     if (clusters_.empty())
       probing_state_ = ProbingState::kSuspended;
   }
@@ -36,8 +36,10 @@ class BitrateProber {
   // with.
   void OnIncomingPacket(size_t packet_size);
 
-  // Create a cluster used to probe for |bitrate_bps| with |num_packets| number
-  // of packets.
+  // Create a cluster used to probe for |bitrate_bps| with at least
+  // |num_packets| packets. The cluster also lasts at least long enough to send
+  // kMinProbeDurationMs worth of data at |bitrate_bps|, so that high bitrates
+  // are probed over a measurable time span.
   void CreateProbeCluster(int bitrate_bps, int num_packets);
 
   // Returns the number of milliseconds until the next packet should be sent to
@@ -70,8 +72,10 @@ class BitrateProber {
   };
 
   struct ProbeCluster {
-    int max_probe_packets = 0;
+    int min_probe_packets = 0;
     int sent_probe_packets = 0;
+    size_t min_probe_bytes = 0;
+    size_t sent_probe_bytes = 0;
     int probe_bitrate_bps = 0;
     int id = -1;
   };
@@ -87,6 +91,10 @@ class BitrateProber {
   size_t packet_size_last_sent_;
   // The last time a probe was sent.
   int64_t time_last_probe_sent_ms_;
+  // The bytes of all probes sent at |time_last_probe_sent_ms_|. When probing at
+  // bitrates where a single packet takes less than a millisecond to send,
+  // several probes are sent at once before waiting for the next one.
+  size_t probe_bytes_last_sent_;
   int next_cluster_id_;
 };
 }  // namespace webrtc
@@ -84,6 +84,51 @@ TEST(BitrateProberTest, DoesntProbeWithoutRecentPackets) {
   EXPECT_GT(prober.TimeUntilNextProbe(now_ms), 0);
 }
 
+TEST(BitrateProberTest, ProbeClusterLastsMinimumDuration) {
+  BitrateProber prober;
+  const int kBitrateBps = 4000000;  // 500 bytes per ms.
+  const size_t kPacketSize = 1000;
+
+  prober.CreateProbeCluster(kBitrateBps, 6);
+  prober.OnIncomingPacket(kPacketSize);
+  ASSERT_TRUE(prober.IsProbing());
+
+  // Six packets aren't enough to probe for 15 ms at this bitrate.
+  int64_t now_ms = 0;
+  int num_packets = 0;
+  while (prober.IsProbing()) {
+    now_ms += prober.TimeUntilNextProbe(now_ms);
+    prober.PacketSent(now_ms, kPacketSize);
+    ++num_packets;
+  }
+  EXPECT_EQ(8, num_packets);
+  EXPECT_EQ(14, now_ms);
+}
+
+TEST(BitrateProberTest, SendsSeveralProbesPerMsAtHighBitrates) {
+  BitrateProber prober;
+  const int kBitrateBps = 40000000;  // 5000 bytes per ms.
+  const size_t kPacketSize = 1000;
+
+  prober.CreateProbeCluster(kBitrateBps, 6);
+  prober.OnIncomingPacket(kPacketSize);
+  ASSERT_TRUE(prober.IsProbing());
+
+  int64_t now_ms = 0;
+  size_t bytes_sent = 0;
+  while (prober.IsProbing()) {
+    int time_until_probe_ms = prober.TimeUntilNextProbe(now_ms);
+    ASSERT_GE(time_until_probe_ms, 0);
+    ASSERT_LE(time_until_probe_ms, 1);
+    now_ms += time_until_probe_ms;
+    prober.PacketSent(now_ms, kPacketSize);
+    bytes_sent += kPacketSize;
+  }
+  // The whole cluster is sent, over 15 ms at the requested bitrate.
+  EXPECT_EQ(75000u, bytes_sent);
+  EXPECT_EQ(14, now_ms);
+}
+
 TEST(BitrateProberTest, DoesntInitializeProbingForSmallPackets) {
   BitrateProber prober;
   prober.SetEnabled(true);
@@ -10,28 +10,49 @@
 
 #include "webrtc/modules/pacing/paced_sender.h"
 
+#include <stdio.h>
+
 #include <algorithm>
+#include <bitset>
+#include <deque>
 #include <map>
 #include <queue>
-#include <set>
+#include <string>
 #include <vector>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/pacing/alr_detector.h"
 #include "webrtc/modules/pacing/bitrate_prober.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/system_wrappers/include/metrics.h"
 
 namespace {
-// Time limit in milliseconds between packet bursts.
+// Default time limit in milliseconds between packet bursts.
 const int64_t kMinPacketLimitMs = 5;
 
+const char kProcessIntervalExperiment[] = "WebRTC-PacerProcessInterval";
+
 // Upper cap on process interval, in case process has not been called in a long
 // time.
 const int64_t kMaxIntervalTimeMs = 30;
 
+// Gets the process interval from the experiment name following the format
+// "WebRTC-PacerProcessInterval/Enabled-1/".
+int64_t ProcessIntervalMsFromExperiment() {
+  std::string experiment_string =
+      webrtc::field_trial::FindFullName(kProcessIntervalExperiment);
+  int interval_ms;
+  if (sscanf(experiment_string.c_str(), "Enabled-%d", &interval_ms) != 1 ||
+      interval_ms < 1 || interval_ms > kMinPacketLimitMs) {
+    return kMinPacketLimitMs;
+  }
+  return interval_ms;
+}
+
 }  // namespace
 
 // TODO(sprang): Move at least PacketQueue and MediaBudget out to separate
@@ -55,7 +76,9 @@ struct Packet {
         enqueue_time_ms(enqueue_time_ms),
         bytes(length_in_bytes),
         retransmission(retransmission),
-        enqueue_order(enqueue_order) {}
+        enqueue_order(enqueue_order),
+        older(nullptr),
+        newer(nullptr) {}
 
   RtpPacketSender::Priority priority;
   uint32_t ssrc;
@@ -65,7 +88,9 @@ struct Packet {
   size_t bytes;
   bool retransmission;
   uint64_t enqueue_order;
-  std::list<Packet>::iterator this_it;
+  // Neighbours in enqueue order, for O(1) removal when popping from queue.
+  Packet* older;
+  Packet* newer;
 };
 
 // Used by priority queue to sort packets.
@@ -88,10 +113,16 @@ struct Comparator {
 };
 
 // Class encapsulating a priority queue with some extensions.
+// Packets are stored in a pool that is reused once it has grown to the peak
+// queue size, so that pushing and popping doesn't allocate while congested.
 class PacketQueue {
  public:
   explicit PacketQueue(Clock* clock)
       : bytes_(0),
+        oldest_(nullptr),
+        newest_(nullptr),
+        num_packets_(0),
+        popped_packet_(nullptr),
         clock_(clock),
         queue_time_sum_(0),
         time_last_updated_(clock_->TimeInMilliseconds()) {}
@@ -103,31 +134,56 @@ class PacketQueue {
 
     UpdateQueueTime(packet.enqueue_time_ms);
 
-    // Store packet in list, use pointers in priority queue for cheaper moves.
-    // Packets have a handle to its own iterator in the list, for easy removal
-    // when popping from queue.
-    packet_list_.push_front(packet);
-    std::list<Packet>::iterator it = packet_list_.begin();
-    it->this_it = it;          // Handle for direct removal from list.
-    prio_queue_.push(&(*it));  // Pointer into list.
+    // Store packet in the pool, use pointers in priority queue for cheaper
+    // moves. Packets are linked to their neighbours in enqueue order, for
+    // easy removal when popping from queue.
+    Packet* stored = AllocatePacket(packet);
+    stored->older = newest_;
+    stored->newer = nullptr;
+    if (newest_)
+      newest_->newer = stored;
+    else
+      oldest_ = stored;
+    newest_ = stored;
+    ++num_packets_;
+    prio_queue_.push(stored);
     bytes_ += packet.bytes;
   }
 
+  // Only one packet may be popped at a time; it stays in storage until
+  // either CancelPop() or FinalizePop() is called.
   const Packet& BeginPop() {
-    const Packet& packet = *prio_queue_.top();
+    RTC_DCHECK(!popped_packet_);
+    popped_packet_ = prio_queue_.top();
     prio_queue_.pop();
-    return packet;
+    return *popped_packet_;
   }
 
-  void CancelPop(const Packet& packet) { prio_queue_.push(&(*packet.this_it)); }
+  void CancelPop(const Packet& packet) {
+    RTC_DCHECK_EQ(popped_packet_, &packet);
+    prio_queue_.push(popped_packet_);
+    popped_packet_ = nullptr;
+  }
 
   void FinalizePop(const Packet& packet) {
-    RemoveFromDupeSet(packet);
-    bytes_ -= packet.bytes;
-    queue_time_sum_ -= (time_last_updated_ - packet.enqueue_time_ms);
-    packet_list_.erase(packet.this_it);
-    RTC_DCHECK_EQ(packet_list_.size(), prio_queue_.size());
-    if (packet_list_.empty())
+    RTC_DCHECK_EQ(popped_packet_, &packet);
+    Packet* popped = popped_packet_;
+    popped_packet_ = nullptr;
+    RemoveFromDupeSet(*popped);
+    bytes_ -= popped->bytes;
+    queue_time_sum_ -= (time_last_updated_ - popped->enqueue_time_ms);
+    if (popped->older)
+      popped->older->newer = popped->newer;
+    else
+      oldest_ = popped->newer;
+    if (popped->newer)
+      popped->newer->older = popped->older;
+    else
+      newest_ = popped->older;
+    --num_packets_;
+    free_packets_.push_back(popped);
+    RTC_DCHECK_EQ(num_packets_, prio_queue_.size());
+    if (num_packets_ == 0)
       RTC_DCHECK_EQ(0u, queue_time_sum_);
   }
 
@@ -138,62 +194,81 @@ class PacketQueue {
   uint64_t SizeInBytes() const { return bytes_; }
 
   int64_t OldestEnqueueTimeMs() const {
-    auto it = packet_list_.rbegin();
-    if (it == packet_list_.rend())
+    if (!oldest_)
       return 0;
-    return it->enqueue_time_ms;
+    return oldest_->enqueue_time_ms;
   }
 
   void UpdateQueueTime(int64_t timestamp_ms) {
     RTC_DCHECK_GE(timestamp_ms, time_last_updated_);
     int64_t delta = timestamp_ms - time_last_updated_;
-    // Use packet packet_list_.size() not prio_queue_.size() here, as there
-    // might be an outstanding element popped from prio_queue_ currently in the
-    // SendPacket() call, while packet_list_ will always be correct.
-    queue_time_sum_ += delta * packet_list_.size();
+    // Use num_packets_ not prio_queue_.size() here, as there might be an
+    // outstanding element popped from prio_queue_ currently in the
+    // SendPacket() call, while num_packets_ will always be correct.
+    queue_time_sum_ += delta * num_packets_;
     time_last_updated_ = timestamp_ms;
   }
 
   int64_t AverageQueueTimeMs() const {
     if (prio_queue_.empty())
       return 0;
-    return queue_time_sum_ / packet_list_.size();
+    return queue_time_sum_ / num_packets_;
   }
 
  private:
+  // One bit per sequence number.
+  typedef std::bitset<1 << 16> SeqNoSet;
+
+  Packet* AllocatePacket(const Packet& packet) {
+    if (free_packets_.empty()) {
+      // Growing a deque at the end doesn't move the stored packets.
+      packet_pool_.push_back(packet);
+      return &packet_pool_.back();
+    }
+    Packet* stored = free_packets_.back();
+    free_packets_.pop_back();
+    *stored = packet;
+    return stored;
+  }
+
   // Try to add a packet to the set of ssrc/seqno identifiers currently in the
   // queue. Return true if inserted, false if this is a duplicate.
   bool AddToDupeSet(const Packet& packet) {
-    SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
-    if (it == dupe_map_.end()) {
-      // First for this ssrc, just insert.
-      dupe_map_[packet.ssrc].insert(packet.sequence_number);
-      return true;
-    }
-
-    // Insert returns a pair, where second is a bool set to true if new element.
-    return it->second.insert(packet.sequence_number).second;
+    // The set of an ssrc is created the first time it is seen and then kept,
+    // so that only new ssrcs allocate.
+    SeqNoSet::reference queued =
+        dupe_map_[packet.ssrc][packet.sequence_number];
+    if (queued)
+      return false;
+    queued = true;
+    return true;
   }
 
   void RemoveFromDupeSet(const Packet& packet) {
     SsrcSeqNoMap::iterator it = dupe_map_.find(packet.ssrc);
     RTC_DCHECK(it != dupe_map_.end());
-    it->second.erase(packet.sequence_number);
-    if (it->second.empty()) {
-      dupe_map_.erase(it);
-    }
+    RTC_DCHECK(it->second[packet.sequence_number]);
+    it->second.reset(packet.sequence_number);
   }
 
-  // List of packets, in the order the were enqueued. Since dequeueing may
-  // occur out of order, use list instead of vector.
-  std::list<Packet> packet_list_;
+  // Storage for the queued packets, and those of its slots that are free.
+  std::deque<Packet> packet_pool_;
+  std::vector<Packet*> free_packets_;
   // Priority queue of the packets, sorted according to Comparator.
-  // Use pointers into list, to avoid moving whole struct within heap.
+  // Use pointers into the pool, to avoid moving whole struct within heap.
   std::priority_queue<Packet*, std::vector<Packet*>, Comparator> prio_queue_;
   // Total number of bytes in the queue.
   uint64_t bytes_;
+  // Queued packets, in the order they were enqueued. Since dequeueing may
+  // occur out of order, they are doubly linked.
+  Packet* oldest_;
+  Packet* newest_;
+  // Number of queued packets, including one that may be popped but not yet
+  // finalized.
+  size_t num_packets_;
+  Packet* popped_packet_;
   // Map<ssrc, set<seq_no> >, for checking duplicates.
-  typedef std::map<uint32_t, std::set<uint16_t> > SsrcSeqNoMap;
+  typedef std::map<uint32_t, SeqNoSet> SsrcSeqNoMap;
   SsrcSeqNoMap dupe_map_;
   Clock* const clock_;
   int64_t queue_time_sum_;
@@ -252,15 +327,20 @@ PacedSender::PacedSender(Clock* clock, PacketSender* packet_sender)
       paused_(false),
       media_budget_(new paced_sender::IntervalBudget(0)),
       padding_budget_(new paced_sender::IntervalBudget(0)),
+      alr_detector_(new AlrDetector()),
       prober_(new BitrateProber()),
       estimated_bitrate_bps_(0),
       min_send_bitrate_kbps_(0u),
       max_padding_bitrate_kbps_(0u),
       pacing_bitrate_kbps_(0),
       time_last_update_us_(clock->TimeInMicroseconds()),
+      process_interval_ms_(ProcessIntervalMsFromExperiment()),
+      burst_packets_(0),
+      burst_time_ms_(-1),
+      last_burst_time_ms_(-1),
       packets_(new paced_sender::PacketQueue(clock)),
       packet_counter_(0) {
-  UpdateBytesPerInterval(kMinPacketLimitMs);
+  UpdateBytesPerInterval(process_interval_ms_);
 }
 
 PacedSender::~PacedSender() {}
@@ -282,6 +362,13 @@ void PacedSender::Resume() {
   paused_ = false;
 }
 
+void PacedSender::SetProcessIntervalMs(int64_t process_interval_ms) {
+  RTC_DCHECK_GE(process_interval_ms, 1);
+  RTC_DCHECK_LE(process_interval_ms, kMaxIntervalTimeMs);
+  CriticalSectionScoped cs(critsect_.get());
+  process_interval_ms_ = process_interval_ms;
+}
+
 void PacedSender::SetProbingEnabled(bool enabled) {
   RTC_CHECK_EQ(0u, packet_counter_);
   CriticalSectionScoped cs(critsect_.get());
@@ -293,6 +380,8 @@ void PacedSender::SetEstimatedBitrate(uint32_t bitrate_bps) {
     LOG(LS_ERROR) << "PacedSender is not designed to handle 0 bitrate.";
   CriticalSectionScoped cs(critsect_.get());
   estimated_bitrate_bps_ = bitrate_bps;
+  if (bitrate_bps > 0)
+    alr_detector_->SetEstimatedBitrate(bitrate_bps);
   padding_budget_->set_target_rate_kbps(
       std::min(estimated_bitrate_bps_ / 1000, max_padding_bitrate_kbps_));
   pacing_bitrate_kbps_ =
@@ -361,6 +450,12 @@ int64_t PacedSender::AverageQueueTimeMs() {
   return packets_->AverageQueueTimeMs();
 }
 
+rtc::Optional<int64_t> PacedSender::GetApplicationLimitedRegionStartTime()
+    const {
+  CriticalSectionScoped cs(critsect_.get());
+  return alr_detector_->GetApplicationLimitedRegionStartTime();
+}
+
 int64_t PacedSender::TimeUntilNextProcess() {
   CriticalSectionScoped cs(critsect_.get());
   if (prober_->IsProbing()) {
@@ -370,7 +465,7 @@ int64_t PacedSender::TimeUntilNextProcess() {
   }
   int64_t elapsed_time_us = clock_->TimeInMicroseconds() - time_last_update_us_;
   int64_t elapsed_time_ms = (elapsed_time_us + 500) / 1000;
-  return std::max<int64_t>(kMinPacketLimitMs - elapsed_time_ms, 0);
+  return std::max<int64_t>(process_interval_ms_ - elapsed_time_ms, 0);
 }
 
 void PacedSender::Process() {
@@ -378,6 +473,7 @@ void PacedSender::Process() {
   CriticalSectionScoped cs(critsect_.get());
   int64_t elapsed_time_ms = (now_us - time_last_update_us_ + 500) / 1000;
   time_last_update_us_ = now_us;
+  UpdateBurstStats(now_us / 1000);
   int target_bitrate_kbps = pacing_bitrate_kbps_;
   // TODO(holmer): Remove the !paused_ check when issue 5307 has been fixed.
   if (!paused_ && elapsed_time_ms > 0) {
@@ -399,6 +495,8 @@ void PacedSender::Process() {
 
     int64_t delta_time_ms = std::min(kMaxIntervalTimeMs, elapsed_time_ms);
     UpdateBytesPerInterval(delta_time_ms);
+    // Lets the detector notice periods when there is nothing to send at all.
+    alr_detector_->OnBytesSent(0, now_us / 1000);
   }
 
   bool is_probing = prober_->IsProbing();
@@ -413,7 +511,7 @@ void PacedSender::Process() {
     if (SendPacket(packet, probe_cluster_id)) {
       // Send succeeded, remove it from the queue.
       packets_->FinalizePop(packet);
-      if (is_probing)
+      if (is_probing && !IsProbeDue(probe_cluster_id))
         return;
     } else {
       // Send failed, put it back into the queue.
@@ -432,9 +530,14 @@ void PacedSender::Process() {
   if (packet_counter_ > 0) {
     size_t padding_needed = is_probing ? prober_->RecommendedPacketSize()
                                        : padding_budget_->bytes_remaining();
-
-    if (padding_needed > 0)
-      SendPadding(padding_needed, probe_cluster_id);
+    // When probing at high bitrates, padding is sent until the next probe is
+    // no longer due.
+    while (padding_needed > 0 &&
+           SendPadding(padding_needed, probe_cluster_id) >=
+               kMinProbePacketSize &&
+           is_probing && IsProbeDue(probe_cluster_id)) {
+      padding_needed = prober_->RecommendedPacketSize();
+    }
   }
 }
 
@@ -461,17 +564,19 @@ bool PacedSender::SendPacket(const paced_sender::Packet& packet,
     prober_->PacketSent(clock_->TimeInMilliseconds(), packet.bytes);
     // TODO(holmer): High priority packets should only be accounted for if we
     // are allocating bandwidth for audio.
+    ++burst_packets_;
     if (packet.priority != kHighPriority) {
       // Update media bytes sent.
       media_budget_->UseBudget(packet.bytes);
       padding_budget_->UseBudget(packet.bytes);
     }
+    alr_detector_->OnBytesSent(packet.bytes, clock_->TimeInMilliseconds());
   }
 
   return success;
 }
 
-void PacedSender::SendPadding(size_t padding_needed, int probe_cluster_id) {
+size_t PacedSender::SendPadding(size_t padding_needed, int probe_cluster_id) {
   critsect_->Leave();
   size_t bytes_sent =
       packet_sender_->TimeToSendPadding(padding_needed, probe_cluster_id);
@@ -482,6 +587,26 @@ void PacedSender::SendPadding(size_t padding_needed, int probe_cluster_id) {
     media_budget_->UseBudget(bytes_sent);
     padding_budget_->UseBudget(bytes_sent);
   }
+  return bytes_sent;
+}
+
+bool PacedSender::IsProbeDue(int probe_cluster_id) {
+  return prober_->TimeUntilNextProbe(clock_->TimeInMilliseconds()) == 0 &&
+         prober_->IsProbing() &&
+         prober_->CurrentClusterId() == probe_cluster_id;
+}
+
+void PacedSender::UpdateBurstStats(int64_t now_ms) {
+  if (burst_packets_ > 0) {
+    RTC_HISTOGRAM_COUNTS_100("WebRTC.Pacer.PacketsPerBurst", burst_packets_);
+    if (last_burst_time_ms_ >= 0) {
+      RTC_HISTOGRAM_COUNTS_1000("WebRTC.Pacer.TimeBetweenBurstsMs",
+                                burst_time_ms_ - last_burst_time_ms_);
+    }
+    last_burst_time_ms_ = burst_time_ms_;
+    burst_packets_ = 0;
+  }
+  burst_time_ms_ = now_ms;
 }
 
 void PacedSender::UpdateBytesPerInterval(int64_t delta_time_ms) {
@@ -15,12 +15,14 @@
 #include <memory>
 #include <set>
 
+#include "webrtc/base/optional.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/include/module.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
+class AlrDetector;
 class BitrateProber;
 class Clock;
 class CriticalSectionWrapper;
@@ -79,6 +81,12 @@ class PacedSender : public Module, public RtpPacketSender {
   // Resume sending packets.
   void Resume();
 
+  // Sets how often queued packets are sent, in milliseconds. The default is
+  // 5 ms, unless overridden by the "WebRTC-PacerProcessInterval" field trial
+  // (e.g. "Enabled-1"). Shorter intervals spread the packets of high bitrate
+  // streams into smaller bursts, at the cost of more frequent wakeups.
+  void SetProcessIntervalMs(int64_t process_interval_ms);
+
   // Enable bitrate probing. Enabled by default, mostly here to simplify
   // testing. Must be called before any packets are being sent to have an
   // effect.
@@ -123,6 +131,11 @@ class PacedSender : public Module, public RtpPacketSender {
   // packets currently in the pacer queue, or 0 if queue is empty.
   virtual int64_t AverageQueueTimeMs();
 
+  // Returns the time in milliseconds when the current application-limited
+  // region started, or an empty result if the media sent is currently not
+  // limited by the application. See AlrDetector.
+  virtual rtc::Optional<int64_t> GetApplicationLimitedRegionStartTime() const;
+
   // Returns the number of milliseconds until the module want a worker thread
   // to call Process.
   int64_t TimeUntilNextProcess() override;
@@ -131,14 +144,23 @@ class PacedSender : public Module, public RtpPacketSender {
   void Process() override;
 
  private:
+  // Reports the size of the latest burst of packets, and the time since the
+  // one before it.
+  void UpdateBurstStats(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+
   // Updates the number of bytes that can be sent for the next time interval.
   void UpdateBytesPerInterval(int64_t delta_time_in_ms)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   bool SendPacket(const paced_sender::Packet& packet, int probe_cluster_id)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
-  void SendPadding(size_t padding_needed, int probe_cluster_id)
+  // Returns the number of padding bytes sent.
+  size_t SendPadding(size_t padding_needed, int probe_cluster_id)
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  // Returns true if another probe of |probe_cluster_id| is due right away,
+  // which is the case when probing at bitrates where a packet takes less than
+  // a millisecond to send.
+  bool IsProbeDue(int probe_cluster_id) EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   Clock* const clock_;
   PacketSender* const packet_sender_;
@@ -155,6 +177,7 @@ class PacedSender : public Module, public RtpPacketSender {
   std::unique_ptr<paced_sender::IntervalBudget> padding_budget_
       GUARDED_BY(critsect_);
 
+  std::unique_ptr<AlrDetector> alr_detector_ GUARDED_BY(critsect_);
   std::unique_ptr<BitrateProber> prober_ GUARDED_BY(critsect_);
   // Actual configured bitrates (media_budget_ may temporarily be higher in
   // order to meet pace time constraint).
@@ -164,6 +187,13 @@ class PacedSender : public Module, public RtpPacketSender {
   uint32_t pacing_bitrate_kbps_ GUARDED_BY(critsect_);
 
   int64_t time_last_update_us_ GUARDED_BY(critsect_);
+  int64_t process_interval_ms_ GUARDED_BY(critsect_);
+
+  // Media packets sent by the latest Process() call, and when it was made.
+  // Reported as histograms on the next call.
+  int burst_packets_ GUARDED_BY(critsect_);
+  int64_t burst_time_ms_ GUARDED_BY(critsect_);
+  int64_t last_burst_time_ms_ GUARDED_BY(critsect_);
 
   std::unique_ptr<paced_sender::PacketQueue> packets_ GUARDED_BY(critsect_);
   uint64_t packet_counter_;
@@ -13,8 +13,11 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/pacing/paced_sender.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/system_wrappers/include/metrics_default.h"
 
 using testing::_;
 using testing::Return;
@@ -873,6 +876,37 @@ TEST_F(PacedSenderTest, ProbingWithTooSmallInitialFrame) {
   EXPECT_EQ(kNumPackets, callback.packets_sent());
 }
 
+TEST_F(PacedSenderTest, ProbingAtHighBitrate) {
+  const size_t kPacketSize = 1200;
+  const int kProbeBitrateBps = 20000000;
+  // What a probe cluster at |kProbeBitrateBps| needs to send in its 15 ms.
+  const size_t kMinProbeBytes = kProbeBitrateBps / 8000 * 15;
+  uint32_t ssrc = 12346;
+  uint16_t sequence_number = 1234;
+
+  PacedSenderPadding callback;
+  send_bucket_.reset(new PacedSender(&clock_, &callback));
+  send_bucket_->CreateProbeCluster(kProbeBitrateBps, 6);
+  send_bucket_->SetEstimatedBitrate(kTargetBitrateBps);
+  send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                             sequence_number, clock_.TimeInMilliseconds(),
+                             kPacketSize, false);
+
+  // A packet takes less than a millisecond to send at this bitrate, so the
+  // pacer has to send several of them per millisecond.
+  const int64_t start_time_ms = clock_.TimeInMilliseconds();
+  while (clock_.TimeInMilliseconds() - start_time_ms < 20) {
+    int time_until_process = send_bucket_->TimeUntilNextProcess();
+    if (time_until_process <= 0) {
+      send_bucket_->Process();
+    } else {
+      clock_.AdvanceTimeMilliseconds(time_until_process);
+    }
+  }
+  EXPECT_GE(kPacketSize + callback.padding_sent(), kMinProbeBytes);
+  EXPECT_LT(kPacketSize + callback.padding_sent(), kMinProbeBytes * 6 / 5);
+}
+
 TEST_F(PacedSenderTest, PriorityInversion) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
@@ -1033,5 +1067,81 @@ TEST_F(PacedSenderTest, ProbeClusterId) {
   send_bucket_->Process();
 }
 
+TEST_F(PacedSenderTest, ProcessIntervalOfOneMs) {
+  metrics::Reset();
+  uint32_t ssrc = 12346;
+  uint16_t sequence_number = 1234;
+  // What the pacing bitrate of 2000 kbps allows per ms.
+  const size_t kPacketSize = 250;
+  const int kNumPackets = 10;
+
+  send_bucket_->SetProcessIntervalMs(1);
+  send_bucket_->Process();
+  for (int i = 0; i < kNumPackets; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                               sequence_number + i, clock_.TimeInMilliseconds(),
+                               kPacketSize, false);
+  }
+
+  // One packet leaves on every 1 ms process call.
+  for (int i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(1, send_bucket_->TimeUntilNextProcess());
+    clock_.AdvanceTimeMilliseconds(1);
+    EXPECT_CALL(callback_, TimeToSendPacket(ssrc, sequence_number + i, _, _, _))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+    send_bucket_->Process();
+  }
+  EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
+
+  // The last burst is reported on the next call.
+  clock_.AdvanceTimeMilliseconds(1);
+  send_bucket_->Process();
+  EXPECT_EQ(kNumPackets, metrics::NumSamples("WebRTC.Pacer.PacketsPerBurst"));
+  EXPECT_EQ(kNumPackets, metrics::NumEvents("WebRTC.Pacer.PacketsPerBurst", 1));
+  EXPECT_EQ(kNumPackets - 1,
+            metrics::NumEvents("WebRTC.Pacer.TimeBetweenBurstsMs", 1));
+}
+
+// Queues 10k packets, as under heavy congestion, and drains them.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(PacedSenderTest, DISABLED_QueueThroughput) {
+  const int kNumRounds = 20;
+  const int kNumPackets = 10000;
+  const int kNumSsrcs = 10;
+  const size_t kPacketSize = 1200;
+  PacedSenderPadding callback;
+  send_bucket_.reset(new PacedSender(&clock_, &callback));
+  send_bucket_->SetProbingEnabled(false);
+  send_bucket_->SetEstimatedBitrate(kTargetBitrateBps);
+
+  int64_t push_ns = 0;
+  int64_t pop_ns = 0;
+  uint16_t sequence_number = 0;
+  for (int round = 0; round < kNumRounds; ++round) {
+    int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumPackets; ++i) {
+      // Mix priorities and retransmissions so that the heap gets reordered.
+      send_bucket_->InsertPacket(
+          static_cast<PacedSender::Priority>(i % 3), 1000 + i % kNumSsrcs,
+          sequence_number, clock_.TimeInMilliseconds() - i % 7, kPacketSize,
+          i % 5 == 0);
+      if (i % kNumSsrcs == kNumSsrcs - 1)
+        ++sequence_number;
+    }
+    push_ns += rtc::TimeNanos() - start_ns;
+    start_ns = rtc::TimeNanos();
+    while (send_bucket_->QueueSizePackets() > 0) {
+      clock_.AdvanceTimeMilliseconds(5);
+      send_bucket_->Process();
+    }
+    pop_ns += rtc::TimeNanos() - start_ns;
+  }
+  LOG(LS_INFO) << "Pushed " << kNumRounds * kNumPackets << " packets at "
+               << push_ns / (kNumRounds * kNumPackets) << " ns/packet, sent "
+               << "them at " << pop_ns / (kNumRounds * kNumPackets)
+               << " ns/packet.";
+}
+
 }  // namespace test
 }  // namespace webrtc
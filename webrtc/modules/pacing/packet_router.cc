@@ -38,6 +38,12 @@ void PacketRouter::RemoveRtpModule(RtpRtcp* rtp_module) {
   RTC_DCHECK(std::find(rtp_modules_.begin(), rtp_modules_.end(), rtp_module) !=
              rtp_modules_.end());
   rtp_modules_.remove(rtp_module);
+  for (auto it = ssrc_to_module_.begin(); it != ssrc_to_module_.end();) {
+    if (it->second == rtp_module)
+      it = ssrc_to_module_.erase(it);
+    else
+      ++it;
+  }
 }
 
 bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
@@ -47,8 +53,22 @@ bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
                                     int probe_cluster_id) {
   RTC_DCHECK(pacer_thread_checker_.CalledOnValidThread());
   rtc::CritScope cs(&modules_crit_);
+  RtpRtcp* cached_module = nullptr;
+  auto cached_it = ssrc_to_module_.find(ssrc);
+  if (cached_it != ssrc_to_module_.end()) {
+    cached_module = cached_it->second;
+    if (cached_module->SendingMedia() && ssrc == cached_module->SSRC()) {
+      return cached_module->TimeToSendPacket(ssrc, sequence_number,
+                                             capture_timestamp, retransmission,
+                                             probe_cluster_id);
+    }
+    ssrc_to_module_.erase(cached_it);
+  }
   for (auto* rtp_module : rtp_modules_) {
+    if (rtp_module == cached_module)
+      continue;
     if (rtp_module->SendingMedia() && ssrc == rtp_module->SSRC()) {
+      ssrc_to_module_[ssrc] = rtp_module;
       return rtp_module->TimeToSendPacket(ssrc, sequence_number,
                                           capture_timestamp, retransmission,
                                           probe_cluster_id);
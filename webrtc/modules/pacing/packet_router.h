@@ -12,6 +12,7 @@
 #define WEBRTC_MODULES_PACING_PACKET_ROUTER_H_
 
 #include <list>
+#include <unordered_map>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
@@ -58,6 +59,11 @@ class PacketRouter : public PacedSender::PacketSender,
   rtc::ThreadChecker pacer_thread_checker_;
   rtc::CriticalSection modules_crit_;
   std::list<RtpRtcp*> rtp_modules_ GUARDED_BY(modules_crit_);
+  // The module that last sent a packet of an ssrc, checked first before
+  // scanning |rtp_modules_|. Modules can change ssrc or stop sending at any
+  // time, so a cached module is only used if it still matches.
+  std::unordered_map<uint32_t, RtpRtcp*> ssrc_to_module_
+      GUARDED_BY(modules_crit_);
 
   volatile int transport_seq_;
 
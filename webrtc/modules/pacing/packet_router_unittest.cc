@@ -103,6 +103,45 @@ TEST_F(PacketRouterTest, TimeToSendPacket) {
   packet_router_->RemoveRtpModule(&rtp_2);
 }
 
+TEST_F(PacketRouterTest, TimeToSendPacketAfterSsrcChange) {
+  const uint32_t kSsrc1 = 1234;
+  const uint32_t kSsrc2 = 4567;
+  const uint16_t kSequenceNumber = 17;
+  const int64_t kTimestamp = 7890;
+  NiceMock<MockRtpRtcp> rtp_1;
+  NiceMock<MockRtpRtcp> rtp_2;
+  ON_CALL(rtp_1, SendingMedia()).WillByDefault(Return(true));
+  ON_CALL(rtp_2, SendingMedia()).WillByDefault(Return(true));
+  ON_CALL(rtp_1, SSRC()).WillByDefault(Return(kSsrc1));
+  ON_CALL(rtp_2, SSRC()).WillByDefault(Return(kSsrc2));
+  packet_router_->AddRtpModule(&rtp_1);
+  packet_router_->AddRtpModule(&rtp_2);
+
+  EXPECT_CALL(rtp_2, TimeToSendPacket(kSsrc2, _, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_TRUE(packet_router_->TimeToSendPacket(kSsrc2, kSequenceNumber,
+                                               kTimestamp, false, 1));
+  // The module of a known ssrc is used without scanning the others.
+  EXPECT_CALL(rtp_1, SSRC()).Times(0);
+  EXPECT_TRUE(packet_router_->TimeToSendPacket(kSsrc2, kSequenceNumber + 1,
+                                               kTimestamp, false, 1));
+  ::testing::Mock::VerifyAndClearExpectations(&rtp_1);
+  ::testing::Mock::VerifyAndClearExpectations(&rtp_2);
+
+  // The modules swap ssrcs.
+  ON_CALL(rtp_1, SSRC()).WillByDefault(Return(kSsrc2));
+  ON_CALL(rtp_2, SSRC()).WillByDefault(Return(kSsrc1));
+  EXPECT_CALL(rtp_2, TimeToSendPacket(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(rtp_1, TimeToSendPacket(kSsrc2, kSequenceNumber + 2, _, _, _))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(packet_router_->TimeToSendPacket(kSsrc2, kSequenceNumber + 2,
+                                               kTimestamp, false, 1));
+
+  packet_router_->RemoveRtpModule(&rtp_1);
+  packet_router_->RemoveRtpModule(&rtp_2);
+}
+
 TEST_F(PacketRouterTest, TimeToSendPadding) {
   const uint16_t kSsrc1 = 1234;
   const uint16_t kSsrc2 = 4567;
@@ -11,15 +11,16 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 
-#include <map>
+#include <vector>
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/modules/include/module_common_types.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 
 namespace webrtc {
 class Clock;
-struct PacketInfo;
 
 class SendTimeHistory {
  public:
@@ -43,10 +44,26 @@ class SendTimeHistory {
   bool GetInfo(PacketInfo* packet_info, bool remove);
 
  private:
+  // Grows the window to include |unwrapped_seq_num|, dropping the oldest
+  // packets if needed. Returns false if the sequence number is too old.
+  bool ExtendWindow(int64_t unwrapped_seq_num);
+  // Makes room for a window of |window_size| packets, keeping the current one.
+  void Reserve(size_t window_size);
+  // Returns the slot of |unwrapped_seq_num|, or null if outside the window.
+  rtc::Optional<PacketInfo>* FindSlot(int64_t unwrapped_seq_num);
+  rtc::Optional<PacketInfo>& Slot(int64_t unwrapped_seq_num) {
+    return history_[unwrapped_seq_num & (history_.size() - 1)];
+  }
+
   Clock* const clock_;
   const int64_t packet_age_limit_ms_;
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketInfo> history_;
+  // Ring buffer with a power of two size, indexed by unwrapped sequence
+  // number. Only the slots of the window [first_seq_num_, first_seq_num_ +
+  // window_size_) are in use; removed packets leave empty slots.
+  std::vector<rtc::Optional<PacketInfo>> history_;
+  int64_t first_seq_num_;
+  size_t window_size_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(SendTimeHistory);
 };
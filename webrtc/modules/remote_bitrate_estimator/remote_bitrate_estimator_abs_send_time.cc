@@ -70,13 +70,13 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
     return fabs(static_cast<float>(send_delta_ms) - cluster_mean) < 2.5f;
   }
 
-  void RemoteBitrateEstimatorAbsSendTime::AddCluster(
-      std::list<Cluster>* clusters,
-      Cluster* cluster) {
-    cluster->send_mean_ms /= static_cast<float>(cluster->count);
-    cluster->recv_mean_ms /= static_cast<float>(cluster->count);
-    cluster->mean_size /= cluster->count;
-    clusters->push_back(*cluster);
+  Cluster RemoteBitrateEstimatorAbsSendTime::FinalizeCluster(
+      const Cluster& cluster_aggregate) {
+    Cluster cluster = cluster_aggregate;
+    cluster.send_mean_ms /= static_cast<float>(cluster.count);
+    cluster.recv_mean_ms /= static_cast<float>(cluster.count);
+    cluster.mean_size /= cluster.count;
+    return cluster;
   }
 
   RemoteBitrateEstimatorAbsSendTime::RemoteBitrateEstimatorAbsSendTime(
@@ -89,6 +89,8 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
         detector_(OverUseDetectorOptions()),
         incoming_bitrate_(kBitrateWindowMs, 8000),
         incoming_bitrate_initialized_(false),
+        num_clusters_(0),
+        cluster_failed_(false),
         total_probes_received_(0),
         first_packet_time_ms_(-1),
         last_update_ms_(-1),
@@ -98,95 +100,113 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
     network_thread_.DetachFromThread();
 }
 
-void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
-    std::list<Cluster>* clusters) const {
-  Cluster current;
-  int64_t prev_send_time = -1;
-  int64_t prev_recv_time = -1;
-  for (std::list<Probe>::const_iterator it = probes_.begin();
-       it != probes_.end();
-       ++it) {
-    if (prev_send_time >= 0) {
-      int send_delta_ms = it->send_time_ms - prev_send_time;
-      int recv_delta_ms = it->recv_time_ms - prev_recv_time;
-      if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
-        ++current.num_above_min_delta;
-      }
-      if (!IsWithinClusterBounds(send_delta_ms, current)) {
-        if (current.count >= kMinClusterSize)
-          AddCluster(clusters, &current);
-        current = Cluster();
+void RemoteBitrateEstimatorAbsSendTime::AddProbeToClusters(
+    const Probe& probe) {
+  if (last_probe_) {
+    int send_delta_ms = probe.send_time_ms - last_probe_->send_time_ms;
+    int recv_delta_ms = probe.recv_time_ms - last_probe_->recv_time_ms;
+    if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
+      ++current_cluster_.num_above_min_delta;
+    }
+    if (!IsWithinClusterBounds(send_delta_ms, current_cluster_)) {
+      if (current_cluster_.count >= kMinClusterSize) {
+        ++num_clusters_;
+        EvaluateCluster(FinalizeCluster(current_cluster_), &best_cluster_,
+                        &cluster_failed_);
       }
-      current.send_mean_ms += send_delta_ms;
-      current.recv_mean_ms += recv_delta_ms;
-      current.mean_size += it->payload_size;
-      ++current.count;
+      current_cluster_ = Cluster();
     }
-    prev_send_time = it->send_time_ms;
-    prev_recv_time = it->recv_time_ms;
+    current_cluster_.send_mean_ms += send_delta_ms;
+    current_cluster_.recv_mean_ms += recv_delta_ms;
+    current_cluster_.mean_size += probe.payload_size;
+    ++current_cluster_.count;
   }
-  if (current.count >= kMinClusterSize)
-    AddCluster(clusters, &current);
+  last_probe_ = rtc::Optional<Probe>(probe);
 }
 
-std::list<Cluster>::const_iterator
-RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
-    const std::list<Cluster>& clusters) const {
-  int highest_probe_bitrate_bps = 0;
-  std::list<Cluster>::const_iterator best_it = clusters.end();
-  for (std::list<Cluster>::const_iterator it = clusters.begin();
-       it != clusters.end();
-       ++it) {
-    if (it->send_mean_ms == 0 || it->recv_mean_ms == 0)
-      continue;
-    if (it->num_above_min_delta > it->count / 2 &&
-        (it->recv_mean_ms - it->send_mean_ms <= 2.0f &&
-         it->send_mean_ms - it->recv_mean_ms <= 5.0f)) {
-      int probe_bitrate_bps =
-          std::min(it->GetSendBitrateBps(), it->GetRecvBitrateBps());
-      if (probe_bitrate_bps > highest_probe_bitrate_bps) {
-        highest_probe_bitrate_bps = probe_bitrate_bps;
-        best_it = it;
-      }
-    } else {
-      int send_bitrate_bps = it->mean_size * 8 * 1000 / it->send_mean_ms;
-      int recv_bitrate_bps = it->mean_size * 8 * 1000 / it->recv_mean_ms;
-      LOG(LS_INFO) << "Probe failed, sent at " << send_bitrate_bps
-                   << " bps, received at " << recv_bitrate_bps
-                   << " bps. Mean send delta: " << it->send_mean_ms
-                   << " ms, mean recv delta: " << it->recv_mean_ms
-                   << " ms, num probes: " << it->count;
-      break;
+void RemoteBitrateEstimatorAbsSendTime::EvaluateCluster(
+    const Cluster& cluster,
+    rtc::Optional<Cluster>* best_cluster,
+    bool* cluster_failed) const {
+  // Clusters following one which failed the checks are not considered.
+  if (*cluster_failed)
+    return;
+  if (cluster.send_mean_ms == 0 || cluster.recv_mean_ms == 0)
+    return;
+  if (cluster.num_above_min_delta > cluster.count / 2 &&
+      (cluster.recv_mean_ms - cluster.send_mean_ms <= 2.0f &&
+       cluster.send_mean_ms - cluster.recv_mean_ms <= 5.0f)) {
+    int probe_bitrate_bps =
+        std::min(cluster.GetSendBitrateBps(), cluster.GetRecvBitrateBps());
+    int highest_probe_bitrate_bps = 0;
+    if (*best_cluster) {
+      highest_probe_bitrate_bps =
+          std::min((*best_cluster)->GetSendBitrateBps(),
+                   (*best_cluster)->GetRecvBitrateBps());
     }
+    if (probe_bitrate_bps > highest_probe_bitrate_bps)
+      *best_cluster = rtc::Optional<Cluster>(cluster);
+  } else {
+    int send_bitrate_bps = cluster.mean_size * 8 * 1000 / cluster.send_mean_ms;
+    int recv_bitrate_bps = cluster.mean_size * 8 * 1000 / cluster.recv_mean_ms;
+    LOG(LS_INFO) << "Probe failed, sent at " << send_bitrate_bps
+                 << " bps, received at " << recv_bitrate_bps
+                 << " bps. Mean send delta: " << cluster.send_mean_ms
+                 << " ms, mean recv delta: " << cluster.recv_mean_ms
+                 << " ms, num probes: " << cluster.count;
+    *cluster_failed = true;
   }
-  return best_it;
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ResetClusters() {
+  probes_.clear();
+  last_probe_ = rtc::Optional<Probe>();
+  current_cluster_ = Cluster();
+  num_clusters_ = 0;
+  best_cluster_ = rtc::Optional<Cluster>();
+  cluster_failed_ = false;
 }
 
 RemoteBitrateEstimatorAbsSendTime::ProbeResult
 RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
-  std::list<Cluster> clusters;
-  ComputeClusters(&clusters);
-  if (clusters.empty()) {
+  // The cluster currently being built counts as well, but may still grow.
+  const bool current_is_cluster = current_cluster_.count >= kMinClusterSize;
+  const size_t num_clusters = num_clusters_ + (current_is_cluster ? 1 : 0);
+  if (num_clusters == 0) {
     // If we reach the max number of probe packets and still have no clusters,
     // we will remove the oldest one.
-    if (probes_.size() >= kMaxProbePackets)
-      probes_.pop_front();
+    if (probes_.size() >= kMaxProbePackets) {
+      std::vector<Probe> probes;
+      probes.swap(probes_);
+      ResetClusters();
+      for (auto it = probes.begin() + 1; it != probes.end(); ++it)
+        AddProbeToClusters(*it);
+      probes_.assign(probes.begin() + 1, probes.end());
+    }
     return ProbeResult::kNoUpdate;
   }
-
-  std::list<Cluster>::const_iterator best_it = FindBestProbe(clusters);
-  if (best_it != clusters.end()) {
-    int probe_bitrate_bps =
-        std::min(best_it->GetSendBitrateBps(), best_it->GetRecvBitrateBps());
+  // Clusters only ever get added until the next reset, so the probes are no
+  // longer needed to recompute them.
+  probes_.clear();
+
+  rtc::Optional<Cluster> best_cluster = best_cluster_;
+  if (current_is_cluster) {
+    bool cluster_failed = cluster_failed_;
+    EvaluateCluster(FinalizeCluster(current_cluster_), &best_cluster,
+                    &cluster_failed);
+  }
+  if (best_cluster) {
+    int probe_bitrate_bps = std::min(best_cluster->GetSendBitrateBps(),
+                                     best_cluster->GetRecvBitrateBps());
     // Make sure that a probe sent on a lower bitrate than our estimate can't
     // reduce the estimate.
     if (IsBitrateImproving(probe_bitrate_bps)) {
       LOG(LS_INFO) << "Probe successful, sent at "
-                   << best_it->GetSendBitrateBps() << " bps, received at "
-                   << best_it->GetRecvBitrateBps()
-                   << " bps. Mean send delta: " << best_it->send_mean_ms
-                   << " ms, mean recv delta: " << best_it->recv_mean_ms
-                   << " ms, num probes: " << best_it->count;
+                   << best_cluster->GetSendBitrateBps() << " bps, received at "
+                   << best_cluster->GetRecvBitrateBps()
+                   << " bps. Mean send delta: " << best_cluster->send_mean_ms
+                   << " ms, mean recv delta: " << best_cluster->recv_mean_ms
+                   << " ms, num probes: " << best_cluster->count;
       remote_rate_.SetEstimate(probe_bitrate_bps, now_ms);
       return ProbeResult::kBitrateUpdated;
     }
@@ -194,8 +214,8 @@ RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
 
   // Not probing and received non-probe packet, or finished with current set
   // of probes.
-  if (clusters.size() >= kExpectedNumberOfProbes)
-    probes_.clear();
+  if (num_clusters >= kExpectedNumberOfProbes)
+    ResetClusters();
   return ProbeResult::kNoUpdate;
 }
 
@@ -293,16 +313,18 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
       if (total_probes_received_ < kMaxProbePackets) {
         int send_delta_ms = -1;
         int recv_delta_ms = -1;
-        if (!probes_.empty()) {
-          send_delta_ms = send_time_ms - probes_.back().send_time_ms;
-          recv_delta_ms = arrival_time_ms - probes_.back().recv_time_ms;
+        if (last_probe_) {
+          send_delta_ms = send_time_ms - last_probe_->send_time_ms;
+          recv_delta_ms = arrival_time_ms - last_probe_->recv_time_ms;
         }
         LOG(LS_INFO) << "Probe packet received: send time=" << send_time_ms
                      << " ms, recv time=" << arrival_time_ms
                      << " ms, send delta=" << send_delta_ms
                      << " ms, recv delta=" << recv_delta_ms << " ms.";
       }
-      probes_.push_back(Probe(send_time_ms, arrival_time_ms, payload_size));
+      Probe probe(send_time_ms, arrival_time_ms, payload_size);
+      AddProbeToClusters(probe);
+      probes_.push_back(probe);
       ++total_probes_received_;
       // Make sure that a probe which updated the bitrate immediately has an
       // effect by calling the OnReceiveBitrateChanged callback.
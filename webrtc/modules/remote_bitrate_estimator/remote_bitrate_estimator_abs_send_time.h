@@ -11,7 +11,6 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 
-#include <list>
 #include <map>
 #include <memory>
 #include <vector>
@@ -19,6 +18,7 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/base/rate_statistics.h"
 #include "webrtc/base/thread_checker.h"
 #include "webrtc/modules/remote_bitrate_estimator/aimd_rate_control.h"
@@ -97,17 +97,26 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   static bool IsWithinClusterBounds(int send_delta_ms,
                                     const Cluster& cluster_aggregate);
 
-  static void AddCluster(std::list<Cluster>* clusters, Cluster* cluster);
+  // Turns the sums of the deltas of a cluster into means.
+  static Cluster FinalizeCluster(const Cluster& cluster_aggregate);
 
   void IncomingPacketInfo(int64_t arrival_time_ms,
                           uint32_t send_time_24bits,
                           size_t payload_size,
                           uint32_t ssrc);
 
-  void ComputeClusters(std::list<Cluster>* clusters) const;
+  // Adds the delta to the previous probe to the cluster being built, and
+  // completes that cluster if the delta falls outside of its bounds.
+  void AddProbeToClusters(const Probe& probe);
 
-  std::list<Cluster>::const_iterator FindBestProbe(
-      const std::list<Cluster>& clusters) const;
+  // Updates |best_cluster| with |cluster| if it is a valid probe with a
+  // higher bitrate. Once a cluster is invalid, |cluster_failed| is set and
+  // later clusters are ignored.
+  void EvaluateCluster(const Cluster& cluster,
+                       rtc::Optional<Cluster>* best_cluster,
+                       bool* cluster_failed) const;
+
+  void ResetClusters();
 
   // Returns true if a probe which changed the estimate was detected.
   ProbeResult ProcessClusters(int64_t now_ms) EXCLUSIVE_LOCKS_REQUIRED(&crit_);
@@ -127,7 +136,18 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   bool incoming_bitrate_initialized_;
   std::vector<int> recent_propagation_delta_ms_;
   std::vector<int64_t> recent_update_time_ms_;
-  std::list<Probe> probes_;
+  // Probes received since the clusters were reset. Only kept until the first
+  // cluster is found, as they are needed to recompute the clusters when the
+  // oldest probe is dropped.
+  std::vector<Probe> probes_;
+  rtc::Optional<Probe> last_probe_;
+  // The clusters are maintained incrementally as probes arrive. Only the
+  // completed clusters are counted; |current_cluster_| holds the sums of the
+  // deltas of the one being built.
+  Cluster current_cluster_;
+  size_t num_clusters_;
+  rtc::Optional<Cluster> best_cluster_;
+  bool cluster_failed_;
   size_t total_probes_received_;
   int64_t first_packet_time_ms_;
   int64_t last_update_ms_;
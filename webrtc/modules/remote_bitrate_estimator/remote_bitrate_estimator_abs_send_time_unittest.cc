@@ -9,6 +9,8 @@
  */
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
 #include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h"
 
@@ -286,4 +288,42 @@ TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, ProbingIgnoresSmallPackets) {
   EXPECT_TRUE(bitrate_observer_->updated());
   EXPECT_NEAR(bitrate_observer_->latest_bitrate(), 800000u, 10000);
 }
+
+// A probe which is not followed by other clusters keeps growing for the whole
+// initial probing interval, and must still be detected on the first packets.
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest, TestProbeDetectionLongBurst) {
+  const int kProbeLength = 1500;
+  int64_t now_ms = clock_.TimeInMilliseconds();
+  // Sent at 8 * 1000 / 1 = 8000 kbps, i.e. at the link capacity.
+  for (int i = 0; i < kProbeLength; ++i) {
+    clock_.AdvanceTimeMilliseconds(1);
+    now_ms = clock_.TimeInMilliseconds();
+    IncomingPacket(0, 1000, now_ms, 90 * now_ms, AbsSendTime(now_ms, 1000));
+    if (i == 10) {
+      bitrate_estimator_->Process();
+      EXPECT_TRUE(bitrate_observer_->updated());
+      EXPECT_NEAR(bitrate_observer_->latest_bitrate(), 8000000u, 100000);
+    }
+  }
+}
+
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(RemoteBitrateEstimatorAbsSendTimeTest,
+       DISABLED_LongProbeBurstThroughput) {
+  const int kNumRuns = 20;
+  const int kProbeLength = 1500;
+  int64_t elapsed_ns = 0;
+  for (int run = 0; run < kNumRuns; ++run) {
+    SetUp();
+    int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kProbeLength; ++i) {
+      clock_.AdvanceTimeMilliseconds(1);
+      int64_t now_ms = clock_.TimeInMilliseconds();
+      IncomingPacket(0, 1000, now_ms, 90 * now_ms, AbsSendTime(now_ms, 1000));
+    }
+    elapsed_ns += rtc::TimeNanos() - start_ns;
+  }
+  LOG(LS_INFO) << "Probe packets: "
+               << elapsed_ns / (kNumRuns * kProbeLength) << " ns per packet.";
+}
 }  // namespace webrtc
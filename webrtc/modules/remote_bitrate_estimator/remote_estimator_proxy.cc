@@ -10,6 +10,9 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/remote_estimator_proxy.h"
 
+#include <math.h>
+
+#include <algorithm>
 #include <limits>
 
 #include "webrtc/base/checks.h"
@@ -23,6 +26,8 @@ namespace webrtc {
 
 // TODO(sprang): Tune these!
 const int RemoteEstimatorProxy::kDefaultProcessIntervalMs = 50;
+const int RemoteEstimatorProxy::kMaxProcessIntervalMs = 250;
+const double RemoteEstimatorProxy::kMaxFeedbackBandwidthFraction = 0.05;
 const int RemoteEstimatorProxy::kBackWindowMs = 500;
 
 // The maximum allowed value for a timestamp in milliseconds. This is lower
@@ -30,6 +35,14 @@ const int RemoteEstimatorProxy::kBackWindowMs = 500;
 static constexpr int64_t kMaxTimeMs =
     std::numeric_limits<int64_t>::max() / 1000;
 
+static constexpr int64_t kNotReceived = -1;
+
+// Approximate size of a feedback packet: IPv4, UDP and SRTCP overhead plus
+// the fixed part of the transport feedback message, and for each reported
+// packet a small delta and its share of a status vector chunk.
+static constexpr int kFeedbackOverheadBytes = 20 + 8 + 14 + 20;
+static constexpr double kFeedbackBytesPerPacket = 1.25;
+
 RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
                                            PacketRouter* packet_router)
     : clock_(clock),
@@ -37,7 +50,12 @@ RemoteEstimatorProxy::RemoteEstimatorProxy(Clock* clock,
       last_process_time_ms_(-1),
       media_ssrc_(0),
       feedback_sequence_(0),
-      window_start_seq_(-1) {}
+      window_start_seq_(-1),
+      first_arrival_seq_(0),
+      send_interval_ms_(kDefaultProcessIntervalMs),
+      bitrate_bps_(0),
+      num_arrivals_since_process_(0),
+      packet_rate_pps_(0) {}
 
 RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
 
@@ -68,11 +86,16 @@ bool RemoteEstimatorProxy::LatestEstimate(std::vector<unsigned int>* ssrcs,
 }
 
 int64_t RemoteEstimatorProxy::TimeUntilNextProcess() {
+  int send_interval_ms;
+  {
+    rtc::CritScope cs(&lock_);
+    send_interval_ms = send_interval_ms_;
+  }
   int64_t now = clock_->TimeInMilliseconds();
   int64_t time_until_next = 0;
   if (last_process_time_ms_ != -1 &&
-      now - last_process_time_ms_ < kDefaultProcessIntervalMs) {
-    time_until_next = (last_process_time_ms_ + kDefaultProcessIntervalMs - now);
+      now - last_process_time_ms_ < send_interval_ms) {
+    time_until_next = (last_process_time_ms_ + send_interval_ms - now);
   }
   return time_until_next;
 }
@@ -80,7 +103,17 @@ int64_t RemoteEstimatorProxy::TimeUntilNextProcess() {
 void RemoteEstimatorProxy::Process() {
   if (TimeUntilNextProcess() > 0)
     return;
-  last_process_time_ms_ = clock_->TimeInMilliseconds();
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  {
+    rtc::CritScope cs(&lock_);
+    if (last_process_time_ms_ != -1 && now_ms > last_process_time_ms_) {
+      packet_rate_pps_ = num_arrivals_since_process_ * 1000.0 /
+                         (now_ms - last_process_time_ms_);
+      UpdateSendInterval();
+    }
+    num_arrivals_since_process_ = 0;
+  }
+  last_process_time_ms_ = now_ms;
 
   bool more_to_build = true;
   while (more_to_build) {
@@ -94,6 +127,27 @@ void RemoteEstimatorProxy::Process() {
   }
 }
 
+void RemoteEstimatorProxy::OnBitrateChanged(int bitrate_bps) {
+  rtc::CritScope cs(&lock_);
+  bitrate_bps_ = bitrate_bps;
+  UpdateSendInterval();
+}
+
+void RemoteEstimatorProxy::UpdateSendInterval() {
+  if (bitrate_bps_ <= 0)
+    return;
+  // The per packet part of the feedback does not depend on the interval, so
+  // only the per feedback overhead can be traded against the interval.
+  double overhead_budget_bps = kMaxFeedbackBandwidthFraction * bitrate_bps_ -
+                               kFeedbackBytesPerPacket * 8 * packet_rate_pps_;
+  double interval_ms = kMaxProcessIntervalMs;
+  if (overhead_budget_bps > 0)
+    interval_ms = kFeedbackOverheadBytes * 8 * 1000 / overhead_budget_bps;
+  send_interval_ms_ = static_cast<int>(ceil(
+      std::min<double>(std::max<double>(interval_ms, kDefaultProcessIntervalMs),
+                       kMaxProcessIntervalMs)));
+}
+
 void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
                                            int64_t arrival_time) {
   if (arrival_time < 0 || arrival_time > kMaxTimeMs) {
@@ -113,16 +167,19 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
                     << window_start_seq_ << ".";
     return;
   }
+  ++num_arrivals_since_process_;
 
-  if (packet_arrival_times_.lower_bound(window_start_seq_) ==
-      packet_arrival_times_.end()) {
+  const int64_t end_seq =
+      first_arrival_seq_ + static_cast<int64_t>(packet_arrival_times_.size());
+  if (window_start_seq_ >= end_seq) {
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
+    while (!packet_arrival_times_.empty() && first_arrival_seq_ < seq &&
+           arrival_time - packet_arrival_times_.front() >= kBackWindowMs) {
+      do {
+        packet_arrival_times_.pop_front();
+        ++first_arrival_seq_;
+      } while (!packet_arrival_times_.empty() &&
+               packet_arrival_times_.front() == kNotReceived);
     }
   }
 
@@ -132,41 +189,61 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
     window_start_seq_ = seq;
   }
 
-  // We are only interested in the first time a packet is received.
-  if (packet_arrival_times_.find(seq) != packet_arrival_times_.end())
-    return;
-
-  packet_arrival_times_[seq] = arrival_time;
+  if (packet_arrival_times_.empty()) {
+    first_arrival_seq_ = seq;
+    packet_arrival_times_.push_back(arrival_time);
+  } else if (seq < first_arrival_seq_) {
+    packet_arrival_times_.insert(packet_arrival_times_.begin(),
+                                 first_arrival_seq_ - seq, kNotReceived);
+    packet_arrival_times_.front() = arrival_time;
+    first_arrival_seq_ = seq;
+  } else {
+    size_t index = static_cast<size_t>(seq - first_arrival_seq_);
+    if (index >= packet_arrival_times_.size())
+      packet_arrival_times_.resize(index + 1, kNotReceived);
+    // We are only interested in the first time a packet is received.
+    if (packet_arrival_times_[index] == kNotReceived)
+      packet_arrival_times_[index] = arrival_time;
+  }
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
     rtcp::TransportFeedback* feedback_packet) {
   // window_start_seq_ is the first sequence number to include in the current
-  // feedback packet. Some older may still be in the map, in case a reordering
+  // feedback packet. Some older may still be buffered, in case a reordering
   // happens and we need to retransmit them.
   rtc::CritScope cs(&lock_);
-  auto it = packet_arrival_times_.lower_bound(window_start_seq_);
-  if (it == packet_arrival_times_.end()) {
+  size_t index = static_cast<size_t>(
+      std::max<int64_t>(window_start_seq_ - first_arrival_seq_, 0));
+  while (index < packet_arrival_times_.size() &&
+         packet_arrival_times_[index] == kNotReceived) {
+    ++index;
+  }
+  if (index >= packet_arrival_times_.size()) {
     // Feedback for all packets already sent.
     return false;
   }
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
-  const int64_t first_sequence = it->first;
+  const size_t first_index = index;
   feedback_packet->WithMediaSourceSsrc(media_ssrc_);
   // Base sequence is the expected next (window_start_seq_). This is known, but
   // we might not have actually received it, so the base time shall be the time
   // of the first received packet in the feedback.
   feedback_packet->WithBase(static_cast<uint16_t>(window_start_seq_ & 0xFFFF),
-                            it->second * 1000);
+                            packet_arrival_times_[index] * 1000);
   feedback_packet->WithFeedbackSequenceNumber(feedback_sequence_++);
-  for (; it != packet_arrival_times_.end(); ++it) {
+  for (; index < packet_arrival_times_.size(); ++index) {
+    const int64_t arrival_time_ms = packet_arrival_times_[index];
+    if (arrival_time_ms == kNotReceived)
+      continue;
+    const int64_t seq = first_arrival_seq_ + static_cast<int64_t>(index);
     if (!feedback_packet->WithReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
+            static_cast<uint16_t>(seq & 0xFFFF), arrival_time_ms * 1000)) {
       // If we can't even add the first seq to the feedback packet, we won't be
       // able to build it at all.
-      RTC_CHECK_NE(first_sequence, it->first);
+      RTC_CHECK_NE(first_index, index);
 
       // Could not add timestamp, feedback packet might be full. Return and
       // try again with a fresh packet.
@@ -176,7 +253,7 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
     // Note: Don't erase items from packet_arrival_times_ after sending, in case
     // they need to be re-sent after a reordering. Removal will be handled
     // by OnPacketArrival once packets are too old.
-    window_start_seq_ = it->first + 1;
+    window_start_seq_ = seq + 1;
   }
 
   return true;
@@ -11,7 +11,7 @@
 #ifndef WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
+#include <deque>
 #include <vector>
 
 #include "webrtc/base/criticalsection.h"
@@ -48,13 +48,21 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   int64_t TimeUntilNextProcess() override;
   void Process() override;
 
+  // Sets the bitrate available for sending, which the feedback is part of.
+  // Once set, the feedback interval is adapted so that the feedback uses at
+  // most kMaxFeedbackBandwidthFraction of it.
+  void OnBitrateChanged(int bitrate_bps);
+
   static const int kDefaultProcessIntervalMs;
+  static const int kMaxProcessIntervalMs;
+  static const double kMaxFeedbackBandwidthFraction;
   static const int kBackWindowMs;
 
  private:
   void OnPacketArrival(uint16_t sequence_number, int64_t arrival_time)
       EXCLUSIVE_LOCKS_REQUIRED(&lock_);
   bool BuildFeedbackPacket(rtcp::TransportFeedback* feedback_packet);
+  void UpdateSendInterval() EXCLUSIVE_LOCKS_REQUIRED(&lock_);
 
   Clock* const clock_;
   PacketRouter* const packet_router_;
@@ -66,8 +74,16 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_sequence_ GUARDED_BY(&lock_);
   SequenceNumberUnwrapper unwrapper_ GUARDED_BY(&lock_);
   int64_t window_start_seq_ GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
+  // Arrival times indexed by unwrapped seq - |first_arrival_seq_|, with
+  // kNotReceived for the packets not (yet) received. The first and the last
+  // entry are always received packets.
+  int64_t first_arrival_seq_ GUARDED_BY(&lock_);
+  std::deque<int64_t> packet_arrival_times_ GUARDED_BY(&lock_);
+
+  int send_interval_ms_ GUARDED_BY(&lock_);
+  int bitrate_bps_ GUARDED_BY(&lock_);
+  int num_arrivals_since_process_ GUARDED_BY(&lock_);
+  double packet_rate_pps_ GUARDED_BY(&lock_);
 };
 
 }  // namespace webrtc
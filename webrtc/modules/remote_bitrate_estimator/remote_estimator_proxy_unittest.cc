@@ -351,4 +351,54 @@ TEST_F(RemoteEstimatorProxyTest, RemovesTimestampsOutOfScope) {
   Process();
 }
 
+TEST_F(RemoteEstimatorProxyTest, DefaultSendIntervalWithoutBitrate) {
+  EXPECT_CALL(router_, SendFeedback(_)).WillRepeatedly(Return(true));
+  IncomingPacket(kBaseSeq, kBaseTimeMs);
+  Process();
+  EXPECT_EQ(RemoteEstimatorProxy::kDefaultProcessIntervalMs,
+            proxy_.TimeUntilNextProcess());
+}
+
+TEST_F(RemoteEstimatorProxyTest, AdaptsSendIntervalToBitrate) {
+  EXPECT_CALL(router_, SendFeedback(_)).WillRepeatedly(Return(true));
+  IncomingPacket(kBaseSeq, kBaseTimeMs);
+  Process();
+
+  // High bitrates are reported at the highest frequency.
+  proxy_.OnBitrateChanged(10000000);
+  EXPECT_EQ(RemoteEstimatorProxy::kDefaultProcessIntervalMs,
+            proxy_.TimeUntilNextProcess());
+
+  // Low bitrates get less frequent feedback, down to the lowest frequency.
+  proxy_.OnBitrateChanged(100000);
+  int64_t interval_ms = proxy_.TimeUntilNextProcess();
+  EXPECT_GT(interval_ms, RemoteEstimatorProxy::kDefaultProcessIntervalMs);
+  EXPECT_LT(interval_ms, RemoteEstimatorProxy::kMaxProcessIntervalMs);
+  // The feedback overhead stays within its share of the bitrate.
+  const int kFeedbackOverheadBits = (20 + 8 + 14 + 20) * 8;
+  EXPECT_LE(kFeedbackOverheadBits * 1000 / interval_ms,
+            RemoteEstimatorProxy::kMaxFeedbackBandwidthFraction * 100000);
+
+  proxy_.OnBitrateChanged(10000);
+  EXPECT_EQ(RemoteEstimatorProxy::kMaxProcessIntervalMs,
+            proxy_.TimeUntilNextProcess());
+}
+
+TEST_F(RemoteEstimatorProxyTest, HighPacketRateIncreasesSendInterval) {
+  EXPECT_CALL(router_, SendFeedback(_)).WillRepeatedly(Return(true));
+  const int kBitrateBps = 300000;
+  proxy_.OnBitrateChanged(kBitrateBps);
+  IncomingPacket(kBaseSeq, kBaseTimeMs);
+  Process();
+  int64_t interval_ms = proxy_.TimeUntilNextProcess();
+
+  // 1000 packets per second leave less room for the per feedback overhead.
+  uint16_t seq = kBaseSeq + 1;
+  for (int i = 0; i < interval_ms; ++i)
+    IncomingPacket(seq++, kBaseTimeMs + i);
+  clock_.AdvanceTimeMilliseconds(interval_ms);
+  proxy_.Process();
+  EXPECT_GT(proxy_.TimeUntilNextProcess(), interval_ms);
+}
+
 }  // namespace webrtc
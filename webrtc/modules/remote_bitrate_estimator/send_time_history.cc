@@ -10,19 +10,31 @@
 
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/system_wrappers/include/clock.h"
 
 namespace webrtc {
+namespace {
+// Packets further behind the newest one can't be told apart from newer ones
+// once their 16 bit sequence numbers are unwrapped, so there is no point in
+// keeping them.
+constexpr size_t kMaxWindowSize = 1 << 15;
+constexpr size_t kMinHistorySize = 64;
+}  // namespace
 
 SendTimeHistory::SendTimeHistory(Clock* clock, int64_t packet_age_limit_ms)
-    : clock_(clock), packet_age_limit_ms_(packet_age_limit_ms) {}
+    : clock_(clock),
+      packet_age_limit_ms_(packet_age_limit_ms),
+      first_seq_num_(0),
+      window_size_(0) {}
 
 SendTimeHistory::~SendTimeHistory() {}
 
 void SendTimeHistory::Clear() {
-  history_.clear();
+  window_size_ = 0;
 }
 
 void SendTimeHistory::AddAndRemoveOld(uint16_t sequence_number,
@@ -30,31 +42,34 @@ void SendTimeHistory::AddAndRemoveOld(uint16_t sequence_number,
                                       int probe_cluster_id) {
   int64_t now_ms = clock_->TimeInMilliseconds();
   // Remove old.
-  while (!history_.empty() &&
-         now_ms - history_.begin()->second.creation_time_ms >
-             packet_age_limit_ms_) {
+  while (window_size_ > 0) {
+    const rtc::Optional<PacketInfo>& oldest = Slot(first_seq_num_);
+    if (oldest && now_ms - oldest->creation_time_ms <= packet_age_limit_ms_)
+      break;
     // TODO(sprang): Warn if erasing (too many) old items?
-    history_.erase(history_.begin());
+    ++first_seq_num_;
+    --window_size_;
   }
 
   // Add new.
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
+  if (!ExtendWindow(unwrapped_seq_num))
+    return;
   int64_t creation_time_ms = now_ms;
   constexpr int64_t kNoArrivalTimeMs = -1;  // Arrival time is ignored.
   constexpr int64_t kNoSendTimeMs = -1;     // Send time is set by OnSentPacket.
-  history_.insert(std::make_pair(
-      unwrapped_seq_num,
+  Slot(unwrapped_seq_num) = rtc::Optional<PacketInfo>(
       PacketInfo(creation_time_ms, kNoArrivalTimeMs, kNoSendTimeMs,
-                 sequence_number, payload_size, probe_cluster_id)));
+                 sequence_number, payload_size, probe_cluster_id));
 }
 
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  rtc::Optional<PacketInfo>* slot = FindSlot(unwrapped_seq_num);
+  if (!slot || !*slot)
     return false;
-  it->second.send_time_ms = send_time_ms;
+  (*slot)->send_time_ms = send_time_ms;
   return true;
 }
 
@@ -62,18 +77,82 @@ bool SendTimeHistory::GetInfo(PacketInfo* packet_info, bool remove) {
   RTC_DCHECK(packet_info);
   int64_t unwrapped_seq_num =
       seq_num_unwrapper_.Unwrap(packet_info->sequence_number);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  rtc::Optional<PacketInfo>* slot = FindSlot(unwrapped_seq_num);
+  if (!slot || !*slot)
     return false;
 
   // Save arrival_time not to overwrite it.
   int64_t arrival_time_ms = packet_info->arrival_time_ms;
-  *packet_info = it->second;
+  *packet_info = **slot;
   packet_info->arrival_time_ms = arrival_time_ms;
 
   if (remove)
-    history_.erase(it);
+    *slot = rtc::Optional<PacketInfo>();
+  return true;
+}
+
+bool SendTimeHistory::ExtendWindow(int64_t unwrapped_seq_num) {
+  if (window_size_ == 0) {
+    Reserve(1);
+    first_seq_num_ = unwrapped_seq_num;
+    window_size_ = 1;
+    Slot(unwrapped_seq_num) = rtc::Optional<PacketInfo>();
+    return true;
+  }
+
+  int64_t end_seq_num = first_seq_num_ + window_size_;
+  if (unwrapped_seq_num < first_seq_num_) {
+    size_t new_window_size = end_seq_num - unwrapped_seq_num;
+    if (new_window_size > kMaxWindowSize)
+      return false;
+    Reserve(new_window_size);
+    for (int64_t seq_num = unwrapped_seq_num; seq_num < first_seq_num_;
+         ++seq_num) {
+      Slot(seq_num) = rtc::Optional<PacketInfo>();
+    }
+    first_seq_num_ = unwrapped_seq_num;
+    window_size_ = new_window_size;
+  } else if (unwrapped_seq_num >= end_seq_num) {
+    int64_t new_first_seq_num = std::max<int64_t>(
+        first_seq_num_, unwrapped_seq_num + 1 - kMaxWindowSize);
+    if (new_first_seq_num >= end_seq_num) {
+      window_size_ = 0;
+    } else {
+      window_size_ -= new_first_seq_num - first_seq_num_;
+    }
+    first_seq_num_ = new_first_seq_num;
+    size_t new_window_size = unwrapped_seq_num + 1 - new_first_seq_num;
+    Reserve(new_window_size);
+    for (int64_t seq_num = std::max(end_seq_num, new_first_seq_num);
+         seq_num <= unwrapped_seq_num; ++seq_num) {
+      Slot(seq_num) = rtc::Optional<PacketInfo>();
+    }
+    window_size_ = new_window_size;
+  }
   return true;
 }
 
+void SendTimeHistory::Reserve(size_t window_size) {
+  if (history_.size() >= window_size)
+    return;
+  size_t new_size = std::max(kMinHistorySize, history_.size());
+  while (new_size < window_size)
+    new_size *= 2;
+  std::vector<rtc::Optional<PacketInfo>> new_history(new_size);
+  for (int64_t seq_num = first_seq_num_;
+       seq_num < first_seq_num_ + static_cast<int64_t>(window_size_);
+       ++seq_num) {
+    new_history[seq_num & (new_size - 1)] = Slot(seq_num);
+  }
+  history_.swap(new_history);
+}
+
+rtc::Optional<PacketInfo>* SendTimeHistory::FindSlot(
+    int64_t unwrapped_seq_num) {
+  if (unwrapped_seq_num < first_seq_num_ ||
+      unwrapped_seq_num >= first_seq_num_ + static_cast<int64_t>(window_size_))
+    return nullptr;
+  return &Slot(unwrapped_seq_num);
+}
+
 }  // namespace webrtc
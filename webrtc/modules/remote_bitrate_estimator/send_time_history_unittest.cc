@@ -13,6 +13,8 @@
 #include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/send_time_history.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -235,5 +237,47 @@ TEST_F(SendTimeHistoryTest, InterlievedGetAndRemove) {
   EXPECT_EQ(packets[2], info3);
 }
 
+TEST_F(SendTimeHistoryTest, AddOlderThanOldest) {
+  const uint16_t kSeqNo = 10;
+  AddPacketWithSendTime(kSeqNo, 0, 1, PacketInfo::kNotAProbe);
+  AddPacketWithSendTime(kSeqNo - 5, 0, 2, PacketInfo::kNotAProbe);
+
+  PacketInfo info(0, kSeqNo);
+  EXPECT_TRUE(history_.GetInfo(&info, true));
+  EXPECT_EQ(1, info.send_time_ms);
+  PacketInfo info2(0, kSeqNo - 5);
+  EXPECT_TRUE(history_.GetInfo(&info2, true));
+  EXPECT_EQ(2, info2.send_time_ms);
+  for (uint16_t i = kSeqNo - 6; i <= kSeqNo + 1; ++i) {
+    PacketInfo info3(0, i);
+    EXPECT_FALSE(history_.GetInfo(&info3, false));
+  }
+}
+
+// Simulates 5000 packets per second, with feedback for every 100 of them.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(SendTimeHistoryTest, DISABLED_AddAndGetThroughput) {
+  const int kNumPackets = 2000000;
+  const int kPacketsPerFeedback = 100;
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumPackets; i += kPacketsPerFeedback) {
+    for (int j = i; j < i + kPacketsPerFeedback; ++j) {
+      if (j % 5 == 0)
+        clock_.AdvanceTimeMilliseconds(1);
+      AddPacketWithSendTime(static_cast<uint16_t>(j), 1200,
+                            clock_.TimeInMilliseconds(),
+                            PacketInfo::kNotAProbe);
+    }
+    // Feedback lags behind by one message.
+    for (int j = i - kPacketsPerFeedback; j < i; ++j) {
+      PacketInfo info(0, static_cast<uint16_t>(j));
+      history_.GetInfo(&info, true);
+    }
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  LOG(LS_INFO) << "Added and looked up " << kNumPackets << " packets: "
+               << elapsed_ns / kNumPackets << " ns/packet.";
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -90,6 +90,13 @@ class RtpReceiver {
 
   // Returns the current energy of the RTP stream received.
   virtual int32_t Energy(uint8_t array_of_energy[kRtpCsrcSize]) const = 0;
+
+  // Returns the audio level in -dBov and the voice activity flag of the
+  // header-extension-for-audio-level-indication of the last received packet
+  // carrying it, without decoding the payload. Returns false if no such packet
+  // has been received.
+  virtual bool LastReceivedAudioLevel(uint8_t* audio_level_dbov,
+                                      bool* voice_activity) const = 0;
 };
 }  // namespace webrtc
 
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/modules/include/module.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
@@ -449,6 +450,12 @@ class RtpRtcp : public Module {
   // return -1 on failure else 0.
   virtual int32_t SetAudioLevel(uint8_t level_dbov) = 0;
 
+  // Store the voice activity for the V flag of the audio level header
+  // extension, e.g. as detected by the audio processing since the previous
+  // packet. Comfort noise packets never have the flag set. If not set, the
+  // flag is set for all speech frames, as reported by the codec.
+  virtual void SetAudioVoiceActivity(rtc::Optional<bool> voice_activity) = 0;
+
   // **************************************************************************
   // Video
   // **************************************************************************
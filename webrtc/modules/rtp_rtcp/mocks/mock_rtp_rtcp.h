@@ -186,6 +186,8 @@ class MockRtpRtcp : public RtpRtcp {
   MOCK_METHOD2(SetRTPAudioLevelIndicationStatus,
                int32_t(bool enable, uint8_t id));
   MOCK_METHOD1(SetAudioLevel, int32_t(uint8_t level_dbov));
+  MOCK_METHOD1(SetAudioVoiceActivity,
+               void(rtc::Optional<bool> voice_activity));
   MOCK_METHOD1(SetTargetSendBitrate, void(uint32_t bitrate_bps));
   MOCK_METHOD3(SetGenericFECStatus,
                void(bool enable,
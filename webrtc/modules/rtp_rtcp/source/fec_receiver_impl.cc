@@ -34,7 +34,7 @@ FecReceiverImpl::~FecReceiverImpl() {
 }
 
 FecPacketCounter FecReceiverImpl::GetPacketCounter() const {
-  rtc::CritScope cs(&crit_sect_);
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   return packet_counter_;
 }
 
@@ -69,7 +69,7 @@ FecPacketCounter FecReceiverImpl::GetPacketCounter() const {
 int32_t FecReceiverImpl::AddReceivedRedPacket(
     const RTPHeader& header, const uint8_t* incoming_rtp_packet,
     size_t packet_length, uint8_t ulpfec_payload_type) {
-  rtc::CritScope cs(&crit_sect_);
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
 
   uint8_t red_header_length = 1;
   size_t payload_data_length = packet_length - header.headerLength;
@@ -200,20 +200,17 @@ int32_t FecReceiverImpl::AddReceivedRedPacket(
 }
 
 int32_t FecReceiverImpl::ProcessReceivedFec() {
-  crit_sect_.Enter();
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   if (!received_packets_.empty()) {
     // Send received media packet to VCM.
     if (!received_packets_.front()->is_fec) {
       ForwardErrorCorrection::Packet* packet = received_packets_.front()->pkt;
-      crit_sect_.Leave();
       if (!recovered_packet_callback_->OnRecoveredPacket(packet->data,
                                                          packet->length)) {
         return -1;
       }
-      crit_sect_.Enter();
     }
     if (fec_->DecodeFec(&received_packets_, &recovered_packets_) != 0) {
-      crit_sect_.Leave();
       return -1;
     }
     RTC_DCHECK(received_packets_.empty());
@@ -226,15 +223,12 @@ int32_t FecReceiverImpl::ProcessReceivedFec() {
     }
     ForwardErrorCorrection::Packet* packet = recovered_packet->pkt;
     ++packet_counter_.num_recovered_packets;
-    crit_sect_.Leave();
     if (!recovered_packet_callback_->OnRecoveredPacket(packet->data,
                                                        packet->length)) {
       return -1;
     }
-    crit_sect_.Enter();
     recovered_packet->returned = true;
   }
-  crit_sect_.Leave();
   return 0;
 }
 
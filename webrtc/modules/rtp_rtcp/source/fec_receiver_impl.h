@@ -13,7 +13,7 @@
 
 #include <memory>
 
-#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/race_checker.h"
 #include "webrtc/modules/rtp_rtcp/include/fec_receiver.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
@@ -21,6 +21,8 @@
 
 namespace webrtc {
 
+// Not thread safe. All calls, including GetPacketCounter(), must be
+// serialized, which they are on the packet delivery path that feeds it.
 class FecReceiverImpl : public FecReceiver {
  public:
   explicit FecReceiverImpl(RtpData* callback);
@@ -36,7 +38,7 @@ class FecReceiverImpl : public FecReceiver {
   FecPacketCounter GetPacketCounter() const override;
 
  private:
-  rtc::CriticalSection crit_sect_;
+  rtc::RaceChecker race_checker_;
   RtpData* recovered_packet_callback_;
   std::unique_ptr<ForwardErrorCorrection> fec_;
   // TODO(holmer): In the current version |received_packets_| is never more
@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/include/flexfec_receiver.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+
+namespace webrtc {
+
+FlexfecReceiver::FlexfecReceiver(uint32_t ssrc,
+                                 uint32_t protected_media_ssrc,
+                                 RtpData* recovered_packet_callback)
+    : ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc),
+      erasure_code_(ForwardErrorCorrection::CreateFlexfec()),
+      recovered_packet_callback_(recovered_packet_callback) {
+  RTC_DCHECK(recovered_packet_callback_);
+}
+
+FlexfecReceiver::~FlexfecReceiver() {
+  received_packets_.clear();
+  erasure_code_->ResetState(&recovered_packets_);
+}
+
+bool FlexfecReceiver::AddAndProcessReceivedPacket(const uint8_t* packet,
+                                                  size_t packet_length) {
+  if (!AddReceivedPacket(packet, packet_length)) {
+    return false;
+  }
+  return ProcessReceivedPackets();
+}
+
+FecPacketCounter FlexfecReceiver::GetPacketCounter() const {
+  return packet_counter_;
+}
+
+bool FlexfecReceiver::AddReceivedPacket(const uint8_t* packet,
+                                        size_t packet_length) {
+  RTPHeader header;
+  if (packet_length < kRtpHeaderSize ||
+      !RtpUtility::RtpHeaderParser(packet, packet_length).Parse(&header)) {
+    LOG(LS_WARNING) << "Received malformed RTP packet.";
+    return false;
+  }
+  if (packet_length > IP_PACKET_SIZE) {
+    LOG(LS_WARNING) << "Received RTP packet is larger than an IP packet.";
+    return false;
+  }
+
+  std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> received_packet(
+      new ForwardErrorCorrection::ReceivedPacket());
+  received_packet->seq_num = header.sequenceNumber;
+  received_packet->ssrc = header.ssrc;
+  received_packet->pkt = new ForwardErrorCorrection::Packet();
+  if (header.ssrc == ssrc_) {
+    // The FEC header follows the RTP header, which is not used by the
+    // decoder.
+    if (header.headerLength + header.paddingLength >= packet_length) {
+      LOG(LS_WARNING) << "Received empty FlexFEC packet.";
+      return false;
+    }
+    const size_t payload_length =
+        packet_length - header.headerLength - header.paddingLength;
+    received_packet->is_fec = true;
+    memcpy(received_packet->pkt->data, packet + header.headerLength,
+           payload_length);
+    received_packet->pkt->length = payload_length;
+    ++packet_counter_.num_fec_packets;
+  } else if (header.ssrc == protected_media_ssrc_) {
+    // Media packets are protected in their entirety.
+    received_packet->is_fec = false;
+    memcpy(received_packet->pkt->data, packet, packet_length);
+    received_packet->pkt->length = packet_length;
+  } else {
+    LOG(LS_WARNING) << "Received packet with SSRC " << header.ssrc
+                    << " that is not handled by FlexFEC stream " << ssrc_
+                    << ".";
+    return false;
+  }
+  ++packet_counter_.num_packets;
+
+  received_packets_.push_back(std::move(received_packet));
+  return true;
+}
+
+bool FlexfecReceiver::ProcessReceivedPackets() {
+  // Decode.
+  if (!received_packets_.empty()) {
+    if (erasure_code_->DecodeFec(&received_packets_, &recovered_packets_) !=
+        0) {
+      return false;
+    }
+    RTC_DCHECK(received_packets_.empty());
+  }
+  // Return recovered packets through callback.
+  for (const auto& recovered_packet : recovered_packets_) {
+    if (recovered_packet->returned) {
+      continue;
+    }
+    ++packet_counter_.num_recovered_packets;
+    if (!recovered_packet_callback_->OnRecoveredPacket(
+            recovered_packet->pkt->data, recovered_packet->pkt->length)) {
+      return false;
+    }
+    recovered_packet->returned = true;
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/include/flexfec_receiver.h"
+#include "webrtc/modules/rtp_rtcp/include/flexfec_sender.h"
+#include "webrtc/modules/rtp_rtcp/mocks/mock_rtp_rtcp.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+namespace {
+
+using ::testing::_;
+using ::testing::Args;
+using ::testing::ElementsAreArray;
+using ::testing::Return;
+
+constexpr int kFlexfecPayloadType = 123;
+constexpr uint32_t kMediaSsrc = 1234;
+constexpr uint32_t kFlexfecSsrc = 5678;
+constexpr uint16_t kMediaStartSeqNum = 65534;  // Wraps around.
+// Two media packets per frame, protected by one FEC packet.
+constexpr FecProtectionParams kParams = {128, 1, kFecMaskBursty};
+
+std::unique_ptr<RtpPacketToSend> CreateMediaPacket(uint16_t seq_num,
+                                                   bool marker,
+                                                   size_t payload_length) {
+  std::unique_ptr<RtpPacketToSend> packet(new RtpPacketToSend(nullptr));
+  packet->SetPayloadType(96);
+  packet->SetSequenceNumber(seq_num);
+  packet->SetTimestamp(90000);
+  packet->SetSsrc(kMediaSsrc);
+  packet->SetMarker(marker);
+  uint8_t* payload = packet->AllocatePayload(payload_length);
+  for (size_t i = 0; i < payload_length; ++i) {
+    payload[i] = static_cast<uint8_t>(seq_num + i);
+  }
+  return packet;
+}
+
+}  // namespace
+
+class FlexfecReceiverTest : public ::testing::Test {
+ protected:
+  FlexfecReceiverTest()
+      : clock_(1),
+        sender_(kFlexfecPayloadType, kFlexfecSsrc, kMediaSsrc, &clock_),
+        receiver_(kFlexfecSsrc, kMediaSsrc, &recovered_packet_callback_) {
+    sender_.SetFecParameters(kParams);
+    media_packets_.push_back(
+        CreateMediaPacket(kMediaStartSeqNum, false, 100));
+    media_packets_.push_back(
+        CreateMediaPacket(kMediaStartSeqNum + 1, true, 50));
+    for (const auto& media_packet : media_packets_) {
+      EXPECT_TRUE(sender_.AddRtpPacketAndGenerateFec(*media_packet));
+    }
+    fec_packets_ = sender_.GetFecPackets();
+  }
+
+  SimulatedClock clock_;
+  FlexfecSender sender_;
+  MockRtpData recovered_packet_callback_;
+  FlexfecReceiver receiver_;
+  std::vector<std::unique_ptr<RtpPacketToSend>> media_packets_;
+  std::vector<std::unique_ptr<RtpPacketToSend>> fec_packets_;
+};
+
+TEST_F(FlexfecReceiverTest, NothingRecoveredWithoutLoss) {
+  ASSERT_EQ(1U, fec_packets_.size());
+  EXPECT_CALL(recovered_packet_callback_, OnRecoveredPacket(_, _)).Times(0);
+  for (const auto& packet : media_packets_) {
+    EXPECT_TRUE(
+        receiver_.AddAndProcessReceivedPacket(packet->data(), packet->size()));
+  }
+  EXPECT_TRUE(receiver_.AddAndProcessReceivedPacket(fec_packets_[0]->data(),
+                                                    fec_packets_[0]->size()));
+
+  FecPacketCounter counter = receiver_.GetPacketCounter();
+  EXPECT_EQ(3U, counter.num_packets);
+  EXPECT_EQ(1U, counter.num_fec_packets);
+  EXPECT_EQ(0U, counter.num_recovered_packets);
+}
+
+// Both orders of arrival of the FEC packet and the remaining media packet
+// recover the lost one.
+TEST_F(FlexfecReceiverTest, RecoversLostMediaPacket) {
+  ASSERT_EQ(1U, fec_packets_.size());
+  for (size_t lost : {0, 1}) {
+    const RtpPacketToSend& lost_packet = *media_packets_[lost];
+    const RtpPacketToSend& received_packet = *media_packets_[1 - lost];
+    FlexfecReceiver receiver(kFlexfecSsrc, kMediaSsrc,
+                             &recovered_packet_callback_);
+    EXPECT_CALL(recovered_packet_callback_, OnRecoveredPacket(_, _))
+        .With(Args<0, 1>(ElementsAreArray(lost_packet.data(),
+                                          lost_packet.size())))
+        .WillOnce(Return(true));
+    if (lost == 0) {
+      EXPECT_TRUE(receiver.AddAndProcessReceivedPacket(
+          received_packet.data(), received_packet.size()));
+      EXPECT_TRUE(receiver.AddAndProcessReceivedPacket(
+          fec_packets_[0]->data(), fec_packets_[0]->size()));
+    } else {
+      EXPECT_TRUE(receiver.AddAndProcessReceivedPacket(
+          fec_packets_[0]->data(), fec_packets_[0]->size()));
+      EXPECT_TRUE(receiver.AddAndProcessReceivedPacket(
+          received_packet.data(), received_packet.size()));
+    }
+    EXPECT_EQ(1U, receiver.GetPacketCounter().num_recovered_packets);
+    ::testing::Mock::VerifyAndClearExpectations(&recovered_packet_callback_);
+  }
+}
+
+TEST_F(FlexfecReceiverTest, DropsPacketsOfOtherStreams) {
+  std::unique_ptr<RtpPacketToSend> packet =
+      CreateMediaPacket(kMediaStartSeqNum, true, 100);
+  packet->SetSsrc(kMediaSsrc + 1);
+  EXPECT_FALSE(
+      receiver_.AddAndProcessReceivedPacket(packet->data(), packet->size()));
+  EXPECT_EQ(0U, receiver_.GetPacketCounter().num_packets);
+}
+
+TEST_F(FlexfecReceiverTest, DropsTruncatedPackets) {
+  const uint8_t kTruncated[] = {0x80, 0x00, 0x00};
+  EXPECT_FALSE(
+      receiver_.AddAndProcessReceivedPacket(kTruncated, sizeof(kTruncated)));
+  // An RTP header alone, without any FlexFEC header.
+  ASSERT_EQ(1U, fec_packets_.size());
+  EXPECT_CALL(recovered_packet_callback_, OnRecoveredPacket(_, _)).Times(0);
+  EXPECT_TRUE(receiver_.AddAndProcessReceivedPacket(
+      media_packets_[0]->data(), media_packets_[0]->size()));
+  EXPECT_FALSE(receiver_.AddAndProcessReceivedPacket(fec_packets_[0]->data(),
+                                                     kRtpHeaderSize));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/rtp_rtcp/include/flexfec_sender.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
+
+namespace webrtc {
+
+namespace {
+
+// Let first sequence number be in the first half of the interval.
+constexpr uint16_t kMaxInitRtpSeqNumber = 0x7fff;
+
+// Since we will mainly use FlexFEC for video, we use a 90 kHz RTP clock,
+// as for video.
+constexpr int kMsToRtpTimestamp = kVideoPayloadTypeFrequency / 1000;
+
+}  // namespace
+
+FlexfecSender::FlexfecSender(int payload_type,
+                             uint32_t ssrc,
+                             uint32_t protected_media_ssrc,
+                             Clock* clock)
+    : clock_(clock),
+      random_(clock_->TimeInMicroseconds()),
+      payload_type_(payload_type),
+      // Random RTP timestamp offset, as per RFC 3550.
+      timestamp_offset_(random_.Rand<uint32_t>()),
+      ssrc_(ssrc),
+      protected_media_ssrc_(protected_media_ssrc),
+      // Random sequence number start, as per RFC 3550.
+      seq_num_(random_.Rand(1, kMaxInitRtpSeqNumber)),
+      producer_(ForwardErrorCorrection::CreateFlexfec()) {
+  // This object should not have been instantiated if FlexFEC is disabled.
+  RTC_DCHECK_GE(payload_type, 0);
+  RTC_DCHECK_LE(payload_type, 127);
+  // FlexFEC must not share the SSRC of the stream it protects.
+  RTC_DCHECK_NE(ssrc, protected_media_ssrc);
+}
+
+FlexfecSender::~FlexfecSender() = default;
+
+int32_t FlexfecSender::RegisterRtpHeaderExtension(RTPExtensionType type,
+                                                  uint8_t id) {
+  return rtp_header_extension_map_.Register(type, id);
+}
+
+void FlexfecSender::SetFecParameters(const FecProtectionParams& params) {
+  // TODO(brandtr): Update this function when we support multistream protection.
+  producer_.SetFecParameters(&params, 0);
+}
+
+bool FlexfecSender::AddRtpPacketAndGenerateFec(const RtpPacketToSend& packet) {
+  // TODO(brandtr): Update this function when we support multistream protection.
+  if (packet.Ssrc() != protected_media_ssrc_) {
+    LOG(LS_WARNING) << "Packet with SSRC " << packet.Ssrc()
+                    << " is not protected by FlexFEC stream " << ssrc_ << ".";
+    return false;
+  }
+  return producer_.AddRtpPacketAndGenerateFec(
+             packet.data(), packet.payload_size(), packet.headers_size()) == 0;
+}
+
+bool FlexfecSender::FecAvailable() const {
+  return producer_.FecAvailable();
+}
+
+std::vector<std::unique_ptr<RtpPacketToSend>> FlexfecSender::GetFecPackets() {
+  std::vector<std::unique_ptr<RtpPacketToSend>> fec_packets_to_send;
+  fec_packets_to_send.reserve(producer_.NumAvailableFecPackets());
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  for (const ForwardErrorCorrection::Packet* fec_packet :
+       producer_.GetFecPackets()) {
+    std::unique_ptr<RtpPacketToSend> fec_packet_to_send(
+        new RtpPacketToSend(&rtp_header_extension_map_));
+
+    // RTP header.
+    fec_packet_to_send->SetMarker(false);
+    fec_packet_to_send->SetPayloadType(payload_type_);
+    fec_packet_to_send->SetSequenceNumber(seq_num_++);
+    fec_packet_to_send->SetTimestamp(
+        timestamp_offset_ + static_cast<uint32_t>(kMsToRtpTimestamp * now_ms));
+    // Set "capture time" so that the TransmissionOffset header extension
+    // can be set by the RTPSender.
+    fec_packet_to_send->set_capture_time_ms(now_ms);
+    fec_packet_to_send->SetSsrc(ssrc_);
+    // Reserve extensions, if registered. These will be set by the RTPSender.
+    fec_packet_to_send->ReserveExtension<AbsoluteSendTime>();
+    fec_packet_to_send->ReserveExtension<TransmissionOffset>();
+    fec_packet_to_send->ReserveExtension<TransportSequenceNumber>();
+
+    // RTP payload.
+    uint8_t* payload = fec_packet_to_send->AllocatePayload(fec_packet->length);
+    memcpy(payload, fec_packet->data, fec_packet->length);
+
+    fec_packets_to_send.push_back(std::move(fec_packet_to_send));
+  }
+  return fec_packets_to_send;
+}
+
+size_t FlexfecSender::MaxPacketOverhead() const {
+  return producer_.MaxPacketOverhead();
+}
+
+}  // namespace webrtc
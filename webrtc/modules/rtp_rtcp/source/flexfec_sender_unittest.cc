@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/modules/rtp_rtcp/include/flexfec_sender.h"
+#include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "webrtc/system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kFlexfecPayloadType = 123;
+constexpr uint32_t kMediaSsrc = 1234;
+constexpr uint32_t kFlexfecSsrc = 5678;
+constexpr int kPayloadLength = 100;
+// Assume a single protected frame, i.e. one FEC packet per frame.
+constexpr FecProtectionParams kParams = {15, 1, kFecMaskRandom};
+constexpr int64_t kInitialSimulatedClockTimeMs = 1;
+
+std::unique_ptr<RtpPacketToSend> CreateMediaPacket(uint16_t seq_num) {
+  std::unique_ptr<RtpPacketToSend> packet(new RtpPacketToSend(nullptr));
+  packet->SetPayloadType(96);
+  packet->SetSequenceNumber(seq_num);
+  packet->SetTimestamp(90000);
+  packet->SetSsrc(kMediaSsrc);
+  packet->SetMarker(true);
+  uint8_t* payload = packet->AllocatePayload(kPayloadLength);
+  for (int i = 0; i < kPayloadLength; ++i) {
+    payload[i] = i;
+  }
+  return packet;
+}
+
+}  // namespace
+
+class FlexfecSenderTest : public ::testing::Test {
+ protected:
+  FlexfecSenderTest()
+      : clock_(kInitialSimulatedClockTimeMs * 1000),
+        sender_(kFlexfecPayloadType, kFlexfecSsrc, kMediaSsrc, &clock_) {}
+
+  SimulatedClock clock_;
+  FlexfecSender sender_;
+};
+
+TEST_F(FlexfecSenderTest, NoFecAvailableBeforeMediaAdded) {
+  EXPECT_FALSE(sender_.FecAvailable());
+  EXPECT_TRUE(sender_.GetFecPackets().empty());
+}
+
+TEST_F(FlexfecSenderTest, ProtectsOneFrame) {
+  sender_.SetFecParameters(kParams);
+  EXPECT_TRUE(sender_.AddRtpPacketAndGenerateFec(*CreateMediaPacket(1000)));
+  EXPECT_TRUE(sender_.FecAvailable());
+
+  std::vector<std::unique_ptr<RtpPacketToSend>> fec_packets =
+      sender_.GetFecPackets();
+  EXPECT_FALSE(sender_.FecAvailable());
+  ASSERT_EQ(1U, fec_packets.size());
+
+  const RtpPacketToSend& fec_packet = *fec_packets[0];
+  EXPECT_EQ(kRtpHeaderSize, fec_packet.headers_size());
+  EXPECT_FALSE(fec_packet.Marker());
+  EXPECT_EQ(kFlexfecPayloadType, fec_packet.PayloadType());
+  EXPECT_EQ(kFlexfecSsrc, fec_packet.Ssrc());
+  EXPECT_EQ(kInitialSimulatedClockTimeMs, fec_packet.capture_time_ms());
+  // The FEC payload is the smallest FlexFEC header followed by the protected
+  // payload.
+  EXPECT_EQ(20U + kPayloadLength, fec_packet.payload_size());
+  EXPECT_GE(sender_.MaxPacketOverhead(), 20U);
+}
+
+TEST_F(FlexfecSenderTest, FecPacketsGetConsecutiveSequenceNumbers) {
+  sender_.SetFecParameters(kParams);
+  EXPECT_TRUE(sender_.AddRtpPacketAndGenerateFec(*CreateMediaPacket(1000)));
+  std::vector<std::unique_ptr<RtpPacketToSend>> first = sender_.GetFecPackets();
+  clock_.AdvanceTimeMilliseconds(33);
+  EXPECT_TRUE(sender_.AddRtpPacketAndGenerateFec(*CreateMediaPacket(1001)));
+  std::vector<std::unique_ptr<RtpPacketToSend>> second =
+      sender_.GetFecPackets();
+  ASSERT_EQ(1U, first.size());
+  ASSERT_EQ(1U, second.size());
+
+  EXPECT_EQ(static_cast<uint16_t>(first[0]->SequenceNumber() + 1),
+            second[0]->SequenceNumber());
+  // 33 ms on a 90 kHz clock.
+  EXPECT_EQ(first[0]->Timestamp() + 33 * 90, second[0]->Timestamp());
+}
+
+TEST_F(FlexfecSenderTest, ReservesRegisteredHeaderExtensions) {
+  EXPECT_EQ(0, sender_.RegisterRtpHeaderExtension(
+                   kRtpExtensionAbsoluteSendTime, 1));
+  EXPECT_EQ(0, sender_.RegisterRtpHeaderExtension(
+                   kRtpExtensionTransportSequenceNumber, 2));
+  sender_.SetFecParameters(kParams);
+  EXPECT_TRUE(sender_.AddRtpPacketAndGenerateFec(*CreateMediaPacket(1000)));
+
+  std::vector<std::unique_ptr<RtpPacketToSend>> fec_packets =
+      sender_.GetFecPackets();
+  ASSERT_EQ(1U, fec_packets.size());
+  EXPECT_TRUE(fec_packets[0]->HasExtension<AbsoluteSendTime>());
+  EXPECT_TRUE(fec_packets[0]->HasExtension<TransportSequenceNumber>());
+  EXPECT_FALSE(fec_packets[0]->HasExtension<TransmissionOffset>());
+}
+
+TEST_F(FlexfecSenderTest, RejectsPacketsOfOtherStreams) {
+  sender_.SetFecParameters(kParams);
+  std::unique_ptr<RtpPacketToSend> packet = CreateMediaPacket(1000);
+  packet->SetSsrc(kMediaSsrc + 1);
+  EXPECT_FALSE(sender_.AddRtpPacketAndGenerateFec(*packet));
+  EXPECT_FALSE(sender_.FecAvailable());
+}
+
+}  // namespace webrtc
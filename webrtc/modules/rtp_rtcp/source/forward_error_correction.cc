@@ -16,10 +16,17 @@
 #include <iterator>
 #include <utility>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "webrtc/modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
 
 namespace webrtc {
@@ -55,6 +62,23 @@ bool ForwardErrorCorrection::SortablePacket::LessThan::operator() (
   return IsNewerSequenceNumber(second->seq_num, first->seq_num);
 }
 
+namespace {
+
+// Inserts |packet| into |packets|, which is sorted by sequence number, after
+// any packet with the same sequence number. Packets mostly arrive in order,
+// so the position is searched for from the back, which avoids re-sorting the
+// whole list for every packet.
+template <typename PacketList, typename PacketPtr>
+void InsertSorted(PacketList* packets, PacketPtr packet) {
+  ForwardErrorCorrection::SortablePacket::LessThan less_than;
+  auto it = packets->end();
+  while (it != packets->begin() && less_than(packet, *std::prev(it)))
+    --it;
+  packets->insert(it, std::move(packet));
+}
+
+}  // namespace
+
 ForwardErrorCorrection::ReceivedPacket::ReceivedPacket() = default;
 ForwardErrorCorrection::ReceivedPacket::~ReceivedPacket() = default;
 
@@ -84,6 +108,14 @@ std::unique_ptr<ForwardErrorCorrection> ForwardErrorCorrection::CreateUlpfec() {
       std::move(fec_header_reader), std::move(fec_header_writer)));
 }
 
+std::unique_ptr<ForwardErrorCorrection>
+ForwardErrorCorrection::CreateFlexfec() {
+  std::unique_ptr<FecHeaderReader> fec_header_reader(new FlexfecHeaderReader());
+  std::unique_ptr<FecHeaderWriter> fec_header_writer(new FlexfecHeaderWriter());
+  return std::unique_ptr<ForwardErrorCorrection>(new ForwardErrorCorrection(
+      std::move(fec_header_reader), std::move(fec_header_writer)));
+}
+
 int ForwardErrorCorrection::EncodeFec(const PacketList& media_packets,
                                       uint8_t protection_factor,
                                       int num_important_packets,
@@ -152,9 +184,10 @@ int ForwardErrorCorrection::EncodeFec(const PacketList& media_packets,
   GenerateFecPayloads(media_packets, num_fec_packets);
   // TODO(brandtr): Generalize this when multistream protection support is
   // added.
+  const uint32_t media_ssrc = ParseSsrc(media_packets.front().get()->data);
   const uint16_t seq_num_base =
       ParseSequenceNumber(media_packets.front().get()->data);
-  FinalizeFecHeaders(num_fec_packets, seq_num_base);
+  FinalizeFecHeaders(num_fec_packets, media_ssrc, seq_num_base);
 
   return 0;
 }
@@ -305,11 +338,12 @@ int ForwardErrorCorrection::InsertZerosInPacketMasks(
 }
 
 void ForwardErrorCorrection::FinalizeFecHeaders(size_t num_fec_packets,
+                                                uint32_t media_ssrc,
                                                 uint16_t seq_num_base) {
   for (size_t i = 0; i < num_fec_packets; ++i) {
     fec_header_writer_->FinalizeFecHeader(
-        seq_num_base, &packet_masks_[i * packet_mask_size_], packet_mask_size_,
-        &generated_fec_packets_[i]);
+        media_ssrc, seq_num_base, &packet_masks_[i * packet_mask_size_],
+        packet_mask_size_, &generated_fec_packets_[i]);
   }
 }
 
@@ -340,11 +374,8 @@ void ForwardErrorCorrection::InsertMediaPacket(
   recovered_packet->seq_num = received_packet->seq_num;
   recovered_packet->pkt = received_packet->pkt;
   recovered_packet->pkt->length = received_packet->pkt->length;
-  // TODO(holmer): Consider replacing this with a binary search for the right
-  // position, and then just insert the new packet. Would get rid of the sort.
   RecoveredPacket* recovered_packet_ptr = recovered_packet.get();
-  recovered_packets->push_back(std::move(recovered_packet));
-  recovered_packets->sort(SortablePacket::LessThan());
+  InsertSorted(recovered_packets, std::move(recovered_packet));
   UpdateCoveringFecPackets(*recovered_packet_ptr);
 }
 
@@ -406,15 +437,11 @@ void ForwardErrorCorrection::InsertFecPacket(
     LOG(LS_WARNING) << "Received FEC packet has an all-zero packet mask.";
   } else {
     AssignRecoveredPackets(recovered_packets, fec_packet.get());
-    // TODO(holmer): Consider replacing this with a binary search for the right
-    // position, and then just insert the new packet. Would get rid of the sort.
-    //
     // For correct decoding, |received_fec_packets_| does not necessarily
     // need to be sorted by sequence number (see decoding algorithm in
     // AttemptRecover()). By keeping it sorted we try to recover the
     // oldest lost packets first, however.
-    received_fec_packets_.push_back(std::move(fec_packet));
-    received_fec_packets_.sort(SortablePacket::LessThan());
+    InsertSorted(&received_fec_packets_, std::move(fec_packet));
     const size_t max_fec_packets = fec_header_reader_->MaxFecPackets();
     if (received_fec_packets_.size() > max_fec_packets) {
       received_fec_packets_.pop_front();
@@ -463,7 +490,12 @@ void ForwardErrorCorrection::InsertPackets(
     // TODO(marpan/holmer): We should be able to improve detection/discarding of
     // old FEC packets based on timestamp information or better sequence number
     // thresholding (e.g., to distinguish between wrap-around and reordering).
-    if (!received_fec_packets_.empty()) {
+    // Media packets are only compared with FEC packets sharing their sequence
+    // number space, which FlexFEC packets sent on an SSRC of their own don't.
+    if (!received_fec_packets_.empty() &&
+        (received_packet->is_fec ||
+         received_fec_packets_.front()->ssrc ==
+             received_fec_packets_.front()->protected_ssrc)) {
       uint16_t seq_num_diff =
           abs(static_cast<int>(received_packet->seq_num) -
               static_cast<int>(received_fec_packets_.front()->seq_num));
@@ -569,8 +601,27 @@ void ForwardErrorCorrection::XorPayloads(const Packet& src,
   // XOR the payload.
   RTC_DCHECK_LE(kRtpHeaderSize + payload_length, sizeof(src.data));
   RTC_DCHECK_LE(dst_offset + payload_length, sizeof(dst->data));
-  for (size_t i = 0; i < payload_length; ++i) {
-    dst->data[dst_offset + i] ^= src.data[kRtpHeaderSize + i];
+  const uint8_t* src_data = &src.data[kRtpHeaderSize];
+  uint8_t* dst_data = &dst->data[dst_offset];
+  size_t i = 0;
+  // If we know the minimum architecture at compile time, XOR 16 bytes at a
+  // time.
+#if defined(__SSE2__)
+  for (; i + 16 <= payload_length; i += 16) {
+    __m128i* dst_block = reinterpret_cast<__m128i*>(dst_data + i);
+    __m128i src_block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_data + i));
+    _mm_storeu_si128(dst_block,
+                     _mm_xor_si128(_mm_loadu_si128(dst_block), src_block));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; i + 16 <= payload_length; i += 16) {
+    vst1q_u8(dst_data + i,
+             veorq_u8(vld1q_u8(dst_data + i), vld1q_u8(src_data + i)));
+  }
+#endif
+  for (; i < payload_length; ++i) {
+    dst_data[i] ^= src_data[i];
   }
 }
 
@@ -616,11 +667,7 @@ void ForwardErrorCorrection::AttemptRecovery(
       auto recovered_packet_ptr = recovered_packet.get();
       // Add recovered packet to the list of recovered packets and update any
       // FEC packets covering this packet with a pointer to the data.
-      // TODO(holmer): Consider replacing this with a binary search for the
-      // right position, and then just insert the new packet. Would get rid of
-      // the sort.
-      recovered_packets->push_back(std::move(recovered_packet));
-      recovered_packets->sort(SortablePacket::LessThan());
+      InsertSorted(recovered_packets, std::move(recovered_packet));
       UpdateCoveringFecPackets(*recovered_packet_ptr);
       DiscardOldRecoveredPackets(recovered_packets);
       fec_packet_it = received_fec_packets_.erase(fec_packet_it);
@@ -677,10 +724,16 @@ int ForwardErrorCorrection::DecodeFec(
   // error?
   const size_t max_media_packets = fec_header_reader_->MaxMediaPackets();
   if (recovered_packets->size() == max_media_packets) {
+    const ReceivedPacket& received_packet = *received_packets->front();
+    // FlexFEC packets don't share the sequence number space of the media
+    // packets they protect, unless they are sent on the same SSRC.
+    const bool same_seq_num_space =
+        !received_packet.is_fec ||
+        received_packet.ssrc == ParseSsrc(recovered_packets->back()->pkt->data);
     const unsigned int seq_num_diff =
-        abs(static_cast<int>(received_packets->front()->seq_num) -
+        abs(static_cast<int>(received_packet.seq_num) -
             static_cast<int>(recovered_packets->back()->seq_num));
-    if (seq_num_diff > max_media_packets) {
+    if (same_seq_num_space && seq_num_diff > max_media_packets) {
       // A big gap in sequence numbers. The old recovered packets
       // are now useless, so it's safe to do a reset.
       ResetState(recovered_packets);
@@ -47,6 +47,10 @@ constexpr uint8_t kHighProtectionThreshold = 80;
 // |kMinMediaPackets| + 1 packets are sent to the FEC code.
 constexpr float kMinMediaPacketsAdaptationThreshold = 2.0f;
 
+// The number of lost packets needed before the loss pattern is trusted to
+// select the packet mask type.
+constexpr int kMinLostPacketsForMaskSelection = 20;
+
 RedPacket::RedPacket(size_t length)
     : data_(new uint8_t[length]),
       length_(length),
@@ -93,7 +97,10 @@ size_t RedPacket::length() const {
 }
 
 ProducerFec::ProducerFec()
-    : fec_(ForwardErrorCorrection::CreateUlpfec()),
+    : ProducerFec(ForwardErrorCorrection::CreateUlpfec()) {}
+
+ProducerFec::ProducerFec(std::unique_ptr<ForwardErrorCorrection> fec)
+    : fec_(std::move(fec)),
       num_protected_frames_(0),
       num_important_packets_(0),
       min_num_media_packets_(1) {
@@ -119,6 +126,18 @@ std::unique_ptr<RedPacket> ProducerFec::BuildRedPacket(
   return red_packet;
 }
 
+FecMaskType ProducerFec::SelectMaskType(int single_loss_count,
+                                        int multiple_loss_packet_count) {
+  RTC_DCHECK_GE(single_loss_count, 0);
+  RTC_DCHECK_GE(multiple_loss_packet_count, 0);
+  if (single_loss_count + multiple_loss_packet_count <
+      kMinLostPacketsForMaskSelection) {
+    return kFecMaskRandom;
+  }
+  return multiple_loss_packet_count > single_loss_count ? kFecMaskBursty
+                                                        : kFecMaskRandom;
+}
+
 void ProducerFec::SetFecParameters(const FecProtectionParams* params,
                                    int num_important_packets) {
   // Number of important packets (i.e. number of packets receiving additional
@@ -247,6 +266,14 @@ std::vector<std::unique_ptr<RedPacket>> ProducerFec::GetFecPacketsAsRed(
   return red_packets;
 }
 
+std::list<ForwardErrorCorrection::Packet*> ProducerFec::GetFecPackets() {
+  std::list<ForwardErrorCorrection::Packet*> fec_packets;
+  fec_packets.swap(generated_fec_packets_);
+  DeleteMediaPackets();
+  num_protected_frames_ = 0;
+  return fec_packets;
+}
+
 int ProducerFec::Overhead() const {
   // Overhead is defined as relative to the number of media packets, and not
   // relative to total number of packets. This definition is inherited from the
@@ -41,7 +41,9 @@ class RedPacket {
 
 class ProducerFec {
  public:
+  // Uses ULPFEC.
   ProducerFec();
+  explicit ProducerFec(std::unique_ptr<ForwardErrorCorrection> fec);
   ~ProducerFec();
 
   static std::unique_ptr<RedPacket> BuildRedPacket(const uint8_t* data_buffer,
@@ -49,6 +51,13 @@ class ProducerFec {
                                                    size_t rtp_header_length,
                                                    int red_payload_type);
 
+  // Returns the packet mask type best suited to the losses seen so far, as
+  // counted by PacketLossStats. Bursty masks are chosen once most lost
+  // packets were lost together with their neighbours; random masks are
+  // kept while losses are mostly isolated or too few to tell.
+  static FecMaskType SelectMaskType(int single_loss_count,
+                                    int multiple_loss_packet_count);
+
   void SetFecParameters(const FecProtectionParams* params,
                         int num_first_partition);
 
@@ -86,6 +95,11 @@ class ProducerFec {
       uint16_t first_seq_num,
       size_t rtp_header_length);
 
+  // Returns generated FEC packets, without any RTP headers, and resets the
+  // state like GetFecPacketsAsRed(). The packets are owned by the FEC encoder
+  // and are valid until the next call to AddRtpPacketAndGenerateFec().
+  std::list<ForwardErrorCorrection::Packet*> GetFecPackets();
+
  private:
   void DeleteMediaPackets();
   int Overhead() const;
@@ -205,4 +205,16 @@ TEST_F(ProducerFecTest, BuildRedPacketWithEmptyPayload) {
                true);  // Marker bit set.
 }
 
+TEST(ProducerFecMaskTypeTest, RandomUntilEnoughLosses) {
+  EXPECT_EQ(kFecMaskRandom, ProducerFec::SelectMaskType(0, 0));
+  EXPECT_EQ(kFecMaskRandom, ProducerFec::SelectMaskType(1, 18));
+  EXPECT_EQ(kFecMaskBursty, ProducerFec::SelectMaskType(1, 19));
+}
+
+TEST(ProducerFecMaskTypeTest, BurstyWhenMostLossesAreConsecutive) {
+  EXPECT_EQ(kFecMaskRandom, ProducerFec::SelectMaskType(20, 20));
+  EXPECT_EQ(kFecMaskBursty, ProducerFec::SelectMaskType(20, 21));
+  EXPECT_EQ(kFecMaskRandom, ProducerFec::SelectMaskType(100, 0));
+}
+
 }  // namespace webrtc
@@ -50,10 +50,11 @@ class StreamStatisticianImpl : public StreamStatistician {
   bool InOrderPacketInternal(uint16_t sequence_number) const;
   RtcpStatistics CalculateRtcpStatistics();
   void UpdateJitter(const RTPHeader& header, NtpTime receive_time);
-  void UpdateCounters(const RTPHeader& rtp_header,
-                      size_t packet_length,
-                      bool retransmitted);
-  void NotifyRtpCallback() LOCKS_EXCLUDED(stream_lock_);
+  // Returns a snapshot of the updated counters, taken under the same lock.
+  StreamDataCounters UpdateCounters(const RTPHeader& rtp_header,
+                                    size_t packet_length,
+                                    bool retransmitted)
+      LOCKS_EXCLUDED(stream_lock_);
   void NotifyRtcpCallback() LOCKS_EXCLUDED(stream_lock_);
 
   Clock* const clock_;
@@ -48,7 +48,6 @@ using rtcp::ReportBlock;
 using RTCPHelp::RTCPPacketInformation;
 using RTCPHelp::RTCPReceiveInformation;
 using RTCPHelp::RTCPReportBlockInformation;
-using RTCPUtility::RTCPCnameInformation;
 using RTCPUtility::RTCPPacketReportBlockItem;
 using RTCPUtility::RTCPPacketTypes;
 
@@ -82,7 +81,6 @@ RTCPReceiver::RTCPReceiver(
       _lastReceivedXRNTPfrac(0),
       xr_rrtr_status_(false),
       xr_rr_rtt_ms_(0),
-      _receivedInfoMap(),
       _lastReceivedRrMs(0),
       _lastIncreasedSequenceNumberMs(0),
       stats_callback_(NULL),
@@ -92,29 +90,7 @@ RTCPReceiver::RTCPReceiver(
   memset(&_remoteSenderInfo, 0, sizeof(_remoteSenderInfo));
 }
 
-RTCPReceiver::~RTCPReceiver() {
-  ReportBlockMap::iterator it = _receivedReportBlockMap.begin();
-  for (; it != _receivedReportBlockMap.end(); ++it) {
-    ReportBlockInfoMap* info_map = &(it->second);
-    while (!info_map->empty()) {
-      ReportBlockInfoMap::iterator it_info = info_map->begin();
-      delete it_info->second;
-      info_map->erase(it_info);
-    }
-  }
-  while (!_receivedInfoMap.empty()) {
-    std::map<uint32_t, RTCPReceiveInformation*>::iterator first =
-        _receivedInfoMap.begin();
-    delete first->second;
-    _receivedInfoMap.erase(first);
-  }
-  while (!_receivedCnameMap.empty()) {
-    std::map<uint32_t, RTCPCnameInformation*>::iterator first =
-        _receivedCnameMap.begin();
-    delete first->second;
-    _receivedCnameMap.erase(first);
-  }
-}
+RTCPReceiver::~RTCPReceiver() {}
 
 bool RTCPReceiver::IncomingPacket(const uint8_t* packet, size_t packet_size) {
   if (packet_size == 0) {
@@ -132,10 +108,9 @@ bool RTCPReceiver::IncomingPacket(const uint8_t* packet, size_t packet_size) {
 int64_t RTCPReceiver::LastReceivedReceiverReport() const {
   rtc::CritScope lock(&_criticalSectionRTCPReceiver);
   int64_t last_received_rr = -1;
-  for (ReceivedInfoMap::const_iterator it = _receivedInfoMap.begin();
-       it != _receivedInfoMap.end(); ++it) {
-    if (it->second->last_time_received_ms > last_received_rr) {
-      last_received_rr = it->second->last_time_received_ms;
+  for (const auto& kv : _receivedInfoMap) {
+    if (kv.second.last_time_received_ms > last_received_rr) {
+      last_received_rr = kv.second.last_time_received_ms;
     }
   }
   return last_received_rr;
@@ -180,7 +155,7 @@ int32_t RTCPReceiver::RTT(uint32_t remoteSSRC,
                           int64_t* maxRTT) const {
   rtc::CritScope lock(&_criticalSectionRTCPReceiver);
 
-  RTCPReportBlockInformation* reportBlock =
+  const RTCPReportBlockInformation* reportBlock =
       GetReportBlockInformation(remoteSSRC, main_ssrc_);
 
   if (reportBlock == NULL) {
@@ -285,13 +260,9 @@ int32_t RTCPReceiver::StatisticsReceived(
     std::vector<RTCPReportBlock>* receiveBlocks) const {
   assert(receiveBlocks);
   rtc::CritScope lock(&_criticalSectionRTCPReceiver);
-  ReportBlockMap::const_iterator it = _receivedReportBlockMap.begin();
-  for (; it != _receivedReportBlockMap.end(); ++it) {
-    const ReportBlockInfoMap* info_map = &(it->second);
-    ReportBlockInfoMap::const_iterator it_info = info_map->begin();
-    for (; it_info != info_map->end(); ++it_info) {
-      receiveBlocks->push_back(it_info->second->remoteReceiveBlock);
-    }
+  for (const auto& source_kv : _receivedReportBlockMap) {
+    for (const auto& remote_kv : source_kv.second)
+      receiveBlocks->push_back(remote_kv.second.remoteReceiveBlock);
   }
   return 0;
 }
@@ -449,7 +420,7 @@ void RTCPReceiver::HandleSenderReport(
   // Update that this remote is alive.
   ptrReceiveInfo->last_time_received_ms = _clock->TimeInMilliseconds();
 
-  for (const rtcp::ReportBlock report_block : sender_report.report_blocks())
+  for (const rtcp::ReportBlock& report_block : sender_report.report_blocks())
     HandleReportBlock(report_block, rtcpPacketInformation, remoteSSRC);
 }
 
@@ -501,11 +472,6 @@ void RTCPReceiver::HandleReportBlock(
 
   RTCPReportBlockInformation* reportBlock =
       CreateOrGetReportBlockInformation(remoteSSRC, report_block.source_ssrc());
-  if (reportBlock == NULL) {
-    LOG(LS_WARNING) << "Failed to CreateReportBlockInformation(" << remoteSSRC
-                    << ")";
-    return;
-  }
 
   _lastReceivedRrMs = _clock->TimeInMilliseconds();
   reportBlock->remoteReceiveBlock.remoteSSRC = remoteSSRC;
@@ -580,84 +546,38 @@ void RTCPReceiver::HandleReportBlock(
 RTCPReportBlockInformation* RTCPReceiver::CreateOrGetReportBlockInformation(
     uint32_t remote_ssrc,
     uint32_t source_ssrc) {
-  RTCPReportBlockInformation* info =
-      GetReportBlockInformation(remote_ssrc, source_ssrc);
-  if (info == NULL) {
-    info = new RTCPReportBlockInformation;
-    _receivedReportBlockMap[source_ssrc][remote_ssrc] = info;
-  }
-  return info;
+  // Values are stored in the nodes of the maps, so the returned pointer stays
+  // valid until the entry is erased.
+  return &_receivedReportBlockMap[source_ssrc][remote_ssrc];
 }
 
-RTCPReportBlockInformation* RTCPReceiver::GetReportBlockInformation(
+const RTCPReportBlockInformation* RTCPReceiver::GetReportBlockInformation(
     uint32_t remote_ssrc,
     uint32_t source_ssrc) const {
   ReportBlockMap::const_iterator it = _receivedReportBlockMap.find(source_ssrc);
   if (it == _receivedReportBlockMap.end()) {
     return NULL;
   }
-  const ReportBlockInfoMap* info_map = &(it->second);
-  ReportBlockInfoMap::const_iterator it_info = info_map->find(remote_ssrc);
-  if (it_info == info_map->end()) {
+  const ReportBlockInfoMap& info_map = it->second;
+  ReportBlockInfoMap::const_iterator it_info = info_map.find(remote_ssrc);
+  if (it_info == info_map.end()) {
     return NULL;
   }
-  return it_info->second;
-}
-
-RTCPCnameInformation* RTCPReceiver::CreateCnameInformation(
-    uint32_t remoteSSRC) {
-  rtc::CritScope lock(&_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPCnameInformation*>::iterator it =
-      _receivedCnameMap.find(remoteSSRC);
-
-  if (it != _receivedCnameMap.end()) {
-    return it->second;
-  }
-  RTCPCnameInformation* cnameInfo = new RTCPCnameInformation;
-  memset(cnameInfo->name, 0, RTCP_CNAME_SIZE);
-  _receivedCnameMap[remoteSSRC] = cnameInfo;
-  return cnameInfo;
-}
-
-RTCPCnameInformation* RTCPReceiver::GetCnameInformation(
-    uint32_t remoteSSRC) const {
-  rtc::CritScope lock(&_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPCnameInformation*>::const_iterator it =
-      _receivedCnameMap.find(remoteSSRC);
-
-  if (it == _receivedCnameMap.end()) {
-    return NULL;
-  }
-  return it->second;
+  return &it_info->second;
 }
 
 RTCPReceiveInformation* RTCPReceiver::CreateReceiveInformation(
     uint32_t remoteSSRC) {
-  rtc::CritScope lock(&_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator it =
-      _receivedInfoMap.find(remoteSSRC);
-
-  if (it != _receivedInfoMap.end()) {
-    return it->second;
-  }
-  RTCPReceiveInformation* receiveInfo = new RTCPReceiveInformation;
-  _receivedInfoMap[remoteSSRC] = receiveInfo;
-  return receiveInfo;
+  return &_receivedInfoMap[remoteSSRC];
 }
 
 RTCPReceiveInformation* RTCPReceiver::GetReceiveInformation(
     uint32_t remoteSSRC) {
-  rtc::CritScope lock(&_criticalSectionRTCPReceiver);
-
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator it =
-      _receivedInfoMap.find(remoteSSRC);
+  ReceivedInfoMap::iterator it = _receivedInfoMap.find(remoteSSRC);
   if (it == _receivedInfoMap.end()) {
     return NULL;
   }
-  return it->second;
+  return &it->second;
 }
 
 bool RTCPReceiver::RtcpRrTimeout(int64_t rtcp_interval_ms) {
@@ -695,14 +615,10 @@ bool RTCPReceiver::UpdateRTCPReceiveInformationTimers() {
   bool updateBoundingSet = false;
   int64_t timeNow = _clock->TimeInMilliseconds();
 
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator receiveInfoIt =
-      _receivedInfoMap.begin();
+  ReceivedInfoMap::iterator receiveInfoIt = _receivedInfoMap.begin();
 
   while (receiveInfoIt != _receivedInfoMap.end()) {
-    RTCPReceiveInformation* receiveInfo = receiveInfoIt->second;
-    if (receiveInfo == NULL) {
-      return updateBoundingSet;
-    }
+    RTCPReceiveInformation* receiveInfo = &receiveInfoIt->second;
     // time since last received rtcp packet
     // when we dont have a lastTimeReceived and the object is marked
     // readyForDelete it's removed from the map
@@ -720,12 +636,7 @@ bool RTCPReceiver::UpdateRTCPReceiveInformationTimers() {
       }
       receiveInfoIt++;
     } else if (receiveInfo->ready_for_delete) {
-      // store our current receiveInfoItem
-      std::map<uint32_t, RTCPReceiveInformation*>::iterator
-          receiveInfoItemToBeErased = receiveInfoIt;
-      receiveInfoIt++;
-      delete receiveInfoItemToBeErased->second;
-      _receivedInfoMap.erase(receiveInfoItemToBeErased);
+      receiveInfoIt = _receivedInfoMap.erase(receiveInfoIt);
     } else {
       receiveInfoIt++;
     }
@@ -736,14 +647,10 @@ bool RTCPReceiver::UpdateRTCPReceiveInformationTimers() {
 std::vector<rtcp::TmmbItem> RTCPReceiver::BoundingSet(bool* tmmbr_owner) {
   rtc::CritScope lock(&_criticalSectionRTCPReceiver);
 
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator receiveInfoIt =
-      _receivedInfoMap.find(_remoteSSRC);
-
-  if (receiveInfoIt == _receivedInfoMap.end()) {
+  RTCPReceiveInformation* receiveInfo = GetReceiveInformation(_remoteSSRC);
+  if (!receiveInfo) {
     return std::vector<rtcp::TmmbItem>();
   }
-  RTCPReceiveInformation* receiveInfo = receiveInfoIt->second;
-  RTC_DCHECK(receiveInfo);
 
   *tmmbr_owner = TMMBRHelp::IsOwner(receiveInfo->tmmbn, main_ssrc_);
   return receiveInfo->tmmbn;
@@ -757,17 +664,11 @@ void RTCPReceiver::HandleSDES(const CommonHeader& rtcp_block,
     return;
   }
 
+  rtc::CritScope lock(&_criticalSectionFeedbacks);
   for (const rtcp::Sdes::Chunk& chunk : sdes.chunks()) {
-    RTCPCnameInformation* cnameInfo = CreateCnameInformation(chunk.ssrc);
-    RTC_DCHECK(cnameInfo);
-
-    cnameInfo->name[RTCP_CNAME_SIZE - 1] = 0;
-    strncpy(cnameInfo->name, chunk.cname.c_str(), RTCP_CNAME_SIZE - 1);
-    {
-      rtc::CritScope lock(&_criticalSectionFeedbacks);
-      if (stats_callback_)
-        stats_callback_->CNameChanged(chunk.cname.c_str(), chunk.ssrc);
-    }
+    _receivedCnameMap[chunk.ssrc] = chunk.cname;
+    if (stats_callback_)
+      stats_callback_->CNameChanged(chunk.cname.c_str(), chunk.ssrc);
   }
   rtcpPacketInformation.rtcpPacketTypeFlags |= kRtcpSdes;
 }
@@ -803,30 +704,16 @@ void RTCPReceiver::HandleBYE(const CommonHeader& rtcp_block) {
   }
 
   // clear our lists
-  ReportBlockMap::iterator it = _receivedReportBlockMap.begin();
-  for (; it != _receivedReportBlockMap.end(); ++it) {
-    ReportBlockInfoMap* info_map = &(it->second);
-    ReportBlockInfoMap::iterator it_info = info_map->find(bye.sender_ssrc());
-    if (it_info != info_map->end()) {
-      delete it_info->second;
-      info_map->erase(it_info);
-    }
-  }
+  for (auto& kv : _receivedReportBlockMap)
+    kv.second.erase(bye.sender_ssrc());
 
   //  we can't delete it due to TMMBR
-  std::map<uint32_t, RTCPReceiveInformation*>::iterator receiveInfoIt =
-      _receivedInfoMap.find(bye.sender_ssrc());
-
-  if (receiveInfoIt != _receivedInfoMap.end())
-    receiveInfoIt->second->ready_for_delete = true;
+  RTCPReceiveInformation* receiveInfo =
+      GetReceiveInformation(bye.sender_ssrc());
+  if (receiveInfo)
+    receiveInfo->ready_for_delete = true;
 
-  std::map<uint32_t, RTCPCnameInformation*>::iterator cnameInfoIt =
-      _receivedCnameMap.find(bye.sender_ssrc());
-
-  if (cnameInfoIt != _receivedCnameMap.end()) {
-    delete cnameInfoIt->second;
-    _receivedCnameMap.erase(cnameInfoIt);
-  }
+  _receivedCnameMap.erase(bye.sender_ssrc());
   xr_rr_rtt_ms_ = 0;
 }
 
@@ -1199,26 +1086,23 @@ int32_t RTCPReceiver::CNAME(uint32_t remoteSSRC,
   assert(cName);
 
   rtc::CritScope lock(&_criticalSectionRTCPReceiver);
-  RTCPCnameInformation* cnameInfo = GetCnameInformation(remoteSSRC);
-  if (cnameInfo == NULL) {
+  auto it = _receivedCnameMap.find(remoteSSRC);
+  if (it == _receivedCnameMap.end()) {
     return -1;
   }
   cName[RTCP_CNAME_SIZE - 1] = 0;
-  strncpy(cName, cnameInfo->name, RTCP_CNAME_SIZE - 1);
+  strncpy(cName, it->second.c_str(), RTCP_CNAME_SIZE - 1);
   return 0;
 }
 
-std::vector<rtcp::TmmbItem> RTCPReceiver::TmmbrReceived() const {
+std::vector<rtcp::TmmbItem> RTCPReceiver::TmmbrReceived() {
   rtc::CritScope lock(&_criticalSectionRTCPReceiver);
   std::vector<rtcp::TmmbItem> candidates;
 
   int64_t now_ms = _clock->TimeInMilliseconds();
 
-  for (const auto& kv : _receivedInfoMap) {
-    RTCPReceiveInformation* receive_info = kv.second;
-    RTC_DCHECK(receive_info);
-    receive_info->GetTmmbrSet(now_ms, &candidates);
-  }
+  for (auto& kv : _receivedInfoMap)
+    kv.second.GetTmmbrSet(now_ms, &candidates);
   return candidates;
 }
 
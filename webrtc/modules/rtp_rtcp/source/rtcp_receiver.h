@@ -13,6 +13,8 @@
 
 #include <map>
 #include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/base/criticalsection.h"
@@ -100,7 +102,7 @@ class RTCPReceiver {
   // returns true once until a new RR is received.
   bool RtcpRrSequenceNumberTimeout(int64_t rtcp_interval_ms);
 
-  std::vector<rtcp::TmmbItem> TmmbrReceived() const;
+  std::vector<rtcp::TmmbItem> TmmbrReceived();
 
   bool UpdateRTCPReceiveInformationTimers();
 
@@ -112,12 +114,15 @@ class RTCPReceiver {
   RtcpStatisticsCallback* GetRtcpStatisticsCallback();
 
  private:
-  using ReceivedInfoMap = std::map<uint32_t, RTCPHelp::RTCPReceiveInformation*>;
+  // Kept ordered by SSRC, which is the order TMMBR candidates are collected in.
+  using ReceivedInfoMap = std::map<uint32_t, RTCPHelp::RTCPReceiveInformation>;
+  // Report blocks are looked up for every block of every incoming compound
+  // packet, with no need for order, so they are stored by value in hash maps.
   // RTCP report block information mapped by remote SSRC.
   using ReportBlockInfoMap =
-      std::map<uint32_t, RTCPHelp::RTCPReportBlockInformation*>;
+      std::unordered_map<uint32_t, RTCPHelp::RTCPReportBlockInformation>;
   // RTCP report block information map mapped by source SSRC.
-  using ReportBlockMap = std::map<uint32_t, ReportBlockInfoMap>;
+  using ReportBlockMap = std::unordered_map<uint32_t, ReportBlockInfoMap>;
 
   bool ParseCompoundPacket(const uint8_t* packet_begin,
                            const uint8_t* packet_end,
@@ -126,14 +131,11 @@ class RTCPReceiver {
   void TriggerCallbacksFromRTCPPacket(
       RTCPHelp::RTCPPacketInformation& rtcpPacketInformation);
 
-  RTCPUtility::RTCPCnameInformation* CreateCnameInformation(
-      uint32_t remoteSSRC);
-  RTCPUtility::RTCPCnameInformation* GetCnameInformation(
-      uint32_t remoteSSRC) const;
-
   RTCPHelp::RTCPReceiveInformation* CreateReceiveInformation(
-      uint32_t remoteSSRC);
-  RTCPHelp::RTCPReceiveInformation* GetReceiveInformation(uint32_t remoteSSRC);
+      uint32_t remoteSSRC)
+      EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
+  RTCPHelp::RTCPReceiveInformation* GetReceiveInformation(uint32_t remoteSSRC)
+      EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
 
   void HandleSenderReport(
       const rtcp::CommonHeader& rtcp_block,
@@ -216,7 +218,7 @@ class RTCPReceiver {
       uint32_t remote_ssrc,
       uint32_t source_ssrc)
       EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
-  RTCPHelp::RTCPReportBlockInformation* GetReportBlockInformation(
+  const RTCPHelp::RTCPReportBlockInformation* GetReportBlockInformation(
       uint32_t remote_ssrc,
       uint32_t source_ssrc) const
       EXCLUSIVE_LOCKS_REQUIRED(_criticalSectionRTCPReceiver);
@@ -253,8 +255,10 @@ class RTCPReceiver {
   // Received report blocks.
   ReportBlockMap _receivedReportBlockMap
       GUARDED_BY(_criticalSectionRTCPReceiver);
-  ReceivedInfoMap _receivedInfoMap;
-  std::map<uint32_t, RTCPUtility::RTCPCnameInformation*> _receivedCnameMap;
+  ReceivedInfoMap _receivedInfoMap GUARDED_BY(_criticalSectionRTCPReceiver);
+  // Received CNAMEs mapped by remote SSRC.
+  std::unordered_map<uint32_t, std::string> _receivedCnameMap
+      GUARDED_BY(_criticalSectionRTCPReceiver);
 
   // The last time we received an RTCP RR.
   int64_t _lastReceivedRrMs;
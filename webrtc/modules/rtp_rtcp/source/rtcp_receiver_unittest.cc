@@ -9,11 +9,15 @@
  */
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/array_view.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
@@ -1267,4 +1271,56 @@ TEST_F(RtcpReceiverTest, ForceSenderReport) {
   InjectRtcpPacket(rr);
 }
 
+// Measures the cost of parsing compound RTCP packets as an SFU would receive
+// them: a receiver report with blocks for both local SSRCs followed by a
+// SDES, from each of 100 remote SSRCs in turn.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(RtcpReceiverTest, DISABLED_CompoundPacketParseThroughput) {
+  constexpr int kNumRemoteSsrcs = 100;
+  // 10k packets per second over one second.
+  constexpr int kNumPackets = 10000;
+
+  std::vector<rtc::Buffer> packets;
+  for (int i = 0; i < kNumRemoteSsrcs; ++i) {
+    const uint32_t remote_ssrc = kSenderSsrc + i;
+    rtcp::ReportBlock rb1;
+    rb1.To(kReceiverMainSsrc);
+    rb1.WithExtHighestSeqNum(i);
+    rtcp::ReportBlock rb2;
+    rb2.To(kReceiverExtraSsrc);
+    rb2.WithExtHighestSeqNum(i);
+    rtcp::ReceiverReport rr;
+    rr.From(remote_ssrc);
+    rr.WithReportBlock(rb1);
+    rr.WithReportBlock(rb2);
+    rtcp::Sdes sdes;
+    sdes.WithCName(remote_ssrc, "remote-" + std::to_string(i));
+    rtcp::CompoundPacket compound;
+    compound.Append(&rr);
+    compound.Append(&sdes);
+    packets.push_back(compound.Build());
+  }
+
+  EXPECT_CALL(rtp_rtcp_impl_, OnReceivedRtcpReportBlocks(SizeIs(2)))
+      .Times(kNumPackets);
+  EXPECT_CALL(bandwidth_observer_,
+              OnReceivedRtcpReceiverReport(SizeIs(2), _, _))
+      .Times(kNumPackets);
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumPackets; ++i) {
+    const rtc::Buffer& packet = packets[i % kNumRemoteSsrcs];
+    EXPECT_TRUE(rtcp_receiver_.IncomingPacket(packet.data(), packet.size()));
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+  std::vector<RTCPReportBlock> report_blocks;
+  rtcp_receiver_.StatisticsReceived(&report_blocks);
+  EXPECT_EQ(2u * kNumRemoteSsrcs, report_blocks.size());
+
+  LOG(LS_INFO) << kNumPackets << " compound packets from " << kNumRemoteSsrcs
+               << " remote SSRCs parsed in " << elapsed_ns / 1000000
+               << " ms, " << elapsed_ns / kNumPackets << " ns per packet";
+}
+
 }  // namespace webrtc
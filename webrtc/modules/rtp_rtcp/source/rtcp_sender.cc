@@ -118,6 +118,53 @@ class PacketContainer : public rtcp::CompoundPacket,
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(PacketContainer);
 };
 
+namespace {
+// Compound packet owning the packets appended to it, so that a single builder
+// can produce several RTCP packets.
+class OwningCompoundPacket : public rtcp::CompoundPacket {
+ public:
+  OwningCompoundPacket() {}
+  ~OwningCompoundPacket() override {
+    for (RtcpPacket* packet : appended_packets_)
+      delete packet;
+  }
+
+ private:
+  RTC_DISALLOW_COPY_AND_ASSIGN(OwningCompoundPacket);
+};
+
+// Adds |report_blocks| to |report|. A report can carry at most 31 blocks;
+// the rest go in additional receiver reports directly following it, as
+// described in RFC 3550, section 6.4.2. This lets one compound packet report
+// on all the streams sharing the receive statistics.
+template <typename Report>
+std::unique_ptr<rtcp::RtcpPacket> AddReportBlocks(
+    std::unique_ptr<Report> report,
+    uint32_t sender_ssrc,
+    const std::map<uint32_t, rtcp::ReportBlock>& report_blocks) {
+  auto it = report_blocks.begin();
+  for (size_t i = 0; it != report_blocks.end() && i < RTCP_MAX_REPORT_BLOCKS;
+       ++it, ++i) {
+    report->WithReportBlock(it->second);
+  }
+  if (it == report_blocks.end())
+    return std::move(report);
+
+  std::unique_ptr<OwningCompoundPacket> reports(new OwningCompoundPacket());
+  reports->Append(report.release());
+  while (it != report_blocks.end()) {
+    rtcp::ReceiverReport* receiver_report = new rtcp::ReceiverReport();
+    receiver_report->From(sender_ssrc);
+    for (size_t i = 0; it != report_blocks.end() && i < RTCP_MAX_REPORT_BLOCKS;
+         ++it, ++i) {
+      receiver_report->WithReportBlock(it->second);
+    }
+    reports->Append(receiver_report);
+  }
+  return std::move(reports);
+}
+}  // namespace
+
 class RTCPSender::RtcpContext {
  public:
   RtcpContext(const FeedbackState& feedback_state,
@@ -448,19 +495,18 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSR(const RtcpContext& ctx) {
       (clock_->TimeInMilliseconds() - last_frame_capture_time_ms_) *
           (ctx.feedback_state_.frequency_hz / 1000);
 
-  rtcp::SenderReport* report = new rtcp::SenderReport();
+  std::unique_ptr<rtcp::SenderReport> report(new rtcp::SenderReport());
   report->From(ssrc_);
   report->WithNtp(NtpTime(ctx.ntp_sec_, ctx.ntp_frac_));
   report->WithRtpTimestamp(rtp_timestamp);
   report->WithPacketCount(ctx.feedback_state_.packets_sent);
   report->WithOctetCount(ctx.feedback_state_.media_bytes_sent);
 
-  for (auto it : report_blocks_)
-    report->WithReportBlock(it.second);
-
+  std::unique_ptr<rtcp::RtcpPacket> packet =
+      AddReportBlocks(std::move(report), ssrc_, report_blocks_);
   report_blocks_.clear();
 
-  return std::unique_ptr<rtcp::RtcpPacket>(report);
+  return packet;
 }
 
 std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSDES(
@@ -478,13 +524,12 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSDES(
 }
 
 std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildRR(const RtcpContext& ctx) {
-  rtcp::ReceiverReport* report = new rtcp::ReceiverReport();
+  std::unique_ptr<rtcp::ReceiverReport> report(new rtcp::ReceiverReport());
   report->From(ssrc_);
-  for (auto it : report_blocks_)
-    report->WithReportBlock(it.second);
-
+  std::unique_ptr<rtcp::RtcpPacket> packet =
+      AddReportBlocks(std::move(report), ssrc_, report_blocks_);
   report_blocks_.clear();
-  return std::unique_ptr<rtcp::RtcpPacket>(report);
+  return packet;
 }
 
 std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildPLI(const RtcpContext& ctx) {
@@ -899,10 +944,6 @@ bool RTCPSender::AddReportBlock(const FeedbackState& feedback_state,
   if (!statistician->GetStatistics(&stats, true))
     return false;
 
-  if (report_blocks_.size() >= RTCP_MAX_REPORT_BLOCKS) {
-    LOG(LS_WARNING) << "Too many report blocks.";
-    return false;
-  }
   RTC_DCHECK(report_blocks_.find(ssrc) == report_blocks_.end());
   rtcp::ReportBlock* block = &report_blocks_[ssrc];
   block->To(ssrc);
@@ -381,6 +381,36 @@ TEST_F(RtcpSenderTest, SendRrWithTwoReportBlocks) {
             parser()->receiver_report()->report_blocks()[1].source_ssrc());
 }
 
+TEST_F(RtcpSenderTest, SendRrWithMoreThan31ReportBlocks) {
+  const uint32_t kNumRemoteSsrcs = 40;
+  for (uint32_t i = 0; i < kNumRemoteSsrcs; ++i)
+    InsertIncomingPacket(kRemoteSsrc + i, 11111);
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpRr));
+  // The blocks that don't fit in the first receiver report follow it in a
+  // second one, in the same compound packet.
+  EXPECT_EQ(2, parser()->receiver_report()->num_packets());
+  EXPECT_EQ(kSenderSsrc, parser()->receiver_report()->sender_ssrc());
+  ASSERT_EQ(9U, parser()->receiver_report()->report_blocks().size());
+  EXPECT_EQ(kRemoteSsrc + 31,
+            parser()->receiver_report()->report_blocks()[0].source_ssrc());
+}
+
+TEST_F(RtcpSenderTest, SendSrWithMoreThan31ReportBlocks) {
+  const uint32_t kNumRemoteSsrcs = 40;
+  for (uint32_t i = 0; i < kNumRemoteSsrcs; ++i)
+    InsertIncomingPacket(kRemoteSsrc + i, 11111);
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
+  RTCPSender::FeedbackState feedback_state = rtp_rtcp_impl_->GetFeedbackState();
+  rtcp_sender_->SetSendingStatus(feedback_state, true);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state, kRtcpSr));
+  EXPECT_EQ(1, parser()->sender_report()->num_packets());
+  EXPECT_EQ(31U, parser()->sender_report()->report_blocks().size());
+  EXPECT_EQ(1, parser()->receiver_report()->num_packets());
+  EXPECT_EQ(kSenderSsrc, parser()->receiver_report()->sender_ssrc());
+  EXPECT_EQ(9U, parser()->receiver_report()->report_blocks().size());
+}
+
 TEST_F(RtcpSenderTest, SendSdes) {
   rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
   EXPECT_EQ(0, rtcp_sender_->SetCNAME("alice@host"));
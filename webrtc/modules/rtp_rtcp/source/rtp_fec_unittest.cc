@@ -14,9 +14,12 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/basictypes.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/fec_test_helper.h"
+#include "webrtc/modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
 #include "webrtc/modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
 
@@ -56,6 +59,14 @@ class UlpfecForwardErrorCorrection : public ForwardErrorCorrection {
             std::unique_ptr<FecHeaderWriter>(new UlpfecHeaderWriter())) {}
 };
 
+class FlexfecForwardErrorCorrection : public ForwardErrorCorrection {
+ public:
+  FlexfecForwardErrorCorrection()
+      : ForwardErrorCorrection(
+            std::unique_ptr<FecHeaderReader>(new FlexfecHeaderReader()),
+            std::unique_ptr<FecHeaderWriter>(new FlexfecHeaderWriter())) {}
+};
+
 template <typename ForwardErrorCorrectionType>
 class RtpFecTest : public ::testing::Test {
  protected:
@@ -104,7 +115,8 @@ class RtpFecTest : public ::testing::Test {
 // Since the tests now are parameterized, we need to access
 // member variables using |this|, thereby enforcing runtime
 // resolution.
-using FecTypes = Types<UlpfecForwardErrorCorrection>;
+using FecTypes =
+    Types<UlpfecForwardErrorCorrection, FlexfecForwardErrorCorrection>;
 TYPED_TEST_CASE(RtpFecTest, FecTypes);
 
 TYPED_TEST(RtpFecTest, FecRecoveryNoLoss) {
@@ -870,6 +882,49 @@ TYPED_TEST(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(this->IsRecoveryComplete());
 }
 
+// Measures the cost of protecting a frame of 48 media packets with 30% FEC,
+// and of recovering one of them.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TYPED_TEST(RtpFecTest, DISABLED_EncodeDecodeThroughput) {
+  constexpr int kNumImportantPackets = 0;
+  constexpr bool kUseUnequalProtection = false;
+  constexpr int kNumMediaPackets = 48;
+  constexpr uint8_t kProtectionFactor = 77;
+  constexpr int kRuns = 1000;
+
+  this->media_packets_ =
+      this->media_packet_generator_.ConstructMediaPackets(kNumMediaPackets);
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kRuns; ++i) {
+    this->generated_fec_packets_.clear();
+    ASSERT_EQ(
+        0, this->fec_.EncodeFec(this->media_packets_, kProtectionFactor,
+                                kNumImportantPackets, kUseUnequalProtection,
+                                kFecMaskBursty, &this->generated_fec_packets_));
+  }
+  int64_t encode_ns = rtc::TimeNanos() - start_ns;
+
+  memset(this->media_loss_mask_, 0, sizeof(this->media_loss_mask_));
+  memset(this->fec_loss_mask_, 0, sizeof(this->fec_loss_mask_));
+  this->media_loss_mask_[0] = 1;
+  int64_t decode_ns = 0;
+  for (int i = 0; i < kRuns; ++i) {
+    this->fec_.ResetState(&this->recovered_packets_);
+    this->NetworkReceivedPackets(this->media_loss_mask_, this->fec_loss_mask_);
+    start_ns = rtc::TimeNanos();
+    ASSERT_EQ(0, this->fec_.DecodeFec(&this->received_packets_,
+                                      &this->recovered_packets_));
+    decode_ns += rtc::TimeNanos() - start_ns;
+  }
+  EXPECT_TRUE(this->IsRecoveryComplete());
+
+  LOG(LS_INFO) << kNumMediaPackets << " media packets, "
+               << this->generated_fec_packets_.size()
+               << " FEC packets: encoded in " << encode_ns / kRuns / 1000
+               << " us, decoded in " << decode_ns / kRuns / 1000 << " us";
+}
+
 template <typename ForwardErrorCorrectionType>
 bool RtpFecTest<ForwardErrorCorrectionType>::IsRecoveryComplete() {
   // We must have equally many recovered packets as original packets.
@@ -239,7 +239,7 @@ bool RtpPacketizerH264::NextPacket(uint8_t* buffer,
     return false;
   }
 
-  PacketUnit packet = packets_.front();
+  const PacketUnit& packet = packets_.front();
 
   if (packet.first_fragment && packet.last_fragment) {
     // Single NAL unit packet.
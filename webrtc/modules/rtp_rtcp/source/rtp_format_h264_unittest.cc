@@ -13,6 +13,8 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/rtp_rtcp/mocks/mock_rtp_rtcp.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
@@ -381,6 +383,91 @@ TEST(RtpPacketizerH264Test, TestFUABig) {
                               sizeof(kExpectedPayloadSizes) / sizeof(size_t)));
 }
 
+TEST(RtpPacketizerH264Test, TestStapAOfSlices) {
+  // Small slices and SEI are aggregated like parameter sets, as many per
+  // STAP-A as fit: (1200 - 1) / (2 + 100) = 11 NAL units.
+  const size_t kNumNalus = 20;
+  const size_t kNaluSize = 100;
+  const size_t kFrameSize = kNumNalus * kNaluSize;
+  uint8_t frame[kFrameSize];
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(kNumNalus);
+  for (size_t i = 0; i < kNumNalus; ++i) {
+    fragmentation.fragmentationOffset[i] = i * kNaluSize;
+    fragmentation.fragmentationLength[i] = kNaluSize;
+    frame[i * kNaluSize] = i == 0 ? kSei : kSlice;
+    for (size_t j = 1; j < kNaluSize; ++j)
+      frame[i * kNaluSize + j] = i + j;
+  }
+  std::unique_ptr<RtpPacketizer> packetizer(
+      RtpPacketizer::Create(kRtpVideoH264, kMaxPayloadSize, NULL, kEmptyFrame));
+  packetizer->SetPayloadData(frame, kFrameSize, &fragmentation);
+
+  uint8_t packet[kMaxPayloadSize] = {0};
+  size_t length = 0;
+  bool last = false;
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_EQ(kStapA, packet[0] & kTypeMask);
+  EXPECT_EQ(kNalHeaderSize + 11 * (kLengthFieldLength + kNaluSize), length);
+  EXPECT_FALSE(last);
+  for (size_t i = 0; i < 11; ++i)
+    VerifyStapAPayload(fragmentation, 0, i, frame, kFrameSize, packet, length);
+
+  ASSERT_TRUE(packetizer->NextPacket(packet, &length, &last));
+  EXPECT_EQ(kStapA, packet[0] & kTypeMask);
+  EXPECT_EQ(kNalHeaderSize + 9 * (kLengthFieldLength + kNaluSize), length);
+  EXPECT_TRUE(last);
+  for (size_t i = 11; i < kNumNalus; ++i)
+    VerifyStapAPayload(fragmentation, 11, i, frame, kFrameSize, packet, length);
+
+  EXPECT_FALSE(packetizer->NextPacket(packet, &length, &last));
+}
+
+// Packetizes frames shaped like 4K key frames: an SEI, eight large IDR slices
+// and a tail of small slices.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(RtpPacketizerH264Test, DISABLED_PacketizationThroughput) {
+  const size_t kNumFrames = 1000;
+  const size_t kNumLargeNalus = 8;
+  const size_t kLargeNaluSize = 64000;
+  const size_t kNumSmallNalus = 64;
+  const size_t kSmallNaluSize = 120;
+  const size_t kNumNalus = 1 + kNumLargeNalus + kNumSmallNalus;
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(kNumNalus);
+  std::vector<uint8_t> frame;
+  for (size_t i = 0; i < kNumNalus; ++i) {
+    size_t nalu_size = kSmallNaluSize;
+    uint8_t nalu_type = kSlice;
+    if (i == 0) {
+      nalu_type = kSei;
+    } else if (i <= kNumLargeNalus) {
+      nalu_size = kLargeNaluSize;
+      nalu_type = kIdr;
+    }
+    fragmentation.fragmentationOffset[i] = frame.size();
+    fragmentation.fragmentationLength[i] = nalu_size;
+    frame.push_back(nalu_type);
+    frame.resize(frame.size() + nalu_size - kNalHeaderSize, 0xAB);
+  }
+
+  uint8_t packet[kMaxPayloadSize];
+  size_t length = 0;
+  bool last = false;
+  size_t num_packets = 0;
+  int64_t start_ns = rtc::TimeNanos();
+  for (size_t i = 0; i < kNumFrames; ++i) {
+    std::unique_ptr<RtpPacketizer> packetizer(RtpPacketizer::Create(
+        kRtpVideoH264, kMaxPayloadSize, NULL, kVideoFrameKey));
+    packetizer->SetPayloadData(frame.data(), frame.size(), &fragmentation);
+    while (packetizer->NextPacket(packet, &length, &last))
+      ++num_packets;
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  LOG(LS_INFO) << "Packetized " << kNumFrames << " frames into " << num_packets
+               << " packets: " << elapsed_ns / num_packets << " ns/packet.";
+}
+
 namespace {
 const uint8_t kStartSequence[] = {0x00, 0x00, 0x00, 0x01};
 const uint8_t kOriginalSps[] = {kSps, 0x00, 0x00, 0x03, 0x03,
@@ -740,4 +740,64 @@ bool RtpDepacketizerVp9::Parse(ParsedPayload* parsed_payload,
 
   return true;
 }
+
+bool Vp9PayloadDescriptorView::Parse(const uint8_t* payload,
+                                     size_t payload_length) {
+  *this = Vp9PayloadDescriptorView();
+  if (payload_length == 0)
+    return false;
+
+  // |I|P|L|F|B|E|V|-|
+  const bool i_bit = (payload[0] & 0x80) != 0;
+  const bool l_bit = (payload[0] & 0x20) != 0;
+  inter_pic_predicted_ = (payload[0] & 0x40) != 0;
+  flexible_mode_ = (payload[0] & 0x10) != 0;
+  beginning_of_frame_ = (payload[0] & 0x08) != 0;
+  end_of_frame_ = (payload[0] & 0x04) != 0;
+  ss_data_available_ = (payload[0] & 0x02) != 0;
+  size_t offset = kFixedPayloadDescriptorBytes;
+
+  if (i_bit) {
+    if (payload_length < offset + 1)
+      return false;
+    if (payload[offset] & 0x80) {
+      if (payload_length < offset + 2)
+        return false;
+      picture_id_ = ((payload[offset] & 0x7f) << 8) | payload[offset + 1];
+      picture_id_length_ = 2;
+    } else {
+      picture_id_ = payload[offset];
+      picture_id_length_ = 1;
+    }
+    offset += picture_id_length_;
+  }
+
+  if (l_bit) {
+    // |  T  |U|  S  |D|, followed by TL0PICIDX in non-flexible mode.
+    if (payload_length < offset + (flexible_mode_ ? 1 : 2))
+      return false;
+    temporal_idx_ = payload[offset] >> 5;
+    temporal_up_switch_ = (payload[offset] & 0x10) != 0;
+    spatial_idx_ = (payload[offset] >> 1) & 0x07;
+    inter_layer_predicted_ = (payload[offset] & 0x01) != 0;
+  }
+  return true;
+}
+
+bool Vp9PayloadDescriptorView::SetPictureId(uint8_t* payload,
+                                            uint16_t picture_id) {
+  const size_t offset = kFixedPayloadDescriptorBytes;
+  if (picture_id_length_ == 2) {
+    picture_id_ = picture_id & kMaxTwoBytePictureId;
+    payload[offset] = 0x80 | (picture_id_ >> 8);
+    payload[offset + 1] = picture_id_ & 0xff;
+    return true;
+  }
+  if (picture_id_length_ == 1) {
+    picture_id_ = picture_id & kMaxOneBytePictureId;
+    payload[offset] = picture_id_;
+    return true;
+  }
+  return false;
+}
 }  // namespace webrtc
@@ -104,5 +104,48 @@ class RtpDepacketizerVp9 : public RtpDepacketizer {
              size_t payload_length) override;
 };
 
+// Reads the fields of a VP9 payload descriptor that a forwarding node needs to
+// drop spatial and temporal layers. Unlike RtpDepacketizerVp9, it only looks
+// at the first few bytes and skips the reference indices and the scalability
+// structure. The picture ID can be rewritten in place.
+class Vp9PayloadDescriptorView {
+ public:
+  // Returns false if |payload| is too short for the descriptor fields it
+  // signals. No pointer to |payload| is kept.
+  bool Parse(const uint8_t* payload, size_t payload_length);
+
+  // Writes |picture_id| to the descriptor at |payload|, which must be the one
+  // that was last parsed. The picture ID keeps its length, so only the low 7
+  // or 15 bits are written. Returns false if there's no picture ID.
+  bool SetPictureId(uint8_t* payload, uint16_t picture_id);
+
+  // kNoPictureId if not present.
+  int16_t picture_id() const { return picture_id_; }
+  // kNoTemporalIdx if not present.
+  uint8_t temporal_idx() const { return temporal_idx_; }
+  // Zero if not present, as in RtpDepacketizerVp9.
+  uint8_t spatial_idx() const { return spatial_idx_; }
+  bool inter_pic_predicted() const { return inter_pic_predicted_; }
+  bool flexible_mode() const { return flexible_mode_; }
+  bool beginning_of_frame() const { return beginning_of_frame_; }
+  bool end_of_frame() const { return end_of_frame_; }
+  bool temporal_up_switch() const { return temporal_up_switch_; }
+  bool inter_layer_predicted() const { return inter_layer_predicted_; }
+  bool ss_data_available() const { return ss_data_available_; }
+
+ private:
+  int16_t picture_id_ = kNoPictureId;
+  size_t picture_id_length_ = 0;
+  uint8_t temporal_idx_ = kNoTemporalIdx;
+  uint8_t spatial_idx_ = 0;
+  bool inter_pic_predicted_ = false;
+  bool flexible_mode_ = false;
+  bool beginning_of_frame_ = false;
+  bool end_of_frame_ = false;
+  bool temporal_up_switch_ = false;
+  bool inter_layer_predicted_ = false;
+  bool ss_data_available_ = false;
+};
+
 }  // namespace webrtc
 #endif  // WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_FORMAT_VP9_H_
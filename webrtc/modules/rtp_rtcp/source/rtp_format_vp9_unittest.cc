@@ -688,4 +688,86 @@ TEST_F(RtpDepacketizerVp9Test, ParseFailsForTooShortBufferToFitPayload) {
   EXPECT_FALSE(depacketizer_->Parse(&parsed, packet, sizeof(packet)));
 }
 
+TEST(Vp9PayloadDescriptorViewTest, ParseLayerInfo) {
+  uint8_t packet[13] = {0};
+  packet[0] = 0xA4;  // I:1 P:0 L:1 F:0 B:0 E:1 V:0 R:0
+  packet[1] = 0x80 | (1234 >> 8);
+  packet[2] = 1234 & 0xFF;
+  packet[3] = (2 << 5) | (1 << 4) | (1 << 1) | 1;  // T:2 U:1 S:1 D:1
+  packet[4] = 17;                                   // TL0PICIDX:17
+
+  Vp9PayloadDescriptorView descriptor;
+  ASSERT_TRUE(descriptor.Parse(packet, sizeof(packet)));
+  EXPECT_EQ(1234, descriptor.picture_id());
+  EXPECT_EQ(2, descriptor.temporal_idx());
+  EXPECT_EQ(1, descriptor.spatial_idx());
+  EXPECT_TRUE(descriptor.temporal_up_switch());
+  EXPECT_TRUE(descriptor.inter_layer_predicted());
+  EXPECT_TRUE(descriptor.end_of_frame());
+  EXPECT_FALSE(descriptor.beginning_of_frame());
+  EXPECT_FALSE(descriptor.flexible_mode());
+
+  // Without layer indices, the fields have the same defaults as in
+  // RtpDepacketizerVp9.
+  packet[0] = 0x08;  // I:0 P:0 L:0 F:0 B:1 E:0 V:0 R:0
+  ASSERT_TRUE(descriptor.Parse(packet, sizeof(packet)));
+  EXPECT_EQ(kNoPictureId, descriptor.picture_id());
+  EXPECT_EQ(kNoTemporalIdx, descriptor.temporal_idx());
+  EXPECT_EQ(0, descriptor.spatial_idx());
+  EXPECT_TRUE(descriptor.beginning_of_frame());
+}
+
+TEST(Vp9PayloadDescriptorViewTest, ParseFailsForTruncatedDescriptor) {
+  uint8_t packet[3] = {0};
+  Vp9PayloadDescriptorView descriptor;
+  EXPECT_FALSE(descriptor.Parse(packet, 0));
+  packet[0] = 0x80;  // I:1
+  packet[1] = 0x80;  // M:1
+  EXPECT_FALSE(descriptor.Parse(packet, 2));
+  packet[0] = 0x20;  // L:1 F:0
+  EXPECT_FALSE(descriptor.Parse(packet, 2));
+  packet[0] = 0x30;  // L:1 F:1
+  EXPECT_TRUE(descriptor.Parse(packet, 2));
+}
+
+TEST(Vp9PayloadDescriptorViewTest, SetPictureIdKeepsLength) {
+  RTPVideoHeaderVP9 hdr;
+  hdr.InitRTPVideoHeaderVP9();
+  hdr.picture_id = 300;
+  hdr.max_picture_id = kMaxTwoBytePictureId;
+  hdr.flexible_mode = true;
+  hdr.temporal_idx = 1;
+  hdr.spatial_idx = 2;
+  hdr.inter_pic_predicted = true;
+  hdr.num_ref_pics = 1;
+  hdr.pid_diff[0] = 3;
+  const uint8_t kFrame[20] = {0};
+  RtpPacketizerVp9 packetizer(hdr, 100);
+  packetizer.SetPayloadData(kFrame, sizeof(kFrame), nullptr);
+  uint8_t packet[100];
+  size_t length = 0;
+  bool last = false;
+  ASSERT_TRUE(packetizer.NextPacket(packet, &length, &last));
+
+  Vp9PayloadDescriptorView descriptor;
+  ASSERT_TRUE(descriptor.Parse(packet, length));
+  EXPECT_EQ(300, descriptor.picture_id());
+  EXPECT_EQ(2, descriptor.spatial_idx());
+  ASSERT_TRUE(descriptor.SetPictureId(packet, 0x8000 | 5000));
+  EXPECT_EQ(5000, descriptor.picture_id());
+
+  RtpDepacketizerVp9 depacketizer;
+  RtpDepacketizer::ParsedPayload parsed;
+  ASSERT_TRUE(depacketizer.Parse(&parsed, packet, length));
+  EXPECT_EQ(5000, parsed.type.Video.codecHeader.VP9.picture_id);
+  EXPECT_EQ(kMaxTwoBytePictureId,
+            parsed.type.Video.codecHeader.VP9.max_picture_id);
+  EXPECT_EQ(1u, parsed.type.Video.codecHeader.VP9.num_ref_pics);
+  EXPECT_EQ(sizeof(kFrame), parsed.payload_length);
+
+  packet[0] = 0x0C;  // I:0
+  ASSERT_TRUE(descriptor.Parse(packet, length));
+  EXPECT_FALSE(descriptor.SetPictureId(packet, 1));
+}
+
 }  // namespace webrtc
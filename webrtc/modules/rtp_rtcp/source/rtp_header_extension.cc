@@ -16,20 +16,27 @@
 
 namespace webrtc {
 
+constexpr RTPExtensionType RtpHeaderExtensionMap::kInvalidType;
+constexpr uint8_t RtpHeaderExtensionMap::kInvalidId;
+constexpr uint8_t RtpHeaderExtensionMap::kMinId;
+constexpr uint8_t RtpHeaderExtensionMap::kMaxId;
+constexpr uint8_t RtpHeaderExtensionMap::kIdTableSize;
+
 RtpHeaderExtensionMap::RtpHeaderExtensionMap() {
+  Erase();
 }
 
 RtpHeaderExtensionMap::~RtpHeaderExtensionMap() {
-  Erase();
 }
 
 void RtpHeaderExtensionMap::Erase() {
-  while (!extensionMap_.empty()) {
-    std::map<uint8_t, HeaderExtension*>::iterator it =
-        extensionMap_.begin();
-    delete it->second;
-    extensionMap_.erase(it);
+  for (uint8_t id = 0; id < kIdTableSize; ++id) {
+    types_[id] = kInvalidType;
+    lengths_[id] = 0;
+    active_[id] = false;
   }
+  for (int type = 0; type < kRtpExtensionNumberOfExtensions; ++type)
+    ids_[type] = kInvalidId;
 }
 
 int32_t RtpHeaderExtensionMap::Register(const RTPExtensionType type,
@@ -45,117 +52,81 @@ int32_t RtpHeaderExtensionMap::RegisterInactive(const RTPExtensionType type,
 int32_t RtpHeaderExtensionMap::Register(const RTPExtensionType type,
                                         const uint8_t id,
                                         bool active) {
-  if (id < 1 || id > 14) {
+  if (id < kMinId || id > kMaxId) {
     return -1;
   }
-  std::map<uint8_t, HeaderExtension*>::iterator it =
-      extensionMap_.find(id);
-  if (it != extensionMap_.end()) {
-    if (it->second->type != type) {
-      // An extension is already registered with the same id
-      // but a different type, so return failure.
+  if (type <= kRtpExtensionNone || type >= kRtpExtensionNumberOfExtensions) {
+    return -1;
+  }
+  if (types_[id] != kInvalidType || ids_[type] != kInvalidId) {
+    if (types_[id] != type) {
+      // Either the id is already registered with a different type, or the
+      // type with a different id, so return failure.
       return -1;
     }
     // This extension type is already registered with this id,
     // so return success.
-    it->second->active = active;
+    active_[id] = active;
     return 0;
   }
-  extensionMap_[id] = new HeaderExtension(type, active);
+  types_[id] = type;
+  lengths_[id] = HeaderExtension(type).length;
+  active_[id] = active;
+  ids_[type] = id;
   return 0;
 }
 
 bool RtpHeaderExtensionMap::SetActive(const RTPExtensionType type,
                                       bool active) {
-  for (auto& kv : extensionMap_) {
-    if (kv.second->type == type) {
-      kv.second->active = active;
-      return true;
-    }
+  uint8_t id = GetId(type);
+  if (id == kInvalidId) {
+    return false;
   }
-  return false;
+  active_[id] = active;
+  return true;
 }
 
 int32_t RtpHeaderExtensionMap::Deregister(const RTPExtensionType type) {
-  uint8_t id;
-  if (GetId(type, &id) != 0) {
+  uint8_t id = GetId(type);
+  if (id == kInvalidId) {
     return 0;
   }
-  std::map<uint8_t, HeaderExtension*>::iterator it =
-      extensionMap_.find(id);
-  assert(it != extensionMap_.end());
-  delete it->second;
-  extensionMap_.erase(it);
+  types_[id] = kInvalidType;
+  lengths_[id] = 0;
+  active_[id] = false;
+  ids_[type] = kInvalidId;
   return 0;
 }
 
-bool RtpHeaderExtensionMap::IsRegistered(RTPExtensionType type) const {
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-    extensionMap_.begin();
-  for (; it != extensionMap_.end(); ++it) {
-    if (it->second->type == type)
-      return true;
-  }
-  return false;
-}
-
 int32_t RtpHeaderExtensionMap::GetType(const uint8_t id,
                                        RTPExtensionType* type) const {
   assert(type);
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.find(id);
-  if (it == extensionMap_.end()) {
+  RTPExtensionType registered_type = GetType(id);
+  if (registered_type == kInvalidType) {
     return -1;
   }
-  HeaderExtension* extension = it->second;
-  *type = extension->type;
+  *type = registered_type;
   return 0;
 }
 
-RTPExtensionType RtpHeaderExtensionMap::GetType(uint8_t id) const {
-  auto it = extensionMap_.find(id);
-  if (it == extensionMap_.end()) {
-    return kInvalidType;
-  }
-  return it->second->type;
-}
-
 int32_t RtpHeaderExtensionMap::GetId(const RTPExtensionType type,
                                      uint8_t* id) const {
   assert(id);
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    if (extension->type == type) {
-      *id = it->first;
-      return 0;
-    }
-    it++;
-  }
-  return -1;
-}
-
-uint8_t RtpHeaderExtensionMap::GetId(RTPExtensionType type) const {
-  for (auto kv : extensionMap_) {
-    if (kv.second->type == type)
-      return kv.first;
+  uint8_t registered_id = GetId(type);
+  if (registered_id == kInvalidId) {
+    return -1;
   }
-  return kInvalidId;
+  *id = registered_id;
+  return 0;
 }
 
 size_t RtpHeaderExtensionMap::GetTotalLengthInBytes() const {
   // Get length for each extension block.
   size_t length = 0;
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    if (extension->active) {
-      length += extension->length;
+  for (uint8_t id = kMinId; id <= kMaxId; ++id) {
+    if (active_[id]) {
+      length += lengths_[id];
     }
-    it++;
   }
   // Add RTP extension header length.
   if (length > 0) {
@@ -168,35 +139,25 @@ size_t RtpHeaderExtensionMap::GetTotalLengthInBytes() const {
 
 int32_t RtpHeaderExtensionMap::GetLengthUntilBlockStartInBytes(
     const RTPExtensionType type) const {
-  uint8_t id;
-  if (GetId(type, &id) != 0) {
-    // Not registered.
+  uint8_t type_id = GetId(type);
+  if (type_id == kInvalidId || !active_[type_id]) {
+    // Not registered or inactive.
     return -1;
   }
   // Get length until start of extension block type.
   uint16_t length = kRtpOneByteHeaderLength;
-
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    if (extension->type == type) {
-      if (!extension->active) {
-        return -1;
-      }
-      break;
-    } else if (extension->active) {
-      length += extension->length;
+  for (uint8_t id = kMinId; id < type_id; ++id) {
+    if (active_[id]) {
+      length += lengths_[id];
     }
-    it++;
   }
   return length;
 }
 
 int32_t RtpHeaderExtensionMap::Size() const {
   int32_t count = 0;
-  for (auto& kv : extensionMap_) {
-    if (kv.second->active) {
+  for (uint8_t id = kMinId; id <= kMaxId; ++id) {
+    if (active_[id]) {
       count++;
     }
   }
@@ -204,9 +165,9 @@ int32_t RtpHeaderExtensionMap::Size() const {
 }
 
 RTPExtensionType RtpHeaderExtensionMap::First() const {
-  for (auto& kv : extensionMap_) {
-    if (kv.second->active) {
-      return kv.second->type;
+  for (uint8_t id = kMinId; id <= kMaxId; ++id) {
+    if (active_[id]) {
+      return types_[id];
     }
   }
 
@@ -214,18 +175,13 @@ RTPExtensionType RtpHeaderExtensionMap::First() const {
 }
 
 RTPExtensionType RtpHeaderExtensionMap::Next(RTPExtensionType type) const {
-  uint8_t id;
-  if (GetId(type, &id) != 0) {
+  uint8_t type_id = GetId(type);
+  if (type_id == kInvalidId || !active_[type_id]) {
     return kRtpExtensionNone;
   }
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.find(id);
-  if (it == extensionMap_.end() || !it->second->active) {
-    return kRtpExtensionNone;
-  }
-  while ((++it) != extensionMap_.end()) {
-    if (it->second->active) {
-      return it->second->type;
+  for (uint8_t id = type_id + 1; id <= kMaxId; ++id) {
+    if (active_[id]) {
+      return types_[id];
     }
   }
 
@@ -234,12 +190,10 @@ RTPExtensionType RtpHeaderExtensionMap::Next(RTPExtensionType type) const {
 
 void RtpHeaderExtensionMap::GetCopy(RtpHeaderExtensionMap* map) const {
   assert(map);
-  std::map<uint8_t, HeaderExtension*>::const_iterator it =
-      extensionMap_.begin();
-  while (it != extensionMap_.end()) {
-    HeaderExtension* extension = it->second;
-    map->Register(extension->type, it->first, extension->active);
-    it++;
+  for (uint8_t id = kMinId; id <= kMaxId; ++id) {
+    if (types_[id] != kInvalidType) {
+      map->Register(types_[id], id, active_[id]);
+    }
   }
 }
 }  // namespace webrtc
@@ -11,8 +11,6 @@
 #ifndef WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_HEADER_EXTENSION_H_
 #define WEBRTC_MODULES_RTP_RTCP_SOURCE_RTP_HEADER_EXTENSION_H_
 
-#include <map>
-
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/typedefs.h"
 
@@ -79,15 +77,22 @@ struct HeaderExtension {
   bool active;
 };
 
+// Maps the one-byte header extension ids 1-14 to extension types and back.
+// Both directions are plain array lookups, since they are done for every
+// extension of every packet that is built or parsed.
 class RtpHeaderExtensionMap {
  public:
   static constexpr RTPExtensionType kInvalidType = kRtpExtensionNone;
   static constexpr uint8_t kInvalidId = 0;
+  static constexpr uint8_t kMinId = 1;
+  static constexpr uint8_t kMaxId = 14;
   RtpHeaderExtensionMap();
   ~RtpHeaderExtensionMap();
 
   void Erase();
 
+  // Fails if |id| is out of range, or if either |id| or |type| is already
+  // registered with something else.
   int32_t Register(const RTPExtensionType type, const uint8_t id);
 
   // Active on an extension indicates whether it is currently being added on
@@ -98,15 +103,21 @@ class RtpHeaderExtensionMap {
 
   int32_t Deregister(const RTPExtensionType type);
 
-  bool IsRegistered(RTPExtensionType type) const;
+  bool IsRegistered(RTPExtensionType type) const {
+    return GetId(type) != kInvalidId;
+  }
 
   int32_t GetType(const uint8_t id, RTPExtensionType* type) const;
   // Return kInvalidType if not found.
-  RTPExtensionType GetType(uint8_t id) const;
+  RTPExtensionType GetType(uint8_t id) const {
+    return id < kIdTableSize ? types_[id] : kInvalidType;
+  }
 
   int32_t GetId(const RTPExtensionType type, uint8_t* id) const;
   // Return kInvalidId if not found.
-  uint8_t GetId(RTPExtensionType type) const;
+  uint8_t GetId(RTPExtensionType type) const {
+    return type < kRtpExtensionNumberOfExtensions ? ids_[type] : kInvalidId;
+  }
 
   //
   // Methods below ignore any inactive rtp header extensions.
@@ -125,8 +136,18 @@ class RtpHeaderExtensionMap {
   RTPExtensionType Next(RTPExtensionType type) const;
 
  private:
+  // Covers every id a one-byte header can carry, so that ids parsed off the
+  // wire can be looked up without a range check beyond the table size.
+  static constexpr uint8_t kIdTableSize = 16;
+
   int32_t Register(const RTPExtensionType type, const uint8_t id, bool active);
-  std::map<uint8_t, HeaderExtension*> extensionMap_;
+
+  // Indexed by id. Unused entries hold kInvalidType.
+  RTPExtensionType types_[kIdTableSize];
+  uint8_t lengths_[kIdTableSize];
+  bool active_[kIdTableSize];
+  // Indexed by type. Unregistered types map to kInvalidId.
+  uint8_t ids_[kRtpExtensionNumberOfExtensions];
 };
 }  // namespace webrtc
 
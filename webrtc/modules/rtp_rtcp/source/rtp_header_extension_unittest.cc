@@ -61,6 +61,29 @@ TEST_F(RtpHeaderExtensionTest, NonUniqueId) {
   EXPECT_EQ(-1, map_.RegisterInactive(kRtpExtensionAudioLevel, kId));
 }
 
+TEST_F(RtpHeaderExtensionTest, NonUniqueType) {
+  EXPECT_EQ(0, map_.Register(kRtpExtensionTransmissionTimeOffset, kId));
+  EXPECT_EQ(-1, map_.Register(kRtpExtensionTransmissionTimeOffset, kId + 1));
+  EXPECT_EQ(kRtpExtensionNone, map_.GetType(kId + 1));
+  EXPECT_EQ(kId, map_.GetId(kRtpExtensionTransmissionTimeOffset));
+}
+
+TEST_F(RtpHeaderExtensionTest, ReregisterAfterDeregister) {
+  EXPECT_EQ(0, map_.Register(kRtpExtensionTransmissionTimeOffset, kId));
+  EXPECT_EQ(0, map_.Deregister(kRtpExtensionTransmissionTimeOffset));
+  EXPECT_EQ(kRtpExtensionNone, map_.GetType(kId));
+  EXPECT_EQ(0, map_.Register(kRtpExtensionAudioLevel, kId));
+  EXPECT_EQ(0, map_.Register(kRtpExtensionTransmissionTimeOffset, kId + 1));
+  EXPECT_EQ(kRtpExtensionAudioLevel, map_.GetType(kId));
+  EXPECT_EQ(kId + 1, map_.GetId(kRtpExtensionTransmissionTimeOffset));
+}
+
+TEST_F(RtpHeaderExtensionTest, GetTypeOfUnusedIds) {
+  // Ids parsed off the wire can take any four bit value.
+  for (uint8_t id = 0; id < 16; ++id)
+    EXPECT_EQ(kRtpExtensionNone, map_.GetType(id));
+}
+
 TEST_F(RtpHeaderExtensionTest, GetTotalLength) {
   EXPECT_EQ(0u, map_.GetTotalLengthInBytes());
   EXPECT_EQ(0, map_.RegisterInactive(kRtpExtensionTransmissionTimeOffset, kId));
@@ -84,6 +107,18 @@ TEST_F(RtpHeaderExtensionTest, GetLengthUntilBlockStart) {
                 kRtpExtensionTransmissionTimeOffset));
 }
 
+TEST_F(RtpHeaderExtensionTest, GetLengthUntilBlockStartSkipsInactive) {
+  EXPECT_EQ(0, map_.Register(kRtpExtensionAudioLevel, 1));
+  EXPECT_EQ(0, map_.RegisterInactive(kRtpExtensionVideoRotation, 2));
+  EXPECT_EQ(0, map_.Register(kRtpExtensionAbsoluteSendTime, 5));
+  EXPECT_EQ(static_cast<int>(kRtpOneByteHeaderLength + kAudioLevelLength),
+            map_.GetLengthUntilBlockStartInBytes(
+                kRtpExtensionAbsoluteSendTime));
+  EXPECT_EQ(kRtpExtensionAudioLevel, map_.First());
+  EXPECT_EQ(kRtpExtensionAbsoluteSendTime,
+            map_.Next(kRtpExtensionAudioLevel));
+}
+
 TEST_F(RtpHeaderExtensionTest, GetType) {
   RTPExtensionType typeOut;
   EXPECT_EQ(-1, map_.GetType(kId, &typeOut));
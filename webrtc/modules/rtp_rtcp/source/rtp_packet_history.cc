@@ -10,8 +10,8 @@
 
 #include "webrtc/modules/rtp_rtcp/source/rtp_packet_history.h"
 
-#include <algorithm>
 #include <limits>
+#include <utility>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
@@ -21,11 +21,20 @@
 namespace webrtc {
 namespace {
 constexpr size_t kMinPacketRequestBytes = 50;
+// A packet may be NACKed until about this many RTTs after it was sent.
+constexpr int64_t kMaxNackRtts = 3;
+
+size_t PacketSizeInBytes(const RtpPacketToSend& packet) {
+  return sizeof(packet) + packet.capacity();
+}
 }  // namespace
 constexpr size_t RtpPacketHistory::kMaxCapacity;
 
 RtpPacketHistory::RtpPacketHistory(Clock* clock)
-    : clock_(clock), store_(false), prev_index_(0) {}
+    : clock_(clock),
+      store_(false),
+      rtt_ms_(0),
+      memory_usage_("RtpPacketHistory") {}
 
 RtpPacketHistory::~RtpPacketHistory() {}
 
@@ -48,7 +57,23 @@ void RtpPacketHistory::Allocate(size_t number_to_store) {
   RTC_DCHECK_GT(number_to_store, 0u);
   RTC_DCHECK_LE(number_to_store, kMaxCapacity);
   store_ = true;
-  stored_packets_.resize(number_to_store);
+  size_t capacity = 1;
+  while (capacity < number_to_store)
+    capacity *= 2;
+  stored_packets_.resize(capacity);
+  memory_usage_.Add(capacity * sizeof(StoredPacket));
+}
+
+void RtpPacketHistory::Grow() {
+  RTC_DCHECK_LT(stored_packets_.size(), kMaxCapacity);
+  std::vector<StoredPacket> stored_packets(stored_packets_.size() * 2);
+  stored_packets_.swap(stored_packets);
+  memory_usage_.Add(stored_packets.size() * sizeof(StoredPacket));
+  // Packets in different slots of the old ring stay apart in the new one.
+  for (StoredPacket& stored : stored_packets) {
+    if (stored.packet)
+      stored_packets_[Index(stored.sequence_number)] = std::move(stored);
+  }
 }
 
 void RtpPacketHistory::Free() {
@@ -57,9 +82,19 @@ void RtpPacketHistory::Free() {
   }
 
   stored_packets_.clear();
+  memory_usage_.Set(0);
 
   store_ = false;
-  prev_index_ = 0;
+}
+
+size_t RtpPacketHistory::Index(uint16_t sequence_number) const {
+  return sequence_number & (stored_packets_.size() - 1);
+}
+
+bool RtpPacketHistory::MayBeRequested(const StoredPacket& stored,
+                                      int64_t now_ms) const {
+  return stored.packet && (stored.send_time == 0 ||
+                           now_ms - stored.send_time < kMaxNackRtts * rtt_ms_);
 }
 
 bool RtpPacketHistory::StorePackets() const {
@@ -67,6 +102,11 @@ bool RtpPacketHistory::StorePackets() const {
   return store_;
 }
 
+void RtpPacketHistory::SetRtt(int64_t rtt_ms) {
+  rtc::CritScope cs(&critsect_);
+  rtt_ms_ = rtt_ms;
+}
+
 void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
                                     StorageType type,
                                     bool sent) {
@@ -76,36 +116,30 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
     return;
   }
 
-  // If index we're about to overwrite contains a packet that has not
-  // yet been sent (probably pending in paced sender), we need to expand
-  // the buffer.
-  if (stored_packets_[prev_index_].packet &&
-      stored_packets_[prev_index_].send_time == 0) {
-    size_t current_size = static_cast<uint16_t>(stored_packets_.size());
-    if (current_size < kMaxCapacity) {
-      size_t expanded_size = std::max(current_size * 3 / 2, current_size + 1);
-      expanded_size = std::min(expanded_size, kMaxCapacity);
-      Allocate(expanded_size);
-      // Causes discontinuity, but that's OK-ish. FindSeqNum() will still work,
-      // but may be slower - at least until buffer has wrapped around once.
-      prev_index_ = current_size;
-    }
+  // If the packet we're about to overwrite has not yet been sent (probably
+  // pending in paced sender), or may still be NACKed, we need to expand the
+  // buffer.
+  uint16_t sequence_number = packet->SequenceNumber();
+  int64_t now = clock_->TimeInMilliseconds();
+  while (stored_packets_.size() < kMaxCapacity &&
+         stored_packets_[Index(sequence_number)].sequence_number !=
+             sequence_number &&
+         MayBeRequested(stored_packets_[Index(sequence_number)], now)) {
+    Grow();
   }
 
   // Store packet.
   if (packet->capture_time_ms() <= 0)
-    packet->set_capture_time_ms(clock_->TimeInMilliseconds());
-  stored_packets_[prev_index_].sequence_number = packet->SequenceNumber();
-  stored_packets_[prev_index_].send_time =
-      (sent ? clock_->TimeInMilliseconds() : 0);
-  stored_packets_[prev_index_].storage_type = type;
-  stored_packets_[prev_index_].has_been_retransmitted = false;
-  stored_packets_[prev_index_].packet = std::move(packet);
-
-  ++prev_index_;
-  if (prev_index_ >= stored_packets_.size()) {
-    prev_index_ = 0;
-  }
+    packet->set_capture_time_ms(now);
+  StoredPacket& stored = stored_packets_[Index(sequence_number)];
+  stored.sequence_number = sequence_number;
+  stored.send_time = (sent ? now : 0);
+  stored.storage_type = type;
+  stored.has_been_retransmitted = false;
+  if (stored.packet)
+    memory_usage_.Subtract(PacketSizeInBytes(*stored.packet));
+  memory_usage_.Add(PacketSizeInBytes(*packet));
+  stored.packet = std::move(packet);
 }
 
 bool RtpPacketHistory::HasRtpPacket(uint16_t sequence_number) const {
@@ -156,6 +190,7 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
 }
 
 std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacket(int index) const {
+  // The copy shares the stored packet's buffer until either is written to.
   const RtpPacketToSend& stored = *stored_packets_[index].packet;
   return std::unique_ptr<RtpPacketToSend>(new RtpPacketToSend(stored));
 }
@@ -172,31 +207,9 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetBestFittingPacket(
 }
 
 bool RtpPacketHistory::FindSeqNum(uint16_t sequence_number, int* index) const {
-  if (prev_index_ > 0) {
-    *index = prev_index_ - 1;
-  } else {
-    *index = stored_packets_.size() - 1;  // Wrap.
-  }
-  uint16_t temp_sequence_number = stored_packets_[*index].sequence_number;
-
-  int idx = *index - (temp_sequence_number - sequence_number);
-  if (idx >= 0 && idx < static_cast<int>(stored_packets_.size())) {
-    *index = idx;
-    temp_sequence_number = stored_packets_[*index].sequence_number;
-  }
-
-  if (temp_sequence_number != sequence_number) {
-    // We did not found a match, search all.
-    for (uint16_t m = 0; m < stored_packets_.size(); m++) {
-      if (stored_packets_[m].sequence_number == sequence_number) {
-        *index = m;
-        temp_sequence_number = stored_packets_[*index].sequence_number;
-        break;
-      }
-    }
-  }
-  return temp_sequence_number == sequence_number &&
-         stored_packets_[*index].packet;
+  *index = static_cast<int>(Index(sequence_number));
+  return stored_packets_[*index].packet &&
+         stored_packets_[*index].sequence_number == sequence_number;
 }
 
 int RtpPacketHistory::FindBestFittingPacket(size_t size) const {
@@ -16,6 +16,7 @@
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
+#include "webrtc/base/memory_usage.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/typedefs.h"
@@ -25,15 +26,25 @@ namespace webrtc {
 class Clock;
 class RtpPacketToSend;
 
+// Stores sent packets for retransmission in a ring indexed by sequence
+// number. The ring starts at the size asked for and grows, up to
+// kMaxCapacity, rather than overwrite a packet that is still waiting in the
+// pacer or may still be NACKed, i.e. was sent less than a few RTTs ago. It so
+// ends up holding RTT x packet rate packets.
 class RtpPacketHistory {
  public:
-  static constexpr size_t kMaxCapacity = 9600;
+  // A power of two, like all the sizes of the ring, so that it stays
+  // continuous when sequence numbers wrap around.
+  static constexpr size_t kMaxCapacity = 16384;
   explicit RtpPacketHistory(Clock* clock);
   ~RtpPacketHistory();
 
   void SetStorePacketsStatus(bool enable, uint16_t number_to_store);
   bool StorePackets() const;
 
+  // Packets sent less than a few |rtt_ms| ago aren't overwritten.
+  void SetRtt(int64_t rtt_ms);
+
   void PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
                     StorageType type,
                     bool sent);
@@ -67,7 +78,12 @@ class RtpPacketHistory {
   std::unique_ptr<RtpPacketToSend> GetPacket(int index) const
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void Allocate(size_t number_to_store) EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void Grow() EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void Free() EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  size_t Index(uint16_t sequence_number) const
+      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  bool MayBeRequested(const StoredPacket& stored, int64_t now_ms) const
+      EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   bool FindSeqNum(uint16_t sequence_number, int* index) const
       EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   int FindBestFittingPacket(size_t size) const
@@ -76,8 +92,10 @@ class RtpPacketHistory {
   Clock* clock_;
   rtc::CriticalSection critsect_;
   bool store_ GUARDED_BY(critsect_);
-  uint32_t prev_index_ GUARDED_BY(critsect_);
+  int64_t rtt_ms_ GUARDED_BY(critsect_);
   std::vector<StoredPacket> stored_packets_ GUARDED_BY(critsect_);
+  // The ring and the stored packets, when memory accounting is enabled.
+  rtc::ScopedMemoryUsage memory_usage_ GUARDED_BY(critsect_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RtpPacketHistory);
 };
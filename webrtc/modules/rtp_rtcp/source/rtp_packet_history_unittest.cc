@@ -219,4 +219,44 @@ TEST_F(RtpPacketHistoryTest, FullExpansion) {
   }
 }
 
+TEST_F(RtpPacketHistoryTest, KeepsPacketsThatMayStillBeNacked) {
+  hist_.SetStorePacketsStatus(true, 4);
+  hist_.SetRtt(100);
+  // Sent 10 ms apart, they all may be NACKed within 3 RTTs.
+  for (int i = 0; i < 20; ++i) {
+    hist_.PutRtpPacket(CreateRtpPacket(kSeqNum + i), kAllowRetransmission,
+                       true);
+    fake_clock_.AdvanceTimeMilliseconds(10);
+  }
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_TRUE(hist_.HasRtpPacket(kSeqNum + i));
+  }
+
+  // Once they're older than that, they're overwritten.
+  fake_clock_.AdvanceTimeMilliseconds(300);
+  for (int i = 20; i < 52; ++i) {
+    hist_.PutRtpPacket(CreateRtpPacket(kSeqNum + i), kAllowRetransmission,
+                       true);
+  }
+  EXPECT_FALSE(hist_.HasRtpPacket(kSeqNum));
+  EXPECT_TRUE(hist_.HasRtpPacket(kSeqNum + 51));
+}
+
+TEST_F(RtpPacketHistoryTest, SequenceNumberWrapAround) {
+  hist_.SetStorePacketsStatus(true, 10);
+  const uint16_t kFirstSeqNum = 0xfffa;
+  for (uint16_t i = 0; i < 10; ++i) {
+    hist_.PutRtpPacket(CreateRtpPacket(kFirstSeqNum + i), kAllowRetransmission,
+                       false);
+  }
+  for (uint16_t i = 0; i < 10; ++i) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        hist_.GetPacketAndSetSendTime(kFirstSeqNum + i, 0, false);
+    ASSERT_TRUE(packet);
+    EXPECT_EQ(static_cast<uint16_t>(kFirstSeqNum + i),
+              packet->SequenceNumber());
+  }
+  EXPECT_FALSE(hist_.HasRtpPacket(kFirstSeqNum - 1));
+}
+
 }  // namespace webrtc
@@ -12,9 +12,12 @@
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 
 using testing::ElementsAreArray;
 using testing::make_tuple;
@@ -302,4 +305,33 @@ TEST(RtpPacketTest, ParseWithExtensionDelayed) {
   EXPECT_EQ(0u, packet.padding_size());
 }
 
+// Measures the cost of parsing a packet with two header extensions, into an
+// RTPHeader as the receive path does and into an RtpPacketReceived.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(RtpPacketTest, DISABLED_ParseCost) {
+  const int kPackets = 1000000;
+  RtpHeaderExtensionMap map;
+  map.Register(kRtpExtensionTransmissionTimeOffset,
+               kTransmissionOffsetExtensionId);
+  map.Register(kRtpExtensionAudioLevel, kAudioLevelExtensionId);
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kPackets; ++i) {
+    RTPHeader header;
+    RtpUtility::RtpHeaderParser parser(kPacketWithTOAndAL,
+                                       sizeof(kPacketWithTOAndAL));
+    ASSERT_TRUE(parser.Parse(&header, &map));
+  }
+  int64_t header_ns = (rtc::TimeNanos() - start_ns) / kPackets;
+
+  RtpPacketReceived packet(&map);
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kPackets; ++i) {
+    ASSERT_TRUE(packet.Parse(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)));
+  }
+  int64_t packet_ns = (rtc::TimeNanos() - start_ns) / kPackets;
+  LOG(LS_INFO) << "Parsing into RTPHeader: " << header_ns
+               << " ns, into RtpPacketReceived: " << packet_ns << " ns";
+}
+
 }  // namespace webrtc
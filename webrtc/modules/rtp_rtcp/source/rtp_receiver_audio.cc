@@ -37,7 +37,10 @@ RTPReceiverAudio::RTPReceiverAudio(RtpData* data_callback)
       g722_payload_type_(-1),
       last_received_g722_(false),
       num_energy_(0),
-      current_remote_energy_() {
+      current_remote_energy_(),
+      has_last_audio_level_(false),
+      last_audio_level_dbov_(0),
+      last_voice_activity_(false) {
   last_payload_.Audio.channels = 1;
   memset(current_remote_energy_, 0, sizeof(current_remote_energy_));
 }
@@ -193,6 +196,13 @@ int32_t RTPReceiverAudio::ParseRtpPacket(WebRtcRTPHeader* rtp_header,
            rtp_header->type.Audio.numEnergy);
   }
 
+  if (rtp_header->header.extension.hasAudioLevel) {
+    rtc::CritScope lock(&crit_sect_);
+    has_last_audio_level_ = true;
+    last_audio_level_dbov_ = rtp_header->header.extension.audioLevel;
+    last_voice_activity_ = rtp_header->header.extension.voiceActivity;
+  }
+
   if (first_packet_received_()) {
     LOG(LS_INFO) << "Received first audio RTP packet";
   }
@@ -259,6 +269,16 @@ int RTPReceiverAudio::Energy(uint8_t array_of_energy[kRtpCsrcSize]) const {
   return num_energy_;
 }
 
+bool RTPReceiverAudio::LastReceivedAudioLevel(uint8_t* audio_level_dbov,
+                                              bool* voice_activity) const {
+  rtc::CritScope cs(&crit_sect_);
+  if (!has_last_audio_level_)
+    return false;
+  *audio_level_dbov = last_audio_level_dbov_;
+  *voice_activity = last_voice_activity_;
+  return true;
+}
+
 int32_t RTPReceiverAudio::InvokeOnInitializeDecoder(
     RtpFeedback* callback,
     int8_t payload_type,
@@ -90,6 +90,9 @@ class RTPReceiverAudio : public RTPReceiverStrategy,
 
   int Energy(uint8_t array_of_energy[kRtpCsrcSize]) const override;
 
+  bool LastReceivedAudioLevel(uint8_t* audio_level_dbov,
+                              bool* voice_activity) const override;
+
  private:
   int32_t ParseAudioCodecSpecific(WebRtcRTPHeader* rtp_header,
                                   const uint8_t* payload_data,
@@ -117,6 +120,11 @@ class RTPReceiverAudio : public RTPReceiverStrategy,
   uint8_t num_energy_;
   uint8_t current_remote_energy_[kRtpCsrcSize];
 
+  // From the audio level header extension of the last packet carrying it.
+  bool has_last_audio_level_;
+  uint8_t last_audio_level_dbov_;
+  bool last_voice_activity_;
+
   ThreadUnsafeOneTimeEvent first_packet_received_;
 };
 }  // namespace webrtc
@@ -134,6 +134,12 @@ int32_t RtpReceiverImpl::Energy(
   return rtp_media_receiver_->Energy(array_of_energy);
 }
 
+bool RtpReceiverImpl::LastReceivedAudioLevel(uint8_t* audio_level_dbov,
+                                             bool* voice_activity) const {
+  return rtp_media_receiver_->LastReceivedAudioLevel(audio_level_dbov,
+                                                     voice_activity);
+}
+
 bool RtpReceiverImpl::IncomingRtpPacket(
   const RTPHeader& rtp_header,
   const uint8_t* payload,
@@ -57,6 +57,9 @@ class RtpReceiverImpl : public RtpReceiver {
 
   int32_t Energy(uint8_t array_of_energy[kRtpCsrcSize]) const override;
 
+  bool LastReceivedAudioLevel(uint8_t* audio_level_dbov,
+                              bool* voice_activity) const override;
+
   TelephoneEventHandler* GetTelephoneEventHandler() override;
 
  private:
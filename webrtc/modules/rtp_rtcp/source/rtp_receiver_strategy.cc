@@ -42,4 +42,9 @@ int RTPReceiverStrategy::Energy(uint8_t array_of_energy[kRtpCsrcSize]) const {
   return -1;
 }
 
+bool RTPReceiverStrategy::LastReceivedAudioLevel(uint8_t* audio_level_dbov,
+                                                 bool* voice_activity) const {
+  return false;
+}
+
 }  // namespace webrtc
@@ -79,6 +79,11 @@ class RTPReceiverStrategy {
 
   virtual int Energy(uint8_t array_of_energy[kRtpCsrcSize]) const;
 
+  // Returns the audio level and voice activity of the last received packet
+  // with the audio level header extension. Returns false if there is none.
+  virtual bool LastReceivedAudioLevel(uint8_t* audio_level_dbov,
+                                      bool* voice_activity) const;
+
   // Stores / retrieves the last media specific payload for later reference.
   void GetLastMediaSpecificPayload(PayloadUnion* payload) const;
   void SetLastMediaSpecificPayload(const PayloadUnion& payload);
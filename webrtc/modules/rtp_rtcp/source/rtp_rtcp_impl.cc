@@ -19,6 +19,7 @@
 #include "webrtc/base/logging.h"
 #include "webrtc/common_types.h"
 #include "webrtc/config.h"
+#include "webrtc/modules/rtp_rtcp/source/producer_fec.h"
 #include "webrtc/system_wrappers/include/trace.h"
 
 #ifdef _WIN32
@@ -583,6 +584,7 @@ void ModuleRtpRtcpImpl::GetRtpPacketLossStats(
     uint32_t ssrc,
     struct RtpPacketLossStats* loss_stats) const {
   if (!loss_stats) return;
+  rtc::CritScope cs(&critical_section_loss_stats_);
   const PacketLossStats* stats_source = NULL;
   if (outgoing) {
     if (SSRC() == ssrc) {
@@ -665,8 +667,10 @@ int ModuleRtpRtcpImpl::SetSelectiveRetransmissions(uint8_t settings) {
 // Send a Negative acknowledgment packet.
 int32_t ModuleRtpRtcpImpl::SendNACK(const uint16_t* nack_list,
                                     const uint16_t size) {
-  for (int i = 0; i < size; ++i) {
-    receive_loss_stats_.AddLostPacket(nack_list[i]);
+  {
+    rtc::CritScope cs(&critical_section_loss_stats_);
+    for (int i = 0; i < size; ++i)
+      receive_loss_stats_.AddLostPacket(nack_list[i]);
   }
   uint16_t nack_length = size;
   uint16_t start_id = 0;
@@ -771,6 +775,11 @@ int32_t ModuleRtpRtcpImpl::SetAudioLevel(
   return rtp_sender_.SetAudioLevel(level_d_bov);
 }
 
+void ModuleRtpRtcpImpl::SetAudioVoiceActivity(
+    rtc::Optional<bool> voice_activity) {
+  rtp_sender_.SetAudioVoiceActivity(voice_activity);
+}
+
 int32_t ModuleRtpRtcpImpl::SetKeyFrameRequestMethod(
     const KeyFrameRequestMethod method) {
   key_frame_req_method_ = method;
@@ -809,7 +818,25 @@ void ModuleRtpRtcpImpl::GenericFECStatus(bool* enable,
 int32_t ModuleRtpRtcpImpl::SetFecParameters(
     const FecProtectionParams* delta_params,
     const FecProtectionParams* key_params) {
-  return rtp_sender_.SetFecParameters(delta_params, key_params);
+  RTC_DCHECK(delta_params);
+  RTC_DCHECK(key_params);
+  // The caller has no feedback on how the losses are distributed, so the
+  // random masks it asks for are replaced by bursty ones when the NACKed
+  // packets show that losses mostly come in runs.
+  FecMaskType mask_type;
+  {
+    rtc::CritScope cs(&critical_section_loss_stats_);
+    mask_type = ProducerFec::SelectMaskType(
+        send_loss_stats_.GetSingleLossCount(),
+        send_loss_stats_.GetMultipleLossPacketCount());
+  }
+  FecProtectionParams delta = *delta_params;
+  FecProtectionParams key = *key_params;
+  if (delta.fec_mask_type == kFecMaskRandom)
+    delta.fec_mask_type = mask_type;
+  if (key.fec_mask_type == kFecMaskRandom)
+    key.fec_mask_type = mask_type;
+  return rtp_sender_.SetFecParameters(&delta, &key);
 }
 
 void ModuleRtpRtcpImpl::SetRemoteSSRC(const uint32_t ssrc) {
@@ -858,8 +885,10 @@ int32_t ModuleRtpRtcpImpl::SendRTCPReferencePictureSelection(
 
 void ModuleRtpRtcpImpl::OnReceivedNack(
     const std::vector<uint16_t>& nack_sequence_numbers) {
-  for (uint16_t nack_sequence_number : nack_sequence_numbers) {
-    send_loss_stats_.AddLostPacket(nack_sequence_number);
+  {
+    rtc::CritScope cs(&critical_section_loss_stats_);
+    for (uint16_t nack_sequence_number : nack_sequence_numbers)
+      send_loss_stats_.AddLostPacket(nack_sequence_number);
   }
   if (!rtp_sender_.StorePackets() ||
       nack_sequence_numbers.size() == 0) {
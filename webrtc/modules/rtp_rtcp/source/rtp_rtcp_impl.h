@@ -269,6 +269,8 @@ class ModuleRtpRtcpImpl : public RtpRtcp, public RTCPReceiver::ModuleRtpRtcp {
   // indication.
   int32_t SetAudioLevel(uint8_t level_d_bov) override;
 
+  void SetAudioVoiceActivity(rtc::Optional<bool> voice_activity) override;
+
   // Video part.
 
   int32_t SendRTCPSliceLossIndication(uint8_t picture_id) override;
@@ -356,8 +358,9 @@ class ModuleRtpRtcpImpl : public RtpRtcp, public RTCPReceiver::ModuleRtpRtcp {
 
   RtcpRttStats* rtt_stats_;
 
-  PacketLossStats send_loss_stats_;
-  PacketLossStats receive_loss_stats_;
+  rtc::CriticalSection critical_section_loss_stats_;
+  PacketLossStats send_loss_stats_ GUARDED_BY(critical_section_loss_stats_);
+  PacketLossStats receive_loss_stats_ GUARDED_BY(critical_section_loss_stats_);
 
   // The processed RTT from RtcpRttStats.
   rtc::CriticalSection critical_section_rtt_;
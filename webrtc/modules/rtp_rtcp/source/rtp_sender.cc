@@ -217,6 +217,7 @@ int32_t RTPSender::SetTransportSequenceNumber(uint16_t sequence_number) {
 int32_t RTPSender::RegisterRtpHeaderExtension(RTPExtensionType type,
                                               uint8_t id) {
   rtc::CritScope lock(&send_critsect_);
+  ResetPacketTemplatesLocked();
   switch (type) {
     case kRtpExtensionVideoRotation:
       video_rotation_active_ = false;
@@ -244,6 +245,7 @@ bool RTPSender::IsRtpHeaderExtensionRegistered(RTPExtensionType type) {
 
 int32_t RTPSender::DeregisterRtpHeaderExtension(RTPExtensionType type) {
   rtc::CritScope lock(&send_critsect_);
+  ResetPacketTemplatesLocked();
   return rtp_header_extension_map_.Deregister(type);
 }
 
@@ -336,6 +338,7 @@ void RTPSender::SetMaxPayloadLength(size_t max_payload_length) {
       << "Invalid max payload length: " << max_payload_length;
   rtc::CritScope lock(&send_critsect_);
   max_payload_length_ = max_payload_length;
+  ResetPacketTemplatesLocked();
 }
 
 size_t RTPSender::MaxDataPayloadLength() const {
@@ -610,9 +613,15 @@ size_t RTPSender::DeprecatedSendPadData(size_t bytes,
         payload_type = rtx_payload_type_map_.begin()->second;
         over_rtx = true;
       }
+      if (!padding_template_) {
+        padding_template_.reset(
+            new RtpPacketToSend(&rtp_header_extension_map_, IP_PACKET_SIZE));
+        padding_template_->ReserveExtension<AbsoluteSendTime>();
+        padding_template_->ReserveExtension<TransportSequenceNumber>();
+      }
     }
 
-    RtpPacketToSend padding_packet(&rtp_header_extension_map_, IP_PACKET_SIZE);
+    RtpPacketToSend padding_packet(*padding_template_);
     padding_packet.SetPayloadType(payload_type);
     padding_packet.SetMarker(false);
     padding_packet.SetSequenceNumber(sequence_number);
@@ -733,6 +742,7 @@ void RTPSender::OnReceivedNack(
   TRACE_EVENT2(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
                "RTPSender::OnReceivedNACK", "num_seqnum",
                nack_sequence_numbers.size(), "avg_rtt", avg_rtt);
+  packet_history_.SetRtt(avg_rtt);
   for (uint16_t seq_no : nack_sequence_numbers) {
     const int32_t bytes_sent = ReSendPacket(seq_no, 5 + avg_rtt);
     if (bytes_sent < 0) {
@@ -1085,17 +1095,28 @@ size_t RTPSender::CreateRtpHeader(uint8_t* header,
 
 std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   rtc::CritScope lock(&send_critsect_);
+  if (!packet_template_) {
+    packet_template_.reset(
+        new RtpPacketToSend(&rtp_header_extension_map_, max_payload_length_));
+    packet_template_->SetCsrcs(csrcs_);
+    // Reserve extensions, if registered, RtpSender set in SendToNetwork.
+    packet_template_->ReserveExtension<AbsoluteSendTime>();
+    packet_template_->ReserveExtension<TransmissionOffset>();
+    packet_template_->ReserveExtension<TransportSequenceNumber>();
+  }
+  // The copy shares the template's buffer until the first write to it, which
+  // the ssrc is.
   std::unique_ptr<RtpPacketToSend> packet(
-      new RtpPacketToSend(&rtp_header_extension_map_, max_payload_length_));
+      new RtpPacketToSend(*packet_template_));
   packet->SetSsrc(ssrc_);
-  packet->SetCsrcs(csrcs_);
-  // Reserve extensions, if registered, RtpSender set in SendToNetwork.
-  packet->ReserveExtension<AbsoluteSendTime>();
-  packet->ReserveExtension<TransmissionOffset>();
-  packet->ReserveExtension<TransportSequenceNumber>();
   return packet;
 }
 
+void RTPSender::ResetPacketTemplatesLocked() {
+  packet_template_.reset();
+  padding_template_.reset();
+}
+
 bool RTPSender::AssignSequenceNumber(RtpPacketToSend* packet) {
   rtc::CritScope lock(&send_critsect_);
   if (!sending_media_)
@@ -1608,6 +1629,7 @@ void RTPSender::SetCsrcs(const std::vector<uint32_t>& csrcs) {
   assert(csrcs.size() <= kRtpCsrcSize);
   rtc::CritScope lock(&send_critsect_);
   csrcs_ = csrcs;
+  ResetPacketTemplatesLocked();
 }
 
 void RTPSender::SetSequenceNumber(uint16_t seq) {
@@ -1642,6 +1664,11 @@ int32_t RTPSender::SetAudioLevel(uint8_t level_d_bov) {
   return audio_->SetAudioLevel(level_d_bov);
 }
 
+void RTPSender::SetAudioVoiceActivity(rtc::Optional<bool> voice_activity) {
+  RTC_DCHECK(audio_configured_);
+  audio_->SetAudioVoiceActivity(voice_activity);
+}
+
 RtpVideoCodecTypes RTPSender::VideoCodecType() const {
   assert(!audio_configured_ && "Sender is an audio stream!");
   return video_->VideoCodecType();
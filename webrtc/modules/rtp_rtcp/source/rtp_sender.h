@@ -19,6 +19,7 @@
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/deprecation.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/base/random.h"
 #include "webrtc/base/rate_statistics.h"
 #include "webrtc/base/thread_annotations.h"
@@ -205,7 +206,8 @@ class RTPSender {
   void SetRtxPayloadType(int payload_type, int associated_payload_type);
 
   // Create empty packet, fills ssrc, csrcs and reserve place for header
-  // extensions RtpSender updates before sending.
+  // extensions RtpSender updates before sending. The packet is copied from a
+  // template kept until the csrcs, extensions or max payload length change.
   std::unique_ptr<RtpPacketToSend> AllocatePacket() const;
   // Allocate sequence number for provided packet.
   // Save packet's fields to generate padding that doesn't break media stream.
@@ -256,6 +258,10 @@ class RTPSender {
   // header-extension-for-audio-level-indication.
   int32_t SetAudioLevel(uint8_t level_d_bov);
 
+  // Store the voice activity for the V flag of the
+  // header-extension-for-audio-level-indication.
+  void SetAudioVoiceActivity(rtc::Optional<bool> voice_activity);
+
   RtpVideoCodecTypes VideoCodecType() const;
 
   uint32_t MaxConfiguredBitrateVideo() const;
@@ -331,6 +337,8 @@ class RTPSender {
   bool SendPacketToNetwork(const RtpPacketToSend& packet,
                            const PacketOptions& options);
 
+  void ResetPacketTemplatesLocked() EXCLUSIVE_LOCKS_REQUIRED(send_critsect_);
+
   void UpdateDelayStatistics(int64_t capture_time_ms, int64_t now_ms);
   void UpdateOnSendPacket(int packet_id,
                           int64_t capture_time_ms,
@@ -382,6 +390,12 @@ class RTPSender {
   std::map<int8_t, RtpUtility::Payload*> payload_type_map_;
 
   RtpHeaderExtensionMap rtp_header_extension_map_ GUARDED_BY(send_critsect_);
+  // Headers, with extensions reserved, that media and padding packets are
+  // copied from; built on first use and reset when what they hold changes.
+  mutable std::unique_ptr<RtpPacketToSend> packet_template_
+      GUARDED_BY(send_critsect_);
+  std::unique_ptr<RtpPacketToSend> padding_template_
+      GUARDED_BY(send_critsect_);
   int32_t transmission_time_offset_;
   uint32_t absolute_send_time_;
   VideoRotation rotation_;
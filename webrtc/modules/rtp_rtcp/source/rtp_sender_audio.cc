@@ -159,11 +159,13 @@ bool RTPSenderAudio::SendAudio(FrameType frame_type,
   uint16_t dtmf_length_ms = 0;
   uint8_t key = 0;
   uint8_t audio_level_dbov;
+  rtc::Optional<bool> voice_activity;
   int8_t dtmf_payload_type;
   uint16_t packet_size_samples;
   {
     rtc::CritScope cs(&send_audio_critsect_);
     audio_level_dbov = audio_level_dbov_;
+    voice_activity = voice_activity_;
     dtmf_payload_type = dtmf_payload_type_;
     packet_size_samples = packet_size_samples_;
   }
@@ -252,8 +254,9 @@ bool RTPSenderAudio::SendAudio(FrameType frame_type,
   packet->SetTimestamp(rtp_timestamp);
   packet->set_capture_time_ms(clock_->TimeInMilliseconds());
   // Update audio level extension, if included.
-  packet->SetExtension<AudioLevel>(frame_type == kAudioFrameSpeech,
-                                   audio_level_dbov);
+  packet->SetExtension<AudioLevel>(
+      frame_type == kAudioFrameSpeech && voice_activity.value_or(true),
+      audio_level_dbov);
 
   if (fragmentation && fragmentation->fragmentationVectorSize > 0) {
     // Use the fragment info if we have one.
@@ -299,6 +302,11 @@ int32_t RTPSenderAudio::SetAudioLevel(uint8_t level_dbov) {
   return 0;
 }
 
+void RTPSenderAudio::SetAudioVoiceActivity(rtc::Optional<bool> voice_activity) {
+  rtc::CritScope cs(&send_audio_critsect_);
+  voice_activity_ = voice_activity;
+}
+
 // Send a TelephoneEvent tone using RFC 2833 (4733)
 int32_t RTPSenderAudio::SendTelephoneEvent(uint8_t key,
                                            uint16_t time_ms,
@@ -14,6 +14,7 @@
 #include "webrtc/common_types.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/onetimeevent.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/modules/rtp_rtcp/source/dtmf_queue.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_sender.h"
@@ -50,6 +51,11 @@ class RTPSenderAudio : public DTMFqueue {
   // Valid range is [0,100]. Actual value is negative.
   int32_t SetAudioLevel(uint8_t level_dbov);
 
+  // Store the voice activity for the V flag of the
+  // header-extension-for-audio-level-indication. If not set, the flag follows
+  // the frame type.
+  void SetAudioVoiceActivity(rtc::Optional<bool> voice_activity);
+
   // Send a DTMF tone using RFC 2833 (4733)
   int32_t SendTelephoneEvent(uint8_t key, uint16_t time_ms, uint8_t level);
 
@@ -95,6 +101,7 @@ class RTPSenderAudio : public DTMFqueue {
   // Audio level indication.
   // (https://datatracker.ietf.org/doc/draft-lennox-avt-rtp-audio-level-exthdr/)
   uint8_t audio_level_dbov_ GUARDED_BY(send_audio_critsect_);
+  rtc::Optional<bool> voice_activity_ GUARDED_BY(send_audio_critsect_);
   OneTimeEvent first_packet_sent_;
 };
 
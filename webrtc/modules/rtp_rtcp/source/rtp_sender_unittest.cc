@@ -14,7 +14,9 @@
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/buffer.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/rate_limiter.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/call/mock/mock_rtc_event_log.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_cvo.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
@@ -1628,6 +1630,55 @@ TEST_F(RtpSenderAudioTest, SendAudioWithAudioLevelExtension) {
                       sizeof(extension)));
 }
 
+TEST_F(RtpSenderAudioTest, AudioLevelExtensionUsesVoiceActivity) {
+  EXPECT_EQ(0, rtp_sender_->SetAudioLevel(kAudioLevel));
+  EXPECT_EQ(0, rtp_sender_->RegisterRtpHeaderExtension(kRtpExtensionAudioLevel,
+                                                       kAudioLevelExtensionId));
+
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "PAYLOAD_NAME";
+  const uint8_t payload_type = 127;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, payload_type, 48000,
+                                            0, 1500));
+  uint8_t payload[] = {47, 11, 32, 93, 89};
+
+  // Returns the data byte of the audio level extension of the last packet,
+  // holding the V flag in its most significant bit.
+  auto last_audio_level_byte = [this]() {
+    RtpUtility::RtpHeaderParser rtp_parser(transport_.last_sent_packet_,
+                                           transport_.last_sent_packet_len_);
+    webrtc::RTPHeader rtp_header;
+    EXPECT_TRUE(rtp_parser.Parse(&rtp_header));
+    const uint8_t* payload_data =
+        GetPayloadData(rtp_header, transport_.last_sent_packet_);
+    // Skip the padding and the data byte.
+    return *(payload_data - 3);
+  };
+
+  // Without a voice activity, the flag follows the frame type.
+  ASSERT_TRUE(rtp_sender_->SendOutgoingData(
+      kAudioFrameSpeech, payload_type, 1234, 4321, payload, sizeof(payload),
+      nullptr, nullptr, nullptr));
+  EXPECT_EQ(0x80 | kAudioLevel, last_audio_level_byte());
+
+  rtp_sender_->SetAudioVoiceActivity(rtc::Optional<bool>(false));
+  ASSERT_TRUE(rtp_sender_->SendOutgoingData(
+      kAudioFrameSpeech, payload_type, 1235, 4322, payload, sizeof(payload),
+      nullptr, nullptr, nullptr));
+  EXPECT_EQ(kAudioLevel, last_audio_level_byte());
+
+  rtp_sender_->SetAudioVoiceActivity(rtc::Optional<bool>(true));
+  ASSERT_TRUE(rtp_sender_->SendOutgoingData(
+      kAudioFrameSpeech, payload_type, 1236, 4323, payload, sizeof(payload),
+      nullptr, nullptr, nullptr));
+  EXPECT_EQ(0x80 | kAudioLevel, last_audio_level_byte());
+
+  // Comfort noise is never flagged as voice.
+  ASSERT_TRUE(rtp_sender_->SendOutgoingData(
+      kAudioFrameCN, payload_type, 1237, 4324, payload, sizeof(payload),
+      nullptr, nullptr, nullptr));
+  EXPECT_EQ(kAudioLevel, last_audio_level_byte());
+}
+
 // As RFC4733, named telephone events are carried as part of the audio stream
 // and must use the same sequence number and timestamp base as the regular
 // audio channel.
@@ -1758,6 +1809,83 @@ TEST_F(RtpSenderTestWithoutPacer, RespectsNackBitrateLimit) {
 }
 
 // Verify that all packets of a frame have CVO byte set.
+// Measures the cost of building and sending media and padding packets, and
+// of packetizing video frames, with the BWE extensions registered. Packets
+// go to a transport that drops them.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(RtpSenderTest, DISABLED_PacketizationThroughput) {
+  class NullTransport : public Transport {
+   public:
+    bool SendRtp(const uint8_t* data,
+                 size_t len,
+                 const PacketOptions& options) override {
+      ++packets_sent;
+      return true;
+    }
+    bool SendRtcp(const uint8_t* data, size_t len) override { return true; }
+    int packets_sent = 0;
+  } transport;
+  rtp_sender_.reset(new RTPSender(false, &fake_clock_, &transport, nullptr,
+                                  nullptr, nullptr, nullptr, nullptr, nullptr,
+                                  nullptr, nullptr,
+                                  &retransmission_rate_limiter_));
+  rtp_sender_->SetSendPayloadType(kPayload);
+  ASSERT_EQ(0, rtp_sender_->RegisterRtpHeaderExtension(
+                   kRtpExtensionTransmissionTimeOffset,
+                   kTransmissionTimeOffsetExtensionId));
+  ASSERT_EQ(
+      0, rtp_sender_->RegisterRtpHeaderExtension(kRtpExtensionAbsoluteSendTime,
+                                                 kAbsoluteSendTimeExtensionId));
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
+  const uint8_t kVideoPayloadType = 127;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, kVideoPayloadType,
+                                            90000, 0, 1500));
+
+  const int kPackets = 100000;
+  const size_t kPayloadSize = 1000;
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kPackets; ++i) {
+    std::unique_ptr<RtpPacketToSend> packet = rtp_sender_->AllocatePacket();
+    packet->SetPayloadType(kPayload);
+    packet->SetMarker(true);
+    packet->SetTimestamp(i * 3000);
+    packet->set_capture_time_ms(fake_clock_.TimeInMilliseconds());
+    memset(packet->AllocatePayload(kPayloadSize), i, kPayloadSize);
+    ASSERT_TRUE(rtp_sender_->AssignSequenceNumber(packet.get()));
+    ASSERT_TRUE(rtp_sender_->SendToNetwork(std::move(packet), kDontRetransmit,
+                                           RtpPacketSender::kNormalPriority));
+  }
+  int64_t media_ns = rtc::TimeNanos() - start_ns;
+
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kPackets; ++i) {
+    ASSERT_EQ(kMaxPaddingSize,
+              rtp_sender_->TimeToSendPadding(kMaxPaddingSize,
+                                             PacketInfo::kNotAProbe));
+  }
+  int64_t padding_ns = rtc::TimeNanos() - start_ns;
+
+  // About a 1080p delta frame at 2.5 Mbps and 30 fps.
+  const int kFrames = 1000;
+  std::vector<uint8_t> frame(10000, 0x55);
+  int packets_before = transport.packets_sent;
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kFrames; ++i) {
+    ASSERT_TRUE(rtp_sender_->SendOutgoingData(
+        kVideoFrameDelta, kVideoPayloadType, i * 3000,
+        fake_clock_.TimeInMilliseconds(), frame.data(), frame.size(), nullptr,
+        nullptr, nullptr));
+  }
+  int64_t video_ns = rtc::TimeNanos() - start_ns;
+  int video_packets = transport.packets_sent - packets_before;
+
+  LOG(LS_INFO) << "Media packets: " << media_ns / kPackets << " ns each"
+               << ", padding packets: " << padding_ns / kPackets
+               << " ns each, video: " << video_ns / video_packets
+               << " ns per packet (" << video_packets << " packets in "
+               << kFrames << " frames)";
+}
+
 TEST_F(RtpSenderVideoTest, SendVideoWithCVO) {
   RTPVideoHeader hdr = {0};
   hdr.rotation = kVideoRotation_90;
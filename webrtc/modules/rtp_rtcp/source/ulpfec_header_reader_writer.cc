@@ -99,6 +99,7 @@ size_t UlpfecHeaderWriter::FecHeaderSize(size_t packet_mask_size) const {
 }
 
 void UlpfecHeaderWriter::FinalizeFecHeader(
+    uint32_t /* media_ssrc */,
     uint16_t seq_num_base,
     const uint8_t* packet_mask,
     size_t packet_mask_size,
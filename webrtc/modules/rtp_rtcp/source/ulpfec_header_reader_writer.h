@@ -55,6 +55,7 @@ class UlpfecHeaderWriter : public FecHeaderWriter {
   size_t FecHeaderSize(size_t packet_mask_row_size) const override;
 
   void FinalizeFecHeader(
+      uint32_t media_ssrc,
       uint16_t seq_num_base,
       const uint8_t* packet_mask,
       size_t packet_mask_size,
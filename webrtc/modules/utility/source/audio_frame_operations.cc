@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
 #include "webrtc/base/checks.h"
@@ -39,10 +41,13 @@ int AudioFrameOperations::MonoToStereo(AudioFrame* frame) {
     return -1;
   }
 
-  int16_t data_copy[AudioFrame::kMaxDataSizeSamples];
-  memcpy(data_copy, frame->data_,
-         sizeof(int16_t) * frame->samples_per_channel_);
-  MonoToStereo(data_copy, frame->samples_per_channel_, frame->data_);
+  // Expand in place, from the back so that no sample is overwritten before it
+  // is read. This saves copying the frame to a temporary buffer.
+  for (size_t i = frame->samples_per_channel_; i > 0; i--) {
+    const int16_t sample = frame->data_[i - 1];
+    frame->data_[2 * i - 2] = sample;
+    frame->data_[2 * i - 1] = sample;
+  }
   frame->num_channels_ = 2;
 
   return 0;
@@ -140,19 +145,13 @@ int AudioFrameOperations::Scale(float left, float right, AudioFrame& frame) {
 }
 
 int AudioFrameOperations::ScaleWithSat(float scale, AudioFrame& frame) {
-  int32_t temp_data = 0;
-
-  // Ensure that the output result is saturated [-32768, +32767].
+  // Ensure that the output result is saturated [-32768, +32767]. The clamping
+  // is done without branches, so that the compiler can vectorize the loop.
   for (size_t i = 0; i < frame.samples_per_channel_ * frame.num_channels_;
        i++) {
-    temp_data = static_cast<int32_t>(scale * frame.data_[i]);
-    if (temp_data < -32768) {
-      frame.data_[i] = -32768;
-    } else if (temp_data > 32767) {
-      frame.data_[i] = 32767;
-    } else {
-      frame.data_[i] = static_cast<int16_t>(temp_data);
-    }
+    const int32_t temp_data = static_cast<int32_t>(scale * frame.data_[i]);
+    frame.data_[i] =
+        static_cast<int16_t>(std::min(std::max(temp_data, -32768), 32767));
   }
   return 0;
 }
@@ -110,6 +110,19 @@ TEST_F(AudioFrameOperationsTest, MonoToStereoSucceeds) {
   VerifyFramesAreEqual(stereo_frame, frame_);
 }
 
+TEST_F(AudioFrameOperationsTest, MonoToStereoKeepsSampleOrder) {
+  frame_.num_channels_ = 1;
+  for (size_t i = 0; i < frame_.samples_per_channel_; i++)
+    frame_.data_[i] = static_cast<int16_t>(i);
+  EXPECT_EQ(0, AudioFrameOperations::MonoToStereo(&frame_));
+
+  EXPECT_EQ(2u, frame_.num_channels_);
+  for (size_t i = 0; i < frame_.samples_per_channel_; i++) {
+    EXPECT_EQ(static_cast<int16_t>(i), GetChannelData(frame_, 0, i));
+    EXPECT_EQ(static_cast<int16_t>(i), GetChannelData(frame_, 1, i));
+  }
+}
+
 TEST_F(AudioFrameOperationsTest, StereoToMonoFailsWithBadParameters) {
   frame_.num_channels_ = 1;
   EXPECT_EQ(-1, AudioFrameOperations::StereoToMono(&frame_));
@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/utility/source/process_thread_impl.h"
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
 #include "webrtc/base/task_queue.h"
 #include "webrtc/base/timeutils.h"
@@ -34,6 +36,8 @@ int64_t GetNextCallbackTime(Module* module, int64_t time_now) {
 }
 }
 
+const size_t ProcessThreadImpl::kNotInHeap;
+
 ProcessThread::~ProcessThread() {}
 
 // static
@@ -113,8 +117,11 @@ void ProcessThreadImpl::WakeUp(Module* module) {
   {
     rtc::CritScope lock(&lock_);
     for (ModuleCallback& m : modules_) {
-      if (m.module == module)
+      if (m.module == module) {
         m.next_callback = kCallProcessImmediately;
+        if (m.heap_index != kNotInHeap)
+          MoveModuleUp(m.heap_index);
+      }
     }
   }
   wake_up_->Set();
@@ -151,6 +158,7 @@ void ProcessThreadImpl::RegisterModule(Module* module) {
   {
     rtc::CritScope lock(&lock_);
     modules_.push_back(ModuleCallback(module));
+    PushModule(&modules_.back());
   }
 
   // Wake the thread calling ProcessThreadImpl::Process() to update the
@@ -166,6 +174,17 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
 
   {
     rtc::CritScope lock(&lock_);
+    for (ModuleCallback& m : modules_) {
+      if (m.module != module)
+        continue;
+      if (m.heap_index != kNotInHeap) {
+        RemoveModule(&m);
+      } else {
+        // Deregistered from its own Process() call.
+        std::replace(due_modules_.begin(), due_modules_.end(), &m,
+                     static_cast<ModuleCallback*>(nullptr));
+      }
+    }
     modules_.remove_if([&module](const ModuleCallback& m) {
         return m.module == module;
       });
@@ -183,6 +202,18 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
   }
 }
 
+std::vector<ProcessThreadImpl::ModuleStats> ProcessThreadImpl::GetModuleStats()
+    const {
+  rtc::CritScope lock(&lock_);
+  std::vector<ModuleStats> stats;
+  for (const ModuleCallback& m : modules_) {
+    stats.push_back(ModuleStats{m.module, m.num_process_calls,
+                                m.total_process_time_us,
+                                m.max_process_time_us});
+  }
+  return stats;
+}
+
 // static
 bool ProcessThreadImpl::Run(void* obj) {
   return static_cast<ProcessThreadImpl*>(obj)->Process();
@@ -196,26 +227,55 @@ bool ProcessThreadImpl::Process() {
     rtc::CritScope lock(&lock_);
     if (stop_)
       return false;
-    for (ModuleCallback& m : modules_) {
+    // Take all modules that are due off the heap before processing them, so
+    // that each of them is processed at most once per iteration.
+    RTC_DCHECK(due_modules_.empty());
+    while (!module_heap_.empty() && module_heap_[0]->next_callback <= now) {
+      due_modules_.push_back(module_heap_[0]);
+      RemoveModule(module_heap_[0]);
+    }
+
+    // Indexed, and |m| is looked up again after Process(), since a module may
+    // deregister itself from Process().
+    for (size_t i = 0; i < due_modules_.size(); ++i) {
+      ModuleCallback* m = due_modules_[i];
+      if (!m)
+        continue;
       // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
       // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
       // operation should not require taking a lock, so querying all modules
       // should run in a matter of nanoseconds.
-      if (m.next_callback == 0)
-        m.next_callback = GetNextCallbackTime(m.module, now);
-
-      if (m.next_callback <= now ||
-          m.next_callback == kCallProcessImmediately) {
-        m.module->Process();
+      if (m->next_callback == 0)
+        m->next_callback = GetNextCallbackTime(m->module, now);
+
+      if (m->next_callback <= now ||
+          m->next_callback == kCallProcessImmediately) {
+        const int64_t start_us = rtc::TimeMicros();
+        m->module->Process();
+        const int64_t end_us = rtc::TimeMicros();
+        m = due_modules_[i];
+        if (!m)
+          continue;
+        ++m->num_process_calls;
+        m->total_process_time_us += end_us - start_us;
+        m->max_process_time_us =
+            std::max(m->max_process_time_us, end_us - start_us);
         // Use a new 'now' reference to calculate when the next callback
         // should occur.  We'll continue to use 'now' above for the baseline
         // of calculating how long we should wait, to reduce variance.
-        int64_t new_now = rtc::TimeMillis();
-        m.next_callback = GetNextCallbackTime(m.module, new_now);
+        int64_t new_now = end_us / rtc::kNumMicrosecsPerMillisec;
+        m->next_callback = GetNextCallbackTime(m->module, new_now);
       }
+    }
 
-      if (m.next_callback < next_checkpoint)
-        next_checkpoint = m.next_callback;
+    for (ModuleCallback* m : due_modules_) {
+      if (m)
+        PushModule(m);
+    }
+    due_modules_.clear();
+    if (!module_heap_.empty() &&
+        module_heap_[0]->next_callback < next_checkpoint) {
+      next_checkpoint = module_heap_[0]->next_callback;
     }
 
     while (!queue_.empty()) {
@@ -234,4 +294,64 @@ bool ProcessThreadImpl::Process() {
 
   return true;
 }
+
+void ProcessThreadImpl::PushModule(ModuleCallback* module) {
+  RTC_DCHECK_EQ(kNotInHeap, module->heap_index);
+  module->heap_index = module_heap_.size();
+  module_heap_.push_back(module);
+  MoveModuleUp(module->heap_index);
+}
+
+void ProcessThreadImpl::RemoveModule(ModuleCallback* module) {
+  const size_t index = module->heap_index;
+  RTC_DCHECK_LT(index, module_heap_.size());
+  RTC_DCHECK_EQ(module, module_heap_[index]);
+  SwapModules(index, module_heap_.size() - 1);
+  module_heap_.pop_back();
+  module->heap_index = kNotInHeap;
+  if (index < module_heap_.size()) {
+    MoveModuleUp(index);
+    MoveModuleDown(index);
+  }
+}
+
+void ProcessThreadImpl::MoveModuleUp(size_t index) {
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (module_heap_[parent]->next_callback <=
+        module_heap_[index]->next_callback) {
+      break;
+    }
+    SwapModules(index, parent);
+    index = parent;
+  }
+}
+
+void ProcessThreadImpl::MoveModuleDown(size_t index) {
+  while (true) {
+    const size_t left = 2 * index + 1;
+    const size_t right = left + 1;
+    size_t smallest = index;
+    if (left < module_heap_.size() &&
+        module_heap_[left]->next_callback <
+            module_heap_[smallest]->next_callback) {
+      smallest = left;
+    }
+    if (right < module_heap_.size() &&
+        module_heap_[right]->next_callback <
+            module_heap_[smallest]->next_callback) {
+      smallest = right;
+    }
+    if (smallest == index)
+      break;
+    SwapModules(index, smallest);
+    index = smallest;
+  }
+}
+
+void ProcessThreadImpl::SwapModules(size_t index1, size_t index2) {
+  std::swap(module_heap_[index1], module_heap_[index2]);
+  module_heap_[index1]->heap_index = index1;
+  module_heap_[index2]->heap_index = index2;
+}
 }  // namespace webrtc
@@ -14,6 +14,7 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/platform_thread.h"
@@ -38,15 +39,30 @@ class ProcessThreadImpl : public ProcessThread {
   void RegisterModule(Module* module) override;
   void DeRegisterModule(Module* module) override;
 
+  // How often the Process() method of a module has been called, and how long
+  // it took.
+  struct ModuleStats {
+    Module* module;
+    int64_t num_process_calls;
+    int64_t total_process_time_us;
+    int64_t max_process_time_us;
+  };
+
+  // Returns the stats of all registered modules, for profiling. Can be called
+  // on any thread.
+  std::vector<ModuleStats> GetModuleStats() const;
+
  protected:
   static bool Run(void* obj);
   bool Process();
 
  private:
+  // Index of a module that isn't in |module_heap_|.
+  static const size_t kNotInHeap = static_cast<size_t>(-1);
+
   struct ModuleCallback {
     ModuleCallback() : module(nullptr), next_callback(0) {}
-    ModuleCallback(const ModuleCallback& cb)
-        : module(cb.module), next_callback(cb.next_callback) {}
+    ModuleCallback(const ModuleCallback& cb) = default;
     ModuleCallback(Module* module) : module(module), next_callback(0) {}
     bool operator==(const ModuleCallback& cb) const {
       return cb.module == module;
@@ -54,6 +70,12 @@ class ProcessThreadImpl : public ProcessThread {
 
     Module* const module;
     int64_t next_callback;  // Absolute timestamp.
+    // Position in |module_heap_|, or kNotInHeap while the module is being
+    // processed.
+    size_t heap_index = kNotInHeap;
+    int64_t num_process_calls = 0;
+    int64_t total_process_time_us = 0;
+    int64_t max_process_time_us = 0;
 
    private:
     ModuleCallback& operator=(ModuleCallback&);
@@ -61,6 +83,13 @@ class ProcessThreadImpl : public ProcessThread {
 
   typedef std::list<ModuleCallback> ModuleList;
 
+  // Operations on |module_heap_|. |lock_| must be held.
+  void PushModule(ModuleCallback* module);
+  void RemoveModule(ModuleCallback* module);
+  void MoveModuleUp(size_t index);
+  void MoveModuleDown(size_t index);
+  void SwapModules(size_t index1, size_t index2);
+
   // Warning: For some reason, if |lock_| comes immediately before |modules_|
   // with the current class layout, we will  start to have mysterious crashes
   // on Mac 10.9 debug.  I (Tommi) suspect we're hitting some obscure alignemnt
@@ -75,6 +104,11 @@ class ProcessThreadImpl : public ProcessThread {
   std::unique_ptr<rtc::PlatformThread> thread_;
 
   ModuleList modules_;
+  // The modules in |modules_|, as a binary min-heap ordered by next_callback,
+  // so that Process() only has to look at the modules that are due. The
+  // modules being processed are moved to |due_modules_| in the meantime.
+  std::vector<ModuleCallback*> module_heap_;
+  std::vector<ModuleCallback*> due_modules_;
   std::queue<rtc::QueuedTask*> queue_;
   bool stop_;
   const char* thread_name_;
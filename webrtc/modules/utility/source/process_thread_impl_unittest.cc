@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -299,6 +300,45 @@ TEST(ProcessThreadImpl, WakeUp) {
   EXPECT_LE(diff, 100u);
 }
 
+// Verifies that a module that isn't due is neither processed nor asked again
+// when the thread wakes up for another module.
+TEST(ProcessThreadImpl, OnlyQueriesModulesThatAreDue) {
+  ProcessThreadImpl thread("ProcessThread");
+  std::unique_ptr<EventWrapper> event(EventWrapper::Create());
+
+  MockModule busy_module;
+  int busy_calls = 0;
+  EXPECT_CALL(busy_module, TimeUntilNextProcess()).WillRepeatedly(Return(1));
+  EXPECT_CALL(busy_module, Process())
+      .WillRepeatedly(
+          DoAll(Increment(&busy_calls), Invoke([&event, &busy_calls]() {
+                  if (busy_calls == 10)
+                    event->Set();
+                }),
+                Return()));
+  EXPECT_CALL(busy_module, ProcessThreadAttached(_)).Times(2);
+
+  MockModule idle_module;
+  EXPECT_CALL(idle_module, TimeUntilNextProcess())
+      .WillOnce(Return(60 * 1000));
+  EXPECT_CALL(idle_module, Process()).Times(0);
+  EXPECT_CALL(idle_module, ProcessThreadAttached(_)).Times(2);
+
+  thread.RegisterModule(&idle_module);
+  thread.RegisterModule(&busy_module);
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, event->Wait(kEventWaitTimeout));
+  thread.Stop();
+
+  std::vector<ProcessThreadImpl::ModuleStats> stats = thread.GetModuleStats();
+  ASSERT_EQ(2u, stats.size());
+  EXPECT_EQ(&idle_module, stats[0].module);
+  EXPECT_EQ(0, stats[0].num_process_calls);
+  EXPECT_EQ(&busy_module, stats[1].module);
+  EXPECT_EQ(busy_calls, stats[1].num_process_calls);
+  EXPECT_GE(stats[1].total_process_time_us, stats[1].max_process_time_us);
+}
+
 // Tests that we can post a task that gets run straight away on the worker
 // thread.
 TEST(ProcessThreadImpl, PostTask) {
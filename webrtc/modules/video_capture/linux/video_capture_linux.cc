@@ -20,15 +20,163 @@
 
 #include <iostream>
 #include <new>
+#include <vector>
 
+#include "webrtc/base/bind.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/base/refcount.h"
 #include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/common_video/include/video_frame_buffer.h"
 #include "webrtc/modules/video_capture/linux/video_capture_linux.h"
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/system_wrappers/include/trace.h"
 
 namespace webrtc {
 namespace videocapturemodule {
+
+namespace {
+// Number of buffers that must stay queued with the driver for a frame to be
+// delivered without a copy. Frames wrapping the other buffers may be held
+// downstream, e.g. by the encoder, without starving the device.
+const int kMinQueuedBuffers = 2;
+}  // namespace
+
+// The mmap'ed capture buffers of a V4L2 device. I420 frames are delivered
+// wrapping these buffers, and each such frame holds a reference to the pool
+// until it's released and its buffer is queued with the driver again. The
+// buffers are unmapped when the last reference goes away, which may be after
+// capture has stopped.
+class V4L2BufferPool : public rtc::RefCountInterface
+{
+public:
+    V4L2BufferPool(int32_t id, int deviceFd)
+        : _id(id), _deviceFd(deviceFd), _numQueued(0) {}
+
+    // Maps the |count| buffers of the device and queues them.
+    bool MapBuffers(int count);
+    // Stops queueing buffers, before the device is closed.
+    void Stop();
+
+    // Dequeues a filled buffer into |buffer|.
+    bool Dequeue(struct v4l2_buffer* buffer);
+    // Queues the buffer |index| with the device again, unless capture has
+    // stopped.
+    void Queue(uint32_t index);
+
+    uint8_t* Data(uint32_t index) const
+    {
+        return static_cast<uint8_t*>(_buffers[index].start);
+    }
+    int NumQueued() const
+    {
+        rtc::CritScope cs(&_crit);
+        return _numQueued;
+    }
+
+protected:
+    ~V4L2BufferPool() override;
+
+private:
+    struct Buffer
+    {
+        void *start;
+        size_t length;
+    };
+
+    const int32_t _id;
+    rtc::CriticalSection _crit;
+    int _deviceFd GUARDED_BY(_crit);
+    int _numQueued GUARDED_BY(_crit);
+    // Only changed by MapBuffers(), before any frame is delivered.
+    std::vector<Buffer> _buffers;
+};
+
+bool V4L2BufferPool::MapBuffers(int count)
+{
+    rtc::CritScope cs(&_crit);
+    for (int i = 0; i < count; i++)
+    {
+        struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(v4l2_buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i;
+
+        if (ioctl(_deviceFd, VIDIOC_QUERYBUF, &buffer) < 0)
+        {
+            return false;
+        }
+
+        void* start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, _deviceFd, buffer.m.offset);
+        if (MAP_FAILED == start)
+        {
+            return false;
+        }
+        _buffers.push_back(Buffer{start, buffer.length});
+
+        if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) < 0)
+        {
+            return false;
+        }
+        _numQueued++;
+    }
+    return true;
+}
+
+void V4L2BufferPool::Stop()
+{
+    rtc::CritScope cs(&_crit);
+    _deviceFd = -1;
+}
+
+bool V4L2BufferPool::Dequeue(struct v4l2_buffer* buffer)
+{
+    rtc::CritScope cs(&_crit);
+    memset(buffer, 0, sizeof(struct v4l2_buffer));
+    buffer->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer->memory = V4L2_MEMORY_MMAP;
+    // dequeue a buffer - repeat until dequeued properly!
+    while (ioctl(_deviceFd, VIDIOC_DQBUF, buffer) < 0)
+    {
+        if (errno != EINTR)
+        {
+            WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
+                         "could not sync on a buffer on device %s",
+                         strerror(errno));
+            return false;
+        }
+    }
+    _numQueued--;
+    return true;
+}
+
+void V4L2BufferPool::Queue(uint32_t index)
+{
+    rtc::CritScope cs(&_crit);
+    if (_deviceFd == -1)
+        return;
+    struct v4l2_buffer buffer;
+    memset(&buffer, 0, sizeof(v4l2_buffer));
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    buffer.index = index;
+    if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) == -1)
+    {
+        WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture, _id,
+                     "Failed to enqueue capture buffer");
+        return;
+    }
+    _numQueued++;
+}
+
+V4L2BufferPool::~V4L2BufferPool()
+{
+    // unmap buffers
+    for (const Buffer& buffer : _buffers)
+        munmap(buffer.start, buffer.length);
+}
+
 rtc::scoped_refptr<VideoCaptureModule> VideoCaptureImpl::Create(
     const int32_t id,
     const char* deviceUniqueId) {
@@ -46,13 +194,11 @@ VideoCaptureModuleV4L2::VideoCaptureModuleV4L2(const int32_t id)
       _captureCritSect(CriticalSectionWrapper::CreateCriticalSection()),
       _deviceId(-1),
       _deviceFd(-1),
-      _buffersAllocatedByDevice(-1),
       _currentWidth(-1),
       _currentHeight(-1),
       _currentFrameRate(-1),
       _captureStarted(false),
-      _captureVideoType(kVideoI420),
-      _pool(NULL)
+      _captureVideoType(kVideoI420)
 {
 }
 
@@ -338,51 +484,23 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers()
     if (rbuffer.count > kNoOfV4L2Bufffers)
         rbuffer.count = kNoOfV4L2Bufffers;
 
-    _buffersAllocatedByDevice = rbuffer.count;
-
     //Map the buffers
-    _pool = new Buffer[rbuffer.count];
-
-    for (unsigned int i = 0; i < rbuffer.count; i++)
+    _pool = new rtc::RefCountedObject<V4L2BufferPool>(_id, _deviceFd);
+    if (!_pool->MapBuffers(rbuffer.count))
     {
-        struct v4l2_buffer buffer;
-        memset(&buffer, 0, sizeof(v4l2_buffer));
-        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buffer.memory = V4L2_MEMORY_MMAP;
-        buffer.index = i;
-
-        if (ioctl(_deviceFd, VIDIOC_QUERYBUF, &buffer) < 0)
-        {
-            return false;
-        }
-
-        _pool[i].start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED,
-                              _deviceFd, buffer.m.offset);
-
-        if (MAP_FAILED == _pool[i].start)
-        {
-            for (unsigned int j = 0; j < i; j++)
-                munmap(_pool[j].start, _pool[j].length);
-            return false;
-        }
-
-        _pool[i].length = buffer.length;
-
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) < 0)
-        {
-            return false;
-        }
+        _pool->Stop();
+        _pool = nullptr;
+        return false;
     }
     return true;
 }
 
 bool VideoCaptureModuleV4L2::DeAllocateVideoBuffers()
 {
-    // unmap buffers
-    for (int i = 0; i < _buffersAllocatedByDevice; i++)
-        munmap(_pool[i].start, _pool[i].length);
-
-    delete[] _pool;
+    // Frames wrapping the buffers may still be in use; they are unmapped when
+    // the last of them is released.
+    _pool->Stop();
+    _pool = nullptr;
 
     // turn off stream
     enum v4l2_buf_type type;
@@ -441,33 +559,42 @@ bool VideoCaptureModuleV4L2::CaptureProcess()
     if (_captureStarted)
     {
         struct v4l2_buffer buf;
-        memset(&buf, 0, sizeof(struct v4l2_buffer));
-        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-        buf.memory = V4L2_MEMORY_MMAP;
-        // dequeue a buffer - repeat until dequeued properly!
-        while (ioctl(_deviceFd, VIDIOC_DQBUF, &buf) < 0)
+        if (!_pool->Dequeue(&buf))
         {
-            if (errno != EINTR)
-            {
-                WEBRTC_TRACE(webrtc::kTraceError, webrtc::kTraceVideoCapture, _id,
-                           "could not sync on a buffer on device %s", strerror(errno));
-                _captureCritSect->Leave();
-                return true;
-            }
+            _captureCritSect->Leave();
+            return true;
         }
-        VideoCaptureCapability frameInfo;
-        frameInfo.width = _currentWidth;
-        frameInfo.height = _currentHeight;
-        frameInfo.rawType = _captureVideoType;
-
-        // convert to to I420 if needed
-        IncomingFrame((unsigned char*) _pool[buf.index].start,
-                      buf.bytesused, frameInfo);
-        // enqueue the buffer again
-        if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1)
+
+        if (_captureVideoType == kVideoI420 &&
+            buf.bytesused ==
+                CalcBufferSize(kI420, _currentWidth, _currentHeight) &&
+            _pool->NumQueued() >= kMinQueuedBuffers)
+        {
+            // Deliver the buffer as it is. It's queued again when the last
+            // frame referring to it is released.
+            const int strideUV = (_currentWidth + 1) / 2;
+            uint8_t* dataY = _pool->Data(buf.index);
+            uint8_t* dataU = dataY + _currentWidth * _currentHeight;
+            uint8_t* dataV = dataU + strideUV * ((_currentHeight + 1) / 2);
+            IncomingFrameBuffer(
+                new rtc::RefCountedObject<WrappedI420Buffer>(
+                    _currentWidth, _currentHeight, dataY, _currentWidth, dataU,
+                    strideUV, dataV, strideUV,
+                    rtc::Bind(&V4L2BufferPool::Queue, _pool.get(),
+                              buf.index)),
+                0);
+        }
+        else
         {
-            WEBRTC_TRACE(webrtc::kTraceWarning, webrtc::kTraceVideoCapture, _id,
-                       "Failed to enqueue capture buffer");
+            VideoCaptureCapability frameInfo;
+            frameInfo.width = _currentWidth;
+            frameInfo.height = _currentHeight;
+            frameInfo.rawType = _captureVideoType;
+
+            // convert to to I420 if needed
+            IncomingFrame(_pool->Data(buf.index), buf.bytesused, frameInfo);
+            // enqueue the buffer again
+            _pool->Queue(buf.index);
         }
     }
     _captureCritSect->Leave();
@@ -14,6 +14,7 @@
 #include <memory>
 
 #include "webrtc/base/platform_thread.h"
+#include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/video_capture/video_capture_impl.h"
 
@@ -22,6 +23,8 @@ namespace webrtc
 class CriticalSectionWrapper;
 namespace videocapturemodule
 {
+class V4L2BufferPool;
+
 class VideoCaptureModuleV4L2: public VideoCaptureImpl
 {
 public:
@@ -48,18 +51,12 @@ private:
     int32_t _deviceId;
     int32_t _deviceFd;
 
-    int32_t _buffersAllocatedByDevice;
     int32_t _currentWidth;
     int32_t _currentHeight;
     int32_t _currentFrameRate;
     bool _captureStarted;
     RawVideoType _captureVideoType;
-    struct Buffer
-    {
-        void *start;
-        size_t length;
-    };
-    Buffer *_pool;
+    rtc::scoped_refptr<V4L2BufferPool> _pool;
 };
 }  // namespace videocapturemodule
 }  // namespace webrtc
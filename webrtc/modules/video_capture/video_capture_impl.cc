@@ -309,6 +309,26 @@ int32_t VideoCaptureImpl::IncomingFrame(
     return 0;
 }
 
+int32_t VideoCaptureImpl::IncomingFrameBuffer(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+    int64_t captureTime) {
+  CriticalSectionScoped cs(&_apiCs);
+  CriticalSectionScoped cs2(&_callBackCs);
+
+  TRACE_EVENT1("webrtc", "VC::IncomingFrameBuffer", "capture_time",
+               captureTime);
+
+  // SetApplyRotation doesn't take any lock. Make a local copy here.
+  const bool apply_rotation = apply_rotation_;
+  VideoFrame captureFrame(
+      apply_rotation ? I420Buffer::Rotate(buffer, _rotateFrame) : buffer, 0,
+      rtc::TimeMillis(), apply_rotation ? kVideoRotation_0 : _rotateFrame);
+  captureFrame.set_ntp_time_ms(captureTime);
+
+  DeliverCapturedFrame(captureFrame);
+  return 0;
+}
+
 int32_t VideoCaptureImpl::SetCaptureRotation(VideoRotation rotation) {
   CriticalSectionScoped cs(&_apiCs);
   CriticalSectionScoped cs2(&_callBackCs);
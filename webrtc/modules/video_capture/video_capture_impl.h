@@ -107,6 +107,11 @@ protected:
     VideoCaptureImpl(const int32_t id);
     virtual ~VideoCaptureImpl();
     int32_t DeliverCapturedFrame(VideoFrame& captureFrame);
+    // Like IncomingFrame(), for frames that are already I420. |buffer| is
+    // delivered without a copy unless the frame has to be rotated.
+    int32_t IncomingFrameBuffer(
+        const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+        int64_t captureTime);
 
     int32_t _id; // Module ID
     char* _deviceUniqueId; // current Device unique name;
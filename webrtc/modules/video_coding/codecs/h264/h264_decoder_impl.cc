@@ -34,6 +34,9 @@ const AVPixelFormat kPixelFormat = AV_PIX_FMT_YUV420P;
 const size_t kYPlaneIndex = 0;
 const size_t kUPlaneIndex = 1;
 const size_t kVPlaneIndex = 2;
+// Slice threading only helps as far as the encoder splits frames into slices,
+// which the OpenH264 encoder does for up to 8 threads.
+const int kMaxDecoderThreads = 8;
 
 // Used by histograms. Values of entries should not be changed.
 enum H264DecoderImplEvent {
@@ -84,6 +87,16 @@ void InitializeFFmpeg() {
 
 #endif  // defined(WEBRTC_INITIALIZE_FFMPEG)
 
+int NumberOfThreads(int number_of_cores) {
+#if defined(WEBRTC_MAC) && defined(WEBRTC_CHROMIUM_BUILD)
+  // Like the encoder, stay single threaded in the Chromium sandbox on Mac, see
+  // crbug.com/583348.
+  return 1;
+#else
+  return std::max(1, std::min(number_of_cores, kMaxDecoderThreads));
+#endif
+}
+
 }  // namespace
 
 int H264DecoderImpl::AVGetBuffer2(
@@ -231,9 +244,11 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
   av_context_->extradata = nullptr;
   av_context_->extradata_size = 0;
 
-  // If this is ever increased, look at |av_context_->thread_safe_callbacks| and
-  // make it possible to disable the thread checker in the frame buffer pool.
-  av_context_->thread_count = 1;
+  // Slice threading decodes the slices of a frame in parallel without adding
+  // any delay, and |get_buffer2| is still only called on the decoding thread.
+  // Frame threading would delay output by one frame per thread and needs
+  // |av_context_->thread_safe_callbacks| and a thread-safe buffer pool.
+  av_context_->thread_count = NumberOfThreads(number_of_cores);
   av_context_->thread_type = FF_THREAD_SLICE;
 
   // Function used by FFmpeg to get buffers to store decoded frames in.
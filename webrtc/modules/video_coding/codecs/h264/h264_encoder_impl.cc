@@ -36,18 +36,21 @@ enum H264EncoderImplEvent {
 };
 
 int NumberOfThreads(int width, int height, int number_of_cores) {
+#if defined(WEBRTC_MAC) && defined(WEBRTC_CHROMIUM_BUILD)
   // TODO(hbos): In Chromium, multiple threads do not work with sandbox on Mac,
   // see crbug.com/583348. Until further investigated, only use one thread.
-//  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
-//    return 8;  // 8 threads for 1080p on high perf machines.
-//  } else if (width * height > 1280 * 960 && number_of_cores >= 6) {
-//    return 3;  // 3 threads for 1080p.
-//  } else if (width * height > 640 * 480 && number_of_cores >= 3) {
-//    return 2;  // 2 threads for qHD/HD.
-//  } else {
-//    return 1;  // 1 thread for VGA or less.
-//  }
   return 1;
+#else
+  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
+    return 8;  // 8 threads for 1080p on high perf machines.
+  } else if (width * height > 1280 * 960 && number_of_cores >= 6) {
+    return 3;  // 3 threads for 1080p.
+  } else if (width * height > 640 * 480 && number_of_cores >= 3) {
+    return 2;  // 2 threads for qHD/HD.
+  } else {
+    return 1;  // 1 thread for VGA or less.
+  }
+#endif
 }
 
 FrameType ConvertToVideoFrameType(EVideoFrameType type) {
@@ -70,8 +73,8 @@ FrameType ConvertToVideoFrameType(EVideoFrameType type) {
 
 // Helper method used by H264EncoderImpl::Encode.
 // Copies the encoded bytes from |info| to |encoded_image| and updates the
-// fragmentation information of |frag_header|. The |encoded_image->_buffer| may
-// be deleted and reallocated if a bigger buffer is required.
+// fragmentation information of |frag_header|. The |encoded_image->_buffer| is
+// taken from |buffer_pool|, with a bigger size if required.
 //
 // After OpenH264 encoding, the encoded bytes are stored in |info| spread out
 // over a number of layers and "NAL units". Each NAL unit is a fragment starting
@@ -80,7 +83,7 @@ FrameType ConvertToVideoFrameType(EVideoFrameType type) {
 // is updated to point to each fragment, with offsets and lengths set as to
 // exclude the start codes.
 static void RtpFragmentize(EncodedImage* encoded_image,
-                           std::unique_ptr<uint8_t[]>* encoded_image_buffer,
+                           EncodedImageBufferPool* buffer_pool,
                            const VideoFrameBuffer& frame_buffer,
                            SFrameBSInfo* info,
                            RTPFragmentationHeader* frag_header) {
@@ -111,9 +114,13 @@ static void RtpFragmentize(EncodedImage* encoded_image,
                       << ", encoded bytes: " << required_size << ".";
       encoded_image->_size = required_size;
     }
-    encoded_image->_buffer = new uint8_t[encoded_image->_size];
-    encoded_image_buffer->reset(encoded_image->_buffer);
   }
+  // Drop the buffer of the previous frame before taking one from the pool, so
+  // that it is reused unless a consumer still holds it.
+  encoded_image->shared_buffer_ = nullptr;
+  encoded_image->shared_buffer_ =
+      buffer_pool->CreateBuffer(encoded_image->_size);
+  encoded_image->_buffer = encoded_image->shared_buffer_->data();
 
   // Iterate layers and NAL units, note each NAL unit as a fragment and copy
   // the data to |encoded_image->_buffer|.
@@ -222,10 +229,9 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* codec_settings,
                                &video_format);
 
   // Initialize encoded image. Default buffer size: size of unencoded data.
+  // The buffer itself is taken from the pool per frame.
   encoded_image_._size = CalcBufferSize(
       kI420, codec_settings_.width, codec_settings_.height);
-  encoded_image_._buffer = new uint8_t[encoded_image_._size];
-  encoded_image_buffer_.reset(encoded_image_._buffer);
   encoded_image_._completeFrame = true;
   encoded_image_._encodedWidth = 0;
   encoded_image_._encodedHeight = 0;
@@ -240,7 +246,8 @@ int32_t H264EncoderImpl::Release() {
     openh264_encoder_ = nullptr;
   }
   encoded_image_._buffer = nullptr;
-  encoded_image_buffer_.reset();
+  encoded_image_.shared_buffer_ = nullptr;
+  encoded_buffer_pool_.Release();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -358,7 +365,7 @@ int32_t H264EncoderImpl::Encode(const VideoFrame& input_frame,
 
   // Split encoded image up into fragments. This also updates |encoded_image_|.
   RTPFragmentationHeader frag_header;
-  RtpFragmentize(&encoded_image_, &encoded_image_buffer_, *frame_buffer, &info,
+  RtpFragmentize(&encoded_image_, &encoded_buffer_pool_, *frame_buffer, &info,
                  &frag_header);
 
   // Encoder can skip frames to save bandwidth in which case
@@ -439,7 +446,9 @@ SEncParamExt H264EncoderImpl::CreateEncoderParams() const {
       encoder_params.iTargetBitrate;
   encoder_params.sSpatialLayers[0].iMaxSpatialBitrate =
       encoder_params.iMaxBitrate;
-  // Slice num according to number of threads.
+  // Slice num according to number of threads, so that each thread encodes its
+  // own slice. The RTP packetizer fragments slices that don't fit a packet, so
+  // the slice size doesn't have to be limited.
   encoder_params.sSpatialLayers[0].sSliceCfg.uiSliceMode = SM_AUTO_SLICE;
 
   return encoder_params;
@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 
+#include "webrtc/common_video/include/encoded_image_buffer.h"
 #include "webrtc/modules/video_coding/codecs/h264/include/h264.h"
 #include "webrtc/modules/video_coding/utility/h264_bitstream_parser.h"
 #include "webrtc/modules/video_coding/utility/quality_scaler.h"
@@ -74,7 +75,7 @@ class H264EncoderImpl : public H264Encoder {
   int32_t number_of_cores_;
 
   EncodedImage encoded_image_;
-  std::unique_ptr<uint8_t[]> encoded_image_buffer_;
+  EncodedImageBufferPool encoded_buffer_pool_;
   EncodedImageCallback* encoded_image_callback_;
 
   bool has_reported_init_;
@@ -12,6 +12,7 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_CODECS_H264_H264_VIDEO_TOOLBOX_ENCODER_H_
 #define WEBRTC_MODULES_VIDEO_CODING_CODECS_H264_H264_VIDEO_TOOLBOX_ENCODER_H_
 
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/common_video/include/bitrate_adjuster.h"
 #include "webrtc/common_video/rotation.h"
@@ -88,6 +89,10 @@ class H264VideoToolboxEncoder : public H264Encoder {
   rtc::CriticalSection quality_scaler_crit_;
   QualityScaler quality_scaler_ GUARDED_BY(quality_scaler_crit_);
   H264BitstreamParser h264_bitstream_parser_;
+  // Annex B output of the last encoded frame. Like |h264_bitstream_parser_| it
+  // is only used by OnEncodedFrame(), which VideoToolbox calls serially, so it
+  // is reused for every frame instead of being reallocated.
+  rtc::Buffer encoded_buffer_;
   bool enable_scaling_;
 };  // H264VideoToolboxEncoder
 
@@ -594,19 +594,18 @@ void H264VideoToolboxEncoder::OnEncodedFrame(
   }
 
   // Convert the sample buffer into a buffer suitable for RTP packetization.
-  // TODO(tkchin): Allocate buffers through a pool.
-  std::unique_ptr<rtc::Buffer> buffer(new rtc::Buffer());
   std::unique_ptr<webrtc::RTPFragmentationHeader> header;
   {
     webrtc::RTPFragmentationHeader* header_raw;
-    bool result = H264CMSampleBufferToAnnexBBuffer(sample_buffer, is_keyframe,
-                                                   buffer.get(), &header_raw);
+    bool result = H264CMSampleBufferToAnnexBBuffer(
+        sample_buffer, is_keyframe, &encoded_buffer_, &header_raw);
     header.reset(header_raw);
     if (!result) {
       return;
     }
   }
-  webrtc::EncodedImage frame(buffer->data(), buffer->size(), buffer->size());
+  webrtc::EncodedImage frame(encoded_buffer_.data(), encoded_buffer_.size(),
+                             encoded_buffer_.size());
   frame._encodedWidth = width;
   frame._encodedHeight = height;
   frame._completeFrame = true;
@@ -616,7 +615,8 @@ void H264VideoToolboxEncoder::OnEncodedFrame(
   frame._timeStamp = timestamp;
   frame.rotation_ = rotation;
 
-  h264_bitstream_parser_.ParseBitstream(buffer->data(), buffer->size());
+  h264_bitstream_parser_.ParseBitstream(encoded_buffer_.data(),
+                                        encoded_buffer_.size());
   int qp;
   if (h264_bitstream_parser_.GetLastSliceQp(&qp)) {
     rtc::CritScope lock(&quality_scaler_crit_);
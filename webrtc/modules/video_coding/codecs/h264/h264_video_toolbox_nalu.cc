@@ -124,27 +124,38 @@ bool H264CMSampleBufferToAnnexBBuffer(
     CFRelease(contiguous_buffer);
     return false;
   }
-  size_t bytes_remaining = block_buffer_size;
-  while (bytes_remaining > 0) {
+  // The avcc length prefixes are as long as the Annex B start codes, so copy
+  // the whole block at once and then overwrite the prefixes in place.
+  static_assert(sizeof(kAnnexBHeaderBytes) == kAvccHeaderByteSize,
+                "Annex B start code and avcc header must be the same size");
+  const size_t block_offset = annexb_buffer->size();
+  annexb_buffer->AppendData(data_ptr, block_buffer_size);
+  CFRelease(contiguous_buffer);
+  uint8_t* const block_data = annexb_buffer->data() + block_offset;
+  size_t block_position = 0;
+  while (block_position < block_buffer_size) {
     // The size type here must match |nalu_header_size|, we expect 4 bytes.
     // Read the length of the next packet of data. Must convert from big endian
     // to host endian.
-    RTC_DCHECK_GE(bytes_remaining, (size_t)nalu_header_size);
-    uint32_t* uint32_data_ptr = reinterpret_cast<uint32_t*>(data_ptr);
-    uint32_t packet_size = CFSwapInt32BigToHost(*uint32_data_ptr);
-    // Update buffer.
-    annexb_buffer->AppendData(kAnnexBHeaderBytes, sizeof(kAnnexBHeaderBytes));
-    annexb_buffer->AppendData(data_ptr + nalu_header_size, packet_size);
+    if (block_buffer_size - block_position < kAvccHeaderByteSize) {
+      LOG(LS_ERROR) << "Truncated avcc NALU header.";
+      return false;
+    }
+    uint8_t* const nalu_header = block_data + block_position;
+    uint32_t packet_size =
+        CFSwapInt32BigToHost(*reinterpret_cast<uint32_t*>(nalu_header));
+    block_position += kAvccHeaderByteSize;
+    if (packet_size > block_buffer_size - block_position) {
+      LOG(LS_ERROR) << "Truncated avcc NALU of size " << packet_size;
+      return false;
+    }
+    memcpy(nalu_header, kAnnexBHeaderBytes, sizeof(kAnnexBHeaderBytes));
     // Update fragmentation.
     frag_offsets.push_back(nalu_offset + sizeof(kAnnexBHeaderBytes));
     frag_lengths.push_back(packet_size);
     nalu_offset += sizeof(kAnnexBHeaderBytes) + packet_size;
-
-    size_t bytes_written = packet_size + nalu_header_size;
-    bytes_remaining -= bytes_written;
-    data_ptr += bytes_written;
+    block_position += packet_size;
   }
-  RTC_DCHECK_EQ(bytes_remaining, (size_t)0);
 
   std::unique_ptr<webrtc::RTPFragmentationHeader> header;
   header.reset(new webrtc::RTPFragmentationHeader());
@@ -157,7 +168,6 @@ bool H264CMSampleBufferToAnnexBBuffer(
     header->fragmentationTimeDiff[i] = 0;
   }
   *out_header = header.release();
-  CFRelease(contiguous_buffer);
   return true;
 }
 
@@ -54,6 +54,19 @@ bool LessForBitRate(const FrameStatistic& s1, const FrameStatistic& s2) {
   return s1.bit_rate_in_kbps < s2.bit_rate_in_kbps;
 }
 
+namespace {
+
+// Returns the value that |percentile| of |values| are less than or equal to.
+int Percentile(std::vector<int>* values, float percentile) {
+  if (values->empty())
+    return 0;
+  size_t index = static_cast<size_t>(percentile * (values->size() - 1) + 0.5f);
+  std::nth_element(values->begin(), values->begin() + index, values->end());
+  return (*values)[index];
+}
+
+}  // namespace
+
 FrameStatistic& Stats::NewFrame(int frame_number) {
   assert(frame_number >= 0);
   FrameStatistic stat;
@@ -62,6 +75,24 @@ FrameStatistic& Stats::NewFrame(int frame_number) {
   return stats_[frame_number];
 }
 
+int Stats::EncodeTimePercentile(float percentile) {
+  assert(percentile >= 0.0f && percentile <= 1.0f);
+  std::vector<int> times;
+  for (const FrameStatistic& stat : stats_)
+    times.push_back(stat.encode_time_in_us);
+  return Percentile(&times, percentile);
+}
+
+int Stats::DecodeTimePercentile(float percentile) {
+  assert(percentile >= 0.0f && percentile <= 1.0f);
+  std::vector<int> times;
+  for (const FrameStatistic& stat : stats_) {
+    if (stat.decoding_successful)
+      times.push_back(stat.decode_time_in_us);
+  }
+  return Percentile(&times, percentile);
+}
+
 void Stats::PrintSummary() {
   printf("Processing summary:\n");
   if (stats_.size() == 0) {
@@ -105,6 +136,9 @@ void Stats::PrintSummary() {
 
   printf("  Average : %7d us\n",
          static_cast<int>(total_encoding_time_in_us / stats_.size()));
+  printf("  50th/90th/99th percentile: %d/%d/%d us\n",
+         EncodeTimePercentile(0.5f), EncodeTimePercentile(0.9f),
+         EncodeTimePercentile(0.99f));
 
   // DECODING
   printf("Decoding time:\n");
@@ -132,6 +166,9 @@ void Stats::PrintSummary() {
 
     printf("  Average : %7d us\n",
            static_cast<int>(total_decoding_time_in_us / decoded_frames.size()));
+    printf("  50th/90th/99th percentile: %d/%d/%d us\n",
+           DecodeTimePercentile(0.5f), DecodeTimePercentile(0.9f),
+           DecodeTimePercentile(0.99f));
     printf("  Failures: %d frames failed to decode.\n",
            static_cast<int>(stats_.size() - decoded_frames.size()));
   }
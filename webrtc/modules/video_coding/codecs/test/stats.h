@@ -61,6 +61,12 @@ class Stats {
   // processing
   void PrintSummary();
 
+  // Returns the encode time, in microseconds, that |percentile| (0.0 - 1.0) of
+  // the frames were encoded within. Returns 0 if no frames have been logged.
+  int EncodeTimePercentile(float percentile);
+  // Same as EncodeTimePercentile, for the successfully decoded frames.
+  int DecodeTimePercentile(float percentile);
+
   std::vector<FrameStatistic> stats_;
 };
 
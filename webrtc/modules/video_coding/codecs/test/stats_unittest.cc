@@ -54,5 +54,23 @@ TEST_F(StatsTest, AddMany) {
   stats_->PrintSummary();  // should not crash
 }
 
+TEST_F(StatsTest, TimePercentiles) {
+  EXPECT_EQ(0, stats_->EncodeTimePercentile(0.5f));
+  for (int i = 0; i < 101; ++i) {
+    FrameStatistic& frame_stat = stats_->NewFrame(i);
+    // Log the frames in reverse order of encode time.
+    frame_stat.encode_time_in_us = 100 - i;
+    frame_stat.decode_time_in_us = 2 * i;
+    frame_stat.decoding_successful = i % 2 == 0;
+  }
+  EXPECT_EQ(0, stats_->EncodeTimePercentile(0.0f));
+  EXPECT_EQ(50, stats_->EncodeTimePercentile(0.5f));
+  EXPECT_EQ(90, stats_->EncodeTimePercentile(0.9f));
+  EXPECT_EQ(100, stats_->EncodeTimePercentile(1.0f));
+  // Only the frames with even numbers were decoded.
+  EXPECT_EQ(100, stats_->DecodeTimePercentile(0.5f));
+  EXPECT_EQ(200, stats_->DecodeTimePercentile(1.0f));
+}
+
 }  // namespace test
 }  // namespace webrtc
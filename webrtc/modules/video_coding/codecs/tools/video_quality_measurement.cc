@@ -21,11 +21,14 @@
 
 #include "gflags/gflags.h"
 #include "webrtc/base/format_macros.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/video_coding/codecs/test/packet_manipulator.h"
 #include "webrtc/modules/video_coding/codecs/test/stats.h"
 #include "webrtc/modules/video_coding/codecs/test/videoprocessor.h"
+#include "webrtc/modules/video_coding/codecs/h264/include/h264.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
+#include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
 #include "webrtc/modules/video_coding/include/video_coding.h"
 #include "webrtc/system_wrappers/include/trace.h"
 #include "webrtc/test/testsupport/frame_reader.h"
@@ -76,6 +79,9 @@ DEFINE_string(output_filename,
               "The name of the output video file resulting of the processing "
               "of the source file. By default this is the same name as the "
               "input file with '_out' appended before the extension.");
+DEFINE_string(codec,
+              "VP8",
+              "Codec to encode and decode with: VP8, VP9 or H264.");
 DEFINE_int32(bitrate, 500, "Bit rate in kilobits/second.");
 DEFINE_int32(keyframe_interval,
              0,
@@ -86,7 +92,7 @@ DEFINE_int32(keyframe_interval,
 DEFINE_int32(temporal_layers,
              0,
              "The number of temporal layers to use "
-             "(VP8 specific codec setting). Must be 0-4.");
+             "(VP8 and VP9 specific codec setting). Must be 0-4.");
 DEFINE_int32(packet_size,
              1500,
              "Simulated network packet size in bytes (MTU). "
@@ -121,6 +127,12 @@ DEFINE_bool(python,
             "statistics as a Python script at the end of execution. "
             "Recommended to run combine with --noverbose to avoid mixing "
             "output.");
+DEFINE_bool(json,
+            false,
+            "JSON output. Enabling this will output the test configuration "
+            "and a summary of the performance and quality of the run as a "
+            "single line of JSON at the end of execution, e.g. for tracking "
+            "regressions. Recommended to run combined with --noverbose.");
 DEFINE_bool(verbose,
             true,
             "Verbose mode. Prints a lot of debugging info. "
@@ -205,8 +217,18 @@ int HandleCommandLineFlags(webrtc::test::TestConfig* config) {
   config->use_single_core = FLAGS_use_single_core;
 
   // Get codec specific configuration.
-  webrtc::VideoCodingModule::Codec(webrtc::kVideoCodecVP8,
-                                   config->codec_settings);
+  webrtc::VideoCodecType codec_type;
+  if (FLAGS_codec == "VP8") {
+    codec_type = webrtc::kVideoCodecVP8;
+  } else if (FLAGS_codec == "VP9" && webrtc::VP9Encoder::IsSupported()) {
+    codec_type = webrtc::kVideoCodecVP9;
+  } else if (FLAGS_codec == "H264" && webrtc::H264Encoder::IsSupported()) {
+    codec_type = webrtc::kVideoCodecH264;
+  } else {
+    fprintf(stderr, "Unsupported codec: %s\n", FLAGS_codec.c_str());
+    return 14;
+  }
+  webrtc::VideoCodingModule::Codec(codec_type, config->codec_settings);
 
   // Check the temporal layers.
   if (FLAGS_temporal_layers < 0 ||
@@ -215,8 +237,13 @@ int HandleCommandLineFlags(webrtc::test::TestConfig* config) {
             FLAGS_temporal_layers);
     return 13;
   }
-  config->codec_settings->codecSpecific.VP8.numberOfTemporalLayers =
-      FLAGS_temporal_layers;
+  if (codec_type == webrtc::kVideoCodecVP8) {
+    config->codec_settings->codecSpecific.VP8.numberOfTemporalLayers =
+        FLAGS_temporal_layers;
+  } else if (codec_type == webrtc::kVideoCodecVP9) {
+    config->codec_settings->codecSpecific.VP9.numberOfTemporalLayers =
+        FLAGS_temporal_layers;
+  }
 
   // Check the bit rate.
   if (FLAGS_bitrate <= 0) {
@@ -458,6 +485,51 @@ void PrintPythonOutput(const webrtc::test::TestConfig& config,
   printf("]\n");
 }
 
+// Prints the configuration and the summary of the run, as a single JSON
+// object. |wall_time_us| and |cpu_time_us| are the real and the process CPU
+// time spent processing the frames.
+void PrintJsonOutput(const webrtc::test::TestConfig& config,
+                     webrtc::test::Stats* stats,
+                     const webrtc::test::QualityMetricsResult& ssim_result,
+                     const webrtc::test::QualityMetricsResult& psnr_result,
+                     int64_t wall_time_us,
+                     int64_t cpu_time_us) {
+  const int num_frames = static_cast<int>(stats->stats_.size());
+  size_t total_encoded_bytes = 0;
+  for (const webrtc::test::FrameStatistic& f : stats->stats_)
+    total_encoded_bytes += f.encoded_frame_length_in_bytes;
+  const int64_t duration_ms =
+      num_frames * 1000 / config.codec_settings->maxFramerate;
+  const int bitrate_kbps =
+      duration_ms > 0 ? static_cast<int>(total_encoded_bytes * 8 / duration_ms)
+                      : 0;
+  const double fps = wall_time_us > 0 ? num_frames * 1e6 / wall_time_us : 0.0;
+  const int cpu_time_per_frame_us =
+      num_frames > 0 ? static_cast<int>(cpu_time_us / num_frames) : 0;
+  printf(
+      "{\"name\": \"%s\", \"codec\": \"%s\", \"width\": %d, "
+      "\"height\": %d, \"framerate\": %d, \"target_bitrate_kbps\": %d, "
+      "\"use_single_core\": %s, \"packet_loss_probability\": %f, "
+      "\"frames\": %d, \"fps\": %.2f, \"cpu_time_per_frame_us\": %d, "
+      "\"bitrate_kbps\": %d, "
+      "\"encode_time_us\": {\"p50\": %d, \"p90\": %d, \"p99\": %d}, "
+      "\"decode_time_us\": {\"p50\": %d, \"p90\": %d, \"p99\": %d}, "
+      "\"psnr\": {\"average\": %.2f, \"min\": %.2f}, "
+      "\"ssim\": {\"average\": %.4f, \"min\": %.4f}}\n",
+      config.name.c_str(),
+      webrtc::test::VideoCodecTypeToStr(config.codec_settings->codecType),
+      config.codec_settings->width, config.codec_settings->height,
+      config.codec_settings->maxFramerate, config.codec_settings->startBitrate,
+      config.use_single_core ? "true" : "false",
+      config.networking_config.packet_loss_probability, num_frames, fps,
+      cpu_time_per_frame_us, bitrate_kbps,
+      stats->EncodeTimePercentile(0.5f), stats->EncodeTimePercentile(0.9f),
+      stats->EncodeTimePercentile(0.99f), stats->DecodeTimePercentile(0.5f),
+      stats->DecodeTimePercentile(0.9f), stats->DecodeTimePercentile(0.99f),
+      psnr_result.average, psnr_result.min, ssim_result.average,
+      ssim_result.min);
+}
+
 // Runs a quality measurement on the input file supplied to the program.
 // The input file must be in YUV format.
 int main(int argc, char* argv[]) {
@@ -469,7 +541,9 @@ int main(int argc, char* argv[]) {
       " --helpshort for usage.\n"
       "Example usage:\n" +
       program_name +
-      " --input_filename=filename.yuv --width=352 --height=288\n";
+      " --input_filename=filename.yuv --width=352 --height=288\n"
+      "Run it once per resolution, bit rate, core setting and clip with "
+      "--json --noverbose to collect a benchmark matrix.\n";
   google::SetUsageMessage(usage);
 
   google::ParseCommandLineFlags(&argc, &argv, true);
@@ -487,8 +561,22 @@ int main(int argc, char* argv[]) {
 
   PrintConfigurationSummary(config);
 
-  webrtc::VP8Encoder* encoder = webrtc::VP8Encoder::Create();
-  webrtc::VP8Decoder* decoder = webrtc::VP8Decoder::Create();
+  webrtc::VideoEncoder* encoder;
+  webrtc::VideoDecoder* decoder;
+  switch (config.codec_settings->codecType) {
+    case webrtc::kVideoCodecVP9:
+      encoder = webrtc::VP9Encoder::Create();
+      decoder = webrtc::VP9Decoder::Create();
+      break;
+    case webrtc::kVideoCodecH264:
+      encoder = webrtc::H264Encoder::Create();
+      decoder = webrtc::H264Decoder::Create();
+      break;
+    default:
+      encoder = webrtc::VP8Encoder::Create();
+      decoder = webrtc::VP8Decoder::Create();
+      break;
+  }
   webrtc::test::Stats stats;
   webrtc::test::FrameReaderImpl frame_reader(config.input_filename,
                                              config.frame_length_in_bytes);
@@ -511,6 +599,8 @@ int main(int argc, char* argv[]) {
                                            config, &stats);
   processor->Init();
 
+  const int64_t start_time_us = rtc::TimeMicros();
+  const clock_t start_cpu_time = clock();
   int frame_number = 0;
   while (processor->ProcessFrame(frame_number)) {
     if (frame_number % 80 == 0) {
@@ -519,6 +609,9 @@ int main(int argc, char* argv[]) {
     Log(".");
     frame_number++;
   }
+  const int64_t wall_time_us = rtc::TimeMicros() - start_time_us;
+  const int64_t cpu_time_us = static_cast<int64_t>(clock() - start_cpu_time) *
+                              1000000 / CLOCKS_PER_SEC;
   Log("\n");
   Log("Processed %d frames\n", frame_number);
 
@@ -546,6 +639,10 @@ int main(int argc, char* argv[]) {
   if (FLAGS_python) {
     PrintPythonOutput(config, stats, ssim_result, psnr_result);
   }
+  if (FLAGS_json) {
+    PrintJsonOutput(config, &stats, ssim_result, psnr_result, wall_time_us,
+                    cpu_time_us);
+  }
   delete processor;
   delete encoder;
   delete decoder;
@@ -11,11 +11,11 @@
 #include "webrtc/modules/video_coding/codecs/vp8/simulcast_encoder_adapter.h"
 
 #include <algorithm>
-
-// NOTE(ajm): Path provided by gyp.
-#include "libyuv/scale.h"  // NOLINT
+#include <utility>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/event.h"
+#include "webrtc/common_video/include/scale_pyramid_buffer.h"
 #include "webrtc/modules/video_coding/codecs/vp8/screenshare_layers.h"
 #include "webrtc/modules/video_coding/utility/simulcast_rate_allocator.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -125,7 +125,8 @@ namespace webrtc {
 SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory)
     : factory_(factory),
       encoded_complete_callback_(nullptr),
-      implementation_name_("SimulcastEncoderAdapter") {
+      implementation_name_("SimulcastEncoderAdapter"),
+      hold_encoded_images_(false) {
   memset(&codec_, 0, sizeof(webrtc::VideoCodec));
   rate_allocator_.reset(new SimulcastRateAllocator(codec_));
 }
@@ -140,6 +141,7 @@ int SimulcastEncoderAdapter::Release() {
   // resolutions doesn't require reallocation of the first encoder, but only
   // reinitialization, which makes sense. Then Destroy this instance instead in
   // ~SimulcastEncoderAdapter().
+  encoder_queues_.clear();
   while (!streaminfos_.empty()) {
     VideoEncoder* encoder = streaminfos_.back().encoder;
     EncodedImageCallback* callback = streaminfos_.back().callback;
@@ -229,6 +231,15 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
   } else {
     implementation_name_ = implementation_name;
   }
+
+  if (doing_simulcast && number_of_cores > 1) {
+    for (int i = 0; i < number_of_streams - 1; ++i) {
+      encoder_queues_.emplace_back(
+          new rtc::TaskQueue("SimulcastEncoderQueue"));
+    }
+    rtc::CritScope lock(&pending_images_crit_);
+    pending_images_.resize(number_of_streams);
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -262,19 +273,25 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
-  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+  // The streams share the scaling work through a pyramid of the input image,
+  // scaled from the highest resolution down.
+  rtc::scoped_refptr<ScalePyramidBuffer> pyramid;
+  if (!input_image.IsZeroSize() &&
+      !input_image.video_frame_buffer()->native_handle()) {
+    pyramid = ScalePyramidBuffer::Wrap(input_image.video_frame_buffer());
+  }
+  std::vector<VideoFrame> frames(streaminfos_.size());
+  std::vector<std::vector<FrameType>> stream_frame_types(streaminfos_.size());
+  for (size_t stream_idx = streaminfos_.size(); stream_idx-- > 0;) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream)
       continue;
 
-    std::vector<FrameType> stream_frame_types;
     if (send_key_frame) {
-      stream_frame_types.push_back(kVideoFrameKey);
+      stream_frame_types[stream_idx].push_back(kVideoFrameKey);
       streaminfos_[stream_idx].key_frame_request = false;
     } else {
-      stream_frame_types.push_back(kVideoFrameDelta);
+      stream_frame_types[stream_idx].push_back(kVideoFrameDelta);
     }
 
     int dst_width = streaminfos_[stream_idx].width;
@@ -289,45 +306,87 @@ int SimulcastEncoderAdapter::Encode(
     // correctly sample/scale the source texture.
     // TODO(perkj): ensure that works going forward, and figure out how this
     // affects webrtc:5683.
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.IsZeroSize() ||
-        input_image.video_frame_buffer()->native_handle()) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          input_image, codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
+    if ((dst_width == input_image.width() &&
+         dst_height == input_image.height()) ||
+        !pyramid) {
+      frames[stream_idx] = input_image;
     } else {
-      VideoFrame dst_frame;
-      // Making sure that destination frame is of sufficient size.
-      // Aligning stride values based on width.
-      dst_frame.CreateEmptyFrame(dst_width, dst_height, dst_width,
-                                 (dst_width + 1) / 2, (dst_width + 1) / 2);
-      libyuv::I420Scale(input_image.video_frame_buffer()->DataY(),
-                        input_image.video_frame_buffer()->StrideY(),
-                        input_image.video_frame_buffer()->DataU(),
-                        input_image.video_frame_buffer()->StrideU(),
-                        input_image.video_frame_buffer()->DataV(),
-                        input_image.video_frame_buffer()->StrideV(),
-                        src_width, src_height,
-                        dst_frame.video_frame_buffer()->MutableDataY(),
-                        dst_frame.video_frame_buffer()->StrideY(),
-                        dst_frame.video_frame_buffer()->MutableDataU(),
-                        dst_frame.video_frame_buffer()->StrideU(),
-                        dst_frame.video_frame_buffer()->MutableDataV(),
-                        dst_frame.video_frame_buffer()->StrideV(),
-                        dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-      dst_frame.set_timestamp(input_image.timestamp());
-      dst_frame.set_render_time_ms(input_image.render_time_ms());
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          dst_frame, codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
+      frames[stream_idx] = VideoFrame(
+          pyramid->ScaledBuffer(dst_width, dst_height), input_image.timestamp(),
+          input_image.render_time_ms(), kVideoRotation_0);
+    }
+  }
+
+  if (!encoder_queues_.empty())
+    return EncodeInParallel(frames, codec_specific_info, stream_frame_types);
+
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    if (!streaminfos_[stream_idx].send_stream)
+      continue;
+    int ret = streaminfos_[stream_idx].encoder->Encode(
+        frames[stream_idx], codec_specific_info,
+        &stream_frame_types[stream_idx]);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
+    }
+  }
+
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int SimulcastEncoderAdapter::EncodeInParallel(
+    const std::vector<VideoFrame>& frames,
+    const CodecSpecificInfo* codec_specific_info,
+    const std::vector<std::vector<FrameType>>& frame_types) {
+  RTC_DCHECK_EQ(encoder_queues_.size() + 1, streaminfos_.size());
+  {
+    rtc::CritScope lock(&pending_images_crit_);
+    hold_encoded_images_ = true;
+  }
+
+  std::vector<int> results(streaminfos_.size(), WEBRTC_VIDEO_CODEC_OK);
+  std::vector<std::unique_ptr<rtc::Event>> encoded;
+  for (size_t stream_idx = 0; stream_idx < encoder_queues_.size();
+       ++stream_idx) {
+    if (!streaminfos_[stream_idx].send_stream)
+      continue;
+    rtc::Event* done = new rtc::Event(false, false);
+    encoded.emplace_back(done);
+    encoder_queues_[stream_idx]->PostTask([this, stream_idx, &frames,
+                                           codec_specific_info, &frame_types,
+                                           &results, done] {
+      results[stream_idx] = streaminfos_[stream_idx].encoder->Encode(
+          frames[stream_idx], codec_specific_info, &frame_types[stream_idx]);
+      done->Set();
+    });
+  }
+  size_t top_idx = streaminfos_.size() - 1;
+  if (streaminfos_[top_idx].send_stream) {
+    results[top_idx] = streaminfos_[top_idx].encoder->Encode(
+        frames[top_idx], codec_specific_info, &frame_types[top_idx]);
+  }
+  for (const auto& done : encoded)
+    done->Wait(rtc::Event::kForever);
+
+  std::vector<std::vector<std::unique_ptr<PendingImage>>> pending_images(
+      streaminfos_.size());
+  {
+    rtc::CritScope lock(&pending_images_crit_);
+    hold_encoded_images_ = false;
+    pending_images.swap(pending_images_);
+  }
+  for (const auto& stream_images : pending_images) {
+    for (const auto& pending : stream_images) {
+      encoded_complete_callback_->OnEncodedImage(
+          pending->encoded_image, &pending->codec_specific_info,
+          pending->fragmentation.get());
     }
   }
 
+  for (int ret : results) {
+    if (ret != WEBRTC_VIDEO_CODEC_OK)
+      return ret;
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -415,6 +474,32 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
   CodecSpecificInfoVP8* vp8Info = &(stream_codec_specific.codecSpecific.VP8);
   vp8Info->simulcastIdx = stream_idx;
 
+  {
+    rtc::CritScope lock(&pending_images_crit_);
+    if (hold_encoded_images_) {
+      std::unique_ptr<PendingImage> pending(new PendingImage());
+      pending->encoded_image = encodedImage;
+      // The data of a shared buffer is kept alive by the copy of the image.
+      if (!encodedImage.shared_buffer_) {
+        if (encodedImage._length > 0) {
+          pending->buffer.reset(new uint8_t[encodedImage._length]);
+          memcpy(pending->buffer.get(), encodedImage._buffer,
+                 encodedImage._length);
+        }
+        pending->encoded_image._buffer = pending->buffer.get();
+        pending->encoded_image._size = encodedImage._length;
+      }
+      pending->codec_specific_info = stream_codec_specific;
+      if (fragmentation) {
+        pending->fragmentation.reset(new RTPFragmentationHeader());
+        pending->fragmentation->CopyFrom(*fragmentation);
+      }
+      pending_images_[stream_idx].push_back(std::move(pending));
+      return EncodedImageCallback::Result(EncodedImageCallback::Result::OK,
+                                          encodedImage._timeStamp);
+    }
+  }
+
   return encoded_complete_callback_->OnEncodedImage(
       encodedImage, &stream_codec_specific, fragmentation);
 }
@@ -16,6 +16,10 @@
 #include <string>
 #include <vector>
 
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/task_queue.h"
+#include "webrtc/base/thread_annotations.h"
+#include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
 
 namespace webrtc {
@@ -33,6 +37,10 @@ class VideoEncoderFactory {
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // All the public interfaces are expected to be called from the same thread,
 // e.g the encoder thread.
+// With more than one core, the streams are encoded in parallel, each on a task
+// queue of its own except for the highest resolution stream, which is encoded
+// on the calling thread. Images encoded during Encode() are then delivered in
+// stream order, on the calling thread, before Encode() returns.
 class SimulcastEncoderAdapter : public VP8Encoder {
  public:
   explicit SimulcastEncoderAdapter(VideoEncoderFactory* factory);
@@ -93,6 +101,15 @@ class SimulcastEncoderAdapter : public VP8Encoder {
     bool send_stream;
   };
 
+  // An encoded image held back while the streams are encoded in parallel, with
+  // copies of the data it points to unless it has a shared buffer.
+  struct PendingImage {
+    EncodedImage encoded_image;
+    std::unique_ptr<uint8_t[]> buffer;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
+  };
+
   // Populate the codec settings for each stream.
   void PopulateStreamCodec(const webrtc::VideoCodec* inst,
                            int stream_index,
@@ -102,6 +119,12 @@ class SimulcastEncoderAdapter : public VP8Encoder {
 
   bool Initialized() const;
 
+  // Encodes the streams in parallel and delivers the encoded images in stream
+  // order. Returns the first error, in stream order.
+  int EncodeInParallel(const std::vector<VideoFrame>& frames,
+                       const CodecSpecificInfo* codec_specific_info,
+                       const std::vector<std::vector<FrameType>>& frame_types);
+
   std::unique_ptr<VideoEncoderFactory> factory_;
   std::unique_ptr<TemporalLayersFactory> screensharing_tl_factory_;
   VideoCodec codec_;
@@ -109,6 +132,15 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   EncodedImageCallback* encoded_complete_callback_;
   std::string implementation_name_;
   std::unique_ptr<SimulcastRateAllocator> rate_allocator_;
+  // One per stream but the highest resolution one. Empty when the streams are
+  // encoded one after another.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> encoder_queues_;
+
+  rtc::CriticalSection pending_images_crit_;
+  bool hold_encoded_images_ GUARDED_BY(pending_images_crit_);
+  // Encoded images per stream, while |hold_encoded_images_| is set.
+  std::vector<std::vector<std::unique_ptr<PendingImage>>> pending_images_
+      GUARDED_BY(pending_images_crit_);
 };
 
 }  // namespace webrtc
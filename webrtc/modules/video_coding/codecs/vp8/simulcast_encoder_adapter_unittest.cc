@@ -254,6 +254,8 @@ class TestSimulcastEncoderAdapterFake : public ::testing::Test,
     if (codec_specific_info) {
       last_encoded_image_simulcast_index_ =
           codec_specific_info->codecSpecific.VP8.simulcastIdx;
+      encoded_simulcast_indices_.push_back(
+          codec_specific_info->codecSpecific.VP8.simulcastIdx);
     }
     return Result(Result::OK, encoded_image._timeStamp);
   }
@@ -366,6 +368,7 @@ class TestSimulcastEncoderAdapterFake : public ::testing::Test,
   int last_encoded_image_width_;
   int last_encoded_image_height_;
   int last_encoded_image_simulcast_index_;
+  std::vector<int> encoded_simulcast_indices_;
 };
 
 TEST_F(TestSimulcastEncoderAdapterFake, InitEncode) {
@@ -551,5 +554,41 @@ TEST_F(TestSimulcastEncoderAdapterFake, TestFailureReturnCodesFromEncodeCalls) {
             adapter_->Encode(input_frame, nullptr, &frame_types));
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake,
+       DeliversEncodedImagesInStreamOrderWhenEncodingInParallel) {
+  TestVp8Simulcast::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
+  codec_.numberOfSimulcastStreams = 3;
+  // With more than one core the streams are encoded in parallel.
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 2, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  adapter_->SetRates(1200, 30);
+  ASSERT_EQ(3u, helper_->factory()->encoders().size());
+  for (MockVideoEncoder* encoder : helper_->factory()->encoders()) {
+    EXPECT_CALL(*encoder, Encode(_, _, _))
+        .WillOnce(::testing::DoAll(::testing::InvokeWithoutArgs([encoder] {
+                                     encoder->SendEncodedImage(
+                                         encoder->codec().width,
+                                         encoder->codec().height);
+                                   }),
+                                   Return(WEBRTC_VIDEO_CODEC_OK)));
+  }
+
+  VideoFrame input_frame;
+  int half_width = (kDefaultWidth + 1) / 2;
+  input_frame.CreateEmptyFrame(kDefaultWidth, kDefaultHeight, kDefaultWidth,
+                               half_width, half_width);
+  memset(input_frame.video_frame_buffer()->MutableDataY(), 0,
+         input_frame.allocated_size(kYPlane));
+  memset(input_frame.video_frame_buffer()->MutableDataU(), 0,
+         input_frame.allocated_size(kUPlane));
+  memset(input_frame.video_frame_buffer()->MutableDataV(), 0,
+         input_frame.allocated_size(kVPlane));
+
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), encoded_simulcast_indices_);
+}
+
 }  // namespace testing
 }  // namespace webrtc
@@ -16,13 +16,13 @@
 #include <algorithm>
 
 // NOTE(ajm): Path provided by gyp.
-#include "libyuv/scale.h"    // NOLINT
 #include "libyuv/convert.h"  // NOLINT
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/timeutils.h"
 #include "webrtc/base/trace_event.h"
 #include "webrtc/common_types.h"
+#include "webrtc/common_video/include/scale_pyramid_buffer.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
@@ -36,7 +36,6 @@ namespace webrtc {
 namespace {
 
 enum { kVp8ErrorPropagationTh = 30 };
-enum { kVp832ByteAlign = 32 };
 
 // VP8 denoiser states.
 enum denoiserState {
@@ -146,11 +145,9 @@ VP8EncoderImpl::~VP8EncoderImpl() {
 int VP8EncoderImpl::Release() {
   int ret_val = WEBRTC_VIDEO_CODEC_OK;
 
-  while (!encoded_images_.empty()) {
-    EncodedImage& image = encoded_images_.back();
-    delete[] image._buffer;
-    encoded_images_.pop_back();
-  }
+  encoded_images_.clear();
+  for (EncodedImageBufferPool& pool : encoded_buffer_pools_)
+    pool.Release();
   while (!encoders_.empty()) {
     vpx_codec_ctx_t& encoder = encoders_.back();
     if (vpx_codec_destroy(&encoder)) {
@@ -399,13 +396,9 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
     // Random start, 16 bits is enough.
     picture_id_[i] = static_cast<uint16_t>(rand()) & 0x7FFF;  // NOLINT
     last_key_frame_picture_id_[i] = -1;
-    // allocate memory for encoded image
-    if (encoded_images_[i]._buffer != NULL) {
-      delete[] encoded_images_[i]._buffer;
-    }
+    // The memory of the encoded image is taken from the pool per frame.
     encoded_images_[i]._size =
         CalcBufferSize(kI420, codec_.width, codec_.height);
-    encoded_images_[i]._buffer = new uint8_t[encoded_images_[i]._size];
     encoded_images_[i]._completeFrame = true;
   }
   // populate encoder configuration with default values
@@ -547,12 +540,10 @@ int VP8EncoderImpl::InitEncode(const VideoCodec* inst,
       // Use 1 thread for lower resolutions.
       configurations_[i].g_threads = 1;
 
-      // Setting alignment to 32 - as that ensures at least 16 for all
-      // planes (32 for Y, 16 for U,V). Libvpx sets the requested stride for
-      // the y plane, but only half of it to the u and v planes.
-      vpx_img_alloc(&raw_images_[i], VPX_IMG_FMT_I420,
-                    inst->simulcastStream[stream_idx].width,
-                    inst->simulcastStream[stream_idx].height, kVp832ByteAlign);
+      // The planes are set per frame, to the scaled buffers of the input.
+      vpx_img_wrap(&raw_images_[i], VPX_IMG_FMT_I420,
+                   inst->simulcastStream[stream_idx].width,
+                   inst->simulcastStream[stream_idx].height, 1, NULL);
       SetStreamState(stream_bitrates[stream_idx] > 0, stream_idx);
       configurations_[i].rc_target_bitrate = stream_bitrates[stream_idx];
       temporal_layers_[stream_idx]->ConfigureBitrates(
@@ -738,20 +729,27 @@ int VP8EncoderImpl::Encode(const VideoFrame& frame,
   raw_images_[0].stride[VPX_PLANE_U] = input_image->StrideU();
   raw_images_[0].stride[VPX_PLANE_V] = input_image->StrideV();
 
-  for (size_t i = 1; i < encoders_.size(); ++i) {
-    // Scale the image down a number of times by downsampling factor
-    libyuv::I420Scale(
-        raw_images_[i - 1].planes[VPX_PLANE_Y],
-        raw_images_[i - 1].stride[VPX_PLANE_Y],
-        raw_images_[i - 1].planes[VPX_PLANE_U],
-        raw_images_[i - 1].stride[VPX_PLANE_U],
-        raw_images_[i - 1].planes[VPX_PLANE_V],
-        raw_images_[i - 1].stride[VPX_PLANE_V], raw_images_[i - 1].d_w,
-        raw_images_[i - 1].d_h, raw_images_[i].planes[VPX_PLANE_Y],
-        raw_images_[i].stride[VPX_PLANE_Y], raw_images_[i].planes[VPX_PLANE_U],
-        raw_images_[i].stride[VPX_PLANE_U], raw_images_[i].planes[VPX_PLANE_V],
-        raw_images_[i].stride[VPX_PLANE_V], raw_images_[i].d_w,
-        raw_images_[i].d_h, libyuv::kFilterBilinear);
+  // The lower resolution streams are scaled through the pyramid of the frame,
+  // which shares the work with other consumers of it. The scaled buffers must
+  // outlive the encode calls below.
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> scaled_images;
+  if (encoders_.size() > 1) {
+    rtc::scoped_refptr<ScalePyramidBuffer> pyramid =
+        ScalePyramidBuffer::Wrap(frame.video_frame_buffer());
+    for (size_t i = 1; i < encoders_.size(); ++i) {
+      rtc::scoped_refptr<VideoFrameBuffer> scaled_image =
+          pyramid->ScaledBuffer(raw_images_[i].d_w, raw_images_[i].d_h);
+      raw_images_[i].planes[VPX_PLANE_Y] =
+          const_cast<uint8_t*>(scaled_image->DataY());
+      raw_images_[i].planes[VPX_PLANE_U] =
+          const_cast<uint8_t*>(scaled_image->DataU());
+      raw_images_[i].planes[VPX_PLANE_V] =
+          const_cast<uint8_t*>(scaled_image->DataV());
+      raw_images_[i].stride[VPX_PLANE_Y] = scaled_image->StrideY();
+      raw_images_[i].stride[VPX_PLANE_U] = scaled_image->StrideU();
+      raw_images_[i].stride[VPX_PLANE_V] = scaled_image->StrideV();
+      scaled_images.push_back(scaled_image);
+    }
   }
   vpx_enc_frame_flags_t flags[kMaxSimulcastStreams];
   for (size_t i = 0; i < encoders_.size(); ++i) {
@@ -948,6 +946,14 @@ int VP8EncoderImpl::GetEncodedPartitions(const VideoFrame& input_image,
        ++encoder_idx, --stream_idx) {
     vpx_codec_iter_t iter = NULL;
     int part_idx = 0;
+    // Drop the buffer of the previous frame before taking one from the pool,
+    // so that it is reused unless a consumer still holds it.
+    encoded_images_[encoder_idx].shared_buffer_ = nullptr;
+    encoded_images_[encoder_idx].shared_buffer_ =
+        encoded_buffer_pools_[encoder_idx].CreateBuffer(
+            encoded_images_[encoder_idx]._size);
+    encoded_images_[encoder_idx]._buffer =
+        encoded_images_[encoder_idx].shared_buffer_->data();
     encoded_images_[encoder_idx]._length = 0;
     encoded_images_[encoder_idx]._frameType = kVideoFrameDelta;
     RTPFragmentationHeader frag_info;
@@ -963,11 +969,14 @@ int VP8EncoderImpl::GetEncodedPartitions(const VideoFrame& input_image,
           size_t length = encoded_images_[encoder_idx]._length;
           if (pkt->data.frame.sz + length >
               encoded_images_[encoder_idx]._size) {
-            uint8_t* buffer = new uint8_t[pkt->data.frame.sz + length];
-            memcpy(buffer, encoded_images_[encoder_idx]._buffer, length);
-            delete[] encoded_images_[encoder_idx]._buffer;
-            encoded_images_[encoder_idx]._buffer = buffer;
-            encoded_images_[encoder_idx]._size = pkt->data.frame.sz + length;
+            rtc::scoped_refptr<EncodedImageBuffer> buffer =
+                encoded_buffer_pools_[encoder_idx].CreateBuffer(
+                    pkt->data.frame.sz + length);
+            memcpy(buffer->data(), encoded_images_[encoder_idx]._buffer,
+                   length);
+            encoded_images_[encoder_idx].shared_buffer_ = buffer;
+            encoded_images_[encoder_idx]._buffer = buffer->data();
+            encoded_images_[encoder_idx]._size = buffer->size();
           }
           memcpy(&encoded_images_[encoder_idx]._buffer[length],
                  pkt->data.frame.buf, pkt->data.frame.sz);
@@ -1064,7 +1073,9 @@ VP8DecoderImpl::VP8DecoderImpl()
       propagation_cnt_(-1),
       last_frame_width_(0),
       last_frame_height_(0),
-      key_frame_required_(true) {}
+      key_frame_required_(true),
+      number_of_cores_(1),
+      num_threads_(1) {}
 
 VP8DecoderImpl::~VP8DecoderImpl() {
   inited_ = true;  // in order to do the actual release
@@ -1082,9 +1093,10 @@ int VP8DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (inst && inst->codecType == kVideoCodecVP8) {
     feedback_mode_ = inst->codecSpecific.VP8.feedbackModeOn;
   }
+  number_of_cores_ = number_of_cores;
+  num_threads_ = NumberOfThreads(inst->width, inst->height, number_of_cores);
   vpx_codec_dec_cfg_t cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  cfg.threads = num_threads_;
   cfg.h = cfg.w = 0;  // set after decode
 
   vpx_codec_flags_t flags = 0;
@@ -1136,6 +1148,27 @@ int VP8DecoderImpl::Decode(const EncodedImage& input_image,
   }
 #endif
 
+  // The resolution can only change on key frames. Reinitialize the decoder if
+  // the new resolution calls for a different number of threads.
+  if (input_image._frameType == kVideoFrameKey &&
+      input_image._completeFrame && input_image._length > 0) {
+    vpx_codec_stream_info_t stream_info;
+    stream_info.sz = sizeof(stream_info);
+    if (vpx_codec_peek_stream_info(
+            vpx_codec_vp8_dx(), input_image._buffer,
+            static_cast<unsigned int>(input_image._length),
+            &stream_info) == VPX_CODEC_OK &&
+        NumberOfThreads(stream_info.w, stream_info.h, number_of_cores_) !=
+            num_threads_) {
+      VideoCodec codec = codec_;
+      codec.width = stream_info.w;
+      codec.height = stream_info.h;
+      int ret = InitDecode(&codec, number_of_cores_);
+      if (ret != WEBRTC_VIDEO_CODEC_OK)
+        return ret;
+    }
+  }
+
 #if !defined(WEBRTC_ARCH_ARM) && !defined(WEBRTC_ARCH_ARM64) && \
   !defined(ANDROID)
   vp8_postproc_cfg_t ppcfg;
@@ -1305,7 +1338,11 @@ int VP8DecoderImpl::ReturnFrame(const vpx_image_t* img,
   }
   last_frame_width_ = img->d_w;
   last_frame_height_ = img->d_h;
-  // Allocate memory for decoded image.
+  // Allocate memory for decoded image. Unlike VP9 (see Vp9FrameBufferPool),
+  // the VP8 decoder in libvpx doesn't support external frame buffers, and
+  // |img| points into its internal frame buffers, which the next
+  // vpx_codec_decode() call may overwrite. Decoded frames can outlive that
+  // (they are rendered asynchronously), so they have to be copied out here.
   VideoFrame decoded_image(buffer_pool_.CreateBuffer(img->d_w, img->d_h),
                            timestamp, 0, kVideoRotation_0);
   libyuv::I420Copy(img->planes[VPX_PLANE_Y], img->stride[VPX_PLANE_Y],
@@ -1352,6 +1389,18 @@ int VP8DecoderImpl::Release() {
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int VP8DecoderImpl::NumberOfThreads(int width, int height, int cpus) {
+  // libvpx only decodes frames with more than one token partition on more
+  // than one thread, so this is an upper bound.
+  if (width * height >= 1920 * 1080 && cpus > 4) {
+    return 4;
+  } else if (width * height > 640 * 480 && cpus >= 3) {
+    return 2;
+  } else {
+    return 1;
+  }
+}
+
 const char* VP8DecoderImpl::ImplementationName() const {
   return "libvpx";
 }
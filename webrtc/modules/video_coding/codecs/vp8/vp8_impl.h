@@ -23,6 +23,7 @@
 #include "vpx/vp8cx.h"
 #include "vpx/vp8dx.h"
 
+#include "webrtc/common_video/include/encoded_image_buffer.h"
 #include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
 #include "webrtc/modules/video_coding/codecs/vp8/include/vp8.h"
@@ -113,6 +114,8 @@ class VP8EncoderImpl : public VP8Encoder {
   std::vector<int> cpu_speed_;
   std::vector<vpx_image_t> raw_images_;
   std::vector<EncodedImage> encoded_images_;
+  // One per stream, as the buffers of the streams differ in size.
+  EncodedImageBufferPool encoded_buffer_pools_[kMaxSimulcastStreams];
   std::vector<vpx_codec_ctx_t> encoders_;
   std::vector<vpx_codec_enc_cfg_t> configurations_;
   std::vector<vpx_rational_t> downsampling_factors_;
@@ -145,6 +148,9 @@ class VP8DecoderImpl : public VP8Decoder {
   // this function.
   int CopyReference(VP8DecoderImpl* copy);
 
+  // Determine number of decoder threads to use.
+  int NumberOfThreads(int width, int height, int number_of_cores);
+
   int DecodePartitions(const EncodedImage& input_image,
                        const RTPFragmentationHeader* fragmentation);
 
@@ -164,6 +170,8 @@ class VP8DecoderImpl : public VP8Decoder {
   int last_frame_width_;
   int last_frame_height_;
   bool key_frame_required_;
+  int number_of_cores_;
+  int num_threads_;
 };  // end of VP8DecoderImpl class
 }  // namespace webrtc
 
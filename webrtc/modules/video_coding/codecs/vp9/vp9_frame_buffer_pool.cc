@@ -11,6 +11,11 @@
 
 #include "webrtc/modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
 #include "vpx/vpx_codec.h"
 #include "vpx/vpx_decoder.h"
 #include "vpx/vpx_frame_buffer.h"
@@ -20,18 +25,42 @@
 
 namespace webrtc {
 
+namespace {
+
+// Same as the alignment of I420Buffer.
+const size_t kBufferAlignment = 64;
+
+}  // namespace
+
 uint8_t* Vp9FrameBufferPool::Vp9FrameBuffer::GetData() {
-  return data_.data<uint8_t>();
+  return data_.get();
 }
 
 size_t Vp9FrameBufferPool::Vp9FrameBuffer::GetDataSize() const {
-  return data_.size();
+  return size_;
+}
+
+size_t Vp9FrameBufferPool::Vp9FrameBuffer::GetCapacity() const {
+  return capacity_;
 }
 
 void Vp9FrameBufferPool::Vp9FrameBuffer::SetSize(size_t size) {
-  data_.SetSize(size);
+  if (size > capacity_) {
+    // Grows by at least 1.5 times, as rtc::Buffer does.
+    const size_t capacity = std::max(size, capacity_ + capacity_ / 2);
+    HugePageBuffer data = HugePageMalloc(capacity, kBufferAlignment);
+    RTC_CHECK(data);
+    if (size_ > 0)
+      memcpy(data.get(), data_.get(), size_);
+    data_ = std::move(data);
+    capacity_ = capacity;
+  }
+  size_ = size;
 }
 
+Vp9FrameBufferPool::Vp9FrameBufferPool()
+    : memory_usage_("Vp9FrameBufferPool") {}
+
 bool Vp9FrameBufferPool::InitializeVpxUsePool(
     vpx_codec_ctx* vpx_codec_context) {
   RTC_DCHECK(vpx_codec_context);
@@ -55,15 +84,23 @@ rtc::scoped_refptr<Vp9FrameBufferPool::Vp9FrameBuffer>
 Vp9FrameBufferPool::GetFrameBuffer(size_t min_size) {
   RTC_DCHECK_GT(min_size, 0u);
   rtc::scoped_refptr<Vp9FrameBuffer> available_buffer = nullptr;
+  size_t previous_capacity = 0;
   {
     rtc::CritScope cs(&buffers_lock_);
-    // Do we have a buffer we can recycle?
+    // Do we have a buffer we can recycle? Prefer one that is large enough, so
+    // that it doesn't have to be reallocated.
     for (const auto& buffer : allocated_buffers_) {
       if (buffer->HasOneRef()) {
         available_buffer = buffer;
-        break;
+        if (buffer->GetCapacity() >= min_size)
+          break;
       }
     }
+    if (available_buffer && available_buffer->GetCapacity() >= min_size) {
+      ++num_reused_buffers_;
+    } else {
+      ++num_allocations_;
+    }
     // Otherwise create one.
     if (available_buffer == nullptr) {
       available_buffer = new rtc::RefCountedObject<Vp9FrameBuffer>();
@@ -76,9 +113,14 @@ Vp9FrameBufferPool::GetFrameBuffer(size_t min_size) {
         RTC_NOTREACHED();
       }
     }
+    previous_capacity = available_buffer->GetCapacity();
   }
 
   available_buffer->SetSize(min_size);
+  if (available_buffer->GetCapacity() != previous_capacity) {
+    rtc::CritScope cs(&buffers_lock_);
+    memory_usage_.Add(available_buffer->GetCapacity() - previous_capacity);
+  }
   return available_buffer;
 }
 
@@ -92,9 +134,20 @@ int Vp9FrameBufferPool::GetNumBuffersInUse() const {
   return num_buffers_in_use;
 }
 
+int Vp9FrameBufferPool::GetNumReusedBuffers() const {
+  rtc::CritScope cs(&buffers_lock_);
+  return num_reused_buffers_;
+}
+
+int Vp9FrameBufferPool::GetNumAllocations() const {
+  rtc::CritScope cs(&buffers_lock_);
+  return num_allocations_;
+}
+
 void Vp9FrameBufferPool::ClearPool() {
   rtc::CritScope cs(&buffers_lock_);
   allocated_buffers_.clear();
+  memory_usage_.Set(0);
 }
 
 // static
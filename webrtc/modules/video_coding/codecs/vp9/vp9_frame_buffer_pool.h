@@ -15,10 +15,11 @@
 #include <vector>
 
 #include "webrtc/base/basictypes.h"
-#include "webrtc/base/buffer.h"
 #include "webrtc/base/criticalsection.h"
+#include "webrtc/base/memory_usage.h"
 #include "webrtc/base/refcount.h"
 #include "webrtc/base/scoped_ref_ptr.h"
+#include "webrtc/system_wrappers/include/huge_page_malloc.h"
 
 struct vpx_codec_ctx;
 struct vpx_codec_frame_buffer;
@@ -57,25 +58,36 @@ class Vp9FrameBufferPool {
    public:
     uint8_t* GetData();
     size_t GetDataSize() const;
+    size_t GetCapacity() const;
     void SetSize(size_t size);
 
     virtual bool HasOneRef() const = 0;
 
    private:
-    // Data as an easily resizable buffer.
-    rtc::Buffer data_;
+    // Large buffers are backed by huge pages when enabled, see
+    // SetHugePageMode().
+    HugePageBuffer data_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
   };
 
+  Vp9FrameBufferPool();
+
   // Configures libvpx to, in the specified context, use this memory pool for
   // buffers used to decompress frames. This is only supported for VP9.
   bool InitializeVpxUsePool(vpx_codec_ctx* vpx_codec_context);
 
   // Gets a frame buffer of at least |min_size|, recycling an available one or
-  // creating a new one. When no longer referenced from the outside the buffer
-  // becomes recyclable.
+  // creating a new one. Available buffers that can hold |min_size| without
+  // reallocating are preferred. When no longer referenced from the outside the
+  // buffer becomes recyclable.
   rtc::scoped_refptr<Vp9FrameBuffer> GetFrameBuffer(size_t min_size);
   // Gets the number of buffers currently in use (not ready to be recycled).
   int GetNumBuffersInUse() const;
+  // Gets the number of GetFrameBuffer calls served without allocating memory,
+  // and the number that created or grew a buffer, respectively.
+  int GetNumReusedBuffers() const;
+  int GetNumAllocations() const;
   // Releases allocated buffers, deleting available buffers. Buffers in use are
   // not deleted until they are no longer referenced.
   void ClearPool();
@@ -102,11 +114,15 @@ class Vp9FrameBufferPool {
                                        vpx_codec_frame_buffer* fb);
 
  private:
-  // Protects |allocated_buffers_|.
+  // Protects |allocated_buffers_| and the counters.
   rtc::CriticalSection buffers_lock_;
   // All buffers, in use or ready to be recycled.
   std::vector<rtc::scoped_refptr<Vp9FrameBuffer>> allocated_buffers_
       GUARDED_BY(buffers_lock_);
+  int num_reused_buffers_ GUARDED_BY(buffers_lock_) = 0;
+  int num_allocations_ GUARDED_BY(buffers_lock_) = 0;
+  // Capacity of |allocated_buffers_|, when memory accounting is enabled.
+  rtc::ScopedMemoryUsage memory_usage_ GUARDED_BY(buffers_lock_);
   // If more buffers than this are allocated we print warnings and crash if in
   // debug mode. VP9 is defined to have 8 reference buffers, of which 3 can be
   // referenced by any frame, see
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
 #include <vector>
 
 #include "vpx/vpx_encoder.h"
@@ -91,10 +92,9 @@ VP9EncoderImpl::~VP9EncoderImpl() {
 }
 
 int VP9EncoderImpl::Release() {
-  if (encoded_image_._buffer != NULL) {
-    delete[] encoded_image_._buffer;
-    encoded_image_._buffer = NULL;
-  }
+  encoded_image_.shared_buffer_ = nullptr;
+  encoded_image_._buffer = nullptr;
+  encoded_buffer_pool_.Release();
   if (encoder_ != NULL) {
     if (vpx_codec_destroy(encoder_)) {
       return WEBRTC_VIDEO_CODEC_MEMORY;
@@ -272,12 +272,8 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
 
   // Random start 16 bits is enough.
   picture_id_ = static_cast<uint16_t>(rand()) & 0x7FFF;  // NOLINT
-  // Allocate memory for encoded image
-  if (encoded_image_._buffer != NULL) {
-    delete[] encoded_image_._buffer;
-  }
+  // The memory of the encoded image is taken from the pool per layer frame.
   encoded_image_._size = CalcBufferSize(kI420, codec_.width, codec_.height);
-  encoded_image_._buffer = new uint8_t[encoded_image_._size];
   encoded_image_._completeFrame = true;
   // Creating a wrapper to the image - setting image data to NULL. Actual
   // pointer will be set in encode. Setting align to 1, as it is meaningless
@@ -378,7 +374,9 @@ int VP9EncoderImpl::NumberOfThreads(int width,
                                     int number_of_cores) {
   // Keep the number of encoder threads equal to the possible number of column
   // tiles, which is (1, 2, 4, 8). See comments below for VP9E_SET_TILE_COLUMNS.
-  if (width * height >= 1280 * 720 && number_of_cores > 4) {
+  if (width * height >= 1920 * 1080 && number_of_cores >= 8) {
+    return 8;
+  } else if (width * height >= 1280 * 720 && number_of_cores > 4) {
     return 4;
   } else if (width * height >= 640 * 480 && number_of_cores > 2) {
     return 2;
@@ -388,6 +386,17 @@ int VP9EncoderImpl::NumberOfThreads(int width,
   }
 }
 
+int VP9EncoderImpl::TileColumnsLog2(int width, int threads) {
+  // A tile column is at least 256 pixels wide, so e.g. 1080p has at most 4
+  // tile columns regardless of the number of threads.
+  int log2_tile_columns = 0;
+  while ((2 << log2_tile_columns) <= threads &&
+         (256 << (log2_tile_columns + 1)) <= width) {
+    ++log2_tile_columns;
+  }
+  return log2_tile_columns;
+}
+
 int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // Set QP-min/max per spatial and temporal layer.
   int tot_num_layers = num_spatial_layers_ * num_temporal_layers_;
@@ -444,7 +453,15 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // log2 unit: e.g., 0 = 1 tile column, 1 = 2 tile columns, 2 = 4 tile columns.
   // The number tile columns will be capped by the encoder based on image size
   // (minimum width of tile column is 256 pixels, maximum is 4096).
-  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, (config_->g_threads >> 1));
+  const int log2_tile_columns =
+      TileColumnsLog2(config_->g_w, config_->g_threads);
+  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, log2_tile_columns);
+#if defined(VPX_CTRL_VP9E_SET_ROW_MT)
+  // Threads beyond the number of tile columns would idle. Let them encode
+  // rows within a tile column instead, where libvpx supports it.
+  if (config_->g_threads > (1 << log2_tile_columns))
+    vpx_codec_control(encoder_, VP9E_SET_ROW_MT, 1);
+#endif
 #if !defined(WEBRTC_ARCH_ARM) && !defined(WEBRTC_ARCH_ARM64) && \
   !defined(ANDROID)
   // Note denoiser is still off by default until further testing/optimization,
@@ -662,11 +679,13 @@ void VP9EncoderImpl::PopulateCodecSpecific(CodecSpecificInfo* codec_specific,
 int VP9EncoderImpl::GetEncodedLayerFrame(const vpx_codec_cx_pkt* pkt) {
   RTC_DCHECK_EQ(pkt->kind, VPX_CODEC_CX_FRAME_PKT);
 
-  if (pkt->data.frame.sz > encoded_image_._size) {
-    delete[] encoded_image_._buffer;
-    encoded_image_._size = pkt->data.frame.sz;
-    encoded_image_._buffer = new uint8_t[encoded_image_._size];
-  }
+  // Drop the buffer of the previous layer frame before taking one from the
+  // pool, so that it is reused unless a consumer still holds it.
+  encoded_image_.shared_buffer_ = nullptr;
+  encoded_image_.shared_buffer_ = encoded_buffer_pool_.CreateBuffer(
+      std::max(encoded_image_._size, pkt->data.frame.sz));
+  encoded_image_._buffer = encoded_image_.shared_buffer_->data();
+  encoded_image_._size = encoded_image_.shared_buffer_->size();
   memcpy(encoded_image_._buffer, pkt->data.frame.buf, pkt->data.frame.sz);
   encoded_image_._length = pkt->data.frame.sz;
 
@@ -841,7 +860,9 @@ VP9DecoderImpl::VP9DecoderImpl()
     : decode_complete_callback_(NULL),
       inited_(false),
       decoder_(NULL),
-      key_frame_required_(true) {
+      key_frame_required_(true),
+      number_of_cores_(1),
+      num_threads_(1) {
   memset(&codec_, 0, sizeof(codec_));
 }
 
@@ -869,9 +890,10 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (decoder_ == NULL) {
     decoder_ = new vpx_codec_ctx_t;
   }
+  number_of_cores_ = number_of_cores;
+  num_threads_ = NumberOfThreads(inst->width, inst->height, number_of_cores);
   vpx_codec_dec_cfg_t cfg;
-  // Setting number of threads to a constant value (1)
-  cfg.threads = 1;
+  cfg.threads = num_threads_;
   cfg.h = cfg.w = 0;  // set after decode
   vpx_codec_flags_t flags = 0;
   if (vpx_codec_dec_init(decoder_, vpx_codec_vp9_dx(), &cfg, flags)) {
@@ -885,6 +907,13 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (!frame_buffer_pool_.InitializeVpxUsePool(decoder_)) {
     return WEBRTC_VIDEO_CODEC_MEMORY;
   }
+#if defined(VPX_CTRL_VP9D_SET_ROW_MT)
+  // Decode rows of a tile column in parallel, so that the threads are used
+  // also for streams with fewer tile columns than threads. Frame parallel
+  // decoding is not enabled, since it adds a frame of latency per thread.
+  if (num_threads_ > 1)
+    vpx_codec_control(decoder_, VP9D_SET_ROW_MT, 1);
+#endif
 
   inited_ = true;
   // Always start with a complete key frame.
@@ -903,6 +932,26 @@ int VP9DecoderImpl::Decode(const EncodedImage& input_image,
   if (decode_complete_callback_ == NULL) {
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
   }
+  // The resolution can only change on key frames. Reinitialize the decoder if
+  // the new resolution calls for a different number of threads.
+  if (input_image._frameType == kVideoFrameKey &&
+      input_image._completeFrame && input_image._length > 0) {
+    vpx_codec_stream_info_t stream_info;
+    stream_info.sz = sizeof(stream_info);
+    if (vpx_codec_peek_stream_info(
+            vpx_codec_vp9_dx(), input_image._buffer,
+            static_cast<unsigned int>(input_image._length),
+            &stream_info) == VPX_CODEC_OK &&
+        NumberOfThreads(stream_info.w, stream_info.h, number_of_cores_) !=
+            num_threads_) {
+      VideoCodec codec = codec_;
+      codec.width = stream_info.w;
+      codec.height = stream_info.h;
+      int ret = InitDecode(&codec, number_of_cores_);
+      if (ret != WEBRTC_VIDEO_CODEC_OK)
+        return ret;
+    }
+  }
   // Always start with a complete key frame.
   if (key_frame_required_) {
     if (input_image._frameType != kVideoFrameKey)
@@ -995,6 +1044,23 @@ int VP9DecoderImpl::Release() {
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int VP9DecoderImpl::NumberOfThreads(int width,
+                                    int height,
+                                    int number_of_cores) {
+  // libvpx decodes the tile columns of a frame in parallel. Use as many
+  // threads as VP9EncoderImpl::NumberOfThreads(), which sets the number of
+  // tile columns.
+  if (width * height >= 1920 * 1080 && number_of_cores >= 8) {
+    return 8;
+  } else if (width * height >= 1280 * 720 && number_of_cores > 4) {
+    return 4;
+  } else if (width * height >= 640 * 480 && number_of_cores > 2) {
+    return 2;
+  } else {
+    return 1;
+  }
+}
+
 const char* VP9DecoderImpl::ImplementationName() const {
   return "libvpx";
 }
@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 
+#include "webrtc/common_video/include/encoded_image_buffer.h"
 #include "webrtc/modules/video_coding/codecs/vp9/include/vp9.h"
 #include "webrtc/modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
 
@@ -70,6 +71,10 @@ class VP9EncoderImpl : public VP9Encoder {
   // Determine number of encoder threads to use.
   int NumberOfThreads(int width, int height, int number_of_cores);
 
+  // Determine the number of tile columns, in log2 unit, for |threads| encoder
+  // threads and a frame |width| pixels wide.
+  static int TileColumnsLog2(int width, int threads);
+
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings(const VideoCodec* inst);
 
@@ -104,6 +109,7 @@ class VP9EncoderImpl : public VP9Encoder {
   uint32_t MaxIntraTarget(uint32_t optimal_buffer_size);
 
   EncodedImage encoded_image_;
+  EncodedImageBufferPool encoded_buffer_pool_;
   EncodedImageCallback* encoded_complete_callback_;
   VideoCodec codec_;
   bool inited_;
@@ -155,6 +161,9 @@ class VP9DecoderImpl : public VP9Decoder {
  private:
   int ReturnFrame(const vpx_image_t* img, uint32_t timeStamp);
 
+  // Determine number of decoder threads to use.
+  int NumberOfThreads(int width, int height, int number_of_cores);
+
   // Memory pool used to share buffers between libvpx and webrtc.
   Vp9FrameBufferPool frame_buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
@@ -162,6 +171,8 @@ class VP9DecoderImpl : public VP9Decoder {
   vpx_codec_ctx_t* decoder_;
   VideoCodec codec_;
   bool key_frame_required_;
+  int number_of_cores_;
+  int num_threads_;
 };
 }  // namespace webrtc
 
@@ -35,6 +35,8 @@ VCMEncodedFrame::VCMEncodedFrame(const webrtc::EncodedImage& rhs)
       _fragmentation(),
       _rotation_set(false) {
   _codecSpecificInfo.codecType = kVideoCodecUnknown;
+  // The frame owns a copy of the data.
+  shared_buffer_ = nullptr;
   _buffer = NULL;
   _size = 0;
   _length = 0;
@@ -54,6 +56,8 @@ VCMEncodedFrame::VCMEncodedFrame(const VCMEncodedFrame& rhs)
       _codec(rhs._codec),
       _fragmentation(),
       _rotation_set(rhs._rotation_set) {
+  // The frame owns a copy of the data.
+  shared_buffer_ = nullptr;
   _buffer = NULL;
   _size = 0;
   _length = 0;
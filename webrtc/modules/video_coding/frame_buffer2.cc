@@ -11,9 +11,12 @@
 #include "webrtc/modules/video_coding/frame_buffer2.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/modules/video_coding/frame_object.h"
+#include "webrtc/modules/video_coding/jitter_buffer_common.h"
 #include "webrtc/modules/video_coding/jitter_estimator.h"
 #include "webrtc/modules/video_coding/sequence_number_util.h"
 #include "webrtc/modules/video_coding/timing.h"
@@ -75,10 +78,9 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
         const FrameObject& frame = *frame_it->second;
         if (IsContinuous(frame)) {
           next_frame_it = frame_it;
-          int64_t render_time =
-              next_frame_it->second->RenderTime() == -1
-                  ? timing_->RenderTimeMs(frame.timestamp, now)
-                  : next_frame_it->second->RenderTime();
+          int64_t render_time = next_frame_it->second->RenderTime() == -1
+                                    ? UpdateTimingAndGetRenderTime(frame, now)
+                                    : next_frame_it->second->RenderTime();
           wait_ms = timing_->MaxWaitingTime(render_time, now);
           frame_it->second->SetRenderTime(render_time);
 
@@ -166,6 +168,40 @@ void FrameBuffer::InsertFrame(std::unique_ptr<FrameObject> frame) {
   frame_inserted_event_.Set();
 }
 
+int64_t FrameBuffer::UpdateTimingAndGetRenderTime(const FrameObject& frame,
+                                                  int64_t now_ms) {
+  const PlayoutDelay& playout_delay = frame.EncodedImage().playout_delay_;
+  if (playout_delay.min_ms >= 0)
+    timing_->set_min_playout_delay(playout_delay.min_ms);
+  if (playout_delay.max_ms >= 0)
+    timing_->set_max_playout_delay(playout_delay.max_ms);
+
+  int64_t render_time_ms = timing_->RenderTimeMs(frame.timestamp, now_ms);
+  // Assume that render timing errors are due to changes in the video stream,
+  // and start over with the timing and the jitter estimate. Unlike
+  // VCMReceiver, the frame isn't dropped since it is known to be decodable.
+  bool timing_error = false;
+  if (render_time_ms < 0) {
+    timing_error = true;
+  } else if (std::abs(render_time_ms - now_ms) > kMaxVideoDelayMs) {
+    LOG(LS_WARNING) << "A frame about to be decoded is out of the configured "
+                    << "delay bounds (" << std::abs(render_time_ms - now_ms)
+                    << " > " << kMaxVideoDelayMs
+                    << "). Resetting the video timing.";
+    timing_error = true;
+  } else if (timing_->TargetVideoDelay() > kMaxVideoDelayMs) {
+    LOG(LS_WARNING) << "The video target delay has grown larger than "
+                    << kMaxVideoDelayMs << " ms. Resetting the video timing.";
+    timing_error = true;
+  }
+  if (timing_error) {
+    timing_->Reset();
+    jitter_estimator_->Reset();
+    render_time_ms = timing_->RenderTimeMs(frame.timestamp, now_ms);
+  }
+  return render_time_ms;
+}
+
 bool FrameBuffer::IsContinuous(const FrameObject& frame) const {
   // If a frame with an earlier picture id was inserted compared to the last
   // decoded frames picture id then that frame arrived too late.
@@ -83,6 +83,11 @@ class FrameBuffer {
   bool IsContinuous(const FrameObject& frame) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Applies the playout delay of |frame| and returns its render time. The
+  // timing is reset if the render time is out of bounds, as in VCMReceiver.
+  int64_t UpdateTimingAndGetRenderTime(const FrameObject& frame, int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Keep track of decoded frames.
   std::set<FrameKey, FrameComp> decoded_frames_ GUARDED_BY(crit_);
 
@@ -82,6 +82,10 @@ class FrameObjectFake : public FrameObject {
   int64_t ReceivedTime() const override { return 0; }
 
   int64_t RenderTime() const override { return _renderTimeMs; }
+
+  void SetPlayoutDelay(const PlayoutDelay& playout_delay) {
+    playout_delay_ = playout_delay;
+  }
 };
 
 class TestFrameBuffer2 : public ::testing::Test {
@@ -344,6 +348,22 @@ TEST_F(TestFrameBuffer2, InsertLateFrame) {
   CheckNoFrame(2);
 }
 
+TEST_F(TestFrameBuffer2, PlayoutDelayIsAppliedToTiming) {
+  std::unique_ptr<FrameObjectFake> frame(new FrameObjectFake());
+  frame->picture_id = Rand();
+  frame->spatial_layer = 0;
+  frame->timestamp = Rand();
+  frame->num_references = 0;
+  frame->inter_layer_predicted = false;
+  frame->SetPlayoutDelay({20, 300});
+  buffer_.InsertFrame(std::move(frame));
+  ExtractFrame();
+
+  CheckFrame(0, frames_[0]->picture_id, 0);
+  EXPECT_EQ(20, timing_.min_playout_delay());
+  EXPECT_EQ(300, timing_.max_playout_delay());
+}
+
 TEST_F(TestFrameBuffer2, ProtectionMode) {
   uint16_t pid = Rand();
   uint32_t ts = Rand();
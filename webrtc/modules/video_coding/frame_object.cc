@@ -9,6 +9,9 @@
  */
 
 #include "webrtc/modules/video_coding/frame_object.h"
+
+#include <string.h>
+
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/modules/video_coding/packet_buffer.h"
 
@@ -43,11 +46,17 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
     _payloadType = packet->payloadType;
     _timeStamp = packet->timestamp;
     ntp_time_ms_ = packet->ntp_time_ms_;
-    _buffer = new uint8_t[frame_size]();
-    _size = frame_size;
-    _length = frame_size;
     _frameType = packet->frameType;
+    // The bitstream is copied straight into a buffer that can be handed to
+    // the decoder, padded as required for the codec.
+    size_t padding_bytes = EncodedImage::GetBufferPaddingBytes(packet->codec);
+    _buffer =
+        packet_buffer_->GetFrameBuffer(frame_size + padding_bytes, &_size);
+    _length = frame_size;
+    memset(_buffer + frame_size, 0, padding_bytes);
     GetBitstream(_buffer);
+    codec_header_ = rtc::Optional<RTPVideoTypeHeader>(
+        packet->video_header.codecHeader);
 
     // RtpFrameObject members
     frame_type_ = packet->frameType;
@@ -60,6 +69,10 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
 
 RtpFrameObject::~RtpFrameObject() {
   packet_buffer_->ReturnFrame(this);
+  if (_buffer) {
+    packet_buffer_->ReturnFrameBuffer(_buffer, _size);
+    _buffer = nullptr;
+  }
 }
 
 uint16_t RtpFrameObject::first_seq_num() const {
@@ -98,11 +111,8 @@ int64_t RtpFrameObject::RenderTime() const {
   return _renderTimeMs;
 }
 
-RTPVideoTypeHeader* RtpFrameObject::GetCodecHeader() const {
-  VCMPacket* packet = packet_buffer_->GetPacket(first_seq_num_);
-  if (!packet)
-    return nullptr;
-  return &packet->video_header.codecHeader;
+const RTPVideoTypeHeader* RtpFrameObject::GetCodecHeader() const {
+  return codec_header_ ? &*codec_header_ : nullptr;
 }
 
 }  // namespace video_coding
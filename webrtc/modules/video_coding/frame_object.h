@@ -11,6 +11,7 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_FRAME_OBJECT_H_
 #define WEBRTC_MODULES_VIDEO_CODING_FRAME_OBJECT_H_
 
+#include "webrtc/base/optional.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/video_coding/encoded_frame.h"
@@ -72,7 +73,7 @@ class RtpFrameObject : public FrameObject {
   uint32_t Timestamp() const override;
   int64_t ReceivedTime() const override;
   int64_t RenderTime() const override;
-  RTPVideoTypeHeader* GetCodecHeader() const;
+  const RTPVideoTypeHeader* GetCodecHeader() const;
 
  private:
   rtc::scoped_refptr<PacketBuffer> packet_buffer_;
@@ -86,6 +87,10 @@ class RtpFrameObject : public FrameObject {
   // Equal to times nacked of the packet with the highet times nacked
   // belonging to this frame.
   int times_nacked_;
+
+  // Copied from the first packet, so that it can be read without locking the
+  // packet buffer.
+  rtc::Optional<RTPVideoTypeHeader> codec_header_;
 };
 
 }  // namespace video_coding
@@ -78,6 +78,9 @@ class VCMReceiveCallback {
 class VCMSendStatisticsCallback {
  public:
   virtual void SendStatistics(uint32_t bitRate, uint32_t frameRate) = 0;
+  // Called when a native handle frame had to be converted to I420 because the
+  // encoder doesn't support native handles.
+  virtual void OnNativeToI420Conversion() {}
 
  protected:
   virtual ~VCMSendStatisticsCallback() {}
@@ -50,10 +50,14 @@ NackModule::NackModule(Clock* clock,
       initialized_(false),
       rtt_ms_(kDefaultRttMs),
       newest_seq_num_(0),
-      next_process_time_ms_(-1) {
+      next_process_time_ms_(-1),
+      next_resend_time_ms_(0) {
   RTC_DCHECK(clock_);
   RTC_DCHECK(nack_sender_);
   RTC_DCHECK(keyframe_request_sender_);
+  static_assert(kMaxPacketAge < kNackListWindowSize,
+                "The NACK list window must cover kMaxPacketAge.");
+  nack_batch_.reserve(kMaxNackPackets);
 }
 
 int NackModule::OnReceivedPacket(const VCMPacket& packet) {
@@ -106,7 +110,7 @@ int NackModule::OnReceivedPacket(const VCMPacket& packet) {
     keyframe_list_.erase(keyframe_list_.begin(), it);
 
   // Are there any nacks that are waiting for this seq_num.
-  std::vector<uint16_t> nack_batch = GetNackBatch(kSeqNumOnly);
+  const std::vector<uint16_t>& nack_batch = GetNackBatch(kSeqNumOnly);
   if (!nack_batch.empty())
     nack_sender_->SendNack(nack_batch);
 
@@ -123,6 +127,8 @@ void NackModule::ClearUpTo(uint16_t seq_num) {
 void NackModule::UpdateRtt(int64_t rtt_ms) {
   rtc::CritScope lock(&crit_);
   rtt_ms_ = rtt_ms;
+  // Packets may be due earlier with the new RTT.
+  next_resend_time_ms_ = 0;
 }
 
 void NackModule::Clear() {
@@ -160,7 +166,9 @@ void NackModule::Process() {
                                 kProcessIntervalMs * kProcessIntervalMs;
   }
 
-  std::vector<uint16_t> nack_batch = GetNackBatch(kTimeOnly);
+  if (now_ms < next_resend_time_ms_)
+    return;
+  const std::vector<uint16_t>& nack_batch = GetNackBatch(kTimeOnly);
   if (!nack_batch.empty() && nack_sender_ != nullptr)
     nack_sender_->SendNack(nack_batch);
 }
@@ -213,46 +221,46 @@ void NackModule::AddPacketsToNack(uint16_t seq_num_start,
     RTC_DCHECK(nack_list_.find(seq_num) == nack_list_.end());
     nack_list_[seq_num] = nack_info;
   }
+  // Packets that have not been nacked yet are due right away.
+  next_resend_time_ms_ = 0;
 }
 
-std::vector<uint16_t> NackModule::GetNackBatch(NackFilterOptions options) {
+const std::vector<uint16_t>& NackModule::GetNackBatch(
+    NackFilterOptions options) {
   bool consider_seq_num = options != kTimeOnly;
   bool consider_timestamp = options != kSeqNumOnly;
   int64_t now_ms = clock_->TimeInMilliseconds();
-  std::vector<uint16_t> nack_batch;
+  nack_batch_.clear();
+  // When going through the whole list by time, this becomes the earliest
+  // time at which a packet that is left in the list is due again.
+  int64_t next_resend_time_ms = std::numeric_limits<int64_t>::max();
   auto it = nack_list_.begin();
   while (it != nack_list_.end()) {
-    if (consider_seq_num && it->second.sent_at_time == -1 &&
-        AheadOrAt(newest_seq_num_, it->second.send_at_seq_num)) {
-      nack_batch.emplace_back(it->second.seq_num);
+    bool send_now =
+        (consider_seq_num && it->second.sent_at_time == -1 &&
+         AheadOrAt(newest_seq_num_, it->second.send_at_seq_num)) ||
+        (consider_timestamp && it->second.sent_at_time + rtt_ms_ <= now_ms);
+    if (send_now) {
+      nack_batch_.emplace_back(it->second.seq_num);
       ++it->second.retries;
       it->second.sent_at_time = now_ms;
       if (it->second.retries >= kMaxNackRetries) {
         LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
                         << " removed from NACK list due to max retries.";
         it = nack_list_.erase(it);
-      } else {
-        ++it;
+        continue;
       }
-      continue;
-    }
-
-    if (consider_timestamp && it->second.sent_at_time + rtt_ms_ <= now_ms) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now_ms;
-      if (it->second.retries >= kMaxNackRetries) {
-        LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                        << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
-      }
-      continue;
     }
+    next_resend_time_ms = std::min(next_resend_time_ms,
+                                   it->second.sent_at_time + rtt_ms_);
     ++it;
   }
-  return nack_batch;
+  if (consider_timestamp) {
+    next_resend_time_ms_ = next_resend_time_ms;
+  } else if (!nack_batch_.empty()) {
+    next_resend_time_ms_ = std::min(next_resend_time_ms_, now_ms + rtt_ms_);
+  }
+  return nack_batch_;
 }
 
 void NackModule::UpdateReorderingStatistics(uint16_t seq_num) {
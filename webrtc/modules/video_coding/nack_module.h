@@ -11,9 +11,8 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_NACK_MODULE_H_
 #define WEBRTC_MODULES_VIDEO_CODING_NACK_MODULE_H_
 
-#include <map>
-#include <vector>
 #include <set>
+#include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/thread_annotations.h"
@@ -65,7 +64,9 @@ class NackModule : public Module {
   // Removes packets from the nack list until the next keyframe. Returns true
   // if packets were removed.
   bool RemovePacketsUntilKeyFrame() EXCLUSIVE_LOCKS_REQUIRED(crit_);
-  std::vector<uint16_t> GetNackBatch(NackFilterOptions options)
+  // Fills |nack_batch_| with the packets to nack now and returns it. The
+  // batch is valid until the next call.
+  const std::vector<uint16_t>& GetNackBatch(NackFilterOptions options)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Update the reordering distribution.
@@ -82,7 +83,10 @@ class NackModule : public Module {
   NackSender* const nack_sender_;
   KeyFrameRequestSender* const keyframe_request_sender_;
 
-  std::map<uint16_t, NackInfo, DescendingSeqNumComp<uint16_t>> nack_list_
+  // Covers kMaxPacketAge, the oldest packet that is nacked.
+  static const size_t kNackListWindowSize = 1 << 14;
+
+  SeqNumWindow<uint16_t, NackInfo, kNackListWindowSize> nack_list_
       GUARDED_BY(crit_);
   std::set<uint16_t, DescendingSeqNumComp<uint16_t>> keyframe_list_
       GUARDED_BY(crit_);
@@ -92,6 +96,11 @@ class NackModule : public Module {
   int64_t rtt_ms_ GUARDED_BY(crit_);
   uint16_t newest_seq_num_ GUARDED_BY(crit_);
   int64_t next_process_time_ms_ GUARDED_BY(crit_);
+  // No packet in the nack list is due to be resent by time before this, so
+  // Process() doesn't have to go through the list until then.
+  int64_t next_resend_time_ms_ GUARDED_BY(crit_);
+  // Reused by GetNackBatch() so that sending nacks doesn't allocate.
+  std::vector<uint16_t> nack_batch_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
@@ -9,9 +9,14 @@
  */
 
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <utility>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
 #include "webrtc/modules/video_coding/nack_module.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -196,6 +201,28 @@ TEST_F(TestNackModule, ResendNack) {
   EXPECT_EQ(4u, sent_nacks_.size());
 }
 
+TEST_F(TestNackModule, ResendNackEarlierAfterRttDecrease) {
+  VCMPacket packet;
+  packet.seqNum = 1;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 3;
+  nack_module_.OnReceivedPacket(packet);
+  EXPECT_EQ(1u, sent_nacks_.size());
+
+  clock_->AdvanceTimeMilliseconds(10);
+  nack_module_.Process();
+  EXPECT_EQ(1u, sent_nacks_.size());
+
+  // The packet is due again at 20 ms rather than at 100 ms.
+  nack_module_.UpdateRtt(20);
+  clock_->AdvanceTimeMilliseconds(9);
+  nack_module_.Process();
+  EXPECT_EQ(1u, sent_nacks_.size());
+  clock_->AdvanceTimeMilliseconds(1);
+  nack_module_.Process();
+  EXPECT_EQ(2u, sent_nacks_.size());
+}
+
 TEST_F(TestNackModule, ResendPacketMaxRetries) {
   VCMPacket packet;
   packet.seqNum = 1;
@@ -314,4 +341,43 @@ TEST_F(TestNackModule, PacketNackCount) {
   EXPECT_EQ(0, nack_module_.OnReceivedPacket(packet));
 }
 
+// Receives packets at 1000 packets/s with 5% random loss, and a burst of 200
+// lost packets every second. Lost packets are retransmitted once and arrive
+// 100 ms later.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(TestNackModule, DISABLED_ReceiveWithLossThroughput) {
+  const int kNumPackets = 200000;
+  const int kRetransmissionDelayPackets = 100;
+  const int kBurstIntervalPackets = 1000;
+  const int kBurstLengthPackets = 200;
+  Random random(0x1234);
+  // Pairs of (packet index to arrive at, sequence number).
+  std::deque<std::pair<int, uint16_t>> retransmissions;
+  VCMPacket packet;
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumPackets; ++i) {
+    clock_->AdvanceTimeMilliseconds(1);
+    if (i % 20 == 0)
+      nack_module_.Process();
+    while (!retransmissions.empty() && retransmissions.front().first == i) {
+      packet.seqNum = retransmissions.front().second;
+      nack_module_.OnReceivedPacket(packet);
+      retransmissions.pop_front();
+    }
+    uint16_t seq_num = static_cast<uint16_t>(i);
+    bool in_burst = i % kBurstIntervalPackets >= kBurstIntervalPackets -
+                                                 kBurstLengthPackets;
+    if (i > 0 && (in_burst || random.Rand(0, 99) < 5)) {
+      retransmissions.push_back(
+          std::make_pair(i + kRetransmissionDelayPackets, seq_num));
+      continue;
+    }
+    packet.seqNum = seq_num;
+    nack_module_.OnReceivedPacket(packet);
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  LOG(LS_INFO) << "Received packets: " << elapsed_ns / kNumPackets
+               << " ns per packet.";
+}
+
 }  // namespace webrtc
@@ -23,6 +23,12 @@
 namespace webrtc {
 namespace video_coding {
 
+namespace {
+// Max number of bitstream buffers kept for reuse. Frames are returned after
+// they have been decoded, so only a few are in flight at any time.
+const size_t kMaxFreeFrameBuffers = 8;
+}  // namespace
+
 rtc::scoped_refptr<PacketBuffer> PacketBuffer::Create(
     Clock* clock,
     size_t start_buffer_size,
@@ -229,6 +235,29 @@ bool PacketBuffer::GetBitstream(const RtpFrameObject& frame,
   return true;
 }
 
+uint8_t* PacketBuffer::GetFrameBuffer(size_t min_size, size_t* size) {
+  rtc::CritScope lock(&crit_);
+  auto it = free_frame_buffers_.lower_bound(min_size);
+  if (it == free_frame_buffers_.end()) {
+    *size = min_size;
+    return new uint8_t[min_size];
+  }
+  *size = it->first;
+  uint8_t* buffer = it->second.release();
+  free_frame_buffers_.erase(it);
+  return buffer;
+}
+
+void PacketBuffer::ReturnFrameBuffer(uint8_t* buffer, size_t size) {
+  rtc::CritScope lock(&crit_);
+  // Make room by dropping the smallest buffer, which is the least likely to
+  // fit a new frame.
+  if (free_frame_buffers_.size() == kMaxFreeFrameBuffers)
+    free_frame_buffers_.erase(free_frame_buffers_.begin());
+  free_frame_buffers_.insert(
+      std::make_pair(size, std::unique_ptr<uint8_t[]>(buffer)));
+}
+
 VCMPacket* PacketBuffer::GetPacket(uint16_t seq_num) {
   rtc::CritScope lock(&crit_);
   size_t index = seq_num % size_;
@@ -11,8 +11,9 @@
 #ifndef WEBRTC_MODULES_VIDEO_CODING_PACKET_BUFFER_H_
 #define WEBRTC_MODULES_VIDEO_CODING_PACKET_BUFFER_H_
 
-#include <vector>
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/scoped_ref_ptr.h"
@@ -104,6 +105,14 @@ class PacketBuffer {
   // Virtual for testing.
   virtual bool GetBitstream(const RtpFrameObject& frame, uint8_t* destination);
 
+  // Returns a buffer of at least |min_size| bytes for the bitstream of a
+  // frame, reusing the buffer of a returned frame when one is large enough.
+  // The size of the buffer is written to |size|.
+  uint8_t* GetFrameBuffer(size_t min_size, size_t* size);
+
+  // Takes back a buffer from GetFrameBuffer() once its frame is destroyed.
+  void ReturnFrameBuffer(uint8_t* buffer, size_t size);
+
   // Get the packet with sequence number |seq_num|.
   // Virtual for testing.
   virtual VCMPacket* GetPacket(uint16_t seq_num);
@@ -134,6 +143,10 @@ class PacketBuffer {
   // and information needed to determine the continuity between packets.
   std::vector<ContinuityInfo> sequence_buffer_ GUARDED_BY(crit_);
 
+  // Bitstream buffers of returned frames, by size.
+  std::multimap<size_t, std::unique_ptr<uint8_t[]>> free_frame_buffers_
+      GUARDED_BY(crit_);
+
   // Called when a received frame is found.
   OnReceivedFrameCallback* const received_frame_callback_;
 
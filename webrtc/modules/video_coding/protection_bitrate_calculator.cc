@@ -115,9 +115,10 @@ uint32_t ProtectionBitrateCalculator::SetTargetRates(
   }
 
   // Set the FEC packet mask type. |kFecMaskBursty| is more effective for
-  // consecutive losses and little/no packet re-ordering. As we currently
-  // do not have feedback data on the degree of correlated losses and packet
-  // re-ordering, we keep default setting to |kFecMaskRandom| for now.
+  // consecutive losses and little/no packet re-ordering. We have no feedback
+  // on the degree of correlated losses here, so we ask for |kFecMaskRandom|
+  // and let the RTP module switch to bursty masks based on the NACKed
+  // packets it sees.
   delta_fec_params.fec_mask_type = kFecMaskRandom;
   key_fec_params.fec_mask_type = kFecMaskRandom;
 
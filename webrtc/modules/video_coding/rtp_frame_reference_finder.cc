@@ -205,7 +205,7 @@ void RtpFrameReferenceFinder::ManageFrameGeneric(
 
 void RtpFrameReferenceFinder::ManageFrameVp8(
     std::unique_ptr<RtpFrameObject> frame) {
-  RTPVideoTypeHeader* rtp_codec_header = frame->GetCodecHeader();
+  const RTPVideoTypeHeader* rtp_codec_header = frame->GetCodecHeader();
   if (!rtp_codec_header)
     return;
 
@@ -318,7 +318,7 @@ void RtpFrameReferenceFinder::ManageFrameVp8(
 
 void RtpFrameReferenceFinder::CompletedFrameVp8(
     std::unique_ptr<RtpFrameObject> frame) {
-  RTPVideoTypeHeader* rtp_codec_header = frame->GetCodecHeader();
+  const RTPVideoTypeHeader* rtp_codec_header = frame->GetCodecHeader();
   if (!rtp_codec_header)
     return;
 
@@ -354,7 +354,7 @@ void RtpFrameReferenceFinder::CompletedFrameVp8(
 
 void RtpFrameReferenceFinder::ManageFrameVp9(
     std::unique_ptr<RtpFrameObject> frame) {
-  RTPVideoTypeHeader* rtp_codec_header = frame->GetCodecHeader();
+  const RTPVideoTypeHeader* rtp_codec_header = frame->GetCodecHeader();
   if (!rtp_codec_header)
     return;
 
@@ -13,7 +13,10 @@
 
 #include <limits>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "webrtc/base/checks.h"
 #include "webrtc/base/mod_ops.h"
 
 namespace webrtc {
@@ -105,6 +108,211 @@ struct DescendingSeqNumComp
   }
 };
 
+// Map from sequence numbers to values, for sequence numbers that are all
+// within |kWindowSize| of each other, such as the packets a receiver is still
+// waiting for. The values are kept in a ring indexed by the sequence number,
+// so insert, find and erase are O(1) and don't allocate. Iteration goes from
+// the oldest to the newest sequence number, skipping 64 empty slots at a time
+// using a bitmap of the slots that are used.
+//
+// Inserting a sequence number evicts the values that fall more than
+// |kWindowSize| behind it. Sequence numbers that are more than |kWindowSize|
+// behind the newest one can't be inserted.
+//
+// |kWindowSize| must be a power of two, and at most half of the range of T.
+template <typename T, typename V, size_t kWindowSize>
+class SeqNumWindow {
+ public:
+  class iterator {
+   public:
+    std::pair<T, V>& operator*() const { return window_->entry(seq_num_); }
+    std::pair<T, V>* operator->() const { return &window_->entry(seq_num_); }
+    iterator& operator++() {
+      if (seq_num_ == window_->newest_)
+        at_end_ = true;
+      else
+        seq_num_ = window_->NextUsed(seq_num_);
+      return *this;
+    }
+    bool operator==(const iterator& other) const {
+      return at_end_ == other.at_end_ &&
+             (at_end_ || seq_num_ == other.seq_num_);
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class SeqNumWindow;
+    iterator(SeqNumWindow* window, T seq_num, bool at_end)
+        : window_(window), seq_num_(seq_num), at_end_(at_end) {}
+
+    SeqNumWindow* window_;
+    T seq_num_;
+    bool at_end_;
+  };
+
+  SeqNumWindow()
+      : entries_(kWindowSize),
+        used_((kWindowSize + kBitsPerWord - 1) / kBitsPerWord),
+        size_(0),
+        oldest_(0),
+        newest_(0) {
+    static_assert(std::is_unsigned<T>::value,
+                  "Type must be an unsigned integer.");
+    static_assert((kWindowSize & (kWindowSize - 1)) == 0,
+                  "Window size must be a power of two.");
+    static_assert(kWindowSize - 1 <= std::numeric_limits<T>::max() / 2,
+                  "Window size must be at most half of the range of T.");
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  iterator begin() { return iterator(this, oldest_, empty()); }
+  iterator end() { return iterator(this, newest_, true); }
+
+  iterator find(T seq_num) {
+    if (empty() || !used(seq_num) || entry(seq_num).first != seq_num)
+      return end();
+    return iterator(this, seq_num, false);
+  }
+
+  // Returns the first value whose sequence number isn't older than |seq_num|.
+  iterator lower_bound(T seq_num) {
+    if (empty() || !AheadOf(seq_num, oldest_))
+      return begin();
+    if (AheadOf(seq_num, newest_))
+      return end();
+    if (!used(seq_num))
+      seq_num = NextUsed(seq_num);
+    return iterator(this, seq_num, false);
+  }
+
+  // Inserts a default constructed value if there is none for |seq_num|.
+  V& operator[](T seq_num) {
+    std::pair<iterator, bool> result = insert(std::make_pair(seq_num, V()));
+    RTC_DCHECK(result.first != end());
+    return result.first->second;
+  }
+
+  // Returns an iterator to the value for the sequence number, and whether the
+  // value was inserted. Returns end() if the sequence number is too old.
+  std::pair<iterator, bool> insert(const std::pair<T, V>& entry) {
+    T seq_num = entry.first;
+    iterator it = find(seq_num);
+    if (it != end())
+      return std::make_pair(it, false);
+    if (empty()) {
+      oldest_ = seq_num;
+      newest_ = seq_num;
+    } else if (AheadOf(seq_num, newest_)) {
+      erase(begin(), lower_bound(static_cast<T>(seq_num - (kWindowSize - 1))));
+      if (empty())
+        oldest_ = seq_num;
+      newest_ = seq_num;
+    } else if (AheadOf(oldest_, seq_num)) {
+      if (ForwardDiff(seq_num, newest_) >= kWindowSize)
+        return std::make_pair(end(), false);
+      oldest_ = seq_num;
+    }
+    SetUsed(seq_num, true);
+    this->entry(seq_num) = entry;
+    ++size_;
+    return std::make_pair(iterator(this, seq_num, false), true);
+  }
+
+  // Returns the iterator following |it|.
+  iterator erase(iterator it) {
+    RTC_DCHECK(it != end());
+    iterator next = it;
+    ++next;
+    T seq_num = it->first;
+    SetUsed(seq_num, false);
+    --size_;
+    if (!empty()) {
+      if (seq_num == oldest_)
+        oldest_ = next.seq_num_;
+      if (seq_num == newest_)
+        newest_ = PrevUsed(newest_);
+    }
+    return next;
+  }
+
+  void erase(iterator first, iterator last) {
+    while (first != last)
+      first = erase(first);
+  }
+
+  size_t erase(T seq_num) {
+    iterator it = find(seq_num);
+    if (it == end())
+      return 0;
+    erase(it);
+    return 1;
+  }
+
+  void clear() { erase(begin(), end()); }
+
+ private:
+  static const size_t kBitsPerWord = kWindowSize < 64 ? kWindowSize : 64;
+
+  std::pair<T, V>& entry(T seq_num) { return entries_[seq_num % kWindowSize]; }
+
+  bool used(T seq_num) const {
+    size_t index = seq_num % kWindowSize;
+    return (used_[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+  }
+
+  void SetUsed(T seq_num, bool used) {
+    size_t index = seq_num % kWindowSize;
+    uint64_t bit = uint64_t{1} << (index % kBitsPerWord);
+    if (used)
+      used_[index / kBitsPerWord] |= bit;
+    else
+      used_[index / kBitsPerWord] &= ~bit;
+  }
+
+  // Returns the first used slot after |seq_num|. There must be one, which
+  // holds as long as |seq_num| is older than |newest_|.
+  T NextUsed(T seq_num) const {
+    while (true) {
+      ++seq_num;
+      size_t index = seq_num % kWindowSize;
+      uint64_t word = used_[index / kBitsPerWord] >> (index % kBitsPerWord);
+      if (word != 0) {
+        for (; (word & 1) == 0; word >>= 1)
+          ++seq_num;
+        return seq_num;
+      }
+      // Skip to the last slot of the word.
+      seq_num += kBitsPerWord - 1 - index % kBitsPerWord;
+    }
+  }
+
+  // Returns the last used slot before |seq_num|. There must be one, which
+  // holds as long as |seq_num| is newer than |oldest_|.
+  T PrevUsed(T seq_num) const {
+    while (true) {
+      --seq_num;
+      size_t index = seq_num % kWindowSize;
+      uint64_t word = used_[index / kBitsPerWord]
+                      << (63 - index % kBitsPerWord);
+      if (word != 0) {
+        for (; (word >> 63) == 0; word <<= 1)
+          --seq_num;
+        return seq_num;
+      }
+      // Skip to the first slot of the word.
+      seq_num -= index % kBitsPerWord;
+    }
+  }
+
+  std::vector<std::pair<T, V>> entries_;
+  std::vector<uint64_t> used_;
+  size_t size_;
+  T oldest_;
+  T newest_;
+};
+
 }  // namespace webrtc
 
 #endif  // WEBRTC_MODULES_VIDEO_CODING_SEQUENCE_NUMBER_UTIL_H_
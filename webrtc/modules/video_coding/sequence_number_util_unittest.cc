@@ -9,6 +9,7 @@
  */
 
 #include <set>
+#include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/video_coding/sequence_number_util.h"
@@ -209,4 +210,83 @@ TEST_F(TestSeqNumUtil, SeqNumComparatorWithDivisor) {
   }
 }
 
+TEST_F(TestSeqNumUtil, SeqNumWindowIteratesInOrderOverWrap) {
+  SeqNumWindow<uint16_t, int, 16> window;
+  window[2] = 2;
+  window[0xfffe] = -2;
+  window[0] = 0;
+  EXPECT_EQ(3u, window.size());
+
+  std::vector<uint16_t> seq_nums;
+  for (const auto& entry : window)
+    seq_nums.push_back(entry.first);
+  EXPECT_EQ(std::vector<uint16_t>({0xfffe, 0, 2}), seq_nums);
+  EXPECT_EQ(-2, window.find(0xfffe)->second);
+  EXPECT_TRUE(window.find(1) == window.end());
+  EXPECT_EQ(0, window.lower_bound(0xffff)->first);
+  EXPECT_TRUE(window.lower_bound(3) == window.end());
+}
+
+TEST_F(TestSeqNumUtil, SeqNumWindowErase) {
+  SeqNumWindow<uint16_t, int, 16> window;
+  for (uint16_t i = 0; i < 8; ++i)
+    window[i] = i;
+
+  EXPECT_EQ(1u, window.erase(0));
+  EXPECT_EQ(0u, window.erase(0));
+  EXPECT_EQ(1u, window.erase(7));
+  EXPECT_EQ(1, window.begin()->first);
+  window.erase(window.begin(), window.lower_bound(4));
+  EXPECT_EQ(3u, window.size());
+  EXPECT_EQ(4, window.begin()->first);
+  window.clear();
+  EXPECT_TRUE(window.empty());
+  EXPECT_TRUE(window.begin() == window.end());
+
+  // The window starts over from the next sequence number.
+  window[1000] = 1;
+  EXPECT_EQ(1000, window.begin()->first);
+}
+
+TEST_F(TestSeqNumUtil, SeqNumWindowEvictsOldValues) {
+  SeqNumWindow<uint16_t, int, 16> window;
+  window[0] = 0;
+  window[10] = 10;
+  window[16] = 16;
+  EXPECT_EQ(2u, window.size());
+  EXPECT_EQ(10, window.begin()->first);
+
+  // Too old to fit in the window.
+  EXPECT_TRUE(window.insert(std::make_pair(0, 0)).first == window.end());
+  EXPECT_TRUE(window.insert(std::make_pair(1, 1)).second);
+  EXPECT_EQ(1, window.begin()->first);
+  EXPECT_FALSE(window.insert(std::make_pair(1, 2)).second);
+  EXPECT_EQ(1, window.find(1)->second);
+
+  // Jumping far ahead evicts everything.
+  window[1000] = 1000;
+  EXPECT_EQ(1u, window.size());
+  EXPECT_EQ(1000, window.begin()->first);
+}
+
+TEST_F(TestSeqNumUtil, SeqNumWindowSkipsEmptySlots) {
+  SeqNumWindow<uint16_t, int, 256> window;
+  window[0xfff0] = 0;
+  window[200] = 1;
+  window[130] = 2;
+  auto it = window.begin();
+  EXPECT_EQ(0xfff0, it->first);
+  EXPECT_EQ(130, (++it)->first);
+  EXPECT_EQ(200, (++it)->first);
+  EXPECT_TRUE(++it == window.end());
+
+  window.erase(200);
+  window.erase(130);
+  window[1] = 3;
+  it = window.begin();
+  EXPECT_EQ(0xfff0, it->first);
+  EXPECT_EQ(1, (++it)->first);
+  EXPECT_TRUE(++it == window.end());
+}
+
 }  // namespace webrtc
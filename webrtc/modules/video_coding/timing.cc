@@ -30,6 +30,7 @@ VCMTiming::VCMTiming(Clock* clock, VCMTiming* master_timing)
       min_playout_delay_ms_(0),
       max_playout_delay_ms_(10000),
       jitter_delay_ms_(0),
+      max_jitter_delay_ms_(-1),
       current_delay_ms_(0),
       last_decode_ms_(0),
       prev_frame_timestamp_(0),
@@ -119,6 +120,8 @@ int VCMTiming::max_playout_delay() {
 
 void VCMTiming::SetJitterDelay(int jitter_delay_ms) {
   CriticalSectionScoped cs(crit_sect_);
+  if (max_jitter_delay_ms_ >= 0)
+    jitter_delay_ms = std::min(jitter_delay_ms, max_jitter_delay_ms_);
   if (jitter_delay_ms != jitter_delay_ms_) {
     jitter_delay_ms_ = jitter_delay_ms;
     // When in initial state, set current delay to minimum delay.
@@ -128,6 +131,11 @@ void VCMTiming::SetJitterDelay(int jitter_delay_ms) {
   }
 }
 
+void VCMTiming::set_max_jitter_delay(int max_jitter_delay_ms) {
+  CriticalSectionScoped cs(crit_sect_);
+  max_jitter_delay_ms_ = max_jitter_delay_ms;
+}
+
 void VCMTiming::UpdateCurrentDelay(uint32_t frame_timestamp) {
   CriticalSectionScoped cs(crit_sect_);
   int target_delay_ms = TargetDelayInternal();
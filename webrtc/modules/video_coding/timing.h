@@ -41,6 +41,10 @@ class VCMTiming {
   // get the desired jitter buffer level.
   void SetJitterDelay(int required_delay_ms);
 
+  // Caps the jitter delay set by SetJitterDelay(). A negative value, which is
+  // the default, leaves the jitter delay uncapped.
+  void set_max_jitter_delay(int max_jitter_delay_ms);
+
   // Set the minimum playout delay from capture to render in ms.
   void set_min_playout_delay(int min_playout_delay_ms);
 
@@ -127,6 +131,7 @@ class VCMTiming {
   int min_playout_delay_ms_ GUARDED_BY(crit_sect_);
   int max_playout_delay_ms_ GUARDED_BY(crit_sect_);
   int jitter_delay_ms_ GUARDED_BY(crit_sect_);
+  int max_jitter_delay_ms_ GUARDED_BY(crit_sect_);
   int current_delay_ms_ GUARDED_BY(crit_sect_);
   int last_decode_ms_ GUARDED_BY(crit_sect_);
   uint32_t prev_frame_timestamp_ GUARDED_BY(crit_sect_);
@@ -146,4 +146,17 @@ TEST(ReceiverTiming, WrapAround) {
   }
 }
 
+TEST(ReceiverTiming, MaxJitterDelay) {
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  timing.set_render_delay(0);
+  timing.set_max_jitter_delay(30);
+  timing.SetJitterDelay(100);
+  EXPECT_EQ(30, timing.TargetVideoDelay());
+
+  timing.set_max_jitter_delay(-1);
+  timing.SetJitterDelay(100);
+  EXPECT_EQ(100, timing.TargetVideoDelay());
+}
+
 }  // namespace webrtc
@@ -14,6 +14,8 @@
 
 #include <algorithm>
 
+#include "webrtc/common_video/include/scale_pyramid_buffer.h"
+
 // TODO(kthelgason): Some versions of Android have issues with log2.
 // See https://code.google.com/p/android/issues/detail?id=212634 for details
 #if defined(WEBRTC_ANDROID)
@@ -176,6 +178,8 @@ rtc::scoped_refptr<VideoFrameBuffer> QualityScaler::GetScaledBuffer(
 
   if (res.width == src_width && res.height == src_height)
     return frame;
+  if (frame->scale_pyramid())
+    return frame->scale_pyramid()->ScaledBuffer(res.width, res.height);
   rtc::scoped_refptr<I420Buffer> scaled_buffer =
       pool_.CreateBuffer(res.width, res.height);
 
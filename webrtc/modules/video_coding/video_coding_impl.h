@@ -151,6 +151,7 @@ class VideoReceiver : public Module {
                          const WebRtcRTPHeader& rtpInfo);
   int32_t SetMinimumPlayoutDelay(uint32_t minPlayoutDelayMs);
   int32_t SetRenderDelay(uint32_t timeMS);
+  void SetLowLatencyMode(int max_jitter_delay_ms);
   int32_t Delay() const;
   uint32_t DiscardedPackets() const;
 
@@ -304,6 +304,38 @@ TEST_F(TestPacketBuffer, GetBitstreamFromFrame) {
   EXPECT_EQ(memcmp(result, "many bitstream, such data", sizeof(result)), 0);
 }
 
+TEST_F(TestPacketBuffer, FrameHoldsBitstream) {
+  uint8_t first[] = {1, 2, 3};
+  uint8_t second[] = {4, 5};
+  uint16_t seq_num = Rand();
+
+  InsertPacket(seq_num, kKeyFrame, kFirst, kNotLast, sizeof(first), first);
+  InsertPacket(seq_num + 1, kKeyFrame, kNotFirst, kLast, sizeof(second),
+               second);
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+  const RtpFrameObject& frame = *frames_from_callback_[seq_num];
+  const uint8_t expected[] = {1, 2, 3, 4, 5};
+  ASSERT_EQ(sizeof(expected), frame.Length());
+  EXPECT_EQ(0, memcmp(expected, frame.Buffer(), sizeof(expected)));
+}
+
+TEST_F(TestPacketBuffer, ReusesBitstreamBufferOfReturnedFrame) {
+  uint8_t data[] = {1, 2, 3, 4};
+  uint16_t seq_num = Rand();
+
+  InsertPacket(seq_num, kKeyFrame, kFirst, kLast, sizeof(data), data);
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+  const uint8_t* buffer = frames_from_callback_[seq_num]->Buffer();
+  frames_from_callback_.clear();
+
+  // A smaller frame fits in the buffer of the returned one.
+  InsertPacket(seq_num + 1, kDeltaFrame, kFirst, kLast, sizeof(data) - 1,
+               data);
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+  EXPECT_EQ(buffer, frames_from_callback_[seq_num + 1]->Buffer());
+  EXPECT_EQ(sizeof(data) - 1, frames_from_callback_[seq_num + 1]->Length());
+}
+
 TEST_F(TestPacketBuffer, FreeSlotsOnFrameDestruction) {
   uint16_t seq_num = Rand();
 
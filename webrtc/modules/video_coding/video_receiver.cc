@@ -434,6 +434,17 @@ int32_t VideoReceiver::SetRenderDelay(uint32_t timeMS) {
   return VCM_OK;
 }
 
+// Frames are decoded as soon as they are decodable and rendered on arrival,
+// without any delay to absorb network jitter. The jitter delay still counts
+// towards VideoCodingModule::Delay(), which sets the audio delay needed for
+// lip-sync, so it is capped at |max_jitter_delay_ms|.
+void VideoReceiver::SetLowLatencyMode(int max_jitter_delay_ms) {
+  // A max playout delay of 0 makes VCMTiming render a frame when it is
+  // estimated to be complete, so there is no time to wait for it either.
+  _timing.set_max_playout_delay(0);
+  _timing.set_max_jitter_delay(max_jitter_delay_ms);
+}
+
 // Current video delay
 int32_t VideoReceiver::Delay() const {
   return _timing.TargetVideoDelay();
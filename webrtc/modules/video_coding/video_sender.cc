@@ -294,6 +294,8 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
       LOG(LS_ERROR) << "Frame conversion failed, dropping frame.";
       return VCM_PARAMETER_ERROR;
     }
+    if (send_stats_callback_)
+      send_stats_callback_->OnNativeToI420Conversion();
     converted_frame = VideoFrame(converted_buffer,
                                  converted_frame.timestamp(),
                                  converted_frame.render_time_ms(),
@@ -11,6 +11,7 @@
 #include "webrtc/modules/video_processing/frame_preprocessor.h"
 
 #include "webrtc/modules/video_processing/video_denoiser.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 
 namespace webrtc {
 
@@ -77,7 +78,8 @@ uint32_t VPMFramePreprocessor::GetDecimatedHeight() const {
 
 void VPMFramePreprocessor::EnableDenoising(bool enable) {
   if (enable) {
-    denoiser_.reset(new VideoDenoiser(true));
+    denoiser_.reset(
+        new VideoDenoiser(true, CpuInfo::DetectNumberOfCores()));
   } else {
     denoiser_.reset();
   }
@@ -94,29 +96,20 @@ const VideoFrame* VPMFramePreprocessor::PreprocessFrame(
     return nullptr;
   }
 
+  // Denoising cost is proportional to the number of pixels, so when the
+  // frame is going to be downscaled, denoise the smaller frame instead.
+  const bool resample = spatial_resampler_->ApplyResample(frame.width(),
+                                                          frame.height());
+  const bool denoise_after_resample =
+      resample &&
+      spatial_resampler_->TargetWidth() * spatial_resampler_->TargetHeight() <
+          frame.width() * frame.height();
+
   const VideoFrame* current_frame = &frame;
-  if (denoiser_) {
-    rtc::scoped_refptr<I420Buffer>* denoised_buffer = &denoised_buffer_[0];
-    rtc::scoped_refptr<I420Buffer>* denoised_buffer_prev = &denoised_buffer_[1];
-    // Swap the buffer to save one memcpy in DenoiseFrame.
-    if (denoised_frame_toggle_) {
-      denoised_buffer = &denoised_buffer_[1];
-      denoised_buffer_prev = &denoised_buffer_[0];
-    }
-    // Invert the flag.
-    denoised_frame_toggle_ ^= 1;
-    denoiser_->DenoiseFrame(current_frame->video_frame_buffer(),
-                            denoised_buffer,
-                            denoised_buffer_prev, true);
-    denoised_frame_ = VideoFrame(*denoised_buffer,
-                                 current_frame->timestamp(),
-                                 current_frame->render_time_ms(),
-                                 current_frame->rotation());
-    current_frame = &denoised_frame_;
-  }
+  if (denoiser_ && !denoise_after_resample)
+    current_frame = DenoiseFrame(*current_frame);
 
-  if (spatial_resampler_->ApplyResample(current_frame->width(),
-                                        current_frame->height())) {
+  if (resample) {
     if (spatial_resampler_->ResampleFrame(*current_frame, &resampled_frame_) !=
         VPM_OK) {
       return nullptr;
@@ -124,8 +117,28 @@ const VideoFrame* VPMFramePreprocessor::PreprocessFrame(
     current_frame = &resampled_frame_;
   }
 
+  if (denoiser_ && denoise_after_resample)
+    current_frame = DenoiseFrame(*current_frame);
+
   ++frame_cnt_;
   return current_frame;
 }
 
+const VideoFrame* VPMFramePreprocessor::DenoiseFrame(const VideoFrame& frame) {
+  rtc::scoped_refptr<I420Buffer>* denoised_buffer = &denoised_buffer_[0];
+  rtc::scoped_refptr<I420Buffer>* denoised_buffer_prev = &denoised_buffer_[1];
+  // Swap the buffer to save one memcpy in DenoiseFrame.
+  if (denoised_frame_toggle_) {
+    denoised_buffer = &denoised_buffer_[1];
+    denoised_buffer_prev = &denoised_buffer_[0];
+  }
+  // Invert the flag.
+  denoised_frame_toggle_ ^= 1;
+  denoiser_->DenoiseFrame(frame.video_frame_buffer(), denoised_buffer,
+                          denoised_buffer_prev, true);
+  denoised_frame_ = VideoFrame(*denoised_buffer, frame.timestamp(),
+                               frame.render_time_ms(), frame.rotation());
+  return &denoised_frame_;
+}
+
 }  // namespace webrtc
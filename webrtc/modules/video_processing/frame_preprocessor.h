@@ -61,6 +61,10 @@ class VPMFramePreprocessor {
   // we can compute new content metrics every |kSkipFrameCA| frames.
   enum { kSkipFrameCA = 2 };
 
+  // Runs the denoiser on |frame| and returns the denoised frame, which stays
+  // valid until the next call.
+  const VideoFrame* DenoiseFrame(const VideoFrame& frame);
+
   rtc::scoped_refptr<I420Buffer> denoised_buffer_[2];
   VideoFrame denoised_frame_;
   VideoFrame resampled_frame_;
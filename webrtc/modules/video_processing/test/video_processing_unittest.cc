@@ -116,6 +116,25 @@ TEST_F(VideoProcessingTest, PreprocessorLogic) {
   EXPECT_TRUE(vp_->PreprocessFrame(video_frame_) != nullptr);
 }
 
+#if defined(WEBRTC_IOS)
+TEST_F(VideoProcessingTest, DISABLED_DenoiseAndDownscale) {
+#else
+TEST_F(VideoProcessingTest, DenoiseAndDownscale) {
+#endif
+  vp_->EnableTemporalDecimation(false);
+  vp_->EnableDenoising(true);
+  video_frame_.set_timestamp(90000);
+  // The denoiser runs on the downscaled frame, so the output keeps the target
+  // size from the first frame on, including when the denoiser is reset.
+  for (int i = 0; i < 3; ++i) {
+    PreprocessFrameAndVerify(video_frame_, width_ / 2, height_ / 2, vp_,
+                             nullptr);
+  }
+  // Upscaling denoises the source frame before scaling it.
+  PreprocessFrameAndVerify(video_frame_, width_ * 2, height_ * 2, vp_, nullptr);
+  vp_->EnableDenoising(false);
+}
+
 #if defined(WEBRTC_IOS)
 TEST_F(VideoProcessingTest, DISABLED_Resampler) {
 #else
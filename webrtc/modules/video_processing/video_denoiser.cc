@@ -8,11 +8,27 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/video_processing/video_denoiser.h"
 
+#include <string.h>
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/event.h"
+#include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
+
 namespace webrtc {
 
+namespace {
+// More threads don't pay off, the work after the filtering of the blocks and
+// the copy of the chroma planes are done on the calling thread.
+const int kMaxDenoiserThreads = 4;
+// Stripes are at least 128 lines, so that small frames, where the cost of
+// posting the tasks outweighs the filtering, are denoised on one thread.
+const int kMinMbRowsPerStripe = 8;
+}  // namespace
+
 #if DISPLAY || DISPLAYNEON
 static void CopyMem8x8(const uint8_t* src,
                        int src_stride,
@@ -68,10 +84,19 @@ static void ShowRect(const std::unique_ptr<DenoiserFilter>& filter,
 #endif
 
 VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection)
+    : VideoDenoiser(runtime_cpu_detection, 1) {}
+
+VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection, int num_threads)
     : width_(0),
       height_(0),
       filter_(DenoiserFilter::Create(runtime_cpu_detection, &cpu_type_)),
-      ne_(new NoiseEstimation()) {}
+      ne_(new NoiseEstimation()) {
+  num_threads = std::min(num_threads, kMaxDenoiserThreads);
+  for (int i = 1; i < num_threads; ++i)
+    stripe_queues_.emplace_back(new rtc::TaskQueue("DenoiserQueue"));
+}
+
+VideoDenoiser::~VideoDenoiser() {}
 
 void VideoDenoiser::DenoiserReset(
     const rtc::scoped_refptr<VideoFrameBuffer>& frame,
@@ -98,9 +123,16 @@ void VideoDenoiser::DenoiserReset(
   x_density_.reset(new uint8_t[mb_cols_]);
   y_density_.reset(new uint8_t[mb_rows_]);
   moving_object_.reset(new uint8_t[mb_cols_ * mb_rows_]);
+  mb_mod_var_.reset(new uint32_t[mb_cols_ * mb_rows_]);
+  mb_noise_var_.reset(new uint32_t[mb_cols_ * mb_rows_]);
+  mb_luma_.reset(new uint32_t[mb_cols_ * mb_rows_]);
+  prev_src_y_.reset(new uint8_t[stride_y_ * height_]);
+  memcpy(prev_src_y_.get(), frame->DataY(), stride_y_ * height_);
 }
 
-int VideoDenoiser::PositionCheck(int mb_row, int mb_col, int noise_level) {
+int VideoDenoiser::PositionCheck(int mb_row,
+                                 int mb_col,
+                                 int noise_level) const {
   if (noise_level == 0)
     return 1;
   if ((mb_row <= (mb_rows_ >> 4)) || (mb_col <= (mb_cols_ >> 4)) ||
@@ -219,6 +251,74 @@ void VideoDenoiser::CopyLumaOnMargin(const uint8_t* y_src, uint8_t* y_dst) {
   }
 }
 
+bool VideoDenoiser::IsStaticBlock(const uint8_t* y_src, int offset) const {
+  const uint8_t* src = y_src + offset;
+  const uint8_t* prev_src = prev_src_y_.get() + offset;
+  for (int i = 0; i < 16; ++i) {
+    if (memcmp(src, prev_src, 16) != 0)
+      return false;
+    src += stride_y_;
+    prev_src += stride_y_;
+  }
+  return true;
+}
+
+void VideoDenoiser::DenoiseStripe(int mb_row_start,
+                                  int mb_row_end,
+                                  const uint8_t* y_src,
+                                  uint8_t* y_dst,
+                                  uint8_t* y_dst_prev,
+                                  uint8_t noise_level) {
+  for (int mb_row = mb_row_start; mb_row < mb_row_end; ++mb_row) {
+    const int mb_index_base = mb_row * mb_cols_;
+    const int offset_base = (mb_row << 4) * stride_y_;
+    for (int mb_col = 0; mb_col < mb_cols_; ++mb_col) {
+      const int mb_index = mb_index_base + mb_col;
+      const bool ne_enable = (mb_index % NOISE_SUBSAMPLE_INTERVAL == 0);
+      const int offset = offset_base + (mb_col << 4);
+      const uint8_t* mb_src = y_src + offset;
+      uint8_t* mb_dst = y_dst + offset;
+      uint8_t* mb_dst_prev = y_dst_prev + offset;
+
+      // TODO(jackychen): Need SSE2/NEON opt.
+      if (ne_enable) {
+        uint32_t luma = 0;
+        for (int i = 4; i < 12; ++i) {
+          for (int j = 4; j < 12; ++j) {
+            luma += mb_src[i * stride_y_ + j];
+          }
+        }
+        mb_luma_[mb_index] = luma;
+      }
+
+      if (IsStaticBlock(y_src, offset)) {
+        // The source block hasn't changed, reuse its denoised output.
+        filter_->CopyMem16x16(mb_dst_prev, stride_y_, mb_dst, stride_y_);
+        mb_filter_decision_[mb_index] = FILTER_BLOCK;
+      } else {
+        // Get the filtered block and filter_decision.
+        mb_filter_decision_[mb_index] =
+            filter_->MbDenoise(mb_dst_prev, stride_y_, mb_dst, stride_y_,
+                               mb_src, stride_y_, 0, noise_level);
+      }
+
+      uint32_t sse_t = 0;
+      if (mb_filter_decision_[mb_index] != FILTER_BLOCK) {
+        // The variance used in MOD is based on the filtered blocks in time
+        // T (mb_dst) and T-1 (mb_dst_prev).
+        mb_mod_var_[mb_index] = filter_->Variance16x8(
+            mb_dst_prev, stride_y_, mb_dst, stride_y_, &sse_t);
+      }
+      if (ne_enable) {
+        // The variance used in noise estimation is based on the src block in
+        // time t (mb_src) and filtered block in time t-1 (mb_dist_prev).
+        mb_noise_var_[mb_index] = filter_->Variance16x8(
+            mb_dst_prev, stride_y_, mb_src, stride_y_, &sse_t);
+      }
+    }
+  }
+}
+
 void VideoDenoiser::DenoiseFrame(
     const rtc::scoped_refptr<VideoFrameBuffer>& frame,
     rtc::scoped_refptr<I420Buffer>* denoised_frame,
@@ -244,76 +344,59 @@ void VideoDenoiser::DenoiseFrame(
   memset(moving_object_.get(), 1, mb_cols_ * mb_rows_);
 
   uint8_t noise_level = noise_estimation_enabled ? ne_->GetNoiseLevel() : 0;
-  int thr_var_base = 16 * 16 * 2;
+  // Filter the blocks, in parallel stripes for large frames.
+  const int num_stripes = std::max(
+      1, std::min(static_cast<int>(stripe_queues_.size()) + 1,
+                  mb_rows_ / kMinMbRowsPerStripe));
+  const int mb_rows_per_stripe = mb_rows_ / num_stripes;
+  std::vector<std::unique_ptr<rtc::Event>> stripes_done;
+  for (int i = 1; i < num_stripes; ++i) {
+    const int mb_row_start = i * mb_rows_per_stripe;
+    const int mb_row_end =
+        i == num_stripes - 1 ? mb_rows_ : mb_row_start + mb_rows_per_stripe;
+    rtc::Event* done = new rtc::Event(false, false);
+    stripes_done.emplace_back(done);
+    stripe_queues_[i - 1]->PostTask([this, mb_row_start, mb_row_end, y_src,
+                                     y_dst, y_dst_prev, noise_level, done] {
+      DenoiseStripe(mb_row_start, mb_row_end, y_src, y_dst, y_dst_prev,
+                    noise_level);
+      done->Set();
+    });
+  }
+  DenoiseStripe(0, mb_rows_per_stripe, y_src, y_dst, y_dst_prev, noise_level);
+  for (const auto& done : stripes_done)
+    done->Wait(rtc::Event::kForever);
+
   // Loop over blocks to accumulate/extract noise level and update x/y_density
   // factors for moving object detection.
+  const int thr_var_base = 16 * 16 * 2;
   for (int mb_row = 0; mb_row < mb_rows_; ++mb_row) {
     const int mb_index_base = mb_row * mb_cols_;
-    const int offset_base = (mb_row << 4) * stride_y_;
-    const uint8_t* mb_src_base = y_src + offset_base;
-    uint8_t* mb_dst_base = y_dst + offset_base;
-    uint8_t* mb_dst_prev_base = y_dst_prev + offset_base;
     for (int mb_col = 0; mb_col < mb_cols_; ++mb_col) {
       const int mb_index = mb_index_base + mb_col;
       const bool ne_enable = (mb_index % NOISE_SUBSAMPLE_INTERVAL == 0);
       const int pos_factor = PositionCheck(mb_row, mb_col, noise_level);
       const uint32_t thr_var_adp = thr_var_base * pos_factor;
-      const uint32_t offset_col = mb_col << 4;
-      const uint8_t* mb_src = mb_src_base + offset_col;
-      uint8_t* mb_dst = mb_dst_base + offset_col;
-      uint8_t* mb_dst_prev = mb_dst_prev_base + offset_col;
-
-      // TODO(jackychen): Need SSE2/NEON opt.
-      int luma = 0;
-      if (ne_enable) {
-        for (int i = 4; i < 12; ++i) {
-          for (int j = 4; j < 12; ++j) {
-            luma += mb_src[i * stride_y_ + j];
-          }
-        }
-      }
-
-      // Get the filtered block and filter_decision.
-      mb_filter_decision_[mb_index] =
-          filter_->MbDenoise(mb_dst_prev, stride_y_, mb_dst, stride_y_, mb_src,
-                             stride_y_, 0, noise_level);
 
       // If filter decision is FILTER_BLOCK, no need to check moving edge.
       // It is unlikely for a moving edge block to be filtered in current
       // setting.
       if (mb_filter_decision_[mb_index] == FILTER_BLOCK) {
-        uint32_t sse_t = 0;
+        if (ne_enable)
+          ne_->GetNoise(mb_index, mb_noise_var_[mb_index], mb_luma_[mb_index]);
+        moving_edge_[mb_index] = 0;  // Not a moving edge block.
+      } else if (mb_mod_var_[mb_index] > thr_var_adp) {
+        // Moving edge checking.
         if (ne_enable) {
-          // The variance used in noise estimation is based on the src block in
-          // time t (mb_src) and filtered block in time t-1 (mb_dist_prev).
-          uint32_t noise_var = filter_->Variance16x8(mb_dst_prev, stride_y_,
-                                                     mb_src, stride_y_, &sse_t);
-          ne_->GetNoise(mb_index, noise_var, luma);
+          ne_->ResetConsecLowVar(mb_index);
         }
-        moving_edge_[mb_index] = 0;  // Not a moving edge block.
+        moving_edge_[mb_index] = 1;  // Mark as moving edge block.
+        x_density_[mb_col] += (pos_factor < 3);
+        y_density_[mb_row] += (pos_factor < 3);
       } else {
-        uint32_t sse_t = 0;
-        // The variance used in MOD is based on the filtered blocks in time
-        // T (mb_dst) and T-1 (mb_dst_prev).
-        uint32_t noise_var = filter_->Variance16x8(mb_dst_prev, stride_y_,
-                                                   mb_dst, stride_y_, &sse_t);
-        if (noise_var > thr_var_adp) {  // Moving edge checking.
-          if (ne_enable) {
-            ne_->ResetConsecLowVar(mb_index);
-          }
-          moving_edge_[mb_index] = 1;  // Mark as moving edge block.
-          x_density_[mb_col] += (pos_factor < 3);
-          y_density_[mb_row] += (pos_factor < 3);
-        } else {
-          moving_edge_[mb_index] = 0;
-          if (ne_enable) {
-            // The variance used in noise estimation is based on the src block
-            // in time t (mb_src) and filtered block in time t-1 (mb_dist_prev).
-            uint32_t noise_var = filter_->Variance16x8(
-                mb_dst_prev, stride_y_, mb_src, stride_y_, &sse_t);
-            ne_->GetNoise(mb_index, noise_var, luma);
-          }
-        }
+        moving_edge_[mb_index] = 0;
+        if (ne_enable)
+          ne_->GetNoise(mb_index, mb_noise_var_[mb_index], mb_luma_[mb_index]);
       }
     }  // End of for loop
   }    // End of for loop
@@ -332,6 +415,8 @@ void VideoDenoiser::DenoiseFrame(
   memcpy(u_dst, u_src, (height_ >> 1) * stride_u_);
   memcpy(v_dst, v_src, (height_ >> 1) * stride_v_);
 
+  memcpy(prev_src_y_.get(), y_src, stride_y_ * height_);
+
 #if DISPLAY || DISPLAYNEON
   // Show rectangular region
   ShowRect(filter_, moving_edge_, moving_object_, x_density_, y_density_, u_src,
@@ -12,7 +12,10 @@
 #define WEBRTC_MODULES_VIDEO_PROCESSING_VIDEO_DENOISER_H_
 
 #include <memory>
+#include <vector>
 
+#include "webrtc/base/task_queue.h"
+#include "webrtc/common_video/include/video_frame_buffer.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter.h"
 #include "webrtc/modules/video_processing/util/noise_estimation.h"
 #include "webrtc/modules/video_processing/util/skin_detection.h"
@@ -22,6 +25,10 @@ namespace webrtc {
 class VideoDenoiser {
  public:
   explicit VideoDenoiser(bool runtime_cpu_detection);
+  // |num_threads| > 1 denoises large frames in horizontal stripes of
+  // macroblock rows, processed in parallel.
+  VideoDenoiser(bool runtime_cpu_detection, int num_threads);
+  ~VideoDenoiser();
 
   // TODO(nisse): Let the denoised_frame and denoised_frame_prev be
   // member variables referencing two I420Buffer, and return a refptr
@@ -39,10 +46,24 @@ class VideoDenoiser {
                      rtc::scoped_refptr<I420Buffer>* denoised_frame,
                      rtc::scoped_refptr<I420Buffer>* denoised_frame_prev);
 
+  // Filter the blocks of macroblock rows [mb_row_start, mb_row_end) and save
+  // the per block decisions and variances. Only touches the blocks of its own
+  // rows, so that stripes can be processed in parallel.
+  void DenoiseStripe(int mb_row_start,
+                     int mb_row_end,
+                     const uint8_t* y_src,
+                     uint8_t* y_dst,
+                     uint8_t* y_dst_prev,
+                     uint8_t noise_level);
+
+  // Return true if the luma block at |offset| is unchanged since the previous
+  // source frame, in which case its previous denoised output is reused.
+  bool IsStaticBlock(const uint8_t* y_src, int offset) const;
+
   // Check the mb position, return 1: close to the frame center (between 1/8
   // and 7/8 of width/height), 3: close to the border (out of 1/16 and 15/16
   // of width/height), 2: in between.
-  int PositionCheck(int mb_row, int mb_col, int noise_level);
+  int PositionCheck(int mb_row, int mb_col, int noise_level) const;
 
   // To reduce false detection in moving object detection (MOD).
   void ReduceFalseDetection(const std::unique_ptr<uint8_t[]>& d_status,
@@ -80,6 +101,16 @@ class VideoDenoiser {
   std::unique_ptr<uint8_t[]> y_density_;
   // Save the return values by MbDenoise for each block.
   std::unique_ptr<DenoiserDecision[]> mb_filter_decision_;
+  // Variance of each block used in MOD, only set for blocks not filtered.
+  std::unique_ptr<uint32_t[]> mb_mod_var_;
+  // Variance and luma of the blocks sampled for noise estimation.
+  std::unique_ptr<uint32_t[]> mb_noise_var_;
+  std::unique_ptr<uint32_t[]> mb_luma_;
+  // Luma plane of the previous source frame, to detect static blocks.
+  std::unique_ptr<uint8_t[]> prev_src_y_;
+  // Queues for all but the first stripe, which is denoised on the calling
+  // thread.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> stripe_queues_;
 };
 
 }  // namespace webrtc
@@ -154,6 +154,26 @@ TEST_F(AsyncStunTCPSocketTest, TestMultipleStunPackets) {
   EXPECT_EQ(4u, recv_packets_.size());
 }
 
+// Verify that packets which arrive in a single read are all delivered, in
+// order, including one that needs padding.
+TEST_F(AsyncStunTCPSocketTest, TestMultiplePacketsInOneRead) {
+  rtc::PacketOptions options;
+  send_socket_->Send(kStunMessageWithZeroLength,
+                     sizeof(kStunMessageWithZeroLength), options);
+  send_socket_->Send(kTurnChannelDataMessageWithOddLength,
+                     sizeof(kTurnChannelDataMessageWithOddLength), options);
+  send_socket_->Send(kTurnChannelDataMessage, sizeof(kTurnChannelDataMessage),
+                     options);
+  vss_->ProcessMessagesUntilIdle();
+  EXPECT_EQ(3u, recv_packets_.size());
+  EXPECT_TRUE(CheckData(kStunMessageWithZeroLength,
+                        sizeof(kStunMessageWithZeroLength)));
+  EXPECT_TRUE(CheckData(kTurnChannelDataMessageWithOddLength,
+                        sizeof(kTurnChannelDataMessageWithOddLength)));
+  EXPECT_TRUE(CheckData(kTurnChannelDataMessage,
+                        sizeof(kTurnChannelDataMessage)));
+}
+
 // Verifying TURN channel data message with zero length.
 TEST_F(AsyncStunTCPSocketTest, TestTurnChannelDataWithZeroLength) {
   EXPECT_TRUE(Send(kTurnChannelDataMessageWithZeroLength,
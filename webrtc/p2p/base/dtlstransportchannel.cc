@@ -21,6 +21,8 @@
 #include "webrtc/base/sslstreamadapter.h"
 #include "webrtc/base/stream.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/system_wrappers/include/field_trial.h"
 
 namespace cricket {
 
@@ -278,6 +280,9 @@ bool DtlsTransportChannelWrapper::SetupDtls() {
   dtls_->SetIdentity(local_certificate_->identity()->GetReference());
   dtls_->SetMode(rtc::SSL_MODE_DTLS);
   dtls_->SetMaxProtocolVersion(ssl_max_version_);
+  dtls_->SetSessionResumptionEnabled(
+      webrtc::field_trial::FindFullName("WebRTC-DtlsSessionResumption") ==
+      "Enabled");
   dtls_->SetServerRole(ssl_role_);
   dtls_->SignalEvent.connect(this, &DtlsTransportChannelWrapper::OnDtlsEvent);
   dtls_->SignalSSLHandshakeError.connect(
@@ -489,31 +494,29 @@ void DtlsTransportChannelWrapper::OnReadPacket(
     case DTLS_TRANSPORT_CONNECTING:
     case DTLS_TRANSPORT_CONNECTED:
       // We should only get DTLS or SRTP packets; STUN's already been demuxed.
-      // Is this potentially a DTLS packet?
-      if (IsDtlsPacket(data, size)) {
-        if (!HandleDtlsPacket(data, size)) {
-          LOG_J(LS_ERROR, this) << "Failed to handle DTLS packet.";
-          return;
-        }
-      } else {
-        // Not a DTLS packet; our handshake should be complete by now.
+      // The first byte tells them apart (RFC 7983), and SRTP is checked first
+      // since it's what almost every packet is once the handshake is done.
+      if (IsRtpPacket(data, size)) {
+        // SRTP is only expected once the handshake is complete.
         if (dtls_state() != DTLS_TRANSPORT_CONNECTED) {
           LOG_J(LS_ERROR, this) << "Received non-DTLS packet before DTLS "
                                 << "complete.";
           return;
         }
 
-        // And it had better be a SRTP packet.
-        if (!IsRtpPacket(data, size)) {
-          LOG_J(LS_ERROR, this) << "Received unexpected non-DTLS packet.";
-          return;
-        }
-
         // Sanity check.
         ASSERT(!srtp_ciphers_.empty());
 
         // Signal this upwards as a bypass packet.
         SignalReadPacket(this, data, size, packet_time, PF_SRTP_BYPASS);
+      } else if (IsDtlsPacket(data, size)) {
+        if (!HandleDtlsPacket(data, size)) {
+          LOG_J(LS_ERROR, this) << "Failed to handle DTLS packet.";
+          return;
+        }
+      } else {
+        LOG_J(LS_ERROR, this) << "Received unexpected non-DTLS packet.";
+        return;
       }
       break;
     case DTLS_TRANSPORT_FAILED:
@@ -543,7 +546,10 @@ void DtlsTransportChannelWrapper::OnDtlsEvent(rtc::StreamInterface* dtls,
   ASSERT(dtls == dtls_.get());
   if (sig & rtc::SE_OPEN) {
     // This is the first time.
-    LOG_J(LS_INFO, this) << "DTLS handshake complete.";
+    LOG_J(LS_INFO, this) << "DTLS handshake complete after "
+                         << rtc::TimeSince(handshake_start_time_ms_) << " ms"
+                         << (dtls_->IsSessionResumed() ? " (resumed)" : "")
+                         << ".";
     if (dtls_->GetState() == rtc::SS_OPEN) {
       // The check for OPEN shouldn't be necessary but let's make
       // sure we don't accidentally frob the state if it's closed.
@@ -588,6 +594,7 @@ void DtlsTransportChannelWrapper::MaybeStartDtls() {
     LOG_J(LS_INFO, this)
       << "DtlsTransportChannelWrapper: Started DTLS handshake";
     set_dtls_state(DTLS_TRANSPORT_CONNECTING);
+    handshake_start_time_ms_ = rtc::TimeMillis();
     // Now that the handshake has started, we can process a cached ClientHello
     // (if one exists).
     if (cached_client_hello_.size()) {
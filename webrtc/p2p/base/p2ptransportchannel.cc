@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <set>
+#include <tuple>
 
 #include "webrtc/base/common.h"
 #include "webrtc/base/crc32.h"
@@ -20,6 +21,7 @@
 #include "webrtc/p2p/base/candidate.h"
 #include "webrtc/p2p/base/candidatepairinterface.h"
 #include "webrtc/p2p/base/common.h"
+#include "webrtc/p2p/base/pingscheduler.h"
 #include "webrtc/p2p/base/relayport.h"  // For RELAY_PORT_TYPE.
 #include "webrtc/p2p/base/stunport.h"   // For STUN_PORT_TYPE.
 #include "webrtc/system_wrappers/include/field_trial.h"
@@ -36,6 +38,10 @@ enum {
 // The minimum improvement in RTT that justifies a switch.
 const int kMinImprovement = 10;
 
+// If more than 1 in this many connections changed since the last sort, they
+// are all sorted again rather than placed one by one.
+const size_t kFullSortRatio = 4;
+
 bool IsRelayRelay(const cricket::Connection* conn) {
   return conn->local_candidate().type() == cricket::RELAY_PORT_TYPE &&
          conn->remote_candidate().type() == cricket::RELAY_PORT_TYPE;
@@ -412,6 +418,12 @@ void P2PTransportChannel::SetIceConfig(const IceConfig& config) {
     }
   }
 
+  if (config.ping_scheduler &&
+      config_.ping_scheduler != config.ping_scheduler) {
+    config_.ping_scheduler = config.ping_scheduler;
+    LOG(LS_INFO) << "Set ping scheduler";
+  }
+
   if (config.regather_on_failed_networks_interval) {
     config_.regather_on_failed_networks_interval =
         config.regather_on_failed_networks_interval;
@@ -520,7 +532,8 @@ void P2PTransportChannel::OnPortReady(PortAllocatorSession *session,
     CreateConnection(port, *iter, iter->origin_port());
   }
 
-  SortConnectionsAndUpdateState();
+  // Ports tend to become ready in bursts; sort once for all of them.
+  RequestSortAndStateUpdate();
 }
 
 // A new candidate is available, let listeners know
@@ -670,7 +683,7 @@ void P2PTransportChannel::OnUnknownAddress(
   // Update the list of connections since we just added another.  We do this
   // after sending the response since it could (in principle) delete the
   // connection in question.
-  SortConnectionsAndUpdateState();
+  RequestSortAndStateUpdate();
 }
 
 void P2PTransportChannel::OnRoleConflict(PortInterface* port) {
@@ -1207,6 +1220,48 @@ bool P2PTransportChannel::PresumedWritable(const Connection* conn) const {
            conn->remote_candidate().type() == PRFLX_PORT_TYPE));
 }
 
+bool P2PTransportChannel::SortKey::operator==(const SortKey& other) const {
+  return std::tie(ice_role, writable, write_state, receiving, connected,
+                  remote_nomination, last_data_received, network_cost,
+                  priority, generation, rtt) ==
+         std::tie(other.ice_role, other.writable, other.write_state,
+                  other.receiving, other.connected, other.remote_nomination,
+                  other.last_data_received, other.network_cost, other.priority,
+                  other.generation, other.rtt);
+}
+
+P2PTransportChannel::SortKey P2PTransportChannel::GetSortKey(
+    const Connection* conn) const {
+  SortKey key;
+  key.ice_role = ice_role_;
+  key.writable = conn->writable() || PresumedWritable(conn);
+  key.write_state = conn->write_state();
+  key.receiving = conn->receiving();
+  key.connected = conn->connected();
+  // The controlling side doesn't compare these; leaving them out saves a
+  // re-sort for every packet received.
+  key.remote_nomination =
+      ice_role_ == ICEROLE_CONTROLLED ? conn->remote_nomination() : 0;
+  key.last_data_received =
+      ice_role_ == ICEROLE_CONTROLLED ? conn->last_data_received() : 0;
+  key.network_cost = conn->ComputeNetworkCost();
+  key.priority = conn->priority();
+  key.generation =
+      conn->remote_candidate().generation() + conn->port()->generation();
+  key.rtt = conn->rtt();
+  return key;
+}
+
+bool P2PTransportChannel::SortsBefore(const Connection* a,
+                                      const Connection* b) const {
+  int cmp = CompareConnections(a, b, rtc::Optional<int64_t>(), nullptr);
+  if (cmp != 0) {
+    return cmp > 0;
+  }
+  // Otherwise, sort based on latency estimate.
+  return a->rtt() < b->rtt();
+}
+
 // Sort the available connections to find the best one.  We also monitor
 // the number of available connections and the current state.
 void P2PTransportChannel::SortConnectionsAndUpdateState() {
@@ -1223,16 +1278,35 @@ void P2PTransportChannel::SortConnectionsAndUpdateState() {
   // that amongst equal preference, writable connections, this will choose the
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
-  std::stable_sort(connections_.begin(), connections_.end(),
-                   [this](const Connection* a, const Connection* b) {
-                     int cmp = CompareConnections(
-                         a, b, rtc::Optional<int64_t>(), nullptr);
-                     if (cmp != 0) {
-                       return cmp > 0;
-                     }
-                     // Otherwise, sort based on latency estimate.
-                     return a->rtt() < b->rtt();
-                   });
+  // Typically only a few connections changed since the last sort, so the
+  // others, which are still in order, are left in place and the changed ones
+  // are inserted among them.
+  std::vector<Connection*> unchanged;
+  std::vector<Connection*> changed;
+  unchanged.reserve(connections_.size());
+  for (Connection* conn : connections_) {
+    SortKey key = GetSortKey(conn);
+    auto result = sort_keys_.insert(std::make_pair(conn, key));
+    if (result.second || !(result.first->second == key)) {
+      result.first->second = key;
+      changed.push_back(conn);
+    } else {
+      unchanged.push_back(conn);
+    }
+  }
+  auto sorts_before = [this](const Connection* a, const Connection* b) {
+    return SortsBefore(a, b);
+  };
+  if (changed.size() * kFullSortRatio > connections_.size()) {
+    std::stable_sort(connections_.begin(), connections_.end(), sorts_before);
+  } else if (!changed.empty()) {
+    for (Connection* conn : changed) {
+      unchanged.insert(std::upper_bound(unchanged.begin(), unchanged.end(),
+                                        conn, sorts_before),
+                       conn);
+    }
+    connections_.swap(unchanged);
+  }
 
   LOG(LS_VERBOSE) << "Sorting " << connections_.size()
                   << " available connections:";
@@ -1505,14 +1579,28 @@ void P2PTransportChannel::OnCheckAndPing() {
   int ping_interval = (weak() || need_more_pings_at_weak_interval)
                           ? weak_ping_interval_
                           : STRONG_PING_INTERVAL;
-  if (rtc::TimeMillis() >= last_ping_sent_ms_ + ping_interval) {
+  PingScheduler* scheduler = config_.ping_scheduler;
+  int64_t now = rtc::TimeMillis();
+  if (now >= last_ping_sent_ms_ + ping_interval) {
     Connection* conn = FindNextPingableConnection();
-    if (conn) {
+    if (conn && scheduler && !scheduler->TryPing()) {
+      // Over the process-wide budget; try again on the next check.
+      if (ping_deferred_since_ms_ < 0) {
+        ping_deferred_since_ms_ = now;
+      }
+    } else if (conn) {
+      if (scheduler && ping_deferred_since_ms_ >= 0) {
+        scheduler->OnDeferredPingSent(now - ping_deferred_since_ms_);
+      }
+      ping_deferred_since_ms_ = -1;
       PingConnection(conn);
       MarkConnectionPinged(conn);
     }
   }
   int delay = std::min(ping_interval, check_receiving_interval_);
+  if (scheduler) {
+    delay = scheduler->Jitter(delay);
+  }
   thread()->PostDelayed(RTC_FROM_HERE, delay, this, MSG_CHECK_AND_PING);
 }
 
@@ -1558,7 +1646,8 @@ bool P2PTransportChannel::IsPingable(const Connection* conn,
   if (IsBackupConnection(conn)) {
     return conn->rtt_samples() == 0 ||
            (now >= conn->last_ping_response_received() +
-                       config_.backup_connection_ping_interval);
+                       RelaxedInterval(
+                           config_.backup_connection_ping_interval));
   }
   // Don't ping inactive non-backup connections.
   if (!conn->active()) {
@@ -1599,7 +1688,13 @@ int P2PTransportChannel::CalculateActiveWritablePingInterval(
   int stablizing_interval =
       std::min(stable_interval, STABILIZING_WRITABLE_CONNECTION_PING_INTERVAL);
 
-  return conn->stable(now) ? stable_interval : stablizing_interval;
+  return conn->stable(now) ? RelaxedInterval(stable_interval)
+                           : stablizing_interval;
+}
+
+int P2PTransportChannel::RelaxedInterval(int interval) const {
+  return config_.ping_scheduler ? config_.ping_scheduler->RelaxInterval(interval)
+                                : interval;
 }
 
 // Returns the next pingable connection to ping.  This will be the oldest
@@ -1727,6 +1822,7 @@ void P2PTransportChannel::OnConnectionDestroyed(Connection* connection) {
   ASSERT(iter != connections_.end());
   pinged_connections_.erase(*iter);
   unpinged_connections_.erase(*iter);
+  sort_keys_.erase(*iter);
   connections_.erase(iter);
 
   LOG_J(LS_INFO, this) << "Removed connection ("
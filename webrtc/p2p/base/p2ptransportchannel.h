@@ -24,6 +24,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/base/constructormagic.h"
@@ -236,6 +237,28 @@ class P2PTransportChannel : public TransportChannelImpl,
 
   bool PresumedWritable(const cricket::Connection* conn) const;
 
+  // Everything that sorting compares about a connection. Connections whose
+  // keys are unchanged since the last sort keep their relative order, so only
+  // the others need to be placed again.
+  struct SortKey {
+    IceRole ice_role;
+    bool writable;  // Or presumed writable.
+    Connection::WriteState write_state;
+    bool receiving;
+    bool connected;
+    // Only compared on the controlled side.
+    uint32_t remote_nomination;
+    int64_t last_data_received;
+    uint32_t network_cost;
+    uint64_t priority;
+    uint32_t generation;
+    int rtt;
+    bool operator==(const SortKey& other) const;
+  };
+  SortKey GetSortKey(const Connection* conn) const;
+  // Returns true if |a| goes before |b| in |connections_|.
+  bool SortsBefore(const Connection* a, const Connection* b) const;
+
   void SortConnectionsAndUpdateState();
   void SwitchSelectedConnection(Connection* conn);
   void UpdateState();
@@ -259,6 +282,8 @@ class P2PTransportChannel : public TransportChannelImpl,
   bool IsSelectedConnectionPingable(int64_t now);
   int CalculateActiveWritablePingInterval(const Connection* conn,
                                           int64_t now) const;
+  // Stretches |interval| when the ping scheduler is loaded.
+  int RelaxedInterval(int interval) const;
   void PingConnection(Connection* conn);
   void AddAllocatorSession(std::unique_ptr<PortAllocatorSession> session);
   void AddConnection(Connection* connection);
@@ -368,6 +393,8 @@ class P2PTransportChannel : public TransportChannelImpl,
   std::vector<Connection *> connections_;
   std::set<Connection*> pinged_connections_;
   std::set<Connection*> unpinged_connections_;
+  // The key of each connection as of the last sort.
+  std::unordered_map<const Connection*, SortKey> sort_keys_;
 
   Connection* selected_connection_ = nullptr;
 
@@ -385,6 +412,9 @@ class P2PTransportChannel : public TransportChannelImpl,
 
   int check_receiving_interval_;
   int64_t last_ping_sent_ms_ = 0;
+  // When the ping scheduler first refused a ping since the last one was sent,
+  // or -1.
+  int64_t ping_deferred_since_ms_ = -1;
   int weak_ping_interval_ = WEAK_PING_INTERVAL;
   TransportChannelState state_ = TransportChannelState::STATE_INIT;
   IceConfig config_;
@@ -13,6 +13,7 @@
 
 #include "webrtc/p2p/base/fakeportallocator.h"
 #include "webrtc/p2p/base/p2ptransportchannel.h"
+#include "webrtc/p2p/base/pingscheduler.h"
 #include "webrtc/p2p/base/testrelayserver.h"
 #include "webrtc/p2p/base/teststunserver.h"
 #include "webrtc/p2p/base/testturnserver.h"
@@ -28,6 +29,7 @@
 #include "webrtc/base/natsocketfactory.h"
 #include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/proxyserver.h"
+#include "webrtc/base/random.h"
 #include "webrtc/base/socketaddress.h"
 #include "webrtc/base/ssladapter.h"
 #include "webrtc/base/thread.h"
@@ -3091,6 +3093,137 @@ TEST_F(P2PTransportChannelPingTest, TestReceivingStateChange) {
   EXPECT_TRUE_WAIT(!ch.receiving(), 1000);
 }
 
+namespace {
+
+bool SortedByRtt(const std::vector<Connection*>& connections) {
+  for (size_t i = 1; i < connections.size(); ++i) {
+    if (connections[i - 1]->rtt() > connections[i]->rtt())
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+// Channels sharing a ping scheduler keep their pings within its budget
+// together.
+TEST_F(P2PTransportChannelPingTest, TestPingSchedulerBudgetIsShared) {
+  rtc::ScopedFakeClock clock;
+  const int kPingsPerSecond = 10;
+  const int kDurationMs = 3000;
+  PingScheduler scheduler(kPingsPerSecond, 10);
+  FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch1("channel 1", 1, &pa);
+  P2PTransportChannel ch2("channel 2", 1, &pa);
+  std::vector<Connection*> conns;
+  for (P2PTransportChannel* ch : {&ch1, &ch2}) {
+    PrepareChannel(ch);
+    IceConfig config = ch->config();
+    config.ping_scheduler = &scheduler;
+    ch->SetIceConfig(config);
+    ch->MaybeStartGathering();
+    ch->AddRemoteCandidate(
+        CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", 1, 1));
+    Connection* conn = WaitForConnectionTo(ch, "1.1.1.1", 1);
+    ASSERT_TRUE(conn != nullptr);
+    conns.push_back(conn);
+  }
+
+  // Unwritable connections are pinged at the weak interval, so each channel
+  // alone would be well over the budget.
+  SIMULATED_WAIT(false, kDurationMs, clock);
+  int pings = conns[0]->num_pings_sent() + conns[1]->num_pings_sent();
+  EXPECT_LE(pings, kPingsPerSecond * kDurationMs / 1000 + 1);
+  EXPECT_GE(pings, kPingsPerSecond * kDurationMs / 1000 / 2);
+  EXPECT_GT(conns[0]->num_pings_sent(), 0);
+  EXPECT_GT(conns[1]->num_pings_sent(), 0);
+
+  PingScheduler::Stats stats = scheduler.GetStats();
+  EXPECT_EQ(static_cast<uint64_t>(pings), stats.pings_sent);
+  EXPECT_LT(0u, stats.pings_deferred);
+  EXPECT_LT(0, stats.total_deferral_ms);
+  EXPECT_GT(stats.pings_per_second, 0.0);
+}
+
+// Connections are re-sorted as they change, whether few of them changed, in
+// which case only those are placed again, or many.
+TEST_F(P2PTransportChannelPingTest, TestConnectionsStaySortedAsTheyChange) {
+  FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch("stay sorted", 1, &pa);
+  PrepareChannel(&ch);
+  // The controlled side doesn't prune before a nomination, so all the
+  // connections stay writable and differ only in RTT.
+  ch.SetIceRole(ICEROLE_CONTROLLED);
+  ch.MaybeStartGathering();
+  const int kConnections = 20;
+  std::vector<Connection*> conns;
+  for (int i = 1; i <= kConnections; ++i) {
+    ch.AddRemoteCandidate(CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", i, 1));
+    Connection* conn = WaitForConnectionTo(&ch, "1.1.1.1", i);
+    ASSERT_TRUE(conn != nullptr);
+    conn->ReceivedPingResponse(LOW_RTT, "id");
+    conns.push_back(conn);
+  }
+
+  webrtc::Random random(1234);
+  for (int i = 0; i < 100; ++i) {
+    int changes = random.Rand(1, kConnections / 2);
+    for (int j = 0; j < changes; ++j) {
+      Connection* conn = conns[random.Rand(0, kConnections - 1)];
+      conn->ReceivedPingResponse(random.Rand(1, 1000), "id");
+      conn->SignalStateChange(conn);
+    }
+    EXPECT_TRUE_WAIT(SortedByRtt(ch.connections()), kDefaultTimeout);
+  }
+  EXPECT_EQ(static_cast<size_t>(kConnections), ch.connections().size());
+}
+
+// Measures the cost of re-sorting after a single connection changed, and
+// after all of them did, for different numbers of candidate pairs.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(P2PTransportChannelPingTest, DISABLED_SortPerformance) {
+  const int kUpdates = 1000;
+  for (int size : {50, 200, 1000}) {
+    FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+    P2PTransportChannel ch("sort performance", 1, &pa);
+    PrepareChannel(&ch);
+    ch.SetIceRole(ICEROLE_CONTROLLED);
+    ch.MaybeStartGathering();
+    std::vector<Connection*> conns;
+    for (int i = 1; i <= size; ++i) {
+      ch.AddRemoteCandidate(
+          CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", i, i % 10));
+      Connection* conn = WaitForConnectionTo(&ch, "1.1.1.1", i);
+      ASSERT_TRUE(conn != nullptr);
+      conn->ReceivedPingResponse(LOW_RTT, "id");
+      conns.push_back(conn);
+    }
+    rtc::Thread::Current()->ProcessMessages(0);
+
+    webrtc::Random random(size);
+    int64_t start = rtc::TimeNanos();
+    for (int i = 0; i < kUpdates; ++i) {
+      Connection* conn = conns[random.Rand(0, size - 1)];
+      conn->ReceivedPingResponse(random.Rand(1, 1000), "id");
+      conn->SignalStateChange(conn);
+      rtc::Thread::Current()->ProcessMessages(0);
+    }
+    int64_t one_ns = (rtc::TimeNanos() - start) / kUpdates;
+
+    start = rtc::TimeNanos();
+    for (int i = 0; i < kUpdates / 10; ++i) {
+      for (Connection* conn : conns)
+        conn->ReceivedPingResponse(random.Rand(1, 1000), "id");
+      conns[0]->SignalStateChange(conns[0]);
+      rtc::Thread::Current()->ProcessMessages(0);
+    }
+    int64_t all_ns = (rtc::TimeNanos() - start) / (kUpdates / 10);
+    LOG(LS_INFO) << size << " connections: re-sort after one changed "
+                 << one_ns / 1000 << " us, after all changed " << all_ns / 1000
+                 << " us";
+  }
+}
+
 // The controlled side will select a connection as the "selected connection"
 // based on priority until the controlling side nominates a connection, at which
 // point the controlled side will select that connection as the
@@ -0,0 +1,112 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/pingscheduler.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/helpers.h"
+#include "webrtc/base/timeutils.h"
+
+namespace cricket {
+
+namespace {
+
+// The ping rate is measured over a second, in 100 ms buckets.
+const int64_t kRateBucketMs = 100;
+const size_t kRateBucketCount = 10;
+const int64_t kCreditPerPing = 1000;
+
+// Allows at least one ping at a time, however small the budget.
+int64_t MaxCredit(int max_pings_per_second) {
+  return std::max(kCreditPerPing, static_cast<int64_t>(max_pings_per_second) *
+                                      PingScheduler::kBurstMs);
+}
+
+}  // namespace
+
+const int PingScheduler::kBurstMs;
+const int PingScheduler::kMaxRelaxation;
+
+PingScheduler::PingScheduler(int max_pings_per_second, int jitter_percent)
+    : max_pings_per_second_(max_pings_per_second),
+      jitter_percent_(jitter_percent),
+      credit_(MaxCredit(max_pings_per_second)),
+      last_refill_ms_(rtc::TimeMillis()),
+      ping_rate_(kRateBucketMs, kRateBucketCount),
+      random_(rtc::CreateRandomId64() | 1) {
+  RTC_DCHECK_GE(max_pings_per_second, 0);
+  RTC_DCHECK(jitter_percent >= 0 && jitter_percent < 100);
+}
+
+PingScheduler::~PingScheduler() {}
+
+bool PingScheduler::TryPing() {
+  rtc::CritScope cs(&crit_);
+  if (max_pings_per_second_ > 0) {
+    RefillLocked(rtc::TimeMillis());
+    if (credit_ < kCreditPerPing) {
+      ++stats_.pings_deferred;
+      return false;
+    }
+    credit_ -= kCreditPerPing;
+  }
+  ++stats_.pings_sent;
+  ping_rate_.AddSamples(1);
+  return true;
+}
+
+void PingScheduler::OnDeferredPingSent(int64_t deferral_ms) {
+  rtc::CritScope cs(&crit_);
+  stats_.total_deferral_ms += deferral_ms;
+}
+
+int PingScheduler::Jitter(int delay_ms) {
+  int spread = delay_ms * jitter_percent_ / 100;
+  if (spread <= 0) {
+    return delay_ms;
+  }
+  rtc::CritScope cs(&crit_);
+  return delay_ms + random_.Rand(-spread, spread);
+}
+
+int PingScheduler::RelaxInterval(int interval_ms) {
+  if (max_pings_per_second_ == 0) {
+    return interval_ms;
+  }
+  rtc::CritScope cs(&crit_);
+  // Relaxation starts at half the budget and reaches its maximum at the
+  // budget.
+  double load = ping_rate_.ComputeRate() / max_pings_per_second_;
+  double excess = std::min(1.0, std::max(0.0, 2 * load - 1));
+  if (excess == 0.0) {
+    return interval_ms;
+  }
+  ++stats_.intervals_relaxed;
+  return static_cast<int>(interval_ms * (1 + (kMaxRelaxation - 1) * excess));
+}
+
+PingScheduler::Stats PingScheduler::GetStats() const {
+  rtc::CritScope cs(&crit_);
+  Stats stats = stats_;
+  stats.pings_per_second = ping_rate_.ComputeRate();
+  return stats;
+}
+
+void PingScheduler::RefillLocked(int64_t now) {
+  if (now > last_refill_ms_) {
+    int64_t earned = (now - last_refill_ms_) * max_pings_per_second_;
+    credit_ = std::min(MaxCredit(max_pings_per_second_), credit_ + earned);
+  }
+  last_refill_ms_ = now;
+}
+
+}  // namespace cricket
@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_PINGSCHEDULER_H_
+#define WEBRTC_P2P_BASE_PINGSCHEDULER_H_
+
+#include <stdint.h>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/ratetracker.h"
+
+namespace cricket {
+
+// Shared by the P2PTransportChannels of a process, through
+// IceConfig::ping_scheduler, to keep the STUN pings they send together within
+// a budget. Without it every channel pings on its own schedule, and with
+// thousands of channels the pings cluster into bursts.
+//
+// The budget is a token bucket that holds up to kBurstMs worth of pings.
+// A channel that gets no token skips its ping and tries again on its next
+// check. The checks themselves are jittered so that channels created at the
+// same time drift apart. As the load approaches the budget, the intervals at
+// which stable writable and backup connections are pinged are stretched, up
+// to kMaxRelaxation times, leaving the budget to connections that are still
+// being checked.
+//
+// May be used from any thread.
+class PingScheduler {
+ public:
+  // Burst size of the budget, in milliseconds of pings.
+  static const int kBurstMs = 100;
+  // How much longer, at most, relaxed intervals get.
+  static const int kMaxRelaxation = 4;
+
+  struct Stats {
+    // Number of pings allowed.
+    uint64_t pings_sent = 0;
+    // Number of pings refused for being over the budget.
+    uint64_t pings_deferred = 0;
+    // Pings allowed per second, over the last second.
+    double pings_per_second = 0.0;
+    // What is given up in RTT estimation: the total time pings that had been
+    // deferred were sent late by, and the number of intervals relaxed.
+    int64_t total_deferral_ms = 0;
+    uint64_t intervals_relaxed = 0;
+  };
+
+  // |max_pings_per_second| of 0 means no budget. |jitter_percent| is how much
+  // check delays are randomly shortened or lengthened by.
+  PingScheduler(int max_pings_per_second, int jitter_percent);
+  ~PingScheduler();
+
+  // Returns true if a ping may be sent now, and counts it as sent.
+  bool TryPing();
+  // Records that a ping which had been deferred for |deferral_ms| was sent.
+  void OnDeferredPingSent(int64_t deferral_ms);
+
+  // Returns |delay_ms| randomly shortened or lengthened.
+  int Jitter(int delay_ms);
+  // Returns the interval to use for a stable or backup connection whose
+  // unrelaxed interval is |interval_ms|.
+  int RelaxInterval(int interval_ms);
+
+  Stats GetStats() const;
+
+ private:
+  // Adds the tokens earned since the last refill. Capped to the burst size.
+  void RefillLocked(int64_t now) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const int max_pings_per_second_;
+  const int jitter_percent_;
+  mutable rtc::CriticalSection crit_;
+  // In pings times 1000, so that fractions of a ping earned in a millisecond
+  // add up.
+  int64_t credit_ GUARDED_BY(crit_);
+  int64_t last_refill_ms_ GUARDED_BY(crit_);
+  rtc::RateTracker ping_rate_ GUARDED_BY(crit_);
+  webrtc::Random random_ GUARDED_BY(crit_);
+  Stats stats_ GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PingScheduler);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_PINGSCHEDULER_H_
@@ -0,0 +1,123 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <set>
+
+#include "webrtc/base/fakeclock.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/p2p/base/pingscheduler.h"
+
+namespace cricket {
+
+namespace {
+
+void AdvanceMs(rtc::ScopedFakeClock* clock, int ms) {
+  clock->AdvanceTime(rtc::TimeDelta::FromMilliseconds(ms));
+}
+
+}  // namespace
+
+TEST(PingSchedulerTest, NoBudget) {
+  rtc::ScopedFakeClock clock;
+  PingScheduler scheduler(0, 0);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(scheduler.TryPing());
+  }
+  EXPECT_EQ(1000u, scheduler.GetStats().pings_sent);
+  EXPECT_EQ(0u, scheduler.GetStats().pings_deferred);
+  EXPECT_EQ(2500, scheduler.RelaxInterval(2500));
+}
+
+TEST(PingSchedulerTest, BudgetAllowsABurstThenRefills) {
+  rtc::ScopedFakeClock clock;
+  PingScheduler scheduler(100, 0);
+  // 100 ms worth of pings.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(scheduler.TryPing());
+  }
+  EXPECT_FALSE(scheduler.TryPing());
+  AdvanceMs(&clock, 5);
+  EXPECT_FALSE(scheduler.TryPing());
+  AdvanceMs(&clock, 5);
+  EXPECT_TRUE(scheduler.TryPing());
+  EXPECT_FALSE(scheduler.TryPing());
+
+  // The burst doesn't grow while idle.
+  AdvanceMs(&clock, 10000);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(scheduler.TryPing());
+  }
+  EXPECT_FALSE(scheduler.TryPing());
+
+  PingScheduler::Stats stats = scheduler.GetStats();
+  EXPECT_EQ(21u, stats.pings_sent);
+  EXPECT_EQ(4u, stats.pings_deferred);
+}
+
+TEST(PingSchedulerTest, SmallBudgetAllowsOnePingAtATime) {
+  rtc::ScopedFakeClock clock;
+  PingScheduler scheduler(2, 0);
+  EXPECT_TRUE(scheduler.TryPing());
+  EXPECT_FALSE(scheduler.TryPing());
+  AdvanceMs(&clock, 499);
+  EXPECT_FALSE(scheduler.TryPing());
+  AdvanceMs(&clock, 1);
+  EXPECT_TRUE(scheduler.TryPing());
+}
+
+TEST(PingSchedulerTest, JitterStaysWithinSpread) {
+  PingScheduler scheduler(0, 10);
+  std::set<int> delays;
+  for (int i = 0; i < 1000; ++i) {
+    int delay = scheduler.Jitter(480);
+    EXPECT_GE(delay, 432);
+    EXPECT_LE(delay, 528);
+    delays.insert(delay);
+  }
+  EXPECT_LT(10u, delays.size());
+
+  PingScheduler no_jitter(0, 0);
+  EXPECT_EQ(480, no_jitter.Jitter(480));
+}
+
+TEST(PingSchedulerTest, RelaxesIntervalsAsLoadApproachesBudget) {
+  rtc::ScopedFakeClock clock;
+  PingScheduler scheduler(100, 0);
+  EXPECT_EQ(2500, scheduler.RelaxInterval(2500));
+
+  // Below half the budget, nothing is relaxed yet.
+  for (int i = 0; i < 80; ++i) {
+    AdvanceMs(&clock, 25);
+    EXPECT_TRUE(scheduler.TryPing());
+  }
+  EXPECT_NEAR(40.0, scheduler.GetStats().pings_per_second, 5.0);
+  EXPECT_EQ(2500, scheduler.RelaxInterval(2500));
+  EXPECT_EQ(0u, scheduler.GetStats().intervals_relaxed);
+
+  // At the budget, intervals are relaxed the most.
+  for (int i = 0; i < 100; ++i) {
+    AdvanceMs(&clock, 10);
+    EXPECT_TRUE(scheduler.TryPing());
+  }
+  EXPECT_NEAR(100.0, scheduler.GetStats().pings_per_second, 5.0);
+  int relaxed = scheduler.RelaxInterval(2500);
+  EXPECT_GT(relaxed, 2500 * 3);
+  EXPECT_LE(relaxed, 2500 * PingScheduler::kMaxRelaxation);
+  EXPECT_EQ(1u, scheduler.GetStats().intervals_relaxed);
+}
+
+TEST(PingSchedulerTest, ReportsDeferral) {
+  PingScheduler scheduler(100, 0);
+  scheduler.OnDeferredPingSent(30);
+  scheduler.OnDeferredPingSent(12);
+  EXPECT_EQ(42, scheduler.GetStats().total_deferral_ms);
+}
+
+}  // namespace cricket
@@ -350,9 +350,6 @@ bool Port::GetStunMessage(const char* data,
                           const rtc::SocketAddress& addr,
                           std::unique_ptr<IceMessage>* out_msg,
                           std::string* out_username) {
-  // NOTE: This could clearly be optimized to avoid allocating any memory.
-  //       However, at the data rates we'll be looking at on the client side,
-  //       this probably isn't worth worrying about.
   ASSERT(out_msg != NULL);
   ASSERT(out_username != NULL);
   out_username->clear();
@@ -363,48 +360,64 @@ bool Port::GetStunMessage(const char* data,
     return false;
   }
 
-  // Parse the request message.  If the packet is not a complete and correct
-  // STUN message, then ignore it.
-  std::unique_ptr<IceMessage> stun_msg(new IceMessage());
-  rtc::ByteBufferReader buf(data, size);
-  if (!stun_msg->Read(&buf) || (buf.Length() > 0)) {
+  // Look at the message in place first, so that requests failing the checks
+  // below are answered without building an IceMessage.
+  StunMessageView view;
+  rtc::ByteBufferReader view_buf(data, size);
+  if (!view.Read(&view_buf)) {
     return false;
   }
 
-  if (stun_msg->type() == STUN_BINDING_REQUEST) {
-    // Check for the presence of USERNAME and MESSAGE-INTEGRITY (if ICE) first.
-    // If not present, fail with a 400 Bad Request.
-    if (!stun_msg->GetByteString(STUN_ATTR_USERNAME) ||
-        !stun_msg->GetByteString(STUN_ATTR_MESSAGE_INTEGRITY)) {
+  std::string remote_ufrag;
+  if (view.type() == STUN_BINDING_REQUEST) {
+    int error_code = 0;
+    const char* reason = NULL;
+    std::string local_ufrag;
+    if (!view.HasAttribute(STUN_ATTR_USERNAME) ||
+        !view.HasAttribute(STUN_ATTR_MESSAGE_INTEGRITY)) {
+      // Check for the presence of USERNAME and MESSAGE-INTEGRITY (if ICE)
+      // first. If not present, fail with a 400 Bad Request.
       LOG_J(LS_ERROR, this) << "Received STUN request without username/M-I "
                             << "from " << addr.ToSensitiveString();
-      SendBindingErrorResponse(stun_msg.get(), addr, STUN_ERROR_BAD_REQUEST,
-                               STUN_ERROR_REASON_BAD_REQUEST);
-      return true;
-    }
-
-    // If the username is bad or unknown, fail with a 401 Unauthorized.
-    std::string local_ufrag;
-    std::string remote_ufrag;
-    if (!ParseStunUsername(stun_msg.get(), &local_ufrag, &remote_ufrag) ||
-        local_ufrag != username_fragment()) {
+      error_code = STUN_ERROR_BAD_REQUEST;
+      reason = STUN_ERROR_REASON_BAD_REQUEST;
+    } else if (!ParseStunUsername(view, &local_ufrag, &remote_ufrag) ||
+               local_ufrag != username_fragment()) {
+      // If the username is bad or unknown, fail with a 401 Unauthorized.
       LOG_J(LS_ERROR, this) << "Received STUN request with bad local username "
                             << local_ufrag << " from "
                             << addr.ToSensitiveString();
-      SendBindingErrorResponse(stun_msg.get(), addr, STUN_ERROR_UNAUTHORIZED,
-                               STUN_ERROR_REASON_UNAUTHORIZED);
-      return true;
-    }
-
-    // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401 Unauthorized
-    if (!stun_msg->ValidateMessageIntegrity(data, size, password_)) {
+      error_code = STUN_ERROR_UNAUTHORIZED;
+      reason = STUN_ERROR_REASON_UNAUTHORIZED;
+    } else if (!StunMessage::ValidateMessageIntegrity(data, size, password_)) {
+      // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401
+      // Unauthorized.
       LOG_J(LS_ERROR, this) << "Received STUN request with bad M-I "
                             << "from " << addr.ToSensitiveString()
                             << ", password_=" << password_;
-      SendBindingErrorResponse(stun_msg.get(), addr, STUN_ERROR_UNAUTHORIZED,
-                               STUN_ERROR_REASON_UNAUTHORIZED);
+      error_code = STUN_ERROR_UNAUTHORIZED;
+      reason = STUN_ERROR_REASON_UNAUTHORIZED;
+    }
+    if (error_code) {
+      // The error response only needs the type and transaction ID of the
+      // request.
+      StunMessage request;
+      request.SetType(view.type());
+      request.SetTransactionID(view.transaction_id());
+      SendBindingErrorResponse(&request, addr, error_code, reason);
       return true;
     }
+  }
+
+  // Parse the request message.  If the packet is not a complete and correct
+  // STUN message, then ignore it.
+  std::unique_ptr<IceMessage> stun_msg(new IceMessage());
+  rtc::ByteBufferReader buf(data, size);
+  if (!stun_msg->Read(&buf) || (buf.Length() > 0)) {
+    return false;
+  }
+
+  if (stun_msg->type() == STUN_BINDING_REQUEST) {
     out_username->assign(remote_ufrag);
   } else if ((stun_msg->type() == STUN_BINDING_RESPONSE) ||
              (stun_msg->type() == STUN_BINDING_ERROR_RESPONSE)) {
@@ -456,7 +469,7 @@ bool Port::IsCompatibleAddress(const rtc::SocketAddress& addr) {
   return true;
 }
 
-bool Port::ParseStunUsername(const StunMessage* stun_msg,
+bool Port::ParseStunUsername(const StunMessageView& stun_msg,
                              std::string* local_ufrag,
                              std::string* remote_ufrag) const {
   // The packet must include a username that either begins or ends with our
@@ -464,20 +477,21 @@ bool Port::ParseStunUsername(const StunMessage* stun_msg,
   // should end with our fragment if it is a response.
   local_ufrag->clear();
   remote_ufrag->clear();
-  const StunByteStringAttribute* username_attr =
-        stun_msg->GetByteString(STUN_ATTR_USERNAME);
-  if (username_attr == NULL)
+  const char* username;
+  size_t username_length;
+  if (!stun_msg.GetByteString(STUN_ATTR_USERNAME, &username,
+                              &username_length))
     return false;
 
   // RFRAG:LFRAG
-  const std::string username = username_attr->GetString();
-  size_t colon_pos = username.find(":");
-  if (colon_pos == std::string::npos) {
+  const char* colon =
+      static_cast<const char*>(memchr(username, ':', username_length));
+  if (colon == NULL) {
     return false;
   }
 
-  *local_ufrag = username.substr(0, colon_pos);
-  *remote_ufrag = username.substr(colon_pos + 1, username.size());
+  local_ufrag->assign(username, colon);
+  remote_ufrag->assign(colon + 1, username + username_length);
   return true;
 }
 
@@ -283,7 +283,7 @@ class Port : public PortInterface, public rtc::MessageHandler,
 
   // This method will return local and remote username fragements from the
   // stun username attribute if present.
-  bool ParseStunUsername(const StunMessage* stun_msg,
+  bool ParseStunUsername(const StunMessageView& stun_msg,
                          std::string* local_username,
                          std::string* remote_username) const;
   void CreateStunUsername(const std::string& remote_username,
@@ -70,6 +70,12 @@ enum {
   // candidates. Doing so ensures that even if a cellular network type was not
   // detected initially, it would not be used if a Wi-Fi network is present.
   PORTALLOCATOR_DISABLE_COSTLY_NETWORKS = 0x2000,
+
+  // Start the UDP, relay and TCP allocation phases of each network at once
+  // instead of one per step delay, so that time to first candidate of every
+  // type doesn't depend on the step delay. The STUN transactions of the
+  // phases are then no longer paced by it.
+  PORTALLOCATOR_ENABLE_PARALLEL_PHASES = 0x4000,
 };
 
 const uint32_t kDefaultPortAllocatorFlags = 0;
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <set>
 
@@ -99,6 +100,11 @@ const uint32_t DEFAULT_SND_BUF_SIZE = 90 * 1024;
 // 24 |                             data                              |
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 //
+// When FLAG_SACK is set, which only happens on ACKs without data once both
+// sides sent TCP_OPT_SACK_PERMITTED, the data starts with a byte giving the
+// number of SACK blocks, each made of the left and right edge of a run of
+// out of order data the receiver holds.
+//
 //////////////////////////////////////////////////////////////////////
 
 #define PSEUDO_KEEPALIVE 0
@@ -115,6 +121,7 @@ const uint32_t DEF_ACK_DELAY = 100;  // 100 milliseconds
 
 const uint8_t FLAG_CTL = 0x02;
 const uint8_t FLAG_RST = 0x04;
+const uint8_t FLAG_SACK = 0x08;
 
 const uint8_t CTL_CONNECT = 0;
 
@@ -123,6 +130,16 @@ const uint8_t TCP_OPT_EOL = 0;        // End of list.
 const uint8_t TCP_OPT_NOOP = 1;       // No-op.
 const uint8_t TCP_OPT_MSS = 2;        // Maximum segment size.
 const uint8_t TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8_t TCP_OPT_SACK_PERMITTED = 4;  // Selective acknowledgments.
+
+// Largest window scale factor (RFC 7323, Sec 2.3), for windows up to 1 GB.
+const uint8_t TCP_MAX_WND_SCALE = 14;
+
+const uint32_t SACK_BLOCK_SIZE = 8;
+
+// CUBIC multiplicative decrease and scaling constant (RFC 8312, Sec 5).
+const double CUBIC_BETA = 0.7;
+const double CUBIC_C = 0.4;  // In segments per second cubed.
 
 const long DEFAULT_TIMEOUT = 4000; // If there are no pending clocks, wake up every 4 seconds
 const long CLOSED_TIMEOUT = 60 * 1000; // If the connection is closed, once per minute
@@ -248,6 +265,16 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
 
   m_dup_acks = 0;
   m_recover = 0;
+  m_retransmits = 0;
+
+  m_rlast_seq = 0;
+  m_support_sack = true;
+  m_use_sack = false;
+  m_sack_high = m_sack_rexmit = 0;
+
+  m_use_cubic = false;
+  m_cubic_wmax = m_cubic_epoch = m_cubic_origin = 0;
+  m_cubic_k = 0;
 
   m_ts_recent = m_ts_lastack = 0;
 
@@ -308,7 +335,7 @@ void PseudoTcp::NotifyClock(uint32_t now) {
       }
 
       uint32_t nInFlight = m_snd_nxt - m_snd_una;
-      m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+      onCongestionEvent(nInFlight);
       //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
       m_cwnd = m_mss;
 
@@ -377,6 +404,10 @@ void PseudoTcp::GetOption(Option opt, int* value) {
     *value = m_sbuf_len;
   } else if (opt == OPT_RCVBUF) {
     *value = m_rbuf_len;
+  } else if (opt == OPT_SACK) {
+    *value = m_support_sack ? 1 : 0;
+  } else if (opt == OPT_CUBIC) {
+    *value = m_use_cubic ? 1 : 0;
   } else {
     ASSERT(false);
   }
@@ -392,6 +423,12 @@ void PseudoTcp::SetOption(Option opt, int value) {
   } else if (opt == OPT_RCVBUF) {
     ASSERT(m_state == TCP_LISTEN);
     resizeReceiveBuffer(value);
+  } else if (opt == OPT_SACK) {
+    ASSERT(m_state == TCP_LISTEN);
+    m_support_sack = value != 0;
+  } else if (opt == OPT_CUBIC) {
+    m_use_cubic = value != 0;
+    m_cubic_epoch = 0;
   } else {
     ASSERT(false);
   }
@@ -415,6 +452,14 @@ uint32_t PseudoTcp::GetRoundTripTimeEstimateMs() const {
   return m_rx_srtt;
 }
 
+bool PseudoTcp::IsSackEnabled() const {
+  return m_use_sack;
+}
+
+uint32_t PseudoTcp::GetRetransmitCount() const {
+  return m_retransmits;
+}
+
 //
 // IPStream Implementation
 //
@@ -519,6 +564,11 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
   ASSERT(HEADER_SIZE + len <= MAX_PACKET);
 
   uint32_t now = Now();
+  // SACK blocks only go on ACKs, so that data segments keep their size.
+  bool bSack = (len == 0) && m_use_sack && !m_rlist.empty();
+  if (bSack) {
+    flags |= FLAG_SACK;
+  }
 
   std::unique_ptr<uint8_t[]> buffer(new uint8_t[MAX_PACKET]);
   long_to_bytes(m_conv, buffer.get());
@@ -534,6 +584,8 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
   long_to_bytes(m_ts_recent, buffer.get() + 20);
   m_ts_lastack = m_rcv_nxt;
 
+  uint32_t sack_len = bSack ? writeSackBlocks(buffer.get() + HEADER_SIZE) : 0;
+
   if (len) {
     size_t bytes_read = 0;
     rtc::StreamResult result = m_sbuf.ReadOffset(
@@ -555,7 +607,8 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 #endif // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char *>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char*>(buffer.get()),
+      len + sack_len + HEADER_SIZE);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value for those,
   // and thus we won't retry.  So go ahead and treat the packet as a success (basically simulate
   // as if it were dropped), which will prevent our timers from being messed up.
@@ -589,6 +642,25 @@ bool PseudoTcp::parse(const uint8_t* buffer, uint32_t size) {
   seg.data = reinterpret_cast<const char *>(buffer) + HEADER_SIZE;
   seg.len = size - HEADER_SIZE;
 
+  seg.sack_count = 0;
+  if (seg.flags & FLAG_SACK) {
+    if (seg.len < 1 || buffer[HEADER_SIZE] > kMaxSackBlocks ||
+        seg.len < 1 + buffer[HEADER_SIZE] * SACK_BLOCK_SIZE) {
+      LOG_F(LS_WARNING) << "Invalid SACK blocks";
+      return false;
+    }
+    seg.sack_count = buffer[HEADER_SIZE];
+    const uint8_t* block = buffer + HEADER_SIZE + 1;
+    for (uint8_t i = 0; i < seg.sack_count; ++i) {
+      seg.sack[i].left = bytes_to_long(block);
+      seg.sack[i].right = bytes_to_long(block + 4);
+      block += SACK_BLOCK_SIZE;
+    }
+    uint32_t sack_len = 1 + seg.sack_count * SACK_BLOCK_SIZE;
+    seg.data += sack_len;
+    seg.len -= sack_len;
+  }
+
 #if _DEBUGMSG >= _DBG_VERBOSE
   LOG(LS_INFO) << "--> <CONV=" << seg.conv
                << "><FLG=" << static_cast<unsigned>(seg.flags)
@@ -709,6 +781,10 @@ bool PseudoTcp::process(Segment& seg) {
     m_ts_recent = seg.tsval;
   }
 
+  if (m_use_sack && seg.sack_count) {
+    applySackBlocks(seg);
+  }
+
   // Check if this is a valuable ack
   if ((seg.ack > m_snd_una) && (seg.ack <= m_snd_nxt)) {
     // Calculate round-trip time
@@ -774,20 +850,21 @@ bool PseudoTcp::process(Segment& seg) {
 #if _DEBUGMSG >= _DBG_NORMAL
         LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
+        // With SACK, the next hole may be further up than the partial ack.
+        SList::iterator hole = m_use_sack ? nextSackHole() : m_slist.end();
+        if (hole == m_slist.end()) {
+          hole = m_slist.begin();
+        }
+        if (!transmit(hole, now)) {
           closedown(ECONNABORTED);
           return false;
         }
+        m_sack_rexmit = std::max(m_sack_rexmit, hole->seq + hole->len);
         m_cwnd += m_mss - std::min(nAcked, m_cwnd);
       }
     } else {
       m_dup_acks = 0;
-      // Slow start, congestion avoidance
-      if (m_cwnd < m_ssthresh) {
-        m_cwnd += m_mss;
-      } else {
-        m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / m_cwnd);
-      }
+      growCongestionWindow(nAcked, now);
     }
   } else if (seg.ack == m_snd_una) {
     // !?! Note, tcp says don't do this... but otherwise how does a closed window become open?
@@ -808,12 +885,24 @@ bool PseudoTcp::process(Segment& seg) {
           return false;
         }
         m_recover = m_snd_nxt;
+        m_sack_rexmit = m_slist.front().seq + m_slist.front().len;
         uint32_t nInFlight = m_snd_nxt - m_snd_una;
-        m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+        onCongestionEvent(nInFlight);
         //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
-        m_cwnd += m_mss;
+        // Each further dup ack means a segment left the network. With SACK,
+        // use it to repair the next hole rather than to send new data.
+        SList::iterator hole = m_use_sack ? nextSackHole() : m_slist.end();
+        if (hole != m_slist.end()) {
+          if (!transmit(hole, now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+          m_sack_rexmit = hole->seq + hole->len;
+        } else {
+          m_cwnd += m_mss;
+        }
       }
     } else {
       m_dup_acks = 0;
@@ -935,6 +1024,7 @@ bool PseudoTcp::process(Segment& seg) {
           it = m_rlist.erase(it);
         }
       } else {
+        m_rlast_seq = seg.seq;
 #if _DEBUGMSG >= _DBG_NORMAL
         LOG(LS_INFO) << "Saving " << seg.len << " bytes (" << seg.seq << " -> " << seg.seq + seg.len << ")";
 #endif // _DEBUGMSG
@@ -950,6 +1040,13 @@ bool PseudoTcp::process(Segment& seg) {
     }
   }
 
+  // Make sure the SACK blocks get to the sender, which a data segment
+  // carrying the ack wouldn't do.
+  if (m_use_sack && (sflags == sfImmediateAck) && !m_rlist.empty()) {
+    packet(m_snd_nxt, 0, 0, 0);
+    sflags = sfNone;
+  }
+
   attemptSend(sflags);
 
   // If we have new data, notify the user
@@ -1023,6 +1120,8 @@ bool PseudoTcp::transmit(const SList::iterator& seg, uint32_t now) {
 
   if (seg->xmit == 0) {
     m_snd_nxt += seg->len;
+  } else {
+    ++m_retransmits;
   }
   seg->xmit += 1;
   //seg->tstamp = now;
@@ -1038,6 +1137,7 @@ void PseudoTcp::attemptSend(SendFlags sflags) {
 
   if (rtc::TimeDiff32(now, m_lastsend) > static_cast<long>(m_rx_rto)) {
     m_cwnd = m_mss;
+    m_cubic_epoch = 0;
   }
 
 #if _DEBUGMSG
@@ -1179,6 +1279,10 @@ PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_support_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32_t>(buf.Length());
   queue(buf.Data(), static_cast<uint32_t>(buf.Length()), true);
 }
@@ -1242,13 +1346,151 @@ void PseudoTcp::applyOption(char kind, const char* data, uint32_t len) {
       return;
     }
     applyWindowScaleOption(data[0]);
+  } else if (kind == TCP_OPT_SACK_PERMITTED) {
+    // Selective acknowledgments.
+    // http://www.ietf.org/rfc/rfc2018.txt
+    m_use_sack = m_support_sack;
   }
 }
 
 void PseudoTcp::applyWindowScaleOption(uint8_t scale_factor) {
+  if (scale_factor > TCP_MAX_WND_SCALE) {
+    LOG(LS_WARNING) << "Window scale factor " << static_cast<int>(scale_factor)
+                    << " too large, using " << static_cast<int>(
+                        TCP_MAX_WND_SCALE);
+    scale_factor = TCP_MAX_WND_SCALE;
+  }
   m_swnd_scale = scale_factor;
 }
 
+uint32_t PseudoTcp::writeSackBlocks(uint8_t* buffer) {
+  // Merge the out of order segments into the runs the blocks describe.
+  SackBlock blocks[kMaxSackBlocks];
+  uint8_t count = 0;
+  bool bLatestWritten = false;
+  RList::const_iterator it = m_rlist.begin();
+  while (it != m_rlist.end() && count < kMaxSackBlocks) {
+    SackBlock block = {it->seq, it->seq + it->len};
+    for (++it; (it != m_rlist.end()) && (it->seq <= block.right); ++it) {
+      block.right = std::max(block.right, it->seq + it->len);
+    }
+    // The block with the latest segment goes first (RFC 2018, Sec 4).
+    bool bLatest = (block.left <= m_rlast_seq) && (m_rlast_seq < block.right);
+    if (bLatest) {
+      bLatestWritten = true;
+      std::copy_backward(blocks, blocks + count, blocks + count + 1);
+      blocks[0] = block;
+    } else if (count < kMaxSackBlocks - 1 || bLatestWritten) {
+      blocks[count] = block;
+    } else {
+      // Keep the last block for the latest segment.
+      continue;
+    }
+    ++count;
+  }
+
+  buffer[0] = count;
+  uint8_t* block = buffer + 1;
+  for (uint8_t i = 0; i < count; ++i) {
+    long_to_bytes(blocks[i].left, block);
+    long_to_bytes(blocks[i].right, block + 4);
+    block += SACK_BLOCK_SIZE;
+  }
+  return 1 + count * SACK_BLOCK_SIZE;
+}
+
+bool PseudoTcp::applySackBlocks(const Segment& seg) {
+  bool bMarked = false;
+  for (uint8_t i = 0; i < seg.sack_count; ++i) {
+    const SackBlock& block = seg.sack[i];
+    if ((block.left >= block.right) || (block.left < m_snd_una) ||
+        (block.right > m_snd_nxt)) {
+      continue;
+    }
+    for (SList::iterator it = m_slist.begin();
+         (it != m_slist.end()) && (it->seq < block.right); ++it) {
+      if (!it->bSacked && (it->seq >= block.left) &&
+          (it->seq + it->len <= block.right)) {
+        it->bSacked = true;
+        bMarked = true;
+      }
+    }
+    m_sack_high = std::max(m_sack_high, block.right);
+  }
+  return bMarked;
+}
+
+PseudoTcp::SList::iterator PseudoTcp::nextSackHole() {
+  for (SList::iterator it = m_slist.begin();
+       (it != m_slist.end()) && (it->xmit > 0) && (it->seq < m_sack_high);
+       ++it) {
+    if (!it->bSacked && (it->seq >= m_sack_rexmit)) {
+      return it;
+    }
+  }
+  return m_slist.end();
+}
+
+void PseudoTcp::onCongestionEvent(uint32_t nInFlight) {
+  if (!m_use_cubic) {
+    m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+    return;
+  }
+  // Fast convergence: give up bandwidth to newer flows when losses come
+  // before the window is back at its previous maximum.
+  if (nInFlight < m_cubic_wmax) {
+    m_cubic_wmax = static_cast<uint32_t>(nInFlight * (1 + CUBIC_BETA) / 2);
+  } else {
+    m_cubic_wmax = nInFlight;
+  }
+  m_cubic_epoch = 0;
+  m_ssthresh =
+      std::max(static_cast<uint32_t>(nInFlight * CUBIC_BETA), 2 * m_mss);
+}
+
+void PseudoTcp::growCongestionWindow(uint32_t nAcked, uint32_t now) {
+  if (m_cwnd < m_ssthresh) {
+    // Slow start. CUBIC counts bytes (RFC 3465) so that delayed acks don't
+    // slow it down.
+    m_cwnd += m_use_cubic ? std::min(nAcked, 2 * m_mss) : m_mss;
+    return;
+  }
+  if (!m_use_cubic) {
+    m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / m_cwnd);
+    return;
+  }
+
+  if (m_cubic_epoch == 0) {
+    m_cubic_epoch = now;
+    if (m_cwnd < m_cubic_wmax) {
+      m_cubic_k = std::cbrt((m_cubic_wmax - m_cwnd) / (CUBIC_C * m_mss));
+      m_cubic_origin = m_cubic_wmax;
+    } else {
+      m_cubic_k = 0;
+      m_cubic_origin = m_cwnd;
+    }
+  }
+
+  // Where the cubic function puts the window one round trip from now, and
+  // where Reno would have it, whichever is larger (RFC 8312, Sec 4.2).
+  uint32_t rtt = std::max<uint32_t>(m_rx_srtt, 1);
+  double elapsed = rtc::TimeDiff32(now, m_cubic_epoch) / 1000.0;
+  double offset = elapsed + rtt / 1000.0 - m_cubic_k;
+  double target = m_cubic_origin + CUBIC_C * m_mss * offset * offset * offset;
+  double reno = m_cubic_wmax * CUBIC_BETA + 3 * (1 - CUBIC_BETA) /
+                (1 + CUBIC_BETA) * m_mss * elapsed * 1000 / rtt;
+  target = std::min(std::max(target, reno), 1.5 * m_cwnd);
+
+  if (target > m_cwnd) {
+    m_cwnd += std::max<uint32_t>(
+        1, static_cast<uint32_t>((target - m_cwnd) * nAcked / m_cwnd));
+  } else {
+    m_cwnd += std::max<uint32_t>(
+        1, static_cast<uint32_t>(static_cast<double>(nAcked) * m_mss /
+                                 (100 * m_cwnd)));
+  }
+}
+
 void PseudoTcp::resizeSendBuffer(uint32_t new_size) {
   m_sbuf_len = new_size;
   m_sbuf.SetCapacity(new_size);
@@ -1259,10 +1501,11 @@ void PseudoTcp::resizeReceiveBuffer(uint32_t new_size) {
 
   // Determine the scale factor such that the scaled window size can fit
   // in a 16-bit unsigned integer.
-  while (new_size > 0xFFFF) {
+  while (new_size > 0xFFFF && scale_factor < TCP_MAX_WND_SCALE) {
     ++scale_factor;
     new_size >>= 1;
   }
+  new_size = std::min<uint32_t>(new_size, 0xFFFF);
 
   // Determine the proper size of the buffer.
   new_size <<= scale_factor;
@@ -82,13 +82,15 @@ class PseudoTcp {
   // instance's behaviour for the kind of data it will carry.
   // If an unrecognized option is set or got, an assertion will fire.
   //
-  // Setting options for OPT_RCVBUF or OPT_SNDBUF after Connect() is called
-  // will result in an assertion.
+  // Setting options for OPT_RCVBUF, OPT_SNDBUF or OPT_SACK after Connect() is
+  // called will result in an assertion.
   enum Option {
     OPT_NODELAY,      // Whether to enable Nagle's algorithm (0 == off)
     OPT_ACKDELAY,     // The Delayed ACK timeout (0 == off).
     OPT_RCVBUF,       // Set the receive buffer size, in bytes.
     OPT_SNDBUF,       // Set the send buffer size, in bytes.
+    OPT_SACK,         // Whether to offer selective acknowledgments (0 == off).
+    OPT_CUBIC,        // Whether to use CUBIC congestion control (0 == Reno).
   };
   void GetOption(Option opt, int* value);
   void SetOption(Option opt, int value);
@@ -107,9 +109,22 @@ class PseudoTcp {
   // Returns current round-trip time estimate in milliseconds.
   uint32_t GetRoundTripTimeEstimateMs() const;
 
+  // Returns true if both sides agreed to use selective acknowledgments.
+  bool IsSackEnabled() const;
+
+  // Returns the number of segments retransmitted so far.
+  uint32_t GetRetransmitCount() const;
+
+  // Most SACK blocks carried by an ACK, as in RFC 2018 with timestamps.
+  static const uint8_t kMaxSackBlocks = 4;
+
  protected:
   enum SendFlags { sfNone, sfDelayedAck, sfImmediateAck };
 
+  struct SackBlock {
+    uint32_t left, right;
+  };
+
   struct Segment {
     uint32_t conv, seq, ack;
     uint8_t flags;
@@ -117,15 +132,19 @@ class PseudoTcp {
     const char * data;
     uint32_t len;
     uint32_t tsval, tsecr;
+    uint8_t sack_count;
+    SackBlock sack[kMaxSackBlocks];
   };
 
   struct SSegment {
     SSegment(uint32_t s, uint32_t l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {}
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), bSacked(false) {}
     uint32_t seq, len;
     // uint32_t tstamp;
     uint8_t xmit;
     bool bCtrl;
+    // Whether the peer reported holding this segment in a SACK block.
+    bool bSacked;
   };
   typedef std::list<SSegment> SList;
 
@@ -160,6 +179,20 @@ class PseudoTcp {
 
   void adjustMTU();
 
+  // Marks the segments covered by the SACK blocks of |seg|. Returns true if
+  // any segment was newly marked.
+  bool applySackBlocks(const Segment& seg);
+
+  // Returns the first unacknowledged segment below the highest SACKed one
+  // that hasn't been retransmitted during this recovery, or m_slist.end().
+  SList::iterator nextSackHole();
+
+  // Reduces m_ssthresh after a loss with |nInFlight| bytes in flight.
+  void onCongestionEvent(uint32_t nInFlight);
+
+  // Opens the congestion window for |nAcked| newly acknowledged bytes.
+  void growCongestionWindow(uint32_t nAcked, uint32_t now);
+
  protected:
   // This method is used in test only to query receive buffer state.
   bool isReceiveBufferFull() const;
@@ -181,6 +214,10 @@ class PseudoTcp {
   // Apply window scale option.
   void applyWindowScaleOption(uint8_t scale_factor);
 
+  // Writes the SACK blocks describing |m_rlist| after the header in
+  // |buffer|, returning their size in bytes.
+  uint32_t writeSackBlocks(uint8_t* buffer);
+
   // Resize the send buffer with |new_size| in bytes.
   void resizeSendBuffer(uint32_t new_size);
 
@@ -201,6 +238,9 @@ class PseudoTcp {
   // Incoming data
   typedef std::list<RSegment> RList;
   RList m_rlist;
+  // Sequence number of the latest out of order segment, reported in the
+  // first SACK block.
+  uint32_t m_rlast_seq;
   uint32_t m_rbuf_len, m_rcv_nxt, m_rcv_wnd, m_lastrecv;
   uint8_t m_rwnd_scale;  // Window scale factor.
   rtc::FifoBuffer m_rbuf;
@@ -227,6 +267,19 @@ class PseudoTcp {
   uint8_t m_dup_acks;
   uint32_t m_recover;
   uint32_t m_t_ack;
+  uint32_t m_retransmits;
+
+  // Selective acknowledgments (RFC 2018). |m_sack_high| is the end of the
+  // highest SACKed segment and |m_sack_rexmit| how far holes below it have
+  // been retransmitted in the current recovery.
+  bool m_support_sack, m_use_sack;
+  uint32_t m_sack_high, m_sack_rexmit;
+
+  // CUBIC state (RFC 8312), in bytes and milliseconds. |m_cubic_epoch| is
+  // the start of the current congestion avoidance period, or 0 if none.
+  bool m_use_cubic;
+  uint32_t m_cubic_wmax, m_cubic_epoch, m_cubic_origin;
+  double m_cubic_k;
 
   // Configuration options
   bool m_use_nagling;
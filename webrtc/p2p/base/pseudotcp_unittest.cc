@@ -9,15 +9,19 @@
  */
 
 #include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "webrtc/p2p/base/pseudotcp.h"
+#include "webrtc/base/asyncudpsocket.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/helpers.h"
 #include "webrtc/base/messagehandler.h"
+#include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/stream.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/base/timeutils.h"
+#include "webrtc/base/virtualsocketserver.h"
 
 using cricket::PseudoTcp;
 
@@ -97,6 +101,13 @@ class PseudoTcpTestBase : public testing::Test,
   void DisableLocalWindowScale() {
     local_.disableWindowScale();
   }
+  void DisableRemoteSack() {
+    remote_.SetOption(PseudoTcp::OPT_SACK, 0);
+  }
+  void SetOptCubic(bool enable_cubic) {
+    local_.SetOption(PseudoTcp::OPT_CUBIC, enable_cubic);
+    remote_.SetOption(PseudoTcp::OPT_CUBIC, enable_cubic);
+  }
 
  protected:
   int Connect() {
@@ -725,6 +736,52 @@ TEST_F(PseudoTcpTest, TestSendVerySmallReceiveBuffer) {
   TestTransfer(100000);
 }
 
+// Test a receive buffer of several MB, which needs a scale factor of 7.
+TEST_F(PseudoTcpTest, TestSendMultiMegabyteReceiveBuffer) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetRemoteOptRcvBuf(8 * 1024 * 1024);
+  SetLocalOptRcvBuf(8 * 1024 * 1024);
+  SetOptSndBuf(12 * 1024 * 1024);
+  TestTransfer(10000000);
+  int value = 0;
+  remote_.GetOption(PseudoTcp::OPT_RCVBUF, &value);
+  EXPECT_EQ(8 * 1024 * 1024, value);
+}
+
+// Test that selective acknowledgments are negotiated and used under loss.
+TEST_F(PseudoTcpTest, TestSendWithLossAndSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  TestTransfer(100000);
+  EXPECT_TRUE(local_.IsSackEnabled());
+  EXPECT_TRUE(remote_.IsSackEnabled());
+}
+
+// Test a peer that doesn't offer selective acknowledgments.
+TEST_F(PseudoTcpTest, TestSendWithLossRemoteNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableRemoteSack();
+  TestTransfer(100000);
+  EXPECT_FALSE(local_.IsSackEnabled());
+  EXPECT_FALSE(remote_.IsSackEnabled());
+}
+
+// Test CUBIC congestion control with a large window, delay and loss.
+TEST_F(PseudoTcpTest, TestSendWithCubic) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptCubic(true);
+  SetDelay(20);
+  SetLoss(1);
+  TestTransfer(1000000);
+}
+
 // Ping-pong (request/response) tests
 
 // Test sending <= 1x MTU of data in each ping/pong.  Should take <10ms.
@@ -839,3 +896,184 @@ TEST_F(PseudoTcpTest, TestSendWithMismatchedMtus) {
   TestTransfer(1000000);
 }
 */
+
+// Transfers data between two PseudoTcps over UDP sockets on a
+// VirtualSocketServer, whose delay, loss and bandwidth model the path.
+class PseudoTcpVirtualNetworkTest : public testing::Test,
+                                    public rtc::MessageHandler,
+                                    public cricket::IPseudoTcpNotify,
+                                    public sigslot::has_slots<> {
+ public:
+  struct Path {
+    int rtt_ms;
+    double loss;
+  };
+  struct Config {
+    const char* name;
+    int buffer_size;
+    bool sack;
+    bool cubic;
+  };
+
+  PseudoTcpVirtualNetworkTest()
+      : pss_(new rtc::PhysicalSocketServer),
+        vss_(new rtc::VirtualSocketServer(pss_.get())),
+        ss_scope_(vss_.get()) {}
+
+  // Returns the throughput in Kbps of a |size| byte transfer, over what was
+  // received if it didn't complete within |timeout_ms|.
+  int MeasureThroughput(const Path& path,
+                        const Config& config,
+                        int size,
+                        int timeout_ms) {
+    vss_->set_delay_mean(path.rtt_ms / 2);
+    vss_->UpdateDelayDistribution();
+    vss_->set_drop_probability(path.loss);
+    vss_->set_bandwidth(kBandwidth);
+    // Queues up to 125 ms worth of packets.
+    vss_->set_network_capacity(kBandwidth / 8);
+
+    local_socket_.reset(CreateSocket());
+    remote_socket_.reset(CreateSocket());
+    local_.reset(new PseudoTcp(this, 1));
+    remote_.reset(new PseudoTcp(this, 1));
+    for (PseudoTcp* tcp : {local_.get(), remote_.get()}) {
+      tcp->NotifyMTU(1500);
+      tcp->SetOption(PseudoTcp::OPT_RCVBUF, config.buffer_size);
+      tcp->SetOption(PseudoTcp::OPT_SNDBUF, config.buffer_size * 3 / 2);
+      tcp->SetOption(PseudoTcp::OPT_SACK, config.sack);
+      tcp->SetOption(PseudoTcp::OPT_CUBIC, config.cubic);
+    }
+    to_send_ = size;
+    received_ = 0;
+
+    uint32_t start = rtc::Time32();
+    EXPECT_EQ(0, local_->Connect());
+    UpdateClock(local_.get());
+    WAIT(received_ == size, timeout_ms);
+    int32_t elapsed = rtc::TimeDiff32(rtc::Time32(), start);
+
+    rtc::Thread::Current()->Clear(this);
+    local_.reset();
+    remote_.reset();
+    return static_cast<int>(int64_t{received_} * 8 / elapsed);
+  }
+
+ private:
+  static const uint32_t kBandwidth = 100 * 1000 * 1000 / 8;  // 100 Mbps.
+
+  rtc::AsyncUDPSocket* CreateSocket() {
+    rtc::AsyncUDPSocket* socket = rtc::AsyncUDPSocket::Create(
+        vss_.get(), rtc::SocketAddress("1.1.1.1", 0));
+    socket->SignalReadPacket.connect(
+        this, &PseudoTcpVirtualNetworkTest::OnReadPacket);
+    return socket;
+  }
+
+  PseudoTcp* Peer(PseudoTcp* tcp) {
+    return tcp == local_.get() ? remote_.get() : local_.get();
+  }
+
+  rtc::AsyncUDPSocket* Socket(PseudoTcp* tcp) {
+    return tcp == local_.get() ? local_socket_.get() : remote_socket_.get();
+  }
+
+  void UpdateClock(PseudoTcp* tcp) {
+    long interval = 0;  // NOLINT
+    tcp->GetNextClock(PseudoTcp::Now(), interval);
+    interval = std::max<int>(interval, 0L);
+    int id = tcp == local_.get() ? MSG_LCLOCK : MSG_RCLOCK;
+    rtc::Thread::Current()->Clear(this, id);
+    rtc::Thread::Current()->PostDelayed(RTC_FROM_HERE, interval, this, id);
+  }
+
+  void OnMessage(rtc::Message* message) override {
+    PseudoTcp* tcp =
+        message->message_id == MSG_LCLOCK ? local_.get() : remote_.get();
+    tcp->NotifyClock(PseudoTcp::Now());
+    UpdateClock(tcp);
+  }
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time) {
+    PseudoTcp* tcp =
+        socket == local_socket_.get() ? local_.get() : remote_.get();
+    if (tcp) {
+      tcp->NotifyPacket(data, size);
+      UpdateClock(tcp);
+    }
+  }
+
+  void OnTcpOpen(PseudoTcp* tcp) override {
+    if (tcp == local_.get()) {
+      OnTcpWriteable(tcp);
+    }
+  }
+
+  void OnTcpReadable(PseudoTcp* tcp) override {
+    char block[kBlockSize];
+    int read;
+    while ((read = tcp->Recv(block, sizeof(block))) > 0) {
+      received_ += read;
+    }
+  }
+
+  void OnTcpWriteable(PseudoTcp* tcp) override {
+    char block[kBlockSize] = {0};
+    while (to_send_ > 0) {
+      int sent =
+          tcp->Send(block, std::min<size_t>(sizeof(block), to_send_));
+      if (sent <= 0) {
+        break;
+      }
+      to_send_ -= sent;
+    }
+    UpdateClock(tcp);
+  }
+
+  void OnTcpClosed(PseudoTcp* tcp, uint32_t error) override {}
+
+  WriteResult TcpWritePacket(PseudoTcp* tcp,
+                             const char* buffer,
+                             size_t len) override {
+    rtc::PacketOptions options;
+    Socket(tcp)->SendTo(buffer, len, Socket(Peer(tcp))->GetLocalAddress(),
+                        options);
+    return WR_SUCCESS;
+  }
+
+  enum { MSG_LCLOCK, MSG_RCLOCK };
+
+  std::unique_ptr<rtc::PhysicalSocketServer> pss_;
+  std::unique_ptr<rtc::VirtualSocketServer> vss_;
+  rtc::SocketServerScope ss_scope_;
+  std::unique_ptr<rtc::AsyncUDPSocket> local_socket_;
+  std::unique_ptr<rtc::AsyncUDPSocket> remote_socket_;
+  std::unique_ptr<PseudoTcp> local_;
+  std::unique_ptr<PseudoTcp> remote_;
+  int to_send_ = 0;
+  int received_ = 0;
+};
+
+// Compares throughput over a 100 Mbps path with Reno and the default
+// buffers, large buffers with SACK, and CUBIC on top of that.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(PseudoTcpVirtualNetworkTest, DISABLED_Throughput) {
+  const int kSize = 8 * 1024 * 1024;
+  const int kTimeoutMs = 30000;
+  const Path kPaths[] = {{20, 0.0}, {100, 0.0}, {100, 0.001}, {100, 0.01}};
+  const Config kConfigs[] = {{"reno, 60 KB", 60 * 1024, false, false},
+                             {"reno+sack, 4 MB", 4 * 1024 * 1024, true, false},
+                             {"cubic+sack, 4 MB", 4 * 1024 * 1024, true, true}};
+  for (const Path& path : kPaths) {
+    for (const Config& config : kConfigs) {
+      int kbps = MeasureThroughput(path, config, kSize, kTimeoutMs);
+      LOG(LS_INFO) << "rtt " << path.rtt_ms << " ms, loss "
+                   << path.loss * 100 << "%, " << config.name << ": " << kbps
+                   << " Kbps";
+    }
+  }
+}
@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/shardedturnserver.h"
+
+#include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/bind.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+
+namespace cricket {
+
+ShardedTurnServer::ShardedTurnServer(size_t num_shards)
+    : num_shards_(num_shards), auth_hook_(nullptr) {
+  RTC_DCHECK_GT(num_shards_, 0u);
+}
+
+ShardedTurnServer::~ShardedTurnServer() {
+  Stop();
+}
+
+bool ShardedTurnServer::Start(const rtc::SocketAddress& internal_addr,
+                              const rtc::IPAddress& external_ip) {
+  RTC_DCHECK(!started());
+  rtc::SocketAddress addr = internal_addr;
+  for (size_t i = 0; i < num_shards_; ++i) {
+    std::unique_ptr<Shard> shard(new Shard());
+    shard->thread = rtc::Thread::CreateWithSocketServer();
+    shard->thread->SetName("ShardedTurnServer", shard.get());
+    shard->thread->Start();
+    // Push the shard first so that Stop() cleans it up on failure.
+    shards_.push_back(std::move(shard));
+    Shard* started_shard = shards_.back().get();
+    rtc::SocketAddress bound_addr;
+    if (!started_shard->thread->Invoke<bool>(
+            RTC_FROM_HERE, rtc::Bind(&ShardedTurnServer::StartShard, this,
+                                     started_shard, addr, external_ip,
+                                     &bound_addr))) {
+      Stop();
+      return false;
+    }
+    // Later shards share the port the first one got.
+    addr = bound_addr;
+  }
+  internal_address_ = addr;
+  LOG(LS_INFO) << "ShardedTurnServer listening on "
+               << internal_address_.ToString() << " with " << num_shards_
+               << " shards.";
+  return true;
+}
+
+void ShardedTurnServer::Stop() {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    shard->thread->Invoke<void>(
+        RTC_FROM_HERE,
+        rtc::Bind(&ShardedTurnServer::StopShard, this, shard.get()));
+    shard->thread->Stop();
+  }
+  shards_.clear();
+  internal_address_.Clear();
+}
+
+std::vector<size_t> ShardedTurnServer::GetAllocationCounts() const {
+  std::vector<size_t> counts;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    counts.push_back(shard->thread->Invoke<size_t>(
+        RTC_FROM_HERE, rtc::Bind(&ShardedTurnServer::CountAllocations, this,
+                                 shard.get())));
+  }
+  return counts;
+}
+
+bool ShardedTurnServer::StartShard(Shard* shard,
+                                   const rtc::SocketAddress& internal_addr,
+                                   const rtc::IPAddress& external_ip,
+                                   rtc::SocketAddress* bound_addr) {
+  RTC_DCHECK(shard->thread->IsCurrent());
+  std::unique_ptr<rtc::AsyncSocket> socket(
+      shard->thread->socketserver()->CreateAsyncSocket(
+          internal_addr.family(), SOCK_DGRAM));
+  if (!socket) {
+    LOG(LS_ERROR) << "Failed to create a TURN shard socket.";
+    return false;
+  }
+  if (socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1) != 0 &&
+      num_shards_ > 1) {
+    LOG(LS_ERROR) << "Sharding a TURN server needs SO_REUSEPORT.";
+    return false;
+  }
+  if (socket->Bind(internal_addr) != 0) {
+    LOG(LS_ERROR) << "Failed to bind a TURN shard socket to "
+                  << internal_addr.ToString() << ", err="
+                  << socket->GetError();
+    return false;
+  }
+  *bound_addr = socket->GetLocalAddress();
+
+  shard->server.reset(new TurnServer(shard->thread.get()));
+  shard->server->set_realm(realm_);
+  shard->server->set_software(software_);
+  shard->server->set_auth_hook(auth_hook_);
+  shard->server->AddInternalSocket(new rtc::AsyncUDPSocket(socket.release()),
+                                   PROTO_UDP);
+  shard->server->SetExternalSocketFactory(
+      new rtc::BasicPacketSocketFactory(),
+      rtc::SocketAddress(external_ip, 0));
+  return true;
+}
+
+void ShardedTurnServer::StopShard(Shard* shard) {
+  RTC_DCHECK(shard->thread->IsCurrent());
+  shard->server.reset();
+}
+
+size_t ShardedTurnServer::CountAllocations(const Shard* shard) const {
+  RTC_DCHECK(shard->thread->IsCurrent());
+  return shard->server ? shard->server->allocations().size() : 0;
+}
+
+}  // namespace cricket
@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
+#define WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/ipaddress.h"
+#include "webrtc/base/socketaddress.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/p2p/base/turnserver.h"
+
+namespace cricket {
+
+// Runs a TurnServer on each of several network threads, so a relay can use
+// more than one core. Every shard has its own UDP socket bound to the same
+// internal address with OPT_REUSEPORT, its own allocation table and its own
+// external sockets; the kernel spreads clients over the shard sockets by
+// hashing their 5-tuple, so all packets from a client reach the same shard
+// and the shards never need to share allocation state.
+//
+// The realm, software and auth hook are shared by all shards. Since the auth
+// hook is called on every shard thread, it must be thread safe.
+//
+// Only UDP is supported. Multiple shards need SO_REUSEPORT, which Linux and
+// most BSDs have; elsewhere Start() fails unless there is only one shard.
+// The setters and Start() must not be called once the server is started.
+class ShardedTurnServer {
+ public:
+  explicit ShardedTurnServer(size_t num_shards);
+  ~ShardedTurnServer();
+
+  void set_realm(const std::string& realm) { realm_ = realm; }
+  void set_software(const std::string& software) { software_ = software; }
+  // Does not take ownership.
+  void set_auth_hook(TurnAuthInterface* auth_hook) { auth_hook_ = auth_hook; }
+
+  // Starts a shard thread for each shard and binds its socket to
+  // |internal_addr|. If the port of |internal_addr| is 0, the first shard
+  // picks one and the others bind to it. Relayed addresses are allocated on
+  // |external_ip|. Returns false, with all shards stopped, on failure.
+  bool Start(const rtc::SocketAddress& internal_addr,
+             const rtc::IPAddress& external_ip);
+  // Closes all allocations and stops the shard threads.
+  void Stop();
+
+  size_t num_shards() const { return num_shards_; }
+  bool started() const { return !shards_.empty(); }
+  // The address the shards are bound to, once started.
+  const rtc::SocketAddress& internal_address() const {
+    return internal_address_;
+  }
+
+  // Returns the number of allocations on each shard.
+  std::vector<size_t> GetAllocationCounts() const;
+
+ private:
+  struct Shard {
+    std::unique_ptr<rtc::Thread> thread;
+    std::unique_ptr<TurnServer> server;
+  };
+
+  // These run on the shard's thread.
+  bool StartShard(Shard* shard,
+                  const rtc::SocketAddress& internal_addr,
+                  const rtc::IPAddress& external_ip,
+                  rtc::SocketAddress* bound_addr);
+  void StopShard(Shard* shard);
+  size_t CountAllocations(const Shard* shard) const;
+
+  const size_t num_shards_;
+  std::string realm_;
+  std::string software_;
+  TurnAuthInterface* auth_hook_;
+  rtc::SocketAddress internal_address_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ShardedTurnServer);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_SHARDEDTURNSERVER_H_
@@ -0,0 +1,363 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/helpers.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/p2p/base/shardedturnserver.h"
+#include "webrtc/p2p/base/stun.h"
+
+namespace cricket {
+
+namespace {
+
+const char kRealm[] = "example.org";
+const int kTimeoutMs = 10000;
+
+// Accepts any username, with the username as the password. Thread safe since
+// it has no state.
+class TestAuth : public TurnAuthInterface {
+ public:
+  bool GetKey(const std::string& username,
+              const std::string& realm,
+              std::string* key) override {
+    return ComputeStunCredentialHash(username, realm, username, key);
+  }
+};
+
+// Counts the packets that arrive on a UDP socket.
+class TestPeer : public sigslot::has_slots<> {
+ public:
+  explicit TestPeer(rtc::SocketServer* ss)
+      : socket_(rtc::AsyncUDPSocket::Create(
+            ss,
+            rtc::SocketAddress(rtc::IPAddress(INADDR_LOOPBACK), 0))),
+        packets_(0) {
+    socket_->SignalReadPacket.connect(this, &TestPeer::OnReadPacket);
+  }
+
+  rtc::SocketAddress address() const { return socket_->GetLocalAddress(); }
+  uint64_t packets() const { return packets_; }
+
+ private:
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time) {
+    ++packets_;
+  }
+
+  std::unique_ptr<rtc::AsyncUDPSocket> socket_;
+  uint64_t packets_;
+};
+
+// A minimal TURN client over UDP: allocates, answering the 401 challenge,
+// creates a permission for one peer and then sends data to it in send
+// indications.
+class TestTurnClient : public sigslot::has_slots<> {
+ public:
+  TestTurnClient(rtc::SocketServer* ss,
+                 const rtc::SocketAddress& server_addr,
+                 const rtc::SocketAddress& peer_addr,
+                 const std::string& username)
+      : socket_(rtc::AsyncUDPSocket::Create(
+            ss,
+            rtc::SocketAddress(rtc::IPAddress(INADDR_LOOPBACK), 0))),
+        server_addr_(server_addr),
+        peer_addr_(peer_addr),
+        username_(username),
+        ready_(false),
+        failed_(false) {
+    socket_->SignalReadPacket.connect(this, &TestTurnClient::OnReadPacket);
+  }
+
+  bool ready() const { return ready_; }
+  bool failed() const { return failed_; }
+
+  void Start() {
+    TurnMessage msg;
+    msg.SetType(STUN_ALLOCATE_REQUEST);
+    msg.SetTransactionID(rtc::CreateRandomString(kStunTransactionIdLength));
+    msg.AddAttribute(new StunUInt32Attribute(STUN_ATTR_REQUESTED_TRANSPORT,
+                                             IPPROTO_UDP << 24));
+    Send(msg);
+  }
+
+  void SendData(const char* data, size_t size) {
+    TurnMessage msg;
+    msg.SetType(TURN_SEND_INDICATION);
+    msg.SetTransactionID(rtc::CreateRandomString(kStunTransactionIdLength));
+    msg.AddAttribute(
+        new StunXorAddressAttribute(STUN_ATTR_XOR_PEER_ADDRESS, peer_addr_));
+    msg.AddAttribute(new StunByteStringAttribute(STUN_ATTR_DATA, data, size));
+    Send(msg);
+  }
+
+ private:
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time) {
+    TurnMessage msg;
+    rtc::ByteBufferReader buf(data, size);
+    if (!msg.Read(&buf)) {
+      failed_ = true;
+      return;
+    }
+    switch (msg.type()) {
+      case STUN_ALLOCATE_ERROR_RESPONSE: {
+        const StunErrorCodeAttribute* error = msg.GetErrorCode();
+        const StunByteStringAttribute* nonce =
+            msg.GetByteString(STUN_ATTR_NONCE);
+        const StunByteStringAttribute* realm =
+            msg.GetByteString(STUN_ATTR_REALM);
+        if (!error || error->code() != STUN_ERROR_UNAUTHORIZED || !nonce ||
+            !realm || !nonce_.empty()) {
+          failed_ = true;
+          return;
+        }
+        nonce_ = nonce->GetString();
+        realm_ = realm->GetString();
+        ComputeStunCredentialHash(username_, realm_, username_, &key_);
+        TurnMessage request;
+        request.SetType(STUN_ALLOCATE_REQUEST);
+        request.SetTransactionID(
+            rtc::CreateRandomString(kStunTransactionIdLength));
+        request.AddAttribute(new StunUInt32Attribute(
+            STUN_ATTR_REQUESTED_TRANSPORT, IPPROTO_UDP << 24));
+        SendAuthenticated(&request);
+        break;
+      }
+      case STUN_ALLOCATE_RESPONSE: {
+        TurnMessage request;
+        request.SetType(TURN_CREATE_PERMISSION_REQUEST);
+        request.SetTransactionID(
+            rtc::CreateRandomString(kStunTransactionIdLength));
+        request.AddAttribute(new StunXorAddressAttribute(
+            STUN_ATTR_XOR_PEER_ADDRESS, peer_addr_));
+        SendAuthenticated(&request);
+        break;
+      }
+      case TURN_CREATE_PERMISSION_RESPONSE:
+        ready_ = true;
+        break;
+      default:
+        failed_ = true;
+        break;
+    }
+  }
+
+  void SendAuthenticated(TurnMessage* msg) {
+    msg->AddAttribute(new StunByteStringAttribute(STUN_ATTR_USERNAME,
+                                                  username_));
+    msg->AddAttribute(new StunByteStringAttribute(STUN_ATTR_REALM, realm_));
+    msg->AddAttribute(new StunByteStringAttribute(STUN_ATTR_NONCE, nonce_));
+    msg->AddMessageIntegrity(key_);
+    Send(*msg);
+  }
+
+  void Send(const TurnMessage& msg) {
+    rtc::ByteBufferWriter buf;
+    msg.Write(&buf);
+    rtc::PacketOptions options;
+    socket_->SendTo(buf.Data(), buf.Length(), server_addr_, options);
+  }
+
+  std::unique_ptr<rtc::AsyncUDPSocket> socket_;
+  const rtc::SocketAddress server_addr_;
+  const rtc::SocketAddress peer_addr_;
+  const std::string username_;
+  std::string realm_;
+  std::string nonce_;
+  std::string key_;
+  bool ready_;
+  bool failed_;
+};
+
+}  // namespace
+
+class ShardedTurnServerTest : public testing::Test {
+ public:
+  ShardedTurnServerTest() : ss_scope_(&pss_), peer_(&pss_) {}
+
+  bool StartServer(ShardedTurnServer* server) {
+    server->set_realm(kRealm);
+    server->set_auth_hook(&auth_);
+    return server->Start(
+        rtc::SocketAddress(rtc::IPAddress(INADDR_LOOPBACK), 0),
+        rtc::IPAddress(INADDR_LOOPBACK));
+  }
+
+  void CreateClients(const ShardedTurnServer& server, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      clients_.push_back(std::unique_ptr<TestTurnClient>(new TestTurnClient(
+          &pss_, server.internal_address(), peer_.address(),
+          "user" + rtc::ToString(i))));
+    }
+  }
+
+  size_t CountReady() const {
+    size_t ready = 0;
+    for (const std::unique_ptr<TestTurnClient>& client : clients_) {
+      EXPECT_FALSE(client->failed());
+      if (client->ready())
+        ++ready;
+    }
+    return ready;
+  }
+
+ protected:
+  rtc::PhysicalSocketServer pss_;
+  rtc::SocketServerScope ss_scope_;
+  TestAuth auth_;
+  TestPeer peer_;
+  std::vector<std::unique_ptr<TestTurnClient>> clients_;
+};
+
+#if defined(SO_REUSEPORT)
+TEST_F(ShardedTurnServerTest, SpreadsAllocationsOverShards) {
+  static const size_t kShards = 4;
+  static const size_t kClients = 32;
+  ShardedTurnServer server(kShards);
+  ASSERT_TRUE(StartServer(&server));
+  EXPECT_EQ(kShards, server.num_shards());
+  EXPECT_NE(0, server.internal_address().port());
+
+  CreateClients(server, kClients);
+  for (std::unique_ptr<TestTurnClient>& client : clients_)
+    client->Start();
+  EXPECT_EQ_WAIT(kClients, CountReady(), kTimeoutMs);
+
+  std::vector<size_t> counts = server.GetAllocationCounts();
+  ASSERT_EQ(kShards, counts.size());
+  size_t total = 0;
+  size_t used_shards = 0;
+  for (size_t count : counts) {
+    total += count;
+    if (count > 0)
+      ++used_shards;
+  }
+  EXPECT_EQ(kClients, total);
+  // The chance of 32 clients hashing to the same shard is negligible.
+  EXPECT_GT(used_shards, 1u);
+
+  for (std::unique_ptr<TestTurnClient>& client : clients_)
+    client->SendData("ping", 4);
+  EXPECT_EQ_WAIT(kClients, peer_.packets(), kTimeoutMs);
+
+  server.Stop();
+  EXPECT_FALSE(server.started());
+  EXPECT_TRUE(server.GetAllocationCounts().empty());
+}
+#endif
+
+TEST_F(ShardedTurnServerTest, SingleShard) {
+  ShardedTurnServer server(1);
+  ASSERT_TRUE(StartServer(&server));
+  CreateClients(server, 1);
+  clients_[0]->Start();
+  EXPECT_TRUE_WAIT(clients_[0]->ready(), kTimeoutMs);
+  EXPECT_EQ(std::vector<size_t>({1}), server.GetAllocationCounts());
+  clients_[0]->SendData("ping", 4);
+  EXPECT_EQ_WAIT(1u, peer_.packets(), kTimeoutMs);
+}
+
+TEST_F(ShardedTurnServerTest, FailsToStartOnAddressInUse) {
+  // Doesn't set OPT_REUSEPORT, so the shards can't share its port.
+  std::unique_ptr<rtc::AsyncUDPSocket> socket(rtc::AsyncUDPSocket::Create(
+      &pss_, rtc::SocketAddress(rtc::IPAddress(INADDR_LOOPBACK), 0)));
+  ASSERT_TRUE(socket);
+  ShardedTurnServer server(2);
+  server.set_realm(kRealm);
+  EXPECT_FALSE(server.Start(socket->GetLocalAddress(),
+                            rtc::IPAddress(INADDR_LOOPBACK)));
+  EXPECT_FALSE(server.started());
+}
+
+// Load generator: measures allocations per second and relayed packets per
+// second for different numbers of shards. Each shard runs on its own thread,
+// so the per shard rates are the per core rates. The client side runs on the
+// test thread and can be the bottleneck with many shards.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+#if defined(SO_REUSEPORT)
+TEST_F(ShardedTurnServerTest, DISABLED_Performance) {
+  // Each allocation takes a client and a relay socket in this process, which
+  // must stay within FD_SETSIZE for PhysicalSocketServer.
+  static const size_t kClients = 200;
+  static const uint64_t kPacketsPerClient = 1000;
+  // Packets in flight, bounded to avoid overflowing socket buffers.
+  static const uint64_t kWindow = 256;
+  static const int64_t kStallMs = 50;
+  static const char kPayload[100] = {0};
+
+  for (size_t shards : {1, 2, 4}) {
+    clients_.clear();
+    ShardedTurnServer server(shards);
+    ASSERT_TRUE(StartServer(&server));
+    CreateClients(server, kClients);
+
+    int64_t start = rtc::TimeNanos();
+    for (std::unique_ptr<TestTurnClient>& client : clients_) {
+      client->Start();
+      // Let responses in so that requests don't pile up in socket buffers.
+      rtc::Thread::Current()->ProcessMessages(0);
+    }
+    ASSERT_EQ_WAIT(kClients, CountReady(), kTimeoutMs);
+    int64_t allocate_ns = rtc::TimeNanos() - start;
+
+    const uint64_t base = peer_.packets();
+    const uint64_t total = kClients * kPacketsPerClient;
+    uint64_t sent = 0;
+    uint64_t lost = 0;
+    uint64_t last_received = 0;
+    int64_t last_progress_ms = rtc::TimeMillis();
+    start = rtc::TimeNanos();
+    while (sent < total || peer_.packets() - base + lost < total) {
+      uint64_t received = peer_.packets() - base;
+      while (sent < total && sent - received - lost < kWindow) {
+        clients_[sent % kClients]->SendData(kPayload, sizeof(kPayload));
+        ++sent;
+      }
+      rtc::Thread::Current()->ProcessMessages(0);
+      if (received != last_received) {
+        last_received = received;
+        last_progress_ms = rtc::TimeMillis();
+      } else if (rtc::TimeMillis() - last_progress_ms > kStallMs) {
+        // Whatever is still in flight was dropped.
+        lost = sent - received;
+        last_progress_ms = rtc::TimeMillis();
+      }
+    }
+    int64_t relay_ns = rtc::TimeNanos() - start;
+    uint64_t relayed = peer_.packets() - base;
+
+    double allocations_per_s = kClients * 1e9 / allocate_ns;
+    double packets_per_s = relayed * 1e9 / relay_ns;
+    LOG(LS_INFO) << shards << " shards: " << allocations_per_s
+                 << " allocations/s (" << allocations_per_s / shards
+                 << " per core), " << packets_per_s << " packets/s ("
+                 << packets_per_s / shards << " per core), " << lost
+                 << " of " << total << " packets lost.";
+  }
+}
+#endif
+
+}  // namespace cricket
@@ -12,9 +12,11 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <memory>
 
 #include "webrtc/base/byteorder.h"
+#include "webrtc/base/checks.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/crc32.h"
 #include "webrtc/base/logging.h"
@@ -414,6 +416,361 @@ bool StunMessage::IsValidTransactionId(const std::string& transaction_id) {
       transaction_id.size() == kStunLegacyTransactionIdLength;
 }
 
+// StunMessageView
+
+namespace {
+
+size_t PaddedLength(size_t length) {
+  return (length + 3) & ~static_cast<size_t>(3);
+}
+
+// Address values are XORed bytewise with the magic cookie and then, for IPv6,
+// the transaction ID; see RFC 5389, section 15.2.
+void XorAddressBytes(char* bytes, size_t length, const char* transaction_id) {
+  char magic_cookie[kStunMagicCookieLength];
+  rtc::SetBE32(magic_cookie, kStunMagicCookie);
+  for (size_t i = 0; i < length; ++i) {
+    bytes[i] ^= i < kStunMagicCookieLength
+                    ? magic_cookie[i]
+                    : transaction_id[i - kStunMagicCookieLength];
+  }
+}
+
+}  // namespace
+
+const size_t StunMessageView::kMaxAttributes;
+
+StunMessageView::StunMessageView()
+    : data_(NULL),
+      type_(0),
+      length_(0),
+      transaction_id_(EMPTY_TRANSACTION_ID),
+      transaction_id_length_(kStunLegacyTransactionIdLength),
+      num_attributes_(0) {
+}
+
+bool StunMessageView::Read(ByteBufferReader* buf) {
+  const char* data = buf->Data();
+  size_t size = buf->Length();
+  if (size < kStunHeaderSize)
+    return false;
+
+  uint16_t type = rtc::GetBE16(data);
+  if (type & 0x8000) {
+    // RTP and RTCP set the MSB of first byte; see StunMessage::Read().
+    return false;
+  }
+  uint16_t length = rtc::GetBE16(data + 2);
+  if (length != size - kStunHeaderSize)
+    return false;
+
+  // Parse into locals so that a failed read leaves the view as it was.
+  Attribute attributes[kMaxAttributes];
+  size_t num_attributes = 0;
+  size_t pos = kStunHeaderSize;
+  while (pos < size) {
+    if (size - pos < kStunAttributeHeaderSize)
+      return false;
+    uint16_t attr_type = rtc::GetBE16(data + pos);
+    uint16_t attr_length = rtc::GetBE16(data + pos + 2);
+    pos += kStunAttributeHeaderSize;
+    if (attr_length > size - pos || num_attributes == kMaxAttributes)
+      return false;
+    attributes[num_attributes].type = attr_type;
+    attributes[num_attributes].length = attr_length;
+    attributes[num_attributes].offset = static_cast<uint32_t>(pos);
+    ++num_attributes;
+    // Like StunMessage::Read(), tolerate missing padding at the very end.
+    pos = std::min(size, pos + PaddedLength(attr_length));
+  }
+
+  data_ = data;
+  type_ = type;
+  length_ = length;
+  if (rtc::GetBE32(data + kStunTransactionIdOffset - kStunMagicCookieLength) !=
+      kStunMagicCookie) {
+    // RFC3489 has no magic cookie; it's part of the transaction ID instead.
+    transaction_id_ = data + kStunTransactionIdOffset - kStunMagicCookieLength;
+    transaction_id_length_ = kStunLegacyTransactionIdLength;
+  } else {
+    transaction_id_ = data + kStunTransactionIdOffset;
+    transaction_id_length_ = kStunTransactionIdLength;
+  }
+  std::copy(attributes, attributes + num_attributes, attributes_);
+  num_attributes_ = num_attributes;
+  buf->Consume(size);
+  return true;
+}
+
+bool StunMessageView::GetByteString(int type,
+                                    const char** bytes,
+                                    size_t* length) const {
+  const Attribute* attr = FindAttribute(type);
+  if (!attr)
+    return false;
+  *bytes = data_ + attr->offset;
+  *length = attr->length;
+  return true;
+}
+
+bool StunMessageView::GetUInt32(int type, uint32_t* value) const {
+  const Attribute* attr = FindAttribute(type);
+  if (!attr || attr->length != StunUInt32Attribute::SIZE)
+    return false;
+  *value = rtc::GetBE32(data_ + attr->offset);
+  return true;
+}
+
+bool StunMessageView::GetUInt64(int type, uint64_t* value) const {
+  const Attribute* attr = FindAttribute(type);
+  if (!attr || attr->length != StunUInt64Attribute::SIZE)
+    return false;
+  *value = rtc::GetBE64(data_ + attr->offset);
+  return true;
+}
+
+bool StunMessageView::GetAddress(int type, rtc::SocketAddress* addr) const {
+  return GetAddress(type, false, addr);
+}
+
+bool StunMessageView::GetXorAddress(int type, rtc::SocketAddress* addr) const {
+  return GetAddress(type, true, addr);
+}
+
+bool StunMessageView::GetErrorCode(int* code) const {
+  const Attribute* attr = FindAttribute(STUN_ATTR_ERROR_CODE);
+  if (!attr || attr->length < StunErrorCodeAttribute::MIN_SIZE)
+    return false;
+  uint32_t val = rtc::GetBE32(data_ + attr->offset);
+  *code = ((val >> 8) & 0x7) * 100 + (val & 0xff);
+  return true;
+}
+
+const StunMessageView::Attribute* StunMessageView::FindAttribute(
+    int type) const {
+  for (size_t i = 0; i < num_attributes_; ++i) {
+    if (attributes_[i].type == type)
+      return &attributes_[i];
+  }
+  return NULL;
+}
+
+bool StunMessageView::GetAddress(int type,
+                                 bool xor_address,
+                                 rtc::SocketAddress* addr) const {
+  const Attribute* attr = FindAttribute(type);
+  if (!attr || attr->length < 4)
+    return false;
+  const char* value = data_ + attr->offset;
+  uint8_t family = static_cast<uint8_t>(value[1]);
+  uint16_t port = rtc::GetBE16(value + 2);
+  if (xor_address)
+    port ^= (kStunMagicCookie >> 16);
+
+  if (family == STUN_ADDRESS_IPV4 &&
+      attr->length == StunAddressAttribute::SIZE_IP4) {
+    in_addr v4addr;
+    memcpy(&v4addr, value + 4, sizeof(v4addr));
+    if (xor_address) {
+      XorAddressBytes(reinterpret_cast<char*>(&v4addr), sizeof(v4addr),
+                      transaction_id_);
+    }
+    addr->SetIP(rtc::IPAddress(v4addr));
+  } else if (family == STUN_ADDRESS_IPV6 &&
+             attr->length == StunAddressAttribute::SIZE_IP6) {
+    if (xor_address && IsLegacy())
+      return false;
+    in6_addr v6addr;
+    memcpy(&v6addr, value + 4, sizeof(v6addr));
+    if (xor_address) {
+      XorAddressBytes(reinterpret_cast<char*>(&v6addr), sizeof(v6addr),
+                      transaction_id_);
+    }
+    addr->SetIP(rtc::IPAddress(v6addr));
+  } else {
+    return false;
+  }
+  addr->SetPort(port);
+  return true;
+}
+
+// StunMessageWriter
+
+StunMessageWriter::StunMessageWriter(char* buffer, size_t capacity)
+    : buffer_(buffer), capacity_(capacity), length_(0), legacy_(false) {
+}
+
+bool StunMessageWriter::Start(int type,
+                              const char* transaction_id,
+                              size_t transaction_id_length) {
+  length_ = 0;
+  if (capacity_ < kStunHeaderSize)
+    return false;
+  rtc::SetBE16(buffer_, static_cast<uint16_t>(type));
+  rtc::SetBE16(buffer_ + 2, 0);
+  if (transaction_id_length == kStunTransactionIdLength) {
+    rtc::SetBE32(buffer_ + kStunTransactionIdOffset - kStunMagicCookieLength,
+                 kStunMagicCookie);
+    memcpy(buffer_ + kStunTransactionIdOffset, transaction_id,
+           transaction_id_length);
+    legacy_ = false;
+  } else if (transaction_id_length == kStunLegacyTransactionIdLength) {
+    memcpy(buffer_ + kStunTransactionIdOffset - kStunMagicCookieLength,
+           transaction_id, transaction_id_length);
+    legacy_ = true;
+  } else {
+    return false;
+  }
+  length_ = kStunHeaderSize;
+  return true;
+}
+
+bool StunMessageWriter::AddByteString(int type,
+                                      const char* bytes,
+                                      size_t length) {
+  char* value = AddAttribute(type, length);
+  if (!value)
+    return false;
+  if (length > 0)
+    memcpy(value, bytes, length);
+  return true;
+}
+
+bool StunMessageWriter::AddUInt32(int type, uint32_t value) {
+  char* attr_value = AddAttribute(type, StunUInt32Attribute::SIZE);
+  if (!attr_value)
+    return false;
+  rtc::SetBE32(attr_value, value);
+  return true;
+}
+
+bool StunMessageWriter::AddUInt64(int type, uint64_t value) {
+  char* attr_value = AddAttribute(type, StunUInt64Attribute::SIZE);
+  if (!attr_value)
+    return false;
+  rtc::SetBE64(attr_value, value);
+  return true;
+}
+
+bool StunMessageWriter::AddAddress(int type, const rtc::SocketAddress& addr) {
+  return AddAddress(type, addr, false);
+}
+
+bool StunMessageWriter::AddXorAddress(int type,
+                                      const rtc::SocketAddress& addr) {
+  return AddAddress(type, addr, true);
+}
+
+bool StunMessageWriter::AddErrorCode(int code, const std::string& reason) {
+  char* value = AddAttribute(STUN_ATTR_ERROR_CODE,
+                             StunErrorCodeAttribute::MIN_SIZE + reason.size());
+  if (!value)
+    return false;
+  rtc::SetBE32(value, (code / 100) << 8 | (code % 100));
+  memcpy(value + StunErrorCodeAttribute::MIN_SIZE, reason.data(),
+         reason.size());
+  return true;
+}
+
+bool StunMessageWriter::AddMessageIntegrity(const std::string& password) {
+  size_t attr_pos = length_;
+  char* value = AddAttribute(STUN_ATTR_MESSAGE_INTEGRITY,
+                             kStunMessageIntegritySize);
+  if (!value)
+    return false;
+
+  // The HMAC covers the message up to the attribute, with a length that
+  // includes it, which is what the header says now.
+  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
+                                password.c_str(), password.size(),
+                                buffer_, attr_pos,
+                                value, kStunMessageIntegritySize);
+  ASSERT(ret == kStunMessageIntegritySize);
+  if (ret != kStunMessageIntegritySize) {
+    LOG(LS_ERROR) << "HMAC computation failed.";
+    length_ = attr_pos;
+    rtc::SetBE16(buffer_ + 2,
+                 static_cast<uint16_t>(length_ - kStunHeaderSize));
+    return false;
+  }
+  return true;
+}
+
+bool StunMessageWriter::AddFingerprint() {
+  size_t attr_pos = length_;
+  char* value = AddAttribute(STUN_ATTR_FINGERPRINT, StunUInt32Attribute::SIZE);
+  if (!value)
+    return false;
+  uint32_t crc = rtc::ComputeCrc32(buffer_, attr_pos);
+  rtc::SetBE32(value, crc ^ STUN_FINGERPRINT_XOR_VALUE);
+  return true;
+}
+
+char* StunMessageWriter::AddAttribute(int type, size_t length) {
+  RTC_DCHECK_GE(length_, kStunHeaderSize) << "Start() has not succeeded.";
+  size_t padded_length = PaddedLength(length);
+  if (length_ < kStunHeaderSize || length > 0xffff ||
+      capacity_ - length_ < kStunAttributeHeaderSize + padded_length ||
+      length_ + kStunAttributeHeaderSize + padded_length - kStunHeaderSize >
+          0xffff) {
+    return NULL;
+  }
+  char* attr = buffer_ + length_;
+  rtc::SetBE16(attr, static_cast<uint16_t>(type));
+  rtc::SetBE16(attr + 2, static_cast<uint16_t>(length));
+  char* value = attr + kStunAttributeHeaderSize;
+  memset(value + length, 0, padded_length - length);
+  length_ += kStunAttributeHeaderSize + padded_length;
+  rtc::SetBE16(buffer_ + 2, static_cast<uint16_t>(length_ - kStunHeaderSize));
+  return value;
+}
+
+bool StunMessageWriter::AddAddress(int type,
+                                   const rtc::SocketAddress& addr,
+                                   bool xor_address) {
+  const rtc::IPAddress& ip = addr.ipaddr();
+  uint8_t family;
+  size_t length;
+  switch (ip.family()) {
+    case AF_INET:
+      family = STUN_ADDRESS_IPV4;
+      length = StunAddressAttribute::SIZE_IP4;
+      break;
+    case AF_INET6:
+      // XOR-ing an IPv6 address needs an RFC5389 transaction ID.
+      if (xor_address && legacy_)
+        return false;
+      family = STUN_ADDRESS_IPV6;
+      length = StunAddressAttribute::SIZE_IP6;
+      break;
+    default:
+      LOG(LS_ERROR) << "Error writing address attribute: unknown family.";
+      return false;
+  }
+  char* value = AddAttribute(type, length);
+  if (!value)
+    return false;
+  value[0] = 0;
+  value[1] = static_cast<char>(family);
+  uint16_t port = addr.port();
+  if (xor_address)
+    port ^= (kStunMagicCookie >> 16);
+  rtc::SetBE16(value + 2, port);
+  char* address = value + 4;
+  if (family == STUN_ADDRESS_IPV4) {
+    in_addr v4addr = ip.ipv4_address();
+    memcpy(address, &v4addr, sizeof(v4addr));
+  } else {
+    in6_addr v6addr = ip.ipv6_address();
+    memcpy(address, &v6addr, sizeof(v6addr));
+  }
+  if (xor_address) {
+    XorAddressBytes(address, length - 4,
+                    buffer_ + kStunTransactionIdOffset);
+  }
+  return true;
+}
+
 // StunAttribute
 
 StunAttribute::StunAttribute(uint16_t type, uint16_t length)
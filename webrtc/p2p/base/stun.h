@@ -19,6 +19,7 @@
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/constructormagic.h"
 #include "webrtc/base/socketaddress.h"
 
 namespace cricket {
@@ -204,6 +205,112 @@ class StunMessage {
   std::vector<StunAttribute*>* attrs_;
 };
 
+// A read-only view of a STUN message that parses it in place. Unlike
+// StunMessage, reading allocates nothing: the view records where each
+// attribute is in the input, and the Get* methods decode values from there on
+// demand. The input must outlive the view.
+class StunMessageView {
+ public:
+  // Messages with more attributes than this fail to read.
+  static const size_t kMaxAttributes = 32;
+
+  StunMessageView();
+
+  int type() const { return type_; }
+  size_t length() const { return length_; }
+  // See StunMessage::IsLegacy().
+  bool IsLegacy() const {
+    return transaction_id_length_ == kStunLegacyTransactionIdLength;
+  }
+  const char* transaction_id_data() const { return transaction_id_; }
+  size_t transaction_id_length() const { return transaction_id_length_; }
+  std::string transaction_id() const {
+    return std::string(transaction_id_, transaction_id_length_);
+  }
+
+  // Parses the STUN packet in the given buffer, with the same framing checks
+  // as StunMessage::Read(), and consumes it. The return value indicates
+  // whether this was successful.
+  bool Read(rtc::ByteBufferReader* buf);
+
+  bool HasAttribute(int type) const { return FindAttribute(type) != NULL; }
+
+  // Decode the value of the first attribute of the given type. Return false
+  // if there is no such attribute or its value is malformed.
+  bool GetByteString(int type, const char** bytes, size_t* length) const;
+  bool GetUInt32(int type, uint32_t* value) const;
+  bool GetUInt64(int type, uint64_t* value) const;
+  bool GetAddress(int type, rtc::SocketAddress* addr) const;
+  bool GetXorAddress(int type, rtc::SocketAddress* addr) const;
+  bool GetErrorCode(int* code) const;
+
+ private:
+  struct Attribute {
+    uint16_t type;
+    uint16_t length;
+    // Offset of the value from the start of the message.
+    uint32_t offset;
+  };
+
+  const Attribute* FindAttribute(int type) const;
+  bool GetAddress(int type, bool xor_address, rtc::SocketAddress* addr) const;
+
+  const char* data_;
+  uint16_t type_;
+  uint16_t length_;
+  const char* transaction_id_;
+  size_t transaction_id_length_;
+  size_t num_attributes_;
+  Attribute attributes_[kMaxAttributes];
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(StunMessageView);
+};
+
+// Serializes a STUN message directly into a caller-provided buffer, without
+// building StunAttribute objects. Attributes are written in the order they are
+// added. Since MESSAGE-INTEGRITY and FINGERPRINT cover everything before them,
+// AddMessageIntegrity() and AddFingerprint() should be called last. The Add*
+// methods return false, and leave the buffer unchanged, if the attribute does
+// not fit.
+class StunMessageWriter {
+ public:
+  StunMessageWriter(char* buffer, size_t capacity);
+
+  const char* Data() const { return buffer_; }
+  size_t Length() const { return length_; }
+
+  // Writes the message header, discarding anything written before.
+  // |transaction_id_length| must be kStunTransactionIdLength, or
+  // kStunLegacyTransactionIdLength for an RFC3489 message.
+  bool Start(int type,
+             const char* transaction_id,
+             size_t transaction_id_length);
+
+  bool AddByteString(int type, const char* bytes, size_t length);
+  bool AddUInt32(int type, uint32_t value);
+  bool AddUInt64(int type, uint64_t value);
+  bool AddAddress(int type, const rtc::SocketAddress& addr);
+  // The address is XORed with the message's transaction ID, which has to be
+  // an RFC5389 one for IPv6 addresses.
+  bool AddXorAddress(int type, const rtc::SocketAddress& addr);
+  bool AddErrorCode(int code, const std::string& reason);
+  bool AddMessageIntegrity(const std::string& password);
+  bool AddFingerprint();
+
+ private:
+  // Appends an attribute header and padding for a value of |length| bytes,
+  // and returns where the value goes, or NULL if it does not fit.
+  char* AddAttribute(int type, size_t length);
+  bool AddAddress(int type, const rtc::SocketAddress& addr, bool xor_address);
+
+  char* const buffer_;
+  const size_t capacity_;
+  size_t length_;
+  bool legacy_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(StunMessageWriter);
+};
+
 // Base class for all STUN/TURN attributes.
 class StunAttribute {
  public:
@@ -1332,6 +1332,249 @@ TEST_F(StunTest, AddFingerprint) {
       reinterpret_cast<const char*>(buf1.Data()), buf1.Length()));
 }
 
+// Read the RFC5769 sample messages in place.
+TEST_F(StunTest, ReadRfc5769MessagesWithView) {
+  StunMessageView request;
+  rtc::ByteBufferReader buf(
+      reinterpret_cast<const char*>(kRfc5769SampleRequest),
+      sizeof(kRfc5769SampleRequest));
+  ASSERT_TRUE(request.Read(&buf));
+  EXPECT_EQ(0u, buf.Length());
+  EXPECT_EQ(STUN_BINDING_REQUEST, request.type());
+  EXPECT_EQ(sizeof(kRfc5769SampleRequest) - kStunHeaderSize,
+            request.length());
+  EXPECT_FALSE(request.IsLegacy());
+  ASSERT_EQ(kStunTransactionIdLength, request.transaction_id_length());
+  EXPECT_EQ(0, memcmp(request.transaction_id_data(),
+                      kRfc5769SampleMsgTransactionId,
+                      kStunTransactionIdLength));
+
+  const char* bytes;
+  size_t length;
+  ASSERT_TRUE(request.GetByteString(STUN_ATTR_USERNAME, &bytes, &length));
+  EXPECT_EQ(kRfc5769SampleMsgUsername, std::string(bytes, length));
+  ASSERT_TRUE(request.GetByteString(STUN_ATTR_SOFTWARE, &bytes, &length));
+  EXPECT_EQ(kRfc5769SampleMsgClientSoftware, std::string(bytes, length));
+  EXPECT_TRUE(request.HasAttribute(STUN_ATTR_MESSAGE_INTEGRITY));
+  uint32_t fingerprint;
+  ASSERT_TRUE(request.GetUInt32(STUN_ATTR_FINGERPRINT, &fingerprint));
+  EXPECT_EQ(0xe57a3bcf, fingerprint);
+  EXPECT_FALSE(request.HasAttribute(STUN_ATTR_XOR_MAPPED_ADDRESS));
+
+  StunMessageView response;
+  rtc::ByteBufferReader buf2(
+      reinterpret_cast<const char*>(kRfc5769SampleResponse),
+      sizeof(kRfc5769SampleResponse));
+  ASSERT_TRUE(response.Read(&buf2));
+  EXPECT_EQ(STUN_BINDING_RESPONSE, response.type());
+  rtc::SocketAddress addr;
+  ASSERT_TRUE(response.GetXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, &addr));
+  EXPECT_EQ(kRfc5769SampleMsgMappedAddress, addr);
+
+  StunMessageView response_ipv6;
+  rtc::ByteBufferReader buf3(
+      reinterpret_cast<const char*>(kRfc5769SampleResponseIPv6),
+      sizeof(kRfc5769SampleResponseIPv6));
+  ASSERT_TRUE(response_ipv6.Read(&buf3));
+  ASSERT_TRUE(
+      response_ipv6.GetXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, &addr));
+  EXPECT_EQ(kRfc5769SampleMsgIPv6MappedAddress, addr);
+}
+
+TEST_F(StunTest, ReadMessageWithView) {
+  StunMessageView msg;
+  rtc::ByteBufferReader buf(
+      reinterpret_cast<const char*>(kStunMessageWithIPv4MappedAddress),
+      sizeof(kStunMessageWithIPv4MappedAddress));
+  ASSERT_TRUE(msg.Read(&buf));
+  rtc::SocketAddress addr;
+  ASSERT_TRUE(msg.GetAddress(STUN_ATTR_MAPPED_ADDRESS, &addr));
+  EXPECT_EQ(rtc::SocketAddress(rtc::IPAddress(kIPv4TestAddress1),
+                               kTestMessagePort4),
+            addr);
+  // The attribute is there, but it's the wrong size for a UInt32.
+  uint32_t value;
+  EXPECT_FALSE(msg.GetUInt32(STUN_ATTR_MAPPED_ADDRESS, &value));
+
+  StunMessageView xor_msg;
+  rtc::ByteBufferReader buf2(
+      reinterpret_cast<const char*>(kStunMessageWithIPv6XorMappedAddress),
+      sizeof(kStunMessageWithIPv6XorMappedAddress));
+  ASSERT_TRUE(xor_msg.Read(&buf2));
+  ASSERT_TRUE(xor_msg.GetXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, &addr));
+  EXPECT_EQ(rtc::SocketAddress(rtc::IPAddress(kIPv6TestAddress1),
+                               kTestMessagePort1),
+            addr);
+
+  StunMessageView error_msg;
+  rtc::ByteBufferReader buf3(
+      reinterpret_cast<const char*>(kStunMessageWithErrorAttribute),
+      sizeof(kStunMessageWithErrorAttribute));
+  ASSERT_TRUE(error_msg.Read(&buf3));
+  int code;
+  ASSERT_TRUE(error_msg.GetErrorCode(&code));
+  EXPECT_EQ(kTestErrorCode, code);
+}
+
+TEST_F(StunTest, ReadLegacyMessageWithView) {
+  unsigned char rfc3489_packet[sizeof(kStunMessageWithIPv4MappedAddress)];
+  memcpy(rfc3489_packet, kStunMessageWithIPv4MappedAddress,
+      sizeof(kStunMessageWithIPv4MappedAddress));
+  memcpy(&rfc3489_packet[4], "ABCD", 4);
+
+  StunMessageView msg;
+  rtc::ByteBufferReader buf(reinterpret_cast<const char*>(rfc3489_packet),
+                            sizeof(rfc3489_packet));
+  ASSERT_TRUE(msg.Read(&buf));
+  EXPECT_TRUE(msg.IsLegacy());
+  ASSERT_EQ(kStunLegacyTransactionIdLength, msg.transaction_id_length());
+  EXPECT_EQ(0, memcmp(msg.transaction_id_data(), &rfc3489_packet[4],
+                      kStunLegacyTransactionIdLength));
+}
+
+TEST_F(StunTest, FailToReadInvalidMessagesWithView) {
+  const unsigned char* testcases[] = {
+    kStunMessageWithZeroLength, kStunMessageWithSmallLength,
+    kStunMessageWithExcessLength,
+  };
+  for (const unsigned char* testcase : testcases) {
+    StunMessageView msg;
+    rtc::ByteBufferReader buf(reinterpret_cast<const char*>(testcase),
+                              kRealLengthOfInvalidLengthTestCases);
+    EXPECT_FALSE(msg.Read(&buf));
+  }
+
+  StunMessageView rtcp;
+  rtc::ByteBufferReader buf(reinterpret_cast<const char*>(kRtcpPacket),
+                            sizeof(kRtcpPacket));
+  EXPECT_FALSE(rtcp.Read(&buf));
+}
+
+TEST_F(StunTest, FailToReadMessageWithTooManyAttributesWithView) {
+  char data[kStunHeaderSize +
+            (StunMessageView::kMaxAttributes + 1) * kStunAttributeHeaderSize];
+  StunMessageWriter writer(data, sizeof(data));
+  ASSERT_TRUE(writer.Start(STUN_BINDING_REQUEST,
+                           reinterpret_cast<const char*>(kTestTransactionId1),
+                           kStunTransactionIdLength));
+  for (size_t i = 0; i < StunMessageView::kMaxAttributes; ++i)
+    ASSERT_TRUE(writer.AddByteString(STUN_ATTR_SOFTWARE, NULL, 0));
+
+  StunMessageView msg;
+  rtc::ByteBufferReader buf(writer.Data(), writer.Length());
+  EXPECT_TRUE(msg.Read(&buf));
+
+  ASSERT_TRUE(writer.AddByteString(STUN_ATTR_SOFTWARE, NULL, 0));
+  rtc::ByteBufferReader buf2(writer.Data(), writer.Length());
+  EXPECT_FALSE(msg.Read(&buf2));
+}
+
+// Test that StunMessageWriter produces the same bytes as StunMessage::Write().
+TEST_F(StunTest, MessageWriterMatchesStunMessage) {
+  std::string transaction_id(reinterpret_cast<const char*>(kTestTransactionId1),
+                             kStunTransactionIdLength);
+  rtc::SocketAddress v4_addr(rtc::IPAddress(kIPv4TestAddress1),
+                             kTestMessagePort1);
+  rtc::SocketAddress v6_addr(rtc::IPAddress(kIPv6TestAddress1),
+                             kTestMessagePort2);
+
+  StunMessage msg;
+  msg.SetType(STUN_BINDING_ERROR_RESPONSE);
+  msg.SetTransactionID(transaction_id);
+  msg.AddAttribute(new StunByteStringAttribute(STUN_ATTR_USERNAME,
+                                               kTestUserName2));
+  msg.AddAttribute(new StunUInt32Attribute(STUN_ATTR_RETRANSMIT_COUNT, 3));
+  msg.AddAttribute(new StunAddressAttribute(STUN_ATTR_MAPPED_ADDRESS,
+                                            v6_addr));
+  msg.AddAttribute(new StunXorAddressAttribute(STUN_ATTR_XOR_MAPPED_ADDRESS,
+                                               v4_addr));
+  msg.AddAttribute(new StunXorAddressAttribute(STUN_ATTR_XOR_MAPPED_ADDRESS,
+                                               v6_addr));
+  StunErrorCodeAttribute* error_code = StunAttribute::CreateErrorCode();
+  error_code->SetCode(kTestErrorCode);
+  error_code->SetReason(kTestErrorReason);
+  msg.AddAttribute(error_code);
+  EXPECT_TRUE(msg.AddMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_TRUE(msg.AddFingerprint());
+  rtc::ByteBufferWriter expected;
+  ASSERT_TRUE(msg.Write(&expected));
+
+  char data[256];
+  StunMessageWriter writer(data, sizeof(data));
+  ASSERT_TRUE(writer.Start(STUN_BINDING_ERROR_RESPONSE, transaction_id.data(),
+                           transaction_id.size()));
+  EXPECT_TRUE(writer.AddByteString(STUN_ATTR_USERNAME, kTestUserName2,
+                                   strlen(kTestUserName2)));
+  EXPECT_TRUE(writer.AddUInt32(STUN_ATTR_RETRANSMIT_COUNT, 3));
+  EXPECT_TRUE(writer.AddAddress(STUN_ATTR_MAPPED_ADDRESS, v6_addr));
+  EXPECT_TRUE(writer.AddXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, v4_addr));
+  EXPECT_TRUE(writer.AddXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, v6_addr));
+  EXPECT_TRUE(writer.AddErrorCode(kTestErrorCode, kTestErrorReason));
+  EXPECT_TRUE(writer.AddMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_TRUE(writer.AddFingerprint());
+
+  ASSERT_EQ(expected.Length(), writer.Length());
+  EXPECT_EQ(0, memcmp(expected.Data(), writer.Data(), writer.Length()));
+  EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(
+      writer.Data(), writer.Length(), kRfc5769SampleMsgPassword));
+  EXPECT_TRUE(StunMessage::ValidateFingerprint(writer.Data(),
+                                               writer.Length()));
+
+  // And reads back.
+  StunMessageView view;
+  rtc::ByteBufferReader buf(writer.Data(), writer.Length());
+  ASSERT_TRUE(view.Read(&buf));
+  rtc::SocketAddress addr;
+  ASSERT_TRUE(view.GetXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, &addr));
+  EXPECT_EQ(v4_addr, addr);
+  ASSERT_TRUE(view.GetAddress(STUN_ATTR_MAPPED_ADDRESS, &addr));
+  EXPECT_EQ(v6_addr, addr);
+}
+
+TEST_F(StunTest, MessageWriterWritesLegacyMessages) {
+  const char transaction_id[] = "0123456789abcdef";
+  rtc::SocketAddress v6_addr(rtc::IPAddress(kIPv6TestAddress1),
+                             kTestMessagePort2);
+  char data[128];
+  StunMessageWriter writer(data, sizeof(data));
+  ASSERT_TRUE(writer.Start(STUN_BINDING_RESPONSE, transaction_id,
+                           kStunLegacyTransactionIdLength));
+  // IPv6 addresses can't be XOR-ed with a legacy transaction ID.
+  EXPECT_FALSE(writer.AddXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, v6_addr));
+  EXPECT_TRUE(writer.AddAddress(STUN_ATTR_MAPPED_ADDRESS, v6_addr));
+
+  StunMessage msg;
+  rtc::ByteBufferReader buf(writer.Data(), writer.Length());
+  ASSERT_TRUE(msg.Read(&buf));
+  EXPECT_TRUE(msg.IsLegacy());
+  EXPECT_EQ(transaction_id, msg.transaction_id());
+  ASSERT_TRUE(msg.GetAddress(STUN_ATTR_MAPPED_ADDRESS) != NULL);
+  EXPECT_EQ(v6_addr, msg.GetAddress(STUN_ATTR_MAPPED_ADDRESS)->GetAddress());
+}
+
+TEST_F(StunTest, MessageWriterFailsWhenFull) {
+  char data[kStunHeaderSize + 8];
+  StunMessageWriter writer(data, sizeof(data));
+  EXPECT_FALSE(writer.Start(STUN_BINDING_REQUEST, "0123", 4));
+  EXPECT_EQ(0u, writer.Length());
+  ASSERT_TRUE(writer.Start(STUN_BINDING_REQUEST,
+                           reinterpret_cast<const char*>(kTestTransactionId1),
+                           kStunTransactionIdLength));
+
+  // Needs 4 bytes of padding, which don't fit.
+  EXPECT_FALSE(writer.AddByteString(STUN_ATTR_USERNAME, kTestUserName1, 5));
+  EXPECT_EQ(kStunHeaderSize, writer.Length());
+  EXPECT_TRUE(writer.AddByteString(STUN_ATTR_USERNAME, kTestUserName1, 4));
+  EXPECT_FALSE(writer.AddFingerprint());
+  EXPECT_FALSE(writer.AddMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_EQ(sizeof(data), writer.Length());
+
+  StunMessage msg;
+  rtc::ByteBufferReader buf(writer.Data(), writer.Length());
+  ASSERT_TRUE(msg.Read(&buf));
+  EXPECT_EQ(8u, msg.length());
+}
+
 // Sample "GTURN" relay message.
 static const unsigned char kRelayMessage[] = {
   0x00, 0x01, 0x00, 88,    // message header
@@ -13,6 +13,7 @@
 #include "webrtc/p2p/base/common.h"
 #include "webrtc/p2p/base/portallocator.h"
 #include "webrtc/p2p/base/stun.h"
+#include "webrtc/p2p/base/udpsocketmux.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/helpers.h"
@@ -231,6 +232,8 @@ bool UDPPort::Init() {
 }
 
 UDPPort::~UDPPort() {
+  if (socket_mux_)
+    socket_mux_->RemovePort(this);
   if (!SharedSocket())
     delete socket_;
 }
@@ -282,6 +285,8 @@ int UDPPort::SendTo(const void* data, size_t size,
     error_ = socket_->GetError();
     LOG_J(LS_ERROR, this) << "UDP send of " << size
                           << " bytes failed with error " << error_;
+  } else if (socket_mux_) {
+    socket_mux_->OnPacketSent(this, data, size, addr, true);
   }
   return sent;
 }
@@ -500,8 +505,11 @@ void UDPPort::MaybeSetPortCompleteOrError() {
 void UDPPort::OnSendPacket(const void* data, size_t size, StunRequest* req) {
   StunBindingRequest* sreq = static_cast<StunBindingRequest*>(req);
   rtc::PacketOptions options(DefaultDscpValue());
-  if (socket_->SendTo(data, size, sreq->server_addr(), options) < 0)
+  if (socket_->SendTo(data, size, sreq->server_addr(), options) < 0) {
     PLOG(LERROR, socket_->GetError()) << "sendto";
+  } else if (socket_mux_) {
+    socket_mux_->OnPacketSent(this, data, size, sreq->server_addr(), false);
+  }
 }
 
 bool UDPPort::HasCandidateWithAddress(const rtc::SocketAddress& addr) const {
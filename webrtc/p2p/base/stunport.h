@@ -26,6 +26,8 @@ class SignalThread;
 
 namespace cricket {
 
+class UDPSocketMux;
+
 // Lifetime chosen for STUN ports on low-cost networks.
 static const int INFINITE_LIFETIME = -1;
 // Lifetime for STUN ports on high-cost networks: 2 minutes
@@ -123,6 +125,10 @@ class UDPPort : public Port {
     return requests_.HasRequest(msg_type);
   }
 
+  rtc::AsyncPacketSocket* socket() const { return socket_; }
+  // Set by UDPSocketMux::AddPort() for a port on one of its sockets.
+  void set_socket_mux(UDPSocketMux* mux) { socket_mux_ = mux; }
+
  protected:
   UDPPort(rtc::Thread* thread,
           rtc::PacketSocketFactory* factory,
@@ -241,6 +247,7 @@ class UDPPort : public Port {
   ServerAddresses bind_request_failed_servers_;
   StunRequestManager requests_;
   rtc::AsyncPacketSocket* socket_;
+  UDPSocketMux* socket_mux_ = nullptr;
   int error_;
   std::unique_ptr<AddressResolver> resolver_;
   bool ready_;
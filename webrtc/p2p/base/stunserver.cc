@@ -15,6 +15,8 @@
 
 namespace cricket {
 
+const size_t StunServer::kMaxResponseSize;
+
 StunServer::StunServer(rtc::AsyncUDPSocket* socket) : socket_(socket) {
   socket_->SignalReadPacket.connect(this, &StunServer::OnPacket);
 }
@@ -27,9 +29,9 @@ void StunServer::OnPacket(
     rtc::AsyncPacketSocket* socket, const char* buf, size_t size,
     const rtc::SocketAddress& remote_addr,
     const rtc::PacketTime& packet_time) {
-  // Parse the STUN message; eat any messages that fail to parse.
+  // Parse the STUN message in place; eat any messages that fail to parse.
   rtc::ByteBufferReader bbuf(buf, size);
-  StunMessage msg;
+  StunMessageView msg;
   if (!msg.Read(&bbuf)) {
     return;
   }
@@ -40,7 +42,7 @@ void StunServer::OnPacket(
   // Send the message to the appropriate handler function.
   switch (msg.type()) {
     case STUN_BINDING_REQUEST:
-      OnBindingRequest(&msg, remote_addr);
+      OnBindingRequest(msg, remote_addr);
       break;
 
     default:
@@ -49,51 +51,43 @@ void StunServer::OnPacket(
 }
 
 void StunServer::OnBindingRequest(
-    StunMessage* msg, const rtc::SocketAddress& remote_addr) {
-  StunMessage response;
+    const StunMessageView& msg, const rtc::SocketAddress& remote_addr) {
+  char buf[kMaxResponseSize];
+  StunMessageWriter response(buf, sizeof(buf));
   GetStunBindReqponse(msg, remote_addr, &response);
   SendResponse(response, remote_addr);
 }
 
 void StunServer::SendErrorResponse(
-    const StunMessage& msg, const rtc::SocketAddress& addr,
+    const StunMessageView& msg, const rtc::SocketAddress& addr,
     int error_code, const char* error_desc) {
-  StunMessage err_msg;
-  err_msg.SetType(GetStunErrorResponseType(msg.type()));
-  err_msg.SetTransactionID(msg.transaction_id());
-
-  StunErrorCodeAttribute* err_code = StunAttribute::CreateErrorCode();
-  err_code->SetCode(error_code);
-  err_code->SetReason(error_desc);
-  err_msg.AddAttribute(err_code);
-
+  char buf[kMaxResponseSize];
+  StunMessageWriter err_msg(buf, sizeof(buf));
+  err_msg.Start(GetStunErrorResponseType(msg.type()),
+                msg.transaction_id_data(), msg.transaction_id_length());
+  err_msg.AddErrorCode(error_code, error_desc);
   SendResponse(err_msg, addr);
 }
 
 void StunServer::SendResponse(
-    const StunMessage& msg, const rtc::SocketAddress& addr) {
-  rtc::ByteBufferWriter buf;
-  msg.Write(&buf);
+    const StunMessageWriter& msg, const rtc::SocketAddress& addr) {
   rtc::PacketOptions options;
-  if (socket_->SendTo(buf.Data(), buf.Length(), addr, options) < 0)
+  if (socket_->SendTo(msg.Data(), msg.Length(), addr, options) < 0)
     LOG_ERR(LS_ERROR) << "sendto";
 }
 
-void StunServer::GetStunBindReqponse(StunMessage* request,
+void StunServer::GetStunBindReqponse(const StunMessageView& request,
                                      const rtc::SocketAddress& remote_addr,
-                                     StunMessage* response) const {
-  response->SetType(STUN_BINDING_RESPONSE);
-  response->SetTransactionID(request->transaction_id());
+                                     StunMessageWriter* response) const {
+  response->Start(STUN_BINDING_RESPONSE, request.transaction_id_data(),
+                  request.transaction_id_length());
 
   // Tell the user the address that we received their request from.
-  StunAddressAttribute* mapped_addr;
-  if (!request->IsLegacy()) {
-    mapped_addr = StunAttribute::CreateAddress(STUN_ATTR_MAPPED_ADDRESS);
+  if (!request.IsLegacy()) {
+    response->AddAddress(STUN_ATTR_MAPPED_ADDRESS, remote_addr);
   } else {
-    mapped_addr = StunAttribute::CreateXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+    response->AddXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, remote_addr);
   }
-  mapped_addr->SetAddress(remote_addr);
-  response->AddAttribute(mapped_addr);
 }
 
 }  // namespace cricket
@@ -34,8 +34,11 @@ class StunServer : public sigslot::has_slots<> {
       const rtc::SocketAddress& remote_addr,
       const rtc::PacketTime& packet_time);
 
+  // Large enough for any response the server sends.
+  static const size_t kMaxResponseSize = 128;
+
   // Handlers for the different types of STUN/TURN requests:
-  virtual void OnBindingRequest(StunMessage* msg,
+  virtual void OnBindingRequest(const StunMessageView& msg,
       const rtc::SocketAddress& addr);
   void OnAllocateRequest(StunMessage* msg,
       const rtc::SocketAddress& addr);
@@ -46,17 +49,17 @@ class StunServer : public sigslot::has_slots<> {
 
   // Sends an error response to the given message back to the user.
   void SendErrorResponse(
-      const StunMessage& msg, const rtc::SocketAddress& addr,
+      const StunMessageView& msg, const rtc::SocketAddress& addr,
       int error_code, const char* error_desc);
 
   // Sends the given message to the appropriate destination.
-  void SendResponse(const StunMessage& msg,
+  void SendResponse(const StunMessageWriter& msg,
        const rtc::SocketAddress& addr);
 
   // A helper method to compose a STUN binding response.
-  void GetStunBindReqponse(StunMessage* request,
+  void GetStunBindReqponse(const StunMessageView& request,
                            const rtc::SocketAddress& remote_addr,
-                           StunMessage* response) const;
+                           StunMessageWriter* response) const;
 
  private:
   std::unique_ptr<rtc::AsyncUDPSocket> socket_;
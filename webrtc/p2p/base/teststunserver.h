@@ -38,12 +38,13 @@ class TestStunServer : StunServer {
  private:
   explicit TestStunServer(rtc::AsyncUDPSocket* socket) : StunServer(socket) {}
 
-  void OnBindingRequest(StunMessage* msg,
+  void OnBindingRequest(const StunMessageView& msg,
                         const rtc::SocketAddress& remote_addr) override {
     if (fake_stun_addr_.IsNil()) {
       StunServer::OnBindingRequest(msg, remote_addr);
     } else {
-      StunMessage response;
+      char buf[kMaxResponseSize];
+      StunMessageWriter response(buf, sizeof(buf));
       GetStunBindReqponse(msg, fake_stun_addr_, &response);
       SendResponse(response, remote_addr);
     }
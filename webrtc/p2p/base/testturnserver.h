@@ -92,6 +92,15 @@ class TestTurnServer : public TurnAuthInterface {
     }
   }
 
+  // Adds a UDP socket that reads up to |max_packets| packets at once.
+  void AddBatchingInternalSocket(const rtc::SocketAddress& int_addr,
+                                 size_t max_packets) {
+    rtc::AsyncUDPSocket* socket =
+        rtc::AsyncUDPSocket::Create(thread_->socketserver(), int_addr);
+    socket->SetMaxReadBatchSize(max_packets);
+    server_.AddInternalSocket(socket, cricket::PROTO_UDP);
+  }
+
   // Finds the first allocation in the server allocation map with a source
   // ip and port matching the socket address provided.
   TurnServerAllocation* FindAllocation(const rtc::SocketAddress& src) {
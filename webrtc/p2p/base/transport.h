@@ -43,6 +43,7 @@
 
 namespace cricket {
 
+class PingScheduler;
 class PortAllocator;
 class TransportChannel;
 class TransportChannelImpl;
@@ -212,6 +213,10 @@ struct IceConfig {
   // Default nomination mode if the remote does not support renomination.
   NominationMode default_nomination_mode = NominationMode::SEMI_AGGRESSIVE;
 
+  // If set, the channels sharing it keep their pings within its budget. Not
+  // owned; must outlive the channels.
+  PingScheduler* ping_scheduler = nullptr;
+
   IceConfig() {}
   IceConfig(int receiving_timeout_ms,
             int backup_connection_ping_interval,
@@ -558,6 +558,16 @@ class TurnPortTest : public testing::Test,
       EXPECT_EQ(i + 1, udp_packets_[i].size());
       EXPECT_EQ(turn_packets_[i], udp_packets_[i]);
     }
+
+    // The allocation counted the data along with the pings.
+    TurnServerAllocation* allocation =
+        turn_server_.FindAllocation(turn_port_->GetLocalAddress());
+    ASSERT_TRUE(allocation != NULL);
+    const size_t data_bytes = num_packets * (num_packets + 1) / 2;
+    EXPECT_GT(allocation->stats().packets_sent, num_packets);
+    EXPECT_GT(allocation->stats().bytes_sent, data_bytes);
+    EXPECT_GT(allocation->stats().packets_received, num_packets);
+    EXPECT_GT(allocation->stats().bytes_received, data_bytes);
   }
 
  protected:
@@ -1040,6 +1050,15 @@ TEST_F(TurnPortTest, TestTurnSendDataTurnUdpToUdp) {
   EXPECT_EQ(UDP_PROTOCOL_NAME, turn_port_->Candidates()[0].relay_protocol());
 }
 
+// Same as above, with the server relaying the ChannelData of each batch of
+// packets it reads with a single send.
+TEST_F(TurnPortTest, TestTurnSendDataTurnUdpToUdpWithBatchedReads) {
+  turn_server_.AddBatchingInternalSocket(kTurnIntAddr, 8);
+  CreateTurnPort(kTurnUsername, kTurnPassword,
+                 cricket::ProtocolAddress(kTurnIntAddr, cricket::PROTO_UDP));
+  TestTurnSendData(PROTO_UDP);
+}
+
 // Do a TURN allocation, establish a TCP connection, and send some data.
 TEST_F(TurnPortTest, TestTurnSendDataTurnTcpToUdp) {
   turn_server_.AddInternalSocket(kTurnTcpIntAddr, PROTO_TCP);
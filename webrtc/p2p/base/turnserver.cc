@@ -10,6 +10,7 @@
 
 #include "webrtc/p2p/base/turnserver.h"
 
+#include <algorithm>
 #include <tuple>  // for std::tie
 
 #include "webrtc/p2p/base/asyncstuntcpsocket.h"
@@ -145,6 +146,8 @@ void TurnServer::AddInternalSocket(rtc::AsyncPacketSocket* socket,
   ASSERT(server_sockets_.end() == server_sockets_.find(socket));
   server_sockets_[socket] = proto;
   socket->SignalReadPacket.connect(this, &TurnServer::OnInternalPacket);
+  socket->SignalReadBatchDone.connect(this,
+                                      &TurnServer::OnInternalReadBatchDone);
 }
 
 void TurnServer::AddInternalServerSocket(rtc::AsyncSocket* socket,
@@ -205,12 +208,27 @@ void TurnServer::OnInternalPacket(rtc::AsyncPacketSocket* socket,
   } else {
     // This is a channel message; let the allocation handle it.
     TurnServerAllocation* allocation = FindAllocation(&conn);
-    if (allocation) {
+    if (!allocation) {
+      return;
+    }
+    if (socket->BatchesReads()) {
+      // Sent on together once the whole batch has been read.
+      if (allocation->QueueChannelData(data, size)) {
+        allocations_to_flush_.push_back(allocation);
+      }
+    } else {
       allocation->HandleChannelData(data, size);
     }
   }
 }
 
+void TurnServer::OnInternalReadBatchDone(rtc::AsyncPacketSocket* socket) {
+  for (TurnServerAllocation* allocation : allocations_to_flush_) {
+    allocation->SendQueuedChannelData();
+  }
+  allocations_to_flush_.clear();
+}
+
 void TurnServer::HandleStunMessage(TurnServerConnection* conn, const char* data,
                                    size_t size) {
   TurnMessage msg;
@@ -520,6 +538,10 @@ void TurnServer::OnAllocationDestroyed(TurnServerAllocation* allocation) {
     it->second.release();
     allocations_.erase(it);
   }
+  allocations_to_flush_.erase(
+      std::remove(allocations_to_flush_.begin(), allocations_to_flush_.end(),
+                  allocation),
+      allocations_to_flush_.end());
 }
 
 void TurnServer::DestroyInternalSocket(rtc::AsyncPacketSocket* socket) {
@@ -582,13 +604,13 @@ TurnServerAllocation::TurnServerAllocation(TurnServer* server,
 }
 
 TurnServerAllocation::~TurnServerAllocation() {
-  for (ChannelList::iterator it = channels_.begin();
+  for (ChannelIdMap::iterator it = channels_.begin();
        it != channels_.end(); ++it) {
-    delete *it;
+    delete it->second;
   }
-  for (PermissionList::iterator it = perms_.begin();
+  for (PermissionMap::iterator it = perms_.begin();
        it != perms_.end(); ++it) {
-    delete *it;
+    delete it->second;
   }
   thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
   LOG_J(LS_INFO, this) << "Allocation destroyed";
@@ -697,6 +719,8 @@ void TurnServerAllocation::HandleSendIndication(const TurnMessage* msg) {
 
   // If a permission exists, send the data on to the peer.
   if (HasPermission(peer_attr->GetAddress().ipaddr())) {
+    ++stats_.packets_sent;
+    stats_.bytes_sent += data_attr->length();
     SendExternal(data_attr->bytes(), data_attr->length(),
                  peer_attr->GetAddress());
   } else {
@@ -765,7 +789,8 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
     channel1 = new Channel(thread_, channel_id, peer_attr->GetAddress());
     channel1->SignalDestroyed.connect(this,
         &TurnServerAllocation::OnChannelDestroyed);
-    channels_.push_back(channel1);
+    channels_[channel_id] = channel1;
+    channels_by_peer_[channel1->peer()] = channel1;
   } else {
     channel1->Refresh();
   }
@@ -783,17 +808,62 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
 }
 
 void TurnServerAllocation::HandleChannelData(const char* data, size_t size) {
-  // Extract the channel number from the data.
-  uint16_t channel_id = rtc::GetBE16(data);
-  Channel* channel = FindChannel(channel_id);
+  const char* payload;
+  size_t payload_size;
+  Channel* channel = ParseChannelData(data, size, &payload, &payload_size);
   if (channel) {
     // Send the data to the peer address.
-    SendExternal(data + TURN_CHANNEL_HEADER_SIZE,
-                 size - TURN_CHANNEL_HEADER_SIZE, channel->peer());
-  } else {
+    ++stats_.packets_sent;
+    stats_.bytes_sent += payload_size;
+    SendExternal(payload, payload_size, channel->peer());
+  }
+}
+
+bool TurnServerAllocation::QueueChannelData(const char* data, size_t size) {
+  const char* payload;
+  size_t payload_size;
+  Channel* channel = ParseChannelData(data, size, &payload, &payload_size);
+  if (!channel) {
+    return false;
+  }
+  ++stats_.packets_sent;
+  stats_.bytes_sent += payload_size;
+  queued_channel_data_.push_back(rtc::BatchedPacket(
+      payload, payload_size, channel->peer(), &relay_options_));
+  return queued_channel_data_.size() == 1;
+}
+
+void TurnServerAllocation::SendQueuedChannelData() {
+  if (!queued_channel_data_.empty()) {
+    external_socket_->SendToBatch(queued_channel_data_.data(),
+                                  queued_channel_data_.size());
+    queued_channel_data_.clear();
+  }
+}
+
+TurnServerAllocation::Channel* TurnServerAllocation::ParseChannelData(
+    const char* data,
+    size_t size,
+    const char** payload,
+    size_t* payload_size) {
+  // Extract the channel number and length from the data. Over TCP, the
+  // message may be followed by padding.
+  uint16_t channel_id = rtc::GetBE16(data);
+  uint16_t length = rtc::GetBE16(data + 2);
+  if (TURN_CHANNEL_HEADER_SIZE + length > size) {
+    LOG_J(LS_WARNING, this) << "Received truncated channel data, id="
+                            << channel_id;
+    return NULL;
+  }
+  Channel* channel = FindChannel(channel_id);
+  if (!channel) {
     LOG_J(LS_WARNING, this) << "Received channel data for invalid channel, id="
                             << channel_id;
+    return NULL;
   }
+  *payload = data + TURN_CHANNEL_HEADER_SIZE;
+  *payload_size = length;
+  return channel;
 }
 
 void TurnServerAllocation::OnExternalPacket(
@@ -804,15 +874,21 @@ void TurnServerAllocation::OnExternalPacket(
   ASSERT(external_socket_.get() == socket);
   Channel* channel = FindChannel(addr);
   if (channel) {
-    // There is a channel bound to this address. Send as a channel message.
-    rtc::ByteBufferWriter buf;
-    buf.WriteUInt16(channel->id());
-    buf.WriteUInt16(static_cast<uint16_t>(size));
-    buf.WriteBytes(data, size);
-    server_->Send(&conn_, buf);
+    // There is a channel bound to this address. Send as a channel message,
+    // framed in a reused buffer rather than a new ByteBufferWriter.
+    ++stats_.packets_received;
+    stats_.bytes_received += size;
+    channel_data_.resize(TURN_CHANNEL_HEADER_SIZE + size);
+    rtc::SetBE16(&channel_data_[0], static_cast<uint16_t>(channel->id()));
+    rtc::SetBE16(&channel_data_[2], static_cast<uint16_t>(size));
+    memcpy(&channel_data_[TURN_CHANNEL_HEADER_SIZE], data, size);
+    conn_.socket()->SendTo(channel_data_.data(), channel_data_.size(),
+                           conn_.src(), relay_options_);
   } else if (!server_->enable_permission_checks_ ||
              HasPermission(addr.ipaddr())) {
     // No channel, but a permission exists. Send as a data indication.
+    ++stats_.packets_received;
+    stats_.bytes_received += size;
     TurnMessage msg;
     msg.SetType(TURN_DATA_INDICATION);
     msg.SetTransactionID(
@@ -848,7 +924,7 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
     perm = new Permission(thread_, addr);
     perm->SignalDestroyed.connect(
         this, &TurnServerAllocation::OnPermissionDestroyed);
-    perms_.push_back(perm);
+    perms_[addr] = perm;
   } else {
     perm->Refresh();
   }
@@ -856,32 +932,20 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
 
 TurnServerAllocation::Permission* TurnServerAllocation::FindPermission(
     const rtc::IPAddress& addr) const {
-  for (PermissionList::const_iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  PermissionMap::const_iterator it = perms_.find(addr);
+  return it != perms_.end() ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     int channel_id) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->id() == channel_id)
-      return *it;
-  }
-  return NULL;
+  ChannelIdMap::const_iterator it = channels_.find(channel_id);
+  return it != channels_.end() ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     const rtc::SocketAddress& addr) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  ChannelPeerMap::const_iterator it = channels_by_peer_.find(addr);
+  return it != channels_by_peer_.end() ? it->second : NULL;
 }
 
 void TurnServerAllocation::SendResponse(TurnMessage* msg) {
@@ -901,8 +965,7 @@ void TurnServerAllocation::SendErrorResponse(const TurnMessage* req, int code,
 
 void TurnServerAllocation::SendExternal(const void* data, size_t size,
                                   const rtc::SocketAddress& peer) {
-  rtc::PacketOptions options;
-  external_socket_->SendTo(data, size, peer, options);
+  external_socket_->SendTo(data, size, peer, relay_options_);
 }
 
 void TurnServerAllocation::OnMessage(rtc::Message* msg) {
@@ -912,16 +975,18 @@ void TurnServerAllocation::OnMessage(rtc::Message* msg) {
 }
 
 void TurnServerAllocation::OnPermissionDestroyed(Permission* perm) {
-  PermissionList::iterator it = std::find(perms_.begin(), perms_.end(), perm);
-  ASSERT(it != perms_.end());
+  PermissionMap::iterator it = perms_.find(perm->peer());
+  ASSERT(it != perms_.end() && it->second == perm);
   perms_.erase(it);
 }
 
 void TurnServerAllocation::OnChannelDestroyed(Channel* channel) {
-  ChannelList::iterator it =
-      std::find(channels_.begin(), channels_.end(), channel);
-  ASSERT(it != channels_.end());
+  ChannelIdMap::iterator it = channels_.find(channel->id());
+  ASSERT(it != channels_.end() && it->second == channel);
   channels_.erase(it);
+  ChannelPeerMap::iterator peer_it = channels_by_peer_.find(channel->peer());
+  ASSERT(peer_it != channels_by_peer_.end() && peer_it->second == channel);
+  channels_by_peer_.erase(peer_it);
 }
 
 TurnServerAllocation::Permission::Permission(rtc::Thread* thread,
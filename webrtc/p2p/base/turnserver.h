@@ -11,11 +11,11 @@
 #ifndef WEBRTC_P2P_BASE_TURNSERVER_H_
 #define WEBRTC_P2P_BASE_TURNSERVER_H_
 
-#include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "webrtc/p2p/base/portinterface.h"
@@ -68,6 +68,14 @@ class TurnServerConnection {
 class TurnServerAllocation : public rtc::MessageHandler,
                              public sigslot::has_slots<> {
  public:
+  // Counts the data relayed to and from peers, without the TURN framing.
+  struct Stats {
+    uint64_t packets_sent = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t packets_received = 0;
+    uint64_t bytes_received = 0;
+  };
+
   TurnServerAllocation(TurnServer* server_,
                        rtc::Thread* thread,
                        const TurnServerConnection& conn,
@@ -83,18 +91,40 @@ class TurnServerAllocation : public rtc::MessageHandler,
   const std::string& last_nonce() const { return last_nonce_; }
   void set_last_nonce(const std::string& nonce) { last_nonce_ = nonce; }
 
+  const Stats& stats() const { return stats_; }
+
   std::string ToString() const;
 
   void HandleTurnMessage(const TurnMessage* msg);
   void HandleChannelData(const char* data, size_t size);
+  // Like HandleChannelData, but only queues the payload for the next
+  // SendQueuedChannelData() call, so |data| must stay valid until then.
+  // Returns true if nothing was queued before.
+  bool QueueChannelData(const char* data, size_t size);
+  // Sends the queued payloads to their peers with a single SendToBatch call.
+  void SendQueuedChannelData();
 
   sigslot::signal1<TurnServerAllocation*> SignalDestroyed;
 
  private:
   class Channel;
   class Permission;
-  typedef std::list<Permission*> PermissionList;
-  typedef std::list<Channel*> ChannelList;
+  struct IPAddressHash {
+    size_t operator()(const rtc::IPAddress& ip) const {
+      return rtc::HashIP(ip);
+    }
+  };
+  struct SocketAddressHash {
+    size_t operator()(const rtc::SocketAddress& addr) const {
+      return addr.Hash();
+    }
+  };
+  // Looked up for every relayed packet, so hashed.
+  typedef std::unordered_map<rtc::IPAddress, Permission*, IPAddressHash>
+      PermissionMap;
+  typedef std::unordered_map<int, Channel*> ChannelIdMap;
+  typedef std::unordered_map<rtc::SocketAddress, Channel*, SocketAddressHash>
+      ChannelPeerMap;
 
   void HandleAllocateRequest(const TurnMessage* msg);
   void HandleRefreshRequest(const TurnMessage* msg);
@@ -113,6 +143,12 @@ class TurnServerAllocation : public rtc::MessageHandler,
   Permission* FindPermission(const rtc::IPAddress& addr) const;
   Channel* FindChannel(int channel_id) const;
   Channel* FindChannel(const rtc::SocketAddress& addr) const;
+  // Finds the channel a ChannelData message is for and its payload. Returns
+  // null if the message is invalid or the channel is not bound.
+  Channel* ParseChannelData(const char* data,
+                            size_t size,
+                            const char** payload,
+                            size_t* payload_size);
 
   void SendResponse(TurnMessage* msg);
   void SendBadRequestResponse(const TurnMessage* req);
@@ -134,8 +170,15 @@ class TurnServerAllocation : public rtc::MessageHandler,
   std::string username_;
   std::string origin_;
   std::string last_nonce_;
-  PermissionList perms_;
-  ChannelList channels_;
+  PermissionMap perms_;
+  ChannelIdMap channels_;
+  ChannelPeerMap channels_by_peer_;
+  Stats stats_;
+  // Payloads waiting for SendQueuedChannelData().
+  std::vector<rtc::BatchedPacket> queued_channel_data_;
+  // Reused to frame the ChannelData messages sent to the client.
+  std::vector<char> channel_data_;
+  const rtc::PacketOptions relay_options_;
 };
 
 // An interface through which the MD5 credential hash can be retrieved.
@@ -225,6 +268,8 @@ class TurnServer : public sigslot::has_slots<> {
   // Accept connections on this server socket.
   void AcceptConnection(rtc::AsyncSocket* server_socket);
   void OnInternalSocketClose(rtc::AsyncPacketSocket* socket, int err);
+  // Sends on the ChannelData queued while reading a batch of packets.
+  void OnInternalReadBatchDone(rtc::AsyncPacketSocket* socket);
 
   void HandleStunMessage(
       TurnServerConnection* conn, const char* data, size_t size);
@@ -289,6 +334,8 @@ class TurnServer : public sigslot::has_slots<> {
   rtc::SocketAddress external_addr_;
 
   AllocationMap allocations_;
+  // Allocations with ChannelData queued during the current read batch.
+  std::vector<TurnServerAllocation*> allocations_to_flush_;
 
   rtc::AsyncInvoker invoker_;
 
@@ -0,0 +1,240 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/p2p/base/udpsocketmux.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "webrtc/base/bytebuffer.h"
+#include "webrtc/base/byteorder.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/p2p/base/packetsocketfactory.h"
+#include "webrtc/p2p/base/stun.h"
+#include "webrtc/p2p/base/stunport.h"
+
+namespace cricket {
+
+namespace {
+
+// Transaction IDs of requests remembered at most, over all ports.
+const size_t kMaxTransactionIds = 10000;
+
+// Returns true if |data| starts with a STUN header carrying the RFC 5389
+// magic cookie, without looking any further.
+bool IsStunPacket(const char* data, size_t size) {
+  // The magic cookie follows the 16-bit type and length.
+  return size >= kStunHeaderSize && (data[0] & 0xc0) == 0 &&
+         rtc::GetBE32(data + 4) == kStunMagicCookie;
+}
+
+std::string GetTransactionId(const char* data) {
+  return std::string(data + kStunTransactionIdOffset,
+                     kStunTransactionIdLength);
+}
+
+}  // namespace
+
+UDPSocketMux::UDPSocketMux() {}
+
+UDPSocketMux::~UDPSocketMux() {
+  for (const auto& shared : sockets_) {
+    RTC_DCHECK(shared->ports.empty());
+  }
+}
+
+rtc::AsyncPacketSocket* UDPSocketMux::GetSocket(
+    rtc::PacketSocketFactory* factory,
+    const rtc::IPAddress& ip,
+    uint16_t min_port,
+    uint16_t max_port,
+    const std::string& ufrag) {
+  for (const auto& shared : sockets_) {
+    if (shared->ip == ip) {
+      if (FindPortByUfrag(shared.get(), ufrag)) {
+        return nullptr;
+      }
+      return shared->socket.get();
+    }
+  }
+
+  rtc::AsyncPacketSocket* socket =
+      factory->CreateUdpSocket(rtc::SocketAddress(ip, 0), min_port, max_port);
+  if (!socket) {
+    LOG(LS_WARNING) << "Failed to create a shared UDP socket on "
+                    << ip.ToSensitiveString();
+    return nullptr;
+  }
+  socket->SignalReadPacket.connect(this, &UDPSocketMux::OnReadPacket);
+  std::unique_ptr<SharedSocket> shared(new SharedSocket());
+  shared->ip = ip;
+  shared->socket.reset(socket);
+  sockets_.push_back(std::move(shared));
+  return socket;
+}
+
+void UDPSocketMux::AddPort(UDPPort* port) {
+  SharedSocket* shared = FindSocket(port->socket());
+  RTC_DCHECK(shared);
+  shared->ports.push_back(port);
+  shared->ports_by_ufrag[port->username_fragment()] = port;
+  port->set_socket_mux(this);
+}
+
+void UDPSocketMux::RemovePort(UDPPort* port) {
+  SharedSocket* shared = FindSocket(port->socket());
+  RTC_DCHECK(shared);
+  shared->ports.erase(
+      std::remove(shared->ports.begin(), shared->ports.end(), port),
+      shared->ports.end());
+  for (auto it = shared->ports_by_ufrag.begin();
+       it != shared->ports_by_ufrag.end();) {
+    it = it->second == port ? shared->ports_by_ufrag.erase(it) : ++it;
+  }
+  auto& by_address = shared->ports_by_remote_address;
+  for (auto it = by_address.begin(); it != by_address.end();) {
+    it = it->second == port ? by_address.erase(it) : ++it;
+  }
+  for (auto it = ports_by_transaction_id_.begin();
+       it != ports_by_transaction_id_.end();) {
+    it = it->second == port ? ports_by_transaction_id_.erase(it) : ++it;
+  }
+}
+
+void UDPSocketMux::OnPacketSent(UDPPort* port,
+                                const void* data,
+                                size_t size,
+                                const rtc::SocketAddress& remote_addr,
+                                bool is_connection) {
+  // Only STUN packets are looked at. They precede anything else sent on a
+  // connection, and media packets shouldn't pay for a lookup.
+  const char* bytes = static_cast<const char*>(data);
+  if (!IsStunPacket(bytes, size)) {
+    return;
+  }
+  if (IsStunRequestType(rtc::GetBE16(bytes))) {
+    std::string id = GetTransactionId(bytes);
+    // Retransmissions reuse the transaction ID.
+    if (ports_by_transaction_id_.insert(std::make_pair(id, port)).second) {
+      transaction_ids_.push_back(id);
+      if (transaction_ids_.size() > kMaxTransactionIds) {
+        ports_by_transaction_id_.erase(transaction_ids_.front());
+        transaction_ids_.pop_front();
+      }
+    }
+  }
+  if (is_connection) {
+    SharedSocket* shared = FindSocket(port->socket());
+    RTC_DCHECK(shared);
+    shared->ports_by_remote_address[remote_addr] = port;
+  }
+}
+
+UDPSocketMux::Stats UDPSocketMux::GetStats() const {
+  Stats stats = stats_;
+  stats.sockets = sockets_.size();
+  for (const auto& shared : sockets_) {
+    stats.ports += shared->ports.size();
+  }
+  return stats;
+}
+
+void UDPSocketMux::OnReadPacket(rtc::AsyncPacketSocket* socket,
+                                const char* data,
+                                size_t size,
+                                const rtc::SocketAddress& remote_addr,
+                                const rtc::PacketTime& packet_time) {
+  int64_t start = rtc::TimeNanos();
+  SharedSocket* shared = FindSocket(socket);
+  RTC_DCHECK(shared);
+  UDPPort* port = FindPort(shared, data, size, remote_addr);
+  stats_.total_demux_ns += rtc::TimeNanos() - start;
+  if (!port) {
+    ++stats_.packets_dropped;
+    LOG(LS_VERBOSE) << "Dropping packet from unknown address "
+                    << remote_addr.ToSensitiveString();
+    return;
+  }
+  port->HandleIncomingPacket(socket, data, size, remote_addr, packet_time);
+}
+
+UDPPort* UDPSocketMux::FindPort(SharedSocket* shared,
+                                const char* data,
+                                size_t size,
+                                const rtc::SocketAddress& remote_addr) {
+  if (IsStunPacket(data, size)) {
+    int type = rtc::GetBE16(data);
+    if (IsStunSuccessResponseType(type) || IsStunErrorResponseType(type)) {
+      auto it = ports_by_transaction_id_.find(GetTransactionId(data));
+      if (it != ports_by_transaction_id_.end()) {
+        UDPPort* port = it->second;
+        ports_by_transaction_id_.erase(it);
+        ++stats_.packets_by_transaction_id;
+        return port;
+      }
+    } else if (type == STUN_BINDING_REQUEST) {
+      StunMessageView view;
+      rtc::ByteBufferReader buf(data, size);
+      const char* username;
+      size_t length;
+      if (view.Read(&buf) &&
+          view.GetByteString(STUN_ATTR_USERNAME, &username, &length)) {
+        // The local ufrag comes first in requests sent to us.
+        std::string ufrag(username,
+                          std::find(username, username + length, ':'));
+        UDPPort* port = FindPortByUfrag(shared, ufrag);
+        if (port) {
+          shared->ports_by_remote_address[remote_addr] = port;
+          ++stats_.packets_by_ufrag;
+          return port;
+        }
+      }
+    }
+  }
+
+  auto it = shared->ports_by_remote_address.find(remote_addr);
+  if (it == shared->ports_by_remote_address.end()) {
+    return nullptr;
+  }
+  ++stats_.packets_by_remote_address;
+  return it->second;
+}
+
+UDPPort* UDPSocketMux::FindPortByUfrag(SharedSocket* shared,
+                                       const std::string& ufrag) {
+  auto it = shared->ports_by_ufrag.find(ufrag);
+  if (it != shared->ports_by_ufrag.end()) {
+    if (it->second->username_fragment() == ufrag) {
+      return it->second;
+    }
+    shared->ports_by_ufrag.erase(it);
+  }
+  for (UDPPort* port : shared->ports) {
+    if (port->username_fragment() == ufrag) {
+      shared->ports_by_ufrag[ufrag] = port;
+      return port;
+    }
+  }
+  return nullptr;
+}
+
+UDPSocketMux::SharedSocket* UDPSocketMux::FindSocket(
+    rtc::AsyncPacketSocket* socket) {
+  for (const auto& shared : sockets_) {
+    if (shared->socket.get() == socket) {
+      return shared.get();
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace cricket
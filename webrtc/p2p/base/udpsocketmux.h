@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_P2P_BASE_UDPSOCKETMUX_H_
+#define WEBRTC_P2P_BASE_UDPSOCKETMUX_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "webrtc/base/asyncpacketsocket.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/ipaddress.h"
+#include "webrtc/base/sigslot.h"
+#include "webrtc/base/socketaddress.h"
+
+namespace rtc {
+class PacketSocketFactory;
+}  // namespace rtc
+
+namespace cricket {
+
+class UDPPort;
+
+// Lets the UDPPorts of any number of allocator sessions share one UDP socket
+// per local IP address, the way media servers serve all their clients on a
+// single port, instead of binding a socket of their own each.
+//
+// Packets read from a shared socket are handed to the port they belong to:
+// STUN responses by the transaction ID of a request the port sent, STUN
+// binding requests by the local ICE ufrag in their USERNAME, and anything
+// else by the remote address the port last exchanged packets with. Packets
+// that match none of these are dropped.
+//
+// Since ports are told apart by ufrag, two ports with the same ufrag can't
+// share a socket; the RTP and RTCP components of a session without RTCP mux
+// can't both use it.
+//
+// Sockets stay open until the mux is destroyed, which must happen after all
+// of its ports are. Not thread safe; the mux and all its ports must be used
+// on the same thread.
+class UDPSocketMux : public sigslot::has_slots<> {
+ public:
+  struct Stats {
+    // Number of sockets, i.e. file descriptors, held.
+    size_t sockets = 0;
+    // Number of ports using them.
+    size_t ports = 0;
+    uint64_t packets_by_transaction_id = 0;
+    uint64_t packets_by_ufrag = 0;
+    uint64_t packets_by_remote_address = 0;
+    uint64_t packets_dropped = 0;
+    // Time spent deciding where packets go, over all packets.
+    int64_t total_demux_ns = 0;
+  };
+
+  UDPSocketMux();
+  ~UDPSocketMux() override;
+
+  // Returns the socket shared on |ip|, creating it with |factory| if this is
+  // the first port on it. Returns null if it can't be created, or if a port
+  // with |ufrag| already uses it.
+  rtc::AsyncPacketSocket* GetSocket(rtc::PacketSocketFactory* factory,
+                                    const rtc::IPAddress& ip,
+                                    uint16_t min_port,
+                                    uint16_t max_port,
+                                    const std::string& ufrag);
+
+  // Starts handing |port| the packets for it from its socket, which must have
+  // come from GetSocket(). The port calls RemovePort() when destroyed.
+  void AddPort(UDPPort* port);
+  void RemovePort(UDPPort* port);
+
+  // Called by a port for each packet it sends to |remote_addr|.
+  // |is_connection| is false for requests to STUN servers, whose address is
+  // shared by the ports.
+  void OnPacketSent(UDPPort* port,
+                    const void* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    bool is_connection);
+
+  Stats GetStats() const;
+
+ private:
+  struct SocketAddressHash {
+    size_t operator()(const rtc::SocketAddress& addr) const {
+      return addr.Hash();
+    }
+  };
+  struct SharedSocket {
+    rtc::IPAddress ip;
+    std::unique_ptr<rtc::AsyncPacketSocket> socket;
+    std::vector<UDPPort*> ports;
+    // Updated lazily, since a port's ufrag changes when its session is
+    // reused with new ICE parameters.
+    std::unordered_map<std::string, UDPPort*> ports_by_ufrag;
+    std::unordered_map<rtc::SocketAddress, UDPPort*, SocketAddressHash>
+        ports_by_remote_address;
+  };
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time);
+  UDPPort* FindPort(SharedSocket* shared,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr);
+  UDPPort* FindPortByUfrag(SharedSocket* shared, const std::string& ufrag);
+  SharedSocket* FindSocket(rtc::AsyncPacketSocket* socket);
+
+  std::vector<std::unique_ptr<SharedSocket>> sockets_;
+  // Ports by the transaction IDs of their outstanding STUN requests. Requests
+  // that are never answered are forgotten in the order they were sent.
+  std::unordered_map<std::string, UDPPort*> ports_by_transaction_id_;
+  std::deque<std::string> transaction_ids_;
+  Stats stats_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(UDPSocketMux);
+};
+
+}  // namespace cricket
+
+#endif  // WEBRTC_P2P_BASE_UDPSOCKETMUX_H_
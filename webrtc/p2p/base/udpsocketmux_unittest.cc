@@ -0,0 +1,233 @@
+/*
+ *  Copyright 2016 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/fakenetwork.h"
+#include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/physicalsocketserver.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
+#include "webrtc/base/virtualsocketserver.h"
+#include "webrtc/p2p/base/basicpacketsocketfactory.h"
+#include "webrtc/p2p/base/p2ptransportchannel.h"
+#include "webrtc/p2p/base/udpsocketmux.h"
+#include "webrtc/p2p/client/basicportallocator.h"
+
+namespace cricket {
+
+namespace {
+
+const int kDefaultTimeout = 3000;
+const char kServerIp[] = "11.11.11.11";
+const uint32_t kAllocatorFlags = PORTALLOCATOR_DISABLE_STUN |
+                                 PORTALLOCATOR_DISABLE_RELAY |
+                                 PORTALLOCATOR_DISABLE_TCP;
+
+// One side of a call: an allocator on a network of its own and a channel.
+class Endpoint : public sigslot::has_slots<> {
+ public:
+  Endpoint(const std::string& ip,
+           rtc::PacketSocketFactory* factory,
+           UDPSocketMux* mux,
+           const std::string& ufrag,
+           IceRole role)
+      : allocator_(&network_manager_, factory), ufrag_(ufrag) {
+    network_manager_.AddInterface(rtc::SocketAddress(ip, 0));
+    allocator_.set_flags(kAllocatorFlags);
+    allocator_.set_step_delay(kMinimumStepDelay);
+    allocator_.set_udp_socket_mux(mux);
+    channel_.reset(new P2PTransportChannel("data", 1, &allocator_));
+    channel_->SetIceParameters(IceParameters(ufrag, Password(), false));
+    channel_->SetIceRole(role);
+    channel_->SetIceTiebreaker(role == ICEROLE_CONTROLLING ? 2 : 1);
+    channel_->SignalCandidateGathered.connect(this,
+                                              &Endpoint::OnCandidateGathered);
+    channel_->SignalReadPacket.connect(this, &Endpoint::OnReadPacket);
+  }
+
+  void Connect(Endpoint* peer) {
+    peer_ = peer;
+    channel_->SetRemoteIceParameters(
+        IceParameters(peer->ufrag_, peer->Password(), false));
+    channel_->MaybeStartGathering();
+  }
+
+  P2PTransportChannel* channel() { return channel_.get(); }
+  const std::vector<std::string>& received() const { return received_; }
+
+ private:
+  std::string Password() const { return ufrag_ + "password000000000000"; }
+
+  void OnCandidateGathered(TransportChannelImpl* channel,
+                           const Candidate& candidate) {
+    // The peer may not have started yet; it picks up the candidate anyway.
+    peer_->channel_->AddRemoteCandidate(candidate);
+  }
+  void OnReadPacket(TransportChannel* channel,
+                    const char* data,
+                    size_t size,
+                    const rtc::PacketTime& packet_time,
+                    int flags) {
+    received_.push_back(std::string(data, size));
+  }
+
+  rtc::FakeNetworkManager network_manager_;
+  BasicPortAllocator allocator_;
+  std::string ufrag_;
+  std::unique_ptr<P2PTransportChannel> channel_;
+  Endpoint* peer_ = nullptr;
+  std::vector<std::string> received_;
+};
+
+}  // namespace
+
+class UDPSocketMuxTest : public testing::Test {
+ public:
+  UDPSocketMuxTest()
+      : pss_(new rtc::PhysicalSocketServer),
+        vss_(new rtc::VirtualSocketServer(pss_.get())),
+        ss_scope_(vss_.get()),
+        factory_(rtc::Thread::Current()) {}
+
+ protected:
+  // Creates |count| server endpoints sharing |mux_| and a client for each,
+  // and connects each pair.
+  void ConnectPairs(int count) {
+    for (int i = 0; i < count; ++i) {
+      servers_.emplace_back(new Endpoint(kServerIp, &factory_, &mux_,
+                                         "server" + rtc::ToString(i),
+                                         ICEROLE_CONTROLLED));
+      clients_.emplace_back(new Endpoint("22.22.22." + rtc::ToString(i + 1),
+                                         &factory_, nullptr,
+                                         "client" + rtc::ToString(i),
+                                         ICEROLE_CONTROLLING));
+      servers_[i]->Connect(clients_[i].get());
+      clients_[i]->Connect(servers_[i].get());
+    }
+  }
+
+  bool AllWritable() {
+    for (size_t i = 0; i < servers_.size(); ++i) {
+      if (!servers_[i]->channel()->writable() ||
+          !clients_[i]->channel()->writable()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::unique_ptr<rtc::PhysicalSocketServer> pss_;
+  std::unique_ptr<rtc::VirtualSocketServer> vss_;
+  rtc::SocketServerScope ss_scope_;
+  rtc::BasicPacketSocketFactory factory_;
+  // Destroyed after the endpoints, whose ports use it.
+  UDPSocketMux mux_;
+  std::vector<std::unique_ptr<Endpoint>> servers_;
+  std::vector<std::unique_ptr<Endpoint>> clients_;
+};
+
+// Server channels of different sessions connect over one socket, and each
+// gets only the packets of its own client.
+TEST_F(UDPSocketMuxTest, SessionsShareOneSocket) {
+  ConnectPairs(3);
+  EXPECT_TRUE_WAIT(AllWritable(), kDefaultTimeout);
+
+  UDPSocketMux::Stats stats = mux_.GetStats();
+  EXPECT_EQ(1u, stats.sockets);
+  EXPECT_EQ(3u, stats.ports);
+  EXPECT_LT(0u, stats.packets_by_ufrag);
+  EXPECT_LT(0u, stats.packets_by_transaction_id);
+  // Different ports, same local address.
+  const Connection* first = servers_[0]->channel()->selected_connection();
+  for (const auto& server : servers_) {
+    const Connection* conn = server->channel()->selected_connection();
+    EXPECT_EQ(first->local_candidate().address(),
+              conn->local_candidate().address());
+  }
+
+  rtc::PacketOptions options;
+  for (size_t i = 0; i < clients_.size(); ++i) {
+    std::string data = "data" + rtc::ToString(i);
+    EXPECT_EQ(static_cast<int>(data.size()),
+              clients_[i]->channel()->SendPacket(data.data(), data.size(),
+                                                 options, 0));
+  }
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    EXPECT_EQ_WAIT(1u, servers_[i]->received().size(), kDefaultTimeout);
+    EXPECT_EQ("data" + rtc::ToString(i), servers_[i]->received()[0]);
+  }
+  EXPECT_LE(3u, mux_.GetStats().packets_by_remote_address);
+}
+
+// A port that goes away stops getting packets; the others keep theirs.
+TEST_F(UDPSocketMuxTest, DestroyedPortIsRemoved) {
+  ConnectPairs(2);
+  EXPECT_TRUE_WAIT(AllWritable(), kDefaultTimeout);
+  servers_[0].reset();
+  EXPECT_EQ(1u, mux_.GetStats().ports);
+  EXPECT_EQ(1u, mux_.GetStats().sockets);
+
+  rtc::PacketOptions options;
+  clients_[1]->channel()->SendPacket("data", 4, options, 0);
+  EXPECT_EQ_WAIT(1u, servers_[1]->received().size(), kDefaultTimeout);
+  // The destroyed port's client keeps pinging into the void.
+  EXPECT_TRUE_WAIT(mux_.GetStats().packets_dropped > 0, kDefaultTimeout);
+}
+
+// A second port with a ufrag already on the socket gets one of its own.
+TEST_F(UDPSocketMuxTest, SameUfragFallsBackToOwnSocket) {
+  Endpoint server1(kServerIp, &factory_, &mux_, "server", ICEROLE_CONTROLLED);
+  Endpoint server2(kServerIp, &factory_, &mux_, "server", ICEROLE_CONTROLLED);
+  Endpoint client(kServerIp, &factory_, nullptr, "client",
+                  ICEROLE_CONTROLLING);
+  server1.Connect(&client);
+  server2.Connect(&client);
+  EXPECT_TRUE_WAIT(server1.channel()->ports().size() == 1 &&
+                       server2.channel()->ports().size() == 1,
+                   kDefaultTimeout);
+  EXPECT_EQ(1u, mux_.GetStats().sockets);
+  EXPECT_EQ(1u, mux_.GetStats().ports);
+}
+
+// Measures the cost of demultiplexing with many sessions on one socket.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(UDPSocketMuxTest, DISABLED_DemuxCost) {
+  const int kPairs = 100;
+  const int kPacketsPerClient = 100;
+  ConnectPairs(kPairs);
+  EXPECT_TRUE_WAIT(AllWritable(), kDefaultTimeout * 10);
+  UDPSocketMux::Stats before = mux_.GetStats();
+
+  rtc::PacketOptions options;
+  for (int i = 0; i < kPacketsPerClient; ++i) {
+    for (const auto& client : clients_) {
+      client->channel()->SendPacket("0123456789", 10, options, 0);
+    }
+  }
+  EXPECT_TRUE_WAIT(servers_.back()->received().size() == kPacketsPerClient,
+                   kDefaultTimeout * 10);
+  UDPSocketMux::Stats after = mux_.GetStats();
+  uint64_t packets =
+      after.packets_by_remote_address + after.packets_by_ufrag +
+      after.packets_by_transaction_id - before.packets_by_remote_address -
+      before.packets_by_ufrag - before.packets_by_transaction_id;
+  int64_t demux_ns = after.total_demux_ns - before.total_demux_ns;
+  LOG(LS_INFO) << kPairs << " sessions on " << after.sockets
+               << " socket(s): " << packets << " packets demultiplexed in "
+               << demux_ns / std::max<uint64_t>(packets, 1) << " ns each";
+}
+
+}  // namespace cricket
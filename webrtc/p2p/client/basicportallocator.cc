@@ -22,6 +22,7 @@
 #include "webrtc/p2p/base/tcpport.h"
 #include "webrtc/p2p/base/turnport.h"
 #include "webrtc/p2p/base/udpport.h"
+#include "webrtc/p2p/base/udpsocketmux.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/common.h"
 #include "webrtc/base/helpers.h"
@@ -1096,33 +1097,40 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
     "Udp", "Relay", "Tcp", "SslTcp"
   };
 
-  // Perform all of the phases in the current step.
-  LOG_J(LS_INFO, network_) << "Allocation Phase="
-                           << PHASE_NAMES[phase_];
+  // Perform all of the phases in the current step, or all of the remaining
+  // ones if they run in parallel.
+  bool parallel = IsFlagSet(PORTALLOCATOR_ENABLE_PARALLEL_PHASES);
+  while (true) {
+    LOG_J(LS_INFO, network_) << "Allocation Phase=" << PHASE_NAMES[phase_];
+
+    switch (phase_) {
+      case PHASE_UDP:
+        CreateUDPPorts();
+        CreateStunPorts();
+        EnableProtocol(PROTO_UDP);
+        break;
 
-  switch (phase_) {
-    case PHASE_UDP:
-      CreateUDPPorts();
-      CreateStunPorts();
-      EnableProtocol(PROTO_UDP);
-      break;
+      case PHASE_RELAY:
+        CreateRelayPorts();
+        break;
 
-    case PHASE_RELAY:
-      CreateRelayPorts();
-      break;
+      case PHASE_TCP:
+        CreateTCPPorts();
+        EnableProtocol(PROTO_TCP);
+        break;
 
-    case PHASE_TCP:
-      CreateTCPPorts();
-      EnableProtocol(PROTO_TCP);
-      break;
+      case PHASE_SSLTCP:
+        state_ = kCompleted;
+        EnableProtocol(PROTO_SSLTCP);
+        break;
 
-    case PHASE_SSLTCP:
-      state_ = kCompleted;
-      EnableProtocol(PROTO_SSLTCP);
+      default:
+        ASSERT(false);
+    }
+    if (!parallel || state() != kRunning) {
       break;
-
-    default:
-      ASSERT(false);
+    }
+    ++phase_;
   }
 
   if (state() == kRunning) {
@@ -1165,7 +1173,23 @@ void AllocationSequence::CreateUDPPorts() {
   UDPPort* port = NULL;
   bool emit_local_candidate_for_anyaddress =
       !IsFlagSet(PORTALLOCATOR_DISABLE_DEFAULT_LOCAL_CANDIDATE);
-  if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET) && udp_socket_) {
+  UDPSocketMux* mux = session_->allocator()->udp_socket_mux();
+  rtc::AsyncPacketSocket* mux_socket = nullptr;
+  if (mux) {
+    // Falls back to a socket of the port's own if the mux has none to spare.
+    mux_socket = mux->GetSocket(
+        session_->socket_factory(), ip_, session_->allocator()->min_port(),
+        session_->allocator()->max_port(), session_->username());
+  }
+  if (mux_socket) {
+    port = UDPPort::Create(
+        session_->network_thread(), session_->socket_factory(), network_,
+        mux_socket, session_->username(), session_->password(),
+        session_->allocator()->origin(), emit_local_candidate_for_anyaddress);
+    if (port) {
+      mux->AddPort(port);
+    }
+  } else if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET) && udp_socket_) {
     port = UDPPort::Create(
         session_->network_thread(), session_->socket_factory(), network_,
         udp_socket_.get(), session_->username(), session_->password(),
@@ -1181,9 +1205,12 @@ void AllocationSequence::CreateUDPPorts() {
   if (port) {
     // If shared socket is enabled, STUN candidate will be allocated by the
     // UDPPort.
-    if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET)) {
-      udp_port_ = port;
-      port->SignalDestroyed.connect(this, &AllocationSequence::OnPortDestroyed);
+    if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET) || mux) {
+      if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET)) {
+        udp_port_ = port;
+        port->SignalDestroyed.connect(this,
+                                      &AllocationSequence::OnPortDestroyed);
+      }
 
       // If STUN is not disabled, setting stun server address to port.
       if (!IsFlagSet(PORTALLOCATOR_DISABLE_STUN)) {
@@ -1225,7 +1252,8 @@ void AllocationSequence::CreateStunPorts() {
     return;
   }
 
-  if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET)) {
+  if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET) ||
+      session_->allocator()->udp_socket_mux()) {
     return;
   }
 
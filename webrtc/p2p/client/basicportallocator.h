@@ -22,6 +22,8 @@
 
 namespace cricket {
 
+class UDPSocketMux;
+
 class BasicPortAllocator : public PortAllocator {
  public:
   BasicPortAllocator(rtc::NetworkManager* network_manager,
@@ -62,6 +64,13 @@ class BasicPortAllocator : public PortAllocator {
   // Convenience method that adds a TURN server to the configuration.
   void AddTurnServer(const RelayServerConfig& turn_server);
 
+  // If set, UDP ports are created on the sockets of |mux|, which may be
+  // shared with other allocators, rather than on sockets of their own. They
+  // then gather STUN candidates themselves, as with
+  // PORTALLOCATOR_ENABLE_SHARED_SOCKET. Not owned; must outlive the ports.
+  void set_udp_socket_mux(UDPSocketMux* mux) { udp_socket_mux_ = mux; }
+  UDPSocketMux* udp_socket_mux() const { return udp_socket_mux_; }
+
  private:
   void Construct();
 
@@ -69,6 +78,7 @@ class BasicPortAllocator : public PortAllocator {
   rtc::PacketSocketFactory* socket_factory_;
   bool allow_tcp_listen_;
   int network_ignore_mask_ = rtc::kDefaultNetworkIgnoreMask;
+  UDPSocketMux* udp_socket_mux_ = nullptr;
 };
 
 struct PortConfiguration;
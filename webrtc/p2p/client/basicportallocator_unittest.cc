@@ -882,6 +882,57 @@ TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithOneSecondStepDelay) {
   session_->StopGettingPorts();
 }
 
+// Test that with parallel phases, candidates of every type are gathered
+// without waiting for the step delay.
+TEST_F(BasicPortAllocatorTest, TestParallelPhasesDontWaitForStepDelay) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_PARALLEL_PHASES);
+  EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  ASSERT_EQ_WAIT(7U, candidates_.size(), kDefaultStepDelay / 2);
+  EXPECT_EQ(4U, ports_.size());
+  EXPECT_PRED4(HasCandidate, candidates_, "local", "udp", kClientAddr);
+  EXPECT_PRED4(HasCandidate, candidates_, "relay", "udp", kRelayUdpIntAddr);
+  EXPECT_PRED4(HasCandidate, candidates_, "local", "tcp", kClientAddr);
+  EXPECT_PRED4(HasCandidate, candidates_, "relay", "ssltcp",
+               kRelaySslTcpIntAddr);
+  EXPECT_TRUE_WAIT(candidate_allocation_done_, kDefaultStepDelay / 2);
+}
+
+// Measures the time to the first candidate and to the end of gathering, with
+// the phases run one per step and in parallel.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(BasicPortAllocatorTest, DISABLED_GatherLatency) {
+  AddInterface(kClientAddr);
+  const int kRuns = 20;
+  for (bool parallel : {false, true}) {
+    if (parallel) {
+      allocator_->set_flags(allocator().flags() |
+                            PORTALLOCATOR_ENABLE_PARALLEL_PHASES);
+    }
+    int64_t first_ms = 0;
+    int64_t done_ms = 0;
+    for (int i = 0; i < kRuns; ++i) {
+      candidates_.clear();
+      ports_.clear();
+      candidate_allocation_done_ = false;
+      ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+      int64_t start = rtc::TimeMillis();
+      session_->StartGettingPorts();
+      ASSERT_TRUE_WAIT(!candidates_.empty(), kDefaultAllocationTimeout);
+      first_ms += rtc::TimeMillis() - start;
+      ASSERT_TRUE_WAIT(candidate_allocation_done_, kDefaultAllocationTimeout);
+      done_ms += rtc::TimeMillis() - start;
+      EXPECT_EQ(7U, candidates_.size());
+    }
+    LOG(LS_INFO) << (parallel ? "Parallel" : "Sequential")
+                 << " phases: first candidate after " << first_ms / kRuns
+                 << " ms, gathering done after " << done_ms / kRuns << " ms";
+  }
+}
+
 TEST_F(BasicPortAllocatorTest, TestSetupVideoRtpPortsWithNormalSendBuffers) {
   AddInterface(kClientAddr);
   EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP, CN_VIDEO));
@@ -33,6 +33,8 @@
         'base/p2ptransportchannel.cc',
         'base/p2ptransportchannel.h',
         'base/packetsocketfactory.h',
+        'base/pingscheduler.cc',
+        'base/pingscheduler.h',
         'base/port.cc',
         'base/port.h',
         'base/portallocator.cc',
@@ -70,6 +72,8 @@
         'base/turnport.cc',
         'base/turnport.h',
         'base/udpport.h',
+        'base/udpsocketmux.cc',
+        'base/udpsocketmux.h',
         'client/basicportallocator.cc',
         'client/basicportallocator.h',
         'client/httpportallocator.cc',
@@ -87,6 +91,8 @@
           'sources': [
             'base/relayserver.cc',
             'base/relayserver.h',
+            'base/shardedturnserver.cc',
+            'base/shardedturnserver.h',
             'base/stunserver.cc',
             'base/stunserver.h',
             'base/turnserver.cc',
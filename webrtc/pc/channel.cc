@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <unordered_set>
 #include <utility>
 
 #include "webrtc/pc/channel.h"
@@ -21,6 +22,7 @@
 #include "webrtc/base/dscp.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/networkroute.h"
+#include "webrtc/base/packetbufferpool.h"
 #include "webrtc/base/trace_event.h"
 #include "webrtc/media/base/mediaconstants.h"
 #include "webrtc/media/base/rtputils.h"
@@ -39,6 +41,24 @@ bool SetRawAudioSink_w(VoiceMediaChannel* channel,
   return true;
 }
 
+// Returns true if |params| are the ones last given to the media channel, so
+// that giving them again would only cost time. Parameters without codecs are
+// never taken as applied, since the initial, default |last_params| weren't.
+template <class Params>
+bool IsUnchanged(const Params& params, const Params& last_params) {
+  return !last_params.codecs.empty() && params == last_params;
+}
+
+// Returns all SSRCs of |streams|, so that looking a stream up is cheap even
+// in a conference with many of them.
+std::unordered_set<uint32_t> GetAllSsrcs(const StreamParamsVec& streams) {
+  std::unordered_set<uint32_t> ssrcs;
+  for (const StreamParams& stream : streams) {
+    ssrcs.insert(stream.ssrcs.begin(), stream.ssrcs.end());
+  }
+  return ssrcs;
+}
+
 struct SendPacketMessageData : public rtc::MessageData {
   rtc::CopyOnWriteBuffer packet;
   rtc::PacketOptions options;
@@ -231,6 +251,7 @@ void BaseChannel::DestroyTransportChannels_n() {
 }
 
 bool BaseChannel::Init_w(const std::string* bundle_transport_name) {
+  TRACE_EVENT0("webrtc", "BaseChannel::Init_w");
   if (!network_thread_->Invoke<bool>(
           RTC_FROM_HERE,
           Bind(&BaseChannel::InitNetwork_n, this, bundle_transport_name))) {
@@ -245,6 +266,7 @@ bool BaseChannel::Init_w(const std::string* bundle_transport_name) {
 }
 
 bool BaseChannel::InitNetwork_n(const std::string* bundle_transport_name) {
+  TRACE_EVENT0("webrtc", "BaseChannel::InitNetwork_n");
   RTC_DCHECK(network_thread_->IsCurrent());
   const std::string& transport_name =
       (bundle_transport_name ? *bundle_transport_name : content_name());
@@ -545,7 +567,8 @@ void BaseChannel::OnChannelRead(TransportChannel* channel,
   // When using RTCP multiplexing we might get RTCP packets on the RTP
   // transport. We feed RTP traffic into the demuxer to determine if it is RTCP.
   bool rtcp = PacketIsRtcp(channel, data, len);
-  rtc::CopyOnWriteBuffer packet(data, len);
+  rtc::CopyOnWriteBuffer packet =
+      rtc::PacketBufferPool::Instance()->Allocate(data, len);
   HandlePacket(rtcp, &packet, packet_time);
 }
 
@@ -817,9 +840,39 @@ void BaseChannel::HandlePacket(bool rtcp, rtc::CopyOnWriteBuffer* packet,
     return;
   }
 
-  invoker_.AsyncInvoke<void>(
-      RTC_FROM_HERE, worker_thread_,
-      Bind(&BaseChannel::OnPacketReceived, this, rtcp, *packet, packet_time));
+  // Media channels that deliver packets on the network thread take those of
+  // their known streams right here, without a hop to the worker thread.
+  if (media_channel_->DeliverPacketOnNetworkThread(rtcp, packet, packet_time))
+    return;
+
+  // Packets are handed to the worker thread in batches: only the first packet
+  // queued after the worker thread has taken the previous batch posts a
+  // message, the rest are delivered along with it.
+  bool post_delivery;
+  {
+    rtc::CritScope cs(&received_packets_crit_);
+    post_delivery = received_packets_.empty();
+    received_packets_.push_back(ReceivedPacket{rtcp, *packet, packet_time});
+  }
+  if (post_delivery) {
+    invoker_.AsyncInvoke<void>(
+        RTC_FROM_HERE, worker_thread_,
+        Bind(&BaseChannel::DeliverReceivedPackets_w, this));
+  }
+}
+
+void BaseChannel::DeliverReceivedPackets_w() {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  RTC_DCHECK(packets_to_deliver_.empty());
+  {
+    rtc::CritScope cs(&received_packets_crit_);
+    received_packets_.swap(packets_to_deliver_);
+  }
+  for (const ReceivedPacket& received : packets_to_deliver_)
+    OnPacketReceived(received.rtcp, received.packet, received.packet_time);
+  // Keeps the capacity, so that the next batch can be swapped in without
+  // allocating.
+  packets_to_deliver_.clear();
 }
 
 void BaseChannel::OnPacketReceived(bool rtcp,
@@ -1283,12 +1336,17 @@ bool BaseChannel::UpdateLocalStreams_w(const std::vector<StreamParams>& streams,
     return true;
   }
   // Else streams are all the streams we want to send.
+  if (streams == local_streams_) {
+    return true;
+  }
+  std::unordered_set<uint32_t> new_ssrcs = GetAllSsrcs(streams);
+  std::unordered_set<uint32_t> old_ssrcs = GetAllSsrcs(local_streams_);
 
   // Check for streams that have been removed.
   bool ret = true;
   for (StreamParamsVec::const_iterator it = local_streams_.begin();
        it != local_streams_.end(); ++it) {
-    if (!GetStreamBySsrc(streams, it->first_ssrc())) {
+    if (!new_ssrcs.count(it->first_ssrc())) {
       if (!media_channel()->RemoveSendStream(it->first_ssrc())) {
         std::ostringstream desc;
         desc << "Failed to remove send stream with ssrc "
@@ -1301,7 +1359,7 @@ bool BaseChannel::UpdateLocalStreams_w(const std::vector<StreamParams>& streams,
   // Check for new streams.
   for (StreamParamsVec::const_iterator it = streams.begin();
        it != streams.end(); ++it) {
-    if (!GetStreamBySsrc(local_streams_, it->first_ssrc())) {
+    if (!old_ssrcs.count(it->first_ssrc())) {
       if (media_channel()->AddSendStream(*it)) {
         LOG(LS_INFO) << "Add send stream ssrc: " << it->ssrcs[0];
       } else {
@@ -1358,12 +1416,17 @@ bool BaseChannel::UpdateRemoteStreams_w(
     return true;
   }
   // Else streams are all the streams we want to receive.
+  if (streams == remote_streams_) {
+    return true;
+  }
+  std::unordered_set<uint32_t> new_ssrcs = GetAllSsrcs(streams);
+  std::unordered_set<uint32_t> old_ssrcs = GetAllSsrcs(remote_streams_);
 
   // Check for streams that have been removed.
   bool ret = true;
   for (StreamParamsVec::const_iterator it = remote_streams_.begin();
        it != remote_streams_.end(); ++it) {
-    if (!GetStreamBySsrc(streams, it->first_ssrc())) {
+    if (!new_ssrcs.count(it->first_ssrc())) {
       if (!RemoveRecvStream_w(it->first_ssrc())) {
         std::ostringstream desc;
         desc << "Failed to remove remote stream with ssrc "
@@ -1376,7 +1439,7 @@ bool BaseChannel::UpdateRemoteStreams_w(
   // Check for new streams.
   for (StreamParamsVec::const_iterator it = streams.begin();
       it != streams.end(); ++it) {
-    if (!GetStreamBySsrc(remote_streams_, it->first_ssrc())) {
+    if (!old_ssrcs.count(it->first_ssrc())) {
       if (AddRecvStream_w(*it)) {
         LOG(LS_INFO) << "Add remote ssrc: " << it->ssrcs[0];
       } else {
@@ -1701,7 +1764,8 @@ bool VoiceChannel::SetLocalContent_w(const MediaContentDescription* content,
 
   AudioRecvParameters recv_params = last_recv_params_;
   RtpParametersFromMediaDescription(audio, &recv_params);
-  if (!media_channel()->SetRecvParameters(recv_params)) {
+  if (!IsUnchanged(recv_params, last_recv_params_) &&
+      !media_channel()->SetRecvParameters(recv_params)) {
     SafeSetError("Failed to set local audio description recv parameters.",
                  error_desc);
     return false;
@@ -1750,7 +1814,8 @@ bool VoiceChannel::SetRemoteContent_w(const MediaContentDescription* content,
     send_params.options.adjust_agc_delta = rtc::Optional<int>(kAgcMinus10db);
   }
 
-  bool parameters_applied = media_channel()->SetSendParameters(send_params);
+  bool parameters_applied = IsUnchanged(send_params, last_send_params_) ||
+                            media_channel()->SetSendParameters(send_params);
   if (!parameters_applied) {
     SafeSetError("Failed to set remote audio description send parameters.",
                  error_desc);
@@ -1984,7 +2049,8 @@ bool VideoChannel::SetLocalContent_w(const MediaContentDescription* content,
 
   VideoRecvParameters recv_params = last_recv_params_;
   RtpParametersFromMediaDescription(video, &recv_params);
-  if (!media_channel()->SetRecvParameters(recv_params)) {
+  if (!IsUnchanged(recv_params, last_recv_params_) &&
+      !media_channel()->SetRecvParameters(recv_params)) {
     SafeSetError("Failed to set local video description recv parameters.",
                  error_desc);
     return false;
@@ -2033,7 +2099,8 @@ bool VideoChannel::SetRemoteContent_w(const MediaContentDescription* content,
     send_params.conference_mode = true;
   }
 
-  bool parameters_applied = media_channel()->SetSendParameters(send_params);
+  bool parameters_applied = IsUnchanged(send_params, last_send_params_) ||
+                            media_channel()->SetSendParameters(send_params);
 
   if (!parameters_applied) {
     SafeSetError("Failed to set remote video description send parameters.",
@@ -2214,7 +2281,8 @@ bool DataChannel::SetLocalContent_w(const MediaContentDescription* content,
   // data channels need codecs.
   DataRecvParameters recv_params = last_recv_params_;
   RtpParametersFromMediaDescription(data, &recv_params);
-  if (!media_channel()->SetRecvParameters(recv_params)) {
+  if (!IsUnchanged(recv_params, last_recv_params_) &&
+      !media_channel()->SetRecvParameters(recv_params)) {
     SafeSetError("Failed to set remote data description recv parameters.",
                  error_desc);
     return false;
@@ -2273,7 +2341,8 @@ bool DataChannel::SetRemoteContent_w(const MediaContentDescription* content,
 
   DataSendParameters send_params = last_send_params_;
   RtpSendParametersFromMediaDescription<DataCodec>(data, &send_params);
-  if (!media_channel()->SetSendParameters(send_params)) {
+  if (!IsUnchanged(send_params, last_send_params_) &&
+      !media_channel()->SetSendParameters(send_params)) {
     SafeSetError("Failed to set remote data description send parameters.",
                  error_desc);
     return false;
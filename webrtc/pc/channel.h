@@ -261,6 +261,8 @@ class BaseChannel
   void OnPacketReceived(bool rtcp,
                         const rtc::CopyOnWriteBuffer& packet,
                         const rtc::PacketTime& packet_time);
+  // Passes the packets queued by HandlePacket() to OnPacketReceived().
+  void DeliverReceivedPackets_w();
 
   void EnableMedia_w();
   void DisableMedia_w();
@@ -366,6 +368,19 @@ class BaseChannel
   rtc::Thread* const network_thread_;
   rtc::AsyncInvoker invoker_;
 
+  // Packets received on the network thread that the worker thread hasn't taken
+  // yet. A message to deliver them is pending whenever this is non-empty.
+  struct ReceivedPacket {
+    bool rtcp;
+    rtc::CopyOnWriteBuffer packet;
+    rtc::PacketTime packet_time;
+  };
+  rtc::CriticalSection received_packets_crit_;
+  std::vector<ReceivedPacket> received_packets_
+      GUARDED_BY(received_packets_crit_);
+  // The batch being delivered; only accessed on the worker thread.
+  std::vector<ReceivedPacket> packets_to_deliver_;
+
   const std::string content_name_;
   std::unique_ptr<ConnectionMonitor> connection_monitor_;
 
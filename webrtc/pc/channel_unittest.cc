@@ -8,6 +8,10 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#endif
+
 #include <memory>
 
 #include "webrtc/base/array_view.h"
@@ -16,6 +20,7 @@
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/sslstreamadapter.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/media/base/fakemediaengine.h"
 #include "webrtc/media/base/fakertp.h"
 #include "webrtc/media/base/mediachannel.h"
@@ -795,6 +800,37 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
     EXPECT_TRUE(CheckCustomRtp1(kSsrc2, 0));
   }
 
+  // Test that renegotiating a content with many streams only adds and removes
+  // the streams that changed, and that an unchanged content changes nothing.
+  void TestRenegotiateManyRemoteStreams() {
+    const uint32_t kStreams = 50;
+    CreateChannels(0, 0);
+    typename T::Content content1;
+    CreateContent(0, kPcmuCodec, kH264Codec, &content1);
+    for (uint32_t i = 0; i < kStreams; ++i) {
+      content1.AddStream(cricket::StreamParams::CreateLegacy(100 + i));
+    }
+    EXPECT_TRUE(channel1_->SetRemoteContent(&content1, CA_OFFER, NULL));
+    EXPECT_EQ(kStreams, media_channel1_->recv_streams().size());
+
+    // One participant leaves and another joins.
+    typename T::Content content2;
+    CreateContent(0, kPcmuCodec, kH264Codec, &content2);
+    for (uint32_t i = 1; i <= kStreams; ++i) {
+      content2.AddStream(cricket::StreamParams::CreateLegacy(100 + i));
+    }
+    EXPECT_TRUE(channel1_->SetRemoteContent(&content2, CA_OFFER, NULL));
+    ASSERT_EQ(kStreams, media_channel1_->recv_streams().size());
+    EXPECT_FALSE(
+        cricket::GetStreamBySsrc(media_channel1_->recv_streams(), 100));
+    EXPECT_TRUE(cricket::GetStreamBySsrc(media_channel1_->recv_streams(),
+                                         100 + kStreams));
+
+    EXPECT_TRUE(channel1_->SetRemoteContent(&content2, CA_OFFER, NULL));
+    EXPECT_EQ(kStreams, media_channel1_->recv_streams().size());
+    ASSERT_EQ(1U, media_channel1_->codecs().size());
+  }
+
   // Test that we only start playout and sending at the right times.
   void TestPlayoutAndSendingStates() {
     CreateChannels(0, 0);
@@ -1444,6 +1480,62 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
     EXPECT_TRUE(CheckNoRtcp2());
   }
 
+  // Test that a media channel can take the received packets on the network
+  // thread, after they have been unprotected.
+  void DeliverPacketsOnNetworkThread() {
+    CreateChannels(RTCP | SECURE, RTCP | SECURE);
+    media_channel2_->set_deliver_packets_on_network_thread(true);
+    EXPECT_TRUE(SendInitiate());
+    EXPECT_TRUE(SendAccept());
+    SendRtp1();
+    SendRtcp1();
+    WaitForThreads();
+    EXPECT_TRUE(CheckRtp2());
+    EXPECT_TRUE(CheckRtcp2());
+    EXPECT_TRUE(CheckNoRtp2());
+    EXPECT_TRUE(CheckNoRtcp2());
+    EXPECT_EQ(network_thread_, media_channel2_->receive_thread());
+  }
+
+  // Logs the time it takes to get a packet from one channel to the other, and
+  // the CPU time spent on it, with and without delivery on the network thread.
+  void BenchmarkPacketDelivery() {
+    const int kNumPackets = 10000;
+    CreateChannels(RTCP | SECURE, RTCP | SECURE);
+    EXPECT_TRUE(SendInitiate());
+    EXPECT_TRUE(SendAccept());
+    for (bool on_network_thread : {false, true}) {
+      media_channel2_->set_deliver_packets_on_network_thread(on_network_thread);
+#if defined(WEBRTC_POSIX)
+      struct rusage usage_before;
+      getrusage(RUSAGE_SELF, &usage_before);
+#endif
+      const int64_t start_us = rtc::TimeMicros();
+      for (int i = 0; i < kNumPackets; ++i) {
+        SendRtp1();
+        WaitForThreads();
+        ASSERT_TRUE(CheckRtp2());
+      }
+      const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+      int64_t cpu_us = -1;
+#if defined(WEBRTC_POSIX)
+      struct rusage usage_after;
+      getrusage(RUSAGE_SELF, &usage_after);
+      cpu_us = ((usage_after.ru_utime.tv_sec - usage_before.ru_utime.tv_sec) +
+                (usage_after.ru_stime.tv_sec - usage_before.ru_stime.tv_sec)) *
+                   rtc::kNumMicrosecsPerSec +
+               (usage_after.ru_utime.tv_usec - usage_before.ru_utime.tv_usec) +
+               (usage_after.ru_stime.tv_usec - usage_before.ru_stime.tv_usec);
+#endif
+      LOG(LS_INFO) << "Delivery on the "
+                   << (on_network_thread ? "network" : "worker") << " thread: "
+                   << static_cast<double>(elapsed_us) / kNumPackets
+                   << " us latency and "
+                   << static_cast<double>(cpu_us) / kNumPackets
+                   << " us CPU per packet.";
+    }
+  }
+
   // Test that we properly send SRTP with RTCP from a thread.
   void SendSrtpToSrtpOnThread() {
     CreateChannels(RTCP | SECURE, RTCP | SECURE);
@@ -2186,6 +2278,10 @@ TEST_F(VoiceChannelSingleThreadTest, TestChangeStreamParamsInContent) {
   Base::TestChangeStreamParamsInContent();
 }
 
+TEST_F(VoiceChannelSingleThreadTest, TestRenegotiateManyRemoteStreams) {
+  Base::TestRenegotiateManyRemoteStreams();
+}
+
 TEST_F(VoiceChannelSingleThreadTest, TestPlayoutAndSendingStates) {
   Base::TestPlayoutAndSendingStates();
 }
@@ -2531,6 +2627,10 @@ TEST_F(VoiceChannelDoubleThreadTest, TestChangeStreamParamsInContent) {
   Base::TestChangeStreamParamsInContent();
 }
 
+TEST_F(VoiceChannelDoubleThreadTest, TestRenegotiateManyRemoteStreams) {
+  Base::TestRenegotiateManyRemoteStreams();
+}
+
 TEST_F(VoiceChannelDoubleThreadTest, TestPlayoutAndSendingStates) {
   Base::TestPlayoutAndSendingStates();
 }
@@ -2679,6 +2779,14 @@ TEST_F(VoiceChannelDoubleThreadTest, SendSrtpToSrtpOnThread) {
   Base::SendSrtpToSrtpOnThread();
 }
 
+TEST_F(VoiceChannelDoubleThreadTest, DeliverPacketsOnNetworkThread) {
+  Base::DeliverPacketsOnNetworkThread();
+}
+
+TEST_F(VoiceChannelDoubleThreadTest, DISABLED_BenchmarkPacketDelivery) {
+  Base::BenchmarkPacketDelivery();
+}
+
 TEST_F(VoiceChannelDoubleThreadTest, SendWithWritabilityLoss) {
   Base::SendWithWritabilityLoss();
 }
@@ -2874,6 +2982,10 @@ TEST_F(VideoChannelSingleThreadTest, TestChangeStreamParamsInContent) {
   Base::TestChangeStreamParamsInContent();
 }
 
+TEST_F(VideoChannelSingleThreadTest, TestRenegotiateManyRemoteStreams) {
+  Base::TestRenegotiateManyRemoteStreams();
+}
+
 TEST_F(VideoChannelSingleThreadTest, TestPlayoutAndSendingStates) {
   Base::TestPlayoutAndSendingStates();
 }
@@ -3118,6 +3230,10 @@ TEST_F(VideoChannelDoubleThreadTest, TestChangeStreamParamsInContent) {
   Base::TestChangeStreamParamsInContent();
 }
 
+TEST_F(VideoChannelDoubleThreadTest, TestRenegotiateManyRemoteStreams) {
+  Base::TestRenegotiateManyRemoteStreams();
+}
+
 TEST_F(VideoChannelDoubleThreadTest, TestPlayoutAndSendingStates) {
   Base::TestPlayoutAndSendingStates();
 }
@@ -3249,6 +3365,14 @@ TEST_F(VideoChannelDoubleThreadTest, SendSrtpToSrtpOnThread) {
   Base::SendSrtpToSrtpOnThread();
 }
 
+TEST_F(VideoChannelDoubleThreadTest, DeliverPacketsOnNetworkThread) {
+  Base::DeliverPacketsOnNetworkThread();
+}
+
+TEST_F(VideoChannelDoubleThreadTest, DISABLED_BenchmarkPacketDelivery) {
+  Base::BenchmarkPacketDelivery();
+}
+
 TEST_F(VideoChannelDoubleThreadTest, SendWithWritabilityLoss) {
   Base::SendWithWritabilityLoss();
 }
@@ -3433,6 +3557,10 @@ TEST_F(DataChannelSingleThreadTest, TestChangeStreamParamsInContent) {
   Base::TestChangeStreamParamsInContent();
 }
 
+TEST_F(DataChannelSingleThreadTest, TestRenegotiateManyRemoteStreams) {
+  Base::TestRenegotiateManyRemoteStreams();
+}
+
 TEST_F(DataChannelSingleThreadTest, TestPlayoutAndSendingStates) {
   Base::TestPlayoutAndSendingStates();
 }
@@ -3577,6 +3705,10 @@ TEST_F(DataChannelDoubleThreadTest, TestChangeStreamParamsInContent) {
   Base::TestChangeStreamParamsInContent();
 }
 
+TEST_F(DataChannelDoubleThreadTest, TestRenegotiateManyRemoteStreams) {
+  Base::TestRenegotiateManyRemoteStreams();
+}
+
 TEST_F(DataChannelDoubleThreadTest, TestPlayoutAndSendingStates) {
   Base::TestPlayoutAndSendingStates();
 }
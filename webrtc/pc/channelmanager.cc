@@ -219,6 +219,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
     const std::string* bundle_transport_name,
     bool rtcp,
     const AudioOptions& options) {
+  TRACE_EVENT0("webrtc", "ChannelManager::CreateVoiceChannel");
   return worker_thread_->Invoke<VoiceChannel*>(
       RTC_FROM_HERE, Bind(&ChannelManager::CreateVoiceChannel_w, this,
                           media_controller, transport_controller, content_name,
@@ -232,6 +233,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel_w(
     const std::string* bundle_transport_name,
     bool rtcp,
     const AudioOptions& options) {
+  TRACE_EVENT0("webrtc", "ChannelManager::CreateVoiceChannel_w");
   ASSERT(initialized_);
   ASSERT(worker_thread_ == rtc::Thread::Current());
   ASSERT(nullptr != media_controller);
@@ -282,6 +284,7 @@ VideoChannel* ChannelManager::CreateVideoChannel(
     const std::string* bundle_transport_name,
     bool rtcp,
     const VideoOptions& options) {
+  TRACE_EVENT0("webrtc", "ChannelManager::CreateVideoChannel");
   return worker_thread_->Invoke<VideoChannel*>(
       RTC_FROM_HERE, Bind(&ChannelManager::CreateVideoChannel_w, this,
                           media_controller, transport_controller, content_name,
@@ -295,6 +298,7 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
     const std::string* bundle_transport_name,
     bool rtcp,
     const VideoOptions& options) {
+  TRACE_EVENT0("webrtc", "ChannelManager::CreateVideoChannel_w");
   ASSERT(initialized_);
   ASSERT(worker_thread_ == rtc::Thread::Current());
   ASSERT(nullptr != media_controller);
@@ -341,27 +345,32 @@ void ChannelManager::DestroyVideoChannel_w(VideoChannel* video_channel) {
 }
 
 DataChannel* ChannelManager::CreateDataChannel(
+    const MediaConfig& media_config,
     TransportController* transport_controller,
     const std::string& content_name,
     const std::string* bundle_transport_name,
     bool rtcp,
     DataChannelType channel_type) {
+  TRACE_EVENT0("webrtc", "ChannelManager::CreateDataChannel");
   return worker_thread_->Invoke<DataChannel*>(
       RTC_FROM_HERE,
-      Bind(&ChannelManager::CreateDataChannel_w, this, transport_controller,
-           content_name, bundle_transport_name, rtcp, channel_type));
+      Bind(&ChannelManager::CreateDataChannel_w, this, media_config,
+           transport_controller, content_name, bundle_transport_name, rtcp,
+           channel_type));
 }
 
 DataChannel* ChannelManager::CreateDataChannel_w(
+    const MediaConfig& media_config,
     TransportController* transport_controller,
     const std::string& content_name,
     const std::string* bundle_transport_name,
     bool rtcp,
     DataChannelType data_channel_type) {
+  TRACE_EVENT0("webrtc", "ChannelManager::CreateDataChannel_w");
   // This is ok to alloc from a thread other than the worker thread.
   ASSERT(initialized_);
   DataMediaChannel* media_channel = data_media_engine_->CreateChannel(
-      data_channel_type);
+      data_channel_type, media_config);
   if (!media_channel) {
     LOG(LS_WARNING) << "Failed to create data channel of type "
                     << data_channel_type;
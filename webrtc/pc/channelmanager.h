@@ -108,7 +108,8 @@ class ChannelManager {
       const VideoOptions& options);
   // Destroys a video channel created with the Create API.
   void DestroyVideoChannel(VideoChannel* video_channel);
-  DataChannel* CreateDataChannel(TransportController* transport_controller,
+  DataChannel* CreateDataChannel(const MediaConfig& media_config,
+                                 TransportController* transport_controller,
                                  const std::string& content_name,
                                  const std::string* bundle_transport_name,
                                  bool rtcp,
@@ -171,7 +172,8 @@ class ChannelManager {
       bool rtcp,
       const VideoOptions& options);
   void DestroyVideoChannel_w(VideoChannel* video_channel);
-  DataChannel* CreateDataChannel_w(TransportController* transport_controller,
+  DataChannel* CreateDataChannel_w(const MediaConfig& media_config,
+                                   TransportController* transport_controller,
                                    const std::string& content_name,
                                    const std::string* bundle_transport_name,
                                    bool rtcp,
@@ -107,8 +107,9 @@ TEST_F(ChannelManagerTest, CreateDestroyChannels) {
       VideoOptions());
   EXPECT_TRUE(video_channel != nullptr);
   cricket::DataChannel* data_channel =
-      cm_->CreateDataChannel(transport_controller_, cricket::CN_DATA, nullptr,
-                             false, cricket::DCT_RTP);
+      cm_->CreateDataChannel(cricket::MediaConfig(), transport_controller_,
+                             cricket::CN_DATA, nullptr, false,
+                             cricket::DCT_RTP);
   EXPECT_TRUE(data_channel != nullptr);
   cm_->DestroyVideoChannel(video_channel);
   cm_->DestroyVoiceChannel(voice_channel);
@@ -135,8 +136,9 @@ TEST_F(ChannelManagerTest, CreateDestroyChannelsOnThread) {
       VideoOptions());
   EXPECT_TRUE(video_channel != nullptr);
   cricket::DataChannel* data_channel =
-      cm_->CreateDataChannel(transport_controller_, cricket::CN_DATA, nullptr,
-                             false, cricket::DCT_RTP);
+      cm_->CreateDataChannel(cricket::MediaConfig(), transport_controller_,
+                             cricket::CN_DATA, nullptr, false,
+                             cricket::DCT_RTP);
   EXPECT_TRUE(data_channel != nullptr);
   cm_->DestroyVideoChannel(video_channel);
   cm_->DestroyVoiceChannel(voice_channel);
@@ -163,8 +165,9 @@ TEST_F(ChannelManagerTest, NoTransportChannelTest) {
       VideoOptions());
   EXPECT_TRUE(video_channel == nullptr);
   cricket::DataChannel* data_channel =
-      cm_->CreateDataChannel(transport_controller_, cricket::CN_DATA, nullptr,
-                             false, cricket::DCT_RTP);
+      cm_->CreateDataChannel(cricket::MediaConfig(), transport_controller_,
+                             cricket::CN_DATA, nullptr, false,
+                             cricket::DCT_RTP);
   EXPECT_TRUE(data_channel == nullptr);
   cm_->Terminate();
 }
@@ -1304,6 +1304,7 @@ void MediaSessionDescriptionFactory::set_audio_codecs(
   // expensive than decoding, and prioritizing a codec in the send list probably
   // means it's a codec we can handle efficiently.
   NegotiateCodecs(recv_codecs, send_codecs, &audio_sendrecv_codecs_);
+  offer_cache_.valid = false;
 }
 
 SessionDescription* MediaSessionDescriptionFactory::CreateOffer(
@@ -1319,22 +1320,21 @@ SessionDescription* MediaSessionDescriptionFactory::CreateOffer(
   const AudioCodecs& supported_audio_codecs =
       GetAudioCodecsForOffer({wants_send, options.recv_audio});
 
-  AudioCodecs audio_codecs;
-  VideoCodecs video_codecs;
-  DataCodecs data_codecs;
-  GetCodecsToOffer(current_description, supported_audio_codecs,
-                   video_codecs_, data_codecs_,
-                   &audio_codecs, &video_codecs, &data_codecs);
+  const OfferCache& to_offer = GetCachedCodecsAndRtpHdrExtsToOffer(
+      current_description, supported_audio_codecs);
+  AudioCodecs audio_codecs = to_offer.audio_codecs;
+  const VideoCodecs& video_codecs = to_offer.video_codecs;
+  DataCodecs data_codecs = to_offer.data_codecs;
 
   if (!options.vad_enabled) {
     // If application doesn't want CN codecs in offer.
     StripCNCodecs(&audio_codecs);
   }
 
-  RtpHeaderExtensions audio_rtp_extensions;
-  RtpHeaderExtensions video_rtp_extensions;
-  GetRtpHdrExtsToOffer(current_description, &audio_rtp_extensions,
-                       &video_rtp_extensions);
+  const RtpHeaderExtensions& audio_rtp_extensions =
+      to_offer.audio_rtp_extensions;
+  const RtpHeaderExtensions& video_rtp_extensions =
+      to_offer.video_rtp_extensions;
 
   bool audio_added = false;
   bool video_added = false;
@@ -1601,6 +1601,62 @@ void MediaSessionDescriptionFactory::GetRtpHdrExtsToOffer(
                         &all_extensions, &used_ids);
 }
 
+const MediaSessionDescriptionFactory::OfferCache&
+MediaSessionDescriptionFactory::GetCachedCodecsAndRtpHdrExtsToOffer(
+    const SessionDescription* current_description,
+    const AudioCodecs& supported_audio_codecs) const {
+  const AudioContentDescription* audio = NULL;
+  const VideoContentDescription* video = NULL;
+  const DataContentDescription* data = NULL;
+  if (current_description) {
+    audio = GetFirstAudioContentDescription(current_description);
+    video = GetFirstVideoContentDescription(current_description);
+    data = GetFirstDataContentDescription(current_description);
+  }
+  // A missing content contributes nothing, the same as an empty one.
+  const AudioCodecs kNoAudioCodecs;
+  const VideoCodecs kNoVideoCodecs;
+  const DataCodecs kNoDataCodecs;
+  const RtpHeaderExtensions kNoRtpExtensions;
+  const AudioCodecs& current_audio_codecs =
+      audio ? audio->codecs() : kNoAudioCodecs;
+  const VideoCodecs& current_video_codecs =
+      video ? video->codecs() : kNoVideoCodecs;
+  const DataCodecs& current_data_codecs =
+      data ? data->codecs() : kNoDataCodecs;
+  const RtpHeaderExtensions& current_audio_rtp_extensions =
+      audio ? audio->rtp_header_extensions() : kNoRtpExtensions;
+  const RtpHeaderExtensions& current_video_rtp_extensions =
+      video ? video->rtp_header_extensions() : kNoRtpExtensions;
+
+  if (offer_cache_.valid &&
+      offer_cache_.supported_audio_codecs == &supported_audio_codecs &&
+      offer_cache_.current_audio_codecs == current_audio_codecs &&
+      offer_cache_.current_video_codecs == current_video_codecs &&
+      offer_cache_.current_data_codecs == current_data_codecs &&
+      offer_cache_.current_audio_rtp_extensions ==
+          current_audio_rtp_extensions &&
+      offer_cache_.current_video_rtp_extensions ==
+          current_video_rtp_extensions) {
+    return offer_cache_;
+  }
+
+  GetCodecsToOffer(current_description, supported_audio_codecs, video_codecs_,
+                   data_codecs_, &offer_cache_.audio_codecs,
+                   &offer_cache_.video_codecs, &offer_cache_.data_codecs);
+  GetRtpHdrExtsToOffer(current_description,
+                       &offer_cache_.audio_rtp_extensions,
+                       &offer_cache_.video_rtp_extensions);
+  offer_cache_.supported_audio_codecs = &supported_audio_codecs;
+  offer_cache_.current_audio_codecs = current_audio_codecs;
+  offer_cache_.current_video_codecs = current_video_codecs;
+  offer_cache_.current_data_codecs = current_data_codecs;
+  offer_cache_.current_audio_rtp_extensions = current_audio_rtp_extensions;
+  offer_cache_.current_video_rtp_extensions = current_video_rtp_extensions;
+  offer_cache_.valid = true;
+  return offer_cache_;
+}
+
 bool MediaSessionDescriptionFactory::AddTransportOffer(
   const std::string& content_name,
   const TransportOptions& transport_options,
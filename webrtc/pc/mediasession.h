@@ -437,20 +437,28 @@ class MediaSessionDescriptionFactory {
                         const AudioCodecs& recv_codecs);
   void set_audio_rtp_header_extensions(const RtpHeaderExtensions& extensions) {
     audio_rtp_extensions_ = extensions;
+    offer_cache_.valid = false;
   }
   const RtpHeaderExtensions& audio_rtp_header_extensions() const {
     return audio_rtp_extensions_;
   }
   const VideoCodecs& video_codecs() const { return video_codecs_; }
-  void set_video_codecs(const VideoCodecs& codecs) { video_codecs_ = codecs; }
+  void set_video_codecs(const VideoCodecs& codecs) {
+    video_codecs_ = codecs;
+    offer_cache_.valid = false;
+  }
   void set_video_rtp_header_extensions(const RtpHeaderExtensions& extensions) {
     video_rtp_extensions_ = extensions;
+    offer_cache_.valid = false;
   }
   const RtpHeaderExtensions& video_rtp_header_extensions() const {
     return video_rtp_extensions_;
   }
   const DataCodecs& data_codecs() const { return data_codecs_; }
-  void set_data_codecs(const DataCodecs& codecs) { data_codecs_ = codecs; }
+  void set_data_codecs(const DataCodecs& codecs) {
+    data_codecs_ = codecs;
+    offer_cache_.valid = false;
+  }
   SecurePolicy secure() const { return secure_; }
   void set_secure(SecurePolicy s) { secure_ = s; }
   // Decides if a StreamParams shall be added to the audio and video media
@@ -459,6 +467,9 @@ class MediaSessionDescriptionFactory {
   // applications. |add_legacy_| is true per default.
   void set_add_legacy_streams(bool add_legacy) { add_legacy_ = add_legacy; }
 
+  // CreateOffer() reuses the codecs and RTP header extensions of the previous
+  // offer when neither they nor the configuration above changed, so it must
+  // not be called concurrently on the same factory.
   SessionDescription* CreateOffer(
       const MediaSessionOptions& options,
       const SessionDescription* current_description) const;
@@ -468,6 +479,26 @@ class MediaSessionDescriptionFactory {
         const SessionDescription* current_description) const;
 
  private:
+  // The codecs and RTP header extensions to offer, along with what they were
+  // derived from: the audio codecs supported for the offer's direction and
+  // the codecs and extensions of the first audio, video and data contents of
+  // the current description.
+  struct OfferCache {
+    bool valid = false;
+    const AudioCodecs* supported_audio_codecs = nullptr;
+    AudioCodecs current_audio_codecs;
+    VideoCodecs current_video_codecs;
+    DataCodecs current_data_codecs;
+    RtpHeaderExtensions current_audio_rtp_extensions;
+    RtpHeaderExtensions current_video_rtp_extensions;
+
+    AudioCodecs audio_codecs;
+    VideoCodecs video_codecs;
+    DataCodecs data_codecs;
+    RtpHeaderExtensions audio_rtp_extensions;
+    RtpHeaderExtensions video_rtp_extensions;
+  };
+
   const AudioCodecs& GetAudioCodecsForOffer(
       const RtpTransceiverDirection& direction) const;
   const AudioCodecs& GetAudioCodecsForAnswer(
@@ -483,6 +514,13 @@ class MediaSessionDescriptionFactory {
   void GetRtpHdrExtsToOffer(const SessionDescription* current_description,
                             RtpHeaderExtensions* audio_extensions,
                             RtpHeaderExtensions* video_extensions) const;
+  // Returns |offer_cache_|, updated with GetCodecsToOffer() and
+  // GetRtpHdrExtsToOffer() unless it already holds their result for these
+  // arguments. A renegotiation or ICE restart of an unchanged session then
+  // only compares the codec lists instead of merging them again.
+  const OfferCache& GetCachedCodecsAndRtpHdrExtsToOffer(
+      const SessionDescription* current_description,
+      const AudioCodecs& supported_audio_codecs) const;
   bool AddTransportOffer(
       const std::string& content_name,
       const TransportOptions& transport_options,
@@ -559,6 +597,8 @@ class MediaSessionDescriptionFactory {
   bool add_legacy_;
   std::string lang_;
   const TransportDescriptionFactory* transport_desc_factory_;
+  // Invalidated by the setters above.
+  mutable OfferCache offer_cache_;
 };
 
 // Convenience functions.
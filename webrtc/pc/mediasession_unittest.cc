@@ -14,8 +14,10 @@
 
 #include "webrtc/base/fakesslidentity.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/messagedigest.h"
 #include "webrtc/base/ssladapter.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/media/base/codec.h"
 #include "webrtc/media/base/testutils.h"
 #include "webrtc/p2p/base/p2pconstants.h"
@@ -2113,6 +2115,103 @@ TEST_F(MediaSessionDescriptionFactoryTest, RtpExtensionIdReused) {
                 updated_offer.get())->rtp_header_extensions());
 }
 
+// Test that updated offers pick up the configuration of the factory when it
+// changes between offers.
+TEST_F(MediaSessionDescriptionFactoryTest,
+       UpdatedOfferReflectsChangedConfiguration) {
+  MediaSessionOptions opts;
+  opts.recv_video = true;
+  std::unique_ptr<SessionDescription> offer(f1_.CreateOffer(opts, NULL));
+  ASSERT_TRUE(offer.get() != NULL);
+
+  // Renegotiating the same description offers the same codecs.
+  std::unique_ptr<SessionDescription> updated_offer(
+      f1_.CreateOffer(opts, offer.get()));
+  ASSERT_TRUE(updated_offer.get() != NULL);
+  EXPECT_EQ(GetFirstAudioContentDescription(offer.get())->codecs(),
+            GetFirstAudioContentDescription(updated_offer.get())->codecs());
+  EXPECT_EQ(GetFirstVideoContentDescription(offer.get())->codecs(),
+            GetFirstVideoContentDescription(updated_offer.get())->codecs());
+
+  f1_.set_video_codecs(MAKE_VECTOR(kVideoCodecs2));
+  f1_.set_audio_rtp_header_extensions(MAKE_VECTOR(kAudioRtpExtension1));
+  updated_offer.reset(f1_.CreateOffer(opts, offer.get()));
+  ASSERT_TRUE(updated_offer.get() != NULL);
+  // The codecs of the current description are kept and the new H263 codec is
+  // added after them.
+  const VideoCodec kExpectedVideoCodecs[] = {
+      kVideoCodecs1[0], kVideoCodecs1[1], kVideoCodecs2[1],
+  };
+  EXPECT_EQ(MAKE_VECTOR(kExpectedVideoCodecs),
+            GetFirstVideoContentDescription(updated_offer.get())->codecs());
+  EXPECT_EQ(MAKE_VECTOR(kAudioRtpExtension1),
+            GetFirstAudioContentDescription(
+                updated_offer.get())->rtp_header_extensions());
+
+  offer.reset(f1_.CreateOffer(opts, NULL));
+  ASSERT_TRUE(offer.get() != NULL);
+  EXPECT_EQ(MAKE_VECTOR(kVideoCodecs2),
+            GetFirstVideoContentDescription(offer.get())->codecs());
+}
+
+// Measures how many initial and updated offers with audio, video and RTP data
+// can be created per second, with codec lists the size of the built-in media
+// engines'.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(MediaSessionDescriptionFactoryTest, DISABLED_OffersPerSecond) {
+  const int kNumOffers = 10000;
+  const AudioCodec kAudioCodecs[] = {
+      AudioCodec(111, "opus", 48000, 0, 2),
+      AudioCodec(103, "ISAC", 16000, 0, 1),
+      AudioCodec(104, "ISAC", 32000, 0, 1),
+      AudioCodec(9, "G722", 8000, 0, 1),
+      AudioCodec(102, "ILBC", 8000, 0, 1),
+      AudioCodec(0, "PCMU", 8000, 0, 1),
+      AudioCodec(8, "PCMA", 8000, 0, 1),
+      AudioCodec(106, "CN", 32000, 0, 1),
+      AudioCodec(105, "CN", 16000, 0, 1),
+      AudioCodec(13, "CN", 8000, 0, 1),
+      AudioCodec(126, "telephone-event", 8000, 0, 1)};
+  const VideoCodec kVideoCodecs[] = {
+      VideoCodec(100, "VP8", 640, 480, 30),
+      VideoCodec::CreateRtxCodec(96, 100),
+      VideoCodec(101, "VP9", 640, 480, 30),
+      VideoCodec::CreateRtxCodec(97, 101),
+      VideoCodec(107, "H264", 640, 480, 30),
+      VideoCodec::CreateRtxCodec(99, 107),
+      VideoCodec(116, "red", 640, 480, 30),
+      VideoCodec::CreateRtxCodec(98, 116),
+      VideoCodec(117, "ulpfec", 640, 480, 30)};
+  f1_.set_audio_codecs(MAKE_VECTOR(kAudioCodecs), MAKE_VECTOR(kAudioCodecs));
+  f1_.set_video_codecs(MAKE_VECTOR(kVideoCodecs));
+  MediaSessionOptions opts;
+  opts.recv_video = true;
+  opts.data_channel_type = cricket::DCT_RTP;
+  opts.bundle_enabled = true;
+  opts.AddSendStream(MEDIA_TYPE_AUDIO, kAudioTrack1, kMediaStream1);
+  opts.AddSendStream(MEDIA_TYPE_VIDEO, kVideoTrack1, kMediaStream1);
+  opts.AddSendStream(MEDIA_TYPE_DATA, kDataTrack1, kMediaStream1);
+  f1_.set_secure(SEC_ENABLED);
+  f1_.set_audio_rtp_header_extensions(MAKE_VECTOR(kAudioRtpExtension1));
+  f1_.set_video_rtp_header_extensions(MAKE_VECTOR(kVideoRtpExtension1));
+
+  int64_t start = rtc::TimeMicros();
+  for (int i = 0; i < kNumOffers; ++i)
+    delete f1_.CreateOffer(opts, NULL);
+  int64_t initial_us = rtc::TimeMicros() - start;
+
+  std::unique_ptr<SessionDescription> offer(f1_.CreateOffer(opts, NULL));
+  ASSERT_TRUE(offer.get() != NULL);
+  start = rtc::TimeMicros();
+  for (int i = 0; i < kNumOffers; ++i)
+    delete f1_.CreateOffer(opts, offer.get());
+  int64_t updated_us = rtc::TimeMicros() - start;
+
+  LOG(LS_INFO) << "Initial offers: " << kNumOffers * 1e6 / initial_us
+               << "/s, updated offers: " << kNumOffers * 1e6 / updated_us
+               << "/s";
+}
+
 TEST(MediaSessionDescription, CopySessionDescription) {
   SessionDescription source;
   cricket::ContentGroup group(cricket::CN_AUDIO);
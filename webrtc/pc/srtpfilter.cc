@@ -231,6 +231,24 @@ bool SrtpFilter::UnprotectRtp(void* p, int in_len, int* out_len) {
   return recv_session_->UnprotectRtp(p, in_len, out_len);
 }
 
+bool SrtpFilter::ProtectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to ProtectRtp: SRTP not active";
+    return false;
+  }
+  RTC_CHECK(send_session_);
+  return send_session_->ProtectRtp(packets);
+}
+
+bool SrtpFilter::UnprotectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to UnprotectRtp: SRTP not active";
+    return false;
+  }
+  RTC_CHECK(recv_session_);
+  return recv_session_->UnprotectRtp(packets);
+}
+
 bool SrtpFilter::UnprotectRtcp(void* p, int in_len, int* out_len) {
   if (!IsActive()) {
     LOG(LS_WARNING) << "Failed to UnprotectRtcp: SRTP not active";
@@ -619,6 +637,48 @@ bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+bool SrtpSession::ProtectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    return false;
+  }
+
+  bool all_protected = true;
+  for (rtc::CopyOnWriteBuffer& packet : *packets) {
+    int len = static_cast<int>(packet.size());
+    packet.EnsureCapacity(packet.size() + rtp_auth_tag_len_);
+    if (!ProtectRtp(packet.data(), len, static_cast<int>(packet.capacity()),
+                    &len)) {
+      packet.Clear();
+      all_protected = false;
+      continue;
+    }
+    packet.SetSize(len);
+  }
+  return all_protected;
+}
+
+bool SrtpSession::UnprotectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    return false;
+  }
+
+  bool all_unprotected = true;
+  for (rtc::CopyOnWriteBuffer& packet : *packets) {
+    int len = static_cast<int>(packet.size());
+    if (!UnprotectRtp(packet.data(), len, &len)) {
+      packet.Clear();
+      all_unprotected = false;
+      continue;
+    }
+    packet.SetSize(len);
+  }
+  return all_unprotected;
+}
+
 bool SrtpSession::GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len) {
 #if defined(ENABLE_EXTERNAL_AUTH)
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
@@ -857,6 +917,14 @@ bool SrtpSession::UnprotectRtcp(void* data, int in_len, int* out_len) {
   return SrtpNotAvailable(__FUNCTION__);
 }
 
+bool SrtpSession::ProtectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
+bool SrtpSession::UnprotectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
 void SrtpSession::set_signal_silent_time(uint32_t signal_silent_time) {
   // Do nothing.
 }
@@ -19,6 +19,7 @@
 
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/sigslotrepeater.h"
 #include "webrtc/base/sslstreamadapter.h"
@@ -110,6 +111,10 @@ class SrtpFilter {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Batch versions of ProtectRtp/UnprotectRtp, see SrtpSession.
+  bool ProtectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets);
+  bool UnprotectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets);
+
   // Returns rtp auth params from srtp context.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
@@ -200,6 +205,14 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Encrypts/signs a batch of RTP packets, in-place, growing each buffer as
+  // needed to make room for the auth tag. Packets that fail to be protected
+  // are cleared. Returns false if any packet failed.
+  bool ProtectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets);
+  // Decrypts/verifies a batch of RTP packets, in-place. Packets that fail to
+  // be unprotected are cleared. Returns false if any packet failed.
+  bool UnprotectRtp(std::vector<rtc::CopyOnWriteBuffer>* packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
@@ -11,7 +11,9 @@
 #include "webrtc/base/byteorder.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/gunit.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/thread.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/media/base/cryptoparams.h"
 #include "webrtc/media/base/fakertp.h"
 #include "webrtc/p2p/base/sessiondescription.h"
@@ -776,6 +778,106 @@ TEST_F(SrtpSessionTest, TestReplay) {
                              &out_len));
 }
 
+// Builds |count| RTP packets with consecutive sequence numbers and
+// |payload_len| bytes of payload.
+static std::vector<rtc::CopyOnWriteBuffer> MakeRtpPackets(size_t count,
+                                                          size_t payload_len) {
+  static const size_t kRtpHeaderLen = 12;
+  std::vector<rtc::CopyOnWriteBuffer> packets;
+  for (size_t i = 0; i < count; ++i) {
+    rtc::CopyOnWriteBuffer packet(kPcmuFrame, kRtpHeaderLen,
+                                  kRtpHeaderLen + payload_len + 16);
+    packet.SetSize(kRtpHeaderLen + payload_len);
+    memset(packet.data() + kRtpHeaderLen, static_cast<uint8_t>(i), payload_len);
+    rtc::SetBE16(packet.data() + 2, static_cast<uint16_t>(i + 1));
+    packets.push_back(packet);
+  }
+  return packets;
+}
+
+TEST_F(SrtpSessionTest, TestProtectUnprotectBatch) {
+  EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  EXPECT_TRUE(s2_.SetRecv(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  const std::vector<rtc::CopyOnWriteBuffer> original = MakeRtpPackets(8, 160);
+  std::vector<rtc::CopyOnWriteBuffer> packets = original;
+
+  EXPECT_TRUE(s1_.ProtectRtp(&packets));
+  for (size_t i = 0; i < packets.size(); ++i) {
+    EXPECT_EQ(original[i].size() + 10, packets[i].size());
+    // Protecting must not touch buffers shared with |original|.
+    EXPECT_NE(original[i], packets[i]);
+  }
+
+  EXPECT_TRUE(s2_.UnprotectRtp(&packets));
+  EXPECT_EQ(original, packets);
+}
+
+// Test that a packet failing to unprotect in a batch is cleared and does not
+// prevent the others from being unprotected.
+TEST_F(SrtpSessionTest, TestUnprotectBatchWithTamperedPacket) {
+  EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  EXPECT_TRUE(s2_.SetRecv(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  const std::vector<rtc::CopyOnWriteBuffer> original = MakeRtpPackets(3, 160);
+  std::vector<rtc::CopyOnWriteBuffer> packets = original;
+  EXPECT_TRUE(s1_.ProtectRtp(&packets));
+  packets[1].data()[20] ^= 0xff;
+
+  EXPECT_FALSE(s2_.UnprotectRtp(&packets));
+  EXPECT_EQ(original[0], packets[0]);
+  EXPECT_EQ(0u, packets[1].size());
+  EXPECT_EQ(original[2], packets[2]);
+}
+
+// Measures protect and unprotect throughput for batches of video sized
+// packets with the given cipher suite.
+static void MeasureSrtpThroughput(int cs, const std::string& name) {
+  static const size_t kBatchSize = 32;
+  static const size_t kPayloadLen = 1200;
+  static const int kRounds = 2000;
+  int key_len;
+  int salt_len;
+  ASSERT_TRUE(rtc::GetSrtpKeyAndSaltLengths(cs, &key_len, &salt_len));
+  // Long enough for any cipher suite.
+  static const uint8_t kKey[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghij";
+  ASSERT_LE(static_cast<size_t>(key_len + salt_len), sizeof(kKey));
+
+  cricket::SrtpSession sender;
+  cricket::SrtpSession receiver;
+  ASSERT_TRUE(sender.SetSend(cs, kKey, key_len + salt_len));
+  ASSERT_TRUE(receiver.SetRecv(cs, kKey, key_len + salt_len));
+
+  int64_t protect_us = 0;
+  int64_t unprotect_us = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    std::vector<rtc::CopyOnWriteBuffer> packets =
+        MakeRtpPackets(kBatchSize, kPayloadLen);
+    // Keep sequence numbers increasing across rounds for the replay check.
+    for (size_t i = 0; i < packets.size(); ++i) {
+      rtc::SetBE16(packets[i].data() + 2,
+                   static_cast<uint16_t>(round * kBatchSize + i + 1));
+    }
+    int64_t start = rtc::TimeMicros();
+    ASSERT_TRUE(sender.ProtectRtp(&packets));
+    int64_t protected_at = rtc::TimeMicros();
+    ASSERT_TRUE(receiver.UnprotectRtp(&packets));
+    unprotect_us += rtc::TimeMicros() - protected_at;
+    protect_us += protected_at - start;
+  }
+  const double megabits = 8.0 * kRounds * kBatchSize * kPayloadLen / 1e6;
+  LOG(LS_INFO) << name << ": protect " << megabits * 1e6 / protect_us
+               << " Mbps, unprotect " << megabits * 1e6 / unprotect_us
+               << " Mbps";
+}
+
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST(SrtpThroughputTest, DISABLED_Throughput) {
+  MeasureSrtpThroughput(rtc::SRTP_AES128_CM_SHA1_80, CS_AES_CM_128_HMAC_SHA1_80);
+#if !defined(ENABLE_EXTERNAL_AUTH)
+  MeasureSrtpThroughput(rtc::SRTP_AEAD_AES_128_GCM, CS_AEAD_AES_128_GCM);
+  MeasureSrtpThroughput(rtc::SRTP_AEAD_AES_256_GCM, CS_AEAD_AES_256_GCM);
+#endif
+}
+
 class SrtpStatTest
     : public testing::Test,
       public sigslot::has_slots<> {
@@ -10,6 +10,12 @@
 
 #include "webrtc/api/stats/rtcstats.h"
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cmath>
+
 #include "webrtc/base/stringencode.h"
 
 namespace webrtc {
@@ -46,8 +52,113 @@ std::string VectorOfStringsToString(const std::vector<T>& strings) {
   return oss.str();
 }
 
+// The JSON writers append to |json| directly, without going through streams
+// or temporary strings.
+void AppendJsonString(const char* value, size_t length, std::string* json) {
+  json->push_back('"');
+  for (const char* c = value; c != value + length; ++c) {
+    switch (*c) {
+      case '"':
+        json->append("\\\"");
+        break;
+      case '\\':
+        json->append("\\\\");
+        break;
+      case '\n':
+        json->append("\\n");
+        break;
+      case '\r':
+        json->append("\\r");
+        break;
+      case '\t':
+        json->append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char escaped[7];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+          json->append(escaped);
+        } else {
+          json->push_back(*c);
+        }
+        break;
+    }
+  }
+  json->push_back('"');
+}
+
+void AppendJsonValue(const char* value, std::string* json) {
+  AppendJsonString(value, strlen(value), json);
+}
+
+void AppendJsonValue(const std::string& value, std::string* json) {
+  AppendJsonString(value.data(), value.size(), json);
+}
+
+template<typename T>
+void AppendJsonNumber(const char* format, T value, std::string* json) {
+  char buffer[32];
+  int length = snprintf(buffer, sizeof(buffer), format, value);
+  RTC_DCHECK(length > 0 && length < static_cast<int>(sizeof(buffer)));
+  json->append(buffer, length);
+}
+
+void AppendJsonValue(int32_t value, std::string* json) {
+  AppendJsonNumber("%" PRId32, value, json);
+}
+
+void AppendJsonValue(uint32_t value, std::string* json) {
+  AppendJsonNumber("%" PRIu32, value, json);
+}
+
+void AppendJsonValue(int64_t value, std::string* json) {
+  AppendJsonNumber("%" PRId64, value, json);
+}
+
+void AppendJsonValue(uint64_t value, std::string* json) {
+  AppendJsonNumber("%" PRIu64, value, json);
+}
+
+void AppendJsonValue(double value, std::string* json) {
+  // JSON has no representation of NaN or infinity.
+  if (!std::isfinite(value)) {
+    json->append("null");
+    return;
+  }
+  // Enough digits for the value to survive the round trip.
+  AppendJsonNumber("%.17g", value, json);
+}
+
+template<typename T>
+void AppendJsonValue(const std::vector<T>& values, std::string* json) {
+  json->push_back('[');
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i > 0)
+      json->push_back(',');
+    AppendJsonValue(values[i], json);
+  }
+  json->push_back(']');
+}
+
 }  // namespace
 
+bool RTCStats::operator==(const RTCStats& other) const {
+  if (type() != other.type() || id() != other.id())
+    return false;
+  std::vector<const RTCStatsMemberInterface*> members = Members();
+  std::vector<const RTCStatsMemberInterface*> other_members = other.Members();
+  RTC_DCHECK_EQ(members.size(), other_members.size());
+  for (size_t i = 0; i < members.size(); ++i) {
+    if (*members[i] != *other_members[i])
+      return false;
+  }
+  return true;
+}
+
+bool RTCStats::operator!=(const RTCStats& other) const {
+  return !(*this == other);
+}
+
 std::string RTCStats::ToString() const {
   std::ostringstream oss;
   oss << type() << " {\n  id: \"" << id_ << "\"\n  timestamp: "
@@ -67,6 +178,30 @@ std::string RTCStats::ToString() const {
   return oss.str();
 }
 
+std::string RTCStats::ToJson() const {
+  std::string json;
+  AppendJson(&json);
+  return json;
+}
+
+void RTCStats::AppendJson(std::string* json) const {
+  json->append("{\"type\":");
+  AppendJsonValue(type(), json);
+  json->append(",\"id\":");
+  AppendJsonValue(id_, json);
+  json->append(",\"timestamp\":");
+  AppendJsonValue(timestamp_us_, json);
+  for (const RTCStatsMemberInterface* member : Members()) {
+    if (!member->is_defined())
+      continue;
+    json->push_back(',');
+    AppendJsonValue(member->name(), json);
+    json->push_back(':');
+    member->AppendValueJson(json);
+  }
+  json->push_back('}');
+}
+
 std::vector<const RTCStatsMemberInterface*> RTCStats::Members() const {
   return MembersOfThisObjectAndAncestors(0);
 }
@@ -91,6 +226,11 @@ RTCStats::MembersOfThisObjectAndAncestors(
   std::string RTCStatsMember<T>::ValueToString() const {                       \
     RTC_DCHECK(is_defined_);                                                   \
     return to_str;                                                             \
+  }                                                                            \
+  template<>                                                                   \
+  void RTCStatsMember<T>::AppendValueJson(std::string* json) const {           \
+    RTC_DCHECK(is_defined_);                                                   \
+    AppendJsonValue(value_, json);                                             \
   }
 
 WEBRTC_DEFINE_RTCSTATSMEMBER(int32_t, kInt32, false, false,
@@ -10,6 +10,7 @@
 
 #include "webrtc/api/stats/rtcstats.h"
 
+#include <cmath>
 #include <cstring>
 
 #include "webrtc/base/checks.h"
@@ -123,6 +124,64 @@ TEST(RTCStatsTest, RTCStatsGrandChild) {
   EXPECT_EQ(*copy.grandchild_int, *stats.grandchild_int);
 }
 
+TEST(RTCStatsTest, EqualityOperator) {
+  RTCTestStats empty_stats("testId", 123);
+  EXPECT_EQ(empty_stats, empty_stats);
+
+  RTCTestStats stats_with_all_values("testId", 123);
+  stats_with_all_values.m_int32 = 123;
+  stats_with_all_values.m_string = std::string("123");
+  stats_with_all_values.m_sequence_double = std::vector<double>(2, 4.0);
+  EXPECT_NE(empty_stats, stats_with_all_values);
+
+  // The timestamp isn't compared.
+  RTCTestStats later_stats("testId", 456);
+  later_stats.m_int32 = 123;
+  later_stats.m_string = std::string("123");
+  later_stats.m_sequence_double = std::vector<double>(2, 4.0);
+  EXPECT_EQ(stats_with_all_values, later_stats);
+
+  later_stats.m_sequence_double->push_back(4.0);
+  EXPECT_NE(stats_with_all_values, later_stats);
+  RTCTestStats other_id("otherId", 123);
+  EXPECT_NE(empty_stats, other_id);
+  RTCChildStats other_type("testId", 123);
+  EXPECT_NE(empty_stats, other_type);
+}
+
+TEST(RTCStatsTest, ToJson) {
+  RTCTestStats stats("test\"Id", 42);
+  EXPECT_EQ("{\"type\":\"test-stats\",\"id\":\"test\\\"Id\",\"timestamp\":42}",
+            stats.ToJson());
+
+  stats.m_int32 = -1;
+  stats.m_uint64 = 18446744073709551615ull;
+  stats.m_double = 0.5;
+  stats.m_string = std::string("a\\b\n\x01");
+  stats.m_sequence_int32 = std::vector<int32_t>();
+  std::vector<double> sequence_double;
+  sequence_double.push_back(1.0);
+  sequence_double.push_back(std::nan(""));
+  stats.m_sequence_double = sequence_double;
+  std::vector<std::string> sequence_string;
+  sequence_string.push_back("one");
+  sequence_string.push_back("two");
+  stats.m_sequence_string = sequence_string;
+  EXPECT_EQ(
+      "{\"type\":\"test-stats\",\"id\":\"test\\\"Id\",\"timestamp\":42,"
+      "\"mInt32\":-1,\"mUint64\":18446744073709551615,\"mDouble\":0.5,"
+      "\"mString\":\"a\\\\b\\n\\u0001\",\"mSequenceInt32\":[],"
+      "\"mSequenceDouble\":[1,null],\"mSequenceString\":[\"one\",\"two\"]}",
+      stats.ToJson());
+
+  // AppendJson() leaves what is already in the string alone.
+  std::string json = "[";
+  RTCChildStats child("child", 1);
+  child.AppendJson(&json);
+  EXPECT_EQ("[{\"type\":\"child-stats\",\"id\":\"child\",\"timestamp\":1}",
+            json);
+}
+
 // Death tests.
 // Disabled on Android because death tests misbehave on Android, see
 // base/test/gtest_util.h.
@@ -92,4 +92,19 @@ RTCStatsReport::ConstIterator RTCStatsReport::end() const {
                        stats_.cend());
 }
 
+std::string RTCStatsReport::ToJson() const {
+  std::string json;
+  // A rough guess that avoids most reallocations for typical reports.
+  json.reserve(stats_.size() * 256);
+  json += '[';
+  for (StatsMap::const_iterator it = stats_.begin(); it != stats_.end();
+       ++it) {
+    if (it != stats_.begin())
+      json += ',';
+    it->second->AppendJson(&json);
+  }
+  json += ']';
+  return json;
+}
+
 }  // namespace webrtc
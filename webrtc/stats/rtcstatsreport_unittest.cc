@@ -128,4 +128,18 @@ TEST(RTCStatsReport, TakeMembersFrom) {
   EXPECT_EQ(i, static_cast<int64_t>(6));
 }
 
+TEST(RTCStatsReport, ToJson) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create();
+  EXPECT_EQ("[]", report->ToJson());
+
+  std::unique_ptr<RTCTestStats1> a(new RTCTestStats1("A", 0));
+  a->integer = 1;
+  report->AddStats(std::move(a));
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats2("B", 1)));
+  EXPECT_EQ("[{\"type\":\"test-stats-1\",\"id\":\"A\",\"timestamp\":0,"
+            "\"integer\":1},"
+            "{\"type\":\"test-stats-2\",\"id\":\"B\",\"timestamp\":1}]",
+            report->ToJson());
+}
+
 }  // namespace webrtc
@@ -62,6 +62,27 @@ namespace field_trial {
 // Note: To keep things tidy append all the trial names with WebRTC.
 std::string FindFullName(const std::string& name);
 
+// Looks up the group of a trial once, for code that checks the trial often,
+// e.g. per packet or frame. Make it a member of the object that uses the trial
+// rather than a static: trials don't change while webrtc is running, but tests
+// change them between test cases.
+class FieldTrialGroup {
+ public:
+  explicit FieldTrialGroup(const std::string& trial)
+      : group_(FindFullName(trial)) {}
+
+  // The group name, or the empty string if the trial does not exist.
+  const std::string& name() const { return group_; }
+
+  // Whether the group name starts with "Enabled" or "Disabled", like the
+  // groups of most trials do, e.g. "Enabled-30".
+  bool IsEnabled() const { return group_.compare(0, 7, "Enabled") == 0; }
+  bool IsDisabled() const { return group_.compare(0, 8, "Disabled") == 0; }
+
+ private:
+  const std::string group_;
+};
+
 }  // namespace field_trial
 }  // namespace webrtc
 
@@ -18,6 +18,8 @@ namespace field_trial {
 // This method can be called at most once before any other call into webrtc.
 // E.g. before the peer connection factory is constructed.
 // Note: trials_string must never be destroyed.
+// The string is parsed when this is called, so it must not be called while
+// other threads may look up field trials.
 void InitFieldTrialsFromString(const char* trials_string);
 
 const char* GetFieldTrialString();
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_SYSTEM_WRAPPERS_INCLUDE_HUGE_PAGE_MALLOC_H_
+#define WEBRTC_SYSTEM_WRAPPERS_INCLUDE_HUGE_PAGE_MALLOC_H_
+
+// Allocation of the pixel data of large video and desktop frames. A 4K frame
+// spans thousands of 4 KB pages, which are faulted in one by one when the
+// frame is first written, and which miss the TLB while the frame is scaled or
+// encoded. Backed by 2 MB huge pages, the frame only spans a few.
+//
+// Huge pages are off by default, and the memory then comes from
+// AlignedMalloc().
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+namespace webrtc {
+
+enum class HugePageMode {
+  kOff,
+  // Blocks of at least kHugePageSize are mapped on their own, and the kernel
+  // is asked to back them with transparent huge pages.
+  kTransparent,
+  // Blocks of at least kHugePageSize are mapped from the reserved huge page
+  // pool (MAP_HUGETLB), and from transparent huge pages when it is exhausted.
+  kExplicit,
+};
+
+const size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Sets the mode for the blocks allocated after the call. Huge pages are only
+// supported on Linux; elsewhere the mode has no effect. Thread safe.
+void SetHugePageMode(HugePageMode mode);
+HugePageMode GetHugePageMode();
+
+// Frees blocks allocated by HugePageMalloc(). Remembers how the block was
+// allocated, so it must be moved along with the block.
+class HugePageFreeDeleter {
+ public:
+  HugePageFreeDeleter() {}
+  explicit HugePageFreeDeleter(size_t mapped_size)
+      : mapped_size_(mapped_size) {}
+
+  void operator()(void* ptr) const;
+
+  // The size of the block's mapping, or 0 if it is from AlignedMalloc().
+  size_t mapped_size() const { return mapped_size_; }
+
+ private:
+  size_t mapped_size_ = 0;
+};
+
+typedef std::unique_ptr<uint8_t, HugePageFreeDeleter> HugePageBuffer;
+
+// Allocates |size| bytes aligned on an |alignment| boundary, which must be a
+// power of two. Blocks mapped for huge pages are aligned on kHugePageSize.
+// Like new[], returns a block even if |size| is zero. Returns null on failure.
+HugePageBuffer HugePageMalloc(size_t size, size_t alignment);
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_SYSTEM_WRAPPERS_INCLUDE_HUGE_PAGE_MALLOC_H_
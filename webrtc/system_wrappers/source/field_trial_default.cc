@@ -11,22 +11,25 @@
 #include "webrtc/system_wrappers/include/field_trial_default.h"
 
 #include <string>
+#include <unordered_map>
 
 // Simple field trial implementation, which allows client to
 // specify desired flags in InitFieldTrialsFromString.
 namespace webrtc {
 namespace field_trial {
 
-static const char *trials_init_string = NULL;
+namespace {
 
-std::string FindFullName(const std::string& name) {
+typedef std::unordered_map<std::string, std::string> TrialMap;
+
+// Splits a field trial configuration string into its name/value pairs. If a
+// trial is listed more than once, the first group wins.
+TrialMap* ParseTrials(const char* trials_init_string) {
+  TrialMap* trials = new TrialMap();
   if (trials_init_string == NULL)
-    return std::string();
+    return trials;
 
   std::string trials_string(trials_init_string);
-  if (trials_string.empty())
-    return std::string();
-
   static const char kPersistentStringSeparator = '/';
   size_t next_item = 0;
   while (next_item < trials_string.length()) {
@@ -47,15 +50,33 @@ std::string FindFullName(const std::string& name) {
         field_value_end - field_name_end - 1);
     next_item = field_value_end + 1;
 
-    if (name == field_name)
-      return field_value;
+    trials->emplace(std::move(field_name), std::move(field_value));
   }
-  return std::string();
+  return trials;
+}
+
+}  // namespace
+
+static const char *trials_init_string = NULL;
+
+// The trials of |trials_init_string|, parsed once when it is set, since the
+// trials can be looked up often.
+static const TrialMap* trials = NULL;
+
+std::string FindFullName(const std::string& name) {
+  if (trials == NULL)
+    return std::string();
+
+  const auto it = trials->find(name);
+  return it == trials->end() ? std::string() : it->second;
 }
 
 // Optionally initialize field trial from a string.
 void InitFieldTrialsFromString(const char* trials_string) {
+  const TrialMap* old_trials = trials;
   trials_init_string = trials_string;
+  trials = ParseTrials(trials_string);
+  delete old_trials;
 }
 
 const char* GetFieldTrialString() {
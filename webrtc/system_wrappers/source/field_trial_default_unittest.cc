@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/system_wrappers/include/field_trial.h"
+#include "webrtc/system_wrappers/include/field_trial_default.h"
+
+namespace webrtc {
+namespace field_trial {
+
+class FieldTrialDefaultTest : public ::testing::Test {
+ public:
+  FieldTrialDefaultTest() : previous_trials_(GetFieldTrialString()) {}
+  ~FieldTrialDefaultTest() override {
+    InitFieldTrialsFromString(previous_trials_);
+  }
+
+ private:
+  const char* const previous_trials_;
+};
+
+TEST_F(FieldTrialDefaultTest, FindsTrials) {
+  static const char kTrials[] = "WebRTC-A/Enabled/WebRTC-B/Disabled-2/";
+  InitFieldTrialsFromString(kTrials);
+  EXPECT_EQ(kTrials, GetFieldTrialString());
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+  EXPECT_EQ("Disabled-2", FindFullName("WebRTC-B"));
+  EXPECT_EQ("", FindFullName("WebRTC-C"));
+  EXPECT_EQ("", FindFullName("WebRTC"));
+}
+
+TEST_F(FieldTrialDefaultTest, NoTrials) {
+  InitFieldTrialsFromString(nullptr);
+  EXPECT_EQ("", FindFullName("WebRTC-A"));
+  InitFieldTrialsFromString("");
+  EXPECT_EQ("", FindFullName("WebRTC-A"));
+}
+
+TEST_F(FieldTrialDefaultTest, FirstGroupOfTrialWins) {
+  InitFieldTrialsFromString("WebRTC-A/Enabled/WebRTC-A/Disabled/");
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+}
+
+TEST_F(FieldTrialDefaultTest, IgnoresTrialsAfterMalformedEntry) {
+  InitFieldTrialsFromString("WebRTC-A/Enabled//Disabled/WebRTC-B/Enabled/");
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+  EXPECT_EQ("", FindFullName("WebRTC-B"));
+  InitFieldTrialsFromString("WebRTC-A/Enabled/WebRTC-B/Enabled");
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+  EXPECT_EQ("", FindFullName("WebRTC-B"));
+}
+
+TEST_F(FieldTrialDefaultTest, ReinitializingReplacesTrials) {
+  InitFieldTrialsFromString("WebRTC-A/Enabled/");
+  InitFieldTrialsFromString("WebRTC-B/Enabled/");
+  EXPECT_EQ("", FindFullName("WebRTC-A"));
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-B"));
+}
+
+TEST_F(FieldTrialDefaultTest, FieldTrialGroup) {
+  InitFieldTrialsFromString(
+      "WebRTC-A/Enabled-30/WebRTC-B/Disabled/WebRTC-C/Control/");
+  const FieldTrialGroup a("WebRTC-A");
+  EXPECT_EQ("Enabled-30", a.name());
+  EXPECT_TRUE(a.IsEnabled());
+  EXPECT_FALSE(a.IsDisabled());
+  const FieldTrialGroup b("WebRTC-B");
+  EXPECT_FALSE(b.IsEnabled());
+  EXPECT_TRUE(b.IsDisabled());
+  const FieldTrialGroup c("WebRTC-C");
+  EXPECT_FALSE(c.IsEnabled());
+  EXPECT_FALSE(c.IsDisabled());
+  const FieldTrialGroup d("WebRTC-D");
+  EXPECT_EQ("", d.name());
+  EXPECT_FALSE(d.IsEnabled());
+  EXPECT_FALSE(d.IsDisabled());
+
+  // The group is looked up when the FieldTrialGroup is created.
+  InitFieldTrialsFromString("WebRTC-A/Disabled/");
+  EXPECT_TRUE(a.IsEnabled());
+  EXPECT_TRUE(FieldTrialGroup("WebRTC-A").IsDisabled());
+}
+
+}  // namespace field_trial
+}  // namespace webrtc
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/huge_page_malloc.h"
+
+#if defined(WEBRTC_LINUX)
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/checks.h"
+#include "webrtc/system_wrappers/include/aligned_malloc.h"
+
+namespace webrtc {
+
+namespace {
+
+volatile int g_huge_page_mode = static_cast<int>(HugePageMode::kOff);
+
+#if defined(WEBRTC_LINUX)
+// Maps |size| bytes, a multiple of kHugePageSize, aligned on kHugePageSize.
+// The kernel only backs aligned 2 MB ranges with huge pages, so the mapping is
+// made larger and trimmed to the aligned part.
+void* MapAligned(size_t size) {
+  const size_t padded_size = size + kHugePageSize;
+  void* const mapping = mmap(nullptr, padded_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED)
+    return nullptr;
+  const uintptr_t start = reinterpret_cast<uintptr_t>(mapping);
+  const uintptr_t aligned_start =
+      (start + kHugePageSize - 1) & ~(kHugePageSize - 1);
+  if (aligned_start != start)
+    munmap(mapping, aligned_start - start);
+  const size_t tail = start + padded_size - (aligned_start + size);
+  if (tail != 0)
+    munmap(reinterpret_cast<void*>(aligned_start + size), tail);
+  return reinterpret_cast<void*>(aligned_start);
+}
+
+// Returns a block of |size| bytes, a multiple of kHugePageSize, backed by huge
+// pages if possible, or null.
+void* MapHugePages(size_t size, HugePageMode mode) {
+#if defined(MAP_HUGETLB)
+  if (mode == HugePageMode::kExplicit) {
+    void* const block =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (block != MAP_FAILED)
+      return block;
+  }
+#endif
+  void* const block = MapAligned(size);
+#if defined(MADV_HUGEPAGE)
+  // Fails if transparent huge pages are disabled, and the block then stays
+  // backed by small pages.
+  if (block)
+    madvise(block, size, MADV_HUGEPAGE);
+#endif
+  return block;
+}
+#endif  // defined(WEBRTC_LINUX)
+
+}  // namespace
+
+void SetHugePageMode(HugePageMode mode) {
+  rtc::AtomicOps::ReleaseStore(&g_huge_page_mode, static_cast<int>(mode));
+}
+
+HugePageMode GetHugePageMode() {
+  return static_cast<HugePageMode>(
+      rtc::AtomicOps::AcquireLoad(&g_huge_page_mode));
+}
+
+void HugePageFreeDeleter::operator()(void* ptr) const {
+#if defined(WEBRTC_LINUX)
+  if (mapped_size_ != 0) {
+    munmap(ptr, mapped_size_);
+    return;
+  }
+#endif
+  AlignedFree(ptr);
+}
+
+HugePageBuffer HugePageMalloc(size_t size, size_t alignment) {
+  RTC_DCHECK(alignment != 0 && (alignment & (alignment - 1)) == 0);
+#if defined(WEBRTC_LINUX)
+  const HugePageMode mode = GetHugePageMode();
+  if (mode != HugePageMode::kOff && size >= kHugePageSize &&
+      alignment <= kHugePageSize) {
+    const size_t mapped_size =
+        (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    void* const block = MapHugePages(mapped_size, mode);
+    if (block) {
+      return HugePageBuffer(static_cast<uint8_t*>(block),
+                            HugePageFreeDeleter(mapped_size));
+    }
+  }
+#endif
+  // AlignedMalloc() fails for empty blocks.
+  return HugePageBuffer(static_cast<uint8_t*>(
+      AlignedMalloc(std::max<size_t>(size, 1), alignment)));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/system_wrappers/include/huge_page_malloc.h"
+
+#include <string.h>
+#if defined(WEBRTC_LINUX)
+#include <sys/resource.h>
+#endif
+
+#include <utility>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
+
+namespace webrtc {
+
+namespace {
+
+// The size of a 4K I420 frame.
+const size_t kFrameSize = 3840 * 2160 * 3 / 2;
+
+bool IsAligned(const void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+}  // namespace
+
+class HugePageMallocTest : public ::testing::Test {
+ protected:
+  void TearDown() override { SetHugePageMode(HugePageMode::kOff); }
+};
+
+TEST_F(HugePageMallocTest, OffByDefault) {
+  EXPECT_EQ(HugePageMode::kOff, GetHugePageMode());
+  HugePageBuffer buffer = HugePageMalloc(kFrameSize, 64);
+  ASSERT_TRUE(buffer);
+  EXPECT_TRUE(IsAligned(buffer.get(), 64));
+  EXPECT_EQ(0u, buffer.get_deleter().mapped_size());
+}
+
+#if defined(WEBRTC_LINUX)
+TEST_F(HugePageMallocTest, MapsLargeBlocks) {
+  for (HugePageMode mode :
+       {HugePageMode::kTransparent, HugePageMode::kExplicit}) {
+    SetHugePageMode(mode);
+    // Explicit huge pages fall back to transparent ones when none are
+    // reserved.
+    HugePageBuffer buffer = HugePageMalloc(kFrameSize, 64);
+    ASSERT_TRUE(buffer);
+    EXPECT_TRUE(IsAligned(buffer.get(), kHugePageSize));
+    EXPECT_EQ(6 * kHugePageSize, buffer.get_deleter().mapped_size());
+    memset(buffer.get(), 0xff, kFrameSize);
+
+    HugePageBuffer moved = std::move(buffer);
+    EXPECT_EQ(6 * kHugePageSize, moved.get_deleter().mapped_size());
+  }
+}
+#endif
+
+TEST_F(HugePageMallocTest, SmallBlocksUseAlignedMalloc) {
+  SetHugePageMode(HugePageMode::kTransparent);
+  HugePageBuffer buffer = HugePageMalloc(kHugePageSize - 1, 64);
+  ASSERT_TRUE(buffer);
+  EXPECT_TRUE(IsAligned(buffer.get(), 64));
+  EXPECT_EQ(0u, buffer.get_deleter().mapped_size());
+  EXPECT_TRUE(HugePageMalloc(0, 64));
+}
+
+#if defined(WEBRTC_LINUX)
+// Writes 4K frames to newly allocated memory, as a frame pool filling up
+// does, and logs the page faults it takes with and without huge pages.
+TEST_F(HugePageMallocTest, DISABLED_PageFaultsWritingFrames) {
+  const int kNumFrames = 16;
+  for (HugePageMode mode : {HugePageMode::kOff, HugePageMode::kTransparent}) {
+    SetHugePageMode(mode);
+    std::vector<HugePageBuffer> buffers;
+    struct rusage usage_before;
+    getrusage(RUSAGE_SELF, &usage_before);
+    const int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumFrames; ++i) {
+      buffers.push_back(HugePageMalloc(kFrameSize, 64));
+      ASSERT_TRUE(buffers.back());
+      memset(buffers.back().get(), i, kFrameSize);
+    }
+    const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+    struct rusage usage_after;
+    getrusage(RUSAGE_SELF, &usage_after);
+    LOG(LS_INFO) << (mode == HugePageMode::kOff ? "Small" : "Huge")
+                 << " pages: "
+                 << (usage_after.ru_minflt - usage_before.ru_minflt) /
+                        kNumFrames
+                 << " page faults and " << elapsed_us / kNumFrames
+                 << " us per frame.";
+  }
+}
+#endif
+
+}  // namespace webrtc
@@ -9,6 +9,9 @@
 
 #include "webrtc/system_wrappers/include/metrics_default.h"
 
+#include <limits>
+
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/system_wrappers/include/metrics.h"
@@ -26,11 +29,36 @@ namespace {
 // linearly/exponentially spaced buckets) if samples are logged more frequently.
 const int kMaxSampleMapSize = 300;
 
+// Number of slots in the table of sample values of a histogram. A power of two
+// comfortably larger than kMaxSampleMapSize, to keep the probe sequences short.
+const int kLog2NumSlots = 9;
+const size_t kNumSlots = 1 << kLog2NumSlots;
+
+// Marks a slot that no sample value has claimed yet. Can't be a sample value,
+// since samples are clamped to [min - 1, max].
+const int kEmptySlot = std::numeric_limits<int>::min();
+
+// Samples are added without taking a lock, since histograms are updated per
+// packet or frame from many threads. Each sample value is counted in a slot of
+// an open addressing table, which is claimed by the first sample with that
+// value and then keeps the value for the lifetime of the histogram. Therefore
+// kMaxSampleMapSize limits the number of values added since the histogram was
+// created, rather than since the last GetAndReset(). The counts are only
+// collected into a SampleInfo in GetAndReset().
 class RtcHistogram {
  public:
   RtcHistogram(const std::string& name, int min, int max, int bucket_count)
-      : min_(min), max_(max), info_(name, min, max, bucket_count) {
+      : min_(min),
+        max_(max),
+        name_(name),
+        bucket_count_(bucket_count),
+        num_values_(0) {
     RTC_DCHECK_GT(bucket_count, 0);
+    RTC_DCHECK_GT(min - 1, kEmptySlot);
+    for (Slot& slot : slots_) {
+      slot.value = kEmptySlot;
+      slot.count = 0;
+    }
   }
 
   void Add(int sample) {
@@ -39,60 +67,132 @@ class RtcHistogram {
     if (sample > max_)
       sample = max_;
 
-    rtc::CritScope cs(&crit_);
-    if (info_.samples.size() == kMaxSampleMapSize &&
-        info_.samples.find(sample) == info_.samples.end()) {
-      return;
-    }
-    ++info_.samples[sample];
+    Slot* slot = FindOrClaimSlot(sample);
+    if (slot)
+      rtc::AtomicOps::Increment(&slot->count);
   }
 
   // Returns a copy (or nullptr if there are no samples) and clears samples.
   std::unique_ptr<SampleInfo> GetAndReset() {
-    rtc::CritScope cs(&crit_);
-    if (info_.samples.empty())
-      return nullptr;
-
-    SampleInfo* copy =
-        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count);
-    copy->samples = info_.samples;
-    info_.samples.clear();
-    return std::unique_ptr<SampleInfo>(copy);
+    std::unique_ptr<SampleInfo> copy;
+    for (Slot& slot : slots_) {
+      const int value = rtc::AtomicOps::AcquireLoad(&slot.value);
+      if (value == kEmptySlot)
+        continue;
+      // Samples added concurrently are either returned now or kept for the
+      // next call.
+      int count = rtc::AtomicOps::AcquireLoad(&slot.count);
+      while (count != 0) {
+        const int old_count =
+            rtc::AtomicOps::CompareAndSwap(&slot.count, count, 0);
+        if (old_count == count)
+          break;
+        count = old_count;
+      }
+      if (count == 0)
+        continue;
+      if (!copy)
+        copy.reset(new SampleInfo(name_, min_, max_, bucket_count_));
+      copy->samples[value] = count;
+    }
+    return copy;
   }
 
-  const std::string& name() const { return info_.name; }
+  const std::string& name() const { return name_; }
 
   // Functions only for testing.
   void Reset() {
-    rtc::CritScope cs(&crit_);
-    info_.samples.clear();
+    for (Slot& slot : slots_)
+      rtc::AtomicOps::ReleaseStore(&slot.count, 0);
   }
 
   int NumEvents(int sample) const {
-    rtc::CritScope cs(&crit_);
-    const auto it = info_.samples.find(sample);
-    return (it == info_.samples.end()) ? 0 : it->second;
+    const Slot* slot = FindSlot(sample);
+    return slot ? rtc::AtomicOps::AcquireLoad(&slot->count) : 0;
   }
 
   int NumSamples() const {
     int num_samples = 0;
-    rtc::CritScope cs(&crit_);
-    for (const auto& sample : info_.samples) {
-      num_samples += sample.second;
-    }
+    for (const Slot& slot : slots_)
+      num_samples += rtc::AtomicOps::AcquireLoad(&slot.count);
     return num_samples;
   }
 
   int MinSample() const {
-    rtc::CritScope cs(&crit_);
-    return (info_.samples.empty()) ? -1 : info_.samples.begin()->first;
+    int min_sample = kEmptySlot;
+    for (const Slot& slot : slots_) {
+      const int value = rtc::AtomicOps::AcquireLoad(&slot.value);
+      if (value != kEmptySlot &&
+          (min_sample == kEmptySlot || value < min_sample) &&
+          rtc::AtomicOps::AcquireLoad(&slot.count) > 0) {
+        min_sample = value;
+      }
+    }
+    return (min_sample == kEmptySlot) ? -1 : min_sample;
   }
 
  private:
-  rtc::CriticalSection crit_;
+  struct Slot {
+    volatile int value;
+    volatile int count;
+  };
+
+  static size_t FirstSlot(int sample) {
+    // Fibonacci hashing.
+    return (static_cast<uint32_t>(sample) * 2654435769u) >>
+           (32 - kLog2NumSlots);
+  }
+
+  // Returns the slot of |sample|, or nullptr if no slot has been claimed for
+  // it. Values are never removed from the table, so |sample| can't be found
+  // after an empty slot.
+  const Slot* FindSlot(int sample) const {
+    size_t index = FirstSlot(sample);
+    for (size_t i = 0; i < kNumSlots; ++i) {
+      const Slot* slot = &slots_[index];
+      const int value = rtc::AtomicOps::AcquireLoad(&slot->value);
+      if (value == sample)
+        return slot;
+      if (value == kEmptySlot)
+        return nullptr;
+      index = (index + 1) & (kNumSlots - 1);
+    }
+    return nullptr;
+  }
+
+  // Like FindSlot(), but claims a slot for |sample| if there is none, unless
+  // kMaxSampleMapSize values have been added already.
+  Slot* FindOrClaimSlot(int sample) {
+    size_t index = FirstSlot(sample);
+    for (size_t i = 0; i < kNumSlots; ++i) {
+      Slot* slot = &slots_[index];
+      int value = rtc::AtomicOps::AcquireLoad(&slot->value);
+      if (value == kEmptySlot) {
+        if (rtc::AtomicOps::Increment(&num_values_) > kMaxSampleMapSize) {
+          rtc::AtomicOps::Decrement(&num_values_);
+          return nullptr;
+        }
+        value = rtc::AtomicOps::CompareAndSwap(&slot->value, kEmptySlot,
+                                               sample);
+        if (value == kEmptySlot)
+          return slot;
+        // Another thread claimed the slot first, possibly for |sample|.
+        rtc::AtomicOps::Decrement(&num_values_);
+      }
+      if (value == sample)
+        return slot;
+      index = (index + 1) & (kNumSlots - 1);
+    }
+    return nullptr;
+  }
+
   const int min_;
   const int max_;
-  SampleInfo info_ GUARDED_BY(crit_);
+  const std::string name_;
+  const size_t bucket_count_;
+  // Number of claimed slots, or reserved while being claimed.
+  volatile int num_values_;
+  Slot slots_[kNumSlots];
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
 };
@@ -8,8 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <memory>
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/system_wrappers/include/metrics.h"
 #include "webrtc/system_wrappers/include/metrics_default.h"
 
@@ -48,6 +53,34 @@ int NumEvents(const std::string& name,
 
   return it_sample->second;
 }
+
+// Adds |num_samples| samples to a histogram, with values cycling through
+// [0, |num_values|).
+struct AddSamplesTask {
+  metrics::Histogram* histogram;
+  int num_samples;
+  int num_values;
+};
+
+bool AddSamples(void* obj) {
+  const AddSamplesTask* task = static_cast<const AddSamplesTask*>(obj);
+  for (int i = 0; i < task->num_samples; ++i)
+    metrics::HistogramAdd(task->histogram, i % task->num_values);
+  return false;
+}
+
+// Runs AddSamples() for |task| on |num_threads| threads at the same time.
+void AddSamplesConcurrently(AddSamplesTask* task, int num_threads) {
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&AddSamples, task, "AddSamples"));
+  }
+  for (auto& thread : threads)
+    thread->Start();
+  for (auto& thread : threads)
+    thread->Stop();
+}
 }  // namespace
 
 class MetricsDefaultTest : public ::testing::Test {
@@ -151,4 +184,49 @@ TEST_F(MetricsDefaultTest, TestMinMaxBucket) {
   EXPECT_EQ(1u, histograms.begin()->second->samples.size());
 }
 
+TEST_F(MetricsDefaultTest, ConcurrentAdd) {
+  const int kNumThreads = 4;
+  AddSamplesTask task;
+  task.histogram =
+      metrics::HistogramFactoryGetCounts("Concurrent", 1, 10000, 50);
+  task.num_samples = 10000;
+  task.num_values = 100;
+  AddSamplesConcurrently(&task, kNumThreads);
+
+  EXPECT_EQ(kNumThreads * task.num_samples, metrics::NumSamples("Concurrent"));
+  EXPECT_EQ(kNumThreads * task.num_samples / task.num_values,
+            metrics::NumEvents("Concurrent", 0));
+  EXPECT_EQ(kNumThreads * task.num_samples / task.num_values,
+            metrics::NumEvents("Concurrent", 99));
+
+  std::map<std::string, std::unique_ptr<metrics::SampleInfo>> histograms;
+  metrics::GetAndReset(&histograms);
+  EXPECT_EQ(kNumThreads * task.num_samples,
+            NumSamples("Concurrent", histograms));
+  EXPECT_EQ(static_cast<size_t>(task.num_values),
+            histograms["Concurrent"]->samples.size());
+  EXPECT_EQ(0, metrics::NumSamples("Concurrent"));
+}
+
+// Measures how long it takes to add samples to the same histogram from several
+// threads at once.
+TEST_F(MetricsDefaultTest, DISABLED_ConcurrentAddPerformance) {
+  AddSamplesTask task;
+  task.histogram =
+      metrics::HistogramFactoryGetCounts("Performance", 1, 10000, 50);
+  task.num_samples = 1000000;
+  task.num_values = 30;
+  for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    metrics::Reset();
+    const int64_t start_us = rtc::TimeMicros();
+    AddSamplesConcurrently(&task, num_threads);
+    const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+    EXPECT_EQ(num_threads * task.num_samples,
+              metrics::NumSamples("Performance"));
+    printf("%d threads: %d ns / sample\n", num_threads,
+           static_cast<int>(elapsed_us * 1000 /
+                            (num_threads * task.num_samples)));
+  }
+}
+
 }  // namespace webrtc
@@ -31,6 +31,7 @@
         'include/field_trial.h',
         'include/file_wrapper.h',
         'include/fix_interlocked_exchange_pointer_win.h',
+        'include/huge_page_malloc.h',
         'include/logging.h',
         'include/metrics.h',
         'include/ntp_time.h',
@@ -58,6 +59,7 @@
         'source/event_timer_win.cc',
         'source/event_timer_win.h',
         'source/file_impl.cc',
+        'source/huge_page_malloc.cc',
         'source/logging.cc',
         'source/rtp_to_ntp.cc',
         'source/rw_lock.cc',
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "webrtc/call.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -31,13 +32,13 @@ FakeNetworkPipe::FakeNetworkPipe(Clock* clock,
                                  uint64_t seed)
     : clock_(clock),
       packet_receiver_(NULL),
+      next_pipe_(NULL),
       random_(seed),
       config_(config),
       dropped_packets_(0),
       sent_packets_(0),
       total_packet_delay_(0),
-      bursting_(false),
-      next_process_time_(clock_->TimeInMilliseconds()) {
+      bursting_(false) {
   double prob_loss = config.loss_percent / 100.0;
   if (config_.avg_burst_loss_length == -1) {
     // Uniform loss
@@ -73,15 +74,23 @@ void FakeNetworkPipe::SetReceiver(PacketReceiver* receiver) {
   packet_receiver_ = receiver;
 }
 
+void FakeNetworkPipe::SetNextPipe(FakeNetworkPipe* next_pipe) {
+  next_pipe_ = next_pipe;
+}
+
 void FakeNetworkPipe::SetConfig(const FakeNetworkPipe::Config& config) {
   rtc::CritScope crit(&lock_);
   config_ = config;  // Shallow copy of the struct.
 }
 
 void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length) {
+  SendPacket(rtc::CopyOnWriteBuffer(data, data_length));
+}
+
+void FakeNetworkPipe::SendPacket(const rtc::CopyOnWriteBuffer& data) {
   // A NULL packet_receiver_ means that this pipe will terminate the flow of
   // packets.
-  if (packet_receiver_ == NULL)
+  if (packet_receiver_ == NULL && next_pipe_ == NULL)
     return;
   rtc::CritScope crit(&lock_);
   if (config_.queue_length_packets > 0 &&
@@ -96,7 +105,7 @@ void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length) {
   // Delay introduced by the link capacity.
   int64_t capacity_delay_ms = 0;
   if (config_.link_capacity_kbps > 0)
-    capacity_delay_ms = data_length / (config_.link_capacity_kbps / 8);
+    capacity_delay_ms = data.size() / (config_.link_capacity_kbps / 8);
   int64_t network_start_time = time_now;
 
   // Check if there already are packets on the link and change network start
@@ -106,8 +115,7 @@ void FakeNetworkPipe::SendPacket(const uint8_t* data, size_t data_length) {
     network_start_time = capacity_link_.back()->arrival_time();
 
   int64_t arrival_time = network_start_time + capacity_delay_ms;
-  NetworkPacket* packet = new NetworkPacket(data, data_length, time_now,
-                                            arrival_time);
+  NetworkPacket* packet = new NetworkPacket(data, time_now, arrival_time);
   capacity_link_.push(packet);
 }
 
@@ -164,8 +172,6 @@ void FakeNetworkPipe::Process() {
             (*delay_link_.rbegin())->arrival_time() - packet->arrival_time();
       }
       packet->IncrementArrivalTime(arrival_time_jitter);
-      if (packet->arrival_time() < next_process_time_)
-        next_process_time_ = packet->arrival_time();
       delay_link_.insert(packet);
     }
 
@@ -186,8 +192,12 @@ void FakeNetworkPipe::Process() {
   while (!packets_to_deliver.empty()) {
     NetworkPacket* packet = packets_to_deliver.front();
     packets_to_deliver.pop();
-    packet_receiver_->DeliverPacket(MediaType::ANY, packet->data(),
-                                    packet->data_length(), PacketTime());
+    if (next_pipe_) {
+      next_pipe_->SendPacket(packet->packet());
+    } else {
+      packet_receiver_->DeliverPacket(MediaType::ANY, packet->data(),
+                                      packet->data_length(), PacketTime());
+    }
     delete packet;
   }
 }
@@ -195,9 +205,16 @@ void FakeNetworkPipe::Process() {
 int64_t FakeNetworkPipe::TimeUntilNextProcess() const {
   rtc::CritScope crit(&lock_);
   const int64_t kDefaultProcessIntervalMs = 30;
-  if (capacity_link_.empty() || delay_link_.empty())
+  if (capacity_link_.empty() && delay_link_.empty())
     return kDefaultProcessIntervalMs;
-  return std::max<int64_t>(next_process_time_ - clock_->TimeInMilliseconds(),
+  int64_t next_process_time = std::numeric_limits<int64_t>::max();
+  if (!capacity_link_.empty())
+    next_process_time = capacity_link_.front()->arrival_time();
+  if (!delay_link_.empty()) {
+    next_process_time = std::min(next_process_time,
+                                 (*delay_link_.begin())->arrival_time());
+  }
+  return std::max<int64_t>(next_process_time - clock_->TimeInMilliseconds(),
                            0);
 }
 
@@ -17,6 +17,7 @@
 #include <queue>
 
 #include "webrtc/base/constructormagic.h"
+#include "webrtc/base/copyonwritebuffer.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/random.h"
 #include "webrtc/typedefs.h"
@@ -29,19 +30,14 @@ class PacketReceiver;
 
 class NetworkPacket {
  public:
-  NetworkPacket(const uint8_t* data,
-                size_t length,
+  NetworkPacket(const rtc::CopyOnWriteBuffer& packet,
                 int64_t send_time,
                 int64_t arrival_time)
-      : data_(new uint8_t[length]),
-        data_length_(length),
-        send_time_(send_time),
-        arrival_time_(arrival_time) {
-    memcpy(data_.get(), data, length);
-  }
+      : packet_(packet), send_time_(send_time), arrival_time_(arrival_time) {}
 
-  uint8_t* data() const { return data_.get(); }
-  size_t data_length() const { return data_length_; }
+  const uint8_t* data() const { return packet_.data(); }
+  size_t data_length() const { return packet_.size(); }
+  const rtc::CopyOnWriteBuffer& packet() const { return packet_; }
   int64_t send_time() const { return send_time_; }
   int64_t arrival_time() const { return arrival_time_; }
   void IncrementArrivalTime(int64_t extra_delay) {
@@ -49,10 +45,8 @@ class NetworkPacket {
   }
 
  private:
-  // The packet data.
-  std::unique_ptr<uint8_t[]> data_;
-  // Length of data_.
-  size_t data_length_;
+  // The packet data, shared with the sender.
+  rtc::CopyOnWriteBuffer packet_;
   // The time the packet was sent out on the network.
   const int64_t send_time_;
   // The time the packet should arrive at the receiver.
@@ -91,16 +85,25 @@ class FakeNetworkPipe {
 
   // Must not be called in parallel with SendPacket or Process.
   void SetReceiver(PacketReceiver* receiver);
+  // Sends the packets leaving this pipe on to |next_pipe| instead of
+  // delivering them to the receiver. Chaining pipes this way, e.g. several
+  // access links into one bottleneck, models a path across several links.
+  // Must not be called in parallel with SendPacket or Process.
+  void SetNextPipe(FakeNetworkPipe* next_pipe);
 
   // Sets a new configuration. This won't affect packets already in the pipe.
   void SetConfig(const FakeNetworkPipe::Config& config);
 
-  // Sends a new packet to the link.
+  // Sends a new packet to the link. The second version doesn't copy the
+  // packet.
   void SendPacket(const uint8_t* packet, size_t packet_length);
+  void SendPacket(const rtc::CopyOnWriteBuffer& packet);
 
   // Processes the network queues and trigger PacketReceiver::IncomingPacket for
   // packets ready to be delivered.
   void Process();
+  // Time until the next packet is due to move to the next queue or to be
+  // delivered, or a default interval if the pipe is empty.
   int64_t TimeUntilNextProcess() const;
 
   // Get statistics.
@@ -113,6 +116,7 @@ class FakeNetworkPipe {
   Clock* const clock_;
   rtc::CriticalSection lock_;
   PacketReceiver* packet_receiver_;
+  FakeNetworkPipe* next_pipe_;
   std::queue<NetworkPacket*> capacity_link_;
   Random random_;
 
@@ -144,8 +148,6 @@ class FakeNetworkPipe {
   // The probability to drop a burst of packets.
   double prob_start_bursting_;
 
-  int64_t next_process_time_;
-
   RTC_DISALLOW_COPY_AND_ASSIGN(FakeNetworkPipe);
 };
 
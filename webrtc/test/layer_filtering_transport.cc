@@ -14,6 +14,7 @@
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_format_vp9.h"
 #include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
 #include "webrtc/test/layer_filtering_transport.h"
 
@@ -63,19 +64,29 @@ bool LayerFilteringTransport::SendRtp(const uint8_t* packet,
     RTC_DCHECK_GT(payload_length, header.paddingLength);
     const size_t payload_data_length = payload_length - header.paddingLength;
 
+    // VP9 only needs the start of the payload descriptor, which is read
+    // without depacketizing the rest of it.
     const bool is_vp8 = header.payloadType == vp8_video_payload_type_;
-    std::unique_ptr<RtpDepacketizer> depacketizer(
-        RtpDepacketizer::Create(is_vp8 ? kRtpVideoVp8 : kRtpVideoVp9));
-    RtpDepacketizer::ParsedPayload parsed_payload;
-    if (depacketizer->Parse(&parsed_payload, payload, payload_data_length)) {
-      const int temporal_idx = static_cast<int>(
-          is_vp8 ? parsed_payload.type.Video.codecHeader.VP8.temporalIdx
-                 : parsed_payload.type.Video.codecHeader.VP9.temporal_idx);
-      const int spatial_idx = static_cast<int>(
-          is_vp8 ? kNoSpatialIdx
-                 : parsed_payload.type.Video.codecHeader.VP9.spatial_idx);
-      if (selected_sl_ >= 0 && spatial_idx == selected_sl_ &&
-          parsed_payload.type.Video.codecHeader.VP9.end_of_frame) {
+    bool parsed = false;
+    int temporal_idx = kNoTemporalIdx;
+    int spatial_idx = kNoSpatialIdx;
+    bool end_of_frame = false;
+    if (is_vp8) {
+      std::unique_ptr<RtpDepacketizer> depacketizer(
+          RtpDepacketizer::Create(kRtpVideoVp8));
+      RtpDepacketizer::ParsedPayload parsed_payload;
+      parsed =
+          depacketizer->Parse(&parsed_payload, payload, payload_data_length);
+      temporal_idx = parsed_payload.type.Video.codecHeader.VP8.temporalIdx;
+    } else {
+      Vp9PayloadDescriptorView descriptor;
+      parsed = descriptor.Parse(payload, payload_data_length);
+      temporal_idx = descriptor.temporal_idx();
+      spatial_idx = descriptor.spatial_idx();
+      end_of_frame = descriptor.end_of_frame();
+    }
+    if (parsed) {
+      if (selected_sl_ >= 0 && spatial_idx == selected_sl_ && end_of_frame) {
         // This layer is now the last in the superframe.
         set_marker_bit = true;
       } else if ((selected_tl_ >= 0 && temporal_idx != kNoTemporalIdx &&
@@ -0,0 +1,521 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/test/mapped_rtp_file_reader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/base/format_macros.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_utility.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+const size_t kRtpDumpFirstLineLength = 40;
+const size_t kRtpDumpFileHeaderSize = 16;
+const size_t kRtpDumpPacketHeaderSize = 8;
+
+const uint32_t kPcapBOMSwapOrder = 0xd4c3b2a1UL;
+const uint32_t kPcapBOMNoSwapOrder = 0xa1b2c3d4UL;
+const size_t kPcapGlobalHeaderSize = 24;
+const size_t kPcapPacketHeaderSize = 16;
+const uint16_t kPcapVersionMajor = 2;
+const uint16_t kPcapVersionMinor = 4;
+const uint32_t kLinktypeNull = 0;
+const uint32_t kLinktypeEthernet = 1;
+const uint32_t kBsdNullLoopback1 = 0x00000002;
+const uint32_t kBsdNullLoopback2 = 0x02000000;
+const size_t kBsdNullHeaderSize = 4;
+const size_t kEthernetIIHeaderSize = 14;
+const uint16_t kEthertypeIp = 0x0800;
+const uint8_t kIpVersion4 = 4;
+const size_t kMinIpHeaderLength = 20;
+const uint16_t kFragmentOffsetClear = 0x0000;
+const uint16_t kFragmentOffsetDoNotFragment = 0x4000;
+const uint8_t kProtocolUdp = 0x11;
+const size_t kUdpHeaderLength = 8;
+
+const uint32_t kLengthPacketInterleavedTimeStepMs = 5;
+
+// IndexEntry::flags.
+const uint32_t kIndexEntryRtcp = 1;
+const uint32_t kIndexEntryRtp = 2;
+
+const char kIndexFileSuffix[] = ".rtpindex";
+const char kIndexFileMagic[8] = {'R', 'T', 'P', 'I', 'D', 'X', '1', '\0'};
+
+uint16_t ReadBigEndian16(const uint8_t* data) {
+  return (data[0] << 8) | data[1];
+}
+
+uint32_t ReadBigEndian32(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) | (data[1] << 16) |
+         (data[2] << 8) | data[3];
+}
+
+uint32_t ReadLittleEndian32(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[3]) << 24) | (data[2] << 16) |
+         (data[1] << 8) | data[0];
+}
+
+// The index file is a header followed by one IndexEntry per packet, all in
+// native byte order, since it is only a cache for the machine that wrote it.
+struct IndexFileHeader {
+  char magic[8];
+  uint32_t format;
+  uint32_t reserved;
+  uint64_t file_size;
+  int64_t file_mtime;
+  uint64_t num_entries;
+};
+
+}  // namespace
+
+struct MappedRtpFileReader::IndexEntry {
+  uint64_t offset;
+  uint32_t length;
+  uint32_t original_length;
+  uint32_t time_ms;
+  uint32_t ssrc;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+// A read-only file mapped into memory. Where mmap is not available the file
+// is read into memory instead.
+class MappedRtpFileReader::MappedFile {
+ public:
+  static std::unique_ptr<MappedFile> Open(const std::string& filename) {
+    std::unique_ptr<MappedFile> file(new MappedFile());
+#if defined(WEBRTC_POSIX)
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      return nullptr;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+      close(fd);
+      return nullptr;
+    }
+    file->size_ = static_cast<size_t>(file_stat.st_size);
+    file->mtime_ = static_cast<int64_t>(file_stat.st_mtime);
+    if (file->size_ > 0) {
+      void* data = mmap(nullptr, file->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+      }
+      // Packets are mostly read in order.
+      madvise(data, file->size_, MADV_SEQUENTIAL);
+      file->data_ = static_cast<const uint8_t*>(data);
+    }
+    close(fd);
+#else
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (!f)
+      return nullptr;
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), f)) > 0)
+      file->buffer_.insert(file->buffer_.end(), buffer, buffer + read);
+    fclose(f);
+    file->size_ = file->buffer_.size();
+    file->data_ = file->buffer_.empty() ? nullptr : &file->buffer_[0];
+#endif
+    return file;
+  }
+
+  ~MappedFile() {
+#if defined(WEBRTC_POSIX)
+    if (data_)
+      munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+  }
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  // Zero if not known.
+  int64_t mtime() const { return mtime_; }
+
+ private:
+  MappedFile() : data_(nullptr), size_(0), mtime_(0) {}
+
+  const uint8_t* data_;
+  size_t size_;
+  int64_t mtime_;
+#if !defined(WEBRTC_POSIX)
+  std::vector<uint8_t> buffer_;
+#endif
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+std::unique_ptr<MappedRtpFileReader> MappedRtpFileReader::Create(
+    FileFormat format,
+    const std::string& filename,
+    const std::set<uint32_t>& ssrc_filter) {
+  std::unique_ptr<MappedRtpFileReader> reader(new MappedRtpFileReader());
+  if (!reader->Init(format, filename, ssrc_filter))
+    return nullptr;
+  return reader;
+}
+
+std::unique_ptr<MappedRtpFileReader> MappedRtpFileReader::Create(
+    FileFormat format,
+    const std::string& filename) {
+  return Create(format, filename, std::set<uint32_t>());
+}
+
+MappedRtpFileReader::MappedRtpFileReader() : next_packet_(0) {}
+
+MappedRtpFileReader::~MappedRtpFileReader() {}
+
+std::vector<uint32_t> MappedRtpFileReader::Ssrcs() const {
+  std::vector<uint32_t> ssrcs;
+  for (const auto& it : packets_by_ssrc_)
+    ssrcs.push_back(it.first);
+  return ssrcs;
+}
+
+const std::vector<size_t>& MappedRtpFileReader::PacketsWithSsrc(
+    uint32_t ssrc) const {
+  static const std::vector<size_t>* const kNoPackets =
+      new std::vector<size_t>();
+  auto it = packets_by_ssrc_.find(ssrc);
+  return it != packets_by_ssrc_.end() ? it->second : *kNoPackets;
+}
+
+size_t MappedRtpFileReader::FindPacket(uint32_t time_ms) const {
+  // The times are not guaranteed to be increasing in a pcap, so this can't
+  // be a binary search.
+  for (size_t i = 0; i < packets_.size(); ++i) {
+    if (packets_[i].time_ms >= time_ms)
+      return i;
+  }
+  return packets_.size();
+}
+
+void MappedRtpFileReader::Seek(size_t index) {
+  RTC_DCHECK_LE(index, packets_.size());
+  next_packet_ = index;
+}
+
+bool MappedRtpFileReader::NextPacket(RtpPacket* packet) {
+  Packet view;
+  if (!NextPacketView(&view))
+    return false;
+  if (view.length > RtpPacket::kMaxPacketBufferSize) {
+    FATAL() << "Packet is too large to fit: " << view.length << " bytes vs "
+            << RtpPacket::kMaxPacketBufferSize
+            << " bytes allocated. Consider using NextPacketView().";
+  }
+  memcpy(packet->data, view.data, view.length);
+  packet->length = view.length;
+  packet->original_length = view.original_length;
+  packet->time_ms = view.time_ms;
+  return true;
+}
+
+bool MappedRtpFileReader::NextPacketView(Packet* packet) {
+  if (next_packet_ >= packets_.size())
+    return false;
+  *packet = packets_[next_packet_++];
+  return true;
+}
+
+bool MappedRtpFileReader::Init(FileFormat format,
+                               const std::string& filename,
+                               const std::set<uint32_t>& ssrc_filter) {
+  file_ = MappedFile::Open(filename);
+  if (!file_) {
+    printf("ERROR: Can't open file: %s\n", filename.c_str());
+    return false;
+  }
+
+  const std::string index_filename = filename + kIndexFileSuffix;
+  std::vector<IndexEntry> entries;
+  if (!ReadIndexFile(index_filename, format, &entries)) {
+    entries.clear();
+    if (!BuildIndex(format, &entries))
+      return false;
+    WriteIndexFile(index_filename, format, entries);
+  }
+
+  for (const IndexEntry& entry : entries) {
+    const bool is_rtp = (entry.flags & kIndexEntryRtp) != 0;
+    if (!(entry.flags & kIndexEntryRtcp) && !ssrc_filter.empty() &&
+        (!is_rtp || ssrc_filter.find(entry.ssrc) == ssrc_filter.end())) {
+      continue;
+    }
+    Packet packet;
+    packet.data = file_->data() + entry.offset;
+    packet.length = entry.length;
+    packet.original_length = entry.original_length;
+    packet.time_ms = entry.time_ms;
+    packet.ssrc = entry.ssrc;
+    packet.is_rtcp = (entry.flags & kIndexEntryRtcp) != 0;
+    if (is_rtp)
+      packets_by_ssrc_[packet.ssrc].push_back(packets_.size());
+    packets_.push_back(packet);
+  }
+  return true;
+}
+
+bool MappedRtpFileReader::BuildIndex(FileFormat format,
+                                     std::vector<IndexEntry>* entries) const {
+  const uint8_t* const data = file_->data();
+  const size_t size = file_->size();
+
+  auto add_entry = [data, entries](size_t offset, size_t length,
+                                   size_t original_length, uint32_t time_ms,
+                                   bool skip_non_rtp) {
+    IndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.offset = offset;
+    entry.length = static_cast<uint32_t>(length);
+    entry.original_length = static_cast<uint32_t>(original_length);
+    entry.time_ms = time_ms;
+    RtpUtility::RtpHeaderParser parser(data + offset, length);
+    RTPHeader header;
+    if (parser.RTCP()) {
+      entry.flags = kIndexEntryRtcp;
+    } else if (parser.Parse(&header, nullptr)) {
+      entry.flags = kIndexEntryRtp;
+      entry.ssrc = header.ssrc;
+    } else if (skip_non_rtp) {
+      return;
+    }
+    entries->push_back(entry);
+  };
+
+  switch (format) {
+    case kRtpDump: {
+      // Read RTP packets from file in rtpdump format, as documented at:
+      // http://www.cs.columbia.edu/irt/software/rtptools/
+      const char* first_line = reinterpret_cast<const char*>(data);
+      const size_t max_line_length = std::min(size, kRtpDumpFirstLineLength);
+      const void* line_end = memchr(first_line, '\n', max_line_length);
+      if (!line_end)
+        return false;
+      if (strncmp(first_line, "#!rtpplay1.0", 12) != 0 &&
+          strncmp(first_line, "#!RTPencode1.0", 14) != 0) {
+        return false;
+      }
+      size_t pos = static_cast<const uint8_t*>(line_end) - data + 1 +
+                   kRtpDumpFileHeaderSize;
+      if (pos > size)
+        return false;
+      while (pos + kRtpDumpPacketHeaderSize <= size) {
+        uint16_t len = ReadBigEndian16(data + pos);
+        uint16_t plen = ReadBigEndian16(data + pos + 2);
+        uint32_t offset = ReadBigEndian32(data + pos + 4);
+        if (len < kRtpDumpPacketHeaderSize || pos + len > size)
+          break;
+        // A |plen| of 0 specifies RTCP.
+        add_entry(pos + kRtpDumpPacketHeaderSize,
+                  len - kRtpDumpPacketHeaderSize, plen, offset, false);
+        if (plen == 0)
+          entries->back().flags = kIndexEntryRtcp;
+        pos += len;
+      }
+      return true;
+    }
+    case kPcap: {
+      // Read RTP packets from file in tcpdump/libpcap format, as documented
+      // at: http://wiki.wireshark.org/Development/LibpcapFileFormat
+      if (size < kPcapGlobalHeaderSize)
+        return false;
+      bool swap_pcap_byte_order;
+      uint32_t magic = ReadLittleEndian32(data);
+      if (magic == kPcapBOMNoSwapOrder) {
+        swap_pcap_byte_order = false;
+      } else if (magic == kPcapBOMSwapOrder) {
+        swap_pcap_byte_order = true;
+      } else {
+        return false;
+      }
+      auto read_pcap_32 = [swap_pcap_byte_order](const uint8_t* p) {
+        return swap_pcap_byte_order ? ReadBigEndian32(p)
+                                    : ReadLittleEndian32(p);
+      };
+      auto read_pcap_16 = [swap_pcap_byte_order](const uint8_t* p) {
+        return static_cast<uint16_t>(
+            swap_pcap_byte_order ? ReadBigEndian16(p) : (p[1] << 8) | p[0]);
+      };
+      if (read_pcap_16(data + 4) != kPcapVersionMajor ||
+          read_pcap_16(data + 6) != kPcapVersionMinor) {
+        return false;
+      }
+      uint32_t network = read_pcap_32(data + 20);
+      // Accept only LINKTYPE_NULL and LINKTYPE_ETHERNET.
+      // See: http://www.tcpdump.org/linktypes.html
+      if (network != kLinktypeNull && network != kLinktypeEthernet)
+        return false;
+
+      bool has_start_time = false;
+      uint64_t start_time_ms = 0;
+      size_t pos = kPcapGlobalHeaderSize;
+      while (pos + kPcapPacketHeaderSize <= size) {
+        uint32_t ts_sec = read_pcap_32(data + pos);
+        uint32_t ts_usec = read_pcap_32(data + pos + 4);
+        uint32_t incl_len = read_pcap_32(data + pos + 8);
+        pos += kPcapPacketHeaderSize;
+        if (pos + incl_len > size)
+          break;
+        const uint8_t* frame = data + pos;
+        const size_t frame_end = pos + incl_len;
+        pos = frame_end;
+
+        // The BSD null/loopback header is 4 bytes in native byte order, so
+        // both versions are accepted.
+        size_t ip_offset;
+        if (incl_len > kBsdNullHeaderSize &&
+            (ReadBigEndian32(frame) == kBsdNullLoopback1 ||
+             ReadBigEndian32(frame) == kBsdNullLoopback2) &&
+            (frame[kBsdNullHeaderSize] >> 4) == kIpVersion4) {
+          ip_offset = kBsdNullHeaderSize;
+        } else if (incl_len >= kEthernetIIHeaderSize &&
+                   ReadBigEndian16(frame + kEthernetIIHeaderSize - 2) ==
+                       kEthertypeIp) {
+          ip_offset = kEthernetIIHeaderSize;
+        } else {
+          continue;
+        }
+        if (incl_len < ip_offset + kMinIpHeaderLength)
+          continue;
+        const uint8_t* ip = frame + ip_offset;
+        size_t ip_header_length = (ip[0] & 0x0f) * 4;
+        uint16_t fragment = ReadBigEndian16(ip + 6);
+        if ((ip[0] >> 4) != kIpVersion4 ||
+            ip_header_length < kMinIpHeaderLength ||
+            (fragment != kFragmentOffsetClear &&
+             fragment != kFragmentOffsetDoNotFragment) ||
+            ip[9] != kProtocolUdp) {
+          continue;
+        }
+        size_t udp_offset = ip_offset + ip_header_length;
+        if (incl_len < udp_offset + kUdpHeaderLength)
+          continue;
+        uint16_t udp_length = ReadBigEndian16(frame + udp_offset + 4);
+        size_t payload_offset = udp_offset + kUdpHeaderLength;
+        if (udp_length < kUdpHeaderLength ||
+            incl_len < payload_offset + udp_length - kUdpHeaderLength) {
+          continue;
+        }
+        size_t payload_length = udp_length - kUdpHeaderLength;
+
+        // Round to nearest ms, and make the times relative to the first
+        // packet.
+        uint64_t time_ms =
+            (static_cast<uint64_t>(ts_sec) * 1000000 + ts_usec + 500) / 1000;
+        size_t num_entries = entries->size();
+        add_entry(frame - data + payload_offset, payload_length,
+                  payload_length, 0, true);
+        if (entries->size() == num_entries)
+          continue;
+        if (!has_start_time) {
+          has_start_time = true;
+          start_time_ms = time_ms;
+        }
+        entries->back().time_ms = static_cast<uint32_t>(
+            time_ms > start_time_ms ? time_ms - start_time_ms : 0);
+      }
+      printf("Total RTP/RTCP packets: %" PRIuS "\n", entries->size());
+      return true;
+    }
+    case kLengthPacketInterleaved: {
+      size_t pos = 0;
+      uint32_t time_ms = 0;
+      while (pos + 4 <= size) {
+        uint32_t len = ReadBigEndian32(data + pos);
+        pos += 4;
+        if (len > size - pos)
+          break;
+        add_entry(pos, len, len, time_ms, false);
+        time_ms += kLengthPacketInterleavedTimeStepMs;
+        pos += len;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MappedRtpFileReader::ReadIndexFile(
+    const std::string& filename,
+    FileFormat format,
+    std::vector<IndexEntry>* entries) const {
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (!file)
+    return false;
+  IndexFileHeader header;
+  bool valid =
+      fread(&header, sizeof(header), 1, file) == 1 &&
+      memcmp(header.magic, kIndexFileMagic, sizeof(kIndexFileMagic)) == 0 &&
+      header.format == static_cast<uint32_t>(format) &&
+      header.file_size == file_->size() &&
+      header.file_mtime == file_->mtime() &&
+      header.num_entries <= file_->size();
+  if (valid) {
+    entries->resize(static_cast<size_t>(header.num_entries));
+    valid = entries->empty() ||
+            fread(&(*entries)[0], sizeof(IndexEntry), entries->size(), file) ==
+                entries->size();
+  }
+  fclose(file);
+  if (!valid)
+    return false;
+  for (const IndexEntry& entry : *entries) {
+    if (entry.offset > file_->size() ||
+        entry.length > file_->size() - entry.offset) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MappedRtpFileReader::WriteIndexFile(
+    const std::string& filename,
+    FileFormat format,
+    const std::vector<IndexEntry>& entries) const {
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (!file)
+    return;
+  IndexFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kIndexFileMagic, sizeof(kIndexFileMagic));
+  header.format = static_cast<uint32_t>(format);
+  header.file_size = file_->size();
+  header.file_mtime = file_->mtime();
+  header.num_entries = entries.size();
+  bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 (entries.empty() ||
+                  fwrite(&entries[0], sizeof(IndexEntry), entries.size(),
+                         file) == entries.size());
+  fclose(file);
+  // Don't leave a truncated index behind.
+  if (!written)
+    remove(filename.c_str());
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef WEBRTC_TEST_MAPPED_RTP_FILE_READER_H_
+#define WEBRTC_TEST_MAPPED_RTP_FILE_READER_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/test/rtp_file_reader.h"
+
+namespace webrtc {
+namespace test {
+
+// Reads the same formats as RtpFileReader, but maps the whole file into
+// memory instead of reading it packet by packet. The packets are exposed as
+// views into the mapping, so they are not copied and not limited to
+// RtpPacket::kMaxPacketBufferSize.
+//
+// The file is indexed once when it is opened, and the index is stored next
+// to it in "<filename>.rtpindex" so that opening the same file again doesn't
+// have to go through the packets at all. The index is only a cache and is
+// rebuilt whenever it doesn't match the file; failing to write it is not an
+// error.
+class MappedRtpFileReader : public RtpFileReader {
+ public:
+  struct Packet {
+    // Points into the mapping and is valid as long as the reader is.
+    const uint8_t* data;
+    size_t length;
+    // The length the packet had on wire. Zero for RTCP in rtpdump files.
+    size_t original_length;
+    uint32_t time_ms;
+    // Zero for RTCP and for packets that couldn't be parsed as RTP.
+    uint32_t ssrc;
+    bool is_rtcp;
+  };
+
+  // Returns null if the file can't be opened or is not in |format|. Only
+  // packets with an SSRC in |ssrc_filter|, and RTCP, are kept if it is not
+  // empty.
+  static std::unique_ptr<MappedRtpFileReader> Create(
+      FileFormat format,
+      const std::string& filename,
+      const std::set<uint32_t>& ssrc_filter);
+  static std::unique_ptr<MappedRtpFileReader> Create(
+      FileFormat format,
+      const std::string& filename);
+
+  ~MappedRtpFileReader() override;
+
+  size_t num_packets() const { return packets_.size(); }
+  const Packet& packet(size_t index) const { return packets_[index]; }
+
+  // The SSRCs of the RTP packets in the file, in increasing order.
+  std::vector<uint32_t> Ssrcs() const;
+  // The indices of the packets with |ssrc|, in file order.
+  const std::vector<size_t>& PacketsWithSsrc(uint32_t ssrc) const;
+  // Returns the index of the first packet at or after |time_ms|, or
+  // num_packets() if there is none.
+  size_t FindPacket(uint32_t time_ms) const;
+
+  // Makes the next call to NextPacket() or NextPacketView() return the
+  // packet at |index|.
+  void Seek(size_t index);
+
+  // Copies the next packet into |packet|, as the other RtpFileReaders do.
+  bool NextPacket(RtpPacket* packet) override;
+  // Returns the next packet without copying it.
+  bool NextPacketView(Packet* packet);
+
+ private:
+  class MappedFile;
+  struct IndexEntry;
+
+  MappedRtpFileReader();
+
+  bool Init(FileFormat format,
+            const std::string& filename,
+            const std::set<uint32_t>& ssrc_filter);
+  bool BuildIndex(FileFormat format, std::vector<IndexEntry>* entries) const;
+  bool ReadIndexFile(const std::string& filename,
+                     FileFormat format,
+                     std::vector<IndexEntry>* entries) const;
+  void WriteIndexFile(const std::string& filename,
+                      FileFormat format,
+                      const std::vector<IndexEntry>& entries) const;
+
+  std::unique_ptr<MappedFile> file_;
+  std::vector<Packet> packets_;
+  std::map<uint32_t, std::vector<size_t>> packets_by_ssrc_;
+  size_t next_packet_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MappedRtpFileReader);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_TEST_MAPPED_RTP_FILE_READER_H_
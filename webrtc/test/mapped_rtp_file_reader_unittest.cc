@@ -0,0 +1,203 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/test/mapped_rtp_file_reader.h"
+#include "webrtc/test/rtp_file_writer.h"
+#include "webrtc/test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint32_t kSsrc1 = 0x11223344;
+const uint32_t kSsrc2 = 0x55667788;
+
+size_t WriteRtpHeader(uint32_t ssrc, uint16_t sequence_number, uint8_t* data) {
+  data[0] = 0x80;
+  data[1] = 100;
+  data[2] = sequence_number >> 8;
+  data[3] = sequence_number & 0xff;
+  memset(&data[4], 0, 4);
+  for (int i = 0; i < 4; ++i)
+    data[8 + i] = ssrc >> (24 - 8 * i);
+  return 12;
+}
+
+}  // namespace
+
+class MappedRtpFileReaderTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    filename_ = test::OutputPath() + "mapped_rtp_file_reader_test.rtp";
+  }
+
+  void TearDown() override {
+    remove(filename_.c_str());
+    remove((filename_ + ".rtpindex").c_str());
+  }
+
+  // Writes |num_packets| RTP packets, alternating between two SSRCs and 10 ms
+  // apart, followed by an RTCP packet.
+  void WriteRtpDump(int num_packets) {
+    std::unique_ptr<test::RtpFileWriter> writer(
+        test::RtpFileWriter::Create(test::RtpFileWriter::kRtpDump, filename_));
+    ASSERT_TRUE(writer);
+    test::RtpPacket packet;
+    for (int i = 0; i < num_packets; ++i) {
+      packet.length = WriteRtpHeader(i % 2 ? kSsrc2 : kSsrc1, i, packet.data);
+      memset(&packet.data[packet.length], i, 10);
+      packet.length += 10;
+      packet.original_length = packet.length;
+      packet.time_ms = i * 10;
+      ASSERT_TRUE(writer->WritePacket(&packet));
+    }
+    // An RTCP receiver report.
+    const uint8_t kRtcp[] = {0x80, 201, 0, 1, 0x11, 0x22, 0x33, 0x44};
+    memcpy(packet.data, kRtcp, sizeof(kRtcp));
+    packet.length = sizeof(kRtcp);
+    packet.original_length = 0;
+    packet.time_ms = num_packets * 10;
+    ASSERT_TRUE(writer->WritePacket(&packet));
+  }
+
+  void ExpectSameAsRtpFileReader(test::MappedRtpFileReader* mapped_reader) {
+    std::unique_ptr<test::RtpFileReader> reader(
+        test::RtpFileReader::Create(test::RtpFileReader::kRtpDump, filename_));
+    ASSERT_TRUE(reader);
+    test::RtpPacket packet;
+    test::MappedRtpFileReader::Packet view;
+    size_t num_packets = 0;
+    while (reader->NextPacket(&packet)) {
+      ASSERT_TRUE(mapped_reader->NextPacketView(&view));
+      ASSERT_EQ(packet.length, view.length);
+      EXPECT_EQ(packet.original_length, view.original_length);
+      EXPECT_EQ(packet.time_ms, view.time_ms);
+      EXPECT_EQ(0, memcmp(packet.data, view.data, view.length));
+      ++num_packets;
+    }
+    EXPECT_FALSE(mapped_reader->NextPacketView(&view));
+    EXPECT_EQ(mapped_reader->num_packets(), num_packets);
+  }
+
+ protected:
+  std::string filename_;
+};
+
+TEST_F(MappedRtpFileReaderTest, ReadsRtpDump) {
+  WriteRtpDump(10);
+  std::unique_ptr<test::MappedRtpFileReader> reader(
+      test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                        filename_));
+  ASSERT_TRUE(reader);
+  ASSERT_EQ(11u, reader->num_packets());
+  EXPECT_TRUE(reader->packet(10).is_rtcp);
+  EXPECT_EQ(kSsrc2, reader->packet(3).ssrc);
+  EXPECT_EQ(std::vector<uint32_t>({kSsrc1, kSsrc2}), reader->Ssrcs());
+  EXPECT_EQ(std::vector<size_t>({1, 3, 5, 7, 9}),
+            reader->PacketsWithSsrc(kSsrc2));
+  EXPECT_TRUE(reader->PacketsWithSsrc(0).empty());
+  ExpectSameAsRtpFileReader(reader.get());
+}
+
+TEST_F(MappedRtpFileReaderTest, ReusesIndexFile) {
+  WriteRtpDump(10);
+  ASSERT_TRUE(test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                                filename_));
+  FILE* index = fopen((filename_ + ".rtpindex").c_str(), "rb");
+  ASSERT_TRUE(index != nullptr);
+  fclose(index);
+
+  std::unique_ptr<test::MappedRtpFileReader> reader(
+      test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                        filename_));
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(std::vector<size_t>({0, 2, 4, 6, 8}),
+            reader->PacketsWithSsrc(kSsrc1));
+  ExpectSameAsRtpFileReader(reader.get());
+}
+
+TEST_F(MappedRtpFileReaderTest, RebuildsStaleIndexFile) {
+  WriteRtpDump(10);
+  ASSERT_TRUE(test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                                filename_));
+  WriteRtpDump(4);
+  std::unique_ptr<test::MappedRtpFileReader> reader(
+      test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                        filename_));
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(5u, reader->num_packets());
+  ExpectSameAsRtpFileReader(reader.get());
+}
+
+TEST_F(MappedRtpFileReaderTest, FiltersAndSeeks) {
+  WriteRtpDump(10);
+  std::unique_ptr<test::MappedRtpFileReader> reader(
+      test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                        filename_, {kSsrc1}));
+  ASSERT_TRUE(reader);
+  // The RTCP packet is kept.
+  ASSERT_EQ(6u, reader->num_packets());
+  EXPECT_EQ(std::vector<uint32_t>({kSsrc1}), reader->Ssrcs());
+
+  size_t index = reader->FindPacket(35);
+  ASSERT_EQ(2u, index);
+  reader->Seek(index);
+  test::RtpPacket packet;
+  ASSERT_TRUE(reader->NextPacket(&packet));
+  EXPECT_EQ(40u, packet.time_ms);
+  EXPECT_EQ(reader->num_packets(), reader->FindPacket(1000));
+}
+
+TEST_F(MappedRtpFileReaderTest, ReadsPcap) {
+  // A pcap with two Ethernet II/IPv4/UDP frames carrying RTP, 20 ms apart.
+  FILE* file = fopen(filename_.c_str(), "wb");
+  ASSERT_TRUE(file != nullptr);
+  // The headers are in host byte order, as given by the magic number.
+  const uint32_t kMagic = 0xa1b2c3d4;
+  const uint16_t kVersion[] = {2, 4};
+  const uint32_t kGlobalHeader[] = {0, 0, 65535, 1};
+  fwrite(&kMagic, sizeof(kMagic), 1, file);
+  fwrite(kVersion, sizeof(kVersion), 1, file);
+  fwrite(kGlobalHeader, sizeof(kGlobalHeader), 1, file);
+  for (uint32_t i = 0; i < 2; ++i) {
+    uint8_t frame[14 + 20 + 8 + 12 + 4] = {0};
+    frame[12] = 0x08;  // Ethertype IP.
+    uint8_t* ip = &frame[14];
+    ip[0] = 0x45;
+    ip[9] = 0x11;  // UDP.
+    uint8_t* udp = &ip[20];
+    udp[5] = 8 + 12 + 4;
+    WriteRtpHeader(kSsrc1, i, &udp[8]);
+    const uint32_t kPacketHeader[] = {1000, i * 20000, sizeof(frame),
+                                      sizeof(frame)};
+    fwrite(kPacketHeader, sizeof(kPacketHeader), 1, file);
+    fwrite(frame, sizeof(frame), 1, file);
+  }
+  fclose(file);
+
+  std::unique_ptr<test::MappedRtpFileReader> reader(
+      test::MappedRtpFileReader::Create(test::RtpFileReader::kPcap, filename_));
+  ASSERT_TRUE(reader);
+  ASSERT_EQ(2u, reader->num_packets());
+  EXPECT_EQ(16u, reader->packet(1).length);
+  EXPECT_EQ(20u, reader->packet(1).time_ms);
+  EXPECT_EQ(kSsrc1, reader->packet(1).ssrc);
+  EXPECT_FALSE(test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                                 filename_));
+}
+
+}  // namespace webrtc
@@ -43,6 +43,7 @@ class MockVoEChannelProxy : public voe::ChannelProxy {
   MOCK_CONST_METHOD0(GetDecodingCallStatistics, AudioDecodingCallStats());
   MOCK_CONST_METHOD0(GetSpeechOutputLevelFullRange, int32_t());
   MOCK_CONST_METHOD0(GetDelayEstimate, uint32_t());
+  MOCK_CONST_METHOD0(PlayoutInDtx, bool());
   MOCK_METHOD1(SetSendTelephoneEventPayloadType, bool(int payload_type));
   MOCK_METHOD2(SendTelephoneEventOutband, bool(int event, int duration_ms));
   MOCK_METHOD1(SetInputMute, void(bool muted));
@@ -50,15 +51,18 @@ class MockVoEChannelProxy : public voe::ChannelProxy {
   // MOCK_METHOD1(SetSink, void(std::unique_ptr<AudioSinkInterface> sink));
   MOCK_METHOD1(RegisterExternalTransport, void(Transport* transport));
   MOCK_METHOD0(DeRegisterExternalTransport, void());
-  MOCK_METHOD3(ReceivedRTPPacket, bool(const uint8_t* packet,
-                                       size_t length,
-                                       const PacketTime& packet_time));
+  MOCK_METHOD3(OnRtpPacket, bool(const uint8_t* packet,
+                                 size_t length,
+                                 const RTPHeader& header));
   MOCK_METHOD2(ReceivedRTCPPacket, bool(const uint8_t* packet, size_t length));
   MOCK_CONST_METHOD0(GetAudioDecoderFactory,
                      const rtc::scoped_refptr<AudioDecoderFactory>&());
   MOCK_METHOD1(SetChannelOutputVolumeScaling, void(float scaling));
   MOCK_METHOD1(SetRtcEventLog, void(RtcEventLog* event_log));
   MOCK_METHOD1(SetBitrate, void(int bitrate_bps));
+  MOCK_METHOD1(EnableAudioNetworkAdaptor, bool(bool enable));
+  MOCK_METHOD2(OnUplinkNetworkMetrics,
+               void(int uplink_bandwidth_bps, int64_t rtt_ms));
 };
 }  // namespace test
 }  // namespace webrtc
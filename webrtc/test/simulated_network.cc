@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "webrtc/test/simulated_network.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+namespace test {
+
+SimulatedNetwork::SimulatedNetwork(int64_t start_time_ms)
+    : clock_(start_time_ms * 1000) {}
+
+SimulatedNetwork::~SimulatedNetwork() {}
+
+FakeNetworkPipe* SimulatedNetwork::CreateLink(
+    const FakeNetworkPipe::Config& config,
+    uint64_t seed) {
+  links_.emplace_back(new FakeNetworkPipe(&clock_, config, seed));
+  return links_.back().get();
+}
+
+void SimulatedNetwork::AdvanceTimeMilliseconds(int64_t time_ms) {
+  RTC_DCHECK_GE(time_ms, 0);
+  const int64_t end_time_ms = clock_.TimeInMilliseconds() + time_ms;
+  ProcessLinks();
+  while (true) {
+    const int64_t now_ms = clock_.TimeInMilliseconds();
+    int64_t next_time_ms = end_time_ms;
+    for (const auto& link : links_) {
+      next_time_ms =
+          std::min(next_time_ms, now_ms + link->TimeUntilNextProcess());
+    }
+    clock_.AdvanceTimeMilliseconds(next_time_ms - now_ms);
+    ProcessLinks();
+    if (next_time_ms == end_time_ms)
+      break;
+  }
+}
+
+void SimulatedNetwork::ProcessLinks() {
+  // A packet leaving one link may already be due on the next one, so keep
+  // going until no link has anything left to do right now.
+  bool packets_due = true;
+  while (packets_due) {
+    for (const auto& link : links_)
+      link->Process();
+    packets_due = false;
+    for (const auto& link : links_) {
+      if (link->TimeUntilNextProcess() == 0)
+        packets_due = true;
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef WEBRTC_TEST_SIMULATED_NETWORK_H_
+#define WEBRTC_TEST_SIMULATED_NETWORK_H_
+
+#include <memory>
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/test/fake_network_pipe.h"
+
+namespace webrtc {
+namespace test {
+
+// A set of FakeNetworkPipes sharing one simulated clock, all processed on the
+// calling thread. Unlike DirectTransport, which needs a thread per link and
+// runs in real time, time only moves in AdvanceTimeMilliseconds(), jumping
+// from one packet event to the next, so a network of many links runs as fast
+// as the packets can be processed.
+//
+// Links are connected with FakeNetworkPipe::SetNextPipe() to build a
+// topology, e.g. the access links of several senders feeding one shared
+// bottleneck link, and end in a PacketReceiver. Cross traffic is sent into a
+// link like any other packets. Forwarding between links doesn't copy the
+// packets.
+//
+// Everything that uses clock(), including the senders into the links, must
+// run on the thread calling AdvanceTimeMilliseconds().
+class SimulatedNetwork {
+ public:
+  explicit SimulatedNetwork(int64_t start_time_ms);
+  ~SimulatedNetwork();
+
+  Clock* clock() { return &clock_; }
+
+  // Creates a link that is owned by, and processed with, the network. The
+  // |seed| drives the link's random loss and delay.
+  FakeNetworkPipe* CreateLink(const FakeNetworkPipe::Config& config,
+                              uint64_t seed);
+
+  // Moves the clock forward by |time_ms|, stopping at every time a link has a
+  // packet due and processing the links.
+  void AdvanceTimeMilliseconds(int64_t time_ms);
+
+ private:
+  void ProcessLinks();
+
+  SimulatedClock clock_;
+  std::vector<std::unique_ptr<FakeNetworkPipe>> links_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SimulatedNetwork);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // WEBRTC_TEST_SIMULATED_NETWORK_H_
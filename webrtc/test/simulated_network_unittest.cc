@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include "webrtc/call.h"
+#include "webrtc/test/simulated_network.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+class RecordingReceiver : public PacketReceiver {
+ public:
+  DeliveryStatus DeliverPacket(MediaType media_type,
+                               const uint8_t* packet,
+                               size_t length,
+                               const PacketTime& packet_time) override {
+    delivered_packets.push_back(packet);
+    return DELIVERY_OK;
+  }
+
+  std::vector<const uint8_t*> delivered_packets;
+};
+
+}  // namespace
+
+// Two senders share an 80 kbps bottleneck behind their own access links, so
+// their 160 kb take two seconds to get through.
+TEST(SimulatedNetworkTest, SharedBottleneck) {
+  SimulatedNetwork network(100000);
+  FakeNetworkPipe::Config access_config;
+  access_config.queue_delay_ms = 10;
+  FakeNetworkPipe::Config bottleneck_config;
+  bottleneck_config.link_capacity_kbps = 80;
+  FakeNetworkPipe* access_1 = network.CreateLink(access_config, 1);
+  FakeNetworkPipe* access_2 = network.CreateLink(access_config, 2);
+  FakeNetworkPipe* bottleneck = network.CreateLink(bottleneck_config, 3);
+  RecordingReceiver receiver;
+  access_1->SetNextPipe(bottleneck);
+  access_2->SetNextPipe(bottleneck);
+  bottleneck->SetReceiver(&receiver);
+
+  const int kNumPackets = 10;
+  const size_t kPacketSize = 1000;
+  std::vector<rtc::CopyOnWriteBuffer> packets;
+  for (int i = 0; i < 2 * kNumPackets; ++i)
+    packets.push_back(rtc::CopyOnWriteBuffer(kPacketSize));
+  for (int i = 0; i < kNumPackets; ++i) {
+    access_1->SendPacket(packets[2 * i]);
+    access_2->SendPacket(packets[2 * i + 1]);
+  }
+
+  network.AdvanceTimeMilliseconds(1000);
+  EXPECT_EQ(9u, receiver.delivered_packets.size());
+  network.AdvanceTimeMilliseconds(1010);
+  ASSERT_EQ(2u * kNumPackets, receiver.delivered_packets.size());
+  EXPECT_EQ(102010, network.clock()->TimeInMilliseconds());
+
+  // The packets were forwarded across both links without being copied.
+  for (const uint8_t* delivered : receiver.delivered_packets) {
+    bool found = false;
+    for (const rtc::CopyOnWriteBuffer& packet : packets)
+      found |= packet.cdata() == delivered;
+    EXPECT_TRUE(found);
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
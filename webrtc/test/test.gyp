@@ -31,6 +31,8 @@
       'target_name': 'rtp_test_utils',
       'type': 'static_library',
       'sources': [
+        'mapped_rtp_file_reader.cc',
+        'mapped_rtp_file_reader.h',
         'rtcp_packet_parser.cc',
         'rtcp_packet_parser.h',
         'rtp_file_reader.cc',
@@ -183,6 +185,8 @@
        'null_transport.cc',
        'null_transport.h',
        'rtp_rtcp_observer.h',
+       'simulated_network.cc',
+       'simulated_network.h',
        'statistics.cc',
        'statistics.h',
        'vcm_capturer.cc',
@@ -11,6 +11,8 @@
 #include "webrtc/tools/event_log_visualizer/analyzer.h"
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <sstream>
@@ -268,44 +270,50 @@ void MovingAverage(const std::vector<typename Extractor::DataType>& data,
 }  // namespace
 
 EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
-    : parsed_log_(log), window_duration_(250000), step_(10000) {
-  uint64_t first_timestamp = std::numeric_limits<uint64_t>::max();
-  uint64_t last_timestamp = std::numeric_limits<uint64_t>::min();
+    : EventLogAnalyzer() {
+  AddEvents(log);
+}
 
-  // Maps a stream identifier consisting of ssrc and direction
-  // to the header extensions used by that stream,
-  std::map<StreamId, RtpHeaderExtensionMap> extension_maps;
+EventLogAnalyzer::EventLogAnalyzer()
+    : window_duration_(250000),
+      step_(10000),
+      first_timestamp_(std::numeric_limits<uint64_t>::max()),
+      last_timestamp_(std::numeric_limits<uint64_t>::min()),
+      begin_time_(0),
+      end_time_(0),
+      call_duration_s_(0) {}
 
+void EventLogAnalyzer::AddEvents(const ParsedRtcEventLog& parsed_log) {
   PacketDirection direction;
   uint8_t header[IP_PACKET_SIZE];
   size_t header_length;
   size_t total_length;
 
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
+  for (size_t i = 0; i < parsed_log.GetNumberOfEvents(); i++) {
+    ParsedRtcEventLog::EventType event_type = parsed_log.GetEventType(i);
     if (event_type != ParsedRtcEventLog::VIDEO_RECEIVER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::VIDEO_SENDER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::AUDIO_RECEIVER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::AUDIO_SENDER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::LOG_START &&
         event_type != ParsedRtcEventLog::LOG_END) {
-      uint64_t timestamp = parsed_log_.GetTimestamp(i);
-      first_timestamp = std::min(first_timestamp, timestamp);
-      last_timestamp = std::max(last_timestamp, timestamp);
+      uint64_t timestamp = parsed_log.GetTimestamp(i);
+      first_timestamp_ = std::min(first_timestamp_, timestamp);
+      last_timestamp_ = std::max(last_timestamp_, timestamp);
     }
 
-    switch (parsed_log_.GetEventType(i)) {
+    switch (parsed_log.GetEventType(i)) {
       case ParsedRtcEventLog::VIDEO_RECEIVER_CONFIG_EVENT: {
         VideoReceiveStream::Config config(nullptr);
-        parsed_log_.GetVideoReceiveConfig(i, &config);
+        parsed_log.GetVideoReceiveConfig(i, &config);
         StreamId stream(config.rtp.remote_ssrc, kIncomingPacket);
         RegisterHeaderExtensions(config.rtp.extensions,
-                                 &extension_maps[stream]);
+                                 &extension_maps_[stream]);
         video_ssrcs_.insert(stream);
         for (auto kv : config.rtp.rtx) {
           StreamId rtx_stream(kv.second.ssrc, kIncomingPacket);
           RegisterHeaderExtensions(config.rtp.extensions,
-                                   &extension_maps[rtx_stream]);
+                                   &extension_maps_[rtx_stream]);
           video_ssrcs_.insert(rtx_stream);
           rtx_ssrcs_.insert(rtx_stream);
         }
@@ -313,17 +321,17 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
       case ParsedRtcEventLog::VIDEO_SENDER_CONFIG_EVENT: {
         VideoSendStream::Config config(nullptr);
-        parsed_log_.GetVideoSendConfig(i, &config);
+        parsed_log.GetVideoSendConfig(i, &config);
         for (auto ssrc : config.rtp.ssrcs) {
           StreamId stream(ssrc, kOutgoingPacket);
           RegisterHeaderExtensions(config.rtp.extensions,
-                                   &extension_maps[stream]);
+                                   &extension_maps_[stream]);
           video_ssrcs_.insert(stream);
         }
         for (auto ssrc : config.rtp.rtx.ssrcs) {
           StreamId rtx_stream(ssrc, kOutgoingPacket);
           RegisterHeaderExtensions(config.rtp.extensions,
-                                   &extension_maps[rtx_stream]);
+                                   &extension_maps_[rtx_stream]);
           video_ssrcs_.insert(rtx_stream);
           rtx_ssrcs_.insert(rtx_stream);
         }
@@ -341,7 +349,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
       case ParsedRtcEventLog::RTP_EVENT: {
         MediaType media_type;
-        parsed_log_.GetRtpHeader(i, &direction, &media_type, header,
+        parsed_log.GetRtpHeader(i, &direction, &media_type, header,
                                  &header_length, &total_length);
         // Parse header to get SSRC.
         RtpUtility::RtpHeaderParser rtp_parser(header, header_length);
@@ -349,11 +357,11 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
         rtp_parser.Parse(&parsed_header);
         StreamId stream(parsed_header.ssrc, direction);
         // Look up the extension_map and parse it again to get the extensions.
-        if (extension_maps.count(stream) == 1) {
-          RtpHeaderExtensionMap* extension_map = &extension_maps[stream];
+        if (extension_maps_.count(stream) == 1) {
+          RtpHeaderExtensionMap* extension_map = &extension_maps_[stream];
           rtp_parser.Parse(&parsed_header, extension_map);
         }
-        uint64_t timestamp = parsed_log_.GetTimestamp(i);
+        uint64_t timestamp = parsed_log.GetTimestamp(i);
         rtp_packets_[stream].push_back(
             LoggedRtpPacket(timestamp, parsed_header, total_length));
         break;
@@ -361,7 +369,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       case ParsedRtcEventLog::RTCP_EVENT: {
         uint8_t packet[IP_PACKET_SIZE];
         MediaType media_type;
-        parsed_log_.GetRtcpPacket(i, &direction, &media_type, packet,
+        parsed_log.GetRtcpPacket(i, &direction, &media_type, packet,
                                   &total_length);
 
         RtpUtility::RtpHeaderParser rtp_parser(packet, total_length);
@@ -382,7 +390,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
                 std::unique_ptr<rtcp::RtcpPacket> rtcp_packet(
                     rtcp_parser.ReleaseRtcpPacket());
                 StreamId stream(ssrc, direction);
-                uint64_t timestamp = parsed_log_.GetTimestamp(i);
+                uint64_t timestamp = parsed_log.GetTimestamp(i);
                 rtcp_packets_[stream].push_back(LoggedRtcpPacket(
                     timestamp, kRtcpTransportFeedback, std::move(rtcp_packet)));
               }
@@ -404,8 +412,8 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
       case ParsedRtcEventLog::BWE_PACKET_LOSS_EVENT: {
         BwePacketLossEvent bwe_update;
-        bwe_update.timestamp = parsed_log_.GetTimestamp(i);
-        parsed_log_.GetBwePacketLossEvent(i, &bwe_update.new_bitrate,
+        bwe_update.timestamp = parsed_log.GetTimestamp(i);
+        parsed_log.GetBwePacketLossEvent(i, &bwe_update.new_bitrate,
                                              &bwe_update.fraction_loss,
                                              &bwe_update.expected_packets);
         bwe_loss_updates_.push_back(bwe_update);
@@ -415,6 +423,9 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
         break;
       }
       case ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT: {
+        uint32_t ssrc;
+        parsed_log.GetAudioPlayout(i, &ssrc);
+        audio_playouts_[ssrc].push_back(parsed_log.GetTimestamp(i));
         break;
       }
       case ParsedRtcEventLog::UNKNOWN_EVENT: {
@@ -423,12 +434,13 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
     }
   }
 
-  if (last_timestamp < first_timestamp) {
+  if (last_timestamp_ < first_timestamp_) {
     // No useful events in the log.
-    first_timestamp = last_timestamp = 0;
+    begin_time_ = end_time_ = 0;
+  } else {
+    begin_time_ = first_timestamp_;
+    end_time_ = last_timestamp_;
   }
-  begin_time_ = first_timestamp;
-  end_time_ = last_timestamp;
   call_duration_s_ = static_cast<float>(end_time_ - begin_time_) / 1000000;
 }
 
@@ -487,7 +499,7 @@ std::string EventLogAnalyzer::GetStreamName(StreamId stream_id) const {
 }
 
 void EventLogAnalyzer::CreatePacketGraph(PacketDirection desired_direction,
-                                         Plot* plot) {
+                                         Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -519,7 +531,7 @@ void EventLogAnalyzer::CreateAccumulatedPacketsTimeSeries(
     PacketDirection desired_direction,
     Plot* plot,
     const std::map<StreamId, std::vector<T>>& packets,
-    const std::string& label_prefix) {
+    const std::string& label_prefix) const {
   for (auto& kv : packets) {
     StreamId stream_id = kv.first;
     const std::vector<T>& packet_stream = kv.second;
@@ -546,7 +558,7 @@ void EventLogAnalyzer::CreateAccumulatedPacketsTimeSeries(
 
 void EventLogAnalyzer::CreateAccumulatedPacketsGraph(
     PacketDirection desired_direction,
-    Plot* plot) {
+    Plot* plot) const {
   CreateAccumulatedPacketsTimeSeries(desired_direction, plot, rtp_packets_,
                                      "RTP");
   CreateAccumulatedPacketsTimeSeries(desired_direction, plot, rtcp_packets_,
@@ -562,28 +574,24 @@ void EventLogAnalyzer::CreateAccumulatedPacketsGraph(
 }
 
 // For each SSRC, plot the time between the consecutive playouts.
-void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) {
+void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) const {
   std::map<uint32_t, TimeSeries> time_series;
-  std::map<uint32_t, uint64_t> last_playout;
-
-  uint32_t ssrc;
-
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT) {
-      parsed_log_.GetAudioPlayout(i, &ssrc);
-      uint64_t timestamp = parsed_log_.GetTimestamp(i);
-      if (MatchingSsrc(ssrc, desired_ssrc_)) {
-        float x = static_cast<float>(timestamp - begin_time_) / 1000000;
-        float y = static_cast<float>(timestamp - last_playout[ssrc]) / 1000;
-        if (time_series[ssrc].points.size() == 0) {
-          // There were no previusly logged playout for this SSRC.
-          // Generate a point, but place it on the x-axis.
-          y = 0;
-        }
-        time_series[ssrc].points.push_back(TimeSeriesPoint(x, y));
-        last_playout[ssrc] = timestamp;
+
+  for (const auto& kv : audio_playouts_) {
+    uint32_t ssrc = kv.first;
+    if (!MatchingSsrc(ssrc, desired_ssrc_))
+      continue;
+    uint64_t last_playout = 0;
+    for (uint64_t timestamp : kv.second) {
+      float x = static_cast<float>(timestamp - begin_time_) / 1000000;
+      float y = static_cast<float>(timestamp - last_playout) / 1000;
+      if (time_series[ssrc].points.size() == 0) {
+        // There were no previusly logged playout for this SSRC.
+        // Generate a point, but place it on the x-axis.
+        y = 0;
       }
+      time_series[ssrc].points.push_back(TimeSeriesPoint(x, y));
+      last_playout = timestamp;
     }
   }
 
@@ -601,7 +609,7 @@ void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) {
 }
 
 // For each SSRC, plot the time between the consecutive playouts.
-void EventLogAnalyzer::CreateSequenceNumberGraph(Plot* plot) {
+void EventLogAnalyzer::CreateSequenceNumberGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -624,7 +632,7 @@ void EventLogAnalyzer::CreateSequenceNumberGraph(Plot* plot) {
   plot->SetTitle("Sequence number");
 }
 
-void EventLogAnalyzer::CreateIncomingPacketLossGraph(Plot* plot) {
+void EventLogAnalyzer::CreateIncomingPacketLossGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -669,7 +677,7 @@ void EventLogAnalyzer::CreateIncomingPacketLossGraph(Plot* plot) {
   plot->SetTitle("Estimated incoming loss rate");
 }
 
-void EventLogAnalyzer::CreateDelayChangeGraph(Plot* plot) {
+void EventLogAnalyzer::CreateDelayChangeGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -702,7 +710,7 @@ void EventLogAnalyzer::CreateDelayChangeGraph(Plot* plot) {
   plot->SetTitle("Network latency change between consecutive packets");
 }
 
-void EventLogAnalyzer::CreateAccumulatedDelayChangeGraph(Plot* plot) {
+void EventLogAnalyzer::CreateAccumulatedDelayChangeGraph(Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -736,7 +744,7 @@ void EventLogAnalyzer::CreateAccumulatedDelayChangeGraph(Plot* plot) {
 }
 
 // Plot the fraction of packets lost (as perceived by the loss-based BWE).
-void EventLogAnalyzer::CreateFractionLossGraph(Plot* plot) {
+void EventLogAnalyzer::CreateFractionLossGraph(Plot* plot) const {
   plot->series_list_.push_back(TimeSeries());
   for (auto& bwe_update : bwe_loss_updates_) {
     float x = static_cast<float>(bwe_update.timestamp - begin_time_) / 1000000;
@@ -755,7 +763,7 @@ void EventLogAnalyzer::CreateFractionLossGraph(Plot* plot) {
 // Plot the total bandwidth used by all RTP streams.
 void EventLogAnalyzer::CreateTotalBitrateGraph(
     PacketDirection desired_direction,
-    Plot* plot) {
+    Plot* plot) const {
   struct TimestampSize {
     TimestampSize(uint64_t t, size_t s) : timestamp(t), size(s) {}
     uint64_t timestamp;
@@ -763,21 +771,18 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
   };
   std::vector<TimestampSize> packets;
 
-  PacketDirection direction;
-  size_t total_length;
-
   // Extract timestamps and sizes for the relevant packets.
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::RTP_EVENT) {
-      parsed_log_.GetRtpHeader(i, &direction, nullptr, nullptr, nullptr,
-                               &total_length);
-      if (direction == desired_direction) {
-        uint64_t timestamp = parsed_log_.GetTimestamp(i);
-        packets.push_back(TimestampSize(timestamp, total_length));
-      }
-    }
+  for (const auto& kv : rtp_packets_) {
+    if (kv.first.GetDirection() != desired_direction)
+      continue;
+    for (const LoggedRtpPacket& rtp_packet : kv.second)
+      packets.push_back(
+          TimestampSize(rtp_packet.timestamp, rtp_packet.total_length));
   }
+  std::stable_sort(packets.begin(), packets.end(),
+                   [](const TimestampSize& a, const TimestampSize& b) {
+                     return a.timestamp < b.timestamp;
+                   });
 
   size_t window_index_begin = 0;
   size_t window_index_end = 0;
@@ -837,7 +842,7 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
 // For each SSRC, plot the bandwidth used by that stream.
 void EventLogAnalyzer::CreateStreamBitrateGraph(
     PacketDirection desired_direction,
-    Plot* plot) {
+    Plot* plot) const {
   for (auto& kv : rtp_packets_) {
     StreamId stream_id = kv.first;
     const std::vector<LoggedRtpPacket>& packet_stream = kv.second;
@@ -866,7 +871,9 @@ void EventLogAnalyzer::CreateStreamBitrateGraph(
   }
 }
 
-void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
+void EventLogAnalyzer::SimulateBwe(TimeSeries* estimate,
+                                   TimeSeries* acked_time_series,
+                                   TimeSeries* network_delay) const {
   std::map<uint64_t, const LoggedRtpPacket*> outgoing_rtp;
   std::map<uint64_t, const LoggedRtcpPacket*> incoming_rtcp;
 
@@ -893,13 +900,6 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
   static const uint32_t kDefaultStartBitrateBps = 300000;
   cc.SetBweBitrates(0, kDefaultStartBitrateBps, -1);
 
-  TimeSeries time_series;
-  time_series.label = "Delay-based estimate";
-  time_series.style = LINE_DOT_GRAPH;
-  TimeSeries acked_time_series;
-  acked_time_series.label = "Acked bitrate";
-  acked_time_series.style = LINE_DOT_GRAPH;
-
   auto rtp_iterator = outgoing_rtp.begin();
   auto rtcp_iterator = incoming_rtcp.begin();
 
@@ -949,7 +949,13 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
           y = *bitrate_bps / 1000;
         float x = static_cast<float>(clock.TimeInMicroseconds() - begin_time_) /
                   1000000;
-        acked_time_series.points.emplace_back(x, y);
+        acked_time_series->points.emplace_back(x, y);
+        if (network_delay) {
+          for (const PacketInfo& packet : feedback) {
+            network_delay->points.emplace_back(
+                x, packet.arrival_time_ms - packet.send_time_ms);
+          }
+        }
       }
       ++rtcp_iterator;
     }
@@ -975,10 +981,22 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
       uint32_t y = observer.last_bitrate_bps() / 1000;
       float x = static_cast<float>(clock.TimeInMicroseconds() - begin_time_) /
                 1000000;
-      time_series.points.emplace_back(x, y);
+      estimate->points.emplace_back(x, y);
     }
     time_us = std::min({NextRtpTime(), NextRtcpTime(), NextProcessTime()});
   }
+}
+
+void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) const {
+  TimeSeries time_series;
+  time_series.label = "Delay-based estimate";
+  time_series.style = LINE_DOT_GRAPH;
+  TimeSeries acked_time_series;
+  acked_time_series.label = "Acked bitrate";
+  acked_time_series.style = LINE_DOT_GRAPH;
+
+  SimulateBwe(&time_series, &acked_time_series, nullptr);
+
   // Add the data set to the plot.
   plot->series_list_.push_back(std::move(time_series));
   plot->series_list_.push_back(std::move(acked_time_series));
@@ -988,7 +1006,70 @@ void EventLogAnalyzer::CreateBweSimulationGraph(Plot* plot) {
   plot->SetTitle("Simulated BWE behavior");
 }
 
-void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) {
+BweSimulationStats EventLogAnalyzer::GetBweSimulationStats() const {
+  TimeSeries estimate;
+  TimeSeries acked_bitrate;
+  TimeSeries network_delay;
+  SimulateBwe(&estimate, &acked_bitrate, &network_delay);
+
+  BweSimulationStats stats;
+  if (!estimate.points.empty()) {
+    // The estimate has converged once it no longer leaves the tolerance
+    // band around its final value.
+    static const float kConvergenceTolerance = 0.2f;
+    const float final_kbps = estimate.points.back().y;
+    stats.convergence_time_s = estimate.points.front().x;
+    for (size_t i = estimate.points.size(); i > 0; --i) {
+      if (std::abs(estimate.points[i - 1].y - final_kbps) >
+          kConvergenceTolerance * final_kbps) {
+        stats.convergence_time_s =
+            estimate.points[std::min(i, estimate.points.size() - 1)].x;
+        break;
+      }
+    }
+
+    // The estimate is a step function; compare each acked bitrate sample to
+    // the estimate in effect at that time.
+    double acked_sum = 0;
+    double estimate_sum = 0;
+    auto estimate_it = estimate.points.begin();
+    for (const TimeSeriesPoint& acked : acked_bitrate.points) {
+      while (std::next(estimate_it) != estimate.points.end() &&
+             std::next(estimate_it)->x <= acked.x) {
+        ++estimate_it;
+      }
+      if (estimate_it->x > acked.x)
+        continue;
+      acked_sum += acked.y;
+      estimate_sum += estimate_it->y;
+    }
+    if (estimate_sum > 0)
+      stats.utilization = static_cast<float>(acked_sum / estimate_sum);
+  }
+
+  if (!network_delay.points.empty()) {
+    // As in CreateNetworkDelayFeedbackGraph, the base network delay is
+    // assumed to be the min delay observed during the call.
+    std::vector<float> queueing_delay_ms;
+    queueing_delay_ms.reserve(network_delay.points.size());
+    for (const TimeSeriesPoint& point : network_delay.points)
+      queueing_delay_ms.push_back(point.y);
+    std::sort(queueing_delay_ms.begin(), queueing_delay_ms.end());
+    const float base_delay_ms = queueing_delay_ms.front();
+    double sum_ms = 0;
+    for (float& delay_ms : queueing_delay_ms) {
+      delay_ms -= base_delay_ms;
+      sum_ms += delay_ms;
+    }
+    stats.mean_queueing_delay_ms =
+        static_cast<float>(sum_ms / queueing_delay_ms.size());
+    stats.p95_queueing_delay_ms =
+        queueing_delay_ms[(queueing_delay_ms.size() - 1) * 95 / 100];
+  }
+  return stats;
+}
+
+void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) const {
   std::map<uint64_t, const LoggedRtpPacket*> outgoing_rtp;
   std::map<uint64_t, const LoggedRtcpPacket*> incoming_rtcp;
 
@@ -21,6 +21,7 @@
 #include "webrtc/call/rtc_event_log_parser.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/rtp_rtcp/source/rtcp_packet.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_header_extension.h"
 #include "webrtc/tools/event_log_visualizer/plot_base.h"
 
 namespace webrtc {
@@ -52,37 +53,66 @@ struct BwePacketLossEvent {
   int32_t expected_packets;
 };
 
+// Summary of a BWE simulation over the logged packets, so that estimator
+// changes can be compared across many logs without inspecting the plots.
+struct BweSimulationStats {
+  // Time from the start of the log until the delay-based estimate stays
+  // within 20% of its final value.
+  float convergence_time_s = 0;
+  // Acked bitrate divided by the estimate, averaged over all feedback.
+  float utilization = 0;
+  // Network delay above the smallest delay observed during the call.
+  float mean_queueing_delay_ms = 0;
+  float p95_queueing_delay_ms = 0;
+};
+
 class EventLogAnalyzer {
  public:
-  // The EventLogAnalyzer keeps a reference to the ParsedRtcEventLog for the
-  // duration of its lifetime. The ParsedRtcEventLog must not be destroyed or
-  // modified while the EventLogAnalyzer is being used.
+  // Analyzes all events of |log|.
   explicit EventLogAnalyzer(const ParsedRtcEventLog& log);
 
-  void CreatePacketGraph(PacketDirection desired_direction, Plot* plot);
+  // Creates an analyzer to which the events of a log are added with
+  // AddEvents(), e.g. chunk by chunk while the log is parsed incrementally.
+  // Only the data needed for the plots is kept, so the parsed events can be
+  // dropped once they have been added.
+  EventLogAnalyzer();
+
+  // Adds the currently parsed events of |log|, which must follow the events
+  // added earlier.
+  void AddEvents(const ParsedRtcEventLog& log);
+
+  // The plots only read the analyzed data, so different plots can be created
+  // concurrently once all events have been added.
+  void CreatePacketGraph(PacketDirection desired_direction, Plot* plot) const;
 
   void CreateAccumulatedPacketsGraph(PacketDirection desired_direction,
-                                     Plot* plot);
+                                     Plot* plot) const;
+
+  void CreatePlayoutGraph(Plot* plot) const;
 
-  void CreatePlayoutGraph(Plot* plot);
+  void CreateSequenceNumberGraph(Plot* plot) const;
 
-  void CreateSequenceNumberGraph(Plot* plot);
+  void CreateIncomingPacketLossGraph(Plot* plot) const;
 
-  void CreateIncomingPacketLossGraph(Plot* plot);
+  void CreateDelayChangeGraph(Plot* plot) const;
 
-  void CreateDelayChangeGraph(Plot* plot);
+  void CreateAccumulatedDelayChangeGraph(Plot* plot) const;
 
-  void CreateAccumulatedDelayChangeGraph(Plot* plot);
+  void CreateFractionLossGraph(Plot* plot) const;
 
-  void CreateFractionLossGraph(Plot* plot);
+  void CreateTotalBitrateGraph(PacketDirection desired_direction,
+                               Plot* plot) const;
 
-  void CreateTotalBitrateGraph(PacketDirection desired_direction, Plot* plot);
+  void CreateStreamBitrateGraph(PacketDirection desired_direction,
+                                Plot* plot) const;
 
-  void CreateStreamBitrateGraph(PacketDirection desired_direction, Plot* plot);
+  void CreateBweSimulationGraph(Plot* plot) const;
 
-  void CreateBweSimulationGraph(Plot* plot);
+  void CreateNetworkDelayFeedbackGraph(Plot* plot) const;
 
-  void CreateNetworkDelayFeedbackGraph(Plot* plot);
+  // Runs the same simulation as CreateBweSimulationGraph. The result only
+  // depends on the log, since the estimator runs on a simulated clock.
+  BweSimulationStats GetBweSimulationStats() const;
 
  private:
   class StreamId {
@@ -110,7 +140,13 @@ class EventLogAnalyzer {
       PacketDirection desired_direction,
       Plot* plot,
       const std::map<StreamId, std::vector<T>>& packets,
-      const std::string& label_prefix);
+      const std::string& label_prefix) const;
+
+  // Feeds the outgoing RTP packets and the incoming transport feedback to a
+  // CongestionController in time order. |network_delay| may be null.
+  void SimulateBwe(TimeSeries* estimate,
+                   TimeSeries* acked_time_series,
+                   TimeSeries* network_delay) const;
 
   bool IsRtxSsrc(StreamId stream_id) const;
 
@@ -120,8 +156,6 @@ class EventLogAnalyzer {
 
   std::string GetStreamName(StreamId) const;
 
-  const ParsedRtcEventLog& parsed_log_;
-
   // A list of SSRCs we are interested in analysing.
   // If left empty, all SSRCs will be considered relevant.
   std::vector<uint32_t> desired_ssrc_;
@@ -135,6 +169,10 @@ class EventLogAnalyzer {
   std::set<StreamId> video_ssrcs_;
   std::set<StreamId> audio_ssrcs_;
 
+  // Maps a stream identifier consisting of ssrc and direction
+  // to the header extensions used by that stream.
+  std::map<StreamId, RtpHeaderExtensionMap> extension_maps_;
+
   // Maps a stream identifier consisting of ssrc and direction to the parsed
   // RTP headers in that stream. Header extensions are parsed if the stream
   // has been configured.
@@ -145,6 +183,9 @@ class EventLogAnalyzer {
   // A list of all updates from the send-side loss-based bandwidth estimator.
   std::vector<BwePacketLossEvent> bwe_loss_updates_;
 
+  // The times of the audio playouts of each SSRC.
+  std::map<uint32_t, std::vector<uint64_t>> audio_playouts_;
+
   // Window and step size used for calculating moving averages, e.g. bitrate.
   // The generated data points will be |step_| microseconds apart.
   // Only events occuring at most |window_duration_| microseconds before the
@@ -152,6 +193,11 @@ class EventLogAnalyzer {
   uint64_t window_duration_;
   uint64_t step_;
 
+  // First and last events of the log, except for the log start and end and
+  // the configuration events.
+  uint64_t first_timestamp_;
+  uint64_t last_timestamp_;
+
   // First and last events of the log.
   uint64_t begin_time_;
   uint64_t end_time_;
@@ -8,10 +8,17 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "gflags/gflags.h"
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/call/rtc_event_log_parser.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 #include "webrtc/tools/event_log_visualizer/analyzer.h"
 #include "webrtc/tools/event_log_visualizer/plot_base.h"
 #include "webrtc/tools/event_log_visualizer/plot_python.h"
@@ -55,6 +62,68 @@ DEFINE_bool(plot_fraction_loss,
             false,
             "Plot packet loss in percent for outgoing packets (as perceived by "
             "the send-side bandwidth estimator).");
+DEFINE_bool(print_bwe_stats,
+            false,
+            "Run the bandwidth estimator with the logged rtp and rtcp and "
+            "print convergence time, utilization and queueing delay instead "
+            "of plotting. The simulation is deterministic, so many logs can "
+            "be evaluated in parallel and compared between revisions.");
+DEFINE_int32(plot_threads,
+             0,
+             "Number of threads used to create the plots, or 0 to use one "
+             "thread per CPU core.");
+
+namespace {
+
+// Number of events parsed at a time. The events are dropped once they have
+// been added to the analyzer, so only the analyzed data has to fit in memory.
+const size_t kMaxEventsPerChunk = 10000;
+
+// Creates plots on several threads. The plots are appended to the collection
+// in the order they are added, so the output doesn't depend on which plot is
+// finished first.
+class ParallelPlotCreator {
+ public:
+  explicit ParallelPlotCreator(webrtc::plotting::PlotCollection* collection)
+      : collection_(collection), next_task_(0) {}
+
+  void Add(std::function<void(webrtc::plotting::Plot*)> create_plot) {
+    tasks_.push_back(std::bind(create_plot, collection_->AppendNewPlot()));
+  }
+
+  // Creates all added plots and returns when they are done.
+  void Run(size_t num_threads) {
+    std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+    for (size_t i = 0; i < num_threads && i < tasks_.size(); ++i) {
+      threads.emplace_back(
+          new rtc::PlatformThread(&RunTasks, this, "PlotCreator"));
+      threads.back()->Start();
+    }
+    for (auto& thread : threads)
+      thread->Stop();
+  }
+
+ private:
+  static bool RunTasks(void* obj) {
+    ParallelPlotCreator* creator = static_cast<ParallelPlotCreator*>(obj);
+    while (true) {
+      const size_t index = rtc::AtomicOps::Increment(&creator->next_task_) - 1;
+      if (index >= creator->tasks_.size())
+        break;
+      creator->tasks_[index]();
+    }
+    // Done; the thread doesn't need to run again.
+    return false;
+  }
+
+  webrtc::plotting::PlotCollection* const collection_;
+  std::vector<std::function<void()>> tasks_;
+  volatile int next_task_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ParallelPlotCreator);
+};
+
+}  // namespace
 
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
@@ -75,94 +144,146 @@ int main(int argc, char* argv[]) {
   std::string filename = argv[1];
 
   webrtc::ParsedRtcEventLog parsed_log;
+  webrtc::plotting::EventLogAnalyzer analyzer;
+  size_t num_events = 0;
 
-  if (!parsed_log.ParseFile(filename)) {
+  bool opened = parsed_log.StartParsingFile(filename);
+  if (opened) {
+    while (parsed_log.ParseNextEvents(kMaxEventsPerChunk)) {
+      analyzer.AddEvents(parsed_log);
+      num_events += parsed_log.GetNumberOfEvents();
+    }
+  }
+  if (!opened || parsed_log.parse_error()) {
     std::cerr << "Could not parse the entire log file." << std::endl;
-    std::cerr << "Proceeding to analyze the first "
-              << parsed_log.GetNumberOfEvents() << " events in the file."
-              << std::endl;
+    std::cerr << "Proceeding to analyze the first " << num_events
+              << " events in the file." << std::endl;
   }
 
-  webrtc::plotting::EventLogAnalyzer analyzer(parsed_log);
+  if (FLAGS_print_bwe_stats) {
+    webrtc::plotting::BweSimulationStats stats =
+        analyzer.GetBweSimulationStats();
+    std::cout << "convergence_time_s " << stats.convergence_time_s << "\n"
+              << "utilization " << stats.utilization << "\n"
+              << "mean_queueing_delay_ms " << stats.mean_queueing_delay_ms
+              << "\n"
+              << "p95_queueing_delay_ms " << stats.p95_queueing_delay_ms
+              << std::endl;
+    return 0;
+  }
   std::unique_ptr<webrtc::plotting::PlotCollection> collection(
       new webrtc::plotting::PythonPlotCollection());
+  ParallelPlotCreator plots(collection.get());
 
   if (FLAGS_plot_all || FLAGS_plot_packets) {
     if (FLAGS_incoming) {
-      analyzer.CreatePacketGraph(webrtc::PacketDirection::kIncomingPacket,
-                                 collection->AppendNewPlot());
-      analyzer.CreateAccumulatedPacketsGraph(
-          webrtc::PacketDirection::kIncomingPacket,
-          collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreatePacketGraph(webrtc::PacketDirection::kIncomingPacket,
+                                   plot);
+      });
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateAccumulatedPacketsGraph(
+            webrtc::PacketDirection::kIncomingPacket, plot);
+      });
     }
     if (FLAGS_outgoing) {
-      analyzer.CreatePacketGraph(webrtc::PacketDirection::kOutgoingPacket,
-                                 collection->AppendNewPlot());
-      analyzer.CreateAccumulatedPacketsGraph(
-          webrtc::PacketDirection::kOutgoingPacket,
-          collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreatePacketGraph(webrtc::PacketDirection::kOutgoingPacket,
+                                   plot);
+      });
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateAccumulatedPacketsGraph(
+            webrtc::PacketDirection::kOutgoingPacket, plot);
+      });
     }
   }
 
   if (FLAGS_plot_all || FLAGS_plot_audio_playout) {
-    analyzer.CreatePlayoutGraph(collection->AppendNewPlot());
+    plots.Add([&](webrtc::plotting::Plot* plot) {
+      analyzer.CreatePlayoutGraph(plot);
+    });
   }
 
   if (FLAGS_plot_all || FLAGS_plot_sequence_number) {
     if (FLAGS_incoming) {
-      analyzer.CreateSequenceNumberGraph(collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateSequenceNumberGraph(plot);
+      });
     }
   }
 
   if (FLAGS_plot_all || FLAGS_plot_delay_change) {
     if (FLAGS_incoming) {
-      analyzer.CreateDelayChangeGraph(collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateDelayChangeGraph(plot);
+      });
     }
   }
 
   if (FLAGS_plot_all || FLAGS_plot_accumulated_delay_change) {
     if (FLAGS_incoming) {
-      analyzer.CreateAccumulatedDelayChangeGraph(collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateAccumulatedDelayChangeGraph(plot);
+      });
     }
   }
 
   if (FLAGS_plot_all || FLAGS_plot_fraction_loss) {
-    analyzer.CreateFractionLossGraph(collection->AppendNewPlot());
-    analyzer.CreateIncomingPacketLossGraph(collection->AppendNewPlot());
+    plots.Add([&](webrtc::plotting::Plot* plot) {
+      analyzer.CreateFractionLossGraph(plot);
+    });
+    plots.Add([&](webrtc::plotting::Plot* plot) {
+      analyzer.CreateIncomingPacketLossGraph(plot);
+    });
   }
 
   if (FLAGS_plot_all || FLAGS_plot_total_bitrate) {
     if (FLAGS_incoming) {
-      analyzer.CreateTotalBitrateGraph(webrtc::PacketDirection::kIncomingPacket,
-                                       collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateTotalBitrateGraph(
+            webrtc::PacketDirection::kIncomingPacket, plot);
+      });
     }
     if (FLAGS_outgoing) {
-      analyzer.CreateTotalBitrateGraph(webrtc::PacketDirection::kOutgoingPacket,
-                                       collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateTotalBitrateGraph(
+            webrtc::PacketDirection::kOutgoingPacket, plot);
+      });
     }
   }
 
   if (FLAGS_plot_all || FLAGS_plot_stream_bitrate) {
     if (FLAGS_incoming) {
-      analyzer.CreateStreamBitrateGraph(
-          webrtc::PacketDirection::kIncomingPacket,
-          collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateStreamBitrateGraph(
+            webrtc::PacketDirection::kIncomingPacket, plot);
+      });
     }
     if (FLAGS_outgoing) {
-      analyzer.CreateStreamBitrateGraph(
-          webrtc::PacketDirection::kOutgoingPacket,
-          collection->AppendNewPlot());
+      plots.Add([&](webrtc::plotting::Plot* plot) {
+        analyzer.CreateStreamBitrateGraph(
+            webrtc::PacketDirection::kOutgoingPacket, plot);
+      });
     }
   }
 
   if (FLAGS_plot_all || FLAGS_plot_bwe) {
-    analyzer.CreateBweSimulationGraph(collection->AppendNewPlot());
+    plots.Add([&](webrtc::plotting::Plot* plot) {
+      analyzer.CreateBweSimulationGraph(plot);
+    });
   }
 
   if (FLAGS_plot_all || FLAGS_plot_network_delay_feedback) {
-    analyzer.CreateNetworkDelayFeedbackGraph(collection->AppendNewPlot());
+    plots.Add([&](webrtc::plotting::Plot* plot) {
+      analyzer.CreateNetworkDelayFeedbackGraph(plot);
+    });
   }
 
+  int num_threads = FLAGS_plot_threads;
+  if (num_threads <= 0)
+    num_threads = webrtc::CpuInfo::DetectNumberOfCores();
+  plots.Run(num_threads);
+
   collection->Draw();
 
   return 0;
@@ -14,8 +14,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <memory>
 #include <string>
 
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
+
 #define STATS_LINE_LENGTH 32
 #define Y4M_FILE_HEADER_MAX_SIZE 200
 #define Y4M_FRAME_DELIMITER "FRAME"
@@ -26,6 +30,136 @@ namespace test {
 
 using std::string;
 
+namespace {
+
+// Each comparison thread gets this many frames per batch.
+const size_t kFramesPerThread = 2;
+
+// Reads I420 frames from a raw YUV or a Y4M file through one open handle, so
+// reading consecutive frames doesn't have to reopen the file or seek.
+class VideoFile {
+ public:
+  VideoFile(const char* file_name, bool y4m, int width, int height)
+      : file_name_(file_name),
+        y4m_(y4m),
+        frame_size_(GetI420FrameSize(width, height)),
+        file_(NULL),
+        first_frame_offset_(0),
+        position_(-1) {}
+
+  ~VideoFile() {
+    if (file_)
+      fclose(file_);
+  }
+
+  bool Open() {
+    file_ = fopen(file_name_, "rb");
+    if (file_ == NULL) {
+      fprintf(stderr, "Couldn't open input file for reading: %s\n",
+              file_name_);
+      return false;
+    }
+    if (!y4m_)
+      return true;
+    // YUV4MPEG2, a.k.a. Y4M File format has a file header and a frame header.
+    // The file header has the aspect: "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1".
+    char file_header[Y4M_FILE_HEADER_MAX_SIZE + 1] = {0};
+    size_t bytes_read =
+        fread(file_header, 1, Y4M_FILE_HEADER_MAX_SIZE, file_);
+    std::string header_contents(file_header, bytes_read);
+    std::size_t found = header_contents.find(Y4M_FRAME_DELIMITER);
+    if (found == std::string::npos) {
+      fprintf(stdout, "Corrupted Y4M header, could not find \"FRAME\" in %s\n",
+              header_contents.c_str());
+      return false;
+    }
+    first_frame_offset_ = static_cast<long>(found);
+    return true;
+  }
+
+  // Returns false if the frame couldn't be read, e.g. because it is past the
+  // end of the file.
+  bool ReadFrame(int frame_number, uint8_t* frame) {
+    long offset = first_frame_offset_;
+    if (y4m_) {
+      // Skip the frame header as well.
+      offset += frame_number * static_cast<long>(frame_size_ +
+                                                 Y4M_FRAME_HEADER_SIZE) +
+                Y4M_FRAME_HEADER_SIZE;
+    } else {
+      offset += frame_number * static_cast<long>(frame_size_);
+    }
+    if (offset != position_ && fseek(file_, offset, SEEK_SET) != 0) {
+      position_ = -1;
+      return false;
+    }
+    size_t bytes_read = fread(frame, 1, frame_size_, file_);
+    if (bytes_read != frame_size_) {
+      if (ferror(file_)) {
+        fprintf(stdout, "Error while reading frame no %d from file %s\n",
+                frame_number, file_name_);
+      }
+      position_ = -1;
+      return false;
+    }
+    position_ = offset + static_cast<long>(frame_size_);
+    return true;
+  }
+
+ private:
+  const char* const file_name_;
+  const bool y4m_;
+  const size_t frame_size_;
+  FILE* file_;
+  long first_frame_offset_;
+  // Where the next fread() would read from, or -1 if not known.
+  long position_;
+};
+
+struct FrameComparison {
+  explicit FrameComparison(int frame_size)
+      : frame_number(-1),
+        reference(new uint8_t[frame_size]),
+        test(new uint8_t[frame_size]),
+        psnr(0.0),
+        ssim(0.0) {}
+
+  int frame_number;
+  std::unique_ptr<uint8_t[]> reference;
+  std::unique_ptr<uint8_t[]> test;
+  double psnr;
+  double ssim;
+};
+
+typedef std::vector<std::unique_ptr<FrameComparison>> FrameComparisons;
+
+// Compares every |step|th frame of a batch, starting at |first|.
+struct ComparisonTask {
+  FrameComparisons* comparisons;
+  size_t num_comparisons;
+  size_t first;
+  size_t step;
+  int width;
+  int height;
+};
+
+bool RunComparisonTask(void* obj) {
+  ComparisonTask* task = static_cast<ComparisonTask*>(obj);
+  for (size_t i = task->first; i < task->num_comparisons; i += task->step) {
+    FrameComparison* comparison = (*task->comparisons)[i].get();
+    comparison->psnr =
+        CalculateMetrics(kPSNR, comparison->reference.get(),
+                         comparison->test.get(), task->width, task->height);
+    comparison->ssim =
+        CalculateMetrics(kSSIM, comparison->reference.get(),
+                         comparison->test.get(), task->width, task->height);
+  }
+  // Run once.
+  return false;
+}
+
+}  // namespace
+
 ResultsContainer::ResultsContainer() {}
 ResultsContainer::~ResultsContainer() {}
 
@@ -95,29 +229,8 @@ bool ExtractFrameFromYuvFile(const char* i420_file_name,
                              int height,
                              int frame_number,
                              uint8_t* result_frame) {
-  int frame_size = GetI420FrameSize(width, height);
-  int offset = frame_number * frame_size;  // Calculate offset for the frame.
-  bool errors = false;
-
-  FILE* input_file = fopen(i420_file_name, "rb");
-  if (input_file == NULL) {
-    fprintf(stderr, "Couldn't open input file for reading: %s\n",
-            i420_file_name);
-    return false;
-  }
-
-  // Change stream pointer to new offset.
-  fseek(input_file, offset, SEEK_SET);
-
-  size_t bytes_read = fread(result_frame, 1, frame_size, input_file);
-  if (bytes_read != static_cast<size_t>(frame_size) &&
-      ferror(input_file)) {
-    fprintf(stdout, "Error while reading frame no %d from file %s\n",
-            frame_number, i420_file_name);
-    errors = true;
-  }
-  fclose(input_file);
-  return !errors;
+  VideoFile file(i420_file_name, false, width, height);
+  return file.Open() && file.ReadFrame(frame_number, result_frame);
 }
 
 bool ExtractFrameFromY4mFile(const char* y4m_file_name,
@@ -125,54 +238,8 @@ bool ExtractFrameFromY4mFile(const char* y4m_file_name,
                              int height,
                              int frame_number,
                              uint8_t* result_frame) {
-  int frame_size = GetI420FrameSize(width, height);
-  int frame_offset = frame_number * frame_size;
-  bool errors = false;
-
-  FILE* input_file = fopen(y4m_file_name, "rb");
-  if (input_file == NULL) {
-    fprintf(stderr, "Couldn't open input file for reading: %s\n",
-            y4m_file_name);
-    return false;
-  }
-
-  // YUV4MPEG2, a.k.a. Y4M File format has a file header and a frame header. The
-  // file header has the aspect: "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1".
-  // Skip the header if this is the first frame of the file.
-  if (frame_number == 0) {
-    char frame_header[Y4M_FILE_HEADER_MAX_SIZE];
-    size_t bytes_read =
-        fread(frame_header, 1, Y4M_FILE_HEADER_MAX_SIZE, input_file);
-    if (bytes_read != static_cast<size_t>(frame_size) && ferror(input_file)) {
-      fprintf(stdout, "Error while reading first frame from file %s\n",
-          y4m_file_name);
-      fclose(input_file);
-      return false;
-    }
-    std::string header_contents(frame_header);
-    std::size_t found = header_contents.find(Y4M_FRAME_DELIMITER);
-    if (found == std::string::npos) {
-      fprintf(stdout, "Corrupted Y4M header, could not find \"FRAME\" in %s\n",
-          header_contents.c_str());
-      fclose(input_file);
-      return false;
-    }
-    frame_offset = static_cast<int>(found);
-  }
-
-  // Change stream pointer to new offset, skipping the frame header as well.
-  fseek(input_file, frame_offset + Y4M_FRAME_HEADER_SIZE, SEEK_SET);
-
-  size_t bytes_read = fread(result_frame, 1, frame_size, input_file);
-  if (bytes_read != static_cast<size_t>(frame_size) &&
-      ferror(input_file)) {
-    fprintf(stdout, "Error while reading frame no %d from file %s\n",
-            frame_number, y4m_file_name);
-    errors = true;
-  }
-
-  fclose(input_file);
-  return !errors;
+  VideoFile file(y4m_file_name, true, width, height);
+  return file.Open() && file.ReadFrame(frame_number, result_frame);
 }
 
 double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
@@ -225,69 +292,106 @@ double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
                  ResultsContainer* results) {
+  RunAnalysis(reference_file_name, test_file_name, stats_file_name, width,
+              height, 0, results);
+}
+
+void RunAnalysis(const char* reference_file_name, const char* test_file_name,
+                 const char* stats_file_name, int width, int height,
+                 int num_threads, ResultsContainer* results) {
   // Check if the reference_file_name ends with "y4m".
   bool y4m_mode = false;
   if (std::string(reference_file_name).find("y4m") != std::string::npos) {
     y4m_mode = true;
   }
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(CpuInfo::DetectNumberOfCores());
 
-  int size = GetI420FrameSize(width, height);
+  VideoFile reference_file(reference_file_name, y4m_mode, width, height);
+  VideoFile test_file(test_file_name, false, width, height);
+  if (!reference_file.Open() || !test_file.Open())
+    return;
   FILE* stats_file = fopen(stats_file_name, "r");
+  if (stats_file == NULL) {
+    fprintf(stderr, "Couldn't open stats file for reading: %s\n",
+            stats_file_name);
+    return;
+  }
 
   // String buffer for the lines in the stats file.
   char line[STATS_LINE_LENGTH];
-
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* reference_frame = new uint8_t[size];
   int previous_frame_number = -1;
 
-  // While there are entries in the stats file.
-  while (GetNextStatsLine(stats_file, line)) {
-    int extracted_test_frame = ExtractFrameSequenceNumber(line);
-    int decoded_frame_number = ExtractDecodedFrameNumber(line);
-
-    // If there was problem decoding the barcode in this frame or the frame has
-    // been duplicated, continue.
-    if (IsThereBarcodeError(line) ||
-        decoded_frame_number == previous_frame_number) {
-      continue;
-    }
+  // Reads the frames of the next entries in the stats file into |batch|, and
+  // returns how many were read.
+  auto read_batch = [&](FrameComparisons* batch) {
+    size_t num_frames = 0;
+    while (num_frames < batch->size() && GetNextStatsLine(stats_file, line)) {
+      int extracted_test_frame = ExtractFrameSequenceNumber(line);
+      int decoded_frame_number = ExtractDecodedFrameNumber(line);
+
+      // If there was problem decoding the barcode in this frame or the frame
+      // has been duplicated, continue.
+      if (IsThereBarcodeError(line) ||
+          decoded_frame_number == previous_frame_number) {
+        continue;
+      }
 
-    assert(extracted_test_frame != -1);
-    assert(decoded_frame_number != -1);
+      assert(extracted_test_frame != -1);
+      assert(decoded_frame_number != -1);
 
-    ExtractFrameFromYuvFile(test_file_name, width, height, extracted_test_frame,
-                            test_frame);
-    if (y4m_mode) {
-      ExtractFrameFromY4mFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
-    } else {
-      ExtractFrameFromYuvFile(reference_file_name, width, height,
-                              decoded_frame_number, reference_frame);
+      FrameComparison* comparison = (*batch)[num_frames++].get();
+      comparison->frame_number = decoded_frame_number;
+      test_file.ReadFrame(extracted_test_frame, comparison->test.get());
+      reference_file.ReadFrame(decoded_frame_number,
+                               comparison->reference.get());
+      previous_frame_number = decoded_frame_number;
     }
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = CalculateMetrics(kPSNR, reference_frame, test_frame,
-                                          width, height);
-    double result_ssim = CalculateMetrics(kSSIM, reference_frame, test_frame,
-                                          width, height);
-
-    previous_frame_number = decoded_frame_number;
-
-    // Fill in the result struct.
-    AnalysisResult result;
-    result.frame_number = decoded_frame_number;
-    result.psnr_value = result_psnr;
-    result.ssim_value = result_ssim;
-
-    results->frames.push_back(result);
+    return num_frames;
+  };
+
+  // Two batches of frames, so the next one can be read while the frames of
+  // the current one are being compared.
+  const int size = GetI420FrameSize(width, height);
+  const size_t batch_size = num_threads * kFramesPerThread;
+  FrameComparisons batches[2];
+  for (FrameComparisons& batch : batches) {
+    for (size_t i = 0; i < batch_size; ++i)
+      batch.emplace_back(new FrameComparison(size));
+  }
+  std::vector<ComparisonTask> tasks(num_threads);
+
+  int current = 0;
+  size_t num_frames = read_batch(&batches[current]);
+  while (num_frames > 0) {
+    std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      tasks[i].comparisons = &batches[current];
+      tasks[i].num_comparisons = num_frames;
+      tasks[i].first = i;
+      tasks[i].step = num_threads;
+      tasks[i].width = width;
+      tasks[i].height = height;
+      threads.emplace_back(
+          new rtc::PlatformThread(&RunComparisonTask, &tasks[i], "Analyzer"));
+      threads.back()->Start();
+    }
+    size_t num_next_frames = read_batch(&batches[1 - current]);
+    for (const auto& thread : threads)
+      thread->Stop();
+
+    // Fill in the result structs.
+    for (size_t i = 0; i < num_frames; ++i) {
+      const FrameComparison& comparison = *batches[current][i];
+      results->frames.push_back(AnalysisResult(
+          comparison.frame_number, comparison.psnr, comparison.ssim));
+    }
+    current = 1 - current;
+    num_frames = num_next_frames;
   }
 
   // Cleanup.
   fclose(stats_file);
-  delete[] test_frame;
-  delete[] reference_frame;
 }
 
 void PrintMaxRepeatedAndSkippedFrames(const std::string& label,
@@ -53,6 +53,13 @@ enum VideoAnalysisMetricsType {kPSNR, kSSIM};
 // tools/barcode_tools/barcode_decoder.py. This script decodes the barcodes
 // integrated in every video and generates the stats file. If three was some
 // problem with the decoding there would be 'Barcode error' instead of yyyy.
+//
+// The files are read sequentially through one open handle each, and the frames
+// are compared on |num_threads| threads while the next frames are read. A
+// |num_threads| of 0 uses all cores.
+void RunAnalysis(const char* reference_file_name, const char* test_file_name,
+                 const char* stats_file_name, int width, int height,
+                 int num_threads, ResultsContainer* results);
 void RunAnalysis(const char* reference_file_name, const char* test_file_name,
                  const char* stats_file_name, int width, int height,
                  ResultsContainer* results);
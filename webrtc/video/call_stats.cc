@@ -12,6 +12,7 @@
 
 #include <algorithm>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/checks.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -23,39 +24,13 @@ namespace {
 const int64_t kUpdateIntervalMs = 1000;
 // Weight factor to apply to the average rtt.
 const float kWeightFactor = 0.3f;
+// A rtt report is considered valid for this long.
+const int64_t kRttTimeoutMs = 1500;
+// Max number of valid rtt reports that are kept. Each RTP module reports
+// about once per second, so this covers a few hundred streams.
+const size_t kMaxNumReports = 512;
 
-void RemoveOldReports(int64_t now, std::list<CallStats::RttTime>* reports) {
-  // A rtt report is considered valid for this long.
-  const int64_t kRttTimeoutMs = 1500;
-  while (!reports->empty() &&
-         (now - reports->front().time) > kRttTimeoutMs) {
-    reports->pop_front();
-  }
-}
-
-int64_t GetMaxRttMs(std::list<CallStats::RttTime>* reports) {
-  if (reports->empty())
-    return -1;
-  int64_t max_rtt_ms = 0;
-  for (const CallStats::RttTime& rtt_time : *reports)
-    max_rtt_ms = std::max(rtt_time.rtt, max_rtt_ms);
-  return max_rtt_ms;
-}
-
-int64_t GetAvgRttMs(std::list<CallStats::RttTime>* reports) {
-  if (reports->empty()) {
-    return -1;
-  }
-  int64_t sum = 0;
-  for (std::list<CallStats::RttTime>::const_iterator it = reports->begin();
-       it != reports->end(); ++it) {
-    sum += it->rtt;
-  }
-  return sum / reports->size();
-}
-
-void UpdateAvgRttMs(std::list<CallStats::RttTime>* reports, int64_t* avg_rtt) {
-  int64_t cur_rtt_ms = GetAvgRttMs(reports);
+void UpdateAvgRttMs(int64_t cur_rtt_ms, int64_t* avg_rtt) {
   if (cur_rtt_ms == -1) {
     // Reset.
     *avg_rtt = -1;
@@ -96,12 +71,19 @@ CallStats::CallStats(Clock* clock)
       last_process_time_(clock_->TimeInMilliseconds()),
       max_rtt_ms_(-1),
       avg_rtt_ms_(-1),
+      shared_avg_rtt_ms_(-1),
       sum_avg_rtt_ms_(0),
       num_avg_rtt_(0),
-      time_of_first_rtt_ms_(-1) {}
+      time_of_first_rtt_ms_(-1),
+      reports_(kMaxNumReports),
+      first_report_(0),
+      num_reports_(0) {}
 
 CallStats::~CallStats() {
-  RTC_DCHECK(observers_.empty());
+  {
+    rtc::CritScope cs(&observers_crit_);
+    RTC_DCHECK(observers_.empty());
+  }
   UpdateHistograms();
 }
 
@@ -110,33 +92,42 @@ int64_t CallStats::TimeUntilNextProcess() {
 }
 
 void CallStats::Process() {
-  rtc::CritScope cs(&crit_);
-  int64_t now = clock_->TimeInMilliseconds();
-  if (now < last_process_time_ + kUpdateIntervalMs)
-    return;
+  int64_t avg_rtt_ms;
+  int64_t max_rtt_ms;
+  {
+    rtc::CritScope cs(&crit_);
+    int64_t now = clock_->TimeInMilliseconds();
+    if (now < last_process_time_ + kUpdateIntervalMs)
+      return;
 
-  last_process_time_ = now;
+    last_process_time_ = now;
 
-  RemoveOldReports(now, &reports_);
-  max_rtt_ms_ = GetMaxRttMs(&reports_);
-  UpdateAvgRttMs(&reports_, &avg_rtt_ms_);
+    RemoveOldReports(now);
+    max_rtt_ms_ = GetMaxRttMs();
+    UpdateAvgRttMs(GetAvgRttMs(), &avg_rtt_ms_);
+    rtc::AtomicOps::ReleaseStore(&shared_avg_rtt_ms_,
+                                 static_cast<int>(avg_rtt_ms_));
+    avg_rtt_ms = avg_rtt_ms_;
+    max_rtt_ms = max_rtt_ms_;
 
-  // If there is a valid rtt, update all observers with the max rtt.
-  if (max_rtt_ms_ >= 0) {
-    RTC_DCHECK_GE(avg_rtt_ms_, 0);
-    for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
-         it != observers_.end(); ++it) {
-      (*it)->OnRttUpdate(avg_rtt_ms_, max_rtt_ms_);
+    if (max_rtt_ms_ >= 0) {
+      // Sum for Histogram of average RTT reported over the entire call.
+      sum_avg_rtt_ms_ += avg_rtt_ms_;
+      ++num_avg_rtt_;
     }
-    // Sum for Histogram of average RTT reported over the entire call.
-    sum_avg_rtt_ms_ += avg_rtt_ms_;
-    ++num_avg_rtt_;
+  }
+
+  // If there is a valid rtt, update all observers with the max rtt.
+  if (max_rtt_ms >= 0) {
+    RTC_DCHECK_GE(avg_rtt_ms, 0);
+    rtc::CritScope cs(&observers_crit_);
+    for (CallStatsObserver* observer : observers_)
+      observer->OnRttUpdate(avg_rtt_ms, max_rtt_ms);
   }
 }
 
 int64_t CallStats::avg_rtt_ms() const {
-  rtc::CritScope cs(&crit_);
-  return avg_rtt_ms_;
+  return rtc::AtomicOps::AcquireLoad(&shared_avg_rtt_ms_);
 }
 
 RtcpRttStats* CallStats::rtcp_rtt_stats() const {
@@ -144,34 +135,59 @@ RtcpRttStats* CallStats::rtcp_rtt_stats() const {
 }
 
 void CallStats::RegisterStatsObserver(CallStatsObserver* observer) {
-  rtc::CritScope cs(&crit_);
-  for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
-       it != observers_.end(); ++it) {
-    if (*it == observer)
-      return;
+  rtc::CritScope cs(&observers_crit_);
+  if (std::find(observers_.begin(), observers_.end(), observer) ==
+      observers_.end()) {
+    observers_.push_back(observer);
   }
-  observers_.push_back(observer);
 }
 
 void CallStats::DeregisterStatsObserver(CallStatsObserver* observer) {
-  rtc::CritScope cs(&crit_);
-  for (std::list<CallStatsObserver*>::iterator it = observers_.begin();
-       it != observers_.end(); ++it) {
-    if (*it == observer) {
-      observers_.erase(it);
-      return;
-    }
-  }
+  rtc::CritScope cs(&observers_crit_);
+  auto it = std::find(observers_.begin(), observers_.end(), observer);
+  if (it != observers_.end())
+    observers_.erase(it);
 }
 
 void CallStats::OnRttUpdate(int64_t rtt) {
   rtc::CritScope cs(&crit_);
   int64_t now_ms = clock_->TimeInMilliseconds();
-  reports_.push_back(RttTime(rtt, now_ms));
+  if (num_reports_ == reports_.size()) {
+    first_report_ = (first_report_ + 1) % reports_.size();
+    --num_reports_;
+  }
+  reports_[(first_report_ + num_reports_) % reports_.size()] =
+      RttTime(rtt, now_ms);
+  ++num_reports_;
   if (time_of_first_rtt_ms_ == -1)
     time_of_first_rtt_ms_ = now_ms;
 }
 
+void CallStats::RemoveOldReports(int64_t now) {
+  while (num_reports_ > 0 && (now - report(0).time) > kRttTimeoutMs) {
+    first_report_ = (first_report_ + 1) % reports_.size();
+    --num_reports_;
+  }
+}
+
+int64_t CallStats::GetMaxRttMs() const {
+  if (num_reports_ == 0)
+    return -1;
+  int64_t max_rtt_ms = 0;
+  for (size_t i = 0; i < num_reports_; ++i)
+    max_rtt_ms = std::max(report(i).rtt, max_rtt_ms);
+  return max_rtt_ms;
+}
+
+int64_t CallStats::GetAvgRttMs() const {
+  if (num_reports_ == 0)
+    return -1;
+  int64_t sum = 0;
+  for (size_t i = 0; i < num_reports_; ++i)
+    sum += report(i).rtt;
+  return sum / static_cast<int64_t>(num_reports_);
+}
+
 void CallStats::UpdateHistograms() {
   rtc::CritScope cs(&crit_);
   if (time_of_first_rtt_ms_ == -1 || num_avg_rtt_ < 1)
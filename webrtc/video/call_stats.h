@@ -11,8 +11,8 @@
 #ifndef WEBRTC_VIDEO_CALL_STATS_H_
 #define WEBRTC_VIDEO_CALL_STATS_H_
 
-#include <list>
 #include <memory>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
@@ -46,10 +46,11 @@ class CallStats : public Module {
 
   // Helper struct keeping track of the time a rtt value is reported.
   struct RttTime {
+    RttTime() : rtt(0), time(0) {}
     RttTime(int64_t new_rtt, int64_t rtt_time)
         : rtt(new_rtt), time(rtt_time) {}
-    const int64_t rtt;
-    const int64_t time;
+    int64_t rtt;
+    int64_t time;
   };
 
  protected:
@@ -60,8 +61,15 @@ class CallStats : public Module {
  private:
   void UpdateHistograms();
 
+  void RemoveOldReports(int64_t now) EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  int64_t GetMaxRttMs() const EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  int64_t GetAvgRttMs() const EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  const RttTime& report(size_t i) const EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    return reports_[(first_report_ + i) % reports_.size()];
+  }
+
   Clock* const clock_;
-  // Protecting all members.
+  // Protecting the members below, except for the observers.
   rtc::CriticalSection crit_;
   // Observer receiving statistics updates.
   std::unique_ptr<RtcpRttStats> rtcp_rtt_stats_;
@@ -70,15 +78,24 @@ class CallStats : public Module {
   // The last RTT in the statistics update (zero if there is no valid estimate).
   int64_t max_rtt_ms_;
   int64_t avg_rtt_ms_;
+  // Copy of |avg_rtt_ms_|, read by avg_rtt_ms() without taking |crit_|.
+  volatile int shared_avg_rtt_ms_;
   int64_t sum_avg_rtt_ms_ GUARDED_BY(crit_);
   int64_t num_avg_rtt_ GUARDED_BY(crit_);
   int64_t time_of_first_rtt_ms_ GUARDED_BY(crit_);
 
-  // All Rtt reports within valid time interval, oldest first.
-  std::list<RttTime> reports_;
+  // All Rtt reports within valid time interval, oldest first, in a ring of
+  // fixed size starting at |first_report_|. When the ring is full, a new
+  // report replaces the oldest one.
+  std::vector<RttTime> reports_ GUARDED_BY(crit_);
+  size_t first_report_ GUARDED_BY(crit_);
+  size_t num_reports_ GUARDED_BY(crit_);
 
+  // Held while the observers are updated, which is done without holding
+  // |crit_| so that new RTT reports and avg_rtt_ms() don't wait for it.
+  rtc::CriticalSection observers_crit_;
   // Observers getting stats reports.
-  std::list<CallStatsObserver*> observers_;
+  std::vector<CallStatsObserver*> observers_ GUARDED_BY(observers_crit_);
 
   RTC_DISALLOW_COPY_AND_ASSIGN(CallStats);
 };
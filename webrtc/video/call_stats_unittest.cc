@@ -203,6 +203,27 @@ TEST_F(CallStatsTest, LastProcessedRtt) {
   call_stats_->DeregisterStatsObserver(&stats_observer);
 }
 
+TEST_F(CallStatsTest, KeepsMostRecentReportsWhenManyAreReported) {
+  MockStatsObserver stats_observer;
+  call_stats_->RegisterStatsObserver(&stats_observer);
+  RtcpRttStats* rtcp_rtt_stats = call_stats_->rtcp_rtt_stats();
+  fake_clock_.AdvanceTimeMilliseconds(1000);
+
+  // More reports than are kept, the high rtt ones first. Only the most recent
+  // reports should be used.
+  const int64_t kRttLow = 10;
+  const int64_t kRttHigh = 1000;
+  for (int i = 0; i < 1000; ++i)
+    rtcp_rtt_stats->OnRttUpdate(kRttHigh);
+  for (int i = 0; i < 1000; ++i)
+    rtcp_rtt_stats->OnRttUpdate(kRttLow);
+  EXPECT_CALL(stats_observer, OnRttUpdate(kRttLow, kRttLow)).Times(1);
+  call_stats_->Process();
+  EXPECT_EQ(kRttLow, rtcp_rtt_stats->LastProcessedRtt());
+
+  call_stats_->DeregisterStatsObserver(&stats_observer);
+}
+
 TEST_F(CallStatsTest, ProducesHistogramMetrics) {
   metrics::Reset();
   const int64_t kRtt = 123;
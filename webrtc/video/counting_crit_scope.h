@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_VIDEO_COUNTING_CRIT_SCOPE_H_
+#define WEBRTC_VIDEO_COUNTING_CRIT_SCOPE_H_
+
+#include <stdint.h>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/thread_annotations.h"
+
+namespace webrtc {
+
+// How often a lock was taken, and how often another thread was holding it at
+// the time. Must be guarded by the lock it counts.
+struct LockContention {
+  void Add(const LockContention& other) {
+    num_acquisitions += other.num_acquisitions;
+    num_contended_acquisitions += other.num_contended_acquisitions;
+  }
+
+  int64_t num_acquisitions = 0;
+  int64_t num_contended_acquisitions = 0;
+};
+
+// Like rtc::CritScope, but counts the acquisitions of |cs| in |contention|.
+// Used to measure how much the threads reporting stream statistics contend.
+class SCOPED_LOCKABLE CountingCritScope {
+ public:
+  CountingCritScope(const rtc::CriticalSection* cs, LockContention* contention)
+      EXCLUSIVE_LOCK_FUNCTION(cs)
+      : cs_(cs) {
+    bool contended = !cs_->TryEnter();
+    if (contended)
+      cs_->Enter();
+    ++contention->num_acquisitions;
+    if (contended)
+      ++contention->num_contended_acquisitions;
+  }
+  ~CountingCritScope() UNLOCK_FUNCTION() { cs_->Leave(); }
+
+ private:
+  const rtc::CriticalSection* const cs_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CountingCritScope);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_VIDEO_COUNTING_CRIT_SCOPE_H_
@@ -9,9 +9,30 @@
  */
 #include <stdio.h>
 
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/json.h"
+#include "webrtc/test/testsupport/fileutils.h"
 #include "webrtc/video/video_quality_test.h"
 
+DEFINE_int32(full_stack_repetitions,
+             1,
+             "How many times to run each full stack test. The median of each "
+             "metric over the runs is reported.");
+DEFINE_string(full_stack_baseline_dir,
+              "",
+              "Directory with the full_stack_*.json results of an earlier run. "
+              "Tests fail if a metric got worse than its baseline by more than "
+              "--full_stack_regression_tolerance.");
+DEFINE_double(full_stack_regression_tolerance,
+              0.1,
+              "Allowed relative regression of a metric from its baseline.");
+
 namespace webrtc {
 
 static const int kFullStackTestDurationSecs = 60;
@@ -19,9 +40,110 @@ static const int kFullStackTestDurationSecs = 60;
 class FullStackTest : public VideoQualityTest {
  public:
   void RunTest(const VideoQualityTest::Params &params) {
-    RunWithAnalyzer(params);
+    std::vector<PerfResults> runs;
+    for (int i = 0; i < std::max(FLAGS_full_stack_repetitions, 1); ++i) {
+      RunWithAnalyzer(params);
+      runs.push_back(perf_results_);
+    }
+    ReportPerfResults(params.analyzer.test_label, runs);
+  }
+
+ private:
+  struct Metric {
+    const char* name;
+    double value;
+    // Whether a larger value is a regression.
+    bool larger_is_worse;
+  };
+
+  static std::vector<Metric> GetMetrics(const PerfResults& results) {
+    return {
+        {"psnr", results.psnr, false},
+        {"ssim", results.ssim, false},
+        {"capture_to_render_ms", results.capture_to_render_ms, true},
+        {"cpu_ms_per_frame", results.cpu_ms_per_frame, true},
+        {"bitrate_utilization", results.bitrate_utilization, false},
+        {"accounted_memory_bytes",
+         static_cast<double>(results.accounted_memory_bytes), true},
+        {"threads", static_cast<double>(results.num_threads), true},
+        {"rendered_frames", static_cast<double>(results.rendered_frames),
+         false},
+        {"dropped_frames", static_cast<double>(results.dropped_frames), true},
+    };
+  }
+
+  static double Median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle]
+                             : (values[middle - 1] + values[middle]) / 2;
   }
 
+  // Writes the medians of |runs| to full_stack_<test_label>.json in the output
+  // directory, and checks them against the same file in the baseline
+  // directory, if there is one.
+  static void ReportPerfResults(const std::string& test_label,
+                                const std::vector<PerfResults>& runs) {
+    std::vector<Metric> metrics = GetMetrics(runs[0]);
+    for (size_t i = 0; i < metrics.size(); ++i) {
+      std::vector<double> values;
+      for (const PerfResults& run : runs)
+        values.push_back(GetMetrics(run)[i].value);
+      metrics[i].value = Median(values);
+    }
+
+    const std::string filename = "full_stack_" + test_label + ".json";
+    const std::string output_path = test::OutputPath() + filename;
+    FILE* output = fopen(output_path.c_str(), "w");
+    ASSERT_TRUE(output != nullptr) << "Can't write " << output_path;
+    fprintf(output, "{\"test\": \"%s\", \"repetitions\": %d",
+            test_label.c_str(), static_cast<int>(runs.size()));
+    for (const Metric& metric : metrics)
+      fprintf(output, ", \"%s\": %f", metric.name, metric.value);
+    fprintf(output, "}\n");
+    fclose(output);
+
+    if (FLAGS_full_stack_baseline_dir.empty())
+      return;
+    const std::string baseline_path =
+        FLAGS_full_stack_baseline_dir + "/" + filename;
+    FILE* baseline_file = fopen(baseline_path.c_str(), "r");
+    if (!baseline_file) {
+      printf("No baseline in %s\n", baseline_path.c_str());
+      return;
+    }
+    std::string contents;
+    char buffer[1024];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), baseline_file)) > 0)
+      contents.append(buffer, read);
+    fclose(baseline_file);
+    Json::Value baseline;
+    ASSERT_TRUE(Json::Reader().parse(contents, baseline))
+        << "Can't parse " << baseline_path;
+
+    const double tolerance = FLAGS_full_stack_regression_tolerance;
+    for (const Metric& metric : metrics) {
+      double baseline_value;
+      if (!rtc::GetDoubleFromJsonObject(baseline, metric.name,
+                                        &baseline_value)) {
+        continue;
+      }
+      // The magnitude is used so that the tolerance works for small and
+      // negative values, like the PSNR and SSIM of "-1" when not measured.
+      const double allowed = tolerance * std::abs(baseline_value);
+      if (metric.larger_is_worse) {
+        EXPECT_LE(metric.value, baseline_value + allowed)
+            << metric.name << " regressed from " << baseline_value;
+      } else {
+        EXPECT_GE(metric.value, baseline_value - allowed)
+            << metric.name << " regressed from " << baseline_value;
+      }
+    }
+  }
+
+ public:
+
   void ForemanCifWithoutPacketLoss(const std::string& video_codec) {
     // TODO(pbos): Decide on psnr/ssim thresholds for foreman_cif.
     VideoQualityTest::Params foreman_cif = {
@@ -14,12 +14,11 @@
 #include <math.h>
 
 #include <algorithm>
-#include <list>
-#include <map>
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/exp_filter.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/common_video/include/frame_callback.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/video_frame.h"
@@ -45,6 +44,17 @@ const double kRampUpBackoffFactor = 2.0;
 // Max number of overuses detected before always applying the rampup delay.
 const int kMaxOverusesBeforeApplyRampupDelay = 4;
 
+// Delay before reporting actual encoding time, used to have the ability to
+// detect total encoding time when encoding more than one layer. Encoding is
+// here assumed to finish within a second (or that we get enough long-time
+// samples before one second to trigger an overuse even when this is not the
+// case).
+const int64_t kEncodingTimeMeasureWindowMs = 1000;
+// Max number of frames waiting for their encode time to be measured. Enough
+// for the measure window at 120 fps. Older frames are measured early, or
+// dropped if not yet sent.
+const size_t kMaxFrameTimings = 128;
+
 // The maximum exponent to use in VCMExpFilter.
 const float kSampleDiffMs = 33.0f;
 const float kMaxExp = 7.0f;
@@ -112,41 +122,41 @@ class OveruseFrameDetector::SendProcessingUsage {
         kMaxSampleDiffMs(45.0f),
         count_(0),
         options_(options),
-        filtered_processing_ms_(new rtc::ExpFilter(kWeightFactorProcessing)),
-        filtered_frame_diff_ms_(new rtc::ExpFilter(kWeightFactorFrameDiff)) {
+        filtered_processing_ms_(kWeightFactorProcessing),
+        filtered_frame_diff_ms_(kWeightFactorFrameDiff) {
     Reset();
   }
   ~SendProcessingUsage() {}
 
   void Reset() {
     count_ = 0;
-    filtered_frame_diff_ms_->Reset(kWeightFactorFrameDiff);
-    filtered_frame_diff_ms_->Apply(1.0f, kInitialSampleDiffMs);
-    filtered_processing_ms_->Reset(kWeightFactorProcessing);
-    filtered_processing_ms_->Apply(1.0f, InitialProcessingMs());
+    filtered_frame_diff_ms_.Reset(kWeightFactorFrameDiff);
+    filtered_frame_diff_ms_.Apply(1.0f, kInitialSampleDiffMs);
+    filtered_processing_ms_.Reset(kWeightFactorProcessing);
+    filtered_processing_ms_.Apply(1.0f, InitialProcessingMs());
   }
 
   void AddCaptureSample(float sample_ms) {
     float exp = sample_ms / kSampleDiffMs;
     exp = std::min(exp, kMaxExp);
-    filtered_frame_diff_ms_->Apply(exp, sample_ms);
+    filtered_frame_diff_ms_.Apply(exp, sample_ms);
   }
 
   void AddSample(float processing_ms, int64_t diff_last_sample_ms) {
     ++count_;
     float exp = diff_last_sample_ms / kSampleDiffMs;
     exp = std::min(exp, kMaxExp);
-    filtered_processing_ms_->Apply(exp, processing_ms);
+    filtered_processing_ms_.Apply(exp, processing_ms);
   }
 
   int Value() const {
     if (count_ < static_cast<uint32_t>(options_.min_frame_samples)) {
       return static_cast<int>(InitialUsageInPercent() + 0.5f);
     }
-    float frame_diff_ms = std::max(filtered_frame_diff_ms_->filtered(), 1.0f);
+    float frame_diff_ms = std::max(filtered_frame_diff_ms_.filtered(), 1.0f);
     frame_diff_ms = std::min(frame_diff_ms, kMaxSampleDiffMs);
     float encode_usage_percent =
-        100.0f * filtered_processing_ms_->filtered() / frame_diff_ms;
+        100.0f * filtered_processing_ms_.filtered() / frame_diff_ms;
     return static_cast<int>(encode_usage_percent + 0.5);
   }
 
@@ -167,8 +177,8 @@ class OveruseFrameDetector::SendProcessingUsage {
   const float kMaxSampleDiffMs;
   uint64_t count_;
   const CpuOveruseOptions options_;
-  std::unique_ptr<rtc::ExpFilter> filtered_processing_ms_;
-  std::unique_ptr<rtc::ExpFilter> filtered_frame_diff_ms_;
+  rtc::ExpFilter filtered_processing_ms_;
+  rtc::ExpFilter filtered_frame_diff_ms_;
 };
 
 class OveruseFrameDetector::CheckOveruseTask : public rtc::QueuedTask {
@@ -223,7 +233,10 @@ OveruseFrameDetector::OveruseFrameDetector(
       last_rampup_time_ms_(-1),
       in_quick_rampup_(false),
       current_rampup_delay_ms_(kStandardRampUpDelayMs),
-      usage_(new SendProcessingUsage(options)) {
+      usage_(new SendProcessingUsage(options)),
+      frame_timing_(kMaxFrameTimings, FrameTiming(-1, 0, -1)),
+      frame_timing_first_(0),
+      num_frame_timings_(0) {
   task_checker_.Detach();
 }
 
@@ -270,7 +283,7 @@ void OveruseFrameDetector::ResetAll(int num_pixels) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
   num_pixels_ = num_pixels;
   usage_->Reset();
-  frame_timing_.clear();
+  num_frame_timings_ = 0;
   last_capture_time_ms_ = -1;
   last_processed_capture_time_ms_ = -1;
   num_process_times_ = 0;
@@ -291,50 +304,78 @@ void OveruseFrameDetector::FrameCaptured(const VideoFrame& frame,
 
   last_capture_time_ms_ = time_when_first_seen_ms;
 
-  frame_timing_.push_back(FrameTiming(frame.ntp_time_ms(), frame.timestamp(),
-                                      time_when_first_seen_ms));
+  if (num_frame_timings_ == frame_timing_.size())
+    PopFrameTiming();
+  frame_timing_[(frame_timing_first_ + num_frame_timings_) %
+                frame_timing_.size()] =
+      FrameTiming(frame.ntp_time_ms(), frame.timestamp(),
+                  time_when_first_seen_ms);
+  ++num_frame_timings_;
 }
 
-void OveruseFrameDetector::FrameSent(uint32_t timestamp,
-                                     int64_t time_sent_in_ms) {
+void OveruseFrameDetector::FrameEncoded(uint32_t timestamp,
+                                        int64_t encode_cpu_time_us) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
+  FrameTiming* timing = FindFrameTiming(timestamp);
+  if (timing)
+    timing->encode_cpu_time_us = encode_cpu_time_us;
+}
+
+OveruseFrameDetector::FrameTiming* OveruseFrameDetector::FindFrameTiming(
+    uint32_t timestamp) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
+  for (size_t i = num_frame_timings_; i > 0; --i) {
+    FrameTiming& timing =
+        frame_timing_[(frame_timing_first_ + i - 1) % frame_timing_.size()];
+    if (timing.timestamp == timestamp)
+      return &timing;
+  }
+  return nullptr;
+}
+
+void OveruseFrameDetector::PopFrameTiming() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
-  // Delay before reporting actual encoding time, used to have the ability to
-  // detect total encoding time when encoding more than one layer. Encoding is
-  // here assumed to finish within a second (or that we get enough long-time
-  // samples before one second to trigger an overuse even when this is not the
-  // case).
-  static const int64_t kEncodingTimeMeasureWindowMs = 1000;
-  for (auto& it : frame_timing_) {
-    if (it.timestamp == timestamp) {
-      it.last_send_ms = time_sent_in_ms;
-      break;
+  RTC_DCHECK_GT(num_frame_timings_, 0u);
+  const FrameTiming& timing = frame_timing_[frame_timing_first_];
+  if (timing.last_send_ms != -1) {
+    int encode_duration_ms =
+        static_cast<int>(timing.last_send_ms - timing.capture_ms);
+    if (encoder_timing_) {
+      encoder_timing_->OnEncodeTiming(timing.capture_ntp_ms,
+                                      encode_duration_ms);
     }
+    if (last_processed_capture_time_ms_ != -1) {
+      int64_t diff_ms = timing.capture_ms - last_processed_capture_time_ms_;
+      float processing_ms =
+          timing.encode_cpu_time_us != -1
+              ? timing.encode_cpu_time_us /
+                    static_cast<float>(rtc::kNumMicrosecsPerMillisec)
+              : encode_duration_ms;
+      usage_->AddSample(processing_ms, diff_ms);
+    }
+    last_processed_capture_time_ms_ = timing.capture_ms;
+    EncodedFrameTimeMeasured(encode_duration_ms);
   }
+  frame_timing_first_ = (frame_timing_first_ + 1) % frame_timing_.size();
+  --num_frame_timings_;
+}
+
+void OveruseFrameDetector::FrameSent(uint32_t timestamp,
+                                     int64_t time_sent_in_ms) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&task_checker_);
+  FrameTiming* timing = FindFrameTiming(timestamp);
+  if (timing)
+    timing->last_send_ms = time_sent_in_ms;
   // TODO(pbos): Handle the case/log errors when not finding the corresponding
   // frame (either very slow encoding or incorrect wrong timestamps returned
   // from the encoder).
   // This is currently the case for all frames on ChromeOS, so logging them
   // would be spammy, and triggering overuse would be wrong.
   // https://crbug.com/350106
-  while (!frame_timing_.empty()) {
-    FrameTiming timing = frame_timing_.front();
-    if (time_sent_in_ms - timing.capture_ms < kEncodingTimeMeasureWindowMs)
-      break;
-    if (timing.last_send_ms != -1) {
-      int encode_duration_ms =
-          static_cast<int>(timing.last_send_ms - timing.capture_ms);
-      if (encoder_timing_) {
-        encoder_timing_->OnEncodeTiming(timing.capture_ntp_ms,
-                                        encode_duration_ms);
-      }
-      if (last_processed_capture_time_ms_ != -1) {
-        int64_t diff_ms = timing.capture_ms - last_processed_capture_time_ms_;
-        usage_->AddSample(encode_duration_ms, diff_ms);
-      }
-      last_processed_capture_time_ms_ = timing.capture_ms;
-      EncodedFrameTimeMeasured(encode_duration_ms);
-    }
-    frame_timing_.pop_front();
+  while (num_frame_timings_ > 0 &&
+         time_sent_in_ms - frame_timing_[frame_timing_first_].capture_ms >=
+             kEncodingTimeMeasureWindowMs) {
+    PopFrameTiming();
   }
 }
 
@@ -11,8 +11,8 @@
 #ifndef WEBRTC_VIDEO_OVERUSE_FRAME_DETECTOR_H_
 #define WEBRTC_VIDEO_OVERUSE_FRAME_DETECTOR_H_
 
-#include <list>
 #include <memory>
+#include <vector>
 
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/optional.h"
@@ -94,6 +94,12 @@ class OveruseFrameDetector {
   // Called for each captured frame.
   void FrameCaptured(const VideoFrame& frame, int64_t time_when_first_seen_ms);
 
+  // Called after encoding a frame with the CPU time the encoding thread spent
+  // on it. When reported, it's used as the processing time of the frame
+  // instead of the time from capture until the frame is sent, which also
+  // counts the time the thread waited for the CPU.
+  void FrameEncoded(uint32_t timestamp, int64_t encode_cpu_time_us);
+
   // Called for each sent frame.
   void FrameSent(uint32_t timestamp, int64_t time_sent_in_ms);
 
@@ -108,13 +114,23 @@ class OveruseFrameDetector {
         : capture_ntp_ms(capture_ntp_ms),
           timestamp(timestamp),
           capture_ms(now),
-          last_send_ms(-1) {}
+          last_send_ms(-1),
+          encode_cpu_time_us(-1) {}
     int64_t capture_ntp_ms;
     uint32_t timestamp;
     int64_t capture_ms;
     int64_t last_send_ms;
+    int64_t encode_cpu_time_us;
   };
 
+  // Returns the timing of the most recent frame with |timestamp|, or nullptr.
+  // Frames are usually encoded and sent shortly after being captured, so the
+  // search from the newest frame ends after a step or two.
+  FrameTiming* FindFrameTiming(uint32_t timestamp);
+  // Removes the oldest frame from |frame_timing_|, after adding its encode
+  // time to the usage if it has been sent.
+  void PopFrameTiming();
+
   void EncodedFrameTimeMeasured(int encode_duration_ms);
   bool IsOverusing(const CpuOveruseMetrics& metrics);
   bool IsUnderusing(const CpuOveruseMetrics& metrics, int64_t time_now);
@@ -156,7 +172,11 @@ class OveruseFrameDetector {
   // TODO(asapersson): Can these be regular members (avoid separate heap
   // allocs)?
   const std::unique_ptr<SendProcessingUsage> usage_ GUARDED_BY(task_checker_);
-  std::list<FrameTiming> frame_timing_ GUARDED_BY(task_checker_);
+  // Ring buffer of the frames waiting for their encode time to be measured,
+  // ordered by capture time.
+  std::vector<FrameTiming> frame_timing_ GUARDED_BY(task_checker_);
+  size_t frame_timing_first_ GUARDED_BY(task_checker_);
+  size_t num_frame_timings_ GUARDED_BY(task_checker_);
 
   RTC_DISALLOW_COPY_AND_ASSIGN(OveruseFrameDetector);
 };
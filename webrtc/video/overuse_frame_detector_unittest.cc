@@ -16,6 +16,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/base/event.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/video_frame.h"
 
@@ -322,6 +323,28 @@ TEST_F(OveruseFrameDetectorTest, UpdatesExistingSamples) {
   }
 }
 
+TEST_F(OveruseFrameDetectorTest, UsesEncodeCpuTimeWhenReported) {
+  // The frames are sent late, e.g. because the encoder thread waited for the
+  // CPU, but encoding them only took kProcessTime5ms of CPU time.
+  EXPECT_CALL(*(observer_.get()), OveruseDetected()).Times(0);
+  static const int kDelayMs = 32;
+  VideoFrame frame;
+  frame.CreateEmptyFrame(kWidth, kHeight, kWidth, kWidth / 2, kWidth / 2);
+  uint32_t timestamp = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    frame.set_timestamp(timestamp);
+    overuse_detector_->FrameCaptured(frame, clock_->TimeInMilliseconds());
+    clock_->AdvanceTimeMilliseconds(kDelayMs);
+    overuse_detector_->FrameEncoded(
+        timestamp, kProcessTime5ms * rtc::kNumMicrosecsPerMillisec);
+    overuse_detector_->FrameSent(timestamp, clock_->TimeInMilliseconds());
+    clock_->AdvanceTimeMilliseconds(kFrameInterval33ms - kDelayMs);
+    timestamp += kFrameInterval33ms * 90;
+    overuse_detector_->CheckForOveruse();
+  }
+  EXPECT_EQ(kProcessTime5ms * 100 / kFrameInterval33ms, UsagePercent());
+}
+
 TEST_F(OveruseFrameDetectorTest, RunOnTqNormalUsage) {
   rtc::TaskQueue queue("OveruseFrameDetectorTestQueue");
 
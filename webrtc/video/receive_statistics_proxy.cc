@@ -13,11 +13,25 @@
 #include <cmath>
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/metrics.h"
 
 namespace webrtc {
+namespace {
+
+template <typename RtpStats>
+std::map<uint32_t, std::unique_ptr<RtpStats>> CreateRtpStats(
+    const VideoReceiveStream::Config::Rtp& rtp_config) {
+  std::map<uint32_t, std::unique_ptr<RtpStats>> rtp_stats;
+  rtp_stats[rtp_config.remote_ssrc].reset(new RtpStats());
+  for (auto it : rtp_config.rtx)
+    rtp_stats[it.second.ssrc].reset(new RtpStats());
+  return rtp_stats;
+}
+
+}  // namespace
 
 ReceiveStatisticsProxy::ReceiveStatisticsProxy(
     const VideoReceiveStream::Config* config,
@@ -29,14 +43,22 @@ ReceiveStatisticsProxy::ReceiveStatisticsProxy(
       decode_fps_estimator_(1000, 1000),
       renders_fps_estimator_(1000, 1000),
       render_fps_tracker_(100, 10u),
-      render_pixel_tracker_(100, 10u) {
+      render_pixel_tracker_(100, 10u),
+      rtp_stats_(CreateRtpStats<RtpStats>(config_.rtp)) {
   stats_.ssrc = config_.rtp.remote_ssrc;
-  for (auto it : config_.rtp.rtx)
-    rtx_stats_[it.second.ssrc] = StreamDataCounters();
 }
 
 ReceiveStatisticsProxy::~ReceiveStatisticsProxy() {
   UpdateHistograms();
+
+  LockContention contention;
+  for (const auto& kv : rtp_stats_) {
+    rtc::CritScope lock(&kv.second->crit);
+    contention.Add(kv.second->contention);
+  }
+  LOG(LS_INFO) << "Receive stats: " << contention.num_contended_acquisitions
+               << " of " << contention.num_acquisitions
+               << " acquisitions of the RTP stats locks were contended.";
 }
 
 void ReceiveStatisticsProxy::UpdateHistograms() {
@@ -99,10 +121,16 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
   if (delay_ms != -1)
     RTC_HISTOGRAM_COUNTS_10000("WebRTC.Video.OnewayDelayInMs", delay_ms);
 
-  StreamDataCounters rtp = stats_.rtp_stats;
+  int e2e_delay_ms = e2e_delay_counter_.Avg(kMinRequiredSamples);
+  if (e2e_delay_ms != -1)
+    RTC_HISTOGRAM_COUNTS_10000("WebRTC.Video.EndToEndDelayInMs", e2e_delay_ms);
+
+  StreamDataCounters rtp = GetRtpCounters(stats_.ssrc);
   StreamDataCounters rtx;
-  for (auto it : rtx_stats_)
-    rtx.Add(it.second);
+  for (const auto& kv : rtp_stats_) {
+    if (kv.first != stats_.ssrc)
+      rtx.Add(GetRtpCounters(kv.first));
+  }
   StreamDataCounters rtp_rtx = rtp;
   rtp_rtx.Add(rtx);
   int64_t elapsed_sec =
@@ -123,7 +151,7 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
         "WebRTC.Video.RetransmittedBitrateReceivedInKbps",
         static_cast<int>(rtp_rtx.retransmitted.TotalBytes() * 8 / elapsed_sec /
                          1000));
-    if (!rtx_stats_.empty()) {
+    if (rtp_stats_.size() > 1) {
       RTC_HISTOGRAM_COUNTS_10000("WebRTC.Video.RtxBitrateReceivedInKbps",
                                  static_cast<int>(rtx.transmitted.TotalBytes() *
                                                   8 / elapsed_sec / 1000));
@@ -148,8 +176,20 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
 }
 
 VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
-  rtc::CritScope lock(&crit_);
-  return stats_;
+  VideoReceiveStream::Stats stats;
+  {
+    rtc::CritScope lock(&crit_);
+    stats = stats_;
+  }
+  stats.rtp_stats = GetRtpCounters(stats.ssrc);
+  return stats;
+}
+
+StreamDataCounters ReceiveStatisticsProxy::GetRtpCounters(
+    uint32_t ssrc) const {
+  RtpStats* rtp = rtp_stats_.find(ssrc)->second.get();
+  CountingCritScope lock(&rtp->crit, &rtp->contention);
+  return rtp->counters;
 }
 
 void ReceiveStatisticsProxy::OnIncomingPayloadType(int payload_type) {
@@ -227,17 +267,14 @@ void ReceiveStatisticsProxy::CNameChanged(const char* cname, uint32_t ssrc) {
 void ReceiveStatisticsProxy::DataCountersUpdated(
     const webrtc::StreamDataCounters& counters,
     uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  if (ssrc == stats_.ssrc) {
-    stats_.rtp_stats = counters;
-  } else {
-    auto it = rtx_stats_.find(ssrc);
-    if (it != rtx_stats_.end()) {
-      it->second = counters;
-    } else {
-      RTC_NOTREACHED() << "Unexpected stream ssrc: " << ssrc;
-    }
+  auto it = rtp_stats_.find(ssrc);
+  if (it == rtp_stats_.end()) {
+    RTC_NOTREACHED() << "Unexpected stream ssrc: " << ssrc;
+    return;
   }
+  RtpStats* rtp = it->second.get();
+  CountingCritScope lock(&rtp->crit, &rtp->contention);
+  rtp->counters = counters;
 }
 
 void ReceiveStatisticsProxy::OnDecodedFrame() {
@@ -248,12 +285,23 @@ void ReceiveStatisticsProxy::OnDecodedFrame() {
   stats_.decode_frame_rate = decode_fps_estimator_.Rate(now).value_or(0);
 }
 
-void ReceiveStatisticsProxy::OnRenderedFrame(int width, int height) {
+void ReceiveStatisticsProxy::OnRenderedFrame(const VideoFrame& frame) {
+  int width = frame.width();
+  int height = frame.height();
   RTC_DCHECK_GT(width, 0);
   RTC_DCHECK_GT(height, 0);
   uint64_t now = clock_->TimeInMilliseconds();
 
   rtc::CritScope lock(&crit_);
+  // The capture time is estimated once an RTCP sender report has been
+  // received, until then it is 0.
+  if (frame.ntp_time_ms() > 0) {
+    int64_t delay_ms = clock_->CurrentNtpInMilliseconds() - frame.ntp_time_ms();
+    if (delay_ms >= 0) {
+      stats_.end_to_end_delay_ms = static_cast<int>(delay_ms);
+      e2e_delay_counter_.Add(stats_.end_to_end_delay_ms);
+    }
+  }
   renders_fps_estimator_.Update(1, now);
   stats_.render_frame_rate = renders_fps_estimator_.Rate(now).value_or(0);
   stats_.width = width;
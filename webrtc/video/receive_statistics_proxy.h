@@ -12,6 +12,7 @@
 #define WEBRTC_VIDEO_RECEIVE_STATISTICS_PROXY_H_
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include "webrtc/base/criticalsection.h"
@@ -21,8 +22,10 @@
 #include "webrtc/common_types.h"
 #include "webrtc/common_video/include/frame_callback.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
+#include "webrtc/video/counting_crit_scope.h"
 #include "webrtc/video/report_block_stats.h"
 #include "webrtc/video/video_stream_decoder.h"
+#include "webrtc/video_frame.h"
 #include "webrtc/video_receive_stream.h"
 
 namespace webrtc {
@@ -45,7 +48,7 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
 
   void OnDecodedFrame();
   void OnSyncOffsetUpdated(int64_t sync_offset_ms);
-  void OnRenderedFrame(int width, int height);
+  void OnRenderedFrame(const VideoFrame& frame);
   void OnIncomingPayloadType(int payload_type);
   void OnDecoderImplementationName(const char* implementation_name);
   void OnIncomingRate(unsigned int framerate, unsigned int bitrate_bps);
@@ -93,7 +96,17 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
     SampleCounter vp8;
   };
 
+  // The RTP counters of an SSRC, which are reported per packet on the network
+  // thread. Each SSRC has its own lock, so these updates don't contend with
+  // the decoder and render threads, which use |crit_|.
+  struct RtpStats {
+    rtc::CriticalSection crit;
+    LockContention contention GUARDED_BY(crit);
+    StreamDataCounters counters GUARDED_BY(crit);
+  };
+
   void UpdateHistograms() EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  StreamDataCounters GetRtpCounters(uint32_t ssrc) const;
 
   Clock* const clock_;
   // Ownership of this object lies with the owner of the ReceiveStatisticsProxy
@@ -120,9 +133,11 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   SampleCounter target_delay_counter_ GUARDED_BY(crit_);
   SampleCounter current_delay_counter_ GUARDED_BY(crit_);
   SampleCounter delay_counter_ GUARDED_BY(crit_);
+  SampleCounter e2e_delay_counter_ GUARDED_BY(crit_);
   ReportBlockStats report_block_stats_ GUARDED_BY(crit_);
   QpCounters qp_counters_;  // Only accessed on the decoding thread.
-  std::map<uint32_t, StreamDataCounters> rtx_stats_ GUARDED_BY(crit_);
+  // Created for the media and RTX SSRCs in the constructor, then const.
+  const std::map<uint32_t, std::unique_ptr<RtpStats>> rtp_stats_;
 };
 
 }  // namespace webrtc
@@ -10,23 +10,36 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "gflags/gflags.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 #include "webrtc/base/checks.h"
+#include "webrtc/base/criticalsection.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/base/stringencode.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/call.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_header_parser.h"
+#include "webrtc/modules/rtp_rtcp/source/rtp_format.h"
+#include "webrtc/modules/video_coding/frame_object.h"
+#include "webrtc/modules/video_coding/include/video_coding.h"
+#include "webrtc/modules/video_coding/packet_buffer.h"
+#include "webrtc/modules/video_coding/utility/vp8_header_parser.h"
 #include "webrtc/system_wrappers/include/clock.h"
 #include "webrtc/system_wrappers/include/sleep.h"
 #include "webrtc/test/encoder_settings.h"
 #include "webrtc/test/null_transport.h"
 #include "webrtc/test/fake_decoder.h"
-#include "webrtc/test/rtp_file_reader.h"
+#include "webrtc/test/mapped_rtp_file_reader.h"
 #include "webrtc/test/run_loop.h"
 #include "webrtc/test/run_test.h"
 #include "webrtc/test/video_capturer.h"
@@ -109,7 +122,9 @@ bool ValidateInputFilenameNotEmpty(const char* flagname,
   return !string.empty();
 }
 
-DEFINE_string(input_file, "", "input file");
+DEFINE_string(input_file,
+              "",
+              "input file, or comma separated list of input files with --fast");
 static std::string InputFile() {
   return static_cast<std::string>(FLAGS_input_file);
 }
@@ -132,6 +147,21 @@ static std::string DecoderBitstreamFilename() {
 DEFINE_string(codec, "VP8", "Video codec");
 static std::string Codec() { return static_cast<std::string>(FLAGS_codec); }
 
+DEFINE_bool(fast,
+            false,
+            "Decode as fast as possible on a simulated clock, instead of in "
+            "real time through a VideoReceiveStream. RED, FEC and H264 are "
+            "not supported. Several input files are decoded in parallel.");
+static bool Fast() { return FLAGS_fast; }
+
+DEFINE_string(frame_stats_file,
+              "",
+              "CSV output file with the size, QP and decode time of each "
+              "frame");
+static std::string FrameStatsFile() {
+  return static_cast<std::string>(FLAGS_frame_stats_file);
+}
+
 }  // namespace flags
 
 static const uint32_t kReceiverLocalSsrc = 0x123456;
@@ -206,7 +236,315 @@ class DecoderBitstreamFileWriter : public EncodedFrameObserver {
   FILE* file_;
 };
 
+// Writes one line per decoded frame to a CSV file. Shared by the replays of
+// all input files.
+class FrameStatsWriter {
+ public:
+  explicit FrameStatsWriter(const std::string& filename)
+      : file_(filename.empty() ? nullptr : fopen(filename.c_str(), "w")) {
+    if (!filename.empty() && !file_)
+      fprintf(stderr, "Couldn't open file for writing: %s\n", filename.c_str());
+    if (file_) {
+      fprintf(file_,
+              "input,rtp_timestamp,time_ms,key_frame,size_bytes,qp,"
+              "decode_time_us,result\n");
+    }
+  }
+  ~FrameStatsWriter() {
+    if (file_)
+      fclose(file_);
+  }
+
+  // |time_ms| is the render time of the frame, or with --fast the time the
+  // frame was complete according to the dump. |qp| is -1 if unknown.
+  void Write(int input,
+             const EncodedImage& image,
+             int64_t time_ms,
+             int qp,
+             int64_t decode_time_us,
+             int32_t result) {
+    if (!file_)
+      return;
+    rtc::CritScope lock(&crit_);
+    fprintf(file_, "%d,%u,%lld,%d,%u,%d,%lld,%d\n", input, image._timeStamp,
+            static_cast<long long>(time_ms),
+            image._frameType == kVideoFrameKey ? 1 : 0,
+            static_cast<unsigned>(image._length), qp,
+            static_cast<long long>(decode_time_us), result);
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  FILE* const file_;
+};
+
+// Times the frames passing through |decoder| and writes their stats.
+class FrameStatsDecoder : public VideoDecoder {
+ public:
+  FrameStatsDecoder(VideoDecoder* decoder, int input, FrameStatsWriter* writer)
+      : decoder_(decoder), input_(input), writer_(writer) {}
+
+  int32_t InitDecode(const VideoCodec* codec_settings,
+                     int32_t number_of_cores) override {
+    return decoder_->InitDecode(codec_settings, number_of_cores);
+  }
+
+  int32_t Decode(const EncodedImage& input_image,
+                 bool missing_frames,
+                 const RTPFragmentationHeader* fragmentation,
+                 const CodecSpecificInfo* codec_specific_info,
+                 int64_t render_time_ms) override {
+    int64_t start_us = rtc::TimeMicros();
+    int32_t result = decoder_->Decode(input_image, missing_frames,
+                                      fragmentation, codec_specific_info,
+                                      render_time_ms);
+    int64_t decode_time_us = rtc::TimeMicros() - start_us;
+    int qp = -1;
+    if (codec_specific_info &&
+        codec_specific_info->codecType == kVideoCodecVP8 &&
+        !vp8::GetQp(input_image._buffer, input_image._length, &qp)) {
+      qp = -1;
+    }
+    writer_->Write(input_, input_image, render_time_ms, qp, decode_time_us,
+                   result);
+    return result;
+  }
+
+  int32_t RegisterDecodeCompleteCallback(
+      DecodedImageCallback* callback) override {
+    return decoder_->RegisterDecodeCompleteCallback(callback);
+  }
+
+  int32_t Release() override { return decoder_->Release(); }
+
+  bool PrefersLateDecoding() const override {
+    return decoder_->PrefersLateDecoding();
+  }
+
+  const char* ImplementationName() const override {
+    return decoder_->ImplementationName();
+  }
+
+ private:
+  const std::unique_ptr<VideoDecoder> decoder_;
+  const int input_;
+  FrameStatsWriter* const writer_;
+};
+
+std::unique_ptr<test::MappedRtpFileReader> OpenRtpFile(
+    const std::string& filename,
+    const std::set<uint32_t>& ssrc_filter) {
+  std::unique_ptr<test::MappedRtpFileReader> rtp_reader(
+      test::MappedRtpFileReader::Create(test::RtpFileReader::kRtpDump,
+                                        filename, ssrc_filter));
+  if (!rtp_reader) {
+    rtp_reader = test::MappedRtpFileReader::Create(
+        test::RtpFileReader::kPcap, filename, ssrc_filter);
+    if (!rtp_reader) {
+      fprintf(stderr,
+              "Couldn't open input file as either a rtpdump or .pcap. Note "
+              "that .pcapng is not supported.\nTrying to interpret the file as "
+              "length/packet interleaved.\n");
+      rtp_reader = test::MappedRtpFileReader::Create(
+          test::RtpFileReader::kLengthPacketInterleaved, filename,
+          ssrc_filter);
+      if (!rtp_reader) {
+        fprintf(stderr,
+                "Unable to open input file with any supported format\n");
+      }
+    }
+  }
+  return rtp_reader;
+}
+
+// Replays one input file with --fast. The packets are depacketized and
+// assembled into frames as they are read, with a simulated clock following
+// the arrival times in the dump, and each complete frame is decoded right
+// away. There is no jitter buffer, NACK or rendering, so the replay runs as
+// fast as the decoder does.
+class FastReplay : public video_coding::OnReceivedFrameCallback,
+                   public DecodedImageCallback {
+ public:
+  FastReplay(int input,
+             const std::string& input_file,
+             const std::string& out_base,
+             FrameStatsWriter* frame_stats)
+      : input_(input),
+        input_file_(input_file),
+        file_passthrough_(out_base, nullptr),
+        frame_stats_(frame_stats),
+        clock_(0),
+        thread_(&FastReplay::RunThread, this, "FastReplay"),
+        packet_payloads_(kMaxPacketBufferSize) {}
+
+  void Start() { thread_.Start(); }
+  void Stop() { thread_.Stop(); }
+
+  void Run() {
+    std::unique_ptr<test::MappedRtpFileReader> rtp_reader =
+        OpenRtpFile(input_file_, {flags::Ssrc()});
+    if (!rtp_reader)
+      return;
+    RtpVideoCodecTypes rtp_codec_type;
+    VideoCodecType codec_type;
+    if (flags::Codec() == "VP8") {
+      rtp_codec_type = kRtpVideoVp8;
+      codec_type = kVideoCodecVP8;
+    } else if (flags::Codec() == "VP9") {
+      rtp_codec_type = kRtpVideoVp9;
+      codec_type = kVideoCodecVP9;
+    } else {
+      fprintf(stderr, "--fast only supports VP8 and VP9.\n");
+      return;
+    }
+
+    VideoSendStream::Config::EncoderSettings encoder_settings;
+    encoder_settings.payload_name = flags::Codec();
+    encoder_settings.payload_type = flags::PayloadType();
+    decoder_.reset(new FrameStatsDecoder(
+        test::CreateMatchingDecoder(encoder_settings).decoder, input_,
+        frame_stats_));
+    VideoCodec codec;
+    VideoCodingModule::Codec(codec_type, &codec);
+    if (decoder_->InitDecode(&codec, 1) != WEBRTC_VIDEO_CODEC_OK) {
+      fprintf(stderr, "Failed to initialize the decoder.\n");
+      return;
+    }
+    decoder_->RegisterDecodeCompleteCallback(this);
+
+    rtc::scoped_refptr<video_coding::PacketBuffer> packet_buffer =
+        video_coding::PacketBuffer::Create(&clock_, kStartPacketBufferSize,
+                                           kMaxPacketBufferSize, this);
+    std::unique_ptr<RtpHeaderParser> parser(RtpHeaderParser::Create());
+    std::unique_ptr<RtpDepacketizer> depacketizer(
+        RtpDepacketizer::Create(rtp_codec_type));
+    int64_t start_ms = rtc::TimeMillis();
+    int num_packets = 0;
+    while (true) {
+      test::MappedRtpFileReader::Packet packet;
+      if (!rtp_reader->NextPacketView(&packet))
+        break;
+      if (packet.time_ms > clock_.TimeInMilliseconds())
+        clock_.AdvanceTimeMilliseconds(packet.time_ms -
+                                       clock_.TimeInMilliseconds());
+      RTPHeader header;
+      if (!parser->Parse(packet.data, packet.length, &header) ||
+          header.ssrc != flags::Ssrc() ||
+          header.payloadType != flags::PayloadType()) {
+        continue;
+      }
+      const size_t header_length = header.headerLength + header.paddingLength;
+      if (packet.length <= header_length)
+        continue;
+      ++num_packets;
+      // The packet buffer refers to the payload until the frame is complete,
+      // and holds at most kMaxPacketBufferSize packets.
+      rtc::Buffer* payload =
+          &packet_payloads_[header.sequenceNumber % kMaxPacketBufferSize];
+      payload->SetData(packet.data + header.headerLength,
+                       packet.length - header_length);
+      RtpDepacketizer::ParsedPayload parsed_payload;
+      if (!depacketizer->Parse(&parsed_payload, payload->data(),
+                               payload->size())) {
+        continue;
+      }
+      WebRtcRTPHeader rtp_header;
+      memset(&rtp_header, 0, sizeof(rtp_header));
+      rtp_header.header = header;
+      rtp_header.frameType = parsed_payload.frame_type;
+      rtp_header.type = parsed_payload.type;
+      packet_buffer->InsertPacket(VCMPacket(parsed_payload.payload,
+                                            parsed_payload.payload_length,
+                                            rtp_header));
+      DecodeFrames(packet_buffer.get());
+    }
+    decoder_->Release();
+    int64_t elapsed_ms = std::max<int64_t>(rtc::TimeMillis() - start_ms, 1);
+    fprintf(stderr,
+            "%s: %d packets, %d frames decoded, %d decode errors, %.1fx real "
+            "time\n",
+            input_file_.c_str(), num_packets, num_decoded_frames_,
+            num_decode_errors_,
+            static_cast<double>(clock_.TimeInMilliseconds()) / elapsed_ms);
+  }
+
+  // Implements video_coding::OnReceivedFrameCallback. Called by the packet
+  // buffer while it holds its lock, so the frame is decoded later.
+  void OnReceivedFrame(
+      std::unique_ptr<video_coding::RtpFrameObject> frame) override {
+    frames_.push_back(std::move(frame));
+  }
+
+  // Implements DecodedImageCallback.
+  int32_t Decoded(VideoFrame& frame) override {
+    ++num_decoded_frames_;
+    static_cast<rtc::VideoSinkInterface<VideoFrame>*>(&file_passthrough_)
+        ->OnFrame(frame);
+    return 0;
+  }
+
+ private:
+  static const size_t kStartPacketBufferSize = 512;
+  static const size_t kMaxPacketBufferSize = 2048;
+
+  static bool RunThread(void* obj) {
+    static_cast<FastReplay*>(obj)->Run();
+    return false;
+  }
+
+  void DecodeFrames(video_coding::PacketBuffer* packet_buffer) {
+    for (std::unique_ptr<video_coding::RtpFrameObject>& frame : frames_) {
+      if (decoder_->Decode(frame->EncodedImage(), false, nullptr,
+                           frame->CodecSpecific(), frame->ReceivedTime()) !=
+          WEBRTC_VIDEO_CODEC_OK) {
+        ++num_decode_errors_;
+      }
+      // Drop incomplete frames from before this one.
+      uint16_t last_seq_num = frame->last_seq_num();
+      frame.reset();
+      packet_buffer->ClearTo(last_seq_num);
+    }
+    frames_.clear();
+  }
+
+  const int input_;
+  const std::string input_file_;
+  FileRenderPassthrough file_passthrough_;
+  FrameStatsWriter* const frame_stats_;
+  SimulatedClock clock_;
+  rtc::PlatformThread thread_;
+  std::unique_ptr<VideoDecoder> decoder_;
+  std::vector<rtc::Buffer> packet_payloads_;
+  std::vector<std::unique_ptr<video_coding::RtpFrameObject>> frames_;
+  int num_decoded_frames_ = 0;
+  int num_decode_errors_ = 0;
+};
+
+void FastRtpReplay() {
+  FrameStatsWriter frame_stats(flags::FrameStatsFile());
+  std::vector<std::string> input_files;
+  rtc::split(flags::InputFile(), ',', &input_files);
+  std::vector<std::unique_ptr<FastReplay>> replays;
+  for (size_t i = 0; i < input_files.size(); ++i) {
+    std::string out_base = flags::OutBase();
+    if (!out_base.empty() && input_files.size() > 1)
+      out_base += "_" + std::to_string(i);
+    replays.emplace_back(new FastReplay(static_cast<int>(i), input_files[i],
+                                        out_base, &frame_stats));
+  }
+  for (const auto& replay : replays)
+    replay->Start();
+  for (const auto& replay : replays)
+    replay->Stop();
+}
+
 void RtpReplay() {
+  if (flags::Fast()) {
+    FastRtpReplay();
+    return;
+  }
+
+  FrameStatsWriter frame_stats(flags::FrameStatsFile());
   std::unique_ptr<test::VideoRenderer> playback_video(
       test::VideoRenderer::Create("Playback Video", 640, 480));
   FileRenderPassthrough file_passthrough(flags::OutBase(),
@@ -248,38 +586,24 @@ void RtpReplay() {
     delete decoder.decoder;
     decoder.decoder = new test::FakeNullDecoder();
   }
+  decoder.decoder = new FrameStatsDecoder(decoder.decoder, 0, &frame_stats);
   receive_config.decoders.push_back(decoder);
 
   VideoReceiveStream* receive_stream =
       call->CreateVideoReceiveStream(std::move(receive_config));
 
-  std::unique_ptr<test::RtpFileReader> rtp_reader(test::RtpFileReader::Create(
-      test::RtpFileReader::kRtpDump, flags::InputFile()));
-  if (!rtp_reader) {
-    rtp_reader.reset(test::RtpFileReader::Create(test::RtpFileReader::kPcap,
-                                                 flags::InputFile()));
-    if (!rtp_reader) {
-      fprintf(stderr,
-              "Couldn't open input file as either a rtpdump or .pcap. Note "
-              "that .pcapng is not supported.\nTrying to interpret the file as "
-              "length/packet interleaved.\n");
-      rtp_reader.reset(test::RtpFileReader::Create(
-          test::RtpFileReader::kLengthPacketInterleaved, flags::InputFile()));
-      if (!rtp_reader) {
-        fprintf(stderr,
-                "Unable to open input file with any supported format\n");
-        return;
-      }
-    }
-  }
+  std::unique_ptr<test::MappedRtpFileReader> rtp_reader =
+      OpenRtpFile(flags::InputFile(), std::set<uint32_t>());
+  if (!rtp_reader)
+    return;
   receive_stream->Start();
 
   uint32_t last_time_ms = 0;
   int num_packets = 0;
   std::map<uint32_t, int> unknown_packets;
   while (true) {
-    test::RtpPacket packet;
-    if (!rtp_reader->NextPacket(&packet))
+    test::MappedRtpFileReader::Packet packet;
+    if (!rtp_reader->NextPacketView(&packet))
       break;
     ++num_packets;
     switch (call->Receiver()->DeliverPacket(webrtc::MediaType::ANY, packet.data,
@@ -65,6 +65,17 @@ void UpdateCodecTypeHistogram(const std::string& payload_name) {
                             PayloadNameToHistogramCodecType(payload_name),
                             kVideoMax);
 }
+
+template <typename RtpStats>
+std::map<uint32_t, std::unique_ptr<RtpStats>> CreateRtpStats(
+    const VideoSendStream::Config::Rtp& rtp_config) {
+  std::map<uint32_t, std::unique_ptr<RtpStats>> rtp_stats;
+  for (uint32_t ssrc : rtp_config.ssrcs)
+    rtp_stats[ssrc].reset(new RtpStats());
+  for (uint32_t ssrc : rtp_config.rtx.ssrcs)
+    rtp_stats[ssrc].reset(new RtpStats());
+  return rtp_stats;
+}
 }  // namespace
 
 
@@ -77,18 +88,30 @@ SendStatisticsProxy::SendStatisticsProxy(
     : clock_(clock),
       payload_name_(config.encoder_settings.payload_name),
       rtp_config_(config.rtp),
+      rtp_stats_(CreateRtpStats<RtpStats>(config.rtp)),
       content_type_(content_type),
       start_ms_(clock->TimeInMilliseconds()),
       last_sent_frame_timestamp_(0),
       encode_time_(kEncodeTimeWeigthFactor),
+      capture_to_encode_delay_(kEncodeTimeWeigthFactor),
       uma_container_(
           new UmaSamplesContainer(GetUmaPrefix(content_type_), stats_, clock)) {
 }
 
 SendStatisticsProxy::~SendStatisticsProxy() {
   rtc::CritScope lock(&crit_);
+  MergeRtpStats();
   uma_container_->UpdateHistograms(rtp_config_, stats_);
 
+  LockContention contention;
+  for (const auto& kv : rtp_stats_) {
+    rtc::CritScope rtp_lock(&kv.second->crit);
+    contention.Add(kv.second->contention);
+  }
+  LOG(LS_INFO) << "Send stats: " << contention.num_contended_acquisitions
+               << " of " << contention.num_acquisitions
+               << " acquisitions of the RTP stats locks were contended.";
+
   int64_t elapsed_sec = (clock_->TimeInMilliseconds() - start_ms_) / 1000;
   RTC_HISTOGRAM_COUNTS_100000("WebRTC.Video.SendStreamLifetimeInSeconds",
                               elapsed_sec);
@@ -97,6 +120,16 @@ SendStatisticsProxy::~SendStatisticsProxy() {
     UpdateCodecTypeHistogram(payload_name_);
 }
 
+SendStatisticsProxy::RtpStats::RtpStats()
+    : updated(false),
+      total_bitrate_bps(0),
+      retransmit_bitrate_bps(0),
+      avg_delay_ms(0),
+      max_delay_ms(0),
+      first_rtp_stats_time_ms(-1) {}
+
+SendStatisticsProxy::RtpStats::~RtpStats() {}
+
 SendStatisticsProxy::UmaSamplesContainer::UmaSamplesContainer(
     const char* prefix,
     const VideoSendStream::Stats& stats,
@@ -343,6 +376,7 @@ void SendStatisticsProxy::SetContentType(
     VideoEncoderConfig::ContentType content_type) {
   rtc::CritScope lock(&crit_);
   if (content_type_ != content_type) {
+    MergeRtpStats();
     uma_container_->UpdateHistograms(rtp_config_, stats_);
     uma_container_.reset(
         new UmaSamplesContainer(GetUmaPrefix(content_type), stats_, clock_));
@@ -372,8 +406,27 @@ void SendStatisticsProxy::OnSuspendChange(bool is_suspended) {
   stats_.suspended = is_suspended;
 }
 
+void SendStatisticsProxy::OnNativeToI420Conversion() {
+  rtc::CritScope lock(&crit_);
+  ++stats_.native_to_i420_conversions;
+}
+
+void SendStatisticsProxy::OnFramesDroppedByEncoderQueue(int num_frames) {
+  rtc::CritScope lock(&crit_);
+  stats_.frames_dropped_by_encoder_queue += num_frames;
+}
+
+void SendStatisticsProxy::OnFrameDequeuedForEncode(
+    int capture_to_encode_delay_ms) {
+  rtc::CritScope lock(&crit_);
+  capture_to_encode_delay_.Apply(1.0f, capture_to_encode_delay_ms);
+  stats_.avg_capture_to_encode_delay_ms =
+      round(capture_to_encode_delay_.filtered());
+}
+
 VideoSendStream::Stats SendStatisticsProxy::GetStats() {
   rtc::CritScope lock(&crit_);
+  MergeRtpStats();
   PurgeOldStats();
   stats_.input_frame_rate =
       round(uma_container_->input_frame_rate_tracker_.ComputeRate());
@@ -417,6 +470,40 @@ VideoSendStream::StreamStats* SendStatisticsProxy::GetStatsEntry(
   return entry;
 }
 
+SendStatisticsProxy::RtpStats* SendStatisticsProxy::GetRtpStats(
+    uint32_t ssrc) const {
+  auto it = rtp_stats_.find(ssrc);
+  return it != rtp_stats_.end() ? it->second.get() : nullptr;
+}
+
+void SendStatisticsProxy::MergeRtpStats() {
+  for (const auto& kv : rtp_stats_) {
+    RtpStats* rtp = kv.second.get();
+    CountingCritScope rtp_lock(&rtp->crit, &rtp->contention);
+    if (!rtp->updated)
+      continue;
+    VideoSendStream::StreamStats* stats = GetStatsEntry(kv.first);
+    stats->rtp_stats = rtp->rtp_stats;
+    stats->total_bitrate_bps = rtp->total_bitrate_bps;
+    stats->retransmit_bitrate_bps = rtp->retransmit_bitrate_bps;
+    stats->frame_counts = rtp->frame_counts;
+    stats->avg_delay_ms = rtp->avg_delay_ms;
+    stats->max_delay_ms = rtp->max_delay_ms;
+
+    if (rtp->first_rtp_stats_time_ms != -1 &&
+        (uma_container_->first_rtp_stats_time_ms_ == -1 ||
+         rtp->first_rtp_stats_time_ms <
+             uma_container_->first_rtp_stats_time_ms_)) {
+      uma_container_->first_rtp_stats_time_ms_ = rtp->first_rtp_stats_time_ms;
+    }
+    rtp->first_rtp_stats_time_ms = -1;
+    uma_container_->delay_counter_.Add(rtp->delay_counter);
+    uma_container_->max_delay_counter_.Add(rtp->max_delay_counter);
+    rtp->delay_counter = SampleCounter();
+    rtp->max_delay_counter = SampleCounter();
+  }
+}
+
 void SendStatisticsProxy::OnInactiveSsrc(uint32_t ssrc) {
   rtc::CritScope lock(&crit_);
   VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
@@ -427,6 +514,11 @@ void SendStatisticsProxy::OnInactiveSsrc(uint32_t ssrc) {
   stats->retransmit_bitrate_bps = 0;
   stats->height = 0;
   stats->width = 0;
+
+  RtpStats* rtp = GetRtpStats(ssrc);
+  CountingCritScope rtp_lock(&rtp->crit, &rtp->contention);
+  rtp->total_bitrate_bps = 0;
+  rtp->retransmit_bitrate_bps = 0;
 }
 
 void SendStatisticsProxy::OnSetEncoderTargetRate(uint32_t bitrate_bps) {
@@ -568,50 +660,53 @@ void SendStatisticsProxy::CNameChanged(const char* cname, uint32_t ssrc) {}
 void SendStatisticsProxy::DataCountersUpdated(
     const StreamDataCounters& counters,
     uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
-  RTC_DCHECK(stats) << "DataCountersUpdated reported for unknown ssrc: "
-                    << ssrc;
-
-  stats->rtp_stats = counters;
-  if (uma_container_->first_rtp_stats_time_ms_ == -1)
-    uma_container_->first_rtp_stats_time_ms_ = clock_->TimeInMilliseconds();
+  RtpStats* rtp = GetRtpStats(ssrc);
+  RTC_DCHECK(rtp) << "DataCountersUpdated reported for unknown ssrc: " << ssrc;
+
+  CountingCritScope lock(&rtp->crit, &rtp->contention);
+  rtp->updated = true;
+  rtp->rtp_stats = counters;
+  if (rtp->first_rtp_stats_time_ms == -1)
+    rtp->first_rtp_stats_time_ms = clock_->TimeInMilliseconds();
 }
 
 void SendStatisticsProxy::Notify(uint32_t total_bitrate_bps,
                                  uint32_t retransmit_bitrate_bps,
                                  uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
-  if (!stats)
+  RtpStats* rtp = GetRtpStats(ssrc);
+  if (!rtp)
     return;
 
-  stats->total_bitrate_bps = total_bitrate_bps;
-  stats->retransmit_bitrate_bps = retransmit_bitrate_bps;
+  CountingCritScope lock(&rtp->crit, &rtp->contention);
+  rtp->updated = true;
+  rtp->total_bitrate_bps = total_bitrate_bps;
+  rtp->retransmit_bitrate_bps = retransmit_bitrate_bps;
 }
 
 void SendStatisticsProxy::FrameCountUpdated(const FrameCounts& frame_counts,
                                             uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
-  if (!stats)
+  RtpStats* rtp = GetRtpStats(ssrc);
+  if (!rtp)
     return;
 
-  stats->frame_counts = frame_counts;
+  CountingCritScope lock(&rtp->crit, &rtp->contention);
+  rtp->updated = true;
+  rtp->frame_counts = frame_counts;
 }
 
 void SendStatisticsProxy::SendSideDelayUpdated(int avg_delay_ms,
                                                int max_delay_ms,
                                                uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
-  if (!stats)
+  RtpStats* rtp = GetRtpStats(ssrc);
+  if (!rtp)
     return;
-  stats->avg_delay_ms = avg_delay_ms;
-  stats->max_delay_ms = max_delay_ms;
 
-  uma_container_->delay_counter_.Add(avg_delay_ms);
-  uma_container_->max_delay_counter_.Add(max_delay_ms);
+  CountingCritScope lock(&rtp->crit, &rtp->contention);
+  rtp->updated = true;
+  rtp->avg_delay_ms = avg_delay_ms;
+  rtp->max_delay_ms = max_delay_ms;
+  rtp->delay_counter.Add(avg_delay_ms);
+  rtp->max_delay_counter.Add(max_delay_ms);
 }
 
 void SendStatisticsProxy::SampleCounter::Add(int sample) {
@@ -619,6 +714,11 @@ void SendStatisticsProxy::SampleCounter::Add(int sample) {
   ++num_samples;
 }
 
+void SendStatisticsProxy::SampleCounter::Add(const SampleCounter& other) {
+  sum += other.sum;
+  num_samples += other.num_samples;
+}
+
 int SendStatisticsProxy::SampleCounter::Avg(int min_required_samples) const {
   if (num_samples < min_required_samples || num_samples == 0)
     return -1;
@@ -23,6 +23,7 @@
 #include "webrtc/modules/video_coding/include/video_codec_interface.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
 #include "webrtc/system_wrappers/include/clock.h"
+#include "webrtc/video/counting_crit_scope.h"
 #include "webrtc/video/overuse_frame_detector.h"
 #include "webrtc/video/report_block_stats.h"
 #include "webrtc/video/vie_encoder.h"
@@ -54,6 +55,14 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
 
   void OnEncoderStatsUpdate(uint32_t framerate, uint32_t bitrate);
   void OnSuspendChange(bool is_suspended);
+  // Used to count texture frames read back to memory for the encoder.
+  void OnNativeToI420Conversion();
+  // Used to report frames that were dropped because a newer frame arrived
+  // before they were encoded.
+  void OnFramesDroppedByEncoderQueue(int num_frames);
+  // Used to report the delay between a frame being captured and the encoder
+  // picking it up.
+  void OnFrameDequeuedForEncode(int capture_to_encode_delay_ms);
   void OnInactiveSsrc(uint32_t ssrc);
 
   // Used to indicate change in content type, which may require a change in
@@ -101,6 +110,8 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
     SampleCounter() : sum(0), num_samples(0) {}
     ~SampleCounter() {}
     void Add(int sample);
+    // Adds the samples of |other|.
+    void Add(const SampleCounter& other);
     int Avg(int min_required_samples) const;
 
    private:
@@ -129,13 +140,41 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
     SampleCounter vp8;  // QP range: 0-127
     SampleCounter vp9;  // QP range: 0-255
   };
+  // The stats of an SSRC that the RTP module reports per packet or frame, on
+  // the encoder, pacer and network threads. Each SSRC has its own lock, so
+  // these updates don't contend with each other, nor with the users of
+  // |crit_|. MergeRtpStats() copies them into |stats_|.
+  struct RtpStats {
+    RtpStats();
+    ~RtpStats();
+
+    rtc::CriticalSection crit;
+    LockContention contention GUARDED_BY(crit);
+    // Whether any of the stats below have been reported.
+    bool updated GUARDED_BY(crit);
+    StreamDataCounters rtp_stats GUARDED_BY(crit);
+    int total_bitrate_bps GUARDED_BY(crit);
+    int retransmit_bitrate_bps GUARDED_BY(crit);
+    FrameCounts frame_counts GUARDED_BY(crit);
+    int avg_delay_ms GUARDED_BY(crit);
+    int max_delay_ms GUARDED_BY(crit);
+    // UMA samples since the last merge, -1 if there are none.
+    int64_t first_rtp_stats_time_ms GUARDED_BY(crit);
+    SampleCounter delay_counter GUARDED_BY(crit);
+    SampleCounter max_delay_counter GUARDED_BY(crit);
+  };
   void PurgeOldStats() EXCLUSIVE_LOCKS_REQUIRED(crit_);
   VideoSendStream::StreamStats* GetStatsEntry(uint32_t ssrc)
       EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Returns nullptr if |ssrc| isn't one of the SSRCs of the stream.
+  RtpStats* GetRtpStats(uint32_t ssrc) const;
+  void MergeRtpStats() EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   Clock* const clock_;
   const std::string payload_name_;
   const VideoSendStream::Config::Rtp rtp_config_;
+  // Created for the media and RTX SSRCs in the constructor, then const.
+  const std::map<uint32_t, std::unique_ptr<RtpStats>> rtp_stats_;
   rtc::CriticalSection crit_;
   VideoEncoderConfig::ContentType content_type_ GUARDED_BY(crit_);
   const int64_t start_ms_;
@@ -143,6 +182,7 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   uint32_t last_sent_frame_timestamp_ GUARDED_BY(crit_);
   std::map<uint32_t, StatsUpdateTimes> update_times_ GUARDED_BY(crit_);
   rtc::ExpFilter encode_time_ GUARDED_BY(crit_);
+  rtc::ExpFilter capture_to_encode_delay_ GUARDED_BY(crit_);
 
   // Contains stats used for UMA histograms. These stats will be reset if
   // content type changes between real-time video and screenshare, since these
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/system_wrappers/include/metrics.h"
 #include "webrtc/system_wrappers/include/metrics_default.h"
 
@@ -166,6 +167,25 @@ TEST_F(SendStatisticsProxyTest, Suspended) {
   EXPECT_FALSE(statistics_proxy_->GetStats().suspended);
 }
 
+TEST_F(SendStatisticsProxyTest, NativeToI420Conversions) {
+  EXPECT_EQ(0u, statistics_proxy_->GetStats().native_to_i420_conversions);
+  statistics_proxy_->OnNativeToI420Conversion();
+  statistics_proxy_->OnNativeToI420Conversion();
+  EXPECT_EQ(2u, statistics_proxy_->GetStats().native_to_i420_conversions);
+}
+
+TEST_F(SendStatisticsProxyTest, EncoderQueueStats) {
+  EXPECT_EQ(0u, statistics_proxy_->GetStats().frames_dropped_by_encoder_queue);
+  statistics_proxy_->OnFramesDroppedByEncoderQueue(2);
+  statistics_proxy_->OnFramesDroppedByEncoderQueue(1);
+  EXPECT_EQ(3u, statistics_proxy_->GetStats().frames_dropped_by_encoder_queue);
+
+  const int kDelayMs = 12;
+  statistics_proxy_->OnFrameDequeuedForEncode(kDelayMs);
+  EXPECT_EQ(kDelayMs,
+            statistics_proxy_->GetStats().avg_capture_to_encode_delay_ms);
+}
+
 TEST_F(SendStatisticsProxyTest, FrameCounts) {
   FrameCountObserver* observer = statistics_proxy_.get();
   for (const auto& ssrc : config_.rtp.ssrcs) {
@@ -253,6 +273,66 @@ TEST_F(SendStatisticsProxyTest, Bitrate) {
   ExpectEqual(expected_, stats);
 }
 
+namespace {
+struct DataCountersTask {
+  StreamDataCountersCallback* callback;
+  uint32_t ssrc;
+  int num_updates;
+};
+
+bool UpdateDataCounters(void* obj) {
+  DataCountersTask* task = static_cast<DataCountersTask*>(obj);
+  StreamDataCounters counters;
+  for (int i = 1; i <= task->num_updates; ++i) {
+    counters.transmitted.packets = i;
+    task->callback->DataCountersUpdated(counters, task->ssrc);
+  }
+  return false;
+}
+}  // namespace
+
+TEST_F(SendStatisticsProxyTest, DataCountersReportedOnOtherThreads) {
+  const int kNumUpdates = 10000;
+  DataCountersTask first_task = {statistics_proxy_.get(), kFirstSsrc,
+                                 kNumUpdates};
+  DataCountersTask second_task = {statistics_proxy_.get(), kSecondSsrc,
+                                  kNumUpdates};
+  rtc::PlatformThread first_thread(&UpdateDataCounters, &first_task, "first");
+  rtc::PlatformThread second_thread(&UpdateDataCounters, &second_task,
+                                    "second");
+  first_thread.Start();
+  second_thread.Start();
+  for (int i = 0; i < 100; ++i) {
+    VideoSendStream::Stats stats = statistics_proxy_->GetStats();
+    for (const auto& kv : stats.substreams)
+      EXPECT_LE(kv.second.rtp_stats.transmitted.packets, kNumUpdates);
+  }
+  first_thread.Stop();
+  second_thread.Stop();
+
+  VideoSendStream::Stats stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(static_cast<uint32_t>(kNumUpdates),
+            stats.substreams[kFirstSsrc].rtp_stats.transmitted.packets);
+  EXPECT_EQ(static_cast<uint32_t>(kNumUpdates),
+            stats.substreams[kSecondSsrc].rtp_stats.transmitted.packets);
+}
+
+TEST_F(SendStatisticsProxyTest, SendSideDelayHistogramsIncludeMergedSamples) {
+  SendSideDelayObserver* observer = statistics_proxy_.get();
+  for (int i = 0; i < kMinRequiredSamples; ++i) {
+    observer->SendSideDelayUpdated(10, 20, kFirstSsrc);
+    // Samples are moved to the histogram counters when the stats are merged.
+    if (i == kMinRequiredSamples / 2)
+      statistics_proxy_->GetStats();
+  }
+
+  SetUp();  // Reset stats proxy also causes histograms to be reported.
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Video.SendSideDelayInMs"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.SendSideDelayInMs", 10));
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Video.SendSideDelayMaxInMs"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.SendSideDelayMaxInMs", 20));
+}
+
 TEST_F(SendStatisticsProxyTest, SendSideDelay) {
   SendSideDelayObserver* observer = statistics_proxy_.get();
   for (const auto& ssrc : config_.rtp.ssrcs) {
@@ -10,6 +10,7 @@
 #include "webrtc/video/video_quality_test.h"
 
 #include <stdio.h>
+#include <time.h>
 #include <algorithm>
 #include <deque>
 #include <map>
@@ -21,7 +22,9 @@
 #include "webrtc/base/checks.h"
 #include "webrtc/base/event.h"
 #include "webrtc/base/format_macros.h"
+#include "webrtc/base/memory_usage.h"
 #include "webrtc/base/optional.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/timeutils.h"
 #include "webrtc/call.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
@@ -342,6 +345,18 @@ class VideoAnalyzer : public PacketReceiver,
     stats_polling_thread_.Stop();
   }
 
+  void GetPerfResults(int target_bitrate_bps,
+                      VideoQualityTest::PerfResults* results) {
+    rtc::CritScope crit(&comparison_lock_);
+    results->psnr = psnr_.Mean();
+    results->ssim = ssim_.Mean();
+    results->capture_to_render_ms = end_to_end_.Mean();
+    results->rendered_frames = frames_processed_ - dropped_frames_;
+    results->dropped_frames = dropped_frames_;
+    results->bitrate_utilization =
+        media_bitrate_bps.Mean() / target_bitrate_bps;
+  }
+
   rtc::VideoSinkInterface<VideoFrame>* pre_encode_proxy() {
     return &pre_encode_proxy_;
   }
@@ -798,7 +813,8 @@ class VideoAnalyzer : public PacketReceiver,
   rtc::Event done_;
 };
 
-VideoQualityTest::VideoQualityTest() : clock_(Clock::GetRealTimeClock()) {}
+VideoQualityTest::VideoQualityTest()
+    : clock_(Clock::GetRealTimeClock()), perf_results_() {}
 
 void VideoQualityTest::TestBody() {}
 
@@ -1121,6 +1137,9 @@ void VideoQualityTest::RunWithAnalyzer(const Params& params) {
         << "!";
   }
 
+  rtc::EnableMemoryAccounting();
+  const size_t start_num_threads = rtc::GetRunningThreads().size();
+
   Call::Config call_config;
   call_config.bitrate_config = params.common.call_bitrate_config;
   CreateCalls(call_config, call_config);
@@ -1190,9 +1209,22 @@ void VideoQualityTest::RunWithAnalyzer(const Params& params) {
   for (VideoReceiveStream* receive_stream : video_receive_streams_)
     receive_stream->Start();
   capturer_->Start();
+  const clock_t start_cpu = clock();
 
   analyzer.Wait();
 
+  // CPU time of all threads of the process, except on Windows where clock()
+  // measures wall time.
+  const double cpu_ms = 1000.0 * (clock() - start_cpu) / CLOCKS_PER_SEC;
+  analyzer.GetPerfResults(params_.common.target_bitrate_bps, &perf_results_);
+  perf_results_.cpu_ms_per_frame =
+      cpu_ms / std::max(perf_results_.rendered_frames, 1);
+  perf_results_.accounted_memory_bytes = 0;
+  for (const rtc::MemoryUsage& usage : rtc::GetMemoryUsage())
+    perf_results_.accounted_memory_bytes += usage.bytes;
+  perf_results_.num_threads =
+      rtc::GetRunningThreads().size() - start_num_threads;
+
   send_transport.StopSending();
   recv_transport.StopSending();
 
@@ -1202,6 +1234,8 @@ void VideoQualityTest::RunWithAnalyzer(const Params& params) {
   video_send_stream_->Stop();
 
   DestroyStreams();
+  // Allows running again on the same fixture.
+  video_receive_configs_.clear();
 
   if (graph_data_output_file)
     fclose(graph_data_output_file);
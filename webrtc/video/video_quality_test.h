@@ -77,6 +77,24 @@ class VideoQualityTest : public test::CallTest {
   // selected stream/layer doesn't have the same resolution as the largest
   // stream/layer (to ignore the PSNR and SSIM calculation errors).
 
+  // Summary of a RunWithAnalyzer() call, for tracking performance over time.
+  struct PerfResults {
+    double psnr;
+    double ssim;
+    double capture_to_render_ms;
+    // CPU time of the whole process while the analyzer ran, divided by the
+    // number of rendered frames.
+    double cpu_ms_per_frame;
+    // Media bitrate of the send stream relative to the target bitrate.
+    double bitrate_utilization;
+    // Memory counted with rtc::ScopedMemoryUsage when the analyzer finished.
+    int64_t accounted_memory_bytes;
+    // Threads started by the calls and streams.
+    size_t num_threads;
+    int rendered_frames;
+    int dropped_frames;
+  };
+
   VideoQualityTest();
   void RunWithAnalyzer(const Params& params);
   void RunWithRenderers(const Params& params);
@@ -116,6 +134,7 @@ class VideoQualityTest : public test::CallTest {
   Clock* const clock_;
 
   Params params_;
+  PerfResults perf_results_;
 };
 
 }  // namespace webrtc
@@ -33,6 +33,11 @@ namespace webrtc {
 
 static const bool kEnableFrameRecording = false;
 
+// Frames aren't held back to absorb jitter in the low-latency playout mode, but
+// late frames are still rendered late. Lets the audio be delayed by up to this
+// much of the jitter to stay in sync with the video.
+static const int kLowLatencyMaxJitterDelayMs = 20;
+
 static bool UseSendSideBwe(const VideoReceiveStream::Config& config) {
   if (!config.rtp.transport_cc)
     return false;
@@ -70,6 +75,8 @@ std::string VideoReceiveStream::Config::ToString() const {
   ss << ", rtp: " << rtp.ToString();
   ss << ", renderer: " << (renderer ? "(renderer)" : "nullptr");
   ss << ", render_delay_ms: " << render_delay_ms;
+  ss << ", playout_mode: "
+     << (playout_mode == PlayoutMode::kLowLatency ? "low_latency" : "smooth");
   if (!sync_group.empty())
     ss << ", sync_group: " << sync_group;
   ss << ", pre_decode_callback: "
@@ -133,6 +140,7 @@ std::string VideoReceiveStream::Stats::ToString(int64_t time_ms) const {
   ss << "targ_delay_ms: " << target_delay_ms << ", ";
   ss << "jb_delay_ms: " << jitter_buffer_ms << ", ";
   ss << "min_playout_delay_ms: " << min_playout_delay_ms << ", ";
+  ss << "e2e_delay_ms: " << end_to_end_delay_ms << ", ";
   ss << "discarded: " << discarded_packets << ", ";
   ss << "sync_offset_ms: " << sync_offset_ms << ", ";
   ss << "cum_loss: " << rtcp_stats.cumulative_lost << ", ";
@@ -187,7 +195,8 @@ VideoReceiveStream::VideoReceiveStream(
     webrtc::VoiceEngine* voice_engine,
     ProcessThread* process_thread,
     CallStats* call_stats,
-    VieRemb* remb)
+    VieRemb* remb,
+    rtc::TaskQueuePool* render_pool)
     : transport_adapter_(config.rtcp_send_transport),
       config_(std::move(config)),
       process_thread_(process_thread),
@@ -195,6 +204,7 @@ VideoReceiveStream::VideoReceiveStream(
       decode_thread_(DecodeThreadFunction, this, "DecodingThread"),
       congestion_controller_(congestion_controller),
       call_stats_(call_stats),
+      render_pool_(render_pool),
       video_receiver_(clock_, nullptr, this, this, this),
       stats_proxy_(&config_, clock_),
       rtp_stream_receiver_(
@@ -236,6 +246,8 @@ VideoReceiveStream::VideoReceiveStream(
   }
 
   video_receiver_.SetRenderDelay(config.render_delay_ms);
+  if (config_.playout_mode == Config::PlayoutMode::kLowLatency)
+    video_receiver_.SetLowLatencyMode(kLowLatencyMaxJitterDelayMs);
 
   process_thread_->RegisterModule(&video_receiver_);
   process_thread_->RegisterModule(&rtp_stream_sync_);
@@ -280,11 +292,12 @@ void VideoReceiveStream::Start() {
   transport_adapter_.Enable();
   rtc::VideoSinkInterface<VideoFrame>* renderer = nullptr;
   if (config_.renderer) {
-    if (config_.disable_prerenderer_smoothing) {
+    if (config_.disable_prerenderer_smoothing ||
+        config_.playout_mode == Config::PlayoutMode::kLowLatency) {
       renderer = this;
     } else {
-      incoming_video_stream_.reset(
-          new IncomingVideoStream(config_.render_delay_ms, this));
+      incoming_video_stream_.reset(new IncomingVideoStream(
+          config_.render_delay_ms, this, render_pool_));
       renderer = incoming_video_stream_.get();
     }
   }
@@ -350,7 +363,7 @@ void VideoReceiveStream::OnFrame(const VideoFrame& video_frame) {
   config_.renderer->OnFrame(video_frame);
 
   // TODO(tommi): OnRenderFrame grabs a lock too.
-  stats_proxy_.OnRenderedFrame(video_frame.width(), video_frame.height());
+  stats_proxy_.OnRenderedFrame(video_frame);
 }
 
 // TODO(asapersson): Consider moving callback from video_encoder.h or
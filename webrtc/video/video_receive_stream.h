@@ -26,6 +26,10 @@
 #include "webrtc/video/video_stream_decoder.h"
 #include "webrtc/video_receive_stream.h"
 
+namespace rtc {
+class TaskQueuePool;
+}  // namespace rtc
+
 namespace webrtc {
 
 class CallStats;
@@ -50,7 +54,8 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
                      webrtc::VoiceEngine* voice_engine,
                      ProcessThread* process_thread,
                      CallStats* call_stats,
-                     VieRemb* remb);
+                     VieRemb* remb,
+                     rtc::TaskQueuePool* render_pool);
   ~VideoReceiveStream() override;
 
   void SignalNetworkState(NetworkState state);
@@ -97,6 +102,7 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
 
   CongestionController* const congestion_controller_;
   CallStats* const call_stats_;
+  rtc::TaskQueuePool* const render_pool_;
 
   vcm::VideoReceiver video_receiver_;
   std::unique_ptr<rtc::VideoSinkInterface<VideoFrame>> incoming_video_stream_;
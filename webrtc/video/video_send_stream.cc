@@ -162,7 +162,10 @@ std::string VideoSendStream::Stats::ToString(int64_t time_ms) const {
   ss << "target_bps: " << target_media_bitrate_bps << ", ";
   ss << "media_bps: " << media_bitrate_bps << ", ";
   ss << "suspended: " << (suspended ? "true" : "false") << ", ";
-  ss << "bw_adapted: " << (bw_limited_resolution ? "true" : "false");
+  ss << "bw_adapted: " << (bw_limited_resolution ? "true" : "false") << ", ";
+  ss << "native_to_i420_conversions: " << native_to_i420_conversions << ", ";
+  ss << "encoder_queue_drops: " << frames_dropped_by_encoder_queue << ", ";
+  ss << "capture_to_encode_ms: " << avg_capture_to_encode_delay_ms;
   ss << '}';
   for (const auto& substream : substreams) {
     if (!substream.second.is_rtx) {
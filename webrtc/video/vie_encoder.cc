@@ -30,6 +30,11 @@ namespace {
 // Time interval for logging frame counts.
 const int64_t kFrameLogIntervalMs = 60000;
 
+// Number of consecutive unchanged screen frames that are still encoded, so that
+// the encoder can refine the quality of the static content. Further unchanged
+// frames are not encoded.
+const int kMaxStaticFramesToEncode = 5;
+
 VideoCodecType PayloadNameToCodecType(const std::string& payload_name) {
   if (payload_name == "VP8")
     return kVideoCodecVP8;
@@ -200,31 +205,50 @@ CpuOveruseOptions GetCpuOveruseOptions(bool full_overuse_time) {
 
 class ViEEncoder::EncodeTask : public rtc::QueuedTask {
  public:
-  EncodeTask(const VideoFrame& frame,
-             ViEEncoder* vie_encoder,
-             int64_t time_when_posted_in_ms,
-             bool log_stats)
-      : vie_encoder_(vie_encoder),
-        time_when_posted_ms_(time_when_posted_in_ms),
-        log_stats_(log_stats) {
-    frame_.ShallowCopy(frame);
-    ++vie_encoder_->posted_frames_waiting_for_encode_;
-  }
+  EncodeTask(ViEEncoder* vie_encoder, uint64_t frame_id)
+      : vie_encoder_(vie_encoder), frame_id_(frame_id) {}
 
  private:
   bool Run() override {
     RTC_DCHECK_RUN_ON(&vie_encoder_->encoder_queue_);
-    RTC_DCHECK_GT(vie_encoder_->posted_frames_waiting_for_encode_.Value(), 0);
-    ++vie_encoder_->captured_frame_count_;
-    if (--vie_encoder_->posted_frames_waiting_for_encode_ == 0) {
-      vie_encoder_->EncodeVideoFrame(frame_, time_when_posted_ms_);
-    } else {
-      // There is a newer frame in flight. Do not encode this frame.
-      LOG(LS_VERBOSE)
-          << "Incoming frame dropped due to that the encoder is blocked.";
-      ++vie_encoder_->dropped_frame_count_;
+    VideoFrame frame;
+    int64_t time_when_posted_ms;
+    int frames_dropped;
+    bool log_stats;
+    {
+      rtc::CritScope lock(&vie_encoder_->pending_frame_crit_);
+      // The frame this task was posted for has been replaced by a newer one,
+      // which is encoded by its own task.
+      if (!vie_encoder_->pending_frame_ ||
+          vie_encoder_->pending_frame_id_ != frame_id_) {
+        return true;
+      }
+      frame = *vie_encoder_->pending_frame_;
+      vie_encoder_->pending_frame_ = rtc::Optional<VideoFrame>();
+      time_when_posted_ms = vie_encoder_->pending_frame_post_time_ms_;
+      frames_dropped = vie_encoder_->pending_frames_dropped_;
+      vie_encoder_->pending_frames_dropped_ = 0;
+      log_stats = vie_encoder_->pending_frame_log_stats_;
+      vie_encoder_->pending_frame_log_stats_ = false;
+    }
+    vie_encoder_->captured_frame_count_ += frames_dropped + 1;
+    if (frames_dropped > 0) {
+      // Newer frames arrived while the encoder was blocked; only the last one
+      // is encoded.
+      LOG(LS_VERBOSE) << frames_dropped
+                      << " incoming frames dropped due to that the encoder is "
+                         "blocked.";
+      vie_encoder_->dropped_frame_count_ += frames_dropped;
+    }
+    if (vie_encoder_->stats_proxy_) {
+      if (frames_dropped > 0)
+        vie_encoder_->stats_proxy_->OnFramesDroppedByEncoderQueue(
+            frames_dropped);
+      vie_encoder_->stats_proxy_->OnFrameDequeuedForEncode(static_cast<int>(
+          vie_encoder_->clock_->TimeInMilliseconds() - frame.render_time_ms()));
     }
-    if (log_stats_) {
+    vie_encoder_->EncodeVideoFrame(frame, time_when_posted_ms);
+    if (log_stats) {
       LOG(LS_INFO) << "Number of frames: captured "
                    << vie_encoder_->captured_frame_count_
                    << ", dropped (due to encoder blocked) "
@@ -235,10 +259,8 @@ class ViEEncoder::EncodeTask : public rtc::QueuedTask {
     }
     return true;
   }
-  VideoFrame frame_;
   ViEEncoder* const vie_encoder_;
-  const int64_t time_when_posted_ms_;
-  const bool log_stats_;
+  const uint64_t frame_id_;
 };
 
 // VideoSourceProxy is responsible ensuring thread safety between calls to
@@ -307,11 +329,18 @@ ViEEncoder::ViEEncoder(uint32_t number_of_cores,
       encoder_start_bitrate_bps_(0),
       last_observed_bitrate_bps_(0),
       encoder_paused_and_dropped_frame_(false),
+      encoded_on_encoder_queue_(false),
       has_received_sli_(false),
       picture_id_sli_(0),
       has_received_rpsi_(false),
       picture_id_rpsi_(0),
+      key_frame_requested_(false),
+      static_frame_count_(0),
       clock_(Clock::GetRealTimeClock()),
+      pending_frame_id_(0),
+      pending_frame_post_time_ms_(0),
+      pending_frames_dropped_(0),
+      pending_frame_log_stats_(false),
       last_captured_timestamp_(0),
       delta_ntp_internal_ms_(clock_->CurrentNtpInMilliseconds() -
                              clock_->TimeInMilliseconds()),
@@ -403,6 +432,7 @@ void ViEEncoder::ConfigureEncoderInternal(const VideoCodec& video_codec,
                                         video_codec.maxFramerate));
 
   encoder_config_ = video_codec;
+  static_frame_count_ = 0;
   encoder_config_.startBitrate = encoder_start_bitrate_bps_ / 1000;
   encoder_config_.startBitrate =
       std::max(encoder_config_.startBitrate, video_codec.minBitrate);
@@ -478,8 +508,20 @@ void ViEEncoder::OnFrame(const VideoFrame& video_frame) {
   }
 
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
-  encoder_queue_.PostTask(std::unique_ptr<rtc::QueuedTask>(new EncodeTask(
-      incoming_frame, this, clock_->TimeInMilliseconds(), log_stats)));
+  uint64_t frame_id;
+  {
+    rtc::CritScope lock(&pending_frame_crit_);
+    if (pending_frame_)
+      ++pending_frames_dropped_;
+    pending_frame_ = rtc::Optional<VideoFrame>(incoming_frame);
+    frame_id = ++pending_frame_id_;
+    pending_frame_post_time_ms_ = clock_->TimeInMilliseconds();
+    pending_frame_log_stats_ |= log_stats;
+  }
+  // The task is posted even if an older frame is still pending so that the
+  // frame is encoded after any configuration change posted before it.
+  encoder_queue_.PostTask(
+      std::unique_ptr<rtc::QueuedTask>(new EncodeTask(this, frame_id)));
 }
 
 bool ViEEncoder::EncoderPaused() const {
@@ -510,6 +552,18 @@ void ViEEncoder::TraceFrameDropEnd() {
   encoder_paused_and_dropped_frame_ = false;
 }
 
+bool ViEEncoder::SkipStaticFrame(const VideoFrame& video_frame) {
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  // Only screen capturers are expected to report the updated region of their
+  // frames, and camera frames are encoded even if nothing moves.
+  if (encoder_config_.mode != kScreensharing || !video_frame.update_rect() ||
+      !video_frame.update_rect()->IsEmpty() || key_frame_requested_) {
+    static_frame_count_ = 0;
+    return false;
+  }
+  return ++static_frame_count_ > kMaxStaticFramesToEncode;
+}
+
 void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
                                   int64_t time_when_posted_in_ms) {
   RTC_DCHECK_RUN_ON(&encoder_queue_);
@@ -522,6 +576,9 @@ void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
   }
   TraceFrameDropEnd();
 
+  if (SkipStaticFrame(video_frame))
+    return;
+
   TRACE_EVENT_ASYNC_STEP0("webrtc", "Video", video_frame.render_time_ms(),
                           "Encode");
   const VideoFrame* frame_to_send = &video_frame;
@@ -537,8 +594,9 @@ void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
 
   overuse_detector_.FrameCaptured(video_frame, time_when_posted_in_ms);
 
+  webrtc::CodecSpecificInfo codec_specific_info;
+  const webrtc::CodecSpecificInfo* codec_specific_info_ptr = nullptr;
   if (encoder_config_.codecType == webrtc::kVideoCodecVP8) {
-    webrtc::CodecSpecificInfo codec_specific_info;
     codec_specific_info.codecType = webrtc::kVideoCodecVP8;
 
       codec_specific_info.codecSpecific.VP8.hasReceivedRPSI =
@@ -552,10 +610,22 @@ void ViEEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
       has_received_sli_ = false;
       has_received_rpsi_ = false;
 
-    video_sender_.AddVideoFrame(*frame_to_send, &codec_specific_info);
-    return;
+    codec_specific_info_ptr = &codec_specific_info;
+  }
+
+  const int64_t encode_start_cpu_time_ns = rtc::ThreadCpuTimeNanos();
+  encoded_on_encoder_queue_ = false;
+  video_sender_.AddVideoFrame(*frame_to_send, codec_specific_info_ptr);
+  key_frame_requested_ = false;
+  // The CPU time of this thread is the encode time only for encoders that
+  // deliver the encoded frame before returning. Other encoders keep being
+  // measured by the time until the frame is sent.
+  if (encode_start_cpu_time_ns != -1 && encoded_on_encoder_queue_) {
+    overuse_detector_.FrameEncoded(
+        video_frame.timestamp(),
+        (rtc::ThreadCpuTimeNanos() - encode_start_cpu_time_ns) /
+            rtc::kNumNanosecsPerMicrosec);
   }
-  video_sender_.AddVideoFrame(*frame_to_send, nullptr);
 }
 
 void ViEEncoder::SendKeyFrame() {
@@ -564,6 +634,7 @@ void ViEEncoder::SendKeyFrame() {
     return;
   }
   RTC_DCHECK_RUN_ON(&encoder_queue_);
+  key_frame_requested_ = true;
   video_sender_.IntraFrameRequest(0);
 }
 
@@ -577,6 +648,10 @@ EncodedImageCallback::Result ViEEncoder::OnEncodedImage(
   if (stats_proxy_) {
     stats_proxy_->OnSendEncodedImage(encoded_image, codec_specific_info);
   }
+  if (encoder_queue_.IsCurrent()) {
+    RTC_DCHECK_RUN_ON(&encoder_queue_);
+    encoded_on_encoder_queue_ = true;
+  }
 
   EncodedImageCallback::Result result =
       sink_->OnEncodedImage(encoded_image, codec_specific_info, fragmentation);
@@ -596,6 +671,12 @@ void ViEEncoder::SendStatistics(uint32_t bit_rate, uint32_t frame_rate) {
     stats_proxy_->OnEncoderStatsUpdate(frame_rate, bit_rate);
 }
 
+void ViEEncoder::OnNativeToI420Conversion() {
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  if (stats_proxy_)
+    stats_proxy_->OnNativeToI420Conversion();
+}
+
 void ViEEncoder::OnReceivedSLI(uint8_t picture_id) {
   if (!encoder_queue_.IsCurrent()) {
     encoder_queue_.PostTask([this, picture_id] { OnReceivedSLI(picture_id); });
@@ -625,6 +706,7 @@ void ViEEncoder::OnReceivedIntraFrameRequest(size_t stream_index) {
   RTC_DCHECK_RUN_ON(&encoder_queue_);
   // Key frame request from remote side, signal to VCM.
   TRACE_EVENT0("webrtc", "OnKeyFrameRequest");
+  key_frame_requested_ = true;
   video_sender_.IntraFrameRequest(stream_index);
 }
 
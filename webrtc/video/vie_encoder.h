@@ -17,6 +17,7 @@
 
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/event.h"
+#include "webrtc/base/optional.h"
 #include "webrtc/base/sequenced_task_checker.h"
 #include "webrtc/base/task_queue.h"
 #include "webrtc/call.h"
@@ -25,7 +26,6 @@
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
 #include "webrtc/modules/video_coding/video_coding_impl.h"
 #include "webrtc/modules/video_processing/include/video_processing.h"
-#include "webrtc/system_wrappers/include/atomic32.h"
 #include "webrtc/video/overuse_frame_detector.h"
 #include "webrtc/video_encoder.h"
 #include "webrtc/video_send_stream.h"
@@ -100,6 +100,7 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   // Implements VideoSendStatisticsCallback.
   void SendStatistics(uint32_t bit_rate,
                       uint32_t frame_rate) override;
+  void OnNativeToI420Conversion() override;
 
   void EncodeVideoFrame(const VideoFrame& frame,
                         int64_t time_when_posted_in_ms);
@@ -114,6 +115,10 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   void OveruseDetected() override;
   void NormalUsage() override;
 
+  // Returns true if |video_frame| is a screen frame without any change, which
+  // doesn't need to be encoded.
+  bool SkipStaticFrame(const VideoFrame& video_frame);
+
   bool EncoderPaused() const;
   void TraceFrameDropStart();
   void TraceFrameDropEnd();
@@ -145,14 +150,32 @@ class ViEEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   int encoder_start_bitrate_bps_ ACCESS_ON(&encoder_queue_);
   uint32_t last_observed_bitrate_bps_ ACCESS_ON(&encoder_queue_);
   bool encoder_paused_and_dropped_frame_ ACCESS_ON(&encoder_queue_);
+  // Set if the encoder delivered an encoded frame on |encoder_queue_|, while
+  // encoding the current frame.
+  bool encoded_on_encoder_queue_ ACCESS_ON(&encoder_queue_);
   bool has_received_sli_ ACCESS_ON(&encoder_queue_);
   uint8_t picture_id_sli_ ACCESS_ON(&encoder_queue_);
   bool has_received_rpsi_ ACCESS_ON(&encoder_queue_);
   uint64_t picture_id_rpsi_ ACCESS_ON(&encoder_queue_);
+  // Set if a key frame was requested since the last encoded frame.
+  bool key_frame_requested_ ACCESS_ON(&encoder_queue_);
+  // Number of consecutive frames reported as unchanged.
+  int static_frame_count_ ACCESS_ON(&encoder_queue_);
   Clock* const clock_;
 
   rtc::RaceChecker incoming_frame_race_checker_;
-  Atomic32 posted_frames_waiting_for_encode_;
+  // Frames are handed to |encoder_queue_| through a single slot: a frame that
+  // arrives while the previous one is still waiting replaces it, so stale
+  // frames are released right away and only the newest one is encoded.
+  rtc::CriticalSection pending_frame_crit_;
+  rtc::Optional<VideoFrame> pending_frame_ GUARDED_BY(pending_frame_crit_);
+  // Incremented for every frame put in the slot. An EncodeTask only encodes
+  // the frame it was posted for.
+  uint64_t pending_frame_id_ GUARDED_BY(pending_frame_crit_);
+  int64_t pending_frame_post_time_ms_ GUARDED_BY(pending_frame_crit_);
+  // Frames replaced in the slot since the encoder queue last took a frame.
+  int pending_frames_dropped_ GUARDED_BY(pending_frame_crit_);
+  bool pending_frame_log_stats_ GUARDED_BY(pending_frame_crit_);
   // Used to make sure incoming time stamp is increasing for every frame.
   int64_t last_captured_timestamp_ GUARDED_BY(incoming_frame_race_checker_);
   // Delta used for translating between NTP and internal timestamps.
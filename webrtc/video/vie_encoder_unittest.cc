@@ -73,6 +73,13 @@ class ViEEncoderTest : public ::testing::Test {
     return frame;
   }
 
+  VideoFrame CreateStaticFrame(int64_t ntp_ts) const {
+    VideoFrame frame = CreateFrame(ntp_ts, nullptr);
+    frame.set_update_rect(rtc::Optional<VideoFrame::UpdateRect>(
+        VideoFrame::UpdateRect{0, 0, 0, 0}));
+    return frame;
+  }
+
   class TestEncoder : public test::FakeEncoder {
    public:
     TestEncoder()
@@ -91,6 +98,7 @@ class ViEEncoderTest : public ::testing::Test {
 
         timestamp_ = input_image.timestamp();
         ntp_time_ms_ = input_image.ntp_time_ms();
+        ++encoded_frame_count_;
         block_encode = block_next_encode_;
         block_next_encode_ = false;
       }
@@ -108,6 +116,11 @@ class ViEEncoderTest : public ::testing::Test {
 
     void ContinueEncode() { continue_encode_event_.Set(); }
 
+    int encoded_frame_count() const {
+      rtc::CritScope lock(&crit_);
+      return encoded_frame_count_;
+    }
+
     void CheckLastTimeStampsMatch(int64_t ntp_time_ms,
                                   uint32_t timestamp) const {
       rtc::CritScope lock(&crit_);
@@ -121,6 +134,7 @@ class ViEEncoderTest : public ::testing::Test {
     rtc::Event continue_encode_event_;
     uint32_t timestamp_ = 0;
     int64_t ntp_time_ms_ = 0;
+    int encoded_frame_count_ = 0;
   };
 
   class TestSink : public EncodedImageCallback {
@@ -255,4 +269,82 @@ TEST_F(ViEEncoderTest, DropsPendingFramesOnSlowEncode) {
   vie_encoder_->Stop();
 }
 
+TEST_F(ViEEncoderTest, ReleasesReplacedPendingFrame) {
+  const int kTargetBitrateBps = 100000;
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  fake_encoder_.BlockNextEncode();
+  video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
+  sink_.WaitForEncodedFrame(1);
+  // While the encoder is blocked, frame 2 waits for it and is replaced by
+  // frame 3, which releases it without waiting for the encoder.
+  rtc::Event frame_destroyed_event(false, false);
+  video_source_.IncomingCapturedFrame(CreateFrame(2, &frame_destroyed_event));
+  video_source_.IncomingCapturedFrame(CreateFrame(3, nullptr));
+  EXPECT_TRUE(frame_destroyed_event.Wait(kDefaultTimeoutMs));
+  fake_encoder_.ContinueEncode();
+  sink_.WaitForEncodedFrame(3);
+
+  EXPECT_EQ(1u, stats_proxy_.GetStats().frames_dropped_by_encoder_queue);
+  vie_encoder_->Stop();
+}
+
+TEST_F(ViEEncoderTest, SkipsStaticScreenFrames) {
+  video_encoder_config_.content_type =
+      VideoEncoderConfig::ContentType::kScreen;
+  vie_encoder_->ConfigureEncoder(video_encoder_config_, 1440);
+  const int kTargetBitrateBps = 100000;
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
+  sink_.WaitForEncodedFrame(1);
+  // The first unchanged frames are encoded, to refine the quality.
+  for (int i = 2; i <= 6; ++i) {
+    video_source_.IncomingCapturedFrame(CreateStaticFrame(i));
+    sink_.WaitForEncodedFrame(i);
+  }
+  // Skipped, since the content has been static for long enough.
+  video_source_.IncomingCapturedFrame(CreateStaticFrame(7));
+
+  VideoFrame changed_frame = CreateFrame(8, nullptr);
+  changed_frame.set_update_rect(rtc::Optional<VideoFrame::UpdateRect>(
+      VideoFrame::UpdateRect{0, 0, 16, 16}));
+  video_source_.IncomingCapturedFrame(changed_frame);
+  sink_.WaitForEncodedFrame(8);
+  EXPECT_EQ(7, fake_encoder_.encoded_frame_count());
+  vie_encoder_->Stop();
+}
+
+TEST_F(ViEEncoderTest, EncodesStaticScreenFrameOnKeyFrameRequest) {
+  video_encoder_config_.content_type =
+      VideoEncoderConfig::ContentType::kScreen;
+  vie_encoder_->ConfigureEncoder(video_encoder_config_, 1440);
+  const int kTargetBitrateBps = 100000;
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  for (int i = 1; i <= 5; ++i) {
+    video_source_.IncomingCapturedFrame(CreateStaticFrame(i));
+    sink_.WaitForEncodedFrame(i);
+  }
+  // Skipped.
+  video_source_.IncomingCapturedFrame(CreateStaticFrame(6));
+
+  vie_encoder_->SendKeyFrame();
+  video_source_.IncomingCapturedFrame(CreateStaticFrame(7));
+  sink_.WaitForEncodedFrame(7);
+  EXPECT_EQ(6, fake_encoder_.encoded_frame_count());
+  vie_encoder_->Stop();
+}
+
+TEST_F(ViEEncoderTest, EncodesStaticFramesOfRealtimeVideo) {
+  const int kTargetBitrateBps = 100000;
+  vie_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  for (int i = 1; i <= 10; ++i) {
+    video_source_.IncomingCapturedFrame(CreateStaticFrame(i));
+    sink_.WaitForEncodedFrame(i);
+  }
+  vie_encoder_->Stop();
+}
+
 }  // namespace webrtc
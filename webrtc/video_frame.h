@@ -11,9 +11,11 @@
 #ifndef WEBRTC_VIDEO_FRAME_H_
 #define WEBRTC_VIDEO_FRAME_H_
 
+#include "webrtc/base/optional.h"
 #include "webrtc/base/scoped_ref_ptr.h"
 #include "webrtc/base/timeutils.h"
 #include "webrtc/common_types.h"
+#include "webrtc/common_video/include/encoded_image_buffer.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
 #include "webrtc/common_video/rotation.h"
 #include "webrtc/typedefs.h"
@@ -25,6 +27,18 @@ namespace webrtc {
 // https://bugs.chromium.org/p/webrtc/issues/detail?id=5682.
 class VideoFrame {
  public:
+  // Part of the frame that changed since the previous frame of the same
+  // source, in pixels. An empty rectangle means that the frame is identical to
+  // the previous one.
+  struct UpdateRect {
+    bool IsEmpty() const { return width <= 0 || height <= 0; }
+
+    int offset_x;
+    int offset_y;
+    int width;
+    int height;
+  };
+
   // TODO(nisse): Deprecated. Using the default constructor violates the
   // reasonable assumption that video_frame_buffer() returns a valid buffer.
   VideoFrame();
@@ -162,6 +176,15 @@ class VideoFrame {
     return timestamp_us() / rtc::kNumMicrosecsPerMillisec;
   }
 
+  // Set by sources which know which part of the frame changed, e.g. screen
+  // capturers. Unset if unknown, in which case the entire frame should be
+  // considered changed. Must be reset by anyone changing the frame content
+  // or geometry.
+  const rtc::Optional<UpdateRect>& update_rect() const { return update_rect_; }
+  void set_update_rect(const rtc::Optional<UpdateRect>& update_rect) {
+    update_rect_ = update_rect;
+  }
+
   // Return true if and only if video_frame_buffer() is null. Which is possible
   // only if the object was default-constructed.
   // TODO(nisse): Deprecated. Should be deleted in the cricket::VideoFrame and
@@ -191,6 +214,7 @@ class VideoFrame {
   int64_t ntp_time_ms_;
   int64_t timestamp_us_;
   VideoRotation rotation_;
+  rtc::Optional<UpdateRect> update_rect_;
 };
 
 
@@ -230,6 +254,9 @@ class EncodedImage {
   uint8_t* _buffer;
   size_t _length;
   size_t _size;
+  // If set, the memory |_buffer| points to. Copies of the image then keep the
+  // data alive, without copying it.
+  rtc::scoped_refptr<EncodedImageBuffer> shared_buffer_;
   VideoRotation rotation_ = kVideoRotation_0;
   bool _completeFrame = false;
   AdaptReason adapt_reason_;
@@ -64,6 +64,11 @@ class VideoReceiveStream {
     int jitter_buffer_ms = 0;
     int min_playout_delay_ms = 0;
     int render_delay_ms = 10;
+    // Delay from capture on the sender to render of the last rendered frame,
+    // or -1 if the capture time isn't known yet since it is estimated from
+    // RTCP sender reports. The receive side part of the delay is made up of
+    // |current_delay_ms|, which includes |decode_ms| and |render_delay_ms|.
+    int end_to_end_delay_ms = -1;
 
     int current_payload_type = -1;
 
@@ -175,6 +180,16 @@ class VideoReceiveStream {
     // available.
     bool disable_prerenderer_smoothing = false;
 
+    // Trade-off between latency and smoothness of the playout.
+    //  - kSmooth: frames are delayed to absorb the estimated network jitter,
+    //    so that they can be rendered at an even pace.
+    //  - kLowLatency: frames are decoded as soon as they are decodable and
+    //    passed on to the renderer on arrival, e.g. for game streaming or
+    //    remote desktop. Jitter then shows up as uneven frame pacing. Implies
+    //    |disable_prerenderer_smoothing|.
+    enum class PlayoutMode { kSmooth, kLowLatency };
+    PlayoutMode playout_mode = PlayoutMode::kSmooth;
+
     // Identifier for an A/V synchronization group. Empty string to disable.
     // TODO(pbos): Synchronize streams in a sync group, not just video streams
     // to one of the audio streams.
@@ -57,6 +57,15 @@ class VideoSendStream {
     int media_bitrate_bps = 0;
     bool suspended = false;
     bool bw_limited_resolution = false;
+    // Number of native handle (texture) frames that were converted to I420
+    // because the encoder only takes frames in memory.
+    uint32_t native_to_i420_conversions = 0;
+    // Number of frames that were replaced by a newer frame before the encoder
+    // got to them.
+    uint32_t frames_dropped_by_encoder_queue = 0;
+    // Time from a frame being delivered to the encoder until it is picked up
+    // for encoding, averaged over recent frames.
+    int avg_capture_to_encode_delay_ms = 0;
     std::map<uint32_t, StreamStats> substreams;
   };
 
@@ -355,6 +355,11 @@ int32_t Channel::SendData(FrameType frameType,
     // The level will be used in combination with voice-activity state
     // (frameType) to add an RTP header extension
     _rtpRtcpModule->SetAudioLevel(rms_level_.RMS());
+    // Prefer the voice activity detected by the audio processing over the
+    // codec frame type, which marks all frames as speech unless the codec
+    // runs its own VAD/DTX.
+    _rtpRtcpModule->SetAudioVoiceActivity(send_voice_activity_);
+    send_voice_activity_ = rtc::Optional<bool>();
   }
 
   // Push data from ACM to RTP/RTCP-module to deliver audio frame for
@@ -1289,6 +1294,25 @@ void Channel::SetBitRate(int bitrate_bps) {
   retransmission_rate_limiter_->SetMaxRate(bitrate_bps);
 }
 
+bool Channel::EnableAudioNetworkAdaptor(bool enable) {
+  WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId, _channelId),
+               "Channel::EnableAudioNetworkAdaptor(enable=%d)", enable);
+  codec_manager_.SetAudioNetworkAdaptor(enable);
+  if (!codec_manager_.MakeEncoder(&rent_a_codec_, audio_coding_.get()))
+    return false;
+  return !enable || codec_manager_.GetStackParams()->use_audio_network_adaptor;
+}
+
+void Channel::OnUplinkNetworkMetrics(int uplink_bandwidth_bps,
+                                     int64_t rtt_ms) {
+  audio_coding_->ModifyEncoder([&](std::unique_ptr<AudioEncoder>* encoder) {
+    if (*encoder) {
+      (*encoder)->OnReceivedUplinkBandwidth(uplink_bandwidth_bps);
+      (*encoder)->OnReceivedRtt(static_cast<int>(rtt_ms));
+    }
+  });
+}
+
 void Channel::OnIncomingFractionLoss(int fraction_lost) {
   network_predictor_->UpdatePacketLossRate(fraction_lost);
   uint8_t average_fraction_loss = network_predictor_->GetLossRate();
@@ -1535,15 +1559,24 @@ int32_t Channel::ReceivedRTPPacket(const uint8_t* received_packet,
   WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, _channelId),
                "Channel::ReceivedRTPPacket()");
 
-  // Store playout timestamp for the received RTP packet
-  UpdatePlayoutTimestamp(false);
-
   RTPHeader header;
   if (!rtp_header_parser_->Parse(received_packet, length, &header)) {
+    // Store playout timestamp for the received RTP packet
+    UpdatePlayoutTimestamp(false);
     WEBRTC_TRACE(webrtc::kTraceDebug, webrtc::kTraceVoice, _channelId,
                  "Incoming packet: invalid RTP header");
     return -1;
   }
+  return OnRtpPacket(received_packet, length, header);
+}
+
+int32_t Channel::OnRtpPacket(const uint8_t* received_packet,
+                             size_t length,
+                             const RTPHeader& parsed_header) {
+  // Store playout timestamp for the received RTP packet
+  UpdatePlayoutTimestamp(false);
+
+  RTPHeader header = parsed_header;
   header.payload_type_frequency =
       rtp_payload_registry_->GetPayloadTypeFrequency(header.payloadType);
   if (header.payload_type_frequency < 0)
@@ -2185,6 +2218,11 @@ int Channel::GetSpeechOutputLevelFullRange(uint32_t& level) const {
   return 0;
 }
 
+bool Channel::GetLastReceivedAudioLevel(uint8_t* level_dbov,
+                                        bool* voice_activity) const {
+  return rtp_receiver_->LastReceivedAudioLevel(level_dbov, voice_activity);
+}
+
 int Channel::SetInputMute(bool enable) {
   rtc::CritScope cs(&volume_settings_critsect_);
   WEBRTC_TRACE(kTraceInfo, kTraceVoice, VoEId(_instanceId, _channelId),
@@ -2744,6 +2782,12 @@ uint32_t Channel::PrepareEncodeAndSend(int mixingFrequency) {
     } else {
       rms_level_.Process(_audioFrame.data_, length);
     }
+    // The packet is flagged as voice if any of its frames is.
+    if (_audioFrame.vad_activity_ != AudioFrame::kVadUnknown) {
+      send_voice_activity_ = rtc::Optional<bool>(
+          send_voice_activity_.value_or(false) ||
+          (!is_muted && _audioFrame.vad_activity_ == AudioFrame::kVadActive));
+    }
   }
   previous_frame_muted_ = is_muted;
 
@@ -2882,6 +2926,10 @@ void Channel::GetDecodingCallStatistics(AudioDecodingCallStats* stats) const {
   audio_coding_->GetDecodingCallStatistics(stats);
 }
 
+bool Channel::PlayoutInDtx() const {
+  return audio_coding_->PlayoutInDtx();
+}
+
 bool Channel::GetDelayEstimate(int* jitter_buffer_delay_ms,
                                int* playout_buffer_delay_ms) const {
   rtc::CritScope lock(&video_sync_lock_);
@@ -200,6 +200,8 @@ class Channel
   int32_t GetRecCodec(CodecInst& codec);
   int32_t SetSendCodec(const CodecInst& codec);
   void SetBitRate(int bitrate_bps);
+  bool EnableAudioNetworkAdaptor(bool enable);
+  void OnUplinkNetworkMetrics(int uplink_bandwidth_bps, int64_t rtt_ms);
   int32_t SetVADStatus(bool enableVAD, ACMVADMode mode, bool disableDTX);
   int32_t GetVADStatus(bool& enabledVAD, ACMVADMode& mode, bool& disabledDTX);
   int32_t SetRecPayloadType(const CodecInst& codec);
@@ -215,6 +217,11 @@ class Channel
   int32_t ReceivedRTPPacket(const uint8_t* received_packet,
                             size_t length,
                             const PacketTime& packet_time);
+  // Like ReceivedRTPPacket(), for a packet the caller already parsed into
+  // |header|, with the same header extensions registered as this channel.
+  int32_t OnRtpPacket(const uint8_t* received_packet,
+                      size_t length,
+                      const RTPHeader& header);
   int32_t ReceivedRTCPPacket(const uint8_t* data, size_t length);
 
   // VoEFile
@@ -264,6 +271,12 @@ class Channel
   // VoEVolumeControl
   int GetSpeechOutputLevel(uint32_t& level) const;
   int GetSpeechOutputLevelFullRange(uint32_t& level) const;
+  // Audio level in -dBov and voice activity from the audio level header
+  // extension of the last received packet, available without decoding, e.g.
+  // for selecting the loudest streams to mix. Returns false if the remote
+  // side doesn't send the extension.
+  bool GetLastReceivedAudioLevel(uint8_t* level_dbov,
+                                 bool* voice_activity) const;
   int SetInputMute(bool enable);
   bool InputMute() const;
   int SetOutputVolumePan(float left, float right);
@@ -274,6 +287,7 @@ class Channel
   // VoENetEqStats
   int GetNetworkStatistics(NetworkStatistics& stats);
   void GetDecodingCallStatistics(AudioDecodingCallStats* stats) const;
+  bool PlayoutInDtx() const;
 
   // VoEVideoSync
   bool GetDelayEstimate(int* jitter_buffer_delay_ms,
@@ -511,6 +525,10 @@ class Channel
   rtc::CriticalSection* _callbackCritSectPtr;    // owned by base
   Transport* _transportPtr;  // WebRtc socket or external transport
   RMSLevel rms_level_;
+  // Voice activity detected by the audio processing in the frames encoded
+  // since the last sent packet; unset if the detection is disabled. Only
+  // accessed on the send path.
+  rtc::Optional<bool> send_voice_activity_;
   int32_t _sendFrameType;  // Send data is voice, 1-voice, 0-otherwise
   // VoEBase
   bool _externalMixing;
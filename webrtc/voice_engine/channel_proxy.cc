@@ -148,6 +148,10 @@ uint32_t ChannelProxy::GetDelayEstimate() const {
   return channel()->GetDelayEstimate();
 }
 
+bool ChannelProxy::PlayoutInDtx() const {
+  return channel()->PlayoutInDtx();
+}
+
 bool ChannelProxy::SetSendTelephoneEventPayloadType(int payload_type) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   return channel()->SetSendTelephoneEventPayloadType(payload_type) == 0;
@@ -163,6 +167,17 @@ void ChannelProxy::SetBitrate(int bitrate_bps) {
   channel()->SetBitRate(bitrate_bps);
 }
 
+bool ChannelProxy::EnableAudioNetworkAdaptor(bool enable) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  return channel()->EnableAudioNetworkAdaptor(enable);
+}
+
+void ChannelProxy::OnUplinkNetworkMetrics(int uplink_bandwidth_bps,
+                                          int64_t rtt_ms) {
+  // Called on the same thread as SetBitrate().
+  channel()->OnUplinkNetworkMetrics(uplink_bandwidth_bps, rtt_ms);
+}
+
 void ChannelProxy::SetSink(std::unique_ptr<AudioSinkInterface> sink) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   channel()->SetSink(std::move(sink));
@@ -185,11 +200,11 @@ void ChannelProxy::DeRegisterExternalTransport() {
   channel()->DeRegisterExternalTransport();
 }
 
-bool ChannelProxy::ReceivedRTPPacket(const uint8_t* packet,
-                                     size_t length,
-                                     const PacketTime& packet_time) {
+bool ChannelProxy::OnRtpPacket(const uint8_t* packet,
+                               size_t length,
+                               const RTPHeader& header) {
   // May be called on either worker thread or network thread.
-  return channel()->ReceivedRTPPacket(packet, length, packet_time) == 0;
+  return channel()->OnRtpPacket(packet, length, header) == 0;
 }
 
 bool ChannelProxy::ReceivedRTCPPacket(const uint8_t* packet, size_t length) {
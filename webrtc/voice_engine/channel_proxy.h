@@ -70,18 +70,24 @@ class ChannelProxy {
   virtual AudioDecodingCallStats GetDecodingCallStatistics() const;
   virtual int32_t GetSpeechOutputLevelFullRange() const;
   virtual uint32_t GetDelayEstimate() const;
+  // May be called on any thread, e.g. the one pulling audio for mixing.
+  virtual bool PlayoutInDtx() const;
 
   virtual bool SetSendTelephoneEventPayloadType(int payload_type);
   virtual bool SendTelephoneEventOutband(int event, int duration_ms);
   virtual void SetBitrate(int bitrate_bps);
+  virtual bool EnableAudioNetworkAdaptor(bool enable);
+  virtual void OnUplinkNetworkMetrics(int uplink_bandwidth_bps,
+                                      int64_t rtt_ms);
   virtual void SetSink(std::unique_ptr<AudioSinkInterface> sink);
   virtual void SetInputMute(bool muted);
 
   virtual void RegisterExternalTransport(Transport* transport);
   virtual void DeRegisterExternalTransport();
-  virtual bool ReceivedRTPPacket(const uint8_t* packet,
-                                 size_t length,
-                                 const PacketTime& packet_time);
+  // |header| must have been parsed with the channel's header extensions.
+  virtual bool OnRtpPacket(const uint8_t* packet,
+                           size_t length,
+                           const RTPHeader& header);
   virtual bool ReceivedRTCPPacket(const uint8_t* packet, size_t length);
 
   virtual const rtc::scoped_refptr<AudioDecoderFactory>&
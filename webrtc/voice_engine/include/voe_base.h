@@ -198,6 +198,16 @@ class WEBRTC_DLLEXPORT VoEBase {
   // 1 <- 2 <- 1.
   virtual int AssociateSendChannel(int channel, int accociate_send_channel) = 0;
 
+  // Spreads the per-channel send processing (demultiplexing, encoding and
+  // packetization) of the recorded audio over |num_threads| threads, the audio
+  // device thread included. Each channel is always processed on the same
+  // thread. Meant for processes with many channels, e.g. servers fed by an
+  // external or file based audio device module. Note that the transports of
+  // different channels are then called in parallel. Defaults to 1, i.e. all
+  // channels are processed serially on the audio device thread.
+  // Returns -1 in case of an error, 0 otherwise.
+  virtual int SetNumSendThreads(size_t num_threads) { return -1; }
+
  protected:
   VoEBase() {}
   virtual ~VoEBase() {}
@@ -12,6 +12,8 @@
 
 #include <memory>
 
+#include "webrtc/base/atomicops.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/format_macros.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/modules/utility/include/audio_frame_operations.h"
@@ -388,33 +390,29 @@ TransmitMixer::DemuxAndMix()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::DemuxAndMix()");
 
-    for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-         it.Increment())
-    {
-        Channel* channelPtr = it.GetChannel();
-        if (channelPtr->Sending())
-        {
-            // Demultiplex makes a copy of its input.
-            channelPtr->Demultiplex(_audioFrame);
-            channelPtr->PrepareEncodeAndSend(_audioFrame.sample_rate_hz_);
-        }
-    }
+    std::vector<ChannelOwner> channels;
+    _channelManagerPtr->GetAllChannels(&channels);
+    ProcessSendingChannels(channels, [this](Channel* channel) {
+        // Demultiplex makes a copy of its input.
+        channel->Demultiplex(_audioFrame);
+        channel->PrepareEncodeAndSend(_audioFrame.sample_rate_hz_);
+    });
     return 0;
 }
 
 void TransmitMixer::DemuxAndMix(const int voe_channels[],
                                 size_t number_of_voe_channels) {
+  std::vector<ChannelOwner> channels;
   for (size_t i = 0; i < number_of_voe_channels; ++i) {
     voe::ChannelOwner ch = _channelManagerPtr->GetChannel(voe_channels[i]);
-    voe::Channel* channel_ptr = ch.channel();
-    if (channel_ptr) {
-      if (channel_ptr->Sending()) {
-        // Demultiplex makes a copy of its input.
-        channel_ptr->Demultiplex(_audioFrame);
-        channel_ptr->PrepareEncodeAndSend(_audioFrame.sample_rate_hz_);
-      }
-    }
+    if (ch.channel())
+      channels.push_back(ch);
   }
+  ProcessSendingChannels(channels, [this](Channel* channel) {
+    // Demultiplex makes a copy of its input.
+    channel->Demultiplex(_audioFrame);
+    channel->PrepareEncodeAndSend(_audioFrame.sample_rate_hz_);
+  });
 }
 
 int32_t
@@ -423,26 +421,66 @@ TransmitMixer::EncodeAndSend()
     WEBRTC_TRACE(kTraceStream, kTraceVoice, VoEId(_instanceId, -1),
                  "TransmitMixer::EncodeAndSend()");
 
-    for (ChannelManager::Iterator it(_channelManagerPtr); it.IsValid();
-         it.Increment())
-    {
-        Channel* channelPtr = it.GetChannel();
-        if (channelPtr->Sending())
-        {
-            channelPtr->EncodeAndSend();
-        }
-    }
+    std::vector<ChannelOwner> channels;
+    _channelManagerPtr->GetAllChannels(&channels);
+    ProcessSendingChannels(channels,
+                           [](Channel* channel) { channel->EncodeAndSend(); });
     return 0;
 }
 
 void TransmitMixer::EncodeAndSend(const int voe_channels[],
                                   size_t number_of_voe_channels) {
+  std::vector<ChannelOwner> channels;
   for (size_t i = 0; i < number_of_voe_channels; ++i) {
     voe::ChannelOwner ch = _channelManagerPtr->GetChannel(voe_channels[i]);
-    voe::Channel* channel_ptr = ch.channel();
-    if (channel_ptr && channel_ptr->Sending())
-      channel_ptr->EncodeAndSend();
+    if (ch.channel())
+      channels.push_back(ch);
+  }
+  ProcessSendingChannels(channels,
+                         [](Channel* channel) { channel->EncodeAndSend(); });
+}
+
+void TransmitMixer::SetNumSendThreads(size_t num_threads) {
+  RTC_DCHECK_GE(num_threads, 1u);
+  rtc::CritScope cs(&_sendWorkersCritSect);
+  send_workers_.clear();
+  for (size_t i = 1; i < num_threads; ++i)
+    send_workers_.emplace_back(new rtc::TaskQueue("VoESendWorker"));
+}
+
+void TransmitMixer::ProcessSendingChannels(
+    const std::vector<ChannelOwner>& channels,
+    const std::function<void(Channel*)>& process) {
+  rtc::CritScope cs(&_sendWorkersCritSect);
+  const size_t num_threads = send_workers_.size() + 1;
+  auto process_partition = [&channels, &process, num_threads](size_t index) {
+    for (const ChannelOwner& ch : channels) {
+      Channel* channel = ch.channel();
+      if (static_cast<size_t>(channel->ChannelId()) % num_threads == index &&
+          channel->Sending()) {
+        process(channel);
+      }
+    }
+  };
+  if (num_threads == 1) {
+    process_partition(0);
+    return;
+  }
+
+  // The tasks refer to local variables; this is safe since we wait for all of
+  // them to finish before returning.
+  rtc::Event done(false, false);
+  volatile int pending_workers = static_cast<int>(send_workers_.size());
+  for (size_t i = 0; i < send_workers_.size(); ++i) {
+    send_workers_[i]->PostTask(
+        [&process_partition, &done, &pending_workers, i]() {
+          process_partition(i + 1);
+          if (rtc::AtomicOps::Decrement(&pending_workers) == 0)
+            done.Set();
+        });
   }
+  process_partition(0);
+  done.Wait(rtc::Event::kForever);
 }
 
 uint32_t TransmitMixer::CaptureLevel() const
@@ -11,9 +11,13 @@
 #ifndef WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 #define WEBRTC_VOICE_ENGINE_TRANSMIT_MIXER_H
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "webrtc/base/criticalsection.h"
+#include "webrtc/base/task_queue.h"
+#include "webrtc/base/thread_annotations.h"
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 #include "webrtc/common_types.h"
 #include "webrtc/modules/audio_processing/typing_detection.h"
@@ -34,7 +38,9 @@ class VoEMediaProcess;
 
 namespace voe {
 
+class Channel;
 class ChannelManager;
+class ChannelOwner;
 class MixedAudio;
 class Statistics;
 
@@ -72,6 +78,13 @@ public:
     // channels for encoding and sending to the network.
     void EncodeAndSend(const int voe_channels[], size_t number_of_voe_channels);
 
+    // Spreads the per-channel part of DemuxAndMix() and EncodeAndSend() over
+    // |num_threads| threads, the calling thread included. A channel is always
+    // processed on the same thread, so channels do not contend for each
+    // other's locks. With 1 (default), all channels are processed serially on
+    // the calling thread.
+    void SetNumSendThreads(size_t num_threads);
+
     // Must be called on the same thread as PrepareDemux().
     uint32_t CaptureLevel() const;
 
@@ -187,6 +200,11 @@ private:
     void TypingDetection(bool keyPressed);
 #endif
 
+    // Calls |process| for each sending channel in |channels| and returns when
+    // all of them have been processed. See SetNumSendThreads().
+    void ProcessSendingChannels(const std::vector<ChannelOwner>& channels,
+                                const std::function<void(Channel*)>& process);
+
     // uses
     Statistics* _engineStatisticsPtr;
     ChannelManager* _channelManagerPtr;
@@ -211,6 +229,13 @@ private:
     // protect file instances and their variables in MixedParticipants()
     rtc::CriticalSection _critSect;
     rtc::CriticalSection _callbackCritSect;
+    // Held while the sending channels are processed, so that the workers are
+    // not replaced meanwhile.
+    rtc::CriticalSection _sendWorkersCritSect;
+    // Each worker processes the channels with ChannelId() % (number of workers
+    // + 1) equal to its index + 1; the rest is processed on the calling thread.
+    std::vector<std::unique_ptr<rtc::TaskQueue>> send_workers_
+        GUARDED_BY(_sendWorkersCritSect);
 
 #ifdef WEBRTC_VOICE_ENGINE_TYPING_DETECTION
     webrtc::TypingDetection _typingDetection;
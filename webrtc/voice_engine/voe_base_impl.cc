@@ -788,4 +788,15 @@ int VoEBaseImpl::AssociateSendChannel(int channel,
   return 0;
 }
 
+int VoEBaseImpl::SetNumSendThreads(size_t num_threads) {
+  rtc::CritScope cs(shared_->crit_sec());
+  if (num_threads == 0) {
+    shared_->SetLastError(VE_INVALID_ARGUMENT, kTraceError,
+        "SetNumSendThreads() invalid number of threads");
+    return -1;
+  }
+  shared_->transmit_mixer()->SetNumSendThreads(num_threads);
+  return 0;
+}
+
 }  // namespace webrtc
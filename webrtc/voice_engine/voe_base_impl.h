@@ -59,6 +59,8 @@ class VoEBaseImpl : public VoEBase,
 
   int AssociateSendChannel(int channel, int accociate_send_channel) override;
 
+  int SetNumSendThreads(size_t num_threads) override;
+
   // AudioTransport
   int32_t RecordedDataIsAvailable(const void* audioSamples,
                                   const size_t nSamples,
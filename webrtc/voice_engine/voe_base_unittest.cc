@@ -13,6 +13,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_processing/include/audio_processing.h"
 #include "webrtc/voice_engine/channel_manager.h"
+#include "webrtc/voice_engine/include/voe_errors.h"
 #include "webrtc/voice_engine/shared_data.h"
 #include "webrtc/voice_engine/voice_engine_fixture.h"
 #include "webrtc/voice_engine/voice_engine_impl.h"
@@ -84,4 +85,23 @@ TEST_F(VoEBaseTest, GetVersion) {
   std::string v2 = VoiceEngine::GetVersionString() + "\n";
   EXPECT_EQ(v2, v1);
 }
+TEST_F(VoEBaseTest, SetNumSendThreads) {
+  EXPECT_EQ(0, base_->Init(&adm_, nullptr));
+  const int channel = base_->CreateChannel();
+  EXPECT_EQ(-1, base_->SetNumSendThreads(0));
+  EXPECT_EQ(VE_INVALID_ARGUMENT, base_->LastError());
+  EXPECT_EQ(0, base_->SetNumSendThreads(4));
+
+  // Recorded audio is processed with the workers in place.
+  const size_t kSamples = 480;
+  int16_t audio[kSamples] = {0};
+  uint32_t new_mic_level = 0;
+  EXPECT_EQ(0, base_->audio_transport()->RecordedDataIsAvailable(
+                   audio, kSamples, sizeof(int16_t), 1, 48000, 0, 0, 0, false,
+                   new_mic_level));
+
+  EXPECT_EQ(0, base_->SetNumSendThreads(1));
+  EXPECT_EQ(0, base_->DeleteChannel(channel));
+}
+
 }  // namespace webrtc
@@ -17,6 +17,7 @@
       'dependencies': [
         '<(webrtc_root)/api/api.gyp:call_api',
         '<(webrtc_root)/base/base.gyp:rtc_base_approved',
+        '<(webrtc_root)/base/base.gyp:rtc_task_queue',
         '<(webrtc_root)/common.gyp:webrtc_common',
         '<(webrtc_root)/common_audio/common_audio.gyp:common_audio',
         '<(webrtc_root)/modules/modules.gyp:audio_coding_module',
@@ -52,6 +52,8 @@
         'call/rtc_event_log.h',
         'call/rtc_event_log_helper_thread.cc',
         'call/rtc_event_log_helper_thread.h',
+        'call/rtc_event_log_rtp_batch.cc',
+        'call/rtc_event_log_rtp_batch.h',
       ],
       'conditions': [
         # If enable_protobuf is defined, we want to compile the protobuf
@@ -94,6 +96,7 @@
             'call/rtc_event_log_parser.h',
           ],
           'dependencies': [
+            'rtc_event_log',
             'rtc_event_log_proto',
           ],
           'export_dependent_settings': [
@@ -115,6 +118,16 @@
             'test/test.gyp:rtp_test_utils'
           ],
         },
+        {
+          'target_name': 'rtc_event_log2legacy',
+          'type': 'executable',
+          'sources': ['call/rtc_event_log2legacy.cc',],
+          'dependencies': [
+            '<(DEPTH)/third_party/gflags/gflags.gyp:gflags',
+            'rtc_event_log_parser',
+            'rtc_event_log_proto',
+          ],
+        },
       ],
     }],
   ],  # conditions